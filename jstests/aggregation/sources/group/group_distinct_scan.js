@@ -0,0 +1,121 @@
+// Tests that a $group which needs only one document of each group, such as the first or last one
+// of each value of the group key, reads them with a DISTINCT_SCAN rather than scanning every
+// matching document, and that it produces the same groups as when the collection is scanned.
+//
+// Relies on the $group being the first stage after the query, so cannot wrap pipelines in $facet
+// stages, and on the collection not being sharded:
+// @tags: [do_not_wrap_aggregations_in_facets, assumes_unsharded_collection]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For 'aggPlanHasStage' and 'getAggPlanStage'.
+
+    const coll = db.group_distinct_scan;
+    coll.drop();
+
+    const numCategories = 10;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 600; ++i) {
+        bulk.insert({
+            _id: i,
+            tenant: i % 3,
+            category: (i * 7) % numCategories,
+            price: (i * 13) % 101,
+            name: "item" + i
+        });
+    }
+    // Documents missing the group key form the null group.
+    bulk.insert({_id: "missing", tenant: 1, price: 5, name: "missing"});
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({tenant: 1, category: 1, price: 1}));
+
+    function sortById(results) {
+        return results.sort((a, b) => bsonWoCompare({_id: a._id}, {_id: b._id}));
+    }
+
+    // Runs 'pipeline' and checks that it produces the same groups as when the collection is
+    // scanned, which a hint prevents from using a DISTINCT_SCAN. Returns its explain.
+    function assertSameResultsAsCollectionScan(pipeline) {
+        const results = sortById(coll.aggregate(pipeline).toArray());
+        const expected = sortById(coll.aggregate(pipeline, {hint: {$natural: 1}}).toArray());
+        assert.eq(expected, results, tojson(pipeline));
+        return coll.explain("executionStats").aggregate(pipeline);
+    }
+
+    function assertUsesDistinctScan(pipeline) {
+        const explain = assertSameResultsAsCollectionScan(pipeline);
+        assert(aggPlanHasStage(explain, "DISTINCT_SCAN"), tojson(explain));
+        assert(!aggPlanHasStage(explain, "$sort"), tojson(explain));
+        return explain;
+    }
+
+    // The distinct values of an index field after an equality on the fields before it.
+    let explain = assertUsesDistinctScan(
+        [{$match: {tenant: 1}}, {$group: {_id: "$category", low: {$min: "$category"}}}]);
+    assert(!aggPlanHasStage(explain, "FETCH"), tojson(explain));
+
+    // The first and last documents of each group in the order of a $sort provided by the index.
+    // Only one document of each group is fetched.
+    explain = assertUsesDistinctScan([
+        {$match: {tenant: 1}},
+        {$sort: {category: 1, price: 1}},
+        {$group: {_id: "$category", cheapest: {$first: "$price"}, name: {$first: "$name"}}}
+    ]);
+    assert.lte(getAggPlanStage(explain, "DISTINCT_SCAN").keysExamined,
+               2 * (numCategories + 1) + 1,
+               tojson(explain));
+    assert.eq(explain.stages[0].$cursor.executionStats.totalDocsExamined,
+              numCategories + 1,
+              tojson(explain));
+
+    assertUsesDistinctScan([
+        {$match: {tenant: 1}},
+        {$sort: {category: 1, price: 1}},
+        {$group: {_id: "$category", priciest: {$last: "$price"}, doc: {$last: "$$ROOT"}}}
+    ]);
+    assertUsesDistinctScan([
+        {$match: {tenant: {$gte: 1}}},
+        {$sort: {tenant: -1, category: -1, price: -1}},
+        {$group: {_id: "$category", doc: {$first: "$$ROOT"}}}
+    ]);
+
+    // Without a query or a $sort, the smallest index led by the group key is scanned.
+    assertUsesDistinctScan([{$group: {_id: "$tenant", high: {$max: "$tenant"}}}]);
+
+    // Groups which need more than one document of each group, or a sort the index does not
+    // provide, still read all of them.
+    const pipelinesNeedingAllDocuments = [
+        [{$match: {tenant: 1}}, {$group: {_id: "$category", n: {$sum: 1}}}],
+        [{$match: {tenant: 1}}, {$group: {_id: "$category", low: {$min: "$price"}}}],
+        [
+          {$match: {tenant: 1}},
+          {$sort: {category: 1, price: 1}},
+          {$group: {_id: "$category", f: {$first: "$price"}, l: {$last: "$price"}}}
+        ],
+        [
+          {$match: {tenant: 1}},
+          {$sort: {name: 1}},
+          {$group: {_id: "$category", name: {$first: "$name"}}}
+        ],
+        [
+          {$match: {tenant: 1}},
+          {$sort: {category: 1, price: 1}},
+          {$limit: 20},
+          {$group: {_id: "$category", cheapest: {$first: "$price"}}}
+        ],
+        [{$match: {tenant: 1, name: /1/}}, {$group: {_id: "$category"}}],
+    ];
+    pipelinesNeedingAllDocuments.forEach(function(pipeline) {
+        const explain = assertSameResultsAsCollectionScan(pipeline);
+        assert(!aggPlanHasStage(explain, "DISTINCT_SCAN"), tojson(explain));
+    });
+
+    // A multikey index holds several entries for a document.
+    assert.writeOK(coll.insert({_id: "array", tenant: 1, category: [1, 2], price: 0, name: "a"}));
+    explain = assertSameResultsAsCollectionScan([
+        {$match: {tenant: 1}},
+        {$sort: {category: 1, price: 1}},
+        {$group: {_id: "$category", cheapest: {$first: "$price"}}}
+    ]);
+    assert(!aggPlanHasStage(explain, "DISTINCT_SCAN"), tojson(explain));
+})();
@@ -0,0 +1,33 @@
+// Tests that $out fails without modifying the target collection when the results violate a unique
+// index on the target, and that indexes are carried over when they are satisfied.
+(function() {
+    "use strict";
+
+    const coll = db.out_unique_index_source;
+    const target = db.out_unique_index_target;
+    coll.drop();
+    target.drop();
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i % 10, b: i}));
+    }
+    assert.writeOK(target.insert({_id: "original"}));
+    assert.commandWorked(target.createIndex({a: 1}, {unique: true}));
+
+    // The results have duplicate values for 'a', so building the unique index must fail.
+    assert.commandFailed(db.runCommand(
+        {aggregate: coll.getName(), pipeline: [{$out: target.getName()}], cursor: {}}));
+
+    // The target collection and its indexes should be untouched.
+    assert.eq(target.find().toArray(), [{_id: "original"}]);
+    assert.eq(target.getIndexes().length, 2);
+
+    // The temporary collection should have been cleaned up.
+    assert.eq(db.getCollectionNames().filter((name) => name.startsWith("tmp.agg_out")), []);
+
+    // When the results satisfy the index, it should exist on the new target collection.
+    coll.aggregate([{$match: {_id: {$lt: 10}}}, {$out: target.getName()}]);
+    assert.eq(target.find().itcount(), 10);
+    assert.eq(target.getIndexes().length, 2);
+    assert.eq(target.find({a: 5}).hint({a: 1}).itcount(), 1);
+}());
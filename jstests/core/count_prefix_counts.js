@@ -0,0 +1,131 @@
+// Tests that counts of documents by the values of the leading field of an index created with
+// {prefixCounts: true} are answered by the counts the index keeps, that these counts follow
+// inserts, updates and removes, and that an empty count hinted to an index which has a key for
+// every document is answered from the number of records of the collection.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    const coll = db.count_prefix_counts;
+    coll.drop();
+
+    // The option is only accepted as a boolean, on btree indexes, and for indexes which have a key
+    // for every document.
+    assert.commandFailedWithCode(coll.createIndex({tenant: 1}, {prefixCounts: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({tenant: 'text'}, {prefixCounts: true}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(
+        coll.createIndex({tenant: 1},
+                         {prefixCounts: true, partialFilterExpression: {tenant: {$gt: 0}}}),
+        ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(
+        coll.createIndex({tenant: 1}, {prefixCounts: true, deferred: true}),
+        ErrorCodes.CannotCreateIndex);
+
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, tenant: 't' + (i % 4), x: i}));
+    }
+    assert.commandWorked(coll.createIndex({tenant: 1, x: 1}, {prefixCounts: true}));
+    assert.eq(true,
+              coll.getIndexes().filter(index => index.name === 'tenant_1_x_1')[0].prefixCounts);
+    assert.commandWorked(coll.createIndex({x: 1}));
+    assert.commandWorked(coll.createIndex({y: 1}, {sparse: true}));
+
+    function getCountStage(query, hint) {
+        const explain = coll.explain('executionStats').count(query, {hint: hint});
+        return getPlanStage(explain.executionStats.executionStages, 'COUNT');
+    }
+
+    // Checks that the count of 'query' is answered by the prefix counts, and that it is the same
+    // as the number of documents a collection scan finds.
+    function assertPrefixCount(query, expected) {
+        const stage = getCountStage(query);
+        assert.eq('tenant_1_x_1', stage.prefixCountIndex, tojson(stage));
+        assert.eq(expected, coll.count(query), tojson(query));
+        assert.eq(expected, coll.find(query).hint({$natural: 1}).itcount(), tojson(query));
+    }
+
+    assertPrefixCount({tenant: 't1'}, 25);
+    assertPrefixCount({tenant: {$in: ['t1', 't2', 't1']}}, 50);
+    assertPrefixCount({tenant: 'none'}, 0);
+    assert.eq(10, coll.count({tenant: 't1'}, {limit: 10}));
+    assert.eq(5, coll.count({tenant: 't1'}, {skip: 20}));
+
+    // Inserts, updates which move documents between tenants and removes are reflected in the
+    // counts once they commit.
+    assert.writeOK(coll.insert({_id: 100, tenant: 't1'}));
+    assertPrefixCount({tenant: 't1'}, 26);
+    assert.writeOK(coll.update({tenant: 't2'}, {$set: {tenant: 't1'}}, {multi: true}));
+    assertPrefixCount({tenant: 't1'}, 51);
+    assertPrefixCount({tenant: 't2'}, 0);
+    assert.writeOK(coll.update({_id: 1}, {$set: {x: -1}}));
+    assertPrefixCount({tenant: 't1'}, 51);
+    assert.writeOK(coll.remove({tenant: 't1', x: {$lt: 50}}));
+    assertPrefixCount({tenant: 't1'}, 26);
+
+    // A document with an array of tenants is counted once for each of them, so an $in on a
+    // multikey index is counted by a plan.
+    assert.writeOK(coll.insert({_id: 200, tenant: ['t3', 't5', 't5']}));
+    assertPrefixCount({tenant: 't5'}, 1);
+    assertPrefixCount({tenant: 't3'}, 26);
+    let stage = getCountStage({tenant: {$in: ['t3', 't5']}});
+    assert(!stage.hasOwnProperty('prefixCountIndex'), tojson(stage));
+    assert.eq(26, coll.count({tenant: {$in: ['t3', 't5']}}));
+    assert.writeOK(coll.update({_id: 200}, {$set: {tenant: ['t5']}}));
+    assertPrefixCount({tenant: 't3'}, 25);
+    assertPrefixCount({tenant: 't5'}, 1);
+
+    // Other predicates, including on values which don't match the keys they generate, are
+    // counted by a plan.
+    for (let query of [{tenant: null},
+                       {tenant: ['t5']},
+                       {tenant: /t/},
+                       {tenant: {$in: ['t1', /t/]}},
+                       {tenant: 't1', x: 75},
+                       {x: 1}]) {
+        stage = getCountStage(query);
+        assert(!stage.hasOwnProperty('prefixCountIndex'), tojson(stage));
+        assert.eq(coll.find(query).itcount(), coll.count(query), tojson(query));
+    }
+
+    // So are counts hinted to another index, or with another collation.
+    stage = getCountStage({tenant: 't1'}, {x: 1});
+    assert(!stage.hasOwnProperty('prefixCountIndex'), tojson(stage));
+    stage = getCountStage({tenant: 't1'}, 'tenant_1_x_1');
+    assert.eq('tenant_1_x_1', stage.prefixCountIndex, tojson(stage));
+    const caseInsensitive = {locale: 'en', strength: 2};
+    stage = getPlanStage(coll.explain('executionStats')
+                             .find({tenant: 'T1'})
+                             .collation(caseInsensitive)
+                             .count()
+                             .executionStats.executionStages,
+                         'COUNT');
+    assert(!stage.hasOwnProperty('prefixCountIndex'), tojson(stage));
+    assert.eq(26, coll.count({tenant: 'T1'}, {collation: caseInsensitive}));
+
+    // An empty count hinted to an index which has a key for every document is answered from the
+    // number of records, but not one hinted to a sparse index.
+    const numDocs = coll.find().itcount();
+    let countExplain = coll.explain('executionStats').count({}, {hint: {x: 1}});
+    assert(!countExplain.queryPlanner.winningPlan.hasOwnProperty('inputStage'),
+           tojson(countExplain));
+    assert.eq(0, countExplain.executionStats.totalKeysExamined, tojson(countExplain));
+    assert.eq(numDocs, coll.count({}, {hint: {x: 1}}));
+    assert.eq(numDocs, coll.count({}, {hint: 'x_1'}));
+
+    assert.writeOK(coll.insert({_id: 300, y: 1}));
+    countExplain = coll.explain('executionStats').count({}, {hint: {y: 1}});
+    assert(countExplain.queryPlanner.winningPlan.hasOwnProperty('inputStage'),
+           tojson(countExplain));
+    assert.eq(1, coll.count({}, {hint: {y: 1}}));
+    assert.commandFailed(
+        db.runCommand({count: coll.getName(), query: {}, hint: {doesNotExist: 1}}));
+
+    // The counts are rebuilt when the index is rebuilt.
+    assert.commandWorked(coll.reIndex());
+    assertPrefixCount({tenant: 't1'}, 26);
+    assertPrefixCount({tenant: 't5'}, 1);
+})();
@@ -0,0 +1,61 @@
+// Tests the parallel and incremental modes of dbHash.
+(function() {
+    "use strict";
+
+    const mydb = db.getSiblingDB("dbhash_parallel_incremental");
+    assert.commandWorked(mydb.dropDatabase());
+
+    for (let i = 0; i < 5; i++) {
+        const coll = mydb["c" + i];
+        for (let j = 0; j < 20; j++) {
+            assert.writeOK(coll.insert({_id: j, x: i * j}));
+        }
+    }
+    assert.commandWorked(mydb.createCollection("empty"));
+
+    // Parallel hashing reports the same hashes as hashing under the database lock.
+    const serial = assert.commandWorked(mydb.runCommand({dbHash: 1}));
+    const parallel = assert.commandWorked(mydb.runCommand({dbHash: 1, parallel: 3}));
+    assert.eq(serial.collections, parallel.collections);
+    assert.eq(serial.md5, parallel.md5);
+
+    assert.commandFailedWithCode(mydb.runCommand({dbHash: 1, parallel: 0}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(mydb.runCommand({dbHash: 1, parallel: "2"}),
+                                 ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(mydb.runCommand({dbHash: 1, incremental: 1}),
+                                 ErrorCodes.TypeMismatch);
+
+    function incrementalHash(collName, parallelism) {
+        const res = assert.commandWorked(mydb.runCommand(
+            {dbHash: 1, collections: [collName], incremental: true, parallel: parallelism || 1}));
+        return res.collections[collName];
+    }
+
+    // The first incremental request seeds the hash from a scan, later ones report it as it is
+    // maintained by the writes to the collection.
+    const seeded = incrementalHash("c1");
+    assert.eq(seeded, incrementalHash("c1", 2));
+
+    const c1 = mydb.c1;
+    assert.writeOK(c1.insert({_id: 100, x: "new"}));
+    const afterInsert = incrementalHash("c1");
+    assert.neq(seeded, afterInsert);
+
+    assert.writeOK(c1.remove({_id: 100}));
+    assert.eq(seeded, incrementalHash("c1"));
+
+    // The maintained hash matches one seeded from scratch over the same documents, whatever order
+    // they were written in.
+    assert.writeOK(c1.update({_id: 3}, {$set: {x: "updated"}}));
+    assert.writeOK(c1.update({_id: 4}, {$inc: {x: 1}}));
+    assert.writeOK(c1.remove({_id: 5}));
+    assert.writeOK(c1.insert({_id: 200, x: [1, 2, 3]}));
+
+    const copy = mydb.c1_copy;
+    const docs = c1.find().sort({_id: -1}).toArray();
+    docs.forEach(doc => assert.writeOK(copy.insert(doc)));
+    assert.eq(incrementalHash("c1"), incrementalHash("c1_copy", 2));
+
+    // Incremental hashes are independent of document order, so they differ from scan hashes.
+    assert.neq(serial.collections.c2, incrementalHash("c2"));
+})();
@@ -0,0 +1,34 @@
+// Tests the xxhash64 mode of dbHash.
+(function() {
+    "use strict";
+
+    const mydb = db.getSiblingDB("dbhash_xxhash64");
+    assert.commandWorked(mydb.dropDatabase());
+
+    const coll = mydb.foo;
+    assert.writeOK(coll.insert({_id: 1, x: 1}));
+
+    const md5Res = assert.commandWorked(mydb.runCommand({dbHash: 1}));
+    assert.eq("string", typeof md5Res.md5, tojson(md5Res));
+
+    const res1 = assert.commandWorked(mydb.runCommand({dbHash: 1, hashAlgorithm: "xxhash64"}));
+    assert.eq(undefined, res1.md5, tojson(res1));
+    assert.eq(16, res1.xxhash64.length, tojson(res1));
+    assert.eq(16, res1.collections.foo.length, tojson(res1));
+
+    // The hash is deterministic and changes with the contents of the collection.
+    const res2 = assert.commandWorked(mydb.runCommand({dbHash: 1, hashAlgorithm: "xxhash64"}));
+    assert.eq(res1.xxhash64, res2.xxhash64);
+    assert.eq(res1.collections.foo, res2.collections.foo);
+
+    assert.writeOK(coll.insert({_id: 2, x: 2}));
+    const res3 = assert.commandWorked(mydb.runCommand({dbHash: 1, hashAlgorithm: "xxhash64"}));
+    assert.neq(res1.xxhash64, res3.xxhash64);
+    assert.neq(res1.collections.foo, res3.collections.foo);
+
+    assert.commandWorked(mydb.runCommand({dbHash: 1, hashAlgorithm: "md5"}));
+    assert.commandFailedWithCode(mydb.runCommand({dbHash: 1, hashAlgorithm: "sha1"}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(mydb.runCommand({dbHash: 1, hashAlgorithm: 1}),
+                                 ErrorCodes.TypeMismatch);
+})();
@@ -0,0 +1,80 @@
+// Tests findAndModify by _id with a projection of the returned document, which is answered by an
+// IDHACK plan without canonicalizing the query unless the projection depends on it.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    const coll = db.find_and_modify_id_projection;
+    coll.drop();
+
+    function reset() {
+        coll.drop();
+        assert.writeOK(coll.insert({_id: 1, a: 1, b: {c: 2, d: 3}, arr: [{x: 1}, {x: 2}, {x: 3}]}));
+    }
+
+    function runFindAndModify(args) {
+        const res = assert.commandWorked(
+            db.runCommand(Object.extend({findAndModify: coll.getName(), query: {_id: 1}}, args)));
+        return res.value;
+    }
+
+    // Inclusion, exclusion and dotted projections of the pre-image and the post-image.
+    reset();
+    assert.eq({_id: 1, a: 1}, runFindAndModify({update: {$inc: {a: 1}}, fields: {a: 1}}));
+    assert.eq({_id: 1, a: 3},
+              runFindAndModify({update: {$inc: {a: 1}}, fields: {a: 1}, new: true}));
+    assert.eq({a: 4},
+              runFindAndModify({update: {$inc: {a: 1}}, fields: {_id: 0, a: 1}, new: true}));
+    assert.eq({_id: 1, b: {c: 2}},
+              runFindAndModify({update: {$set: {'b.d': 4}}, fields: {'b.c': 1}, new: true}));
+    assert.eq({_id: 1, a: 5, b: {c: 2, d: 4}},
+              runFindAndModify({update: {$inc: {a: 1}}, fields: {arr: 0}, new: true}));
+
+    // $slice and $elemMatch projections do not need the query.
+    assert.eq({_id: 1, arr: [{x: 3}]},
+              runFindAndModify({update: {$inc: {a: 1}}, fields: {arr: {$slice: -1}, a: 0, b: 0}}));
+    assert.eq({_id: 1, arr: [{x: 2}]}, runFindAndModify({
+                  update: {$inc: {a: 1}},
+                  fields: {arr: {$elemMatch: {x: {$gt: 1}}}},
+                  new: true
+              }));
+
+    // Upserts return the projected new document.
+    assert.eq({_id: 2, z: 1}, runFindAndModify({
+                  query: {_id: 2},
+                  update: {$set: {z: 1, y: 1}},
+                  fields: {z: 1},
+                  upsert: true,
+                  new: true
+              }));
+
+    // A positional projection depends on the query, and is still validated against it.
+    reset();
+    assert.commandFailed(db.runCommand({
+        findAndModify: coll.getName(),
+        query: {_id: 1},
+        update: {$inc: {a: 1}},
+        fields: {'arr.$': 1}
+    }));
+    assert.eq(1, coll.findOne({_id: 1}).a);
+
+    // Removes return the projected deleted document.
+    assert.eq({_id: 1, a: 1}, runFindAndModify({remove: true, fields: {a: 1}}));
+    assert.eq(null, coll.findOne({_id: 1}));
+
+    // Both use an IDHACK plan.
+    reset();
+    let explain = assert.commandWorked(db.runCommand({
+        explain:
+            {findAndModify: coll.getName(), query: {_id: 1}, update: {$inc: {a: 1}}, fields: {a: 1}}
+    }));
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'IDHACK'), tojson(explain));
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'PROJECTION'), tojson(explain));
+
+    explain = assert.commandWorked(db.runCommand(
+        {explain: {findAndModify: coll.getName(), query: {_id: 1}, remove: true, fields: {a: 1}}}));
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'IDHACK'), tojson(explain));
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'PROJECTION'), tojson(explain));
+})();
@@ -0,0 +1,44 @@
+// Test that a limited sort on text score only fetches the documents it returns.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var t = db.fts_score_sort_limit;
+    t.drop();
+
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        // Repeating the term raises the score of documents with larger _id.
+        bulk.insert({_id: i, a: "common " + "rare ".repeat(i % 10), b: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.ensureIndex({a: "text"}));
+
+    function checkTopK(search, filter, limit) {
+        var query = Object.extend({$text: {$search: search}}, filter);
+        var proj = {score: {$meta: "textScore"}};
+        var sort = {score: {$meta: "textScore"}};
+
+        var all = t.find(query, proj).sort(sort).toArray();
+        var limited = t.find(query, proj).sort(sort).limit(limit).toArray();
+        assert.eq(Math.min(limit, all.length), limited.length);
+        for (var i = 0; i < limited.length; i++) {
+            assert.eq(all[i].score, limited[i].score, tojson(limited));
+        }
+        return t.find(query, proj).sort(sort).limit(limit).explain("executionStats");
+    }
+
+    // Only the documents returned are fetched.
+    var explain = checkTopK("common rare", {}, 5);
+    assert.eq(5, getPlanStage(explain.executionStats.executionStages, "TEXT_OR").docsExamined);
+
+    // Filtering on a non-text field still gives the best scoring matches.
+    checkTopK("common rare", {b: 1}, 5);
+
+    // Negated terms are applied above TEXT_OR, which then has to fetch every positive match.
+    explain = checkTopK("common -rare", {}, 5);
+    assert.eq(100, getPlanStage(explain.executionStats.executionStages, "TEXT_OR").docsExamined);
+    assert.eq(10, t.find({$text: {$search: "common -rare"}}).itcount());
+}());
@@ -0,0 +1,50 @@
+// Cannot implicitly shard accessed collections because of use of $near query instead of geoNear
+// command.
+// @tags: [assumes_unsharded_collection]
+
+// Tests that a 2dsphere $near search stays correct, and does not buffer the whole collection for a
+// small limit, when the density of the data changes sharply between search annuli.
+(function() {
+    "use strict";
+
+    var t = db.geo_s2near_adaptive_intervals;
+    t.drop();
+
+    var origin = {type: "Point", coordinates: [0, 0]};
+    var bulk = t.initializeUnorderedBulkOp();
+
+    // A dense cluster around the origin...
+    for (var x = 0; x < 40; x++) {
+        for (var y = 0; y < 25; y++) {
+            bulk.insert({loc: {type: "Point", coordinates: [x * 0.0025, y * 0.004]}});
+        }
+    }
+
+    // ...and a few points spread much further out.
+    for (var i = 1; i <= 30; i++) {
+        bulk.insert({loc: {type: "Point", coordinates: [i * 2, (i % 5) * 10 - 20]}});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.createIndex({loc: "2dsphere"}));
+
+    var nDocs = t.count();
+
+    // Every document is returned, in non-decreasing distance order.
+    var results =
+        t.aggregate([{
+             $geoNear: {near: origin, distanceField: "dist", spherical: true, num: nDocs + 1}
+         }])
+            .toArray();
+    assert.eq(nDocs, results.length);
+    for (var j = 1; j < results.length; j++) {
+        assert.lte(results[j - 1].dist, results[j].dist, tojson(results[j]));
+    }
+
+    assert.eq(nDocs, t.find({loc: {$near: {$geometry: origin}}}).itcount());
+
+    // A small limit is satisfied from the first few annuli near the cluster.
+    var explain =
+        t.find({loc: {$near: {$geometry: origin}}}).limit(5).explain("executionStats");
+    assert.eq(5, explain.executionStats.nReturned);
+    assert.lt(explain.executionStats.totalDocsExamined, nDocs / 2, tojson(explain));
+})();
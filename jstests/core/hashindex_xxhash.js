@@ -0,0 +1,46 @@
+// Cannot implicitly shard accessed collections because of extra shard key index in sharded
+// collection.
+// @tags: [assumes_no_implicit_index_creation]
+
+// Tests hashed indexes built with the xxHash-based hash function (hashVersion 1).
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For isIxscan.
+
+    var t = db.hashindex_xxhash;
+    t.drop();
+
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(t.insert({a: i, b: {c: i % 7}}));
+    }
+    assert.writeOK(t.insert({b: 1}));
+
+    assert.commandWorked(t.createIndex({a: "hashed"}, {hashVersion: 1}));
+    assert.commandWorked(t.createIndex({b: "hashed"}, {hashVersion: 1}));
+
+    // Only hashVersion 0 and 1 exist, and only for hashed indexes.
+    assert.commandFailedWithCode(t.createIndex({a: "hashed"}, {name: "bad", hashVersion: 2}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(t.createIndex({a: 1}, {hashVersion: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    // Equality lookups through the index must find the same documents as a collection scan.
+    function assertUsesIndexAndMatches(query, expectedCount) {
+        assert.eq(expectedCount, t.find(query).hint({$natural: 1}).itcount());
+
+        var hint = {};
+        hint[Object.keys(query)[0]] = "hashed";
+        assert.eq(expectedCount, t.find(query).hint(hint).itcount());
+        var explain = t.find(query).hint(hint).explain();
+        assert(isIxscan(db, explain.queryPlanner.winningPlan), tojson(explain));
+    }
+
+    assertUsesIndexAndMatches({a: 42}, 1);
+    assertUsesIndexAndMatches({a: 42.0}, 1);
+    assertUsesIndexAndMatches({a: {$in: [1, 2, 3, 1000]}}, 3);
+    assertUsesIndexAndMatches({a: null}, 1);
+    assertUsesIndexAndMatches({b: {c: 3}}, 14);
+
+    assert.commandWorked(t.validate(true));
+})();
@@ -0,0 +1,57 @@
+// Tests that inserting into a collection with several partial indexes whose filters share clauses
+// maintains each index according to its own filter.
+(function() {
+    "use strict";
+    var coll = db.index_partial_shared_filters;
+
+    var getNumKeys = function(idxName) {
+        var res = assert.commandWorked(coll.validate(true));
+        var kpi;
+
+        var isShardedNS = res.hasOwnProperty('raw');
+        if (isShardedNS) {
+            kpi = res.raw[Object.getOwnPropertyNames(res.raw)[0]].keysPerIndex;
+        } else {
+            kpi = res.keysPerIndex;
+        }
+        return kpi[coll.getFullName() + ".$" + idxName];
+    };
+
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex(
+        {x: 1}, {name: "a_active", partialFilterExpression: {type: "a", status: "active"}}));
+    assert.commandWorked(coll.createIndex(
+        {x: 1}, {name: "b_active", partialFilterExpression: {type: "b", status: "active"}}));
+    assert.commandWorked(coll.createIndex(
+        {y: 1}, {name: "active", partialFilterExpression: {status: "active"}}));
+    assert.commandWorked(coll.createIndex(
+        {y: 1}, {name: "large", partialFilterExpression: {x: {$gt: 50}}}));
+
+    var docs = [];
+    for (var i = 0; i < 100; ++i) {
+        docs.push({
+            _id: i,
+            x: i,
+            y: i,
+            type: (i % 2 === 0) ? "a" : "b",
+            status: (i % 3 === 0) ? "active" : "inactive"
+        });
+    }
+    assert.writeOK(coll.insert(docs));
+
+    assert.eq(17, getNumKeys("a_active"));
+    assert.eq(17, getNumKeys("b_active"));
+    assert.eq(34, getNumKeys("active"));
+    assert.eq(49, getNumKeys("large"));
+
+    // Single document inserts take the same path.
+    assert.writeOK(coll.insert({_id: 100, x: 100, y: 100, type: "a", status: "active"}));
+    assert.eq(18, getNumKeys("a_active"));
+    assert.eq(17, getNumKeys("b_active"));
+    assert.eq(35, getNumKeys("active"));
+    assert.eq(50, getNumKeys("large"));
+
+    assert.eq(18, coll.find({type: "a", status: "active"}).hint("a_active").itcount());
+    assert.eq(35, coll.find({status: "active"}).hint("active").itcount());
+})();
@@ -0,0 +1,44 @@
+// Cannot implicitly shard accessed collections because of the unique index on a non-shard-key
+// field.
+// @tags: [assumes_unsharded_collection]
+
+// Tests that multi-document inserts, whose index keys are inserted into each index in key order
+// rather than document order, leave every index consistent with the collection.
+(function() {
+    "use strict";
+
+    var t = db.insert_batch_index_keys;
+    t.drop();
+
+    assert.commandWorked(t.createIndex({a: 1}));
+    assert.commandWorked(t.createIndex({b: -1, a: 1}));
+    assert.commandWorked(t.createIndex({arr: 1}));
+    assert.commandWorked(t.createIndex({u: 1}, {unique: true, sparse: true}));
+
+    var docs = [];
+    for (var i = 0; i < 500; i++) {
+        docs.push({_id: i, a: (i * 7919) % 500, b: i % 13, arr: [i % 5, (i + 1) % 5], u: i});
+    }
+    assert.writeOK(t.insert(docs));
+    assert.eq(500, t.count());
+
+    assert.eq(500, t.find({a: {$gte: 0}}).hint({a: 1}).itcount());
+    assert.eq(500, t.find({b: {$gte: 0}}).hint({b: -1, a: 1}).itcount());
+    assert.eq(200, t.find({arr: 2}).hint({arr: 1}).itcount());
+    assert.eq(1, t.find({u: 123}).hint({u: 1}).itcount());
+
+    var explain = t.find({arr: 2}).hint({arr: 1}).explain();
+    assert(explain.queryPlanner.winningPlan.inputStage.isMultiKey, tojson(explain));
+
+    // A duplicate key inside a batch fails that document without leaving stray index keys.
+    var res = t.insert([{_id: 1000, u: 1000}, {_id: 1001, u: 1000}, {_id: 1002, u: 1002}],
+                       {ordered: false});
+    assert.eq(1, res.getWriteErrors().length, tojson(res));
+    assert.eq(ErrorCodes.DuplicateKey, res.getWriteErrors()[0].code, tojson(res));
+    assert.eq(502, t.count());
+    assert.eq(502, t.find({_id: {$gte: 0}}).hint({_id: 1}).itcount());
+
+    var validateRes = t.validate(true);
+    assert.commandWorked(validateRes);
+    assert(validateRes.valid, tojson(validateRes));
+})();
@@ -0,0 +1,46 @@
+// Tests that consecutive mapReduce jobs on the same connection, which may reuse the same JS scope,
+// each see only their own functions, scope variables and natives.
+(function() {
+    'use strict';
+
+    const coll = db.mr_scope_reuse;
+    coll.drop();
+    for (let i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({_id: i, k: i % 4}));
+    }
+
+    function runJob(multiplier, jsMode) {
+        const res = coll.mapReduce(
+            function() {
+                emit(this.k, multiplier);
+            },
+            function(key, values) {
+                return Array.sum(values);
+            },
+            {out: {inline: 1}, scope: {multiplier: multiplier}, jsMode: jsMode});
+        assert.commandWorked(res);
+        return res.results.sort(function(a, b) {
+            return a._id - b._id;
+        });
+    }
+
+    for (let round = 1; round <= 15; round++) {
+        const results = runJob(round, round % 2 === 0);
+        assert.eq(4, results.length);
+        results.forEach(function(result) {
+            assert.eq(5 * round, result.value, tojson(result));
+        });
+    }
+
+    // The natives of earlier jobs are not left behind for later jobs to call.
+    assert.throws(function() {
+        coll.mapReduce(
+            function() {
+                _bailFromJS(this.k, 1);
+            },
+            function(key, values) {
+                return Array.sum(values);
+            },
+            {out: {inline: 1}});
+    });
+})();
@@ -0,0 +1,54 @@
+// Tests that an index whose indexed paths are all multikey keeps returning correct results and
+// reporting the same multikey paths, once inserts and updates stop computing multikey paths.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.multikey_all_paths;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({"a.b": 1, c: 1}));
+
+    function getIxscan() {
+        var explain = coll.find({"a.b": {$gte: 0}, c: {$gte: 0}}).explain();
+        assert(planHasStage(explain.queryPlanner.winningPlan, "IXSCAN"), tojson(explain));
+        return getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+    }
+
+    function assertMultikeyPaths(expected) {
+        var stage = getIxscan();
+        assert.eq(true, stage.isMultiKey, tojson(stage));
+        if (jsTest.options().storageEngine !== "mmapv1") {
+            assert.eq(expected, stage.multiKeyPaths, tojson(stage));
+        }
+    }
+
+    // Only "a" and "c" make the index multikey so far.
+    assert.writeOK(coll.insert({_id: 0, a: [{b: 1}, {b: 2}], c: [1, 2]}));
+    assertMultikeyPaths({"a.b": ["a"], c: ["c"]});
+
+    // Now every component of every indexed field does.
+    assert.writeOK(coll.insert({_id: 1, a: {b: [3, 4]}, c: 3}));
+    assertMultikeyPaths({"a.b": ["a", "a.b"], c: ["c"]});
+
+    // Further writes of arrays must still be indexed correctly.
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 2; i < 50; i++) {
+        bulk.insert({_id: i, a: [{b: [i, i + 100]}, {b: i + 200}], c: [i, i + 1]});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.insert({_id: 50, a: [{b: [500, 501]}], c: [50]}));
+    assert.writeOK(coll.update({_id: 49}, {$set: {a: [{b: [900, 901]}], c: [9, 10]}}));
+    assertMultikeyPaths({"a.b": ["a", "a.b"], c: ["c"]});
+
+    assert.eq(1, coll.find({"a.b": 7, c: 8}).hint({"a.b": 1, c: 1}).itcount());
+    assert.eq(1, coll.find({"a.b": 207, c: 7}).hint({"a.b": 1, c: 1}).itcount());
+    assert.eq(1, coll.find({"a.b": 501, c: 50}).hint({"a.b": 1, c: 1}).itcount());
+    assert.eq(1, coll.find({"a.b": 901, c: 10}).hint({"a.b": 1, c: 1}).itcount());
+    assert.eq(0, coll.find({"a.b": 149, c: 49}).hint({"a.b": 1, c: 1}).itcount());
+
+    var validateRes = coll.validate(true);
+    assert.commandWorked(validateRes);
+    assert(validateRes.valid, tojson(validateRes));
+})();
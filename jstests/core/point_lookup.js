@@ -0,0 +1,114 @@
+// Tests that equalities and $in lists on all of the fields of a unique index are answered by a
+// POINT_LOOKUP plan, which seeks the index for each key, and that it returns the same documents as
+// the plans the query planner chooses otherwise.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    const coll = db.point_lookup;
+    coll.drop();
+
+    for (let i = 0; i < 200; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i, b: i % 10, c: i % 7, arr: [i, i + 1000]}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}, {unique: true}));
+    assert.commandWorked(
+        coll.createIndex({b: 1, c: -1}, {unique: true, partialFilterExpression: {c: {$lt: 0}}}));
+    assert.commandWorked(coll.createIndex({arr: 1}, {unique: true}));
+    assert.commandWorked(coll.createIndex({c: 1}));
+    assert.commandWorked(coll.createIndex({c: 1, a: -1}, {unique: true}));
+
+    function getPointLookup(query, projection) {
+        const explain = coll.find(query, projection).explain('executionStats');
+        return getPlanStage(explain.executionStats.executionStages, 'POINT_LOOKUP');
+    }
+
+    function sortedIds(cursor) {
+        return cursor.toArray().map(doc => doc._id).sort((x, y) => x - y);
+    }
+
+    // Checks that 'query' uses a POINT_LOOKUP plan on 'indexName' and finds the same documents as
+    // a plan which scans the collection.
+    function assertPointLookup(query, indexName, expectedIds) {
+        const stage = getPointLookup(query);
+        assert.neq(null, stage, tojson(query));
+        assert.eq(indexName, stage.indexName, tojson(stage));
+        assert.eq(expectedIds, sortedIds(coll.find(query)), tojson(query));
+        assert.eq(expectedIds, sortedIds(coll.find(query).hint({$natural: 1})), tojson(query));
+    }
+
+    // Equality on a unique secondary index.
+    assertPointLookup({a: 17}, 'a_1', [17]);
+    assertPointLookup({a: 1000}, 'a_1', []);
+    assertPointLookup({a: NumberLong(17)}, 'a_1', [17]);
+
+    // $in lists on _id and on a unique index are looked up in index order, once per value.
+    const ids = [];
+    for (let i = 0; i < 100; i++) {
+        ids.push((i * 37) % 250);
+    }
+    const expectedIds = Array.from(new Set(ids.filter(id => id < 200))).sort((x, y) => x - y);
+    assertPointLookup({_id: {$in: ids}}, '_id_', expectedIds);
+    assertPointLookup({a: {$in: ids}}, 'a_1', expectedIds);
+    assert.eq(100, getPointLookup({_id: {$in: ids}}).numKeys);
+    assert.eq([3, 5], coll.find({_id: {$in: [5, 3, 5.0]}}).toArray().map(doc => doc._id));
+
+    // Every combination of the values of a compound index is looked up.
+    assertPointLookup({a: {$in: [3, 4, 10]}, c: {$in: [3, 4]}}, 'c_1_a_-1', [3, 4]);
+    assert.eq(6, getPointLookup({a: {$in: [3, 4, 10]}, c: {$in: [3, 4]}}).numKeys);
+
+    // A multikey index returns each document once, even when several of its keys are looked up.
+    assertPointLookup({arr: {$in: [5, 1005, 6]}}, 'arr_1', [5, 6]);
+
+    // The other predicates of the query are still applied to the documents found.
+    assertPointLookup({_id: {$in: [1, 2, 3]}, a: {$in: [2, 3, 4]}}, '_id_', [2, 3]);
+
+    // Limits and projections are applied on top of the lookups.
+    assert.eq(2, coll.find({_id: {$in: [1, 2, 3]}}).limit(2).itcount());
+    assert.eq({a: 17, b: 7}, coll.findOne({a: 17}, {_id: 0, a: 1, b: 1}));
+
+    // Queries which are not equalities on all the fields of a usable unique index are planned.
+    assert.eq(null, getPointLookup({c: 3}));
+    assert.eq(null, getPointLookup({b: 0, c: 0}));
+    assert.eq(null, getPointLookup({a: {$in: [1, /2/]}}));
+    assert.eq(null, getPointLookup({a: null}));
+    assert.eq(null, getPointLookup({a: [1, 2]}));
+    assert.eq(null, getPointLookup({a: {$gte: 1, $lte: 1}}));
+    assert.eq(null, getPointLookup({$or: [{a: 1}, {a: 2}]}));
+    assert(!planHasStage(coll.find({a: 17}).sort({b: 1}).explain().queryPlanner.winningPlan,
+                         'POINT_LOOKUP'));
+    assert(!planHasStage(coll.find({a: 17}).hint({c: 1}).explain().queryPlanner.winningPlan,
+                         'POINT_LOOKUP'));
+
+    // A projection covered by the index is left to the planner, which does not fetch anything.
+    assert.eq(null, getPointLookup({a: 17}, {_id: 0, a: 1}));
+
+    // The lookup is only used when the index has the collation of the query.
+    coll.drop();
+    assert.commandWorked(
+        db.createCollection(coll.getName(), {collation: {locale: 'en_US', strength: 2}}));
+    assert.commandWorked(coll.createIndex({s: 1}, {unique: true}));
+    assert.writeOK(coll.insert({_id: 1, s: 'foo'}));
+    assert.neq(null, getPointLookup({s: 'FOO'}));
+    assert.eq(1, coll.find({s: 'FOO'}).itcount());
+    const simpleExplain =
+        coll.find({s: 'FOO'}).collation({locale: 'simple'}).explain('executionStats');
+    assert.eq(null, getPlanStage(simpleExplain.executionStats.executionStages, 'POINT_LOOKUP'));
+    assert.eq(0, coll.find({s: 'FOO'}).collation({locale: 'simple'}).itcount());
+
+    // The fast path can be turned off.
+    const res = db.adminCommand({getParameter: 1, internalQueryPointLookupMaxKeys: 1});
+    if (res.ok) {
+        const maxKeys = res.internalQueryPointLookupMaxKeys;
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryPointLookupMaxKeys: 0}));
+        try {
+            assert.eq(null, getPointLookup({s: 'foo'}));
+        } finally {
+            assert.commandWorked(
+                db.adminCommand({setParameter: 1, internalQueryPointLookupMaxKeys: maxKeys}));
+        }
+    }
+})();
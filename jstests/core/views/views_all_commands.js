@@ -86,6 +86,7 @@
         _recvChunkStart: {skip: isAnInternalCommand},
         _recvChunkStatus: {skip: isAnInternalCommand},
         _transferMods: {skip: isAnInternalCommand},
+        abortBulkLoad: {skip: "Tested in noPassthrough/bulk_load_restore.js"},
         addShard: {skip: isUnrelated},
         addShardToZone: {skip: isUnrelated},
         aggregate: {command: {aggregate: "view", pipeline: [{$match: {}}], cursor: {}}},
@@ -99,9 +100,11 @@
         authenticate: {skip: isUnrelated},
         availableQueryOptions: {skip: isAnInternalCommand},
         balancerStart: {skip: isUnrelated},
+        beginBulkLoad: {skip: "Tested in noPassthrough/bulk_load_restore.js"},
         balancerStatus: {skip: isUnrelated},
         balancerStop: {skip: isUnrelated},
         buildInfo: {skip: isUnrelated},
+        bulkLoadInsert: {skip: "Tested in noPassthrough/bulk_load_restore.js"},
         captrunc: {
             command: {captrunc: "view", n: 2, inc: false},
             expectFailure: true,
@@ -119,6 +122,7 @@
         },
         collMod: {command: {collMod: "view", viewOn: "other", pipeline: []}},
         collStats: {skip: "Tested in views/views_coll_stats.js"},
+        commitBulkLoad: {skip: "Tested in noPassthrough/bulk_load_restore.js"},
         compact: {command: {compact: "view", force: true}, expectFailure: true, skipSharded: true},
         configureFailPoint: {skip: isUnrelated},
         connPoolStats: {skip: isUnrelated},
@@ -234,7 +238,9 @@
         getCmdLineOpts: {skip: isUnrelated},
         getDiagnosticData: {skip: isUnrelated},
         getLastError: {skip: isUnrelated},
+        getLockContention: {skip: isUnrelated},
         getLog: {skip: isUnrelated},
+        getOperationTraces: {skip: isUnrelated},
         getMore: {
             setup: function(conn) {
                 assert.writeOK(conn.collection.remove({}));
@@ -486,6 +492,8 @@
         },
         stageDebug: {skip: isAnInternalCommand},
         startSession: {skip: isAnInternalCommand},
+        startRecordingTraffic: {skip: isUnrelated},
+        stopRecordingTraffic: {skip: isUnrelated},
         top: {skip: "tested in views/views_stats.js"},
         touch: {
             command: {touch: "view", data: true},
@@ -0,0 +1,97 @@
+// Tests that applyOps with {parallel: true} applies a batch of CRUD ops the same way as a serial
+// applyOps, keeping the ops on each document in order, and that it still reports per-op results.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {applyOpsParallelWriterThreads: 4}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+
+    // Builds a batch which inserts, updates and deletes the same documents several times.
+    function makeOps(ns, numDocs) {
+        const ops = [];
+        for (let i = 0; i < numDocs; i++) {
+            ops.push({op: 'i', ns: ns, o: {_id: i, x: 0}});
+        }
+        for (let round = 1; round <= 3; round++) {
+            for (let i = 0; i < numDocs; i++) {
+                ops.push({op: 'u', ns: ns, o2: {_id: i}, o: {$set: {x: round}}});
+            }
+        }
+        for (let i = 0; i < numDocs; i += 3) {
+            ops.push({op: 'd', ns: ns, o: {_id: i}});
+            ops.push({op: 'i', ns: ns, o: {_id: i, x: 'reinserted'}});
+        }
+        for (let i = 1; i < numDocs; i += 3) {
+            ops.push({op: 'd', ns: ns, o: {_id: i}});
+        }
+        ops.push({op: 'n', ns: '', o: {msg: 'noop'}});
+        return ops;
+    }
+
+    const numDocs = 300;
+    const serial = testDB.apply_ops_serial;
+    const parallel = testDB.apply_ops_parallel;
+    assert.commandWorked(testDB.createCollection(serial.getName()));
+    assert.commandWorked(testDB.createCollection(parallel.getName()));
+
+    const serialOps = makeOps(serial.getFullName(), numDocs);
+    const parallelOps = makeOps(parallel.getFullName(), numDocs);
+    const serialRes =
+        assert.commandWorked(testDB.adminCommand({applyOps: serialOps, allowAtomic: false}));
+    const parallelRes = assert.commandWorked(
+        testDB.adminCommand({applyOps: parallelOps, allowAtomic: false, parallel: true}));
+
+    // The no-op is not counted, and results are reported in the order of the ops.
+    assert.eq(parallelOps.length - 1, parallelRes.applied);
+    assert.eq(serialRes.applied, parallelRes.applied);
+    assert.eq(serialRes.results, parallelRes.results);
+    assert.eq(serial.find().sort({_id: 1}).toArray(), parallel.find().sort({_id: 1}).toArray());
+    assert.eq(numDocs - Math.floor((numDocs + 1) / 3), parallel.count());
+
+    // A collection with a unique secondary index is applied in the order of the ops, so an op
+    // which frees up a key is applied before the op which takes it.
+    const unique = testDB.apply_ops_parallel_unique;
+    assert.commandWorked(unique.createIndex({k: 1}, {unique: true}));
+    const uniqueOps = [];
+    for (let i = 0; i < 100; i++) {
+        uniqueOps.push({op: 'i', ns: unique.getFullName(), o: {_id: i, k: i}});
+    }
+    for (let i = 0; i < 100; i++) {
+        uniqueOps.push({op: 'u', ns: unique.getFullName(), o2: {_id: i}, o: {$set: {k: -i - 1}}});
+        uniqueOps.push({op: 'i', ns: unique.getFullName(), o: {_id: 100 + i, k: i}});
+    }
+    assert.commandWorked(
+        testDB.adminCommand({applyOps: uniqueOps, allowAtomic: false, parallel: true}));
+    assert.eq(200, unique.find().itcount());
+    assert.eq(100, unique.find({k: {$lt: 0}}).itcount());
+
+    // An insert into a collection which does not exist fails the command, and the other ops are
+    // still applied.
+    const res = testDB.adminCommand({
+        applyOps: [
+            {op: 'i', ns: 'test.apply_ops_parallel_missing', o: {_id: 1}},
+            {op: 'i', ns: parallel.getFullName(), o: {_id: 'new'}}
+        ],
+        allowAtomic: false,
+        parallel: true
+    });
+    assert.commandFailed(res);
+    assert.eq(ErrorCodes.NamespaceNotFound, res.code);
+    assert.eq([false, true], res.results);
+    assert.eq(1, parallel.find({_id: 'new'}).itcount());
+
+    // Batches containing commands are applied serially.
+    assert.commandWorked(testDB.adminCommand({
+        applyOps: [
+            {op: 'c', ns: 'test.$cmd', o: {create: 'apply_ops_parallel_created'}},
+            {op: 'i', ns: 'test.apply_ops_parallel_created', o: {_id: 1}}
+        ],
+        allowAtomic: false,
+        parallel: true
+    }));
+    assert.eq(1, testDB.apply_ops_parallel_created.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
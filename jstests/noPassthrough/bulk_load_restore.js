@@ -0,0 +1,79 @@
+// Tests the bulk load commands, which restore a collection into a standalone server and build its
+// indexes in bulk when the load is committed.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.bulk_load_restore;
+
+    let res = assert.commandWorked(testDB.runCommand({
+        beginBulkLoad: coll.getName(),
+        options: {},
+        indexes: [{key: {a: 1}, name: 'a_1'}, {key: {b: 1}, name: 'b_1', unique: true}]
+    }));
+    const bulkLoadId = res.bulkLoadId;
+
+    // The collection cannot be bulk loaded twice.
+    assert.commandFailedWithCode(testDB.runCommand({beginBulkLoad: coll.getName()}),
+                                 ErrorCodes.NamespaceExists);
+
+    const numDocs = 1000;
+    for (let batch = 0; batch < 10; batch++) {
+        const docs = [];
+        for (let i = batch * numDocs / 10; i < (batch + 1) * numDocs / 10; i++) {
+            docs.push({_id: i, a: i % 7, b: i});
+        }
+        res = assert.commandWorked(testDB.runCommand(
+            {bulkLoadInsert: coll.getName(), bulkLoadId: bulkLoadId, documents: docs}));
+        assert.eq(docs.length, res.n);
+    }
+
+    // The id is only valid for its own collection.
+    assert.commandFailedWithCode(
+        testDB.runCommand({commitBulkLoad: 'other', bulkLoadId: bulkLoadId}),
+        ErrorCodes.NoSuchSession);
+
+    assert.commandWorked(
+        testDB.runCommand({commitBulkLoad: coll.getName(), bulkLoadId: bulkLoadId}));
+    assert.commandFailedWithCode(
+        testDB.runCommand({commitBulkLoad: coll.getName(), bulkLoadId: bulkLoadId}),
+        ErrorCodes.NoSuchSession);
+
+    assert.eq(numDocs, coll.find().itcount());
+    assert.eq(3, coll.getIndexes().length);
+    assert.eq(Math.floor((numDocs - 1) / 7) + 1, coll.find({a: 0}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({b: 10}).hint({b: 1}).itcount());
+    assert.writeErrorWithCode(coll.insert({_id: 'dup', b: 10}), ErrorCodes.DuplicateKey);
+
+    // A duplicate key, on the _id index or on a unique secondary index, fails the commit and
+    // drops the collection.
+    const dupColl = testDB.bulk_load_restore_dup;
+    [[{_id: 1, b: 1}, {_id: 2, b: 1}], [{_id: 1, b: 1}, {_id: 1, b: 2}]].forEach(function(docs) {
+        res = assert.commandWorked(testDB.runCommand({
+            beginBulkLoad: dupColl.getName(),
+            indexes: [{key: {b: 1}, name: 'b_1', unique: true}]
+        }));
+        assert.commandWorked(testDB.runCommand(
+            {bulkLoadInsert: dupColl.getName(), bulkLoadId: res.bulkLoadId, documents: docs}));
+        assert.commandFailedWithCode(
+            testDB.runCommand({commitBulkLoad: dupColl.getName(), bulkLoadId: res.bulkLoadId}),
+            ErrorCodes.DuplicateKey);
+        assert.eq(null, testDB.getCollectionInfos({name: dupColl.getName()})[0]);
+    });
+
+    // An aborted load drops the collection.
+    const abortColl = testDB.bulk_load_restore_abort;
+    res = assert.commandWorked(testDB.runCommand({beginBulkLoad: abortColl.getName()}));
+    assert.commandWorked(testDB.runCommand(
+        {bulkLoadInsert: abortColl.getName(), bulkLoadId: res.bulkLoadId, documents: [{x: 1}]}));
+    assert.commandWorked(
+        testDB.runCommand({abortBulkLoad: abortColl.getName(), bulkLoadId: res.bulkLoadId}));
+    assert.eq(null, testDB.getCollectionInfos({name: abortColl.getName()})[0]);
+
+    // Loads left unfinished do not prevent a clean shutdown.
+    assert.commandWorked(testDB.runCommand({beginBulkLoad: 'bulk_load_restore_unfinished'}));
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,88 @@
+/**
+ * Tests that with internalQueryExecCollectionScanShared enabled, a collection scan started while
+ * another scan of the same collection is running starts at the position of that scan, wraps around
+ * to read the documents before it and returns every document exactly once, and that scans which
+ * depend on natural order do not share.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine, whose records are in
+    // RecordId order.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const conn =
+        MongoRunner.runMongod({setParameter: {internalQueryExecCollectionScanShared: true}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.collection_scan_shared;
+
+    const numDocs = 2000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, a: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    function getCollScan(explain) {
+        const stage = explain.executionStats.executionStages;
+        assert.eq('COLLSCAN', stage.stage, tojson(explain));
+        return stage;
+    }
+
+    // A scan which runs alone starts at the beginning of the collection.
+    let collScan = getCollScan(coll.find({a: {$gte: 0}}).explain('executionStats'));
+    assert.eq(true, collScan.shared, tojson(collScan));
+    assert.eq(false, collScan.joinedSharedScan, tojson(collScan));
+    assert.eq(0, coll.find().limit(1).next()._id);
+
+    // Leave a scan open partway through the collection.
+    const openCursor = coll.find().batchSize(500);
+    for (let i = 0; i < 500; i++) {
+        assert.eq(i, openCursor.next()._id);
+    }
+
+    // A second scan starts where the open one is, and still returns every document once.
+    const ids = coll.find({}, {_id: 1}).toArray().map(doc => doc._id);
+    assert.eq(numDocs, ids.length);
+    assert.neq(0, ids[0], 'second scan did not join the open scan');
+    assert.eq(numDocs, new Set(ids).size);
+    ids.sort((a, b) => a - b);
+    for (let i = 0; i < numDocs; i++) {
+        assert.eq(i, ids[i]);
+    }
+    collScan = getCollScan(coll.find({a: {$gte: 0}}).explain('executionStats'));
+    assert.eq(true, collScan.joinedSharedScan, tojson(collScan));
+    assert.eq(numDocs, collScan.nReturned);
+
+    // Sorts on fields do not depend on the order of the scan.
+    assert.eq(numDocs / 10, coll.find({a: 3}).sort({_id: -1}).itcount());
+    assert.eq(numDocs - 1, coll.find().sort({_id: -1}).limit(1).next()._id);
+
+    // Scans in natural order do not share.
+    collScan = getCollScan(coll.find().sort({$natural: 1}).explain('executionStats'));
+    assert.eq(undefined, collScan.shared, tojson(collScan));
+    collScan = getCollScan(coll.find().hint({$natural: 1}).explain('executionStats'));
+    assert.eq(undefined, collScan.shared, tojson(collScan));
+    assert.eq(0, coll.find().sort({$natural: 1}).limit(1).next()._id);
+
+    // Once the open scan is exhausted, scans start at the beginning again.
+    while (openCursor.hasNext()) {
+        openCursor.next();
+    }
+    collScan = getCollScan(coll.find({a: {$gte: 0}}).explain('executionStats'));
+    assert.eq(false, collScan.joinedSharedScan, tojson(collScan));
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecCollectionScanShared: false}));
+    collScan = getCollScan(coll.find({a: {$gte: 0}}).explain('executionStats'));
+    assert.eq(undefined, collScan.shared, tojson(collScan));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,63 @@
+/**
+ * Tests that compact with {online: true} compacts a WiredTiger collection and its indexes under
+ * intent locks, so that writes to the collection proceed while it runs, and that it leaves the
+ * collection and its indexes consistent.
+ *
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const conn = MongoRunner.runMongod({setParameter: {compactOnlineThrottleMillis: 10}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.compact_online;
+
+    const numDocs = 20000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, a: i, padding: 'x'.repeat(500)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    // Leave most of the file free, so that there is space to reclaim.
+    assert.writeOK(coll.remove({_id: {$mod: [10, 0], $ne: 0}}));
+    assert.writeOK(coll.remove({_id: {$mod: [10, 1]}}));
+    const remaining = coll.count();
+
+    // Writes to the collection are not blocked while the compact runs.
+    const awaitCompact = startParallelShell(function() {
+        const res = assert.commandWorked(
+            db.getSiblingDB('test').runCommand({compact: 'compact_online', online: true}));
+        // At least one pass over the record store and each of the two indexes.
+        assert.gte(res.passes, 3, tojson(res));
+        assert.eq(2, res.indexesCompacted, tojson(res));
+    }, conn.port);
+    for (let i = 0; i < 500; i++) {
+        assert.writeOK(coll.insert({_id: numDocs + i, a: numDocs + i}));
+    }
+    awaitCompact();
+
+    assert.eq(remaining + 500, coll.find().itcount());
+    assert.eq(remaining + 500, coll.find().hint({a: 1}).itcount());
+    const validateRes = assert.commandWorked(coll.validate({full: true}));
+    assert(validateRes.valid, tojson(validateRes));
+
+    // Views and collections which do not exist cannot be compacted.
+    assert.commandWorked(testDB.createView('compact_online_view', coll.getName(), []));
+    assert.commandFailedWithCode(testDB.runCommand({compact: 'compact_online_view', online: true}),
+                                 ErrorCodes.CommandNotSupportedOnView);
+    assert.commandFailedWithCode(
+        testDB.runCommand({compact: 'compact_online_missing', online: true}),
+        ErrorCodes.NamespaceNotFound);
+
+    MongoRunner.stopMongod(conn);
+})();
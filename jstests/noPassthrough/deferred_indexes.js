@@ -0,0 +1,94 @@
+/**
+ * Tests that writes to an index created with {deferred: true} are applied to it in the background,
+ * that the index is consistent with the collection once they have been applied, and that it is
+ * rebuilt after an unclean shutdown lost the writes which had not been applied yet.
+ *
+ * This test requires persistence to ensure data survives a restart.
+ * @tags: [requires_persistence, requires_journaling]
+ */
+(function() {
+    'use strict';
+
+    const dbpath = MongoRunner.dataPath + 'deferred_indexes';
+    resetDbpath(dbpath);
+
+    const mongodArgs = {
+        dbpath: dbpath,
+        noCleanData: true,
+        journal: '',
+        setParameter: {deferredIndexApplyIntervalMillis: 10}
+    };
+    let conn = MongoRunner.runMongod(mongodArgs);
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let testDB = conn.getDB('test');
+    let coll = testDB.deferred_indexes;
+
+    // Deferred writes are applied without checking for duplicate keys.
+    assert.commandFailedWithCode(coll.createIndex({a: 1}, {deferred: true, unique: true}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: 1}, {deferred: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    assert.commandWorked(coll.createIndex({a: 1}, {deferred: true}));
+    assert.eq(true, coll.getIndexes().filter(index => index.name === 'a_1')[0].deferred);
+
+    function countViaIndex(query) {
+        return coll.find(query).hint({a: 1}).itcount();
+    }
+
+    // Inserts, updates (including one which makes the index multikey) and deletes all reach the
+    // index eventually.
+    for (let i = 0; i < 200; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+    assert.soon(() => countViaIndex({a: {$gte: 0}}) === 200, 'inserts were not applied');
+
+    assert.writeOK(coll.update({_id: {$lt: 20}}, {$inc: {a: 1000}}, {multi: true}));
+    assert.writeOK(coll.update({_id: 20}, {$set: {a: [-1, -2]}}));
+    assert.writeOK(coll.remove({_id: {$gte: 100}}));
+    assert.soon(() => countViaIndex({a: {$gte: 1000}}) === 20, 'updates were not applied');
+    assert.soon(() => countViaIndex({a: -2}) === 1, 'multikey update was not applied');
+    assert.soon(() => countViaIndex({a: {$gte: MinKey}}) === 100, 'deletes were not applied');
+    assert.eq(0, countViaIndex({a: 5}));
+
+    // validate applies the pending writes before checking the index.
+    let validateRes = assert.commandWorked(coll.validate({full: true}));
+    assert(validateRes.valid, tojson(validateRes));
+
+    const serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    assert.gt(serverStatus.metrics.deferredIndexes.passes, 0, tojson(serverStatus.metrics));
+
+    // Writes which have not been applied yet are lost when the server is killed, so the index is
+    // rebuilt on startup.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, deferredIndexApplyIntervalMillis: 1000 * 1000}));
+    for (let i = 200; i < 300; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}, {writeConcern: {j: true}}));
+    }
+    MongoRunner.stopMongod(conn, 9, {allowedExitCode: MongoRunner.EXIT_SIGKILL});
+
+    conn = MongoRunner.runMongod(mongodArgs);
+    assert.neq(null, conn, 'mongod was unable to restart after receiving a SIGKILL');
+    testDB = conn.getDB('test');
+    coll = testDB.deferred_indexes;
+
+    assert.eq(200, coll.find().itcount());
+    assert.eq(200, countViaIndex({a: {$gte: MinKey}}));
+    assert.eq(true, coll.getIndexes().filter(index => index.name === 'a_1')[0].deferred);
+    validateRes = assert.commandWorked(coll.validate({full: true}));
+    assert(validateRes.valid, tojson(validateRes));
+
+    // A clean shutdown applies the pending writes first.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, deferredIndexApplyIntervalMillis: 1000 * 1000}));
+    assert.writeOK(coll.insert({_id: 300, a: 300}));
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod(mongodArgs);
+    assert.neq(null, conn, 'mongod was unable to restart');
+    coll = conn.getDB('test').deferred_indexes;
+    assert.eq(1, countViaIndex({a: 300}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,45 @@
+// Tests that cursors return the same results, in the same order, while getMore prefetches their
+// next batch in the background, and that prefetched cursors can still be killed.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryGetMorePrefetchMaxBytes: 1024 * 1024}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.getmore_prefetch;
+
+    const numDocs = 1000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, padding: 'x'.repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Iterate with small batches, so that most getMores are served from a prefetched batch.
+    let expected = 0;
+    coll.find().sort({_id: 1}).batchSize(7).forEach(function(doc) {
+        assert.eq(expected++, doc._id);
+    });
+    assert.eq(numDocs, expected);
+
+    // Batches larger than what may be prefetched are completed by the getMore itself.
+    assert.eq(numDocs, coll.find({}, {padding: 0}).batchSize(2).itcount());
+    assert.eq(numDocs / 2, coll.find({_id: {$gte: numDocs / 2}}).batchSize(300).itcount());
+
+    // A cursor whose next batch is being or has been prefetched can be killed.
+    let res = assert.commandWorked(testDB.runCommand({find: coll.getName(), batchSize: 5}));
+    const cursorId = res.cursor.id;
+    res = assert.commandWorked(
+        testDB.runCommand({getMore: cursorId, collection: coll.getName(), batchSize: 5}));
+    assert.eq(5, res.cursor.nextBatch.length);
+    res = assert.commandWorked(
+        testDB.runCommand({killCursors: coll.getName(), cursors: [cursorId]}));
+    assert.eq([cursorId], res.cursorsKilled);
+    assert.commandFailedWithCode(
+        testDB.runCommand({getMore: cursorId, collection: coll.getName()}),
+        ErrorCodes.CursorNotFound);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,60 @@
+// Tests that concurrent updates of the same document, which conflict with each other, all apply
+// when the writers which conflict wait for the conflicting write to end, and that the conflicts
+// on hot documents are reported to serverStatus.
+// @tags: [requires_document_locking]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {hotDocumentWriteConflictMaxWaitMillis: 50}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.hot_document_write_conflicts;
+    assert.writeOK(coll.insert({_id: 'counter', n: 0}));
+
+    const numWriters = 8;
+    const numUpdates = 500;
+    const joins = [];
+    for (let i = 0; i < numWriters; i++) {
+        joins.push(startParallelShell(
+            'for (let i = 0; i < ' + numUpdates + '; i++) {' +
+                ' assert.writeOK(db.getSiblingDB("test").hot_document_write_conflicts.update(' +
+                ' {_id: "counter"}, {$inc: {n: 1}}));' +
+                ' }',
+            conn.port));
+    }
+    joins.forEach(join => join());
+
+    assert.eq(numWriters * numUpdates, coll.findOne({_id: 'counter'}).n);
+
+    const hotDocuments =
+        assert.commandWorked(testDB.adminCommand({serverStatus: 1})).hotDocuments;
+    assert(hotDocuments, 'serverStatus has no hotDocuments section');
+    assert.gte(hotDocuments.conflicts, hotDocuments.waits, tojson(hotDocuments));
+    assert.eq(
+        hotDocuments.waits, hotDocuments.wakeups + hotDocuments.timeouts, tojson(hotDocuments));
+    if (hotDocuments.conflicts > hotDocuments.untrackedConflicts) {
+        assert.eq(coll.getFullName(), hotDocuments.documents[0].ns, tojson(hotDocuments));
+        assert.gt(hotDocuments.documents[0].conflicts, 0, tojson(hotDocuments));
+    }
+
+    // Turning the queue off stops the tracking of new documents, and the updates still apply.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, hotDocumentWriteConflictMaxWaitMillis: 0}));
+    const conflictsBefore = hotDocuments.conflicts;
+    const join = startParallelShell(
+        'for (let i = 0; i < 200; i++) {' +
+            ' assert.writeOK(db.getSiblingDB("test").hot_document_write_conflicts.update(' +
+            ' {_id: "counter"}, {$inc: {n: 1}}));' +
+            ' }',
+        conn.port);
+    for (let i = 0; i < 200; i++) {
+        assert.writeOK(coll.update({_id: 'counter'}, {$inc: {n: 1}}));
+    }
+    join();
+    assert.eq(numWriters * numUpdates + 400, coll.findOne({_id: 'counter'}).n);
+    assert.eq(conflictsBefore,
+              assert.commandWorked(testDB.adminCommand({serverStatus: 1})).hotDocuments.conflicts);
+
+    MongoRunner.stopMongod(conn);
+})();
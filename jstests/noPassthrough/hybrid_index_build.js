@@ -0,0 +1,59 @@
+/**
+ * Tests that writes made while a background index build is scanning the collection are captured
+ * and applied to the index before it is committed.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.hybrid_index_build;
+    coll.drop();
+
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+
+    // The failpoint hangs the build after its scan, before the scanned keys are loaded.
+    assert.commandWorked(
+        testDB.adminCommand({configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'alwaysOn'}));
+
+    const createIdx = startParallelShell(function() {
+        assert.commandWorked(
+            db.getSiblingDB("test").hybrid_index_build.createIndex({a: 1}, {background: true}));
+    }, conn.port);
+
+    assert.soon(function() {
+        return testDB.currentOp({"command.createIndexes": coll.getName()}).inprog.length === 1;
+    }, "index build did not start");
+
+    // Inserts, updates (including one that makes the index multikey) and deletes.
+    for (let i = 100; i < 150; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+    assert.writeOK(coll.update({_id: {$lt: 20}}, {$inc: {a: 1000}}, {multi: true}));
+    assert.writeOK(coll.update({_id: 20}, {$set: {a: [-1, -2]}}));
+    assert.writeOK(coll.remove({_id: {$gte: 30, $lt: 40}}));
+    assert.writeOK(coll.remove({_id: {$gte: 140}}));
+
+    assert.commandWorked(
+        testDB.adminCommand({configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'off'}));
+    createIdx();
+
+    const validateRes = coll.validate({full: true});
+    assert.commandWorked(validateRes);
+    assert(validateRes.valid, tojson(validateRes));
+
+    // Every document must be found through the new index.
+    const expected = coll.find().sort({_id: 1}).toArray();
+    const viaIndex = coll.find({a: {$gte: MinKey}}).hint({a: 1}).sort({_id: 1}).toArray();
+    assert.eq(130, expected.length);
+    assert.eq(expected, viaIndex);
+    assert.eq(1, coll.find({a: -2}).hint({a: 1}).itcount());
+    assert.eq(0, coll.find({a: 5}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({a: 1005}).hint({a: 1}).itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,52 @@
+/**
+ * Tests that with internalInsertGroupCommitWindowMicros set, concurrent single-document inserts
+ * into the same collection are all applied and replicated, and that each insert still reports its
+ * own error.
+ *
+ * @tags: [requires_replication]
+ */
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest(
+        {nodes: 2, nodeOptions: {setParameter: {internalInsertGroupCommitWindowMicros: 2000}}});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB('test');
+    const coll = testDB.insert_group_commit;
+    assert.commandWorked(coll.createIndex({k: 1}, {unique: true}));
+
+    // Each shell inserts its own documents one at a time, and then tries to insert a document
+    // whose unique key is taken by one of the documents of shell 0.
+    const numShells = 8;
+    const numDocsPerShell = 200;
+    const shells = [];
+    for (let shell = 0; shell < numShells; shell++) {
+        shells.push(startParallelShell(
+            'const coll = db.getSiblingDB("test").insert_group_commit;' +
+                'for (let i = 0; i < ' + numDocsPerShell + '; i++) {' +
+                '    assert.writeOK(coll.insert({_id: ' + shell + ' * 1000 + i, k: ' + shell +
+                ' * 1000 + i}, {writeConcern: {w: 2}}));' +
+                '}' +
+                'if (' + shell + ' > 0) {' +
+                '    const res = coll.insert({_id: "dup' + shell + '", k: 0});' +
+                '    assert.writeErrorWithCode(res, ErrorCodes.DuplicateKey);' +
+                '}',
+            primary.port));
+    }
+    shells.forEach(function(join) {
+        join();
+    });
+
+    assert.eq(numShells * numDocsPerShell, coll.find().itcount());
+    assert.eq(0, coll.find({_id: /^dup/}).itcount());
+
+    // The combined inserts are replicated like any others.
+    rst.awaitReplication();
+    const secondaryColl = rst.getSecondary().getDB('test').insert_group_commit;
+    assert.eq(numShells * numDocsPerShell, secondaryColl.find().itcount());
+
+    rst.stopSet();
+})();
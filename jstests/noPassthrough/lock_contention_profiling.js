@@ -0,0 +1,58 @@
+/**
+ * Tests that long lock waits are recorded with the operations waiting for and holding the lock
+ * while lock contention is profiled, and that they are summarized in serverStatus.
+ */
+(function() {
+    'use strict';
+
+    let conn = MongoRunner.runMongod({
+        setParameter: {lockContentionProfiling: true, lockContentionProfilingThresholdMillis: 100}
+    });
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let testDB = conn.getDB("test");
+    let adminDB = conn.getDB("admin");
+    let coll = testDB.lock_contention_profiling;
+
+    assert.commandWorked(adminDB.runCommand({getLockContention: 1, clear: true}));
+
+    // Hold the global lock exclusively while an insert waits for it.
+    let awaitSleep = startParallelShell(function() {
+        assert.commandWorked(db.adminCommand({sleep: 1, lock: "w", secs: 2}));
+    }, conn.port);
+    assert.soon(function() {
+        return adminDB.currentOp({"command.sleep": 1, active: true}).inprog.length > 0;
+    });
+    assert.writeOK(coll.insert({_id: 1}));
+    awaitSleep();
+
+    let res = assert.commandWorked(adminDB.runCommand({getLockContention: 1}));
+    let insertWaits = res.waits.filter(function(wait) {
+        return wait.resourceType === "Global" && wait.waiter.ns === coll.getFullName();
+    });
+    assert.eq(1, insertWaits.length, tojson(res.waits));
+
+    let wait = insertWaits[0];
+    assert.eq("granted", wait.result, tojson(wait));
+    assert.gte(wait.waitMicros, 100 * 1000, tojson(wait));
+    assert.eq(1, wait.holders.length, tojson(wait));
+    assert.eq("X", wait.holders[0].mode, tojson(wait));
+    assert.eq(1, wait.holders[0].command.sleep, tojson(wait));
+
+    let summary = assert.commandWorked(adminDB.runCommand({serverStatus: 1})).lockContention;
+    assert.gte(summary.Global.count, 1, tojson(summary));
+    assert.gte(summary.Global.waitMicros, wait.waitMicros, tojson(summary));
+
+    // The waits are dropped when requested, and no longer reported once profiling is off.
+    assert.commandWorked(adminDB.runCommand({getLockContention: 1, clear: true}));
+    assert.eq(0, assert.commandWorked(adminDB.runCommand({getLockContention: 1})).waits.length);
+    assert.commandWorked(adminDB.runCommand({setParameter: 1, lockContentionProfiling: false}));
+    assert.eq(undefined,
+              assert.commandWorked(adminDB.runCommand({serverStatus: 1})).lockContention);
+
+    assert.commandFailedWithCode(
+        adminDB.runCommand({setParameter: 1, lockContentionProfilingThresholdMillis: -1}),
+        ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+})();
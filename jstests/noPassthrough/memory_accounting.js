@@ -0,0 +1,47 @@
+/**
+ * Tests that the memory held by the plan cache and by cursors is reported in the
+ * memoryAccounting serverStatus section.
+ */
+(function() {
+    'use strict';
+
+    let conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let testDB = conn.getDB("test");
+    let coll = testDB.memory_accounting;
+
+    function memoryAccounting() {
+        return assert.commandWorked(testDB.adminCommand({serverStatus: 1})).memoryAccounting;
+    }
+
+    let accounts = memoryAccounting();
+    ["planCache", "cursors", "sorters", "aggregation", "networkBuffers", "total"].forEach(
+        function(name) {
+            assert(accounts.hasOwnProperty(name), tojson(accounts));
+        });
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    // A query with two candidate plans is cached once a plan wins.
+    let before = memoryAccounting();
+    assert.eq(1, coll.find({a: 1, b: 1}).itcount());
+    assert.gt(memoryAccounting().planCache, before.planCache);
+
+    coll.getPlanCache().clear();
+    assert.eq(before.planCache, memoryAccounting().planCache);
+
+    // An open cursor is charged until it is exhausted.
+    before = memoryAccounting();
+    let cursor = coll.find().batchSize(2);
+    cursor.next();
+    assert.gt(memoryAccounting().cursors, before.cursors);
+    cursor.itcount();
+    assert.eq(before.cursors, memoryAccounting().cursors);
+
+    MongoRunner.stopMongod(conn);
+})();
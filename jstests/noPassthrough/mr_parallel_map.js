@@ -0,0 +1,96 @@
+// Tests that mapReduce gives the same results when its map function runs on several worker
+// threads as when it runs on the thread of the command, including when the emitted tuples are
+// spilled to disk before the final reduce.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {internalMapReduceMaxMapWorkerThreads: 4}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.mr_parallel_map;
+
+    const numDocs = 5000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, key: i % 97, value: i, tags: ['a', 'b', 'c'].slice(0, i % 4)});
+    }
+    assert.writeOK(bulk.execute());
+
+    const map = function() {
+        emit(this.key, {count: 1, total: this.value});
+        this.tags.forEach(function(tag) {
+            emit(tag, {count: 1, total: 0});
+        });
+    };
+    const reduce = function(key, values) {
+        const result = {count: 0, total: 0};
+        values.forEach(function(value) {
+            result.count += value.count;
+            result.total += value.total;
+        });
+        return result;
+    };
+
+    function sorted(results) {
+        return results.sort(function(a, b) {
+            return String(a._id) < String(b._id) ? -1 : (String(a._id) > String(b._id) ? 1 : 0);
+        });
+    }
+
+    function runMapReduce(numWorkers, options) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalMapReduceMaxMapWorkerThreads: numWorkers}));
+        const res = assert.commandWorked(testDB.runCommand(
+            Object.extend({mapReduce: coll.getName(), map: map, reduce: reduce}, options)));
+        if (res.results) {
+            return sorted(res.results);
+        }
+        return sorted(testDB.getCollection(res.result).find().toArray());
+    }
+
+    // Inline output.
+    const expected = runMapReduce(1, {out: {inline: 1}});
+    assert.eq(97 + 3, expected.length);
+    assert.eq(expected, runMapReduce(4, {out: {inline: 1}}));
+
+    // Output to a collection, with a query and a sort on the input.
+    assert.commandWorked(coll.createIndex({key: 1}));
+    const options = {out: 'mr_parallel_map_out', query: {key: {$lt: 50}}, sort: {key: 1}};
+    assert.eq(runMapReduce(1, options), runMapReduce(4, options));
+
+    // Emitting a distinct key for every document grows the in-memory state until it is reduced
+    // and spilled to disk, and is reduced again for the final output.
+    const distinctMap = function() {
+        emit(this._id, {count: 1, total: this.value});
+        emit(this._id, {count: 1, total: 1});
+    };
+    const spillOptions = {map: distinctMap, out: 'mr_parallel_map_spill'};
+    const spilled = runMapReduce(4, spillOptions);
+    assert.eq(numDocs, spilled.length);
+    assert.eq(runMapReduce(1, spillOptions), spilled);
+
+    // An error thrown by the map function on a worker fails the command.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalMapReduceMaxMapWorkerThreads: 4}));
+    assert.commandFailed(testDB.runCommand({
+        mapReduce: coll.getName(),
+        map: function() {
+            if (this._id == 1234) {
+                throw new Error('map failed');
+            }
+            emit(this.key, 1);
+        },
+        reduce: function(key, values) {
+            return Array.sum(values);
+        },
+        out: {inline: 1}
+    }));
+
+    // jsMode keeps the emitted tuples in the scope of the command and maps on its thread.
+    const jsModeRes = assert.commandWorked(testDB.runCommand(
+        {mapReduce: coll.getName(), map: map, reduce: reduce, out: {inline: 1}, jsMode: true}));
+    assert.eq(expected, sorted(jsModeRes.results));
+
+    MongoRunner.stopMongod(conn);
+})();
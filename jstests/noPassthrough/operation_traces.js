@@ -0,0 +1,52 @@
+/**
+ * Tests that sampled operations are traced with their phase breakdown, and that the traces can be
+ * retrieved and cleared with the getOperationTraces command.
+ */
+(function() {
+    'use strict';
+
+    let conn = MongoRunner.runMongod({setParameter: {operationTraceSampleRate: 1}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let testDB = conn.getDB("test");
+    let adminDB = conn.getDB("admin");
+    let coll = testDB.operation_traces;
+
+    assert.commandWorked(adminDB.runCommand({getOperationTraces: 1, clear: true}));
+
+    assert.writeOK(coll.insert({_id: 1, a: 1}));
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    assert.eq(1, coll.find({a: 1}).itcount());
+
+    let res = assert.commandWorked(adminDB.runCommand({getOperationTraces: 1}));
+    let findTraces = res.traces.filter(function(trace) {
+        return trace.command === "find" && trace.ns === coll.getFullName();
+    });
+    assert.eq(1, findTraces.length, tojson(res.traces));
+
+    let trace = findTraces[0];
+    assert.gte(trace.durationMicros, 0, tojson(trace));
+    assert.gte(trace.phases.ticketQueueMicros, 0, tojson(trace));
+    assert.eq("object", typeof trace.phases.lockWaitMicros, tojson(trace));
+    // Two candidate indexes mean the find had to select a plan.
+    assert.gte(trace.phases.planningMicros, 0, tojson(trace));
+    assert.eq(1, trace.docsExamined, tojson(trace));
+    assert.eq(0, trace.writeConflicts, tojson(trace));
+
+    // The traces are dropped when requested, and no longer collected once sampling is off.
+    assert.commandWorked(adminDB.runCommand({getOperationTraces: 1, clear: true}));
+    assert.commandWorked(adminDB.runCommand({setParameter: 1, operationTraceSampleRate: 0}));
+    assert.eq(1, coll.find({a: 1}).itcount());
+    res = assert.commandWorked(adminDB.runCommand({getOperationTraces: 1}));
+    assert.eq(0,
+              res.traces.filter(function(trace) {
+                  return trace.command === "find";
+              }).length,
+              tojson(res.traces));
+
+    assert.commandFailedWithCode(
+        adminDB.runCommand({setParameter: 1, operationTraceSampleRate: 2}), ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,44 @@
+/**
+ * Tests that with profilerDeferredWrites enabled, profile entries are written to system.profile by
+ * the background writer, and that the profile collection is recreated if it is dropped.
+ */
+(function() {
+    'use strict';
+
+    let conn = MongoRunner.runMongod({setParameter: {profilerDeferredWrites: true}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let testDB = conn.getDB("profile_deferred_writes");
+    let coll = testDB.coll;
+    assert.writeOK(coll.insert({_id: 1}));
+
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    const kNumFinds = 20;
+    for (let i = 0; i < kNumFinds; i++) {
+        assert.eq(1, coll.find({_id: 1, x: {$ne: i}}).itcount());
+    }
+
+    function countProfiledFinds() {
+        return testDB.system.profile.find({op: "query", ns: coll.getFullName()}).itcount();
+    }
+
+    assert.soon(function() {
+        return countProfiledFinds() === kNumFinds;
+    }, "deferred profile entries were not written", 60 * 1000);
+
+    // The writer recreates the profile collection if it goes away under it.
+    assert.commandWorked(testDB.setProfilingLevel(0));
+    testDB.system.profile.drop();
+    assert.commandWorked(testDB.setProfilingLevel(2));
+    assert.eq(1, coll.find({_id: 1}).itcount());
+    assert.soon(function() {
+        return countProfiledFinds() === 1;
+    }, "deferred profile entry was not written after the profile collection was dropped");
+
+    assert.eq(0,
+              testDB.serverStatus().metrics.profiler.deferredWrites.droppedEntries,
+              "unexpected dropped profile entries");
+
+    MongoRunner.stopMongod(conn);
+})();
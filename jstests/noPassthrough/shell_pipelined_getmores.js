@@ -0,0 +1,39 @@
+// Tests that a shell cursor which requests its next batch ahead of time returns the same results,
+// and that the connection remains usable once such a cursor is exhausted or killed.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const coll = conn.getDB('test').shell_pipelined_getmores;
+    const numDocs = 500;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    function pipelinedFind(query) {
+        return coll.find(query).sort({_id: 1}).batchSize(7).addOption(
+            DBQuery.Option.pipelineGetMores);
+    }
+
+    let expected = 0;
+    pipelinedFind({}).forEach(function(doc) {
+        assert.eq(expected++, doc._id);
+    });
+    assert.eq(numDocs, expected);
+    assert.eq(numDocs, coll.find().itcount());
+
+    // Killing a cursor with a getMore in flight drains its reply before the connection is reused.
+    const cursor = pipelinedFind({_id: {$gte: 100}});
+    for (let i = 0; i < 10; i++) {
+        assert.eq(100 + i, cursor.next()._id);
+    }
+    cursor.close();
+    assert.eq(numDocs, coll.count());
+    assert.commandWorked(coll.getDB().runCommand({ping: 1}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,95 @@
+// Tests that a time-series collection stores its measurements in buckets of the same series, which
+// are compressed once full, and that aggregations see the measurements with their time and meta
+// predicates pushed down to the buckets.
+(function() {
+    'use strict';
+
+    load('jstests/aggregation/extras/utils.js');  // For arrayEq.
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.timeseries_collection;
+
+    assert.commandFailed(testDB.createCollection(coll.getName(), {timeseries: {}}));
+    assert.commandFailed(
+        testDB.createCollection(coll.getName(), {timeseries: {timeField: 't', metaField: 't'}}));
+    assert.commandFailed(testDB.createCollection(
+        coll.getName(), {timeseries: {timeField: 't'}, capped: true, size: 4096}));
+
+    const bucketMaxCount = 10;
+    assert.commandWorked(testDB.createCollection(
+        coll.getName(),
+        {timeseries: {timeField: 't', metaField: 'sensor', bucketMaxCount: bucketMaxCount}}));
+    const collInfo = testDB.getCollectionInfos({name: coll.getName()})[0];
+    assert.eq({timeField: 't', metaField: 'sensor', bucketMaxCount: bucketMaxCount},
+              collInfo.options.timeseries,
+              tojson(collInfo));
+
+    // Measurements need a date in their timeField.
+    assert.writeError(coll.insert({_id: -1, sensor: 'a', v: 1}));
+    assert.writeError(coll.insert({_id: -1, t: 1, sensor: 'a', v: 1}));
+
+    const start = new Date('2017-10-01T00:00:00Z').getTime();
+    const sensors = ['a', 'b', 'c'];
+    const numMeasurements = 95;
+    const measurements = [];
+    for (let i = 0; i < numMeasurements; i++) {
+        measurements.push(
+            {_id: i, t: new Date(start + i * 1000), sensor: sensors[i % sensors.length], v: i});
+    }
+    assert.writeOK(coll.insert(measurements.slice(0, 50), {ordered: false}));
+    measurements.slice(50).forEach(measurement => assert.writeOK(coll.insert(measurement)));
+
+    // Reading the collection directly returns its buckets, of which the full ones are compressed.
+    const buckets = coll.find().toArray();
+    sensors.forEach(function(sensor, index) {
+        const count = Math.floor((numMeasurements - index - 1) / sensors.length) + 1;
+        const sensorBuckets = buckets.filter(bucket => bucket.meta === sensor);
+        assert.eq(Math.ceil(count / bucketMaxCount), sensorBuckets.length, tojson(sensorBuckets));
+        assert.eq(Math.floor(count / bucketMaxCount),
+                  sensorBuckets.filter(bucket => bucket.control.version === 2).length,
+                  tojson(sensorBuckets));
+        assert.eq(count, Array.sum(sensorBuckets.map(bucket => bucket.control.count)));
+    });
+
+    function checkMeasurements(expected, pipeline) {
+        const actual = coll.aggregate(pipeline.concat([{$sort: {_id: 1}}])).toArray();
+        assert.eq(expected.length, actual.length, tojson(actual));
+        for (let i = 0; i < expected.length; i++) {
+            assert.eq(expected[i]._id, actual[i]._id, tojson(actual[i]));
+            assert.eq(expected[i].t, actual[i].t, tojson(actual[i]));
+            assert.eq(expected[i].sensor, actual[i].sensor, tojson(actual[i]));
+            assert.eq(expected[i].v, actual[i].v, tojson(actual[i]));
+        }
+    }
+
+    // Aggregations see the measurements of both compressed and open buckets.
+    checkMeasurements(measurements, []);
+
+    const from = new Date(start + 20 * 1000);
+    const to = new Date(start + 40 * 1000);
+    checkMeasurements(measurements.filter(m => m.t >= from && m.t < to),
+                      [{$match: {t: {$gte: from, $lt: to}}}]);
+    checkMeasurements(measurements.filter(m => m.sensor === 'b' && m.v > 60),
+                      [{$match: {sensor: 'b', v: {$gt: 60}}}]);
+    const totalOfA = Array.sum(measurements.filter(m => m.sensor === 'a').map(m => m.v));
+    assert.eq([{_id: 'a', total: totalOfA}],
+              coll.aggregate([
+                      {$match: {sensor: 'a'}},
+                      {$group: {_id: '$sensor', total: {$sum: '$v'}}}
+                  ])
+                  .toArray());
+
+    // The predicates on the time and meta of the measurements are pushed down to the buckets.
+    const explain = coll.explain().aggregate([{$match: {t: {$gte: from}, sensor: 'a'}}]);
+    const cursorStage = explain.stages[0].$cursor;
+    assert(arrayEq([{'control.max.t': {$gte: from}}, {meta: 'a'}], cursorStage.query.$and),
+           tojson(explain));
+    assert.eq({timeField: 't', metaField: 'sensor'},
+              explain.stages[1].$_internalUnpackBucket,
+              tojson(explain));
+
+    MongoRunner.stopMongod(conn);
+})();
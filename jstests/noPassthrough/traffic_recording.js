@@ -0,0 +1,50 @@
+/**
+ * Tests that the traffic of a mongod is recorded between the startRecordingTraffic and
+ * stopRecordingTraffic commands, and that recordings are confined to trafficRecordingDirectory.
+ */
+(function() {
+    'use strict';
+
+    let recordingDir = MongoRunner.toRealDir("$dataDir/traffic_recording");
+    resetDbpath(recordingDir);
+
+    let conn = MongoRunner.runMongod({setParameter: {trafficRecordingDirectory: recordingDir}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let adminDB = conn.getDB("admin");
+    let coll = conn.getDB("test").traffic_recording;
+
+    assert.commandFailedWithCode(
+        adminDB.runCommand({startRecordingTraffic: 1, filename: "../traffic"}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(adminDB.runCommand({stopRecordingTraffic: 1}),
+                                 ErrorCodes.FileNotOpen);
+
+    let res = assert.commandWorked(
+        adminDB.runCommand({startRecordingTraffic: 1, filename: "traffic"}));
+    assert.eq(true, res.recording, tojson(res));
+    assert.commandFailedWithCode(
+        adminDB.runCommand({startRecordingTraffic: 1, filename: "traffic2"}),
+        ErrorCodes.FileAlreadyOpen);
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+    assert.eq(10, coll.find().batchSize(2).itcount());
+
+    let status = assert.commandWorked(adminDB.runCommand({serverStatus: 1, trafficRecording: 1}));
+    assert.eq(true, status.trafficRecording.recording, tojson(status.trafficRecording));
+
+    res = assert.commandWorked(adminDB.runCommand({stopRecordingTraffic: 1}));
+    assert.eq(false, res.recording, tojson(res));
+    assert.gt(res.recordsWritten, 10, tojson(res));
+    assert.eq(0, res.recordsDropped, tojson(res));
+
+    let files = listFiles(recordingDir).filter(function(file) {
+        return file.baseName === "traffic";
+    });
+    assert.eq(1, files.length, tojson(listFiles(recordingDir)));
+    assert.eq(res.bytesWritten, files[0].size, tojson(files));
+
+    MongoRunner.stopMongod(conn);
+})();
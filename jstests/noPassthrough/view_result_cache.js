@@ -0,0 +1,49 @@
+/**
+ * Tests that reads of a view may be served from the cache of view results while they are within
+ * the staleness bound set by 'internalQueryViewResultCacheMaxStalenessMS', and that reads which
+ * cannot be answered from the cache still see the current contents of the underlying collection.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: 'internalQueryViewResultCacheMaxStalenessMS=' + 60 * 60 * 1000});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const testDB = conn.getDB('test');
+    const coll = testDB.view_result_cache;
+    coll.drop();
+
+    assert.writeOK(coll.insert([{_id: 0, a: 1}, {_id: 1, a: 1}, {_id: 2, a: 2}]));
+    assert.commandWorked(testDB.createView(
+        'cachedView', coll.getName(), [{$group: {_id: '$a', count: {$sum: 1}}}, {$sort: {_id: 1}}]));
+    const view = testDB.cachedView;
+
+    const expected = [{_id: 1, count: 2}, {_id: 2, count: 1}];
+    assert.eq(expected, view.find().toArray());
+
+    // The first read cached the view's results, so a change to the collection is not yet visible.
+    assert.writeOK(coll.insert({_id: 3, a: 2}));
+    assert.eq(expected, view.find().toArray());
+
+    // Stages on top of the view run against the cached results.
+    assert.eq([{_id: 2, count: 1}], view.aggregate([{$match: {_id: 2}}]).toArray());
+
+    // Explain describes the view's own pipeline, on the collection.
+    const explain = view.explain().aggregate([{$match: {_id: 2}}]);
+    assert(!tojson(explain).includes('$_internalCachedViewResults'), tojson(explain));
+
+    // With the cache disabled every read runs the pipeline again.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryViewResultCacheMaxStalenessMS: 0}));
+    assert.eq([{_id: 1, count: 2}, {_id: 2, count: 2}], view.find().toArray());
+
+    // Views with stages whose output is not a function of the collection alone are never cached.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryViewResultCacheMaxStalenessMS: 60000}));
+    assert.commandWorked(testDB.createView('sampledView', coll.getName(), [{$sample: {size: 10}}]));
+    assert.eq(4, testDB.sampledView.find().itcount());
+    assert.writeOK(coll.insert({_id: 4, a: 3}));
+    assert.eq(5, testDB.sampledView.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+}());
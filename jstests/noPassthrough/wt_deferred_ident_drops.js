@@ -0,0 +1,53 @@
+/**
+ * Tests that with wiredTigerDeferIdentDrops set, dropped collections and databases disappear from
+ * the catalog right away, their tables are removed in the background, and tables that were still
+ * queued at shutdown do not come back after a restart.
+ *
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const dbpath = MongoRunner.dataPath + 'wt_deferred_ident_drops';
+    resetDbpath(dbpath);
+
+    let conn = MongoRunner.runMongod(
+        {dbpath: dbpath, noCleanData: true, setParameter: 'wiredTigerDeferIdentDrops=true'});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const numCollections = 50;
+    let testDB = conn.getDB('test');
+    for (let i = 0; i < numCollections; i++) {
+        assert.writeOK(testDB.getCollection('coll' + i).insert({_id: i}));
+        assert.commandWorked(testDB.getCollection('coll' + i).createIndex({a: 1}));
+    }
+
+    assert(testDB.coll0.drop());
+    assert.eq(null, testDB.getCollectionInfos({name: 'coll0'})[0]);
+
+    // Recreating a dropped collection must not see any of its old documents.
+    assert.writeOK(testDB.coll0.insert({_id: 'new'}));
+    assert.eq([{_id: 'new'}], testDB.coll0.find().toArray());
+
+    assert.commandWorked(testDB.dropDatabase());
+    assert.eq(0, testDB.getCollectionNames().length);
+
+    // Restart before the queue is necessarily drained. The remaining tables are dropped as
+    // unknown idents during startup and the database stays empty.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, 'mongod was unable to restart after dropping a database');
+
+    testDB = conn.getDB('test');
+    assert.eq(0, testDB.getCollectionNames().length);
+    assert.writeOK(testDB.coll1.insert({_id: 1}));
+    assert.eq(1, testDB.coll1.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
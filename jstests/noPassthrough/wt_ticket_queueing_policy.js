@@ -0,0 +1,48 @@
+/**
+ * Tests that the FIFO ticket queueing policy can be selected for WiredTiger and that its queue
+ * statistics are reported by serverStatus.
+ */
+(function() {
+    "use strict";
+
+    // This test can only be run if the storageEngine is wiredTiger.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTestLog("Skipping test because storageEngine is not wiredTiger");
+        return;
+    }
+
+    // An unknown policy is rejected at startup.
+    assert.eq(null, MongoRunner.runMongod({
+        storageEngine: "wiredTiger",
+        setParameter: "wiredTigerTicketQueueingPolicy=lifo"
+    }));
+
+    const conn = MongoRunner.runMongod({
+        storageEngine: "wiredTiger",
+        setParameter:
+            {wiredTigerTicketQueueingPolicy: "fifo", wiredTigerConcurrentReadTransactions: 7}
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const db = conn.getDB("test");
+    assert.writeOK(db.coll.insert({_id: 1}));
+    assert.eq(1, db.coll.find().itcount());
+
+    const tickets = assert.commandWorked(db.serverStatus()).wiredTiger.concurrentTransactions;
+    assert.eq(7, tickets.read.totalTickets, tojson(tickets));
+    assert.eq(128, tickets.write.totalTickets, tojson(tickets));
+    for (let kind of ["read", "write"]) {
+        assert(tickets[kind].hasOwnProperty("queueLength"), tojson(tickets));
+        assert(tickets[kind].hasOwnProperty("totalQueued"), tojson(tickets));
+        assert(tickets[kind].hasOwnProperty("totalTimeQueuedMicros"), tojson(tickets));
+    }
+
+    // The number of tickets can still be changed at runtime.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, wiredTigerConcurrentReadTransactions: 9}));
+    assert.eq(9,
+              assert.commandWorked(db.serverStatus())
+                  .wiredTiger.concurrentTransactions.read.totalTickets);
+
+    MongoRunner.stopMongod(conn);
+})();
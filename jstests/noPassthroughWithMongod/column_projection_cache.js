@@ -0,0 +1,68 @@
+// Tests the columnCacheSet and columnCacheClear commands, and that queries which only need the
+// cached fields are answered by a COLUMN_SCAN which stays up to date with writes.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.column_projection_cache;
+    coll.drop();
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i, b: {c: i % 10}, d: "x".repeat(100)}));
+    }
+
+    // Only top-level fields other than _id can be cached.
+    assert.commandFailed(db.runCommand({columnCacheSet: coll.getName(), fields: ["a.b"]}));
+    assert.commandFailed(db.runCommand({columnCacheSet: coll.getName(), fields: ["_id"]}));
+    assert.commandFailed(db.runCommand({columnCacheSet: coll.getName(), fields: "a"}));
+    assert.commandFailedWithCode(db.runCommand({columnCacheSet: "nonexistent", fields: ["a"]}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    const res =
+        assert.commandWorked(db.runCommand({columnCacheSet: coll.getName(), fields: ["a", "b"]}));
+    assert.eq(100, res.columnCache.numDocuments, tojson(res));
+
+    function assertUsesColumnScan(cursor) {
+        const explain = cursor.explain();
+        assert(planHasStage(explain.queryPlanner.winningPlan, "COLUMN_SCAN"), tojson(explain));
+    }
+
+    function assertUsesCollScan(cursor) {
+        const explain = cursor.explain();
+        assert(planHasStage(explain.queryPlanner.winningPlan, "COLLSCAN"), tojson(explain));
+    }
+
+    // Queries over cached fields use the cache.
+    assertUsesColumnScan(coll.find({a: {$lt: 10}}, {_id: 0, a: 1}));
+    assertUsesColumnScan(coll.find({"b.c": 3}, {a: 1}).sort({a: -1}));
+    assert.eq(10, coll.find({"b.c": 3}, {a: 1}).itcount());
+    assert.eq([{a: 9}, {a: 8}],
+              coll.find({a: {$in: [8, 9]}}, {_id: 0, a: 1}).sort({a: -1}).toArray());
+    assert.eq(10, coll.count({"b.c": 3}));
+
+    // Queries needing other fields use the collection.
+    assertUsesCollScan(coll.find({a: 1}));
+    assertUsesCollScan(coll.find({d: "x"}, {a: 1}));
+    assertUsesCollScan(coll.find({a: 1}, {a: 1, d: 1}));
+
+    // Writes are reflected in the cache.
+    assert.writeOK(coll.insert({_id: 100, a: 1000}));
+    assert.writeOK(coll.update({_id: 0}, {$set: {a: 2000}}));
+    assert.writeOK(coll.remove({_id: 1}));
+    assert.eq([{_id: 0, a: 2000}, {_id: 100, a: 1000}],
+              coll.find({a: {$gte: 1000}}, {a: 1}).sort({_id: 1}).toArray());
+    assert.eq(0, coll.find({_id: 1}, {a: 1}).hint({$natural: 1}).itcount());
+    assert.eq(100, coll.count({a: {$exists: true}}));
+
+    // Clearing the cache reverts to collection scans.
+    assert.commandWorked(db.runCommand({columnCacheClear: coll.getName()}));
+    assertUsesCollScan(coll.find({a: {$lt: 10}}, {_id: 0, a: 1}));
+
+    // Capped collections are not supported.
+    const capped = db.column_projection_cache_capped;
+    capped.drop();
+    assert.commandWorked(db.createCollection(capped.getName(), {capped: true, size: 4096}));
+    assert.commandFailedWithCode(db.runCommand({columnCacheSet: capped.getName(), fields: ["a"]}),
+                                 ErrorCodes.InvalidOptions);
+})();
@@ -270,6 +270,40 @@
 
     testDbCheckParameters();
 
+    // Check several collections at once over the whole database.
+    function testDbCheckConcurrentCollections() {
+        let master = replSet.getPrimary();
+        let db = master.getDB("dbCheck-concurrent-test");
+        let collNames = ["a", "b", "c", "d"];
+
+        for (let name of collNames) {
+            addEnoughForMultipleBatches(db[name]);
+        }
+        replSet.awaitReplication();
+        clearLog();
+
+        assert.commandFailed(db.runCommand({dbCheck: 1, maxConcurrentCollections: 0}));
+        assert.commandWorked(db.runCommand({dbCheck: 1, maxConcurrentCollections: 3}));
+        awaitDbCheckCompletion(db);
+
+        forEachNode(function(node) {
+            let healthlog = node.getDB("local").system.healthlog;
+            for (let name of collNames) {
+                let ns = db[name].getFullName();
+                let batches = healthlog.find({operation: "dbCheckBatch", namespace: ns}).toArray();
+                assert.gt(batches.length, 1, "dbCheck should check " + ns + " in multiple batches");
+                assert.eq(batches.reduce((x, y) => x + y.data.count, 0), 10000);
+            }
+
+            let errs = healthlog.find({"severity": {"$ne": "info"}});
+            assert(!errs.hasNext(), "dbCheck found inconsistency: " + tojson(errs.toArray()));
+        });
+
+        db.dropDatabase();
+    }
+
+    testDbCheckConcurrentCollections();
+
     // Now, test some unusual cases where the command should fail.
     function testErrorOnNonexistent() {
         let master = replSet.getPrimary();
@@ -0,0 +1,56 @@
+/**
+ * Tests that initial sync completes when the oplog entries fetched while cloning are buffered in a
+ * temporary file rather than a collection.
+ */
+
+(function() {
+    "use strict";
+    load("jstests/libs/check_log.js");
+
+    var name = 'initial_sync_oplog_buffer_file';
+    var replSet = new ReplSetTest({
+        name: name,
+        nodes: [{}, {rsConfig: {arbiterOnly: true}}],
+    });
+
+    replSet.startSet();
+    replSet.initiate();
+    var primary = replSet.getPrimary();
+
+    var coll = primary.getDB('test').getCollection(name);
+    assert.writeOK(coll.insert({_id: 0, x: 0}));
+
+    // Add a secondary node buffering the oplog in a file, and make it hang after retrieving the
+    // last op on the source but before copying databases.
+    var secondary = replSet.add({setParameter: "initialSyncOplogBuffer=file"});
+    secondary.setSlaveOk();
+
+    assert.commandWorked(secondary.getDB('admin').runCommand(
+        {configureFailPoint: 'initialSyncHangBeforeCopyingDatabases', mode: 'alwaysOn'}));
+    replSet.reInitiate();
+
+    checkLog.contains(secondary,
+                      'initial sync - initialSyncHangBeforeCopyingDatabases fail point enabled');
+
+    // These writes are fetched into the oplog buffer while the secondary is syncing.
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 1; i <= 1000; i++) {
+        bulk.insert({_id: i, x: i, padding: 'x'.repeat(1024)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.update({_id: 0}, {$set: {x: 1}}));
+
+    assert.commandWorked(secondary.getDB('admin').runCommand(
+        {configureFailPoint: 'initialSyncHangBeforeCopyingDatabases', mode: 'off'}));
+
+    checkLog.contains(secondary, 'initial sync done');
+
+    replSet.awaitReplication();
+    replSet.awaitSecondaryNodes();
+
+    var secondaryColl = secondary.getDB('test').getCollection(name);
+    assert.eq(1001, secondaryColl.find().itcount());
+    assert.eq(1, secondaryColl.findOne({_id: 0}).x);
+
+    replSet.stopSet();
+})();
@@ -0,0 +1,51 @@
+// Tests that counts which a shard answers from the number of records of a collection or from the
+// prefix counts of an index don't include the orphaned documents on the shard.
+(function() {
+    'use strict';
+
+    const st = new ShardingTest({shards: 2});
+    const dbName = 'test';
+    const ns = dbName + '.count_orphans_fast_path';
+    const coll = st.s0.getCollection(ns);
+
+    assert.commandWorked(st.s0.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(coll.createIndex({tenant: 1}, {prefixCounts: true}));
+    assert.commandWorked(st.s0.adminCommand({shardCollection: ns, key: {_id: 1}}));
+    assert.commandWorked(st.s0.adminCommand({split: ns, middle: {_id: 50}}));
+    assert.commandWorked(st.s0.adminCommand(
+        {moveChunk: ns, find: {_id: 50}, to: st.shard1.shardName, _waitForDelete: true}));
+
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, tenant: 't' + (i % 10)}));
+    }
+    assert.eq(100, coll.count());
+    assert.eq(10, coll.count({tenant: 't7'}));
+
+    // Documents of the chunk owned by the other shard are orphans on this one. They are still
+    // counted by a count against the shard itself.
+    const shardColl = st.shard0.getCollection(ns);
+    for (let i = 100; i < 120; i++) {
+        assert.writeOK(shardColl.insert({_id: i, tenant: 't7'}));
+    }
+    assert.eq(70, shardColl.count());
+    assert.eq(25, shardColl.count({tenant: 't7'}));
+
+    assert.eq(100, coll.count());
+    assert.eq(100, coll.count({}, {hint: {tenant: 1}}));
+    assert.eq(100, coll.count({}, {hint: {$natural: 1}}));
+    assert.eq(10, coll.count({tenant: 't7'}));
+    assert.eq(20, coll.count({tenant: {$in: ['t1', 't7']}}));
+    assert.eq(10, coll.count({tenant: 't1'}));
+    assert.eq(5, coll.count({tenant: 't1'}, {limit: 5}));
+
+    // The orphans found are reported by explain.
+    const explain = coll.explain('executionStats').count({tenant: 't7'});
+    const shardStages = explain.executionStats.executionStages.shards.filter(
+        shard => shard.shardName === st.shard0.shardName);
+    assert.eq(1, shardStages.length, tojson(explain));
+    assert.eq('tenant_1', shardStages[0].executionStages.prefixCountIndex, tojson(explain));
+    assert.eq(20, shardStages[0].executionStages.nOrphans, tojson(explain));
+
+    st.stop();
+})();
@@ -0,0 +1,53 @@
+// Tests that a shard primary loads the metadata of its sharded collections from the persisted
+// routing metadata in the background once it steps up, before any versioned request for them.
+// @tags: [requires_replication]
+(function() {
+    'use strict';
+
+    const st = new ShardingTest({shards: 1, rs: {nodes: 2}});
+    const dbName = 'test';
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+
+    // Shard the collections and route a write to each of them, so that the shard primary persists
+    // their routing metadata.
+    const numColls = 20;
+    const namespaces = [];
+    for (let i = 0; i < numColls; i++) {
+        const ns = dbName + '.coll' + i;
+        namespaces.push(ns);
+        assert.commandWorked(st.s.adminCommand({shardCollection: ns, key: {_id: 1}}));
+        assert.commandWorked(st.s.adminCommand({split: ns, middle: {_id: 0}}));
+        assert.writeOK(st.s.getCollection(ns).insert({_id: i}));
+    }
+
+    const oldPrimary = st.rs0.getPrimary();
+    const newPrimary = st.rs0.getSecondary();
+    st.rs0.stepUp(newPrimary);
+    assert.eq(newPrimary, st.rs0.getPrimary());
+
+    // The new primary refreshes every collection without being asked for it.
+    let warmUp;
+    assert.soon(function() {
+        warmUp = assert.commandWorked(newPrimary.adminCommand({serverStatus: 1}))
+                     .sharding.metadataWarmUp;
+        return !warmUp.inProgress && warmUp.refreshed + warmUp.failed === numColls;
+    }, () => 'metadata was not warmed up: ' + tojson(warmUp));
+    assert.eq(numColls, warmUp.collections, tojson(warmUp));
+    assert.eq(numColls, warmUp.refreshed, tojson(warmUp));
+
+    namespaces.forEach(function(ns) {
+        const res = assert.commandWorked(newPrimary.adminCommand({getShardVersion: ns}));
+        assert.gt(res.global.getTime(), 0, tojson(res));
+    });
+
+    // The collections can still be read and written through mongos.
+    assert.writeOK(st.s.getCollection(namespaces[0]).insert({_id: -1}));
+    assert.eq(2, st.s.getCollection(namespaces[0]).find().itcount());
+
+    // The node which stepped down does not warm up anything.
+    const oldPrimaryWarmUp = assert.commandWorked(oldPrimary.adminCommand({serverStatus: 1}))
+                                 .sharding.metadataWarmUp;
+    assert(!oldPrimaryWarmUp.inProgress, tojson(oldPrimaryWarmUp));
+
+    st.stop();
+})();
@@ -675,4 +675,38 @@ TEST(BSONObj, addField) {
     ASSERT_BSONOBJ_EQ(obj, BSON("a" << 1 << "b" << 2));
 }
 
+TEST(BSONObjGetField, FindsFieldsByExactName) {
+    BSONObj obj = BSON("a" << 1 << "ab" << 2 << "b" << BSON("c" << 3) << "" << 4 << "abc" << 5);
+    ASSERT_EQ(obj.getField("a").numberInt(), 1);
+    ASSERT_EQ(obj.getField("ab").numberInt(), 2);
+    ASSERT_BSONOBJ_EQ(obj.getField("b").Obj(), BSON("c" << 3));
+    ASSERT_EQ(obj.getField("").numberInt(), 4);
+    ASSERT_EQ(obj.getField("abc").numberInt(), 5);
+    ASSERT_EQ(obj.getField("abc").fieldNameStringData(), "abc");
+}
+
+TEST(BSONObjGetField, MissingFieldsAreEOO) {
+    BSONObj obj = BSON("a" << 1 << "abc" << 2);
+    ASSERT(obj.getField("ab").eoo());
+    ASSERT(obj.getField("abcd").eoo());
+    ASSERT(obj.getField("c").eoo());
+    ASSERT(obj.getField("b.c").eoo());
+    ASSERT(obj.getField(std::string(64, 'a')).eoo());
+    ASSERT(BSONObj().getField("a").eoo());
+    ASSERT(BSONObj().getField("").eoo());
+}
+
+TEST(BSONObjGetField, ReturnsFirstOfDuplicateFields) {
+    BSONObjBuilder bob;
+    bob.append("a", 1);
+    bob.append("a", 2);
+    ASSERT_EQ(bob.obj().getField("a").numberInt(), 1);
+}
+
+TEST(BSONObjGetField, NameWithEmbeddedNulDoesNotMatchShorterField) {
+    // The first byte of the value 98 is 'b' and its second byte is NUL.
+    BSONObj obj = BSON("a" << 98);
+    ASSERT(obj.getField(StringData("a\0b", 3)).eoo());
+}
+
 }  // unnamed namespace
@@ -414,6 +414,139 @@ Status validateBSONIterative(Buffer* buffer) {
     return Status::OK();
 }
 
+/**
+ * Checks a buffer against exactly the same rules as validateBSONIterative(), but only answers
+ * whether it is valid. Since almost every document we validate is valid, this is the common path:
+ * it descends into nested objects by recursion rather than with a heap-allocated frame stack, and
+ * does none of the bookkeeping needed to describe an error. When it fails, validateBSON() runs
+ * validateBSONIterative() to produce the error.
+ */
+class FastValidator {
+public:
+    FastValidator(const char* buffer, uint64_t maxLength)
+        : _buffer(buffer), _maxLength(maxLength) {}
+
+    bool validate() {
+        return validateObject(0);
+    }
+
+private:
+    bool validateObject(size_t numFrames) {
+        if (numFrames > BSONDepth::getMaxAllowableDepth()) {
+            return false;
+        }
+
+        const uint64_t startPosition = _position;
+        int32_t expectedSize;
+        if (!readNumber(&expectedSize)) {
+            return false;
+        }
+
+        while (true) {
+            signed char type;
+            if (!readNumber(&type)) {
+                return false;
+            }
+            if (type == EOO) {
+                return _position - startPosition == static_cast<uint64_t>(expectedSize);
+            }
+            if (!skipCString() || !validateElementValue(type, numFrames + 1)) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * Validates the value of an element of type 'type' in an object which has 'numFrames' frames,
+     * counting itself, on the validation stack.
+     */
+    bool validateElementValue(signed char type, size_t numFrames) {
+        switch (type) {
+            case MinKey:
+            case MaxKey:
+            case jstNULL:
+            case Undefined:
+                return true;
+            case jstOID:
+                return skip(OID::kOIDSize);
+            case NumberInt:
+                return skip(sizeof(int32_t));
+            case Bool: {
+                uint8_t val;
+                return readNumber(&val) && (val == 0 || val == 1);
+            }
+            case NumberDouble:
+            case NumberLong:
+            case bsonTimestamp:
+            case Date:
+                return skip(sizeof(int64_t));
+            case NumberDecimal:
+                return skip(sizeof(Decimal128::Value));
+            case DBRef:
+                return skipUTF8String() && skip(OID::kOIDSize);
+            case RegEx:
+                return skipCString() && skipCString();
+            case Code:
+            case Symbol:
+            case String:
+                return skipUTF8String();
+            case BinData: {
+                int32_t sz;
+                return readNumber(&sz) && sz >= 0 && sz != std::numeric_limits<int>::max() &&
+                    skip(1 + sz);
+            }
+            case CodeWScope: {
+                const uint64_t startPosition = _position;
+                int32_t expectedSize;
+                return readNumber(&expectedSize) && skipUTF8String() &&
+                    validateObject(numFrames + 1) &&
+                    _position - startPosition == static_cast<uint64_t>(expectedSize);
+            }
+            case Object:
+            case Array:
+                return validateObject(numFrames);
+            default:
+                return false;
+        }
+    }
+
+    template <typename N>
+    bool readNumber(N* out) {
+        if ((_position + sizeof(N)) > _maxLength)
+            return false;
+        *out = ConstDataView(_buffer).read<LittleEndian<N>>(_position);
+        _position += sizeof(N);
+        return true;
+    }
+
+    bool skip(uint64_t sz) {
+        _position += sz;
+        return _position < _maxLength;
+    }
+
+    bool skipCString() {
+        // memchr() is vectorized by the C library, so this scans for the terminator many bytes at a
+        // time.
+        const void* end = memchr(_buffer + _position, 0, _maxLength - _position);
+        if (!end)
+            return false;
+        _position = static_cast<const char*>(end) - _buffer + 1;
+        return true;
+    }
+
+    bool skipUTF8String() {
+        int32_t sz;
+        if (!readNumber(&sz) || sz <= 0 || !skip(sz - 1))
+            return false;
+        char terminator;
+        return readNumber(&terminator) && terminator == 0;
+    }
+
+    const char* const _buffer;
+    const uint64_t _maxLength;
+    uint64_t _position = 0;
+};
+
 }  // namespace
 
 Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
@@ -421,6 +554,10 @@ Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion
         return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
     }
 
+    if (FastValidator(originalBuffer, maxLength).validate()) {
+        return Status::OK();
+    }
+
     Buffer buf(originalBuffer, maxLength, version);
     return validateBSONIterative(&buf);
 }
@@ -0,0 +1,63 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeMixedObject(int64_t numFields) {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    for (int64_t i = 0; i < numFields; i += 4) {
+        bob.append("int", static_cast<int>(i));
+        bob.append("double", static_cast<double>(i));
+        bob.append("string", "a short string value");
+        BSONObjBuilder sub(bob.subobjStart("sub"));
+        sub.append("a", static_cast<long long>(i));
+        sub.append("b", true);
+    }
+    return bob.obj();
+}
+
+void BM_ValidateBSON(benchmark::State& state) {
+    const BSONObj obj = makeMixedObject(state.range());
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(
+            validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest).isOK());
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+MONGO_BENCHMARK(BM_ValidateBSON)->arg(4)->arg(64)->arg(1024);
+
+}  // namespace
+}  // namespace mongo
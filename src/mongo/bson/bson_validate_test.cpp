@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/data_view.h"
+#include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/random.h"
@@ -354,4 +355,34 @@ TEST(BSONValidateBool, BoolValuesAreValidated) {
     }
 }
 
+BSONObj makeNestedObject(size_t depth) {
+    BSONObj obj = BSON("x" << 1);
+    for (size_t i = 0; i < depth; ++i) {
+        obj = BSON("a" << obj);
+    }
+    return obj;
+}
+
+TEST(BSONValidateDepth, NestingUpToMaxDepthIsValid) {
+    const BSONObj obj = makeNestedObject(BSONDepth::getMaxAllowableDepth());
+    ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+}
+
+TEST(BSONValidateDepth, NestingBeyondMaxDepthIsReportedAsOverflow) {
+    const BSONObj obj = makeNestedObject(BSONDepth::getMaxAllowableDepth() + 1);
+    ASSERT_EQ(ErrorCodes::Overflow,
+              validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+}
+
+TEST(BSONValidateDepth, CodeWScopeCountsTowardsDepth) {
+    const BSONObj obj = BSON(
+        "a" << BSONCodeWScope("code", makeNestedObject(BSONDepth::getMaxAllowableDepth() - 1)));
+    ASSERT_EQ(ErrorCodes::Overflow,
+              validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+
+    const BSONObj shallower = BSON(
+        "a" << BSONCodeWScope("code", makeNestedObject(BSONDepth::getMaxAllowableDepth() - 2)));
+    ASSERT_OK(validateBSON(shallower.objdata(), shallower.objsize(), BSONVersion::kLatest));
+}
+
 }  // namespace
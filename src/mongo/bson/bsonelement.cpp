@@ -49,18 +49,24 @@
 namespace mongo {
 namespace str = mongoutils::str;
 
-using std::dec;
-using std::hex;
 using std::string;
 
 string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames, int pretty) const {
-    std::stringstream s;
+    StringBuilder s;
+    jsonString(s, format, includeFieldNames, pretty);
+    return s.str();
+}
+
+void BSONElement::jsonString(StringBuilder& s,
+                             JsonStringFormat format,
+                             bool includeFieldNames,
+                             int pretty) const {
     if (includeFieldNames)
         s << '"' << escape(fieldName()) << "\" : ";
     switch (type()) {
         case mongo::String:
         case Symbol:
-            s << '"' << escape(string(valuestr(), valuestrsize() - 1)) << '"';
+            s << '"' << escape(StringData(valuestr(), valuestrsize() - 1)) << '"';
             break;
         case NumberLong:
             if (format == TenGen) {
@@ -77,8 +83,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
         case NumberDouble:
             if (number() >= -std::numeric_limits<double>::max() &&
                 number() <= std::numeric_limits<double>::max()) {
-                s.precision(16);
-                s << number();
+                s.appendDoublePrecise(number());
             }
             // This is not valid JSON, but according to RFC-4627, "Numeric values that cannot be
             // represented as sequences of digits (such as Infinity and NaN) are not permitted." so
@@ -127,7 +132,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             }
             break;
         case Object:
-            s << embeddedObject().jsonString(format, pretty);
+            embeddedObject().jsonString(s, format, pretty);
             break;
         case mongo::Array: {
             if (embeddedObject().isEmpty()) {
@@ -149,7 +154,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
                     if (strtol(e.fieldName(), 0, 10) > count) {
                         s << "undefined";
                     } else {
-                        s << e.jsonString(format, false, pretty ? pretty + 1 : 0);
+                        e.jsonString(s, format, false, pretty ? pretty + 1 : 0);
                         e = i.next();
                     }
                     count++;
@@ -169,7 +174,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             s << '"' << valuestr() << "\", ";
             if (format != TenGen)
                 s << "\"$id\" : ";
-            s << '"' << mongo::OID::from(valuestr() + valuestrsize()) << "\" ";
+            s << '"' << mongo::OID::from(valuestr() + valuestrsize()).toString() << "\" ";
             if (format == TenGen)
                 s << ')';
             else
@@ -182,7 +187,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             } else {
                 s << "{ \"$oid\" : ";
             }
-            s << '"' << __oid() << '"';
+            s << '"' << __oid().toString() << '"';
             if (format == TenGen) {
                 s << " )";
             } else {
@@ -192,15 +197,10 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
         case BinData: {
             ConstDataCursor reader(value());
             const int len = reader.readAndAdvance<LittleEndian<int>>();
-            BinDataType type = static_cast<BinDataType>(reader.readAndAdvance<uint8_t>());
+            const uint8_t type = reader.readAndAdvance<uint8_t>();
 
-            s << "{ \"$binary\" : \"";
-            base64::encode(s, reader.view(), len);
-            s << "\", \"$type\" : \"" << hex;
-            s.width(2);
-            s.fill('0');
-            s << type << dec;
-            s << "\" }";
+            s << "{ \"$binary\" : \"" << base64::encode(reader.view(), len);
+            s << "\", \"$type\" : \"" << toHexLower(&type, 1) << "\" }";
             break;
         }
         case mongo::Date:
@@ -266,7 +266,9 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             BSONObj scope = codeWScopeObject();
             if (!scope.isEmpty()) {
                 s << "{ \"$code\" : \"" << escape(_asCode()) << "\" , "
-                  << "\"$scope\" : " << scope.jsonString() << " }";
+                  << "\"$scope\" : ";
+                scope.jsonString(s);
+                s << " }";
                 break;
             }
         }
@@ -301,7 +303,6 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             string message = ss.str();
             massert(10312, message.c_str(), false);
     }
-    return s.str();
 }
 
 namespace {
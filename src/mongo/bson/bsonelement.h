@@ -210,6 +210,10 @@ public:
     std::string jsonString(JsonStringFormat format,
                            bool includeFieldNames = true,
                            int pretty = 0) const;
+    void jsonString(StringBuilder& s,
+                    JsonStringFormat format,
+                    bool includeFieldNames = true,
+                    int pretty = 0) const;
     operator std::string() const {
         return toString();
     }
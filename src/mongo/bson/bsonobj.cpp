@@ -31,6 +31,8 @@
 
 #include "mongo/db/jsobj.h"
 
+#include <cstring>
+
 #include "mongo/base/data_range.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/bsonelement_comparator_interface.h"
@@ -118,12 +120,25 @@ string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArray) co
         return isArray ? "[]" : "{}";
 
     StringBuilder s;
+    jsonString(s, format, pretty, isArray);
+    return s.str();
+}
+
+void BSONObj::jsonString(StringBuilder& s,
+                         JsonStringFormat format,
+                         int pretty,
+                         bool isArray) const {
+    if (isEmpty()) {
+        s << (isArray ? "[]" : "{}");
+        return;
+    }
+
     s << (isArray ? "[ " : "{ ");
     BSONObjIterator i(*this);
     BSONElement e = i.next();
     if (!e.eoo())
         while (1) {
-            s << e.jsonString(format, !isArray, pretty ? pretty + 1 : 0);
+            e.jsonString(s, format, !isArray, pretty ? pretty + 1 : 0);
             e = i.next();
             if (e.eoo())
                 break;
@@ -137,7 +152,6 @@ string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArray) co
             }
         }
     s << (isArray ? " ]" : " }");
-    return s.str();
 }
 
 bool BSONObj::valid(BSONVersion version) const {
@@ -473,15 +487,22 @@ void BSONObj::getFields(unsigned n, const char** fieldNames, BSONElement* fields
 }
 
 BSONElement BSONObj::getField(StringData name) const {
-    BSONObjIterator i(*this);
-    while (i.more()) {
-        BSONElement e = i.next();
-        // We know that e has a cached field length since BSONObjIterator::next internally
-        // called BSONElement::size on the BSONElement that it returned, so it is more
-        // efficient to re-use that information by obtaining the field name as a
-        // StringData, which will be pre-populated with the cached length.
-        if (name == e.fieldNameStringData())
-            return e;
+    // Compare each field name in place rather than going through BSONObjIterator, which measures
+    // every field name before it can be compared. Most field names differ from 'name' within
+    // their first few bytes, so the name's length is only computed to step over the element.
+    const size_t nameSize = name.size();
+    const char* pos = objdata() + 4;
+    const char* const end = objdata() + objsize() - 1;  // The terminating EOO.
+    while (pos < end) {
+        const char* fieldName = pos + 1;
+        if (static_cast<size_t>(end - fieldName) > nameSize &&
+            (nameSize == 0 || std::memcmp(fieldName, name.rawData(), nameSize) == 0) &&
+            fieldName[nameSize] == '\0' &&
+            // Guard against a 'name' with an embedded NUL matching a shorter field name.
+            std::strlen(fieldName) == nameSize) {
+            return BSONElement(pos, nameSize + 1, BSONElement::FieldNameSizeTag());
+        }
+        pos += BSONElement(pos).size();
     }
     return BSONElement();
 }
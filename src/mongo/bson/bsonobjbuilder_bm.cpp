@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+void BM_BSONObjBuilderAppendMixed(benchmark::State& state) {
+    const auto numFields = state.range();
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        for (int64_t i = 0; i < numFields; i += 4) {
+            bob.append("int", static_cast<int>(i));
+            bob.append("long", static_cast<long long>(i));
+            bob.append("double", static_cast<double>(i));
+            bob.append("string", "a short string value");
+        }
+        benchmark::doNotOptimize(bob.done().objsize());
+    }
+    state.setItemsProcessed(state.iterations() * numFields);
+}
+MONGO_BENCHMARK(BM_BSONObjBuilderAppendMixed)->arg(4)->arg(64)->arg(1024);
+
+void BM_BSONObjBuilderNested(benchmark::State& state) {
+    const auto depth = state.range();
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        std::vector<std::unique_ptr<BSONObjBuilder>> builders;
+        BSONObjBuilder* current = &bob;
+        for (int64_t i = 0; i < depth; ++i) {
+            current->append("x", static_cast<int>(i));
+            builders.push_back(stdx::make_unique<BSONObjBuilder>(current->subobjStart("sub")));
+            current = builders.back().get();
+        }
+        // Close the innermost builders first.
+        while (!builders.empty()) {
+            builders.pop_back();
+        }
+        benchmark::doNotOptimize(bob.done().objsize());
+    }
+}
+MONGO_BENCHMARK(BM_BSONObjBuilderNested)->arg(1)->arg(16);
+
+void BM_BSONObjIterate(benchmark::State& state) {
+    BSONObjBuilder bob;
+    for (int64_t i = 0; i < state.range(); ++i) {
+        bob.append(std::to_string(i), static_cast<int>(i));
+    }
+    const BSONObj obj = bob.obj();
+
+    while (state.keepRunning()) {
+        int sum = 0;
+        for (auto&& elem : obj) {
+            sum += elem.numberInt();
+        }
+        benchmark::doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+MONGO_BENCHMARK(BM_BSONObjIterate)->arg(64);
+
+}  // namespace
+}  // namespace mongo
@@ -65,8 +65,6 @@ enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
-    STRINGVAL_RESERVE_SIZE = 4096,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
     NS_RESERVE_SIZE = 64,
@@ -152,7 +150,6 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
         }
     } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
         std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
         Status ret = quotedString(&valueString);
         if (ret != Status::OK()) {
             return ret;
@@ -202,7 +199,6 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
 
     // Special object
     std::string firstField;
-    firstField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&firstField);
     if (ret != Status::OK()) {
         return ret;
@@ -314,9 +310,11 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        // Reuse one buffer for the rest of the field names, so that only field names longer than
+        // any before them need an allocation.
+        std::string fieldName;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
+            fieldName.clear();
             Status fieldRet = field(&fieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
@@ -429,7 +427,6 @@ Status JParse::dateObject(StringData fieldName, BSONObjBuilder& builder) {
         date = dateRet.getValue();
     } else if (readToken(LBRACE)) {
         std::string fieldName;
-        fieldName.reserve(FIELD_RESERVE_SIZE);
         Status ret = field(&fieldName);
         if (ret != Status::OK()) {
             return ret;
@@ -1184,7 +1181,13 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
             }
             ++q;
         } else {
-            result->push_back(*q++);
+            // Append the whole run of characters which need no unescaping at once.
+            const char* runStart = q++;
+            while (q < _input_end && *q != '\\' && !(0x00 <= *q && *q <= 0x1F) &&
+                   !match(*q, terminalSet) && (allowedSet == NULL || match(*q, allowedSet))) {
+                ++q;
+            }
+            result->append(runStart, q);
         }
     }
     if (q < _input_end) {
@@ -1246,7 +1249,6 @@ bool JParse::readTokenImpl(const char* token, bool advance) {
 bool JParse::readField(StringData expectedField) {
     MONGO_JSON_DEBUG("expectedField: " << expectedField);
     std::string nextField;
-    nextField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&nextField);
     if (ret != Status::OK()) {
         return false;
@@ -31,6 +31,7 @@
 
 #include <cfloat>
 #include <cinttypes>
+#include <cmath>
 #include <cstdint>
 #include <sstream>
 #include <stdio.h>
@@ -395,6 +396,9 @@ public:
     StringBuilderImpl() {}
 
     StringBuilderImpl& operator<<(double x) {
+        if (appendDoubleAsIntegral(x, 1e6)) {
+            return *this;
+        }
         return SBNUM(x, MONGO_DBL_SIZE, "%g");
     }
     StringBuilderImpl& operator<<(int x) {
@@ -449,7 +453,22 @@ public:
         return *this;
     }
 
+    /**
+     * Appends 'x' formatted as printf("%.16g") would, which is also how a std::ostream with a
+     * precision of 16 formats it.
+     */
+    void appendDoublePrecise(double x) {
+        if (!appendDoubleAsIntegral(x, 1e16)) {
+            SBNUM(x, MONGO_DBL_SIZE, "%.16g");
+        }
+    }
+
     void appendDoubleNice(double x) {
+        if (appendDoubleAsIntegral(x, 1e16)) {
+            write(".0", 2);
+            return;
+        }
+
         const int prev = _buf.l;
         const int maxSize = 32;
         char* start = _buf.grow(maxSize);
@@ -509,6 +528,19 @@ private:
         return *this;
     }
 
+    /**
+     * If 'x' is a whole number of magnitude less than 'limit', appends it as an integer and returns
+     * true. For a 'limit' of 10^P, this is exactly how printf("%.<P>g") formats such a number, but
+     * much cheaper than calling snprintf().
+     */
+    bool appendDoubleAsIntegral(double x, double limit) {
+        if (!(std::abs(x) < limit) || x != std::trunc(x) || (x == 0 && std::signbit(x))) {
+            return false;
+        }
+        appendIntegral(static_cast<long long>(x), MONGO_S64_SIZE);
+        return true;
+    }
+
     template <typename T>
     StringBuilderImpl& SBNUM(T val, int maxSize, const char* macro) {
         int prev = _buf.l;
@@ -29,6 +29,10 @@
 
 #include "mongo/unittest/unittest.h"
 
+#include <cstdio>
+#include <limits>
+#include <vector>
+
 #include "mongo/bson/util/builder.h"
 
 namespace mongo {
@@ -123,4 +127,58 @@ TEST(Builder, AppendUnsignedLongLong) {
 TEST(Builder, AppendShort) {
     testStringBuilderIntegral<short>();
 }
+
+std::string formatWithPrintf(const char* format, double x) {
+    char buf[StringBuilder::MONGO_DBL_SIZE];
+    snprintf(buf, sizeof(buf), format, x);
+    return buf;
+}
+
+const std::vector<double> kInterestingDoubles = {0.0,
+                                                 -0.0,
+                                                 1.0,
+                                                 -1.0,
+                                                 0.5,
+                                                 999999.0,
+                                                 1000000.0,
+                                                 -1000001.0,
+                                                 123456789.0,
+                                                 9007199254740993.0,
+                                                 9999999999999998.0,
+                                                 1e16,
+                                                 -1e17,
+                                                 1.0 / 3,
+                                                 1e-300,
+                                                 std::numeric_limits<double>::max(),
+                                                 std::numeric_limits<double>::infinity(),
+                                                 std::numeric_limits<double>::quiet_NaN()};
+
+TEST(Builder, AppendDoubleMatchesPrintf) {
+    for (double x : kInterestingDoubles) {
+        StringBuilder sb;
+        sb << x;
+        ASSERT_EQ(formatWithPrintf("%g", x), sb.str());
+    }
+}
+
+TEST(Builder, AppendDoublePreciseMatchesPrintf) {
+    for (double x : kInterestingDoubles) {
+        StringBuilder sb;
+        sb.appendDoublePrecise(x);
+        ASSERT_EQ(formatWithPrintf("%.16g", x), sb.str());
+    }
+}
+
+TEST(Builder, AppendDoubleNiceAlwaysHasAFractionOrExponent) {
+    auto format = [](double x) {
+        StringBuilder sb;
+        sb.appendDoubleNice(x);
+        return sb.str();
+    };
+    ASSERT_EQ("0.0", format(0.0));
+    ASSERT_EQ("-0.0", format(-0.0));
+    ASSERT_EQ("42.0", format(42.0));
+    ASSERT_EQ("-9999999999999998.0", format(-9999999999999998.0));
+    ASSERT_EQ("0.25", format(0.25));
+}
 }
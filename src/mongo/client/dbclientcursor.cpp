@@ -204,7 +204,7 @@ bool DBClientCursor::initLazyFinish(bool& retry) {
 }
 
 void DBClientCursor::requestMore() {
-    invariant(!_connectionHasPendingReplies);
+    invariant(!_connectionHasPendingReplies || _getMorePending);
     verify(cursorId && batch.pos == batch.objs.size());
 
     if (haveLimit) {
@@ -220,9 +220,18 @@ void DBClientCursor::requestMore() {
         _client = connHolder->get();
     }
 
-    Message toSend = _assembleGetMore();
     Message response;
-    _client->call(toSend, response);
+    if (_getMorePending) {
+        if (_connectionHasPendingReplies) {
+            _receivePipelinedGetMore();
+        }
+        response = std::move(_pipelinedReply);
+        _pipelinedReply.reset();
+        _getMorePending = false;
+    } else {
+        Message toSend = _assembleGetMore();
+        _client->call(toSend, response);
+    }
 
     // If call() succeeds, the connection is clean so we can return it to the pool, even if
     // dataReceived() throws because the command reported failure. However, we can't return it yet,
@@ -235,6 +244,32 @@ void DBClientCursor::requestMore() {
     dataReceived(response);
 }
 
+void DBClientCursor::_pipelineGetMore() {
+    if (!_pipelineGetMores || _getMorePending || !cursorId || haveLimit ||
+        (opts & (QueryOption_CursorTailable | QueryOption_Exhaust))) {
+        return;
+    }
+    if (!_client || !_client->lazySupported() || _client->type() != ConnectionString::MASTER) {
+        return;
+    }
+
+    Message toSend = _assembleGetMore();
+    _client->say(toSend);
+    _lastRequestId = toSend.header().getId();
+    _connectionHasPendingReplies = true;
+    _getMorePending = true;
+}
+
+void DBClientCursor::_receivePipelinedGetMore() {
+    invariant(_getMorePending && _connectionHasPendingReplies);
+    verify(_client);
+    _connectionHasPendingReplies = false;
+    if (!_client->recv(_pipelinedReply, _lastRequestId)) {
+        _pipelinedReply.reset();
+        uasserted(40658, "recv failed while receiving a pipelined getMore reply");
+    }
+}
+
 /** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
 void DBClientCursor::exhaustReceiveMore() {
     verify(cursorId && batch.pos == batch.objs.size());
@@ -359,8 +394,10 @@ bool DBClientCursor::more() {
     if (haveLimit && static_cast<int>(batch.pos) >= nToReturn)
         return false;
 
-    if (batch.pos < batch.objs.size())
+    if (batch.pos < batch.objs.size()) {
+        _pipelineGetMore();
         return true;
+    }
 
     if (cursorId == 0)
         return false;
@@ -439,6 +476,12 @@ void DBClientCursor::attach(AScopedConnection* conn) {
     verify(conn);
     verify(conn->get());
 
+    // The connection goes back to the pool, so the reply to a pipelined getMore must be read off
+    // it first.
+    if (_getMorePending && _connectionHasPendingReplies) {
+        _receivePipelinedGetMore();
+    }
+
     if (conn->get()->type() == ConnectionString::SET) {
         if (_lazyHost.size() > 0)
             _scopedHost = _lazyHost;
@@ -508,7 +551,7 @@ DBClientCursor::DBClientCursor(DBClientBase* client,
       haveLimit(nToReturn > 0 && !(queryOptions & QueryOption_CursorTailable)),
       nToSkip(nToSkip),
       fieldsToReturn(fieldsToReturn),
-      opts(queryOptions & ~QueryOptionLocal_forceOpQuery),
+      opts(queryOptions & ~(QueryOptionLocal_forceOpQuery | QueryOptionLocal_pipelineGetMores)),
       batchSize(batchSize == 1 ? 2 : batchSize),
       resultFlags(0),
       cursorId(cursorId),
@@ -517,6 +560,8 @@ DBClientCursor::DBClientCursor(DBClientBase* client,
       _enabledBSONVersion(Validator<BSONObj>::enabledBSONVersion()) {
     if (queryOptions & QueryOptionLocal_forceOpQuery)
         _useFindCommand = false;
+    if (queryOptions & QueryOptionLocal_pipelineGetMores)
+        _pipelineGetMores = true;
 }
 
 DBClientCursor::~DBClientCursor() {
@@ -525,6 +570,11 @@ DBClientCursor::~DBClientCursor() {
 
 void DBClientCursor::kill() {
     DESTRUCTOR_GUARD({
+        // Drain the reply to a pipelined getMore, so that the connection remains usable.
+        if (_getMorePending && _connectionHasPendingReplies) {
+            _receivePipelinedGetMore();
+        }
+
         if (cursorId && _ownCursor && !globalInShutdownDeprecated()) {
             auto killCursor = [&](auto& conn) {
                 if (_useFindCommand) {
@@ -139,6 +139,17 @@ public:
      */
     enum { QueryOptionLocal_forceOpQuery = 1 << 30 };
 
+    /**
+     * Fold this in with queryOptions to request each batch of the cursor from the server as soon
+     * as the caller starts consuming the previous one, so that the server produces the next batch
+     * while the caller processes the current one. Like exhaust, this leaves a reply pending on the
+     * connection for as long as the cursor is open, so the connection must not be used for
+     * anything else until the cursor is exhausted or killed. It is ignored for cursors which are
+     * tailable, have a limit, or are not on a single direct connection.
+     * This flag is never sent over the wire and is only used locally.
+     */
+    enum { QueryOptionLocal_pipelineGetMores = 1 << 29 };
+
     DBClientCursor(DBClientBase* client,
                    const std::string& ns,
                    const BSONObj& query,
@@ -208,8 +219,9 @@ public:
      * If true, you should not try to use the connection for any other purpose or return it to a
      * pool.
      *
-     * This can happen if either initLazy() was called without initLazyFinish() or an exhaust query
-     * was started but not completed.
+     * This can happen if either initLazy() was called without initLazyFinish(), an exhaust query
+     * was started but not completed, or the next batch of a cursor with pipelined getMores was
+     * requested but not received yet.
      */
     bool connectionHasPendingReplies() const {
         return _connectionHasPendingReplies;
@@ -256,6 +268,12 @@ private:
     bool _useFindCommand = true;
     bool _connectionHasPendingReplies = false;
     int _lastRequestId = 0;
+    bool _pipelineGetMores = false;
+
+    // Set once the getMore for the next batch has been sent ahead of time. Its reply is read into
+    // '_pipelinedReply' when that batch is needed, or earlier if the connection must be freed.
+    bool _getMorePending = false;
+    Message _pipelinedReply;
 
     void dataReceived(const Message& reply) {
         bool retry;
@@ -272,6 +290,16 @@ private:
 
     void requestMore();
 
+    /**
+     * Sends the getMore for the next batch ahead of time, if pipelining is enabled and possible.
+     */
+    void _pipelineGetMore();
+
+    /**
+     * Reads the reply to the pipelined getMore off the connection.
+     */
+    void _receivePipelinedGetMore();
+
     // init pieces
     Message _assembleInit();
     Message _assembleGetMore();
@@ -28,6 +28,8 @@
 
 #include "mongo/client/embedded/libmongodbcapi.h"
 
+#include <algorithm>
+#include <cstring>
 #include <exception>
 #include <thread>
 #include <unordered_map>
@@ -82,6 +84,57 @@ libmongodbcapi_db* global_db = nullptr;
 thread_local int last_error = LIBMONGODB_CAPI_ERROR_SUCCESS;
 bool run_setup = false;
 
+/**
+ * Options which keep an embedded mongod small and quick to start, such as not collecting
+ * diagnostic data. Each one is only added if none of the arguments of the caller contains any of
+ * its 'setBy' strings, so that the caller can still choose otherwise.
+ */
+struct EmbeddedDefaultOption {
+    std::vector<const char*> setBy;
+    std::vector<const char*> args;
+};
+
+const std::vector<EmbeddedDefaultOption>& embeddedDefaultOptions() {
+    static const std::vector<EmbeddedDefaultOption> options = {
+        {{"diagnosticDataCollectionEnabled"},
+         {"--setParameter", "diagnosticDataCollectionEnabled=false"}},
+        {{"wiredTigerCacheSizeGB"}, {"--wiredTigerCacheSizeGB", "0.25"}},
+        {{"nounixsocket", "unixSocketPrefix"}, {"--nounixsocket"}},
+    };
+    return options;
+}
+
+/**
+ * Returns the arguments mongod is started with: the caller's, followed by those embedded defaults
+ * the caller did not override. Defaults are not added when a config file is given, since command
+ * line options would take precedence over its settings.
+ */
+std::vector<const char*> embeddedArgs(int argc, const char** argv) {
+    std::vector<const char*> args(argv, argv + argc);
+    const auto isSetByCaller = [&](const char* needle) {
+        for (int i = 1; i < argc; i++) {
+            if (std::strstr(argv[i], needle)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const auto isConfigFile = [](const char* arg) {
+        return std::strcmp(arg, "-f") == 0 || std::strncmp(arg, "--config", 8) == 0;
+    };
+
+    if (argc == 0 || std::any_of(argv + 1, argv + argc, isConfigFile)) {
+        return args;
+    }
+    for (auto&& option : embeddedDefaultOptions()) {
+        if (std::none_of(option.setBy.begin(), option.setBy.end(), isSetByCaller)) {
+            args.insert(args.end(), option.args.begin(), option.args.end());
+        }
+    }
+    return args;
+}
+
 libmongodbcapi_db* db_new(int argc, const char** argv, const char** envp) noexcept try {
     last_error = LIBMONGODB_CAPI_ERROR_SUCCESS;
     if (global_db) {
@@ -91,11 +144,13 @@ libmongodbcapi_db* db_new(int argc, const char** argv, const char** envp) noexce
 
     if (!run_setup) {
         // iterate over argv and copy them to argvStorage
-        for (int i = 0; i < argc; i++) {
+        const auto args = embeddedArgs(argc, argv);
+        argc = args.size();
+        for (const char* arg : args) {
             // allocate space for the null terminator
-            auto s = mongo::stdx::make_unique<char[]>(std::strlen(argv[i]) + 1);
+            auto s = mongo::stdx::make_unique<char[]>(std::strlen(arg) + 1);
             // copy the string + null terminator
-            std::strncpy(s.get(), argv[i], std::strlen(argv[i]) + 1);
+            std::strncpy(s.get(), arg, std::strlen(arg) + 1);
             global_db->argvPointers.push_back(s.get());
             global_db->argvStorage.push_back(std::move(s));
         }
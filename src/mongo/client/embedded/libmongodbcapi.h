@@ -45,6 +45,10 @@ typedef enum {
 /**
 * Starts the database and returns a handle with the service context.
 *
+* Unless argv overrides them or names a config file, the database is started with options that
+* reduce its footprint: no diagnostic data collection, a 256MB WiredTiger cache and no unix domain
+* socket.
+*
 * @param argc
 *      The number of arguments in argv
 * @param argv
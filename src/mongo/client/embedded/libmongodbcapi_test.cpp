@@ -157,6 +157,24 @@ TEST_F(MongodbCAPITest, IsMaster) {
     ASSERT(outputOpMsg.body.getBoolField("ismaster"));
 }
 
+TEST_F(MongodbCAPITest, StartsWithoutDiagnosticDataCollection) {
+    auto client = createClient();
+
+    auto inputMessage =
+        mongo::OpMsgRequest::fromDBAndBody(
+            "admin", mongo::fromjson("{getParameter: 1, diagnosticDataCollectionEnabled: 1}"))
+            .serialize();
+
+    void* output;
+    size_t outputSize;
+    int err = libmongodbcapi_db_client_wire_protocol_rpc(
+        client.get(), inputMessage.buf(), inputMessage.size(), &output, &outputSize);
+    ASSERT_EQUALS(err, LIBMONGODB_CAPI_ERROR_SUCCESS);
+
+    auto outputOpMsg = mongo::OpMsg::parseOwned(messageFromBuffer(output, outputSize));
+    ASSERT_EQUALS(outputOpMsg.body.getField("ok").numberDouble(), 1.0);
+    ASSERT_FALSE(outputOpMsg.body.getBoolField("diagnosticDataCollectionEnabled"));
+}
 
 TEST_F(MongodbCAPITest, InsertDocument) {
     auto client = createClient();
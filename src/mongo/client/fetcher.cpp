@@ -224,6 +224,7 @@ std::string Fetcher::getDiagnosticString() const {
     output << " getMoreNetworkTimeout: " << _getMoreNetworkTimeout;
     output << " shutting down?: " << _isShuttingDown_inlock();
     output << " first: " << _first;
+    output << " streaming: " << static_cast<bool>(_streamingGetMoreFn);
     output << " firstCommandScheduler: " << _firstRemoteCommandScheduler.toString();
 
     if (_getMoreCallbackHandle.isValid()) {
@@ -243,6 +244,12 @@ bool Fetcher::_isActive_inlock() const {
     return State::kRunning == _state || State::kShuttingDown == _state;
 }
 
+void Fetcher::setStreamingGetMoreFn(const StreamingGetMoreFn& fn) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(State::kPreStart == _state);
+    _streamingGetMoreFn = fn;
+}
+
 Status Fetcher::schedule() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     switch (_state) {
@@ -308,6 +315,11 @@ bool Fetcher::_isShuttingDown_inlock() const {
     return State::kShuttingDown == _state;
 }
 
+bool Fetcher::_isDiscardingStreamedBatch() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _discardStreamedBatch;
+}
+
 Status Fetcher::_scheduleGetMore(const BSONObj& cmdObj) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     if (_isShuttingDown_inlock()) {
@@ -330,6 +342,39 @@ Status Fetcher::_scheduleGetMore(const BSONObj& cmdObj) {
 }
 
 void Fetcher::_callback(const RemoteCommandCallbackArgs& rcbd, const char* batchFieldName) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_inCallback) {
+            // Response to a streamed getMore that arrived while '_work' was still processing the
+            // previous batch. The thread running '_work' will pick it up when it is done.
+            invariant(!_pendingResponse);
+            _pendingResponse = rcbd.response;
+            return;
+        }
+        _inCallback = true;
+    }
+
+    auto response = rcbd.response;
+    while (_processResponse(response, batchFieldName)) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_pendingResponse) {
+            _inCallback = false;
+            return;
+        }
+        response = std::move(*_pendingResponse);
+        _pendingResponse = boost::none;
+        batchFieldName = kNextBatchFieldName;
+    }
+}
+
+bool Fetcher::_processResponse(const executor::RemoteCommandResponse& response,
+                               const char* batchFieldName) {
+    if (_isDiscardingStreamedBatch()) {
+        _sendKillCursors(_streamedCursorId, _streamedNss);
+        _finishCallback();
+        return false;
+    }
+
     QueryResponse batchData;
     auto finishCallbackGuard = MakeGuard([this, &batchData] {
         if (batchData.cursorId && !batchData.nss.isEmpty()) {
@@ -338,31 +383,31 @@ void Fetcher::_callback(const RemoteCommandCallbackArgs& rcbd, const char* batch
         _finishCallback();
     });
 
-    if (!rcbd.response.isOK()) {
-        _work(StatusWith<Fetcher::QueryResponse>(rcbd.response.status), nullptr, nullptr);
-        return;
+    if (!response.isOK()) {
+        _work(StatusWith<Fetcher::QueryResponse>(response.status), nullptr, nullptr);
+        return false;
     }
 
     if (_isShuttingDown()) {
         _work(Status(ErrorCodes::CallbackCanceled, "fetcher shutting down"), nullptr, nullptr);
-        return;
+        return false;
     }
 
-    const BSONObj& queryResponseObj = rcbd.response.data;
+    const BSONObj& queryResponseObj = response.data;
     Status status = getStatusFromCommandResult(queryResponseObj);
     if (!status.isOK()) {
         _work(StatusWith<Fetcher::QueryResponse>(status), nullptr, nullptr);
-        return;
+        return false;
     }
 
     status = parseCursorResponse(queryResponseObj, batchFieldName, &batchData);
     if (!status.isOK()) {
         _work(StatusWith<Fetcher::QueryResponse>(status), nullptr, nullptr);
-        return;
+        return false;
     }
 
-    batchData.otherFields.metadata = std::move(rcbd.response.metadata);
-    batchData.elapsedMillis = rcbd.response.elapsedMillis.value_or(Milliseconds{0});
+    batchData.otherFields.metadata = response.metadata;
+    batchData.elapsedMillis = response.elapsedMillis.value_or(Milliseconds{0});
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         batchData.first = _first;
@@ -373,7 +418,21 @@ void Fetcher::_callback(const RemoteCommandCallbackArgs& rcbd, const char* batch
 
     if (!batchData.cursorId) {
         _work(StatusWith<QueryResponse>(batchData), &nextAction, nullptr);
-        return;
+        return false;
+    }
+
+    // In streaming mode, request the next batch before handing this one to '_work'.
+    bool streamed = false;
+    if (_streamingGetMoreFn) {
+        auto streamingCmdObj = _streamingGetMoreFn(batchData);
+        if (!streamingCmdObj.isEmpty()) {
+            status = _scheduleGetMore(streamingCmdObj);
+            if (!status.isOK()) {
+                _work(StatusWith<Fetcher::QueryResponse>(status), nullptr, nullptr);
+                return false;
+            }
+            streamed = true;
+        }
     }
 
     nextAction = NextAction::kGetMore;
@@ -383,25 +442,37 @@ void Fetcher::_callback(const RemoteCommandCallbackArgs& rcbd, const char* batch
 
     // Callback function _work may modify nextAction to request the fetcher
     // not to schedule a getMore command.
-    if (nextAction != NextAction::kGetMore) {
-        return;
-    }
-
     // Callback function may also disable the fetching of additional data by not filling in the
     // BSONObjBuilder for the getMore command.
     auto cmdObj = bob.obj();
-    if (cmdObj.isEmpty()) {
-        return;
+    const bool wantsNextBatch = nextAction == NextAction::kGetMore && !cmdObj.isEmpty();
+
+    if (streamed) {
+        // The streamed getMore callback now owns completion of this fetcher.
+        finishCallbackGuard.Dismiss();
+        if (!wantsNextBatch) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _discardStreamedBatch = true;
+            _streamedCursorId = batchData.cursorId;
+            _streamedNss = batchData.nss;
+            _executor->cancel(_getMoreCallbackHandle);
+        }
+        return true;
+    }
+
+    if (!wantsNextBatch) {
+        return false;
     }
 
     status = _scheduleGetMore(cmdObj);
     if (!status.isOK()) {
         nextAction = NextAction::kNoAction;
         _work(StatusWith<Fetcher::QueryResponse>(status), nullptr, nullptr);
-        return;
+        return false;
     }
 
     finishCallbackGuard.Dismiss();
+    return true;
 }
 
 void Fetcher::_sendKillCursors(const CursorId id, const NamespaceString& nss) {
@@ -432,6 +503,7 @@ void Fetcher::_finishCallback() {
     // logic that's invoked at the function object's destruction that might call into this Fetcher.
     // 'tempWork' must be declared before lock guard 'lk' so that it is destroyed outside the lock.
     Fetcher::CallbackFn tempWork;
+    StreamingGetMoreFn tempStreamingGetMoreFn;
 
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     invariant(State::kComplete != _state);
@@ -441,6 +513,7 @@ void Fetcher::_finishCallback() {
 
     invariant(_work);
     std::swap(_work, tempWork);
+    std::swap(_streamingGetMoreFn, tempStreamingGetMoreFn);
 }
 
 std::ostream& operator<<(std::ostream& os, const Fetcher::State& state) {
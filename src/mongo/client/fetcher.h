@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -88,6 +89,12 @@ public:
     typedef stdx::function<void(const StatusWith<QueryResponse>&, NextAction*, BSONObjBuilder*)>
         CallbackFn;
 
+    /**
+     * Type of function used in streaming mode to build the getMore command for the next batch
+     * from the batch that was just received. See setStreamingGetMoreFn().
+     */
+    using StreamingGetMoreFn = stdx::function<BSONObj(const QueryResponse&)>;
+
     /**
      * Creates Fetcher task but does not schedule it to be run by the executor.
      *
@@ -167,6 +174,23 @@ public:
      */
     bool isActive() const;
 
+    /**
+     * Enables streaming mode. Must be called before schedule().
+     *
+     * In streaming mode the fetcher sends the getMore for the next batch as soon as a batch
+     * arrives and before 'work' is invoked on it, so that the remote server produces the next
+     * batch while this batch is being processed. The command is built by 'fn'; an empty object
+     * means the getMore is requested only after 'work' returns, as in the default mode.
+     *
+     * When a getMore has been streamed, the getMore command that 'work' appends to the
+     * BSONObjBuilder is not sent; filling it in (with NextAction left as kGetMore) only
+     * signals that the client wants the streamed batch. Otherwise, the streamed request is
+     * canceled and its cursor killed without invoking 'work' again.
+     *
+     * Batches are always delivered to 'work' one at a time, in the order they were requested.
+     */
+    void setStreamingGetMoreFn(const StreamingGetMoreFn& fn);
+
     /**
      * Schedules 'cmdObj' to be run on the remote server.
      */
@@ -212,6 +236,13 @@ private:
     void _callback(const executor::TaskExecutor::RemoteCommandCallbackArgs& rcbd,
                    const char* batchFieldName);
 
+    /**
+     * Parses a remote command response and passes it to '_work'.
+     * Returns true if a getMore request is still outstanding (the fetcher remains active).
+     */
+    bool _processResponse(const executor::RemoteCommandResponse& response,
+                          const char* batchFieldName);
+
     /**
      * Sets fetcher state to inactive and notifies waiters.
      */
@@ -230,6 +261,11 @@ private:
     bool _isShuttingDown() const;
     bool _isShuttingDown_inlock() const;
 
+    /**
+     * Returns whether the response to the streamed getMore should be discarded.
+     */
+    bool _isDiscardingStreamedBatch() const;
+
     // Not owned by us.
     executor::TaskExecutor* _executor;
 
@@ -254,6 +290,21 @@ private:
     // Callback handle to the scheduled getMore command.
     executor::TaskExecutor::CallbackHandle _getMoreCallbackHandle;
 
+    // Builds streamed getMore commands. Empty unless streaming mode is enabled.
+    StreamingGetMoreFn _streamingGetMoreFn;
+
+    // True while a response is being processed by _callback(). In streaming mode, the response
+    // to the streamed getMore may arrive before '_work' returns; it is parked in
+    // '_pendingResponse' and processed by the same thread once the current batch is done.
+    bool _inCallback = false;
+    boost::optional<executor::RemoteCommandResponse> _pendingResponse;
+
+    // Set when '_work' declined to continue after the next getMore had already been streamed.
+    // The response to that getMore is discarded and the cursor killed.
+    bool _discardStreamedBatch = false;
+    CursorId _streamedCursorId = 0;
+    NamespaceString _streamedNss;
+
     // Socket timeout
     Milliseconds _findNetworkTimeout;
     Milliseconds _getMoreNetworkTimeout;
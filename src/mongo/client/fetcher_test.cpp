@@ -1037,6 +1037,124 @@ TEST_F(FetcherTest, ShutdownDuringSecondBatch) {
     ASSERT_EQUALS(ErrorCodes::ShutdownInProgress, status.code());
 }
 
+BSONObj makeStreamedGetMore(const Fetcher::QueryResponse& batchData) {
+    return BSON("getMore" << batchData.cursorId << "collection" << batchData.nss.coll()
+                          << "streamed"
+                          << true);
+}
+
+TEST_F(FetcherTest, StreamingModeSendsGetMoreBeforeInvokingCallback) {
+    fetcher->setStreamingGetMoreFn(makeStreamedGetMore);
+
+    callbackHook = appendGetMoreRequest;
+
+    ASSERT_OK(fetcher->schedule());
+
+    const BSONObj doc = BSON("_id" << 1);
+    processNetworkResponse(BSON("cursor" << BSON("id" << 1LL << "ns"
+                                                      << "db.coll"
+                                                      << "firstBatch"
+                                                      << BSON_ARRAY(doc))
+                                         << "ok"
+                                         << 1),
+                           ReadyQueueState::kHasReadyRequests,
+                           FetcherState::kActive);
+    ASSERT_OK(status);
+    ASSERT_TRUE(Fetcher::NextAction::kGetMore == nextAction);
+
+    // Only the getMore streamed before the callback ran is sent. The one appended by the
+    // callback is not.
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        auto noi = getNet()->getNextReadyRequest();
+        auto request = noi->getRequest();
+        ASSERT_EQUALS("getMore", request.cmdObj.firstElementFieldName());
+        ASSERT_TRUE(request.cmdObj["streamed"].trueValue());
+        ASSERT_FALSE(getNet()->hasReadyRequests());
+        getNet()->scheduleSuccessfulResponse(
+            noi, ResponseStatus(BSON("cursor" << BSON("id" << 0LL << "ns"
+                                                                  << "db.coll"
+                                                                  << "nextBatch"
+                                                                  << BSON_ARRAY(doc))
+                                                     << "ok"
+                                                     << 1),
+                                       BSONObj(),
+                                       Milliseconds(0)));
+        getNet()->runReadyNetworkOperations();
+    }
+
+    ASSERT_OK(status);
+    ASSERT_EQUALS(0, cursorId);
+    ASSERT_FALSE(first);
+    ASSERT_FALSE(fetcher->isActive());
+}
+
+TEST_F(FetcherTest, StreamingModeFallsBackToGetMoreFromCallbackIfStreamingFnReturnsEmptyObject) {
+    fetcher->setStreamingGetMoreFn([](const Fetcher::QueryResponse&) { return BSONObj(); });
+    callbackHook = appendGetMoreRequest;
+
+    ASSERT_OK(fetcher->schedule());
+
+    processNetworkResponse(BSON("cursor" << BSON("id" << 1LL << "ns"
+                                                      << "db.coll"
+                                                      << "firstBatch"
+                                                      << BSONArray())
+                                         << "ok"
+                                         << 1),
+                           ReadyQueueState::kHasReadyRequests,
+                           FetcherState::kActive);
+
+    executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+    auto request = getNet()->getNextReadyRequest()->getRequest();
+    ASSERT_EQUALS("getMore", request.cmdObj.firstElementFieldName());
+    ASSERT_FALSE(request.cmdObj.hasField("streamed"));
+}
+
+TEST_F(FetcherTest, StreamingModeKillsCursorWhenCallbackStopsAfterGetMoreWasStreamed) {
+    fetcher->setStreamingGetMoreFn(makeStreamedGetMore);
+
+    // Callback does not fill in the getMore request.
+    callbackHook = [](const StatusWith<Fetcher::QueryResponse>& fetchResult,
+                      Fetcher::NextAction* nextAction,
+                      BSONObjBuilder* getMoreBob) {};
+
+    ASSERT_OK(fetcher->schedule());
+
+    const BSONObj doc = BSON("_id" << 1);
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        getNet()->scheduleSuccessfulResponse(BSON("cursor" << BSON("id" << 1LL << "ns"
+                                                                        << "db.coll"
+                                                                        << "firstBatch"
+                                                                        << BSON_ARRAY(doc))
+                                                           << "ok"
+                                                           << 1));
+        getNet()->runReadyNetworkOperations();
+
+        // Deliver the cancellation of the streamed getMore if it has not been delivered yet.
+        getNet()->runReadyNetworkOperations();
+    }
+
+    ASSERT_OK(status);
+    ASSERT_EQUALS(1LL, cursorId);
+    ASSERT_BSONOBJ_EQ(doc, documents.front());
+    ASSERT_FALSE(fetcher->isActive());
+
+    executor::RemoteCommandRequest request;
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        ASSERT_TRUE(getNet()->hasReadyRequests());
+        request = getNet()->getNextReadyRequest()->getRequest();
+    }
+
+    auto&& cmdObj = request.cmdObj;
+    ASSERT_EQUALS("killCursors", cmdObj.firstElementFieldName());
+    ASSERT_EQUALS("coll", cmdObj.firstElement().String());
+    auto cursors = cmdObj["cursors"].Array();
+    ASSERT_EQUALS(1U, cursors.size());
+    ASSERT_EQUALS(1LL, cursors.front().numberLong());
+}
+
 TEST_F(FetcherTest, FetcherAppliesRetryPolicyToFirstCommandButNotToGetMoreRequests) {
     auto policy = RemoteCommandRetryScheduler::makeRetryPolicy(
         3U,
@@ -92,6 +92,7 @@ const Milliseconds kFindHostMaxBackOffTime(500);
 // TODO: Move to ReplicaSetMonitorManager
 ReplicaSetMonitor::ConfigChangeHook asyncConfigChangeHook;
 ReplicaSetMonitor::ConfigChangeHook syncConfigChangeHook;
+ReplicaSetMonitor::PrimaryChangeHook syncPrimaryChangeHook;
 
 //
 // Helpers for stl algorithms
@@ -163,6 +164,12 @@ struct HostNotIn {
  * Replica set refresh period on the task executor.
  */
 const Seconds kRefreshPeriod(30);
+
+/**
+ * Refresh period used instead of kRefreshPeriod while the set has no known primary, so that the
+ * outcome of a failover is noticed without waiting for the next regular refresh.
+ */
+const Milliseconds kExpeditedRefreshPeriod(500);
 }  // namespace
 
 // If we cannot find a host after 15 seconds of refreshing, give up
@@ -235,9 +242,18 @@ void ReplicaSetMonitor::_refresh(const CallbackArgs& cbArgs) {
             return;
         }
 
+        Milliseconds refreshPeriod = kRefreshPeriod;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+            if (_state->getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly))
+                    .empty()) {
+                refreshPeriod = kExpeditedRefreshPeriod;
+            }
+        }
+
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         std::weak_ptr<ReplicaSetMonitor> that(shared_from_this());
-        auto status = _executor->scheduleWorkAt(_executor->now() + kRefreshPeriod,
+        auto status = _executor->scheduleWorkAt(_executor->now() + refreshPeriod,
                                                 [=](const CallbackArgs& cbArgs) {
                                                     if (auto ptr = that.lock()) {
                                                         ptr->_refresh(cbArgs);
@@ -270,7 +286,7 @@ StatusWith<HostAndPort> ReplicaSetMonitor::getHostOrRefresh(const ReadPreference
     {
         // Fast path, for the failure-free case
         stdx::lock_guard<stdx::mutex> lk(_state->mutex);
-        HostAndPort out = _state->getMatchingHost(criteria);
+        HostAndPort out = _state->getMatchingHostCached(criteria);
         if (!out.empty())
             return out;
     }
@@ -318,11 +334,36 @@ Refresher ReplicaSetMonitor::startOrContinueRefresh() {
 }
 
 void ReplicaSetMonitor::failedHost(const HostAndPort& host, const Status& status) {
-    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
-    Node* node = _state->findNode(host);
-    if (node)
-        node->markFailed(status);
-    DEV _state->checkInvariants();
+    bool failedPrimary = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        Node* node = _state->findNode(host);
+        if (node) {
+            failedPrimary = node->isMaster;
+            node->markFailed(status);
+            _state->invalidateMatchingHostsCache();
+        }
+        DEV _state->checkInvariants();
+    }
+
+    // Losing the primary usually means an election is under way. Rather than let callers keep
+    // using a view without a primary until the next scheduled refresh, start one right away; the
+    // rescheduled refreshes then run at the expedited period until a new primary is found.
+    if (failedPrimary && _executor) {
+        std::weak_ptr<ReplicaSetMonitor> that(shared_from_this());
+        auto status = _executor->scheduleWork([=](const CallbackArgs& cbArgs) {
+            if (!cbArgs.status.isOK()) {
+                return;
+            }
+            if (auto ptr = that.lock()) {
+                ptr->startOrContinueRefresh().refreshAll();
+            }
+        });
+        if (!status.isOK()) {
+            LOG(1) << "Couldn't schedule refresh for " << getName() << " after its primary "
+                   << host << " failed" << causedBy(redact(status.getStatus()));
+        }
+    }
 }
 
 bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
@@ -408,6 +449,11 @@ void ReplicaSetMonitor::setSynchronousConfigChangeHook(ConfigChangeHook hook) {
     syncConfigChangeHook = hook;
 }
 
+void ReplicaSetMonitor::setSynchronousPrimaryChangeHook(PrimaryChangeHook hook) {
+    invariant(!syncPrimaryChangeHook);
+    syncPrimaryChangeHook = hook;
+}
+
 // TODO move to correct order with non-statics before pushing
 void ReplicaSetMonitor::appendInfo(BSONObjBuilder& bsonObjBuilder) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
@@ -450,6 +496,7 @@ void ReplicaSetMonitor::cleanup() {
     globalRSMonitorManager.removeAllMonitors();
     asyncConfigChangeHook = ReplicaSetMonitor::ConfigChangeHook();
     syncConfigChangeHook = ReplicaSetMonitor::ConfigChangeHook();
+    syncPrimaryChangeHook = ReplicaSetMonitor::PrimaryChangeHook();
 }
 
 bool ReplicaSetMonitor::isKnownToHaveGoodPrimary() const {
@@ -517,6 +564,7 @@ Refresher::NextStep Refresher::getNextStep() {
                  ++it) {
                 _set->findOrCreateNode(it->host)->update(*it);
             }
+            _set->invalidateMatchingHostsCache();
 
             const string newAddr = _set->getUnconfirmedServerAddress();
             if (oldAddr != newAddr && syncConfigChangeHook) {
@@ -562,6 +610,9 @@ void Refresher::receivedIsMaster(const HostAndPort& from,
 
     const IsMasterReply reply(from, latencyMicros, replyObj);
 
+    // Any reply can change the nodes, or at least their latencies.
+    _set->invalidateMatchingHostsCache();
+
     // Handle various failure cases
     if (!reply.ok) {
         failedHost(from, {ErrorCodes::CommandFailed, "Failed to execute 'ismaster' command"});
@@ -626,8 +677,10 @@ void Refresher::failedHost(const HostAndPort& host, const Status& status) {
         _set->cv.notify_all();
 
     Node* node = _set->findNode(host);
-    if (node)
+    if (node) {
         node->markFailed(status);
+        _set->invalidateMatchingHostsCache();
+    }
 }
 
 ScanStatePtr Refresher::startNewScan(const SetState* set) {
@@ -771,6 +824,11 @@ Status Refresher::receivedIsMasterFromMaster(const HostAndPort& from, const IsMa
     _scan->unconfirmedReplies.clear();
 
     _scan->foundUpMaster = true;
+
+    if (reply.host != _set->lastSeenMaster && syncPrimaryChangeHook) {
+        syncPrimaryChangeHook(_set->name, reply.host);
+    }
+
     _set->lastSeenMaster = reply.host;
 
     return Status::OK();
@@ -1009,6 +1067,8 @@ SetState::SetState(StringData name, const std::set<HostAndPort>& seedNodes)
     DEV checkInvariants();
 }
 
+constexpr size_t SetState::kMaxCachedReadPreferences;
+
 SetState::SetState(const MongoURI& uri)
     : SetState(uri.getSetName(),
                std::set<HostAndPort>(uri.getServers().begin(), uri.getServers().end())) {
@@ -1016,25 +1076,69 @@ SetState::SetState(const MongoURI& uri)
 }
 
 HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) const {
+    return pickHost(getMatchingHosts(criteria));
+}
+
+HostAndPort SetState::getMatchingHostCached(const ReadPreferenceSetting& criteria) {
+    // The eligible hosts also depend on the optimes of the nodes when there is a minOpTime.
+    if (!criteria.minOpTime.isNull()) {
+        return getMatchingHost(criteria);
+    }
+
+    const BSONObj key = criteria.toInnerBSON();
+    const std::string keyData(key.objdata(), key.objsize());
+    auto it = matchingHostsCache.find(keyData);
+    if (it == matchingHostsCache.end()) {
+        if (matchingHostsCache.size() >= kMaxCachedReadPreferences) {
+            matchingHostsCache.clear();
+        }
+        it = matchingHostsCache.emplace(keyData, getMatchingHosts(criteria)).first;
+    }
+    return pickHost(it->second);
+}
+
+void SetState::invalidateMatchingHostsCache() {
+    matchingHostsCache.clear();
+}
+
+HostAndPort SetState::pickHost(const std::vector<HostAndPort>& hosts) const {
+    if (hosts.empty()) {
+        return HostAndPort();
+    }
+    if (hosts.size() == 1) {
+        return hosts.front();
+    }
+
+    // pick one at random (or use round-robin)
+    if (ReplicaSetMonitor::useDeterministicHostSelection) {
+        // only in tests
+        return hosts[roundRobin++ % hosts.size()];
+    } else {
+        // normal case
+        return hosts[rand.nextInt32(hosts.size())];
+    }
+}
+
+std::vector<HostAndPort> SetState::getMatchingHosts(const ReadPreferenceSetting& criteria) const {
     switch (criteria.pref) {
         // "Prefered" read preferences are defined in terms of other preferences
         case ReadPreference::PrimaryPreferred: {
-            HostAndPort out =
-                getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+            auto out =
+                getMatchingHosts(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
             // NOTE: the spec says we should use the primary even if tags don't match
             if (!out.empty())
                 return out;
-            return getMatchingHost(ReadPreferenceSetting(
+            return getMatchingHosts(ReadPreferenceSetting(
                 ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
         }
 
         case ReadPreference::SecondaryPreferred: {
-            HostAndPort out = getMatchingHost(ReadPreferenceSetting(
+            auto out = getMatchingHosts(ReadPreferenceSetting(
                 ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
             if (!out.empty())
                 return out;
             // NOTE: the spec says we should use the primary even if tags don't match
-            return getMatchingHost(
+            return getMatchingHosts(
                 ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
         }
 
@@ -1042,8 +1146,8 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
             // NOTE: isMaster implies isUp
             Nodes::const_iterator it = std::find_if(nodes.begin(), nodes.end(), isMaster);
             if (it == nodes.end())
-                return HostAndPort();
-            return it->host;
+                return {};
+            return {it->host};
         }
 
         // The difference between these is handled by Node::matches
@@ -1107,7 +1211,7 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                     continue;
                 }
                 if (matchingNodes.size() == 1) {
-                    return matchingNodes.front()->host;
+                    return {matchingNodes.front()->host};
                 }
 
                 // Only consider nodes that satisfy the minOpTime
@@ -1126,7 +1230,7 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                     }
 
                     if (matchingNodes.size() == 1) {
-                        return matchingNodes.front()->host;
+                        return {matchingNodes.front()->host};
                     }
                 }
 
@@ -1143,17 +1247,15 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                     }
                 }
 
-                // of the remaining nodes, pick one at random (or use round-robin)
-                if (ReplicaSetMonitor::useDeterministicHostSelection) {
-                    // only in tests
-                    return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
-                } else {
-                    // normal case
-                    return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
-                };
+                std::vector<HostAndPort> hosts;
+                hosts.reserve(matchingNodes.size());
+                for (auto node : matchingNodes) {
+                    hosts.push_back(node->host);
+                }
+                return hosts;
             }
 
-            return HostAndPort();
+            return {};
         }
 
         default:
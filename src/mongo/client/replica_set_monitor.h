@@ -62,6 +62,9 @@ public:
     typedef stdx::function<void(const std::string& setName, const std::string& newConnectionString)>
         ConfigChangeHook;
 
+    typedef stdx::function<void(const std::string& setName, const HostAndPort& newPrimary)>
+        PrimaryChangeHook;
+
     /**
      * Initializes local state.
      *
@@ -217,6 +220,18 @@ public:
      */
     static void setSynchronousConfigChangeHook(ConfigChangeHook hook);
 
+    /**
+     * Sets the hook to be called whenever a replica set monitor sees a primary other than the
+     * last one it knew of, including the first primary seen after the monitor is created.
+     * Currently only 1 globally, so this asserts if one already exists.
+     *
+     * The hook will be called inline while refreshing the ReplicaSetMonitor's view of the set and
+     * must not block, as it will be running under the ReplicaSetMonitor's mutex.
+     *
+     * The hook must not be changed while the program has multiple threads.
+     */
+    static void setSynchronousPrimaryChangeHook(PrimaryChangeHook hook);
+
     /**
      * Permanently stops all monitoring on replica sets and clears all cached information
      * as well. As a consequence, NEVER call this if you have other threads that have a
@@ -272,7 +287,7 @@ private:
     executor::TaskExecutor::CallbackHandle _refresherHandle;
 
     const SetStatePtr _state;
-    executor::TaskExecutor* _executor;
+    executor::TaskExecutor* _executor = nullptr;
     AtomicBool _isRemovedFromManager{false};
 };
 
@@ -46,6 +46,7 @@
 #include "mongo/platform/random.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -153,6 +154,26 @@ public:
      */
     HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
 
+    /**
+     * Returns all hosts among which getMatchingHost() picks one for 'criteria', or an empty vector
+     * if no known host matches.
+     */
+    std::vector<HostAndPort> getMatchingHosts(const ReadPreferenceSetting& criteria) const;
+
+    /**
+     * Like getMatchingHost(), but saves the hosts matching each read preference, so that only the
+     * random pick among them is left to do the next time. The saved hosts must be discarded with
+     * invalidateMatchingHostsCache() whenever the nodes change.
+     */
+    HostAndPort getMatchingHostCached(const ReadPreferenceSetting& criteria);
+
+    void invalidateMatchingHostsCache();
+
+    /**
+     * Returns one of 'hosts' at random (or round-robin), or an empty host if 'hosts' is empty.
+     */
+    HostAndPort pickHost(const std::vector<HostAndPort>& hosts) const;
+
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
      */
@@ -206,6 +227,11 @@ public:
     mutable PseudoRandom rand;  // only used for host selection to balance load
     mutable int roundRobin;     // used when useDeterministicHostSelection is true
     MongoURI setUri;            // URI that may have constructed this
+
+    // Hosts matching each read preference without a minOpTime, keyed by the read preference's
+    // BSON. Cleared whenever the nodes change, and once it holds too many read preferences.
+    static constexpr size_t kMaxCachedReadPreferences = 64;
+    stdx::unordered_map<std::string, std::vector<HostAndPort>> matchingHostsCache;
 };
 
 struct ReplicaSetMonitor::ScanState {
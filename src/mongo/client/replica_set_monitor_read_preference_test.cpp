@@ -1061,6 +1061,35 @@ TEST(MultiTags, NearestMultiTagsNoMatch) {
     ASSERT(host.empty());
 }
 
+TEST(MatchingHostsCache, CachedHostsMatchUntilInvalidated) {
+    vector<Node> nodes = getThreeMemberWithTags();
+
+    set<HostAndPort> seeds;
+    seeds.insert(nodes.front().host);
+    SetState set("name", seeds);
+    set.nodes = nodes;
+    set.latencyThresholdMicros = 3 * 1000;
+
+    const ReadPreferenceSetting criteria(ReadPreference::SecondaryOnly, TagSet(getP2TagSet()));
+    ASSERT_EQUALS("c", set.getMatchingHostCached(criteria).host());
+    ASSERT_EQUALS(1U, set.matchingHostsCache.size());
+
+    // The cached hosts are used until the nodes are known to have changed.
+    set.findNode(HostAndPort("c"))->isUp = false;
+    ASSERT(set.getMatchingHost(criteria).empty());
+    ASSERT_EQUALS("c", set.getMatchingHostCached(criteria).host());
+
+    set.invalidateMatchingHostsCache();
+    ASSERT(set.getMatchingHostCached(criteria).empty());
+
+    // Falls back to the primary, which the cache must also remember for secondaryPreferred.
+    const ReadPreferenceSetting preferred(ReadPreference::SecondaryPreferred,
+                                          TagSet(getP2TagSet()));
+    ASSERT_EQUALS("b", set.getMatchingHostCached(preferred).host());
+    ASSERT_EQUALS("b", set.getMatchingHostCached(preferred).host());
+    ASSERT_EQUALS(2U, set.matchingHostsCache.size());
+}
+
 TEST(TagSet, DefaultConstructorMatchesAll) {
     TagSet tags;
     ASSERT_BSONOBJ_EQ(tags.getTagBSON(), BSON_ARRAY(BSONObj()));
@@ -32,6 +32,7 @@
 
 #include "mongo/db/auth/authorization_manager.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -56,6 +57,7 @@
 #include "mongo/db/auth/user_name_hash.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/mongod_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/platform/unordered_map.h"
 #include "mongo/stdx/memory.h"
@@ -75,6 +77,9 @@ using std::vector;
 
 AuthInfo internalSecurity;
 
+// How many users that are no longer referenced by any session to keep in the user cache.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(authorizationManagerCacheSize, int, 100);
+
 MONGO_INITIALIZER_WITH_PREREQUISITES(SetupInternalSecurityUser, ("EndStartupOptionStorage"))
 (InitializerContext* const context) try {
     User* user = new User(UserName("__system", "local"));
@@ -275,6 +280,7 @@ AuthorizationManager::AuthorizationManager(std::unique_ptr<AuthzManagerExternalS
       _privilegeDocsExist(false),
       _externalState(std::move(externalState)),
       _version(schemaVersionInvalid),
+      _unusedUsers(static_cast<size_t>(std::max(0, authorizationManagerCacheSize))),
       _isFetchPhaseBusy(false) {
     _updateCacheGeneration_inlock();
 }
@@ -495,7 +501,10 @@ Status AuthorizationManager::acquireUser(OperationContext* opCtx,
     if (it != _userCache.end()) {
         fassert(16914, it->second);
         fassert(17003, it->second->isValid());
-        fassert(17008, it->second->getRefCount() > 0);
+        if (it->second->getRefCount() == 0) {
+            // The user was kept in the cache after its last release.
+            _unusedUsers.erase(userName);
+        }
         it->second->incrementRefCount();
         *acquiredUser = it->second;
         return Status::OK();
@@ -597,10 +606,28 @@ void AuthorizationManager::releaseUser(User* user) {
     user->decrementRefCount();
     if (user->getRefCount() == 0) {
         // If it's been invalidated then it's not in the _userCache anymore.
-        if (user->isValid()) {
-            MONGO_COMPILER_VARIABLE_UNUSED bool erased = _userCache.erase(user->getName());
+        if (!user->isValid()) {
+            delete user;
+            return;
+        }
+
+        // Keep the user cached for its next acquisition, making room by dropping the least
+        // recently released user if needed.
+        if (auto evicted = _unusedUsers.add(user->getName(), user)) {
+            User* evictedUser = *evicted;
+            MONGO_COMPILER_VARIABLE_UNUSED bool erased = _userCache.erase(evictedUser->getName());
             dassert(erased);
+            delete evictedUser;
         }
+    }
+}
+
+void AuthorizationManager::_invalidateCachedUser_inlock(User* user) {
+    user->invalidate();
+
+    // Nobody will release a user that no session references, so it is deleted here.
+    if (user->getRefCount() == 0) {
+        _unusedUsers.erase(user->getName());
         delete user;
     }
 }
@@ -615,7 +642,7 @@ void AuthorizationManager::invalidateUserByName(const UserName& userName) {
 
     User* user = it->second;
     _userCache.erase(it);
-    user->invalidate();
+    _invalidateCachedUser_inlock(user);
 }
 
 void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
@@ -626,7 +653,7 @@ void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
         User* user = it->second;
         if (user->getName().getDB() == dbname) {
             _userCache.erase(it++);
-            user->invalidate();
+            _invalidateCachedUser_inlock(user);
         } else {
             ++it;
         }
@@ -643,9 +670,10 @@ void AuthorizationManager::_invalidateUserCache_inlock() {
     for (unordered_map<UserName, User*>::iterator it = _userCache.begin(); it != _userCache.end();
          ++it) {
         fassert(17266, it->second != internalSecurity.user);
-        it->second->invalidate();
+        _invalidateCachedUser_inlock(it->second);
     }
     _userCache.clear();
+    invariant(_unusedUsers.empty());
 
     // Reread the schema version before acquiring the next user.
     _version = schemaVersionInvalid;
@@ -50,6 +50,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 
 namespace mongo {
 
@@ -347,6 +348,12 @@ private:
      */
     void _invalidateUserCache_inlock();
 
+    /**
+     * Marks a user that was just removed from _userCache as invalid, and deletes it if no session
+     * references it. Should only be called when already holding _cacheMutex.
+     */
+    void _invalidateCachedUser_inlock(User* user);
+
     /**
      * Given the objects describing an oplog entry that affects authorization data, invalidates
      * the portion of the user cache that is affected by that operation.  Should only be called
@@ -414,6 +421,13 @@ private:
      */
     unordered_map<UserName, User*> _userCache;
 
+    /**
+     * The users in _userCache whose reference count dropped to zero, most recently released
+     * first. They are kept, up to authorizationManagerCacheSize of them, so that reauthenticating
+     * a user does not have to read its privilege document again. Protected by CacheGuard.
+     */
+    LRUCache<UserName, User*> _unusedUsers;
+
     /**
      * Current generation of cached data.  Updated every time part of the cache gets
      * invalidated.  Protected by CacheGuard.
@@ -429,8 +443,8 @@ private:
     bool _isFetchPhaseBusy;
 
     /**
-     * Protects _userCache, _cacheGeneration, _version and _isFetchPhaseBusy.  Manipulated
-     * via CacheGuard.
+     * Protects _userCache, _unusedUsers, _cacheGeneration, _version and _isFetchPhaseBusy.
+     * Manipulated via CacheGuard.
      */
     stdx::mutex _cacheMutex;
 
@@ -246,6 +246,49 @@ TEST_F(AuthorizationManagerTest, testAcquireV2User) {
     authzManager->releaseUser(v2cluster);
 }
 
+TEST_F(AuthorizationManagerTest, ReleasedUserStaysCachedUntilInvalidated) {
+    OperationContextNoop opCtx;
+
+    ASSERT_OK(externalState->insertPrivilegeDocument(&opCtx,
+                                                     BSON("_id"
+                                                          << "test.v2read"
+                                                          << "user"
+                                                          << "v2read"
+                                                          << "db"
+                                                          << "test"
+                                                          << "credentials"
+                                                          << BSON("MONGODB-CR"
+                                                                  << "password")
+                                                          << "roles"
+                                                          << BSON_ARRAY(BSON("role"
+                                                                             << "read"
+                                                                             << "db"
+                                                                             << "test"))),
+                                                     BSONObj()));
+
+    User* user;
+    ASSERT_OK(authzManager->acquireUser(&opCtx, UserName("v2read", "test"), &user));
+    authzManager->releaseUser(user);
+
+    // Once the user document is gone, only the cached copy can satisfy the next acquisition.
+    int numRemoved;
+    ASSERT_OK(externalState->remove(&opCtx,
+                                    AuthorizationManager::usersCollectionNamespace,
+                                    BSONObj(),
+                                    BSONObj(),
+                                    &numRemoved));
+    ASSERT_EQUALS(1, numRemoved);
+
+    ASSERT_OK(authzManager->acquireUser(&opCtx, UserName("v2read", "test"), &user));
+    ASSERT(user->isValid());
+    ASSERT_EQUALS(1U, user->getRefCount());
+    authzManager->releaseUser(user);
+
+    authzManager->invalidateUserByName(UserName("v2read", "test"));
+    ASSERT_EQUALS(ErrorCodes::UserNotFound,
+                  authzManager->acquireUser(&opCtx, UserName("v2read", "test"), &user));
+}
+
 TEST_F(AuthorizationManagerTest, testLocalX509Authorization) {
     ServiceContextNoop serviceContext;
     transport::TransportLayerMock transportLayer{};
@@ -39,8 +39,10 @@
 #include "mongo/crypto/sha1_block.h"
 #include "mongo/db/auth/sasl_options.h"
 #include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/log.h"
+#include "mongo/util/lru_cache.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/password_digest.h"
 #include "mongo/util/sequence_util.h"
@@ -51,6 +53,38 @@ namespace mongo {
 using std::unique_ptr;
 using std::string;
 
+namespace {
+
+// SCRAM credentials generated on the fly for users that only have MONGODB-CR credentials. Deriving
+// them costs a full PBKDF2 run, so they are remembered per (user, password digest) pair and handed
+// out again on later authentications of the same user. The key includes the MONGODB-CR digest so
+// that a password change naturally misses the cache.
+const size_t kMixedModeCredentialCacheSize = 100;
+
+stdx::mutex mixedModeCredentialCacheMutex;
+LRUCache<std::string, BSONObj> mixedModeCredentialCache(kMixedModeCredentialCacheSize);
+
+BSONObj getMixedModeScramCredentials(const UserName& userName,
+                                     const std::string& password,
+                                     int iterationCount) {
+    const std::string key = userName.getFullName() + '\0' + password;
+    {
+        stdx::lock_guard<stdx::mutex> lk(mixedModeCredentialCacheMutex);
+        auto it = mixedModeCredentialCache.promote(key);
+        if (it != mixedModeCredentialCache.end()) {
+            return it->second;
+        }
+    }
+
+    BSONObj scramCreds = scram::generateCredentials(password, iterationCount);
+
+    stdx::lock_guard<stdx::mutex> lk(mixedModeCredentialCacheMutex);
+    mixedModeCredentialCache.add(key, scramCreds);
+    return scramCreds;
+}
+
+}  // namespace
+
 SaslSCRAMSHA1ServerConversation::SaslSCRAMSHA1ServerConversation(
     SaslAuthenticationSession* saslAuthSession)
     : SaslServerConversation(saslAuthSession), _step(0), _authMessage(""), _nonce("") {}
@@ -194,8 +228,8 @@ StatusWith<bool> SaslSCRAMSHA1ServerConversation::_firstStep(std::vector<string>
         // Use a default value of 5000 for the scramIterationCount when in mixed mode,
         // overriding the default value (10000) used for SCRAM mode or the user-given value.
         const int mixedModeScramIterationCount = 5000;
-        BSONObj scramCreds =
-            scram::generateCredentials(_creds.password, mixedModeScramIterationCount);
+        BSONObj scramCreds = getMixedModeScramCredentials(
+            userName, _creds.password, mixedModeScramIterationCount);
         _creds.scram.iterationCount = scramCreds[scram::iterationCountFieldName].Int();
         _creds.scram.salt = scramCreds[scram::saltFieldName].String();
         _creds.scram.storedKey = scramCreds[scram::storedKeyFieldName].String();
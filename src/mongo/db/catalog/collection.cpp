@@ -137,6 +137,9 @@ std::string CompactOptions::toString() const {
 
     ss << " validateDocuments: " << validateDocuments;
 
+    if (timeLimit > Seconds(0))
+        ss << " timeLimit: " << timeLimit;
+
     return ss.str();
 }
 
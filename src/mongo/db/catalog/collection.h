@@ -55,6 +55,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 class CollectionCatalogEntry;
@@ -84,6 +85,11 @@ struct CompactOptions {
     // other
     bool validateDocuments = true;
 
+    // If non-zero, a storage engine which compacts in place may stop compacting a record store or
+    // index after roughly this long and return ExceededTimeLimit. The space reclaimed so far is
+    // kept, and compacting it again continues from there.
+    Seconds timeLimit{0};
+
     std::string toString() const;
 
     unsigned computeRecordSize(unsigned recordSize) const {
@@ -333,6 +339,8 @@ public:
 
         virtual const CollatorInterface* getDefaultCollator() const = 0;
 
+        virtual const boost::optional<TimeseriesOptions>& getTimeseriesOptions() const = 0;
+
         virtual void informIndexObserver(OperationContext* opCtx,
                                          const IndexDescriptor* descriptor,
                                          const IndexKeyEntry& indexEntry,
@@ -732,6 +740,13 @@ public:
         return this->_impl().getDefaultCollator();
     }
 
+    /**
+     * Returns the options of this collection if it is a time-series collection.
+     */
+    inline const boost::optional<TimeseriesOptions>& getTimeseriesOptions() const {
+        return this->_impl().getTimeseriesOptions();
+    }
+
     /**
      * Calls the Inforn function in the IndexObserver if it's hooked.
      */
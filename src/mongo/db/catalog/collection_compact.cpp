@@ -130,7 +130,7 @@ StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
             IndexAccessMethod* index = _indexCatalog.getIndex(descriptor);
 
             LOG(1) << "compacting index: " << descriptor->toString();
-            Status status = index->compact(opCtx);
+            Status status = index->compact(opCtx, compactOptions);
             if (!status.isOK()) {
                 error() << "failed to compact index: " << descriptor->toString();
                 return status;
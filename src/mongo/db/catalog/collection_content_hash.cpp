@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection_content_hash.h"
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/xxhash.h"
+
+namespace mongo {
+
+class CollectionContentHash::PendingChange final : public RecoveryUnit::Change {
+public:
+    PendingChange(std::shared_ptr<CollectionContentHash> hash,
+                  int64_t countDelta,
+                  uint64_t hashDelta)
+        : _hash(std::move(hash)), _countDelta(countDelta), _hashDelta(hashDelta) {}
+
+    void commit() final {
+        _hash->_sum.fetchAndAdd(_hashDelta);
+        _hash->_count.fetchAndAdd(_countDelta);
+    }
+
+    void rollback() final {}
+
+private:
+    const std::shared_ptr<CollectionContentHash> _hash;
+    const int64_t _countDelta;
+    const uint64_t _hashDelta;
+};
+
+uint64_t CollectionContentHash::hashDocument(const BSONObj& doc) {
+    return xxhash64(doc.objdata(), doc.objsize());
+}
+
+void CollectionContentHash::addInitialDocument(const BSONObj& doc) {
+    _sum.fetchAndAdd(hashDocument(doc));
+    _count.fetchAndAdd(1);
+}
+
+void CollectionContentHash::noteInsert(OperationContext* opCtx, const BSONObj& doc) {
+    _note(opCtx, 1, hashDocument(doc));
+}
+
+void CollectionContentHash::noteDelete(OperationContext* opCtx, const BSONObj& doc) {
+    // Unsigned arithmetic wraps, so adding the negation subtracts the document's hash.
+    _note(opCtx, -1, 0 - hashDocument(doc));
+}
+
+void CollectionContentHash::noteUpdate(OperationContext* opCtx,
+                                       uint64_t oldDocHash,
+                                       const BSONObj& newDoc) {
+    _note(opCtx, 0, hashDocument(newDoc) - oldDocHash);
+}
+
+void CollectionContentHash::_note(OperationContext* opCtx, int64_t countDelta, uint64_t hashDelta) {
+    opCtx->recoveryUnit()->registerChange(
+        new PendingChange(shared_from_this(), countDelta, hashDelta));
+}
+
+std::string CollectionContentHash::toString() const {
+    // Mix the count in, so that the hash of the sum is not simply the sum itself.
+    char buf[2 * sizeof(uint64_t)];
+    DataView(buf).write<LittleEndian<uint64_t>>(_sum.load());
+    DataView(buf).write<LittleEndian<int64_t>>(_count.load(), sizeof(uint64_t));
+
+    char digest[sizeof(uint64_t)];
+    DataView(digest).write<BigEndian<uint64_t>>(xxhash64(buf, sizeof(buf)));
+    return toHexLower(digest, sizeof(digest));
+}
+
+}  // namespace mongo
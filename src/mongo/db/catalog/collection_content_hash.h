@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * An order-independent hash of the documents of a collection, maintained as the collection is
+ * written to, so that dbHash can report it without scanning the collection.
+ *
+ * The hash is the sum, modulo 2^64, of the XXH64 hashes of the BSON of every document, together
+ * with the number of documents. Since addition commutes, each write contributes a delta which is
+ * applied when its unit of work commits, in whatever order units of work commit in.
+ *
+ * Like the column projection cache, it is not persisted; dbHash seeds it with a full scan of the
+ * collection the first time it is asked for an incremental hash. The oplog is never tracked since
+ * its inserts bypass the collection's write paths.
+ *
+ * A hash must be owned by a std::shared_ptr, since pending changes keep it alive until their unit
+ * of work ends. All methods are thread-safe.
+ */
+class CollectionContentHash : public std::enable_shared_from_this<CollectionContentHash> {
+    MONGO_DISALLOW_COPYING(CollectionContentHash);
+
+public:
+    CollectionContentHash() = default;
+
+    static uint64_t hashDocument(const BSONObj& doc);
+
+    /**
+     * Adds a document of the collection while seeding the hash, before it is published to the
+     * collection's writers.
+     */
+    void addInitialDocument(const BSONObj& doc);
+
+    /**
+     * Record a write to the collection. The change is applied when the unit of work of 'opCtx'
+     * commits, and discarded if it rolls back.
+     */
+    void noteInsert(OperationContext* opCtx, const BSONObj& doc);
+    void noteDelete(OperationContext* opCtx, const BSONObj& doc);
+    void noteUpdate(OperationContext* opCtx, uint64_t oldDocHash, const BSONObj& newDoc);
+
+    /**
+     * Returns the hash of the committed contents of the collection as 16 hexadecimal digits.
+     */
+    std::string toString() const;
+
+    long long numDocuments() const {
+        return _count.load();
+    }
+
+private:
+    class PendingChange;
+
+    void _note(OperationContext* opCtx, int64_t countDelta, uint64_t hashDelta);
+
+    AtomicUInt64 _sum;
+    AtomicInt64 _count;
+};
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection_content_hash.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::string hashOf(const std::vector<BSONObj>& docs) {
+    auto hash = std::make_shared<CollectionContentHash>();
+    for (auto&& doc : docs) {
+        hash->addInitialDocument(doc);
+    }
+    return hash->toString();
+}
+
+TEST(CollectionContentHashTest, IndependentOfDocumentOrder) {
+    const BSONObj a = fromjson("{_id: 1, x: 1}");
+    const BSONObj b = fromjson("{_id: 2, x: 'two'}");
+    const BSONObj c = fromjson("{_id: 3, x: [3]}");
+
+    ASSERT_EQ(hashOf({a, b, c}), hashOf({c, a, b}));
+    ASSERT_NE(hashOf({a, b, c}), hashOf({a, b}));
+    ASSERT_NE(hashOf({a, b}), hashOf({a, c}));
+
+    // Duplicates count, so that a document appearing twice is not mistaken for one.
+    ASSERT_NE(hashOf({a}), hashOf({a, a}));
+    ASSERT_EQ(16U, hashOf({}).size());
+}
+
+TEST(CollectionContentHashTest, WritesAreAppliedOnCommit) {
+    const BSONObj a = fromjson("{_id: 1, x: 1}");
+    const BSONObj b = fromjson("{_id: 2, x: 2}");
+    const BSONObj bUpdated = fromjson("{_id: 2, x: 3}");
+    const BSONObj c = fromjson("{_id: 3}");
+
+    auto hash = std::make_shared<CollectionContentHash>();
+    hash->addInitialDocument(a);
+    hash->addInitialDocument(b);
+
+    OperationContextNoop opCtx;
+    {
+        WriteUnitOfWork wuow(&opCtx);
+        hash->noteInsert(&opCtx, c);
+        hash->noteDelete(&opCtx, a);
+        hash->noteUpdate(&opCtx, CollectionContentHash::hashDocument(b), bUpdated);
+
+        // Nothing is visible before the unit of work commits.
+        ASSERT_EQ(hashOf({a, b}), hash->toString());
+        wuow.commit();
+    }
+    ASSERT_EQ(hashOf({bUpdated, c}), hash->toString());
+    ASSERT_EQ(2, hash->numDocuments());
+}
+
+TEST(CollectionContentHashTest, WritesAreDiscardedOnRollback) {
+    const BSONObj a = fromjson("{_id: 1, x: 1}");
+
+    auto hash = std::make_shared<CollectionContentHash>();
+    hash->addInitialDocument(a);
+    const std::string before = hash->toString();
+
+    OperationContextNoop opCtx;
+    {
+        WriteUnitOfWork wuow(&opCtx);
+        hash->noteInsert(&opCtx, fromjson("{_id: 2}"));
+        hash->noteDelete(&opCtx, a);
+    }
+    ASSERT_EQ(before, hash->toString());
+    ASSERT_EQ(1, hash->numDocuments());
+}
+
+}  // namespace
+}  // namespace mongo
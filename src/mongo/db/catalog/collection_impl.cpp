@@ -54,6 +54,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/op_observer.h"
@@ -158,6 +159,7 @@ CollectionImpl::CollectionImpl(Collection* _this_init,
       _infoCache(_this_init, _ns),
       _indexCatalog(_this_init, this->getCatalogEntry()->getMaxAllowedIndexes()),
       _collator(parseCollation(opCtx, _ns, _details->getCollectionOptions(opCtx).collation)),
+      _timeseriesOptions(_details->getCollectionOptions(opCtx).timeseries),
       _validatorDoc(_details->getCollectionOptions(opCtx).validator.getOwned()),
       _validator(
           uassertStatusOK(parseValidator(_validatorDoc,
@@ -361,6 +363,18 @@ Status CollectionImpl::insertDocuments(OperationContext* opCtx,
     getGlobalServiceContext()->getOpObserver()->onInserts(
         opCtx, ns(), uuid(), begin, end, fromMigrate);
 
+    if (auto columnCache = _infoCache.getColumnProjectionCache()) {
+        for (auto it = begin; it != end; it++) {
+            columnCache->noteInsert(opCtx, it->doc);
+        }
+    }
+
+    if (auto contentHash = _infoCache.getContentHash()) {
+        for (auto it = begin; it != end; it++) {
+            contentHash->noteInsert(opCtx, it->doc);
+        }
+    }
+
     opCtx->recoveryUnit()->onCommit([this]() { notifyCappedWaitersIfNeeded(); });
 
     return Status::OK();
@@ -430,6 +444,14 @@ Status CollectionImpl::insertDocument(OperationContext* opCtx,
     getGlobalServiceContext()->getOpObserver()->onInserts(
         opCtx, ns(), uuid(), inserts.begin(), inserts.end(), false);
 
+    if (auto columnCache = _infoCache.getColumnProjectionCache()) {
+        columnCache->noteInsert(opCtx, doc);
+    }
+
+    if (auto contentHash = _infoCache.getContentHash()) {
+        contentHash->noteInsert(opCtx, doc);
+    }
+
     opCtx->recoveryUnit()->onCommit([this]() { notifyCappedWaitersIfNeeded(); });
 
     return loc.getStatus();
@@ -515,6 +537,10 @@ Status CollectionImpl::aboutToDeleteCapped(OperationContext* opCtx,
     int64_t* const nullKeysDeleted = nullptr;
     _indexCatalog.unindexRecord(opCtx, doc, loc, false, nullKeysDeleted);
 
+    if (auto contentHash = _infoCache.getContentHash()) {
+        contentHash->noteDelete(opCtx, doc);
+    }
+
     // We are not capturing and reporting to OpDebug the 'keysDeleted' by unindexRecord(). It is
     // questionable whether reporting will add diagnostic value to users and may instead be
     // confusing as it depends on our internal capped collection document removal strategy.
@@ -560,6 +586,14 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
 
     getGlobalServiceContext()->getOpObserver()->onDelete(
         opCtx, ns(), uuid(), stmtId, std::move(deleteState), fromMigrate, deletedDoc);
+
+    if (auto columnCache = _infoCache.getColumnProjectionCache()) {
+        columnCache->noteDelete(opCtx, doc.value()["_id"]);
+    }
+
+    if (auto contentHash = _infoCache.getContentHash()) {
+        contentHash->noteDelete(opCtx, doc.value());
+    }
 }
 
 Counter64 moveCounter;
@@ -632,6 +666,9 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
             IndexDescriptor* descriptor = ii.next();
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
+            if (entry->indexBuildInterceptor()) {
+                continue;
+            }
 
             InsertDeleteOptions options;
             IndexCatalog::prepareInsertDeleteOptions(opCtx, descriptor, &options);
@@ -663,8 +700,21 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            // An index being built by a hybrid build sees the update as a delete and an insert.
+            if (auto interceptor = entry->indexBuildInterceptor()) {
+                interceptor->sideWrite(
+                    opCtx, *args->preImageDoc, oldLocation, IndexBuildInterceptor::Op::kDelete);
+                const MatchExpression* filter = entry->getFilterExpression();
+                if (!filter || filter->matchesBSON(newDoc)) {
+                    interceptor->sideWrite(
+                        opCtx, newDoc, oldLocation, IndexBuildInterceptor::Op::kInsert);
+                }
+                continue;
+            }
+
             int64_t keysInserted;
             int64_t keysDeleted;
             uassertStatusOK(iam->update(
@@ -681,6 +731,15 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
 
     getGlobalServiceContext()->getOpObserver()->onUpdate(opCtx, *args);
 
+    if (auto columnCache = _infoCache.getColumnProjectionCache()) {
+        columnCache->noteUpdate(opCtx, newDoc);
+    }
+
+    if (auto contentHash = _infoCache.getContentHash()) {
+        contentHash->noteUpdate(
+            opCtx, CollectionContentHash::hashDocument(*args->preImageDoc), newDoc);
+    }
+
     return {oldLocation};
 }
 
@@ -729,6 +788,15 @@ StatusWith<RecordId> CollectionImpl::_updateDocumentWithMove(OperationContext* o
 
     getGlobalServiceContext()->getOpObserver()->onUpdate(opCtx, *args);
 
+    if (auto columnCache = _infoCache.getColumnProjectionCache()) {
+        columnCache->noteUpdate(opCtx, newDoc);
+    }
+
+    if (auto contentHash = _infoCache.getContentHash()) {
+        contentHash->noteUpdate(
+            opCtx, CollectionContentHash::hashDocument(*args->preImageDoc), newDoc);
+    }
+
     moveCounter.increment();
     if (opDebug) {
         opDebug->nmoved++;
@@ -768,6 +836,11 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     // Broadcast the mutation so that query results stay correct.
     _cursorManager.invalidateDocument(opCtx, loc, INVALIDATION_MUTATION);
 
+    // The old document must be hashed first, since the update may overwrite it in place.
+    auto contentHash = _infoCache.getContentHash();
+    const uint64_t oldDocHash =
+        contentHash ? CollectionContentHash::hashDocument(oldRec.value().toBson()) : 0;
+
     auto newRecStatus =
         _recordStore->updateWithDamages(opCtx, loc, oldRec.value(), damageSource, damages);
 
@@ -775,6 +848,14 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
         args->updatedDoc = newRecStatus.getValue().toBson();
 
         getGlobalServiceContext()->getOpObserver()->onUpdate(opCtx, *args);
+
+        if (auto columnCache = _infoCache.getColumnProjectionCache()) {
+            columnCache->noteUpdate(opCtx, args->updatedDoc);
+        }
+
+        if (contentHash) {
+            contentHash->noteUpdate(opCtx, oldDocHash, args->updatedDoc);
+        }
     }
     return newRecStatus;
 }
@@ -865,6 +946,13 @@ Status CollectionImpl::truncate(OperationContext* opCtx) {
     if (!status.isOK())
         return status;
 
+    if (auto columnCache = _infoCache.getColumnProjectionCache()) {
+        columnCache->noteTruncate(opCtx);
+    }
+
+    // Simpler than making the reset transactional; the next incremental dbHash reseeds it.
+    _infoCache.setContentHash(nullptr);
+
     // 4) re-create indexes
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         status = _indexCatalog.createIndexOnEmptyCollection(opCtx, indexSpecs[i]).getStatus();
@@ -883,6 +971,9 @@ void CollectionImpl::cappedTruncateAfter(OperationContext* opCtx, RecordId end,
 
     _cursorManager.invalidateAll(opCtx, false, "capped collection truncated");
     _recordStore->cappedTruncateAfter(opCtx, end, inclusive);
+
+    // Not every storage engine reports the removed documents through aboutToDeleteCapped().
+    _infoCache.setContentHash(nullptr);
 }
 
 Status CollectionImpl::setValidator(OperationContext* opCtx, BSONObj validatorDoc) {
@@ -993,6 +1084,10 @@ const CollatorInterface* CollectionImpl::getDefaultCollator() const {
     return _collator.get();
 }
 
+const boost::optional<TimeseriesOptions>& CollectionImpl::getTimeseriesOptions() const {
+    return _timeseriesOptions;
+}
+
 void CollectionImpl::informIndexObserver(OperationContext* opCtx,
                                          const IndexDescriptor* descriptor,
                                          const IndexKeyEntry& indexEntry,
@@ -359,6 +359,8 @@ public:
      */
     const CollatorInterface* getDefaultCollator() const final;
 
+    const boost::optional<TimeseriesOptions>& getTimeseriesOptions() const final;
+
     /**
      * Calls the Inform function in the IndexObserver if it's hooked.
      */
@@ -444,6 +446,9 @@ private:
     // If null, the default collation is simple binary compare.
     std::unique_ptr<CollatorInterface> _collator;
 
+    // Time-series collections can only be created, so these do not change.
+    const boost::optional<TimeseriesOptions> _timeseriesOptions;
+
     // Empty means no filter.
     BSONObj _validatorDoc;
 
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include "mongo/db/catalog/collection_content_hash.h"
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/column_projection_cache.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -53,6 +55,14 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual std::shared_ptr<ColumnProjectionCache> getColumnProjectionCache() const = 0;
+
+        virtual void setColumnProjectionCache(std::shared_ptr<ColumnProjectionCache> cache) = 0;
+
+        virtual std::shared_ptr<CollectionContentHash> getContentHash() const = 0;
+
+        virtual void setContentHash(std::shared_ptr<CollectionContentHash> hash) = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
@@ -103,6 +113,40 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Get the column projection cache for this collection, or nullptr if there isn't one.
+     */
+    inline std::shared_ptr<ColumnProjectionCache> getColumnProjectionCache() const {
+        return this->_impl().getColumnProjectionCache();
+    }
+
+    /**
+     * Replaces the column projection cache for this collection with 'cache', which may be
+     * nullptr. The previous cache, if any, is invalidated.
+     *
+     * Must be called under exclusive collection lock.
+     */
+    inline void setColumnProjectionCache(std::shared_ptr<ColumnProjectionCache> cache) {
+        return this->_impl().setColumnProjectionCache(std::move(cache));
+    }
+
+    /**
+     * Get the incrementally maintained content hash of this collection, or nullptr if it is not
+     * being maintained.
+     */
+    inline std::shared_ptr<CollectionContentHash> getContentHash() const {
+        return this->_impl().getContentHash();
+    }
+
+    /**
+     * Replaces the content hash of this collection with 'hash', which may be nullptr.
+     *
+     * Must be called under a collection lock which excludes writers.
+     */
+    inline void setContentHash(std::shared_ptr<CollectionContentHash> hash) {
+        return this->_impl().setContentHash(std::move(hash));
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -36,6 +36,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/deferred_index_collection_cache.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
@@ -73,6 +74,13 @@ CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         ttlCollectionCache.unregisterCollection(_ns);
     }
+    if (_hasDeferredIndex) {
+        DeferredIndexCollectionCache::get(getGlobalServiceContext()).unregisterCollection(_ns);
+    }
+
+    if (_columnProjectionCache) {
+        _columnProjectionCache->invalidate("collection closed");
+    }
 }
 
 const UpdateIndexData& CollectionInfoCacheImpl::getIndexKeys(OperationContext* opCtx) const {
@@ -87,10 +95,15 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
 
     bool hadTTLIndex = _hasTTLIndex;
     _hasTTLIndex = false;
+    bool hadDeferredIndex = _hasDeferredIndex;
+    _hasDeferredIndex = false;
 
     IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(opCtx, true);
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
+        if (descriptor->isDeferred()) {
+            _hasDeferredIndex = true;
+        }
 
         if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
             BSONObj key = descriptor->keyPattern();
@@ -148,6 +161,16 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
         }
     }
 
+    if (_hasDeferredIndex != hadDeferredIndex) {
+        auto& deferredIndexCollectionCache =
+            DeferredIndexCollectionCache::get(getGlobalServiceContext());
+        if (_hasDeferredIndex) {
+            deferredIndexCollectionCache.registerCollection(_collection->ns());
+        } else {
+            deferredIndexCollectionCache.unregisterCollection(_collection->ns());
+        }
+    }
+
     _keysComputed = true;
 }
 
@@ -178,6 +201,28 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+std::shared_ptr<ColumnProjectionCache> CollectionInfoCacheImpl::getColumnProjectionCache() const {
+    return _columnProjectionCache;
+}
+
+void CollectionInfoCacheImpl::setColumnProjectionCache(
+    std::shared_ptr<ColumnProjectionCache> cache) {
+    if (_columnProjectionCache) {
+        _columnProjectionCache->invalidate("cache replaced");
+    }
+    _columnProjectionCache = std::move(cache);
+}
+
+std::shared_ptr<CollectionContentHash> CollectionInfoCacheImpl::getContentHash() const {
+    stdx::lock_guard<stdx::mutex> lk(_contentHashMutex);
+    return _contentHash;
+}
+
+void CollectionInfoCacheImpl::setContentHash(std::shared_ptr<CollectionContentHash> hash) {
+    stdx::lock_guard<stdx::mutex> lk(_contentHashMutex);
+    _contentHash = std::move(hash);
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<IndexEntry> indexEntries;
 
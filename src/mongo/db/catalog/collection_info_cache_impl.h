@@ -31,9 +31,11 @@
 #include "mongo/db/catalog/collection_info_cache.h"
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/column_projection_cache.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -61,6 +63,28 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the column projection cache for this collection, or nullptr if there isn't one.
+     */
+    std::shared_ptr<ColumnProjectionCache> getColumnProjectionCache() const;
+
+    /**
+     * Replaces the column projection cache for this collection. Must be called under exclusive
+     * collection lock.
+     */
+    void setColumnProjectionCache(std::shared_ptr<ColumnProjectionCache> cache);
+
+    /**
+     * Get the content hash for this collection, or nullptr if it is not being maintained.
+     */
+    std::shared_ptr<CollectionContentHash> getContentHash() const;
+
+    /**
+     * Replaces the content hash for this collection. Must be called under a collection lock which
+     * excludes writers.
+     */
+    void setContentHash(std::shared_ptr<CollectionContentHash> hash);
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -131,10 +155,21 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Cached values of selected fields, set with the columnCacheSet command. Shared with the
+    // scans reading from it and the units of work writing to it.
+    std::shared_ptr<ColumnProjectionCache> _columnProjectionCache;
+
+    // Incrementally maintained hash of the documents, seeded by dbHash. Unlike the column cache it
+    // is installed under a shared collection lock, so concurrent seeders and readers (which only
+    // hold intent locks) synchronize on the mutex.
+    mutable stdx::mutex _contentHashMutex;
+    std::shared_ptr<CollectionContentHash> _contentHash;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
     bool _hasTTLIndex = false;
+    bool _hasDeferredIndex = false;
 };
 
 }  // namespace mongo
@@ -279,6 +279,10 @@ public:
         std::abort();
     }
 
+    const boost::optional<TimeseriesOptions>& getTimeseriesOptions() const {
+        std::abort();
+    }
+
     void informIndexObserver(OperationContext* opCtx,
                              const IndexDescriptor* descriptor,
                              const IndexKeyEntry& indexEntry,
@@ -92,8 +92,73 @@ Status checkStorageEngineOptions(const BSONElement& elem) {
     return Status::OK();
 }
 
+Status checkTimeseriesField(StringData optionName, StringData fieldName) {
+    if (fieldName.empty() || fieldName == "_id" || fieldName.find('.') != std::string::npos ||
+        fieldName.startsWith("$")) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'timeseries." << optionName
+                              << "' must name a top-level field other than _id, but is '"
+                              << fieldName
+                              << "'"};
+    }
+    return Status::OK();
+}
+
 }  // namespace
 
+StatusWith<TimeseriesOptions> TimeseriesOptions::parse(const BSONObj& obj) {
+    TimeseriesOptions options;
+    for (auto&& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "timeField" || fieldName == "metaField") {
+            if (elem.type() != mongo::String) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << "'timeseries." << fieldName << "' has to be a string."};
+            }
+            auto status = checkTimeseriesField(fieldName, elem.valueStringData());
+            if (!status.isOK()) {
+                return status;
+            }
+            (fieldName == "timeField" ? options.timeField : options.metaField) = elem.String();
+        } else if (fieldName == "bucketMaxCount") {
+            if (!elem.isNumber()) {
+                return {ErrorCodes::TypeMismatch,
+                        "'timeseries.bucketMaxCount' has to be a number."};
+            }
+            const long long bucketMaxCount = elem.safeNumberLong();
+            if (bucketMaxCount < 1 || bucketMaxCount > kMaxBucketMaxCount) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "'timeseries.bucketMaxCount' must be between 1 and "
+                                      << kMaxBucketMaxCount};
+            }
+            options.bucketMaxCount = bucketMaxCount;
+        } else {
+            return {ErrorCodes::InvalidOptions,
+                    str::stream() << "The field 'timeseries." << fieldName
+                                  << "' is not a valid time-series collection option."};
+        }
+    }
+
+    if (options.timeField.empty()) {
+        return {ErrorCodes::BadValue, "'timeseries.timeField' is required."};
+    }
+    if (options.timeField == options.metaField) {
+        return {ErrorCodes::BadValue,
+                "'timeseries.timeField' and 'timeseries.metaField' cannot be the same field."};
+    }
+    return options;
+}
+
+BSONObj TimeseriesOptions::toBSON() const {
+    BSONObjBuilder b;
+    b.append("timeField", timeField);
+    if (!metaField.empty()) {
+        b.append("metaField", metaField);
+    }
+    b.append("bucketMaxCount", bucketMaxCount);
+    return b.obj();
+}
+
 bool CollectionOptions::isView() const {
     return !viewOn.empty();
 }
@@ -243,6 +308,16 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             pipeline = e.Obj().getOwned();
+        } else if (fieldName == "timeseries") {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::BadValue, "'timeseries' has to be a document.");
+            }
+
+            auto swOptions = TimeseriesOptions::parse(e.Obj());
+            if (!swOptions.isOK()) {
+                return swOptions.getStatus();
+            }
+            timeseries = std::move(swOptions.getValue());
         } else if (!createdOn24OrEarlier && !Command::isGenericArgument(fieldName)) {
             return Status(ErrorCodes::InvalidOptions,
                           str::stream() << "The field '" << fieldName
@@ -255,6 +330,11 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (timeseries && (capped || !viewOn.empty())) {
+        return Status(ErrorCodes::BadValue,
+                      "A time-series collection cannot be capped or a view.");
+    }
+
     return Status::OK();
 }
 
@@ -319,6 +399,10 @@ BSONObj CollectionOptions::toBSON() const {
         b.append("pipeline", pipeline);
     }
 
+    if (timeseries) {
+        b.append("timeseries", timeseries->toBSON());
+    }
+
     return b.obj();
 }
 }
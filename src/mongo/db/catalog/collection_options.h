@@ -33,6 +33,7 @@
 #include <boost/optional.hpp>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/util/uuid.h"
 
@@ -51,6 +52,29 @@ using CollectionUUID = UUID;
 
 using OptionalCollectionUUID = boost::optional<CollectionUUID>;
 
+/**
+ * The options of a time-series collection, which stores its measurements grouped into buckets
+ * of the measurements of the same series. See timeseries/bucket_format.h.
+ */
+struct TimeseriesOptions {
+    static const int kDefaultBucketMaxCount = 1000;
+    static const int kMaxBucketMaxCount = 100 * 1000;
+
+    static StatusWith<TimeseriesOptions> parse(const BSONObj& obj);
+
+    BSONObj toBSON() const;
+
+    // The top-level field holding the time of each measurement, which must be a date.
+    std::string timeField;
+
+    // The top-level field identifying the series of each measurement, or the empty string if the
+    // collection has a single series.
+    std::string metaField;
+
+    // The number of measurements after which a bucket is closed and compressed.
+    int bucketMaxCount = kDefaultBucketMaxCount;
+};
+
 struct CollectionOptions {
     /**
      * Returns true if the options indicate the namespace is a view.
@@ -135,5 +159,8 @@ struct CollectionOptions {
     std::string viewOn;
     // The aggregation pipeline that defines this view.
     BSONObj pipeline;
+
+    // Set if this is a time-series collection.
+    boost::optional<TimeseriesOptions> timeseries;
 };
 }
@@ -333,4 +333,35 @@ TEST(CollectionOptions, ParseUUID) {
     // Check that a collection options containing a UUID passes validation.
     ASSERT_OK(options.validateForStorage());
 }
+
+TEST(CollectionOptions, ParseTimeseries) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{timeseries: {timeField: 't', metaField: 'm'}}")));
+    ASSERT(options.timeseries);
+    ASSERT_EQ("t", options.timeseries->timeField);
+    ASSERT_EQ("m", options.timeseries->metaField);
+    ASSERT_EQ(TimeseriesOptions::kDefaultBucketMaxCount, options.timeseries->bucketMaxCount);
+    ASSERT_OK(options.validateForStorage());
+    ASSERT_BSONOBJ_EQ(fromjson("{timeseries: {timeField: 't', metaField: 'm', bucketMaxCount: "
+                               "1000}}"),
+                      options.toBSON());
+
+    ASSERT_OK(options.parse(fromjson("{timeseries: {timeField: 't', bucketMaxCount: 10}}")));
+    ASSERT_EQ("", options.timeseries->metaField);
+    ASSERT_EQ(10, options.timeseries->bucketMaxCount);
+}
+
+TEST(CollectionOptions, InvalidTimeseriesOptionsRejected) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: 1}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 1}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 'a.b'}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: '_id'}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't', metaField: 't'}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't', bucketMaxCount: 0}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't', other: 1}}")));
+    ASSERT_NOT_OK(
+        options.parse(fromjson("{timeseries: {timeField: 't'}, capped: true, size: 1024}")));
+}
 }  // namespace mongo
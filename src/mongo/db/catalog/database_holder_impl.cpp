@@ -99,23 +99,27 @@ Database* DatabaseHolderImpl::get(OperationContext* opCtx, StringData ns) const
     const StringData db = _todb(ns);
     invariant(opCtx->lockState()->isDbLockedForMode(db, MODE_IS));
 
-    stdx::lock_guard<SimpleMutex> lk(_m);
-    DBs::const_iterator it = _dbs.find(db);
-    if (it != _dbs.end()) {
-        return it->second;
-    }
+    return _dbs.read([db](const DBs& dbs) -> Database* {
+        DBs::const_iterator it = dbs.find(db);
+        if (it != dbs.end()) {
+            return it->second;
+        }
 
-    return NULL;
+        return NULL;
+    });
 }
 
 std::set<std::string> DatabaseHolderImpl::_getNamesWithConflictingCasing_inlock(StringData name) {
     std::set<std::string> duplicates;
 
-    for (const auto& nameAndPointer : _dbs) {
-        // A name that's equal with case-insensitive match must be identical, or it's a duplicate.
-        if (name.equalCaseInsensitive(nameAndPointer.first) && name != nameAndPointer.first)
-            duplicates.insert(nameAndPointer.first);
-    }
+    _dbs.read([&](const DBs& dbs) {
+        for (const auto& nameAndPointer : dbs) {
+            // A name that's equal with case-insensitive match must be identical, or it's a
+            // duplicate.
+            if (name.equalCaseInsensitive(nameAndPointer.first) && name != nameAndPointer.first)
+                duplicates.insert(nameAndPointer.first);
+        }
+    });
     return duplicates;
 }
 
@@ -133,16 +137,24 @@ Database* DatabaseHolderImpl::openDb(OperationContext* opCtx, StringData ns, boo
 
     stdx::unique_lock<SimpleMutex> lk(_m);
 
+    if (auto db = get(opCtx, ns))
+        return db;
+
     // The following will insert a nullptr for dbname, which will treated the same as a non-
     // existant database by the get method, yet still counts in getNamesWithConflictingCasing.
-    if (auto db = _dbs[dbname])
-        return db;
+    _dbs.write([dbname](DBs& dbs) {
+        dbs[dbname] = nullptr;
+        return true;
+    });
 
     // We've inserted a nullptr entry for dbname: make sure to remove it on unsuccessful exit.
     auto removeDbGuard = MakeGuard([this, &lk, dbname] {
         if (!lk.owns_lock())
             lk.lock();
-        _dbs.erase(dbname);
+        _dbs.write([dbname](DBs& dbs) {
+            dbs.erase(dbname);
+            return true;
+        });
     });
 
     // Check casing in lock to avoid transient duplicates.
@@ -175,12 +187,16 @@ Database* DatabaseHolderImpl::openDb(OperationContext* opCtx, StringData ns, boo
     // Finally replace our nullptr entry with the new Database pointer.
     removeDbGuard.Dismiss();
     lk.lock();
-    auto it = _dbs.find(dbname);
-    invariant(it != _dbs.end() && it->second == nullptr);
-    it->second = newDb.release();
+    Database* db = newDb.release();
+    _dbs.write([dbname, db](DBs& dbs) {
+        auto it = dbs.find(dbname);
+        invariant(it != dbs.end() && it->second == nullptr);
+        it->second = db;
+        return true;
+    });
     invariant(_getNamesWithConflictingCasing_inlock(dbname.toString()).empty());
 
-    return it->second;
+    return db;
 }
 
 void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std::string& reason) {
@@ -190,12 +206,11 @@ void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std
 
     stdx::lock_guard<SimpleMutex> lk(_m);
 
-    DBs::const_iterator it = _dbs.find(dbName);
-    if (it == _dbs.end()) {
+    auto db = get(opCtx, ns);
+    if (!db) {
         return;
     }
 
-    auto db = it->second;
     UUIDCatalog::get(opCtx).onCloseDatabase(db);
     for (auto&& coll : *db) {
         NamespaceUUIDCache::get(opCtx).evictNamespace(coll->ns());
@@ -205,7 +220,10 @@ void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std
     delete db;
     db = nullptr;
 
-    _dbs.erase(it);
+    _dbs.write([dbName](DBs& dbs) {
+        dbs.erase(dbName);
+        return true;
+    });
 
     getGlobalServiceContext()
         ->getGlobalStorageEngine()
@@ -222,9 +240,11 @@ bool DatabaseHolderImpl::closeAll(OperationContext* opCtx,
     stdx::lock_guard<SimpleMutex> lk(_m);
 
     set<string> dbs;
-    for (DBs::const_iterator i = _dbs.begin(); i != _dbs.end(); ++i) {
-        dbs.insert(i->first);
-    }
+    _dbs.read([&dbs](const DBs& openDbs) {
+        for (DBs::const_iterator i = openDbs.begin(); i != openDbs.end(); ++i) {
+            dbs.insert(i->first);
+        }
+    });
 
     BSONArrayBuilder bb(result.subarrayStart("dbs"));
     int nNotClosed = 0;
@@ -240,11 +260,14 @@ bool DatabaseHolderImpl::closeAll(OperationContext* opCtx,
             continue;
         }
 
-        Database* db = _dbs[name];
+        Database* db = get(opCtx, name);
         db->close(opCtx, reason);
         delete db;
 
-        _dbs.erase(name);
+        _dbs.write([&name](DBs& openDbs) {
+            openDbs.erase(name);
+            return true;
+        });
 
         getGlobalServiceContext()
             ->getGlobalStorageEngine()
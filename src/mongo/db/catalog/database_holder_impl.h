@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/util/published_snapshot.h"
 
 #include <set>
 #include <string>
@@ -53,7 +54,7 @@ public:
 
     /**
      * Retrieves an already opened database or returns NULL. Must be called with the database
-     * locked in at least IS-mode.
+     * locked in at least IS-mode. Does not take the holder's mutex.
      */
     Database* get(OperationContext* opCtx, StringData ns) const override;
 
@@ -92,7 +93,9 @@ private:
     std::set<std::string> _getNamesWithConflictingCasing_inlock(StringData name);
 
     typedef StringMap<Database*> DBs;
+
+    // Serializes changes to '_dbs'. Lookups do not take it.
     mutable SimpleMutex _m;
-    DBs _dbs;
+    PublishedSnapshot<DBs> _dbs;
 };
 }  // namespace mongo
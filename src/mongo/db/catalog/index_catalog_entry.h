@@ -29,7 +29,9 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/ordering.h"
@@ -48,10 +50,22 @@ class CollectionCatalogEntry;
 class CollectionInfoCache;
 class HeadManager;
 class IndexAccessMethod;
+class IndexBuildInterceptor;
 class IndexDescriptor;
+class IndexPrefixCounts;
 class MatchExpression;
 class OperationContext;
 
+/**
+ * A top-level conjunct of a partial index's filter. Conjuncts with equal 'key's, even from
+ * different indexes, match exactly the same documents and so need only be evaluated once per
+ * document.
+ */
+struct PartialFilterConjunct {
+    std::string key;
+    const MatchExpression* expr;
+};
+
 class IndexCatalogEntry {
 public:
     // This class represents the internal vtable for the (potentially polymorphic) implementation of
@@ -77,8 +91,19 @@ public:
 
         virtual const MatchExpression* getFilterExpression() const = 0;
 
+        virtual const std::vector<PartialFilterConjunct>& getFilterConjuncts() const = 0;
+
         virtual const CollatorInterface* getCollator() const = 0;
 
+        virtual IndexBuildInterceptor* indexBuildInterceptor() const = 0;
+
+        virtual std::shared_ptr<IndexBuildInterceptor> getSharedIndexBuildInterceptor() const = 0;
+
+        virtual void setIndexBuildInterceptor(
+            std::shared_ptr<IndexBuildInterceptor> interceptor) = 0;
+
+        virtual IndexPrefixCounts* prefixCounts() const = 0;
+
         virtual const RecordId& head(OperationContext* opCtx) const = 0;
 
         virtual void setHead(OperationContext* opCtx, RecordId newHead) = 0;
@@ -91,6 +116,8 @@ public:
 
         virtual MultikeyPaths getMultikeyPaths(OperationContext* opCtx) const = 0;
 
+        virtual bool isMultikeyOnAllPaths() const = 0;
+
         virtual void setMultikey(OperationContext* opCtx, const MultikeyPaths& multikeyPaths) = 0;
 
         virtual bool isReady(OperationContext* opCtx) const = 0;
@@ -161,10 +188,50 @@ public:
         return this->_impl().getFilterExpression();
     }
 
+    /**
+     * Returns the top-level conjuncts of getFilterExpression(), whose conjunction is equivalent to
+     * it. Empty if this isn't a partial index.
+     */
+    inline const std::vector<PartialFilterConjunct>& getFilterConjuncts() const {
+        return this->_impl().getFilterConjuncts();
+    }
+
     inline const CollatorInterface* getCollator() const {
         return this->_impl().getCollator();
     }
 
+    /**
+     * If non-null, writes to this index are captured by the returned interceptor rather than
+     * applied to the index, because it is being bulk built without the collection lock held or
+     * because the index is deferred.
+     */
+    inline IndexBuildInterceptor* indexBuildInterceptor() const {
+        return this->_impl().indexBuildInterceptor();
+    }
+
+    /**
+     * Returns the interceptor, if any, with shared ownership so that it can be handed over to
+     * another entry for the same index.
+     */
+    inline std::shared_ptr<IndexBuildInterceptor> getSharedIndexBuildInterceptor() const {
+        return this->_impl().getSharedIndexBuildInterceptor();
+    }
+
+    /**
+     * Requires an exclusive lock on the collection.
+     */
+    inline void setIndexBuildInterceptor(std::shared_ptr<IndexBuildInterceptor> interceptor) {
+        return this->_impl().setIndexBuildInterceptor(std::move(interceptor));
+    }
+
+    /**
+     * Non-null if the index was created with the "prefixCounts" option, in which case the
+     * documents are counted by the value of its leading field.
+     */
+    inline IndexPrefixCounts* prefixCounts() const {
+        return this->_impl().prefixCounts();
+    }
+
     /// ---------------------
 
     inline const RecordId& head(OperationContext* const opCtx) const {
@@ -205,6 +272,16 @@ public:
         return this->_impl().getMultikeyPaths(opCtx);
     }
 
+    /**
+     * Returns true if no further call to setMultikey() can change this index's multikey state:
+     * the index is multikey and either doesn't support path-level multikey tracking, or already
+     * has every component of every indexed field marked as causing it to be multikey. Callers may
+     * then skip computing multikey paths when generating keys.
+     */
+    inline bool isMultikeyOnAllPaths() const {
+        return this->_impl().isMultikeyOnAllPaths();
+    }
+
     /**
      * Sets this index to be multikey. Information regarding which newly detected path components
      * cause this index to be multikey can also be specified.
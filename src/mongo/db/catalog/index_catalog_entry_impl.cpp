@@ -40,12 +40,15 @@
 #include "mongo/db/catalog/head_manager.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/index_prefix_counts.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -110,6 +113,7 @@ IndexCatalogEntryImpl::IndexCatalogEntryImpl(IndexCatalogEntry* const this_,
         stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
         _isMultikey.store(_catalogIsMultikey(opCtx, &_indexMultikeyPaths));
         _indexTracksPathLevelMultikeyInfo = !_indexMultikeyPaths.empty();
+        _isMultikeyOnAllPaths.store(_computeIsMultikeyOnAllPaths_inlock());
     }
 
     if (BSONElement collationElement = _descriptor->getInfoElement("collation")) {
@@ -132,9 +136,38 @@ IndexCatalogEntryImpl::IndexCatalogEntryImpl(IndexCatalogEntry* const this_,
         // this should be checked in create, so can blow up here
         invariantOK(statusWithMatcher.getStatus());
         _filterExpression = std::move(statusWithMatcher.getValue());
+        _initFilterConjuncts();
         LOG(2) << "have filter expression for " << _ns << " " << _descriptor->indexName() << " "
                << redact(filter);
     }
+
+    if (_descriptor->tracksPrefixCounts()) {
+        _prefixCounts = stdx::make_unique<IndexPrefixCounts>();
+    }
+}
+
+void IndexCatalogEntryImpl::_initFilterConjuncts() {
+    std::vector<const MatchExpression*> conjuncts;
+    if (_filterExpression->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < _filterExpression->numChildren(); ++i) {
+            conjuncts.push_back(_filterExpression->getChild(i));
+        }
+    } else {
+        conjuncts.push_back(_filterExpression.get());
+    }
+
+    // The same predicate can match differently under different collations, so the collation is
+    // part of the key.
+    BSONObj collation = _collator ? _collator->getSpec().toBSON() : BSONObj();
+    for (auto conjunct : conjuncts) {
+        BSONObjBuilder bob;
+        conjunct->serialize(&bob);
+        BSONObj serialized = bob.obj();
+
+        std::string key(serialized.objdata(), serialized.objsize());
+        key.append(collation.objdata(), collation.objsize());
+        _filterConjuncts.push_back({std::move(key), conjunct});
+    }
 }
 
 IndexCatalogEntryImpl::~IndexCatalogEntryImpl() {
@@ -168,6 +201,32 @@ MultikeyPaths IndexCatalogEntryImpl::getMultikeyPaths(OperationContext* opCtx) c
     return _indexMultikeyPaths;
 }
 
+bool IndexCatalogEntryImpl::isMultikeyOnAllPaths() const {
+    return _isMultikeyOnAllPaths.load();
+}
+
+bool IndexCatalogEntryImpl::_computeIsMultikeyOnAllPaths_inlock() const {
+    if (!_isMultikey.load()) {
+        return false;
+    }
+
+    if (!_indexTracksPathLevelMultikeyInfo) {
+        return true;
+    }
+
+    // Each component recorded for an indexed field is a position in [0, numParts), so the field is
+    // fully multikey exactly when it has as many components recorded as it has parts.
+    size_t i = 0;
+    for (auto&& keyElem : _descriptor->keyPattern()) {
+        invariant(i < _indexMultikeyPaths.size());
+        if (_indexMultikeyPaths[i].size() < FieldRef(keyElem.fieldNameStringData()).numParts()) {
+            return false;
+        }
+        ++i;
+    }
+    return true;
+}
+
 // ---
 
 void IndexCatalogEntryImpl::setIsReady(bool newIsReady) {
@@ -309,12 +368,13 @@ void IndexCatalogEntryImpl::setMultikey(OperationContext* opCtx,
 
     _isMultikey.store(true);
 
+    stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
     if (_indexTracksPathLevelMultikeyInfo) {
-        stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
         for (size_t i = 0; i < multikeyPaths.size(); ++i) {
             _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
         }
     }
+    _isMultikeyOnAllPaths.store(_computeIsMultikeyOnAllPaths_inlock());
 }
 
 // ----
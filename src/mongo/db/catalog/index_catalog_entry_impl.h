@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -49,7 +50,9 @@ class CollectionCatalogEntry;
 class CollectionInfoCache;
 class HeadManager;
 class IndexAccessMethod;
+class IndexBuildInterceptor;
 class IndexDescriptor;
+class IndexPrefixCounts;
 class MatchExpression;
 class OperationContext;
 
@@ -95,10 +98,30 @@ public:
         return _filterExpression.get();
     }
 
+    const std::vector<PartialFilterConjunct>& getFilterConjuncts() const final {
+        return _filterConjuncts;
+    }
+
     const CollatorInterface* getCollator() const final {
         return _collator.get();
     }
 
+    IndexBuildInterceptor* indexBuildInterceptor() const final {
+        return _indexBuildInterceptor.get();
+    }
+
+    std::shared_ptr<IndexBuildInterceptor> getSharedIndexBuildInterceptor() const final {
+        return _indexBuildInterceptor;
+    }
+
+    void setIndexBuildInterceptor(std::shared_ptr<IndexBuildInterceptor> interceptor) final {
+        _indexBuildInterceptor = std::move(interceptor);
+    }
+
+    IndexPrefixCounts* prefixCounts() const final {
+        return _prefixCounts.get();
+    }
+
     /// ---------------------
 
     const RecordId& head(OperationContext* opCtx) const final;
@@ -129,6 +152,11 @@ public:
      */
     MultikeyPaths getMultikeyPaths(OperationContext* opCtx) const final;
 
+    /**
+     * Returns true if this index is multikey and setMultikey() would have nothing left to record.
+     */
+    bool isMultikeyOnAllPaths() const final;
+
     /**
      * Sets this index to be multikey. Information regarding which newly detected path components
      * cause this index to be multikey can also be specified.
@@ -174,6 +202,17 @@ private:
      */
     bool _catalogIsMultikey(OperationContext* opCtx, MultikeyPaths* multikeyPaths) const;
 
+    /**
+     * Computes the value for '_isMultikeyOnAllPaths'. The caller must hold
+     * '_indexMultikeyPathsMutex'.
+     */
+    bool _computeIsMultikeyOnAllPaths_inlock() const;
+
+    /**
+     * Fills in '_filterConjuncts' from '_filterExpression', which must be set.
+     */
+    void _initFilterConjuncts();
+
     KVPrefix _catalogGetPrefix(OperationContext* opCtx) const;
 
     // -----
@@ -193,6 +232,9 @@ private:
     std::unique_ptr<CollatorInterface> _collator;
     std::unique_ptr<MatchExpression> _filterExpression;
 
+    // The top-level conjuncts of '_filterExpression', keyed by their serialization and collation.
+    std::vector<PartialFilterConjunct> _filterConjuncts;
+
     // cached stuff
 
     Ordering _ordering;  // TODO: this might be b-tree specific
@@ -208,6 +250,10 @@ private:
     // stored in the NamespaceDetails or KVCatalog.
     AtomicWord<bool> _isMultikey;
 
+    // Set to true once this index is multikey and, if it tracks path-level multikey information,
+    // every component of every indexed field is recorded in '_indexMultikeyPaths'.
+    AtomicWord<bool> _isMultikeyOnAllPaths{false};
+
     // Controls concurrent access to '_indexMultikeyPaths'. We acquire this mutex rather than the
     // RESOURCE_METADATA lock as a performance optimization so that it is cheaper to detect whether
     // there is actually any path-level multikey information to update or not.
@@ -227,5 +273,12 @@ private:
 
     // The earliest snapshot that is allowed to read this index.
     boost::optional<SnapshotName> _minVisibleSnapshot;
+
+    // Set while a hybrid build of this index is in progress, in which case it is shared with the
+    // index builder, and for as long as a deferred index is ready.
+    std::shared_ptr<IndexBuildInterceptor> _indexBuildInterceptor;
+
+    // Set if the index was created with the "prefixCounts" option.
+    std::unique_ptr<IndexPrefixCounts> _prefixCounts;
 };
 }  // namespace mongo
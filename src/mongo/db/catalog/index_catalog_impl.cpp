@@ -32,6 +32,8 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -49,7 +51,9 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/index_prefix_counts.h"
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
@@ -63,13 +67,38 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/represent_as.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 namespace {
+/**
+ * Diverts the writes to 'entry' into an interceptor if it is a ready deferred index, so that the
+ * DeferredIndexApplier applies them in the background instead of the writers.
+ */
+void setUpDeferredIndexWrites(IndexCatalogEntry* entry, const NamespaceString& ns) {
+    if (!entry->descriptor()->isDeferred() || storageGlobalParams.readOnly) {
+        return;
+    }
+    invariant(!entry->indexBuildInterceptor());
+    entry->setIndexBuildInterceptor(std::make_shared<IndexBuildInterceptor>(ns.ns()));
+}
+
+/**
+ * Builds the prefix counts of 'entry' from its keys if it keeps them. The writers to the collection
+ * must be excluded until the counts are built, from when they maintain them.
+ */
+void buildPrefixCounts(OperationContext* opCtx, IndexCatalogEntry* entry) {
+    if (auto prefixCounts = entry->prefixCounts()) {
+        prefixCounts->rebuild(opCtx, entry->accessMethod(), entry->isMultikey());
+        LOG(1) << "built the prefix counts of index " << entry->descriptor()->indexNamespace();
+    }
+}
+
 MONGO_INITIALIZER(InitializeIndexCatalogFactory)(InitializerContext* const) {
     IndexCatalog::registerFactory([](
         IndexCatalog* const this_, Collection* const collection, const int maxNumIndexesAllowed) {
@@ -152,6 +181,8 @@ Status IndexCatalogImpl::init(OperationContext* opCtx) {
             _setupInMemoryStructures(opCtx, std::move(descriptor), initFromDisk);
 
         fassert(17340, entry->isReady(opCtx));
+        setUpDeferredIndexWrites(entry, _collection->ns());
+        buildPrefixCounts(opCtx, entry);
     }
 
     if (_unfinishedIndexes.size()) {
@@ -469,6 +500,13 @@ void IndexCatalogImpl::IndexBuildBlock::success() {
     });
 
     entry->setIsReady(true);
+    buildPrefixCounts(_opCtx, entry);
+
+    setUpDeferredIndexWrites(entry, ns);
+    if (entry->indexBuildInterceptor()) {
+        _opCtx->recoveryUnit()->onRollback(
+            [entry] { entry->setIndexBuildInterceptor(nullptr); });
+    }
 }
 
 namespace {
@@ -679,6 +717,43 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
         }
     }
 
+    // Deferred writes are applied without checking for duplicate keys.
+    BSONElement deferredElt = spec[IndexDescriptor::kDeferredFieldName];
+    if (deferredElt) {
+        if (deferredElt.type() != Bool) {
+            return Status(ErrorCodes::CannotCreateIndex,
+                          "\"deferred\" for an index must be a boolean");
+        }
+        if (deferredElt.boolean() && spec["unique"].trueValue()) {
+            return Status(ErrorCodes::CannotCreateIndex,
+                          "cannot mix \"deferred\" and \"unique\" options");
+        }
+    }
+
+    // Prefix counts are maintained by the writers, and count every document by its index keys.
+    BSONElement prefixCountsElt = spec[IndexDescriptor::kPrefixCountsFieldName];
+    if (prefixCountsElt) {
+        if (prefixCountsElt.type() != Bool) {
+            return Status(ErrorCodes::CannotCreateIndex,
+                          "\"prefixCounts\" for an index must be a boolean");
+        }
+        if (prefixCountsElt.boolean()) {
+            if (IndexNames::findPluginName(key) != IndexNames::BTREE) {
+                return Status(ErrorCodes::CannotCreateIndex,
+                              "\"prefixCounts\" is only supported by btree indexes");
+            }
+            if (deferredElt.trueValue()) {
+                return Status(ErrorCodes::CannotCreateIndex,
+                              "cannot mix \"prefixCounts\" and \"deferred\" options");
+            }
+            if (filterElement) {
+                return Status(ErrorCodes::CannotCreateIndex,
+                              "cannot mix \"prefixCounts\" and \"partialFilterExpression\" "
+                              "options");
+            }
+        }
+    }
+
     if (IndexDescriptor::isIdIndexPattern(key)) {
         BSONElement uniqueElt = spec["unique"];
         if (uniqueElt && !uniqueElt.trueValue()) {
@@ -693,6 +768,10 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
             return Status(ErrorCodes::CannotCreateIndex, "_id index cannot be sparse");
         }
 
+        if (deferredElt.trueValue()) {
+            return Status(ErrorCodes::CannotCreateIndex, "_id index cannot be deferred");
+        }
+
         if (collationElement &&
             !CollatorInterface::collatorsMatch(collator.get(), _collection->getDefaultCollator())) {
             return Status(ErrorCodes::CannotCreateIndex,
@@ -1281,6 +1360,7 @@ const IndexDescriptor* IndexCatalogImpl::refreshEntry(OperationContext* opCtx,
     // Delete the IndexCatalogEntry that owns this descriptor.  After deletion, 'oldDesc' is
     // invalid and should not be dereferenced.
     IndexCatalogEntry* oldEntry = _entries.release(oldDesc);
+    auto interceptor = oldEntry->getSharedIndexBuildInterceptor();
     opCtx->recoveryUnit()->registerChange(
         new IndexRemoveChange(opCtx, _collection, &_entries, oldEntry));
 
@@ -1292,9 +1372,18 @@ const IndexDescriptor* IndexCatalogImpl::refreshEntry(OperationContext* opCtx,
     auto newDesc = stdx::make_unique<IndexDescriptor>(
         _collection, _getAccessMethodName(opCtx, keyPattern), spec);
     const bool initFromDisk = false;
-    const IndexCatalogEntry* newEntry =
+    IndexCatalogEntry* newEntry =
         _setupInMemoryStructures(opCtx, std::move(newDesc), initFromDisk);
     invariant(newEntry->isReady(opCtx));
+    buildPrefixCounts(opCtx, newEntry);
+
+    // The writes of a deferred index which haven't been applied yet stay with the index.
+    if (interceptor) {
+        newEntry->setIndexBuildInterceptor(interceptor);
+        oldEntry->setIndexBuildInterceptor(nullptr);
+        opCtx->recoveryUnit()->onRollback(
+            [oldEntry, interceptor] { oldEntry->setIndexBuildInterceptor(interceptor); });
+    }
 
     // Return the new descriptor.
     return newEntry->descriptor();
@@ -1302,13 +1391,103 @@ const IndexDescriptor* IndexCatalogImpl::refreshEntry(OperationContext* opCtx,
 
 // ---------------------------
 
+namespace {
+
+/**
+ * Matches a batch of records against the filters of several partial indexes, evaluating every
+ * distinct filter conjunct (see IndexCatalogEntry::getFilterConjuncts()) at most once per record.
+ * Partial indexes whose filters share clauses, e.g. {tenantType: "a", status: "active"} and
+ * {tenantType: "b", status: "active"}, then only walk each record once for the shared clause.
+ */
+class SharedPartialFilterMatcher {
+public:
+    explicit SharedPartialFilterMatcher(const std::vector<BsonRecord>& bsonRecords)
+        : _bsonRecords(bsonRecords), _results(bsonRecords.size()) {}
+
+    /**
+     * Returns the records that match the filter of the partial index 'index'.
+     */
+    std::vector<BsonRecord> matchingRecords(const IndexCatalogEntry* index) {
+        const auto& conjuncts = index->getFilterConjuncts();
+
+        std::vector<size_t> slots;
+        for (auto&& conjunct : conjuncts) {
+            auto it = _slots.find(conjunct.key);
+            if (it == _slots.end()) {
+                const size_t slot = _slots.size();
+                _slots[conjunct.key] = slot;
+                slots.push_back(slot);
+            } else {
+                slots.push_back(it->second);
+            }
+        }
+
+        std::vector<BsonRecord> matching;
+        for (size_t i = 0; i < _bsonRecords.size(); ++i) {
+            auto& results = _results[i];
+            results.resize(_slots.size(), kUnknown);
+
+            bool matches = true;
+            for (size_t j = 0; j < conjuncts.size() && matches; ++j) {
+                char& result = results[slots[j]];
+                if (result == kUnknown) {
+                    result =
+                        conjuncts[j].expr->matchesBSON(*_bsonRecords[i].docPtr) ? kMatch : kNoMatch;
+                }
+                matches = (result == kMatch);
+            }
+
+            if (matches) {
+                matching.push_back(_bsonRecords[i]);
+            }
+        }
+        return matching;
+    }
+
+private:
+    static const char kUnknown = 0;
+    static const char kMatch = 1;
+    static const char kNoMatch = 2;
+
+    const std::vector<BsonRecord>& _bsonRecords;
+
+    // Maps each distinct conjunct key seen so far to its position in the rows of '_results'.
+    StringMap<size_t> _slots;
+
+    // For each record, whether it matches each conjunct, if evaluated yet.
+    std::vector<std::vector<char>> _results;
+};
+
+}  // namespace
+
 Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
                                                IndexCatalogEntry* index,
                                                const std::vector<BsonRecord>& bsonRecords,
                                                int64_t* keysInsertedOut) {
+    if (auto interceptor = index->indexBuildInterceptor()) {
+        for (auto bsonRecord : bsonRecords) {
+            interceptor->sideWrite(
+                opCtx, *bsonRecord.docPtr, bsonRecord.id, IndexBuildInterceptor::Op::kInsert);
+        }
+        return Status::OK();
+    }
+
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    if (bsonRecords.size() > 1) {
+        // Insert the keys of the whole batch in index order rather than document by document.
+        int64_t inserted;
+        Status status = index->accessMethod()->insertBatch(opCtx, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -1347,6 +1526,11 @@ Status IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
                                         const RecordId& loc,
                                         bool logIfError,
                                         int64_t* keysDeletedOut) {
+    if (auto interceptor = index->indexBuildInterceptor()) {
+        interceptor->sideWrite(opCtx, obj, loc, IndexBuildInterceptor::Op::kDelete);
+        return Status::OK();
+    }
+
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
     options.logIfError = logIfError;
@@ -1382,9 +1566,30 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
         *keysInsertedOut = 0;
     }
 
+    const auto numPartialIndexes =
+        std::count_if(_entries.begin(), _entries.end(), [](const auto& entry) {
+            return entry->getFilterExpression() != nullptr;
+        });
+    if (numPartialIndexes < 2) {
+        for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
+             ++i) {
+            Status s = _indexRecords(opCtx, i->get(), bsonRecords, keysInsertedOut);
+            if (!s.isOK())
+                return s;
+        }
+
+        return Status::OK();
+    }
+
+    // Share the evaluation of clauses that appear in several partial index filters.
+    SharedPartialFilterMatcher filterMatcher(bsonRecords);
     for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
          ++i) {
-        Status s = _indexRecords(opCtx, i->get(), bsonRecords, keysInsertedOut);
+        IndexCatalogEntry* index = i->get();
+        Status s = index->getFilterExpression()
+            ? _indexFilteredRecords(
+                  opCtx, index, filterMatcher.matchingRecords(index), keysInsertedOut)
+            : _indexFilteredRecords(opCtx, index, bsonRecords, keysInsertedOut);
         if (!s.isOK())
             return s;
     }
@@ -43,6 +43,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
@@ -99,6 +100,10 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// If true, background builds of indexes that don't enforce uniqueness bulk load the keys they scan
+// and capture concurrent writes to apply afterwards, rather than inserting into the live index.
+MONGO_EXPORT_SERVER_PARAMETER(enableHybridIndexBuilds, bool, true);
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -140,6 +145,7 @@ MultiIndexBlockImpl::MultiIndexBlockImpl(OperationContext* opCtx, Collection* co
       _buildInBackground(false),
       _allowInterruption(false),
       _ignoreUnique(false),
+      _buildIsHybrid(false),
       _needToCleanup(true) {}
 
 MultiIndexBlockImpl::~MultiIndexBlockImpl() {
@@ -203,6 +209,7 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
     if (!status.isOK())
         return status;
 
+    bool anyUnique = false;
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
 
@@ -216,8 +223,14 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
 
         // Any foreground indexes make all indexes be built in the foreground.
         _buildInBackground = (_buildInBackground && info["background"].trueValue());
+
+        // Side writes are applied without checking for duplicate keys, so unique indexes are
+        // built in the background one document at a time.
+        anyUnique = anyUnique || info["unique"].trueValue();
     }
 
+    _buildIsHybrid = _buildInBackground && !anyUnique && enableHybridIndexBuilds.load();
+
     std::vector<BSONObj> indexInfoObjs;
     indexInfoObjs.reserve(indexSpecs.size());
     std::size_t eachIndexBuildMaxMemoryUsageBytes = 0;
@@ -248,12 +261,17 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!status.isOK())
             return status;
 
-        if (!_buildInBackground) {
-            // Bulk build process requires foreground building as it assumes nothing is changing
-            // under it.
+        if (!_buildInBackground || _buildIsHybrid) {
+            // Bulk build process assumes nothing is changing under it, so a hybrid build diverts
+            // concurrent writes to an interceptor until the bulk load is done.
             index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
         }
 
+        if (_buildIsHybrid) {
+            index.interceptor = std::make_shared<IndexBuildInterceptor>(ns);
+            index.block->getEntry()->setIndexBuildInterceptor(index.interceptor);
+        }
+
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
 
         IndexCatalog::prepareInsertDeleteOptions(_opCtx, descriptor, &index.options);
@@ -264,7 +282,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
 
         log() << "build index on: " << ns << " properties: " << descriptor->toString();
         if (index.bulk)
-            log() << "\t building index using bulk method; build may temporarily use up to "
+            log() << "\t building index using " << (_buildIsHybrid ? "hybrid" : "bulk")
+                  << " method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
@@ -455,6 +474,20 @@ Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
         }
     }
 
+    // Apply the writes made during the scan while still allowing new ones. commit() applies the
+    // rest under an exclusive lock.
+    return _drainSideWrites();
+}
+
+Status MultiIndexBlockImpl::_drainSideWrites() {
+    for (auto&& index : _indexes) {
+        if (!index.interceptor)
+            continue;
+        Status status = index.interceptor->drainWritesIntoIndex(_opCtx, index.real, index.options);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
     return Status::OK();
 }
 
@@ -464,6 +497,17 @@ void MultiIndexBlockImpl::abortWithoutCleanup() {
 }
 
 void MultiIndexBlockImpl::commit() {
+    uassertStatusOK(_drainSideWrites());
+    for (auto&& index : _indexes) {
+        if (!index.interceptor)
+            continue;
+        invariant(index.interceptor->areAllWritesApplied());
+        LOG(1) << "\t applied " << index.interceptor->numApplied()
+               << " concurrent writes to index: "
+               << index.block->getEntry()->descriptor()->indexName();
+        index.block->getEntry()->setIndexBuildInterceptor(nullptr);
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         _indexes[i].block->success();
     }
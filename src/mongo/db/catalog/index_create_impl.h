@@ -47,6 +47,7 @@ namespace mongo {
 class BackgroundOperation;
 class BSONObj;
 class Collection;
+class IndexBuildInterceptor;
 class OperationContext;
 
 /**
@@ -199,9 +200,17 @@ private:
         const MatchExpression* filterExpression;  // might be NULL, owned elsewhere
         std::unique_ptr<IndexAccessMethod::BulkBuilder> bulk;
 
+        // Set for hybrid builds. Shared with the index's catalog entry.
+        std::shared_ptr<IndexBuildInterceptor> interceptor;
+
         InsertDeleteOptions options;
     };
 
+    /**
+     * Applies the committed side writes of every index in a hybrid build.
+     */
+    Status _drainSideWrites();
+
     std::vector<IndexToBuild> _indexes;
 
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
@@ -214,6 +223,10 @@ private:
     bool _allowInterruption;
     bool _ignoreUnique;
 
+    // A hybrid build is a background build that bulk loads the keys it scans, diverting writes
+    // made in the meantime to an IndexBuildInterceptor.
+    bool _buildIsHybrid;
+
     bool _needToCleanup;
 };
 
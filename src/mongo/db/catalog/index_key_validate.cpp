@@ -38,6 +38,7 @@
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
@@ -72,15 +73,18 @@ static const std::set<StringData> allowedFieldNames = {
     IndexDescriptor::kBackgroundFieldName,
     IndexDescriptor::kCollationFieldName,
     IndexDescriptor::kDefaultLanguageFieldName,
+    IndexDescriptor::kDeferredFieldName,
     IndexDescriptor::kDropDuplicatesFieldName,
     IndexDescriptor::kExpireAfterSecondsFieldName,
     IndexDescriptor::kGeoHaystackBucketSize,
+    IndexDescriptor::kHashVersionFieldName,
     IndexDescriptor::kIndexNameFieldName,
     IndexDescriptor::kIndexVersionFieldName,
     IndexDescriptor::kKeyPatternFieldName,
     IndexDescriptor::kLanguageOverrideFieldName,
     IndexDescriptor::kNamespaceFieldName,
     IndexDescriptor::kPartialFilterExprFieldName,
+    IndexDescriptor::kPrefixCountsFieldName,
     IndexDescriptor::kSparseFieldName,
     IndexDescriptor::kStorageEngineFieldName,
     IndexDescriptor::kTextVersionFieldName,
@@ -217,6 +221,7 @@ StatusWith<BSONObj> validateIndexSpec(
     bool hasNamespaceField = false;
     bool hasVersionField = false;
     bool hasCollationField = false;
+    int hashVersion = BSONElementHasher::kMD5HashVersion;
 
     auto fieldNamesValidStatus = validateIndexSpecFieldNames(indexSpec);
     if (!fieldNamesValidStatus.isOK()) {
@@ -333,6 +338,23 @@ StatusWith<BSONObj> validateIndexSpec(
             }
 
             hasCollationField = true;
+        } else if (IndexDescriptor::kHashVersionFieldName == indexSpecElemFieldName) {
+            auto requestedHashVersion = indexSpecElem.isNumber()
+                ? representAs<int>(indexSpecElem.number())
+                : boost::optional<int>();
+            if (!requestedHashVersion ||
+                !BSONElementHasher::isSupportedHashVersion(*requestedHashVersion)) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "Invalid index specification " << indexSpec
+                                      << "; the field '"
+                                      << IndexDescriptor::kHashVersionFieldName
+                                      << "' must be "
+                                      << BSONElementHasher::kMD5HashVersion
+                                      << " or "
+                                      << BSONElementHasher::kXXHash64HashVersion};
+            }
+
+            hashVersion = *requestedHashVersion;
         } else {
             // We can assume field name is valid at this point. Validation of fieldname is handled
             // prior to this in validateIndexSpecFieldNames().
@@ -357,6 +379,30 @@ StatusWith<BSONObj> validateIndexSpec(
                               << "' field is a required property of an index specification"};
     }
 
+    if (hashVersion != BSONElementHasher::kMD5HashVersion) {
+        if (IndexNames::findPluginName(indexSpec.getObjectField(
+                IndexDescriptor::kKeyPatternFieldName)) != IndexNames::HASHED) {
+            return {ErrorCodes::CannotCreateIndex,
+                    str::stream() << "Invalid index specification " << indexSpec
+                                  << "; the field '"
+                                  << IndexDescriptor::kHashVersionFieldName
+                                  << "' is only valid for hashed indexes"};
+        }
+
+        // Older versions cannot generate keys for the xxHash-based hash function.
+        if (featureCompatibility.validateFeaturesAsMaster.load() &&
+            featureCompatibility.version.load() !=
+                ServerGlobalParams::FeatureCompatibility::Version::k36) {
+            return {ErrorCodes::CannotCreateIndex,
+                    str::stream() << "Invalid index specification " << indexSpec
+                                  << "; a hashed index with "
+                                  << IndexDescriptor::kHashVersionFieldName
+                                  << "="
+                                  << hashVersion
+                                  << " requires featureCompatibilityVersion 3.6"};
+        }
+    }
+
     if (hasCollationField && *resolvedIndexVersion < IndexVersion::kV2) {
         return {ErrorCodes::CannotCreateIndex,
                 str::stream() << "Invalid index specification " << indexSpec
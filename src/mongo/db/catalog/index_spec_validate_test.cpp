@@ -571,6 +571,90 @@ TEST(IndexSpecValidateTest, AcceptsIndexSpecIfCollationIsPresentAndVersionIsEqua
                       sorted(result.getValue()));
 }
 
+TEST(IndexSpecValidateTest, AcceptsSupportedHashVersionsForHashedIndexes) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k36);
+    featureCompatibility.validateFeaturesAsMaster.store(true);
+
+    for (int hashVersion : {0, 1}) {
+        ASSERT_OK(validateIndexSpec(BSON("key" << BSON("field"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << hashVersion),
+                                    kTestNamespace,
+                                    featureCompatibility));
+    }
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfHashVersionIsUnsupported) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k36);
+    featureCompatibility.validateFeaturesAsMaster.store(true);
+
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+              validateIndexSpec(BSON("key" << BSON("field"
+                                                   << "hashed")
+                                           << "name"
+                                           << "indexName"
+                                           << "hashVersion"
+                                           << 2),
+                                kTestNamespace,
+                                featureCompatibility));
+
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+              validateIndexSpec(BSON("key" << BSON("field"
+                                                   << "hashed")
+                                           << "name"
+                                           << "indexName"
+                                           << "hashVersion"
+                                           << "1"),
+                                kTestNamespace,
+                                featureCompatibility));
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfHashVersionIsUsedOnNonHashedIndex) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k36);
+    featureCompatibility.validateFeaturesAsMaster.store(true);
+
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+              validateIndexSpec(BSON("key" << BSON("field" << 1) << "name"
+                                           << "indexName"
+                                           << "hashVersion"
+                                           << 1),
+                                kTestNamespace,
+                                featureCompatibility));
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfXXHashVersionIsUsedWithFCV34) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k34);
+    featureCompatibility.validateFeaturesAsMaster.store(true);
+
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+              validateIndexSpec(BSON("key" << BSON("field"
+                                                   << "hashed")
+                                           << "name"
+                                           << "indexName"
+                                           << "hashVersion"
+                                           << 1),
+                                kTestNamespace,
+                                featureCompatibility));
+
+    // A secondary must still be able to replicate the index from a primary in FCV 3.6.
+    featureCompatibility.validateFeaturesAsMaster.store(false);
+    ASSERT_OK(validateIndexSpec(BSON("key" << BSON("field"
+                                                   << "hashed")
+                                           << "name"
+                                           << "indexName"
+                                           << "hashVersion"
+                                           << 1),
+                                kTestNamespace,
+                                featureCompatibility));
+}
+
 TEST(IndexSpecValidateTest, ReturnsAnErrorIfUnknownFieldIsPresentInSpecV2) {
     ServerGlobalParams::FeatureCompatibility featureCompatibility;
     featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k36);
@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+/**
+ * Holds a value of type T that is read far more often than it is written, such as a catalog map.
+ *
+ * Readers see an immutable snapshot of the value. Every thread caches the last snapshot it read,
+ * so read() only has to load a version number, and takes no lock unless a write was published
+ * since the calling thread's last read. A write copies the current value, modifies the copy and
+ * publishes it as the new snapshot, so writes cost O(size of T).
+ *
+ * A superseded snapshot is freed once every thread that cached it has read a newer one or exited.
+ */
+template <typename T>
+class PublishedSnapshot {
+    MONGO_DISALLOW_COPYING(PublishedSnapshot);
+
+public:
+    PublishedSnapshot() : _current(std::make_shared<const T>()), _version(_nextVersion()) {}
+
+    /**
+     * Calls 'reader' with the current snapshot and returns its result. 'reader' must not keep
+     * references into the snapshot past its return, and must not read any other
+     * PublishedSnapshot<T>.
+     */
+    template <typename Reader>
+    auto read(Reader&& reader) const -> decltype(reader(std::declval<const T&>())) {
+        auto& cache = _threadCache();
+        invariant(!cache.reading);
+
+        if (cache.version != _version.load()) {
+            stdx::lock_guard<stdx::mutex> lk(_publishMutex);
+            cache.snapshot = _current;
+            cache.version = _version.load();
+        }
+
+        cache.reading = true;
+        ON_BLOCK_EXIT([&cache] { cache.reading = false; });
+        return reader(*cache.snapshot);
+    }
+
+    /**
+     * Calls 'writer' with a copy of the current value. If 'writer' returns true, the copy is
+     * published as the new snapshot; otherwise it is discarded. Writes are serialized with each
+     * other, but do not block readers while copying.
+     */
+    template <typename Writer>
+    void write(Writer&& writer) {
+        stdx::lock_guard<stdx::mutex> writeLk(_writeMutex);
+
+        // Only writers replace '_current', so it can be read under '_writeMutex' alone.
+        auto copy = std::make_shared<T>(*_current);
+        if (!writer(*copy)) {
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> publishLk(_publishMutex);
+        _current = std::move(copy);
+        _version.store(_nextVersion());
+    }
+
+private:
+    struct ThreadCache {
+        std::shared_ptr<const T> snapshot;
+        unsigned long long version = 0;
+        bool reading = false;
+    };
+
+    static ThreadCache& _threadCache() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    /**
+     * Versions are unique across all instances, so a thread's cache can never be mistaken for
+     * the current snapshot of a different instance.
+     */
+    static unsigned long long _nextVersion() {
+        static AtomicUInt64 lastVersion;
+        return lastVersion.addAndFetch(1);
+    }
+
+    // Serializes writers.
+    stdx::mutex _writeMutex;
+
+    // Protects '_current' while it is replaced, and while readers copy it into their cache.
+    mutable stdx::mutex _publishMutex;
+    std::shared_ptr<const T> _current;
+
+    AtomicUInt64 _version;
+};
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+#include <vector>
+
+#include "mongo/db/catalog/util/published_snapshot.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using IntMapSnapshot = PublishedSnapshot<std::map<int, int>>;
+
+int lookup(const IntMapSnapshot& snapshot, int key) {
+    return snapshot.read([key](const std::map<int, int>& map) {
+        auto it = map.find(key);
+        return it == map.end() ? -1 : it->second;
+    });
+}
+
+TEST(PublishedSnapshot, DefaultConstructedSnapshotShouldBeEmpty) {
+    IntMapSnapshot snapshot;
+    ASSERT_TRUE(snapshot.read([](const std::map<int, int>& map) { return map.empty(); }));
+}
+
+TEST(PublishedSnapshot, ReadShouldSeePublishedWrite) {
+    IntMapSnapshot snapshot;
+    ASSERT_EQ(-1, lookup(snapshot, 1));
+
+    snapshot.write([](std::map<int, int>& map) {
+        map[1] = 10;
+        return true;
+    });
+    ASSERT_EQ(10, lookup(snapshot, 1));
+
+    snapshot.write([](std::map<int, int>& map) {
+        map[1] = 20;
+        return true;
+    });
+    ASSERT_EQ(20, lookup(snapshot, 1));
+}
+
+TEST(PublishedSnapshot, DiscardedWriteShouldNotBeVisible) {
+    IntMapSnapshot snapshot;
+    snapshot.write([](std::map<int, int>& map) {
+        map[1] = 10;
+        return false;
+    });
+    ASSERT_EQ(-1, lookup(snapshot, 1));
+}
+
+TEST(PublishedSnapshot, InstancesShouldNotShareCachedSnapshots) {
+    IntMapSnapshot first;
+    IntMapSnapshot second;
+    first.write([](std::map<int, int>& map) {
+        map[1] = 10;
+        return true;
+    });
+
+    ASSERT_EQ(10, lookup(first, 1));
+    ASSERT_EQ(-1, lookup(second, 1));
+    ASSERT_EQ(10, lookup(first, 1));
+}
+
+TEST(PublishedSnapshot, ConcurrentReadersShouldSeeCompleteSnapshots) {
+    IntMapSnapshot snapshot;
+    const int kWrites = 100;
+
+    // Each write sets every key to the same value, so readers must never see two values mixed.
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&snapshot] {
+            int lastSeen = 0;
+            while (lastSeen < kWrites) {
+                auto seen = snapshot.read([](const std::map<int, int>& map) {
+                    int value = map.empty() ? 0 : map.begin()->second;
+                    for (auto&& entry : map) {
+                        ASSERT_EQ(value, entry.second);
+                    }
+                    return value;
+                });
+                ASSERT_GTE(seen, lastSeen);
+                lastSeen = seen;
+            }
+        });
+    }
+
+    for (int version = 1; version <= kWrites; ++version) {
+        snapshot.write([version](std::map<int, int>& map) {
+            for (int key = 0; key < 10; ++key) {
+                map[key] = version;
+            }
+            return true;
+        });
+    }
+
+    for (auto&& reader : readers) {
+        reader.join();
+    }
+}
+
+}  // namespace
+}  // namespace mongo
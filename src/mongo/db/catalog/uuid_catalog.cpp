@@ -86,54 +86,84 @@ void UUIDCatalog::onRenameCollection(OperationContext* opCtx,
 }
 
 void UUIDCatalog::onCloseDatabase(Database* db) {
+    // While the collections do not actually get dropped, we're going to destroy the Collection
+    // objects, so for purposes of the UUIDCatalog it looks the same.
+    std::vector<CollectionUUID> uuids;
     for (auto&& coll : *db) {
         if (coll->uuid()) {
-            // While the collection does not actually get dropped, we're going to destroy the
-            // Collection object, so for purposes of the UUIDCatalog it looks the same.
-            removeUUIDCatalogEntry(coll->uuid().get());
+            uuids.push_back(coll->uuid().get());
         }
     }
+
+    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
+
+    // Invalidate this database's ordering, since we're deleting its UUIDs.
+    _orderedCollections.erase(db->name());
+
+    _catalog.write([&uuids](CollectionMap& catalog) {
+        bool removed = false;
+        for (auto&& uuid : uuids) {
+            auto foundIt = catalog.find(uuid);
+            if (foundIt == catalog.end())
+                continue;
+
+            LOG(2) << "unregistering collection " << foundIt->second.nss << " with UUID "
+                   << uuid.toString();
+            catalog.erase(foundIt);
+            removed = true;
+        }
+        return removed;
+    });
 }
 
 Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    return foundIt == _catalog.end() ? nullptr : foundIt->second;
+    return _catalog.read([&uuid](const CollectionMap& catalog) -> Collection* {
+        auto foundIt = catalog.find(uuid);
+        return foundIt == catalog.end() ? nullptr : foundIt->second.collection;
+    });
 }
 
 NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    Collection* coll = foundIt == _catalog.end() ? nullptr : foundIt->second;
-    return foundIt == _catalog.end() ? NamespaceString() : coll->ns();
+    return _catalog.read([&uuid](const CollectionMap& catalog) {
+        auto foundIt = catalog.find(uuid);
+        return foundIt == catalog.end() ? NamespaceString() : foundIt->second.nss;
+    });
 }
 
 void UUIDCatalog::registerUUIDCatalogEntry(CollectionUUID uuid, Collection* coll) {
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
 
-    if (coll && !_catalog.count(uuid)) {
-        // Invalidate this database's ordering, since we're adding a new UUID.
-        _orderedCollections.erase(coll->ns().db());
-
-        std::pair<CollectionUUID, Collection*> entry = std::make_pair(uuid, coll);
-        LOG(2) << "registering collection " << coll->ns() << " with UUID " << uuid.toString();
-        invariant(_catalog.insert(entry).second == true);
+    // Changes are serialized by '_catalogLock', so checking first avoids copying the catalog
+    // without racing with another change.
+    if (!coll || lookupCollectionByUUID(uuid)) {
+        return;
     }
+
+    // Invalidate this database's ordering, since we're adding a new UUID.
+    _orderedCollections.erase(coll->ns().db());
+
+    LOG(2) << "registering collection " << coll->ns() << " with UUID " << uuid.toString();
+    _catalog.write([&](CollectionMap& catalog) {
+        invariant(catalog.emplace(uuid, Entry{coll, coll->ns()}).second == true);
+        return true;
+    });
 }
 
 Collection* UUIDCatalog::removeUUIDCatalogEntry(CollectionUUID uuid) {
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
 
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt == _catalog.end())
+    auto foundCol = lookupCollectionByUUID(uuid);
+    if (!foundCol)
         return nullptr;
 
     // Invalidate this database's ordering, since we're deleting a UUID.
-    _orderedCollections.erase(foundIt->second->ns().db());
+    _orderedCollections.erase(foundCol->ns().db());
 
-    auto foundCol = foundIt->second;
     LOG(2) << "unregistering collection " << foundCol->ns() << " with UUID " << uuid.toString();
-    _catalog.erase(foundIt);
+    _catalog.write([&uuid](CollectionMap& catalog) {
+        invariant(catalog.erase(uuid) == 1);
+        return true;
+    });
     return foundCol;
 }
 
@@ -173,11 +203,13 @@ const std::vector<CollectionUUID>& UUIDCatalog::_getOrdering_inlock(
 
     // Otherwise, get all of the UUIDs for this database,
     auto& newOrdering = _orderedCollections[db];
-    for (const auto& pair : _catalog) {
-        if (pair.second->ns().db() == db) {
-            newOrdering.push_back(pair.first);
+    _catalog.read([&](const CollectionMap& catalog) {
+        for (const auto& pair : catalog) {
+            if (pair.second.nss.db() == db) {
+                newOrdering.push_back(pair.first);
+            }
         }
-    }
+    });
 
     // and sort them.
     std::sort(newOrdering.begin(), newOrdering.end());
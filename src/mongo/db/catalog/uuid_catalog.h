@@ -32,6 +32,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/util/published_snapshot.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/uuid.h"
@@ -40,7 +41,7 @@ namespace mongo {
 
 /**
  * This class comprises a UUID to collection catalog, allowing for efficient
- * collection lookup by UUID.
+ * collection lookup by UUID. Lookups do not take a lock; changes copy the catalog.
  */
 using CollectionUUID = UUID;
 class Database;
@@ -76,7 +77,8 @@ public:
                             CollectionUUID uuid);
 
     /**
-     * Implies onDropCollection for all collections in db, but is not transactional.
+     * Implies onDropCollection for all collections in db, but is not transactional. The
+     * collections are removed from the catalog in a single change.
      */
     void onCloseDatabase(Database* db);
 
@@ -111,9 +113,20 @@ public:
     boost::optional<CollectionUUID> next(const StringData& db, CollectionUUID uuid);
 
 private:
+    struct Entry {
+        Collection* collection;
+
+        // Kept alongside the collection so that lookupNSSByUUID() never dereferences a Collection
+        // that was removed from the catalog after the lookup read its snapshot.
+        NamespaceString nss;
+    };
+    using CollectionMap = stdx::unordered_map<CollectionUUID, Entry, CollectionUUID::Hash>;
+
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<stdx::mutex>&);
 
+    // Serializes changes to the catalog and protects '_orderedCollections'. Lookups by UUID do
+    // not take it.
     mutable mongo::stdx::mutex _catalogLock;
 
     /**
@@ -123,7 +136,7 @@ private:
      * not all databases are guaranteed to have an ordering in it.
      */
     StringMap<std::vector<CollectionUUID>> _orderedCollections;
-    mongo::stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash> _catalog;
+    PublishedSnapshot<CollectionMap> _catalog;
 };
 
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/thread.h"
@@ -108,6 +109,16 @@ Client::Client(std::string desc, ServiceContext* serviceContext, transport::Sess
       _connectionId(_session ? _session->id() : 0),
       _prng(generateSeed(_desc)) {}
 
+Client::~Client() = default;
+
+void Client::setCachedLocker(std::unique_ptr<Locker> locker) {
+    _cachedLocker = std::move(locker);
+}
+
+std::unique_ptr<Locker> Client::releaseCachedLocker() {
+    return std::move(_cachedLocker);
+}
+
 void Client::reportState(BSONObjBuilder& builder) {
     builder.append("desc", desc());
 
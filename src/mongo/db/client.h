@@ -55,6 +55,7 @@ namespace mongo {
 
 class AbstractMessagingPort;
 class Collection;
+class Locker;
 class OperationContext;
 
 typedef long long ConnectionId;
@@ -218,6 +219,20 @@ public:
         return _prng;
     }
 
+    /**
+     * Keeps 'locker', which must hold no locks, to be given to the next OperationContext created
+     * on this client instead of allocating a new Locker for it.
+     */
+    void setCachedLocker(std::unique_ptr<Locker> locker);
+
+    /**
+     * Returns the Locker saved by setCachedLocker, or nullptr if there is none. Ownership passes to
+     * the caller.
+     */
+    std::unique_ptr<Locker> releaseCachedLocker();
+
+    ~Client();
+
 private:
     friend class ServiceContext;
     explicit Client(std::string desc,
@@ -246,6 +261,9 @@ private:
     OperationContext* _opCtx = nullptr;
 
     PseudoRandom _prng;
+
+    // Locker left behind by the previous operation on this client, for reuse by the next one.
+    std::unique_ptr<Locker> _cachedLocker;
 };
 
 /** get the Client object for this thread. */
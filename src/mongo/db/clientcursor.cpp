@@ -93,6 +93,7 @@ ClientCursor::ClientCursor(ClientCursorParams params,
     invariant(_cursorManager);
     invariant(_exec);
 
+    _memoryCharge.set(sizeof(ClientCursor) + _originatingCommand.objsize());
     cursorStatsOpen.increment();
 
     if (isNoTimeout()) {
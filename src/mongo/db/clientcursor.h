@@ -38,6 +38,7 @@
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/record_id.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/memory_accounting.h"
 #include "mongo/util/net/message.h"
 
 namespace mongo {
@@ -309,6 +310,10 @@ private:
     // Holds an owned copy of the command specification received from the client.
     const BSONObj _originatingCommand;
 
+    // Charges the cursor and its command to the cursors memory account. The results buffered by
+    // the executor are not included.
+    MemoryAccount::Charge _memoryCharge{&memory_accounts::cursors};
+
     // See the QueryOptions enum in dbclientinterface.h.
     const int _queryOptions = 0;
 
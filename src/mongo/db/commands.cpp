@@ -32,6 +32,7 @@
 
 #include "mongo/db/commands.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -49,8 +50,10 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/latency_percentile_histogram.h"
 #include "mongo/rpc/write_concern_error_detail.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -74,7 +77,21 @@ ExportedServerParameter<bool, ServerParameterType::kStartupOnly> testCommandsPar
 
 }  // namespace
 
-Command::~Command() = default;
+Command::~Command() {
+    delete _latencyHistogram.load();
+}
+
+void Command::recordLatency(uint64_t micros) {
+    auto histogram = _latencyHistogram.load(std::memory_order_acquire);
+    if (MONGO_unlikely(!histogram)) {
+        auto newHistogram = stdx::make_unique<LatencyPercentileHistogram>();
+        if (_latencyHistogram.compare_exchange_strong(
+                histogram, newHistogram.get(), std::memory_order_acq_rel)) {
+            histogram = newHistogram.release();
+        }
+    }
+    histogram->increment(micros);
+}
 
 BSONObj Command::appendPassthroughFields(const BSONObj& cmdObjWithPassthroughFields,
                                          const BSONObj& request) {
@@ -171,6 +188,23 @@ Command::Command(StringData name, StringData oldName)
         (*_commands)[oldName.toString()] = this;
 }
 
+namespace {
+// Bounds the memory that replyBufferSizeHint() reserves after an unusually large reply.
+const int kMaxReplySizeHint = 1024 * 1024;
+}  // namespace
+
+std::size_t Command::replyBufferSizeHint() const {
+    return std::max(reserveBytesForReply(), static_cast<std::size_t>(_recentReplySize.load()));
+}
+
+void Command::noteReplySize(std::size_t bytes) {
+    // Racing updates may lose a sample, which is harmless for a hint.
+    const int size = static_cast<int>(std::min(bytes, static_cast<std::size_t>(kMaxReplySizeHint)));
+    const int recent = _recentReplySize.load();
+    const int decayed = recent - recent / 16;
+    _recentReplySize.store(std::max(size, decayed));
+}
+
 void Command::help(stringstream& help) const {
     help << "no help defined";
 }
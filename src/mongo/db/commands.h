@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/optional.hpp>
 #include <string>
 #include <vector>
@@ -42,6 +43,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/write_concern.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/net/op_msg.h"
@@ -49,6 +51,8 @@
 
 namespace mongo {
 
+class LatencyPercentileHistogram;
+
 class OperationContext;
 class Timer;
 
@@ -337,6 +341,31 @@ public:
         _commandsFailed.increment();
     }
 
+    /**
+     * Records how long an execution of this command took, for the commandLatencies section of
+     * serverStatus.
+     */
+    void recordLatency(uint64_t micros);
+
+    /**
+     * Returns the latencies recorded for this command, or nullptr if none were recorded yet.
+     */
+    const LatencyPercentileHistogram* getLatencyHistogram() const {
+        return _latencyHistogram.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns how many bytes to reserve up front for a reply to this command: the larger of
+     * reserveBytesForReply() and the size of recent replies, so that most replies are built
+     * without repeatedly growing their buffer.
+     */
+    std::size_t replyBufferSizeHint() const;
+
+    /**
+     * Records the size of a reply to this command, for replyBufferSizeHint().
+     */
+    void noteReplySize(std::size_t bytes);
+
     /**
      * Runs the command.
      *
@@ -525,6 +554,12 @@ private:
     Counter64 _commandsExecuted;
     Counter64 _commandsFailed;
 
+    // A maximum over recent reply sizes which decays with every smaller reply.
+    AtomicWord<int> _recentReplySize{0};
+
+    // Allocated by the first recordLatency(), as most commands are never run.
+    std::atomic<LatencyPercentileHistogram*> _latencyHistogram{nullptr};  // NOLINT
+
     // The full name of the command
     const std::string _name;
 
@@ -0,0 +1,379 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/catalog/index_key_validate.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/bulk_load_registry.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/ops/insert.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/server_options.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const StringData kBulkLoadIdFieldName = "bulkLoadId"_sd;
+
+/**
+ * Common attributes of the commands which drive a bulk load session. A session creates a new
+ * collection, fills it with unindexed inserts while its indexes are built on the side, and builds
+ * the indexes in bulk when it is committed, as initial sync does. This is meant for restoring
+ * dumps into a standalone server: the writes of a session are not replicated, so the commands
+ * refuse to run on a node which is part of a replica set.
+ */
+class BulkLoadCommand : public BasicCommand {
+public:
+    using BasicCommand::BasicCommand;
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::createCollection);
+        actions.addAction(ActionType::createIndex);
+        actions.addAction(ActionType::insert);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+protected:
+    static Status checkCanBulkLoad(OperationContext* opCtx) {
+        if (repl::ReplicationCoordinator::get(opCtx)->getReplicationMode() !=
+            repl::ReplicationCoordinator::modeNone) {
+            return {ErrorCodes::IllegalOperation,
+                    "bulk loads are not replicated and can only run on a standalone server"};
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Drops a partially loaded collection, whose loader must already have been destroyed.
+     */
+    static void dropLoadedCollection(OperationContext* opCtx, const NamespaceString& nss) {
+        Status status = repl::StorageInterface::get(opCtx)->dropCollection(opCtx, nss);
+        if (!status.isOK()) {
+            warning() << "Failed to drop " << nss.ns()
+                      << " after aborting its bulk load: " << redact(status);
+        }
+    }
+
+    /**
+     * Destroys the loader of a failed or abandoned session and drops its collection.
+     */
+    static void abortSession(OperationContext* opCtx, BulkLoadRegistry::Session session) {
+        session.loader.reset();
+        dropLoadedCollection(opCtx, session.nss);
+    }
+
+    static StatusWith<BulkLoadRegistry::Session> checkOutSession(const NamespaceString& nss,
+                                                                 const BSONObj& cmdObj,
+                                                                 long long* id) {
+        BSONElement idElt = cmdObj[kBulkLoadIdFieldName];
+        if (!idElt.isNumber()) {
+            return {ErrorCodes::TypeMismatch,
+                    str::stream() << "'" << kBulkLoadIdFieldName << "' must be a number"};
+        }
+        *id = idElt.safeNumberLong();
+        return BulkLoadRegistry::get()->checkOut(*id, nss);
+    }
+};
+
+/**
+ * { beginBulkLoad: <collection>, options: <collection options>, indexes: [<index specs>] }
+ *
+ * Creates the collection, which must not exist yet, and returns the id of the new session. The
+ * _id index is created with the default spec unless 'indexes' contains one. Like initial sync, the
+ * loader does not enforce unique constraints on secondary indexes, so unique indexes are instead
+ * built by commitBulkLoad after the other indexes.
+ */
+class BeginBulkLoadCmd : public BulkLoadCommand {
+public:
+    BeginBulkLoadCmd() : BulkLoadCommand("beginBulkLoad") {}
+
+    void help(std::stringstream& help) const override {
+        help << "creates a collection to be filled with bulkLoadInsert and indexed in bulk by "
+                "commitBulkLoad\n"
+                "{ beginBulkLoad: <collection>, options: <collection options>, "
+                "indexes: [<index specs>] }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+        uassertStatusOK(checkCanBulkLoad(opCtx));
+        uassertStatusOK(userAllowedCreateNS(nss.db(), nss.coll()));
+
+        CollectionOptions options;
+        BSONElement optionsElt = cmdObj["options"];
+        if (!optionsElt.eoo()) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'options' must be an object",
+                    optionsElt.type() == Object);
+            uassertStatusOK(options.parse(optionsElt.Obj()));
+        }
+
+        const auto& fcv = serverGlobalParams.featureCompatibility;
+        BSONObj idIndexSpec;
+        std::vector<BSONObj> secondaryIndexSpecs;
+        std::vector<BSONObj> deferredIndexSpecs;
+        BSONElement indexesElt = cmdObj["indexes"];
+        if (!indexesElt.eoo()) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'indexes' must be an array of objects",
+                    indexesElt.type() == Array);
+            for (auto&& elt : indexesElt.Obj()) {
+                uassert(ErrorCodes::TypeMismatch,
+                        "'indexes' must be an array of objects",
+                        elt.type() == Object);
+                BSONObj spec =
+                    uassertStatusOK(index_key_validate::validateIndexSpec(elt.Obj(), nss, fcv));
+                if (IndexDescriptor::isIdIndexPattern(
+                        spec[IndexDescriptor::kKeyPatternFieldName].Obj())) {
+                    uassertStatusOK(index_key_validate::validateIdIndexSpec(spec));
+                    idIndexSpec = spec;
+                } else if (spec[IndexDescriptor::kUniqueFieldName].trueValue()) {
+                    deferredIndexSpecs.push_back(spec);
+                } else {
+                    secondaryIndexSpecs.push_back(spec);
+                }
+            }
+        }
+        if (idIndexSpec.isEmpty() && options.autoIndexId != CollectionOptions::NO) {
+            idIndexSpec = uassertStatusOK(index_key_validate::validateIndexSpec(
+                BSON(IndexDescriptor::kKeyPatternFieldName
+                     << BSON("_id" << 1)
+                     << IndexDescriptor::kIndexNameFieldName
+                     << "_id_"),
+                nss,
+                fcv));
+        }
+
+        auto loader = uassertStatusOK(
+            repl::StorageInterface::get(opCtx)->createCollectionForBulkLoading(
+                nss, options, idIndexSpec, secondaryIndexSpecs));
+
+        BulkLoadRegistry::Session session;
+        session.nss = nss;
+        session.loader = std::move(loader);
+        session.deferredIndexSpecs = std::move(deferredIndexSpecs);
+
+        // The registry destroys the loader if it refuses the session.
+        auto id = BulkLoadRegistry::get()->add(std::move(session));
+        if (!id.isOK()) {
+            dropLoadedCollection(opCtx, nss);
+            return appendCommandStatus(result, id.getStatus());
+        }
+
+        log() << "Began bulk load " << id.getValue() << " of " << nss.ns();
+        result.append(kBulkLoadIdFieldName, id.getValue());
+        return true;
+    }
+};
+
+/**
+ * { bulkLoadInsert: <collection>, bulkLoadId: <id>, documents: [<documents>] }
+ *
+ * A failed insert aborts the whole session.
+ */
+class BulkLoadInsertCmd : public BulkLoadCommand {
+public:
+    BulkLoadInsertCmd() : BulkLoadCommand("bulkLoadInsert") {}
+
+    void help(std::stringstream& help) const override {
+        help << "inserts documents into a collection created by beginBulkLoad\n"
+                "{ bulkLoadInsert: <collection>, bulkLoadId: <id>, documents: [<documents>] }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        BSONElement documentsElt = cmdObj["documents"];
+        uassert(ErrorCodes::TypeMismatch,
+                "'documents' must be an array of objects",
+                documentsElt.type() == Array);
+        std::vector<BSONObj> documents;
+        for (auto&& elt : documentsElt.Obj()) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'documents' must be an array of objects",
+                    elt.type() == Object);
+            BSONObj fixed =
+                uassertStatusOK(fixDocumentForInsert(opCtx->getServiceContext(), elt.Obj()));
+            documents.push_back(fixed.isEmpty() ? elt.Obj() : fixed);
+        }
+
+        long long id;
+        auto session = uassertStatusOK(checkOutSession(nss, cmdObj, &id));
+        Status status = session.loader->insertDocuments(documents.cbegin(), documents.cend());
+        if (!status.isOK()) {
+            abortSession(opCtx, std::move(session));
+            return appendCommandStatus(result, status);
+        }
+        session.numInserted += documents.size();
+        BulkLoadRegistry::get()->checkIn(id, std::move(session));
+
+        result.append("n", static_cast<long long>(documents.size()));
+        return true;
+    }
+};
+
+/**
+ * { commitBulkLoad: <collection>, bulkLoadId: <id> }
+ *
+ * Builds the indexes and ends the session. If this fails, for example on a duplicate key, the
+ * collection is dropped.
+ */
+class CommitBulkLoadCmd : public BulkLoadCommand {
+public:
+    CommitBulkLoadCmd() : BulkLoadCommand("commitBulkLoad") {}
+
+    void help(std::stringstream& help) const override {
+        help << "builds the indexes of a collection created by beginBulkLoad\n"
+                "{ commitBulkLoad: <collection>, bulkLoadId: <id> }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        long long id;
+        auto session = uassertStatusOK(checkOutSession(nss, cmdObj, &id));
+        Status status = session.loader->commit();
+        if (!status.isOK()) {
+            abortSession(opCtx, std::move(session));
+            return appendCommandStatus(result, status);
+        }
+
+        // Release the loader's collection lock before building the remaining indexes.
+        session.loader.reset();
+
+        status = finishCommittedLoad(opCtx, session);
+        if (!status.isOK()) {
+            dropLoadedCollection(opCtx, nss);
+            return appendCommandStatus(result, status);
+        }
+
+        log() << "Committed bulk load " << id << " of " << nss.ns();
+        return true;
+    }
+
+private:
+    static Status finishCommittedLoad(OperationContext* opCtx,
+                                      const BulkLoadRegistry::Session& session) {
+        DBDirectClient client(opCtx);
+
+        const long long numRecords = client.count(session.nss.ns());
+        if (numRecords != session.numInserted) {
+            return {ErrorCodes::DuplicateKey,
+                    str::stream() << "bulk load of " << session.nss.ns() << " discarded "
+                                  << (session.numInserted - numRecords)
+                                  << " documents with duplicate _id values"};
+        }
+
+        if (session.deferredIndexSpecs.empty()) {
+            return Status::OK();
+        }
+
+        BSONObj info;
+        client.runCommand(session.nss.db().toString(),
+                          BSON("createIndexes" << session.nss.coll() << "indexes"
+                                               << session.deferredIndexSpecs),
+                          info);
+        return getStatusFromCommandResult(info);
+    }
+};
+
+/**
+ * { abortBulkLoad: <collection>, bulkLoadId: <id> }
+ *
+ * Ends the session and drops the collection.
+ */
+class AbortBulkLoadCmd : public BulkLoadCommand {
+public:
+    AbortBulkLoadCmd() : BulkLoadCommand("abortBulkLoad") {}
+
+    void help(std::stringstream& help) const override {
+        help << "drops a collection created by beginBulkLoad which was not committed\n"
+                "{ abortBulkLoad: <collection>, bulkLoadId: <id> }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        long long id;
+        auto session = uassertStatusOK(checkOutSession(nss, cmdObj, &id));
+        abortSession(opCtx, std::move(session));
+
+        log() << "Aborted bulk load " << id << " of " << nss.ns();
+        return true;
+    }
+};
+
+MONGO_INITIALIZER(RegisterBulkLoadCommands)(InitializerContext* context) {
+    new BeginBulkLoadCmd();
+    new BulkLoadInsertCmd();
+    new CommitBulkLoadCmd();
+    new AbortBulkLoadCmd();
+    return Status::OK();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/bulk_load_registry.h"
+
+#include <vector>
+
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+BulkLoadRegistry* BulkLoadRegistry::get() {
+    static BulkLoadRegistry* const registry = new BulkLoadRegistry();
+    return registry;
+}
+
+StatusWith<long long> BulkLoadRegistry::add(Session session) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_shutdown) {
+        return {ErrorCodes::ShutdownInProgress, "cannot begin a bulk load during shutdown"};
+    }
+    const long long id = _nextId++;
+    _sessions.emplace(id, std::move(session));
+    return id;
+}
+
+StatusWith<BulkLoadRegistry::Session> BulkLoadRegistry::checkOut(long long id,
+                                                                   const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _sessions.find(id);
+    if (it == _sessions.end() || it->second.nss != nss) {
+        return {ErrorCodes::NoSuchSession,
+                str::stream() << "no bulk load " << id << " on " << nss.ns()
+                              << " is available; it does not exist or is in use"};
+    }
+    Session session = std::move(it->second);
+    _sessions.erase(it);
+    return std::move(session);
+}
+
+void BulkLoadRegistry::checkIn(long long id, Session session) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_shutdown) {
+            _sessions.emplace(id, std::move(session));
+            return;
+        }
+    }
+    // Destroy the loader outside of the mutex, since that drops its unfinished indexes.
+    session.loader.reset();
+}
+
+void BulkLoadRegistry::abortAll() {
+    std::vector<Session> sessions;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown = true;
+        for (auto&& entry : _sessions) {
+            sessions.push_back(std::move(entry.second));
+        }
+        _sessions.clear();
+    }
+    for (auto&& session : sessions) {
+        log() << "Aborting unfinished bulk load of " << session.nss.ns();
+        session.loader.reset();
+    }
+}
+
+}  // namespace mongo
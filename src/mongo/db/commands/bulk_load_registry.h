@@ -0,0 +1,107 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/collection_bulk_loader.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * Keeps the collection bulk loaders started by the beginBulkLoad command between the commands of
+ * a bulk load session. A loader builds the indexes of its collection on the side, the way initial
+ * sync does, so restoring a collection does not pay for per-document index maintenance.
+ *
+ * A session is checked out for the duration of each command, so that only one command at a time
+ * uses a given loader. Each loader holds an intent lock on its collection until it is committed
+ * or destroyed, which is why all remaining sessions are aborted before shutdown takes the global
+ * lock.
+ */
+class BulkLoadRegistry {
+    MONGO_DISALLOW_COPYING(BulkLoadRegistry);
+
+public:
+    using LoaderPtr = std::unique_ptr<repl::CollectionBulkLoader>;
+
+    struct Session {
+        NamespaceString nss;
+        LoaderPtr loader;
+
+        // Unique secondary indexes, which the loader does not enforce and which are therefore
+        // built once the load is committed.
+        std::vector<BSONObj> deferredIndexSpecs;
+
+        // The number of documents given to the loader, which silently discards documents with
+        // duplicate _id values.
+        long long numInserted = 0;
+    };
+
+    static BulkLoadRegistry* get();
+
+    /**
+     * Registers a new session and returns its id. Fails with ShutdownInProgress after abortAll().
+     */
+    StatusWith<long long> add(Session session);
+
+    /**
+     * Removes the session 'id' from the registry and hands it to the caller, who must either
+     * return it with checkIn() or dispose of it. Fails if there is no such session on 'nss', or if
+     * it is already checked out.
+     */
+    StatusWith<Session> checkOut(long long id, const NamespaceString& nss);
+
+    /**
+     * Returns a session previously obtained from checkOut(). The loader is destroyed instead if
+     * the registry has been shut down in the meantime.
+     */
+    void checkIn(long long id, Session session);
+
+    /**
+     * Destroys the loaders of all sessions which are not checked out and refuses new sessions.
+     * The collections being loaded are left behind with whatever was inserted so far.
+     */
+    void abortAll();
+
+private:
+    BulkLoadRegistry() = default;
+
+    stdx::mutex _mutex;
+    std::map<long long, Session> _sessions;
+    long long _nextId = 1;
+    bool _shutdown = false;
+};
+
+}  // namespace mongo
@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/base/status.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/column_projection_cache.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Common attributes of the commands which manage a collection's column projection cache. Like
+ * index filters, the cache is kept in the collection info cache of a single node, so these
+ * commands are not replicated and the cache does not survive a restart.
+ */
+class ColumnCacheCommand : public BasicCommand {
+public:
+    ColumnCacheCommand(StringData name, std::string helpText)
+        : BasicCommand(name), _helpText(std::move(helpText)) {}
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return false;
+    }
+
+    bool slaveOverrideOk() const override {
+        return true;
+    }
+
+    void help(std::stringstream& ss) const override {
+        ss << _helpText;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) override {
+        AuthorizationSession* authzSession = AuthorizationSession::get(client);
+        ResourcePattern pattern = parseResourcePattern(dbname, cmdObj);
+
+        if (authzSession->isAuthorizedForActionsOnResource(pattern,
+                                                           ActionType::planCacheIndexFilter)) {
+            return Status::OK();
+        }
+
+        return Status(ErrorCodes::Unauthorized, "unauthorized");
+    }
+
+private:
+    const std::string _helpText;
+};
+
+/**
+ * { columnCacheSet: <collection>, fields: [<field1>, <field2>, ...] }
+ */
+class ColumnCacheSet : public ColumnCacheCommand {
+public:
+    ColumnCacheSet()
+        : ColumnCacheCommand("columnCacheSet",
+                             "Caches the values of the given top-level fields of every document "
+                             "in a collection so that queries only using those fields can avoid "
+                             "reading whole documents. Replaces any existing cache.") {}
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        BSONElement fieldsElt = cmdObj["fields"];
+        if (fieldsElt.type() != Array) {
+            return appendCommandStatus(
+                result, Status(ErrorCodes::TypeMismatch, "'fields' must be an array of strings"));
+        }
+
+        std::vector<std::string> fields;
+        for (auto&& elt : fieldsElt.Obj()) {
+            if (elt.type() != String) {
+                return appendCommandStatus(
+                    result,
+                    Status(ErrorCodes::TypeMismatch, "'fields' must be an array of strings"));
+            }
+            fields.push_back(elt.str());
+        }
+
+        Status status = ColumnProjectionCache::validateFields(fields);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+
+        // Populating the cache requires that no writes happen until it is published.
+        AutoGetCollection autoColl(opCtx, nss, MODE_IX, MODE_X);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return appendCommandStatus(result,
+                                       Status(ErrorCodes::NamespaceNotFound, "no such collection"));
+        }
+        if (collection->isCapped()) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::InvalidOptions,
+                       "capped collections do not support column projection caches"));
+        }
+
+        auto cache = std::make_shared<ColumnProjectionCache>(
+            std::move(fields),
+            static_cast<size_t>(internalQueryColumnProjectionCacheMaxBytes.load()));
+
+        auto cursor = collection->getCursor(opCtx);
+        while (auto record = cursor->next()) {
+            cache->addInitialDocument(record->data.toBson());
+            if (!cache->isValid()) {
+                return appendCommandStatus(
+                    result,
+                    Status(ErrorCodes::ExceededMemoryLimit,
+                           "collection does not fit within "
+                           "internalQueryColumnProjectionCacheMaxBytes, or has a document "
+                           "without an _id"));
+            }
+        }
+
+        CollectionInfoCache* infoCache = collection->infoCache();
+        infoCache->setColumnProjectionCache(cache);
+
+        // Plans cached before this point never consider the cache.
+        infoCache->clearQueryCache();
+
+        LOG(0) << "Built column projection cache on " << nss.ns() << " for "
+               << cache->numDocuments() << " documents using " << cache->dataBytes()
+               << " bytes";
+
+        BSONObjBuilder infoBuilder(result.subobjStart("columnCache"));
+        cache->appendInfo(&infoBuilder);
+        infoBuilder.doneFast();
+        return true;
+    }
+};
+
+/**
+ * { columnCacheClear: <collection> }
+ */
+class ColumnCacheClear : public ColumnCacheCommand {
+public:
+    ColumnCacheClear()
+        : ColumnCacheCommand("columnCacheClear",
+                             "Drops a collection's column projection cache, if it has one.") {}
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        AutoGetCollection autoColl(opCtx, nss, MODE_IX, MODE_X);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            // No collection - do nothing.
+            return true;
+        }
+
+        CollectionInfoCache* infoCache = collection->infoCache();
+        if (infoCache->getColumnProjectionCache()) {
+            infoCache->setColumnProjectionCache(nullptr);
+            infoCache->clearQueryCache();
+            LOG(0) << "Dropped column projection cache on " << nss.ns();
+        }
+        return true;
+    }
+};
+
+MONGO_INITIALIZER(RegisterColumnCacheCommands)(InitializerContext* context) {
+    new ColumnCacheSet();
+    new ColumnCacheClear();
+    return Status::OK();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -39,20 +39,135 @@
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_builder.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
+#include "mongo/util/progress_meter.h"
 
 namespace mongo {
 
 using std::string;
 using std::stringstream;
 
+namespace {
+
+// An online compact compacts the record store and each index of the collection in passes of about
+// this many seconds, holding only intent locks, and releases its locks between passes.
+MONGO_EXPORT_SERVER_PARAMETER(compactOnlineTimeSliceSecs, int, 1);
+
+// How long an online compact sleeps between passes, so that it does not compete with the workload
+// for I/O without a break.
+MONGO_EXPORT_SERVER_PARAMETER(compactOnlineThrottleMillis, int, 100);
+
+/**
+ * Compacts the collection 'nss' in place under intent locks. The record store and then each ready
+ * index are compacted in bounded passes, with the locks released, the operation checked for
+ * interruption and a throttling sleep between passes. Reads and writes to the collection proceed
+ * meanwhile against their own snapshots, since compacting in place only moves blocks within the
+ * files. Fills in the number of passes and of indexes compacted in 'result'.
+ */
+Status compactOnline(OperationContext* opCtx,
+                     const NamespaceString& nss,
+                     CompactOptions* compactOptions,
+                     BSONObjBuilder* result) {
+    std::vector<std::string> indexNames;
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return {ErrorCodes::NamespaceNotFound, "collection does not exist"};
+        }
+        if (!collection->getRecordStore()->compactSupported() ||
+            !collection->getRecordStore()->compactsInPlace()) {
+            return {ErrorCodes::CommandNotSupported,
+                    str::stream() << "cannot compact collection online with record store: "
+                                  << collection->getRecordStore()->name()};
+        }
+        BackgroundOperation::assertNoBgOpInProgForNs(nss.ns());
+
+        IndexCatalog::IndexIterator ii =
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (ii.more()) {
+            indexNames.push_back(ii.next()->indexName());
+        }
+    }
+
+    compactOptions->timeLimit = Seconds(std::max(1, compactOnlineTimeSliceSecs.load()));
+    log() << "compact " << nss.ns() << " online begin, options: " << *compactOptions;
+
+    stdx::unique_lock<Client> lk(*opCtx->getClient());
+    ProgressMeterHolder pm(CurOp::get(opCtx)->setMessage_inlock(
+        "compact online", "Online Compaction Progress", indexNames.size() + 1));
+    lk.unlock();
+
+    long long passes = 0;
+    long long indexesCompacted = 0;
+
+    // An empty name stands for the record store, which is compacted first.
+    indexNames.insert(indexNames.begin(), std::string());
+    for (const auto& indexName : indexNames) {
+        while (true) {
+            ++passes;
+            Status status = Status::OK();
+            {
+                AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+                Collection* collection = autoColl.getCollection();
+                if (!collection) {
+                    return {ErrorCodes::NamespaceNotFound,
+                            "collection was dropped during online compact"};
+                }
+
+                if (indexName.empty()) {
+                    CompactStats stats;
+                    status = collection->getRecordStore()->compact(
+                        opCtx, nullptr, compactOptions, &stats);
+                } else {
+                    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+                    IndexDescriptor* descriptor = indexCatalog->findIndexByName(opCtx, indexName);
+                    if (!descriptor) {
+                        // The index was dropped since the compact began, so there is nothing left
+                        // to reclaim for it.
+                        break;
+                    }
+                    LOG(1) << "compacting index online: " << descriptor->toString();
+                    status = indexCatalog->getIndex(descriptor)->compact(opCtx, compactOptions);
+                    if (status.isOK()) {
+                        ++indexesCompacted;
+                    }
+                }
+            }
+
+            if (status.isOK()) {
+                break;
+            }
+            if (status != ErrorCodes::ExceededTimeLimit) {
+                return status;
+            }
+
+            opCtx->checkForInterrupt();
+            opCtx->sleepFor(Milliseconds(std::max(0, compactOnlineThrottleMillis.load())));
+        }
+        pm.hit();
+    }
+    pm.finished();
+
+    result->append("passes", passes);
+    result->append("indexesCompacted", indexesCompacted);
+    log() << "compact " << nss.ns() << " online end";
+    return Status::OK();
+}
+
+}  // namespace
+
 class CompactCmd : public ErrmsgCommandDeprecated {
 public:
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -79,8 +194,10 @@ public:
                 "warning: this operation locks the database and is slow. you can cancel with "
                 "killOp()\n"
                 "{ compact : <collection_name>, [force:<bool>], [validate:<bool>],\n"
-                "  [paddingFactor:<num>], [paddingBytes:<num>] }\n"
+                "  [paddingFactor:<num>], [paddingBytes:<num>], [online:<bool>] }\n"
                 "  force - allows to run on a replica set primary\n"
+                "  online - compact in place in bounded passes under intent locks, without "
+                "blocking other operations on the database. allowed on a primary\n"
                 "  validate - check records are noncorrupt before adding to newly compacting "
                 "extents. slower but safer (defaults to true in this version)\n";
     }
@@ -92,9 +209,10 @@ public:
                            string& errmsg,
                            BSONObjBuilder& result) {
         NamespaceString nss = parseNsCollectionRequired(db, cmdObj);
+        const bool online = cmdObj["online"].trueValue();
 
         repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue() && !online) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
@@ -143,6 +261,10 @@ public:
         if (cmdObj.hasElement("validate"))
             compactOptions.validateDocuments = cmdObj["validate"].trueValue();
 
+        if (online) {
+            return appendCommandStatus(result, compactOnline(opCtx, nss, &compactOptions, &result));
+        }
+
         AutoGetDb autoDb(opCtx, db, MODE_X);
         Database* const collDB = autoDb.getDb();
 
@@ -0,0 +1,191 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/cursor_prefetcher.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/cursor_manager.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+// static
+const size_t CursorPrefetcher::kMaxConcurrentPrefetches;
+
+namespace {
+
+/**
+ * Returns the pool running all prefetches. The pool is never shut down, so that it remains usable
+ * until the process exits.
+ */
+ThreadPool* getPrefetchPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "GetMorePrefetch";
+        options.minThreads = 0;
+        options.maxThreads = CursorPrefetcher::kMaxConcurrentPrefetches;
+        options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
+}  // namespace
+
+CursorPrefetcher* CursorPrefetcher::get() {
+    static CursorPrefetcher* const prefetcher = new CursorPrefetcher();
+    return prefetcher;
+}
+
+bool CursorPrefetcher::canPrefetch(OperationContext* opCtx, const ClientCursor& cursor) {
+    return internalQueryGetMorePrefetchMaxBytes.load() > 0 && !cursor.isTailable() &&
+        !cursor.getSessionId() && !opCtx->getClient()->isInDirectClient() &&
+        cursor.getExecutor()->numStashedResults() == 0;
+}
+
+bool CursorPrefetcher::reserve(CursorId cursorId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_inProgress.size() >= kMaxConcurrentPrefetches || _inProgress.count(cursorId)) {
+        return false;
+    }
+    _inProgress.insert(cursorId);
+    return true;
+}
+
+void CursorPrefetcher::schedule(const NamespaceString& nss,
+                                CursorId cursorId,
+                                long long batchSize) {
+    auto status = getPrefetchPool()->schedule([this, nss, cursorId, batchSize] {
+        _prefetch(nss, cursorId, batchSize);
+        _finish(cursorId);
+    });
+    if (!status.isOK()) {
+        _finish(cursorId);
+    }
+}
+
+void CursorPrefetcher::waitFor(OperationContext* opCtx, CursorId cursorId) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    opCtx->waitForConditionOrInterrupt(
+        _prefetchFinished, lk, [&] { return !_inProgress.count(cursorId); });
+}
+
+void CursorPrefetcher::_finish(CursorId cursorId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _inProgress.erase(cursorId);
+    _prefetchFinished.notify_all();
+}
+
+void CursorPrefetcher::_prefetch(const NamespaceString& nss,
+                                 CursorId cursorId,
+                                 long long batchSize) {
+    auto opCtx = cc().makeOperationContext();
+    try {
+        AutoGetCollectionForRead readLock(opCtx.get(), nss);
+        Collection* collection = readLock.getCollection();
+        if (!collection) {
+            return;
+        }
+
+        auto ccPin = collection->getCursorManager()->pinCursor(opCtx.get(), cursorId);
+        if (!ccPin.isOK()) {
+            return;
+        }
+
+        try {
+            _fillStash(opCtx.get(), ccPin.getValue().getCursor(), batchSize);
+        } catch (const DBException& ex) {
+            // The executor may be left attached to this operation, so the cursor cannot be used
+            // any further.
+            warning() << "Prefetching a batch of cursor " << cursorId << " on " << nss.ns()
+                      << " failed: " << redact(ex.toStatus());
+            ccPin.getValue().deleteUnderlying();
+        }
+    } catch (const DBException& ex) {
+        LOG(1) << "Could not prefetch a batch of cursor " << cursorId << " on " << nss.ns() << ": "
+               << redact(ex.toStatus());
+    }
+}
+
+void CursorPrefetcher::_fillStash(OperationContext* opCtx,
+                                  ClientCursor* cursor,
+                                  long long batchSize) {
+    if (cursor->isReadCommitted())
+        uassertStatusOK(opCtx->recoveryUnit()->setReadFromMajorityCommittedSnapshot());
+
+    PlanExecutor* exec = cursor->getExecutor();
+    exec->reattachToOperationContext(opCtx);
+    if (!exec->restoreState().isOK()) {
+        // The next getMore reports the reason the cursor can no longer be restored.
+        exec->detachFromOperationContext();
+        return;
+    }
+
+    // Results can only be appended to the stash in order if it starts out empty.
+    if (exec->numStashedResults() == 0) {
+        const long long maxBytes = internalQueryGetMorePrefetchMaxBytes.load();
+        long long numResults = 0;
+        long long bytes = 0;
+        BSONObj obj;
+        PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+        while (!FindCommon::enoughForGetMore(batchSize, numResults) && bytes < maxBytes &&
+               PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
+            exec->enqueue(obj);
+            bytes += obj.objsize();
+            numResults++;
+        }
+
+        // The documents of an error are not results, so report it through the next getMore
+        // instead.
+        if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+            exec->markAsKilled(str::stream() << "prefetching the next batch failed: "
+                                             << WorkingSetCommon::toStatusString(obj));
+        }
+    }
+
+    exec->saveState();
+    exec->detachFromOperationContext();
+}
+
+}  // namespace mongo
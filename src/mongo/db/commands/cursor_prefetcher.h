@@ -0,0 +1,103 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/cursor_id.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_set.h"
+
+namespace mongo {
+
+class ClientCursor;
+class OperationContext;
+
+/**
+ * Builds the next batch of a cursor in the background once a getMore has returned, so that a
+ * client iterating a large result set finds each batch ready rather than waiting for it. The
+ * prefetched documents are queued in the cursor's PlanExecutor, from which the next getMore takes
+ * them before running the plan any further.
+ *
+ * A prefetch pins its cursor, so getMore and killCursors must wait for any prefetch of a cursor to
+ * finish before pinning or killing it themselves. They wait before taking any locks, since a
+ * prefetch may be queued for its collection lock behind a conflicting request.
+ *
+ * This class is thread-safe.
+ */
+class CursorPrefetcher {
+    MONGO_DISALLOW_COPYING(CursorPrefetcher);
+
+public:
+    // Prefetches beyond this many are skipped rather than queued.
+    static const size_t kMaxConcurrentPrefetches = 16;
+
+    CursorPrefetcher() = default;
+
+    static CursorPrefetcher* get();
+
+    /**
+     * Returns whether a batch of 'cursor' may be prefetched. Only cursors of a single collection
+     * which are used outside a session and only ever end at EOF qualify.
+     */
+    static bool canPrefetch(OperationContext* opCtx, const ClientCursor& cursor);
+
+    /**
+     * Registers a prefetch of the cursor 'cursorId', so that getMores of it wait from now on.
+     * Returns false if the prefetch should be skipped. Must be called while the cursor is still
+     * pinned by the getMore which returned its last batch, and followed by schedule() once the
+     * pin is released.
+     */
+    bool reserve(CursorId cursorId);
+
+    /**
+     * Starts prefetching up to 'batchSize' documents of the reserved cursor 'cursorId' on 'nss',
+     * where a 'batchSize' of 0 means no limit other than the memory budget.
+     */
+    void schedule(const NamespaceString& nss, CursorId cursorId, long long batchSize);
+
+    /**
+     * Waits until no prefetch of the cursor 'cursorId' is in progress.
+     */
+    void waitFor(OperationContext* opCtx, CursorId cursorId);
+
+private:
+    void _finish(CursorId cursorId);
+
+    static void _prefetch(const NamespaceString& nss, CursorId cursorId, long long batchSize);
+
+    static void _fillStash(OperationContext* opCtx, ClientCursor* cursor, long long batchSize);
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _prefetchFinished;
+    stdx::unordered_set<CursorId> _inProgress;
+};
+
+}  // namespace mongo
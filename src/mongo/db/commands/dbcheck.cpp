@@ -42,6 +42,11 @@
 #include "mongo/db/repl/dbcheck.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/background.h"
 
 #include "mongo/util/log.h"
@@ -49,9 +54,13 @@
 namespace mongo {
 
 namespace {
-constexpr uint64_t kBatchDocs = 5'000;
-constexpr uint64_t kBatchBytes = 20'000'000;
+constexpr int64_t kBatchDocs = 5'000;
+constexpr int64_t kMinBatchDocs = 100;
+constexpr int64_t kBatchBytes = 20'000'000;
 
+// Batches shrink while the majority commit point is more than this many seconds behind the last
+// batch, so that secondaries recomputing the batches can keep up.
+MONGO_EXPORT_SERVER_PARAMETER(dbCheckMaxReplicationLagSecs, int, 1);
 
 /**
  * All the information needed to run dbCheck on a single collection.
@@ -62,13 +71,66 @@ struct DbCheckCollectionInfo {
     BSONKey end;
     int64_t maxCount;
     int64_t maxSize;
-    int64_t maxRate;
 };
 
 /**
- * A run of dbCheck consists of a series of collections.
+ * A run of dbCheck consists of a series of collections, checked up to `maxConcurrency` at a time
+ * and at no more than `maxRate` documents per second in total.
  */
-using DbCheckRun = std::vector<DbCheckCollectionInfo>;
+struct DbCheckRun {
+    std::vector<DbCheckCollectionInfo> collections;
+    int64_t maxConcurrency = 1;
+    int64_t maxRate = std::numeric_limits<int64_t>::max();
+};
+
+/**
+ * Limits the rate of a dbCheck run over all of the threads checking its collections.
+ */
+class DbCheckRateLimiter {
+public:
+    explicit DbCheckRateLimiter(int64_t maxRate) : _maxRate(maxRate) {}
+
+    /**
+     * Accounts for `docs` documents having been checked, and sleeps if that exceeds the rate.
+     */
+    void consume(int64_t docs) {
+        using namespace std::literals::chrono_literals;
+
+        if (_maxRate <= 0) {
+            return;
+        }
+
+        TimePoint sleepUntil;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (Clock::now() - _intervalStart > 1s) {
+                _intervalStart = Clock::now();
+                _docsInInterval = 0;
+            }
+
+            _docsInInterval += docs;
+            if (_docsInInterval <= _maxRate) {
+                return;
+            }
+
+            // If an extremely low max rate has been set (substantially smaller than the batch
+            // size) we might want to sleep for multiple seconds between batches.
+            int64_t timesExceeded = _docsInInterval / _maxRate;
+            sleepUntil = _intervalStart + timesExceeded * 1s;
+        }
+        stdx::this_thread::sleep_until(sleepUntil);
+    }
+
+private:
+    using Clock = stdx::chrono::system_clock;
+    using TimePoint = stdx::chrono::time_point<Clock>;
+
+    const int64_t _maxRate;
+
+    stdx::mutex _mutex;
+    TimePoint _intervalStart = Clock::now();
+    int64_t _docsInInterval = 0;
+};
 
 /**
  * Check if dbCheck can run on the given namespace.
@@ -113,10 +175,10 @@ std::unique_ptr<DbCheckRun> singleCollectionRun(OperationContext* opCtx,
     auto end = invocation.getMaxKey();
     auto maxCount = invocation.getMaxCount();
     auto maxSize = invocation.getMaxSize();
-    auto maxRate = invocation.getMaxCountPerSecond();
-    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize, maxRate};
+    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize};
     auto result = stdx::make_unique<DbCheckRun>();
-    result->push_back(info);
+    result->collections.push_back(info);
+    result->maxRate = invocation.getMaxCountPerSecond();
     return result;
 }
 
@@ -133,14 +195,19 @@ std::unique_ptr<DbCheckRun> fullDatabaseRun(OperationContext* opCtx,
 
     uassert(ErrorCodes::NamespaceNotFound, "Database " + dbName + " not found", agd.getDb());
 
+    uassert(40657,
+            "maxConcurrentCollections must be positive",
+            invocation.getMaxConcurrentCollections() > 0);
+
     int64_t max = std::numeric_limits<int64_t>::max();
-    auto rate = invocation.getMaxCountPerSecond();
 
     for (Collection* coll : *db) {
-        DbCheckCollectionInfo info{coll->ns(), BSONKey::min(), BSONKey::max(), max, max, rate};
-        result->push_back(info);
+        DbCheckCollectionInfo info{coll->ns(), BSONKey::min(), BSONKey::max(), max, max};
+        result->collections.push_back(info);
     }
 
+    result->maxConcurrency = invocation.getMaxConcurrentCollections();
+    result->maxRate = invocation.getMaxCountPerSecond();
     return result;
 }
 
@@ -176,11 +243,18 @@ std::unique_ptr<DbCheckRun> getRun(OperationContext* opCtx,
 
 /**
  * The BackgroundJob in which dbCheck actually executes on the primary.
+ *
+ * Collections are handed out to up to `maxConcurrency` threads, each with its own client. No locks
+ * are held between batches; each batch hashes its documents and logs its oplog entry under the
+ * collection lock, so that secondaries recompute it at the same point in time.
  */
 class DbCheckJob : public BackgroundJob {
 public:
     DbCheckJob(const StringData& dbName, std::unique_ptr<DbCheckRun> run)
-        : BackgroundJob(true), _done(false), _dbName(dbName.toString()), _run(std::move(run)) {}
+        : BackgroundJob(true),
+          _dbName(dbName.toString()),
+          _run(std::move(run)),
+          _rateLimiter(_run->maxRate) {}
 
 protected:
     virtual std::string name() const override {
@@ -191,31 +265,58 @@ protected:
         // Every dbCheck runs in its own client.
         Client::initThread(name());
 
-        for (const auto& coll : *_run) {
+        const auto numThreads = std::min(_run->maxConcurrency,
+                                         static_cast<int64_t>(_run->collections.size()));
+        std::vector<stdx::thread> threads;
+        for (int64_t i = 1; i < numThreads; i++) {
+            threads.emplace_back([this, i] {
+                Client::initThread(str::stream() << name() << "-" << i);
+                _doCollections();
+            });
+        }
+
+        _doCollections();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (_done.load()) {
+            log() << "dbCheck terminated due to stepdown";
+        }
+    }
+
+private:
+    /**
+     * Checks collections of the run until there are none left or the run has to stop.
+     */
+    void _doCollections() {
+        while (!_done.load() && !_failed.load()) {
+            const auto next = _nextCollection.fetchAndAdd(1);
+            if (next >= _run->collections.size()) {
+                return;
+            }
+
+            const auto& coll = _run->collections[next];
             try {
                 _doCollection(coll);
             } catch (const DBException& e) {
                 auto logEntry = dbCheckErrorHealthLogEntry(
                     coll.nss, "dbCheck failed", OplogEntriesEnum::Batch, e.toStatus());
                 HealthLog::get(Client::getCurrent()->getServiceContext()).log(*logEntry);
-                return;
-            }
-
-            if (_done) {
-                log() << "dbCheck terminated due to stepdown";
+                _failed.store(true);
                 return;
             }
         }
     }
 
-private:
     void _doCollection(const DbCheckCollectionInfo& info) {
         // If we can't find the collection, abort the check.
         if (!_getCollectionMetadata(info)) {
             return;
         }
 
-        if (_done) {
+        if (_done.load()) {
             return;
         }
 
@@ -227,23 +328,12 @@ private:
         int64_t totalBytesSeen = 0;
         int64_t totalDocsSeen = 0;
 
-        // Limit the rate of the check.
-        using Clock = stdx::chrono::system_clock;
-        using TimePoint = stdx::chrono::time_point<Clock>;
-        TimePoint lastStart = Clock::now();
-        int64_t docsInCurrentInterval = 0;
+        int64_t batchDocs = kBatchDocs;
 
         do {
-            using namespace std::literals::chrono_literals;
-
-            if (Clock::now() - lastStart > 1s) {
-                lastStart = Clock::now();
-                docsInCurrentInterval = 0;
-            }
+            auto result = _runBatch(info, start, batchDocs, kBatchBytes);
 
-            auto result = _runBatch(info, start, kBatchDocs, kBatchBytes);
-
-            if (_done) {
+            if (_done.load()) {
                 return;
             }
 
@@ -274,7 +364,6 @@ private:
             // Update our running totals.
             totalDocsSeen += stats.nDocs;
             totalBytesSeen += stats.nBytes;
-            docsInCurrentInterval += stats.nDocs;
 
             // Check if we've exceeded any limits.
             bool reachedLast = stats.lastKey >= info.end;
@@ -282,16 +371,30 @@ private:
             bool tooManyBytes = totalBytesSeen >= info.maxSize;
             reachedEnd = reachedLast || tooManyDocs || tooManyBytes;
 
-            if (docsInCurrentInterval > info.maxRate && info.maxRate > 0) {
-                // If an extremely low max rate has been set (substantially smaller than the batch
-                // size) we might want to sleep for multiple seconds between batches.
-                int64_t timesExceeded = docsInCurrentInterval / info.maxRate;
-
-                stdx::this_thread::sleep_for(timesExceeded * 1s - (Clock::now() - lastStart));
-            }
+            batchDocs = _nextBatchDocs(batchDocs, stats.time);
+            _rateLimiter.consume(stats.nDocs);
         } while (!reachedEnd);
     }
 
+    /**
+     * Halves the batch size while the majority commit point lags the batch logged at `batchTime`
+     * by more than dbCheckMaxReplicationLagSecs, and grows it back to kBatchDocs otherwise.
+     */
+    int64_t _nextBatchDocs(int64_t batchDocs, const repl::OpTime& batchTime) {
+        auto coord = repl::ReplicationCoordinator::get(Client::getCurrent()->getServiceContext());
+        auto committed = coord->getLastCommittedOpTime();
+
+        const auto batchSecs = batchTime.getTimestamp().getSecs();
+        const auto committedSecs = committed.getTimestamp().getSecs();
+        const bool lagging = committed < batchTime &&
+            batchSecs - committedSecs > static_cast<unsigned>(dbCheckMaxReplicationLagSecs.load());
+
+        if (lagging) {
+            return std::max(kMinBatchDocs, batchDocs / 2);
+        }
+        return std::min(kBatchDocs, batchDocs + kMinBatchDocs);
+    }
+
     /**
      * For organizing the results of batches.
      */
@@ -303,10 +406,15 @@ private:
         repl::OpTime time;
     };
 
-    // Set if the job cannot proceed.
-    bool _done;
+    // Set if the job cannot proceed because of a stepdown.
+    AtomicWord<bool> _done{false};
+    // Set if checking a collection failed; the run stops.
+    AtomicWord<bool> _failed{false};
     std::string _dbName;
     std::unique_ptr<DbCheckRun> _run;
+    DbCheckRateLimiter _rateLimiter;
+    // Index in _run->collections of the next collection to check.
+    AtomicWord<size_t> _nextCollection{0};
 
     bool _getCollectionMetadata(const DbCheckCollectionInfo& info) {
         auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
@@ -317,7 +425,7 @@ private:
         AutoGetDbForDbCheck agd(opCtx, info.nss);
 
         if (_stepdownHasOccurred(opCtx, info.nss)) {
-            _done = true;
+            _done.store(true);
             return true;
         }
 
@@ -387,7 +495,7 @@ private:
         AutoGetCollectionForDbCheck agc(opCtx, info.nss, OplogEntriesEnum::Batch);
 
         if (_stepdownHasOccurred(opCtx, info.nss)) {
-            _done = true;
+            _done.store(true);
             return Status(ErrorCodes::PrimarySteppedDown, "dbCheck terminated due to stepdown");
         }
 
@@ -498,7 +606,10 @@ public:
              << "              maxSize: <max size of docs>,\n"
              << "              maxCountPerSecond: <max rate in docs/sec> } "
              << "to check a collection.\n"
-             << "Invoke with {dbCheck: 1} to check all collections in the database.";
+             << "Invoke with {dbCheck: 1,\n"
+             << "             maxCountPerSecond: <max rate in docs/sec>,\n"
+             << "             maxConcurrentCollections: <collections to check at once> } "
+             << "to check all collections in the database.";
     }
 
     virtual Status checkAuthForCommand(Client* client,
@@ -35,25 +35,78 @@
 #include <map>
 #include <string>
 
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_content_hash.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/timer.h"
+#include "mongo/util/xxhash.h"
 
 namespace mongo {
 
 namespace {
 
+/**
+ * Accumulates the hash of a collection or of the whole database. Defaults to md5; xxhash64 is the
+ * fast alternative for consistency checks over large data sets, where md5 is the bottleneck.
+ */
+class DBHasher {
+public:
+    enum class Algorithm { kMD5, kXXHash64 };
+
+    static constexpr StringData kMD5Name = "md5"_sd;
+    static constexpr StringData kXXHash64Name = "xxhash64"_sd;
+
+    explicit DBHasher(Algorithm algorithm) : _algorithm(algorithm) {
+        md5_init(&_md5State);
+    }
+
+    void update(const void* buf, size_t len) {
+        if (_algorithm == Algorithm::kXXHash64) {
+            _xxhashState.update(buf, len);
+        } else {
+            md5_append(&_md5State, static_cast<const md5_byte_t*>(buf), len);
+        }
+    }
+
+    std::string finish() {
+        if (_algorithm == Algorithm::kXXHash64) {
+            char digest[sizeof(uint64_t)];
+            DataView(digest).write<BigEndian<uint64_t>>(_xxhashState.digest());
+            return toHexLower(digest, sizeof(digest));
+        }
+
+        md5digest d;
+        md5_finish(&_md5State, d);
+        return digestToString(d);
+    }
+
+private:
+    const Algorithm _algorithm;
+    md5_state_t _md5State;
+    XXHash64 _xxhashState;
+};
+
+constexpr StringData DBHasher::kMD5Name;
+constexpr StringData DBHasher::kXXHash64Name;
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -94,15 +147,56 @@ public:
             }
         }
 
+        HashOptions options;
+        StringData algorithmName = DBHasher::kMD5Name;
+        if (auto algorithmElem = cmdObj["hashAlgorithm"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "hashAlgorithm must be a string",
+                    algorithmElem.type() == String);
+            algorithmName = algorithmElem.valueStringData();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Unknown hashAlgorithm '" << algorithmName << "', expected '"
+                                  << DBHasher::kMD5Name
+                                  << "' or '"
+                                  << DBHasher::kXXHash64Name
+                                  << "'",
+                    algorithmName == DBHasher::kMD5Name ||
+                        algorithmName == DBHasher::kXXHash64Name);
+            if (algorithmName == DBHasher::kXXHash64Name) {
+                options.algorithm = DBHasher::Algorithm::kXXHash64;
+            }
+        }
+
+        if (auto incrementalElem = cmdObj["incremental"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "incremental must be a boolean",
+                    incrementalElem.isBoolean());
+            options.incremental = incrementalElem.boolean();
+        }
+
+        int parallel = 1;
+        if (auto parallelElem = cmdObj["parallel"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "parallel must be a number",
+                    parallelElem.isNumber());
+            parallel = parallelElem.numberInt();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "parallel must be between 1 and " << kMaxParallel,
+                    parallel >= 1 && parallel <= kMaxParallel);
+        }
+
         const std::string ns = parseNs(dbname, cmdObj);
         uassert(ErrorCodes::InvalidNamespace,
                 str::stream() << "Invalid db name: " << ns,
                 NamespaceString::validDBName(ns, NamespaceString::DollarInDbNameBehavior::Allow));
 
-        // We lock the entire database in S-mode in order to ensure that the contents will not
-        // change for the snapshot.
-        AutoGetDb autoDb(opCtx, ns, MODE_S);
-        Database* db = autoDb.getDb();
+        // By default we lock the entire database in S-mode in order to ensure that the contents
+        // will not change for the snapshot. In parallel mode each collection is instead hashed
+        // under its own read lock, so writes to the rest of the database can proceed, but the
+        // collections are not hashed as of a single point in time.
+        boost::optional<AutoGetDb> autoDb;
+        autoDb.emplace(opCtx, ns, parallel > 1 ? MODE_IS : MODE_S);
+        Database* db = autoDb->getDb();
         std::list<std::string> colls;
         if (db) {
             db->getDatabaseCatalogEntry()->getCollectionNamespaces(&colls);
@@ -111,9 +205,6 @@ public:
 
         result.append("host", prettyHostName());
 
-        md5_state_t globalState;
-        md5_init(&globalState);
-
         // A set of 'system' collections that are replicated, and therefore included in the db hash.
         const std::set<StringData> replicatedSystemCollections{"system.backup_users",
                                                                "system.js",
@@ -123,8 +214,7 @@ public:
                                                                "system.version",
                                                                "system.views"};
 
-
-        BSONObjBuilder bb(result.subobjStart("collections"));
+        std::vector<NamespaceString> toHash;
         for (const auto& collectionName : colls) {
 
             NamespaceString collNss(collectionName);
@@ -148,34 +238,169 @@ public:
             if (collNss.isDropPendingNamespace())
                 continue;
 
-            // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss.toString());
+            toHash.push_back(std::move(collNss));
+        }
 
-            bb.append(collNss.coll(), hash);
-            md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
+        std::vector<std::string> hashes;
+        if (parallel > 1) {
+            autoDb.reset();
+            hashes = _hashCollectionsInParallel(opCtx, toHash, options, parallel);
+        } else {
+            for (const auto& collNss : toHash) {
+                std::string hash;
+                if (Collection* collection = db->getCollection(opCtx, collNss)) {
+                    hash = *_hashCollection(opCtx, collection, collNss, options, true);
+                }
+                hashes.push_back(std::move(hash));
+            }
         }
-        bb.done();
 
-        md5digest d;
-        md5_finish(&globalState, d);
-        std::string hash = digestToString(d);
+        DBHasher globalHasher(options.algorithm);
+        BSONObjBuilder bb(result.subobjStart("collections"));
+        for (size_t i = 0; i < toHash.size(); ++i) {
+            bb.append(toHash[i].coll(), hashes[i]);
+            globalHasher.update(hashes[i].c_str(), hashes[i].size());
+        }
+        bb.done();
 
-        result.append("md5", hash);
+        result.append(algorithmName, globalHasher.finish());
         result.appendNumber("timeMillis", timer.millis());
 
         return 1;
     }
 
 private:
-    std::string _hashCollection(OperationContext* opCtx,
-                                Database* db,
-                                const std::string& fullCollectionName) {
+    static const int kMaxParallel = 64;
+
+    struct HashOptions {
+        DBHasher::Algorithm algorithm = DBHasher::Algorithm::kMD5;
+
+        // Report the collection's incrementally maintained CollectionContentHash, seeding it if
+        // needed, instead of hashing a scan of the collection.
+        bool incremental = false;
+
+        // Set by the command when a parallel hash is interrupted, to stop the other workers.
+        const AtomicBool* stop = nullptr;
+    };
+
+    /**
+     * Hashes each of 'namespaces' on up to 'parallel' worker threads, each of which locks the
+     * collection it hashes. Returns the hashes in the same order as 'namespaces'.
+     */
+    std::vector<std::string> _hashCollectionsInParallel(
+        OperationContext* opCtx,
+        const std::vector<NamespaceString>& namespaces,
+        HashOptions options,
+        int parallel) {
+        if (namespaces.empty())
+            return {};
+
+        AtomicBool stop(false);
+        options.stop = &stop;
+
+        stdx::mutex mutex;
+        stdx::condition_variable doneCV;
+        size_t remaining = namespaces.size();
+        Status firstError = Status::OK();
+        std::vector<std::string> hashes(namespaces.size());
+
+        ThreadPool::Options poolOptions;
+        poolOptions.poolName = "dbHash";
+        poolOptions.minThreads = 0;
+        poolOptions.maxThreads = std::min(static_cast<size_t>(parallel), namespaces.size());
+        poolOptions.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+        ThreadPool pool(poolOptions);
+        pool.startup();
+
+        for (size_t i = 0; i < namespaces.size(); ++i) {
+            uassertStatusOK(pool.schedule([&, i] {
+                Status status = Status::OK();
+                if (!stop.load()) {
+                    auto workerOpCtx = cc().makeOperationContext();
+                    try {
+                        hashes[i] =
+                            _lockAndHashCollection(workerOpCtx.get(), namespaces[i], options);
+                    } catch (const DBException& ex) {
+                        status = ex.toStatus();
+                        stop.store(true);
+                    }
+                }
 
-        NamespaceString ns(fullCollectionName);
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (!status.isOK() && firstError.isOK()) {
+                    firstError = status;
+                }
+                if (--remaining == 0) {
+                    doneCV.notify_all();
+                }
+            }));
+        }
 
-        Collection* collection = db->getCollection(opCtx, ns);
+        try {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            opCtx->waitForConditionOrInterrupt(doneCV, lk, [&] { return remaining == 0; });
+        } catch (const DBException&) {
+            stop.store(true);
+            pool.shutdown();
+            pool.join();
+            throw;
+        }
+        pool.shutdown();
+        pool.join();
+
+        uassertStatusOK(firstError);
+        return hashes;
+    }
+
+    std::string _lockAndHashCollection(OperationContext* opCtx,
+                                       const NamespaceString& nss,
+                                       const HashOptions& options) {
+        {
+            AutoGetCollectionForRead autoColl(opCtx, nss);
+            Collection* collection = autoColl.getCollection();
+            if (!collection)
+                return "";
+
+            if (auto hash = _hashCollection(opCtx, collection, nss, options, false))
+                return *hash;
+        }
+
+        // Seeding the incremental hash needs to exclude writers until it is published.
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS, MODE_S);
+        Collection* collection = autoColl.getCollection();
         if (!collection)
             return "";
+        return _hashCollection(opCtx, collection, nss, options, true).get();
+    }
+
+    /**
+     * Returns the hash of 'collection'. In incremental mode with 'canSeed' false, returns
+     * boost::none if the collection's content hash must first be seeded, which requires the caller
+     * to hold a lock on the collection which excludes writers.
+     */
+    boost::optional<std::string> _hashCollection(OperationContext* opCtx,
+                                                 Collection* collection,
+                                                 const NamespaceString& nss,
+                                                 const HashOptions& options,
+                                                 bool canSeed) {
+        // The oplog is written without going through the collection's change tracking.
+        if (options.incremental && !nss.isOplog()) {
+            if (auto contentHash = collection->infoCache()->getContentHash())
+                return contentHash->toString();
+            if (!canSeed)
+                return boost::none;
+
+            // Since the hash is independent of the order of the documents, seed it from a
+            // collection scan rather than an _id index scan.
+            auto contentHash = std::make_shared<CollectionContentHash>();
+            auto exec = InternalPlanner::collectionScan(
+                opCtx, nss.ns(), collection, PlanExecutor::NO_YIELD);
+            _scan(exec.get(), nss, options, [&](const BSONObj& doc) {
+                contentHash->addInitialDocument(doc);
+            });
+            collection->infoCache()->setContentHash(contentHash);
+            return contentHash->toString();
+        }
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
@@ -192,34 +417,43 @@ private:
                                               InternalPlanner::IXSCAN_FETCH);
         } else if (collection->isCapped()) {
             exec = InternalPlanner::collectionScan(
-                opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
+                opCtx, nss.ns(), collection, PlanExecutor::NO_YIELD);
         } else {
-            log() << "can't find _id index for: " << fullCollectionName;
-            return "no _id _index";
+            log() << "can't find _id index for: " << nss;
+            return std::string("no _id _index");
         }
 
-        md5_state_t st;
-        md5_init(&st);
+        DBHasher hasher(options.algorithm);
+        _scan(exec.get(), nss, options, [&](const BSONObj& doc) {
+            hasher.update(doc.objdata(), doc.objsize());
+        });
+        return hasher.finish();
+    }
 
+    template <typename OnDocument>
+    void _scan(PlanExecutor* exec,
+               const NamespaceString& nss,
+               const HashOptions& options,
+               OnDocument onDocument) {
         long long n = 0;
         PlanExecutor::ExecState state;
         BSONObj c;
-        verify(NULL != exec.get());
+        verify(NULL != exec);
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+            onDocument(c);
             n++;
+            if (options.stop && n % 1024 == 0) {
+                uassert(ErrorCodes::Interrupted,
+                        "dbHash was interrupted",
+                        !options.stop->load());
+            }
         }
         if (PlanExecutor::IS_EOF != state) {
-            warning() << "error while hashing, db dropped? ns=" << fullCollectionName;
+            warning() << "error while hashing, db dropped? ns=" << nss;
             uasserted(34371,
                       "Plan executor error while running dbHash command: " +
                           WorkingSetCommon::toStatusString(c));
         }
-        md5digest d;
-        md5_finish(&st, d);
-        std::string hash = digestToString(d);
-
-        return hash;
     }
 
 } dbhashCmd;
@@ -39,6 +39,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/cursor_prefetcher.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
@@ -159,6 +160,8 @@ public:
         auto curOp = CurOp::get(opCtx);
         curOp->debug().cursorid = request.cursorid;
 
+        CursorPrefetcher::get()->waitFor(opCtx, request.cursorid);
+
         // Validate term before acquiring locks, if provided.
         if (request.term) {
             auto replCoord = repl::ReplicationCoordinator::get(opCtx);
@@ -385,6 +388,14 @@ public:
 
         if (respondWithId) {
             cursorFreer.Dismiss();
+
+            if (!CursorManager::isGloballyManagedCursor(request.cursorid) &&
+                CursorPrefetcher::canPrefetch(opCtx, *cursor) &&
+                CursorPrefetcher::get()->reserve(request.cursorid)) {
+                ccPin.getValue().release();
+                CursorPrefetcher::get()->schedule(
+                    request.nss, request.cursorid, request.batchSize.value_or(0));
+            }
         }
 
         return true;
@@ -30,6 +30,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands/cursor_prefetcher.h"
 #include "mongo/db/commands/killcursors_common.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/cursor_manager.h"
@@ -63,6 +64,11 @@ private:
         //
         // Thus, exactly one of 'readLock' and 'statsTracker' will be populated as we populate
         // 'cursorManager'.
+        //
+        // A cursor whose next batch is being prefetched is pinned and so cannot be killed until
+        // the prefetch is done. Wait for it before taking any locks.
+        CursorPrefetcher::get()->waitFor(opCtx, cursorId);
+
         boost::optional<AutoGetCollectionForReadCommand> readLock;
         boost::optional<AutoStatsTracker> statsTracker;
         CursorManager* cursorManager;
@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+#include <set>
+
+#include "mongo/base/init.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace {
+
+using namespace mongo;
+
+/**
+ * Describes the operations using the given lockers the way currentOp does, with the command
+ * truncated.
+ */
+std::map<LockerId, BSONObj> describeLockers(const std::vector<LockerId>& lockerIds) {
+    std::map<LockerId, BSONObj> descriptions;
+    const std::set<LockerId> wanted(lockerIds.begin(), lockerIds.end());
+
+    for (ServiceContext::LockedClientsCursor cursor(getGlobalServiceContext());
+         Client* client = cursor.next();) {
+        invariant(client);
+
+        stdx::lock_guard<Client> lk(*client);
+        OperationContext* clientOpCtx = client->getOperationContext();
+        if (!clientOpCtx) {
+            continue;
+        }
+
+        const LockerId lockerId = clientOpCtx->lockState()->getId();
+        if (!wanted.count(lockerId)) {
+            continue;
+        }
+
+        BSONObjBuilder infoBuilder;
+        client->reportState(infoBuilder);
+        infoBuilder.append("opid", clientOpCtx->getOpID());
+        CurOp::get(clientOpCtx)->reportState(&infoBuilder, true);
+        descriptions.insert({lockerId, infoBuilder.obj()});
+    }
+
+    return descriptions;
+}
+
+/**
+ * Returns the lock waits recorded while lockContentionProfiling is on, oldest first.
+ *
+ * {getLockContention: 1, clear: <bool>}
+ */
+class GetLockContentionCommand : public BasicCommand {
+public:
+    GetLockContentionCommand() : BasicCommand("getLockContention") {}
+
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+    virtual void help(std::stringstream& help) const {
+        help << "lock waits which lasted at least lockContentionProfilingThresholdMillis, with "
+                "the operations waiting and holding the lock. {clear: true} empties the buffer "
+                "after returning them";
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::inprog);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+    virtual bool run(OperationContext* opCtx,
+                     const std::string& db,
+                     const BSONObj& cmdObj,
+                     BSONObjBuilder& result) {
+        auto& profiler = LockContentionProfiler::get();
+        {
+            BSONArrayBuilder waitsBuilder(result.subarrayStart("waits"));
+            profiler.append(&waitsBuilder);
+        }
+
+        if (cmdObj["clear"].trueValue()) {
+            profiler.clear();
+        }
+        return true;
+    }
+};
+
+MONGO_INITIALIZER(RegisterGetLockContentionCommand)(InitializerContext* context) {
+    new GetLockContentionCommand();
+    LockContentionProfiler::setDescribeLockersFn(describeLockers);
+
+    return Status::OK();
+}
+}  // namespace
@@ -42,7 +42,6 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_catalog.h"
-#include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
@@ -58,13 +57,16 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
 #include "mongo/s/client/shard_connection.h"
@@ -73,7 +75,9 @@
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/scripting/engine.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
@@ -93,6 +97,41 @@ namespace dps = ::mongo::dotted_path_support;
 
 namespace mr {
 
+namespace {
+
+// The most threads which may run the map function of a mapReduce which does not use jsMode, each
+// with a JS scope of its own. A value of one runs it on the thread executing the command.
+MONGO_EXPORT_SERVER_PARAMETER(internalMapReduceMaxMapWorkerThreads, int, 1);
+
+// Checks the arguments of a call to emit() and returns the tuple to stage for them.
+BSONObj makeEmitTuple(const BSONObj& args) {
+    uassert(10077, "fast_emit takes 2 args", args.nFields() == 2);
+    uassert(13069,
+            "an emit can't be more than half max bson size",
+            args.objsize() < (BSONObjMaxUserSize / 2));
+
+    if (args.firstElement().type() == Undefined) {
+        BSONObjBuilder b(args.objsize());
+        b.appendNull("");
+        BSONObjIterator i(args);
+        i.next();
+        b.append(i.next());
+        return b.obj();
+    }
+    return args;
+}
+
+// Orders spilled tuples by their key, like TupleKeyCmp orders the in-memory map, so that the final
+// reduce sees the tuples of each key one after another.
+class SpillComparator {
+public:
+    int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const {
+        return lhs.first.firstElement().woCompare(rhs.first.firstElement());
+    }
+};
+
+}  // namespace
+
 AtomicUInt32 Config::JOB_NUMBER;
 
 JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
@@ -309,7 +348,6 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
             outputOptions.outDB.empty() ? dbname : outputOptions.outDB,
             str::stream() << "tmp.mr." << cmdObj.firstElement().valueStringData() << "_"
                           << JOB_NUMBER.fetchAndAdd(1));
-        incLong = NamespaceString(str::stream() << tempNamespace.ns() << "_inc");
     }
 
     {
@@ -361,7 +399,7 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
 }
 
 /**
- * Clean up the temporary and incremental collections
+ * Clean up the temporary collection
  */
 void State::dropTempCollections() {
     if (!_config.tempNamespace.isEmpty()) {
@@ -380,22 +418,6 @@ void State::dropTempCollections() {
         // Always forget about temporary namespaces, so we don't cache lots of them
         ShardConnection::forgetNS(_config.tempNamespace.ns());
     }
-    if (_useIncremental && !_config.incLong.isEmpty()) {
-        // We don't want to log the deletion of incLong as it isn't replicated. While
-        // harmless, this would lead to a scary looking warning on the secondaries.
-        repl::UnreplicatedWritesBlock uwb(_opCtx);
-
-        writeConflictRetry(_opCtx, "M/R dropTempCollections", _config.incLong.ns(), [this] {
-            Lock::DBLock lk(_opCtx, _config.incLong.db(), MODE_X);
-            if (Database* db = dbHolder().get(_opCtx, _config.incLong.ns())) {
-                WriteUnitOfWork wunit(_opCtx);
-                db->dropCollection(_opCtx, _config.incLong.ns()).transitional_ignore();
-                wunit.commit();
-            }
-        });
-
-        ShardConnection::forgetNS(_config.incLong.ns());
-    }
 }
 
 /**
@@ -406,46 +428,6 @@ void State::prepTempCollection() {
         return;
 
     dropTempCollections();
-    if (_useIncremental) {
-        // Create the inc collection and make sure we have index on "0" key.
-        // Intentionally not replicating the inc collection to secondaries.
-        repl::UnreplicatedWritesBlock uwb(_opCtx);
-
-        writeConflictRetry(_opCtx, "M/R prepTempCollection", _config.incLong.ns(), [this] {
-            OldClientWriteContext incCtx(_opCtx, _config.incLong.ns());
-            WriteUnitOfWork wuow(_opCtx);
-            Collection* incColl = incCtx.getCollection();
-            invariant(!incColl);
-
-            CollectionOptions options;
-            options.setNoIdIndex();
-            options.temp = true;
-            if (enableCollectionUUIDs &&
-                serverGlobalParams.featureCompatibility.isSchemaVersion36.load() == true) {
-                options.uuid.emplace(UUID::gen());
-            }
-            incColl = incCtx.db()->createCollection(_opCtx, _config.incLong.ns(), options);
-            invariant(incColl);
-
-            auto rawIndexSpec =
-                BSON("key" << BSON("0" << 1) << "ns" << _config.incLong.ns() << "name"
-                           << "_temp_0");
-            auto indexSpec = uassertStatusOK(index_key_validate::validateIndexSpec(
-                rawIndexSpec, _config.incLong, serverGlobalParams.featureCompatibility));
-
-            Status status = incColl->getIndexCatalog()
-                                ->createIndexOnEmptyCollection(_opCtx, indexSpec)
-                                .getStatus();
-            if (!status.isOK()) {
-                uasserted(17305,
-                          str::stream() << "createIndex failed for mr incLong ns: "
-                                        << _config.incLong.ns()
-                                        << " err: "
-                                        << status.code());
-            }
-            wuow.commit();
-        });
-    }
 
     CollectionOptions finalOptions;
     vector<BSONObj> indexesToInsert;
@@ -780,45 +762,39 @@ void State::insert(const NamespaceString& nss, const BSONObj& o) {
     });
 }
 
-/**
- * Insert doc into the inc collection. This should not be replicated.
- */
-void State::_insertToInc(BSONObj& o) {
+void State::_spill(const BSONObj& tuple) {
     verify(_onDisk);
 
-    writeConflictRetry(_opCtx, "M/R insertToInc", _config.incLong.ns(), [this, &o] {
-        OldClientWriteContext ctx(_opCtx, _config.incLong.ns());
-        WriteUnitOfWork wuow(_opCtx);
-        Collection* coll = getCollectionOrUassert(_opCtx, ctx.db(), _config.incLong);
-        repl::UnreplicatedWritesBlock uwb(_opCtx);
-
-        // The documents inserted into the incremental collection are of the form
-        // {"0": <key>, "1": <value>}, so we cannot call fixDocumentForInsert(o) here because the
-        // check that the document has an "_id" field would fail. Instead, we directly verify that
-        // the size of the document to insert is smaller than 16MB.
-        if (o.objsize() > BSONObjMaxUserSize) {
-            uasserted(ErrorCodes::BadValue,
-                      str::stream() << "object to insert too large for incremental collection"
-                                    << ". size in bytes: "
-                                    << o.objsize()
-                                    << ", max size: "
-                                    << BSONObjMaxUserSize);
-        }
+    // The tuples are of the form {"0": <key>, "1": <value>}. They end up in the output collection
+    // once reduced, so we make sure here that they are no larger than a document may be.
+    if (tuple.objsize() > BSONObjMaxUserSize) {
+        uasserted(ErrorCodes::BadValue,
+                  str::stream() << "object to spill too large for map reduce"
+                                << ". size in bytes: "
+                                << tuple.objsize()
+                                << ", max size: "
+                                << BSONObjMaxUserSize);
+    }
 
-        // TODO: Consider whether to pass OpDebug for stats tracking under SERVER-23261.
-        OpDebug* const nullOpDebug = nullptr;
-        uassertStatusOK(coll->insertDocument(_opCtx, InsertStatement(o), nullOpDebug, true, false));
-        wuow.commit();
-    });
+    if (!_spilled) {
+        const SortOptions opts =
+            SortOptions()
+                .MaxMemoryUsageBytes(internalQueryExecMaxBlockingSortBytes.load())
+                .ExtSortAllowed()
+                .TempDir(storageGlobalParams.dbpath + "/_tmp");
+        _spilled.reset(SpillSorter::make(opts, SpillComparator()));
+    }
+    _spilled->add(tuple, BSONObj());
+    ++_numSpilled;
 }
 
 State::State(OperationContext* opCtx, const Config& c)
     : _config(c),
       _db(opCtx),
-      _useIncremental(true),
       _opCtx(opCtx),
       _size(0),
       _dupCount(0),
+      _numSpilled(0),
       _numEmits(0) {
     _temp.reset(new InMemory());
     _onDisk = _config.outputOptions.outType != Config::INMEMORY;
@@ -856,11 +832,14 @@ void State::init() {
     // setup js
     const string userToken =
         AuthorizationSession::get(Client::getCurrent())->getAuthenticatedUserNamesToken();
-    _scope.reset(getGlobalScriptEngine()->newScopeForCurrentThread());
+    _scope = getGlobalScriptEngine()->getPooledScopeForCurrentThread(
+        _opCtx, _config.dbname, "mapreduce" + userToken);
     _scope->requireOwnedObjects();
-    _scope->registerOperation(_opCtx);
-    _scope->setLocalDB(_config.dbname);
-    _scope->loadStored(_opCtx, true);
+
+    // A reused scope may still hold the natives of an earlier job, which point at its State.
+    ScriptingFunction removeNatives =
+        _scope->createFunction("delete emit; delete _bailFromJS; delete _nativeToTemp;");
+    _scope->invoke(removeNatives, 0, 0, 0, true);
 
     if (!_config.scopeSetup.isEmpty())
         _scope->init(&_config.scopeSetup);
@@ -1025,14 +1004,6 @@ BSONObj _nativeToTemp(const BSONObj& args, void* data) {
     return BSONObj();
 }
 
-//        BSONObj _nativeToInc( const BSONObj& args, void* data ) {
-//            State* state = (State*) data;
-//            BSONObjIterator it(args);
-//            const BSONObj& obj = it.next().Obj();
-//            state->_insertToInc(const_cast<BSONObj&>(obj));
-//            return BSONObj();
-//        }
-
 /**
  * Applies last reduce and finalize.
  * After calling this method, the temp collection will be completed.
@@ -1072,117 +1043,46 @@ void State::finalReduce(OperationContext* opCtx, CurOp* curOp, ProgressMeterHold
         return;
     }
 
-    // use index on "0" to pull sorted data
+    // pull the spilled tuples sorted by key
     verify(_temp->size() == 0);
-    BSONObj sortKey = BSON("0" << 1);
-
-    writeConflictRetry(_opCtx, "finalReduce", _config.incLong.ns(), [&] {
-        OldClientWriteContext incCtx(_opCtx, _config.incLong.ns());
-        WriteUnitOfWork wuow(_opCtx);
-        Collection* incColl = getCollectionOrUassert(_opCtx, incCtx.db(), _config.incLong);
-
-        bool foundIndex = false;
-        IndexCatalog::IndexIterator ii = incColl->getIndexCatalog()->getIndexIterator(_opCtx, true);
-        // Iterate over incColl's indexes.
-        while (ii.more()) {
-            IndexDescriptor* currIndex = ii.next();
-            BSONObj x = currIndex->infoObj();
-            if (sortKey.woCompare(x["key"].embeddedObject()) == 0) {
-                foundIndex = true;
-                break;
-            }
-        }
-
-        verify(foundIndex);
-        wuow.commit();
-    });
-
-    unique_ptr<AutoGetCollectionForReadCommand> ctx(
-        new AutoGetCollectionForReadCommand(_opCtx, _config.incLong));
-
-    BSONObj prev;
-    BSONList all;
 
     {
-        const auto count = _db.count(_config.incLong.ns(), BSONObj(), QueryOption_SlaveOk);
         stdx::lock_guard<Client> lk(*_opCtx->getClient());
         verify(pm ==
                curOp->setMessage_inlock("m/r: (3/3) final reduce to collection",
                                         "M/R: (3/3) Final Reduce Progress",
-                                        count));
+                                        _numSpilled));
     }
 
-    const ExtensionsCallbackReal extensionsCallback(_opCtx, &_config.incLong);
-
-    auto qr = stdx::make_unique<QueryRequest>(_config.incLong);
-    qr->setSort(sortKey);
-
-    const boost::intrusive_ptr<ExpressionContext> expCtx;
-    auto statusWithCQ =
-        CanonicalQuery::canonicalize(opCtx,
-                                     std::move(qr),
-                                     expCtx,
-                                     extensionsCallback,
-                                     MatchExpressionParser::kAllowAllSpecialFeatures &
-                                         ~MatchExpressionParser::AllowedFeatures::kExpr);
-    verify(statusWithCQ.isOK());
-    std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
-
-    Collection* coll = getCollectionOrUassert(opCtx, ctx->getDb(), _config.incLong);
-    invariant(coll);
-
-    auto exec = uassertStatusOK(getExecutor(
-        _opCtx, coll, std::move(cq), PlanExecutor::YIELD_AUTO, QueryPlannerParams::NO_TABLE_SCAN));
-
-    // Make sure the PlanExecutor is destroyed while holding a collection lock.
-    ON_BLOCK_EXIT([&exec, &ctx, opCtx, this] {
-        if (!ctx) {
-            AutoGetCollection autoColl(opCtx, _config.incLong, MODE_IS);
-            exec.reset();
-        }
-    });
+    if (!_spilled) {
+        pm.finished();
+        return;
+    }
 
-    // iterate over all sorted objects
-    BSONObj o;
-    PlanExecutor::ExecState state;
-    while (PlanExecutor::ADVANCED == (state = exec->getNext(&o, NULL))) {
-        o = o.getOwned();  // we will be accessing outside of the lock
+    std::unique_ptr<SpillSorter::Iterator> sorted(_spilled->done());
+    const SpillComparator comparator;
+    BSONList all;
+    while (sorted->more()) {
+        SpillSorter::Data next = sorted->next();
+        next.first = next.first.getOwned();
         pm.hit();
 
-        if (dps::compareObjectsAccordingToSort(o, prev, sortKey) == 0) {
-            // object is same as previous, add to array
-            all.push_back(o);
-            if (pm->hits() % 100 == 0) {
-                _opCtx->checkForInterrupt();
-            }
-            continue;
+        if (!all.empty() && comparator({all.front(), BSONObj()}, next) != 0) {
+            // reduce and finalize the tuples of the previous key
+            finalReduce(all);
+            all.clear();
+            _opCtx->checkForInterrupt();
+        } else if (pm->hits() % 100 == 0) {
+            _opCtx->checkForInterrupt();
         }
 
-        exec->saveState();
-
-        ctx.reset();
-
-        // reduce a finalize array
-        finalReduce(all);
-
-        ctx.reset(new AutoGetCollectionForReadCommand(_opCtx, _config.incLong));
-
-        all.clear();
-        prev = o;
-        all.push_back(o);
-
-        _opCtx->checkForInterrupt();
-        uassertStatusOK(exec->restoreState());
+        all.push_back(next.first);
     }
 
-    uassert(34428,
-            "Plan executor error during mapReduce command: " + WorkingSetCommon::toStatusString(o),
-            PlanExecutor::IS_EOF == state);
-
-    ctx.reset();
     // reduce and finalize last array
     finalReduce(all);
-    ctx.reset(new AutoGetCollectionForReadCommand(_opCtx, _config.incLong));
+    sorted.reset();
+    _spilled.reset();
 
     pm.finished();
 }
@@ -1209,8 +1109,8 @@ void State::reduceInMemory() {
         if (all.size() == 1) {
             // only 1 value for this key
             if (_onDisk) {
-                // this key has low cardinality, so just write to collection
-                _insertToInc(*(all.begin()));
+                // this key has low cardinality, so just spill it
+                _spill(*(all.begin()));
             } else {
                 // add to new map
                 nSize += _add(n.get(), all[0]);
@@ -1228,9 +1128,9 @@ void State::reduceInMemory() {
 }
 
 /**
- * Dumps the entire in memory map to the inc collection.
+ * Dumps the entire in memory map to the spill sorter.
  */
-void State::dumpToInc() {
+void State::dumpToSpill() {
     if (!_onDisk)
         return;
 
@@ -1240,7 +1140,7 @@ void State::dumpToInc() {
             continue;
 
         for (BSONList::iterator j = all.begin(); j != all.end(); j++)
-            _insertToInc(*j);
+            _spill(*j);
     }
     _temp->clear();
     _size = 0;
@@ -1302,8 +1202,8 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
 
         // if size is still high, or values are not reducing well, dump
         if (_onDisk && (_size > _config.maxInMemSize || _size > oldSize / 2)) {
-            dumpToInc();
-            LOG(3) << "  MR - dumping to db";
+            dumpToSpill();
+            LOG(3) << "  MR - spilling to disk";
         }
     }
 }
@@ -1312,22 +1212,8 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
  * emit that will be called by js function
  */
 BSONObj fast_emit(const BSONObj& args, void* data) {
-    uassert(10077, "fast_emit takes 2 args", args.nFields() == 2);
-    uassert(13069,
-            "an emit can't be more than half max bson size",
-            args.objsize() < (BSONObjMaxUserSize / 2));
-
     State* state = (State*)data;
-    if (args.firstElement().type() == Undefined) {
-        BSONObjBuilder b(args.objsize());
-        b.appendNull("");
-        BSONObjIterator i(args);
-        i.next();
-        b.append(i.next());
-        state->emit(b.obj());
-    } else {
-        state->emit(args);
-    }
+    state->emit(makeEmitTuple(args));
     return BSONObj();
 }
 
@@ -1345,6 +1231,218 @@ BSONObj _bailFromJS(const BSONObj& args, void* data) {
     return BSONObj();
 }
 
+namespace {
+
+/**
+ * Runs the map function of a mapReduce on several threads, each with a JS scope of its own. The
+ * thread executing the command still reads the input documents and hands them out to the workers.
+ * It collects the tuples they emit into its State between batches, so reducing, spilling and
+ * writing the output all stay on that thread.
+ */
+class ParallelMapper {
+    MONGO_DISALLOW_COPYING(ParallelMapper);
+
+public:
+    ParallelMapper(OperationContext* opCtx, const Config& config, int numWorkers)
+        : _opCtx(opCtx), _config(config) {
+        for (int i = 0; i < numWorkers; ++i) {
+            _workers.push_back(stdx::make_unique<Worker>());
+        }
+        for (int i = 0; i < numWorkers; ++i) {
+            Worker* worker = _workers[i].get();
+            worker->thread = stdx::thread([this, worker, i] { _run(worker, i); });
+        }
+    }
+
+    ~ParallelMapper() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _stop = true;
+
+            // Interrupt map functions which are still running, for example if the command failed.
+            for (auto&& worker : _workers) {
+                if (worker->opCtx) {
+                    stdx::lock_guard<Client> clientLock(*worker->opCtx->getClient());
+                    worker->opCtx->getServiceContext()->killOperation(worker->opCtx);
+                }
+            }
+        }
+        _workAvailable.notify_all();
+
+        for (auto&& worker : _workers) {
+            worker->thread.join();
+        }
+    }
+
+    /**
+     * Hands 'doc', which must be owned, to the least busy worker. Waits while every worker already
+     * has enough documents queued.
+     */
+    void map(const BSONObj& doc) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        Worker* target = nullptr;
+        _opCtx->waitForConditionOrInterrupt(_workDone, lk, [&] {
+            if (!_error.isOK())
+                return true;
+            for (auto&& worker : _workers) {
+                if (!target || worker->docs.size() < target->docs.size()) {
+                    target = worker.get();
+                }
+            }
+            return target->docs.size() < kMaxQueuedDocsPerWorker;
+        });
+        uassertStatusOK(_error);
+
+        target->docs.push_back(doc);
+        _workAvailable.notify_all();
+    }
+
+    /**
+     * Moves the tuples emitted so far into 'state'. Throws the first error of any worker.
+     */
+    void collectEmits(State* state) {
+        BSONList emitted;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            uassertStatusOK(_error);
+            for (auto&& worker : _workers) {
+                emitted.insert(emitted.end(),
+                               std::make_move_iterator(worker->emitted.begin()),
+                               std::make_move_iterator(worker->emitted.end()));
+                worker->emitted.clear();
+            }
+        }
+
+        for (auto&& tuple : emitted) {
+            state->emit(tuple);
+        }
+    }
+
+    /**
+     * Waits for the workers to map every document handed to them, then collects what they
+     * emitted into 'state'.
+     */
+    void finish(State* state) {
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _opCtx->waitForConditionOrInterrupt(_workDone, lk, [&] {
+                if (!_error.isOK())
+                    return true;
+                for (auto&& worker : _workers) {
+                    if (!worker->docs.empty() || worker->mapping)
+                        return false;
+                }
+                return true;
+            });
+        }
+        collectEmits(state);
+    }
+
+private:
+    // Keeps the workers busy without holding many documents in memory.
+    static const size_t kMaxQueuedDocsPerWorker = 64;
+
+    struct Worker {
+        stdx::thread thread;
+
+        // The worker's operation, which is killed to interrupt its map function.
+        OperationContext* opCtx = nullptr;
+
+        std::deque<BSONObj> docs;
+        bool mapping = false;
+
+        // Tuples emitted by the document being mapped, only accessed by the worker's thread.
+        BSONList pending;
+
+        // Tuples emitted by mapped documents, waiting to be collected.
+        BSONList emitted;
+    };
+
+    static BSONObj _emit(const BSONObj& args, void* data) {
+        static_cast<Worker*>(data)->pending.push_back(makeEmitTuple(args).getOwned());
+        return BSONObj();
+    }
+
+    void _run(Worker* worker, int index) {
+        Client::initThread(str::stream() << "MapReduceWorker-" << index);
+
+        // The worker reads the stored JavaScript of the database like the scope of the command
+        // does. The map function itself has no way to access the database.
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        auto opCtx = cc().makeOperationContext();
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            worker->opCtx = opCtx.get();
+        }
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            worker->opCtx = nullptr;
+        });
+
+        try {
+            const JSFunction& mapFunction =
+                static_cast<const JSMapper&>(*_config.mapper).function();
+
+            std::unique_ptr<Scope> scope(getGlobalScriptEngine()->newScopeForCurrentThread());
+            scope->requireOwnedObjects();
+            scope->registerOperation(opCtx.get());
+            scope->setLocalDB(_config.dbname);
+            scope->loadStored(opCtx.get(), true);
+            if (!_config.scopeSetup.isEmpty())
+                scope->init(&_config.scopeSetup);
+            scope->init(&mapFunction.wantedScope());
+
+            ScriptingFunction func = scope->createFunction(mapFunction.code().c_str());
+            uassert(13598, "couldn't compile code for: _map", func);
+            scope->injectNative("emit", _emit, worker);
+
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            while (true) {
+                _workAvailable.wait(lk, [&] { return _stop || !worker->docs.empty(); });
+                if (_stop)
+                    break;
+
+                BSONObj doc = std::move(worker->docs.front());
+                worker->docs.pop_front();
+                worker->mapping = true;
+                _workDone.notify_all();
+                lk.unlock();
+
+                if (scope->invoke(func, &_config.mapParams, &doc, 0, true))
+                    uasserted(9014, str::stream() << "map invoke failed: " << scope->getError());
+
+                lk.lock();
+                worker->emitted.insert(worker->emitted.end(),
+                                       std::make_move_iterator(worker->pending.begin()),
+                                       std::make_move_iterator(worker->pending.end()));
+                worker->pending.clear();
+                worker->mapping = false;
+                _workDone.notify_all();
+            }
+        } catch (const DBException& ex) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_error.isOK()) {
+                _error = ex.toStatus();
+            }
+            worker->mapping = false;
+            _workDone.notify_all();
+        }
+    }
+
+    OperationContext* const _opCtx;
+    const Config& _config;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;  // for the workers, when documents are handed out
+    stdx::condition_variable _workDone;       // for the command, when documents are mapped
+    std::vector<std::unique_ptr<Worker>> _workers;
+    bool _stop = false;
+    Status _error = Status::OK();
+};
+
+}  // namespace
+
 /**
  * This class represents a map/reduce command executed on a single server
  */
@@ -1518,6 +1616,15 @@ public:
                     CurOp::get(opCtx)->setPlanSummary_inlock(Explain::getPlanSummary(exec.get()));
                 }
 
+                // In jsMode the emitted tuples live in the scope of the command, so only the
+                // other modes can map on several threads.
+                std::unique_ptr<ParallelMapper> parallelMapper;
+                const int numMapWorkers = internalMapReduceMaxMapWorkerThreads.load();
+                if (!state.jsMode() && numMapWorkers > 1) {
+                    parallelMapper =
+                        stdx::make_unique<ParallelMapper>(opCtx, config, numMapWorkers);
+                }
+
                 Timer mt;
 
                 // go through each doc
@@ -1537,7 +1644,11 @@ public:
                     // do map
                     if (config.verbose)
                         mt.reset();
-                    config.mapper->map(o);
+                    if (parallelMapper) {
+                        parallelMapper->map(o);
+                    } else {
+                        config.mapper->map(o);
+                    }
                     if (config.verbose)
                         mapTime += mt.micros();
 
@@ -1556,6 +1667,8 @@ public:
 
                         scopedAutoDb.reset();
 
+                        if (parallelMapper)
+                            parallelMapper->collectEmits(&state);
                         state.reduceAndSpillInMemoryStateIfNeeded();
 
                         scopedAutoDb.reset(new AutoGetDb(opCtx, config.nss.db(), MODE_S));
@@ -1584,6 +1697,11 @@ public:
                                              << WorkingSetCommon::toStatusString(o)));
                 }
 
+                if (parallelMapper) {
+                    parallelMapper->finish(&state);
+                    parallelMapper.reset();
+                }
+
                 // Record the indexes used by the PlanExecutor.
                 PlanSummaryStats stats;
                 Explain::getSummaryStats(*exec, &stats);
@@ -1624,8 +1742,8 @@ public:
             // do reduce in memory
             // this will be the last reduce needed for inline mode
             state.reduceInMemory();
-            // if not inline: dump the in memory map to inc collection, all data is on disk
-            state.dumpToInc();
+            // if not inline: dump the in memory map to the spill sorter, all data is spilled
+            state.dumpToSpill();
             // final reduce
             state.finalReduce(opCtx, curOp, pm);
             reduceTime += rt.micros();
@@ -1755,10 +1873,6 @@ public:
         State state(opCtx, config);
         state.init();
 
-        // no need for incremental collection because records are already sorted
-        state._useIncremental = false;
-        config.incLong = config.tempNamespace;
-
         BSONObj shardCounts = cmdObj["shardCounts"].embeddedObjectUserCheck();
         BSONObj counts = cmdObj["counts"].embeddedObjectUserCheck();
 
@@ -1890,3 +2004,6 @@ public:
 
 }  // namespace
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -38,6 +38,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/scripting/engine.h"
 
@@ -124,6 +125,13 @@ public:
         return _func;
     }
 
+    const std::string& code() const {
+        return _code;
+    }
+    const BSONObj& wantedScope() const {
+        return _wantedScope;
+    }
+
 private:
     std::string _type;
     std::string _code;     // actual javascript code
@@ -139,6 +147,10 @@ public:
     virtual void map(const BSONObj& o);
     virtual void init(State* state);
 
+    const JSFunction& function() const {
+        return _func;
+    }
+
 private:
     JSFunction _func;
     BSONObj _params;
@@ -188,6 +200,9 @@ public:
 
 typedef std::map<BSONObj, BSONList, TupleKeyCmp> InMemory;  // from key to list of tuples
 
+// Sorts the tuples spilled from the in-memory map by their key. The values are unused.
+typedef Sorter<BSONObj, BSONObj> SpillSorter;
+
 /**
  * holds map/reduce config information
  */
@@ -220,7 +235,6 @@ public:
     BSONObj scopeSetup;
 
     // output tables
-    NamespaceString incLong;
     NamespaceString tempNamespace;
 
     enum OutputType {
@@ -296,11 +310,9 @@ public:
     void reduceInMemory();
 
     /**
-     * transfers in memory storage to temp collection
+     * transfers in memory storage to the spill sorter
      */
-    void dumpToInc();
-    void insertToInc(BSONObj& o);
-    void _insertToInc(BSONObj& o);
+    void dumpToSpill();
 
     // ------ reduce stage -----------
 
@@ -382,7 +394,6 @@ public:
 
     const Config& _config;
     DBDirectClient _db;
-    bool _useIncremental;  // use an incremental collection
 
 protected:
     /**
@@ -393,6 +404,11 @@ protected:
      */
     int _add(InMemory* im, const BSONObj& a);
 
+    /**
+     * Adds a tuple to the spill sorter, which keeps it on disk if memory runs short.
+     */
+    void _spill(const BSONObj& tuple);
+
     OperationContext* _opCtx;
     std::unique_ptr<Scope> _scope;
     bool _onDisk;  // if the end result of this map reduce is disk or not
@@ -401,6 +417,10 @@ protected:
     long _size;      // bytes in _temp
     long _dupCount;  // number of duplicate key entries
 
+    // Tuples spilled from _temp, pulled in key order by the final reduce.
+    std::unique_ptr<SpillSorter> _spilled;
+    long long _numSpilled;
+
     long long _numEmits;
 
     bool _jsMode;
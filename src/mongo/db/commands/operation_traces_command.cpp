@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/operation_trace.h"
+
+namespace {
+
+using namespace mongo;
+
+/**
+ * Returns the buffered traces of the sampled operations, oldest first.
+ *
+ * {getOperationTraces: 1, clear: <bool>}
+ */
+class GetOperationTracesCommand : public BasicCommand {
+public:
+    GetOperationTracesCommand() : BasicCommand("getOperationTraces") {}
+
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+    virtual void help(std::stringstream& help) const {
+        help << "traces of the operations sampled at operationTraceSampleRate, in micros. "
+                "{clear: true} empties the buffer after returning them";
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::inprog);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+    virtual bool run(OperationContext* opCtx,
+                     const std::string& db,
+                     const BSONObj& cmdObj,
+                     BSONObjBuilder& result) {
+        auto& traceBuffer = OperationTraceBuffer::get(opCtx->getServiceContext());
+        {
+            BSONArrayBuilder tracesBuilder(result.subarrayStart("traces"));
+            traceBuffer.append(&tracesBuilder);
+        }
+
+        if (cmdObj["clear"].trueValue()) {
+            traceBuffer.clear();
+        }
+        return true;
+    }
+};
+
+MONGO_INITIALIZER(RegisterGetOperationTracesCommand)(InitializerContext* context) {
+    new GetOperationTracesCommand();
+
+    return Status::OK();
+}
+}  // namespace
@@ -46,6 +46,7 @@
 #include "mongo/db/pipeline/close_change_stream_exception.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_cached_view_results.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -56,11 +57,14 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/views/view.h"
 #include "mongo/db/views/view_catalog.h"
+#include "mongo/db/views/view_result_cache.h"
 #include "mongo/db/views/view_sharding_check.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -287,13 +291,101 @@ Status collatorCompatibleWithPipeline(OperationContext* opCtx,
     }
     return Status::OK();
 }
-}  // namespace
 
-Status runAggregate(OperationContext* opCtx,
-                    const NamespaceString& origNss,
-                    const AggregationRequest& request,
-                    const BSONObj& cmdObj,
-                    BSONObjBuilder& result) {
+/**
+ * Runs the pipeline of 'resolvedView' by itself and returns its results, or nullptr if they would
+ * take up more than 'maxSizeBytes'.
+ */
+ViewResultCache::Results computeViewResults(OperationContext* opCtx,
+                                            const ResolvedView& resolvedView,
+                                            size_t maxSizeBytes) {
+    AggregationRequest viewRequest(resolvedView.getNamespace(), resolvedView.getPipeline());
+    viewRequest.setCollation(resolvedView.getDefaultCollation());
+
+    std::unique_ptr<Pipeline, Pipeline::Deleter> pipeline;
+    {
+        AutoGetCollectionForReadCommand autoColl(opCtx, viewRequest.getNamespaceString());
+        Collection* collection = autoColl.getCollection();
+
+        // Pick the collation in the same way as an aggregation over the view would.
+        std::unique_ptr<CollatorInterface> collator;
+        if (!viewRequest.getCollation().isEmpty()) {
+            collator = uassertStatusOK(CollatorFactoryInterface::get(opCtx->getServiceContext())
+                                           ->makeFromBSON(viewRequest.getCollation()));
+        } else if (collection && collection->getDefaultCollator()) {
+            collator = collection->getDefaultCollator()->clone();
+        }
+
+        boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(opCtx,
+                                  viewRequest,
+                                  std::move(collator),
+                                  uassertStatusOK(resolveInvolvedNamespaces(opCtx, viewRequest))));
+        expCtx->tempDir = storageGlobalParams.dbpath + "/_tmp";
+
+        pipeline = uassertStatusOK(Pipeline::parse(viewRequest.getPipeline(), expCtx));
+        pipeline->optimizePipeline();
+        PipelineD::prepareCursorSource(
+            collection, viewRequest.getNamespaceString(), &viewRequest, pipeline.get());
+    }
+
+    auto results = std::make_shared<std::vector<BSONObj>>();
+    size_t sizeBytes = 0;
+    while (auto next = pipeline->getNext()) {
+        results->push_back(next->toBson());
+        sizeBytes += results->back().objsize();
+        if (sizeBytes > maxSizeBytes) {
+            return nullptr;
+        }
+    }
+    return results;
+}
+
+/**
+ * Returns the results of the pipeline of 'resolvedView' from the process-wide view result cache to
+ * answer 'request', computing and caching them first if they are missing or too stale. Returns
+ * nullptr if 'request' should run the view's pipeline itself.
+ */
+ViewResultCache::Results getCachedViewResults(OperationContext* opCtx,
+                                              const ResolvedView& resolvedView,
+                                              const AggregationRequest& request) {
+    const Milliseconds maxStaleness{internalQueryViewResultCacheMaxStalenessMS.load()};
+    // The cached results are read with the default read concern, and explain should describe the
+    // plan of the view's pipeline.
+    if (maxStaleness <= Milliseconds(0) || request.getExplain() ||
+        repl::ReadConcernArgs::get(opCtx).getLevel() !=
+            repl::ReadConcernLevel::kLocalReadConcern ||
+        !ViewResultCache::isCacheable(resolvedView)) {
+        return nullptr;
+    }
+
+    auto cache = ViewResultCache::get(opCtx->getServiceContext());
+    auto clock = opCtx->getServiceContext()->getFastClockSource();
+    if (auto results = cache->find(resolvedView, clock->now(), maxStaleness)) {
+        return results;
+    }
+
+    const Date_t computedAt = clock->now();
+    const size_t maxSizeBytes = internalQueryViewResultCacheMaxBytes.load();
+    auto results = computeViewResults(opCtx, resolvedView, maxSizeBytes);
+    if (results) {
+        cache->insert(resolvedView, results, computedAt, maxSizeBytes);
+    }
+    return results;
+}
+
+/**
+ * Implements runAggregate(). If 'cachedViewResults' is set, 'request' is the expansion of an
+ * aggregation over a view, and its first 'nViewStages' stages are replaced with the view's
+ * precomputed results.
+ */
+Status runAggregateImpl(OperationContext* opCtx,
+                        const NamespaceString& origNss,
+                        const AggregationRequest& request,
+                        const BSONObj& cmdObj,
+                        BSONObjBuilder& result,
+                        ViewResultCache::Results cachedViewResults,
+                        size_t nViewStages) {
     // For operations on views, this will be the underlying namespace.
     NamespaceString nss = request.getNamespaceString();
 
@@ -376,7 +468,15 @@ Status runAggregate(OperationContext* opCtx,
             auto newRequest = resolvedView.getValue().asExpandedViewAggregation(request);
             auto newCmd = newRequest.serializeToCommandObj().toBson();
 
-            auto status = runAggregate(opCtx, origNss, newRequest, newCmd, result);
+            auto cachedViewResults =
+                getCachedViewResults(opCtx, resolvedView.getValue(), request);
+            auto status = runAggregateImpl(opCtx,
+                                           origNss,
+                                           newRequest,
+                                           newCmd,
+                                           result,
+                                           std::move(cachedViewResults),
+                                           resolvedView.getValue().getPipeline().size());
             {
                 // Set the namespace of the curop back to the view namespace so ctx records
                 // stats on this view namespace on destruction.
@@ -404,6 +504,12 @@ Status runAggregate(OperationContext* opCtx,
                                   std::move(collatorToUse),
                                   uassertStatusOK(resolveInvolvedNamespaces(opCtx, request))));
         expCtx->tempDir = storageGlobalParams.dbpath + "/_tmp";
+        if (internalPipelineUseDocumentArena.load()) {
+            expCtx->documentArena = std::make_shared<RefCountedArena>();
+        }
+        if (internalPipelineUseDocumentShapes.load()) {
+            expCtx->documentShapes = new DocumentShapeTable();
+        }
 
         if (liteParsedPipeline.hasChangeStream()) {
             expCtx->tailableMode = TailableMode::kTailableAndAwaitData;
@@ -411,6 +517,18 @@ Status runAggregate(OperationContext* opCtx,
 
         auto pipeline = uassertStatusOK(Pipeline::parse(request.getPipeline(), expCtx));
 
+        const bool usingCachedViewResults = bool(cachedViewResults);
+        if (usingCachedViewResults) {
+            // Each of the view's stages parses to a single DocumentSource, so the first
+            // 'nViewStages' stages are the view's.
+            for (size_t i = 0; i < nViewStages; ++i) {
+                invariant(pipeline->popFrontStageWithName(
+                    pipeline->getSources().front()->getSourceName()));
+            }
+            pipeline->addInitialSource(
+                DocumentSourceCachedViewResults::create(expCtx, std::move(cachedViewResults)));
+        }
+
         // Check that the view's collation matches the collation of any views involved in the
         // pipeline.
         if (!pipelineInvolvedNamespaces.empty()) {
@@ -424,7 +542,7 @@ Status runAggregate(OperationContext* opCtx,
 
         pipeline->optimizePipeline();
 
-        if (kDebugBuild && !expCtx->explain && !expCtx->fromMongos) {
+        if (kDebugBuild && !expCtx->explain && !expCtx->fromMongos && !usingCachedViewResults) {
             // Make sure all operations round-trip through Pipeline::serialize() correctly by
             // re-parsing every command in debug builds. This is important because sharded
             // aggregations rely on this ability.  Skipping when fromMongos because this has
@@ -500,5 +618,14 @@ Status runAggregate(OperationContext* opCtx,
     // Any code that needs the cursor pinned must be inside the try block, above.
     return Status::OK();
 }
+}  // namespace
+
+Status runAggregate(OperationContext* opCtx,
+                    const NamespaceString& origNss,
+                    const AggregationRequest& request,
+                    const BSONObj& cmdObj,
+                    BSONObjBuilder& result) {
+    return runAggregateImpl(opCtx, origNss, request, cmdObj, result, nullptr, 0);
+}
 
 }  // namespace mongo
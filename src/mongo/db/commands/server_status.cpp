@@ -50,6 +50,7 @@
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/util/log.h"
+#include "mongo/util/memory_accounting.h"
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/net/ssl_manager.h"
@@ -286,6 +287,22 @@ public:
 } asserts;
 
 
+class MemoryAccounting : public ServerStatusSection {
+public:
+    MemoryAccounting() : ServerStatusSection("memoryAccounting") {}
+    virtual bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        BSONObjBuilder b;
+        MemoryAccount::appendAll(&b);
+        return b.obj();
+    }
+
+} memoryAccounting;
+
+
 class Network : public ServerStatusSection {
 public:
     Network() : ServerStatusSection("network") {}
@@ -124,7 +124,8 @@ public:
 
         Lock::GlobalLock lk(opCtx, MODE_IX, UINT_MAX);
         auto name = SnapshotName(cmdObj.firstElement().Long());
-        snapshotManager->setCommittedSnapshot(name, Timestamp(name.asU64()));
+        // Snapshot names from makeSnapshot are not timestamps, so read from the named snapshot.
+        snapshotManager->setCommittedSnapshot(name, Timestamp());
         return true;
     }
 };
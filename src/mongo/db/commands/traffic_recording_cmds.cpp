@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/traffic_recorder.h"
+
+namespace {
+
+using namespace mongo;
+
+// Bounds the recordings started without a maximum size.
+const long long kDefaultMaxFileSizeBytes = 1024LL * 1024 * 1024;
+
+class TrafficRecordingCommand : public BasicCommand {
+public:
+    using BasicCommand::BasicCommand;
+
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::trafficRecord);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+};
+
+/**
+ * Starts recording the requests the server receives.
+ *
+ * {startRecordingTraffic: 1, filename: <string>, maxFileSize: <bytes>}
+ */
+class StartRecordingTrafficCommand : public TrafficRecordingCommand {
+public:
+    StartRecordingTrafficCommand() : TrafficRecordingCommand("startRecordingTraffic") {}
+
+    virtual void help(std::stringstream& help) const {
+        help << "record the requests received into 'filename' within trafficRecordingDirectory, "
+                "up to 'maxFileSize' bytes, for replay with mongotrafficreplay";
+    }
+    virtual bool run(OperationContext* opCtx,
+                     const std::string& db,
+                     const BSONObj& cmdObj,
+                     BSONObjBuilder& result) {
+        std::string filename;
+        uassertStatusOK(bsonExtractStringField(cmdObj, "filename", &filename));
+
+        long long maxFileSizeBytes;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "maxFileSize", kDefaultMaxFileSizeBytes, &maxFileSizeBytes));
+
+        auto& recorder = TrafficRecorder::get(opCtx->getServiceContext());
+        uassertStatusOK(recorder.start(filename, maxFileSizeBytes));
+        recorder.appendStatus(&result);
+        return true;
+    }
+};
+
+/**
+ * Stops recording the requests the server receives and reports what was recorded.
+ *
+ * {stopRecordingTraffic: 1}
+ */
+class StopRecordingTrafficCommand : public TrafficRecordingCommand {
+public:
+    StopRecordingTrafficCommand() : TrafficRecordingCommand("stopRecordingTraffic") {}
+
+    virtual void help(std::stringstream& help) const {
+        help << "stop the recording started by startRecordingTraffic";
+    }
+    virtual bool run(OperationContext* opCtx,
+                     const std::string& db,
+                     const BSONObj& cmdObj,
+                     BSONObjBuilder& result) {
+        auto& recorder = TrafficRecorder::get(opCtx->getServiceContext());
+        uassertStatusOK(recorder.stop());
+        recorder.appendStatus(&result);
+        return true;
+    }
+};
+
+class TrafficRecordingServerStatusSection final : public ServerStatusSection {
+public:
+    TrafficRecordingServerStatusSection() : ServerStatusSection("trafficRecording") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        TrafficRecorder::get(opCtx->getServiceContext()).appendStatus(&builder);
+        return builder.obj();
+    }
+} trafficRecordingServerStatusSection;
+
+MONGO_INITIALIZER(RegisterTrafficRecordingCommands)(InitializerContext* context) {
+    new StartRecordingTrafficCommand();
+    new StopRecordingTrafficCommand();
+
+    return Status::OK();
+}
+}  // namespace
@@ -36,6 +36,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/deferred_index_applier.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/util/fail_point_service.h"
@@ -190,6 +191,13 @@ public:
             _validationNotifier.notify_all();
         });
 
+        // Deferred indexes are only expected to match the collection once their pending writes
+        // have been applied.
+        Status applyStatus = applyDeferredIndexWrites(opCtx, collection);
+        if (!applyStatus.isOK()) {
+            return appendCommandStatus(result, applyStatus);
+        }
+
         ValidateResults results;
         Status status =
             collection->validate(opCtx, level, background, std::move(collLk), &results, &result);
@@ -99,80 +99,90 @@ void serializeReply(OperationContext* opCtx,
     if (shouldSkipOutput(opCtx))
         return;
 
+    // The upserted ids and errors are written straight into the reply rather than into separate
+    // objects which are then copied in, so first find out which of the arrays are needed.
     long long n = 0;
     long long nModified = 0;
-    std::vector<BSONObj> upsertInfo;
-    std::vector<BSONObj> errors;
-    BSONSizeTracker upsertInfoSizeTracker;
-    BSONSizeTracker errorsSizeTracker;
-
-    auto errorMessage = [&, errorSize = size_t(0) ](StringData rawMessage) mutable {
-        // Start truncating error messages once both of these limits are exceeded.
-        constexpr size_t kErrorSizeTruncationMin = 1024 * 1024;
-        constexpr size_t kErrorCountTruncationMin = 2;
-        if (errorSize >= kErrorSizeTruncationMin && errors.size() >= kErrorCountTruncationMin) {
-            return ""_sd;
+    bool hasUpserts = false;
+    bool hasErrors = false;
+    for (const auto& opResult : result.results) {
+        if (!opResult.isOK()) {
+            hasErrors = true;
+            continue;
+        }
+        n += opResult.getValue().getN();  // Always there.
+        if (replyStyle == ReplyStyle::kUpdate) {
+            nModified += opResult.getValue().getNModified();
+            hasUpserts = hasUpserts || !opResult.getValue().getUpsertedId().isEmpty();
         }
+    }
+
+    // For ordered:false commands we need to duplicate the StaleConfig result for all ops
+    // after we stopped. result.results doesn't include the staleConfigException.
+    // See the comment on WriteResult::staleConfigException for more info.
+    const size_t staleConfigEndIndex = !result.staleConfigException
+        ? result.results.size()
+        : continueOnError ? opsInBatch : result.results.size() + 1;
+    hasErrors = hasErrors || staleConfigEndIndex > result.results.size();
+
+    out->appendNumber("n", n);
 
-        errorSize += rawMessage.size();
-        return rawMessage;
-    };
-
-    for (size_t i = 0; i < result.results.size(); i++) {
-        if (result.results[i].isOK()) {
-            const auto& opResult = result.results[i].getValue();
-            n += opResult.getN();  // Always there.
-            if (replyStyle == ReplyStyle::kUpdate) {
-                nModified += opResult.getNModified();
-                if (auto idElement = opResult.getUpsertedId().firstElement()) {
-                    BSONObjBuilder upsertedId(upsertInfoSizeTracker);
+    if (replyStyle == ReplyStyle::kUpdate) {
+        out->appendNumber("nModified", nModified);
+        if (hasUpserts) {
+            BSONArrayBuilder upserted(out->subarrayStart("upserted"));
+            for (size_t i = 0; i < result.results.size(); i++) {
+                if (!result.results[i].isOK())
+                    continue;
+                if (auto idElement = result.results[i].getValue().getUpsertedId().firstElement()) {
+                    BSONObjBuilder upsertedId(upserted.subobjStart());
                     upsertedId.append("index", int(i));
                     upsertedId.appendAs(idElement, "_id");
-                    upsertInfo.push_back(upsertedId.obj());
                 }
             }
-            continue;
         }
-
-        const auto& status = result.results[i].getStatus();
-        BSONObjBuilder error(errorsSizeTracker);
-        error.append("index", int(i));
-        error.append("code", int(status.code()));
-        error.append("errmsg", errorMessage(status.reason()));
-        errors.push_back(error.obj());
     }
 
-    if (result.staleConfigException) {
-        // For ordered:false commands we need to duplicate the StaleConfig result for all ops
-        // after we stopped. result.results doesn't include the staleConfigException.
-        // See the comment on WriteResult::staleConfigException for more info.
-        int endIndex = continueOnError ? opsInBatch : result.results.size() + 1;
-        for (int i = result.results.size(); i < endIndex; i++) {
-            BSONObjBuilder error(errorsSizeTracker);
-            error.append("index", i);
+    if (hasErrors) {
+        size_t errorCount = 0;
+        auto errorMessage = [&, errorSize = size_t(0) ](StringData rawMessage) mutable {
+            // Start truncating error messages once both of these limits are exceeded.
+            constexpr size_t kErrorSizeTruncationMin = 1024 * 1024;
+            constexpr size_t kErrorCountTruncationMin = 2;
+            if (errorSize >= kErrorSizeTruncationMin && errorCount >= kErrorCountTruncationMin) {
+                return ""_sd;
+            }
+
+            errorSize += rawMessage.size();
+            return rawMessage;
+        };
+
+        BSONArrayBuilder errors(out->subarrayStart("writeErrors"));
+        for (size_t i = 0; i < result.results.size(); i++) {
+            if (result.results[i].isOK())
+                continue;
+
+            const auto& status = result.results[i].getStatus();
+            BSONObjBuilder error(errors.subobjStart());
+            error.append("index", int(i));
+            error.append("code", int(status.code()));
+            error.append("errmsg", errorMessage(status.reason()));
+            ++errorCount;
+        }
+
+        for (size_t i = result.results.size(); i < staleConfigEndIndex; i++) {
+            BSONObjBuilder error(errors.subobjStart());
+            error.append("index", int(i));
             error.append("code", int(ErrorCodes::StaleShardVersion));  // Different from exception!
             error.append("errmsg", errorMessage(result.staleConfigException->reason()));
             {
                 BSONObjBuilder errInfo(error.subobjStart("errInfo"));
                 result.staleConfigException->getVersionWanted().addToBSON(errInfo, "vWanted");
             }
-            errors.push_back(error.obj());
+            ++errorCount;
         }
     }
 
-    out->appendNumber("n", n);
-
-    if (replyStyle == ReplyStyle::kUpdate) {
-        out->appendNumber("nModified", nModified);
-        if (!upsertInfo.empty()) {
-            out->append("upserted", upsertInfo);
-        }
-    }
-
-    if (!errors.empty()) {
-        out->append("writeErrors", errors);
-    }
-
     // writeConcernError field is handled by command processor.
 
     {
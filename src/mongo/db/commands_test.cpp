@@ -36,6 +36,54 @@
 
 namespace mongo {
 
+class ReplySizeHintCommand : public BasicCommand {
+public:
+    ReplySizeHintCommand() : BasicCommand("replySizeHintTestCommand") {}
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    std::size_t reserveBytesForReply() const override {
+        return 100;
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        return true;
+    }
+};
+
+TEST(Commands, ReplyBufferSizeHintFollowsRecentReplies) {
+    ReplySizeHintCommand command;
+    ASSERT_EQ(100U, command.replyBufferSizeHint());
+
+    command.noteReplySize(50);
+    ASSERT_EQ(100U, command.replyBufferSizeHint());
+
+    command.noteReplySize(16 * 1024);
+    ASSERT_EQ(16U * 1024, command.replyBufferSizeHint());
+
+    // The hint decays with every smaller reply, and never goes below reserveBytesForReply().
+    command.noteReplySize(50);
+    ASSERT_LT(command.replyBufferSizeHint(), 16U * 1024);
+    ASSERT_GT(command.replyBufferSizeHint(), 8U * 1024);
+    for (int i = 0; i < 200; ++i) {
+        command.noteReplySize(50);
+    }
+    ASSERT_EQ(100U, command.replyBufferSizeHint());
+
+    // Huge replies don't make every later reply reserve as much.
+    command.noteReplySize(BSONObjMaxUserSize);
+    ASSERT_LTE(command.replyBufferSizeHint(), 1024U * 1024);
+}
+
 TEST(Commands, appendCommandStatusOK) {
     BSONObjBuilder actualResult;
     Command::appendCommandStatus(actualResult, Status::OK());
@@ -72,7 +72,7 @@ public:
 
 private:
     OperationContext* _opCtx;
-    TicketHolder _holder;
+    SemaphoreTicketHolder _holder;
 };
 
 
@@ -0,0 +1,249 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/hot_document_wait_queue.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+// The longest a writer waits for the write which its update of a hot document conflicted with to
+// end. 0 turns off the tracking of hot documents.
+MONGO_EXPORT_SERVER_PARAMETER(hotDocumentWriteConflictMaxWaitMillis, int, 100);
+
+// The number of documents each partition tracks at most.
+const size_t kMaxTrackedPerPartition = 64;
+
+// How long a document is tracked after its last conflict.
+const Seconds kIdleExpiry{10};
+
+// The number of the most conflicted documents reported to serverStatus.
+const size_t kNumReportedDocuments = 10;
+
+}  // namespace
+
+/**
+ * Ends a write registered by onWrite() when its WriteUnitOfWork commits or rolls back.
+ */
+class HotDocumentWaitQueue::WriteChange final : public RecoveryUnit::Change {
+public:
+    WriteChange(HotDocumentWaitQueue* queue, Key key) : _queue(queue), _key(std::move(key)) {}
+
+    void commit() final {
+        _queue->_onWriteEnded(_key);
+    }
+
+    void rollback() final {
+        _queue->_onWriteEnded(_key);
+    }
+
+private:
+    HotDocumentWaitQueue* const _queue;
+    const Key _key;
+};
+
+size_t HotDocumentWaitQueue::KeyHasher::operator()(const Key& key) const {
+    size_t hash = RecordId::Hasher()(key.recordId);
+    boost::hash_combine(hash, key.ns);
+    return hash;
+}
+
+HotDocumentWaitQueue& HotDocumentWaitQueue::get() {
+    static HotDocumentWaitQueue queue;
+    return queue;
+}
+
+HotDocumentWaitQueue::Partition& HotDocumentWaitQueue::_partitionFor(const Key& key) {
+    return _partitions[KeyHasher()(key) % kNumPartitions];
+}
+
+void HotDocumentWaitQueue::onWrite(OperationContext* opCtx,
+                                   StringData ns,
+                                   const RecordId& recordId) {
+    if (_numTracked.load() == 0 || hotDocumentWriteConflictMaxWaitMillis.load() <= 0) {
+        return;
+    }
+
+    Key key{ns.toString(), recordId};
+    auto& partition = _partitionFor(key);
+    {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        auto it = partition.entries.find(key);
+        if (it == partition.entries.end()) {
+            return;
+        }
+        ++it->second.pendingWrites;
+    }
+    opCtx->recoveryUnit()->registerChange(new WriteChange(this, std::move(key)));
+}
+
+bool HotDocumentWaitQueue::waitAfterConflict(OperationContext* opCtx,
+                                             StringData ns,
+                                             const RecordId& recordId) {
+    const int maxWaitMillis = hotDocumentWriteConflictMaxWaitMillis.load();
+    if (maxWaitMillis <= 0 || opCtx->lockState()->inAWriteUnitOfWork()) {
+        return false;
+    }
+    _conflicts.fetchAndAdd(1);
+
+    const Date_t now = Date_t::now();
+    Key key{ns.toString(), recordId};
+    auto& partition = _partitionFor(key);
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex);
+
+    auto it = partition.entries.find(key);
+    if (it == partition.entries.end()) {
+        if (partition.entries.size() >= kMaxTrackedPerPartition) {
+            _evictIdle(lk, &partition, now - kIdleExpiry);
+        }
+        if (partition.entries.size() >= kMaxTrackedPerPartition) {
+            _untrackedConflicts.fetchAndAdd(1);
+            return false;
+        }
+        it = partition.entries.emplace(std::piecewise_construct,
+                                       std::forward_as_tuple(std::move(key)),
+                                       std::forward_as_tuple())
+                 .first;
+        _numTracked.fetchAndAdd(1);
+    }
+
+    auto& entry = it->second;
+    ++entry.conflicts;
+    entry.lastConflict = now;
+    if (entry.pendingWrites == 0) {
+        // The conflicting write has already ended, or was made before the document became hot.
+        return false;
+    }
+
+    _waits.fetchAndAdd(1);
+    ++entry.waiters;
+    ON_BLOCK_EXIT([&] { --entry.waiters; });
+
+    Timer timer;
+    ON_BLOCK_EXIT([&] { _waitMicros.fetchAndAdd(timer.micros()); });
+
+    const uint64_t writesEnded = entry.writesEnded;
+    if (opCtx->waitForConditionOrInterruptUntil(
+            entry.endedWrite, lk, now + Milliseconds(maxWaitMillis), [&] {
+                return entry.writesEnded != writesEnded;
+            })) {
+        _wakeups.fetchAndAdd(1);
+    } else {
+        _timeouts.fetchAndAdd(1);
+    }
+    return true;
+}
+
+void HotDocumentWaitQueue::_onWriteEnded(const Key& key) {
+    auto& partition = _partitionFor(key);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.entries.find(key);
+    invariant(it != partition.entries.end());
+
+    auto& entry = it->second;
+    invariant(entry.pendingWrites > 0);
+    --entry.pendingWrites;
+    ++entry.writesEnded;
+    if (entry.waiters > 0) {
+        entry.endedWrite.notify_all();
+    } else if (entry.pendingWrites == 0 && entry.lastConflict < Date_t::now() - kIdleExpiry) {
+        // The document has cooled down, stop tracking the writes to it.
+        partition.entries.erase(it);
+        _numTracked.fetchAndSubtract(1);
+    }
+}
+
+void HotDocumentWaitQueue::_evictIdle(WithLock, Partition* partition, Date_t cutoff) {
+    for (auto it = partition->entries.begin(); it != partition->entries.end();) {
+        const auto& entry = it->second;
+        if (entry.waiters == 0 && entry.pendingWrites == 0 && entry.lastConflict < cutoff) {
+            it = partition->entries.erase(it);
+            _numTracked.fetchAndSubtract(1);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void HotDocumentWaitQueue::appendStats(BSONObjBuilder* builder) const {
+    builder->append("conflicts", _conflicts.load());
+    builder->append("untrackedConflicts", _untrackedConflicts.load());
+    builder->append("waits", _waits.load());
+    builder->append("wakeups", _wakeups.load());
+    builder->append("timeouts", _timeouts.load());
+    builder->append("waitMicros", _waitMicros.load());
+    builder->append("trackedDocuments", _numTracked.load());
+
+    struct Report {
+        BSONObj description;
+        uint64_t conflicts;
+    };
+    std::vector<Report> reports;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& kv : partition.entries) {
+            BSONObjBuilder description;
+            description.append("ns", kv.first.ns);
+            description.append("recordId", kv.first.recordId.repr());
+            description.append("conflicts", static_cast<long long>(kv.second.conflicts));
+            description.append("waiters", kv.second.waiters);
+            description.append("pendingWrites", kv.second.pendingWrites);
+            description.append("lastConflict", kv.second.lastConflict);
+            reports.push_back({description.obj(), kv.second.conflicts});
+        }
+    }
+
+    const size_t numReported = std::min(reports.size(), kNumReportedDocuments);
+    std::partial_sort(reports.begin(),
+                      reports.begin() + numReported,
+                      reports.end(),
+                      [](const Report& lhs, const Report& rhs) {
+                          return lhs.conflicts > rhs.conflicts;
+                      });
+
+    BSONArrayBuilder documents(builder->subarrayStart("documents"));
+    for (size_t i = 0; i < numReported; ++i) {
+        documents.append(reports[i].description);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * Lets a writer whose update of a document hit a WriteConflictException wait for the storage
+ * transaction which wrote the document to end, instead of retrying in a loop of backoffs while
+ * that transaction is still open.
+ *
+ * A document becomes hot the first time an update of it conflicts. From then on the writers which
+ * modify it register their write here until their WriteUnitOfWork commits or rolls back, and the
+ * writers which conflict on it wait for the next of those to end, for at most
+ * hotDocumentWriteConflictMaxWaitMillis. A writer which conflicts while no write to the document
+ * is registered retries straight away. Setting hotDocumentWriteConflictMaxWaitMillis to 0 turns
+ * the queue off.
+ *
+ * Documents are identified by namespace and RecordId. A bounded number of them are tracked, and
+ * the ones which have not conflicted for a while are forgotten. The number of conflicts and waits
+ * in total and for the hottest documents are reported to serverStatus.
+ */
+class HotDocumentWaitQueue {
+    MONGO_DISALLOW_COPYING(HotDocumentWaitQueue);
+
+public:
+    HotDocumentWaitQueue() = default;
+
+    static HotDocumentWaitQueue& get();
+
+    /**
+     * Called by a writer which modified 'recordId' in 'ns' in its current WriteUnitOfWork. If the
+     * document is hot, the writers which conflict on it wait until the WriteUnitOfWork ends.
+     */
+    void onWrite(OperationContext* opCtx, StringData ns, const RecordId& recordId);
+
+    /**
+     * Called by a writer whose WriteUnitOfWork modifying 'recordId' in 'ns' was rolled back by a
+     * WriteConflictException, before it retries. Marks the document hot and waits for a
+     * registered write to it to end, if there is one. Returns whether it waited.
+     *
+     * Does not wait if the caller is in a WriteUnitOfWork, since it could be what the writer it
+     * would wait for is waiting for. Throws if the operation is interrupted while waiting.
+     */
+    bool waitAfterConflict(OperationContext* opCtx, StringData ns, const RecordId& recordId);
+
+    /**
+     * Appends the totals, and the most conflicted of the tracked documents.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    class WriteChange;
+
+    struct Key {
+        std::string ns;
+        RecordId recordId;
+
+        bool operator==(const Key& other) const {
+            return recordId == other.recordId && ns == other.ns;
+        }
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        stdx::condition_variable endedWrite;
+        // Incremented each time a registered write to the document ends.
+        uint64_t writesEnded = 0;
+        int pendingWrites = 0;
+        int waiters = 0;
+        uint64_t conflicts = 0;
+        Date_t lastConflict;
+    };
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+        std::unordered_map<Key, Entry, KeyHasher> entries;
+    };
+
+    static const int kNumPartitions = 16;
+
+    Partition& _partitionFor(const Key& key);
+
+    /**
+     * Forgets the documents of 'partition' which nobody is waiting for or writing, and which have
+     * not conflicted since 'cutoff'.
+     */
+    void _evictIdle(WithLock, Partition* partition, Date_t cutoff);
+
+    /**
+     * Called when a write registered by onWrite() commits or rolls back.
+     */
+    void _onWriteEnded(const Key& key);
+
+    Partition _partitions[kNumPartitions];
+
+    // The number of documents tracked by all the partitions, so that writes need not look for the
+    // documents they modify while none are hot.
+    AtomicInt64 _numTracked{0};
+
+    AtomicInt64 _conflicts{0};
+    AtomicInt64 _untrackedConflicts{0};
+    AtomicInt64 _waits{0};
+    AtomicInt64 _wakeups{0};
+    AtomicInt64 _timeouts{0};
+    AtomicInt64 _waitMicros{0};
+};
+
+}  // namespace mongo
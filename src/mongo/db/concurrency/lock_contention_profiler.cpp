@@ -0,0 +1,204 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(lockContentionProfiling, bool, false);
+
+AtomicInt32 lockContentionProfilingThresholdMillis(100);
+
+class LockContentionProfilingThresholdMillisParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    LockContentionProfilingThresholdMillisParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "lockContentionProfilingThresholdMillis",
+              &lockContentionProfilingThresholdMillis) {}
+
+    Status validate(const int& potentialNewValue) override {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "lockContentionProfilingThresholdMillis must be "
+                                           "greater than or equal to 0, but attempted to set to: "
+                                        << potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+} lockContentionProfilingThresholdMillisParameter;
+
+MONGO_EXPORT_SERVER_PARAMETER(lockContentionProfilingBufferSize, int, 1000);
+
+LockContentionProfiler::DescribeLockersFn describeLockersFn;
+
+const char* lockResultName(LockResult result) {
+    switch (result) {
+        case LOCK_OK:
+            return "granted";
+        case LOCK_TIMEOUT:
+            return "timedOut";
+        case LOCK_DEADLOCK:
+            return "deadlock";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace
+
+LockContentionProfiler& LockContentionProfiler::get() {
+    static LockContentionProfiler profiler;
+    return profiler;
+}
+
+void LockContentionProfiler::setDescribeLockersFn(DescribeLockersFn describeLockers) {
+    describeLockersFn = std::move(describeLockers);
+}
+
+boost::optional<Milliseconds> LockContentionProfiler::getThreshold() {
+    if (!lockContentionProfiling.load()) {
+        return boost::none;
+    }
+
+    return Milliseconds(lockContentionProfilingThresholdMillis.load());
+}
+
+BSONObj LockContentionProfiler::describeWait(LockerId waiterId,
+                                             ResourceId resId,
+                                             LockMode mode,
+                                             bool includeHolders) {
+    std::vector<std::pair<LockerId, LockMode>> holders;
+    if (includeHolders) {
+        holders = getGlobalLockManager()->getGrantedLockers(resId);
+    }
+
+    std::vector<LockerId> lockerIds{waiterId};
+    for (const auto& holder : holders) {
+        lockerIds.push_back(holder.first);
+    }
+
+    std::map<LockerId, BSONObj> descriptions;
+    if (describeLockersFn) {
+        descriptions = describeLockersFn(lockerIds);
+    }
+
+    auto appendLocker = [&](LockerId lockerId, BSONObjBuilder* builder) {
+        builder->append("lockerId", static_cast<long long>(lockerId));
+        auto it = descriptions.find(lockerId);
+        if (it != descriptions.end()) {
+            builder->appendElements(it->second);
+        }
+    };
+
+    BSONObjBuilder builder;
+    {
+        BSONObjBuilder waiterBuilder(builder.subobjStart("waiter"));
+        appendLocker(waiterId, &waiterBuilder);
+    }
+
+    if (includeHolders) {
+        BSONArrayBuilder holdersBuilder(builder.subarrayStart("holders"));
+        for (const auto& holder : holders) {
+            // A waiter converting its lock to a stronger mode is on the granted list itself.
+            if (holder.first == waiterId) {
+                continue;
+            }
+
+            BSONObjBuilder holderBuilder(holdersBuilder.subobjStart());
+            holderBuilder.append("mode", modeName(holder.second));
+            appendLocker(holder.first, &holderBuilder);
+        }
+    }
+
+    return builder.obj();
+}
+
+void LockContentionProfiler::recordWait(const BSONObj& description,
+                                        ResourceId resId,
+                                        LockMode mode,
+                                        uint64_t waitMicros,
+                                        LockResult result) {
+    ResourceTypeSummary& summary = _summary[resId.getType()];
+    summary.count.fetchAndAdd(1);
+    summary.waitMicros.fetchAndAdd(waitMicros);
+
+    BSONObjBuilder builder;
+    builder.appendDate("ts", Date_t::now());
+    builder.append("resource", resId.toString());
+    builder.append("resourceType", resourceTypeName(resId.getType()));
+    builder.append("mode", modeName(mode));
+    builder.append("waitMicros", static_cast<long long>(waitMicros));
+    builder.append("result", lockResultName(result));
+    builder.appendElements(description);
+    BSONObj wait = builder.obj();
+
+    const size_t bufferSize = std::max(lockContentionProfilingBufferSize.load(), 0);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _waits.push_back(std::move(wait));
+    while (_waits.size() > bufferSize) {
+        _waits.pop_front();
+    }
+}
+
+void LockContentionProfiler::append(BSONArrayBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& wait : _waits) {
+        builder->append(wait);
+    }
+}
+
+void LockContentionProfiler::appendSummary(BSONObjBuilder* builder) const {
+    for (int type = RESOURCE_GLOBAL; type < ResourceTypesCount; type++) {
+        const ResourceTypeSummary& summary = _summary[type];
+
+        BSONObjBuilder typeBuilder(
+            builder->subobjStart(resourceTypeName(static_cast<ResourceType>(type))));
+        typeBuilder.append("count", summary.count.load());
+        typeBuilder.append("waitMicros", summary.waitMicros.load());
+    }
+}
+
+void LockContentionProfiler::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _waits.clear();
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONArrayBuilder;
+class BSONObjBuilder;
+
+/**
+ * Keeps a record of the lock waits which lasted at least lockContentionProfilingThresholdMillis
+ * while lockContentionProfiling is on, so that lock convoys can be diagnosed after the fact.
+ *
+ * Each record names the resource, the mode and duration of the wait, and describes the operation
+ * which waited and the operations which held the resource once the wait became long. The most
+ * recent lockContentionProfilingBufferSize records are kept. The number and total duration of the
+ * long waits by resource type are reported to serverStatus, and through it to FTDC.
+ */
+class LockContentionProfiler {
+    MONGO_DISALLOW_COPYING(LockContentionProfiler);
+
+public:
+    /**
+     * Returns a description of the operation using each of the given lockers which still has one.
+     * The lock manager has no knowledge of operations, so the server provides this function.
+     */
+    using DescribeLockersFn =
+        stdx::function<std::map<LockerId, BSONObj>(const std::vector<LockerId>& lockerIds)>;
+
+    LockContentionProfiler() = default;
+
+    static LockContentionProfiler& get();
+
+    static void setDescribeLockersFn(DescribeLockersFn describeLockers);
+
+    /**
+     * Returns how long a lock wait must last to be recorded, or boost::none if lock contention is
+     * not being profiled.
+     */
+    static boost::optional<Milliseconds> getThreshold();
+
+    /**
+     * Describes the wait of 'waiterId' for 'resId' in 'mode'. The lockers which hold the resource
+     * are included if 'includeHolders' is true, which must only be done while the wait lasts.
+     */
+    BSONObj describeWait(LockerId waiterId, ResourceId resId, LockMode mode, bool includeHolders);
+
+    /**
+     * Records a long wait which ended with 'result', given the description built for it by
+     * describeWait().
+     */
+    void recordWait(const BSONObj& description,
+                    ResourceId resId,
+                    LockMode mode,
+                    uint64_t waitMicros,
+                    LockResult result);
+
+    /**
+     * Appends the recorded waits to 'builder', oldest first.
+     */
+    void append(BSONArrayBuilder* builder) const;
+
+    /**
+     * Appends the number and total duration of the long waits by resource type.
+     */
+    void appendSummary(BSONObjBuilder* builder) const;
+
+    /**
+     * Removes all the recorded waits. The summary is not reset.
+     */
+    void clear();
+
+private:
+    struct ResourceTypeSummary {
+        AtomicInt64 count;
+        AtomicInt64 waitMicros;
+    };
+
+    ResourceTypeSummary _summary[ResourceTypesCount];
+
+    mutable stdx::mutex _mutex;
+    std::deque<BSONObj> _waits;
+};
+
+}  // namespace mongo
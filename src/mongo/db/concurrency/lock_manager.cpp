@@ -41,6 +41,7 @@
 #include "mongo/config.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -410,15 +411,30 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+namespace {
 
-LockManager::LockManager() {
-    _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
+/**
+ * Balance scalability of intent locks against potential added cost of conflicting locks, which
+ * must visit every partition holding the resource. Intent locks should almost never find another
+ * locker's thread on their partition, so use a power of two of at least twice the number of
+ * cores.
+ */
+unsigned computeNumPartitions() {
+    const unsigned minPartitions = 2 * stdx::thread::hardware_concurrency();
+    unsigned numPartitions = 32;
+    while (numPartitions < minPartitions && numPartitions < 1024) {
+        numPartitions *= 2;
+    }
+    return numPartitions;
 }
 
+}  // namespace
+
+LockManager::LockManager()
+    : _lockBuckets(_numLockBuckets),
+      _numPartitions(computeNumPartitions()),
+      _partitions(_numPartitions) {}
+
 LockManager::~LockManager() {
     cleanupUnusedLocks();
 
@@ -426,9 +442,6 @@ LockManager::~LockManager() {
         // TODO: dump more information about the non-empty bucket to see what locks were leaked
         invariant(_lockBuckets[i].data.empty());
     }
-
-    delete[] _lockBuckets;
-    delete[] _partitions;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -888,6 +901,27 @@ void LockManager::getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClien
     result->append("lockInfo", lockInfo.arr());
 }
 
+std::vector<std::pair<LockerId, LockMode>> LockManager::getGrantedLockers(ResourceId resId) {
+    std::vector<std::pair<LockerId, LockMode>> grantedLockers;
+
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    LockBucket::Map::const_iterator it = bucket->data.find(resId);
+    if (it == bucket->data.end()) {
+        return grantedLockers;
+    }
+
+    // Requests granted in the partitions are migrated to the lock head as soon as a conflicting
+    // request arrives, so for a contended resource the granted list is complete.
+    for (const LockRequest* request = it->second->grantedList._front; request != nullptr;
+         request = request->next) {
+        grantedLockers.emplace_back(request->locker->getId(), request->mode);
+    }
+
+    return grantedLockers;
+}
+
 void LockManager::_dumpBucket(const LockBucket* bucket) const {
     for (LockBucket::Map::const_iterator it = bucket->data.begin(); it != bucket->data.end();
          it++) {
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/align/aligned_allocator.hpp>
 #include <cstdint>
 #include <deque>
 #include <map>
@@ -43,6 +44,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -131,6 +133,11 @@ public:
     void getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                          BSONObjBuilder* result);
 
+    /**
+     * Returns the lockers which have been granted 'resId', with the mode each of them holds it in.
+     */
+    std::vector<std::pair<LockerId, LockMode>> getGrantedLockers(ResourceId resId);
+
 private:
     // The deadlock detector needs to access the buckets and locks directly
     friend class DeadlockDetector;
@@ -211,11 +218,18 @@ private:
      */
     void _cleanupUnusedLocksInBucket(LockBucket* bucket);
 
+    template <typename T>
+    using CacheAlignedVector = std::vector<CacheAligned<T>,
+                                           boost::alignment::aligned_allocator<CacheAligned<T>>>;
+
+    // Buckets and partitions each start on their own cache line, so that threads working on
+    // neighbouring ones do not contend on the same line for their mutexes.
     static const unsigned _numLockBuckets;
-    LockBucket* _lockBuckets;
+    mutable CacheAlignedVector<LockBucket> _lockBuckets;
 
-    static const unsigned _numPartitions;
-    Partition* _partitions;
+    // Scaled with the number of cores, so that concurrent lockers rarely share a partition.
+    const unsigned _numPartitions;
+    mutable CacheAlignedVector<Partition> _partitions;
 };
 
 
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+const ResourceId resIdDatabase(RESOURCE_DATABASE, StringData("benchmarkdb"));
+const ResourceId resIdCollection(RESOURCE_COLLECTION, StringData("benchmarkdb.coll"));
+
+void BM_LockManagerLockUnlock(benchmark::State& state) {
+    LockManager lockMgr;
+    LockerForTests locker(MODE_IS);
+    TrackingLockGrantNotification notify;
+
+    LockRequest request;
+    request.initNew(&locker, &notify);
+    while (state.keepRunning()) {
+        invariant(lockMgr.lock(resIdCollection, &request, MODE_IS) == LOCK_OK);
+        lockMgr.unlock(&request);
+    }
+}
+MONGO_BENCHMARK(BM_LockManagerLockUnlock);
+
+void BM_LockerLockUnlockCollection(benchmark::State& state) {
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        invariant(locker.lockGlobal(MODE_IX) == LOCK_OK);
+        invariant(locker.lock(resIdDatabase, MODE_IX) == LOCK_OK);
+        invariant(locker.lock(resIdCollection, MODE_IX) == LOCK_OK);
+        locker.unlock(resIdCollection);
+        locker.unlock(resIdDatabase);
+        locker.unlockGlobal();
+    }
+}
+MONGO_BENCHMARK(BM_LockerLockUnlockCollection);
+
+void BM_LockerRecursiveLock(benchmark::State& state) {
+    DefaultLockerImpl locker;
+    invariant(locker.lockGlobal(MODE_IS) == LOCK_OK);
+    invariant(locker.lock(resIdDatabase, MODE_IS) == LOCK_OK);
+    while (state.keepRunning()) {
+        invariant(locker.lock(resIdDatabase, MODE_IS) == LOCK_OK);
+        locker.unlock(resIdDatabase);
+    }
+    locker.unlock(resIdDatabase);
+    locker.unlockGlobal();
+}
+MONGO_BENCHMARK(BM_LockerRecursiveLock);
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include <vector>
 
+#include "mongo/db/concurrency/lock_contention_profiler.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
@@ -43,6 +44,7 @@
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -276,6 +278,23 @@ LockerImpl<IsForMMAPV1>::~LockerImpl() {
     _stats.reset();
 }
 
+template <bool IsForMMAPV1>
+bool LockerImpl<IsForMMAPV1>::resetForReuse() {
+    if (inAWriteUnitOfWork() || !_resourcesToUnlockAtEndOfUnitOfWork.empty() ||
+        !_requests.empty() || _modeForTicket != MODE_NONE) {
+        return false;
+    }
+
+    // The id is kept, since the previous operation which used it no longer has any requests in
+    // the lock manager.
+    _stats.reset();
+    _notify.clear();
+    _clientState.store(kInactive);
+    _threadId = stdx::this_thread::get_id();
+    setShouldConflictWithSecondaryBatchApplication(true);
+    return true;
+}
+
 template <bool IsForMMAPV1>
 Locker::ClientState LockerImpl<IsForMMAPV1>::getClientState() const {
     auto state = _clientState.load();
@@ -310,11 +329,18 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(LockMode mode, Milliseconds
         auto holder = ticketHolders[mode];
         if (holder) {
             _clientState.store(reader ? kQueuedReader : kQueuedWriter);
-            if (timeout == Milliseconds::max()) {
-                holder->waitForTicket();
-            } else if (!holder->waitForTicketUntil(Date_t::now() + timeout)) {
-                _clientState.store(kInactive);
-                return LOCK_TIMEOUT;
+            // Only time the wait when no ticket is immediately available, so that the common
+            // uncontended acquisition does not have to read the clock.
+            if (!holder->tryAcquire()) {
+                Timer timer;
+                if (timeout == Milliseconds::max()) {
+                    holder->waitForTicket();
+                } else if (!holder->waitForTicketUntil(Date_t::now() + timeout)) {
+                    _timeQueuedForTicket += Microseconds(timer.micros());
+                    _clientState.store(kInactive);
+                    return LOCK_TIMEOUT;
+                }
+                _timeQueuedForTicket += Microseconds(timer.micros());
             }
         }
         _clientState.store(reader ? kActiveReader : kActiveWriter);
@@ -741,6 +767,14 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
     const uint64_t startOfTotalWaitTime = curTimeMicros64();
     uint64_t startOfCurrentWaitTime = startOfTotalWaitTime;
 
+    // When lock contention is profiled, wake up once the wait has lasted long enough to be
+    // recorded, so that the lockers holding the resource can be described before they release it.
+    const auto contentionThreshold = LockContentionProfiler::getThreshold();
+    boost::optional<BSONObj> longWaitDescription;
+    if (contentionThreshold) {
+        waitTime = std::min(waitTime, *contentionThreshold);
+    }
+
     while (true) {
         // It is OK if this call wakes up spuriously, because we re-evaluate the remaining
         // wait time anyways.
@@ -770,18 +804,46 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
             }
         }
 
+        const auto totalBlockTime = duration_cast<Milliseconds>(
+            Microseconds(int64_t(curTimeMicros - startOfTotalWaitTime)));
+
+        if (contentionThreshold && !longWaitDescription &&
+            totalBlockTime >= *contentionThreshold) {
+            longWaitDescription =
+                LockContentionProfiler::get().describeWait(_id, resId, mode, true);
+        }
+
         // If infinite timeout was requested, just keep waiting
         if (timeout == Milliseconds::max()) {
-            continue;
+            waitTime = DeadlockTimeout;
+        } else {
+            waitTime = (totalBlockTime < timeout)
+                ? std::min(timeout - totalBlockTime, DeadlockTimeout)
+                : Milliseconds(0);
+
+            if (waitTime == Milliseconds(0)) {
+                break;
+            }
         }
 
-        const auto totalBlockTime = duration_cast<Milliseconds>(
-            Microseconds(int64_t(curTimeMicros - startOfTotalWaitTime)));
-        waitTime = (totalBlockTime < timeout) ? std::min(timeout - totalBlockTime, DeadlockTimeout)
-                                              : Milliseconds(0);
+        if (contentionThreshold && !longWaitDescription) {
+            waitTime = std::min(waitTime, *contentionThreshold - totalBlockTime);
+        }
+    }
 
-        if (waitTime == Milliseconds(0)) {
-            break;
+    if (contentionThreshold) {
+        const auto totalWaitTime = Microseconds(int64_t(curTimeMicros64() - startOfTotalWaitTime));
+        if (totalWaitTime >= *contentionThreshold) {
+            // A lock granted right as the wait became long has no holders left to describe.
+            if (!longWaitDescription) {
+                longWaitDescription =
+                    LockContentionProfiler::get().describeWait(_id, resId, mode, false);
+            }
+            LockContentionProfiler::get().recordWait(*longWaitDescription,
+                                                     resId,
+                                                     mode,
+                                                     durationCount<Microseconds>(totalWaitTime),
+                                                     result);
         }
     }
 
@@ -95,6 +95,10 @@ public:
 
     virtual ClientState getClientState() const;
 
+    virtual Microseconds getTimeQueuedForTicket() const {
+        return _timeQueuedForTicket;
+    }
+
     virtual LockerId getId() const {
         return _id;
     }
@@ -140,6 +144,8 @@ public:
 
     virtual void restoreLockState(const LockSnapshot& stateToRestore);
 
+    bool resetForReuse() override;
+
     /**
      * Allows for lock requests to be requested in a non-blocking way. There can be only one
      * outstanding pending lock request per locker object.
@@ -231,6 +237,9 @@ private:
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
+    // Total time spent waiting for a ticket. Only the owning thread reads or writes it.
+    Microseconds _timeQueuedForTicket{0};
+
     // Track the thread who owns the lock for debugging purposes
     stdx::thread::id _threadId;
 
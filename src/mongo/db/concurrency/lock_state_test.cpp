@@ -34,6 +34,7 @@
 #include <string>
 #include <vector>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/config.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/concurrency/locker.h"
@@ -387,4 +388,39 @@ TEST(LockerImpl, GetLockerInfoShouldReportPendingLocks) {
     ASSERT(conflictingLocker.unlockGlobal());
 }
 
+TEST(LockerImpl, ResetForReuseRequiresAllLocksReleased) {
+    const ResourceId dbId(RESOURCE_DATABASE, "TestDB"_sd);
+
+    DefaultLockerImpl locker;
+    const LockerId id = locker.getId();
+    ASSERT_EQ(LOCK_OK, locker.lockGlobal(MODE_IX));
+    ASSERT_EQ(LOCK_OK, locker.lock(dbId, MODE_X));
+    locker.setShouldConflictWithSecondaryBatchApplication(false);
+
+    // A Locker which still holds locks cannot be reused.
+    ASSERT_FALSE(locker.resetForReuse());
+    ASSERT_EQ(MODE_X, locker.getLockMode(dbId));
+
+    ASSERT(locker.unlock(dbId));
+    ASSERT(locker.unlockGlobal());
+    ASSERT(locker.resetForReuse());
+
+    ASSERT_EQ(id, locker.getId());
+    ASSERT_EQ(Locker::kInactive, locker.getClientState());
+    ASSERT(locker.shouldConflictWithSecondaryBatchApplication());
+
+    Locker::LockerInfo lockerInfo;
+    locker.getLockerInfo(&lockerInfo);
+    ASSERT_EQ(0U, lockerInfo.locks.size());
+
+    // The statistics of the previous operation have been cleared.
+    BSONObjBuilder statsBuilder;
+    lockerInfo.stats.report(&statsBuilder);
+    ASSERT_BSONOBJ_EQ(BSONObj(), statsBuilder.obj());
+
+    // The reused Locker can take locks again.
+    ASSERT_EQ(LOCK_OK, locker.lockGlobal(MODE_IS));
+    ASSERT(locker.unlockGlobal());
+}
+
 }  // namespace mongo
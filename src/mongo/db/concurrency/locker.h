@@ -81,6 +81,11 @@ public:
      */
     virtual ClientState getClientState() const = 0;
 
+    /**
+     * Returns the total time this locker spent waiting for a ticket to acquire the Global lock.
+     */
+    virtual Microseconds getTimeQueuedForTicket() const = 0;
+
     virtual LockerId getId() const = 0;
 
     /**
@@ -327,6 +332,15 @@ public:
         return _shouldConflictWithSecondaryBatchApplication;
     }
 
+    /**
+     * Prepares this Locker, whose operation has finished with it, to be handed to a later operation
+     * on the same Client. Returns false, leaving the Locker untouched, if it still holds or is
+     * waiting for locks or does not support being reused.
+     */
+    virtual bool resetForReuse() {
+        return false;
+    }
+
 protected:
     Locker() {}
 
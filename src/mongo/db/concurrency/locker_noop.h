@@ -49,6 +49,10 @@ public:
         invariant(false);
     }
 
+    virtual Microseconds getTimeQueuedForTicket() const {
+        return Microseconds(0);
+    }
+
     virtual LockerId getId() const {
         invariant(false);
     }
@@ -507,6 +507,10 @@ string OpDebug::report(Client* client,
         s << " writeConflicts:" << writeConflicts;
     }
 
+    if (!storageStats.isEmpty()) {
+        s << " storage:" << storageStats.toString();
+    }
+
     if (!exceptionInfo.isOK()) {
         s << " exception: " << redact(exceptionInfo.reason());
         s << " code:" << exceptionInfo.code();
@@ -597,6 +601,10 @@ void OpDebug::append(const CurOp& curop,
         b.appendNumber("writeConflicts", writeConflicts);
     }
 
+    if (!storageStats.isEmpty()) {
+        b.append("storage", storageStats);
+    }
+
     b.appendNumber("numYield", curop.numYields());
 
     {
@@ -120,11 +120,16 @@ public:
 
     BSONObj execStats;  // Owned here.
 
+    // Work the storage engine did on behalf of the operation. Only filled in for operations
+    // which are logged or profiled.
+    BSONObj storageStats;
+
     // error handling
     Status exceptionInfo = Status::OK();
 
     // response info
     long long executionTimeMicros{0};
+    long long planningTimeMicros{0};  // time spent selecting a plan, reported in operation traces
     long long nreturned{-1};
     int responseLength{-1};
 };
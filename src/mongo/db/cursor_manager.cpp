@@ -356,6 +356,7 @@ CursorManager::CursorManager(NamespaceString nss)
     : _nss(std::move(nss)),
       _collectionCacheRuntimeId(_nss.isEmpty() ? 0
                                                : globalCursorIdCache->registerCursorManager(_nss)),
+      _registrationLock("CursorManager::_registrationLock"),
       _random(stdx::make_unique<PseudoRandom>(globalCursorIdCache->nextSeed())),
       _registeredPlanExecutors(),
       _cursorMap(stdx::make_unique<Partitioned<unordered_map<CursorId, ClientCursor*>>>()) {}
@@ -449,24 +450,34 @@ bool CursorManager::cursorShouldTimeout_inlock(const ClientCursor* cursor, Date_
 }
 
 std::size_t CursorManager::timeoutCursors(OperationContext* opCtx, Date_t now) {
+    std::size_t numTimedOut = 0;
     std::vector<std::unique_ptr<ClientCursor, ClientCursor::Deleter>> toDelete;
 
     for (size_t partitionId = 0; partitionId < kNumPartitions; ++partitionId) {
-        auto lockedPartition = _cursorMap->lockOnePartitionById(partitionId);
-        for (auto it = lockedPartition->begin(); it != lockedPartition->end();) {
-            auto* cursor = it->second;
-            if (cursorShouldTimeout_inlock(cursor, now)) {
-                // Dispose of the cursor and remove it from the partition.
-                cursor->dispose(opCtx);
-                toDelete.push_back(std::unique_ptr<ClientCursor, ClientCursor::Deleter>{cursor});
-                it = lockedPartition->erase(it);
-            } else {
-                ++it;
+        {
+            auto lockedPartition = _cursorMap->lockOnePartitionById(partitionId);
+            for (auto it = lockedPartition->begin(); it != lockedPartition->end();) {
+                auto* cursor = it->second;
+                if (cursorShouldTimeout_inlock(cursor, now)) {
+                    toDelete.push_back(
+                        std::unique_ptr<ClientCursor, ClientCursor::Deleter>{cursor});
+                    it = lockedPartition->erase(it);
+                } else {
+                    ++it;
+                }
             }
         }
+
+        // Once removed from its partition, a cursor is no longer reachable by other threads, so it
+        // can be disposed of without blocking pins of the other cursors in the partition.
+        for (auto&& cursor : toDelete) {
+            cursor->dispose(opCtx);
+        }
+        numTimedOut += toDelete.size();
+        toDelete.clear();
     }
 
-    return toDelete.size();
+    return numTimedOut;
 }
 
 namespace {
@@ -488,32 +499,40 @@ void CursorManager::deregisterExecutor(PlanExecutor* exec) {
 }
 
 StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx, CursorId id) {
-    auto lockedPartition = _cursorMap->lockOnePartition(id);
-    auto it = lockedPartition->find(id);
-    if (it == lockedPartition->end()) {
-        return {ErrorCodes::CursorNotFound, str::stream() << "cursor id " << id << " not found"};
-    }
+    ClientCursor* cursor;
+    {
+        auto lockedPartition = _cursorMap->lockOnePartition(id);
+        auto it = lockedPartition->find(id);
+        if (it == lockedPartition->end()) {
+            return {ErrorCodes::CursorNotFound,
+                    str::stream() << "cursor id " << id << " not found"};
+        }
 
-    ClientCursor* cursor = it->second;
-    uassert(12051, str::stream() << "cursor id " << id << " is already in use", !cursor->_isPinned);
-    if (cursor->getExecutor()->isMarkedAsKilled()) {
-        // This cursor was killed while it was idle.
-        Status error{ErrorCodes::QueryPlanKilled,
-                     str::stream() << "cursor killed because: "
-                                   << cursor->getExecutor()->getKillReason()};
-        lockedPartition->erase(cursor->cursorid());
-        cursor->dispose(opCtx);
-        delete cursor;
-        return error;
-    }
+        cursor = it->second;
+        uassert(
+            12051, str::stream() << "cursor id " << id << " is already in use", !cursor->_isPinned);
+        if (cursor->getExecutor()->isMarkedAsKilled()) {
+            // This cursor was killed while it was idle.
+            Status error{ErrorCodes::QueryPlanKilled,
+                         str::stream() << "cursor killed because: "
+                                       << cursor->getExecutor()->getKillReason()};
+            lockedPartition->erase(cursor->cursorid());
+            cursor->dispose(opCtx);
+            delete cursor;
+            return error;
+        }
 
-    auto cursorPrivilegeStatus = checkCursorSessionPrivilege(opCtx, cursor->getSessionId());
+        auto cursorPrivilegeStatus = checkCursorSessionPrivilege(opCtx, cursor->getSessionId());
 
-    if (!cursorPrivilegeStatus.isOK()) {
-        return cursorPrivilegeStatus;
+        if (!cursorPrivilegeStatus.isOK()) {
+            return cursorPrivilegeStatus;
+        }
+
+        cursor->_isPinned = true;
     }
 
-    cursor->_isPinned = true;
+    // A pinned cursor cannot be deleted by other threads, so the rest of the work is done without
+    // holding up operations on the other cursors in its partition.
 
     // We use pinning of a cursor as a proxy for active, user-initiated use of a cursor.  Therefor,
     // we pass down to the logical session cache and vivify the record (updating last use).
@@ -575,28 +594,23 @@ size_t CursorManager::numCursors() const {
     return _cursorMap->size();
 }
 
-CursorId CursorManager::allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        // The leading two bits of a CursorId are used to determine if the cursor is registered on
-        // the global cursor manager.
-        CursorId id;
-        if (isGlobalManager()) {
-            // This is the global cursor manager, so generate a random number and make sure the
-            // first two bits are 01.
-            uint64_t mask = 0x3FFFFFFFFFFFFFFF;
-            uint64_t bitToSet = 1ULL << 62;
-            id = ((_random->nextInt64() & mask) | bitToSet);
-        } else {
-            // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32
-            // bits are random.
-            uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
-            id = cursorIdFromParts(_collectionCacheRuntimeId, myPart);
-        }
-        auto partition = _cursorMap->lockOnePartition(id);
-        if (partition->count(id) == 0)
-            return id;
+CursorId CursorManager::generateCursorId() {
+    stdx::lock_guard<AdaptiveMutex> lock(_registrationLock);
+
+    // The leading two bits of a CursorId are used to determine if the cursor is registered on the
+    // global cursor manager.
+    if (isGlobalManager()) {
+        // This is the global cursor manager, so generate a random number and make sure the first
+        // two bits are 01.
+        uint64_t mask = 0x3FFFFFFFFFFFFFFF;
+        uint64_t bitToSet = 1ULL << 62;
+        return ((_random->nextInt64() & mask) | bitToSet);
     }
-    fassertFailed(17360);
+
+    // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32 bits are
+    // random.
+    uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, myPart);
 }
 
 ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
@@ -611,18 +625,25 @@ ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
     cursorParams.exec.get_deleter().dismissDisposal();
     cursorParams.exec->unsetRegistered();
 
-    // Note we must hold the registration lock from now until insertion into '_cursorMap' to ensure
-    // we don't insert two cursors with the same cursor id.
-    stdx::lock_guard<SimpleMutex> lock(_registrationLock);
-    CursorId cursorId = allocateCursorId_inlock();
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(new ClientCursor(
-        std::move(cursorParams), this, cursorId, opCtx->getLogicalSessionId(), now));
-
-    // Transfer ownership of the cursor to '_cursorMap'.
-    auto partition = _cursorMap->lockOnePartition(cursorId);
-    ClientCursor* unownedCursor = clientCursor.release();
-    partition->emplace(cursorId, unownedCursor);
-    return ClientCursorPin(opCtx, unownedCursor);
+    for (int i = 0; i < 10000; i++) {
+        CursorId cursorId = generateCursorId();
+        ClientCursor* unownedCursor;
+        {
+            // Note we must hold the partition lock from the check that the id is unused until
+            // insertion into '_cursorMap' to ensure we don't insert two cursors with the same id.
+            auto partition = _cursorMap->lockOnePartition(cursorId);
+            if (partition->count(cursorId) > 0) {
+                continue;
+            }
+
+            // Transfer ownership of the cursor to '_cursorMap'.
+            unownedCursor = new ClientCursor(
+                std::move(cursorParams), this, cursorId, opCtx->getLogicalSessionId(), now);
+            partition->emplace(cursorId, unownedCursor);
+        }
+        return ClientCursorPin(opCtx, unownedCursor);
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
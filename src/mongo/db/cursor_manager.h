@@ -39,6 +39,7 @@
 #include "mongo/platform/unordered_map.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/unordered_set.h"
+#include "mongo/util/concurrency/adaptive_mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/duration.h"
 
@@ -219,7 +220,11 @@ private:
     struct PlanExecutorPartitioner {
         std::size_t operator()(const PlanExecutor* exec, std::size_t nPartitions);
     };
-    CursorId allocateCursorId_inlock();
+    /**
+     * Returns a candidate id for a new cursor. The caller must check that the id is not already in
+     * use while holding the lock for the partition of '_cursorMap' it maps to.
+     */
+    CursorId generateCursorId();
 
     ClientCursorPin _registerCursor(
         OperationContext* opCtx, std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor);
@@ -247,17 +252,19 @@ private:
     // There are several mutexes at work to protect concurrent access to data structures managed by
     // this cursor manager. The two registration data structures '_registeredPlanExecutors' and
     // '_cursorMap' are partitioned to decrease contention, and each partition of the structure is
-    // protected by its own mutex. Separately, there is a '_registrationLock' which protects
-    // concurrent access to '_random' for cursor id generation, and must be held from cursor id
-    // generation until insertion into '_cursorMap'. If you ever need to acquire more than one of
-    // these mutexes at once, you must follow the following rules:
+    // protected by its own mutex. Cursors are assigned to partitions by the low bits of their id,
+    // which are random, so that pinning and unpinning different cursors rarely contend. A cursor
+    // id is checked for uniqueness and inserted into '_cursorMap' under the lock of its partition.
+    // Separately, there is a '_registrationLock' which protects concurrent access to '_random' for
+    // cursor id generation, and is only held while drawing a candidate id. If you ever need to
+    // acquire more than one of these mutexes at once, you must follow the following rules:
     // - '_registrationLock' must be acquired first, if at all.
     // - Mutex(es) for '_registeredPlanExecutors' must be acquired next.
     // - Mutex(es) for '_cursorMap' must be acquired next.
     // - If you need to access multiple partitions within '_registeredPlanExecutors' or '_cursorMap'
     //   at once, you must acquire the mutexes for those partitions in ascending order, or use the
     //   partition helpers to acquire mutexes for all partitions.
-    mutable SimpleMutex _registrationLock;
+    mutable AdaptiveMutex _registrationLock;
     std::unique_ptr<PseudoRandom> _random;
     Partitioned<unordered_set<PlanExecutor*>, kNumPartitions, PlanExecutorPartitioner>
         _registeredPlanExecutors;
@@ -58,11 +58,13 @@
 #include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
+#include "mongo/db/commands/bulk_load_registry.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/deferred_index_applier.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -716,7 +718,11 @@ ExitCode _initAndListen(int listenPort) {
 
         startMongoDFTDC();
 
-        restartInProgressIndexesFromLastShutdown(startupOpCtx.get());
+        // The writes to deferred indexes which had not been applied are lost if the server did
+        // not shut down cleanly.
+        restartInProgressIndexesFromLastShutdown(startupOpCtx.get(),
+                                                 serviceContext->wasUncleanShutdown());
+        startDeferredIndexApplier();
 
         if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
             // Note: For replica sets, ShardingStateRecovery happens on transition to primary.
@@ -983,6 +989,8 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(CreateReplicationManager,
 
     repl::TopologyCoordinatorImpl::Options topoCoordOptions;
     topoCoordOptions.maxSyncSourceLagSecs = Seconds(repl::maxSyncSourceLagSecs);
+    topoCoordOptions.syncSourceFanoutPenalty =
+        Milliseconds(repl::syncSourceFanoutPenaltyMillis);
     topoCoordOptions.clusterRole = serverGlobalParams.clusterRole;
 
     auto logicalClock = stdx::make_unique<LogicalClock>(serviceContext);
@@ -1118,6 +1126,14 @@ void shutdownTask() {
 
     HealthLog::get(serviceContext).shutdown();
 
+    shutdownDeferredProfileWriter();
+
+    // Apply the remaining writes to deferred indexes while operations may still take locks.
+    shutdownDeferredIndexApplier();
+
+    // Unfinished bulk loads hold collection locks until their loaders are destroyed.
+    BulkLoadRegistry::get()->abortAll();
+
     // We should always be able to acquire the global lock at shutdown.
     //
     // TODO: This call chain uses the locker directly, because we do not want to start an
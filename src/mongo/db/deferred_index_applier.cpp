@@ -0,0 +1,197 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/deferred_index_applier.h"
+
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/deferred_index_collection_cache.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_build_interceptor.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+Counter64 deferredIndexPasses;
+
+ServerStatusMetricField<Counter64> deferredIndexPassesDisplay("deferredIndexes.passes",
+                                                              &deferredIndexPasses);
+
+// How long the writes to deferred indexes may wait before they are applied.
+MONGO_EXPORT_SERVER_PARAMETER(deferredIndexApplyIntervalMillis, int, 100);
+
+/**
+ * Periodically applies the writes of the deferred indexes of every collection registered with
+ * the DeferredIndexCollectionCache.
+ */
+class DeferredIndexApplier {
+    MONGO_DISALLOW_COPYING(DeferredIndexApplier);
+
+public:
+    DeferredIndexApplier() = default;
+
+    void start() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        invariant(!_thread.joinable());
+        _thread = stdx::thread([this] { _run(); });
+    }
+
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inShutdown = true;
+            _condvar.notify_one();
+        }
+
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+private:
+    void _run() {
+        Client::initThread("DeferredIndexApplier");
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        while (true) {
+            bool inShutdown;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                const Milliseconds interval(std::max(1, deferredIndexApplyIntervalMillis.load()));
+                _condvar.wait_for(
+                    lk, interval.toSystemDuration(), [this] { return _inShutdown; });
+                inShutdown = _inShutdown;
+            }
+
+            // The last pass applies the writes made before shutdown.
+            _doPass();
+            if (inShutdown) {
+                return;
+            }
+        }
+    }
+
+    void _doPass() {
+        deferredIndexPasses.increment();
+
+        auto opCtx = cc().makeOperationContext();
+        auto collections =
+            DeferredIndexCollectionCache::get(getGlobalServiceContext()).getCollections();
+        for (const std::string& ns : collections) {
+            try {
+                AutoGetCollection autoColl(opCtx.get(), NamespaceString(ns), MODE_IX);
+                Collection* collection = autoColl.getCollection();
+                if (!collection) {
+                    // Skip since the collection has been dropped.
+                    continue;
+                }
+
+                Status status = applyDeferredIndexWrites(opCtx.get(), collection);
+                if (!status.isOK()) {
+                    error() << "Failed to apply writes to the deferred indexes of " << ns << ": "
+                            << redact(status);
+                }
+            } catch (const DBException& ex) {
+                warning() << "Caught exception while applying writes to the deferred indexes of "
+                          << ns << ": " << redact(ex);
+            }
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    bool _inShutdown = false;
+
+    stdx::thread _thread;
+};
+
+DeferredIndexApplier* getDeferredIndexApplier() {
+    // Intentionally leaked so that the applier thread never outlives its owner during exit.
+    static DeferredIndexApplier* const applier = new DeferredIndexApplier();
+    return applier;
+}
+
+}  // namespace
+
+void startDeferredIndexApplier() {
+    getDeferredIndexApplier()->start();
+}
+
+void shutdownDeferredIndexApplier() {
+    getDeferredIndexApplier()->shutdown();
+}
+
+Status applyDeferredIndexWrites(OperationContext* opCtx, Collection* collection) {
+    invariant(opCtx->lockState()->isCollectionLockedForMode(collection->ns().ns(), MODE_IX));
+
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii.more()) {
+        IndexDescriptor* descriptor = ii.next();
+        if (!descriptor->isDeferred()) {
+            continue;
+        }
+
+        IndexBuildInterceptor* interceptor = ii.catalogEntry(descriptor)->indexBuildInterceptor();
+        if (!interceptor) {
+            continue;
+        }
+
+        InsertDeleteOptions options;
+        IndexCatalog::prepareInsertDeleteOptions(opCtx, descriptor, &options);
+        Status status =
+            interceptor->drainWritesIntoIndex(opCtx, ii.accessMethod(descriptor), options);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+}  // namespace mongo
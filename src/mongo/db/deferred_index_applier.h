@@ -0,0 +1,58 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+class Collection;
+class OperationContext;
+
+/**
+ * Starts the background thread which applies the writes of deferred indexes, that is indexes
+ * created with {deferred: true}. Writers leave the maintenance of those indexes to this thread,
+ * so reads through a deferred index may not see writes made within about the last
+ * deferredIndexApplyIntervalMillis.
+ */
+void startDeferredIndexApplier();
+
+/**
+ * Stops the background thread, after applying the writes made so far.
+ */
+void shutdownDeferredIndexApplier();
+
+/**
+ * Applies the committed writes to the deferred indexes of 'collection' which haven't been applied
+ * yet. The caller must hold the collection lock in MODE_IX or stronger, and only one caller may
+ * apply the writes of a collection at a time.
+ */
+Status applyDeferredIndexWrites(OperationContext* opCtx, Collection* collection);
+
+}  // namespace mongo
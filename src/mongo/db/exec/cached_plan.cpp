@@ -32,7 +32,9 @@
 
 #include "mongo/db/exec/cached_plan.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/scoped_timer.h"
@@ -51,6 +53,14 @@
 
 namespace mongo {
 
+namespace {
+
+Counter64 evictionsDuringExecutionCounter;
+ServerStatusMetricField<Counter64> displayEvictionsDuringExecution(
+    "query.planCacheEvictionsDuringExecution", &evictionsDuringExecutionCounter);
+
+}  // namespace
+
 // static
 const char* CachedPlanStage::kStageType = "CACHED_PLAN";
 
@@ -60,13 +70,15 @@ CachedPlanStage::CachedPlanStage(OperationContext* opCtx,
                                  CanonicalQuery* cq,
                                  const QueryPlannerParams& params,
                                  size_t decisionWorks,
+                                 bool wantsFeedback,
                                  PlanStage* root)
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _ws(ws),
       _canonicalQuery(cq),
       _plannerParams(params),
-      _decisionWorks(decisionWorks) {
+      _decisionWorks(decisionWorks),
+      _wantsFeedback(wantsFeedback) {
     invariant(_collection);
     _children.emplace_back(root);
 }
@@ -106,6 +118,11 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
                 // Once a plan returns enough results, stop working. Update cache with stats
                 // from this run and return.
                 updatePlanCache();
+
+                // Keep an eye on the plan for the rest of its execution.
+                if (internalQueryCacheEvictDuringExecution.load()) {
+                    _maxWorksWithoutAdvance = maxWorksBeforeReplan;
+                }
                 return Status::OK();
             }
         } else if (PlanStage::IS_EOF == state) {
@@ -294,7 +311,54 @@ PlanStage::StageState CachedPlanStage::doWork(WorkingSetID* out) {
     }
 
     // Nothing left in trial period buffer.
-    return child()->work(out);
+    StageState state = child()->work(out);
+    if (_maxWorksWithoutAdvance > 0) {
+        monitorExecution(1, PlanStage::ADVANCED == state ? 1 : 0);
+    }
+    return state;
+}
+
+PlanStage::StageState CachedPlanStage::doWorkBatch(size_t maxWorks,
+                                                   std::vector<WorkingSetID>* results,
+                                                   WorkingSetID* out,
+                                                   size_t* worksPerformed) {
+    // Results buffered during the trial period go through the per-document path.
+    if (isEOF() || !_results.empty()) {
+        return PlanStage::doWorkBatch(maxWorks, results, out, worksPerformed);
+    }
+
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+    const size_t resultsBefore = results->size();
+    StageState state = child()->workBatch(maxWorks, results, out);
+    const size_t childWorks = child()->getCommonStats()->works - childWorksBefore;
+    *worksPerformed += childWorks;
+    if (_maxWorksWithoutAdvance > 0) {
+        monitorExecution(childWorks, results->size() - resultsBefore);
+    }
+    return state;
+}
+
+void CachedPlanStage::monitorExecution(size_t works, size_t advanced) {
+    if (advanced > 0) {
+        _worksWithoutAdvance = 0;
+        return;
+    }
+
+    _worksWithoutAdvance += works;
+    if (_worksWithoutAdvance <= _maxWorksWithoutAdvance) {
+        return;
+    }
+
+    LOG(1) << "Execution of cached plan went " << _worksWithoutAdvance
+           << " works without producing a result after its trial period, but was originally "
+           << "cached with only " << _decisionWorks << " works. Evicting cache entry for query: "
+           << redact(_canonicalQuery->toStringShort())
+           << " planSummary: " << redact(Explain::getPlanSummary(child().get()));
+
+    _collection->infoCache()->getPlanCache()->remove(*_canonicalQuery).transitional_ignore();
+    evictionsDuringExecutionCounter.increment();
+    _specificStats.evictedDuringExecution = true;
+    _maxWorksWithoutAdvance = 0;
 }
 
 void CachedPlanStage::doInvalidate(OperationContext* opCtx,
@@ -324,6 +388,11 @@ const SpecificStats* CachedPlanStage::getSpecificStats() const {
 }
 
 void CachedPlanStage::updatePlanCache() {
+    if (!_wantsFeedback) {
+        // The entry already holds as much feedback as it will store, so skip building stats.
+        return;
+    }
+
     std::unique_ptr<PlanCacheEntryFeedback> feedback = stdx::make_unique<PlanCacheEntryFeedback>();
     feedback->stats = getStats();
     feedback->score = PlanRanker::scoreTree(feedback->stats->children[0].get());
@@ -59,11 +59,16 @@ public:
                     CanonicalQuery* cq,
                     const QueryPlannerParams& params,
                     size_t decisionWorks,
+                    bool wantsFeedback,
                     PlanStage* root);
 
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out,
+                           size_t* worksPerformed) final;
 
     void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
@@ -116,6 +121,15 @@ private:
      */
     Status tryYield(PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Called after the cached plan has done 'works' work cycles past its trial period, of which
+     * it produced results in 'advanced'. Evicts the plan's cache entry once the plan has gone
+     * more than '_maxWorksWithoutAdvance' work cycles in a row without producing a result, so
+     * that the next run of the query replans. The plan itself keeps running, since results it
+     * already returned cannot be taken back.
+     */
+    void monitorExecution(size_t works, size_t advanced);
+
     // Not owned. Must be non-null.
     Collection* _collection;
 
@@ -131,6 +145,10 @@ private:
     // cached.
     size_t _decisionWorks;
 
+    // False if the plan cache entry had no room for more feedback when the cached solution was
+    // retrieved. In that case there is no point in gathering stats for updatePlanCache().
+    bool _wantsFeedback;
+
     // If we fall back to re-planning the query, and there is just one resulting query solution,
     // that solution is owned here.
     std::unique_ptr<QuerySolution> _replannedQs;
@@ -144,6 +162,12 @@ private:
     // just pass a NULL fetcher.
     std::unique_ptr<RecordFetcher> _fetcher;
 
+    // Once the cached plan has been kept after its trial period, the number of consecutive work
+    // cycles without a result after which its cache entry is evicted. Zero if the plan is not
+    // being monitored.
+    size_t _maxWorksWithoutAdvance = 0;
+    size_t _worksWithoutAdvance = 0;
+
     // Stats
     CachedPlanStats _specificStats;
 };
@@ -30,6 +30,9 @@
 
 #include "mongo/db/exec/collection_scan.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -38,8 +41,14 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -54,6 +63,107 @@ using stdx::make_unique;
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
+// static
+const int CollectionScan::kMaxParallelism = 64;
+
+namespace {
+
+// A parallel scan does not hand a thread fewer records than this.
+const size_t kMinRecordsPerRange = 64;
+
+// A shared scan reports its position to the other scans of the collection every this many records.
+const size_t kSharedScanReportInterval = 64;
+
+/**
+ * Returns the pool shared by all parallel collection scans. The pool is never shut down, so that
+ * it remains usable until the process exits.
+ */
+ThreadPool* getFilterPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "CollectionScanFilter";
+        options.minThreads = 0;
+        options.maxThreads = CollectionScan::kMaxParallelism;
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
+/**
+ * Tracks the shared collection scans running on each collection, and the position they most
+ * recently reported, which a new shared scan of the collection starts at.
+ */
+class SharedScanRegistry {
+public:
+    static SharedScanRegistry& get() {
+        static SharedScanRegistry* const registry = new SharedScanRegistry();
+        return *registry;
+    }
+
+    /**
+     * Registers a scan of 'ns', and returns the position of the scans already running on it. The
+     * position is null if there are none, or if none has reported its position yet.
+     */
+    RecordId join(const std::string& ns) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto& scans = _scansByNs[ns];
+        ++scans.numScans;
+        return scans.position;
+    }
+
+    void report(const std::string& ns, const RecordId& position) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _scansByNs.find(ns);
+        if (it != _scansByNs.end()) {
+            it->second.position = position;
+        }
+    }
+
+    void leave(const std::string& ns) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _scansByNs.find(ns);
+        invariant(it != _scansByNs.end());
+        if (--it->second.numScans == 0) {
+            _scansByNs.erase(it);
+        }
+    }
+
+private:
+    struct Scans {
+        RecordId position;
+        int numScans = 0;
+    };
+
+    stdx::mutex _mutex;
+    std::map<std::string, Scans> _scansByNs;
+};
+
+/**
+ * Returns whether 'expr' can be matched concurrently on other threads. $where and $expr are
+ * evaluated using state owned by the operation, so they must stay on its thread.
+ */
+bool canMatchOnAnyThread(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::WHERE:
+        case MatchExpression::EXPRESSION:
+        case MatchExpression::TEXT:
+            return false;
+        default:
+            break;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canMatchOnAnyThread(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 CollectionScan::CollectionScan(OperationContext* opCtx,
                                const CollectionScanParams& params,
                                WorkingSet* workingSet,
@@ -67,6 +177,110 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
     invariant(!_params.shouldTrackLatestOplogTimestamp || _params.collection->ns().isOplog());
+
+    if (shouldFilterInParallel()) {
+        _parallelism =
+            std::min(internalQueryExecCollectionScanParallelism.load(), kMaxParallelism);
+        _specificStats.parallelism = _parallelism;
+    }
+
+    if (_filter && internalQueryCompileMatchExpressions.load()) {
+        _compiledFilter = CompiledMatchExpression::compile(_filter);
+    }
+
+    _specificStats.shared = canShareScan();
+}
+
+CollectionScan::~CollectionScan() {
+    leaveSharedScan();
+}
+
+bool CollectionScan::canShareScan() const {
+    if (!_params.shared || _params.direction != CollectionScanParams::FORWARD ||
+        _params.tailable || !_params.start.isNull()) {
+        return false;
+    }
+
+    // Wrapping around relies on every record which is read after the end having a RecordId
+    // smaller than the one the scan started at.
+    const Collection* collection = _params.collection;
+    return !collection->isCapped() && !collection->ns().isOplog() &&
+        collection->getRecordStore()->isInRecordIdOrder();
+}
+
+void CollectionScan::joinSharedScan() {
+    invariant(_sharedScanNs.empty());
+    _sharedScanNs = _params.collection->ns().ns();
+    _sharedScanStart = SharedScanRegistry::get().join(_sharedScanNs);
+    _sharedScanSeekPending = !_sharedScanStart.isNull();
+    _specificStats.joinedSharedScan = _sharedScanSeekPending;
+}
+
+void CollectionScan::leaveSharedScan() {
+    if (!_sharedScanNs.empty()) {
+        SharedScanRegistry::get().leave(_sharedScanNs);
+        _sharedScanNs.clear();
+    }
+}
+
+boost::optional<Record> CollectionScan::nextRecord() {
+    if (_sharedScanSeekPending) {
+        if (auto record = _cursor->seekExact(_sharedScanStart)) {
+            _sharedScanSeekPending = false;
+            return record;
+        }
+
+        // The record the other scans reported has since been deleted, so read the whole
+        // collection from the beginning instead.
+        _sharedScanSeekPending = false;
+        _sharedScanStart = RecordId();
+        _specificStats.joinedSharedScan = false;
+        _cursor = _params.collection->getCursor(getOpCtx(), true);
+    }
+
+    boost::optional<Record> record = _cursor->next();
+    if (!_sharedScanStart.isNull()) {
+        if (!record && !_sharedScanWrapped) {
+            _sharedScanWrapped = true;
+            _cursor = _params.collection->getCursor(getOpCtx(), true);
+            record = _cursor->next();
+        }
+        if (record && _sharedScanWrapped && record->id >= _sharedScanStart) {
+            // The rest of the collection was read before wrapping around.
+            record = boost::none;
+        }
+    }
+
+    if (!record) {
+        leaveSharedScan();
+    } else if (!_sharedScanNs.empty() &&
+               ++_recordsSinceSharedScanReport >= kSharedScanReportInterval) {
+        SharedScanRegistry::get().report(_sharedScanNs, record->id);
+        _recordsSinceSharedScanReport = 0;
+    }
+    return record;
+}
+
+bool CollectionScan::shouldFilterInParallel() const {
+    if (internalQueryExecCollectionScanParallelism.load() <= 1 || !_filter) {
+        return false;
+    }
+
+    // Only plain scans read ahead: the other options depend on examining one record at a time.
+    if (_params.tailable || _params.shouldTrackLatestOplogTimestamp ||
+        _params.stopApplyingFilterAfterFirstMatch || _params.maxScan != 0 ||
+        !_params.start.isNull()) {
+        return false;
+    }
+
+    // Records read ahead of the cursor are not fetched with a RecordFetcher, which is only needed
+    // by storage engines that lack document-level locking.
+    auto storageEngine = getOpCtx()->getServiceContext()->getGlobalStorageEngine();
+    if (!storageEngine || !storageEngine->supportsDocLocking()) {
+        return false;
+    }
+
+    return canMatchOnAnyThread(_filter);
 }
 
 PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
@@ -89,6 +303,14 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_readAheadPos < _readAhead.size()) {
+        return returnReadAhead(out);
+    }
+
+    if (_parallelism > 1 && _cursor) {
+        return readAhead(out);
+    }
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
@@ -109,6 +331,9 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             }
 
             _cursor = _params.collection->getCursor(getOpCtx(), forward);
+            if (_specificStats.shared && _sharedScanNs.empty() && _lastSeenId.isNull()) {
+                joinSharedScan();
+            }
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
@@ -146,7 +371,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
                 return PlanStage::NEED_YIELD;
             }
 
-            record = _cursor->next();
+            record = nextRecord();
         }
     } catch (const WriteConflictException&) {
         // Leave us in a state to try again next time.
@@ -187,6 +412,152 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     return returnIfMatches(member, id, out);
 }
 
+PlanStage::StageState CollectionScan::doWorkBatch(size_t maxWorks,
+                                                  std::vector<WorkingSetID>* results,
+                                                  WorkingSetID* out,
+                                                  size_t* worksPerformed) {
+    const size_t resultsBefore = results->size();
+    for (size_t i = 0; i < maxWorks; ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        ++*worksPerformed;
+
+        if (PlanStage::ADVANCED == state) {
+            // The record data is only valid until the cursor moves again, so a result that is
+            // kept in the batch while we scan further must own its document.
+            _workingSet->get(id)->makeObjOwnedIfNeeded();
+            results->push_back(id);
+        } else if (PlanStage::NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+    }
+
+    return results->size() > resultsBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+PlanStage::StageState CollectionScan::readAhead(WorkingSetID* out) {
+    invariant(_readAhead.empty());
+    const size_t batchSize =
+        std::max(internalQueryExecCollectionScanParallelBatchSize.load(), 1);
+    _readAhead.reserve(batchSize);
+    try {
+        while (_readAhead.size() < batchSize) {
+            boost::optional<Record> record = nextRecord();
+            if (!record) {
+                _cursorExhausted = true;
+                break;
+            }
+
+            _lastSeenId = record->id;
+            ReadAheadRecord readAheadRecord;
+            readAheadRecord.id = record->id;
+            readAheadRecord.obj = record->data.releaseToBson().getOwned();
+            _readAhead.push_back(std::move(readAheadRecord));
+        }
+    } catch (const WriteConflictException&) {
+        // Filter whatever we managed to read. The next read retries the cursor.
+        if (_readAhead.empty()) {
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+    }
+    _readAheadSnapshotId = getOpCtx()->recoveryUnit()->getSnapshotId();
+
+    Status status = filterReadAhead();
+    if (!status.isOK()) {
+        _readAhead.clear();
+        *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+        return PlanStage::FAILURE;
+    }
+    _specificStats.docsTested += _readAhead.size();
+
+    return returnReadAhead(out);
+}
+
+Status CollectionScan::filterReadAhead() {
+    const size_t numRecords = _readAhead.size();
+    if (numRecords == 0) {
+        return Status::OK();
+    }
+
+    const size_t numRanges = std::min(static_cast<size_t>(_parallelism),
+                                      (numRecords + kMinRecordsPerRange - 1) / kMinRecordsPerRange);
+    const size_t rangeSize = (numRecords + numRanges - 1) / numRanges;
+
+    auto filterRange = [this, numRecords, rangeSize](size_t range) -> Status {
+        try {
+            const size_t end = std::min(numRecords, (range + 1) * rangeSize);
+            for (size_t i = range * rangeSize; i < end; ++i) {
+                _readAhead[i].matches = _compiledFilter
+                    ? _compiledFilter->matchesBSON(_readAhead[i].obj)
+                    : _filter->matchesBSON(_readAhead[i].obj);
+            }
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return Status::OK();
+    };
+
+    stdx::mutex mutex;
+    stdx::condition_variable rangesDone;
+    size_t pendingRanges = 0;
+    Status result = Status::OK();
+    auto finishRange = [&](const Status& status) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (!status.isOK() && result.isOK()) {
+            result = status;
+        }
+        if (--pendingRanges == 0) {
+            rangesDone.notify_all();
+        }
+    };
+
+    // Hand all but the first range to the pool, and filter the first one on this thread.
+    for (size_t range = 1; range < numRanges; ++range) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++pendingRanges;
+        }
+        Status scheduled = getFilterPool()->schedule(
+            [&filterRange, &finishRange, range] { finishRange(filterRange(range)); });
+        if (!scheduled.isOK()) {
+            finishRange(filterRange(range));
+        }
+    }
+
+    Status firstRangeStatus = filterRange(0);
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    rangesDone.wait(lk, [&] { return pendingRanges == 0; });
+    return firstRangeStatus.isOK() ? result : firstRangeStatus;
+}
+
+PlanStage::StageState CollectionScan::returnReadAhead(WorkingSetID* out) {
+    while (_readAheadPos < _readAhead.size()) {
+        ReadAheadRecord& record = _readAhead[_readAheadPos++];
+        if (!record.matches) {
+            continue;
+        }
+
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = record.id;
+        member->obj = {_readAheadSnapshotId, std::move(record.obj)};
+        _workingSet->transitionToRecordIdAndObj(id);
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
+    _readAhead.clear();
+    _readAheadPos = 0;
+    if (_cursorExhausted) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+    return PlanStage::NEED_TIME;
+}
+
 Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()["ts"];
     if (tsElem.type() != BSONType::bsonTimestamp) {
@@ -205,9 +576,13 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    // Collection scan members always hold the full document.
+    const bool matches = _compiledFilter ? _compiledFilter->matchesBSON(member->obj.value())
+                                         : Filter::passes(member, _filter);
+    if (matches) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -237,6 +612,13 @@ void CollectionScan::doInvalidate(OperationContext* opCtx,
         _cursor->invalidate(opCtx, id);
     }
 
+    // Records which were read ahead but not yet returned must not be returned once deleted.
+    for (size_t i = _readAheadPos; i < _readAhead.size(); ++i) {
+        if (_readAhead[i].id == id) {
+            _readAhead[i].matches = false;
+        }
+    }
+
     if (_params.tailable && id == _lastSeenId) {
         // This means that deletes have caught up to the reader. We want to error in this case
         // so readers don't miss potentially important data.
@@ -28,12 +28,17 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/snapshot.h"
 
 namespace mongo {
 
@@ -46,6 +51,18 @@ class OperationContext;
  * Scans over a collection, starting at the RecordId provided in params and continuing until
  * there are no more records in the collection.
  *
+ * If internalQueryExecCollectionScanParallelism is greater than one, a scan with a filter that
+ * is safe to evaluate off the operation's thread reads records ahead in batches and splits each
+ * batch into contiguous ranges of RecordIds whose documents are matched against the filter on
+ * worker threads. The cursor is only ever used by the thread calling work(), so yielding and
+ * interruption behave exactly as they do for a serial scan.
+ *
+ * A shared scan starts at the position most recently reported by the other shared scans of the
+ * same collection, if there are any, reads to the end and then wraps around to read the records
+ * before the position it started at. Scans of a large collection which run at the same time thus
+ * read the same records while they are in the cache rather than each reading the whole collection
+ * separately.
+ *
  * Preconditions: Valid RecordId.
  */
 class CollectionScan final : public PlanStage {
@@ -55,7 +72,13 @@ public:
                    WorkingSet* workingSet,
                    const MatchExpression* filter);
 
+    ~CollectionScan();
+
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out,
+                           size_t* worksPerformed) final;
     bool isEOF() final;
 
     void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
@@ -78,7 +101,64 @@ public:
 
     static const char* kStageType;
 
+    // The largest number of threads a single scan will use to evaluate its filter.
+    static const int kMaxParallelism;
+
 private:
+    /**
+     * A record which has been read ahead of the scan's position but not yet returned.
+     */
+    struct ReadAheadRecord {
+        RecordId id;
+        BSONObj obj;
+        bool matches = false;
+    };
+
+    /**
+     * Returns whether this scan should evaluate its filter on multiple threads.
+     */
+    bool shouldFilterInParallel() const;
+
+    /**
+     * Returns whether this scan can share its position with other scans of the collection.
+     */
+    bool canShareScan() const;
+
+    /**
+     * Registers this scan as a shared scan of the collection, starting at the position of the
+     * shared scans which are already running on it.
+     */
+    void joinSharedScan();
+
+    /**
+     * Unregisters this scan from the shared scans of the collection, if it is registered.
+     */
+    void leaveSharedScan();
+
+    /**
+     * Returns the next record from '_cursor', or boost::none at the end of the scan. A shared scan
+     * which started partway through the collection continues from the beginning once it reaches
+     * the end, and stops before the record it started at.
+     */
+    boost::optional<Record> nextRecord();
+
+    /**
+     * Reads the next batch of records into '_readAhead' and matches them against the filter.
+     */
+    StageState readAhead(WorkingSetID* out);
+
+    /**
+     * Sets 'matches' for every record in '_readAhead', splitting the work among up to
+     * '_parallelism' threads. Returns the first error encountered by any of them.
+     */
+    Status filterReadAhead();
+
+    /**
+     * Returns the next matching record from '_readAhead' as ADVANCED, or NEED_TIME or IS_EOF once
+     * the batch has been used up.
+     */
+    StageState returnReadAhead(WorkingSetID* out);
+
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
      * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
@@ -98,6 +178,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // A compiled form of '_filter' used in its place, if the filter could be compiled.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
     CollectionScanParams _params;
@@ -115,6 +198,34 @@ private:
     // timestamp seen in the collection.  Otherwise, this is a null timestamp.
     Timestamp _latestOplogEntryTimestamp;
 
+    // The number of threads used to evaluate the filter. One if the scan is not parallel.
+    int _parallelism = 1;
+
+    // Records read by a parallel scan and the snapshot they were read in. Entries before
+    // '_readAheadPos' have already been returned or skipped.
+    std::vector<ReadAheadRecord> _readAhead;
+    size_t _readAheadPos = 0;
+    SnapshotId _readAheadSnapshotId;
+
+    // Set once a parallel scan has read the last record from '_cursor'.
+    bool _cursorExhausted = false;
+
+    // The namespace this scan is registered under as a shared scan. Empty if it is not registered.
+    std::string _sharedScanNs;
+
+    // Where a shared scan started and will stop after wrapping around. Null if it started at the
+    // beginning of the collection.
+    RecordId _sharedScanStart;
+
+    // Set until '_cursor' has been positioned at '_sharedScanStart'.
+    bool _sharedScanSeekPending = false;
+
+    // Set once a shared scan has reached the end of the collection and wrapped around.
+    bool _sharedScanWrapped = false;
+
+    // The number of records read since this scan last reported its position to the other scans.
+    size_t _recordsSinceSharedScanReport = 0;
+
     // Stats
     CollectionScanStats _specificStats;
 };
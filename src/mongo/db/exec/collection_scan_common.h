@@ -65,6 +65,11 @@ struct CollectionScanParams {
 
     // If non-zero, how many documents will we look at?
     size_t maxScan = 0;
+
+    // May a forward scan start at the position of another shared scan of the collection, and
+    // wrap around to the records before it once it reaches the end? Results are then not in
+    // natural order. Only honoured for non-capped collections whose records are in RecordId order.
+    bool shared = false;
 };
 
 }  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/column_scan.h"
+
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* ColumnScanStage::kStageType = "COLUMN_SCAN";
+
+ColumnScanStage::ColumnScanStage(OperationContext* opCtx,
+                                 std::shared_ptr<ColumnProjectionCache> cache,
+                                 WorkingSet* workingSet,
+                                 const MatchExpression* filter)
+    : PlanStage(kStageType, opCtx),
+      _cache(std::move(cache)),
+      _workingSet(workingSet),
+      _filter(filter) {
+    invariant(_cache);
+    _specificStats.cachedFields = _cache->getFields();
+}
+
+PlanStage::StageState ColumnScanStage::doWork(WorkingSetID* out) {
+    if (_isEOF) {
+        return PlanStage::IS_EOF;
+    }
+
+    BSONObj obj;
+    if (!_cache->next(&_nextRow, &obj)) {
+        if (!_cache->isValid()) {
+            Status status(ErrorCodes::QueryPlanKilled,
+                          "column projection cache was dropped during the scan");
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+            return PlanStage::DEAD;
+        }
+        _isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    ++_specificStats.rowsExamined;
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), obj};
+    _workingSet->transitionToOwnedObj(id);
+
+    if (!Filter::passes(member, _filter)) {
+        _workingSet->free(id);
+        return PlanStage::NEED_TIME;
+    }
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+bool ColumnScanStage::isEOF() {
+    return _isEOF;
+}
+
+unique_ptr<PlanStageStats> ColumnScanStage::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (NULL != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_COLUMN_SCAN);
+    ret->specific = make_unique<ColumnScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ColumnScanStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/query/column_projection_cache.h"
+
+namespace mongo {
+
+class WorkingSet;
+class OperationContext;
+
+/**
+ * Scans over a collection's column projection cache, producing owned documents which hold only
+ * the cached fields of each document in the collection. Documents which do not pass 'filter' are
+ * skipped.
+ *
+ * The results have no RecordId, so this stage can only answer queries which need nothing but
+ * the cached fields. If the cache is invalidated while the scan is running, the stage dies.
+ */
+class ColumnScanStage final : public PlanStage {
+public:
+    ColumnScanStage(OperationContext* opCtx,
+                    std::shared_ptr<ColumnProjectionCache> cache,
+                    WorkingSet* workingSet,
+                    const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    const std::shared_ptr<ColumnProjectionCache> _cache;
+
+    // WorkingSet is not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    // The next row of the cache to examine.
+    ColumnProjectionCache::RowId _nextRow = 0;
+
+    bool _isEOF = false;
+
+    ColumnScanStats _specificStats;
+};
+
+}  // namespace mongo
@@ -30,10 +30,17 @@
 
 #include "mongo/db/exec/count.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/index_prefix_counts.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -56,13 +63,22 @@ CountStage::CountStage(OperationContext* opCtx,
       _ws(ws) {
     if (child)
         _children.emplace_back(child);
+    if (_params.prefixCountIndex) {
+        _specificStats.prefixCountIndexName = _params.prefixCountIndex->indexName();
+    }
+    _specificStats.subtractOrphans = _params.subtractOrphans;
 }
 
 bool CountStage::isEOF() {
-    if (_specificStats.recordStoreCount) {
+    if (_specificStats.recordStoreCount || _specificStats.prefixCount) {
         return true;
     }
 
+    if (_params.subtractOrphans) {
+        // The count is only taken once all the orphans have been counted.
+        return false;
+    }
+
     if (_params.limit > 0 && _specificStats.nCounted >= _params.limit) {
         return true;
     }
@@ -70,9 +86,26 @@ bool CountStage::isEOF() {
     return !_children.empty() && child()->isEOF();
 }
 
-void CountStage::recordStoreCount() {
+Status CountStage::statisticsCount() {
     invariant(_collection);
-    long long nCounted = _collection->numRecords(getOpCtx());
+    long long nCounted;
+    if (_params.prefixCountIndex) {
+        const IndexCatalogEntry* entry =
+            _collection->getIndexCatalog()->getEntry(_params.prefixCountIndex);
+        auto count = entry->prefixCounts()->count(_params.prefixCountKeys);
+        if (!count) {
+            return {ErrorCodes::QueryPlanKilled,
+                    str::stream() << "the prefix counts of index "
+                                  << _params.prefixCountIndex->indexName()
+                                  << " were reset during the count"};
+        }
+        nCounted = *count;
+    } else {
+        nCounted = _collection->numRecords(getOpCtx());
+    }
+
+    // Documents can be written between the reads of the count and of the orphans.
+    nCounted = std::max(0LL, nCounted - _specificStats.nOrphans);
 
     if (0 != _params.skip) {
         nCounted -= _params.skip;
@@ -92,16 +125,24 @@ void CountStage::recordStoreCount() {
 
     _specificStats.nCounted = nCounted;
     _specificStats.nSkipped = _params.skip;
-    _specificStats.recordStoreCount = true;
+    if (_params.prefixCountIndex) {
+        _specificStats.prefixCount = true;
+    } else {
+        _specificStats.recordStoreCount = true;
+    }
+    return Status::OK();
 }
 
 PlanStage::StageState CountStage::doWork(WorkingSetID* out) {
     // This stage never returns a working set member.
     *out = WorkingSet::INVALID_ID;
 
-    if (_params.useRecordStoreCount) {
-        invariant(_collection);
-        recordStoreCount();
+    if ((_params.useRecordStoreCount || _params.prefixCountIndex) && !_params.subtractOrphans) {
+        Status status = statisticsCount();
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
         return PlanStage::IS_EOF;
     }
 
@@ -117,6 +158,13 @@ PlanStage::StageState CountStage::doWork(WorkingSetID* out) {
     PlanStage::StageState state = child()->work(&id);
 
     if (PlanStage::IS_EOF == state) {
+        if (_params.subtractOrphans) {
+            Status status = statisticsCount();
+            if (!status.isOK()) {
+                *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                return PlanStage::FAILURE;
+            }
+        }
         _commonStats.isEOF = true;
         return PlanStage::IS_EOF;
     } else if (PlanStage::DEAD == state) {
@@ -134,7 +182,9 @@ PlanStage::StageState CountStage::doWork(WorkingSetID* out) {
     } else if (PlanStage::ADVANCED == state) {
         // We got a result. If we're still skipping, then decrement the number left to skip.
         // Otherwise increment the count until we hit the limit.
-        if (_leftToSkip > 0) {
+        if (_params.subtractOrphans) {
+            _specificStats.nOrphans++;
+        } else if (_leftToSkip > 0) {
             _leftToSkip--;
             _specificStats.nSkipped++;
         } else {
@@ -29,11 +29,15 @@
 #pragma once
 
 
+#include <vector>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/query/count_request.h"
 
 namespace mongo {
 
+class IndexDescriptor;
+
 struct CountStageParams {
     CountStageParams(const CountRequest& request, bool useRecordStoreCount)
         : nss(request.getNs()),
@@ -56,6 +60,16 @@ struct CountStageParams {
     // Note: This strategy can lead to inaccurate counts on certain storage engines (including
     // WiredTiger).
     bool useRecordStoreCount;
+
+    // If set, the count is the number of documents with one of 'prefixCountKeys' as the value of
+    // the leading field of this index, as kept by its prefix counts. Not owned here.
+    const IndexDescriptor* prefixCountIndex = nullptr;
+    std::vector<BSONObj> prefixCountKeys;
+
+    // True if the count is taken from the record store or from prefix counts, which include the
+    // orphaned documents of a sharded collection. The child stage then returns the orphans that
+    // match the query, which are subtracted from the count.
+    bool subtractOrphans = false;
 };
 
 /**
@@ -92,12 +106,13 @@ public:
 
 private:
     /**
-     * Asks the record store for the count, applying the skip and limit if necessary. The result is
-     * stored in '_specificStats'.
+     * Asks the record store or the prefix counts of an index for the count, subtracting the
+     * orphans counted so far and applying the skip and limit if necessary. The result is stored in
+     * '_specificStats'.
      *
-     * This is only valid if the query and hint are both empty.
+     * This is only valid if the query is empty, or if it is answered by the prefix counts.
      */
-    void recordStoreCount();
+    Status statisticsCount();
 
     // The collection over which we are counting.
     Collection* _collection;
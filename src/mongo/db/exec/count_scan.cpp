@@ -89,6 +89,12 @@ CountScan::CountScan(OperationContext* opCtx, const CountScanParams& params, Wor
     _specificStats.isPartial = _params.descriptor->isPartial();
     _specificStats.indexVersion = static_cast<int>(_params.descriptor->version());
 
+    if (!_params.bounds.fields.empty()) {
+        _checker = stdx::make_unique<IndexBoundsChecker>(
+            &_params.bounds, _params.descriptor->keyPattern(), 1);
+        return;
+    }
+
     // endKey must be after startKey in index order since we only do forward scans.
     dassert(_params.startKey.woCompare(_params.endKey,
                                        Ordering::make(params.descriptor->keyPattern()),
@@ -103,17 +109,26 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
     boost::optional<IndexKeyEntry> entry;
     const bool needInit = !_cursor;
     try {
-        // We don't care about the keys.
-        const auto kWantLoc = SortedDataInterface::Cursor::kWantLoc;
+        // We don't care about the keys, unless they must be checked against the bounds.
+        const auto parts = _checker ? SortedDataInterface::Cursor::kKeyAndLoc
+                                    : SortedDataInterface::Cursor::kWantLoc;
 
         if (needInit) {
             // First call to work().  Perform cursor init.
             _cursor = _iam->newCursor(getOpCtx());
-            _cursor->setEndPosition(_params.endKey, _params.endKeyInclusive);
-
-            entry = _cursor->seek(_params.startKey, _params.startKeyInclusive, kWantLoc);
+            if (_checker) {
+                if (_checker->getStartSeekPoint(&_seekPoint)) {
+                    entry = _cursor->seek(_seekPoint, parts);
+                }
+            } else {
+                _cursor->setEndPosition(_params.endKey, _params.endKeyInclusive);
+                entry = _cursor->seek(_params.startKey, _params.startKeyInclusive, parts);
+            }
+        } else if (_needSeek) {
+            entry = _cursor->seek(_seekPoint, parts);
+            _needSeek = false;
         } else {
-            entry = _cursor->next(kWantLoc);
+            entry = _cursor->next(parts);
         }
     } catch (const WriteConflictException&) {
         if (needInit) {
@@ -126,6 +141,21 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
 
     ++_specificStats.keysExamined;
 
+    if (entry && _checker) {
+        switch (_checker->checkKey(entry->key, &_seekPoint)) {
+            case IndexBoundsChecker::VALID:
+                break;
+
+            case IndexBoundsChecker::DONE:
+                entry = boost::none;
+                break;
+
+            case IndexBoundsChecker::MUST_ADVANCE:
+                _needSeek = true;
+                return PlanStage::NEED_TIME;
+        }
+    }
+
     if (!entry) {
         _commonStats.isEOF = true;
         _cursor.reset();
@@ -192,10 +222,14 @@ unique_ptr<PlanStageStats> CountScan::getStats() {
     unique_ptr<CountScanStats> countStats = make_unique<CountScanStats>(_specificStats);
     countStats->keyPattern = _specificStats.keyPattern.getOwned();
 
-    countStats->startKey = replaceBSONFieldNames(_params.startKey, countStats->keyPattern);
-    countStats->startKeyInclusive = _params.startKeyInclusive;
-    countStats->endKey = replaceBSONFieldNames(_params.endKey, countStats->keyPattern);
-    countStats->endKeyInclusive = _params.endKeyInclusive;
+    if (_checker) {
+        countStats->indexBounds = _params.bounds.toBSON();
+    } else {
+        countStats->startKey = replaceBSONFieldNames(_params.startKey, countStats->keyPattern);
+        countStats->startKeyInclusive = _params.startKeyInclusive;
+        countStats->endKey = replaceBSONFieldNames(_params.endKey, countStats->keyPattern);
+        countStats->endKeyInclusive = _params.endKeyInclusive;
+    }
 
     ret->specific = std::move(countStats);
 
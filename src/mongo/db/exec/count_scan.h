@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
 
@@ -54,10 +55,15 @@ struct CountScanParams {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // If non-empty, the keys within these bounds are counted instead of those between 'startKey'
+    // and 'endKey'. The scan seeks over the gaps between intervals.
+    IndexBounds bounds;
 };
 
 /**
- * Used by the count command. Scans an index from a start key to an end key. Creates a
+ * Used by the count command. Scans an index from a start key to an end key, or over a set of
+ * index bounds. Creates a
  * WorkingSetMember for each matching index key in RID_AND_OBJ state. It has a null record id and an
  * empty object with a null snapshot id rather than real data. Returning real data is unnecessary
  * since all we need is the count.
@@ -97,6 +103,12 @@ private:
 
     std::unique_ptr<SortedDataInterface::Cursor> _cursor;
 
+    // Set when scanning '_params.bounds', in which case the checker tells us which keys fall in
+    // the bounds and where to seek to next when one does not.
+    std::unique_ptr<IndexBoundsChecker> _checker;
+    IndexSeekPoint _seekPoint;
+    bool _needSeek = false;
+
     // Could our index have duplicates?  If so, we use _returned to dedup.
     bool _shouldDedup;
     unordered_set<RecordId, RecordId::Hasher> _returned;
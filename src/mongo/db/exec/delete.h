@@ -62,6 +62,10 @@ struct DeleteStageParams {
     // Should we return the document we just deleted?
     bool returnDeleted;
 
+    // For a multi delete, the maximum number of documents to delete before reporting EOF. Zero
+    // means no limit.
+    long long limit = 0;
+
     // The stmtId for this particular delete.
     StmtId stmtId = kUninitializedStmtId;
 
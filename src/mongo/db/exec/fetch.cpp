@@ -71,6 +71,11 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (_nextChildResult < _childResults.size()) {
+        // We still have results from our child's last batch to fetch.
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -82,55 +87,19 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (_nextChildResult < _childResults.size()) {
+        status = ADVANCED;
+        id = _childResults[_nextChildResult++];
+    } else {
+        status = child()->work(&id);
     }
 
     if (PlanStage::ADVANCED == status) {
-        WorkingSetMember* member = _ws->get(id);
-
-        // If there's an obj there, there is no fetching to perform.
-        if (member->hasObj()) {
-            ++_specificStats.alreadyHasObj;
-        } else {
-            // We need a valid RecordId to fetch from and this is the only state that has one.
-            verify(WorkingSetMember::RID_AND_IDX == member->getState());
-            verify(member->hasRecordId());
-
-            try {
-                if (!_cursor)
-                    _cursor = _collection->getCursor(getOpCtx());
-
-                if (auto fetcher = _cursor->fetcherForId(member->recordId)) {
-                    // There's something to fetch. Hand the fetcher off to the WSM, and pass up
-                    // a fetch request.
-                    _idRetrying = id;
-                    member->setFetcher(fetcher.release());
-                    *out = id;
-                    return NEED_YIELD;
-                }
-
-                // The doc is already in memory, so go ahead and grab it. Now we have a RecordId
-                // as well as an unowned object
-                if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
-                    _ws->free(id);
-                    return NEED_TIME;
-                }
-            } catch (const WriteConflictException&) {
-                // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
-                // be freed when we yield.
-                member->makeObjOwnedIfNeeded();
-                _idRetrying = id;
-                *out = WorkingSet::INVALID_ID;
-                return NEED_YIELD;
-            }
-        }
-
-        return returnIfMatches(member, id, out);
+        return fetchAndFilter(id, out);
     } else if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
         *out = id;
         // If a stage fails, it may create a status WSM to indicate why it
@@ -150,6 +119,119 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatch(size_t maxWorks,
+                                              std::vector<WorkingSetID>* results,
+                                              WorkingSetID* out,
+                                              size_t* worksPerformed) {
+    // Finish the results we already hold one at a time before batching from our child again.
+    if (_idRetrying != WorkingSet::INVALID_ID || _nextChildResult < _childResults.size()) {
+        return PlanStage::doWorkBatch(maxWorks, results, out, worksPerformed);
+    }
+
+    if (isEOF()) {
+        ++*worksPerformed;
+        return PlanStage::IS_EOF;
+    }
+
+    _childResults.clear();
+    _nextChildResult = 0;
+    const size_t resultsBefore = results->size();
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxWorks, &_childResults, &id);
+
+    *worksPerformed += child()->getCommonStats()->works - childWorksBefore;
+    const bool childFailed = PlanStage::FAILURE == status || PlanStage::DEAD == status;
+
+    while (_nextChildResult < _childResults.size()) {
+        WorkingSetID memberID = _childResults[_nextChildResult++];
+        WorkingSetID fetchOut = WorkingSet::INVALID_ID;
+        StageState fetchState = fetchAndFilter(memberID, &fetchOut);
+
+        if (PlanStage::ADVANCED == fetchState) {
+            // Our cursor is repositioned for the next fetch, which invalidates unowned data.
+            _ws->get(memberID)->makeObjOwnedIfNeeded();
+            results->push_back(memberID);
+        } else if (PlanStage::NEED_YIELD == fetchState) {
+            if (!childFailed) {
+                // The rest of the child's batch is fetched once we are called again after the
+                // yield.
+                *out = fetchOut;
+                return PlanStage::NEED_YIELD;
+            }
+
+            // Our child failed, so there is no point in paging in the remaining documents.
+            _ws->free(_idRetrying);
+            _idRetrying = WorkingSet::INVALID_ID;
+            while (_nextChildResult < _childResults.size()) {
+                _ws->free(_childResults[_nextChildResult++]);
+            }
+        }
+    }
+
+    if (childFailed) {
+        *out = id;
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "fetch stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+        return status;
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+        return status;
+    } else if (PlanStage::IS_EOF == status) {
+        return status;
+    }
+
+    return results->size() > resultsBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+PlanStage::StageState FetchStage::fetchAndFilter(WorkingSetID memberID, WorkingSetID* out) {
+    WorkingSetMember* member = _ws->get(memberID);
+
+    // If there's an obj there, there is no fetching to perform.
+    if (member->hasObj()) {
+        ++_specificStats.alreadyHasObj;
+    } else {
+        // We need a valid RecordId to fetch from and this is the only state that has one.
+        verify(WorkingSetMember::RID_AND_IDX == member->getState());
+        verify(member->hasRecordId());
+
+        try {
+            if (!_cursor)
+                _cursor = _collection->getCursor(getOpCtx());
+
+            if (auto fetcher = _cursor->fetcherForId(member->recordId)) {
+                // There's something to fetch. Hand the fetcher off to the WSM, and pass up
+                // a fetch request.
+                _idRetrying = memberID;
+                member->setFetcher(fetcher.release());
+                *out = memberID;
+                return NEED_YIELD;
+            }
+
+            // The doc is already in memory, so go ahead and grab it. Now we have a RecordId
+            // as well as an unowned object
+            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, memberID, _cursor)) {
+                _ws->free(memberID);
+                return NEED_TIME;
+            }
+        } catch (const WriteConflictException&) {
+            // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
+            // be freed when we yield.
+            member->makeObjOwnedIfNeeded();
+            _idRetrying = memberID;
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+    }
+
+    return returnIfMatches(member, memberID, out);
+}
+
 void FetchStage::doSaveState() {
     if (_cursor)
         _cursor->saveUnpositioned();
@@ -180,6 +262,14 @@ void FetchStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inval
             WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
         }
     }
+
+    // The same goes for any results from our child's last batch that we haven't fetched yet.
+    for (size_t i = _nextChildResult; i < _childResults.size(); ++i) {
+        WorkingSetMember* member = _ws->get(_childResults[i]);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        }
+    }
 }
 
 PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
@@ -59,6 +59,10 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out,
+                           size_t* worksPerformed) final;
 
     void doSaveState() final;
     void doRestoreState() final;
@@ -77,6 +81,13 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Fetches the document for the member with id 'memberID' if it doesn't already have one, then
+     * applies our filter via returnIfMatches(). Returns NEED_YIELD and sets '_idRetrying' if the
+     * document must be paged in or the fetch hit a write conflict.
+     */
+    StageState fetchAndFilter(WorkingSetID memberID, WorkingSetID* out);
+
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
      * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
@@ -98,6 +109,12 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Results taken from our child by doWorkBatch() that we have not fetched yet, starting at
+    // index '_nextChildResult'. These are consumed after '_idRetrying' and before asking our
+    // child for more.
+    std::vector<WorkingSetID> _childResults;
+    size_t _nextChildResult = 0;
+
     // Stats
     FetchStats _specificStats;
 };
@@ -841,7 +841,57 @@ S2Region* buildS2Region(const R2Annulus& sphereBounds) {
     // Takes ownership of caps
     return new S2RegionIntersection(&regions);
 }
+
+// The next annulus aims to return this many times as many results as the previous one, so that
+// small limits are satisfied by a few narrow annuli while long scans still grow geometrically.
+const double kIntervalResultsGrowthFactor = 2.0;
+const double kMinIntervalResultsTarget = 32;
+const double kMaxIntervalResultsTarget = 600;
+
+// Bounds on how much the width of the annulus may change from one interval to the next, which
+// keep a single unusually sparse or dense annulus from skewing the estimate too far.
+const double kMaxBoundsIncrementChange = 8.0;
+
+// Area of a spherical cap of the given radius, in square meters.
+double capAreaInSquareMeters(double radiusInMeters) {
+    const double angle = std::min(std::max(radiusInMeters, 0.0) / kRadiusOfEarthInMeters, M_PI);
+    return 2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters * (1 - std::cos(angle));
+}
+
+// Radius of a spherical cap with the given area, in meters.
+double capRadiusInMeters(double areaInSquareMeters) {
+    const double cosAngle =
+        1 - areaInSquareMeters / (2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters);
+    return std::acos(std::min(std::max(cosAngle, -1.0), 1.0)) * kRadiusOfEarthInMeters;
+}
+
+/**
+ * Derives the width of the next annulus from the density of results observed in the last one,
+ * rather than doubling or halving a fixed width. Sparse regions then grow the search quickly
+ * and dense regions shrink it before large numbers of documents are buffered.
+ */
+double adaptBoundsIncrement(const IntervalStats& lastInterval, double lastIncrement) {
+    const double inner = lastInterval.minDistanceAllowed;
+    const double outer = lastInterval.maxDistanceAllowed;
+    const double lastArea = capAreaInSquareMeters(outer) - capAreaInSquareMeters(inner);
+    const double returned = static_cast<double>(lastInterval.numResultsReturned);
+
+    if (returned == 0 || lastArea <= 0) {
+        // Nothing found nearby: widen as aggressively as the change bound allows.
+        return lastIncrement * kMaxBoundsIncrementChange;
+    }
+
+    const double target = std::min(
+        std::max(returned * kIntervalResultsGrowthFactor, kMinIntervalResultsTarget),
+        kMaxIntervalResultsTarget);
+    const double targetArea = lastArea * (target / returned);
+    const double nextIncrement =
+        capRadiusInMeters(capAreaInSquareMeters(outer) + targetArea) - outer;
+
+    return std::min(std::max(nextIncrement, lastIncrement / kMaxBoundsIncrementChange),
+                    lastIncrement * kMaxBoundsIncrementChange);
 }
+}  // namespace
 
 // Estimate the density of data by search the nearest cells level by level around center.
 class GeoNear2DSphereStage::DensityEstimator {
@@ -1041,12 +1091,7 @@ StatusWith<NearStage::CoveredInterval*>  //
 
     if (!_specificStats.intervalStats.empty()) {
         const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement = adaptBoundsIncrement(lastIntervalStats, _boundsIncrement);
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -86,6 +86,42 @@ PlanStage::StageState LimitStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState LimitStage::doWorkBatch(size_t maxWorks,
+                                              std::vector<WorkingSetID>* results,
+                                              WorkingSetID* out,
+                                              size_t* worksPerformed) {
+    if (0 == _numToReturn) {
+        ++*worksPerformed;
+        return PlanStage::IS_EOF;
+    }
+
+    // Every unit of work produces at most one result, so capping the child's batch at the number
+    // of results we have left keeps us from overshooting the limit.
+    const size_t childMaxWorks = std::min(maxWorks, static_cast<size_t>(_numToReturn));
+    const size_t resultsBefore = results->size();
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(childMaxWorks, results, &id);
+
+    *worksPerformed += child()->getCommonStats()->works - childWorksBefore;
+    _numToReturn -= results->size() - resultsBefore;
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *out = id;
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "limit stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
 unique_ptr<PlanStageStats> LimitStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_LIMIT);
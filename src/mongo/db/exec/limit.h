@@ -49,6 +49,10 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out,
+                           size_t* worksPerformed) final;
 
     StageType stageType() const final {
         return STAGE_LIMIT;
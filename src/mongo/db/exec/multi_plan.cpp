@@ -143,6 +143,23 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
     return state;
 }
 
+PlanStage::StageState MultiPlanStage::doWorkBatch(size_t maxWorks,
+                                                  std::vector<WorkingSetID>* results,
+                                                  WorkingSetID* out,
+                                                  size_t* worksPerformed) {
+    // Results buffered during plan selection and plans that may still fall back to the backup
+    // plan go through the per-document path.
+    if (_failure || !_candidates[_bestPlanIdx].results.empty() || hasBackupPlan()) {
+        return PlanStage::doWorkBatch(maxWorks, results, out, worksPerformed);
+    }
+
+    PlanStage* bestRoot = _candidates[_bestPlanIdx].root;
+    const size_t childWorksBefore = bestRoot->getCommonStats()->works;
+    StageState state = bestRoot->workBatch(maxWorks, results, out);
+    *worksPerformed += bestRoot->getCommonStats()->works - childWorksBefore;
+    return state;
+}
+
 Status MultiPlanStage::tryYield(PlanYieldPolicy* yieldPolicy) {
     // These are the conditions which can cause us to yield:
     //   1) The yield policy's timer elapsed, or
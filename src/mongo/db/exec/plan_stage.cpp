@@ -43,8 +43,17 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
     ++_commonStats.works;
 
+    const bool sampled = MONGO_unlikely(_profileSampleInterval != 0) &&
+        _commonStats.works % _profileSampleInterval == 0;
+    const auto start =
+        sampled ? stdx::chrono::steady_clock::now() : stdx::chrono::steady_clock::time_point();
+
     StageState workResult = doWork(out);
 
+    if (sampled) {
+        recordProfileSample(start, 1);
+    }
+
     if (StageState::ADVANCED == workResult) {
         ++_commonStats.advanced;
     } else if (StageState::NEED_TIME == workResult) {
@@ -56,6 +65,64 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(size_t maxWorks,
+                                           std::vector<WorkingSetID>* results,
+                                           WorkingSetID* out) {
+    invariant(_opCtx);
+    invariant(maxWorks > 0);
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+
+    // A batch amortizes the clock reads over all of its units of work, so every batch is timed.
+    const bool sampled = MONGO_unlikely(_profileSampleInterval != 0);
+    const auto start =
+        sampled ? stdx::chrono::steady_clock::now() : stdx::chrono::steady_clock::time_point();
+
+    const size_t resultsBefore = results->size();
+    size_t worksPerformed = 0;
+    StageState workResult = doWorkBatch(maxWorks, results, out, &worksPerformed);
+
+    if (sampled) {
+        recordProfileSample(start, worksPerformed);
+    }
+
+    const size_t advanced = results->size() - resultsBefore;
+    const bool stoppedEarly =
+        StageState::ADVANCED != workResult && StageState::NEED_TIME != workResult;
+    const size_t stopped = stoppedEarly ? 1 : 0;
+    invariant(worksPerformed >= advanced + stopped);
+
+    _commonStats.works += worksPerformed;
+    _commonStats.advanced += advanced;
+    _commonStats.needTime += worksPerformed - advanced - stopped;
+    if (StageState::NEED_YIELD == workResult) {
+        ++_commonStats.needYield;
+    }
+
+    return workResult;
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(size_t maxWorks,
+                                             std::vector<WorkingSetID>* results,
+                                             WorkingSetID* out,
+                                             size_t* worksPerformed) {
+    for (size_t i = 0; i < maxWorks; ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        ++*worksPerformed;
+
+        if (StageState::ADVANCED == state) {
+            // We don't know whether this result stays valid if we keep working, so hand it back.
+            results->push_back(id);
+            return state;
+        } else if (StageState::NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+    }
+
+    return StageState::NEED_TIME;
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
@@ -105,6 +172,22 @@ void PlanStage::reattachToOperationContext(OperationContext* opCtx) {
     doReattachToOperationContext();
 }
 
+void PlanStage::enableProfiling(size_t sampleInterval) {
+    invariant(sampleInterval > 0);
+    _profileSampleInterval = sampleInterval;
+
+    for (auto&& child : _children) {
+        child->enableProfiling(sampleInterval);
+    }
+}
+
+void PlanStage::recordProfileSample(stdx::chrono::steady_clock::time_point start, size_t works) {
+    const auto elapsed = stdx::chrono::steady_clock::now() - start;
+    _commonStats.profiledTimeNanos +=
+        stdx::chrono::duration_cast<stdx::chrono::nanoseconds>(elapsed).count();
+    _commonStats.profiledWorks += works;
+}
+
 ClockSource* PlanStage::getClock() const {
     return _opCtx->getServiceContext()->getFastClockSource();
 }
@@ -34,6 +34,7 @@
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/invalidation_type.h"
+#include "mongo/stdx/chrono.h"
 
 namespace mongo {
 
@@ -188,6 +189,24 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Performs up to 'maxWorks' units of work on the query, appending the WorkingSetID of every
+     * result produced to 'results'. This amortizes the per-call cost of work() (virtual dispatch,
+     * timing and the caller's yield bookkeeping) over many results.
+     *
+     * Returns ADVANCED if at least one result was appended and NEED_TIME if none was. If a unit
+     * of work produces any other state, the batch stops early and that state is returned with
+     * '*out' set exactly as work() would have set it. Results appended before the stop are still
+     * valid and should be consumed by the caller before it acts on the returned state.
+     *
+     * Results remain valid under the same conditions as a result returned by work(): until the
+     * next call to work() or workBatch() on this stage, or until the next yield.
+     *
+     * Stages which do not override doWorkBatch() fall back to calling doWork() and return at most
+     * one result per batch.
+     */
+    StageState workBatch(size_t maxWorks, std::vector<WorkingSetID>* results, WorkingSetID* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -341,12 +360,32 @@ public:
      */
     virtual const SpecificStats* getSpecificStats() const = 0;
 
+    /**
+     * Turns on sampled, high resolution timing of this stage and all of its descendants. One in
+     * every 'sampleInterval' calls to work(), and every call to workBatch(), is timed with a
+     * nanosecond clock and accounted in CommonStats::profiledTimeNanos. Used by explain at the
+     * "executionProfile" verbosity.
+     */
+    void enableProfiling(size_t sampleInterval);
+
 protected:
     /**
      * Performs one unit of work.  See comment at work() above.
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work.  See comment at workBatch() above.
+     *
+     * Implementations must add the number of units of work they performed to '*worksPerformed'.
+     * The default implementation calls doWork() until it produces a result or a state other than
+     * NEED_TIME.
+     */
+    virtual StageState doWorkBatch(size_t maxWorks,
+                                   std::vector<WorkingSetID>* results,
+                                   WorkingSetID* out,
+                                   size_t* worksPerformed);
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -396,7 +435,15 @@ protected:
     CommonStats _commonStats;
 
 private:
+    /**
+     * Accounts a profiled call which started at 'start' and performed 'works' units of work.
+     */
+    void recordProfileSample(stdx::chrono::steady_clock::time_point start, size_t works);
+
     OperationContext* _opCtx;
+
+    // Zero unless profiling was enabled.
+    size_t _profileSampleInterval = 0;
 };
 
 }  // namespace mongo
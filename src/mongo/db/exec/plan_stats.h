@@ -65,6 +65,8 @@ struct CommonStats {
           needTime(0),
           needYield(0),
           executionTimeMillis(0),
+          profiledTimeNanos(0),
+          profiledWorks(0),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -87,6 +89,12 @@ struct CommonStats {
     // Time elapsed while working inside this stage.
     long long executionTimeMillis;
 
+    // Only set if the stage was profiled (see PlanStage::enableProfiling()). The time spent in
+    // the sampled calls into this stage, including the time spent in its descendants, and the
+    // number of units of work performed by those calls.
+    long long profiledTimeNanos;
+    size_t profiledWorks;
+
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
 
@@ -190,6 +198,9 @@ struct CachedPlanStats : public SpecificStats {
     }
 
     bool replanned;
+
+    // True if the cached plan stalled after its trial period and its cache entry was evicted.
+    bool evictedDuringExecution = false;
 };
 
 struct CollectionScanStats : public SpecificStats {
@@ -206,6 +217,27 @@ struct CollectionScanStats : public SpecificStats {
     // >0 if we're traversing the collection forwards. <0 if we're traversing it
     // backwards.
     int direction;
+
+    // The number of threads used to evaluate the filter.
+    int parallelism = 1;
+
+    // Whether the scan may share its position with other scans of the collection, and whether it
+    // started at the position of one which was already running.
+    bool shared = false;
+    bool joinedSharedScan = false;
+};
+
+struct ColumnScanStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        ColumnScanStats* specific = new ColumnScanStats(*this);
+        return specific;
+    }
+
+    // The fields held by the column projection cache, not including _id.
+    std::vector<std::string> cachedFields;
+
+    // How many cached rows did we check against our filter?
+    size_t rowsExamined = 0;
 };
 
 struct CountStats : public SpecificStats {
@@ -224,6 +256,17 @@ struct CountStats : public SpecificStats {
 
     // True if we computed the count via Collection::numRecords().
     bool recordStoreCount;
+
+    // True if we computed the count from the prefix counts of an index.
+    bool prefixCount = false;
+
+    // The name of that index.
+    std::string prefixCountIndexName;
+
+    // True if the orphaned documents are subtracted from the count taken from the record store or
+    // from the prefix counts, and the number of them.
+    bool subtractOrphans = false;
+    long long nOrphans = 0;
 };
 
 struct CountScanStats : public SpecificStats {
@@ -242,6 +285,7 @@ struct CountScanStats : public SpecificStats {
         specific->collation = collation.getOwned();
         specific->startKey = startKey.getOwned();
         specific->endKey = endKey.getOwned();
+        specific->indexBounds = indexBounds.getOwned();
         return specific;
     }
 
@@ -260,6 +304,9 @@ struct CountScanStats : public SpecificStats {
     bool startKeyInclusive;
     bool endKeyInclusive;
 
+    // The bounds of a count scan over multiple intervals, which has no start or end key.
+    BSONObj indexBounds;
+
     int indexVersion;
 
     // Set to true if the index used for the count scan is multikey.
@@ -386,6 +433,26 @@ struct IDHackStats : public SpecificStats {
     size_t docsExamined;
 };
 
+struct PointLookupStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        PointLookupStats* specific = new PointLookupStats(*this);
+        return specific;
+    }
+
+    std::string indexName;
+
+    BSONObj keyPattern;
+
+    // Number of keys the index is seeked for.
+    size_t numKeys = 0;
+
+    // Number of entries retrieved from the index.
+    size_t keysExamined = 0;
+
+    // Number of documents retrieved from the collection.
+    size_t docsExamined = 0;
+};
+
 struct IndexScanStats : public SpecificStats {
     IndexScanStats()
         : indexVersion(0),
@@ -508,7 +575,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -529,6 +596,9 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // Did the sort exceed its memory limit and spill to disk?
+    bool usedDisk;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -0,0 +1,437 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/point_lookup.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/storage/record_fetcher.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+namespace {
+
+// The values matched by each path of a query, if it is made of equalities and $in lists.
+using PointValues = std::map<StringData, vector<BSONElement>>;
+
+/**
+ * Returns whether the documents matching an equality to 'elt' are exactly those holding 'elt' as an
+ * index key of the path. Arrays, nulls and regular expressions also match documents with other
+ * keys, or no key at all, and MinKey and MaxKey are not worth the special cases.
+ */
+bool isPointValue(const BSONElement& elt) {
+    switch (elt.type()) {
+        case Array:
+        case jstNULL:
+        case Undefined:
+        case RegEx:
+        case MinKey:
+        case MaxKey:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/**
+ * Returns whether a component of 'path' could be an array position, for which the keys generated
+ * differ from the values the query matches.
+ */
+bool hasNumericPathComponent(StringData path) {
+    FieldRef fieldRef(path);
+    for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+        StringData part = fieldRef.getPart(i);
+        if (std::all_of(part.begin(), part.end(), [](char c) { return std::isdigit(c); })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Gathers the values matched by each path of 'expr' into 'valuesOut'. Returns false unless 'expr'
+ * is an equality, a $in list without regular expressions, or a conjunction of those on distinct
+ * paths.
+ */
+bool getPointValues(const MatchExpression* expr, PointValues* valuesOut) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!getPointValues(expr->getChild(i), valuesOut)) {
+                    return false;
+                }
+            }
+            return !valuesOut->empty();
+        case MatchExpression::EQ: {
+            const auto eq = static_cast<const EqualityMatchExpression*>(expr);
+            if (!isPointValue(eq->getData())) {
+                return false;
+            }
+            return valuesOut->emplace(eq->path(), vector<BSONElement>{eq->getData()}).second;
+        }
+        case MatchExpression::MATCH_IN: {
+            const auto in = static_cast<const InMatchExpression*>(expr);
+            if (!in->getRegexes().empty() || in->getEqualities().empty()) {
+                return false;
+            }
+
+            vector<BSONElement> values;
+            for (auto&& elt : in->getEqualities()) {
+                if (!isPointValue(elt)) {
+                    return false;
+                }
+                values.push_back(elt);
+            }
+            return valuesOut->emplace(in->path(), std::move(values)).second;
+        }
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns whether the options of the query request allow it to be answered with index seeks alone.
+ */
+bool supportsQueryRequest(const CanonicalQuery& query) {
+    const QueryRequest& qr = query.getQueryRequest();
+    if (qr.showRecordId() || !qr.getHint().isEmpty() || qr.getSkip() || !qr.getSort().isEmpty() ||
+        !qr.getMin().isEmpty() || !qr.getMax().isEmpty() || qr.returnKey() || qr.isTailable() ||
+        qr.isOplogReplay() || qr.isSnapshot() || qr.getMaxScan()) {
+        return false;
+    }
+
+    // The index keys the documents were found by are not kept.
+    return !query.getProj() || !query.getProj()->wantIndexKey();
+}
+
+}  // namespace
+
+// static
+const char* PointLookupStage::kStageType = "POINT_LOOKUP";
+
+PointLookupStage::PointLookupStage(OperationContext* opCtx,
+                                   const Collection* collection,
+                                   WorkingSet* ws,
+                                   const IndexDescriptor* descriptor,
+                                   vector<BSONObj> keys,
+                                   const MatchExpression* filter)
+    : PlanStage(kStageType, opCtx),
+      _collection(collection),
+      _workingSet(ws),
+      _accessMethod(collection->getIndexCatalog()->getIndex(descriptor)),
+      _filter(filter),
+      _keys(std::move(keys)) {
+    _specificStats.indexName = descriptor->indexName();
+    _specificStats.keyPattern = descriptor->keyPattern();
+    _specificStats.numKeys = _keys.size();
+}
+
+bool PointLookupStage::isEOF() {
+    if (WorkingSet::INVALID_ID != _idBeingPagedIn) {
+        // We asked the parent for a page-in, but still haven't had a chance to return the paged
+        // in document.
+        return false;
+    }
+
+    return _nextKey >= _keys.size();
+}
+
+PlanStage::StageState PointLookupStage::doWork(WorkingSetID* out) {
+    if (WorkingSet::INVALID_ID != _idBeingPagedIn) {
+        invariant(_recordCursor);
+        WorkingSetID id = _idBeingPagedIn;
+        _idBeingPagedIn = WorkingSet::INVALID_ID;
+
+        invariant(WorkingSetCommon::fetchIfUnfetched(getOpCtx(), _workingSet, id, _recordCursor));
+        return returnIfMatches(id, out);
+    }
+
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    try {
+        if (!_indexCursor) {
+            _indexCursor = _accessMethod->newCursor(getOpCtx());
+        }
+
+        // The index is unique, so there is at most one entry for the key. The key is only consumed
+        // once the document it leads to has been fetched, so that a write conflict retries it.
+        auto kv = _indexCursor->seekExact(_keys[_nextKey], SortedDataInterface::Cursor::kWantLoc);
+        if (!kv) {
+            ++_nextKey;
+            return PlanStage::NEED_TIME;
+        }
+
+        ++_specificStats.keysExamined;
+        if (_returned.count(kv->loc)) {
+            ++_nextKey;
+            return PlanStage::NEED_TIME;
+        }
+
+        id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = kv->loc;
+        _workingSet->transitionToRecordIdAndIdx(id);
+
+        if (!_recordCursor) {
+            _recordCursor = _collection->getCursor(getOpCtx());
+        }
+
+        // We may need to request a yield while we fetch the document.
+        if (auto fetcher = _recordCursor->fetcherForId(kv->loc)) {
+            // There's something to fetch. Hand the fetcher off to the WSM, and pass up a fetch
+            // request.
+            ++_nextKey;
+            ++_specificStats.docsExamined;
+            _returned.insert(kv->loc);
+            _idBeingPagedIn = id;
+            member->setFetcher(fetcher.release());
+            *out = id;
+            return PlanStage::NEED_YIELD;
+        }
+
+        // The doc was already in memory, so we go ahead and return it.
+        if (!WorkingSetCommon::fetch(getOpCtx(), _workingSet, id, _recordCursor)) {
+            // The document was deleted since it was found in the index.
+            ++_nextKey;
+            _workingSet->free(id);
+            return PlanStage::NEED_TIME;
+        }
+
+        ++_nextKey;
+        ++_specificStats.docsExamined;
+        _returned.insert(kv->loc);
+        return returnIfMatches(id, out);
+    } catch (const WriteConflictException&) {
+        // Retry the current key on a fresh snapshot.
+        _indexCursor.reset();
+        _recordCursor.reset();
+        if (id != WorkingSet::INVALID_ID) {
+            _workingSet->free(id);
+        }
+
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+}
+
+PlanStage::StageState PointLookupStage::returnIfMatches(WorkingSetID id, WorkingSetID* out) {
+    WorkingSetMember* member = _workingSet->get(id);
+    invariant(member->hasObj());
+
+    if (!Filter::passes(member, _filter)) {
+        _workingSet->free(id);
+        return PlanStage::NEED_TIME;
+    }
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+void PointLookupStage::doSaveState() {
+    if (_indexCursor)
+        _indexCursor->saveUnpositioned();
+    if (_recordCursor)
+        _recordCursor->saveUnpositioned();
+}
+
+void PointLookupStage::doRestoreState() {
+    if (_indexCursor)
+        _indexCursor->restore();
+    if (_recordCursor)
+        _recordCursor->restore();
+}
+
+void PointLookupStage::doDetachFromOperationContext() {
+    if (_indexCursor)
+        _indexCursor->detachFromOperationContext();
+    if (_recordCursor)
+        _recordCursor->detachFromOperationContext();
+}
+
+void PointLookupStage::doReattachToOperationContext() {
+    if (_indexCursor)
+        _indexCursor->reattachToOperationContext(getOpCtx());
+    if (_recordCursor)
+        _recordCursor->reattachToOperationContext(getOpCtx());
+}
+
+void PointLookupStage::doInvalidate(OperationContext* opCtx,
+                                    const RecordId& dl,
+                                    InvalidationType type) {
+    // A mutated document is filtered against the query once fetched, so only deletions matter.
+    if (INVALIDATION_MUTATION == type) {
+        return;
+    }
+
+    // It's possible that the RecordId getting invalidated is the one we're about to fetch. In this
+    // case we do a "forced fetch" and put the WSM in owned object state.
+    if (WorkingSet::INVALID_ID != _idBeingPagedIn) {
+        WorkingSetMember* member = _workingSet->get(_idBeingPagedIn);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            // Fetch it now and kill the RecordId.
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        }
+    }
+}
+
+// static
+const IndexDescriptor* PointLookupStage::getLookupIndex(OperationContext* opCtx,
+                                                        Collection* collection,
+                                                        const CanonicalQuery& query,
+                                                        vector<BSONObj>* keysOut) {
+    const size_t maxKeys = std::max(0, internalQueryPointLookupMaxKeys.load());
+    if (maxKeys == 0 || !supportsQueryRequest(query)) {
+        return nullptr;
+    }
+
+    PointValues values;
+    if (!getPointValues(query.root(), &values)) {
+        return nullptr;
+    }
+
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii.more()) {
+        const IndexDescriptor* desc = ii.next();
+        IndexCatalogEntry* ice = ii.catalogEntry(desc);
+
+        // The index must hold a key for every document, be up to date and compare strings the
+        // way the query does.
+        if (!desc->unique() || desc->getAccessMethodName() != IndexNames::BTREE ||
+            ice->getFilterExpression() || desc->isDeferred() || ice->indexBuildInterceptor() ||
+            !CollatorInterface::collatorsMatch(query.getCollator(), ice->getCollator())) {
+            continue;
+        }
+
+        // The query must match values for each of the index fields and nothing else.
+        const BSONObj keyPattern = desc->keyPattern();
+        if (static_cast<size_t>(keyPattern.nFields()) != values.size()) {
+            continue;
+        }
+
+        vector<const vector<BSONElement>*> fieldValues;
+        size_t numKeys = 1;
+        for (auto&& field : keyPattern) {
+            auto it = values.find(field.fieldNameStringData());
+            if (it == values.end() || hasNumericPathComponent(it->first)) {
+                break;
+            }
+            fieldValues.push_back(&it->second);
+            numKeys *= it->second.size();
+            if (numKeys > maxKeys) {
+                break;
+            }
+        }
+        if (fieldValues.size() != values.size() || numKeys > maxKeys) {
+            continue;
+        }
+
+        // A projection covered by the index is better answered by the planner, without fetching.
+        if (query.getProj() && !query.getProj()->requiresDocument() && !desc->isMultikey(opCtx) &&
+            std::all_of(query.getProj()->getRequiredFields().begin(),
+                        query.getProj()->getRequiredFields().end(),
+                        [&](StringData field) { return keyPattern.hasField(field); })) {
+            continue;
+        }
+
+        // Generate the key for each combination of values.
+        vector<BSONObj> keys;
+        keys.reserve(numKeys);
+        vector<size_t> positions(fieldValues.size(), 0);
+        while (true) {
+            BSONObjBuilder key;
+            for (size_t i = 0; i < fieldValues.size(); ++i) {
+                CollationIndexKey::collationAwareIndexKeyAppend(
+                    (*fieldValues[i])[positions[i]], ice->getCollator(), &key);
+            }
+            keys.push_back(key.obj());
+
+            size_t i = fieldValues.size();
+            while (i > 0 && ++positions[i - 1] == fieldValues[i - 1]->size()) {
+                positions[i - 1] = 0;
+                --i;
+            }
+            if (i == 0) {
+                break;
+            }
+        }
+
+        // Seek the keys in index order, once each.
+        const Ordering ordering = Ordering::make(keyPattern);
+        std::sort(keys.begin(), keys.end(), [&](const BSONObj& lhs, const BSONObj& rhs) {
+            return lhs.woCompare(rhs, ordering, false) < 0;
+        });
+        keys.erase(std::unique(keys.begin(),
+                               keys.end(),
+                               [&](const BSONObj& lhs, const BSONObj& rhs) {
+                                   return lhs.woCompare(rhs, ordering, false) == 0;
+                               }),
+                   keys.end());
+
+        *keysOut = std::move(keys);
+        return desc;
+    }
+
+    return nullptr;
+}
+
+unique_ptr<PlanStageStats> PointLookupStage::getStats() {
+    _commonStats.isEOF = isEOF();
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_POINT_LOOKUP);
+    ret->specific = make_unique<PointLookupStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* PointLookupStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
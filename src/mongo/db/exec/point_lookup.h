@@ -0,0 +1,137 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/stdx/unordered_set.h"
+
+namespace mongo {
+
+class IndexAccessMethod;
+class IndexDescriptor;
+class RecordCursor;
+
+/**
+ * A standalone stage implementing the fast path for queries of equalities or $in lists on all of
+ * the fields of a unique index, such as {a: 1, b: "x"} against a unique index {a: 1, b: 1} or
+ * {_id: {$in: [...]}} against the _id index. The index is seeked for each key the query matches,
+ * in index order and through a single cursor, and the documents found are fetched and filtered
+ * against the query. No plan is enumerated or cached for such a query.
+ *
+ * Since the index must use the collation of the query for the keys to be complete, this stage is
+ * only used when the two collators match.
+ */
+class PointLookupStage final : public PlanStage {
+public:
+    /**
+     * 'keys' must be the index keys to look up, sorted in index order and without duplicates.
+     * Neither 'collection', 'descriptor' nor 'filter' are owned here.
+     */
+    PointLookupStage(OperationContext* opCtx,
+                     const Collection* collection,
+                     WorkingSet* ws,
+                     const IndexDescriptor* descriptor,
+                     std::vector<BSONObj> keys,
+                     const MatchExpression* filter);
+
+    bool isEOF() final;
+    StageState doWork(WorkingSetID* out) final;
+
+    void doSaveState() final;
+    void doRestoreState() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
+
+    /**
+     * If 'query' can be answered by this stage, returns the unique index to look up and fills out
+     * 'keysOut' with the keys to seek it for. Otherwise returns nullptr.
+     */
+    static const IndexDescriptor* getLookupIndex(OperationContext* opCtx,
+                                                 Collection* collection,
+                                                 const CanonicalQuery& query,
+                                                 std::vector<BSONObj>* keysOut);
+
+    StageType stageType() const final {
+        return STAGE_POINT_LOOKUP;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats();
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    /**
+     * Returns the fetched document in 'id' if it matches the query, or discards it.
+     */
+    StageState returnIfMatches(WorkingSetID id, WorkingSetID* out);
+
+    // Not owned here.
+    const Collection* _collection;
+
+    // The WorkingSet we annotate with results. Not owned by us.
+    WorkingSet* _workingSet;
+
+    // Not owned here.
+    const IndexAccessMethod* _accessMethod;
+
+    // Not owned here. Applied to each fetched document, so that a key which is not reachable by
+    // the document anymore does not produce it.
+    const MatchExpression* _filter;
+
+    const std::vector<BSONObj> _keys;
+
+    // Position in '_keys' of the next key to seek.
+    size_t _nextKey = 0;
+
+    std::unique_ptr<SortedDataInterface::Cursor> _indexCursor;
+
+    std::unique_ptr<SeekableRecordCursor> _recordCursor;
+
+    // The documents returned so far. A multikey index may hold several of the keys for the same
+    // document.
+    stdx::unordered_set<RecordId, RecordId::Hasher> _returned;
+
+    // If we want to return a RecordId and it points to something that's not in memory, we return
+    // a "please page this in" result and fetch the document once we are called again.
+    WorkingSetID _idBeingPagedIn = WorkingSet::INVALID_ID;
+
+    PointLookupStats _specificStats;
+};
+
+}  // namespace mongo
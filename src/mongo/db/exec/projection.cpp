@@ -226,6 +226,47 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(size_t maxWorks,
+                                                   std::vector<WorkingSetID>* results,
+                                                   WorkingSetID* out,
+                                                   size_t* worksPerformed) {
+    const size_t resultsBefore = results->size();
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxWorks, results, &id);
+
+    *worksPerformed += child()->getCommonStats()->works - childWorksBefore;
+
+    // The transformed objects are owned, so they stay valid for the rest of the batch.
+    for (size_t i = resultsBefore; i < results->size(); ++i) {
+        Status projStatus = transform(_ws->get((*results)[i]));
+        if (!projStatus.isOK()) {
+            warning() << "Couldn't execute projection, status = " << redact(projStatus);
+            for (size_t j = i; j < results->size(); ++j) {
+                _ws->free((*results)[j]);
+            }
+            results->resize(i);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, projStatus);
+            return PlanStage::FAILURE;
+        }
+    }
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *out = id;
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "projection stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
 unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_PROJECTION);
@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+const size_t RecordIdBitmap::kMaxArraySize;
+const size_t RecordIdBitmap::kBitmapWords;
+
+bool RecordIdBitmap::insert(const RecordId& id) {
+    Chunk& chunk = _chunks[chunkKey(id)];
+    const uint16_t offset = chunkOffset(id);
+
+    if (chunk.isBitmap()) {
+        uint64_t& word = chunk.bits[offset / 64];
+        const uint64_t mask = uint64_t(1) << (offset % 64);
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+    } else {
+        auto it = std::lower_bound(chunk.values.begin(), chunk.values.end(), offset);
+        if (it != chunk.values.end() && *it == offset) {
+            return false;
+        }
+
+        if (chunk.values.size() < kMaxArraySize) {
+            chunk.values.insert(it, offset);
+        } else {
+            // The array is as large as a bitmap would be, so convert the chunk.
+            chunk.bits.assign(kBitmapWords, 0);
+            for (uint16_t value : chunk.values) {
+                chunk.bits[value / 64] |= uint64_t(1) << (value % 64);
+            }
+            chunk.bits[offset / 64] |= uint64_t(1) << (offset % 64);
+            std::vector<uint16_t>().swap(chunk.values);
+        }
+    }
+
+    ++chunk.size;
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::erase(const RecordId& id) {
+    auto chunkIt = _chunks.find(chunkKey(id));
+    if (chunkIt == _chunks.end()) {
+        return false;
+    }
+
+    Chunk& chunk = chunkIt->second;
+    const uint16_t offset = chunkOffset(id);
+
+    if (chunk.isBitmap()) {
+        uint64_t& word = chunk.bits[offset / 64];
+        const uint64_t mask = uint64_t(1) << (offset % 64);
+        if (!(word & mask)) {
+            return false;
+        }
+        word &= ~mask;
+    } else {
+        auto it = std::lower_bound(chunk.values.begin(), chunk.values.end(), offset);
+        if (it == chunk.values.end() || *it != offset) {
+            return false;
+        }
+        chunk.values.erase(it);
+    }
+
+    --_size;
+    if (0 == --chunk.size) {
+        _chunks.erase(chunkIt);
+    }
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& id) const {
+    auto chunkIt = _chunks.find(chunkKey(id));
+    if (chunkIt == _chunks.end()) {
+        return false;
+    }
+
+    const Chunk& chunk = chunkIt->second;
+    const uint16_t offset = chunkOffset(id);
+
+    if (chunk.isBitmap()) {
+        return chunk.bits[offset / 64] & (uint64_t(1) << (offset % 64));
+    }
+    return std::binary_search(chunk.values.begin(), chunk.values.end(), offset);
+}
+
+void RecordIdBitmap::clear() {
+    _chunks.clear();
+    _size = 0;
+}
+
+size_t RecordIdBitmap::memUsage() const {
+    size_t usage = sizeof(*this);
+    for (auto&& entry : _chunks) {
+        const Chunk& chunk = entry.second;
+        usage += sizeof(entry) + chunk.values.capacity() * sizeof(uint16_t) +
+            chunk.bits.capacity() * sizeof(uint64_t);
+    }
+    return usage;
+}
+
+}  // namespace mongo
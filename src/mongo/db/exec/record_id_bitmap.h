@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/platform/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds, used by stages which only need to remember which RecordIds they
+ * have seen, such as the deduplication in OR and the intersection in AND_HASH.
+ *
+ * Following the layout of Roaring bitmaps, the 64-bit RecordId space is split into chunks of
+ * 2^16 consecutive values. Each chunk which holds any RecordId stores the low 16 bits of its
+ * members either as a sorted array, while it is sparse, or as a 2^16 bit bitmap once the array
+ * would be larger. Dense runs of RecordIds, which storage engines tend to hand out, therefore
+ * cost about one bit each, and no allocation is made per RecordId.
+ */
+class RecordIdBitmap {
+public:
+    /**
+     * Adds 'id' to the set. Returns true if it was not already present.
+     */
+    bool insert(const RecordId& id);
+
+    /**
+     * Removes 'id' from the set. Returns true if it was present.
+     */
+    bool erase(const RecordId& id);
+
+    bool contains(const RecordId& id) const;
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return 0 == _size;
+    }
+
+    void clear();
+
+    /**
+     * Returns an estimate of the memory used by the set, in bytes.
+     */
+    size_t memUsage() const;
+
+private:
+    // Sparse chunks switch to a bitmap once their array would outgrow it.
+    static const size_t kMaxArraySize = 4096;
+    static const size_t kBitmapWords = (1 << 16) / 64;
+
+    struct Chunk {
+        bool isBitmap() const {
+            return !bits.empty();
+        }
+
+        // Sorted low 16 bits of the members of the chunk, while it is sparse.
+        std::vector<uint16_t> values;
+
+        // One bit per possible member of the chunk, once it is dense.
+        std::vector<uint64_t> bits;
+
+        // Number of members of the chunk.
+        size_t size = 0;
+    };
+
+    static int64_t chunkKey(const RecordId& id) {
+        // Arithmetic shift, so that negative RecordIds keep distinct chunks.
+        return id.repr() >> 16;
+    }
+
+    static uint16_t chunkOffset(const RecordId& id) {
+        return static_cast<uint16_t>(id.repr() & 0xFFFF);
+    }
+
+    unordered_map<int64_t, Chunk> _chunks;
+    size_t _size = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <set>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdBitmapTest, InsertEraseContains) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+
+    ASSERT_TRUE(bitmap.insert(RecordId(5)));
+    ASSERT_FALSE(bitmap.insert(RecordId(5)));
+    ASSERT_TRUE(bitmap.insert(RecordId(1LL << 40)));
+    ASSERT_EQ(2U, bitmap.size());
+
+    ASSERT_TRUE(bitmap.contains(RecordId(5)));
+    ASSERT_TRUE(bitmap.contains(RecordId(1LL << 40)));
+    ASSERT_FALSE(bitmap.contains(RecordId(6)));
+    ASSERT_FALSE(bitmap.contains(RecordId((1LL << 40) + 5)));
+
+    ASSERT_TRUE(bitmap.erase(RecordId(5)));
+    ASSERT_FALSE(bitmap.erase(RecordId(5)));
+    ASSERT_FALSE(bitmap.contains(RecordId(5)));
+    ASSERT_EQ(1U, bitmap.size());
+
+    bitmap.clear();
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(bitmap.contains(RecordId(1LL << 40)));
+}
+
+TEST(RecordIdBitmapTest, NegativeRecordIdsAreDistinct) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.insert(RecordId(-1)));
+    ASSERT_TRUE(bitmap.insert(RecordId(65535)));
+    ASSERT_TRUE(bitmap.insert(RecordId::min()));
+    ASSERT_TRUE(bitmap.insert(RecordId::max()));
+    ASSERT_EQ(4U, bitmap.size());
+    ASSERT_TRUE(bitmap.contains(RecordId(-1)));
+    ASSERT_FALSE(bitmap.contains(RecordId(-65536)));
+    ASSERT_TRUE(bitmap.contains(RecordId::min()));
+    ASSERT_TRUE(bitmap.contains(RecordId::max()));
+}
+
+TEST(RecordIdBitmapTest, DenseChunkConvertsToBitmap) {
+    RecordIdBitmap bitmap;
+    for (long long i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(bitmap.insert(RecordId(i * 2)));
+    }
+    ASSERT_EQ(10000U, bitmap.size());
+
+    for (long long i = 0; i < 20000; ++i) {
+        ASSERT_EQ(i % 2 == 0, bitmap.contains(RecordId(i)));
+    }
+
+    // A bitmap chunk costs 8KB, much less than a node-based set of the same RecordIds.
+    ASSERT_LT(bitmap.memUsage(), 10000U * sizeof(RecordId));
+
+    for (long long i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(bitmap.erase(RecordId(i * 2)));
+    }
+    ASSERT_TRUE(bitmap.empty());
+}
+
+TEST(RecordIdBitmapTest, MatchesStdSet) {
+    PseudoRandom rng(2017);
+    RecordIdBitmap bitmap;
+    std::set<RecordId> expected;
+
+    for (int i = 0; i < 50000; ++i) {
+        const RecordId id(rng.nextInt64(1 << 18));
+        if (rng.nextInt32(4) == 0) {
+            ASSERT_EQ(expected.erase(id) == 1, bitmap.erase(id));
+        } else {
+            ASSERT_EQ(expected.insert(id).second, bitmap.insert(id));
+        }
+        ASSERT_EQ(expected.size(), bitmap.size());
+    }
+
+    for (long long i = 0; i < (1 << 18); ++i) {
+        ASSERT_EQ(expected.count(RecordId(i)) == 1, bitmap.contains(RecordId(i)));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -87,6 +87,47 @@ PlanStage::StageState SkipStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState SkipStage::doWorkBatch(size_t maxWorks,
+                                             std::vector<WorkingSetID>* results,
+                                             WorkingSetID* out,
+                                             size_t* worksPerformed) {
+    const size_t resultsBefore = results->size();
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxWorks, results, &id);
+
+    *worksPerformed += child()->getCommonStats()->works - childWorksBefore;
+
+    // Drop as many of the new results as we still need to skip.
+    if (_toSkip > 0) {
+        auto firstNew = results->begin() + resultsBefore;
+        const auto numToDrop =
+            std::min(static_cast<long long>(results->end() - firstNew), _toSkip);
+        for (auto it = firstNew; it != firstNew + numToDrop; ++it) {
+            _ws->free(*it);
+        }
+        results->erase(firstNew, firstNew + numToDrop);
+        _toSkip -= numToDrop;
+    }
+
+    if (PlanStage::ADVANCED == status) {
+        return results->size() > resultsBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *out = id;
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "skip stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
 unique_ptr<PlanStageStats> SkipStage::getStats() {
     _commonStats.isEOF = isEOF();
     _specificStats.skip = _toSkip;
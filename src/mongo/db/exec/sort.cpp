@@ -41,6 +41,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -51,6 +52,13 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// An Ordering holds one direction bit per field.
+const int kMaxOrderingFields = 32;
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
@@ -58,6 +66,14 @@ SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
+    if (!lhs.sortKeyString.empty()) {
+        // The RecordId is encoded after the sort key, so it already breaks ties here.
+        return KeyString::compare(lhs.sortKeyString.data(),
+                                  lhs.sortKeyString.size(),
+                                  rhs.sortKeyString.data(),
+                                  rhs.sortKeyString.size()) < 0;
+    }
+
     // False means ignore field names.
     int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
@@ -67,6 +83,15 @@ bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
     return lhs.recordId < rhs.recordId;
 }
 
+SortStage::SpillComparator::SpillComparator(BSONObj p) : pattern(p) {}
+
+int SortStage::SpillComparator::operator()(const SpillSorter::Data& lhs,
+                                           const SpillSorter::Data& rhs) const {
+    // 'pattern' ends with an ascending entry for the trailing RecordId. False means ignore field
+    // names.
+    return lhs.first.woCompare(rhs.first, pattern, false);
+}
+
 SortStage::SortStage(OperationContext* opCtx,
                      const SortStageParams& params,
                      WorkingSet* ws,
@@ -76,7 +101,9 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
+      _sortKeyStringBuilder(KeyString::kLatestVersion),
       _resultIterator(_data.end()),
       _memUsage(0) {
     _children.emplace_back(child);
@@ -84,11 +111,8 @@ SortStage::SortStage(OperationContext* opCtx,
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
     _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
 
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+    if (sortComparator.nFields() <= kMaxOrderingFields) {
+        _sortKeyOrdering = Ordering::make(sortComparator);
     }
 }
 
@@ -97,12 +121,17 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _spillIterator ? !_spillIterator->more() : (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
-    if (_memUsage > maxBytes) {
+    if (_memUsage > maxBytes && _allowDiskUse && canSpill()) {
+        spillBuffer(maxBytes);
+    } else if (_memUsage > maxBytes) {
         mongoutils::str::stream ss;
         ss << "Sort operation used more than the maximum " << maxBytes
            << " bytes of RAM. Add an index, or specify a smaller limit.";
@@ -148,14 +177,25 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
+            if (_sortKeyOrdering) {
+                _sortKeyStringBuilder.resetToKey(item.sortKey, *_sortKeyOrdering, item.recordId);
+                item.sortKeyString.assign(_sortKeyStringBuilder.getBuffer(),
+                                          _sortKeyStringBuilder.getSize());
+            }
+
             addToBuffer(item);
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
-            _resultIterator = _data.begin();
+            if (_spillSorter) {
+                _spillIterator.reset(_spillSorter->done());
+                _spillSorter.reset();
+            } else {
+                sortBuffer();
+                _resultIterator = _data.begin();
+            }
             _sorted = true;
             return PlanStage::NEED_TIME;
         } else if (PlanStage::FAILURE == code || PlanStage::DEAD == code) {
@@ -178,6 +218,27 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_spillIterator) {
+        SpillSorter::Data next = _spillIterator->next();
+
+        *out = _ws->allocate();
+        WorkingSetMember* member = _ws->get(*out);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), next.second.getOwned());
+        member->transitionToOwnedObj();
+
+        // Restore the sort key, leaving off the RecordId which was appended by addToSpillSorter().
+        BSONObjBuilder sortKey;
+        BSONObjIterator it(next.first);
+        while (it.more()) {
+            BSONElement elt = it.next();
+            if (it.more()) {
+                sortKey.append(elt);
+            }
+        }
+        member->addComputed(new SortKeyComputedData(sortKey.obj()));
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -250,12 +311,21 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *                     Updates memory usage if item was replaced.
  *     sortBuffer() - Does nothing.
  * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
- *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ *     addToBuffer() - Pushes item onto the vector, kept as a max-heap.
+ *                     Once the heap holds limit items, a new item replaces
+ *                     the top of the heap (the item with the highest key)
+ *                     if it sorts before it. Updates memory usage accordingly.
+ *     sortBuffer() - Sorts the heap in place.
+ *
+ * Once the stage has spilled, addToBuffer() forwards every item to the
+ * external sorter, which applies the limit itself.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
+    if (_spillSorter) {
+        addToSpillSorter(item);
+        return;
+    }
+
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
@@ -282,33 +352,26 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             _memUsage = member->getMemUsage();
         }
     } else {
-        // Update data item set instead of vector
-        // Limit not reached - insert and return
-        vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        // Limit not reached - push onto the heap and return
+        if (_data.size() < _limit) {
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            _data.push_back(item);
+            std::push_heap(_data.begin(), _data.end(), cmp);
             _memUsage += member->getMemUsage();
             return;
         }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
+        // Limit will be exceeded - compare with the item with the highest key, which is at the
+        // top of the heap. If the new item does not sort before it, do nothing.
         wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
+        if (cmp(item, _data.front())) {
+            wsidToFree = _data.front().wsid;
+            _memUsage -= _ws->get(wsidToFree)->getMemUsage();
             _memUsage += member->getMemUsage();
-            wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
+            std::pop_heap(_data.begin(), _data.end(), cmp);
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            _data.back() = item;
+            std::push_heap(_data.begin(), _data.end(), cmp);
         }
     }
 
@@ -331,13 +394,66 @@ void SortStage::sortBuffer() {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        std::sort_heap(_data.begin(), _data.end(), cmp);
+    }
+}
+
+bool SortStage::canSpill() const {
+    // Only the document and its sort key are written to disk, so we cannot spill if the members
+    // carry any other computed data, such as a text score or a geoNear distance.
+    for (auto&& item : _data) {
+        WorkingSetMember* member = _ws->get(item.wsid);
+        if (member->hasComputed(WSM_COMPUTED_TEXT_SCORE) ||
+            member->hasComputed(WSM_COMPUTED_GEO_DISTANCE) || member->hasComputed(WSM_INDEX_KEY) ||
+            member->hasComputed(WSM_GEO_NEAR_POINT)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SortStage::spillBuffer(size_t maxBytes) {
+    invariant(!_spillSorter);
+
+    BSONObjBuilder spillPattern;
+    spillPattern.appendElements(_sortKeyComparator->pattern);
+    spillPattern.append("$recordId", 1);
+
+    const SortOptions opts = SortOptions()
+                                 .Limit(_limit)
+                                 .MaxMemoryUsageBytes(maxBytes)
+                                 .ExtSortAllowed()
+                                 .TempDir(storageGlobalParams.dbpath + "/_tmp");
+    _spillSorter.reset(SpillSorter::make(opts, SpillComparator(spillPattern.obj())));
+
+    LOG(1) << "Sort stage exceeded " << maxBytes << " bytes of RAM, spilling " << _data.size()
+           << " buffered results to disk";
+
+    for (auto&& item : _data) {
+        addToSpillSorter(item);
     }
+    _data.clear();
+    _resultIterator = _data.end();
+    _memUsage = 0;
+    _specificStats.usedDisk = true;
+}
+
+void SortStage::addToSpillSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+
+    BSONObjBuilder key;
+    key.appendElements(item.sortKey);
+    key.append("", static_cast<long long>(item.recordId.repr()));
+    _spillSorter->add(key.obj(), member->obj.value().getOwned());
+
+    if (member->hasRecordId()) {
+        _wsidByRecordId.erase(member->recordId);
+    }
+    _ws->free(item.wsid);
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
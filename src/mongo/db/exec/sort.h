@@ -28,7 +28,8 @@
 
 #pragma once
 
-#include <set>
+#include <boost/optional.hpp>
+#include <string>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -37,6 +38,8 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +49,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,11 +59,19 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // Whether the buffered data may be spilled to disk once it grows beyond
+    // internalQueryExecMaxBlockingSortBytes, rather than failing the sort.
+    bool allowDiskUse;
 };
 
 /**
  * Sorts the input received from the child according to the sort pattern provided.
  *
+ * If 'allowDiskUse' is set and the buffered data outgrows the memory limit, the stage switches to
+ * an external sort. Results produced from disk are owned objects without a RecordId, exactly like
+ * members which were force-fetched because of an invalidation.
+ *
  * Preconditions:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
@@ -106,6 +117,8 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -122,11 +135,15 @@ private:
         // RecordId to break sortKey ties.
         // See sorta.js.
         RecordId recordId;
+        // (sortKey, recordId) encoded as a KeyString using the ordering of the sort pattern, so
+        // that items can be compared with memcmp(). Empty if the pattern has too many fields to
+        // be described by an Ordering.
+        std::string sortKeyString;
     };
 
-    // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
-    // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // Comparison object for the data buffer. Items are compared on (sortKey, loc). This is also
+    // how the items are ordered in the indices. Keys are compared on their precomputed KeyString
+    // when available, and using BSONObj::woCompare() with RecordId as a tie-breaker otherwise.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
@@ -138,38 +155,76 @@ private:
         BSONObj pattern;
     };
 
+    // External sorter used once the buffered data no longer fits in memory. Keys are the sort key
+    // with the RecordId appended as a trailing NumberLong, values are the documents.
+    typedef Sorter<BSONObj, BSONObj> SpillSorter;
+
+    // Orders spilled (key, document) pairs on (sortKey, loc), like WorkingSetComparator.
+    struct SpillComparator {
+        explicit SpillComparator(BSONObj p);
+
+        int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const;
+
+        BSONObj pattern;
+    };
+
     /**
-     * Inserts one item into data buffer (vector or set).
-     * If limit is exceeded, remove item with lowest key.
+     * Inserts one item into data buffer.
+     * If limit is exceeded, remove item with highest key.
      */
     void addToBuffer(const SortableDataItem& item);
 
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
+    /**
+     * Returns true if the buffered working set members can be written to disk without losing any
+     * information that stages above us may depend on.
+     */
+    bool canSpill() const;
+
+    /**
+     * Moves everything buffered so far into '_spillSorter'. Every subsequent item is added to it
+     * directly.
+     */
+    void spillBuffer(size_t maxBytes);
+
+    /**
+     * Hands 'item' to '_spillSorter' and frees its working set member.
+     */
+    void addToSpillSorter(const SortableDataItem& item);
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // Ordering used to encode SortableDataItem::sortKeyString. Not set if the sort pattern has
+    // more fields than an Ordering can describe.
+    boost::optional<Ordering> _sortKeyOrdering;
+
+    // Reused to build the KeyString of every item, so that its buffer is only allocated once.
+    KeyString _sortKeyStringBuilder;
+
     // The data we buffer and sort.
-    // _data will contain sorted data when all data is gathered
-    // and sorted.
-    // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // _data will contain sorted data when all data is gathered and sorted.
+    // When _limit is greater than 1 and not all data has been gathered from child stage, _data
+    // is maintained as a binary max-heap holding the best _limit items seen so far, so that the
+    // item to evict is always at the front.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
+    // Set once we have started spilling to disk. Released when all data has been gathered and
+    // replaced by '_spillIterator'.
+    std::unique_ptr<SpillSorter> _spillSorter;
+
+    // Returns the sorted results when the sort spilled to disk.
+    std::unique_ptr<SpillSorter::Iterator> _spillIterator;
+
     // We buffer a lot of data and we want to look it up by RecordId quickly upon invalidation.
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByRecordId;
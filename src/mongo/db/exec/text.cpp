@@ -95,7 +95,12 @@ const SpecificStats* TextStage::getSpecificStats() const {
 unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
                                                WorkingSet* ws,
                                                const MatchExpression* filter) const {
-    auto textScorer = make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, _params.index);
+    // Documents dropped by the phrase and negation matching below TextOrStage would leave fewer
+    // than 'topK' results, so the scorer can only prune fetches when there is none to do.
+    const bool needsTextMatch = !_params.query.getNegatedTerms().empty() ||
+        !_params.query.getPositivePhr().empty() || !_params.query.getNegatedPhr().empty();
+    auto textScorer = make_unique<TextOrStage>(
+        opCtx, _params.spec, ws, filter, _params.index, needsTextMatch ? 0 : _params.topK);
 
     // Get all the index scans for each term in our query.
     for (const auto& term : _params.query.getTermsForBounds()) {
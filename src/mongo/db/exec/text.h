@@ -63,6 +63,9 @@ struct TextStageParams {
 
     // The text query.
     FTSQueryImpl query;
+
+    // If non-zero, the parent only needs the 'topK' highest scoring results.
+    size_t topK = 0;
 };
 
 /**
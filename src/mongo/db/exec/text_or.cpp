@@ -28,6 +28,7 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -58,11 +59,13 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         size_t topK)
     : PlanStage(kStageType, opCtx),
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
+      _topK(topK),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID),
       _index(index) {}
@@ -148,7 +151,7 @@ PlanStage::StageState TextOrStage::doWork(WorkingSetID* out) {
             stageState = readFromChildren(out);
             break;
         case State::kReturningResults:
-            stageState = returnResults(out);
+            stageState = _topK ? returnTopKResults(out) : returnResults(out);
             break;
         case State::kDone:
             // Should have been handled above.
@@ -206,6 +209,17 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
         _scoreIterator = _scores.begin();
         _internalState = State::kReturningResults;
 
+        if (_topK) {
+            _topKHeap.reserve(_scores.size());
+            for (auto&& score : _scores) {
+                // Ignore non-matched documents.
+                if (score.second.score >= 0) {
+                    _topKHeap.emplace_back(score.second.score, score.first);
+                }
+            }
+            std::make_heap(_topKHeap.begin(), _topKHeap.end());
+        }
+
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childState) {
         // If a stage fails, it may create a status WSM to indicate why it
@@ -251,6 +265,53 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+PlanStage::StageState TextOrStage::returnTopKResults(WorkingSetID* out) {
+    if (_topKReturned == _topK || _topKHeap.empty()) {
+        _internalState = State::kDone;
+        return PlanStage::IS_EOF;
+    }
+
+    // The document may have been invalidated since the heap was built.
+    ScoreMap::iterator scoreIt = _scores.find(_topKHeap.front().second);
+    if (scoreIt == _scores.end()) {
+        std::pop_heap(_topKHeap.begin(), _topKHeap.end());
+        _topKHeap.pop_back();
+        return PlanStage::NEED_TIME;
+    }
+
+    TextRecordData textRecordData = scoreIt->second;
+    WorkingSetMember* wsm = _ws->get(textRecordData.wsid);
+    if (!wsm->hasObj()) {
+        // Leave the document at the top of the heap so that it is retried after yielding.
+        bool fetched;
+        try {
+            fetched = WorkingSetCommon::fetch(getOpCtx(), _ws, textRecordData.wsid, _recordCursor);
+            ++_specificStats.fetches;
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+
+        if (!fetched) {
+            // The document was deleted or no longer has the indexed term; try the next best one.
+            _ws->free(textRecordData.wsid);
+            _scores.erase(scoreIt);
+            std::pop_heap(_topKHeap.begin(), _topKHeap.end());
+            _topKHeap.pop_back();
+            return PlanStage::NEED_TIME;
+        }
+    }
+
+    std::pop_heap(_topKHeap.begin(), _topKHeap.end());
+    _topKHeap.pop_back();
+    ++_topKReturned;
+
+    // Populate the working set member with the text score and return it.
+    wsm->addComputed(new TextScoreComputedData(textRecordData.score));
+    *out = textRecordData.wsid;
+    return PlanStage::ADVANCED;
+}
+
 /**
  * Provides support for covered matching on non-text fields of a compound text index.
  */
@@ -374,9 +435,10 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
             }
         }
 
-        if (shouldKeep && !wsm->hasObj()) {
+        if (shouldKeep && !wsm->hasObj() && !_topK) {
             // Our parent expects RID_AND_OBJ members, so we fetch the document here if we haven't
-            // already.
+            // already. With a top-k limit, only the documents returned are fetched, once all of
+            // the scores are known.
             try {
                 shouldKeep = WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor);
                 ++_specificStats.fetches;
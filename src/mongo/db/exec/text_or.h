@@ -52,6 +52,10 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If 'topK' is non-zero, the parent only needs the 'topK' highest scoring documents. Documents are
+ * then not fetched while the terms are read, and only the best scoring ones are fetched and
+ * returned, in descending score order.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -76,7 +80,8 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                size_t topK = 0);
     ~TextOrStage();
 
     void addChild(unique_ptr<PlanStage> child);
@@ -125,6 +130,12 @@ private:
      */
     StageState returnResults(WorkingSetID* out);
 
+    /**
+     * Worker for kReturningResults when '_topK' is set. Fetches and returns the highest scoring
+     * document remaining in '_topKHeap'.
+     */
+    StageState returnTopKResults(WorkingSetID* out);
+
     // The index spec used to determine where to find the score.
     FTSSpec _ftsSpec;
 
@@ -152,6 +163,16 @@ private:
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // Number of results our parent needs, or 0 if it needs all of them.
+    const size_t _topK;
+
+    // Max-heap of (score, RecordId) over the matching documents, built once all terms have been
+    // read. Only used when '_topK' is set.
+    std::vector<std::pair<double, RecordId>> _topKHeap;
+
+    // Number of results returned from '_topKHeap' so far.
+    size_t _topKReturned = 0;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
@@ -36,6 +36,7 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/mutable/algorithm.h"
+#include "mongo/db/concurrency/hot_document_wait_queue.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -68,6 +70,13 @@ namespace {
 const char idFieldName[] = "_id";
 const FieldRef idFieldRef(idFieldName);
 
+// A batch of a multi-update stops growing once its documents add up to this many bytes.
+const int kMaxUpdateBatchBytes = 256 * 1024;
+
+// How many times the child may be worked per document of a batch while it is gathered, so that an
+// update matching few of the documents it examines still yields regularly.
+const size_t kMaxChildWorksPerBatchedDocument = 4;
+
 Status ensureIdFieldIsFirst(mb::Document* doc) {
     mb::Element idElem = mb::findFirstChildNamed(doc->root(), idFieldName);
 
@@ -344,6 +353,10 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
 
         invariant(oldObj.snapshotId() == getOpCtx()->recoveryUnit()->getSnapshotId());
+        if (!request->isExplain()) {
+            // Let the writers which conflict on this document wait for this write to end.
+            HotDocumentWaitQueue::get().onWrite(getOpCtx(), _collection->ns().ns(), recordId);
+        }
         wunit.commit();
 
         // If the document moved, we might see it again in a collection scan (maybe it's
@@ -355,7 +368,11 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         //
         // This must be done after the wunit commits so we are sure we won't be rolling back.
         if (_updatedRecordIds && (newRecordId != recordId || driver->modsAffectIndices())) {
-            _updatedRecordIds->insert(newRecordId);
+            if (_uncommittedUpdatedRecordIds) {
+                _uncommittedUpdatedRecordIds->push_back(newRecordId);
+            } else {
+                _updatedRecordIds->insert(newRecordId);
+            }
         }
     }
 
@@ -492,6 +509,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _idsToRetry.empty() && !_pendingChildState &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -561,18 +579,29 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    if (_idRetrying == WorkingSet::INVALID_ID && !_idsToRetry.empty()) {
+        _idRetrying = _idsToRetry.front();
+        _idsToRetry.pop_front();
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    const bool isRetry = _idRetrying != WorkingSet::INVALID_ID;
+    if (isRetry) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (_pendingChildState) {
+        std::tie(status, id) = *_pendingChildState;
+        _pendingChildState = boost::none;
+    } else {
+        status = child()->work(&id);
     }
 
-    if (PlanStage::ADVANCED == status) {
+    if (PlanStage::ADVANCED == status && !isRetry && canUpdateInBatches()) {
+        return updateBatch(id, out);
+    } else if (PlanStage::ADVANCED == status) {
         // Need to get these things from the result returned by the child.
         RecordId recordId;
 
@@ -643,6 +672,10 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             // Do the update, get us the new version of the doc.
             newObj = transformAndUpdate(member->obj, recordId);
         } catch (const WriteConflictException&) {
+            // Rather than retrying while the write we conflicted with is still in progress, wait
+            // for it to end if the document is hot.
+            HotDocumentWaitQueue::get().waitAfterConflict(
+                getOpCtx(), _collection->ns().ns(), recordId);
             memberFreer.Dismiss();  // Keep this member around so we can retry updating it.
             return prepareToRetryWSM(id, out);
         }
@@ -784,4 +817,140 @@ PlanStage::StageState UpdateStage::prepareToRetryWSM(WorkingSetID idToRetry, Wor
     return NEED_YIELD;
 }
 
+bool UpdateStage::canUpdateInBatches() const {
+    const UpdateRequest* request = _params.request;
+    return internalUpdateMultiMaxBatchSize.load() > 1 && request->isMulti() &&
+        !request->shouldReturnAnyDocs() && !request->isExplain() &&
+        getOpCtx()->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+}
+
+PlanStage::StageState UpdateStage::updateBatch(WorkingSetID firstId, WorkingSetID* out) {
+    const size_t maxBatchSize = internalUpdateMultiMaxBatchSize.load();
+
+    // Gather the batch. All of its documents are read in the same snapshot, since the plan cannot
+    // yield until this returns.
+    std::vector<WorkingSetID> batch{firstId};
+    auto batchFreer = MakeGuard([&] {
+        for (auto id : batch) {
+            _ws->free(id);
+        }
+    });
+    auto memberBytes = [this](WorkingSetID id) {
+        WorkingSetMember* member = _ws->get(id);
+        return member->hasObj() ? member->obj.value().objsize() : 0;
+    };
+    int batchBytes = memberBytes(firstId);
+    for (size_t works = 0; batch.size() < maxBatchSize && batchBytes < kMaxUpdateBatchBytes &&
+         works < maxBatchSize * kMaxChildWorksPerBatchedDocument;
+         ++works) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = child()->work(&id);
+        if (PlanStage::ADVANCED == state) {
+            batch.push_back(id);
+            batchBytes += memberBytes(id);
+        } else if (PlanStage::IS_EOF == state) {
+            break;
+        } else if (PlanStage::NEED_TIME != state) {
+            _pendingChildState = std::make_pair(state, id);
+            break;
+        }
+    }
+
+    // Keep the documents which still need updating, as doWork() does for a single document.
+    std::vector<WorkingSetID> toUpdate;
+    RecordIdSet batchRecordIds;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        WorkingSetMember* member = _ws->get(batch[i]);
+        if (!member->hasRecordId()) {
+            ++_specificStats.nInvalidateSkips;
+            continue;
+        }
+        invariant(member->hasObj());
+
+        if (_updatedRecordIds->count(member->recordId) > 0 ||
+            !batchRecordIds.insert(member->recordId).second) {
+            continue;
+        }
+
+        bool docStillMatches;
+        try {
+            docStillMatches = write_stage_common::ensureStillMatches(
+                _collection, getOpCtx(), _ws, batch[i], _params.canonicalQuery);
+        } catch (const WriteConflictException&) {
+            // Nothing has been written yet. Retry this document and the rest of the batch.
+            _idsToRetry.insert(_idsToRetry.end(), toUpdate.begin(), toUpdate.end());
+            _idsToRetry.insert(_idsToRetry.end(), batch.begin() + i, batch.end());
+            batch.erase(batch.begin() + i, batch.end());
+            for (auto id : toUpdate) {
+                batch.erase(std::find(batch.begin(), batch.end(), id));
+            }
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        if (!docStillMatches) {
+            continue;
+        }
+
+        // Ensure that the BSONObj underlying the WorkingSetMember is owned because saveState()
+        // is allowed to free the memory.
+        member->makeObjOwnedIfNeeded();
+        toUpdate.push_back(batch[i]);
+    }
+
+    if (toUpdate.empty()) {
+        return PlanStage::NEED_TIME;
+    }
+
+    // Save state before making changes
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    // Each document of the batch gets its own oplog entry, but they all commit together.
+    const auto nModifiedBefore = _specificStats.nModified;
+    std::vector<RecordId> updatedRecordIds;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        _uncommittedUpdatedRecordIds = &updatedRecordIds;
+        ON_BLOCK_EXIT([&] { _uncommittedUpdatedRecordIds = nullptr; });
+        auto statsRestorer = MakeGuard([&] { _specificStats.nModified = nModifiedBefore; });
+
+        for (auto id : toUpdate) {
+            WorkingSetMember* member = _ws->get(id);
+            transformAndUpdate(member->obj, member->recordId);
+        }
+
+        wunit.commit();
+        statsRestorer.Dismiss();
+    } catch (const WriteConflictException&) {
+        // The whole batch was rolled back. Retry its documents one at a time, so that a document
+        // which keeps conflicting does not hold back the rest.
+        for (auto id : toUpdate) {
+            batch.erase(std::find(batch.begin(), batch.end(), id));
+        }
+        _idsToRetry.insert(_idsToRetry.end(), toUpdate.begin(), toUpdate.end());
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    _updatedRecordIds->insert(updatedRecordIds.begin(), updatedRecordIds.end());
+    _specificStats.nMatched += toUpdate.size();
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // The batch has already committed, and there is nothing to return.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 }  // namespace mongo
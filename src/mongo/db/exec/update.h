@@ -29,6 +29,11 @@
 #pragma once
 
 
+#include <boost/optional.hpp>
+#include <deque>
+#include <utility>
+#include <vector>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
@@ -175,6 +180,19 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Returns whether documents may be updated in batches, which is the case for multi-updates
+     * that return no documents, on storage engines with document-level locking.
+     */
+    bool canUpdateInBatches() const;
+
+    /**
+     * Gathers up to internalUpdateMultiMaxBatchSize documents from the child, starting with
+     * 'firstId', and updates those which still need updating in a single WriteUnitOfWork. If the
+     * batch hits a write conflict, its documents are retried one at a time.
+     */
+    StageState updateBatch(WorkingSetID firstId, WorkingSetID* out);
+
     UpdateStageParams _params;
 
     // Not owned by us.
@@ -189,6 +207,18 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // Members of a batch whose update hit a write conflict. They are retried one at a time, like
+    // '_idRetrying', before the child is asked for more documents.
+    std::deque<WorkingSetID> _idsToRetry;
+
+    // A state other than ADVANCED or NEED_TIME which the child returned while a batch was being
+    // gathered, along with its member. Returned by the next call to work().
+    boost::optional<std::pair<StageState, WorkingSetID>> _pendingChildState;
+
+    // While a batch is being written, the new RecordIds of its documents which belong in
+    // '_updatedRecordIds'. They are only added to it once the batch commits.
+    std::vector<RecordId>* _uncommittedUpdatedRecordIds = nullptr;
+
     // Stats
     UpdateStats _specificStats;
 
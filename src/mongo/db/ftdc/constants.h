@@ -43,6 +43,8 @@ extern const char kFTDCDocField[];
 
 extern const char kFTDCDocsField[];
 
+extern const char kFTDCChecksumField[];
+
 extern const char kFTDCCollectStartField[];
 extern const char kFTDCCollectEndField[];
 
@@ -32,6 +32,9 @@
 
 #include "mongo/db/ftdc/controller.h"
 
+#include <algorithm>
+#include <boost/optional.hpp>
+
 #include "mongo/db/client.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/util.h"
@@ -68,6 +71,12 @@ void FTDCController::setPeriod(Milliseconds millis) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _condvar.notify_one();
+}
+
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _configTemp.maxDirectorySizeBytes = size;
@@ -118,6 +127,15 @@ void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -200,7 +218,18 @@ void FTDCController::doLoop() {
             auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
 
             // Get next time to run at
-            auto next_time = FTDCUtil::roundTime(now, _config.period);
+            auto next_periodic_time = FTDCUtil::roundTime(now, _config.period);
+            auto next_time = next_periodic_time;
+
+            // The high frequency collectors run on their own period. When both periods end at the
+            // same time, both sets of collectors run.
+            boost::optional<Date_t> next_high_frequency_time;
+            if (_config.highFrequencyPeriod > Milliseconds(0) &&
+                !_highFrequencyCollectors.empty()) {
+                next_high_frequency_time =
+                    FTDCUtil::roundTime(now, _config.highFrequencyPeriod);
+                next_time = std::min(next_time, next_high_frequency_time.get());
+            }
 
             // Wait for the next run or signal to shutdown
             {
@@ -241,17 +270,28 @@ void FTDCController::doLoop() {
                     _mgr = uassertStatusOK(std::move(swMgr));
                 }
 
-                auto collectSample = _periodicCollectors.collect(client);
+                if (next_time == next_periodic_time) {
+                    auto collectSample = _periodicCollectors.collect(client);
+
+                    Status s = _mgr->writeSampleAndRotateIfNeeded(
+                        client, std::get<0>(collectSample), std::get<1>(collectSample));
+
+                    uassertStatusOK(s);
+
+                    // Store a reference to the most recent document from the periodic collectors
+                    {
+                        stdx::lock_guard<stdx::mutex> lock(_mutex);
+                        _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    }
+                }
 
-                Status s = _mgr->writeSampleAndRotateIfNeeded(
-                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+                if (next_high_frequency_time && next_time == next_high_frequency_time.get()) {
+                    auto collectSample = _highFrequencyCollectors.collect(client);
 
-                uassertStatusOK(s);
+                    Status s = _mgr->writeHighFrequencySampleAndRotateIfNeeded(
+                        client, std::get<0>(collectSample), std::get<1>(collectSample));
 
-                // Store a reference to the most recent document from the periodic collectors
-                {
-                    stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    uassertStatusOK(s);
                 }
             }
         }
@@ -74,6 +74,11 @@ public:
      */
     void setPeriod(Milliseconds millis);
 
+    /**
+     * Set the period for high frequency data collection, zero disables it.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
     /**
      * Set the maximum directory size in bytes.
      */
@@ -110,6 +115,14 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect on the high frequency period. i.e., WiredTiger cache
+     *
+     * These should be cheap to collect, and only report the few metrics which are needed to
+     * diagnose stalls shorter than the regular period.
+     */
+    void addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -199,6 +212,9 @@ private:
     // Set of periodic collectors
     FTDCCollectorCollection _periodicCollectors;
 
+    // Set of high frequency collectors
+    FTDCCollectorCollection _highFrequencyCollectors;
+
     // Last seen sample document from periodic collectors
     // Owned
     BSONObj _mostRecentPeriodicDocument;
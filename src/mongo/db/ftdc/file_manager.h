@@ -84,6 +84,15 @@ public:
      */
     Status writeSampleAndRotateIfNeeded(Client* client, const BSONObj& sample, Date_t date);
 
+    /**
+     * Writes a high frequency sample to disk via FTDCFileWriter.
+     *
+     * Rotates files as needed.
+     */
+    Status writeHighFrequencySampleAndRotateIfNeeded(Client* client,
+                                                     const BSONObj& sample,
+                                                     Date_t date);
+
     /**
      * Closes the current file manager down.
      */
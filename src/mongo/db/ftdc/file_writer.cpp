@@ -76,6 +76,7 @@ Status FTDCFileWriter::open(const boost::filesystem::path& file) {
     _interimTempFile = FTDCUtil::getInterimTempFile(file);
 
     _compressor.reset();
+    _highFrequencyCompressor.reset();
 
     return Status::OK();
 }
@@ -159,29 +160,62 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
     }
 
     if (ret.getValue().is_initialized()) {
-        return flush(std::get<0>(ret.getValue().get()), std::get<2>(ret.getValue().get()));
+        return flush(
+            &_compressor, std::get<0>(ret.getValue().get()), std::get<2>(ret.getValue().get()));
     }
 
     if (_compressor.getSampleCount() != 0 &&
         (_compressor.getSampleCount() % _config->maxSamplesPerInterimMetricChunk) == 0) {
         // Check if we want to do a partial write to the interim buffer
-        auto swBuf = _compressor.getCompressedSamples();
+        return writeInterimChunks();
+    }
+
+    return Status::OK();
+}
+
+Status FTDCFileWriter::writeHighFrequencySample(const BSONObj& sample, Date_t date) {
+    auto ret = _highFrequencyCompressor.addSample(sample, date);
+
+    if (!ret.isOK()) {
+        return ret.getStatus();
+    }
+
+    if (ret.getValue().is_initialized()) {
+        return flush(&_highFrequencyCompressor,
+                     std::get<0>(ret.getValue().get()),
+                     std::get<2>(ret.getValue().get()));
+    }
+
+    return Status::OK();
+}
+
+Status FTDCFileWriter::writeInterimChunks() {
+    BufBuilder buf;
+
+    for (auto compressor : {&_compressor, &_highFrequencyCompressor}) {
+        if (!compressor->hasDataToFlush()) {
+            continue;
+        }
+
+        auto swBuf = compressor->getCompressedSamples();
         if (!swBuf.isOK()) {
             return swBuf.getStatus();
         }
 
         BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
                                                                 std::get<1>(swBuf.getValue()));
-        return writeInterimFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+        buf.appendBuf(o.objdata(), o.objsize());
     }
 
-    return Status::OK();
+    return writeInterimFileBuffer({buf.buf(), static_cast<size_t>(buf.len())});
 }
 
-Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_t date) {
+Status FTDCFileWriter::flush(FTDCCompressor* compressor,
+                             const boost::optional<ConstDataRange>& range,
+                             Date_t date) {
     if (!range.is_initialized()) {
-        if (_compressor.hasDataToFlush()) {
-            auto swBuf = _compressor.getCompressedSamples();
+        if (compressor->hasDataToFlush()) {
+            auto swBuf = compressor->getCompressedSamples();
 
             if (!swBuf.isOK()) {
                 return swBuf.getStatus();
@@ -204,6 +238,8 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
         }
     }
 
+    // The interim file may hold samples which are now in the archive file. Drop it rather than
+    // risk recovering them twice, the next interim write saves any remaining partial chunks.
     boost::filesystem::remove(_interimFile);
 
     return Status::OK();
@@ -211,7 +247,10 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
 
 Status FTDCFileWriter::close() {
     if (_archiveStream.is_open()) {
-        Status s = flush(boost::none, Date_t());
+        Status s = flush(&_compressor, boost::none, Date_t());
+        if (s.isOK()) {
+            s = flush(&_highFrequencyCompressor, boost::none, Date_t());
+        }
 
         _archiveStream.close();
 
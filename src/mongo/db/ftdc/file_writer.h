@@ -61,7 +61,8 @@ class FTDCFileWriter {
     MONGO_DISALLOW_COPYING(FTDCFileWriter);
 
 public:
-    FTDCFileWriter(const FTDCConfig* config) : _config(config), _compressor(_config) {}
+    FTDCFileWriter(const FTDCConfig* config)
+        : _config(config), _compressor(_config), _highFrequencyCompressor(_config) {}
     ~FTDCFileWriter();
 
     /**
@@ -79,6 +80,15 @@ public:
      */
     Status writeSample(const BSONObj& sample, Date_t date);
 
+    /**
+     * Write a high frequency sample to the archive log as needed.
+     *
+     * High frequency samples are compressed separately from the regular samples, and their chunks
+     * are interleaved with the regular chunks in the archive log. Their partial chunk is only
+     * saved to the interim file alongside the regular partial chunk.
+     */
+    Status writeHighFrequencySample(const BSONObj& sample, Date_t date);
+
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
      */
@@ -101,9 +111,14 @@ public:
 
 private:
     /**
-     * Flush all changes to disk.
+     * Flush all changes of the given compressor to disk.
      */
-    Status flush(const boost::optional<ConstDataRange>&, Date_t date);
+    Status flush(FTDCCompressor* compressor, const boost::optional<ConstDataRange>&, Date_t date);
+
+    /**
+     * Write the partial chunks of both compressors to the interim file.
+     */
+    Status writeInterimChunks();
 
     /**
      * Write a buffer to the beginning of the interim file.
@@ -134,6 +149,9 @@ private:
     // FTDC compressor
     FTDCCompressor _compressor;
 
+    // FTDC compressor for the high frequency samples
+    FTDCCompressor _highFrequencyCompressor;
+
     // Size of archive file
     std::size_t _size{0};
 
@@ -149,6 +149,42 @@ TEST(FTDCFileTest, TestFileBasicCompress) {
     ASSERT_EQUALS(sw.getValue(), false);
 }
 
+// Test high frequency samples are compressed into their own chunk and do not split the chunk of
+// the regular samples
+TEST(FTDCFileTest, TestFileHighFrequencyCompress) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    BSONObj doc1 = BSON("name"
+                        << "joe"
+                        << "key1"
+                        << 34);
+    BSONObj doc2 = BSON("name"
+                        << "joe"
+                        << "key1"
+                        << 35);
+    BSONObj hfDoc1 = BSON("cache" << 1 << "tickets" << 128);
+    BSONObj hfDoc2 = BSON("cache" << 2 << "tickets" << 127);
+
+    FTDCConfig config;
+    FTDCFileWriter writer(&config);
+
+    ASSERT_OK(writer.open(p));
+
+    ASSERT_OK(writer.writeSample(doc1, Date_t()));
+    ASSERT_OK(writer.writeHighFrequencySample(hfDoc1, Date_t()));
+    ASSERT_OK(writer.writeSample(doc2, Date_t()));
+    ASSERT_OK(writer.writeHighFrequencySample(hfDoc2, Date_t()));
+
+    writer.close().transitional_ignore();
+
+    // Each group is read back from its own chunk, regular samples first as they are flushed first
+    ValidateDocumentList(p, {doc1, doc2, hfDoc1, hfDoc2});
+}
+
 /**
  * Validates all the data that gets written to file is returned as is
  */
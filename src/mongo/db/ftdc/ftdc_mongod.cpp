@@ -58,6 +58,31 @@ void registerMongoDCollectors(FTDCController* controller) {
                                                                   BSON("collStats"
                                                                        << "oplog.rs")));
     }
+
+    // Sampled on diagnosticDataCollectionHighFrequencyPeriodMillis to catch short stalls from
+    // checkpoints, eviction or ticket exhaustion which are averaged away by the regular period.
+    // The sections which are not needed are excluded to keep the cost of each sample low.
+    BSONObjBuilder serverStatusBuilder;
+    serverStatusBuilder.append("serverStatus", 1);
+    for (auto section : {"asserts",
+                         "commandLatencies",
+                         "locks",
+                         "logicalSessionRecordCache",
+                         "metrics",
+                         "network",
+                         "opLatencies",
+                         "repl",
+                         "sharding"}) {
+        serverStatusBuilder.append(section, false);
+    }
+
+    controller->addHighFrequencyCollector(stdx::make_unique<FTDCProjectedInternalCommandCollector>(
+        "serverStatus",
+        "serverStatus",
+        "",
+        serverStatusBuilder.obj(),
+        BSON("globalLock" << 1 << "wiredTiger"
+                          << BSON("cache" << 1 << "concurrentTransactions" << 1))));
 }
 
 }  // namespace
@@ -110,6 +110,35 @@ public:
 
 } exportedFTDCPeriodParameter;
 
+AtomicInt32 localHighFrequencyPeriodMillis(FTDCConfig::kHighFrequencyPeriodMillisDefault);
+
+class ExportedFTDCHighFrequencyPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyPeriodMillis",
+              &localHighFrequencyPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue != 0 && potentialNewValue < 10) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyPeriodMillis must be either 0 "
+                          "to disable high frequency collection, or greater than or equal to "
+                          "10ms");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyPeriodParameter;
+
 // Scale the values down since are defaults are in bytes, but the user interface is MB
 AtomicInt32 localMaxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024));
 
@@ -261,6 +290,54 @@ std::string FTDCSimpleInternalCommandCollector::name() const {
     return _name;
 }
 
+namespace {
+
+/**
+ * Appends the fields of source which are named in projection. A field whose projection is an
+ * object only has the named fields of its subdocument appended.
+ */
+void appendProjectedFields(const BSONObj& source,
+                           const BSONObj& projection,
+                           BSONObjBuilder* builder) {
+    for (const auto& projected : projection) {
+        auto element = source[projected.fieldNameStringData()];
+        if (element.eoo()) {
+            continue;
+        }
+
+        if (projected.type() == BSONType::Object && element.type() == BSONType::Object) {
+            BSONObjBuilder subObjBuilder(builder->subobjStart(element.fieldNameStringData()));
+            appendProjectedFields(element.Obj(), projected.Obj(), &subObjBuilder);
+        } else {
+            builder->append(element);
+        }
+    }
+}
+
+}  // namespace
+
+FTDCProjectedInternalCommandCollector::FTDCProjectedInternalCommandCollector(StringData command,
+                                                                             StringData name,
+                                                                             StringData ns,
+                                                                             BSONObj cmdObj,
+                                                                             BSONObj projection)
+    : _name(name.toString()),
+      _request(OpMsgRequest::fromDBAndBody(ns, std::move(cmdObj))),
+      _projection(projection.getOwned()) {
+    invariant(command == _request.getCommandName());
+    invariant(Command::findCommand(command));  // Fail early if it doesn't exist.
+}
+
+void FTDCProjectedInternalCommandCollector::collect(OperationContext* opCtx,
+                                                    BSONObjBuilder& builder) {
+    auto result = Command::runCommandDirectly(opCtx, _request);
+    appendProjectedFields(result, _projection, &builder);
+}
+
+std::string FTDCProjectedInternalCommandCollector::name() const {
+    return _name;
+}
+
 // Register the FTDC system
 // Note: This must be run before the server parameters are parsed during startup
 // so that the FTDCController is initialized.
@@ -270,6 +347,7 @@ void startFTDC(boost::filesystem::path& path,
                RegisterCollectorsFunction registerCollectors) {
     FTDCConfig config;
     config.period = Milliseconds(localPeriodMillis.load());
+    config.highFrequencyPeriod = Milliseconds(localHighFrequencyPeriodMillis.load());
     // Only enable FTDC if our caller says to enable FTDC, MongoS may not have a valid path to write
     // files to so update the diagnosticDataCollectionEnabled set parameter to reflect that.
     localEnabledFlag.store(startupMode == FTDCStartMode::kStart && localEnabledFlag.load());
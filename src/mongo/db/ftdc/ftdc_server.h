@@ -96,4 +96,24 @@ private:
     const OpMsgRequest _request;
 };
 
+/**
+ * An FTDC Collector that runs Commands, and only keeps the fields of the reply named in a
+ * projection. i.e., {wiredTiger: {cache: 1}} keeps only the wiredTiger.cache subdocument.
+ *
+ * Used by the high frequency collectors to keep their samples small.
+ */
+class FTDCProjectedInternalCommandCollector final : public FTDCCollectorInterface {
+public:
+    FTDCProjectedInternalCommandCollector(
+        StringData command, StringData name, StringData ns, BSONObj cmdObj, BSONObj projection);
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override;
+    std::string name() const override;
+
+private:
+    std::string _name;
+    const OpMsgRequest _request;
+    const BSONObj _projection;
+};
+
 }  // namespace mongo
@@ -42,6 +42,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/crc32c.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/time_support.h"
@@ -60,10 +61,13 @@ const char kFTDCDocField[] = "doc";
 
 const char kFTDCDocsField[] = "docs";
 
+const char kFTDCChecksumField[] = "crc32c";
+
 const char kFTDCCollectStartField[] = "start";
 const char kFTDCCollectEndField[] = "end";
 
 const std::int64_t FTDCConfig::kPeriodMillisDefault = 1000;
+const std::int64_t FTDCConfig::kHighFrequencyPeriodMillisDefault = 0;
 
 const std::size_t kMaxRecursion = 10;
 
@@ -358,6 +362,8 @@ BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date) {
     builder.appendDate(kFTDCIdField, date);
     builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kMetricChunk));
     builder.appendBinData(kFTDCDataField, buf.length(), BinDataType::BinDataGeneral, buf.data());
+    builder.appendNumber(kFTDCChecksumField,
+                         static_cast<long long>(crc32c(buf.data(), buf.length())));
 
     return builder.obj();
 }
@@ -430,6 +436,21 @@ StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                 str::stream() << "Field " << std::string(kFTDCTypeField) << " is not a BinData."};
     }
 
+    // Chunks written by older versions have no checksum.
+    BSONElement checksumElement = obj[kFTDCChecksumField];
+    if (!checksumElement.eoo()) {
+        long long checksum;
+        status = bsonExtractIntegerField(obj, kFTDCChecksumField, &checksum);
+        if (!status.isOK()) {
+            return {status};
+        }
+
+        if (checksum != crc32c(buffer, length)) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Checksum mismatch in metric chunk " << obj[kFTDCIdField]};
+        }
+    }
+
     return decompressor->uncompress({buffer, static_cast<std::size_t>(length)});
 }
 
@@ -144,7 +144,11 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "_id" : Date_t
  *  "type" : 1
  *  "data" : BinData(...)
+ *  "crc32c" : NumberLong(...)
  * }
+ *
+ * "crc32c" is the CRC-32C of the contents of "data". It is absent from chunks written by older
+ * versions.
  */
 BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
 
@@ -29,6 +29,12 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/ftdc/util.h"
+
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/ftdc/decompressor.h"
+#include "mongo/db/jsobj.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -69,4 +75,31 @@ TEST(FTDCUtilTest, TestMongoSPath) {
     }
 }
 
+// Validate that metric chunks carry a checksum of their data which is verified when reading them.
+TEST(FTDCUtilTest, TestMetricChunkChecksum) {
+    FTDCConfig config;
+    FTDCCompressor compressor(&config);
+    ASSERT_OK(compressor.addSample(BSON("key1" << 33 << "key2" << 42), Date_t()).getStatus());
+    auto swBuf = compressor.getCompressedSamples();
+    ASSERT_OK(swBuf.getStatus());
+    ConstDataRange buf = std::get<0>(swBuf.getValue());
+
+    BSONObj chunk = FTDCBSONUtil::createBSONMetricChunkDocument(buf, Date_t());
+    ASSERT_TRUE(chunk.hasField(kFTDCChecksumField));
+
+    FTDCDecompressor decompressor;
+    ASSERT_OK(FTDCBSONUtil::getMetricsFromMetricDoc(chunk, &decompressor).getStatus());
+
+    // Chunks from older versions have no checksum and are still readable.
+    BSONObj withoutChecksum = chunk.removeField(kFTDCChecksumField);
+    ASSERT_OK(FTDCBSONUtil::getMetricsFromMetricDoc(withoutChecksum, &decompressor).getStatus());
+
+    BSONObj corrupted = chunk.copy();
+    int length;
+    char* data = const_cast<char*>(corrupted[kFTDCDataField].binData(length));
+    data[length - 1] ^= 1;
+    ASSERT_EQ(ErrorCodes::BadValue,
+              FTDCBSONUtil::getMetricsFromMetricDoc(corrupted, &decompressor).getStatus());
+}
+
 }  // namespace mongo
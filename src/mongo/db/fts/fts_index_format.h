@@ -42,6 +42,12 @@ namespace fts {
 
 class FTSSpec;
 
+/**
+ * Generates the keys of a text index. Each document gets one key per distinct term, laid out as
+ * {<prefix fields>, term, score, <suffix fields>}, where 'score' is the document's relevance score
+ * for 'term'. Since scores are normalized by the number of tokens in a field, any edit that changes
+ * that count changes every key the document has in the index.
+ */
 class FTSIndexFormat {
 public:
     static void getKeys(const FTSSpec& spec, const BSONObj& document, BSONObjSet* keys);
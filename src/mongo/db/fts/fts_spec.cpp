@@ -31,6 +31,9 @@
 
 #include "mongo/db/fts/fts_spec.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/fts/fts_element_iterator.h"
@@ -182,10 +185,21 @@ void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) co
 
     FTSElementIterator it(*this, obj);
 
+    // Creating a tokenizer allocates a stemmer, so share one per language across all of the
+    // document's strings. This also lets the stemmer's cache serve words repeated across fields.
+    std::vector<std::pair<const FTSLanguage*, std::unique_ptr<FTSTokenizer>>> tokenizers;
+
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
-        _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
+        auto tokenizerIt = std::find_if(
+            tokenizers.begin(), tokenizers.end(), [&](const auto& entry) {
+                return entry.first == val._language;
+            });
+        if (tokenizerIt == tokenizers.end()) {
+            tokenizers.emplace_back(val._language, val._language->createTokenizer());
+            tokenizerIt = tokenizers.end() - 1;
+        }
+        _scoreStringV2(tokenizerIt->second.get(), val._text, term_freqs, val._weight);
     }
 }
 
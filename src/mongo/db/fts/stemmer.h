@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -60,8 +63,16 @@ public:
      */
     StringData stem(StringData word) const;
 
+    // Upper bound on the number of words whose stems are remembered. The cache is emptied when it
+    // fills up.
+    static const size_t kMaxCachedStems = 1024;
+
 private:
     struct sb_stemmer* _stemmer;
+
+    // Words seen recently, mapped to their stems. Natural language text repeats a small vocabulary,
+    // so this saves running the stemmer for most tokens of a document.
+    mutable StringMap<std::string> _stemCache;
 };
 }
 }
@@ -43,6 +43,24 @@ TEST(English, Stemmer1) {
     ASSERT_EQUALS("Run", s.stem("Running"));
 }
 
+TEST(English, RepeatedWordsStemConsistently) {
+    Stemmer s(&languageEnglishV2);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQUALS("run", s.stem("running"));
+        ASSERT_EQUALS("jump", s.stem("jumped"));
+    }
+}
+
+TEST(English, StemsRemainCorrectOnceCacheFills) {
+    Stemmer s(&languageEnglishV2);
+    for (size_t i = 0; i <= Stemmer::kMaxCachedStems; ++i) {
+        std::string word = "running" + std::to_string(i);
+        ASSERT_EQUALS(word.substr(0, 3), s.stem(word).substr(0, 3));
+    }
+    ASSERT_EQUALS("run", s.stem("running"));
+    ASSERT_EQUALS("run", s.stem("running"));
+}
+
 TEST(English, Caps) {
     Stemmer s(&languagePorterV1);
     ASSERT_EQUALS("unit", s.stem("united"));
@@ -38,6 +38,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/startup_test.h"
+#include "mongo/util/xxhash.h"
 
 namespace mongo {
 
@@ -79,7 +80,27 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+// Feeds the same canonicalized input as Hasher to XXH64, using the hash seed as the XXH64 seed.
+class XXHasher {
+    MONGO_DISALLOW_COPYING(XXHasher);
+
+public:
+    explicit XXHasher(HashSeed seed) : _state(static_cast<uint64_t>(seed)) {}
+
+    void addData(const void* keyData, size_t numBytes) {
+        _state.update(keyData, numBytes);
+    }
+
+    long long int digest() const {
+        return static_cast<long long int>(_state.digest());
+    }
+
+private:
+    XXHash64 _state;
+};
+
+template <typename H>
+void recursiveHash(H* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -122,11 +143,17 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64(
+                   o.firstElement(), 0, BSONElementHasher::kXXHash64HashVersion) ==
+               -7008785330394283643LL);
     }
 } hasherUnitTest;
 
 }  // namespace
 
+const int BSONElementHasher::kMD5HashVersion;
+const int BSONElementHasher::kXXHash64HashVersion;
+
 long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     Hasher h(seed);
     recursiveHash(&h, e, false);
@@ -137,4 +164,15 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed, int hashVersion) {
+    if (hashVersion == kMD5HashVersion) {
+        return hash64(e, seed);
+    }
+
+    invariant(hashVersion == kXXHash64HashVersion);
+    XXHasher h(seed);
+    recursiveHash(&h, e, false);
+    return h.digest();
+}
+
 }  // namespace mongo
@@ -54,6 +54,18 @@ public:
      */
     static const int DEFAULT_HASH_SEED = 0;
 
+    /* Versions of the hash function, as recorded in the "hashVersion" field of a hashed
+     * index spec. Version 0 is MD5-based and is the only version hashed sharding understands.
+     * Version 1 hashes the same canonicalized bytes with the much cheaper 64-bit xxHash, and
+     * may only be used for hashed indexes that do not back a hashed shard key.
+     */
+    static const int kMD5HashVersion = 0;
+    static const int kXXHash64HashVersion = 1;
+
+    static bool isSupportedHashVersion(int hashVersion) {
+        return hashVersion == kMD5HashVersion || hashVersion == kXXHash64HashVersion;
+    }
+
     /* This computes a 64-bit hash of the value part of BSONElement "e",
      * preceded by the seed "seed".  Squashes element (and any sub-elements)
      * of the same canonical type, so hash({a:{b:4}}) will be the same
@@ -68,6 +80,11 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* Same as above, but with the hash function picked by "hashVersion", which must satisfy
+     * isSupportedHashVersion(). hash64(e, seed, kMD5HashVersion) == hash64(e, seed).
+     */
+    static long long int hash64(const BSONElement& e, HashSeed seed, int hashVersion);
+
 private:
     BSONElementHasher();
 };
@@ -28,9 +28,11 @@
 
 #include "mongo/db/index/btree_key_generator.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/query/collation/collation_index_key.h"
@@ -283,10 +285,10 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                                               std::vector<BSONElement>* fixed,
                                               const BSONElement& arrEntry,
-                                              BSONObjSet* keys,
+                                              std::vector<BSONObj>* keys,
                                               unsigned numNotFound,
                                               const BSONElement& arrObjElt,
-                                              const std::set<size_t>& arrIdxs,
+                                              const std::vector<size_t>& arrIdxs,
                                               bool mayExpandArrayUnembedded,
                                               const std::vector<PositionalPathInfo>& positionalInfo,
                                               MultikeyPaths* multikeyPaths) const {
@@ -343,23 +345,45 @@ void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
         invariant(multikeyPaths->empty());
         multikeyPaths->resize(fieldNames.size());
     }
-    getKeysImplWithArray(
-        std::move(fieldNames), std::move(fixed), obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+
+    std::vector<BSONObj> generatedKeys;
+    getKeysImplWithArray(std::move(fieldNames),
+                         std::move(fixed),
+                         obj,
+                         &generatedKeys,
+                         0,
+                         _emptyPositionalInfo,
+                         multikeyPaths);
+
+    if (generatedKeys.size() > 1) {
+        std::sort(generatedKeys.begin(),
+                  generatedKeys.end(),
+                  SimpleBSONObjComparator::kInstance.makeLessThan());
+        generatedKeys.erase(std::unique(generatedKeys.begin(),
+                                        generatedKeys.end(),
+                                        SimpleBSONObjComparator::kInstance.makeEqualTo()),
+                            generatedKeys.end());
+    }
+
+    // The keys are now in the set's order, so each insertion just appends to the end.
+    for (auto&& key : generatedKeys) {
+        keys->insert(keys->end(), std::move(key));
+    }
 }
 
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
     std::vector<const char*> fieldNames,
     std::vector<BSONElement> fixed,
     const BSONObj& obj,
-    BSONObjSet* keys,
+    std::vector<BSONObj>* keys,
     unsigned numNotFound,
     const std::vector<PositionalPathInfo>& positionalInfo,
     MultikeyPaths* multikeyPaths) const {
     BSONElement arrElt;
 
-    // A set containing the position of any indexed fields in the key pattern that traverse through
-    // the 'arrElt' array value.
-    std::set<size_t> arrIdxs;
+    // The positions, in increasing order, of any indexed fields in the key pattern that traverse
+    // through the 'arrElt' array value.
+    std::vector<size_t> arrIdxs;
 
     // A vector with size equal to the number of elements in the index key pattern. Each element in
     // the vector, if initialized, refers to the component within the indexed field that traverses
@@ -401,7 +425,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
             fieldNames[i] = "";
             numNotFound++;
         } else if (e.type() == Array) {
-            arrIdxs.insert(i);
+            arrIdxs.push_back(i);
             if (arrElt.eoo()) {
                 // we only expand arrays on a single path -- track the path here
                 arrElt = e;
@@ -427,7 +451,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         for (std::vector<BSONElement>::iterator i = fixed.begin(); i != fixed.end(); ++i) {
             CollationIndexKey::collationAwareIndexKeyAppend(*i, _collator, &b);
         }
-        keys->insert(b.obj());
+        keys->push_back(b.obj());
     } else if (arrElt.embeddedObject().firstElement().eoo()) {
         // We've encountered an empty array.
         if (multikeyPaths && mayExpandArrayUnembedded) {
@@ -465,7 +489,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         // array element).
         std::vector<PositionalPathInfo> subPositionalInfo(fixed.size());
         for (size_t i = 0; i < fieldNames.size(); ++i) {
-            const bool fieldIsArray = arrIdxs.find(i) != arrIdxs.end();
+            const bool fieldIsArray = std::binary_search(arrIdxs.begin(), arrIdxs.end(), i);
 
             if (*fieldNames[i] == '\0') {
                 // We've reached the end of the path.
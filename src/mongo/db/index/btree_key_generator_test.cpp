@@ -209,6 +209,23 @@ TEST(BtreeKeyGeneratorTest, GetKeysFromArrayWithEquivalentValues) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromLargeUnsortedArrayWithDuplicates) {
+    BSONObj keyPattern = fromjson("{a: 1, b: 1}");
+    BSONArrayBuilder arr;
+    for (int i = 0; i < 1000; ++i) {
+        arr.append((i * 37) % 50);
+    }
+    BSONObj genKeysFrom = BSON("a" << arr.arr() << "b"
+                                   << "x");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    for (int i = 0; i < 50; ++i) {
+        expectedKeys.insert(BSON("" << i << ""
+                                    << "x"));
+    }
+    MultikeyPaths expectedMultikeyPaths{{0U}, std::set<size_t>{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
 TEST(BtreeKeyGeneratorTest, GetKeysFromArrayFirstElement) {
     BSONObj keyPattern = fromjson("{a: 1, b: 1}");
     BSONObj genKeysFrom = fromjson("{a: [1, 2, 3], b: 2}");
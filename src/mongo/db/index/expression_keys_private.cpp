@@ -376,8 +376,10 @@ void ExpressionKeysPrivate::getHashKeys(const BSONObj& obj,
 
 // static
 long long int ExpressionKeysPrivate::makeSingleHashKey(const BSONElement& e, HashSeed seed, int v) {
-    massert(16767, "Only HashVersion 0 has been defined", v == 0);
-    return BSONElementHasher::hash64(e, seed);
+    massert(16767,
+            str::stream() << "Unsupported hashVersion " << v,
+            BSONElementHasher::isSupportedHashVersion(v));
+    return BSONElementHasher::hash64(e, seed, v);
 }
 
 // static
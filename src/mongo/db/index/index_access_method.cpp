@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -45,11 +46,13 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/index_prefix_counts.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
@@ -79,6 +82,9 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
 
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
+// The number of threads each bulk index build may use to spill and merge its sorted keys.
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildSortThreads, int, 4);
+
 //
 // Comparison for external sorter interface
 //
@@ -134,8 +140,10 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     *numInserted = 0;
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
+    // There's no need to compute the multikey paths if the index metadata can't change anymore.
+    const bool skipMultikeyPaths = _btreeState->isMultikeyOnAllPaths();
     // Delegate to the subclass.
-    getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
+    getKeys(obj, options.getKeysMode, &keys, skipMultikeyPaths ? nullptr : &multikeyPaths);
 
     const ValidationOperation operation = ValidationOperation::INSERT;
 
@@ -179,13 +187,107 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
         return status;
     }
 
-    if (*numInserted > 1 || isMultikeyFromPaths(multikeyPaths)) {
+    if (!skipMultikeyPaths && (*numInserted > 1 || isMultikeyFromPaths(multikeyPaths))) {
         _btreeState->setMultikey(opCtx, multikeyPaths);
     }
 
+    if (auto prefixCounts = _btreeState->prefixCounts()) {
+        prefixCounts->onInsert(opCtx, keys);
+    }
+
     return ret;
 }
 
+Status IndexAccessMethod::insertBatch(OperationContext* opCtx,
+                                      const std::vector<BsonRecord>& bsonRecords,
+                                      const InsertDeleteOptions& options,
+                                      int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+
+    std::vector<std::pair<BSONObj, RecordId>> keysToInsert;
+    std::vector<MultikeyPaths> multikeyPathsToSet;
+    const bool skipMultikeyPaths = _btreeState->isMultikeyOnAllPaths();
+    for (auto&& bsonRecord : bsonRecords) {
+        invariant(bsonRecord.id != RecordId());
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        // Delegate to the subclass.
+        getKeys(*bsonRecord.docPtr,
+                options.getKeysMode,
+                &keys,
+                skipMultikeyPaths ? nullptr : &multikeyPaths);
+
+        if (!skipMultikeyPaths && (keys.size() > 1 || isMultikeyFromPaths(multikeyPaths))) {
+            multikeyPathsToSet.push_back(std::move(multikeyPaths));
+        }
+        if (auto prefixCounts = _btreeState->prefixCounts()) {
+            // Only applied if the WriteUnitOfWork commits, so after the whole batch is inserted.
+            prefixCounts->onInsert(opCtx, keys);
+        }
+        for (auto&& key : keys) {
+            keysToInsert.emplace_back(key, bsonRecord.id);
+        }
+    }
+
+    const Ordering ordering = Ordering::make(_descriptor->keyPattern());
+    std::sort(keysToInsert.begin(),
+              keysToInsert.end(),
+              [&ordering](const std::pair<BSONObj, RecordId>& lhs,
+                          const std::pair<BSONObj, RecordId>& rhs) {
+                  int cmp = lhs.first.woCompare(rhs.first, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.second < rhs.second);
+              });
+
+    const ValidationOperation operation = ValidationOperation::INSERT;
+
+    for (auto it = keysToInsert.begin(); it != keysToInsert.end(); ++it) {
+        Status status = _newInterface->insert(opCtx, it->first, it->second, options.dupsAllowed);
+
+        // Everything's OK, carry on.
+        if (status.isOK()) {
+            ++*numInserted;
+            IndexKeyEntry indexEntry = IndexKeyEntry(it->first, it->second);
+            _descriptor->getCollection()->informIndexObserver(
+                opCtx, _descriptor, indexEntry, operation);
+            continue;
+        }
+
+        // Error cases.
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+            IndexKeyEntry indexEntry = IndexKeyEntry(it->first, it->second);
+            _descriptor->getCollection()->informIndexObserver(
+                opCtx, _descriptor, indexEntry, operation);
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue) {
+            // A document might be indexed multiple times during a background index build
+            // if it moves ahead of the collection scan cursor (e.g. via an update).
+            if (!_btreeState->isReady(opCtx)) {
+                LOG(3) << "key " << it->first
+                       << " already in index during background indexing (ok)";
+                continue;
+            }
+        }
+
+        // Clean up after ourselves.
+        for (auto j = keysToInsert.begin(); j != it; ++j) {
+            removeOneKey(opCtx, j->first, j->second, options.dupsAllowed);
+        }
+        *numInserted = 0;
+
+        return status;
+    }
+
+    for (auto&& multikeyPaths : multikeyPathsToSet) {
+        _btreeState->setMultikey(opCtx, multikeyPaths);
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -236,6 +338,10 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
         ++*numDeleted;
     }
 
+    if (auto prefixCounts = _btreeState->prefixCounts()) {
+        prefixCounts->onRemove(opCtx, keys);
+    }
+
     return Status::OK();
 }
 
@@ -362,7 +468,10 @@ Status IndexAccessMethod::validateUpdate(OperationContext* opCtx,
     }
 
     if (!indexFilter || indexFilter->matchesBSON(to)) {
-        getKeys(to, options.getKeysMode, &ticket->newKeys, &ticket->newMultikeyPaths);
+        // As in insert(), skip computing the multikey paths if they can't add anything.
+        MultikeyPaths* newMultikeyPaths =
+            _btreeState->isMultikeyOnAllPaths() ? nullptr : &ticket->newMultikeyPaths;
+        getKeys(to, options.getKeysMode, &ticket->newKeys, newMultikeyPaths);
     }
 
     ticket->loc = record;
@@ -389,8 +498,11 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
-    if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1 ||
-        isMultikeyFromPaths(ticket.newMultikeyPaths)) {
+    // Once the index is multikey on all paths it stays so, which is what allowed validateUpdate()
+    // to leave 'newMultikeyPaths' empty.
+    if (!_btreeState->isMultikeyOnAllPaths() &&
+        (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1 ||
+         isMultikeyFromPaths(ticket.newMultikeyPaths))) {
         _btreeState->setMultikey(opCtx, ticket.newMultikeyPaths);
     }
 
@@ -428,11 +540,15 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
     *numInserted = ticket.added.size();
     *numDeleted = ticket.removed.size();
 
+    if (auto prefixCounts = _btreeState->prefixCounts()) {
+        prefixCounts->onUpdate(opCtx, ticket.oldKeys, ticket.newKeys);
+    }
+
     return Status::OK();
 }
 
-Status IndexAccessMethod::compact(OperationContext* opCtx) {
-    return this->_newInterface->compact(opCtx);
+Status IndexAccessMethod::compact(OperationContext* opCtx, const CompactOptions* options) {
+    return this->_newInterface->compact(opCtx, options);
 }
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
@@ -447,7 +563,8 @@ IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
           SortOptions()
               .TempDir(storageGlobalParams.dbpath + "/_tmp")
               .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
+              .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+              .NumThreads(std::max(maxIndexBuildSortThreads.load(), 1)),
           BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
       _real(index) {}
 
@@ -46,6 +46,7 @@ extern AtomicBool failIndexKeyTooLong;
 
 class BSONObjBuilder;
 class MatchExpression;
+struct BsonRecord;
 class UpdateTicket;
 struct InsertDeleteOptions;
 
@@ -84,6 +85,17 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Equivalent to calling insert() for each of 'bsonRecords', except that the keys of all the
+     * documents are generated first and then inserted in index key order, so that consecutive
+     * inserts touch neighbouring parts of the index. 'numInserted' will be set to the total number
+     * of keys added. On error, the keys already added by this call are removed again.
+     */
+    Status insertBatch(OperationContext* opCtx,
+                       const std::vector<BsonRecord>& bsonRecords,
+                       const InsertDeleteOptions& options,
+                       int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -188,7 +200,7 @@ public:
      * Attempt compaction to regain disk space if the indexed record store supports
      * compaction-in-place.
      */
-    Status compact(OperationContext* opCtx);
+    Status compact(OperationContext* opCtx, const CompactOptions* options);
 
     //
     // Bulk operations support
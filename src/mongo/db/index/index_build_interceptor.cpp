@@ -0,0 +1,188 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/index_build_interceptor.h"
+
+#include <vector>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+// The number of side writes applied in each WriteUnitOfWork while draining.
+const size_t kDrainBatchSize = 1000;
+
+}  // namespace
+
+/**
+ * Marks a side write as committed or rolled back along with the WriteUnitOfWork that made it.
+ */
+class IndexBuildInterceptor::SideWriteChange : public RecoveryUnit::Change {
+public:
+    SideWriteChange(IndexBuildInterceptor* interceptor, int64_t seq)
+        : _interceptor(interceptor), _seq(seq) {}
+
+    void commit() final {
+        _interceptor->setState(_seq, State::kCommitted);
+    }
+
+    void rollback() final {
+        _interceptor->setState(_seq, State::kRolledBack);
+    }
+
+private:
+    IndexBuildInterceptor* const _interceptor;
+    const int64_t _seq;
+};
+
+void IndexBuildInterceptor::sideWrite(OperationContext* opCtx,
+                                      const BSONObj& doc,
+                                      const RecordId& loc,
+                                      Op op) {
+    int64_t seq;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        seq = _drainedSeq + _sideWrites.size();
+        _sideWrites.push_back({op, doc.getOwned(), loc, State::kPending});
+    }
+    opCtx->recoveryUnit()->registerChange(new SideWriteChange(this, seq));
+}
+
+void IndexBuildInterceptor::setState(int64_t seq, State state) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(seq >= _drainedSeq);
+    _sideWrites[seq - _drainedSeq].state = state;
+}
+
+Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
+                                                   IndexAccessMethod* iam,
+                                                   const InsertDeleteOptions& options) {
+    // Removals are blind unless duplicates are allowed, and the key being removed may never have
+    // been loaded.
+    InsertDeleteOptions removeOptions = options;
+    removeOptions.dupsAllowed = true;
+    removeOptions.logIfError = false;
+
+    // Writes made while draining are left for a later drain, so that a steady stream of them
+    // can't keep this one going.
+    int64_t endSeq;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        endSeq = _drainedSeq + _sideWrites.size();
+    }
+
+    while (true) {
+        std::vector<SideWrite> batch;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            while (batch.size() < kDrainBatchSize && _drainedSeq < endSeq &&
+                   _sideWrites.front().state != State::kPending) {
+                if (_sideWrites.front().state == State::kCommitted) {
+                    batch.push_back(std::move(_sideWrites.front()));
+                }
+                _sideWrites.pop_front();
+                ++_drainedSeq;
+            }
+        }
+        if (batch.empty()) {
+            return Status::OK();
+        }
+
+        Status status = writeConflictRetry(opCtx, "index build drain", _ns, [&] {
+            WriteUnitOfWork wunit(opCtx);
+            std::vector<BsonRecord> inserts;
+            auto flushInserts = [&] {
+                int64_t numKeys;
+                Status status = inserts.size() == 1
+                    ? iam->insert(opCtx, *inserts[0].docPtr, inserts[0].id, options, &numKeys)
+                    : iam->insertBatch(opCtx, inserts, options, &numKeys);
+                inserts.clear();
+                return status;
+            };
+
+            for (auto&& sideWrite : batch) {
+                if (sideWrite.op == Op::kInsert) {
+                    inserts.push_back({sideWrite.loc, &sideWrite.doc});
+                    continue;
+                }
+
+                // A delete must not be reordered with the inserts before it, which may be for the
+                // same document.
+                if (!inserts.empty()) {
+                    Status status = flushInserts();
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+                int64_t numKeys;
+                Status status =
+                    iam->remove(opCtx, sideWrite.doc, sideWrite.loc, removeOptions, &numKeys);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+            if (!inserts.empty()) {
+                Status status = flushInserts();
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+            wunit.commit();
+            return Status::OK();
+        });
+        if (!status.isOK()) {
+            return status;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _numApplied += batch.size();
+    }
+}
+
+bool IndexBuildInterceptor::areAllWritesApplied() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sideWrites.empty();
+}
+
+int64_t IndexBuildInterceptor::numApplied() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numApplied;
+}
+
+}  // namespace mongo
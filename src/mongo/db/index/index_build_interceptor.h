@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class IndexAccessMethod;
+class OperationContext;
+struct InsertDeleteOptions;
+
+/**
+ * Captures writes to an index that is being bulk built without the collection lock held (a
+ * "hybrid" index build), so that they can be applied once the bulk-loaded keys are in place.
+ *
+ * While an IndexCatalogEntry has an interceptor, writers record the documents they insert into or
+ * delete from the collection here instead of touching the index. The index builder then drains
+ * the side writes into the index, in the order they were made, after committing its bulk load.
+ * Applying a side write is idempotent with respect to the collection scan: inserting a key that
+ * the scan already loaded, or removing a key that it never saw, is a no-op. Only indexes that
+ * don't enforce uniqueness may be built this way.
+ *
+ * A ready index created with the "deferred" option keeps an interceptor for as long as it exists,
+ * and the DeferredIndexApplier drains it in the background.
+ *
+ * The side writes are kept in memory. All methods are thread-safe.
+ */
+class IndexBuildInterceptor {
+    MONGO_DISALLOW_COPYING(IndexBuildInterceptor);
+
+public:
+    enum class Op { kInsert, kDelete };
+
+    /**
+     * 'ns' is the namespace of the collection being indexed.
+     */
+    explicit IndexBuildInterceptor(std::string ns) : _ns(std::move(ns)) {}
+
+    /**
+     * Records that 'doc' was inserted into or deleted from the collection at 'loc'. Must be called
+     * inside the WriteUnitOfWork making the write; the side write is discarded if it rolls back.
+     */
+    void sideWrite(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc, Op op);
+
+    /**
+     * Applies the committed side writes to the index through 'iam', stopping at the first one
+     * whose WriteUnitOfWork is still in progress or at the last one made before the call. Writes
+     * that were rolled back are skipped. Consecutive inserts are applied in index key order.
+     */
+    Status drainWritesIntoIndex(OperationContext* opCtx,
+                                IndexAccessMethod* iam,
+                                const InsertDeleteOptions& options);
+
+    /**
+     * Returns true if every side write recorded so far has been applied or skipped. Once writers
+     * are excluded by an exclusive lock, a final drain makes this true.
+     */
+    bool areAllWritesApplied() const;
+
+    /**
+     * The number of side writes applied to the index so far.
+     */
+    int64_t numApplied() const;
+
+private:
+    class SideWriteChange;
+
+    enum class State { kPending, kCommitted, kRolledBack };
+
+    struct SideWrite {
+        Op op;
+        BSONObj doc;
+        RecordId loc;
+        State state;
+    };
+
+    void setState(int64_t seq, State state);
+
+    const std::string _ns;
+
+    mutable stdx::mutex _mutex;
+
+    // Side writes that haven't been drained, oldest first. '_sideWrites.front()' has sequence
+    // number '_drainedSeq'.
+    std::deque<SideWrite> _sideWrites;
+    int64_t _drainedSeq = 0;
+    int64_t _numApplied = 0;
+};
+
+}  // namespace mongo
@@ -81,15 +81,18 @@ constexpr StringData IndexDescriptor::k2dsphereVersionFieldName;
 constexpr StringData IndexDescriptor::kBackgroundFieldName;
 constexpr StringData IndexDescriptor::kCollationFieldName;
 constexpr StringData IndexDescriptor::kDefaultLanguageFieldName;
+constexpr StringData IndexDescriptor::kDeferredFieldName;
 constexpr StringData IndexDescriptor::kDropDuplicatesFieldName;
 constexpr StringData IndexDescriptor::kExpireAfterSecondsFieldName;
 constexpr StringData IndexDescriptor::kGeoHaystackBucketSize;
+constexpr StringData IndexDescriptor::kHashVersionFieldName;
 constexpr StringData IndexDescriptor::kIndexNameFieldName;
 constexpr StringData IndexDescriptor::kIndexVersionFieldName;
 constexpr StringData IndexDescriptor::kKeyPatternFieldName;
 constexpr StringData IndexDescriptor::kLanguageOverrideFieldName;
 constexpr StringData IndexDescriptor::kNamespaceFieldName;
 constexpr StringData IndexDescriptor::kPartialFilterExprFieldName;
+constexpr StringData IndexDescriptor::kPrefixCountsFieldName;
 constexpr StringData IndexDescriptor::kSparseFieldName;
 constexpr StringData IndexDescriptor::kStorageEngineFieldName;
 constexpr StringData IndexDescriptor::kTextVersionFieldName;
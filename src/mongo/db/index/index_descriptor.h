@@ -67,15 +67,18 @@ public:
     static constexpr StringData kBackgroundFieldName = "background"_sd;
     static constexpr StringData kCollationFieldName = "collation"_sd;
     static constexpr StringData kDefaultLanguageFieldName = "default_language"_sd;
+    static constexpr StringData kDeferredFieldName = "deferred"_sd;
     static constexpr StringData kDropDuplicatesFieldName = "dropDups"_sd;
     static constexpr StringData kExpireAfterSecondsFieldName = "expireAfterSeconds"_sd;
     static constexpr StringData kGeoHaystackBucketSize = "bucketSize"_sd;
+    static constexpr StringData kHashVersionFieldName = "hashVersion"_sd;
     static constexpr StringData kIndexNameFieldName = "name"_sd;
     static constexpr StringData kIndexVersionFieldName = "v"_sd;
     static constexpr StringData kKeyPatternFieldName = "key"_sd;
     static constexpr StringData kLanguageOverrideFieldName = "language_override"_sd;
     static constexpr StringData kNamespaceFieldName = "ns"_sd;
     static constexpr StringData kPartialFilterExprFieldName = "partialFilterExpression"_sd;
+    static constexpr StringData kPrefixCountsFieldName = "prefixCounts"_sd;
     static constexpr StringData kSparseFieldName = "sparse"_sd;
     static constexpr StringData kStorageEngineFieldName = "storageEngine"_sd;
     static constexpr StringData kTextVersionFieldName = "textIndexVersion"_sd;
@@ -98,6 +101,8 @@ public:
           _sparse(infoObj[IndexDescriptor::kSparseFieldName].trueValue()),
           _unique(_isIdIndex || infoObj[kUniqueFieldName].trueValue()),
           _partial(!infoObj[kPartialFilterExprFieldName].eoo()),
+          _deferred(infoObj[kDeferredFieldName].trueValue()),
+          _prefixCounts(infoObj[kPrefixCountsFieldName].trueValue()),
           _cachedEntry(NULL) {
         _indexNamespace = makeIndexNamespace(_parentNS, _indexName);
 
@@ -208,6 +213,16 @@ public:
         return _partial;
     }
 
+    // Are writes to this index applied in the background rather than by the writer?
+    bool isDeferred() const {
+        return _deferred;
+    }
+
+    // Are the documents counted by the value of the leading field of this index?
+    bool tracksPrefixCounts() const {
+        return _prefixCounts;
+    }
+
     // Is this index multikey?
     bool isMultikey(OperationContext* opCtx) const;
 
@@ -285,6 +300,8 @@ private:
     bool _sparse;
     bool _unique;
     bool _partial;
+    bool _deferred;
+    bool _prefixCounts;
     IndexVersion _version;
 
     // only used by IndexCatalogEntryContainer to do caching for perf
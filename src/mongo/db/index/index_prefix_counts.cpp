@@ -0,0 +1,184 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/index_prefix_counts.h"
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/stdx/unordered_set.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns the distinct values of the leading field of 'keys'. Since the keys are ordered by their
+ * leading field first, equal values are next to each other.
+ */
+std::vector<BSONObj> distinctPrefixes(const BSONObjSet& keys) {
+    std::vector<BSONObj> prefixes;
+    for (auto&& key : keys) {
+        BSONObj prefix = IndexPrefixCounts::prefixOf(key);
+        if (prefixes.empty() ||
+            SimpleBSONObjComparator::kInstance.evaluate(prefixes.back() != prefix)) {
+            prefixes.push_back(std::move(prefix));
+        }
+    }
+    return prefixes;
+}
+
+}  // namespace
+
+IndexPrefixCounts::IndexPrefixCounts()
+    : _counts(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<long long>()) {}
+
+BSONObj IndexPrefixCounts::prefixOf(const BSONObj& key) {
+    BSONObjBuilder bob;
+    bob.appendAs(key.firstElement(), "");
+    return bob.obj();
+}
+
+void IndexPrefixCounts::rebuild(OperationContext* opCtx,
+                                const IndexAccessMethod* iam,
+                                bool isMultikey) {
+    auto counts = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<long long>();
+
+    // The keys of a multikey index are deduplicated by document within each value, since all the
+    // keys with the same value are next to each other.
+    BSONObj currentPrefix;
+    stdx::unordered_set<RecordId, RecordId::Hasher> currentDocs;
+    long long* currentCount = nullptr;
+
+    auto cursor = iam->newCursor(opCtx, true);
+    for (auto entry = cursor->seek(kMinBSONKey, true); entry; entry = cursor->next()) {
+        BSONObj prefix = prefixOf(entry->key);
+        if (!currentCount ||
+            SimpleBSONObjComparator::kInstance.evaluate(currentPrefix != prefix)) {
+            currentCount = &counts[prefix];
+            currentPrefix = std::move(prefix);
+            currentDocs.clear();
+        }
+        if (!isMultikey || currentDocs.insert(entry->loc).second) {
+            ++*currentCount;
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _counts = std::move(counts);
+    _built = true;
+}
+
+void IndexPrefixCounts::onInsert(OperationContext* opCtx, const BSONObjSet& keys) {
+    Deltas deltas;
+    for (auto&& prefix : distinctPrefixes(keys)) {
+        deltas.emplace_back(std::move(prefix), 1);
+    }
+    _registerDeltas(opCtx, std::move(deltas));
+}
+
+void IndexPrefixCounts::onRemove(OperationContext* opCtx, const BSONObjSet& keys) {
+    Deltas deltas;
+    for (auto&& prefix : distinctPrefixes(keys)) {
+        deltas.emplace_back(std::move(prefix), -1);
+    }
+    _registerDeltas(opCtx, std::move(deltas));
+}
+
+void IndexPrefixCounts::onUpdate(OperationContext* opCtx,
+                                 const BSONObjSet& oldKeys,
+                                 const BSONObjSet& newKeys) {
+    const auto oldPrefixes = distinctPrefixes(oldKeys);
+    const auto newPrefixes = distinctPrefixes(newKeys);
+
+    // Both lists are sorted, so the values which were added or removed are found in one pass.
+    Deltas deltas;
+    auto oldIt = oldPrefixes.begin();
+    auto newIt = newPrefixes.begin();
+    while (oldIt != oldPrefixes.end() || newIt != newPrefixes.end()) {
+        const int cmp = oldIt == oldPrefixes.end()
+            ? 1
+            : newIt == newPrefixes.end() ? -1 : SimpleBSONObjComparator::kInstance.compare(
+                                                   *oldIt, *newIt);
+        if (cmp < 0) {
+            deltas.emplace_back(*oldIt++, -1);
+        } else if (cmp > 0) {
+            deltas.emplace_back(*newIt++, 1);
+        } else {
+            ++oldIt;
+            ++newIt;
+        }
+    }
+    _registerDeltas(opCtx, std::move(deltas));
+}
+
+void IndexPrefixCounts::_registerDeltas(OperationContext* opCtx, Deltas deltas) {
+    if (deltas.empty() || !isBuilt()) {
+        // Writers are excluded while the counts are built, so a write made before then is
+        // already committed and included in them.
+        return;
+    }
+    opCtx->recoveryUnit()->onCommit([ this, deltas = std::move(deltas) ] { _applyDeltas(deltas); });
+}
+
+void IndexPrefixCounts::_applyDeltas(const Deltas& deltas) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& delta : deltas) {
+        auto it = _counts.emplace(delta.first, 0).first;
+        it->second += delta.second;
+        if (it->second <= 0) {
+            _counts.erase(it);
+        }
+    }
+}
+
+boost::optional<long long> IndexPrefixCounts::count(const std::vector<BSONObj>& prefixes) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_built) {
+        return boost::none;
+    }
+
+    long long total = 0;
+    for (auto&& prefix : prefixes) {
+        auto it = _counts.find(prefix);
+        if (it != _counts.end()) {
+            total += it->second;
+        }
+    }
+    return total;
+}
+
+bool IndexPrefixCounts::isBuilt() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _built;
+}
+
+}  // namespace mongo
@@ -0,0 +1,115 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class IndexAccessMethod;
+class OperationContext;
+
+/**
+ * Counts the documents of a collection by the value of the leading field of an index created with
+ * the "prefixCounts" option, so that a count of the documents with given values of that field,
+ * such as count({tenant: "x"}) with an index {tenant: 1, ...}, can be answered without a scan.
+ * A document is counted once for each distinct value it has a key for, so the counts of a
+ * multikey index match what a COUNT_SCAN of the index would return.
+ *
+ * The counts are kept in memory. They are built by a scan of the index when the index becomes
+ * ready, at the end of its build or when the catalog is loaded, and are then maintained by the
+ * IndexAccessMethod as documents are indexed and unindexed. Each write registers its changes with
+ * the WriteUnitOfWork making it, so that they are applied when it commits.
+ *
+ * All methods are thread-safe.
+ */
+class IndexPrefixCounts {
+    MONGO_DISALLOW_COPYING(IndexPrefixCounts);
+
+public:
+    IndexPrefixCounts();
+
+    /**
+     * Replaces the counts with those of the keys in the index accessed through 'iam'. The caller
+     * must hold a lock which excludes the writers to the collection.
+     */
+    void rebuild(OperationContext* opCtx, const IndexAccessMethod* iam, bool isMultikey);
+
+    /**
+     * Record that a document with the index keys 'keys' was inserted or removed, or that its
+     * keys changed from 'oldKeys' to 'newKeys'. Must be called inside the WriteUnitOfWork making
+     * the write, and have no effect until the counts are built.
+     */
+    void onInsert(OperationContext* opCtx, const BSONObjSet& keys);
+    void onRemove(OperationContext* opCtx, const BSONObjSet& keys);
+    void onUpdate(OperationContext* opCtx, const BSONObjSet& oldKeys, const BSONObjSet& newKeys);
+
+    /**
+     * Returns the number of documents with a key whose leading field has one of the values in
+     * 'prefixes', which must be distinct single-field objects with empty field names, in the
+     * format of index keys. Returns boost::none if the counts have not been built.
+     */
+    boost::optional<long long> count(const std::vector<BSONObj>& prefixes) const;
+
+    /**
+     * Returns true once the counts have been built.
+     */
+    bool isBuilt() const;
+
+    /**
+     * Returns the leading field of 'key', as a single-field object with an empty field name.
+     */
+    static BSONObj prefixOf(const BSONObj& key);
+
+private:
+    using Deltas = std::vector<std::pair<BSONObj, long long>>;
+
+    /**
+     * Adds the changes in 'deltas' to the counts when the current WriteUnitOfWork commits.
+     */
+    void _registerDeltas(OperationContext* opCtx, Deltas deltas);
+
+    void _applyDeltas(const Deltas& deltas);
+
+    mutable stdx::mutex _mutex;
+
+    bool _built = false;
+
+    // The number of documents for each value of the leading field. Values without documents are
+    // removed.
+    BSONObjIndexedMap<long long> _counts;
+};
+
+}  // namespace mongo
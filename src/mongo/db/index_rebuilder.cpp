@@ -43,6 +43,7 @@
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/util/log.h"
@@ -55,7 +56,9 @@ using std::string;
 using std::vector;
 
 namespace {
-void checkNS(OperationContext* opCtx, const std::list<std::string>& nsToCheck) {
+void checkNS(OperationContext* opCtx,
+             const std::list<std::string>& nsToCheck,
+             bool rebuildDeferredIndexes) {
     bool firstTime = true;
     for (std::list<std::string>::const_iterator it = nsToCheck.begin(); it != nsToCheck.end();
          ++it) {
@@ -86,6 +89,24 @@ void checkNS(OperationContext* opCtx, const std::list<std::string>& nsToCheck) {
             WriteUnitOfWork wunit(opCtx);
             vector<BSONObj> indexesToBuild = indexCatalog->getAndClearUnfinishedIndexes(opCtx);
 
+            if (rebuildDeferredIndexes && serverGlobalParams.indexBuildRetry) {
+                vector<IndexDescriptor*> deferredIndexes;
+                IndexCatalog::IndexIterator ii = indexCatalog->getIndexIterator(opCtx, false);
+                while (ii.more()) {
+                    IndexDescriptor* descriptor = ii.next();
+                    if (descriptor->isDeferred()) {
+                        deferredIndexes.push_back(descriptor);
+                    }
+                }
+
+                for (IndexDescriptor* descriptor : deferredIndexes) {
+                    log() << "rebuilding deferred index " << descriptor->indexName() << " on "
+                          << nss.ns() << " after an unclean shutdown";
+                    indexesToBuild.push_back(descriptor->infoObj().getOwned());
+                    uassertStatusOK(indexCatalog->dropIndex(opCtx, descriptor));
+                }
+            }
+
             // The indexes have now been removed from system.indexes, so the only record is
             // in-memory. If there is a journal commit between now and when insert() rewrites
             // the entry and the db crashes before the new system.indexes entry is journalled,
@@ -141,7 +162,8 @@ void checkNS(OperationContext* opCtx, const std::list<std::string>& nsToCheck) {
 }
 }  // namespace
 
-void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx) {
+void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx,
+                                              bool rebuildDeferredIndexes) {
     AuthorizationSession::get(opCtx->getClient())->grantInternalAuthorization();
 
     std::vector<std::string> dbNames;
@@ -159,7 +181,7 @@ void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx) {
             Database* db = autoDb.getDb();
             db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collNames);
         }
-        checkNS(opCtx, collNames);
+        checkNS(opCtx, collNames, rebuildDeferredIndexes);
     } catch (const DBException& e) {
         error() << "Index verification did not complete: " << redact(e);
         fassertFailedNoTrace(18643);
@@ -33,8 +33,11 @@ namespace mongo {
 class OperationContext;
 
 /**
- * Restarts building indexes that were in progress during shutdown.
+ * Restarts building indexes that were in progress during shutdown. If 'rebuildDeferredIndexes'
+ * is true, also drops and rebuilds every deferred index, whose writes that were not applied yet
+ * are lost when the server does not shut down cleanly.
  * Only call this at startup before taking requests.
  */
-void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx);
+void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx,
+                                              bool rebuildDeferredIndexes);
 }
@@ -32,17 +32,30 @@
 
 #include "mongo/db/introspect.h"
 
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/counter.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -54,6 +67,13 @@ using std::string;
 
 namespace {
 
+MONGO_EXPORT_SERVER_PARAMETER(profilerDeferredWrites, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(profilerDeferredWriteBufferSizeBytes, int, 16 * 1024 * 1024);
+
+Counter64 profilerDroppedEntriesCounter;
+ServerStatusMetricField<Counter64> displayProfilerDroppedEntries(
+    "profiler.deferredWrites.droppedEntries", &profilerDroppedEntriesCounter);
+
 void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSession* authSession) {
     UserNameIterator nameIter = authSession->getAuthenticatedUserNames();
 
@@ -79,6 +99,184 @@ void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSessi
     builder.append("user", bestUser.getUser().empty() ? "" : bestUser.getFullName());
 }
 
+/**
+ * Inserts the entries into the profile collection of 'dbName', creating the collection if it was
+ * dropped after profiling was enabled. Throws if the insert fails.
+ */
+void _insertProfileEntries(OperationContext* opCtx,
+                           const std::string& dbName,
+                           const std::vector<InsertStatement>& entries) {
+    const bool wasLocked = opCtx->lockState()->isLocked();
+
+    bool acquireDbXLock = false;
+    while (true) {
+        std::unique_ptr<AutoGetDb> autoGetDb;
+        if (acquireDbXLock) {
+            autoGetDb.reset(new AutoGetDb(opCtx, dbName, MODE_X));
+            if (autoGetDb->getDb()) {
+                createProfileCollection(opCtx, autoGetDb->getDb()).transitional_ignore();
+            }
+        } else {
+            autoGetDb.reset(new AutoGetDb(opCtx, dbName, MODE_IX));
+        }
+
+        Database* const db = autoGetDb->getDb();
+        if (!db) {
+            // Database disappeared
+            log() << "note: not profiling because db went away for " << dbName;
+            break;
+        }
+
+        Lock::CollectionLock collLock(opCtx->lockState(), db->getProfilingNS(), MODE_IX);
+
+        Collection* const coll = db->getCollection(opCtx, db->getProfilingNS());
+        if (coll) {
+            writeConflictRetry(opCtx, "profile", db->getProfilingNS(), [&] {
+                WriteUnitOfWork wuow(opCtx);
+                OpDebug* const nullOpDebug = nullptr;
+                coll->insertDocuments(opCtx, entries.begin(), entries.end(), nullOpDebug, false)
+                    .transitional_ignore();
+                wuow.commit();
+            });
+
+            break;
+        } else if (!acquireDbXLock &&
+                   (!wasLocked || opCtx->lockState()->isDbLockedForMode(dbName, MODE_X))) {
+            // Try to create the collection only if we are not under lock, in order to
+            // avoid deadlocks due to lock conversion. This would only be hit if someone
+            // deletes the profiler collection after setting profile level.
+            acquireDbXLock = true;
+        } else {
+            // Cannot write the profile information
+            break;
+        }
+    }
+}
+
+/**
+ * Buffers profile entries in memory and writes them to the profile collections in batches from a
+ * background thread, so that profiled operations do not take the locks of, or wait for, the
+ * insert into system.profile.
+ *
+ * Entries which do not fit in the buffer are dropped. Entries still buffered when the server
+ * crashes are lost.
+ */
+class DeferredProfileWriter {
+    MONGO_DISALLOW_COPYING(DeferredProfileWriter);
+
+public:
+    DeferredProfileWriter() = default;
+
+    /**
+     * Buffers an entry for the profile collection of 'dbName', starting the background thread on
+     * first use. Returns false if the entry was dropped.
+     */
+    bool add(std::string dbName, BSONObj entry) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_inShutdown ||
+            _bufferedBytes + entry.objsize() > profilerDeferredWriteBufferSizeBytes.load()) {
+            return false;
+        }
+
+        if (!_thread.joinable()) {
+            _thread = stdx::thread([this] { _run(); });
+        }
+
+        _bufferedBytes += entry.objsize();
+        _buffer.emplace_back(std::move(dbName), std::move(entry));
+        _condvar.notify_one();
+        return true;
+    }
+
+    /**
+     * Writes out the buffered entries and stops the background thread.
+     */
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inShutdown = true;
+            _condvar.notify_one();
+        }
+
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+private:
+    using Buffer = std::vector<std::pair<std::string, BSONObj>>;
+
+    void _run() {
+        Client::initThread("profileWriter");
+
+        while (true) {
+            Buffer batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait(lk, [this] { return !_buffer.empty() || _inShutdown; });
+                if (_buffer.empty()) {
+                    return;
+                }
+
+                // Everything which accumulated while the previous batch was written goes into
+                // this one.
+                batch.swap(_buffer);
+                _bufferedBytes = 0;
+            }
+
+            _writeBatch(batch);
+        }
+    }
+
+    void _writeBatch(const Buffer& batch) {
+        std::map<std::string, std::vector<InsertStatement>> entriesByDb;
+        for (const auto& entry : batch) {
+            entriesByDb[entry.first].emplace_back(entry.second);
+        }
+
+        auto opCtx = cc().makeOperationContext();
+        for (auto& dbEntries : entriesByDb) {
+            const auto& entries = dbEntries.second;
+            for (size_t begin = 0; begin < entries.size(); begin += kMaxEntriesPerWrite) {
+                const auto end = std::min(begin + kMaxEntriesPerWrite, entries.size());
+                try {
+                    _insertProfileEntries(
+                        opCtx.get(),
+                        dbEntries.first,
+                        std::vector<InsertStatement>(entries.begin() + begin,
+                                                     entries.begin() + end));
+                } catch (const DBException& ex) {
+                    warning() << "Caught exception while writing deferred profile entries for "
+                              << dbEntries.first << ": " << redact(ex);
+                }
+            }
+        }
+    }
+
+    // Bounds the size of a single write unit of work into a capped profile collection.
+    static constexpr size_t kMaxEntriesPerWrite = 100;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+
+    // Entries waiting to be written, and the sum of their sizes.
+    Buffer _buffer;
+    int _bufferedBytes = 0;
+
+    bool _inShutdown = false;
+
+    stdx::thread _thread;
+};
+
+constexpr size_t DeferredProfileWriter::kMaxEntriesPerWrite;
+
+DeferredProfileWriter* getDeferredProfileWriter() {
+    // Intentionally leaked so that a writer thread never outlives its owner during exit.
+    static DeferredProfileWriter* const writer = new DeferredProfileWriter();
+    return writer;
+}
+
 }  // namespace
 
 
@@ -111,59 +309,27 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 
     const BSONObj p = b.done();
 
-    const bool wasLocked = opCtx->lockState()->isLocked();
-
     const string dbName(nsToDatabase(CurOp::get(opCtx)->getNS()));
 
-    try {
-        bool acquireDbXLock = false;
-        while (true) {
-            std::unique_ptr<AutoGetDb> autoGetDb;
-            if (acquireDbXLock) {
-                autoGetDb.reset(new AutoGetDb(opCtx, dbName, MODE_X));
-                if (autoGetDb->getDb()) {
-                    createProfileCollection(opCtx, autoGetDb->getDb()).transitional_ignore();
-                }
-            } else {
-                autoGetDb.reset(new AutoGetDb(opCtx, dbName, MODE_IX));
-            }
-
-            Database* const db = autoGetDb->getDb();
-            if (!db) {
-                // Database disappeared
-                log() << "note: not profiling because db went away for "
-                      << CurOp::get(opCtx)->getNS();
-                break;
-            }
-
-            Lock::CollectionLock collLock(opCtx->lockState(), db->getProfilingNS(), MODE_IX);
-
-            Collection* const coll = db->getCollection(opCtx, db->getProfilingNS());
-            if (coll) {
-                WriteUnitOfWork wuow(opCtx);
-                OpDebug* const nullOpDebug = nullptr;
-                coll->insertDocument(opCtx, InsertStatement(p), nullOpDebug, false)
-                    .transitional_ignore();
-                wuow.commit();
-
-                break;
-            } else if (!acquireDbXLock &&
-                       (!wasLocked || opCtx->lockState()->isDbLockedForMode(dbName, MODE_X))) {
-                // Try to create the collection only if we are not under lock, in order to
-                // avoid deadlocks due to lock conversion. This would only be hit if someone
-                // deletes the profiler collection after setting profile level.
-                acquireDbXLock = true;
-            } else {
-                // Cannot write the profile information
-                break;
-            }
+    if (profilerDeferredWrites.load()) {
+        if (!getDeferredProfileWriter()->add(dbName, p.getOwned())) {
+            profilerDroppedEntriesCounter.increment();
         }
+        return;
+    }
+
+    try {
+        _insertProfileEntries(opCtx, dbName, {InsertStatement(p)});
     } catch (const AssertionException& assertionEx) {
         warning() << "Caught Assertion while trying to profile " << networkOpToString(op)
                   << " against " << CurOp::get(opCtx)->getNS() << ": " << redact(assertionEx);
     }
 }
 
+void shutdownDeferredProfileWriter() {
+    getDeferredProfileWriter()->shutdown();
+}
+
 
 Status createProfileCollection(OperationContext* opCtx, Database* db) {
     invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_X));
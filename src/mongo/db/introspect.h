@@ -41,6 +41,12 @@ class OperationContext;
  */
 void profile(OperationContext* opCtx, NetworkOp op);
 
+/**
+ * Writes out the profile entries buffered when profilerDeferredWrites is enabled, and stops the
+ * thread writing them. Must be called before the storage engine shuts down.
+ */
+void shutdownDeferredProfileWriter();
+
 /**
  * Pre-creates the profile collection for the specified database.
  */
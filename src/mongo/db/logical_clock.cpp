@@ -92,20 +92,31 @@ void LogicalClock::set(ServiceContext* service, std::unique_ptr<LogicalClock> cl
 LogicalClock::LogicalClock(ServiceContext* service) : _service(service) {}
 
 LogicalTime LogicalClock::getClusterTime() {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    return _clusterTime;
+    return _getClusterTime();
 }
 
-Status LogicalClock::advanceClusterTime(const LogicalTime newTime) {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
+LogicalTime LogicalClock::_getClusterTime() const {
+    return LogicalTime(Timestamp(_clusterTime.load()));
+}
+
+void LogicalClock::_setClusterTime_inlock(LogicalTime newTime) {
+    _clusterTime.store(newTime.asTimestamp().asULL());
+}
 
-    auto rateLimitStatus = _passesRateLimiter_inlock(newTime);
+Status LogicalClock::advanceClusterTime(const LogicalTime newTime) {
+    auto rateLimitStatus = _passesRateLimiter(newTime);
     if (!rateLimitStatus.isOK()) {
         return rateLimitStatus;
     }
 
-    if (newTime > _clusterTime) {
-        _clusterTime = newTime;
+    // Most cluster times received were already seen, so check before taking the mutex.
+    if (newTime <= _getClusterTime()) {
+        return Status::OK();
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    if (newTime > _getClusterTime()) {
+        _setClusterTime_inlock(newTime);
     }
 
     return Status::OK();
@@ -117,7 +128,7 @@ LogicalTime LogicalClock::reserveTicks(uint64_t nTicks) {
 
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-    LogicalTime clusterTime = _clusterTime;
+    LogicalTime clusterTime = _getClusterTime();
 
     const unsigned wallClockSecs =
         durationCount<Seconds>(_service->getFastClockSource()->now().toDurationSinceEpoch());
@@ -147,12 +158,13 @@ LogicalTime LogicalClock::reserveTicks(uint64_t nTicks) {
 
     // Save the next cluster time.
     clusterTime.addTicks(1);
-    _clusterTime = clusterTime;
+    LogicalTime reservedUntil = clusterTime;
 
     // Add the rest of the requested ticks if needed.
     if (nTicks > 1) {
-        _clusterTime.addTicks(nTicks - 1);
+        reservedUntil.addTicks(nTicks - 1);
     }
+    _setClusterTime_inlock(reservedUntil);
 
     return clusterTime;
 }
@@ -167,12 +179,12 @@ void LogicalClock::setClusterTimeFromTrustedSource(LogicalTime newTime) {
             "cluster time cannot be advanced beyond its maximum value",
             lessThanOrEqualToMaxPossibleTime(newTime, 0));
 
-    if (newTime > _clusterTime) {
-        _clusterTime = newTime;
+    if (newTime > _getClusterTime()) {
+        _setClusterTime_inlock(newTime);
     }
 }
 
-Status LogicalClock::_passesRateLimiter_inlock(LogicalTime newTime) {
+Status LogicalClock::_passesRateLimiter(LogicalTime newTime) {
     const unsigned wallClockSecs =
         durationCount<Seconds>(_service->getFastClockSource()->now().toDurationSinceEpoch());
     auto maxAcceptableDriftSecs = static_cast<const unsigned>(maxAcceptableLogicalClockDriftSecs);
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/logical_time.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -65,7 +66,7 @@ public:
     Status advanceClusterTime(const LogicalTime newTime);
 
     /**
-     * Returns the current clusterTime.
+     * Returns the current clusterTime. Does not take the clock's mutex.
      */
     LogicalTime getClusterTime();
 
@@ -87,13 +88,23 @@ private:
      * Rate limiter for advancing cluster time. Rejects newTime if its seconds value is more than
      * kMaxAcceptableLogicalClockDriftSecs seconds ahead of this node's wall clock.
      */
-    Status _passesRateLimiter_inlock(LogicalTime newTime);
+    Status _passesRateLimiter(LogicalTime newTime);
+
+    /**
+     * Loads the current clusterTime without taking _mutex.
+     */
+    LogicalTime _getClusterTime() const;
+
+    /**
+     * Publishes newTime as the clusterTime. Must be called while holding _mutex.
+     */
+    void _setClusterTime_inlock(LogicalTime newTime);
 
     ServiceContext* const _service;
 
-    // The mutex protects _clusterTime.
+    // The mutex serializes the updates of _clusterTime. Reads load it without the mutex.
     stdx::mutex _mutex;
-    LogicalTime _clusterTime;
+    AtomicUInt64 _clusterTime;
 };
 
 }  // namespace mongo
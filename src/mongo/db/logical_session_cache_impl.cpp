@@ -53,6 +53,7 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(disableLogicalSessionCacheRefresh, bool, false);
 
 constexpr Minutes LogicalSessionCacheImpl::kLogicalSessionDefaultRefresh;
+constexpr size_t LogicalSessionCacheImpl::kNumPartitions;
 
 LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     std::unique_ptr<ServiceLiason> service,
@@ -65,8 +66,10 @@ LogicalSessionCacheImpl::LogicalSessionCacheImpl(
       _sessionsColl(std::move(collection)),
       _transactionReaper(std::move(transactionReaper)) {
     if (!disableLogicalSessionCacheRefresh) {
-        _service->scheduleJob(
-            {[this](Client* client) { _periodicRefresh(client); }, _refreshInterval});
+        // Each run of the refresh job writes one partition, so every session is still written
+        // once per refresh interval.
+        _service->scheduleJob({[this](Client* client) { _periodicRefresh(client); },
+                               Milliseconds(_refreshInterval) / static_cast<int>(kNumPartitions)});
         _service->scheduleJob(
             {[this](Client* client) { _periodicReap(client); }, _refreshInterval});
     }
@@ -83,9 +86,10 @@ LogicalSessionCacheImpl::~LogicalSessionCacheImpl() {
 }
 
 Status LogicalSessionCacheImpl::promote(LogicalSessionId lsid) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    auto it = _activeSessions.find(lsid);
-    if (it == _activeSessions.end()) {
+    auto& partition = _partitionFor(lsid);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.activeSessions.find(lsid);
+    if (it == partition.activeSessions.end()) {
         return {ErrorCodes::NoSuchSession, "no matching session record found in the cache"};
     }
 
@@ -139,7 +143,7 @@ void LogicalSessionCacheImpl::vivify(OperationContext* opCtx, const LogicalSessi
 
 Status LogicalSessionCacheImpl::refreshNow(Client* client) {
     try {
-        _refresh(client);
+        _refresh(client, 0, kNumPartitions);
     } catch (...) {
         return exceptionToStatus();
     }
@@ -155,13 +159,20 @@ Date_t LogicalSessionCacheImpl::now() {
 }
 
 size_t LogicalSessionCacheImpl::size() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheMutex);
-    return _activeSessions.size();
+    size_t size = 0;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        size += partition.activeSessions.size();
+    }
+    return size;
 }
 
 void LogicalSessionCacheImpl::_periodicRefresh(Client* client) {
+    const size_t partition = _nextRefreshPartition;
+    _nextRefreshPartition = (_nextRefreshPartition + 1) % kNumPartitions;
+
     try {
-        _refresh(client);
+        _refresh(client, partition, 1);
     } catch (...) {
         log() << "Failed to refresh session cache: " << exceptionToStatus();
     }
@@ -200,34 +211,55 @@ Status LogicalSessionCacheImpl::_reap(Client* client) {
     return Status::OK();
 }
 
-void LogicalSessionCacheImpl::_refresh(Client* client) {
-    LogicalSessionIdSet staleSessions;
-    LogicalSessionIdSet explicitlyEndingSessions;
-    LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
+void LogicalSessionCacheImpl::_refresh(Client* client,
+                                       size_t firstPartition,
+                                       size_t numPartitions) {
+    invariant(firstPartition + numPartitions <= kNumPartitions);
+    const auto isRefreshed = [firstPartition, numPartitions](const LogicalSessionId& lsid) {
+        return _partitionIndex(lsid) - firstPartition < numPartitions;
+    };
+    const auto refreshedIndex = [firstPartition](const LogicalSessionId& lsid) {
+        return _partitionIndex(lsid) - firstPartition;
+    };
+
+    // The ending and active sessions of each refreshed partition, indexed by partition number
+    // relative to 'firstPartition'.
+    std::vector<LogicalSessionIdSet> endingSessions(numPartitions);
+    std::vector<LogicalSessionIdMap<LogicalSessionRecord>> activeSessions(numPartitions);
 
     // backSwapper creates a guard that in the case of a exception
     // replaces the ending or active sessions that swapped out of of LogicalSessionCache,
     // and merges in any records that had been added since we swapped them
     // out.
-    auto backSwapper = [this](auto& member, auto& temp) {
-        return MakeGuard([this, &member, &temp] {
-            stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-            using std::swap;
-            swap(member, temp);
-            for (const auto& it : temp) {
-                member.emplace(it);
+    auto backSwapper = [this, firstPartition, numPartitions](auto member, auto& temps) {
+        return MakeGuard([this, firstPartition, numPartitions, member, &temps] {
+            for (size_t i = 0; i < numPartitions; ++i) {
+                auto& partition = _partitions[firstPartition + i];
+                stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+                using std::swap;
+                swap(partition.*member, temps[i]);
+                for (const auto& it : temps[i]) {
+                    (partition.*member).emplace(it);
+                }
             }
         });
     };
 
-    {
+    for (size_t i = 0; i < numPartitions; ++i) {
         using std::swap;
-        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-        swap(explicitlyEndingSessions, _endingSessions);
-        swap(activeSessions, _activeSessions);
+        auto& partition = _partitions[firstPartition + i];
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        swap(endingSessions[i], partition.endingSessions);
+        swap(activeSessions[i], partition.activeSessions);
+    }
+    auto activeSessionsBackSwapper = backSwapper(&CachePartition::activeSessions, activeSessions);
+    auto explicitlyEndingBackSwaper = backSwapper(&CachePartition::endingSessions, endingSessions);
+
+    LogicalSessionIdSet explicitlyEndingSessions;
+    for (const auto& partitionEndingSessions : endingSessions) {
+        explicitlyEndingSessions.insert(partitionEndingSessions.begin(),
+                                        partitionEndingSessions.end());
     }
-    auto activeSessionsBackSwapper = backSwapper(_activeSessions, activeSessions);
-    auto explicitlyEndingBackSwaper = backSwapper(_endingSessions, explicitlyEndingSessions);
 
     // get or make an opCtx
 
@@ -243,7 +275,7 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
 
     // remove all explicitlyEndingSessions from activeSessions
     for (const auto& lsid : explicitlyEndingSessions) {
-        activeSessions.erase(lsid);
+        activeSessions[refreshedIndex(lsid)].erase(lsid);
     }
 
     // refresh all recently active sessions as well as for sessions attached to running ops
@@ -253,6 +285,9 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     auto runningOpSessions = _service->getActiveOpSessions();
 
     for (const auto& it : runningOpSessions) {
+        if (!isRefreshed(it)) {
+            continue;
+        }
         // if a running op is the cause of an upsert, we won't have a user name for the record
         if (explicitlyEndingSessions.count(it) > 0) {
             continue;
@@ -261,8 +296,10 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         lsr.setId(it);
         activeSessionRecords.insert(lsr);
     }
-    for (const auto& it : activeSessions) {
-        activeSessionRecords.insert(it.second);
+    for (const auto& partitionActiveSessions : activeSessions) {
+        for (const auto& it : partitionActiveSessions) {
+            activeSessionRecords.insert(it.second);
+        }
     }
     // refresh the active sessions in the sessions collection
     uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
@@ -278,6 +315,13 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     KillAllSessionsByPatternSet patterns;
 
     auto openCursorSessions = _service->getOpenCursorSessions();
+    for (auto it = openCursorSessions.begin(); it != openCursorSessions.end();) {
+        if (isRefreshed(*it)) {
+            ++it;
+        } else {
+            it = openCursorSessions.erase(it);
+        }
+    }
     // think about pruning ending and active out of openCursorSessions
     auto statusAndRemovedSessions = _sessionsColl->findRemovedSessions(opCtx, openCursorSessions);
 
@@ -303,33 +347,54 @@ void LogicalSessionCacheImpl::clear() {
 }
 
 void LogicalSessionCacheImpl::endSessions(const LogicalSessionIdSet& sessions) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _endingSessions.insert(begin(sessions), end(sessions));
+    for (const auto& lsid : sessions) {
+        auto& partition = _partitionFor(lsid);
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.endingSessions.insert(lsid);
+    }
 }
 
 void LogicalSessionCacheImpl::_addToCache(LogicalSessionRecord record) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _activeSessions.insert(std::make_pair(record.getId(), record));
+    auto& partition = _partitionFor(record.getId());
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    partition.activeSessions.insert(std::make_pair(record.getId(), record));
+}
+
+size_t LogicalSessionCacheImpl::_partitionIndex(const LogicalSessionId& lsid) {
+    return LogicalSessionIdHash()(lsid) % kNumPartitions;
+}
+
+LogicalSessionCacheImpl::CachePartition& LogicalSessionCacheImpl::_partitionFor(
+    const LogicalSessionId& lsid) {
+    return _partitions[_partitionIndex(lsid)];
+}
+
+const LogicalSessionCacheImpl::CachePartition& LogicalSessionCacheImpl::_partitionFor(
+    const LogicalSessionId& lsid) const {
+    return _partitions[_partitionIndex(lsid)];
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds() const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    ret.reserve(_activeSessions.size());
-    for (const auto& id : _activeSessions) {
-        ret.push_back(id.first);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& id : partition.activeSessions) {
+            ret.push_back(id.first);
+        }
     }
     return ret;
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
     const std::vector<SHA256Block>& userDigests) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    for (const auto& it : _activeSessions) {
-        if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
-            userDigests.cend()) {
-            ret.push_back(it.first);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& it : partition.activeSessions) {
+            if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
+                userDigests.cend()) {
+                ret.push_back(it.first);
+            }
         }
     }
     return ret;
@@ -337,9 +402,10 @@ std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
 
 boost::optional<LogicalSessionRecord> LogicalSessionCacheImpl::peekCached(
     const LogicalSessionId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    const auto it = _activeSessions.find(id);
-    if (it == _activeSessions.end()) {
+    const auto& partition = _partitionFor(id);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    const auto it = partition.activeSessions.find(id);
+    if (it == partition.activeSessions.end()) {
         return boost::none;
     }
     return it->second;
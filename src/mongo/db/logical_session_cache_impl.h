@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/db/logical_session_cache.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/refresh_sessions_gen.h"
@@ -57,6 +59,13 @@ class LogicalSessionCacheImpl final : public LogicalSessionCache {
 public:
     static constexpr Minutes kLogicalSessionDefaultRefresh = Minutes(5);
 
+    /**
+     * The cache is split by session id into this many partitions, each with its own mutex. The
+     * periodic refresh writes one partition at a time, so that the writes to the sessions
+     * collection are spread over the refresh interval.
+     */
+    static constexpr size_t kNumPartitions = 16;
+
     /**
      * An Options type to support the LogicalSessionCacheImpl.
      */
@@ -128,12 +137,19 @@ public:
     void endSessions(const LogicalSessionIdSet& sessions) override;
 
 private:
+    struct CachePartition {
+        mutable stdx::mutex mutex;
+        LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
+        LogicalSessionIdSet endingSessions;
+    };
+
     /**
      * Internal methods to handle scheduling and perform refreshes for active
-     * session records contained within the cache.
+     * session records contained within the cache. _refresh() refreshes the 'numPartitions'
+     * partitions starting at 'firstPartition'.
      */
     void _periodicRefresh(Client* client);
-    void _refresh(Client* client);
+    void _refresh(Client* client, size_t firstPartition, size_t numPartitions);
 
     void _periodicReap(Client* client);
     Status _reap(Client* client);
@@ -148,6 +164,10 @@ private:
      */
     void _addToCache(LogicalSessionRecord record);
 
+    static size_t _partitionIndex(const LogicalSessionId& lsid);
+    CachePartition& _partitionFor(const LogicalSessionId& lsid);
+    const CachePartition& _partitionFor(const LogicalSessionId& lsid) const;
+
     const Minutes _refreshInterval;
     const Minutes _sessionTimeout;
 
@@ -157,11 +177,10 @@ private:
     mutable stdx::mutex _reaperMutex;
     std::shared_ptr<TransactionReaper> _transactionReaper;
 
-    mutable stdx::mutex _cacheMutex;
-
-    LogicalSessionIdMap<LogicalSessionRecord> _activeSessions;
+    std::array<CachePartition, kNumPartitions> _partitions;
 
-    LogicalSessionIdSet _endingSessions;
+    // The partition the next periodic refresh writes. Only used by the periodic refresh job.
+    size_t _nextRefreshPartition = 0;
 
     Date_t lastRefreshTime;
 };
@@ -85,17 +85,22 @@ SignedLogicalTime LogicalTimeValidator::_getProof(const KeysCollectionDocument&
                                                   LogicalTime newTime) {
     auto key = keyDoc.getKey();
 
-    // Compare and calculate HMAC inside mutex to prevent multiple threads computing HMAC for the
-    // same cluster time.
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    // Note: _lastSeenValidTime will initially not have a proof set.
-    if (newTime == _lastSeenValidTime.getTime() && _lastSeenValidTime.getProof()) {
-        return _lastSeenValidTime;
+    // Most responses carry the latest cluster time, which was signed already.
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        // Note: _lastSeenValidTime will initially not have a proof set.
+        if (newTime == _lastSeenValidTime.getTime() && _lastSeenValidTime.getProof() &&
+            _lastSeenValidTime.getKeyId() == keyDoc.getKeyId()) {
+            return _lastSeenValidTime;
+        }
     }
 
+    // The time proof service caches the last proof it computed, so threads racing to sign the
+    // same time do not all compute the HMAC, and they do not need to hold _mutex while it does.
     auto signature = _timeProofService.getProof(newTime, key);
     SignedLogicalTime newSignedTime(newTime, std::move(signature), keyDoc.getKeyId());
 
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
     if (newTime > _lastSeenValidTime.getTime() || !_lastSeenValidTime.getProof()) {
         _lastSeenValidTime = newSignedTime;
     }
@@ -159,6 +164,12 @@ Status LogicalTimeValidator::validate(OperationContext* opCtx, const SignedLogic
         return res;
     }
 
+    // Remember the time, so that validating or signing it again does not need another HMAC.
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (newTime.getTime() > _lastSeenValidTime.getTime() || !_lastSeenValidTime.getProof()) {
+        _lastSeenValidTime = newTime;
+    }
+
     return Status::OK();
 }
 
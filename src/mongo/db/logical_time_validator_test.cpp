@@ -116,6 +116,20 @@ TEST_F(LogicalTimeValidatorTest, GetTimeWithIncreasingTimes) {
     ASSERT_TRUE(newTime2.getProof());
 }
 
+TEST_F(LogicalTimeValidatorTest, SigningTheSameTimeAgainReturnsTheSameSignature) {
+    validator()->enableKeyGenerator(operationContext(), true);
+
+    LogicalTime t1(Timestamp(20, 0));
+    refreshKeyManager();
+    auto newTime = validator()->trySignLogicalTime(t1);
+    auto sameTime = validator()->trySignLogicalTime(t1);
+
+    ASSERT_EQ(newTime.getKeyId(), sameTime.getKeyId());
+    ASSERT_TRUE(sameTime.getProof());
+    ASSERT_EQ(*newTime.getProof(), *sameTime.getProof());
+    ASSERT_OK(validator()->validate(operationContext(), sameTime));
+}
+
 TEST_F(LogicalTimeValidatorTest, ValidateReturnsOkForValidSignature) {
     validator()->enableKeyGenerator(operationContext(), true);
 
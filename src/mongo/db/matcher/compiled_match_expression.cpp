@@ -0,0 +1,337 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <cstring>
+
+#include "mongo/bson/oid.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+bool compareResultMatches(MatchExpression::MatchType type, int cmp) {
+    switch (type) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+bool isIntegerType(BSONType type) {
+    return type == NumberInt || type == NumberLong;
+}
+
+StringData stringValue(const BSONElement& elem) {
+    return StringData(elem.valuestr(), elem.valuestrsize() - 1);
+}
+
+StringData objectIdValue(const BSONElement& elem) {
+    return StringData(elem.value(), OID::kOIDSize);
+}
+
+}  // namespace
+
+constexpr size_t CompiledMatchExpression::kMaxFields;
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* expr) {
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression());
+    if (!compiled->compileNode(expr, &compiled->_root)) {
+        return nullptr;
+    }
+    return compiled;
+}
+
+bool CompiledMatchExpression::compileNode(const MatchExpression* expr, size_t* nodeIndex) {
+    *nodeIndex = _nodes.size();
+    _nodes.emplace_back();
+    _nodes[*nodeIndex].type = expr->matchType();
+
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT: {
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                size_t child;
+                if (!compileNode(expr->getChild(i), &child)) {
+                    return false;
+                }
+                _nodes[*nodeIndex].children.push_back(child);
+            }
+            return true;
+        }
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::EQ:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+            break;
+        default:
+            return false;
+    }
+
+    // Dotted paths may traverse arrays at any depth, so only top-level fields are extracted.
+    const StringData path = expr->path();
+    if (path.empty() || path.find('.') != std::string::npos) {
+        return false;
+    }
+
+    Node& node = _nodes[*nodeIndex];
+    node.leaf = expr;
+    if (!fieldSlot(path, &node.field)) {
+        return false;
+    }
+
+    if (expr->matchType() == MatchExpression::MATCH_IN) {
+        compileIn(static_cast<const InMatchExpression*>(expr), &node);
+    } else {
+        compileComparison(&node);
+    }
+    return true;
+}
+
+void CompiledMatchExpression::compileComparison(Node* node) {
+    auto expr = static_cast<const ComparisonMatchExpression*>(node->leaf);
+    node->rhs = expr->getData();
+
+    if (isIntegerType(node->rhs.type())) {
+        node->kernel = Kernel::kInteger;
+        node->rhsInteger = node->rhs.numberLong();
+    } else if (node->rhs.type() == String && !expr->getCollator()) {
+        node->kernel = Kernel::kString;
+    } else if (node->rhs.type() == jstOID) {
+        node->kernel = Kernel::kObjectId;
+    }
+}
+
+void CompiledMatchExpression::compileIn(const InMatchExpression* expr, Node* node) {
+    InSet inSet;
+    inSet.useIntegers = true;
+    inSet.useStrings = !expr->getCollator();
+    inSet.useObjectIds = true;
+    inSet.hasRegexes = !expr->getRegexes().empty();
+
+    for (auto&& equality : expr->getEqualities()) {
+        switch (equality.type()) {
+            case NumberInt:
+            case NumberLong:
+                inSet.integers.insert(equality.numberLong());
+                break;
+            case NumberDouble: {
+                // Only integral doubles in the range of a long long can equal an integer.
+                const double value = equality.numberDouble();
+                if (value >= -9223372036854775808.0 && value < 9223372036854775808.0 &&
+                    value == static_cast<double>(static_cast<long long>(value))) {
+                    inSet.integers.insert(static_cast<long long>(value));
+                }
+                break;
+            }
+            case NumberDecimal:
+                inSet.useIntegers = false;
+                break;
+            case String:
+                inSet.strings.insert(stringValue(equality));
+                break;
+            case Symbol:
+                // Symbols compare equal to strings with the same contents.
+                inSet.useStrings = false;
+                break;
+            case jstOID:
+                inSet.objectIds.insert(objectIdValue(equality));
+                break;
+            default:
+                break;
+        }
+    }
+
+    node->kernel = Kernel::kInSet;
+    node->inSet = _inSets.size();
+    _inSets.push_back(std::move(inSet));
+}
+
+bool CompiledMatchExpression::fieldSlot(StringData path, size_t* slot) {
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        if (_fields[i] == path) {
+            *slot = i;
+            return true;
+        }
+    }
+    if (_fields.size() == kMaxFields) {
+        return false;
+    }
+    *slot = _fields.size();
+    _fields.push_back(path);
+    return true;
+}
+
+void CompiledMatchExpression::extractFields(const BSONObj& doc, BSONElement* slots) const {
+    // Like BSONObj::getField(), a field that appears more than once resolves to its first
+    // occurrence.
+    size_t remaining = _fields.size();
+    BSONObjIterator it(doc);
+    while (remaining > 0 && it.more()) {
+        BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < _fields.size(); ++i) {
+            if (slots[i].eoo() && _fields[i] == fieldName) {
+                slots[i] = elem;
+                --remaining;
+                break;
+            }
+        }
+    }
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    BSONElement slots[kMaxFields];
+    extractFields(doc, slots);
+    return evaluate(_nodes[_root], doc, slots);
+}
+
+bool CompiledMatchExpression::evaluate(const Node& node,
+                                       const BSONObj& doc,
+                                       const BSONElement* slots) const {
+    switch (node.type) {
+        case MatchExpression::AND:
+            for (size_t child : node.children) {
+                if (!evaluate(_nodes[child], doc, slots)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::OR:
+            for (size_t child : node.children) {
+                if (evaluate(_nodes[child], doc, slots)) {
+                    return true;
+                }
+            }
+            return false;
+        case MatchExpression::NOR:
+            for (size_t child : node.children) {
+                if (evaluate(_nodes[child], doc, slots)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::NOT:
+            return !evaluate(_nodes[node.children[0]], doc, slots);
+        default:
+            break;
+    }
+
+    const BSONElement& elem = slots[node.field];
+    if (elem.eoo() || elem.type() == Array) {
+        // Missing fields and arrays need the leaf's own path traversal.
+        return node.leaf->matchesBSON(doc);
+    }
+    return evaluateLeaf(node, doc, elem);
+}
+
+bool CompiledMatchExpression::evaluateLeaf(const Node& node,
+                                           const BSONObj& doc,
+                                           const BSONElement& elem) const {
+    switch (node.kernel) {
+        case Kernel::kInteger:
+            if (isIntegerType(elem.type())) {
+                const long long value = elem.numberLong();
+                return compareResultMatches(
+                    node.type, value < node.rhsInteger ? -1 : (value > node.rhsInteger ? 1 : 0));
+            }
+            break;
+        case Kernel::kString:
+            if (elem.type() == String) {
+                return compareResultMatches(node.type,
+                                            stringValue(elem).compare(stringValue(node.rhs)));
+            }
+            break;
+        case Kernel::kObjectId:
+            if (elem.type() == jstOID) {
+                return compareResultMatches(
+                    node.type, std::memcmp(elem.value(), node.rhs.value(), OID::kOIDSize));
+            }
+            break;
+        case Kernel::kInSet:
+            return evaluateInSet(node, elem);
+        case Kernel::kGeneric:
+            break;
+    }
+    return node.leaf->matchesSingleElement(elem);
+}
+
+bool CompiledMatchExpression::evaluateInSet(const Node& node, const BSONElement& elem) const {
+    const InSet& inSet = _inSets[node.inSet];
+
+    // Regexes only match strings, symbols and regexes, and a present element can't match the
+    // $in's null through being missing, so a miss in a complete set means no match.
+    switch (elem.type()) {
+        case NumberInt:
+        case NumberLong:
+            if (inSet.useIntegers) {
+                return inSet.integers.count(elem.numberLong()) > 0;
+            }
+            break;
+        case String:
+            if (inSet.useStrings) {
+                if (inSet.strings.count(stringValue(elem)) > 0) {
+                    return true;
+                }
+                if (!inSet.hasRegexes) {
+                    return false;
+                }
+            }
+            break;
+        case jstOID:
+            if (inSet.useObjectIds) {
+                return inSet.objectIds.count(objectIdValue(elem)) > 0;
+            }
+            break;
+        default:
+            break;
+    }
+    return node.leaf->matchesSingleElement(elem);
+}
+
+}  // namespace mongo
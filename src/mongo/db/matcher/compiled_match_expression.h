@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class InMatchExpression;
+
+/**
+ * A MatchExpression lowered into a form that is cheaper to evaluate against many documents.
+ *
+ * Every top-level field referenced by the expression is extracted with a single walk of the
+ * document, and the leaves then compare the extracted elements with kernels specialized for the
+ * type of their operand: integers, strings under the simple collation, and ObjectIds. $in
+ * predicates over those types probe hash sets instead of the ordered equality set. Elements
+ * whose types don't match a leaf's kernel, as well as arrays and missing fields, are handed back
+ * to the original leaf, so a compiled expression always agrees with MatchExpression::matchesBSON.
+ *
+ * The original expression must outlive the compiled one. Evaluation doesn't modify the compiled
+ * expression, so it may be used by several threads at once.
+ */
+class CompiledMatchExpression {
+public:
+    /**
+     * The largest number of distinct fields a compiled expression may reference.
+     */
+    static constexpr size_t kMaxFields = 32;
+
+    /**
+     * Returns nullptr if 'expr' contains a node that can't be compiled. Only $and, $or, $nor and
+     * $not over comparisons and $in on top-level (non-dotted) paths are supported.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Equivalent to calling matchesBSON() on the expression this was compiled from.
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+    size_t numFields() const {
+        return _fields.size();
+    }
+
+private:
+    enum class Kernel {
+        // Defer to the leaf's matchesSingleElement().
+        kGeneric,
+        // A comparison between two NumberInt or NumberLong values.
+        kInteger,
+        // A comparison between two strings under the simple collation.
+        kString,
+        // A comparison between two ObjectIds.
+        kObjectId,
+        // Membership in one of '_inSets'.
+        kInSet,
+    };
+
+    struct StringDataHasher {
+        size_t operator()(StringData str) const {
+            return StringMapTraits::hash(str);
+        }
+    };
+
+    /**
+     * Hashed copies of the integer, string and ObjectId equalities of an $in. A set is only
+     * consulted when it is known to hold every equality that could match an element of its type.
+     */
+    struct InSet {
+        bool useIntegers = false;
+        stdx::unordered_set<long long> integers;
+
+        bool useStrings = false;
+        stdx::unordered_set<StringData, StringDataHasher> strings;
+
+        bool useObjectIds = false;
+        stdx::unordered_set<StringData, StringDataHasher> objectIds;
+
+        // Strings may still match one of the $in's regexes after missing 'strings'.
+        bool hasRegexes = false;
+    };
+
+    struct Node {
+        MatchExpression::MatchType type;
+
+        // The indices into '_nodes' of this node's children, for logical nodes.
+        std::vector<size_t> children;
+
+        // The remaining members are only used by leaves.
+        const MatchExpression* leaf = nullptr;
+        size_t field = 0;
+        Kernel kernel = Kernel::kGeneric;
+        BSONElement rhs;
+        long long rhsInteger = 0;
+        size_t inSet = 0;
+    };
+
+    CompiledMatchExpression() = default;
+
+    /**
+     * Appends the nodes for 'expr' and returns the index of its root, or false if 'expr' can't be
+     * compiled.
+     */
+    bool compileNode(const MatchExpression* expr, size_t* nodeIndex);
+    void compileComparison(Node* node);
+    void compileIn(const InMatchExpression* expr, Node* node);
+
+    /**
+     * Returns the slot of 'path' in the array filled in by extractFields(), or false if the
+     * expression references too many fields.
+     */
+    bool fieldSlot(StringData path, size_t* slot);
+
+    void extractFields(const BSONObj& doc, BSONElement* slots) const;
+
+    bool evaluate(const Node& node, const BSONObj& doc, const BSONElement* slots) const;
+    bool evaluateLeaf(const Node& node, const BSONObj& doc, const BSONElement& elem) const;
+    bool evaluateInSet(const Node& node, const BSONElement& elem) const;
+
+    std::vector<StringData> _fields;
+    std::vector<Node> _nodes;
+    std::vector<InSet> _inSets;
+    size_t _root = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,187 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/bson/oid.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Asserts that compiling 'filter' succeeds and that the compiled expression agrees with the
+ * original on every document in 'docs'.
+ */
+void assertCompiledMatchesOriginal(const BSONObj& filter,
+                                   const std::vector<BSONObj>& docs,
+                                   const CollatorInterface* collator = nullptr) {
+    auto parsed = MatchExpressionParser::parse(filter, collator);
+    ASSERT_OK(parsed.getStatus());
+    auto compiled = CompiledMatchExpression::compile(parsed.getValue().get());
+    ASSERT(compiled) << filter;
+    for (auto&& doc : docs) {
+        ASSERT_EQ(parsed.getValue()->matchesBSON(doc), compiled->matchesBSON(doc))
+            << "filter: " << filter << " doc: " << doc;
+    }
+}
+
+std::vector<BSONObj> mixedTypeDocs() {
+    return {fromjson("{}"),
+            fromjson("{a: null}"),
+            fromjson("{a: 1}"),
+            fromjson("{a: 5}"),
+            fromjson("{a: 10}"),
+            fromjson("{a: NumberLong(5)}"),
+            fromjson("{a: 5.0}"),
+            fromjson("{a: 5.5}"),
+            fromjson("{a: NumberDecimal('5')}"),
+            fromjson("{a: 'abc'}"),
+            fromjson("{a: 'abd'}"),
+            fromjson("{a: ''}"),
+            fromjson("{a: ObjectId('000000000000000000000001')}"),
+            fromjson("{a: ObjectId('000000000000000000000002')}"),
+            fromjson("{a: [1, 5, 'abc']}"),
+            fromjson("{a: []}"),
+            fromjson("{a: {b: 5}}"),
+            fromjson("{a: 5, a: 1}"),
+            fromjson("{a: 5, b: 'x'}"),
+            fromjson("{a: 1, b: 'y'}"),
+            fromjson("{b: 'x'}"),
+            fromjson("{a: MinKey}"),
+            fromjson("{a: MaxKey}")};
+}
+
+TEST(CompiledMatchExpressionTest, IntegerComparisonsAgreeWithOriginal) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesOriginal(BSON("a" << BSON(op << 5)), mixedTypeDocs());
+        assertCompiledMatchesOriginal(BSON("a" << BSON(op << 5LL)), mixedTypeDocs());
+    }
+}
+
+TEST(CompiledMatchExpressionTest, StringComparisonsAgreeWithOriginal) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesOriginal(BSON("a" << BSON(op << "abc")), mixedTypeDocs());
+    }
+}
+
+TEST(CompiledMatchExpressionTest, StringComparisonsRespectCollator) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    assertCompiledMatchesOriginal(fromjson("{a: 'xyz'}"), mixedTypeDocs(), &collator);
+    assertCompiledMatchesOriginal(fromjson("{a: {$in: ['xyz']}}"), mixedTypeDocs(), &collator);
+}
+
+TEST(CompiledMatchExpressionTest, ObjectIdComparisonsAgreeWithOriginal) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesOriginal(BSON("a" << BSON(op << OID("000000000000000000000001"))),
+                                      mixedTypeDocs());
+    }
+}
+
+TEST(CompiledMatchExpressionTest, OtherComparisonsAgreeWithOriginal) {
+    assertCompiledMatchesOriginal(fromjson("{a: null}"), mixedTypeDocs());
+    assertCompiledMatchesOriginal(fromjson("{a: {$gt: 4.5}}"), mixedTypeDocs());
+    assertCompiledMatchesOriginal(fromjson("{a: {$lte: NumberDecimal('5')}}"), mixedTypeDocs());
+    assertCompiledMatchesOriginal(fromjson("{a: {$lt: MaxKey}}"), mixedTypeDocs());
+}
+
+TEST(CompiledMatchExpressionTest, InAgreesWithOriginal) {
+    assertCompiledMatchesOriginal(fromjson("{a: {$in: [1, NumberLong(10), 'abc']}}"),
+                                  mixedTypeDocs());
+    assertCompiledMatchesOriginal(fromjson("{a: {$in: [5.0, 7.5]}}"), mixedTypeDocs());
+    assertCompiledMatchesOriginal(fromjson("{a: {$in: [NumberDecimal('5')]}}"), mixedTypeDocs());
+    assertCompiledMatchesOriginal(
+        fromjson("{a: {$in: [null, ObjectId('000000000000000000000002')]}}"), mixedTypeDocs());
+    assertCompiledMatchesOriginal(fromjson("{a: {$in: ['x', /^ab/]}}"), mixedTypeDocs());
+    assertCompiledMatchesOriginal(fromjson("{a: {$in: []}}"), mixedTypeDocs());
+}
+
+TEST(CompiledMatchExpressionTest, LargeInAgreesWithOriginal) {
+    BSONArrayBuilder values;
+    for (int i = 0; i < 5000; i += 5) {
+        values.append(i);
+    }
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(BSON("a" << i));
+        docs.push_back(BSON("a" << static_cast<long long>(i)));
+    }
+    assertCompiledMatchesOriginal(BSON("a" << BSON("$in" << values.arr())), docs);
+}
+
+TEST(CompiledMatchExpressionTest, LogicalNodesAgreeWithOriginal) {
+    auto docs = mixedTypeDocs();
+    assertCompiledMatchesOriginal(fromjson("{a: {$gte: 1, $lt: 10}, b: 'x'}"), docs);
+    assertCompiledMatchesOriginal(fromjson("{$or: [{a: 1}, {b: {$in: ['x', 'z']}}]}"), docs);
+    assertCompiledMatchesOriginal(fromjson("{$nor: [{a: 1}, {b: 'x'}]}"), docs);
+    assertCompiledMatchesOriginal(fromjson("{a: {$not: {$gt: 4}}}"), docs);
+    assertCompiledMatchesOriginal(fromjson("{a: {$ne: 5}}"), docs);
+    assertCompiledMatchesOriginal(fromjson("{a: {$nin: [1, 'abc']}}"), docs);
+    assertCompiledMatchesOriginal(fromjson("{$and: [{$or: [{a: 5}, {a: 'abc'}]}, {b: 'x'}]}"),
+                                  docs);
+}
+
+TEST(CompiledMatchExpressionTest, SharesSlotsBetweenLeavesOnTheSameField) {
+    auto parsed = MatchExpressionParser::parse(fromjson("{$or: [{a: 1}, {a: 2}, {b: 3}]}"),
+                                               nullptr);
+    ASSERT_OK(parsed.getStatus());
+    auto compiled = CompiledMatchExpression::compile(parsed.getValue().get());
+    ASSERT(compiled);
+    ASSERT_EQ(2U, compiled->numFields());
+}
+
+TEST(CompiledMatchExpressionTest, DoesNotCompileUnsupportedExpressions) {
+    for (auto&& filter : {fromjson("{'a.b': 1}"),
+                          fromjson("{a: {$exists: true}}"),
+                          fromjson("{a: /abc/}"),
+                          fromjson("{a: {$elemMatch: {$gt: 1}}}"),
+                          fromjson("{$or: [{a: 1}, {'b.c': 1}]}")}) {
+        auto parsed = MatchExpressionParser::parse(filter, nullptr);
+        ASSERT_OK(parsed.getStatus());
+        ASSERT_FALSE(CompiledMatchExpression::compile(parsed.getValue().get())) << filter;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, DoesNotCompileTooManyFields) {
+    BSONObjBuilder filter;
+    for (size_t i = 0; i <= CompiledMatchExpression::kMaxFields; ++i) {
+        filter.append("f" + std::to_string(i), 1);
+    }
+    auto parsed = MatchExpressionParser::parse(filter.obj(), nullptr);
+    ASSERT_OK(parsed.getStatus());
+    ASSERT_FALSE(CompiledMatchExpression::compile(parsed.getValue().get()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parseFilter(const BSONObj& filter) {
+    auto statusWithMatcher = MatchExpressionParser::parse(filter, nullptr);
+    invariantOK(statusWithMatcher.getStatus());
+    return std::move(statusWithMatcher.getValue());
+}
+
+std::vector<BSONObj> makeDocuments() {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(BSON("_id" << i << "a" << i % 10 << "b"
+                                  << (i % 2 ? "odd" : "even")
+                                  << "c"
+                                  << BSON("d" << i)
+                                  << "arr"
+                                  << BSON_ARRAY(i << i + 1 << i + 2)));
+    }
+    return docs;
+}
+
+void runMatchBenchmark(benchmark::State& state, const BSONObj& filter) {
+    const auto expr = parseFilter(filter);
+    const auto docs = makeDocuments();
+
+    while (state.keepRunning()) {
+        int matched = 0;
+        for (const auto& doc : docs) {
+            matched += expr->matchesBSON(doc);
+        }
+        benchmark::doNotOptimize(matched);
+    }
+    state.setItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_MatchEquality(benchmark::State& state) {
+    runMatchBenchmark(state, fromjson("{a: 5}"));
+}
+MONGO_BENCHMARK(BM_MatchEquality);
+
+void BM_MatchConjunction(benchmark::State& state) {
+    runMatchBenchmark(state, fromjson("{a: {$gte: 2, $lt: 8}, b: 'odd'}"));
+}
+MONGO_BENCHMARK(BM_MatchConjunction);
+
+void BM_MatchDottedPath(benchmark::State& state) {
+    runMatchBenchmark(state, fromjson("{'c.d': {$in: [1, 10, 50, 99]}}"));
+}
+MONGO_BENCHMARK(BM_MatchDottedPath);
+
+void BM_MatchArrayElemMatch(benchmark::State& state) {
+    runMatchBenchmark(state, fromjson("{arr: {$elemMatch: {$gt: 50, $lt: 55}}}"));
+}
+MONGO_BENCHMARK(BM_MatchArrayElemMatch);
+
+void BM_MatchDisjunction(benchmark::State& state) {
+    runMatchBenchmark(state, fromjson("{$or: [{a: 1}, {b: 'even'}, {'c.d': 3}]}"));
+}
+MONGO_BENCHMARK(BM_MatchDisjunction);
+
+}  // namespace
+}  // namespace mongo
@@ -109,6 +109,13 @@ public:
         return *_query;
     }
 
+    /**
+     * Returns the original geo specification provided by the user.
+     */
+    const BSONObj& getRawObj() const {
+        return _rawObj;
+    }
+
 private:
     // The original geo specification provided by the user.
     BSONObj _rawObj;
@@ -0,0 +1,184 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_trace.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getOperationTraceBuffer = ServiceContext::declareDecoration<OperationTraceBuffer>();
+
+AtomicDouble operationTraceSampleRate(0.0);
+
+class OperationTraceSampleRateParameter
+    : public ExportedServerParameter<double, ServerParameterType::kStartupAndRuntime> {
+public:
+    OperationTraceSampleRateParameter()
+        : ExportedServerParameter<double, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "operationTraceSampleRate",
+              &operationTraceSampleRate) {}
+
+    Status validate(const double& potentialNewValue) override {
+        if (potentialNewValue < 0.0 || potentialNewValue > 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "operationTraceSampleRate must be between 0 and 1, "
+                                           "but attempted to set to: "
+                                        << potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+} operationTraceSampleRateParameter;
+
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceBufferSize, int, 1000);
+
+/**
+ * Appends the time spent waiting for locks by resource type, skipping the types without waits.
+ */
+void appendLockWaitTimes(SingleThreadedLockStats& stats, BSONObjBuilder* builder) {
+    auto appendWaitTime = [&](StringData name, ResourceId resId) {
+        long long waitMicros = 0;
+        for (int mode = 0; mode < LockModesCount; mode++) {
+            waitMicros += stats.get(resId, static_cast<LockMode>(mode)).combinedWaitTimeMicros;
+        }
+
+        if (waitMicros > 0) {
+            builder->append(name, waitMicros);
+        }
+    };
+
+    for (int type = RESOURCE_GLOBAL; type < ResourceTypesCount; type++) {
+        const auto resourceType = static_cast<ResourceType>(type);
+        appendWaitTime(resourceTypeName(resourceType), ResourceId(resourceType, 0ULL));
+    }
+
+    appendWaitTime("oplog", resourceIdOplog);
+}
+
+}  // namespace
+
+OperationTraceBuffer& OperationTraceBuffer::get(ServiceContext* service) {
+    return getOperationTraceBuffer(service);
+}
+
+bool OperationTraceBuffer::shouldTrace(Client* client) {
+    const double sampleRate = operationTraceSampleRate.load();
+    if (sampleRate <= 0.0) {
+        return false;
+    }
+
+    return sampleRate >= 1.0 || client->getPrng().nextCanonicalDouble() < sampleRate;
+}
+
+BSONObj OperationTraceBuffer::buildTrace(OperationContext* opCtx, CurOp* curOp) {
+    const OpDebug& debug = curOp->debug();
+
+    BSONObjBuilder builder;
+    builder.appendDate("ts", Date_t::fromMillisSinceEpoch(curOp->startTime() / 1000));
+    builder.append("op", logicalOpToString(curOp->getLogicalOp()));
+    builder.append("ns", curOp->getNS());
+    if (auto command = curOp->getCommand()) {
+        builder.append("command", command->getName());
+    }
+    builder.append("durationMicros", debug.executionTimeMicros);
+
+    {
+        BSONObjBuilder phasesBuilder(builder.subobjStart("phases"));
+        phasesBuilder.append(
+            "ticketQueueMicros",
+            durationCount<Microseconds>(opCtx->lockState()->getTimeQueuedForTicket()));
+
+        Locker::LockerInfo lockerInfo;
+        opCtx->lockState()->getLockerInfo(&lockerInfo);
+        BSONObjBuilder lockWaitBuilder(phasesBuilder.subobjStart("lockWaitMicros"));
+        appendLockWaitTimes(lockerInfo.stats, &lockWaitBuilder);
+        lockWaitBuilder.doneFast();
+
+        phasesBuilder.append("planningMicros", debug.planningTimeMicros);
+    }
+
+    if (debug.keysExamined >= 0) {
+        builder.append("keysExamined", debug.keysExamined);
+    }
+    if (debug.docsExamined >= 0) {
+        builder.append("docsExamined", debug.docsExamined);
+    }
+    builder.append("writeConflicts", debug.writeConflicts);
+    builder.append("numYields", curOp->numYields());
+    if (debug.nreturned >= 0) {
+        builder.append("nreturned", debug.nreturned);
+    }
+    if (debug.responseLength >= 0) {
+        builder.append("responseLength", debug.responseLength);
+    }
+    if (!debug.exceptionInfo.isOK()) {
+        builder.append("errCode", debug.exceptionInfo.code());
+    }
+
+    return builder.obj();
+}
+
+void OperationTraceBuffer::add(BSONObj trace) {
+    const auto capacity = static_cast<size_t>(std::max(operationTraceBufferSize.load(), 0));
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _traces.push_back(std::move(trace));
+    while (_traces.size() > capacity) {
+        _traces.pop_front();
+    }
+}
+
+void OperationTraceBuffer::append(BSONArrayBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& trace : _traces) {
+        builder->append(trace);
+    }
+}
+
+void OperationTraceBuffer::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _traces.clear();
+}
+
+}  // namespace mongo
@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class Client;
+class CurOp;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Keeps the traces of a random sample of the completed operations, so that the phases making up
+ * the latency of individual operations can be inspected without turning on the profiler.
+ *
+ * A trace breaks the execution time of an operation down into the time spent queued for a
+ * ticket, waiting for locks by resource type, and selecting a plan, next to the work and write
+ * conflict counters of the operation.
+ *
+ * Operations are sampled at operationTraceSampleRate, and the most recent
+ * operationTraceBufferSize traces are kept.
+ */
+class OperationTraceBuffer {
+    MONGO_DISALLOW_COPYING(OperationTraceBuffer);
+
+public:
+    OperationTraceBuffer() = default;
+
+    static OperationTraceBuffer& get(ServiceContext* service);
+
+    /**
+     * Returns true if the operation which just completed on 'client' should be traced.
+     */
+    static bool shouldTrace(Client* client);
+
+    /**
+     * Builds the trace of an operation which has completed.
+     */
+    static BSONObj buildTrace(OperationContext* opCtx, CurOp* curOp);
+
+    /**
+     * Adds a trace, evicting the oldest ones if the buffer is full.
+     */
+    void add(BSONObj trace);
+
+    /**
+     * Appends the buffered traces to 'builder', oldest first.
+     */
+    void append(BSONArrayBuilder* builder) const;
+
+    /**
+     * Removes all buffered traces.
+     */
+    void clear();
+
+private:
+    mutable stdx::mutex _mutex;
+    std::deque<BSONObj> _traces;
+};
+
+}  // namespace mongo
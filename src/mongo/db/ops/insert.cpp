@@ -46,10 +46,21 @@ using std::string;
 using namespace mongoutils;
 
 namespace {
+// Smallest possible element holding a nested object: type byte, empty field name, empty object.
+const size_t kMinNestedObjectElementSize = 2 + BSONObj::kMinBSONLength;
+
 /**
  * Validates the nesting depth of 'obj', returning a non-OK status if it exceeds the limit.
  */
 Status validateDepth(const BSONObj& obj) {
+    const size_t maxDepth = BSONDepth::getMaxDepthForUserStorage();
+
+    // Each level of nesting takes at least kMinNestedObjectElementSize bytes, so most documents
+    // are too small to exceed the limit and need not be walked at all.
+    if ((obj.objsize() - BSONObj::kMinBSONLength) / kMinNestedObjectElementSize < maxDepth) {
+        return Status::OK();
+    }
+
     std::vector<BSONObjIterator> frames;
     frames.reserve(16);
     frames.emplace_back(obj);
@@ -57,15 +68,22 @@ Status validateDepth(const BSONObj& obj) {
     while (!frames.empty()) {
         const auto elem = frames.back().next();
         if (elem.type() == BSONType::Object || elem.type() == BSONType::Array) {
-            if (MONGO_unlikely(frames.size() == BSONDepth::getMaxDepthForUserStorage())) {
-                // We're exactly at the limit, so descending to the next level would exceed
-                // the maximum depth.
-                return {ErrorCodes::Overflow,
-                        str::stream() << "cannot insert document because it exceeds "
-                                      << BSONDepth::getMaxDepthForUserStorage()
-                                      << " levels of nesting"};
+            const BSONObj embedded = elem.embeddedObject();
+            const size_t maxLevelsBelow =
+                (embedded.objsize() - BSONObj::kMinBSONLength) / kMinNestedObjectElementSize;
+
+            // Skip subtrees that are too small to reach the limit.
+            if (frames.size() + 1 + maxLevelsBelow > maxDepth) {
+                if (MONGO_unlikely(frames.size() == maxDepth)) {
+                    // We're exactly at the limit, so descending to the next level would exceed
+                    // the maximum depth.
+                    return {ErrorCodes::Overflow,
+                            str::stream() << "cannot insert document because it exceeds "
+                                          << maxDepth
+                                          << " levels of nesting"};
+                }
+                frames.emplace_back(embedded);
             }
-            frames.emplace_back(elem.embeddedObject());
         }
 
         if (!frames.back().more()) {
@@ -42,6 +42,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop_metrics.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/update.h"
 #include "mongo/db/introspect.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/ops/parsed_delete.h"
 #include "mongo/db/ops/parsed_update.h"
+#include "mongo/db/ops/update.h"
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/ops/write_ops_exec.h"
@@ -65,12 +67,18 @@
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/bucket_format.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -327,6 +335,243 @@ void insertDocuments(OperationContext* opCtx,
     wuow.commit();
 }
 
+/**
+ * Combines concurrent single-document inserts into the same collection so that they are committed
+ * in one storage transaction. The first insert to arrive for a collection leads a group: it waits
+ * for other inserts to join, then inserts the documents of the whole group and reports the outcome
+ * to the other members. Members whose document could not be inserted as part of the group insert
+ * it on their own, so each insert still gets its own result and error.
+ */
+class InsertGroupCommitter {
+public:
+    struct Request {
+        explicit Request(InsertStatement* stmt) : stmt(stmt) {}
+
+        InsertStatement* const stmt;
+
+        // Set once a leader has taken the request into its group.
+        bool taken = false;
+
+        // Set once the leader has tried to insert the group, along with whether the document was
+        // inserted and the optime of its oplog entry.
+        bool done = false;
+        bool inserted = false;
+        repl::OpTime opTime;
+    };
+
+    /**
+     * Queues 'request' for the collection 'ns'. Returns true if the caller must lead a group,
+     * which it does by calling takeGroup() and then complete(). Otherwise, waits until a leader
+     * has completed the request and returns false.
+     */
+    bool join(const NamespaceString& ns, Request* request) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _queues[ns.ns()].pending.push_back(request);
+        while (!request->done) {
+            // A request which is still pending keeps the queue of its collection alive.
+            if (!request->taken) {
+                auto& queue = _queues[ns.ns()];
+                if (!queue.hasLeader) {
+                    queue.hasLeader = true;
+                    return true;
+                }
+            }
+            _cv.wait(lk);
+        }
+        return false;
+    }
+
+    /**
+     * Takes the leader's own request and up to 'maxGroupSize' - 1 other pending requests for 'ns'
+     * into a group, with the leader's request first. Inserts arriving after this start a new
+     * group.
+     */
+    std::vector<Request*> takeGroup(const NamespaceString& ns,
+                                    Request* leaderRequest,
+                                    size_t maxGroupSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _queues.find(ns.ns());
+        invariant(it != _queues.end());
+        auto& pending = it->second.pending;
+        invariant(it->second.hasLeader);
+
+        std::vector<Request*> group{leaderRequest};
+        pending.erase(std::find(pending.begin(), pending.end(), leaderRequest));
+        const size_t numTaken = std::min(pending.size(), std::max(maxGroupSize, size_t(1)) - 1);
+        group.insert(group.end(), pending.begin(), pending.begin() + numTaken);
+        pending.erase(pending.begin(), pending.begin() + numTaken);
+        for (auto&& request : group) {
+            request->taken = true;
+        }
+
+        it->second.hasLeader = false;
+        if (pending.empty()) {
+            _queues.erase(it);
+        } else {
+            // Let one of the remaining members lead the next group.
+            _cv.notify_all();
+        }
+        return group;
+    }
+
+    /**
+     * Reports the outcome of inserting 'group' to its members. On success, 'inserted' holds the
+     * statements as they were inserted, in the order of the group.
+     */
+    void complete(const std::vector<Request*>& group,
+                  const std::vector<InsertStatement>* inserted) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (size_t i = 0; i < group.size(); ++i) {
+            group[i]->done = true;
+            if (inserted) {
+                group[i]->inserted = true;
+                group[i]->opTime = (*inserted)[i].oplogSlot.opTime;
+            }
+        }
+        _cv.notify_all();
+    }
+
+private:
+    struct Queue {
+        bool hasLeader = false;
+        std::vector<Request*> pending;
+    };
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    StringMap<Queue> _queues;
+};
+
+InsertGroupCommitter insertGroupCommitter;
+
+/**
+ * Returns true if a single-document insert into 'ns' may be committed together with the inserts
+ * of other operations. Retryable writes are excluded because their oplog entries belong to their
+ * own session, and sharded inserts because each operation must check its own shard version.
+ */
+bool canGroupCommitInsert(OperationContext* opCtx, const NamespaceString& ns) {
+    return internalInsertGroupCommitWindowMicros.load() > 0 && supportsDocLocking() &&
+        !opCtx->getTxnNumber() && opCtx->writesAreReplicated() &&
+        !documentValidationDisabled(opCtx) && !ns.isSystem() &&
+        !ShardingState::get(opCtx)->enabled();
+}
+
+/**
+ * Replaces the full bucket 'bucketId' of the time-series collection 'ns' by its compressed form.
+ * A bucket which fails to be compressed stays open, which readers handle the same way.
+ */
+void compressBucket(OperationContext* opCtx,
+                    const NamespaceString& ns,
+                    const TimeseriesOptions& options,
+                    const OID& bucketId) {
+    try {
+        writeConflictRetry(opCtx, "compressBucket", ns.ns(), [&] {
+            AutoGetCollection collection(opCtx, ns, MODE_IX);
+            if (!collection.getCollection() ||
+                !collection.getCollection()->getTimeseriesOptions()) {
+                return;
+            }
+            assertCanWrite_inlock(opCtx, ns);
+
+            BSONObj bucket;
+            if (!Helpers::findById(
+                    opCtx, collection.getDb(), ns.ns(), BSON("_id" << bucketId), bucket)) {
+                return;
+            }
+
+            UpdateRequest request(ns);
+            request.setQuery(BSON("_id" << bucketId));
+            request.setUpdates(uassertStatusOK(timeseries::compressBucket(options, bucket)));
+            update(opCtx, collection.getDb(), request);
+        });
+    } catch (const DBException& ex) {
+        if (ErrorCodes::isInterruption(ex.code())) {
+            throw;
+        }
+        warning() << "Failed to compress time-series bucket " << bucketId << " of " << ns
+                  << causedBy(redact(ex));
+    }
+}
+
+/**
+ * Adds 'measurement' to the open bucket of its series in the time-series collection 'ns', and
+ * compresses the bucket if it is now full.
+ */
+void insertMeasurement(OperationContext* opCtx,
+                       const NamespaceString& ns,
+                       const TimeseriesOptions& options,
+                       const BSONObj& measurement,
+                       LastOpFixer* lastOpFixer) {
+    uassert(ErrorCodes::IllegalOperation,
+            "Retryable writes are not supported on time-series collections",
+            !opCtx->getTxnNumber());
+    uassertStatusOK(timeseries::validateMeasurement(options, measurement));
+
+    auto& bucketCatalog = timeseries::BucketCatalog::get();
+    const auto reservation = bucketCatalog.reserve(ns.ns(), options, measurement);
+    if (reservation.bucketToCompress) {
+        compressBucket(opCtx, ns, options, *reservation.bucketToCompress);
+    }
+
+    Status status = Status::OK();
+    try {
+        writeConflictRetry(opCtx, "insert", ns.ns(), [&] {
+            AutoGetCollection collection(opCtx, ns, MODE_IX);
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Time-series collection " << ns.ns() << " was dropped",
+                    collection.getCollection() &&
+                        collection.getCollection()->getTimeseriesOptions());
+            assertCanWrite_inlock(opCtx, ns);
+
+            // The measurement either creates the bucket or is added to it.
+            UpdateRequest request(ns);
+            request.setQuery(BSON("_id" << reservation.bucketId));
+            request.setUpdates(
+                timeseries::makeMeasurementUpdate(options, measurement, reservation.row));
+            request.setUpsert();
+            lastOpFixer->startingOp();
+            update(opCtx, collection.getDb(), request);
+            lastOpFixer->finishedOpSuccessfully();
+        });
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    if (bucketCatalog.release(reservation)) {
+        compressBucket(opCtx, ns, options, reservation.bucketId);
+    }
+    uassertStatusOK(status);
+}
+
+/**
+ * Inserts the measurements of 'batch' into the time-series collection of 'wholeOp' one at a
+ * time. Returns true if caller should try to insert more documents.
+ */
+bool insertMeasurementsAndHandleErrors(OperationContext* opCtx,
+                                       const write_ops::Insert& wholeOp,
+                                       const TimeseriesOptions& options,
+                                       std::vector<InsertStatement>& batch,
+                                       LastOpFixer* lastOpFixer,
+                                       WriteResult* out) {
+    auto& curOp = *CurOp::get(opCtx);
+    for (auto&& stmt : batch) {
+        globalOpCounters.gotInsert();
+        try {
+            insertMeasurement(opCtx, wholeOp.getNamespace(), options, stmt.doc, lastOpFixer);
+            SingleWriteResult result;
+            result.setN(1);
+            out->results.emplace_back(std::move(result));
+            curOp.debug().ninserted++;
+        } catch (const DBException& ex) {
+            bool canContinue =
+                handleError(opCtx, ex, wholeOp.getNamespace(), wholeOp.getWriteCommandBase(), out);
+            if (!canContinue)
+                return false;
+        }
+    }
+    return true;
+}
+
 /**
  * Returns true if caller should try to insert more documents. Does nothing else if batch is empty.
  */
@@ -361,9 +606,73 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
         assertCanWrite_inlock(opCtx, wholeOp.getNamespace());
     };
 
+    if (batch.size() == 1 && canGroupCommitInsert(opCtx, wholeOp.getNamespace())) {
+        InsertGroupCommitter::Request request(&batch.front());
+        lastOpFixer->startingOp();
+        if (insertGroupCommitter.join(wholeOp.getNamespace(), &request)) {
+            // Give concurrent inserts a chance to join the group before taking it. Nothing may
+            // throw until the group is taken and completed, or its other members would wait
+            // forever.
+            sleepmicros(internalInsertGroupCommitWindowMicros.load());
+            auto group = insertGroupCommitter.takeGroup(
+                wholeOp.getNamespace(), &request, internalInsertMaxBatchSize.load());
+
+            std::vector<InsertStatement> groupBatch;
+            bool groupInserted = false;
+            ON_BLOCK_EXIT([&] {
+                insertGroupCommitter.complete(group, groupInserted ? &groupBatch : nullptr);
+            });
+
+            // A leader which nobody joined inserts its document the usual way below.
+            if (group.size() > 1) {
+                try {
+                    acquireCollection();
+                    if (!collection->getCollection()->isCapped() &&
+                        !collection->getCollection()->getTimeseriesOptions()) {
+                        groupBatch.reserve(group.size());
+                        for (auto&& member : group) {
+                            groupBatch.push_back(*member->stmt);
+                        }
+                        insertDocuments(opCtx,
+                                        collection->getCollection(),
+                                        groupBatch.begin(),
+                                        groupBatch.end());
+                        groupInserted = true;
+                    }
+                } catch (const DBException&) {
+                    // Every member, including this one, inserts its document on its own instead.
+                    collection.reset();
+                }
+            }
+            if (groupInserted) {
+                request.inserted = true;
+                request.opTime = groupBatch.front().oplogSlot.opTime;
+            }
+        }
+
+        if (request.inserted) {
+            // The leader's lastOp already covers the oplog entries of the whole group.
+            auto& replClientInfo = repl::ReplClientInfo::forClient(opCtx->getClient());
+            if (request.opTime > replClientInfo.getLastOp()) {
+                replClientInfo.setLastOp(request.opTime);
+            }
+            lastOpFixer->finishedOpSuccessfully();
+            globalOpCounters.gotInsert();
+            SingleWriteResult result;
+            result.setN(1);
+            out->results.emplace_back(std::move(result));
+            curOp.debug().ninserted++;
+            return true;
+        }
+    }
+
+    boost::optional<TimeseriesOptions> timeseriesOptions;
     try {
         acquireCollection();
-        if (!collection->getCollection()->isCapped() && batch.size() > 1) {
+        timeseriesOptions = collection->getCollection()->getTimeseriesOptions();
+        if (timeseriesOptions) {
+            collection.reset();
+        } else if (!collection->getCollection()->isCapped() && batch.size() > 1) {
             // First try doing it all together. If all goes well, this is all we need to do.
             // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
             lastOpFixer->startingOp();
@@ -384,6 +693,11 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
         // The loop below will handle reporting any non-transient errors.
     }
 
+    if (timeseriesOptions) {
+        return insertMeasurementsAndHandleErrors(
+            opCtx, wholeOp, *timeseriesOptions, batch, lastOpFixer, out);
+    }
+
     // Try to insert the batch one-at-a-time. This path is executed both for singular batches, and
     // for batches that failed all-at-once inserting.
     for (auto it = batch.begin(); it != batch.end(); ++it) {
@@ -393,6 +707,12 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
                 try {
                     if (!collection)
                         acquireCollection();
+                    // Documents inserted into a time-series collection must go to its buckets.
+                    uassert(ErrorCodes::ConflictingOperationInProgress,
+                            str::stream() << wholeOp.getNamespace().ns()
+                                          << " was created as a time-series collection during the "
+                                             "insert",
+                            !collection->getCollection()->getTimeseriesOptions());
                     lastOpFixer->startingOp();
                     insertDocuments(opCtx, collection->getCollection(), it, it + 1);
                     lastOpFixer->finishedOpSuccessfully();
@@ -490,7 +810,7 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
             }
 
             BSONObj toInsert = fixedDoc.getValue().isEmpty() ? doc : std::move(fixedDoc.getValue());
-            batch.emplace_back(stmtId, toInsert);
+            batch.emplace_back(stmtId, std::move(toInsert));
             bytesInBatch += batch.back().doc.objsize();
             if (!isLastDoc && batch.size() < maxBatchSize && bytesInBatch < insertVectorMaxBytes)
                 continue;  // Add more to batch before inserting.
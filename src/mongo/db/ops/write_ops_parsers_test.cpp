@@ -34,6 +34,7 @@
 #include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/db/ops/write_ops_parsers_test_helpers.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/net/op_msg.h"
 
 namespace mongo {
 namespace {
@@ -214,6 +215,36 @@ TEST(CommandWriteOpsParsers, SingleInsert) {
     }
 }
 
+TEST(CommandWriteOpsParsers, InsertFromDocSequenceReferencesMessageBuffer) {
+    const BSONObj obj0 = BSON("_id" << 0);
+    const BSONObj obj1 = BSON("_id" << 1);
+
+    OpMsgBuilder builder;
+    {
+        auto docSeq = builder.beginDocSequence("documents");
+        docSeq.append(obj0);
+        docSeq.append(obj1);
+    }
+    builder.setBody(BSON("insert"
+                         << "foo"
+                         << "$db"
+                         << "test"));
+    const auto message = builder.finish();
+
+    // The parsed documents are views into the message rather than copies of it.
+    const auto op = InsertOp::parse(OpMsgRequest::parse(message));
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+    const auto messageBegin = reinterpret_cast<uintptr_t>(message.buf());
+    const auto messageEnd = messageBegin + message.size();
+    for (auto&& doc : op.getDocuments()) {
+        const auto docBegin = reinterpret_cast<uintptr_t>(doc.objdata());
+        ASSERT_GTE(docBegin, messageBegin);
+        ASSERT_LTE(docBegin + doc.objsize(), messageEnd);
+    }
+    ASSERT_BSONOBJ_EQ(op.getDocuments()[0], obj0);
+    ASSERT_BSONOBJ_EQ(op.getDocuments()[1], obj1);
+}
+
 TEST(CommandWriteOpsParsers, EmptyMultiInsertFails) {
     const auto ns = NamespaceString("test", "foo");
     auto cmd = BSON("insert" << ns.coll() << "documents" << BSONArray());
@@ -0,0 +1,94 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_event_cache.h"
+
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+const auto getChangeStreamEventCache = ServiceContext::declareDecoration<ChangeStreamEventCache>();
+}  // namespace
+
+ChangeStreamEventCache* ChangeStreamEventCache::get(ServiceContext* serviceContext) {
+    return &getChangeStreamEventCache(serviceContext);
+}
+
+boost::optional<Document> ChangeStreamEventCache::find(Timestamp ts, long long hash) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _events.find({ts, hash});
+    if (it == _events.end()) {
+        return boost::none;
+    }
+    return it->second.event;
+}
+
+void ChangeStreamEventCache::insert(Timestamp ts,
+                                    long long hash,
+                                    Document event,
+                                    size_t maxSizeBytes) {
+    const size_t eventSizeBytes = event.getApproximateSize();
+    if (eventSizeBytes > maxSizeBytes) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto inserted = _events.emplace(Key{ts, hash}, CachedEvent{std::move(event), eventSizeBytes});
+    if (!inserted.second) {
+        // Another stream got here first.
+        return;
+    }
+    _sizeBytes += eventSizeBytes;
+
+    while (_sizeBytes > maxSizeBytes) {
+        auto oldest = _events.begin();
+        _sizeBytes -= oldest->second.sizeBytes;
+        _events.erase(oldest);
+    }
+}
+
+void ChangeStreamEventCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _events.clear();
+    _sizeBytes = 0;
+}
+
+size_t ChangeStreamEventCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _events.size();
+}
+
+size_t ChangeStreamEventCache::sizeBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <map>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A process-wide cache of the change events produced by $changeStream from recent oplog entries.
+ * Every change stream tailing the oplog transforms the same entries into the same events, so when
+ * many streams are open each entry need only be transformed once. Entries are identified by their
+ * timestamp and hash, so that an entry written in place of one which was rolled back is never
+ * given the rolled back entry's event.
+ *
+ * The cache is bounded by the approximate size of the events it holds; once full, the events for
+ * the oldest entries are evicted first, since streams tend to be reading close to the end of the
+ * oplog. This class is thread-safe. The cached Documents are shared between threads, so they must
+ * not be arena-allocated.
+ */
+class ChangeStreamEventCache {
+    MONGO_DISALLOW_COPYING(ChangeStreamEventCache);
+
+public:
+    ChangeStreamEventCache() = default;
+
+    static ChangeStreamEventCache* get(ServiceContext* serviceContext);
+
+    /**
+     * Returns the event for the oplog entry with timestamp 'ts' and hash 'hash', or boost::none if
+     * it is not cached.
+     */
+    boost::optional<Document> find(Timestamp ts, long long hash) const;
+
+    /**
+     * Caches 'event' as the event for the oplog entry with timestamp 'ts' and hash 'hash', evicting
+     * the events for the oldest entries until the cache holds no more than 'maxSizeBytes'.
+     */
+    void insert(Timestamp ts, long long hash, Document event, size_t maxSizeBytes);
+
+    /**
+     * Removes every event from the cache.
+     */
+    void clear();
+
+    size_t size() const;
+
+    size_t sizeBytes() const;
+
+private:
+    using Key = std::pair<Timestamp, long long>;
+
+    struct CachedEvent {
+        Document event;
+        size_t sizeBytes;
+    };
+
+    mutable stdx::mutex _mutex;
+    std::map<Key, CachedEvent> _events;
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
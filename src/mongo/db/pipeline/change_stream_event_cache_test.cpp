@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_event_cache.h"
+
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kCacheSizeBytes = 1024 * 1024;
+
+TEST(ChangeStreamEventCacheTest, FindReturnsInsertedEvent) {
+    ChangeStreamEventCache cache;
+    cache.insert(Timestamp(1, 1), 10, DOC("_id" << 1), kCacheSizeBytes);
+    cache.insert(Timestamp(1, 2), 20, DOC("_id" << 2), kCacheSizeBytes);
+
+    ASSERT_EQ(cache.size(), 2UL);
+    auto found = cache.find(Timestamp(1, 2), 20);
+    ASSERT(found);
+    ASSERT_DOCUMENT_EQ(*found, DOC("_id" << 2));
+}
+
+TEST(ChangeStreamEventCacheTest, FindRequiresMatchingHash) {
+    ChangeStreamEventCache cache;
+    cache.insert(Timestamp(1, 1), 10, DOC("_id" << 1), kCacheSizeBytes);
+
+    ASSERT_FALSE(cache.find(Timestamp(1, 1), 11));
+    ASSERT_FALSE(cache.find(Timestamp(1, 2), 10));
+}
+
+TEST(ChangeStreamEventCacheTest, InsertingSameEntryTwiceKeepsFirstEvent) {
+    ChangeStreamEventCache cache;
+    cache.insert(Timestamp(1, 1), 10, DOC("_id" << 1), kCacheSizeBytes);
+    const auto sizeBytes = cache.sizeBytes();
+    cache.insert(Timestamp(1, 1), 10, DOC("_id" << 2), kCacheSizeBytes);
+
+    ASSERT_EQ(cache.size(), 1UL);
+    ASSERT_EQ(cache.sizeBytes(), sizeBytes);
+    ASSERT_DOCUMENT_EQ(*cache.find(Timestamp(1, 1), 10), DOC("_id" << 1));
+}
+
+TEST(ChangeStreamEventCacheTest, EvictsOldestEntriesWhenFull) {
+    ChangeStreamEventCache cache;
+    const Document event = DOC("_id" << 0);
+    const size_t maxSizeBytes = 3 * event.getApproximateSize();
+
+    // Insert out of timestamp order, to check that eviction goes by timestamp.
+    cache.insert(Timestamp(1, 3), 0, event, maxSizeBytes);
+    cache.insert(Timestamp(1, 1), 0, event, maxSizeBytes);
+    cache.insert(Timestamp(1, 2), 0, event, maxSizeBytes);
+    ASSERT_EQ(cache.size(), 3UL);
+
+    cache.insert(Timestamp(1, 4), 0, event, maxSizeBytes);
+    ASSERT_EQ(cache.size(), 3UL);
+    ASSERT_LTE(cache.sizeBytes(), maxSizeBytes);
+    ASSERT_FALSE(cache.find(Timestamp(1, 1), 0));
+    ASSERT(cache.find(Timestamp(1, 2), 0));
+    ASSERT(cache.find(Timestamp(1, 3), 0));
+    ASSERT(cache.find(Timestamp(1, 4), 0));
+}
+
+TEST(ChangeStreamEventCacheTest, DoesNotCacheEventLargerThanMaximumSize) {
+    ChangeStreamEventCache cache;
+    const Document event = DOC("_id" << 0);
+    cache.insert(Timestamp(1, 1), 0, event, event.getApproximateSize() - 1);
+
+    ASSERT_EQ(cache.size(), 0UL);
+    ASSERT_EQ(cache.sizeBytes(), 0UL);
+}
+
+TEST(ChangeStreamEventCacheTest, ClearRemovesAllEvents) {
+    ChangeStreamEventCache cache;
+    cache.insert(Timestamp(1, 1), 0, DOC("_id" << 1), kCacheSizeBytes);
+    cache.clear();
+
+    ASSERT_EQ(cache.size(), 0UL);
+    ASSERT_EQ(cache.sizeBytes(), 0UL);
+    ASSERT_FALSE(cache.find(Timestamp(1, 1), 0));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -48,10 +49,72 @@ const DocumentStorage DocumentStorage::kEmptyDoc;
 const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldTextScore, Document::metaFieldRandVal, Document::metaFieldSortKey};
 
+namespace {
+AtomicUInt64 nextDocumentShapeId(1);
+thread_local DocumentShapeTable* currentShapeTable = nullptr;
+}  // namespace
+
+DocumentShape::DocumentShape() : _id(nextDocumentShapeId.fetchAndAdd(1)), _numFields(0) {}
+
+DocumentShape::DocumentShape(const DocumentShape& parent, StringData name, Position pos)
+    : _id(nextDocumentShapeId.fetchAndAdd(1)),
+      _numFields(parent._numFields + 1),
+      _lastFieldName(name.toString()),
+      _lastFieldPos(pos),
+      _fields(parent._fields) {
+    // As with the hash table in DocumentStorage, a duplicate name finds the first such field.
+    if (_fields.find(name) == _fields.end()) {
+        _fields[name] = pos;
+    }
+}
+
+DocumentShapeTable::DocumentShapeTable() : _root(new DocumentShape()) {}
+
+DocumentShapeTable::~DocumentShapeTable() = default;
+
+DocumentShapeTable* DocumentShapeTable::current() {
+    return currentShapeTable;
+}
+
+DocumentShapeTable::Scope::Scope(DocumentShapeTable* table) : _previous(currentShapeTable) {
+    currentShapeTable = table;
+}
+
+DocumentShapeTable::Scope::~Scope() {
+    currentShapeTable = _previous;
+}
+
+const DocumentShape* DocumentShapeTable::successor(const DocumentShape* from,
+                                                   StringData name,
+                                                   Position pos) {
+    dassert(currentShapeTable == this);
+
+    // Every shape is owned by this table, so it is ours to add successors to.
+    auto& successors = const_cast<DocumentShape*>(from)->_successors;
+    for (auto&& shape : successors) {
+        if (shape->_lastFieldName == name) {
+            dassert(shape->_lastFieldPos == pos);
+            return shape.get();
+        }
+    }
+
+    if (from->_numFields >= kMaxShapeFields || successors.size() >= kMaxSuccessors ||
+        _numShapes >= kMaxShapes) {
+        return nullptr;
+    }
+
+    successors.emplace_back(new DocumentShape(*from, name, pos));
+    _numShapes++;
+    return successors.back().get();
+}
+
 Position DocumentStorage::findField(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
-    if (_numFields >= HASH_TAB_MIN) {  // hash lookup
+    if (_shape && _numFields >= HASH_TAB_MIN) {  // lookup in the shared table of the shape
+        dassert(_shape->numFields() == _numFields);
+        return _shape->findField(requested);
+    } else if (_numFields >= HASH_TAB_MIN) {  // hash lookup
         const unsigned bucket = bucketForKey(requested);
 
         Position pos = _hashTab[bucket];
@@ -107,7 +170,20 @@ Value& DocumentStorage::appendField(StringData name) {
 
     _numFields++;
 
-    if (_numFields > HASH_TAB_MIN) {
+    if (_numFields == 1) {
+        if (auto table = DocumentShapeTable::current()) {
+            _shapeTable = table;
+            _shape = table->root();
+        }
+    }
+
+    if (_shape) {
+        if (!advanceShape(name, pos) && _numFields >= HASH_TAB_MIN) {
+            // The hash table was not maintained while the document had a shape, so build it now
+            // (including the field we just added).
+            rehash();
+        }
+    } else if (_numFields > HASH_TAB_MIN) {
         addFieldToHashTable(pos);
     } else if (_numFields == HASH_TAB_MIN) {
         // adds all fields to hash table (including the one we just added)
@@ -117,6 +193,19 @@ Value& DocumentStorage::appendField(StringData name) {
     return getField(pos).val;
 }
 
+bool DocumentStorage::advanceShape(StringData name, Position pos) {
+    // Only the thread which has the table current may add shapes to it. A document which is
+    // modified anywhere else stops tracking its shape.
+    _shape = _shapeTable.get() == DocumentShapeTable::current()
+        ? _shapeTable->successor(_shape, name, pos)
+        : nullptr;
+    if (!_shape) {
+        _shapeTable.reset();
+        return false;
+    }
+    return true;
+}
+
 // Call after adding field to _fields and increasing _numFields
 void DocumentStorage::addFieldToHashTable(Position pos) {
     ValueElement& elem = getField(pos);
@@ -148,23 +237,43 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_buffer);
-    _buffer = new char[capacity];
+    char* const oldBuf = _buffer;
+    const bool oldBufInArena = _bufferInArena;
+    _buffer = allocateBuffer(capacity);
     _bufferEnd = _buffer + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_buffer, oldBuf.get(), _usedBytes);
+        memcpy(_buffer, oldBuf, _usedBytes);
 
-        if (_numFields >= HASH_TAB_MIN) {
+        if (usingHashTable()) {
             // if we were hashing, deal with the hash table
             if (doingRehash) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
+
+        freeBuffer(oldBuf, oldBufInArena);
+    }
+}
+
+char* DocumentStorage::allocateBuffer(size_t bytes) {
+    // Only storage which is itself in an arena may put its buffer there, since arena memory must
+    // not be shared between threads.
+    auto arena = isArenaAllocated() ? RefCountedArena::current() : nullptr;
+    char* buffer = arena ? static_cast<char*>(arena->allocate(bytes)) : new char[bytes];
+    _bufferInArena = arena != nullptr;
+    return buffer;
+}
+
+void DocumentStorage::freeBuffer(char* buffer, bool inArena) {
+    if (inArena) {
+        RefCountedArena::deallocate(buffer);
+    } else {
+        delete[] buffer;
     }
 }
 
@@ -181,17 +290,17 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _buffer = new char[newSize + hashTabBytes()];
+    _buffer = allocateBuffer(newSize + hashTabBytes());
     _bufferEnd = _buffer + newSize;
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
-    intrusive_ptr<DocumentStorage> out(new DocumentStorage());
+    intrusive_ptr<DocumentStorage> out(make());
 
     // Make a copy of the buffer.
     // It is very important that the positions of each field are the same after cloning.
     const size_t bufferBytes = allocatedBytes();
-    out->_buffer = new char[bufferBytes];
+    out->_buffer = out->allocateBuffer(bufferBytes);
     out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
     if (bufferBytes > 0) {
         memcpy(out->_buffer, _buffer, bufferBytes);
@@ -201,6 +310,8 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     out->_usedBytes = _usedBytes;
     out->_numFields = _numFields;
     out->_hashTabMask = _hashTabMask;
+    out->_shape = _shape;
+    out->_shapeTable = _shapeTable;
     out->_metaFields = _metaFields;
     out->_textScore = _textScore;
     out->_randVal = _randVal;
@@ -215,11 +326,11 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
-
     for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
+
+    freeBuffer(_buffer, _bufferInArena);
 }
 
 Document::Document(const BSONObj& bson) {
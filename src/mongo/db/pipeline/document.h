@@ -121,6 +121,14 @@ public:
         return storage().getField(key);
     }
 
+    /**
+     * Like getField(key), but remembers where the field was found in 'cache' so that looking it up
+     * again in a Document of the same shape is O(1) without hashing. See DocumentShape.
+     */
+    const Value getField(StringData key, DocumentShape::FieldSlotCache* cache) const {
+        return storage().getField(key, cache);
+    }
+
     /// Look up a field by Position. See positionOf and getNestedField.
     const Value operator[](Position pos) const {
         return getField(pos);
@@ -277,6 +285,11 @@ public:
         return *this;
     }
 
+    /// The shape of this document, or nullptr if it doesn't have one. See DocumentShape.
+    const DocumentShape* getShape() const {
+        return storage().shape();
+    }
+
     /// only for testing
     const void* getPtr() const {
         return _storage.get();
@@ -373,7 +386,7 @@ private:
             // result in an allocation where none is needed, in practice this is only called
             // when we are about to add a field to the sub-document so this just changes where
             // the allocation is done.
-            _val = Value(Document(new DocumentStorage()));
+            _val = Value(Document(DocumentStorage::make()));
         }
 
         return _val._storage.genericRCPtr;
@@ -571,7 +584,7 @@ private:
         return const_cast<DocumentStorage&>(*storagePtr());
     }
     DocumentStorage& newStorage() {
-        reset(new DocumentStorage);
+        reset(DocumentStorage::make());
         return const_cast<DocumentStorage&>(*storagePtr());
     }
     DocumentStorage& clonedStorage() {
@@ -32,10 +32,15 @@
 
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/util/intrusive_counter.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 /** Helper class to make the position in a document abstract
@@ -70,6 +75,116 @@ private:
     friend class DocumentStorageIterator;
 };
 
+/**
+ * The ordered field names of a DocumentStorage, like a hidden class. The Position of a field only
+ * depends on the names before it, so documents with the same shape have the same fields at the
+ * same Positions. Shapes are interned in a DocumentShapeTable, which lets the documents a pipeline
+ * produces share one field name lookup table rather than each hashing its own names.
+ *
+ * A shape never changes once made, except for the list of its successors, which is only touched
+ * by the thread that has the owning table current.
+ */
+class DocumentShape {
+    MONGO_DISALLOW_COPYING(DocumentShape);
+
+public:
+    /**
+     * Remembers where a field was found in the last shape it was looked up in, so that finding it
+     * again in a document of the same shape takes no hashing at all. A cache must always be used
+     * to look up the same field name.
+     */
+    struct FieldSlotCache {
+        unsigned long long shapeId = 0;
+        Position pos;
+    };
+
+    /// Unique among all shapes ever made, and never 0.
+    unsigned long long id() const {
+        return _id;
+    }
+
+    unsigned numFields() const {
+        return _numFields;
+    }
+
+    /// Returns the position of the first field called 'name', or Position() if there is none.
+    Position findField(StringData name) const {
+        auto it = _fields.find(name);
+        return it == _fields.end() ? Position() : it->second;
+    }
+
+private:
+    friend class DocumentShapeTable;
+
+    DocumentShape();
+    DocumentShape(const DocumentShape& parent, StringData name, Position pos);
+
+    const unsigned long long _id;
+    const unsigned _numFields;
+    const std::string _lastFieldName;
+    const Position _lastFieldPos;
+    StringMap<Position> _fields;
+    std::vector<std::unique_ptr<DocumentShape>> _successors;
+};
+
+/**
+ * Interns the DocumentShapes of the documents made while the table is current. A table is only
+ * ever current on one thread at a time. Documents hold a reference to the table of their shape.
+ */
+class DocumentShapeTable : public RefCountable {
+public:
+    // Documents with more fields than this are not given a shape.
+    static const unsigned kMaxShapeFields = 64;
+
+    // Beyond this many successors of one shape, or this many shapes in all, further documents are
+    // not given a shape. This bounds the table for pipelines whose documents have no common shape.
+    static const size_t kMaxSuccessors = 8;
+    static const size_t kMaxShapes = 4096;
+
+    DocumentShapeTable();
+    ~DocumentShapeTable();
+
+    /**
+     * Returns the table set by the innermost Scope on this thread, or nullptr if there is none.
+     */
+    static DocumentShapeTable* current();
+
+    /**
+     * Makes 'table' the current table on this thread until the Scope is destroyed. A null 'table'
+     * means that documents should not be given shapes.
+     */
+    class Scope {
+        MONGO_DISALLOW_COPYING(Scope);
+
+    public:
+        explicit Scope(DocumentShapeTable* table);
+        ~Scope();
+
+    private:
+        DocumentShapeTable* const _previous;
+    };
+
+    /// The shape of a document with no fields.
+    const DocumentShape* root() const {
+        return _root.get();
+    }
+
+    /**
+     * Returns the shape of a document of shape 'from' after a field called 'name' is appended at
+     * 'pos', making it if needed. Returns nullptr if the document should stop tracking its shape.
+     * Must only be called while this table is current.
+     */
+    const DocumentShape* successor(const DocumentShape* from, StringData name, Position pos);
+
+    size_t numShapes() const {
+        return _numShapes;
+    }
+
+private:
+    std::unique_ptr<DocumentShape> _root;
+    size_t _numShapes = 1;
+};
+
 #pragma pack(1)
 /** This is how values are stored in the DocumentStorage buffer
  *  Internal class. Consumers shouldn't care about this.
@@ -193,6 +308,16 @@ public:
 
     ~DocumentStorage();
 
+    /**
+     * Returns a new empty DocumentStorage, made in the current RefCountedArena if there is one.
+     */
+    static DocumentStorage* make() {
+        if (auto arena = RefCountedArena::current()) {
+            return arena->make<DocumentStorage>();
+        }
+        return new DocumentStorage();
+    }
+
     enum MetaType : char {
         TEXT_SCORE,
         RAND_VAL,
@@ -221,6 +346,20 @@ public:
     /// Returns the position of the named field (may be missing) or Position()
     Position findField(StringData name) const;
 
+    /**
+     * Like findField(name), but if this document has a shape, remembers the result in 'cache'
+     * and reuses it for later documents of the same shape.
+     */
+    Position findField(StringData name, DocumentShape::FieldSlotCache* cache) const {
+        if (!_shape)
+            return findField(name);
+        if (cache->shapeId != _shape->id()) {
+            cache->pos = findField(name);
+            cache->shapeId = _shape->id();
+        }
+        return cache->pos;
+    }
+
     // Document uses these
     const ValueElement& getField(Position pos) const {
         verify(pos.found());
@@ -232,6 +371,12 @@ public:
             return Value();
         return getField(pos).val;
     }
+    Value getField(StringData name, DocumentShape::FieldSlotCache* cache) const {
+        Position pos = findField(name, cache);
+        if (!pos.found())
+            return Value();
+        return getField(pos).val;
+    }
 
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
@@ -270,6 +415,11 @@ public:
         return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
     }
 
+    /// The shape of this document, or nullptr if it isn't tracking one.
+    const DocumentShape* shape() const {
+        return _shape;
+    }
+
     /**
      * Copies all metadata from source if it has any.
      * Note: does not clear metadata from this.
@@ -328,9 +478,25 @@ private:
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /// Allocates a new buffer, from the current arena if this storage was itself made in one, and
+    /// sets _bufferInArena to match.
+    char* allocateBuffer(size_t bytes);
+
+    /// Frees a buffer returned by allocateBuffer() with the given value of _bufferInArena.
+    static void freeBuffer(char* buffer, bool inArena);
+
     /// Call after adding field to _buffer and increasing _numFields
     void addFieldToHashTable(Position pos);
 
+    /// Whether findField() uses the hash table. Documents with a shape use the shape's instead.
+    bool usingHashTable() const {
+        return _numFields >= HASH_TAB_MIN && !_shape;
+    }
+
+    /// Call after adding the field at 'pos' to _buffer and increasing _numFields, in place of
+    /// addFieldToHashTable(), to move to the next shape. Returns false if there is none.
+    bool advanceShape(StringData name, Position pos);
+
     // assumes _hashTabMask is (power of two) - 1
     unsigned hashTabBuckets() const {
         return _hashTabMask + 1;
@@ -396,6 +562,12 @@ private:
     unsigned _usedBytes;    // position where next field would start
     unsigned _numFields;    // this includes removed fields
     unsigned _hashTabMask;  // equal to hashTabBuckets()-1 but used more often
+    bool _bufferInArena = false;
+
+    // If not null, the shape of this document in '_shapeTable'. The hash table is not maintained
+    // while a document has a shape.
+    const DocumentShape* _shape = nullptr;
+    boost::intrusive_ptr<DocumentShapeTable> _shapeTable;
 
     std::bitset<MetaType::NUM_FIELDS> _metaFields;
     double _textScore;
@@ -31,6 +31,7 @@
 #include "mongo/db/pipeline/document_source_bucket_auto.h"
 
 #include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 
 namespace mongo {
@@ -44,6 +45,8 @@ REGISTER_DOCUMENT_SOURCE(bucketAuto,
                          LiteParsedDocumentSourceDefault::parse,
                          DocumentSourceBucketAuto::createFromBson);
 
+constexpr StringData DocumentSourceBucketAuto::kShardGroupCountField;
+
 const char* DocumentSourceBucketAuto::getSourceName() const {
     return "$bucketAuto";
 }
@@ -107,8 +110,8 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
     auto next = pSource->getNext();
     for (; next.isAdvanced(); next = pSource->getNext()) {
         auto nextDoc = next.releaseDocument();
+        _nDocuments += _doingMerge ? nextDoc[kShardGroupCountField].coerceToLong() : 1;
         _sorter->add(extractKey(nextDoc), nextDoc);
-        _nDocuments++;
     }
     return next;
 }
@@ -144,15 +147,17 @@ Value DocumentSourceBucketAuto::extractKey(const Document& doc) {
     return key.missing() ? Value(BSONNULL) : std::move(key);
 }
 
-void DocumentSourceBucketAuto::addDocumentToBucket(const pair<Value, Document>& entry,
-                                                   Bucket& bucket) {
+long long DocumentSourceBucketAuto::addDocumentToBucket(const pair<Value, Document>& entry,
+                                                        Bucket& bucket) {
     invariant(pExpCtx->getValueComparator().evaluate(entry.first >= bucket._max));
     bucket._max = entry.first;
 
     const size_t numAccumulators = _accumulatedFields.size();
     for (size_t k = 0; k < numAccumulators; k++) {
-        bucket._accums[k]->process(_accumulatedFields[k].expression->evaluate(entry.second), false);
+        bucket._accums[k]->process(_accumulatedFields[k].expression->evaluate(entry.second),
+                                   _doingMerge);
     }
+    return _doingMerge ? entry.second[kShardGroupCountField].coerceToLong() : 1;
 }
 
 void DocumentSourceBucketAuto::populateBuckets() {
@@ -197,7 +202,7 @@ void DocumentSourceBucketAuto::populateBuckets() {
         Bucket currentBucket(pExpCtx, currentValue.first, currentValue.first, _accumulatedFields);
 
         // Add the first value into the current bucket.
-        addDocumentToBucket(currentValue, currentBucket);
+        long long nDocumentsInBucket = addDocumentToBucket(currentValue, currentBucket);
 
         if (isLastBucket) {
             // If this is the last bucket allowed, we need to put any remaining documents in
@@ -206,11 +211,12 @@ void DocumentSourceBucketAuto::populateBuckets() {
                 addDocumentToBucket(_sortedInput->next(), currentBucket);
             }
         } else {
-            // We go to approxBucketSize - 1 because we already added the first value in order
-            // to keep track of the minimum value.
-            for (long long j = 0; j < approxBucketSize - 1; j++) {
+            // We already added the first value in order to keep track of the minimum value. When
+            // merging, each entry stands for all of the documents with its 'groupBy' value, which
+            // would have been absorbed into the same bucket below anyway.
+            while (nDocumentsInBucket < approxBucketSize) {
                 if (_sortedInput->more()) {
-                    addDocumentToBucket(_sortedInput->next(), currentBucket);
+                    nDocumentsInBucket += addDocumentToBucket(_sortedInput->next(), currentBucket);
                 } else {
                     // No more values to process.
                     break;
@@ -351,9 +357,64 @@ Value DocumentSourceBucketAuto::serialize(
     }
     insides["output"] = outputSpec.freezeToValue();
 
+    if (_doingMerge) {
+        insides["$doingMerge"] = Value(true);
+    }
+
     return Value{Document{{getSourceName(), insides.freezeToValue()}}};
 }
 
+bool DocumentSourceBucketAuto::canSplit() const {
+    // The shards' $group must not be given an output field it already has.
+    return !_doingMerge &&
+        std::none_of(_accumulatedFields.begin(),
+                     _accumulatedFields.end(),
+                     [](const AccumulationStatement& accumulatedField) {
+                         return accumulatedField.fieldName == kShardGroupCountField;
+                     });
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::getShardSource() {
+    if (!canSplit()) {
+        return nullptr;
+    }
+
+    auto groupByExpression = _groupByExpression
+        ? _groupByExpression
+        : ExpressionConstant::create(pExpCtx, Value(BSONNULL));
+    auto shardAccumulators = _accumulatedFields;
+    shardAccumulators.emplace_back(kShardGroupCountField.toString(),
+                                   ExpressionConstant::create(pExpCtx, Value(1)),
+                                   AccumulationStatement::getFactory("$sum"));
+    return DocumentSourceGroup::create(
+        pExpCtx, groupByExpression, std::move(shardAccumulators), _maxMemoryUsageBytes);
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::getMergeSource() {
+    if (!canSplit()) {
+        // Every input document will be sent to the merger, which must do all of the work.
+        return this;
+    }
+
+    // The merger buckets the groups by their _id, which is the 'groupBy' value, and combines the
+    // partial results of each accumulator from the field of the same name.
+    VariablesParseState vps = pExpCtx->variablesParseState;
+    auto mergeAccumulators = _accumulatedFields;
+    for (auto&& accumulatedField : mergeAccumulators) {
+        accumulatedField.expression =
+            ExpressionFieldPath::parse(pExpCtx, "$$ROOT." + accumulatedField.fieldName, vps);
+    }
+    intrusive_ptr<DocumentSourceBucketAuto> merger =
+        create(pExpCtx,
+               ExpressionFieldPath::parse(pExpCtx, "$$ROOT._id", vps),
+               _nBuckets,
+               std::move(mergeAccumulators),
+               _granularityRounder,
+               _maxMemoryUsageBytes);
+    merger->_doingMerge = true;
+    return merger;
+}
+
 intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
     const intrusive_ptr<ExpressionContext>& pExpCtx,
     const boost::intrusive_ptr<Expression>& groupByExpression,
@@ -432,6 +493,7 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
     boost::intrusive_ptr<Expression> groupByExpression;
     boost::optional<int> numBuckets;
     boost::intrusive_ptr<GranularityRounder> granularityRounder;
+    bool doingMerge = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -472,6 +534,9 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
                         << typeName(argument.type()),
                     argument.type() == BSONType::String);
             granularityRounder = GranularityRounder::getGranularityRounder(pExpCtx, argument.str());
+        } else if ("$doingMerge" == argName) {
+            uassert(40640, "$doingMerge should be true if present", argument.trueValue());
+            doingMerge = true;
         } else {
             uasserted(40245, str::stream() << "Unrecognized option to $bucketAuto: " << argName);
         }
@@ -481,8 +546,10 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
             "$bucketAuto requires 'groupBy' and 'buckets' to be specified",
             groupByExpression && numBuckets);
 
-    return DocumentSourceBucketAuto::create(
+    auto bucketAuto = DocumentSourceBucketAuto::create(
         pExpCtx, groupByExpression, numBuckets.get(), accumulationStatements, granularityRounder);
+    bucketAuto->_doingMerge = doingMerge;
+    return bucketAuto;
 }
 }  // namespace mongo
 
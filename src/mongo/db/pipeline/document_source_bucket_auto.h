@@ -49,17 +49,19 @@ public:
     const char* getSourceName() const final;
 
     /**
-     * The $bucketAuto stage must be run on the merging shard.
+     * The bucket boundaries depend on every input document, so they can only be chosen on the
+     * merging shard. The shards instead group their documents by the 'groupBy' value, producing
+     * partial results for each accumulator along with the number of documents in each group, and
+     * the merger then places those groups into buckets.
      */
-    boost::intrusive_ptr<DocumentSource> getShardSource() final {
-        return nullptr;
-    }
-    boost::intrusive_ptr<DocumentSource> getMergeSource() final {
-        return this;
-    }
+    boost::intrusive_ptr<DocumentSource> getShardSource() final;
+    boost::intrusive_ptr<DocumentSource> getMergeSource() final;
 
     static const uint64_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
 
+    // The field in which the shards' $group records the number of documents in each group.
+    static constexpr StringData kShardGroupCountField = "__bucketAutoCount"_sd;
+
     /**
      * Convenience method to create a $bucketAuto stage.
      *
@@ -121,9 +123,17 @@ private:
     void populateBuckets();
 
     /**
-     * Adds the document in 'entry' to 'bucket' by updating the accumulators in 'bucket'.
+     * Returns true if this stage can be split into a $group on the shards followed by a merging
+     * $bucketAuto.
      */
-    void addDocumentToBucket(const std::pair<Value, Document>& entry, Bucket& bucket);
+    bool canSplit() const;
+
+    /**
+     * Adds the document in 'entry' to 'bucket' by updating the accumulators in 'bucket'. Returns
+     * the number of input documents which 'entry' represents: one, unless this stage is merging
+     * the groups produced by the shards.
+     */
+    long long addDocumentToBucket(const std::pair<Value, Document>& entry, Bucket& bucket);
 
     /**
      * Adds 'newBucket' to _buckets and updates any boundaries if necessary.
@@ -149,6 +159,10 @@ private:
     boost::intrusive_ptr<Expression> _groupByExpression;
     boost::intrusive_ptr<GranularityRounder> _granularityRounder;
     long long _nDocuments = 0;
+
+    // True if the input is the output of the $group from getShardSource() rather than the original
+    // documents.
+    bool _doingMerge = false;
 };
 
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_bucket_auto.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
@@ -83,6 +84,57 @@ public:
         return results;
     }
 
+    /**
+     * Splits the $bucketAuto described by 'bucketAutoSpec' as for a sharded aggregation, runs its
+     * shard part over each of 'shardInputs' and returns the results of merging their output.
+     */
+    vector<Document> getSplitResults(BSONObj bucketAutoSpec, vector<deque<Document>> shardInputs) {
+        auto bucketAutoStage = createBucketAuto(bucketAutoSpec);
+        auto splittable = dynamic_cast<SplittableDocumentSource*>(bucketAutoStage.get());
+        ASSERT(splittable);
+        auto shardSource = splittable->getShardSource();
+        auto mergeSource = splittable->getMergeSource();
+        ASSERT(shardSource);
+        ASSERT(mergeSource);
+
+        // Both halves are sent to the hosts which run them in serialized form.
+        vector<Value> shardSerialization;
+        shardSource->serializeToArray(shardSerialization);
+        ASSERT_EQUALS(shardSerialization.size(), 1UL);
+        const BSONObj shardSpec = shardSerialization[0].getDocument().toBson();
+        vector<Value> mergeSerialization;
+        mergeSource->serializeToArray(mergeSerialization);
+        ASSERT_EQUALS(mergeSerialization.size(), 1UL);
+        const BSONObj mergeSpec = mergeSerialization[0].getDocument().toBson();
+
+        deque<DocumentSource::GetNextResult> mergeInputs;
+        getExpCtx()->needsMerge = true;
+        for (auto&& inputs : shardInputs) {
+            auto shardStage =
+                DocumentSourceGroup::createFromBson(shardSpec.firstElement(), getExpCtx());
+            deque<DocumentSource::GetNextResult> mockInputs;
+            for (auto&& input : inputs) {
+                mockInputs.emplace_back(std::move(input));
+            }
+            auto source = DocumentSourceMock::create(std::move(mockInputs));
+            shardStage->setSource(source.get());
+            for (auto next = shardStage->getNext(); next.isAdvanced();
+                 next = shardStage->getNext()) {
+                mergeInputs.emplace_back(next.releaseDocument());
+            }
+        }
+        getExpCtx()->needsMerge = false;
+
+        auto merger = createBucketAuto(mergeSpec);
+        auto source = DocumentSourceMock::create(std::move(mergeInputs));
+        merger->setSource(source.get());
+        vector<Document> results;
+        for (auto next = merger->getNext(); next.isAdvanced(); next = merger->getNext()) {
+            results.push_back(next.releaseDocument());
+        }
+        return results;
+    }
+
     void testSerialize(BSONObj bucketAutoSpec, BSONObj expectedObj) {
         auto bucketAutoStage = createBucketAuto(bucketAutoSpec);
         assertBucketAutoType(bucketAutoStage);
@@ -525,6 +577,45 @@ TEST_F(BucketAutoTests, ShouldBeAbleToReParseSerializedStage) {
     ASSERT_VALUE_EQ(newSerialization[0], serialization[0]);
 }
 
+TEST_F(BucketAutoTests, SplitStagesProduceSameBucketsAsUnsplitStage) {
+    deque<Document> firstShard, secondShard, allInputs;
+    for (int i = 0; i < 40; ++i) {
+        Document doc{{"x", i % 10}, {"y", i}};
+        ((i % 3 == 0) ? firstShard : secondShard).push_back(doc);
+        allInputs.push_back(doc);
+    }
+
+    for (auto&& spec : {fromjson("{$bucketAuto: {groupBy: '$x', buckets: 3}}"),
+                        fromjson("{$bucketAuto: {groupBy: '$x', buckets: 4, output: {n: {$sum: 1}, "
+                                 "avg: {$avg: '$y'}, max: {$max: '$y'}, min: {$min: '$y'}}}}"),
+                        fromjson("{$bucketAuto: {groupBy: '$x', buckets: 2, granularity: 'R5'}}"),
+                        fromjson("{$bucketAuto: {groupBy: '$x', buckets: 20}}")}) {
+        auto expected = getResults(spec, allInputs);
+        auto results = getSplitResults(spec, {firstShard, secondShard});
+        ASSERT_EQUALS(results.size(), expected.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            ASSERT_DOCUMENT_EQ(results[i], expected[i]);
+        }
+    }
+}
+
+TEST_F(BucketAutoTests, MergingStageShouldBeAbleToReParseSerializedStage) {
+    auto bucketAuto = createBucketAuto(
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, output : {f : {$avg : '$x'}}}}"));
+    auto mergeSource = dynamic_cast<SplittableDocumentSource*>(bucketAuto.get())->getMergeSource();
+
+    vector<Value> serialization;
+    mergeSource->serializeToArray(serialization);
+    ASSERT_EQUALS(serialization.size(), 1UL);
+    ASSERT_VALUE_EQ(serialization[0]["$bucketAuto"]["$doingMerge"], Value(true));
+
+    auto roundTripped = createBucketAuto(serialization[0].getDocument().toBson());
+    vector<Value> newSerialization;
+    roundTripped->serializeToArray(newSerialization);
+    ASSERT_EQUALS(newSerialization.size(), 1UL);
+    ASSERT_VALUE_EQ(newSerialization[0], serialization[0]);
+}
+
 TEST_F(BucketAutoTests, FailsWithInvalidNumberOfBuckets) {
     auto spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 'test'}}");
     ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 40241);
@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * An internal stage which takes the place of a view's pipeline when the results of that pipeline
+ * have already been computed, and produces those results. It is never parsed; run_aggregate.cpp
+ * adds it to the front of the pipeline of an aggregation over a view.
+ */
+class DocumentSourceCachedViewResults final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalCachedViewResults"_sd;
+
+    static boost::intrusive_ptr<DocumentSourceCachedViewResults> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        std::shared_ptr<const std::vector<BSONObj>> results);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints() const final {
+        StageConstraints constraints;
+        constraints.requiredPosition = PositionRequirement::kFirst;
+        constraints.requiresInputDocSource = false;
+        constraints.isAllowedInsideFacetStage = false;
+        return constraints;
+    }
+
+    GetNextResult getNext() final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+private:
+    DocumentSourceCachedViewResults(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    std::shared_ptr<const std::vector<BSONObj>> results);
+
+    void doDispose() final;
+
+    std::shared_ptr<const std::vector<BSONObj>> _results;
+    const size_t _nResults;
+    size_t _nextResult = 0;
+};
+
+}  // namespace mongo
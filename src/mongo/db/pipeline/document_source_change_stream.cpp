@@ -31,8 +31,11 @@
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/bson/bson_helper.h"
 #include "mongo/db/catalog/uuid_catalog.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/pipeline/change_stream_event_cache.h"
 #include "mongo/db/pipeline/close_change_stream_exception.h"
 #include "mongo/db/pipeline/document_source_check_resume_token.h"
 #include "mongo/db/pipeline/document_source_limit.h"
@@ -41,10 +44,13 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/resume_token.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/oplog_entry_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
 #include "mongo/util/log.h"
+#include "mongo/util/ref_counted_arena.h"
 
 namespace mongo {
 
@@ -85,8 +91,12 @@ static constexpr StringData kOplogMatchExplainName = "$_internalOplogMatch"_sd;
 }  // namespace
 
 intrusive_ptr<DocumentSourceOplogMatch> DocumentSourceOplogMatch::create(
-    BSONObj filter, const intrusive_ptr<ExpressionContext>& expCtx) {
-    return new DocumentSourceOplogMatch(std::move(filter), expCtx);
+    BSONObj filter,
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    optional<Timestamp> resumeTimestamp,
+    bool lookupPostImage) {
+    return new DocumentSourceOplogMatch(
+        std::move(filter), expCtx, std::move(resumeTimestamp), lookupPostImage);
 }
 
 const char* DocumentSourceOplogMatch::getSourceName() const {
@@ -114,8 +124,12 @@ Value DocumentSourceOplogMatch::serialize(optional<ExplainOptions::Verbosity> ex
 }
 
 DocumentSourceOplogMatch::DocumentSourceOplogMatch(BSONObj filter,
-                                                   const intrusive_ptr<ExpressionContext>& expCtx)
-    : DocumentSourceMatch(std::move(filter), expCtx) {}
+                                                   const intrusive_ptr<ExpressionContext>& expCtx,
+                                                   optional<Timestamp> resumeTimestamp,
+                                                   bool lookupPostImage)
+    : DocumentSourceMatch(std::move(filter), expCtx),
+      _resumeTimestamp(std::move(resumeTimestamp)),
+      _lookupPostImage(lookupPostImage) {}
 
 void checkValueType(const Value v, const StringData filedName, BSONType expectedType) {
     uassert(40532,
@@ -189,8 +203,291 @@ DocumentSource::GetNextResult DocumentSourceCloseCursor::getNext() {
     return nextInput;
 }
 
+/**
+ * Returns whether 'stage' is one of the stages a $changeStream expands into, other than the
+ * DocumentSourceOplogMatch.
+ */
+bool isChangeStreamStage(DocumentSource* stage) {
+    if (dynamic_cast<DocumentSourceSingleDocumentTransformation*>(stage)) {
+        return DocumentSourceChangeStream::kStageName == stage->getSourceName();
+    }
+    return dynamic_cast<DocumentSourceCloseCursor*>(stage) ||
+        dynamic_cast<DocumentSourceEnsureResumeTokenPresent*>(stage) ||
+        dynamic_cast<DocumentSourceShardCheckResumability*>(stage) ||
+        dynamic_cast<DocumentSourceLookupChangePostImage*>(stage);
+}
+
+/**
+ * Returns whether a predicate comparing to 'elem' can never match a missing field.
+ */
+bool neverMatchesMissing(const BSONElement& elem) {
+    switch (elem.type()) {
+        case BSONType::jstNULL:
+        case BSONType::Undefined:
+        case BSONType::MinKey:
+        case BSONType::MaxKey:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/**
+ * Returns whether 'expr' is a predicate on a single path which never matches a document missing
+ * that path. Such a predicate rejects every event which does not have the path, so it may be
+ * evaluated on the oplog entries of the events which do, with the path renamed.
+ */
+bool isRenameablePredicate(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return neverMatchesMissing(
+                static_cast<const ComparisonMatchExpression*>(expr)->getData());
+        case MatchExpression::MATCH_IN: {
+            auto inExpr = static_cast<const InMatchExpression*>(expr);
+            if (inExpr->hasNull()) {
+                return false;
+            }
+            for (auto&& equality : inExpr->getEqualities()) {
+                if (!neverMatchesMissing(equality)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case MatchExpression::EXISTS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Appends the predicate 'expr' to 'builder', applied to 'path' instead of its own path.
+ */
+void appendPredicateOnPath(const MatchExpression* expr, StringData path, BSONObjBuilder* builder) {
+    BSONObjBuilder serialized;
+    expr->serialize(&serialized);
+    const BSONObj predicate = serialized.obj();
+    builder->appendAs(predicate.firstElement(), path);
+}
+
+/**
+ * If 'path' is 'prefix' or a path below it, returns 'newPrefix' followed by the rest of 'path'.
+ */
+optional<string> renamePrefix(StringData path, StringData prefix, StringData newPrefix) {
+    if (!path.startsWith(prefix)) {
+        return boost::none;
+    }
+    StringData rest = path.substr(prefix.size());
+    if (!rest.empty() && rest[0] != '.') {
+        return boost::none;
+    }
+    return newPrefix.toString() + rest.toString();
+}
+
+/**
+ * Returns the filter on the oplog entries of events with the given 'operationType', or an empty
+ * object if they are not built from CRUD entries.
+ */
+BSONObj buildOpTypeFilter(StringData operationType) {
+    if (operationType == DocumentSourceChangeStream::kInsertOpType) {
+        return BSON("op"
+                    << "i");
+    }
+    if (operationType == DocumentSourceChangeStream::kDeleteOpType) {
+        return BSON("op"
+                    << "d");
+    }
+    if (operationType == DocumentSourceChangeStream::kReplaceOpType) {
+        return BSON("op"
+                    << "u"
+                    << "o._id"
+                    << BSON("$exists" << true));
+    }
+    if (operationType == DocumentSourceChangeStream::kUpdateOpType) {
+        return BSON("op"
+                    << "u"
+                    << "o._id"
+                    << BSON("$exists" << false));
+    }
+    return BSONObj();
+}
+
+/**
+ * Rewrites a predicate on the 'operationType' of the events into one on the 'op' field of the
+ * oplog entries. Returns an empty object if 'expr' cannot be rewritten.
+ */
+BSONObj rewriteOperationTypePredicate(const MatchExpression* expr) {
+    std::vector<BSONElement> operationTypes;
+    if (expr->matchType() == MatchExpression::EQ) {
+        operationTypes.push_back(static_cast<const ComparisonMatchExpression*>(expr)->getData());
+    } else if (expr->matchType() == MatchExpression::MATCH_IN) {
+        auto inExpr = static_cast<const InMatchExpression*>(expr);
+        if (!inExpr->getRegexes().empty()) {
+            return BSONObj();
+        }
+        operationTypes.assign(inExpr->getEqualities().begin(), inExpr->getEqualities().end());
+    } else {
+        return BSONObj();
+    }
+
+    BSONArrayBuilder opTypeFilters;
+    for (auto&& operationType : operationTypes) {
+        if (operationType.type() != BSONType::String) {
+            return BSONObj();
+        }
+        auto opTypeFilter = buildOpTypeFilter(operationType.valueStringData());
+        if (!opTypeFilter.isEmpty()) {
+            opTypeFilters.append(opTypeFilter);
+        }
+    }
+    if (opTypeFilters.arrSize() == 0) {
+        // None of the requested events is built from a CRUD entry.
+        return BSON("op" << BSON("$in" << BSONArray()));
+    }
+    return BSON("$or" << opTypeFilters.arr());
+}
+
+/**
+ * Rewrites a predicate on the 'fullDocument' of the events, which is the "o" field of inserts and
+ * replacements and is missing from other events unless it is looked up for updates. Returns an
+ * empty object if 'expr' cannot be rewritten.
+ */
+BSONObj rewriteFullDocumentPredicate(const MatchExpression* expr, bool lookupPostImage) {
+    auto oplogPath =
+        renamePrefix(expr->path(), DocumentSourceChangeStream::kFullDocumentField, "o");
+    if (!oplogPath || *oplogPath == "o" || !isRenameablePredicate(expr)) {
+        return BSONObj();
+    }
+
+    BSONArrayBuilder branches;
+    {
+        BSONObjBuilder insertBranch(branches.subobjStart());
+        insertBranch.append("op", "i");
+        appendPredicateOnPath(expr, *oplogPath, &insertBranch);
+    }
+    {
+        BSONObjBuilder replaceBranch(branches.subobjStart());
+        replaceBranch.append("op", "u");
+        replaceBranch.append("o._id", BSON("$exists" << true));
+        appendPredicateOnPath(expr, *oplogPath, &replaceBranch);
+    }
+    if (lookupPostImage) {
+        branches.append(buildOpTypeFilter(DocumentSourceChangeStream::kUpdateOpType));
+    }
+    return BSON("$or" << branches.arr());
+}
+
+/**
+ * Rewrites a predicate on 'documentKey._id', which is the "_id" of the "o" field of the oplog
+ * entry, or of its "o2" field for updates which are not replacements. Returns an empty object if
+ * 'expr' cannot be rewritten.
+ */
+BSONObj rewriteDocumentKeyPredicate(const MatchExpression* expr) {
+    const string documentKeyIdPath = str::stream() << DocumentSourceChangeStream::kDocumentKeyField
+                                                   << "." << DocumentSourceChangeStream::kIdField;
+    auto objectPath = renamePrefix(expr->path(), documentKeyIdPath, "o._id");
+    if (!objectPath || !isRenameablePredicate(expr)) {
+        return BSONObj();
+    }
+    auto object2Path = renamePrefix(expr->path(), documentKeyIdPath, "o2._id");
+
+    BSONArrayBuilder branches;
+    {
+        BSONObjBuilder objectBranch(branches.subobjStart());
+        appendPredicateOnPath(expr, *objectPath, &objectBranch);
+    }
+    {
+        BSONObjBuilder object2Branch(branches.subobjStart());
+        object2Branch.append("o._id", BSON("$exists" << false));
+        appendPredicateOnPath(expr, *object2Path, &object2Branch);
+    }
+    return BSON("$or" << branches.arr());
+}
+
+/**
+ * Appends to 'rewritten' the rewrites of the conjuncts of 'expr' which can be rewritten.
+ */
+void rewriteConjuncts(const MatchExpression* expr,
+                      bool lookupPostImage,
+                      BSONArrayBuilder* rewritten) {
+    if (expr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            rewriteConjuncts(expr->getChild(i), lookupPostImage, rewritten);
+        }
+        return;
+    }
+
+    BSONObj rewrite;
+    if (expr->path() == DocumentSourceChangeStream::kOperationTypeField) {
+        rewrite = rewriteOperationTypePredicate(expr);
+    } else if (expr->path().startsWith(DocumentSourceChangeStream::kFullDocumentField)) {
+        rewrite = rewriteFullDocumentPredicate(expr, lookupPostImage);
+    } else if (expr->path().startsWith(DocumentSourceChangeStream::kDocumentKeyField)) {
+        rewrite = rewriteDocumentKeyPredicate(expr);
+    }
+    if (!rewrite.isEmpty()) {
+        rewritten->append(rewrite);
+    }
+}
+
 }  // namespace
 
+Pipeline::SourceContainer::iterator DocumentSourceOplogMatch::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto userStage = std::next(itr);
+    while (userStage != container->end() && isChangeStreamStage(userStage->get())) {
+        ++userStage;
+    }
+    if (userStage == container->end()) {
+        return std::next(itr);
+    }
+    auto userMatch = dynamic_cast<DocumentSourceMatch*>(userStage->get());
+    if (!userMatch || userMatch->isTextQuery()) {
+        return std::next(itr);
+    }
+
+    BSONObj userQuery = userMatch->getQuery();
+    if (SimpleBSONObjComparator::kInstance.evaluate(userQuery == _pushedDownQuery)) {
+        return std::next(itr);
+    }
+    _pushedDownQuery = userQuery.getOwned();
+
+    BSONObj pushdownFilter = DocumentSourceChangeStream::buildOplogPushdownFilter(
+        userMatch->getMatchExpression(), _lookupPostImage);
+    if (pushdownFilter.isEmpty()) {
+        return std::next(itr);
+    }
+
+    // Invalidate and retryNeeded entries must still reach the stage closing the cursor, and the
+    // entry being resumed after the stage checking for it, whether or not the user wants them.
+    BSONArrayBuilder alwaysIncluded;
+    alwaysIncluded.append(BSON("op" << BSON("$in" << BSON_ARRAY("c"
+                                                                << "n"))));
+    if (_resumeTimestamp) {
+        alwaysIncluded.append(BSON("ts" << *_resumeTimestamp));
+    }
+    alwaysIncluded.append(pushdownFilter);
+    joinMatchWith(DocumentSourceMatch::create(BSON("$or" << alwaysIncluded.arr()), pExpCtx));
+    return std::next(itr);
+}
+
+BSONObj DocumentSourceChangeStream::buildOplogPushdownFilter(const MatchExpression* userMatch,
+                                                             bool lookupPostImage) {
+    BSONArrayBuilder rewritten;
+    rewriteConjuncts(userMatch, lookupPostImage, &rewritten);
+    if (rewritten.arrSize() == 0) {
+        return BSONObj();
+    }
+    return BSON("$and" << rewritten.arr());
+}
+
 BSONObj DocumentSourceChangeStream::buildMatchFilter(const NamespaceString& nss,
                                                      Timestamp startFrom,
                                                      bool isResume) {
@@ -278,7 +575,10 @@ list<intrusive_ptr<DocumentSource>> DocumentSourceChangeStream::createFromBson(
     const bool shouldLookupPostImage = (fullDocOption == "updateLookup"_sd);
 
     auto oplogMatch = DocumentSourceOplogMatch::create(
-        buildMatchFilter(expCtx->ns, startFrom, changeStreamIsResuming), expCtx);
+        buildMatchFilter(expCtx->ns, startFrom, changeStreamIsResuming),
+        expCtx,
+        changeStreamIsResuming ? optional<Timestamp>(startFrom) : boost::none,
+        shouldLookupPostImage);
     auto transformation = createTransformationStage(elem.embeddedObject(), expCtx);
     list<intrusive_ptr<DocumentSource>> stages = {oplogMatch, transformation};
     if (resumeStage) {
@@ -294,11 +594,43 @@ list<intrusive_ptr<DocumentSource>> DocumentSourceChangeStream::createFromBson(
 
 intrusive_ptr<DocumentSource> DocumentSourceChangeStream::createTransformationStage(
     BSONObj changeStreamSpec, const intrusive_ptr<ExpressionContext>& expCtx) {
+    ChangeStreamEventCache* eventCache = nullptr;
+    if (expCtx->opCtx && expCtx->opCtx->getServiceContext()) {
+        eventCache = ChangeStreamEventCache::get(expCtx->opCtx->getServiceContext());
+    }
     return intrusive_ptr<DocumentSource>(new DocumentSourceSingleDocumentTransformation(
-        expCtx, stdx::make_unique<Transformation>(changeStreamSpec), kStageName.toString()));
+        expCtx,
+        stdx::make_unique<Transformation>(changeStreamSpec, eventCache),
+        kStageName.toString()));
 }
 
 Document DocumentSourceChangeStream::Transformation::applyTransformation(const Document& input) {
+    const int maxCacheSizeBytes = internalChangeStreamEventCacheMaxBytes.load();
+    Value ts = input[repl::OplogEntry::kTimestampFieldName];
+    Value hash = input[repl::OplogEntry::kHashFieldName];
+    const bool useCache = _eventCache && maxCacheSizeBytes > 0 &&
+        ts.getType() == BSONType::bsonTimestamp && hash.getType() == BSONType::NumberLong;
+    if (!useCache) {
+        return transformOplogEntry(input);
+    }
+
+    if (auto cachedEvent = _eventCache->find(ts.getTimestamp(), hash.getLong())) {
+        return std::move(*cachedEvent);
+    }
+
+    // Other threads will hold on to the cached event. If this pipeline allocates in an arena, the
+    // event and the values it shares with 'input' may be arena-allocated, so cache a copy instead.
+    Document event = transformOplogEntry(input);
+    if (RefCountedArena::current()) {
+        RefCountedArena::Scope noArena(nullptr);
+        event = Document(event.toBson());
+    }
+    _eventCache->insert(ts.getTimestamp(), hash.getLong(), event, maxCacheSizeBytes);
+    return event;
+}
+
+Document DocumentSourceChangeStream::Transformation::transformOplogEntry(
+    const Document& input) const {
     MutableDocument doc;
 
     // Extract the fields we need.
@@ -419,6 +751,7 @@ DocumentSource::GetDepsReturn DocumentSourceChangeStream::Transformation::addDep
     deps->fields.insert(repl::OplogEntry::kUuidFieldName.toString());
     deps->fields.insert(repl::OplogEntry::kObjectFieldName.toString());
     deps->fields.insert(repl::OplogEntry::kObject2FieldName.toString());
+    deps->fields.insert(repl::OplogEntry::kHashFieldName.toString());
     return DocumentSource::GetDepsReturn::EXHAUSTIVE_ALL;
 }
 
@@ -35,6 +35,8 @@
 
 namespace mongo {
 
+class ChangeStreamEventCache;
+
 /**
  * The $changeStream stage is an alias for a cursor on oplog followed by a $match stage and a
  * transform stage on mongod.
@@ -66,7 +68,12 @@ public:
 
     class Transformation : public DocumentSourceSingleDocumentTransformation::TransformerInterface {
     public:
-        Transformation(BSONObj changeStreamSpec) : _changeStreamSpec(changeStreamSpec.getOwned()) {}
+        /**
+         * If 'eventCache' is non-null, the events produced from oplog entries are shared with other
+         * change streams through it, subject to 'internalChangeStreamEventCacheMaxBytes'.
+         */
+        Transformation(BSONObj changeStreamSpec, ChangeStreamEventCache* eventCache = nullptr)
+            : _changeStreamSpec(changeStreamSpec.getOwned()), _eventCache(eventCache) {}
         ~Transformation() = default;
         Document applyTransformation(const Document& input) final;
         TransformerType getType() const final {
@@ -79,7 +86,13 @@ public:
         DocumentSource::GetModPathsReturn getModifiedPaths() const final;
 
     private:
+        /**
+         * Builds the change event describing the oplog entry 'input'.
+         */
+        Document transformOplogEntry(const Document& input) const;
+
         BSONObj _changeStreamSpec;
+        ChangeStreamEventCache* const _eventCache;
     };
 
     // The name of the field where the document key (_id and shard key, if present) will be found
@@ -133,6 +146,17 @@ public:
      */
     static BSONObj buildMatchFilter(const NamespaceString& nss, Timestamp startFrom, bool isResume);
 
+    /**
+     * Rewrites the conjuncts of 'userMatch', a $match on the change events, into a filter on the
+     * oplog entries they are built from. The filter accepts every entry whose event could match
+     * 'userMatch', but may accept others too. Conjuncts which cannot be rewritten are ignored, and
+     * an empty object is returned if none can be. If 'lookupPostImage' is true, the full document
+     * of an update event is looked up after the transformation, so no filter on it can be applied
+     * to the update's oplog entry.
+     */
+    static BSONObj buildOplogPushdownFilter(const MatchExpression* userMatch,
+                                            bool lookupPostImage);
+
     /**
      * Parses a $changeStream stage from 'elem' and produces the $match and transformation
      * stages required.
@@ -155,8 +179,15 @@ private:
  */
 class DocumentSourceOplogMatch final : public DocumentSourceMatch {
 public:
+    /**
+     * 'resumeTimestamp' is the timestamp of the oplog entry the change stream resumes after, if it
+     * is resuming, and 'lookupPostImage' whether it looks up the full document of update events.
+     */
     static boost::intrusive_ptr<DocumentSourceOplogMatch> create(
-        BSONObj filter, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+        BSONObj filter,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::optional<Timestamp> resumeTimestamp = boost::none,
+        bool lookupPostImage = false);
 
     const char* getSourceName() const final;
 
@@ -164,8 +195,28 @@ public:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
 
+    /**
+     * Pushes the part of a user $match following the stages of the $changeStream which can be
+     * evaluated on the oplog entries into this stage, so that entries whose events would be
+     * filtered out are never transformed. The user $match stays in place and still applies the
+     * exact predicate. Entries which close the cursor and the entry being resumed after are never
+     * filtered out.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
-    DocumentSourceOplogMatch(BSONObj filter, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+    DocumentSourceOplogMatch(BSONObj filter,
+                             const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                             boost::optional<Timestamp> resumeTimestamp,
+                             bool lookupPostImage);
+
+    const boost::optional<Timestamp> _resumeTimestamp;
+    const bool _lookupPostImage;
+
+    // The query of the user $match last pushed into this stage, so that optimizing the pipeline
+    // again does not push it down twice.
+    BSONObj _pushedDownQuery;
 };
 
 }  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/json.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/change_stream_event_cache.h"
 #include "mongo/db/pipeline/close_change_stream_exception.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
@@ -44,9 +45,11 @@
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -121,9 +124,46 @@ public:
         return stages;
     }
 
+    /**
+     * Returns the oplog $match of the optimized pipeline made of the stages expanded from
+     * 'changeStreamSpec' followed by a $match on 'userFilter'.
+     */
+    intrusive_ptr<DocumentSourceMatch> makeOptimizedOplogMatch(const BSONObj& userFilter,
+                                                               const BSONObj& changeStreamSpec) {
+        const auto spec = BSON(DSChangeStream::kStageName << changeStreamSpec);
+        auto stages = DSChangeStream::createFromBson(spec.firstElement(), getExpCtx());
+        stages.push_back(DocumentSourceMatch::create(userFilter, getExpCtx()));
+        auto pipeline = uassertStatusOK(Pipeline::create(stages, getExpCtx()));
+        pipeline->optimizePipeline();
+
+        intrusive_ptr<DocumentSourceMatch> match =
+            dynamic_cast<DocumentSourceMatch*>(pipeline->getSources().front().get());
+        ASSERT(match);
+        return match;
+    }
+
+    intrusive_ptr<DocumentSourceMatch> makeOptimizedOplogMatch(const BSONObj& userFilter) {
+        return makeOptimizedOplogMatch(userFilter, BSONObj());
+    }
+
+    /**
+     * Returns whether 'match' passes the oplog entry 'entry' on to the transformation.
+     */
+    bool oplogMatchAccepts(const intrusive_ptr<DocumentSourceMatch>& match,
+                           const OplogEntry& entry) {
+        auto mock = DocumentSourceMock::create(D(entry.toBSON()));
+        match->setSource(mock.get());
+        return match->getNext().isAdvanced();
+    }
+
+    /**
+     * Gives each command a distinct hash, as real oplog entries have, since change events are
+     * cached by the timestamp and hash of the oplog entry they describe.
+     */
     OplogEntry createCommand(const BSONObj& oField,
                              const boost::optional<UUID> uuid = boost::none) {
-        auto entry = OplogEntry(optime, 1, OpTypeEnum::kCommand, nss.getCommandNS(), oField);
+        auto entry =
+            OplogEntry(optime, ++_lastHash, OpTypeEnum::kCommand, nss.getCommandNS(), oField);
         if (uuid)
             entry.setUuid(uuid.get());
         return entry;
@@ -146,6 +186,9 @@ public:
         static const UUID* uuid_gen = new UUID(UUID::gen());
         return *uuid_gen;
     }
+
+private:
+    long long _lastHash = 1;
 };
 
 TEST_F(ChangeStreamStageTest, ShouldRejectUnrecognizedOption) {
@@ -220,6 +263,41 @@ TEST_F(ChangeStreamStageTest, TransformInsert) {
     checkTransformation(insert, expectedInsert);
 }
 
+TEST_F(ChangeStreamStageTest, ChangeStreamsShareTransformedEvents) {
+    OplogEntry insert(optime, 1, OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 1));
+    insert.setUuid(testUuid());
+
+    auto firstStages = makeStages(insert);
+    auto firstEvent = firstStages[2]->getNext();
+    ASSERT(firstEvent.isAdvanced());
+
+    auto secondStages = makeStages(insert);
+    auto secondEvent = secondStages[2]->getNext();
+    ASSERT(secondEvent.isAdvanced());
+
+    // The second stream gets the very event produced for the first.
+    ASSERT_EQ(firstEvent.getDocument().getPtr(), secondEvent.getDocument().getPtr());
+    ASSERT_EQ(ChangeStreamEventCache::get(getExpCtx()->opCtx->getServiceContext())->size(), 1UL);
+}
+
+TEST_F(ChangeStreamStageTest, ChangeStreamsDoNotShareEventsWhenCacheIsDisabled) {
+    const auto originalMaxBytes = internalChangeStreamEventCacheMaxBytes.load();
+    internalChangeStreamEventCacheMaxBytes.store(0);
+    ON_BLOCK_EXIT([&] { internalChangeStreamEventCacheMaxBytes.store(originalMaxBytes); });
+
+    OplogEntry insert(optime, 1, OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 1));
+    insert.setUuid(testUuid());
+
+    auto firstStages = makeStages(insert);
+    auto firstEvent = firstStages[2]->getNext();
+    auto secondStages = makeStages(insert);
+    auto secondEvent = secondStages[2]->getNext();
+
+    ASSERT_NE(firstEvent.getDocument().getPtr(), secondEvent.getDocument().getPtr());
+    ASSERT_DOCUMENT_EQ(firstEvent.getDocument(), secondEvent.getDocument());
+    ASSERT_EQ(ChangeStreamEventCache::get(getExpCtx()->opCtx->getServiceContext())->size(), 0UL);
+}
+
 TEST_F(ChangeStreamStageTest, TransformInsertFromMigrate) {
     OplogEntry insert(optime, 1, OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 1));
     insert.setFromMigrate(true);
@@ -466,5 +544,76 @@ TEST_F(ChangeStreamStageTest, CloseCursorOnRetryNeededEntries) {
         closeCursor->getNext(), CloseChangeStreamException, ErrorCodes::CloseChangeStream);
 }
 
+TEST_F(ChangeStreamStageTest, OperationTypeMatchIsPushedDownToOplogMatch) {
+    auto match =
+        makeOptimizedOplogMatch(fromjson("{operationType: {$in: ['insert', 'replace']}}"));
+
+    OplogEntry insert(optime, 1, OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 1));
+    OplogEntry replace(
+        optime, 2, OpTypeEnum::kUpdate, nss, BSON("_id" << 1 << "x" << 2), BSON("_id" << 1));
+    OplogEntry update(
+        optime, 3, OpTypeEnum::kUpdate, nss, BSON("$set" << BSON("x" << 3)), BSON("_id" << 1));
+    OplogEntry deleteEntry(optime, 4, OpTypeEnum::kDelete, nss, BSON("_id" << 1));
+    ASSERT_TRUE(oplogMatchAccepts(match, insert));
+    ASSERT_TRUE(oplogMatchAccepts(match, replace));
+    ASSERT_FALSE(oplogMatchAccepts(match, update));
+    ASSERT_FALSE(oplogMatchAccepts(match, deleteEntry));
+
+    // Entries which close the cursor are never filtered out.
+    ASSERT_TRUE(oplogMatchAccepts(match, createCommand(BSON("drop" << nss.coll()), testUuid())));
+}
+
+TEST_F(ChangeStreamStageTest, FullDocumentMatchIsPushedDownToOplogMatch) {
+    auto match = makeOptimizedOplogMatch(fromjson("{'fullDocument.x': {$gt: 1}, y: 1}"));
+
+    OplogEntry matchingInsert(optime, 1, OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 2));
+    OplogEntry otherInsert(optime, 2, OpTypeEnum::kInsert, nss, BSON("_id" << 2 << "x" << 1));
+    OplogEntry replace(
+        optime, 3, OpTypeEnum::kUpdate, nss, BSON("_id" << 1 << "x" << 2), BSON("_id" << 1));
+    OplogEntry update(
+        optime, 4, OpTypeEnum::kUpdate, nss, BSON("$set" << BSON("x" << 3)), BSON("_id" << 1));
+    OplogEntry deleteEntry(optime, 5, OpTypeEnum::kDelete, nss, BSON("_id" << 1));
+    ASSERT_TRUE(oplogMatchAccepts(match, matchingInsert));
+    ASSERT_FALSE(oplogMatchAccepts(match, otherInsert));
+    ASSERT_TRUE(oplogMatchAccepts(match, replace));
+    ASSERT_FALSE(oplogMatchAccepts(match, update));
+    ASSERT_FALSE(oplogMatchAccepts(match, deleteEntry));
+
+    // The full document of updates is only known once it has been looked up.
+    match = makeOptimizedOplogMatch(fromjson("{'fullDocument.x': {$gt: 1}}"),
+                                    fromjson("{fullDocument: 'updateLookup'}"));
+    ASSERT_FALSE(oplogMatchAccepts(match, otherInsert));
+    ASSERT_TRUE(oplogMatchAccepts(match, update));
+    ASSERT_FALSE(oplogMatchAccepts(match, deleteEntry));
+}
+
+TEST_F(ChangeStreamStageTest, DocumentKeyMatchIsPushedDownToOplogMatch) {
+    auto match = makeOptimizedOplogMatch(fromjson("{'documentKey._id': {$in: [2, 3]}}"));
+
+    OplogEntry insert(optime, 1, OpTypeEnum::kInsert, nss, BSON("_id" << 2));
+    OplogEntry update(
+        optime, 2, OpTypeEnum::kUpdate, nss, BSON("$set" << BSON("x" << 3)), BSON("_id" << 3));
+    OplogEntry otherUpdate(
+        optime, 3, OpTypeEnum::kUpdate, nss, BSON("$set" << BSON("x" << 3)), BSON("_id" << 1));
+    OplogEntry deleteEntry(optime, 4, OpTypeEnum::kDelete, nss, BSON("_id" << 1));
+    ASSERT_TRUE(oplogMatchAccepts(match, insert));
+    ASSERT_TRUE(oplogMatchAccepts(match, update));
+    ASSERT_FALSE(oplogMatchAccepts(match, otherUpdate));
+    ASSERT_FALSE(oplogMatchAccepts(match, deleteEntry));
+}
+
+TEST_F(ChangeStreamStageTest, PredicatesMatchingMissingFieldsAreNotPushedDown) {
+    OplogEntry deleteEntry(optime, 1, OpTypeEnum::kDelete, nss, BSON("_id" << 1));
+    ASSERT_TRUE(oplogMatchAccepts(makeOptimizedOplogMatch(fromjson("{'fullDocument.x': null}")),
+                                  deleteEntry));
+    ASSERT_TRUE(oplogMatchAccepts(
+        makeOptimizedOplogMatch(fromjson("{'fullDocument.x': {$in: [1, null]}}")), deleteEntry));
+    ASSERT_TRUE(oplogMatchAccepts(
+        makeOptimizedOplogMatch(fromjson("{'fullDocument.x': {$exists: false}}")), deleteEntry));
+    ASSERT_TRUE(oplogMatchAccepts(
+        makeOptimizedOplogMatch(fromjson("{$or: [{operationType: 'insert'}, {y: 1}]}")),
+        deleteEntry));
+}
+
 }  // namespace
 }  // namespace mongo
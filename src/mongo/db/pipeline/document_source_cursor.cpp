@@ -58,9 +58,21 @@ DocumentSource::GetNextResult DocumentSourceCursor::getNext() {
             return GetNextResult::makeEOF();
     }
 
-    Document out = std::move(_currentBatch.front());
+    // The batch holds the raw results of the query, and we only build a Document once it is
+    // actually requested. This keeps the conversion cost out of the collection lock and avoids it
+    // entirely for results that are never consumed.
+    BSONObj resultObj = std::move(_currentBatch.front());
     _currentBatch.pop_front();
-    return std::move(out);
+    return transformBSONObjToDocument(resultObj);
+}
+
+Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
+    if (_shouldProduceEmptyDocs) {
+        return Document();
+    } else if (_dependencies) {
+        return _dependencies->extractFields(obj);
+    }
+    return Document::fromBsonWithMetaData(obj);
 }
 
 void DocumentSourceCursor::loadBatch() {
@@ -82,11 +94,9 @@ void DocumentSourceCursor::loadBatch() {
 
             while ((state = _exec->getNext(&resultObj, nullptr)) == PlanExecutor::ADVANCED) {
                 if (_shouldProduceEmptyDocs) {
-                    _currentBatch.push_back(Document());
-                } else if (_dependencies) {
-                    _currentBatch.push_back(_dependencies->extractFields(resultObj));
+                    _currentBatch.push_back(BSONObj());
                 } else {
-                    _currentBatch.push_back(Document::fromBsonWithMetaData(resultObj));
+                    _currentBatch.push_back(resultObj.getOwned());
                 }
 
                 if (_limit) {
@@ -96,7 +106,7 @@ void DocumentSourceCursor::loadBatch() {
                     verify(_docsAddedToBatches < _limit->getLimit());
                 }
 
-                memUsageBytes += _currentBatch.back().getApproximateSize();
+                memUsageBytes += _currentBatch.back().objsize();
 
                 // As long as we're waiting for inserts, we shouldn't do any batching at this level
                 // we need the whole pipeline to see each document to see if we should stop waiting.
@@ -173,7 +173,14 @@ private:
 
     void recordPlanSummaryStats();
 
-    std::deque<Document> _currentBatch;
+    /**
+     * Builds the Document to return for a result of the query, materializing only the fields
+     * described by '_dependencies' when the pipeline's dependencies are known.
+     */
+    Document transformBSONObjToDocument(const BSONObj& obj) const;
+
+    // Owned results of the query which have not been converted to Documents yet.
+    std::deque<BSONObj> _currentBatch;
 
     // BSONObj members must outlive _projection and cursor.
     BSONObj _query;
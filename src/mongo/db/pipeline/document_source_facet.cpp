@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -44,9 +45,13 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -60,10 +65,15 @@ DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelin
     : DocumentSourceNeedsMongod(expCtx),
       _teeBuffer(TeeBuffer::create(facetPipelines.size())),
       _facets(std::move(facetPipelines)) {
+    stdx::unordered_set<ExpressionContext*> contexts{pExpCtx.get()};
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
+        const auto& facetExpCtx = facet.pipeline->getContext();
+        if (!contexts.insert(facetExpCtx.get()).second) {
+            _facetsHaveOwnContexts = false;
+        }
         facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer));
+            DocumentSourceTeeConsumer::create(facetExpCtx, facetId, _teeBuffer));
     }
 }
 
@@ -161,25 +171,118 @@ void DocumentSourceFacet::doDispose() {
     }
 }
 
-DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
-    pExpCtx->checkForInterrupt();
+namespace {
+/**
+ * Pulls results from 'pipeline' into 'results' until it pauses at the end of the TeeBuffer's
+ * current batch or is exhausted. Returns true if the pipeline is exhausted.
+ */
+bool consumeUntilPausedOrEOF(Pipeline* pipeline, vector<Value>* results) {
+    auto next = pipeline->getSources().back()->getNext();
+    for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+        results->emplace_back(next.releaseDocument());
+    }
+    return next.isEOF();
+}
+}  // namespace
 
-    if (_done) {
-        return GetNextResult::makeEOF();
+bool DocumentSourceFacet::canRunFacetsInParallel() const {
+    // Documents allocated in an arena have non-atomic reference counts, so they must not be shared
+    // with the worker threads.
+    if (!_facetsHaveOwnContexts || pExpCtx->documentArena) {
+        return false;
     }
 
-    vector<vector<Value>> results(_facets.size());
+    // Stages which need mongod use the OperationContext to read other collections, which may only
+    // be done on the thread which owns it.
+    for (auto&& facet : _facets) {
+        for (auto&& stage : facet.pipeline->getSources()) {
+            if (dynamic_cast<DocumentSourceNeedsMongod*>(stage.get())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DocumentSourceFacet::runFacetsSequentially(vector<vector<Value>>* results) {
     bool allPipelinesEOF = false;
     while (!allPipelinesEOF) {
         allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
         for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                results[facetId].emplace_back(next.releaseDocument());
+            const bool isEOF =
+                consumeUntilPausedOrEOF(_facets[facetId].pipeline.get(), &(*results)[facetId]);
+            allPipelinesEOF = allPipelinesEOF && isEOF;
+        }
+    }
+}
+
+void DocumentSourceFacet::runFacetsInParallel(vector<vector<Value>>* results, size_t nWorkers) {
+    ThreadPool::Options options;
+    options.poolName = "FacetWorkers";
+    options.minThreads = nWorkers;
+    options.maxThreads = nWorkers;
+    ThreadPool pool(std::move(options));
+    pool.startup();
+    ON_BLOCK_EXIT([&pool] {
+        pool.shutdown();
+        pool.join();
+    });
+
+    // Each task only writes to the entries for its own facet.
+    vector<char> isEOF(_facets.size(), false);
+    vector<Status> statuses(_facets.size(), Status::OK());
+    bool allPipelinesEOF = false;
+    while (!allPipelinesEOF) {
+        pExpCtx->checkForInterrupt();
+
+        // The source may be a $cursor stage reading from storage, so it is only touched here.
+        _teeBuffer->loadConcurrentBatch();
+        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+            if (isEOF[facetId]) {
+                continue;
             }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
+            auto pipeline = _facets[facetId].pipeline.get();
+            auto facetResults = &(*results)[facetId];
+            auto facetIsEOF = &isEOF[facetId];
+            auto facetStatus = &statuses[facetId];
+            auto scheduled = pool.schedule([pipeline, facetResults, facetIsEOF, facetStatus] {
+                try {
+                    *facetIsEOF = consumeUntilPausedOrEOF(pipeline, facetResults);
+                } catch (...) {
+                    *facetStatus = exceptionToStatus();
+                    *facetIsEOF = true;
+                }
+            });
+            if (!scheduled.isOK()) {
+                pool.waitForIdle();
+                _teeBuffer->finishConcurrentBatch();
+                uassertStatusOK(scheduled);
+            }
+        }
+        pool.waitForIdle();
+        _teeBuffer->finishConcurrentBatch();
+
+        for (auto&& status : statuses) {
+            uassertStatusOK(status);
         }
+        allPipelinesEOF = std::all_of(isEOF.begin(), isEOF.end(), [](char eof) { return eof; });
+    }
+}
+
+DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_done) {
+        return GetNextResult::makeEOF();
+    }
+
+    vector<vector<Value>> results(_facets.size());
+    const size_t nWorkers =
+        std::min(_facets.size(), size_t(std::max(1, internalQueryFacetMaxWorkerThreads.load())));
+    if (nWorkers > 1 && canRunFacetsInParallel()) {
+        runFacetsInParallel(&results, nWorkers);
+    } else {
+        runFacetsSequentially(&results);
     }
 
     MutableDocument resultDoc;
@@ -281,11 +384,19 @@ DocumentSource::GetDepsReturn DocumentSourceFacet::getDependencies(DepsTracker*
 intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     BSONElement elem, const intrusive_ptr<ExpressionContext>& expCtx) {
 
+    // The sub-pipelines may only be run concurrently if each has its own ExpressionContext. Any
+    // variables defined by an enclosing pipeline live in 'expCtx', so then they must share it.
+    const bool parseForParallelism = internalQueryFacetMaxWorkerThreads.load() > 1 &&
+        !expCtx->documentArena && !expCtx->variablesParseState.hasDefinedVariables();
+
     std::vector<FacetPipeline> facetPipelines;
     for (auto&& rawFacet : extractRawPipelines(elem)) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, expCtx));
+        auto facetExpCtx =
+            parseForParallelism ? expCtx->copyWith(expCtx->ns, expCtx->uuid) : expCtx;
+        auto pipeline =
+            uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, facetExpCtx));
 
         facetPipelines.emplace_back(facetName, std::move(pipeline));
     }
@@ -54,6 +54,10 @@ class NamespaceString;
  * For example, {$facet: {facetA: [{$skip: 1}], facetB: [{$limit: 1}]}} would describe a $facet
  * stage which will produce a document like the following:
  * {facetA: [<all input documents except the first one>], facetB: [<the first document>]}.
+ *
+ * If 'internalQueryFacetMaxWorkerThreads' is greater than one when the stage is parsed, each
+ * sub-pipeline gets its own ExpressionContext, and the sub-pipelines may then consume each batch of
+ * input concurrently on a pool of worker threads.
  */
 class DocumentSourceFacet final : public DocumentSourceNeedsMongod,
                                   public SplittableDocumentSource {
@@ -146,9 +150,27 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if the sub-pipelines can safely be run on threads other than the one which owns
+     * the OperationContext.
+     */
+    bool canRunFacetsInParallel() const;
+
+    /**
+     * Feeds the input to every sub-pipeline, collecting each sub-pipeline's results into the
+     * corresponding entry of 'results'. The parallel version pulls each batch from the source on
+     * this thread, then lets up to 'nWorkers' threads run the sub-pipelines over it.
+     */
+    void runFacetsSequentially(std::vector<std::vector<Value>>* results);
+    void runFacetsInParallel(std::vector<std::vector<Value>>* results, size_t nWorkers);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
+    // True if no two sub-pipelines, nor this stage and any sub-pipeline, share an
+    // ExpressionContext, since the variables and interrupt counter it holds are not thread-safe.
+    bool _facetsHaveOwnContexts = true;
+
     bool _done = false;
 };
 }  // namespace mongo
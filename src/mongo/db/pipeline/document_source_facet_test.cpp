@@ -43,8 +43,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -349,6 +351,50 @@ TEST_F(DocumentSourceFacetTest, ShouldPropagateDisposeThroughToSource) {
     ASSERT_TRUE(mockSource->isDisposed);
 }
 
+TEST_F(DocumentSourceFacetTest, ShouldProduceSameResultsWhenRunningFacetsInParallel) {
+    auto ctx = getExpCtx();
+
+    // Parse with several worker threads and a small buffer, so that the sub-pipelines get their own
+    // ExpressionContexts and run concurrently over several batches.
+    const auto originalMaxWorkerThreads = internalQueryFacetMaxWorkerThreads.load();
+    const auto originalBufferSizeBytes = internalQueryFacetBufferSizeBytes.load();
+    internalQueryFacetMaxWorkerThreads.store(4);
+    internalQueryFacetBufferSizeBytes.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalQueryFacetMaxWorkerThreads.store(originalMaxWorkerThreads);
+        internalQueryFacetBufferSizeBytes.store(originalBufferSizeBytes);
+    });
+
+    deque<DocumentSource::GetNextResult> inputs;
+    vector<Value> expectedAll;
+    for (int i = 0; i < 100; ++i) {
+        inputs.emplace_back(Document{{"_id", i}, {"a", i % 3}});
+        expectedAll.emplace_back(inputs.back().getDocument());
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+
+    auto spec = fromjson(
+        "{$facet: {all: [{$match: {}}], skipped: [{$skip: 98}], limited: [{$limit: 2}], "
+        "projected: [{$match: {a: 0}}, {$project: {_id: 0, b: {$let: {vars: {x: '$a'}, "
+        "in: '$$x'}}}}, {$limit: 1}]}}");
+    auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    facetStage->setSource(mock.get());
+
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT_VALUE_EQ(output.getDocument()["all"], Value(expectedAll));
+    ASSERT_VALUE_EQ(output.getDocument()["skipped"],
+                    Value(vector<Value>{expectedAll[98], expectedAll[99]}));
+    ASSERT_VALUE_EQ(output.getDocument()["limited"],
+                    Value(vector<Value>{expectedAll[0], expectedAll[1]}));
+    ASSERT_VALUE_EQ(output.getDocument()["projected"],
+                    Value(vector<Value>{Value(Document{{"b", 0}})}));
+    ASSERT(facetStage->getNext().isEOF());
+
+    facetStage->dispose();
+    ASSERT_TRUE(mock->isDisposed);
+}
+
 // TODO: DocumentSourceFacet will have to propagate pauses if we ever allow nested $facets.
 DEATH_TEST_F(DocumentSourceFacetTest,
              ShouldFailIfGivenPausedInput,
@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -104,18 +105,14 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (hasMoreVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popNextVisited()));
     }
 
     MutableDocument output(*_input);
     output.setNestedField(_as, Value(std::move(results)));
 
-    _visitedUsageBytes = 0;
-
     invariant(_visited.empty());
 
     return output.freeze();
@@ -127,7 +124,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!hasMoreVisited()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -138,12 +135,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
 
             _input = input.releaseDocument();
             performSearch();
-            _visitedUsageBytes = 0;
             _outputIndex = 0;
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!hasMoreVisited()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -157,23 +153,47 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popNextVisited()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
     }
 }
 
+Document DocumentSourceGraphLookUp::popNextVisited() {
+    invariant(hasMoreVisited());
+
+    Document result;
+    if (!_visited.empty()) {
+        auto it = _visited.begin();
+        result = std::move(it->second);
+        _visited.erase(it);
+    } else {
+        auto& spilled = _spilledVisited.back();
+        invariant(spilled->more());
+        result = spilled->next().second;
+        if (!spilled->more()) {
+            _spilledVisited.pop_back();
+        }
+    }
+
+    if (!hasMoreVisited()) {
+        _spilledVisitedIds.clear();
+        _visitedUsageBytes = 0;
+    }
+    return result;
+}
+
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _spilledVisited.clear();
+    _spilledVisitedIds.clear();
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -232,7 +252,8 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() ||
+        _spilledVisitedIds.find(id) != _spilledVisitedIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -387,13 +408,29 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if ((_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes &&
+        pExpCtx->extSortAllowed && !_visited.empty()) {
+        spillVisited();
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spillVisited() {
+    // The results of a search are returned in no particular order, so they need not be sorted.
+    SortedFileWriter<Value, Document> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    for (auto&& visited : _visited) {
+        writer.addAlreadySorted(visited.first, visited.second);
+        _visitedUsageBytes -= visited.second.getApproximateSize();
+        _spilledVisitedIds.insert(visited.first);
+    }
+    _visited.clear();
+    _spilledVisited.emplace_back(writer.done());
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -463,8 +500,10 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledVisitedIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
@@ -606,3 +645,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -152,10 +153,31 @@ private:
 
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'. If disk use
+     * is allowed, spills the documents in '_visited' to disk before giving up.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to a file, keeping only their _ids in memory so that they
+     * are not discovered again.
+     */
+    void spillVisited();
+
+    /**
+     * Returns true if there are results of the current search that have not yet been returned by
+     * popNextVisited().
+     */
+    bool hasMoreVisited() const {
+        return !_visited.empty() || !_spilledVisited.empty();
+    }
+
+    /**
+     * Removes and returns one of the results of the current search, from memory or from disk. Once
+     * every result has been returned, resets the state used to track the current search.
+     */
+    Document popNextVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -181,7 +203,7 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    const size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -195,6 +217,11 @@ private:
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // The _ids of the documents discovered for the current input which have been spilled to disk
+    // rather than kept in '_visited', and the files they were spilled to.
+    ValueUnorderedSet _spilledVisitedIds;
+    std::vector<std::unique_ptr<SortIteratorInterface<Value, Document>>> _spilledVisited;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
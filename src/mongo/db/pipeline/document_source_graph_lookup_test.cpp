@@ -37,9 +37,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongod_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -256,6 +259,90 @@ TEST_F(DocumentSourceGraphLookUpTest,
     }
 }
 
+/**
+ * Returns the contents of a 'from' collection forming a chain in which each document connects to
+ * the next, with a payload to make the documents take up memory.
+ */
+std::deque<DocumentSource::GetNextResult> makeChainOfDocuments(int length) {
+    const std::string payload(100, 'x');
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (int i = 0; i < length; ++i) {
+        fromContents.emplace_back(
+            Document{{"_id", i}, {"to", i}, {"from", i + 1}, {"payload", payload}});
+    }
+    return fromContents;
+}
+
+boost::intrusive_ptr<DocumentSourceGraphLookUp> makeChainGraphLookup(
+    const boost::intrusive_ptr<ExpressionContextForTest>& expCtx) {
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    return DocumentSourceGraphLookUp::create(expCtx,
+                                             fromNs,
+                                             "results",
+                                             "from",
+                                             "to",
+                                             ExpressionFieldPath::create(expCtx, "_id"),
+                                             boost::none,
+                                             boost::none,
+                                             boost::none,
+                                             boost::none);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldFailWhenExceedingMemoryLimitWithoutDiskUse) {
+    auto expCtx = getExpCtx();
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(2 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}});
+    auto graphLookupStage = makeChainGraphLookup(expCtx);
+    graphLookupStage->setSource(inputMock.get());
+    graphLookupStage->injectMongodInterface(
+        std::make_shared<MockMongodImplementation>(makeChainOfDocuments(100)));
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillDiscoveredDocumentsToDiskWhenAllowed) {
+    auto expCtx = getExpCtx();
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(2 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->extSortAllowed = true;
+
+    const int chainLength = 100;
+    auto inputMock = DocumentSourceMock::create({Document{{"_id", 0}}, Document{{"_id", 50}}});
+    auto graphLookupStage = makeChainGraphLookup(expCtx);
+    graphLookupStage->setSource(inputMock.get());
+    graphLookupStage->injectMongodInterface(
+        std::make_shared<MockMongodImplementation>(makeChainOfDocuments(chainLength)));
+
+    // Each input should discover every document from its _id to the end of the chain, exactly
+    // once, even though they could not all be held in memory.
+    for (int start : {0, 50}) {
+        auto next = graphLookupStage->getNext();
+        ASSERT(next.isAdvanced());
+        auto results = next.getDocument()["results"];
+        ASSERT(results.isArray());
+
+        std::vector<int> ids;
+        for (auto&& result : results.getArray()) {
+            ids.push_back(result.getDocument()["_id"].getInt());
+        }
+        std::sort(ids.begin(), ids.end());
+        ASSERT_EQ(ids.size(), static_cast<size_t>(chainLength - start));
+        for (size_t i = 0; i < ids.size(); ++i) {
+            ASSERT_EQ(ids[i], start + static_cast<int>(i));
+        }
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceGraphLookUpTest, ShouldPropagatePauses) {
     auto expCtx = getExpCtx();
 
@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -81,26 +82,17 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
     // We aren't streaming, and we have spilled to disk.
+    if (_numSpillPartitions > 0)
+        return getNextPartitioned();
+
     if (!_sorterIterator)
         return GetNextResult::makeEOF();
 
     _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
     while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
         // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
         // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
-                }
-            }
-        }
+        mergeSpilledState(_firstPartOfNextGroup.second, &_currentAccumulators);
 
         if (!_sorterIterator->more()) {
             dispose();
@@ -113,6 +105,24 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
     return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
 }
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextPartitioned() {
+    while (groupsIterator == _groups->end()) {
+        if (_pendingSpillPartitions.empty()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+
+        // This may leave '_groups' empty if the partition had to be split again, in which case we
+        // move on to the first of the new partitions.
+        loadNextSpillPartition();
+        groupsIterator = _groups->begin();
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    ++groupsIterator;
+    return std::move(out);
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     // Not spilled, and not streaming.
     if (_groups->empty())
@@ -144,6 +154,11 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
                 _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup), _doingMerge);
         }
 
+        // Release the document before retrieving the next one, so that we do not force the stage
+        // before us to copy data it would otherwise modify in place, as $unwind does when it
+        // produces each element of an array.
+        _firstDocOfNextGroup = boost::none;
+
         // Retrieve the next document.
         auto nextInput = pSource->getNext();
         if (!nextInput.isAdvanced()) {
@@ -168,6 +183,10 @@ void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _spillPartitionWriters.clear();
+    _spillPartitionSizes.clear();
+    _pendingSpillPartitions.clear();
+    _memoryCharge.set(0);
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -266,6 +285,7 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
+      _numSpillPartitions(std::max(0, internalDocumentSourceGroupSpillPartitions.load())),
       _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inMongos) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
@@ -359,6 +379,22 @@ namespace {
 
 using GroupsMap = DocumentSourceGroup::GroupsMap;
 
+// A spill partition which is still too large after this many rounds of partitioning most likely
+// holds a few groups which are individually large, so we stop splitting it and aggregate it in
+// memory regardless.
+const int kMaxSpillPartitionDepth = 4;
+
+/**
+ * Scrambles 'hash' differently for each 'depth', so that the groups of a partition which is split
+ * again are spread over all of the new partitions rather than landing in just one of them.
+ */
+uint64_t partitionHash(size_t hash, int depth) {
+    uint64_t h = static_cast<uint64_t>(hash) + 0x9e3779b97f4a7c15ULL * (depth + 1);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
 class SorterComparator {
 public:
     typedef pair<Value, Value> Data;
@@ -486,8 +522,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                     "Exceeded memory limit for $group, but didn't allow external sort."
                     " Pass allowDiskUse:true to opt in.",
                     _extSortAllowed);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
+            spillGroups(0);
         }
 
         // We release the result document here so that it does not outlive the end of this loop
@@ -526,15 +561,16 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
             _memoryUsageBytes += group[i]->memUsageForSorter();
         }
+        _memoryCharge.set(_memoryUsageBytes);
 
         if (kDebugBuild && !storageGlobalParams.readOnly) {
             // In debug mode, spill every time we have a duplicate id to stress merge logic.
             if (!inserted &&                 // is a dup
                 !pExpCtx->inMongos &&        // can't spill to disk in mongos
                 !_extSortAllowed &&          // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+                _numSpills < 20) {           // don't open too many FDs
 
-                _sortedFiles.push_back(spill());
+                spillGroups(0);
             }
         }
     }
@@ -548,7 +584,17 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (_numSpills > 0 && _numSpillPartitions > 0) {
+                _spilled = true;
+
+                // The groups still in memory may have partial state in the partitions on disk, so
+                // they are spilled too and everything is re-aggregated one partition at a time.
+                if (!_groups->empty()) {
+                    spillToPartitions(0);
+                }
+                finishSpillPartitions();
+                groupsIterator = _groups->end();
+            } else if (_numSpills > 0) {
                 _spilled = true;
                 if (!_groups->empty()) {
                     _sortedFiles.push_back(spill());
@@ -592,34 +638,201 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
 
     SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        writer.addAlreadySorted(ptrs[i]->first, serializeForSpill(ptrs[i]->second));
+    }
+
+    _groups->clear();
+
+    return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
+}
+
+void DocumentSourceGroup::spillGroups(int depth) {
+    if (_numSpillPartitions > 0) {
+        spillToPartitions(depth);
+    } else {
+        _sortedFiles.push_back(spill());
+    }
+    _memoryUsageBytes = 0;
+    _memoryCharge.set(0);
+    ++_numSpills;
+}
+
+void DocumentSourceGroup::spillToPartitions(int depth) {
+    if (_spillPartitionWriters.empty()) {
+        _spillPartitionWritersDepth = depth;
+        for (int i = 0; i < _numSpillPartitions; i++) {
+            _spillPartitionWriters.push_back(stdx::make_unique<SortedFileWriter<Value, Value>>(
+                SortOptions().TempDir(pExpCtx->tempDir)));
+        }
+        _spillPartitionSizes.assign(_numSpillPartitions, 0);
+    }
+    invariant(_spillPartitionWritersDepth == depth);
+
+    const auto& valueComparator = pExpCtx->getValueComparator();
+    for (auto&& group : *_groups) {
+        const size_t partition =
+            partitionHash(valueComparator.hash(group.first), depth) % _numSpillPartitions;
+
+        // Partition files are only ever read back from start to finish, so unlike the runs written
+        // by spill() the groups in them need not be sorted.
+        _spillPartitionWriters[partition]->addAlreadySorted(group.first,
+                                                            serializeForSpill(group.second));
+        ++_spillPartitionSizes[partition];
+    }
+
+    _groups->clear();
+}
+
+void DocumentSourceGroup::finishSpillPartitions() {
+    for (size_t i = 0; i < _spillPartitionWriters.size(); i++) {
+        // There is nothing to read back from an empty partition, and its file is removed when the
+        // writer is destroyed.
+        if (_spillPartitionSizes[i] > 0) {
+            _pendingSpillPartitions.push_back(
+                {shared_ptr<Sorter<Value, Value>::Iterator>(_spillPartitionWriters[i]->done()),
+                 _spillPartitionWritersDepth});
+        }
+    }
+    _spillPartitionWriters.clear();
+    _spillPartitionSizes.clear();
+}
+
+void DocumentSourceGroup::loadNextSpillPartition() {
+    invariant(!_pendingSpillPartitions.empty());
+    invariant(_groups->empty());
+
+    SpillPartition partition = std::move(_pendingSpillPartitions.back());
+    _pendingSpillPartitions.pop_back();
+
+    const size_t numAccumulators = _accumulatedFields.size();
+    const bool canSplit = partition.depth < kMaxSpillPartitionDepth;
+    bool wasSplit = false;
+    _memoryUsageBytes = 0;
+
+    while (partition.iterator->more()) {
+        if (canSplit && _memoryUsageBytes > _maxMemoryUsageBytes) {
+            spillGroups(partition.depth + 1);
+            wasSplit = true;
+        }
+
+        auto spilledGroup = partition.iterator->next();
+
+        const size_t oldSize = _groups->size();
+        Accumulators& group = (*_groups)[spilledGroup.first];
+        if (_groups->size() != oldSize) {
+            _memoryUsageBytes += spilledGroup.first.getApproximateSize();
+
+            group.reserve(numAccumulators);
+            for (auto&& accumulatedField : _accumulatedFields) {
+                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+            }
+        } else {
+            for (auto&& accumulator : group) {
+                _memoryUsageBytes -= accumulator->memUsageForSorter();
             }
+        }
+
+        mergeSpilledState(spilledGroup.second, &group);
+
+        for (auto&& accumulator : group) {
+            _memoryUsageBytes += accumulator->memUsageForSorter();
+        }
+        _memoryCharge.set(_memoryUsageBytes);
+    }
+
+    if (wasSplit) {
+        spillToPartitions(partition.depth + 1);
+        finishSpillPartitions();
+    }
+}
+
+void DocumentSourceGroup::mergeSpilledState(const Value& accumulatorStates,
+                                            Accumulators* accumulators) {
+    switch (_accumulatedFields.size()) {  // mirrors switch in serializeForSpill()
+        case 1:                           // Single accumulators serialize as a single Value.
+            (*accumulators)[0]->process(accumulatorStates, true);
+        case 0:  // No accumulators so no Values.
             break;
+        default: {  // Multiple accumulators serialize as an array of Values.
+            const vector<Value>& states = accumulatorStates.getArray();
+            for (size_t i = 0; i < accumulators->size(); i++) {
+                (*accumulators)[i]->process(states[i], true);
+            }
+        }
+    }
+}
+
+Value DocumentSourceGroup::serializeForSpill(const Accumulators& accumulators) {
+    switch (_accumulatedFields.size()) {  // same as accumulators.size()
+        case 0:                           // no values, essentially a distinct
+            return Value();
 
         case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
-            }
-            break;
+            return accumulators[0]->getValue(/*toBeMerged=*/true);
 
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
-                }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+        default: {  // multiple values, serialize as array-typed Value
+            vector<Value> states;
+            states.reserve(accumulators.size());
+            for (auto&& accumulator : accumulators) {
+                states.push_back(accumulator->getValue(/*toBeMerged=*/true));
             }
-            break;
+            return Value(std::move(states));
+        }
     }
+}
 
-    _groups->clear();
+namespace {
 
-    return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
+/**
+ * Returns the path of the field 'expression' refers to, if it is a field path rooted at the
+ * document being grouped.
+ */
+boost::optional<std::string> getRootedFieldPath(const intrusive_ptr<Expression>& expression) {
+    if (!dynamic_cast<ExpressionFieldPath*>(expression.get())) {
+        return boost::none;
+    }
+    DepsTracker deps(DepsTracker::MetadataAvailable::kNoMetadata);
+    expression->addDependencies(&deps);
+    if (deps.needWholeDocument || !deps.vars.empty() || deps.fields.size() != 1) {
+        return boost::none;
+    }
+    return *deps.fields.begin();
+}
+
+}  // namespace
+
+boost::optional<DocumentSourceGroup::OneDocumentPerGroup>
+DocumentSourceGroup::canComputeFromOneDocumentPerGroup() const {
+    if (_doingMerge || _idExpressions.size() != 1 || !_idFieldNames.empty()) {
+        return boost::none;
+    }
+    auto groupKeyPath = getRootedFieldPath(_idExpressions.front());
+    if (!groupKeyPath) {
+        return boost::none;
+    }
+
+    OneDocumentPerGroup result;
+    result.groupKeyPath = *groupKeyPath;
+    bool needsFirstDocument = false;
+    for (auto&& accumulatedField : _accumulatedFields) {
+        const StringData opName = accumulatedField.makeAccumulator(pExpCtx)->getOpName();
+        if (opName == "$first"_sd) {
+            needsFirstDocument = true;
+        } else if (opName == "$last"_sd) {
+            result.needsLastDocument = true;
+        } else if (opName != "$min"_sd && opName != "$max"_sd) {
+            return boost::none;
+        } else if (getRootedFieldPath(accumulatedField.expression) != groupKeyPath) {
+            // The group key is the same in every document of the group, but other values are not.
+            return boost::none;
+        }
+    }
+    if (needsFirstDocument && result.needsLastDocument) {
+        return boost::none;
+    }
+    result.dependsOnOrder = needsFirstDocument || result.needsLastDocument;
+    return result;
 }
 
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
@@ -695,7 +908,9 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
                        // False negatives are OK.
     }
 
-    if (!(_streaming || _spilled)) {
+    // Groups spilled into hash partitions come back in no particular order.
+    const bool spilledSorted = _spilled && _numSpillPartitions == 0;
+    if (!(_streaming || spilledSorted)) {
         return SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     }
 
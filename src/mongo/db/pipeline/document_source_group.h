@@ -35,6 +35,7 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/util/memory_accounting.h"
 
 namespace mongo {
 
@@ -90,6 +91,28 @@ public:
         return _streaming;
     }
 
+    /**
+     * Describes how this $group can be computed from a single document of each group, such as the
+     * first index entry of each distinct value of the group key returned by a DISTINCT_SCAN.
+     */
+    struct OneDocumentPerGroup {
+        // The path of the field whose value is the group key.
+        std::string groupKeyPath;
+
+        // Whether the result depends on which document of a group is used. If so, it must be the
+        // first in the order of the input, or the last if 'needsLastDocument' is true.
+        bool dependsOnOrder = false;
+        bool needsLastDocument = false;
+    };
+
+    /**
+     * Returns how this $group can be computed from a single document of each group, or
+     * boost::none if it needs all of them. That is the case when the group key is a field path
+     * and the accumulators are either all $first or all $last, along with any $min or $max of the
+     * group key itself.
+     */
+    boost::optional<OneDocumentPerGroup> canComputeFromOneDocumentPerGroup() const;
+
     // Virtuals for SplittableDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     boost::intrusive_ptr<DocumentSource> getMergeSource() final;
@@ -110,6 +133,13 @@ private:
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
 
+    /**
+     * Used by getNextSpilled() when the groups were spilled into hash partitions rather than
+     * sorted runs. Returns the groups of one partition at a time, re-aggregating the next pending
+     * partition into '_groups' whenever the previous one has been returned.
+     */
+    GetNextResult getNextPartitioned();
+
     /**
      * Attempt to identify an input sort order that allows us to turn into a streaming $group. If we
      * find one, return it. Otherwise, return boost::none.
@@ -135,6 +165,43 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Spills '_groups' to disk, either as a sorted run or, if '_numSpillPartitions' is non-zero,
+     * by appending each group to the hash partition for its key at the given depth of
+     * re-partitioning.
+     */
+    void spillGroups(int depth);
+
+    /**
+     * Appends the partially accumulated state of every group in '_groups' to the partition files
+     * for 'depth', creating them if necessary, and clears '_groups'.
+     */
+    void spillToPartitions(int depth);
+
+    /**
+     * Closes the partition files being written and queues the non-empty ones to be re-aggregated.
+     */
+    void finishSpillPartitions();
+
+    /**
+     * Re-aggregates the next pending spill partition into '_groups'. If the partition does not
+     * fit in memory it is split into partitions one level deeper, which are queued in its place,
+     * and '_groups' is left empty.
+     */
+    void loadNextSpillPartition();
+
+    /**
+     * Merges the spilled state 'accumulatorStates' of a single group, as written by spill() or
+     * spillToPartitions(), into 'accumulators'.
+     */
+    void mergeSpilledState(const Value& accumulatorStates, Accumulators* accumulators);
+
+    /**
+     * Serializes the partially accumulated state of 'accumulators' for spilling. A single
+     * accumulator is serialized as its own Value, and multiple accumulators as an array.
+     */
+    Value serializeForSpill(const Accumulators& accumulators);
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -152,6 +219,7 @@ private:
 
     bool _doingMerge;
     size_t _memoryUsageBytes = 0;
+    MemoryAccount::Charge _memoryCharge{&memory_accounts::aggregation};
     size_t _maxMemoryUsageBytes;
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
@@ -170,8 +238,29 @@ private:
 
     std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
     bool _spilled;
+    size_t _numSpills = 0;
+
+    // The number of hash partitions to spill into, or 0 to spill sorted runs instead.
+    const int _numSpillPartitions;
+
+    // A partition of spilled groups waiting to be re-aggregated. 'depth' counts how many times
+    // the groups in it have been partitioned.
+    struct SpillPartition {
+        std::shared_ptr<Sorter<Value, Value>::Iterator> iterator;
+        int depth;
+    };
+
+    // The partition files currently being written, all at depth '_spillPartitionWritersDepth',
+    // along with the number of groups written to each.
+    std::vector<std::unique_ptr<SortedFileWriter<Value, Value>>> _spillPartitionWriters;
+    std::vector<size_t> _spillPartitionSizes;
+    int _spillPartitionWritersDepth = 0;
+
+    // Partitions still to be re-aggregated, used as a stack so that a partition which is split
+    // again is finished before moving on to its siblings.
+    std::vector<SpillPartition> _pendingSpillPartitions;
 
-    // Only used when '_spilled' is false.
+    // Only used when '_spilled' is false, or when the groups were spilled into partitions.
     GroupsMap::iterator groupsIterator;
 
     // Only used when '_spilled' is true.
@@ -47,12 +47,14 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -189,6 +191,144 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     ASSERT_THROWS_CODE(group->getNext(), AssertionException, 16945);
 }
 
+/**
+ * Groups 'numDocs' documents into 'numGroups' groups by {_id: {$mod: ["$n", numGroups]}}, computing
+ * a $sum, an $avg and an $addToSet for each, with 'numSpillPartitions' hash partitions and a
+ * memory limit small enough that the $group must spill. Returns the groups keyed by _id.
+ */
+map<int, Document> groupWithSpilling(const intrusive_ptr<ExpressionContextForTest>& expCtx,
+                                     int numDocs,
+                                     int numGroups,
+                                     int numSpillPartitions) {
+    const int originalNumSpillPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(numSpillPartitions);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGroupSpillPartitions.store(originalNumSpillPartitions); });
+
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->extSortAllowed = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto groupByExpression = Expression::parseOperand(
+        expCtx, BSON("_id" << BSON("$mod" << BSON_ARRAY("$n" << numGroups))).firstElement(), vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx,
+        groupByExpression,
+        {{"sum",
+          ExpressionFieldPath::parse(expCtx, "$n", vps),
+          AccumulationStatement::getFactory("$sum")},
+         {"avg",
+          ExpressionFieldPath::parse(expCtx, "$n", vps),
+          AccumulationStatement::getFactory("$avg")},
+         {"set",
+          ExpressionFieldPath::parse(expCtx, "$parity", vps),
+          AccumulationStatement::getFactory("$addToSet")}},
+        maxMemoryUsageBytes);
+
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int n = 0; n < numDocs; n++) {
+        inputs.emplace_back(Document{{"n", n}, {"parity", n % 2}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    map<int, Document> results;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_TRUE(results.emplace(doc["_id"].coerceToInt(), doc).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    return results;
+}
+
+void assertGroupsCorrect(const map<int, Document>& results, int numDocs, int numGroups) {
+    ASSERT_EQ(results.size(), static_cast<size_t>(numGroups));
+    for (auto&& result : results) {
+        const int key = result.first;
+        long long sum = 0;
+        int count = 0;
+        stdx::unordered_set<int> parities;
+        for (int n = key; n < numDocs; n += numGroups) {
+            sum += n;
+            ++count;
+            parities.insert(n % 2);
+        }
+        ASSERT_VALUE_EQ(result.second["sum"], Value(sum));
+        ASSERT_VALUE_EQ(result.second["avg"], Value(static_cast<double>(sum) / count));
+        ASSERT_EQ(result.second["set"].getArrayLength(), parities.size());
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldMergePartialStateAcrossHashPartitionedSpills) {
+    const int numDocs = 2000;
+    const int numGroups = 200;
+    auto results = groupWithSpilling(getExpCtx(), numDocs, numGroups, 16);
+    assertGroupsCorrect(results, numDocs, numGroups);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldSplitSpillPartitionsWhichDoNotFitInMemory) {
+    // With only two partitions, each holds far more groups than fit in memory, so they have to be
+    // partitioned again when they are read back.
+    const int numDocs = 2000;
+    const int numGroups = 500;
+    auto results = groupWithSpilling(getExpCtx(), numDocs, numGroups, 2);
+    assertGroupsCorrect(results, numDocs, numGroups);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldProduceSameGroupsWhenSpillingSortedRuns) {
+    const int numDocs = 2000;
+    const int numGroups = 200;
+    auto results = groupWithSpilling(getExpCtx(), numDocs, numGroups, 0);
+    assertGroupsCorrect(results, numDocs, numGroups);
+}
+
+boost::optional<DocumentSourceGroup::OneDocumentPerGroup> canComputeFromOneDocumentPerGroup(
+    const intrusive_ptr<ExpressionContextForTest>& expCtx, const BSONObj& spec) {
+    BSONObj groupSpec = BSON("$group" << spec);
+    auto group = DocumentSourceGroup::createFromBson(groupSpec.firstElement(), expCtx);
+    return static_cast<DocumentSourceGroup*>(group.get())->canComputeFromOneDocumentPerGroup();
+}
+
+TEST_F(DocumentSourceGroupTest, CanComputeGroupOfFirstOrLastDocumentsFromOneDocumentPerGroup) {
+    auto first = canComputeFromOneDocumentPerGroup(
+        getExpCtx(), fromjson("{_id: '$a.b', x: {$first: '$x'}, y: {$first: '$$ROOT'}}"));
+    ASSERT(first);
+    ASSERT_EQ(first->groupKeyPath, "a.b");
+    ASSERT_TRUE(first->dependsOnOrder);
+    ASSERT_FALSE(first->needsLastDocument);
+
+    auto last = canComputeFromOneDocumentPerGroup(
+        getExpCtx(), fromjson("{_id: '$a', x: {$last: '$x'}, min: {$min: '$a'}}"));
+    ASSERT(last);
+    ASSERT_EQ(last->groupKeyPath, "a");
+    ASSERT_TRUE(last->dependsOnOrder);
+    ASSERT_TRUE(last->needsLastDocument);
+
+    auto keysOnly = canComputeFromOneDocumentPerGroup(
+        getExpCtx(), fromjson("{_id: '$a', min: {$min: '$a'}, max: {$max: '$a'}}"));
+    ASSERT(keysOnly);
+    ASSERT_FALSE(keysOnly->dependsOnOrder);
+    ASSERT(canComputeFromOneDocumentPerGroup(getExpCtx(), fromjson("{_id: '$a'}")));
+}
+
+TEST_F(DocumentSourceGroupTest, CannotComputeGroupNeedingAllDocumentsFromOneDocumentPerGroup) {
+    ASSERT_FALSE(canComputeFromOneDocumentPerGroup(
+        getExpCtx(), fromjson("{_id: '$a', x: {$first: '$x'}, y: {$last: '$y'}}")));
+    ASSERT_FALSE(canComputeFromOneDocumentPerGroup(
+        getExpCtx(), fromjson("{_id: '$a', x: {$first: '$x'}, n: {$sum: 1}}")));
+    ASSERT_FALSE(canComputeFromOneDocumentPerGroup(getExpCtx(),
+                                                   fromjson("{_id: '$a', x: {$min: '$x'}}")));
+    ASSERT_FALSE(canComputeFromOneDocumentPerGroup(
+        getExpCtx(), fromjson("{_id: {a: '$a'}, x: {$first: '$x'}}")));
+    ASSERT_FALSE(canComputeFromOneDocumentPerGroup(
+        getExpCtx(), fromjson("{_id: {$toLower: '$a'}, x: {$first: '$x'}}")));
+    ASSERT_FALSE(canComputeFromOneDocumentPerGroup(getExpCtx(),
+                                                   fromjson("{_id: '$$ROOT', x: {$first: '$x'}}")));
+    ASSERT_FALSE(canComputeFromOneDocumentPerGroup(getExpCtx(), fromjson("{_id: null}")));
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
@@ -0,0 +1,179 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::string timeField,
+    std::string metaField)
+    : DocumentSource(expCtx),
+      _timeField(timeField),
+      _metaField(metaField),
+      _unpacker(std::move(timeField), std::move(metaField)) {}
+
+boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> DocumentSourceInternalUnpackBucket::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::string timeField,
+    std::string metaField) {
+    return new DocumentSourceInternalUnpackBucket(
+        expCtx, std::move(timeField), std::move(metaField));
+}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(40668,
+            str::stream() << "$_internalUnpackBucket must take a nested object but found: "
+                          << elem,
+            elem.type() == BSONType::Object);
+
+    std::string timeField;
+    std::string metaField;
+    for (auto&& option : elem.embeddedObject()) {
+        const auto fieldName = option.fieldNameStringData();
+        uassert(40669,
+                str::stream() << "Unrecognized option to $_internalUnpackBucket: " << option,
+                fieldName == "timeField" || fieldName == "metaField");
+        uassert(40670,
+                str::stream() << "$_internalUnpackBucket option '" << fieldName
+                              << "' must be a string but found: "
+                              << option,
+                option.type() == BSONType::String);
+        (fieldName == "timeField" ? timeField : metaField) = option.String();
+    }
+    uassert(40671, "$_internalUnpackBucket requires a 'timeField'", !timeField.empty());
+
+    return create(expCtx, std::move(timeField), std::move(metaField));
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (!_unpacker.hasNext()) {
+        auto next = pSource->getNext();
+        if (!next.isAdvanced()) {
+            return next;
+        }
+        _unpacker.reset(next.releaseDocument().toBson());
+    }
+    return Document(_unpacker.getNext());
+}
+
+BSONObj DocumentSourceInternalUnpackBucket::makeBucketPredicate(const BSONObj& query) const {
+    BSONArrayBuilder predicates;
+    addBucketPredicates(query, &predicates);
+    if (predicates.arrSize() == 0) {
+        return BSONObj();
+    }
+    return BSON("$and" << predicates.arr());
+}
+
+void DocumentSourceInternalUnpackBucket::addBucketPredicates(const BSONObj& query,
+                                                             BSONArrayBuilder* predicates) const {
+    for (auto&& predicate : query) {
+        const auto fieldName = predicate.fieldNameStringData();
+        if (fieldName == "$and" && predicate.type() == BSONType::Array) {
+            for (auto&& conjunct : predicate.embeddedObject()) {
+                if (conjunct.type() == BSONType::Object) {
+                    addBucketPredicates(conjunct.embeddedObject(), predicates);
+                }
+            }
+        } else if (fieldName == _timeField) {
+            addTimePredicates(predicate, predicates);
+        } else if (!_metaField.empty() &&
+                   (fieldName == _metaField || fieldName.startsWith(_metaField + "."))) {
+            // Every measurement of a bucket has its meta value, so the predicate applies as is.
+            BSONObjBuilder metaPredicate;
+            metaPredicate.appendAs(predicate,
+                                   timeseries::kBucketMetaFieldName.toString() +
+                                       fieldName.substr(_metaField.size()).toString());
+            predicates->append(metaPredicate.obj());
+        }
+    }
+}
+
+void DocumentSourceInternalUnpackBucket::addTimePredicates(const BSONElement& predicate,
+                                                           BSONArrayBuilder* predicates) const {
+    const std::string minPath = str::stream() << timeseries::kBucketControlFieldName << "."
+                                              << timeseries::kBucketControlMinFieldName << "."
+                                              << _timeField;
+    const std::string maxPath = str::stream() << timeseries::kBucketControlFieldName << "."
+                                              << timeseries::kBucketControlMaxFieldName << "."
+                                              << _timeField;
+
+    // Only dates can match the times of the measurements.
+    auto addBound = [&](const std::string& path, StringData op, const BSONElement& bound) {
+        if (bound.type() == BSONType::Date) {
+            predicates->append(BSON(path << BSON(op << bound)));
+        }
+    };
+
+    if (predicate.type() != BSONType::Object ||
+        !StringData(predicate.embeddedObject().firstElementFieldName()).startsWith("$")) {
+        addBound(minPath, "$lte", predicate);
+        addBound(maxPath, "$gte", predicate);
+        return;
+    }
+
+    for (auto&& op : predicate.embeddedObject()) {
+        const auto opName = op.fieldNameStringData();
+        if (opName == "$eq") {
+            addBound(minPath, "$lte", op);
+            addBound(maxPath, "$gte", op);
+        } else if (opName == "$gt" || opName == "$gte") {
+            addBound(maxPath, opName, op);
+        } else if (opName == "$lt" || opName == "$lte") {
+            addBound(minPath, opName, op);
+        }
+    }
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    spec.addField("timeField", Value(_timeField));
+    if (!_metaField.empty()) {
+        spec.addField("metaField", Value(_metaField));
+    }
+    return Value(Document{{getSourceName(), spec.freeze()}});
+}
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/timeseries/bucket_format.h"
+
+namespace mongo {
+
+/**
+ * Turns the bucket documents of a time-series collection into the measurements they hold, one
+ * bucket at a time. This stage is added in front of every pipeline on a time-series collection,
+ * which then sees its measurements rather than its buckets.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalUnpackBucket"_sd;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    static boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        std::string timeField,
+        std::string metaField);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints() const final {
+        StageConstraints constraints;
+        constraints.hostRequirement = HostTypeRequirement::kAnyShard;
+        return constraints;
+    }
+
+    GetDepsReturn getDependencies(DepsTracker* deps) const final {
+        // Every field of a measurement comes from a column of the bucket.
+        deps->needWholeDocument = true;
+        return EXHAUSTIVE_ALL;
+    }
+
+    GetNextResult getNext() final;
+
+    /**
+     * Returns a predicate on the buckets which matches every bucket holding a measurement that
+     * matches 'query', or an empty object if it cannot be narrowed down. The bounds of the times
+     * in each bucket are used for the predicates on the timeField, and the meta value of the
+     * bucket for the predicates on the metaField.
+     */
+    BSONObj makeBucketPredicate(const BSONObj& query) const;
+
+private:
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       std::string timeField,
+                                       std::string metaField);
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    void addBucketPredicates(const BSONObj& query, BSONArrayBuilder* predicates) const;
+
+    void addTimePredicates(const BSONElement& predicate, BSONArrayBuilder* predicates) const;
+
+    const std::string _timeField;
+    const std::string _metaField;
+
+    timeseries::BucketUnpacker _unpacker;
+};
+
+}  // namespace mongo
@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using DocumentSourceInternalUnpackBucketTest = AggregationContextFixture;
+
+boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> createUnpack(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto stage = DocumentSourceInternalUnpackBucket::createFromBson(
+        fromjson("{$_internalUnpackBucket: {timeField: 't', metaField: 'm'}}").firstElement(),
+        expCtx);
+    return static_cast<DocumentSourceInternalUnpackBucket*>(stage.get());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, UnpacksEachMeasurementOfEachBucket) {
+    auto unpack = createUnpack(getExpCtx());
+    auto mock = DocumentSourceMock::create(
+        {Document(fromjson("{_id: 1, control: {version: 1}, meta: 'a', data: {t: {'0': {$date: "
+                           "1}, '1': {$date: 2}}, v: {'1': 5}}}")),
+         DocumentSource::GetNextResult::makePauseExecution(),
+         Document(fromjson("{_id: 2, control: {version: 1}, data: {t: {'0': {$date: 3}}}}"))});
+    unpack->setSource(mock.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{t: {$date: 1}, m: 'a'}")), next.releaseDocument());
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{t: {$date: 2}, v: 5, m: 'a'}")),
+                       next.releaseDocument());
+
+    ASSERT_TRUE(unpack->getNext().isPaused());
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{t: {$date: 3}}")), next.releaseDocument());
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, RejectsInvalidSpecs) {
+    ASSERT_THROWS(DocumentSourceInternalUnpackBucket::createFromBson(
+                      fromjson("{$_internalUnpackBucket: 1}").firstElement(), getExpCtx()),
+                  AssertionException);
+    ASSERT_THROWS(DocumentSourceInternalUnpackBucket::createFromBson(
+                      fromjson("{$_internalUnpackBucket: {}}").firstElement(), getExpCtx()),
+                  AssertionException);
+    ASSERT_THROWS(
+        DocumentSourceInternalUnpackBucket::createFromBson(
+            fromjson("{$_internalUnpackBucket: {timeField: 't', other: 1}}").firstElement(),
+            getExpCtx()),
+        AssertionException);
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, PushesTimePredicatesDownToBucketBounds) {
+    auto unpack = createUnpack(getExpCtx());
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{$and: [{'control.max.t': {$gte: {$date: 10}}}, {'control.min.t': {$lt: "
+                 "{$date: 20}}}]}"),
+        unpack->makeBucketPredicate(
+            fromjson("{t: {$gte: {$date: 10}, $lt: {$date: 20}}, v: {$gt: 1}}")));
+    ASSERT_BSONOBJ_EQ(fromjson("{$and: [{'control.min.t': {$lte: {$date: 10}}}, "
+                               "{'control.max.t': {$gte: {$date: 10}}}]}"),
+                      unpack->makeBucketPredicate(fromjson("{$and: [{t: {$date: 10}}]}")));
+
+    // Bounds which are not dates match no measurement time, and are left to the $match.
+    ASSERT_BSONOBJ_EQ(BSONObj(), unpack->makeBucketPredicate(fromjson("{t: {$gte: 10}}")));
+    ASSERT_BSONOBJ_EQ(BSONObj(), unpack->makeBucketPredicate(fromjson("{v: 1}")));
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, PushesMetaPredicatesDownToBucketMeta) {
+    auto unpack = createUnpack(getExpCtx());
+    ASSERT_BSONOBJ_EQ(fromjson("{$and: [{meta: 'a'}, {'meta.b': {$in: [1, 2]}}]}"),
+                      unpack->makeBucketPredicate(fromjson("{m: 'a', 'm.b': {$in: [1, 2]}}")));
+    ASSERT_BSONOBJ_EQ(BSONObj(), unpack->makeBucketPredicate(fromjson("{mm: 'a'}")));
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, Serializes) {
+    auto unpack = createUnpack(getExpCtx());
+    std::vector<Value> serialized;
+    unpack->serializeToArray(serialized);
+    ASSERT_EQ(1U, serialized.size());
+    ASSERT_VALUE_EQ(Value(fromjson("{$_internalUnpackBucket: {timeField: 't', metaField: 'm'}}")),
+                    serialized[0]);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -200,7 +200,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
+    boost::optional<std::vector<Value>> hashJoinMatches;
+    auto nextInput = getNextInput(&hashJoinMatches);
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
@@ -211,27 +212,30 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
-    }
-
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
 
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
-        uassert(4568,
-                str::stream() << "Total size of documents in " << _fromNs.coll()
-                              << " matching pipeline "
-                              << getUserPipelineDefinition()
-                              << " exceeds maximum document size",
-                objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+    if (hashJoinMatches) {
+        for (auto&& result : *hashJoinMatches) {
+            objsize += result.getDocument().getApproximateSize();
+            assertJoinedSizeWithinLimit(objsize);
+        }
+        results = std::move(*hashJoinMatches);
+    } else {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+            _resolvedPipeline.back() = matchStage;
+        }
+
+        auto pipeline = buildPipeline(inputDoc);
+
+        while (auto result = pipeline->getNext()) {
+            objsize += result->getApproximateSize();
+            assertJoinedSizeWithinLimit(objsize);
+            results.emplace_back(std::move(*result));
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -239,6 +243,119 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+void DocumentSourceLookUp::assertJoinedSizeWithinLimit(int objsize) {
+    uassert(4568,
+            str::stream() << "Total size of documents in " << _fromNs.coll()
+                          << " matching pipeline "
+                          << getUserPipelineDefinition()
+                          << " exceeds maximum document size",
+            objsize <= BSONObjMaxInternalSize);
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextInput(
+    boost::optional<std::vector<Value>>* hashJoinMatches) {
+    if (_joinStrategy == JoinStrategy::kUndecided) {
+        chooseJoinStrategy();
+    }
+
+    if (_joinStrategy == JoinStrategy::kNestedLoop) {
+        return pSource->getNext();
+    }
+
+    std::vector<Value> keys;
+    if (!_hashTable->isSpilled()) {
+        auto nextInput = pSource->getNext();
+        if (nextInput.isAdvanced() &&
+            _hashTable->extractLocalKeys(nextInput.getDocument(), *_localField, &keys)) {
+            *hashJoinMatches = _hashTable->probe(keys);
+        }
+        return nextInput;
+    }
+
+    // A spilled table can only be joined once it has seen the whole input.
+    while (!_hashTable->isDoneAddingLocal()) {
+        auto nextInput = pSource->getNext();
+        if (nextInput.isPaused()) {
+            return nextInput;
+        }
+        if (nextInput.isEOF()) {
+            _hashTable->doneAddingLocal();
+            break;
+        }
+
+        auto inputDoc = nextInput.releaseDocument();
+        if (_hashTable->extractLocalKeys(inputDoc, *_localField, &keys)) {
+            _hashTable->addLocalDocument(std::move(inputDoc), std::move(keys));
+        } else {
+            _hashTable->addLocalDocument(std::move(inputDoc), boost::none);
+        }
+    }
+
+    if (!_hashTable->hasNextOutput()) {
+        return GetNextResult::makeEOF();
+    }
+
+    auto joined = _hashTable->getNextOutput();
+    *hashJoinMatches = std::move(joined.second);
+    return std::move(joined.first);
+}
+
+bool DocumentSourceLookUp::canUseHashJoin(long long maxMemoryBytes) {
+    if (wasConstructedWithPipelineSyntax() || maxMemoryBytes <= 0 || pExpCtx->inMongos ||
+        !LookupHashTable::isSupportedForeignField(*_foreignField)) {
+        return false;
+    }
+
+    // A hash join reads the whole foreign collection, which only pays off over a nested loop of
+    // indexed queries when the collection is small. Use its data size as the estimate of how
+    // large the table would be.
+    BSONObjBuilder stats;
+    if (!_mongod->appendStorageStats(_resolvedNs, BSONObj(), &stats).isOK()) {
+        return false;
+    }
+    auto sizeElem = stats.done()["size"];
+    return sizeElem.isNumber() && sizeElem.safeNumberLong() <= maxMemoryBytes;
+}
+
+void DocumentSourceLookUp::chooseJoinStrategy() {
+    invariant(_joinStrategy == JoinStrategy::kUndecided);
+    _joinStrategy = JoinStrategy::kNestedLoop;
+
+    const long long maxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    if (!canUseHashJoin(maxMemoryBytes)) {
+        return;
+    }
+
+    SortOptions options;
+    options.maxMemoryUsageBytes = maxMemoryBytes;
+    if (pExpCtx->extSortAllowed) {
+        options.extSortAllowed = true;
+        options.tempDir = pExpCtx->tempDir;
+    }
+    _hashTable.emplace(_fromExpCtx->getValueComparator(), *_foreignField, std::move(options));
+
+    // Read the foreign side once. This is the view pipeline, if any, followed by any $match that
+    // was absorbed along with an $unwind. The '_resolvedPipeline' placeholder for the per-document
+    // $match is not needed.
+    std::vector<BSONObj> foreignPipeline(_resolvedPipeline.begin(), _resolvedPipeline.end() - 1);
+    if (_additionalFilter) {
+        foreignPipeline.push_back(BSON("$match" << *_additionalFilter));
+    }
+
+    copyVariablesToExpCtx(_variables, _variablesParseState, _fromExpCtx.get());
+    auto pipeline = uassertStatusOK(_mongod->makePipeline(foreignPipeline, _fromExpCtx));
+    while (auto foreignDoc = pipeline->getNext()) {
+        if (!_hashTable->addForeignDocument(*foreignDoc)) {
+            // The table outgrew its memory limit and may not spill to disk.
+            _hashTable.reset();
+            return;
+        }
+    }
+
+    _hashTable->doneAddingForeign();
+    _joinStrategy = JoinStrategy::kHashJoin;
+}
+
 std::unique_ptr<Pipeline, Pipeline::Deleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -424,6 +541,8 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashTable.reset();
+    _hashJoinResults.reset();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -516,35 +635,43 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+    while (!_nextValue) {
+        boost::optional<std::vector<Value>> hashJoinMatches;
+        auto nextInput = getNextInput(&hashJoinMatches);
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
-
         if (_pipeline) {
             _pipeline->dispose(pExpCtx->opCtx);
+            _pipeline.reset();
         }
 
-        _pipeline = buildPipeline(*_input);
+        _hashJoinResults = std::move(hashJoinMatches);
+        _hashJoinResultsIndex = 0;
+
+        if (!_hashJoinResults) {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in
+                // '_resolvedPipeline'.
+                _resolvedPipeline.back() = matchStage;
+            }
+
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = getNextUnwindValue();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -562,7 +689,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = getNextUnwindValue();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -576,6 +703,17 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::getNextUnwindValue() {
+    if (!_hashJoinResults) {
+        return _pipeline->getNext();
+    }
+
+    if (_hashJoinResultsIndex == _hashJoinResults->size()) {
+        return boost::none;
+    }
+    return (*_hashJoinResults)[_hashJoinResultsIndex++].getDocument();
+}
+
 void DocumentSourceLookUp::copyVariablesToExpCtx(const Variables& vars,
                                                  const VariablesParseState& vps,
                                                  ExpressionContext* expCtx) {
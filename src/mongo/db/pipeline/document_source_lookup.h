@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
 
@@ -183,6 +184,21 @@ protected:
                                                      Pipeline::SourceContainer* container) final;
 
 private:
+    /**
+     * How the stage joins input documents with the foreign collection. Chosen when the first
+     * input document is requested.
+     */
+    enum class JoinStrategy {
+        kUndecided,
+
+        // Query the foreign collection once per input document.
+        kNestedLoop,
+
+        // Read the foreign collection once into '_hashTable' and probe it with each input
+        // document. Only available with localField/foreignField syntax.
+        kHashJoin,
+    };
+
     struct LetVariable {
         LetVariable(std::string name, boost::intrusive_ptr<Expression> expression, Variables::Id id)
             : name(std::move(name)), expression(std::move(expression)), id(id) {}
@@ -229,6 +245,35 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns the next input document to join. If the hash join strategy was able to join it,
+     * 'hashJoinMatches' is set to the matching foreign documents; otherwise the caller must query
+     * the foreign collection for it.
+     */
+    GetNextResult getNextInput(boost::optional<std::vector<Value>>* hashJoinMatches);
+
+    /**
+     * Decides between a nested loop and a hash join, and builds '_hashTable' if this chooses a
+     * hash join.
+     */
+    void chooseJoinStrategy();
+
+    /**
+     * Returns true if the foreign collection is eligible to be read into a hash table no larger
+     * than 'maxMemoryBytes'.
+     */
+    bool canUseHashJoin(long long maxMemoryBytes);
+
+    /**
+     * Returns the next foreign document to unwind for the current input document.
+     */
+    boost::optional<Document> getNextUnwindValue();
+
+    /**
+     * Asserts that the joined documents totalling 'objsize' bytes fit in a single document.
+     */
+    void assertJoinedSizeWithinLimit(int objsize);
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -302,12 +347,20 @@ private:
     boost::intrusive_ptr<DocumentSourceMatch> _matchSrc;
     boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
 
+    JoinStrategy _joinStrategy = JoinStrategy::kUndecided;
+    boost::optional<LookupHashTable> _hashTable;
+
     // The following members are used to hold onto state across getNext() calls when '_unwindSrc' is
     // not null.
     long long _cursorIndex = 0;
     std::unique_ptr<Pipeline, Pipeline::Deleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // When '_unwindSrc' is not null and the current input document was joined through
+    // '_hashTable', holds its matches in place of '_pipeline'.
+    boost::optional<std::vector<Value>> _hashJoinResults;
+    size_t _hashJoinResultsIndex = 0;
 };
 
 }  // namespace mongo
@@ -44,6 +44,8 @@
 #include "mongo/db/pipeline/stub_mongod_interface.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -425,10 +427,33 @@ public:
         return false;
     }
 
+    /**
+     * Reports the foreign collection as 'sizeBytes' large, which allows a $lookup to choose a hash
+     * join. Without this, a $lookup always queries once per input document.
+     */
+    void setForeignCollectionSize(long long sizeBytes) {
+        _foreignCollectionSizeBytes = sizeBytes;
+    }
+
+    Status appendStorageStats(const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        if (!_foreignCollectionSizeBytes) {
+            return {ErrorCodes::NamespaceNotFound, "no storage stats in mock"};
+        }
+        builder->appendNumber("size", *_foreignCollectionSizeBytes);
+        return Status::OK();
+    }
+
+    int numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
     StatusWith<std::unique_ptr<Pipeline, Pipeline::Deleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++_numPipelinesMade;
         auto pipeline = Pipeline::parse(rawPipeline, expCtx);
         if (!pipeline.isOK()) {
             return pipeline.getStatus();
@@ -463,6 +488,8 @@ public:
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    boost::optional<long long> _foreignCollectionSizeBytes;
+    int _numPipelinesMade = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -995,5 +1022,146 @@ TEST_F(DocumentSourceLookUpTest, ShouldNotCacheIfCorrelatedStageIsAbsorbedIntoPl
     ASSERT_VALUE_EQ(Value(subPipeline->writeExplainOps(kExplain)), Value(BSONArray(expectedPipe)));
 }
 
+/**
+ * Sets up a $lookup joining 'localField' of the local documents to '_id' of the foreign documents,
+ * with a foreign collection small enough to be hash joined.
+ */
+std::pair<intrusive_ptr<DocumentSourceLookUp>, std::shared_ptr<MockMongodInterface>>
+makeHashJoinLookup(const intrusive_ptr<ExpressionContextForTest>& expCtx,
+                   DocumentSource* localSource,
+                   deque<DocumentSource::GetNextResult> foreignContents) {
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "localField"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    intrusive_ptr<DocumentSourceLookUp> lookup = static_cast<DocumentSourceLookUp*>(
+        DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx).get());
+    lookup->setSource(localSource);
+
+    auto mongod = std::make_shared<MockMongodInterface>(std::move(foreignContents));
+    mongod->setForeignCollectionSize(1024);
+    lookup->injectMongodInterface(mongod);
+    return {lookup, mongod};
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldHashJoinSmallForeignCollection) {
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"localField", 1}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"localField", vector<Value>{Value(0), Value(2)}}},
+                                    Document{{"localField", 5}}});
+    auto lookupAndMongod = makeHashJoinLookup(
+        getExpCtx(),
+        mockLocalSource.get(),
+        {Document{{"_id", 0}}, Document{{"_id", 1}}, Document{{"_id", 2}}});
+    auto lookup = lookupAndMongod.first;
+
+    // The mock ignores the query it is given, so only a hash join returns just the matches.
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"localField", 1}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 1}})}}}));
+
+    ASSERT_TRUE(lookup->getNext().isPaused());
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"localField", vector<Value>{Value(0), Value(2)}},
+                                 {"foreignDocs",
+                                  vector<Value>{Value(Document{{"_id", 0}}),
+                                                Value(Document{{"_id", 2}})}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"localField", 5}, {"foreignDocs", vector<Value>{}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // The foreign collection was only read once.
+    ASSERT_EQ(lookupAndMongod.second->numPipelinesMade(), 1);
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldQueryForNullLocalValues) {
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"other", 1}}});
+    auto lookupAndMongod =
+        makeHashJoinLookup(getExpCtx(), mockLocalSource.get(), {Document{{"_id", 0}}});
+    auto lookup = lookupAndMongod.first;
+
+    ASSERT_TRUE(lookup->getNext().isAdvanced());
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // One pipeline builds the table, and a second one queries for the missing local field.
+    ASSERT_EQ(lookupAndMongod.second->numPipelinesMade(), 2);
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldSpillWhenAllowedToUseDisk) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->extSortAllowed = true;
+
+    const auto originalMaxMemory = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(originalMaxMemory); });
+
+    std::string padding(512, 'x');
+    deque<DocumentSource::GetNextResult> foreignContents;
+    deque<DocumentSource::GetNextResult> localContents;
+    for (int i = 0; i < 10; ++i) {
+        foreignContents.push_back(Document{{"_id", i}, {"padding", padding}});
+        localContents.push_back(Document{{"localField", 9 - i}});
+    }
+    auto mockLocalSource = DocumentSourceMock::create(localContents);
+    auto lookup =
+        makeHashJoinLookup(expCtx, mockLocalSource.get(), std::move(foreignContents)).first;
+
+    // The output keeps the order of the input.
+    for (int i = 0; i < 10; ++i) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                           (Document{{"localField", 9 - i},
+                                     {"foreignDocs",
+                                      vector<Value>{Value(
+                                          Document{{"_id", 9 - i}, {"padding", padding}})}}}));
+    }
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldHandleAbsorbedUnwind) {
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"localField", vector<Value>{Value(0), Value(1)}}},
+                                    Document{{"localField", 2}}});
+    auto lookup = makeHashJoinLookup(getExpCtx(),
+                                     mockLocalSource.get(),
+                                     {Document{{"_id", 0}}, Document{{"_id", 1}}})
+                      .first;
+    lookup->setUnwindStage(DocumentSourceUnwind::create(getExpCtx(), "foreignDocs", false, {}));
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.releaseDocument()["foreignDocs"], Value(Document{{"_id", 0}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.releaseDocument()["foreignDocs"], Value(Document{{"_id", 1}}));
+
+    // The second input document has no matches, so the $unwind drops it.
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
 }  // namespace
 }  // namespace mongo
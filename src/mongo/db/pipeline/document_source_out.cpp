@@ -121,26 +121,33 @@ void DocumentSourceOut::initialize() {
                 ok);
     }
 
-    // copy indexes to _tempNs
-    for (std::list<BSONObj>::const_iterator it = _originalIndexes.begin();
-         it != _originalIndexes.end();
-         ++it) {
-        MutableDocument index((Document(*it)));
+    _initialized = true;
+}
+
+void DocumentSourceOut::createIndexesOnTempCollection() {
+    if (_originalIndexes.empty()) {
+        return;
+    }
+
+    // Building the indexes once all the documents are in place lets the index builder bulk-load
+    // sorted keys, which is far cheaper than updating every index on every insert. All the indexes
+    // are built in a single command so that the collection is only scanned once.
+    BSONArrayBuilder indexSpecs;
+    for (auto&& indexSpec : _originalIndexes) {
+        MutableDocument index((Document(indexSpec)));
         index.remove("_id");  // indexes shouldn't have _ids but some existing ones do
         index["ns"] = Value(_tempNs.ns());
-
-        BSONObj indexBson = index.freeze().toBson();
-        conn->insert(_tempNs.getSystemIndexesCollection(), indexBson);
-        BSONObj err = conn->getLastErrorDetailed();
-        uassert(16995,
-                str::stream() << "copying index for $out failed."
-                              << " index: "
-                              << indexBson
-                              << " error: "
-                              << err,
-                DBClientBase::getLastErrorString(err).empty());
+        indexSpecs.append(index.freeze().toBson());
     }
-    _initialized = true;
+
+    BSONObj info;
+    bool ok = _mongod->directClient()->runCommand(
+        _tempNs.db().toString(),
+        BSON("createIndexes" << _tempNs.coll() << "indexes" << indexSpecs.arr()),
+        info);
+    uassert(16995,
+            str::stream() << "copying indexes for $out failed: " << info.toString(),
+            ok);
 }
 
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
@@ -189,6 +196,7 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            createIndexesOnTempCollection();
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
@@ -85,12 +85,18 @@ private:
      * Sets '_tempNs' to a unique temporary namespace, makes sure the output collection isn't
      * sharded or capped, and saves the collection options and indexes of the target collection.
      * Then creates the temporary collection we will insert into by copying the collection options
-     * and indexes from the target collection.
+     * from the target collection.
      *
      * Sets '_initialized' to true upon completion.
      */
     void initialize();
 
+    /**
+     * Builds the indexes of the target collection on the temporary collection. This is done after
+     * all documents have been inserted, so that inserts don't have to maintain the indexes.
+     */
+    void createIndexesOnTempCollection();
+
     /**
      * Inserts all of 'toInsert' into the temporary collection.
      */
@@ -67,7 +67,13 @@ DocumentSource::GetNextResult DocumentSourceRedact::getNext() {
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
         auto& variables = pExpCtx->variables;
         variables.setValue(_currentId, Value(nextInput.getDocument()));
-        if (boost::optional<Document> result = redactObject(nextInput.releaseDocument())) {
+        boost::optional<Document> result = redactObject(nextInput.releaseDocument());
+
+        // Don't let $$CURRENT hold a reference to this input while the next one is produced, or
+        // the stage before us would have to copy the data it modifies in place, such as the
+        // document an $unwind is unwinding.
+        variables.setValue(_currentId, Value());
+        if (result) {
             return std::move(*result);
         }
     }
@@ -41,6 +41,7 @@ namespace mongo {
 using boost::intrusive_ptr;
 
 constexpr StringData DocumentSourceSample::kStageName;
+constexpr long long DocumentSourceSample::kMaxSizeToFilterRandomValues;
 
 DocumentSourceSample::DocumentSourceSample(const intrusive_ptr<ExpressionContext>& pExpCtx)
     : DocumentSource(pExpCtx), _size(0) {}
@@ -60,8 +61,14 @@ DocumentSource::GetNextResult DocumentSourceSample::getNext() {
         PseudoRandom& prng = pExpCtx->opCtx->getClient()->getPrng();
         auto nextInput = pSource->getNext();
         for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
+            const double randVal = prng.nextCanonicalDouble();
+            if (!shouldKeepRandomValue(randVal)) {
+                // This document could never make it into the sample, so don't bother copying it
+                // to attach the random value or handing it to the sorter.
+                continue;
+            }
             MutableDocument doc(nextInput.releaseDocument());
-            doc.setRandMetaField(prng.nextCanonicalDouble());
+            doc.setRandMetaField(randVal);
             _sortStage->loadDocument(doc.freeze());
         }
         switch (nextInput.getStatus()) {
@@ -81,6 +88,25 @@ DocumentSource::GetNextResult DocumentSourceSample::getNext() {
     return _sortStage->getNext();
 }
 
+bool DocumentSourceSample::shouldKeepRandomValue(double randVal) {
+    if (_size > kMaxSizeToFilterRandomValues) {
+        return true;
+    }
+
+    // '_highestRandomValues' is a min-heap of the '_size' highest random values seen so far. Once
+    // it is full, anything no higher than its smallest value would be cut by the top-k sort.
+    if (static_cast<long long>(_highestRandomValues.size()) < _size) {
+        _highestRandomValues.push(randVal);
+        return true;
+    }
+    if (randVal <= _highestRandomValues.top()) {
+        return false;
+    }
+    _highestRandomValues.pop();
+    _highestRandomValues.push(randVal);
+    return true;
+}
+
 Value DocumentSourceSample::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     return Value(DOC(kStageName << DOC("size" << _size)));
 }
@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <functional>
+#include <queue>
+#include <vector>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 
@@ -64,10 +68,22 @@ public:
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
 private:
+    // The largest sample size for which we track the highest random values seen, in order to
+    // discard documents which cannot be part of the sample before they reach the sorter.
+    static constexpr long long kMaxSizeToFilterRandomValues = 1024 * 1024;
+
     explicit DocumentSourceSample(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    /**
+     * Returns false if a document with random value 'randVal' is known not to be among the '_size'
+     * documents with the highest random values, and so can be left out of the sample.
+     */
+    bool shouldKeepRandomValue(double randVal);
+
     long long _size;
 
+    std::priority_queue<double, std::vector<double>, std::greater<double>> _highestRandomValues;
+
     // Uses a $sort stage to randomly sort the documents.
     boost::intrusive_ptr<DocumentSourceSort> _sortStage;
 };
@@ -170,6 +170,15 @@ TEST_F(SampleBasics, SampleEOFBeforeSource) {
     checkResults(5, 5);
 }
 
+/**
+ * A $sample stage should still return the requested number of results when it discards most of
+ * its input before sorting.
+ */
+TEST_F(SampleBasics, SampleMuchSmallerThanSource) {
+    loadDocuments(10000);
+    checkResults(10, 10);
+}
+
 /**
  * The incoming documents should not be modified by a $sample stage (except their metadata).
  */
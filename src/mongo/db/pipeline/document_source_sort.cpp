@@ -38,6 +38,9 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 
@@ -288,6 +291,16 @@ intrusive_ptr<DocumentSourceSort> DocumentSourceSort::create(
         pSort->sortKeyPattern(SortKeySerialization::kForPipelineSerialization).toBson(),
         pExpCtx->getCollator()};
 
+    // An Ordering can only describe a limited number of fields, so a sort on more than that many
+    // keys compares them as Values instead.
+    if (internalQueryUseKeyStringSortKeys.load() && pSort->_sortPattern.size() <= 31) {
+        BSONObjBuilder ordering;
+        for (auto&& keyPart : pSort->_sortPattern) {
+            ordering.append("", keyPart.isAscending ? 1 : -1);
+        }
+        pSort->_keyStringOrdering = Ordering::make(ordering.obj());
+    }
+
     if (limit > 0) {
         pSort->setLimitSrc(DocumentSourceLimit::create(pExpCtx, limit));
     }
@@ -370,6 +383,9 @@ public:
         if (doc.hasSortKeyMetaField()) {
             // We set the sort key metadata field during the first half of the sort, so just use
             // that as the sort key here.
+            if (_sorter->_keyStringOrdering) {
+                return make_pair(_sorter->encodeSortKey(doc.getSortKeyMetaField()), doc);
+            }
             return make_pair(
                 deserializeSortKey(_sorter->_sortPattern.size(), doc.getSortKeyMetaField()), doc);
         } else {
@@ -463,6 +479,14 @@ std::pair<Value, Document> DocumentSourceSort::extractSortKey(Document&& doc) co
         inMemorySortKey = deserializeSortKey(_sortPattern.size(), *serializedSortKey);
     }
 
+    if (_keyStringOrdering) {
+        // Encode the key once here so that every comparison the sorter makes is a memcmp.
+        if (!serializedSortKey) {
+            serializedSortKey = serializeSortKey(_sortPattern.size(), inMemorySortKey);
+        }
+        inMemorySortKey = encodeSortKey(*serializedSortKey);
+    }
+
     MutableDocument toBeSorted(std::move(doc));
     if (pExpCtx->needsMerge) {
         // We need to be merged, so will have to be serialized. Save the sort key here to avoid
@@ -473,6 +497,20 @@ std::pair<Value, Document> DocumentSourceSort::extractSortKey(Document&& doc) co
     return {inMemorySortKey, toBeSorted.freeze()};
 }
 
+Value DocumentSourceSort::encodeSortKey(const BSONObj& serializedSortKey) const {
+    invariant(_keyStringOrdering);
+    BSONObj keyToEncode = serializedSortKey;
+    if (auto collator = pExpCtx->getCollator()) {
+        BSONObjBuilder collationKey;
+        for (auto&& elt : serializedSortKey) {
+            CollationIndexKey::collationAwareIndexKeyAppend(elt, collator, &collationKey);
+        }
+        keyToEncode = collationKey.obj();
+    }
+    KeyString keyString(KeyString::Version::V1, keyToEncode, *_keyStringOrdering);
+    return Value(StringData(keyString.getBuffer(), keyString.getSize()));
+}
+
 int DocumentSourceSort::compare(const Value& lhs, const Value& rhs) const {
     /*
       populate() already checked that there is a non-empty sort key,
@@ -481,6 +519,12 @@ int DocumentSourceSort::compare(const Value& lhs, const Value& rhs) const {
       However, the tricky part is what to do is none of the sort keys are
       present.  In this case, consider the document less.
     */
+    if (_keyStringOrdering) {
+        // The keys are KeyStrings, which already account for the collation and the direction of
+        // each component, so a simple binary comparison of the strings orders them.
+        return Value::compare(lhs, rhs, nullptr);
+    }
+
     const size_t n = _sortPattern.size();
     if (n == 1) {  // simple fast case
         if (_sortPattern[0].isAscending)
@@ -521,6 +565,7 @@ intrusive_ptr<DocumentSource> DocumentSourceSort::getMergeSource() {
         other->sortKeyPattern(SortKeySerialization::kForPipelineSerialization).toBson(),
         pExpCtx->getCollator()};
     other->_paths = _paths;
+    other->_keyStringOrdering = _keyStringOrdering;
     other->limitSrc = limitSrc;
     other->_maxMemoryUsageBytes = _maxMemoryUsageBytes;
     other->_mergingPresorted = true;
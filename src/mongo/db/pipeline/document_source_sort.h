@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/index/sort_key_generator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_limit.h"
@@ -219,6 +220,14 @@ private:
      */
     BSONObj extractKeyWithArray(const Document& doc) const;
 
+    /**
+     * Returns the KeyString encoding of the serialized sort key 'serializedSortKey' as a string
+     * Value, with strings replaced by their collation keys. Comparing two such Values as strings
+     * orders them in the same way as comparing the sort keys. Only valid if '_keyStringOrdering' is
+     * set.
+     */
+    Value encodeSortKey(const BSONObj& serializedSortKey) const;
+
     int compare(const Value& lhs, const Value& rhs) const;
 
     /**
@@ -242,6 +251,10 @@ private:
     // The set of paths on which we're sorting.
     std::set<std::string> _paths;
 
+    // Set if the keys given to the sorter are KeyString encodings of the sort keys, as produced by
+    // encodeSortKey(), rather than the sort keys themselves.
+    boost::optional<Ordering> _keyStringOrdering;
+
     boost::intrusive_ptr<DocumentSourceLimit> limitSrc;
 
     uint64_t _maxMemoryUsageBytes;
@@ -44,8 +44,12 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -353,6 +357,39 @@ TEST_F(DocumentSourceSortExecutionTest, ExtractArrayValues) {
                  "[{_id:1,a:[{b:1},{b:0}]},{_id:0,a:[{b:1},{b:2}]}]");
 }
 
+/** Strings should be compared using the collation. */
+TEST_F(DocumentSourceSortExecutionTest, ShouldRespectCollationWhenComparingStrings) {
+    getExpCtx()->setCollator(
+        stdx::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kReverseString));
+    checkResults({Document{{"_id", 0}, {"a", "ab"_sd}},
+                  Document{{"_id", 1}, {"a", "ba"_sd}},
+                  Document{{"_id", 2}, {"a", 2}}},
+                 BSON("a" << 1),
+                 "[{_id:2,a:2},{_id:1,a:\"ba\"},{_id:0,a:\"ab\"}]");
+}
+
+/** The results should not depend on whether the sort keys are compared as KeyStrings. */
+TEST_F(DocumentSourceSortExecutionTest, ShouldProduceSameOrderWithoutKeyStringSortKeys) {
+    const bool originalUseKeyStrings = internalQueryUseKeyStringSortKeys.load();
+    ON_BLOCK_EXIT([&] { internalQueryUseKeyStringSortKeys.store(originalUseKeyStrings); });
+
+    deque<DocumentSource::GetNextResult> inputDocs = {
+        Document{{"_id", 0}, {"a", 2.5}, {"b", "x"_sd}},
+        Document{{"_id", 1}, {"a", 2}, {"b", "y"_sd}},
+        Document{{"_id", 2}, {"a", 2LL}, {"b", "x"_sd}},
+        Document{{"_id", 3}, {"b", "z"_sd}},
+        Document{{"_id", 4}, {"a", "str"_sd}, {"b", BSONNULL}},
+        Document{{"_id", 5}, {"a", Decimal128("2.25")}, {"b", 1}}};
+    const auto expected =
+        "[{_id:3,b:'z'},{_id:1,a:2,b:'y'},{_id:2,a:2,b:'x'},{_id:5,a:NumberDecimal('2.25'),b:1},"
+        "{_id:0,a:2.5,b:'x'},{_id:4,a:'str',b:null}]";
+
+    for (bool useKeyStrings : {true, false}) {
+        internalQueryUseKeyStringSortKeys.store(useKeyStrings);
+        checkResults(inputDocs, BSON("a" << 1 << "b" << -1), expected);
+    }
+}
+
 TEST_F(DocumentSourceSortExecutionTest, ShouldPauseWhenAskedTo) {
     auto sort = DocumentSourceSort::create(getExpCtx(), BSON("a" << 1));
     auto mock = DocumentSourceMock::create({DocumentSource::GetNextResult::makePauseExecution(),
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeFlatObject(int64_t numFields) {
+    BSONObjBuilder bob;
+    for (int64_t i = 0; i < numFields; ++i) {
+        bob.append("field" + std::to_string(i), static_cast<int>(i));
+    }
+    return bob.obj();
+}
+
+void BM_MutableDocumentAddField(benchmark::State& state) {
+    const auto numFields = state.range();
+    std::vector<std::string> names;
+    for (int64_t i = 0; i < numFields; ++i) {
+        names.push_back("field" + std::to_string(i));
+    }
+
+    while (state.keepRunning()) {
+        MutableDocument md;
+        for (int64_t i = 0; i < numFields; ++i) {
+            md.addField(names[i], Value(static_cast<int>(i)));
+        }
+        Document doc = md.freeze();
+        benchmark::doNotOptimize(doc.size());
+    }
+    state.setItemsProcessed(state.iterations() * numFields);
+}
+MONGO_BENCHMARK(BM_MutableDocumentAddField)->arg(4)->arg(64);
+
+void BM_DocumentFromBSONFieldLookup(benchmark::State& state) {
+    const BSONObj obj = makeFlatObject(state.range());
+    const std::string lastField = "field" + std::to_string(state.range() - 1);
+
+    while (state.keepRunning()) {
+        Document doc(obj);
+        benchmark::doNotOptimize(doc[lastField].getInt());
+    }
+}
+MONGO_BENCHMARK(BM_DocumentFromBSONFieldLookup)->arg(4)->arg(64);
+
+void BM_DocumentToBson(benchmark::State& state) {
+    const Document doc(makeFlatObject(state.range()));
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(doc.toBson().objsize());
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+MONGO_BENCHMARK(BM_DocumentToBson)->arg(4)->arg(64);
+
+void BM_ValueFromBSONArray(benchmark::State& state) {
+    BSONArrayBuilder arr;
+    for (int64_t i = 0; i < state.range(); ++i) {
+        arr.append(static_cast<int>(i));
+    }
+    const BSONObj obj = BSON("arr" << arr.arr());
+
+    while (state.keepRunning()) {
+        Value value(obj.firstElement());
+        benchmark::doNotOptimize(value.getArrayLength());
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+MONGO_BENCHMARK(BM_ValueFromBSONArray)->arg(16)->arg(256);
+
+}  // namespace
+}  // namespace mongo
@@ -113,6 +113,134 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(DocumentConstruction, DocumentsMadeInArenaOutliveIt) {
+    const std::string longString(100, 'x');
+    const BSONObj bson = BSON("a" << longString << "b" << BSON("c" << longString << "d" << 1));
+
+    Document document;
+    Document clonedInHeap;
+    {
+        RefCountedArena arena;
+        RefCountedArena::Scope scope(&arena);
+
+        document = Document(bson);
+        MutableDocument md(document);
+        for (int i = 0; i < 50; i++) {
+            md.addField("field" + std::to_string(i), Value(longString));
+        }
+        document = md.freeze();
+
+        RefCountedArena::Scope noArena(nullptr);
+        clonedInHeap = document.clone();
+    }
+
+    ASSERT_EQUALS(52U, document.size());
+    ASSERT_BSONOBJ_EQ(document.toBson(), clonedInHeap.toBson());
+    ASSERT_VALUE_EQ(document.getNestedField(FieldPath("b.c")), Value(longString));
+    ASSERT_VALUE_EQ(document["field49"], Value(longString));
+}
+
+TEST(DocumentShape, DocumentsWithTheSameFieldsShareAShape) {
+    boost::intrusive_ptr<DocumentShapeTable> table(new DocumentShapeTable());
+    DocumentShapeTable::Scope scope(table.get());
+
+    const Document doc1(BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4 << "e" << 5));
+    const Document doc2(BSON("a" << 6 << "b" << 7 << "c" << 8 << "d" << 9 << "e" << 10));
+    const Document doc3(BSON("a" << 1 << "b" << 2 << "x" << 3));
+    ASSERT(doc1.getShape());
+    ASSERT_EQUALS(doc1.getShape(), doc2.getShape());
+    ASSERT_NOT_EQUALS(doc1.getShape(), doc3.getShape());
+    ASSERT_EQUALS(7U, table->numShapes());  // The root, a through e, and x.
+
+    ASSERT_VALUE_EQ(doc2["e"], Value(10));
+    ASSERT_VALUE_EQ(doc2["c"], Value(8));
+    ASSERT(doc2["f"].missing());
+    ASSERT_EQUALS(doc1.positionOf("d"), doc2.positionOf("d"));
+}
+
+TEST(DocumentShape, FieldSlotCacheIsReusedForDocumentsOfTheSameShape) {
+    boost::intrusive_ptr<DocumentShapeTable> table(new DocumentShapeTable());
+    DocumentShapeTable::Scope scope(table.get());
+
+    DocumentShape::FieldSlotCache cache;
+    const Document doc1(BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4));
+    ASSERT_VALUE_EQ(doc1.getField("c", &cache), Value(3));
+    ASSERT_EQUALS(doc1.getShape()->id(), cache.shapeId);
+    ASSERT_EQUALS(doc1.positionOf("c"), cache.pos);
+
+    const Document doc2(BSON("a" << 5 << "b" << 6 << "c" << 7 << "d" << 8));
+    ASSERT_VALUE_EQ(doc2.getField("c", &cache), Value(7));
+
+    // A document of another shape replaces the cached position.
+    const Document doc3(BSON("longerName" << 0 << "c" << 9));
+    ASSERT_VALUE_EQ(doc3.getField("c", &cache), Value(9));
+    ASSERT_EQUALS(doc3.getShape()->id(), cache.shapeId);
+
+    // Documents without a shape don't use the cache.
+    DocumentShapeTable::Scope noTable(nullptr);
+    const Document doc4(BSON("c" << 10));
+    ASSERT_FALSE(doc4.getShape());
+    ASSERT_VALUE_EQ(doc4.getField("c", &cache), Value(10));
+    ASSERT_EQUALS(doc3.getShape()->id(), cache.shapeId);
+}
+
+TEST(DocumentShape, DocumentModifiedWithoutItsTableStopsTrackingItsShape) {
+    boost::intrusive_ptr<DocumentShapeTable> table(new DocumentShapeTable());
+    Document document;
+    {
+        DocumentShapeTable::Scope scope(table.get());
+        document = Document(BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4 << "e" << 5));
+    }
+    ASSERT(document.getShape());
+
+    MutableDocument md(document);
+    md.addField("f", Value(6));
+    md.addField("a", Value(7));
+    const Document modified = md.freeze();
+    ASSERT_FALSE(modified.getShape());
+    ASSERT(document.getShape());
+
+    // Lookups fall back to the document's own hash table, which has to find every field.
+    ASSERT_VALUE_EQ(modified["a"], Value(1));
+    ASSERT_VALUE_EQ(modified["c"], Value(3));
+    ASSERT_VALUE_EQ(modified["f"], Value(6));
+    ASSERT_EQUALS(7U, modified.size());
+}
+
+TEST(DocumentShape, DuplicateFieldNameFindsTheFirstField) {
+    boost::intrusive_ptr<DocumentShapeTable> table(new DocumentShapeTable());
+    DocumentShapeTable::Scope scope(table.get());
+
+    const Document document(BSON("a" << 1 << "b" << 2 << "a" << 3 << "c" << 4 << "d" << 5));
+    ASSERT(document.getShape());
+    ASSERT_VALUE_EQ(document["a"], Value(1));
+}
+
+TEST(DocumentShape, TooManyShapesStopsTrackingShapes) {
+    boost::intrusive_ptr<DocumentShapeTable> table(new DocumentShapeTable());
+    DocumentShapeTable::Scope scope(table.get());
+
+    std::vector<Document> documents;
+    for (size_t i = 0; i <= DocumentShapeTable::kMaxSuccessors; i++) {
+        BSONObjBuilder bob;
+        bob << ("field" + std::to_string(i)) << 1 << "a" << 2 << "b" << 3 << "c" << 4;
+        documents.push_back(Document(bob.obj()));
+    }
+    for (size_t i = 0; i < DocumentShapeTable::kMaxSuccessors; i++) {
+        ASSERT(documents[i].getShape());
+    }
+    ASSERT_FALSE(documents.back().getShape());
+    ASSERT_VALUE_EQ(documents.back()["c"], Value(4));
+
+    MutableDocument wide;
+    for (unsigned i = 0; i <= DocumentShapeTable::kMaxShapeFields; i++) {
+        wide.addField("w" + std::to_string(i), Value(int(i)));
+    }
+    const Document wideDoc = wide.freeze();
+    ASSERT_FALSE(wideDoc.getShape());
+    ASSERT_VALUE_EQ(wideDoc["w10"], Value(10));
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -793,8 +793,14 @@ static const CmpLookup cmpLookup[7] = {
 Value ExpressionCompare::evaluate(const Document& root) const {
     Value pLeft(vpOperand[0]->evaluate(root));
     Value pRight(vpOperand[1]->evaluate(root));
+    return apply(cmpOp, getExpressionContext()->getValueComparator(), pLeft, pRight);
+}
 
-    int cmp = getExpressionContext()->getValueComparator().compare(pLeft, pRight);
+Value ExpressionCompare::apply(CmpOp cmpOp,
+                               const ValueComparator& comparator,
+                               const Value& pLeft,
+                               const Value& pRight) {
+    int cmp = comparator.compare(pLeft, pRight);
 
     // Make cmp one of 1, 0, or -1.
     if (cmp == 0) {
@@ -1647,7 +1653,10 @@ void ExpressionDateToString::_doAddDependencies(DepsTracker* deps) const {
 Value ExpressionDivide::evaluate(const Document& root) const {
     Value lhs = vpOperand[0]->evaluate(root);
     Value rhs = vpOperand[1]->evaluate(root);
+    return apply(lhs, rhs);
+}
 
+Value ExpressionDivide::apply(const Value& lhs, const Value& rhs) {
     auto assertNonZero = [](bool nonZero) { uassert(16608, "can't $divide by zero", nonZero); };
 
     if (lhs.numeric() && rhs.numeric()) {
@@ -1815,7 +1824,10 @@ intrusive_ptr<ExpressionFieldPath> ExpressionFieldPath::parse(
 ExpressionFieldPath::ExpressionFieldPath(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                          const string& theFieldPath,
                                          Variables::Id variable)
-    : Expression(expCtx), _fieldPath(theFieldPath), _variable(variable) {}
+    : Expression(expCtx),
+      _fieldPath(theFieldPath),
+      _variable(variable),
+      _slotCaches(_fieldPath.getPathLength()) {}
 
 intrusive_ptr<Expression> ExpressionFieldPath::optimize() {
     if (_variable == Variables::kRemoveId) {
@@ -1869,10 +1881,10 @@ Value ExpressionFieldPath::evaluatePath(size_t index, const Document& input) con
 
     /* if we've hit the end of the path, stop */
     if (index == _fieldPath.getPathLength() - 1)
-        return input[_fieldPath.getFieldName(index)];
+        return input.getField(_fieldPath.getFieldName(index), &_slotCaches[index]);
 
     // Try to dive deeper
-    const Value val = input[_fieldPath.getFieldName(index)];
+    const Value val = input.getField(_fieldPath.getFieldName(index), &_slotCaches[index]);
     switch (val.getType()) {
         case Object:
             return evaluatePath(index + 1, val.getDocument());
@@ -4027,7 +4039,10 @@ const char* ExpressionStrLenCP::getOpName() const {
 Value ExpressionSubtract::evaluate(const Document& root) const {
     Value lhs = vpOperand[0]->evaluate(root);
     Value rhs = vpOperand[1]->evaluate(root);
+    return apply(lhs, rhs);
+}
 
+Value ExpressionSubtract::apply(const Value& lhs, const Value& rhs) {
     BSONType diffType = Value::getWidestNumeric(rhs.getType(), lhs.getType());
 
     if (diffType == NumberDecimal) {
@@ -210,6 +210,10 @@ public:
      */
     static void registerExpression(std::string key, Parser parser);
 
+    const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
+        return _expCtx;
+    }
+
 protected:
     Expression(const boost::intrusive_ptr<ExpressionContext>& expCtx) : _expCtx(expCtx) {
         auto varIds = _expCtx->variablesParseState.getDefinedVariableIDs();
@@ -220,10 +224,6 @@ protected:
 
     typedef std::vector<boost::intrusive_ptr<Expression>> ExpressionVector;
 
-    const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
-        return _expCtx;
-    }
-
     virtual void _doAddDependencies(DepsTracker* deps) const = 0;
 
 private:
@@ -264,6 +264,10 @@ public:
     /// Allow subclasses the opportunity to validate arguments at parse time.
     virtual void validateArguments(const ExpressionVector& args) const {}
 
+    const ExpressionVector& getOperandList() const {
+        return vpOperand;
+    }
+
     static ExpressionVector parseArguments(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                            BSONElement bsonExpr,
                                            const VariablesParseState& vps);
@@ -797,6 +801,18 @@ public:
         const boost::intrusive_ptr<Expression>& exprLeft,
         const boost::intrusive_ptr<Expression>& exprRight);
 
+    /**
+     * Returns the result of comparing 'lhs' to 'rhs' with 'cmpOp' under 'comparator'.
+     */
+    static Value apply(CmpOp cmpOp,
+                       const ValueComparator& comparator,
+                       const Value& lhs,
+                       const Value& rhs);
+
+    CmpOp getOp() const {
+        return cmpOp;
+    }
+
 private:
     CmpOp cmpOp;
 };
@@ -1017,6 +1033,11 @@ public:
 
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
+
+    /**
+     * Returns 'lhs' divided by 'rhs'.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
 };
 
 
@@ -1093,6 +1114,10 @@ private:
 
     const FieldPath _fieldPath;
     const Variables::Id _variable;
+
+    // Where each component of '_fieldPath' was last found, indexed like the path. Like the rest
+    // of an Expression these are only used by one thread at a time.
+    mutable std::vector<DocumentShape::FieldSlotCache> _slotCaches;
 };
 
 
@@ -1708,6 +1733,11 @@ public:
 
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
+
+    /**
+     * Returns 'rhs' subtracted from 'lhs'.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
 };
 
 
@@ -0,0 +1,276 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_bytecode.h"
+
+#include <algorithm>
+
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+/**
+ * Emits the code for an Expression tree. Registers are handed out like a stack: the code for a
+ * subexpression may use any register above the one it writes its result to, and those are free
+ * again once it is done.
+ */
+class ExpressionBytecode::Compiler {
+public:
+    explicit Compiler(ExpressionBytecode* program) : _program(program) {}
+
+    /**
+     * Emits code which leaves the value of 'expr' in register 'dst'. Returns false, emitting
+     * nothing, if 'expr' has no instruction of its own and 'allowTreeCall' is false.
+     */
+    bool compile(const Expression* expr, uint32_t dst, bool allowTreeCall = true) {
+        if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+            emit(OpCode::kLoadConstant, dst, addConstant(constant->getValue()));
+        } else if (auto compare = dynamic_cast<const ExpressionCompare*>(expr)) {
+            compileBinary(OpCode::kCompare, compare, dst, compare->getOp());
+        } else if (auto subtract = dynamic_cast<const ExpressionSubtract*>(expr)) {
+            compileBinary(OpCode::kSubtract, subtract, dst);
+        } else if (auto divide = dynamic_cast<const ExpressionDivide*>(expr)) {
+            compileBinary(OpCode::kDivide, divide, dst);
+        } else if (auto notExpr = dynamic_cast<const ExpressionNot*>(expr)) {
+            compileNot(notExpr, dst);
+        } else if (auto andExpr = dynamic_cast<const ExpressionAnd*>(expr)) {
+            compileLogical(andExpr, dst, OpCode::kJumpIfFalse);
+        } else if (auto orExpr = dynamic_cast<const ExpressionOr*>(expr)) {
+            compileLogical(orExpr, dst, OpCode::kJumpIfTrue);
+        } else if (auto cond = dynamic_cast<const ExpressionCond*>(expr)) {
+            compileCond(cond, dst);
+        } else if (auto ifNull = dynamic_cast<const ExpressionIfNull*>(expr)) {
+            compileIfNull(ifNull, dst);
+        } else if (auto object = dynamic_cast<const ExpressionObject*>(expr)) {
+            compileObject(object, dst);
+        } else if (allowTreeCall) {
+            emit(OpCode::kEvaluateTree, dst, addExpression(expr));
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    uint32_t numRegisters() const {
+        return _maxRegisters;
+    }
+
+private:
+    /**
+     * Reserves 'count' consecutive registers above 'dst' and returns the first of them.
+     */
+    uint32_t temporaries(uint32_t dst, uint32_t count) {
+        _maxRegisters = std::max(_maxRegisters, dst + 1 + count);
+        return dst + 1;
+    }
+
+    size_t emit(OpCode op, uint32_t dst, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0) {
+        _program->_code.push_back({op, dst, a, b, c});
+        return _program->_code.size() - 1;
+    }
+
+    uint32_t here() const {
+        return _program->_code.size();
+    }
+
+    /**
+     * Points the jump emitted at 'jump' at the next instruction to be emitted.
+     */
+    void patchJump(size_t jump) {
+        auto& instruction = _program->_code[jump];
+        if (instruction.op == OpCode::kJump) {
+            instruction.a = here();
+        } else {
+            instruction.b = here();
+        }
+    }
+
+    uint32_t addConstant(Value value) {
+        _program->_constants.push_back(std::move(value));
+        return _program->_constants.size() - 1;
+    }
+
+    uint32_t addExpression(const Expression* expr) {
+        _program->_expressions.push_back(expr);
+        return _program->_expressions.size() - 1;
+    }
+
+    void compileBinary(OpCode op, const ExpressionNary* expr, uint32_t dst, uint32_t c = 0) {
+        const auto& operands = expr->getOperandList();
+        invariant(operands.size() == 2);
+        const uint32_t lhs = temporaries(dst, 2);
+        const uint32_t rhs = lhs + 1;
+        compile(operands[0].get(), lhs);
+        compile(operands[1].get(), rhs);
+        emit(op, dst, lhs, rhs, c);
+    }
+
+    void compileNot(const ExpressionNot* expr, uint32_t dst) {
+        const auto& operands = expr->getOperandList();
+        invariant(operands.size() == 1);
+        compile(operands[0].get(), dst);
+        emit(OpCode::kNot, dst, dst);
+    }
+
+    /**
+     * $and and $or: each operand is evaluated in turn, and the first one which is false, for $and,
+     * or true, for $or, decides the result without evaluating the rest.
+     */
+    void compileLogical(const ExpressionNary* expr, uint32_t dst, OpCode shortCircuit) {
+        const bool shortCircuitResult = shortCircuit == OpCode::kJumpIfTrue;
+
+        std::vector<size_t> jumpsToShortCircuit;
+        for (auto&& operand : expr->getOperandList()) {
+            compile(operand.get(), dst);
+            jumpsToShortCircuit.push_back(emit(shortCircuit, 0, dst));
+        }
+
+        emit(OpCode::kLoadConstant, dst, addConstant(Value(!shortCircuitResult)));
+        const size_t jumpToEnd = emit(OpCode::kJump, 0);
+
+        for (auto jump : jumpsToShortCircuit) {
+            patchJump(jump);
+        }
+        emit(OpCode::kLoadConstant, dst, addConstant(Value(shortCircuitResult)));
+        patchJump(jumpToEnd);
+    }
+
+    void compileCond(const ExpressionCond* expr, uint32_t dst) {
+        const auto& operands = expr->getOperandList();
+        invariant(operands.size() == 3);
+
+        compile(operands[0].get(), dst);
+        const size_t jumpToElse = emit(OpCode::kJumpIfFalse, 0, dst);
+        compile(operands[1].get(), dst);
+        const size_t jumpToEnd = emit(OpCode::kJump, 0);
+        patchJump(jumpToElse);
+        compile(operands[2].get(), dst);
+        patchJump(jumpToEnd);
+    }
+
+    void compileIfNull(const ExpressionIfNull* expr, uint32_t dst) {
+        const auto& operands = expr->getOperandList();
+        invariant(operands.size() == 2);
+
+        compile(operands[0].get(), dst);
+        const size_t jumpToEnd = emit(OpCode::kJumpIfNotNullish, 0, dst);
+        compile(operands[1].get(), dst);
+        patchJump(jumpToEnd);
+    }
+
+    void compileObject(const ExpressionObject* expr, uint32_t dst) {
+        const auto& children = expr->getChildExpressions();
+        const uint32_t first = temporaries(dst, children.size());
+        const uint32_t firstFieldName = _program->_fieldNames.size();
+        for (size_t i = 0; i < children.size(); i++) {
+            _program->_fieldNames.push_back(children[i].first);
+            compile(children[i].second.get(), first + i);
+        }
+        emit(OpCode::kMakeObject, dst, first, children.size(), firstFieldName);
+    }
+
+    ExpressionBytecode* const _program;
+    uint32_t _maxRegisters = 1;
+};
+
+ExpressionBytecode::ExpressionBytecode(const intrusive_ptr<Expression>& expression)
+    : _root(expression) {}
+
+std::unique_ptr<ExpressionBytecode> ExpressionBytecode::compile(
+    const intrusive_ptr<Expression>& expression) {
+    std::unique_ptr<ExpressionBytecode> program(new ExpressionBytecode(expression));
+    Compiler compiler(program.get());
+    if (!compiler.compile(expression.get(), 0, false)) {
+        return nullptr;
+    }
+    program->_registers.resize(compiler.numRegisters());
+    return program;
+}
+
+Value ExpressionBytecode::evaluate(const Document& root) const {
+    const auto& comparator = _root->getExpressionContext()->getValueComparator();
+    Value* const reg = _registers.data();
+
+    const size_t end = _code.size();
+    for (size_t pc = 0; pc < end; ++pc) {
+        const Instruction& in = _code[pc];
+        switch (in.op) {
+            case OpCode::kLoadConstant:
+                reg[in.dst] = _constants[in.a];
+                break;
+            case OpCode::kEvaluateTree:
+                reg[in.dst] = _expressions[in.a]->evaluate(root);
+                break;
+            case OpCode::kCompare:
+                reg[in.dst] = ExpressionCompare::apply(
+                    static_cast<ExpressionCompare::CmpOp>(in.c), comparator, reg[in.a], reg[in.b]);
+                break;
+            case OpCode::kSubtract:
+                reg[in.dst] = ExpressionSubtract::apply(reg[in.a], reg[in.b]);
+                break;
+            case OpCode::kDivide:
+                reg[in.dst] = ExpressionDivide::apply(reg[in.a], reg[in.b]);
+                break;
+            case OpCode::kNot:
+                reg[in.dst] = Value(!reg[in.a].coerceToBool());
+                break;
+            case OpCode::kJump:
+                pc = in.a - 1;
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!reg[in.a].coerceToBool())
+                    pc = in.b - 1;
+                break;
+            case OpCode::kJumpIfTrue:
+                if (reg[in.a].coerceToBool())
+                    pc = in.b - 1;
+                break;
+            case OpCode::kJumpIfNotNullish:
+                if (!reg[in.a].nullish())
+                    pc = in.b - 1;
+                break;
+            case OpCode::kMakeObject: {
+                MutableDocument outputDoc(in.b);
+                for (uint32_t i = 0; i < in.b; i++) {
+                    outputDoc.addField(_fieldNames[in.c + i], std::move(reg[in.a + i]));
+                }
+                reg[in.dst] = outputDoc.freezeToValue();
+                break;
+            }
+        }
+    }
+
+    return std::move(reg[0]);
+}
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * An optimized Expression tree lowered to a flat, register-based program which is run by a single
+ * dispatch loop rather than by recursive calls to Expression::evaluate().
+ *
+ * Only some operators have an instruction of their own. Any other subexpression, including every
+ * leaf apart from constants, is evaluated through the original Expression tree, so a program
+ * always produces the same result as the tree it was compiled from.
+ *
+ * evaluate() keeps its registers in the program, so a program must not be used by more than one
+ * thread at a time. The Expression tree must outlive the program.
+ */
+class ExpressionBytecode {
+    MONGO_DISALLOW_COPYING(ExpressionBytecode);
+
+public:
+    /**
+     * Compiles 'expression'. Returns nullptr if the root of 'expression' has no instruction of its
+     * own, since such a program would do nothing but call the tree.
+     */
+    static std::unique_ptr<ExpressionBytecode> compile(
+        const boost::intrusive_ptr<Expression>& expression);
+
+    /**
+     * Runs the program against 'root', with the same result as 'expression'->evaluate(root).
+     */
+    Value evaluate(const Document& root) const;
+
+    size_t numInstructions() const {
+        return _code.size();
+    }
+
+    /**
+     * Returns the number of subexpressions which are evaluated through the Expression tree.
+     */
+    size_t numTreeCalls() const {
+        return _expressions.size();
+    }
+
+private:
+    class Compiler;
+
+    enum class OpCode : uint8_t {
+        kLoadConstant,       // reg[dst] = constants[a]
+        kEvaluateTree,       // reg[dst] = expressions[a]->evaluate(root)
+        kCompare,            // reg[dst] = ExpressionCompare::apply(CmpOp(c), reg[a], reg[b])
+        kSubtract,           // reg[dst] = ExpressionSubtract::apply(reg[a], reg[b])
+        kDivide,             // reg[dst] = ExpressionDivide::apply(reg[a], reg[b])
+        kNot,                // reg[dst] = !reg[a].coerceToBool()
+        kJump,               // pc = a
+        kJumpIfFalse,        // if !reg[a].coerceToBool(), pc = b
+        kJumpIfTrue,         // if reg[a].coerceToBool(), pc = b
+        kJumpIfNotNullish,   // if !reg[a].nullish(), pc = b
+        kMakeObject,         // reg[dst] = {fieldNames[c + i]: reg[a + i] for i in [0, b)}
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t dst;
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+    };
+
+    explicit ExpressionBytecode(const boost::intrusive_ptr<Expression>& expression);
+
+    // The compiled expression. Holding it keeps alive the subexpressions in '_expressions'.
+    const boost::intrusive_ptr<Expression> _root;
+
+    std::vector<Instruction> _code;
+    std::vector<Value> _constants;
+    std::vector<const Expression*> _expressions;
+    std::vector<std::string> _fieldNames;
+
+    // The result is always left in register 0.
+    mutable std::vector<Value> _registers;
+};
+
+}  // namespace mongo
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_bytecode.h"
+
+#include <vector>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+class ExpressionBytecodeTest : public AggregationContextFixture {
+protected:
+    intrusive_ptr<Expression> parse(const std::string& json) {
+        auto spec = fromjson("{expr: " + json + "}");
+        auto expCtx = getExpCtx();
+        return Expression::parseOperand(
+                   expCtx, spec.firstElement(), expCtx->variablesParseState)
+            ->optimize();
+    }
+
+    /**
+     * Asserts that the compiled form of 'json' gives the same result, or error, as the tree for
+     * each of 'inputs'.
+     */
+    void assertSameAsTree(const std::string& json, const std::vector<Document>& inputs) {
+        auto expr = parse(json);
+        auto compiled = ExpressionBytecode::compile(expr);
+        ASSERT(compiled) << json;
+
+        for (auto&& input : inputs) {
+            boost::optional<Value> expected;
+            int expectedCode = 0;
+            try {
+                expected = expr->evaluate(input);
+            } catch (const AssertionException& ex) {
+                expectedCode = ex.code();
+            }
+
+            if (expected) {
+                ASSERT_VALUE_EQ(compiled->evaluate(input), *expected);
+            } else {
+                ASSERT_THROWS_CODE(compiled->evaluate(input), AssertionException, expectedCode);
+            }
+        }
+    }
+
+    const std::vector<Document> kInputs = {
+        Document{},
+        Document{{"a", 1}, {"b", 2}},
+        Document{{"a", 2.5}, {"b", 0}},
+        Document{{"a", BSONNULL}, {"b", "str"_sd}},
+        Document{{"a", Document{{"x", 1}, {"y", "abc"_sd}}}, {"b", 10LL}},
+        Document{{"a", Date_t::fromMillisSinceEpoch(1000)}, {"b", 10}},
+    };
+};
+
+TEST_F(ExpressionBytecodeTest, ReturnsNullForExpressionsWithoutInstructions) {
+    ASSERT_FALSE(ExpressionBytecode::compile(parse("'$a'")));
+    ASSERT_FALSE(ExpressionBytecode::compile(parse("{$add: ['$a', '$b']}")));
+}
+
+TEST_F(ExpressionBytecodeTest, ComparisonsMatchTree) {
+    for (auto op : {"$eq", "$ne", "$gt", "$gte", "$lt", "$lte", "$cmp"}) {
+        assertSameAsTree(std::string("{") + op + ": ['$a', '$b']}", kInputs);
+    }
+}
+
+TEST_F(ExpressionBytecodeTest, ArithmeticMatchesTree) {
+    assertSameAsTree("{$subtract: ['$a', '$b']}", kInputs);
+    assertSameAsTree("{$divide: ['$a', '$b']}", kInputs);
+    assertSameAsTree("{$divide: [{$subtract: ['$b', 1]}, {$add: ['$a', 1]}]}", kInputs);
+}
+
+TEST_F(ExpressionBytecodeTest, LogicalOperatorsMatchTree) {
+    assertSameAsTree("{$and: ['$a', '$b']}", kInputs);
+    assertSameAsTree("{$or: ['$a', '$b']}", kInputs);
+    assertSameAsTree("{$not: ['$a']}", kInputs);
+    assertSameAsTree("{$and: [{$or: ['$a', {$not: ['$b']}]}, {$gt: ['$b', 1]}]}", kInputs);
+}
+
+TEST_F(ExpressionBytecodeTest, LogicalOperatorsShortCircuit) {
+    // The $divide would throw if it were evaluated.
+    auto andExpr = ExpressionBytecode::compile(parse("{$and: ['$a', {$divide: [1, '$b']}]}"));
+    ASSERT_VALUE_EQ(andExpr->evaluate(Document{{"a", false}, {"b", 0}}), Value(false));
+
+    auto orExpr = ExpressionBytecode::compile(parse("{$or: ['$a', {$divide: [1, '$b']}]}"));
+    ASSERT_VALUE_EQ(orExpr->evaluate(Document{{"a", true}, {"b", 0}}), Value(true));
+    ASSERT_THROWS_CODE(
+        orExpr->evaluate(Document{{"a", false}, {"b", 0}}), AssertionException, 16608);
+}
+
+TEST_F(ExpressionBytecodeTest, ConditionalsMatchTree) {
+    assertSameAsTree("{$cond: ['$a', '$b', {$subtract: ['$b', 1]}]}", kInputs);
+    assertSameAsTree("{$cond: {if: {$eq: ['$b', 2]}, then: 'two', else: '$a'}}", kInputs);
+    assertSameAsTree("{$ifNull: ['$a', {$not: ['$b']}]}", kInputs);
+}
+
+TEST_F(ExpressionBytecodeTest, ObjectsMatchTree) {
+    assertSameAsTree("{x: '$a', y: {$gt: ['$b', 1]}, z: {w: '$missing', v: {$not: ['$a']}}}",
+                     kInputs);
+}
+
+TEST_F(ExpressionBytecodeTest, FallsBackToTreeForOtherOperators) {
+    auto expr = parse("{$cond: [{$gt: [{$add: ['$a', '$b']}, 2]}, {$concat: ['x', 'y']}, '$b']}");
+    auto compiled = ExpressionBytecode::compile(expr);
+    ASSERT(compiled);
+    ASSERT_EQ(compiled->numTreeCalls(), 2U);
+    assertSameAsTree("{$cond: [{$gt: [{$add: ['$a', '$b']}, 2]}, {$concat: ['x', 'y']}, '$b']}",
+                     kInputs);
+}
+
+TEST_F(ExpressionBytecodeTest, ComparisonsRespectCollation) {
+    auto collator =
+        stdx::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    getExpCtx()->setCollator(std::move(collator));
+
+    auto compiled = ExpressionBytecode::compile(parse("{$eq: ['$a', 'abc']}"));
+    ASSERT_VALUE_EQ(compiled->evaluate(Document{{"a", "xyz"_sd}}), Value(true));
+}
+
+}  // namespace
+}  // namespace mongo
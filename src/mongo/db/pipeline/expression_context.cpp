@@ -88,6 +88,10 @@ intrusive_ptr<ExpressionContext> ExpressionContext::copyWith(NamespaceString ns,
     expCtx->bypassDocumentValidation = bypassDocumentValidation;
 
     expCtx->tempDir = tempDir;
+    expCtx->documentArena = documentArena;
+    if (documentShapes) {
+        expCtx->documentShapes = new DocumentShapeTable();
+    }
 
     expCtx->opCtx = opCtx;
 
@@ -130,6 +130,16 @@ public:
     boost::optional<UUID> uuid;
     std::string tempDir;  // Defaults to empty to prevent external sorting in mongos.
 
+    // If set, the arena in which the pipeline makes its Documents and strings. The current chunk
+    // of the arena is retired each time the pipeline is detached from its operation context, that
+    // is, once each batch of results has been returned.
+    std::shared_ptr<RefCountedArena> documentArena;
+
+    // If set, the table which interns the shapes of the Documents the pipeline makes, which lets
+    // field path lookups skip hashing for documents of a shape seen before. A copy of this context
+    // gets its own table, since a table may only be current on one thread at a time.
+    boost::intrusive_ptr<DocumentShapeTable> documentShapes;
+
     OperationContext* opCtx;
 
     // Collation requested by the user for this pipeline. Empty if the user did not request a
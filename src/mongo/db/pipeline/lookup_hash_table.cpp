@@ -0,0 +1,318 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+
+#include "mongo/db/pipeline/document_path_support.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/stringutils.h"
+
+namespace mongo {
+
+namespace {
+
+// Rough per-key cost of a table entry, on top of the key and the position it holds.
+const size_t kTableEntryOverheadBytes = 32;
+
+/**
+ * Orders Sorter entries by their keys.
+ */
+class KeyComparator {
+public:
+    explicit KeyComparator(const ValueComparator& comparator) : _comparator(comparator) {}
+
+    template <typename Data>
+    int operator()(const Data& lhs, const Data& rhs) const {
+        return _comparator.compare(lhs.first, rhs.first);
+    }
+
+private:
+    const ValueComparator _comparator;
+};
+
+/**
+ * Returns true if equality on 'value' as computed by ValueComparator gives the same result as a
+ * {$eq: <value>} query. Nulls and undefined also match missing fields, regular expressions and
+ * arrays have special matching semantics, so those are always joined with a query.
+ */
+bool isHashableKey(const Value& value) {
+    switch (value.getType()) {
+        case BSONType::jstNULL:
+        case BSONType::Undefined:
+        case BSONType::RegEx:
+        case BSONType::Array:
+            return false;
+        default:
+            return true;
+    }
+}
+
+}  // namespace
+
+LookupHashTable::LookupHashTable(const ValueComparator& comparator,
+                                 FieldPath foreignField,
+                                 SortOptions options)
+    : _comparator(comparator),
+      _foreignField(std::move(foreignField)),
+      _options(std::move(options)),
+      _table(_comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+bool LookupHashTable::isSupportedForeignField(const FieldPath& foreignField) {
+    // The first component of a path is always treated as a field name.
+    for (size_t i = 1; i < foreignField.getPathLength(); ++i) {
+        if (parseUnsignedBase10Integer(foreignField.getFieldName(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LookupHashTable::extractLocalKeys(const Document& localDoc,
+                                       const FieldPath& localField,
+                                       std::vector<Value>* keys) const {
+    keys->clear();
+    bool hashable = true;
+    auto seen = _comparator.makeUnorderedValueSet();
+    document_path_support::visitAllValuesAtPath(localDoc, localField, [&](const Value& value) {
+        if (!isHashableKey(value)) {
+            hashable = false;
+        } else if (seen.insert(value).second) {
+            keys->push_back(value);
+        }
+    });
+
+    // A local document with no values at 'localField' is joined as if it had a null value.
+    return hashable && !keys->empty();
+}
+
+void LookupHashTable::extractForeignKeys(const Document& foreignDoc,
+                                         std::vector<Value>* keys) const {
+    auto seen = _comparator.makeUnorderedValueSet();
+    document_path_support::visitAllValuesAtPath(foreignDoc, _foreignField, [&](const Value& value) {
+        if (isHashableKey(value) && seen.insert(value).second) {
+            keys->push_back(value);
+        }
+    });
+}
+
+bool LookupHashTable::addForeignDocument(const Document& foreignDoc) {
+    invariant(!_doneAddingForeign);
+
+    std::vector<Value> keys;
+    extractForeignKeys(foreignDoc, &keys);
+    if (keys.empty()) {
+        // Such a document can only ever be matched by a local document which is joined with a
+        // query, and that query will find it on its own.
+        return true;
+    }
+
+    const long long position = _numForeignDocs++;
+    if (_foreignSorter) {
+        for (auto&& key : keys) {
+            _foreignSorter->add(key, Document{{"s", position}, {"d", foreignDoc}});
+        }
+        return true;
+    }
+
+    _foreignDocs.push_back(foreignDoc.getOwned());
+    _memoryUsageBytes += foreignDoc.getApproximateSize();
+    for (auto&& key : keys) {
+        _table[key].push_back(position);
+        _memoryUsageBytes += key.getApproximateSize() + sizeof(size_t) + kTableEntryOverheadBytes;
+    }
+    _memoryCharge.set(_memoryUsageBytes);
+
+    if (_memoryUsageBytes > _options.maxMemoryUsageBytes) {
+        if (!_options.extSortAllowed) {
+            return false;
+        }
+        spill();
+    }
+    return true;
+}
+
+void LookupHashTable::spill() {
+    invariant(!_foreignSorter);
+    _foreignSorter.reset(ForeignSorter::make(_options, KeyComparator(_comparator)));
+    for (auto&& entry : _table) {
+        for (auto position : entry.second) {
+            _foreignSorter->add(
+                entry.first,
+                Document{{"s", static_cast<long long>(position)}, {"d", _foreignDocs[position]}});
+        }
+    }
+
+    _table.clear();
+    _foreignDocs.clear();
+    _foreignDocs.shrink_to_fit();
+    _memoryUsageBytes = 0;
+    _memoryCharge.set(0);
+}
+
+void LookupHashTable::doneAddingForeign() {
+    invariant(!_doneAddingForeign);
+    _doneAddingForeign = true;
+
+    if (_foreignSorter) {
+        _localKeySorter.reset(LocalKeySorter::make(_options, KeyComparator(_comparator)));
+        _localDocSorter.reset(LocalDocSorter::make(_options, KeyComparator(ValueComparator())));
+    }
+}
+
+std::vector<Value> LookupHashTable::probe(const std::vector<Value>& keys) const {
+    invariant(_doneAddingForeign && !isSpilled());
+
+    std::vector<size_t> positions;
+    for (auto&& key : keys) {
+        auto it = _table.find(key);
+        if (it != _table.end()) {
+            positions.insert(positions.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // A foreign document matching several of the keys must only be returned once.
+    if (keys.size() > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    std::vector<Value> results;
+    results.reserve(positions.size());
+    for (auto position : positions) {
+        results.emplace_back(_foreignDocs[position]);
+    }
+    return results;
+}
+
+void LookupHashTable::addLocalDocument(Document localDoc,
+                                       boost::optional<std::vector<Value>> keys) {
+    invariant(_doneAddingForeign && _localDocSorter);
+
+    const long long position = _numLocalDocs++;
+    _localDocSorter->add(Value(position),
+                         Document{{"d", std::move(localDoc)}, {"q", !static_cast<bool>(keys)}});
+    if (keys) {
+        for (auto&& key : *keys) {
+            _localKeySorter->add(key, Value(position));
+        }
+    }
+}
+
+void LookupHashTable::doneAddingLocal() {
+    invariant(_localDocSorter && !_localDocs);
+
+    std::unique_ptr<ForeignSorter::Iterator> foreign(_foreignSorter->done());
+    _foreignSorter.reset();
+    std::unique_ptr<LocalKeySorter::Iterator> localKeys(_localKeySorter->done());
+    _localKeySorter.reset();
+
+    // Merge join the two sides, producing a (local position, foreign position) pair for every
+    // match. The pairs are sorted so that each local document's matches come out together and in
+    // the order in which the foreign documents were added.
+    std::unique_ptr<PairSorter> pairs(PairSorter::make(_options, KeyComparator(ValueComparator())));
+    boost::optional<ForeignSorter::Data> nextForeign;
+    boost::optional<LocalKeySorter::Data> nextLocal;
+    auto advanceForeign = [&] {
+        nextForeign = foreign->more() ? boost::make_optional(foreign->next()) : boost::none;
+    };
+    auto advanceLocal = [&] {
+        nextLocal = localKeys->more() ? boost::make_optional(localKeys->next()) : boost::none;
+    };
+
+    advanceForeign();
+    advanceLocal();
+    while (nextForeign && nextLocal) {
+        const int cmp = _comparator.compare(nextForeign->first, nextLocal->first);
+        if (cmp < 0) {
+            advanceForeign();
+            continue;
+        }
+        if (cmp > 0) {
+            advanceLocal();
+            continue;
+        }
+
+        const Value key = nextLocal->first.getOwned();
+        std::vector<long long> localPositions;
+        while (nextLocal && _comparator.compare(nextLocal->first, key) == 0) {
+            localPositions.push_back(nextLocal->second.getLong());
+            advanceLocal();
+        }
+        while (nextForeign && _comparator.compare(nextForeign->first, key) == 0) {
+            const Value foreignPosition = nextForeign->second["s"];
+            const Document foreignDoc = nextForeign->second["d"].getDocument();
+            for (auto localPosition : localPositions) {
+                pairs->add(Value(std::vector<Value>{Value(localPosition), foreignPosition}),
+                           foreignDoc);
+            }
+            advanceForeign();
+        }
+    }
+
+    _pairs.reset(pairs->done());
+    _localDocs.reset(_localDocSorter->done());
+    _localDocSorter.reset();
+    advancePairs();
+}
+
+void LookupHashTable::advancePairs() {
+    _nextPair = _pairs->more() ? boost::make_optional(_pairs->next()) : boost::none;
+}
+
+std::pair<Document, boost::optional<std::vector<Value>>> LookupHashTable::getNextOutput() {
+    invariant(hasNextOutput());
+
+    auto next = _localDocs->next();
+    const long long position = next.first.getLong();
+    Document localDoc = next.second["d"].getDocument();
+    if (next.second["q"].getBool()) {
+        return {std::move(localDoc), boost::none};
+    }
+
+    std::vector<Value> results;
+    boost::optional<long long> lastForeignPosition;
+    while (_nextPair && _nextPair->first[0].getLong() == position) {
+        // A foreign document matched through several keys has one pair per key.
+        const long long foreignPosition = _nextPair->first[1].getLong();
+        if (foreignPosition != lastForeignPosition) {
+            results.emplace_back(std::move(_nextPair->second));
+            lastForeignPosition = foreignPosition;
+        }
+        advancePairs();
+    }
+    return {std::move(localDoc), std::move(results)};
+}
+
+}  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/util/memory_accounting.h"
+
+namespace mongo {
+
+/**
+ * Holds the foreign side of a $lookup with localField/foreignField syntax that is executed as a
+ * hash join. The foreign documents are read once and indexed by every value they have at
+ * 'foreignField', after which each local document is joined by probing with its values at the
+ * local field rather than by querying the foreign collection.
+ *
+ * Only keys whose equality semantics match those of the $eq/$in query that a $lookup would
+ * otherwise issue are hashed. Local documents with other keys (null, missing, undefined, regular
+ * expressions or arrays) must still be joined with a query; see extractLocalKeys().
+ *
+ * If the table grows past its memory limit and the SortOptions allow external sorting, it spills:
+ * the foreign documents are written to a Sorter keyed on the join key, all local documents are
+ * buffered through further Sorters, and the two sides are merge joined once the local input is
+ * exhausted. Results are then returned in the original local document order.
+ */
+class LookupHashTable {
+    MONGO_DISALLOW_COPYING(LookupHashTable);
+
+public:
+    /**
+     * 'comparator' defines key equality and must use the same collation as the foreign pipeline.
+     * 'options.maxMemoryUsageBytes' is the memory limit for the in-memory table.
+     */
+    LookupHashTable(const ValueComparator& comparator, FieldPath foreignField, SortOptions options);
+
+    /**
+     * Returns true if values at 'foreignField' can be extracted the same way the query system
+     * traverses that path. Paths with numeric components are excluded, since the query system
+     * interprets those as both field names and array positions.
+     */
+    static bool isSupportedForeignField(const FieldPath& foreignField);
+
+    /**
+     * Collects the distinct values of 'localField' in 'localDoc' into 'keys' and returns true, or
+     * returns false if 'localDoc' must be joined with a query instead.
+     */
+    bool extractLocalKeys(const Document& localDoc,
+                          const FieldPath& localField,
+                          std::vector<Value>* keys) const;
+
+    /**
+     * Adds a document from the foreign side. Returns false if this exceeded the memory limit and
+     * spilling is not allowed, in which case the table must be discarded.
+     */
+    bool addForeignDocument(const Document& foreignDoc);
+
+    /**
+     * Ends the build phase.
+     */
+    void doneAddingForeign();
+
+    /**
+     * Returns true if the table spilled while it was built. A spilled table is used through
+     * addLocalDocument()/doneAddingLocal()/getNextOutput() rather than probe().
+     */
+    bool isSpilled() const {
+        return static_cast<bool>(_foreignSorter) || static_cast<bool>(_localDocSorter) ||
+            static_cast<bool>(_localDocs);
+    }
+
+    /**
+     * Returns the foreign documents matching any of 'keys', each once, in the order in which they
+     * were added. Only valid for a table that has not spilled.
+     */
+    std::vector<Value> probe(const std::vector<Value>& keys) const;
+
+    /**
+     * Adds the next local document to a spilled table, along with the keys returned by
+     * extractLocalKeys(), or boost::none if the document must be joined with a query.
+     */
+    void addLocalDocument(Document localDoc, boost::optional<std::vector<Value>> keys);
+
+    /**
+     * Joins the local documents added to a spilled table with the foreign side.
+     */
+    void doneAddingLocal();
+
+    bool isDoneAddingLocal() const {
+        return static_cast<bool>(_localDocs);
+    }
+
+    /**
+     * Returns true if a spilled table has more joined local documents to return.
+     */
+    bool hasNextOutput() const {
+        return _localDocs && _localDocs->more();
+    }
+
+    /**
+     * Returns the next local document of a spilled table, along with its matching foreign
+     * documents in the order they were added, or boost::none if it must be joined with a query.
+     */
+    std::pair<Document, boost::optional<std::vector<Value>>> getNextOutput();
+
+    size_t memoryUsageBytes() const {
+        return _memoryUsageBytes;
+    }
+
+private:
+    using ForeignSorter = Sorter<Value, Document>;
+    using LocalKeySorter = Sorter<Value, Value>;
+    using LocalDocSorter = Sorter<Value, Document>;
+    using PairSorter = Sorter<Value, Document>;
+
+    void extractForeignKeys(const Document& foreignDoc, std::vector<Value>* keys) const;
+
+    /**
+     * Moves the in-memory table into '_foreignSorter'.
+     */
+    void spill();
+
+    void advancePairs();
+
+    const ValueComparator _comparator;
+    const FieldPath _foreignField;
+    const SortOptions _options;
+
+    size_t _memoryUsageBytes = 0;
+    MemoryAccount::Charge _memoryCharge{&memory_accounts::aggregation};
+    bool _doneAddingForeign = false;
+    long long _numForeignDocs = 0;
+    long long _numLocalDocs = 0;
+
+    // The in-memory table. Maps each join key to the positions in '_foreignDocs' of the documents
+    // which have that key, in ascending order.
+    std::vector<Document> _foreignDocs;
+    ValueUnorderedMap<std::vector<size_t>> _table;
+
+    // State used once the table has spilled.
+    std::unique_ptr<ForeignSorter> _foreignSorter;
+    std::unique_ptr<LocalKeySorter> _localKeySorter;
+    std::unique_ptr<LocalDocSorter> _localDocSorter;
+    std::unique_ptr<LocalDocSorter::Iterator> _localDocs;
+    std::unique_ptr<PairSorter::Iterator> _pairs;
+    boost::optional<PairSorter::Data> _nextPair;
+};
+
+}  // namespace mongo
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kMemoryLimitBytes = 1024 * 1024;
+
+SortOptions inMemoryOptions() {
+    return SortOptions().MaxMemoryUsageBytes(kMemoryLimitBytes);
+}
+
+std::vector<Value> probeFor(const LookupHashTable& table, const Document& localDoc) {
+    std::vector<Value> keys;
+    ASSERT_TRUE(table.extractLocalKeys(localDoc, FieldPath("a"), &keys));
+    return table.probe(keys);
+}
+
+TEST(LookupHashTableTest, ProbeReturnsMatchingDocumentsInInsertionOrder) {
+    LookupHashTable table(ValueComparator(), FieldPath("b"), inMemoryOptions());
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 0 << "b" << 1)));
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 1 << "b" << 2)));
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 2 << "b" << 1)));
+    table.doneAddingForeign();
+    ASSERT_FALSE(table.isSpilled());
+
+    ASSERT_VALUE_EQ(Value(probeFor(table, DOC("a" << 1))),
+                    Value(std::vector<Value>{Value(DOC("_id" << 0 << "b" << 1)),
+                                             Value(DOC("_id" << 2 << "b" << 1))}));
+    ASSERT_VALUE_EQ(Value(probeFor(table, DOC("a" << 3))), Value(std::vector<Value>{}));
+}
+
+TEST(LookupHashTableTest, NumericKeysOfDifferentTypesMatch) {
+    LookupHashTable table(ValueComparator(), FieldPath("b"), inMemoryOptions());
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 0 << "b" << 1.0)));
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 1 << "b" << 1LL)));
+    table.doneAddingForeign();
+
+    ASSERT_EQ(probeFor(table, DOC("a" << 1)).size(), 2UL);
+}
+
+TEST(LookupHashTableTest, ArrayValuesMatchEachElementOnce) {
+    LookupHashTable table(ValueComparator(), FieldPath("b"), inMemoryOptions());
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 0 << "b" << DOC_ARRAY(1 << 2))));
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 1 << "b" << 3)));
+    table.doneAddingForeign();
+
+    // The foreign document with both 1 and 2 is returned once for a local array of both.
+    auto results = probeFor(table, DOC("a" << DOC_ARRAY(1 << 2 << 3)));
+    ASSERT_EQ(results.size(), 2UL);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(0));
+    ASSERT_VALUE_EQ(results[1]["_id"], Value(1));
+}
+
+TEST(LookupHashTableTest, DottedForeignFieldTraversesArrays) {
+    LookupHashTable table(ValueComparator(), FieldPath("b.c"), inMemoryOptions());
+    ASSERT_TRUE(table.addForeignDocument(
+        DOC("_id" << 0 << "b" << DOC_ARRAY(DOC("c" << 1) << DOC("c" << 2)))));
+    table.doneAddingForeign();
+
+    ASSERT_EQ(probeFor(table, DOC("a" << 2)).size(), 1UL);
+}
+
+TEST(LookupHashTableTest, KeysUseTheCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    LookupHashTable table(ValueComparator(&collator), FieldPath("b"), inMemoryOptions());
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 0 << "b"
+                                                   << "ABC"_sd)));
+    table.doneAddingForeign();
+
+    ASSERT_EQ(probeFor(table, DOC("a"
+                                  << "abc"_sd))
+                  .size(),
+              1UL);
+}
+
+TEST(LookupHashTableTest, LocalDocumentsWithQuerySemanticsCannotBeHashed) {
+    LookupHashTable table(ValueComparator(), FieldPath("b"), inMemoryOptions());
+    table.doneAddingForeign();
+
+    std::vector<Value> keys;
+    ASSERT_FALSE(table.extractLocalKeys(DOC("x" << 1), FieldPath("a"), &keys));
+    ASSERT_FALSE(table.extractLocalKeys(DOC("a" << BSONNULL), FieldPath("a"), &keys));
+    ASSERT_FALSE(table.extractLocalKeys(DOC("a" << BSONUndefined), FieldPath("a"), &keys));
+    ASSERT_FALSE(table.extractLocalKeys(DOC("a" << BSONRegEx("^a")), FieldPath("a"), &keys));
+    ASSERT_FALSE(
+        table.extractLocalKeys(DOC("a" << DOC_ARRAY(1 << BSONNULL)), FieldPath("a"), &keys));
+    ASSERT_FALSE(
+        table.extractLocalKeys(DOC("a" << DOC_ARRAY(DOC_ARRAY(1))), FieldPath("a"), &keys));
+    ASSERT_TRUE(table.extractLocalKeys(DOC("a" << DOC("b" << 1)), FieldPath("a"), &keys));
+}
+
+TEST(LookupHashTableTest, OnlyPathsWithoutPositionalComponentsAreSupported) {
+    ASSERT_TRUE(LookupHashTable::isSupportedForeignField(FieldPath("a.b")));
+    ASSERT_TRUE(LookupHashTable::isSupportedForeignField(FieldPath("0.b")));
+    ASSERT_FALSE(LookupHashTable::isSupportedForeignField(FieldPath("a.0")));
+    ASSERT_FALSE(LookupHashTable::isSupportedForeignField(FieldPath("a.1.b")));
+}
+
+TEST(LookupHashTableTest, ExceedingMemoryLimitFailsWhenSpillingIsNotAllowed) {
+    LookupHashTable table(ValueComparator(), FieldPath("b"), SortOptions().MaxMemoryUsageBytes(1));
+    ASSERT_FALSE(table.addForeignDocument(DOC("_id" << 0 << "b" << 1)));
+}
+
+TEST(LookupHashTableTest, SpilledTableJoinsLocalDocumentsInOrder) {
+    unittest::TempDir tempDir("LookupHashTableTest");
+    LookupHashTable table(
+        ValueComparator(),
+        FieldPath("b"),
+        SortOptions().MaxMemoryUsageBytes(1).ExtSortAllowed().TempDir(tempDir.path()));
+
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 0 << "b" << 2)));
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 1 << "b" << DOC_ARRAY(1 << 2))));
+    ASSERT_TRUE(table.addForeignDocument(DOC("_id" << 2 << "b" << 1)));
+    table.doneAddingForeign();
+    ASSERT_TRUE(table.isSpilled());
+
+    std::vector<Document> localDocs{DOC("a" << 2),
+                                    DOC("a" << BSONNULL),
+                                    DOC("a" << 3),
+                                    DOC("a" << DOC_ARRAY(1 << 2))};
+    for (auto&& localDoc : localDocs) {
+        std::vector<Value> keys;
+        if (table.extractLocalKeys(localDoc, FieldPath("a"), &keys)) {
+            table.addLocalDocument(localDoc, std::move(keys));
+        } else {
+            table.addLocalDocument(localDoc, boost::none);
+        }
+    }
+    table.doneAddingLocal();
+
+    auto next = table.getNextOutput();
+    ASSERT_DOCUMENT_EQ(next.first, localDocs[0]);
+    ASSERT_TRUE(next.second);
+    ASSERT_VALUE_EQ(Value(*next.second),
+                    Value(std::vector<Value>{Value(DOC("_id" << 0 << "b" << 2)),
+                                             Value(DOC("_id" << 1 << "b" << DOC_ARRAY(1 << 2)))}));
+
+    next = table.getNextOutput();
+    ASSERT_DOCUMENT_EQ(next.first, localDocs[1]);
+    ASSERT_FALSE(next.second);
+
+    next = table.getNextOutput();
+    ASSERT_DOCUMENT_EQ(next.first, localDocs[2]);
+    ASSERT_TRUE(next.second);
+    ASSERT_TRUE(next.second->empty());
+
+    // Each foreign document is returned once, in the order in which they were added.
+    next = table.getNextOutput();
+    ASSERT_DOCUMENT_EQ(next.first, localDocs[3]);
+    ASSERT_TRUE(next.second);
+    ASSERT_EQ(next.second->size(), 3UL);
+    ASSERT_VALUE_EQ((*next.second)[0]["_id"], Value(0));
+    ASSERT_VALUE_EQ((*next.second)[1]["_id"], Value(1));
+    ASSERT_VALUE_EQ((*next.second)[2]["_id"], Value(2));
+
+    ASSERT_FALSE(table.hasNextOutput());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 #include <memory>
 
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_bytecode.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
 #include "mongo/stdx/memory.h"
@@ -169,6 +170,10 @@ private:
     std::vector<std::string> _orderToProcessAdditionsAndChildren;
 
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
+
+    // Bytecode for those of '_expressions' which could be compiled, built by optimize().
+    stdx::unordered_map<std::string, std::unique_ptr<ExpressionBytecode>> _compiledExpressions;
+
     stdx::unordered_set<std::string> _inclusions;
 
     // TODO use StringMap once SERVER-23700 is resolved.
@@ -254,6 +254,10 @@ bool Pipeline::aggSupportsWriteConcern(const BSONObj& cmd) {
 void Pipeline::detachFromOperationContext() {
     pCtx->opCtx = nullptr;
 
+    if (pCtx->documentArena) {
+        pCtx->documentArena->retireChunk();
+    }
+
     for (auto&& source : _sources) {
         source->detachFromOperationContext();
     }
@@ -485,6 +489,8 @@ void Pipeline::stitch() {
 
 boost::optional<Document> Pipeline::getNext() {
     invariant(!_sources.empty());
+    RefCountedArena::Scope arenaScope(pCtx->documentArena.get());
+    DocumentShapeTable::Scope shapeScope(pCtx->documentShapes.get());
     auto nextResult = _sources.back()->getNext();
     while (nextResult.isPaused()) {
         nextResult = _sources.back()->getNext();
@@ -54,6 +54,8 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_sample.h"
@@ -64,6 +66,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
@@ -351,8 +354,8 @@ private:
  */
 StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorExecutor(
     Collection* collection, OperationContext* opCtx, long long sampleSize, long long numRecords) {
-    double kMaxSampleRatioForRandCursor = 0.05;
-    if (sampleSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100) {
+    const double maxSampleRatioForRandCursor = internalQueryRandomCursorMaxSampleRatio.load();
+    if (sampleSize > numRecords * maxSampleRatioForRandCursor || numRecords <= 100) {
         return {nullptr};
     }
 
@@ -471,12 +474,145 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
         opCtx, collection, nss, std::move(cq.getValue()), PlanExecutor::YIELD_AUTO, plannerOpts);
 }
 
+/**
+ * Returns 'sortObj' with the direction of each of its fields reversed.
+ */
+BSONObj reverseSortPattern(const BSONObj& sortObj) {
+    BSONObjBuilder reversed;
+    for (auto&& elem : sortObj) {
+        reversed.append(elem.fieldName(), elem.numberInt() > 0 ? -1 : 1);
+    }
+    return reversed.obj();
+}
+
+/**
+ * If 'sources' starts with a $group, possibly after a $sort, which can be computed from a single
+ * document of each group, attempts to get an executor answering 'queryObj' with a DISTINCT_SCAN on
+ * the group key. Rather than reading every matching document, it seeks from each value of the group
+ * key to the next and fetches only the document it lands on, which is the first one in the order
+ * of the $sort, or the last one if the $group needs that instead.
+ *
+ * On success, removes the $sort from 'sources' and sets 'sortObj' to the sort the executor
+ * provides. Returns nullptr if the $group cannot be computed that way.
+ */
+std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> attemptToGetDistinctScanExecutorForGroup(
+    Collection* collection,
+    const NamespaceString& nss,
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    Pipeline::SourceContainer* sources,
+    bool oplogReplay,
+    const intrusive_ptr<DocumentSourceSort>& sortStage,
+    const BSONObj& queryObj,
+    const BSONObj& projectionObj,
+    const AggregationRequest* aggRequest,
+    BSONObj* sortObj) {
+    if (!collection || !internalQueryEnableDistinctScanForGroup.load() || oplogReplay ||
+        expCtx->needsMerge || expCtx->tailableMode != TailableMode::kNormal ||
+        DocumentSourceMatch::isTextQuery(queryObj) ||
+        (aggRequest && !aggRequest->getHint().isEmpty())) {
+        return nullptr;
+    }
+
+    auto groupItr = sources->begin();
+    if (sortStage) {
+        // A $limit coalesced into the $sort restricts which documents are grouped.
+        if (sortStage->getLimitSrc()) {
+            return nullptr;
+        }
+        ++groupItr;
+    }
+    if (groupItr == sources->end()) {
+        return nullptr;
+    }
+    auto groupStage = dynamic_cast<DocumentSourceGroup*>(groupItr->get());
+    if (!groupStage) {
+        return nullptr;
+    }
+    auto oneDocumentPerGroup = groupStage->canComputeFromOneDocumentPerGroup();
+    if (!oneDocumentPerGroup) {
+        return nullptr;
+    }
+
+    // The $sort only matters to the $group through which document of each group comes first.
+    BSONObj distinctSortObj;
+    if (sortStage && oneDocumentPerGroup->dependsOnOrder) {
+        distinctSortObj =
+            oneDocumentPerGroup->needsLastDocument ? reverseSortPattern(*sortObj) : *sortObj;
+    }
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(queryObj);
+    qr->setProj(projectionObj);
+    qr->setSort(distinctSortObj);
+    if (aggRequest) {
+        qr->setExplain(static_cast<bool>(aggRequest->getExplain()));
+    }
+    qr->setCollation(expCtx->getCollator() ? expCtx->getCollator()->getSpec().toBSON()
+                                           : expCtx->collation);
+
+    const ExtensionsCallbackReal extensionsCallback(expCtx->opCtx, &nss);
+    auto cq = CanonicalQuery::canonicalize(expCtx->opCtx,
+                                           std::move(qr),
+                                           expCtx,
+                                           extensionsCallback,
+                                           MatchExpressionParser::AllowedFeatures::kExpr);
+    if (!cq.isOK()) {
+        return nullptr;
+    }
+
+    auto swExec = getExecutorDistinctScan(expCtx->opCtx,
+                                          collection,
+                                          std::move(cq.getValue()),
+                                          oneDocumentPerGroup->groupKeyPath,
+                                          PlanExecutor::YIELD_AUTO);
+    if (!swExec.isOK()) {
+        return nullptr;
+    }
+
+    if (sortStage) {
+        sources->pop_front();
+    }
+    *sortObj = distinctSortObj;
+    return std::move(swExec.getValue());
+}
+
 BSONObj removeSortKeyMetaProjection(BSONObj projectionObj) {
     if (!projectionObj[Document::metaFieldSortKey]) {
         return projectionObj;
     }
     return projectionObj.removeField(Document::metaFieldSortKey);
 }
+
+/**
+ * Makes a pipeline on a time-series collection see its measurements, by unpacking its buckets
+ * first unless the pipeline already does. The predicates of a $match which follows on the time
+ * and meta of the measurements are pushed down to the buckets, so that the query only reads the
+ * buckets which can hold matching measurements.
+ */
+void unpackTimeseriesBuckets(const TimeseriesOptions& options,
+                             const intrusive_ptr<ExpressionContext>& expCtx,
+                             Pipeline::SourceContainer* sources) {
+    auto unpackStage = sources->empty()
+        ? nullptr
+        : dynamic_cast<DocumentSourceInternalUnpackBucket*>(sources->front().get());
+    if (!unpackStage) {
+        auto newUnpackStage = DocumentSourceInternalUnpackBucket::create(
+            expCtx, options.timeField, options.metaField);
+        unpackStage = newUnpackStage.get();
+        sources->push_front(std::move(newUnpackStage));
+    }
+
+    auto matchStage = sources->size() > 1
+        ? dynamic_cast<DocumentSourceMatch*>(std::next(sources->begin())->get())
+        : nullptr;
+    if (!matchStage) {
+        return;
+    }
+    auto bucketPredicate = unpackStage->makeBucketPredicate(matchStage->getQuery());
+    if (!bucketPredicate.isEmpty()) {
+        sources->push_front(DocumentSourceMatch::create(bucketPredicate, expCtx));
+    }
+}
 }  // namespace
 
 void PipelineD::injectMongodInterface(Pipeline* pipeline) {
@@ -507,6 +643,10 @@ void PipelineD::prepareCursorSource(Collection* collection,
     // We are going to generate an input cursor, so we need to be holding the collection lock.
     dassert(expCtx->opCtx->lockState()->isCollectionLockedForMode(nss.ns(), MODE_IS));
 
+    if (collection && collection->getTimeseriesOptions()) {
+        unpackTimeseriesBuckets(*collection->getTimeseriesOptions(), expCtx, &sources);
+    }
+
     if (!sources.empty()) {
         auto sampleStage = dynamic_cast<DocumentSourceSample*>(sources.front().get());
         // Optimize an initial $sample stage if possible.
@@ -573,6 +713,21 @@ void PipelineD::prepareCursorSource(Collection* collection,
         }
     }
 
+    if (auto exec = attemptToGetDistinctScanExecutorForGroup(collection,
+                                                             nss,
+                                                             expCtx,
+                                                             &sources,
+                                                             oplogReplay,
+                                                             sortStage,
+                                                             queryObj,
+                                                             projForQuery,
+                                                             aggRequest,
+                                                             &sortObj)) {
+        addCursorSource(
+            collection, pipeline, expCtx, std::move(exec), deps, queryObj, sortObj, projForQuery);
+        return;
+    }
+
     // Create the PlanExecutor.
     auto exec = uassertStatusOK(prepareExecutor(expCtx->opCtx,
                                                 collection,
@@ -1699,6 +1699,26 @@ TEST_F(PipelineDependenciesTest, ShouldNotRequireTextScoreIfAvailableButDefinite
     ASSERT_FALSE(depsTracker.getNeedTextScore());
 }
 
+TEST_F(PipelineDependenciesTest, ShouldReportDependenciesOfComputedFieldsAndLookUpLocalField) {
+    auto ctx = getExpCtx();
+    NamespaceString lookupCollNs(ctx->ns.db(), "lookupColl");
+    ctx->setResolvedNamespace(lookupCollNs, {lookupCollNs, std::vector<BSONObj>{}});
+    const std::vector<BSONObj> rawPipeline = {
+        fromjson("{$addFields: {c: {$add: ['$x', 1]}}}"),
+        fromjson("{$lookup: {from: 'lookupColl', localField: 'a.b', foreignField: 'f', as: 'j'}}"),
+        fromjson("{$project: {c: 1, j: 1}}")};
+    auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, ctx));
+
+    auto depsTracker = pipeline->getDependencies(DepsTracker::MetadataAvailable::kNoMetadata);
+
+    // The final $project lets us push a projection down to the query system, and that projection
+    // must include the inputs of the computed field and the $lookup's local field.
+    ASSERT_FALSE(depsTracker.needWholeDocument);
+    ASSERT_EQ(depsTracker.fields.count("x"), 1UL);
+    ASSERT_EQ(depsTracker.fields.count("a.b"), 1UL);
+    ASSERT_EQ(depsTracker.fields.count("_id"), 1UL);
+}
+
 }  // namespace Dependencies
 }  // namespace
 
@@ -49,13 +49,17 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
-    size_t nConsumersStillProcessingThisBatch =
-        std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-            return info.nLeftToReturn > 0;
-        });
-
-    if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
-        loadNextBatch();
+    // During a concurrent batch the other consumers' state is being modified by other threads, and
+    // only the owner of the source may load the next batch.
+    if (!_inConcurrentBatch) {
+        size_t nConsumersStillProcessingThisBatch =
+            std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+                return info.nLeftToReturn > 0;
+            });
+
+        if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
+            loadNextBatch();
+        }
     }
 
     if (_buffer.empty()) {
@@ -75,6 +79,35 @@ DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
     return _buffer[bufferIndex];
 }
 
+void TeeBuffer::loadConcurrentBatch() {
+    invariant(!_inConcurrentBatch);
+    if (std::any_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        })) {
+        loadNextBatch();
+    } else {
+        _buffer.clear();
+    }
+    _inConcurrentBatch = true;
+}
+
+void TeeBuffer::finishConcurrentBatch() {
+    invariant(_inConcurrentBatch);
+    _inConcurrentBatch = false;
+    disposeSourceIfUnused();
+}
+
+void TeeBuffer::disposeSourceIfUnused() {
+    if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        })) {
+        _buffer.clear();
+        if (_source) {
+            _source->dispose();
+        }
+    }
+}
+
 void TeeBuffer::loadNextBatch() {
     _buffer.clear();
     size_t bytesInBuffer = 0;
@@ -65,16 +65,26 @@ public:
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
-        if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-                return info.stillInUse;
-            })) {
-            _buffer.clear();
-            if (_source) {
-                _source->dispose();
-            }
+        if (!_inConcurrentBatch) {
+            disposeSourceIfUnused();
         }
     }
 
+    /**
+     * Loads the next batch from the source so that it can be processed by all consumers at once,
+     * each on its own thread. Until finishConcurrentBatch() is called, getNext() and dispose() only
+     * touch the state of the calling consumer: getNext() returns kPauseExecution at the end of the
+     * batch rather than loading another one, and disposing the last consumer leaves the source to
+     * be disposed by finishConcurrentBatch(). Must be called by the thread which owns the source.
+     */
+    void loadConcurrentBatch();
+
+    /**
+     * Ends a batch started by loadConcurrentBatch(). Must only be called once every consumer has
+     * stopped calling getNext() for the batch.
+     */
+    void finishConcurrentBatch();
+
     /**
      * Retrieves the next document meant to be consumed by the pipeline given by 'consumerId'.
      * Returns GetNextState::ResultState::kPauseExecution if this pipeline has consumed the whole
@@ -92,6 +102,11 @@ private:
      */
     void loadNextBatch();
 
+    /**
+     * Clears '_buffer' and disposes of '_source' if no consumer is still in use.
+     */
+    void disposeSourceIfUnused();
+
     DocumentSource* _source = nullptr;
 
     const size_t _bufferSizeBytes;
@@ -102,5 +117,9 @@ private:
         int nLeftToReturn = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    // True between loadConcurrentBatch() and finishConcurrentBatch(), while consumers may be
+    // calling getNext() from several threads.
+    bool _inConcurrentBatch = false;
 };
 }  // namespace mongo
@@ -187,6 +187,9 @@ public:
     }
 
 private:
+    // PlanCache::computeKey() memoizes the key it computes in this query.
+    friend class PlanCache;
+
     // You must go through canonicalize to create a CanonicalQuery.
     CanonicalQuery() {}
 
@@ -207,6 +210,12 @@ private:
     bool _canHaveNoopMatchNodes = false;
 
     bool _isIsolated;
+
+    // The plan cache key last computed for this query. The key is needed several times while a
+    // query is planned and run, and is only valid for the plan cache index information whose
+    // version it was computed against. Zero is never a valid version.
+    mutable std::string _planCacheKey;
+    mutable unsigned long long _planCacheKeyVersion = 0;
 };
 
 }  // namespace mongo
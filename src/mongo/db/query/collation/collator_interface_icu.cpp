@@ -30,17 +30,79 @@
 
 #include "mongo/db/query/collation/collator_interface_icu.h"
 
+#include <cstring>
+#include <string>
 #include <unicode/coll.h>
 #include <unicode/sortkey.h>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#endif
+
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/xxhash.h"
 
 namespace mongo {
 
+namespace {
+
+AtomicUInt64 nextCollatorId(1);
+
+// Strings up to this many bytes are converted to UTF-16 on the stack, and sort keys up to this
+// many bytes are written there too.
+const size_t kStackBufferChars = 256;
+const size_t kStackBufferKeyBytes = 512;
+
+// Recently computed comparison keys of short strings, per thread. An operation runs on one thread,
+// so this serves repeated values such as the $in constants or low-cardinality fields one operation
+// keeps generating keys for.
+const size_t kKeyCacheEntries = 64;
+const size_t kMaxCachedStringBytes = 64;
+
+struct CachedKey {
+    unsigned long long collatorId = 0;
+    std::string string;
+    std::string key;
+};
+
+thread_local CachedKey keyCache[kKeyCacheEntries];
+
+/**
+ * If 'str' is pure ASCII, writes it to 'out' as UTF-16, which for ASCII is just widening each byte,
+ * and returns true. Otherwise returns false and the contents of 'out' are unspecified.
+ */
+bool widenASCII(StringData str, UChar* out) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(str.rawData());
+    const size_t len = str.size();
+    size_t i = 0;
+#if defined(_M_AMD64) || defined(__amd64__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= len; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            return false;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(bytes, zero));
+    }
+#endif
+    unsigned char seen = 0;
+    for (; i < len; i++) {
+        seen |= in[i];
+        out[i] = in[i];
+    }
+    return seen < 0x80;
+}
+
+}  // namespace
+
 CollatorInterfaceICU::CollatorInterfaceICU(CollationSpec spec,
                                            std::unique_ptr<icu::Collator> collator)
-    : CollatorInterface(std::move(spec)), _collator(std::move(collator)) {}
+    : CollatorInterface(std::move(spec)),
+      _collator(std::move(collator)),
+      _id(nextCollatorId.fetchAndAdd(1)) {}
 
 std::unique_ptr<CollatorInterface> CollatorInterfaceICU::clone() const {
     auto clone = stdx::make_unique<CollatorInterfaceICU>(
@@ -71,30 +133,61 @@ int CollatorInterfaceICU::compare(StringData left, StringData right) const {
     MONGO_UNREACHABLE;
 }
 
-CollatorInterface::ComparisonKey CollatorInterfaceICU::getComparisonKey(
-    StringData stringData) const {
-    // A StringPiece is ICU's StringData. They are logically the same abstraction.
-    const icu::StringPiece stringPiece(stringData.rawData(), stringData.size());
-
-    UErrorCode status = U_ZERO_ERROR;
-    icu::CollationKey icuKey;
-    _collator->getCollationKey(icu::UnicodeString::fromUTF8(stringPiece), icuKey, status);
+std::string CollatorInterfaceICU::_getSortKey(StringData stringData) const {
+    // Pure ASCII strings, the common case, skip ICU's UTF-8 conversion and the temporary
+    // UnicodeString. Either way the key is written straight into a local buffer rather than an
+    // icu::CollationKey.
+    UChar stackChars[kStackBufferChars];
+    icu::UnicodeString fromUTF8;
+    const UChar* chars = stackChars;
+    int32_t numChars = stringData.size();
+    if (stringData.size() > kStackBufferChars || !widenASCII(stringData, stackChars)) {
+        // A StringPiece is ICU's StringData. They are logically the same abstraction.
+        fromUTF8 = icu::UnicodeString::fromUTF8(
+            icu::StringPiece(stringData.rawData(), stringData.size()));
+        chars = fromUTF8.getBuffer();
+        numChars = fromUTF8.length();
+    }
 
     // Any sequence of bytes, even invalid UTF-8, has defined comparison behavior in ICU (invalid
-    // subsequences are weighted as the replacement character, U+FFFD). A non-ok error code is only
-    // expected when a memory allocation fails inside ICU, which we consider fatal to the process.
-    fassert(34439, U_SUCCESS(status));
-
-    int32_t keyLength;
-    const uint8_t* keyBuffer = icuKey.getByteArray(keyLength);
-    invariant(keyLength > 0);
-    invariant(keyBuffer);
+    // subsequences are weighted as the replacement character, U+FFFD). getSortKey() only returns 0
+    // when a memory allocation fails inside ICU, which we consider fatal to the process.
+    uint8_t stackKey[kStackBufferKeyBytes];
+    std::unique_ptr<uint8_t[]> heapKey;
+    uint8_t* keyBuffer = stackKey;
+    int32_t keyLength = _collator->getSortKey(chars, numChars, stackKey, sizeof(stackKey));
+    fassert(34439, keyLength > 0);
+    if (static_cast<size_t>(keyLength) > sizeof(stackKey)) {
+        const int32_t heapKeyLength = keyLength;
+        heapKey.reset(new uint8_t[heapKeyLength]);
+        keyBuffer = heapKey.get();
+        keyLength = _collator->getSortKey(chars, numChars, keyBuffer, heapKeyLength);
+        fassert(40643, keyLength > 0 && keyLength <= heapKeyLength);
+    }
 
     // The last byte of the sort key should always be null. When we construct the comparison key, we
     // omit the trailing null byte.
-    invariant(keyBuffer[keyLength - 1u] == '\0');
-    const char* charBuffer = reinterpret_cast<const char*>(keyBuffer);
-    return makeComparisonKey(std::string(charBuffer, keyLength - 1u));
+    invariant(keyBuffer[keyLength - 1] == '\0');
+    return std::string(reinterpret_cast<const char*>(keyBuffer), keyLength - 1);
+}
+
+CollatorInterface::ComparisonKey CollatorInterfaceICU::getComparisonKey(
+    StringData stringData) const {
+    CachedKey* cached = nullptr;
+    if (stringData.size() <= kMaxCachedStringBytes) {
+        cached = &keyCache[xxhash64(stringData.rawData(), stringData.size()) % kKeyCacheEntries];
+        if (cached->collatorId == _id && StringData(cached->string) == stringData) {
+            return makeComparisonKey(cached->key);
+        }
+    }
+
+    std::string key = _getSortKey(stringData);
+    if (cached) {
+        cached->collatorId = _id;
+        cached->string.assign(stringData.rawData(), stringData.size());
+        cached->key = key;
+    }
+    return makeComparisonKey(std::move(key));
 }
 
 }  // namespace mongo
@@ -31,6 +31,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 
 #include <memory>
+#include <string>
 
 namespace icu {
 class Collator;
@@ -53,9 +54,16 @@ public:
     ComparisonKey getComparisonKey(StringData stringData) const final;
 
 private:
+    // Returns the ICU sort key of 'stringData' without its trailing null byte.
+    std::string _getSortKey(StringData stringData) const;
+
     // The ICU implementation of the collator to which we delegate interesting work. Const methods
     // on the ICU collator are expected to be thread-safe.
     const std::unique_ptr<icu::Collator> _collator;
+
+    // Identifies this collator in the per-thread cache of recently computed comparison keys.
+    // Unique among all collators ever made, so a cached key never outlives its collator's id.
+    const unsigned long long _id;
 };
 
 }  // namespace mongo
@@ -33,6 +33,8 @@
 #include <iomanip>
 #include <iostream>
 #include <unicode/coll.h>
+#include <unicode/sortkey.h>
+#include <unicode/unistr.h>
 
 #include "mongo/unittest/unittest.h"
 
@@ -593,4 +595,73 @@ TEST(CollatorInterfaceICUTest, ComparisonKeysForFrCaCollatorCorrect) {
               "\x2D\x45\x4F\x31\x01\x88\x44\x8E\x06\x01\x0A");
 }
 
+// Returns the comparison key ICU itself computes for 'str', for checking the fast paths.
+std::string icuCollationKey(const icu::Collator& collator, StringData str) {
+    UErrorCode status = U_ZERO_ERROR;
+    icu::CollationKey key;
+    collator.getCollationKey(
+        icu::UnicodeString::fromUTF8(icu::StringPiece(str.rawData(), str.size())), key, status);
+    ASSERT(U_SUCCESS(status));
+    int32_t length;
+    const uint8_t* bytes = key.getByteArray(length);
+    return std::string(reinterpret_cast<const char*>(bytes), length - 1);
+}
+
+TEST(CollatorInterfaceICUTest, ComparisonKeysMatchICUForASCIILongAndNonASCIIStrings) {
+    CollationSpec collationSpec;
+    collationSpec.localeID = "en_US";
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> coll(
+        icu::Collator::createInstance(icu::Locale("en", "US"), status));
+    ASSERT(U_SUCCESS(status));
+    std::unique_ptr<icu::Collator> reference(coll->clone());
+    CollatorInterfaceICU icuCollator(collationSpec, std::move(coll));
+
+    std::string longASCII;
+    for (int i = 0; i < 300; i++) {
+        longASCII += "Ab-" + std::to_string(i);
+    }
+    const std::string strings[] = {"",
+                                   "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOP 0123456789",
+                                   std::string("a\0b", 3),
+                                   "c\xC3\xB4t\xC3\xA9 and some ASCII after the accents",
+                                   "\xFF\xFE",
+                                   longASCII,
+                                   longASCII + "\xC3\xA9"};
+    for (auto&& str : strings) {
+        ASSERT_EQ(icuCollator.getComparisonKey(str).getKeyData(),
+                  icuCollationKey(*reference, str));
+        // The second lookup of a short string is answered from the cache.
+        ASSERT_EQ(icuCollator.getComparisonKey(str).getKeyData(),
+                  icuCollationKey(*reference, str));
+    }
+}
+
+TEST(CollatorInterfaceICUTest, CachedComparisonKeysAreNotSharedBetweenCollators) {
+    CollationSpec collationSpec;
+    collationSpec.localeID = "en_US";
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> primaryColl(
+        icu::Collator::createInstance(icu::Locale("en", "US"), status));
+    ASSERT(U_SUCCESS(status));
+    primaryColl->setStrength(icu::Collator::PRIMARY);
+    CollatorInterfaceICU primaryCollator(collationSpec, std::move(primaryColl));
+
+    std::unique_ptr<icu::Collator> tertiaryColl(
+        icu::Collator::createInstance(icu::Locale("en", "US"), status));
+    ASSERT(U_SUCCESS(status));
+    CollatorInterfaceICU tertiaryCollator(collationSpec, std::move(tertiaryColl));
+
+    ASSERT_EQ(primaryCollator.getComparisonKey("a").getKeyData(),
+              primaryCollator.getComparisonKey("A").getKeyData());
+    ASSERT_NE(tertiaryCollator.getComparisonKey("a").getKeyData(),
+              tertiaryCollator.getComparisonKey("A").getKeyData());
+    ASSERT_EQ(primaryCollator.getComparisonKey("a").getKeyData(),
+              primaryCollator.getComparisonKey("A").getKeyData());
+
+    auto clone = tertiaryCollator.clone();
+    ASSERT_EQ(clone->getComparisonKey("a").getKeyData(),
+              tertiaryCollator.getComparisonKey("a").getKeyData());
+}
+
 }  // namespace
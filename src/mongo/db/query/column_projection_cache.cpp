@@ -0,0 +1,511 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/column_projection_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Columns shorter than this are never compacted.
+const size_t kMinCompactionBytes = 4096;
+
+// Tombstones are purged once there are this many, and more than there are documents.
+const size_t kMinTombstonesToPurge = 1024;
+
+const size_t kMaxOrderings = std::numeric_limits<uint16_t>::max();
+
+}  // namespace
+
+const size_t ColumnProjectionCache::kRowsPerBlock;
+const size_t ColumnProjectionCache::kMaxFields;
+
+/**
+ * Applies a noted change to the cache when its unit of work commits.
+ */
+class ColumnProjectionCache::PendingChange final : public RecoveryUnit::Change {
+public:
+    PendingChange(std::shared_ptr<ColumnProjectionCache> cache,
+                  ChangeType type,
+                  BSONObj doc,
+                  uint64_t seq)
+        : _cache(std::move(cache)), _type(type), _doc(std::move(doc)), _seq(seq) {}
+
+    void commit() final {
+        _cache->_finish(_type, _doc, _seq, true);
+    }
+
+    void rollback() final {
+        _cache->_finish(_type, _doc, _seq, false);
+    }
+
+private:
+    const std::shared_ptr<ColumnProjectionCache> _cache;
+    const ChangeType _type;
+    const BSONObj _doc;
+    const uint64_t _seq;
+};
+
+Status ColumnProjectionCache::validateFields(const std::vector<std::string>& fields) {
+    if (fields.size() > kMaxFields) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "at most " << kMaxFields << " fields can be cached");
+    }
+
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const std::string& field = fields[i];
+        if (field.empty()) {
+            return Status(ErrorCodes::BadValue, "cached field names must not be empty");
+        }
+        if (field.find('.') != std::string::npos) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "only top-level fields can be cached: " << field);
+        }
+        if (field[0] == '$') {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "cached field names must not start with '$': "
+                                        << field);
+        }
+        if (field == "_id") {
+            return Status(ErrorCodes::BadValue, "_id is always cached and must not be listed");
+        }
+        if (std::find(fields.begin(), fields.begin() + i, field) != fields.begin() + i) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "field listed more than once: " << field);
+        }
+    }
+
+    return Status::OK();
+}
+
+ColumnProjectionCache::ColumnProjectionCache(std::vector<std::string> fields, size_t maxBytes)
+    : _fields(std::move(fields)),
+      _maxBytes(maxBytes),
+      _entries(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<Entry>()) {
+    invariantOK(validateFields(_fields));
+}
+
+bool ColumnProjectionCache::isFieldCached(StringData fieldName) const {
+    if (fieldName == "_id") {
+        return true;
+    }
+    return std::find(_fields.begin(), _fields.end(), fieldName) != _fields.end();
+}
+
+bool ColumnProjectionCache::isValid() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _valid;
+}
+
+void ColumnProjectionCache::invalidate(StringData reason) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _invalidate_inlock(reason);
+}
+
+void ColumnProjectionCache::addInitialDocument(const BSONObj& doc) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_valid) {
+        _upsert(doc, 0);
+    }
+}
+
+void ColumnProjectionCache::noteInsert(OperationContext* opCtx, const BSONObj& doc) {
+    _note(opCtx, ChangeType::kUpsert, doc.getOwned());
+}
+
+void ColumnProjectionCache::noteUpdate(OperationContext* opCtx, const BSONObj& updatedDoc) {
+    _note(opCtx, ChangeType::kUpsert, updatedDoc.getOwned());
+}
+
+void ColumnProjectionCache::noteDelete(OperationContext* opCtx, const BSONElement& id) {
+    _note(opCtx, ChangeType::kDelete, BSON("" << id));
+}
+
+void ColumnProjectionCache::noteTruncate(OperationContext* opCtx) {
+    _note(opCtx, ChangeType::kTruncate, BSONObj());
+}
+
+void ColumnProjectionCache::_note(OperationContext* opCtx, ChangeType type, BSONObj doc) {
+    uint64_t seq;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_valid) {
+            return;
+        }
+        seq = ++_lastSeq;
+        _pendingSeqs.insert(seq);
+    }
+
+    opCtx->recoveryUnit()->registerChange(
+        new PendingChange(shared_from_this(), type, std::move(doc), seq));
+}
+
+void ColumnProjectionCache::_finish(ChangeType type,
+                                    const BSONObj& doc,
+                                    uint64_t seq,
+                                    bool committed) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pendingSeqs.erase(seq);
+    if (!committed || !_valid) {
+        return;
+    }
+
+    _apply(type, doc, seq);
+
+    if (_numTombstones >= kMinTombstonesToPurge && _numTombstones > _numDocuments) {
+        _purgeTombstones();
+    }
+}
+
+void ColumnProjectionCache::_apply(ChangeType type, const BSONObj& doc, uint64_t seq) {
+    if (seq < _truncateSeq) {
+        // The collection was emptied after this change was made.
+        return;
+    }
+
+    switch (type) {
+        case ChangeType::kUpsert:
+            _upsert(doc, seq);
+            return;
+        case ChangeType::kDelete:
+            _delete(doc, seq);
+            return;
+        case ChangeType::kTruncate:
+            _truncate(seq);
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void ColumnProjectionCache::_upsert(const BSONObj& doc, uint64_t seq) {
+    BSONElement idElt = doc["_id"];
+    if (idElt.eoo()) {
+        _invalidate_inlock("document without an _id");
+        return;
+    }
+
+    BSONObj idObj = BSON("" << idElt);
+    auto it = _entries.find(idObj);
+    if (it == _entries.end()) {
+        it = _entries.emplace(std::move(idObj), Entry()).first;
+        it->second.row = _allocateRow();
+        ++_numDocuments;
+    } else if (it->second.seq > seq) {
+        // A later change to this document has already been applied.
+        return;
+    } else if (it->second.deleted) {
+        it->second.deleted = false;
+        it->second.row = _allocateRow();
+        --_numTombstones;
+        ++_numDocuments;
+    }
+
+    Entry& entry = it->second;
+    entry.seq = seq;
+    _writeRow(entry.row, doc);
+
+    if (_valid && _dataBytes > _maxBytes) {
+        _invalidate_inlock(str::stream() << "cache grew past its limit of " << _maxBytes
+                                         << " bytes");
+    }
+}
+
+void ColumnProjectionCache::_delete(const BSONObj& idObj, uint64_t seq) {
+    auto it = _entries.find(idObj);
+    if (it == _entries.end()) {
+        // Keep a tombstone in case an older insert of this document has yet to be applied.
+        Entry entry;
+        entry.seq = seq;
+        entry.deleted = true;
+        _entries.emplace(idObj.getOwned(), entry);
+        ++_numTombstones;
+        return;
+    }
+
+    Entry& entry = it->second;
+    if (entry.seq > seq) {
+        return;
+    }
+
+    entry.seq = seq;
+    if (!entry.deleted) {
+        _freeRow(entry.row);
+        entry.deleted = true;
+        --_numDocuments;
+        ++_numTombstones;
+    }
+}
+
+void ColumnProjectionCache::_truncate(uint64_t seq) {
+    _clearContents();
+    _truncateSeq = seq;
+}
+
+void ColumnProjectionCache::_writeRow(RowId row, const BSONObj& doc) {
+    Block& block = _blocks[row / kRowsPerBlock];
+    const size_t index = row % kRowsPerBlock;
+
+    // Release the row's previous values, if any.
+    for (auto&& column : block.columns) {
+        uint32_t& offset = column.offsets[index];
+        if (offset != kMissing) {
+            column.garbageBytes += BSONElement(column.data.data() + offset).size();
+            offset = kMissing;
+        }
+    }
+
+    std::vector<uint8_t> ordering;
+    for (auto&& elt : doc) {
+        size_t columnIndex;
+        if (elt.fieldNameStringData() == "_id") {
+            columnIndex = 0;
+        } else {
+            auto field = std::find(_fields.begin(), _fields.end(), elt.fieldNameStringData());
+            if (field == _fields.end()) {
+                continue;
+            }
+            columnIndex = 1 + (field - _fields.begin());
+        }
+
+        Column& column = block.columns[columnIndex];
+        if (column.offsets[index] != kMissing) {
+            // Only the first occurrence of a duplicated field name is visible to queries.
+            continue;
+        }
+
+        // Store the element with an empty field name: its type byte, the field name's
+        // terminating NUL, then its value.
+        const size_t valueSize = elt.valuesize();
+        const size_t offset = column.data.size();
+        if (offset + valueSize + 2 >= kMissing) {
+            _invalidate_inlock("a column block grew past 4GB");
+            return;
+        }
+        column.data.resize(offset + valueSize + 2);
+        column.data[offset] = static_cast<char>(elt.type());
+        column.data[offset + 1] = '\0';
+        std::memcpy(column.data.data() + offset + 2, elt.value(), valueSize);
+        column.offsets[index] = static_cast<uint32_t>(offset);
+        _dataBytes += valueSize + 2;
+
+        ordering.push_back(static_cast<uint8_t>(columnIndex));
+    }
+
+    const uint16_t orderingId = _getOrdering(ordering);
+    if (!_valid) {
+        return;
+    }
+    block.orderings[index] = orderingId;
+    block.live[index] = true;
+
+    for (auto&& column : block.columns) {
+        _compactColumn(&column);
+    }
+}
+
+void ColumnProjectionCache::_freeRow(RowId row) {
+    Block& block = _blocks[row / kRowsPerBlock];
+    const size_t index = row % kRowsPerBlock;
+
+    for (auto&& column : block.columns) {
+        uint32_t& offset = column.offsets[index];
+        if (offset != kMissing) {
+            column.garbageBytes += BSONElement(column.data.data() + offset).size();
+            offset = kMissing;
+        }
+        _compactColumn(&column);
+    }
+
+    block.live[index] = false;
+    _freeRows.push_back(row);
+}
+
+ColumnProjectionCache::RowId ColumnProjectionCache::_allocateRow() {
+    if (!_freeRows.empty()) {
+        RowId row = _freeRows.back();
+        _freeRows.pop_back();
+        return row;
+    }
+
+    const RowId row = _endRow++;
+    if (row / kRowsPerBlock == _blocks.size()) {
+        Block block;
+        block.columns.resize(1 + _fields.size());
+        for (auto&& column : block.columns) {
+            column.offsets.assign(kRowsPerBlock, kMissing);
+        }
+        block.orderings.assign(kRowsPerBlock, 0);
+        block.live.assign(kRowsPerBlock, false);
+        _blocks.push_back(std::move(block));
+
+        _dataBytes += kRowsPerBlock * (sizeof(uint32_t) * (1 + _fields.size()) + sizeof(uint16_t));
+    }
+    return row;
+}
+
+uint16_t ColumnProjectionCache::_getOrdering(const std::vector<uint8_t>& ordering) {
+    auto it = _orderingIds.find(ordering);
+    if (it != _orderingIds.end()) {
+        return it->second;
+    }
+
+    if (_orderings.size() >= kMaxOrderings) {
+        _invalidate_inlock("too many distinct field orders");
+        return 0;
+    }
+
+    const uint16_t id = static_cast<uint16_t>(_orderings.size());
+    _orderings.push_back(ordering);
+    _orderingIds.emplace(ordering, id);
+    return id;
+}
+
+void ColumnProjectionCache::_compactColumn(Column* column) {
+    if (column->data.size() < kMinCompactionBytes ||
+        column->garbageBytes < column->data.size() / 2) {
+        return;
+    }
+
+    std::vector<char> data;
+    data.reserve(column->data.size() - column->garbageBytes);
+    for (auto&& offset : column->offsets) {
+        if (offset == kMissing) {
+            continue;
+        }
+        const char* value = column->data.data() + offset;
+        const size_t size = BSONElement(value).size();
+        offset = static_cast<uint32_t>(data.size());
+        data.insert(data.end(), value, value + size);
+    }
+
+    _dataBytes -= column->data.size() - data.size();
+    column->data = std::move(data);
+    column->garbageBytes = 0;
+}
+
+void ColumnProjectionCache::_purgeTombstones() {
+    // A tombstone is only needed while an older change to its document may still be applied.
+    const uint64_t oldestPending = _pendingSeqs.empty() ? _lastSeq + 1 : *_pendingSeqs.begin();
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.deleted && it->second.seq < oldestPending) {
+            it = _entries.erase(it);
+            --_numTombstones;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ColumnProjectionCache::_invalidate_inlock(StringData reason) {
+    if (!_valid) {
+        return;
+    }
+
+    log() << "invalidating column projection cache: " << reason;
+    _valid = false;
+    _clearContents();
+}
+
+void ColumnProjectionCache::_clearContents() {
+    _blocks.clear();
+    _freeRows.clear();
+    _endRow = 0;
+    _orderings.clear();
+    _orderingIds.clear();
+    _entries.clear();
+    _numDocuments = 0;
+    _numTombstones = 0;
+    _dataBytes = 0;
+}
+
+bool ColumnProjectionCache::next(RowId* row, BSONObj* out) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_valid) {
+        return false;
+    }
+
+    for (RowId current = *row; current < _endRow; ++current) {
+        const Block& block = _blocks[current / kRowsPerBlock];
+        const size_t index = current % kRowsPerBlock;
+        if (!block.live[index]) {
+            continue;
+        }
+
+        BSONObjBuilder bob;
+        for (auto&& columnIndex : _orderings[block.orderings[index]]) {
+            const Column& column = block.columns[columnIndex];
+            BSONElement value(column.data.data() + column.offsets[index]);
+            bob.appendAs(value, columnIndex == 0 ? StringData("_id") : _fields[columnIndex - 1]);
+        }
+        *out = bob.obj();
+        *row = current + 1;
+        return true;
+    }
+
+    *row = _endRow;
+    return false;
+}
+
+size_t ColumnProjectionCache::numDocuments() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numDocuments;
+}
+
+size_t ColumnProjectionCache::dataBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _dataBytes;
+}
+
+void ColumnProjectionCache::appendInfo(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    BSONArrayBuilder fields(builder->subarrayStart("fields"));
+    for (auto&& field : _fields) {
+        fields.append(field);
+    }
+    fields.doneFast();
+    builder->appendBool("valid", _valid);
+    builder->appendNumber("numDocuments", static_cast<long long>(_numDocuments));
+    builder->appendNumber("dataBytes", static_cast<long long>(_dataBytes));
+    builder->appendNumber("maxBytes", static_cast<long long>(_maxBytes));
+}
+
+}  // namespace mongo
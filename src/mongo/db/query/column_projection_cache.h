@@ -0,0 +1,261 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * An in-memory, column-major copy of a few top-level fields of every document in a collection.
+ * Queries which only touch those fields can be answered by a COLUMN_SCAN over the cache instead
+ * of reading and discarding whole documents from the record store.
+ *
+ * The _id field is always cached since it identifies the row of a document. Rows are grouped into
+ * blocks of kRowsPerBlock rows, and each block stores every cached field contiguously for all of
+ * its rows.
+ *
+ * The collection keeps the cache up to date. Each write is noted while the document is still
+ * write-locked by the storage engine and is applied when its unit of work commits. Notes are
+ * tagged with a sequence number so that changes to the same document are applied in the order
+ * they were made, even if their units of work finish committing in a different order.
+ *
+ * Like index filters, the cache is not persisted and must be recreated after a restart. Capped
+ * collections are not supported since they delete documents without notifying the collection.
+ *
+ * A cache must be owned by a std::shared_ptr, since pending changes keep it alive until their
+ * unit of work ends. All methods are thread-safe.
+ */
+class ColumnProjectionCache : public std::enable_shared_from_this<ColumnProjectionCache> {
+    MONGO_DISALLOW_COPYING(ColumnProjectionCache);
+
+public:
+    static const size_t kRowsPerBlock = 1024;
+    static const size_t kMaxFields = 32;
+
+    /**
+     * Identifies a row in the cache. Rows are visited by scans in increasing order. A row freed
+     * by a delete may be reused by a later insert.
+     */
+    using RowId = size_t;
+
+    /**
+     * Returns an error if 'fields' is not a valid list of fields to cache: each must be a
+     * non-empty top-level field name other than _id, and no field may be listed twice.
+     */
+    static Status validateFields(const std::vector<std::string>& fields);
+
+    /**
+     * 'fields' must pass validateFields(). 'maxBytes' bounds the memory used by the cached values.
+     */
+    ColumnProjectionCache(std::vector<std::string> fields, size_t maxBytes);
+
+    /**
+     * Returns the cached fields, not including _id.
+     */
+    const std::vector<std::string>& getFields() const {
+        return _fields;
+    }
+
+    /**
+     * Returns true if the value of the top-level field 'fieldName' is cached. This is always true
+     * for _id.
+     */
+    bool isFieldCached(StringData fieldName) const;
+
+    /**
+     * Returns false once the cache can no longer be trusted to reflect the collection, for
+     * instance because it grew past its size limit or it was replaced. An invalid cache releases
+     * its contents and must not be used to answer queries.
+     */
+    bool isValid() const;
+
+    /**
+     * Marks the cache as invalid. See isValid().
+     */
+    void invalidate(StringData reason);
+
+    /**
+     * Adds a document to the cache. Only used to populate a new cache from the collection's
+     * existing documents under an exclusive collection lock, before the cache is published.
+     */
+    void addInitialDocument(const BSONObj& doc);
+
+    /**
+     * Notes that 'doc' is being inserted. Must be called inside the WriteUnitOfWork that performs
+     * the insert.
+     */
+    void noteInsert(OperationContext* opCtx, const BSONObj& doc);
+
+    /**
+     * Notes that a document is being updated so that it now reads 'updatedDoc'. Must be called
+     * inside the WriteUnitOfWork that performs the update.
+     */
+    void noteUpdate(OperationContext* opCtx, const BSONObj& updatedDoc);
+
+    /**
+     * Notes that the document with _id 'id' is being deleted. Must be called inside the
+     * WriteUnitOfWork that performs the delete.
+     */
+    void noteDelete(OperationContext* opCtx, const BSONElement& id);
+
+    /**
+     * Notes that every document in the collection is being removed. Must be called inside the
+     * WriteUnitOfWork that performs the truncate.
+     */
+    void noteTruncate(OperationContext* opCtx);
+
+    /**
+     * Finds the first live row at or after '*row'. If there is one, sets '*out' to an owned
+     * document made out of the row's cached fields, in the order the document had them, sets
+     * '*row' to the row after it, and returns true. Returns false if there is no such row or the
+     * cache is invalid.
+     */
+    bool next(RowId* row, BSONObj* out) const;
+
+    /**
+     * Returns the number of documents in the cache.
+     */
+    size_t numDocuments() const;
+
+    /**
+     * Returns the number of bytes of memory used to hold the cached values.
+     */
+    size_t dataBytes() const;
+
+    /**
+     * Appends a description of the cache to 'builder'.
+     */
+    void appendInfo(BSONObjBuilder* builder) const;
+
+private:
+    class PendingChange;
+
+    static const uint32_t kMissing = 0xFFFFFFFF;
+
+    /**
+     * The cached values of every row in a block for one field. The value of a field in a row is
+     * stored as a BSONElement with an empty field name at 'offsets[row]' in 'data', or 'offsets'
+     * is kMissing if the document doesn't have the field.
+     */
+    struct Column {
+        std::vector<char> data;
+        std::vector<uint32_t> offsets;
+        size_t garbageBytes = 0;
+    };
+
+    struct Block {
+        // Indexed by column. Column 0 holds _id.
+        std::vector<Column> columns;
+
+        // Per row, the index into '_orderings' of the order the document's fields were in.
+        std::vector<uint16_t> orderings;
+
+        // Per row, whether the row holds a document.
+        std::vector<bool> live;
+    };
+
+    /**
+     * Where, as of which change, a document is in the cache. A deleted document keeps its entry
+     * as a tombstone until no older change to it can still be applied.
+     */
+    struct Entry {
+        uint64_t seq = 0;
+        bool deleted = false;
+        RowId row = 0;
+    };
+
+    enum class ChangeType { kUpsert, kDelete, kTruncate };
+
+    void _note(OperationContext* opCtx, ChangeType type, BSONObj doc);
+    void _finish(ChangeType type, const BSONObj& doc, uint64_t seq, bool committed);
+
+    // The methods below require '_mutex' to be held.
+    void _invalidate_inlock(StringData reason);
+    void _apply(ChangeType type, const BSONObj& doc, uint64_t seq);
+    void _upsert(const BSONObj& doc, uint64_t seq);
+    void _delete(const BSONObj& idObj, uint64_t seq);
+    void _truncate(uint64_t seq);
+    void _writeRow(RowId row, const BSONObj& doc);
+    void _freeRow(RowId row);
+    RowId _allocateRow();
+    uint16_t _getOrdering(const std::vector<uint8_t>& ordering);
+    void _compactColumn(Column* column);
+    void _purgeTombstones();
+    void _clearContents();
+
+    // Top-level field names, not including _id. Column i + 1 holds '_fields[i]'.
+    const std::vector<std::string> _fields;
+    const size_t _maxBytes;
+
+    mutable stdx::mutex _mutex;
+
+    bool _valid = true;
+
+    std::vector<Block> _blocks;
+
+    // Rows freed by deletes, reused by inserts before new rows are appended.
+    std::vector<RowId> _freeRows;
+
+    // The next row that has never been used.
+    RowId _endRow = 0;
+
+    // Every distinct order of cached fields seen so far, as column indexes.
+    std::vector<std::vector<uint8_t>> _orderings;
+    std::map<std::vector<uint8_t>, uint16_t> _orderingIds;
+
+    // Keyed by {"": <_id value>}.
+    BSONObjIndexedMap<Entry> _entries;
+    size_t _numDocuments = 0;
+    size_t _numTombstones = 0;
+    size_t _dataBytes = 0;
+
+    // Sequence number of the most recent note, and of the notes not yet committed or rolled back.
+    uint64_t _lastSeq = 0;
+    std::set<uint64_t> _pendingSeqs;
+
+    // Sequence number of the last truncate. Changes noted before it are dropped.
+    uint64_t _truncateSeq = 0;
+};
+
+}  // namespace mongo
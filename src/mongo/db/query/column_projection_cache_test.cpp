@@ -0,0 +1,278 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for mongo/db/query/column_projection_cache.h
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/column_projection_cache.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::shared_ptr<ColumnProjectionCache> makeCache(std::vector<std::string> fields,
+                                                 size_t maxBytes = 1024 * 1024) {
+    return std::make_shared<ColumnProjectionCache>(std::move(fields), maxBytes);
+}
+
+std::vector<BSONObj> scanAll(const ColumnProjectionCache& cache) {
+    std::vector<BSONObj> docs;
+    ColumnProjectionCache::RowId row = 0;
+    BSONObj doc;
+    while (cache.next(&row, &doc)) {
+        docs.push_back(doc);
+    }
+    return docs;
+}
+
+void insertCommitted(ColumnProjectionCache* cache, const BSONObj& doc) {
+    OperationContextNoop opCtx;
+    WriteUnitOfWork wuow(&opCtx);
+    cache->noteInsert(&opCtx, doc);
+    wuow.commit();
+}
+
+TEST(ColumnProjectionCacheTest, ValidateFields) {
+    ASSERT_OK(ColumnProjectionCache::validateFields({}));
+    ASSERT_OK(ColumnProjectionCache::validateFields({"a", "b"}));
+    ASSERT_NOT_OK(ColumnProjectionCache::validateFields({""}));
+    ASSERT_NOT_OK(ColumnProjectionCache::validateFields({"a.b"}));
+    ASSERT_NOT_OK(ColumnProjectionCache::validateFields({"$a"}));
+    ASSERT_NOT_OK(ColumnProjectionCache::validateFields({"_id"}));
+    ASSERT_NOT_OK(ColumnProjectionCache::validateFields({"a", "b", "a"}));
+
+    std::vector<std::string> tooMany;
+    for (size_t i = 0; i <= ColumnProjectionCache::kMaxFields; ++i) {
+        tooMany.push_back(str::stream() << "f" << i);
+    }
+    ASSERT_NOT_OK(ColumnProjectionCache::validateFields(tooMany));
+}
+
+TEST(ColumnProjectionCacheTest, IsFieldCached) {
+    auto cache = makeCache({"a", "b"});
+    ASSERT_TRUE(cache->isFieldCached("_id"));
+    ASSERT_TRUE(cache->isFieldCached("a"));
+    ASSERT_TRUE(cache->isFieldCached("b"));
+    ASSERT_FALSE(cache->isFieldCached("c"));
+}
+
+TEST(ColumnProjectionCacheTest, ScanReturnsOnlyCachedFieldsInDocumentOrder) {
+    auto cache = makeCache({"a", "b"});
+    cache->addInitialDocument(fromjson("{_id: 1, a: 1, c: 1, b: 'x'}"));
+    cache->addInitialDocument(fromjson("{b: {y: 2}, _id: 2, c: 2}"));
+    cache->addInitialDocument(fromjson("{_id: 3}"));
+
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), 3U);
+    ASSERT_BSONOBJ_EQ(docs[0], fromjson("{_id: 1, a: 1, b: 'x'}"));
+    ASSERT_BSONOBJ_EQ(docs[1], fromjson("{b: {y: 2}, _id: 2}"));
+    ASSERT_BSONOBJ_EQ(docs[2], fromjson("{_id: 3}"));
+    ASSERT_EQ(cache->numDocuments(), 3U);
+}
+
+TEST(ColumnProjectionCacheTest, WritesAreAppliedOnCommit) {
+    auto cache = makeCache({"a"});
+    cache->addInitialDocument(fromjson("{_id: 1, a: 1}"));
+    cache->addInitialDocument(fromjson("{_id: 2, a: 2}"));
+
+    OperationContextNoop opCtx;
+    {
+        WriteUnitOfWork wuow(&opCtx);
+        cache->noteInsert(&opCtx, fromjson("{_id: 3, a: 3}"));
+        cache->noteUpdate(&opCtx, fromjson("{_id: 1, a: 10}"));
+        cache->noteDelete(&opCtx, fromjson("{_id: 2}").firstElement());
+
+        // Nothing is visible before the unit of work commits.
+        ASSERT_EQ(scanAll(*cache).size(), 2U);
+        wuow.commit();
+    }
+
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), 2U);
+    ASSERT_BSONOBJ_EQ(docs[0], fromjson("{_id: 1, a: 10}"));
+    ASSERT_BSONOBJ_EQ(docs[1], fromjson("{_id: 3, a: 3}"));
+}
+
+TEST(ColumnProjectionCacheTest, WritesAreDiscardedOnRollback) {
+    auto cache = makeCache({"a"});
+    cache->addInitialDocument(fromjson("{_id: 1, a: 1}"));
+
+    OperationContextNoop opCtx;
+    {
+        WriteUnitOfWork wuow(&opCtx);
+        cache->noteInsert(&opCtx, fromjson("{_id: 2, a: 2}"));
+        cache->noteUpdate(&opCtx, fromjson("{_id: 1, a: 10}"));
+    }
+
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_BSONOBJ_EQ(docs[0], fromjson("{_id: 1, a: 1}"));
+}
+
+TEST(ColumnProjectionCacheTest, OutOfOrderCommitsKeepTheLatestWrite) {
+    auto cache = makeCache({"a"});
+    cache->addInitialDocument(fromjson("{_id: 1, a: 1}"));
+
+    OperationContextNoop first;
+    OperationContextNoop second;
+    WriteUnitOfWork firstWuow(&first);
+    WriteUnitOfWork secondWuow(&second);
+    cache->noteUpdate(&first, fromjson("{_id: 1, a: 2}"));
+    cache->noteUpdate(&second, fromjson("{_id: 1, a: 3}"));
+
+    secondWuow.commit();
+    firstWuow.commit();
+
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_BSONOBJ_EQ(docs[0], fromjson("{_id: 1, a: 3}"));
+}
+
+TEST(ColumnProjectionCacheTest, DeleteCommittedBeforeEarlierInsertWins) {
+    auto cache = makeCache({"a"});
+
+    OperationContextNoop first;
+    OperationContextNoop second;
+    WriteUnitOfWork firstWuow(&first);
+    WriteUnitOfWork secondWuow(&second);
+    cache->noteInsert(&first, fromjson("{_id: 1, a: 1}"));
+    cache->noteDelete(&second, fromjson("{_id: 1}").firstElement());
+
+    secondWuow.commit();
+    firstWuow.commit();
+
+    ASSERT_EQ(scanAll(*cache).size(), 0U);
+    ASSERT_EQ(cache->numDocuments(), 0U);
+}
+
+TEST(ColumnProjectionCacheTest, DeletedRowsAreReused) {
+    auto cache = makeCache({"a"});
+    for (int i = 0; i < 10; ++i) {
+        cache->addInitialDocument(BSON("_id" << i << "a" << i));
+    }
+
+    OperationContextNoop opCtx;
+    {
+        WriteUnitOfWork wuow(&opCtx);
+        cache->noteDelete(&opCtx, BSON("" << 4).firstElement());
+        wuow.commit();
+    }
+    insertCommitted(cache.get(), BSON("_id" << 10 << "a" << 10));
+
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), 10U);
+    ASSERT_BSONOBJ_EQ(docs[4], BSON("_id" << 10 << "a" << 10));
+}
+
+TEST(ColumnProjectionCacheTest, ManyUpdatesDoNotGrowTheCache) {
+    auto cache = makeCache({"a"});
+    cache->addInitialDocument(BSON("_id" << 0 << "a" << std::string(100, 'x')));
+    const size_t initialBytes = cache->dataBytes();
+
+    for (int i = 0; i < 1000; ++i) {
+        OperationContextNoop opCtx;
+        WriteUnitOfWork wuow(&opCtx);
+        cache->noteUpdate(&opCtx, BSON("_id" << 0 << "a" << std::string(100, 'a' + i % 26)));
+        wuow.commit();
+    }
+
+    ASSERT_LT(cache->dataBytes(), initialBytes + 8192);
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_EQ(docs[0]["a"].String(), std::string(100, 'a' + 999 % 26));
+}
+
+TEST(ColumnProjectionCacheTest, ScanSpansBlocks) {
+    auto cache = makeCache({"a"});
+    const int numDocs = 3 * ColumnProjectionCache::kRowsPerBlock + 1;
+    for (int i = 0; i < numDocs; ++i) {
+        cache->addInitialDocument(BSON("_id" << i << "a" << i));
+    }
+
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), static_cast<size_t>(numDocs));
+    for (int i = 0; i < numDocs; ++i) {
+        ASSERT_EQ(docs[i]["a"].numberInt(), i);
+    }
+}
+
+TEST(ColumnProjectionCacheTest, TruncateRemovesEverything) {
+    auto cache = makeCache({"a"});
+    cache->addInitialDocument(fromjson("{_id: 1, a: 1}"));
+
+    OperationContextNoop opCtx;
+    {
+        WriteUnitOfWork wuow(&opCtx);
+        cache->noteTruncate(&opCtx);
+        wuow.commit();
+    }
+    ASSERT_EQ(scanAll(*cache).size(), 0U);
+
+    insertCommitted(cache.get(), fromjson("{_id: 1, a: 2}"));
+    auto docs = scanAll(*cache);
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_BSONOBJ_EQ(docs[0], fromjson("{_id: 1, a: 2}"));
+}
+
+TEST(ColumnProjectionCacheTest, ExceedingTheSizeLimitInvalidates) {
+    auto cache = makeCache({"a"}, 64 * 1024);
+    ASSERT_TRUE(cache->isValid());
+    for (int i = 0; i < 100 && cache->isValid(); ++i) {
+        insertCommitted(cache.get(), BSON("_id" << i << "a" << std::string(1024, 'x')));
+    }
+
+    ASSERT_FALSE(cache->isValid());
+    ASSERT_EQ(cache->numDocuments(), 0U);
+    ASSERT_EQ(scanAll(*cache).size(), 0U);
+}
+
+TEST(ColumnProjectionCacheTest, DocumentWithoutIdInvalidates) {
+    auto cache = makeCache({"a"});
+    insertCommitted(cache.get(), fromjson("{a: 1}"));
+    ASSERT_FALSE(cache->isValid());
+}
+
+TEST(ColumnProjectionCacheTest, PendingChangeKeepsInvalidatedCacheAlive) {
+    OperationContextNoop opCtx;
+    WriteUnitOfWork wuow(&opCtx);
+    {
+        auto cache = makeCache({"a"});
+        cache->noteInsert(&opCtx, fromjson("{_id: 1, a: 1}"));
+        cache->invalidate("test");
+    }
+    wuow.commit();
+}
+
+}  // namespace
+}  // namespace mongo
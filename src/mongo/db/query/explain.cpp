@@ -30,6 +30,8 @@
 
 #include "mongo/db/query/explain.h"
 
+#include <algorithm>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/exec/cached_plan.h"
@@ -46,6 +48,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
@@ -130,6 +133,9 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_IDHACK == type) {
         const IDHackStats* spec = static_cast<const IDHackStats*>(specific);
         return spec->keysExamined;
+    } else if (STAGE_POINT_LOOKUP == type) {
+        const PointLookupStats* spec = static_cast<const PointLookupStats*>(specific);
+        return spec->keysExamined;
     } else if (STAGE_COUNT_SCAN == type) {
         const CountScanStats* spec = static_cast<const CountScanStats*>(specific);
         return spec->keysExamined;
@@ -160,6 +166,9 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_IDHACK == type) {
         const IDHackStats* spec = static_cast<const IDHackStats*>(specific);
         return spec->docsExamined;
+    } else if (STAGE_POINT_LOOKUP == type) {
+        const PointLookupStats* spec = static_cast<const PointLookupStats*>(specific);
+        return spec->docsExamined;
     } else if (STAGE_TEXT_OR == type) {
         const TextOrStats* spec = static_cast<const TextOrStats*>(specific);
         return spec->fetches;
@@ -198,6 +207,10 @@ void addStageSummaryStr(const PlanStage* stage, StringBuilder& sb) {
         const IndexScanStats* spec = static_cast<const IndexScanStats*>(specific);
         const KeyPattern keyPattern{spec->keyPattern};
         sb << " " << keyPattern;
+    } else if (STAGE_POINT_LOOKUP == stage->stageType()) {
+        const PointLookupStats* spec = static_cast<const PointLookupStats*>(specific);
+        const KeyPattern keyPattern{spec->keyPattern};
+        sb << " " << keyPattern;
     } else if (STAGE_TEXT == stage->stageType()) {
         const TextStats* spec = static_cast<const TextStats*>(specific);
         const KeyPattern keyPattern{spec->indexPrefix};
@@ -239,6 +252,37 @@ void appendMultikeyPaths(const BSONObj& keyPattern,
     subMultikeyPaths.doneFast();
 }
 
+/**
+ * Estimates the time spent in a profiled stage, including its descendants, by scaling the time of
+ * its sampled calls up to all of the work it performed.
+ */
+long long estimateProfiledTimeNanos(const CommonStats& common) {
+    if (0 == common.profiledWorks) {
+        return 0;
+    }
+    return static_cast<long long>(static_cast<double>(common.profiledTimeNanos) * common.works /
+                                  common.profiledWorks);
+}
+
+/**
+ * Appends the "executionProfile" section of a profiled stage to 'bob'.
+ */
+void appendExecutionProfile(const PlanStageStats& stats, BSONObjBuilder* bob) {
+    const long long totalNanos = estimateProfiledTimeNanos(stats.common);
+    long long childrenNanos = 0;
+    for (auto&& child : stats.children) {
+        childrenNanos += estimateProfiledTimeNanos(child->common);
+    }
+
+    BSONObjBuilder profileBob(bob->subobjStart("executionProfile"));
+    profileBob.appendNumber("sampledWorks", stats.common.profiledWorks);
+    profileBob.appendNumber("sampledTimeNanos", stats.common.profiledTimeNanos);
+    profileBob.appendNumber("executionTimeNanosEstimate", totalNanos);
+    // The part of the time which is not spent in the children, i.e. the cost of this stage.
+    profileBob.appendNumber("selfTimeNanosEstimate", std::max(0LL, totalNanos - childrenNanos));
+    profileBob.doneFast();
+}
+
 }  // namespace
 
 namespace mongo {
@@ -282,6 +326,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         bob->appendNumber("invalidates", stats.common.invalidates);
     }
 
+    if (verbosity >= ExplainOptions::Verbosity::kExecProfile && stats.common.profiledWorks > 0) {
+        appendExecutionProfile(stats, bob);
+    }
+
     // Stage-specific stats
     if (STAGE_AND_HASH == stats.stageType) {
         AndHashStats* spec = static_cast<AndHashStats*>(stats.specific.get());
@@ -309,15 +357,37 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_COLLSCAN == stats.stageType) {
         CollectionScanStats* spec = static_cast<CollectionScanStats*>(stats.specific.get());
         bob->append("direction", spec->direction > 0 ? "forward" : "backward");
+        if (spec->parallelism > 1) {
+            bob->append("parallelism", spec->parallelism);
+        }
+        if (spec->shared) {
+            bob->appendBool("shared", true);
+        }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
+            if (spec->shared) {
+                bob->appendBool("joinedSharedScan", spec->joinedSharedScan);
+            }
+        }
+    } else if (STAGE_COLUMN_SCAN == stats.stageType) {
+        ColumnScanStats* spec = static_cast<ColumnScanStats*>(stats.specific.get());
+        bob->append("cachedFields", spec->cachedFields);
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("rowsExamined", spec->rowsExamined);
         }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
 
+        if (!spec->prefixCountIndexName.empty()) {
+            bob->append("prefixCountIndex", spec->prefixCountIndexName);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("nCounted", spec->nCounted);
             bob->appendNumber("nSkipped", spec->nSkipped);
+            if (spec->subtractOrphans) {
+                bob->appendNumber("nOrphans", spec->nOrphans);
+            }
         }
     } else if (STAGE_COUNT_SCAN == stats.stageType) {
         CountScanStats* spec = static_cast<CountScanStats*>(stats.specific.get());
@@ -340,12 +410,16 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         bob->appendBool("isPartial", spec->isPartial);
         bob->append("indexVersion", spec->indexVersion);
 
-        BSONObjBuilder indexBoundsBob;
-        indexBoundsBob.append("startKey", spec->startKey);
-        indexBoundsBob.append("startKeyInclusive", spec->startKeyInclusive);
-        indexBoundsBob.append("endKey", spec->endKey);
-        indexBoundsBob.append("endKeyInclusive", spec->endKeyInclusive);
-        bob->append("indexBounds", indexBoundsBob.obj());
+        if (!spec->indexBounds.isEmpty()) {
+            bob->append("indexBounds", spec->indexBounds);
+        } else {
+            BSONObjBuilder indexBoundsBob;
+            indexBoundsBob.append("startKey", spec->startKey);
+            indexBoundsBob.append("startKeyInclusive", spec->startKeyInclusive);
+            indexBoundsBob.append("endKey", spec->endKey);
+            indexBoundsBob.append("endKeyInclusive", spec->endKeyInclusive);
+            bob->append("indexBounds", indexBoundsBob.obj());
+        }
     } else if (STAGE_DELETE == stats.stageType) {
         DeleteStats* spec = static_cast<DeleteStats*>(stats.specific.get());
 
@@ -424,6 +498,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->appendNumber("keysExamined", spec->keysExamined);
             bob->appendNumber("docsExamined", spec->docsExamined);
         }
+    } else if (STAGE_POINT_LOOKUP == stats.stageType) {
+        PointLookupStats* spec = static_cast<PointLookupStats*>(stats.specific.get());
+        bob->append("keyPattern", spec->keyPattern);
+        bob->append("indexName", spec->indexName);
+        bob->appendNumber("numKeys", spec->numKeys);
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("keysExamined", spec->keysExamined);
+            bob->appendNumber("docsExamined", spec->docsExamined);
+        }
     } else if (STAGE_IXSCAN == stats.stageType) {
         IndexScanStats* spec = static_cast<IndexScanStats*>(stats.specific.get());
 
@@ -485,6 +568,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            if (spec->usedDisk) {
+                bob->appendBool("usedDisk", true);
+            }
         }
 
         if (spec->limit > 0) {
@@ -725,6 +811,12 @@ void Explain::explainStages(PlanExecutor* exec,
         }
     }
 
+    // Profile every stage of the plan while it runs, if asked to.
+    if (verbosity >= ExplainOptions::Verbosity::kExecProfile) {
+        exec->getRootStage()->enableProfiling(
+            std::max(1, internalQueryExecProfileSampleInterval.load()));
+    }
+
     // If we need execution stats, then run the plan in order to gather the stats.
     Status executePlanStatus = Status::OK();
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
@@ -768,6 +860,13 @@ void Explain::explainStages(PlanExecutor* exec,
             durationCount<Milliseconds>(CurOp::get(opCtx)->elapsedTimeTotal());
         generateExecStats(winningStats.get(), verbosity, &execBob, totalTimeMillis);
 
+        BSONObjBuilder storageStatsBob;
+        opCtx->recoveryUnit()->appendOperationStatistics(&storageStatsBob);
+        BSONObj storageStats = storageStatsBob.obj();
+        if (!storageStats.isEmpty()) {
+            execBob.append("storage", storageStats);
+        }
+
         // Also generate exec stats for all plans, if the verbosity level is high enough.
         // These stats reflect what happened during the trial period that ranked the plans.
         if (verbosity >= ExplainOptions::Verbosity::kExecAllPlans) {
@@ -881,6 +980,16 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const IDHackStats* idHackStats =
                 static_cast<const IDHackStats*>(idHackStage->getSpecificStats());
             statsOut->indexesUsed.insert(idHackStats->indexName);
+        } else if (STAGE_POINT_LOOKUP == stages[i]->stageType()) {
+            const PointLookupStats* pointLookupStats =
+                static_cast<const PointLookupStats*>(stages[i]->getSpecificStats());
+            statsOut->indexesUsed.insert(pointLookupStats->indexName);
+        } else if (STAGE_COUNT == stages[i]->stageType()) {
+            const CountStats* countStats =
+                static_cast<const CountStats*>(stages[i]->getSpecificStats());
+            if (!countStats->prefixCountIndexName.empty()) {
+                statsOut->indexesUsed.insert(countStats->prefixCountIndexName);
+            }
         } else if (STAGE_DISTINCT_SCAN == stages[i]->stageType()) {
             const DistinctScan* distinctScan = static_cast<const DistinctScan*>(stages[i]);
             const DistinctScanStats* distinctScanStats =
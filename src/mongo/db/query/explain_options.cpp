@@ -39,6 +39,7 @@ constexpr StringData ExplainOptions::kVerbosityName;
 constexpr StringData ExplainOptions::kQueryPlannerVerbosityStr;
 constexpr StringData ExplainOptions::kExecStatsVerbosityStr;
 constexpr StringData ExplainOptions::kAllPlansExecutionVerbosityStr;
+constexpr StringData ExplainOptions::kExecProfileVerbosityStr;
 
 StringData ExplainOptions::verbosityString(ExplainOptions::Verbosity verbosity) {
     switch (verbosity) {
@@ -48,6 +49,8 @@ StringData ExplainOptions::verbosityString(ExplainOptions::Verbosity verbosity)
             return kExecStatsVerbosityStr;
         case Verbosity::kExecAllPlans:
             return kAllPlansExecutionVerbosityStr;
+        case Verbosity::kExecProfile:
+            return kExecProfileVerbosityStr;
         default:
             MONGO_UNREACHABLE;
     }
@@ -69,6 +72,8 @@ StatusWith<ExplainOptions::Verbosity> ExplainOptions::parseCmdBSON(const BSONObj
             verbosity = Verbosity::kQueryPlanner;
         } else if (verbStr == kExecStatsVerbosityStr) {
             verbosity = Verbosity::kExecStats;
+        } else if (verbStr == kExecProfileVerbosityStr) {
+            verbosity = Verbosity::kExecProfile;
         } else if (verbStr != kAllPlansExecutionVerbosityStr) {
             return Status(ErrorCodes::FailedToParse,
                           str::stream() << "verbosity string must be one of {'"
@@ -77,6 +82,8 @@ StatusWith<ExplainOptions::Verbosity> ExplainOptions::parseCmdBSON(const BSONObj
                                         << kExecStatsVerbosityStr
                                         << "', '"
                                         << kAllPlansExecutionVerbosityStr
+                                        << "', '"
+                                        << kExecProfileVerbosityStr
                                         << "'}");
         }
     }
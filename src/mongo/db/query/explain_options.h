@@ -57,6 +57,11 @@ public:
         // At this verbosity level, we generate the execution stats for each rejected plan as well
         // as the winning plan. String alias is "allPlansExecution".
         kExecAllPlans = 2,
+
+        // In addition to everything at "allPlansExecution", each stage of the winning plan is
+        // profiled while it runs, and reports sampled high resolution timings. String alias is
+        // "executionProfile".
+        kExecProfile = 3,
     };
 
     static constexpr StringData kVerbosityName = "verbosity"_sd;
@@ -65,6 +70,7 @@ public:
     static constexpr StringData kQueryPlannerVerbosityStr = "queryPlanner"_sd;
     static constexpr StringData kExecStatsVerbosityStr = "executionStats"_sd;
     static constexpr StringData kAllPlansExecutionVerbosityStr = "allPlansExecution"_sd;
+    static constexpr StringData kExecProfileVerbosityStr = "executionProfile"_sd;
 
     /**
      * Converts an explain verbosity to its string representation.
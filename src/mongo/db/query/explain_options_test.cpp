@@ -45,6 +45,8 @@ TEST(ExplainOptionsTest, VerbosityEnumToStringReturnsCorrectValues) {
               "executionStats"_sd);
     ASSERT_EQ(ExplainOptions::verbosityString(ExplainOptions::Verbosity::kExecAllPlans),
               "allPlansExecution"_sd);
+    ASSERT_EQ(ExplainOptions::verbosityString(ExplainOptions::Verbosity::kExecProfile),
+              "executionProfile"_sd);
 }
 
 TEST(ExplainOptionsTest, ExplainOptionsSerializeToBSONCorrectly) {
@@ -57,6 +59,9 @@ TEST(ExplainOptionsTest, ExplainOptionsSerializeToBSONCorrectly) {
     ASSERT_BSONOBJ_EQ(BSON("verbosity"
                            << "allPlansExecution"),
                       ExplainOptions::toBSON(ExplainOptions::Verbosity::kExecAllPlans));
+    ASSERT_BSONOBJ_EQ(BSON("verbosity"
+                           << "executionProfile"),
+                      ExplainOptions::toBSON(ExplainOptions::Verbosity::kExecProfile));
 }
 
 TEST(ExplainOptionsTest, CanParseExplainVerbosity) {
@@ -69,6 +74,9 @@ TEST(ExplainOptionsTest, CanParseExplainVerbosity) {
     verbosity = unittest::assertGet(
         ExplainOptions::parseCmdBSON(fromjson("{explain: {}, verbosity: 'allPlansExecution'}")));
     ASSERT(verbosity == ExplainOptions::Verbosity::kExecAllPlans);
+    verbosity = unittest::assertGet(
+        ExplainOptions::parseCmdBSON(fromjson("{explain: {}, verbosity: 'executionProfile'}")));
+    ASSERT(verbosity == ExplainOptions::Verbosity::kExecProfile);
 }
 
 TEST(ExplainOptionsTest, ParsingFailsIfVerbosityIsNotAString) {
@@ -28,7 +28,9 @@
 
 #include "mongo/db/query/expression_index.h"
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <unordered_set>
 
 #include "mongo/db/geo/geoconstants.h"
@@ -37,6 +39,9 @@
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -51,6 +56,14 @@ BSONObj ExpressionMapping::hash(const BSONElement& value) {
     return bob.obj();
 }
 
+BSONObj ExpressionMapping::hash(const BSONElement& value, int hashVersion) {
+    BSONObjBuilder bob;
+    bob.append("",
+               BSONElementHasher::hash64(
+                   value, BSONElementHasher::DEFAULT_HASH_SEED, hashVersion));
+    return bob.obj();
+}
+
 // For debugging only
 static std::string toCoveringString(const GeoHashConverter& hashConverter,
                                     const set<GeoHash>& covering) {
@@ -86,14 +99,103 @@ std::vector<GeoHash> ExpressionMapping::get2dCovering(const R2Region& region,
     return unorderedCovering;
 }
 
-void ExpressionMapping::GeoHashsToIntervalsWithParents(
-    const std::vector<GeoHash>& unorderedCovering, OrderedIntervalList* oilOut) {
+namespace {
+
+/**
+ * A closed range of 2d index hash values. The hashes are compared as unsigned integers, which is
+ * the order of the BinData keys in the index.
+ */
+struct HashRange {
+    unsigned long long min;
+    unsigned long long max;
+};
+
+HashRange toHashRange(const GeoHash& cell) {
+    const unsigned long long min = static_cast<unsigned long long>(cell.getHash());
+    const unsigned bits = cell.getBits();
+    const unsigned long long suffix = (bits >= 32) ? 0 : (~0ULL >> (2 * bits));
+    return {min, min | suffix};
+}
+
+/**
+ * Returns the ranges covered by 'covering', in order, with touching or overlapping ranges merged.
+ */
+std::vector<HashRange> toMergedHashRanges(const std::vector<GeoHash>& unorderedCovering) {
     set<GeoHash> covering(unorderedCovering.begin(), unorderedCovering.end());
-    for (set<GeoHash>::const_iterator it = covering.begin(); it != covering.end(); ++it) {
-        const GeoHash& geoHash = *it;
+
+    std::vector<HashRange> ranges;
+    for (const GeoHash& cell : covering) {
+        HashRange range = toHashRange(cell);
+        if (!ranges.empty() &&
+            (ranges.back().max == ~0ULL || range.min <= ranges.back().max + 1)) {
+            ranges.back().max = std::max(ranges.back().max, range.max);
+        } else {
+            ranges.push_back(range);
+        }
+    }
+    return ranges;
+}
+
+/**
+ * Merges consecutive ranges across the smallest gaps between them while the total length of the
+ * merged gaps is at most 'maxGapFraction' times the total length of 'ranges'.
+ */
+void mergeAcrossGaps(double maxGapFraction, std::vector<HashRange>* ranges) {
+    if (ranges->size() < 2 || !(maxGapFraction > 0.0)) {
+        return;
+    }
+
+    // Lengths can reach 2^64, so accumulate them as doubles.
+    double coveredLength = 0;
+    for (const HashRange& range : *ranges) {
+        coveredLength += static_cast<double>(range.max - range.min) + 1;
+    }
+
+    // gaps[i] is the gap between (*ranges)[i] and (*ranges)[i + 1].
+    std::vector<size_t> gapsBySize(ranges->size() - 1);
+    std::iota(gapsBySize.begin(), gapsBySize.end(), 0);
+    auto gapLength = [&](size_t i) { return (*ranges)[i + 1].min - (*ranges)[i].max - 1; };
+    std::sort(gapsBySize.begin(), gapsBySize.end(), [&](size_t lhs, size_t rhs) {
+        return gapLength(lhs) < gapLength(rhs);
+    });
+
+    std::vector<bool> mergeGap(gapsBySize.size(), false);
+    double remainingBudget = maxGapFraction * coveredLength;
+    for (size_t gap : gapsBySize) {
+        const double length = static_cast<double>(gapLength(gap));
+        if (length > remainingBudget) {
+            break;
+        }
+        remainingBudget -= length;
+        mergeGap[gap] = true;
+    }
+
+    std::vector<HashRange> merged;
+    merged.push_back(ranges->front());
+    for (size_t i = 1; i < ranges->size(); ++i) {
+        if (mergeGap[i - 1]) {
+            merged.back().max = (*ranges)[i].max;
+        } else {
+            merged.push_back((*ranges)[i]);
+        }
+    }
+    ranges->swap(merged);
+}
+
+}  // namespace
+
+void ExpressionMapping::GeoHashsToIntervalsWithParents(
+    const std::vector<GeoHash>& unorderedCovering,
+    OrderedIntervalList* oilOut,
+    double maxGapFraction) {
+    std::vector<HashRange> ranges = toMergedHashRanges(unorderedCovering);
+    mergeAcrossGaps(maxGapFraction, &ranges);
+
+    for (const HashRange& range : ranges) {
+        // A full-precision GeoHash has no suffix bits, so its min bound is the hash itself.
         BSONObjBuilder builder;
-        geoHash.appendHashMin(&builder, "");
-        geoHash.appendHashMax(&builder, "");
+        GeoHash(static_cast<long long>(range.min), 32).appendHashMin(&builder, "");
+        GeoHash(static_cast<long long>(range.max), 32).appendHashMin(&builder, "");
 
         oilOut->intervals.push_back(IndexBoundsBuilder::makeRangeInterval(
             builder.obj(), BoundInclusion::kIncludeBothStartAndEndKeys));
@@ -103,33 +205,114 @@ void ExpressionMapping::GeoHashsToIntervalsWithParents(
 void ExpressionMapping::cover2d(const R2Region& region,
                                 const BSONObj& indexInfoObj,
                                 int maxCoveringCells,
-                                OrderedIntervalList* oilOut) {
+                                OrderedIntervalList* oilOut,
+                                double maxGapFraction) {
     std::vector<GeoHash> unorderedCovering = get2dCovering(region, indexInfoObj, maxCoveringCells);
-    GeoHashsToIntervalsWithParents(unorderedCovering, oilOut);
+    GeoHashsToIntervalsWithParents(unorderedCovering, oilOut, maxGapFraction);
 }
 
-std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
-    auto minLevel = internalQueryS2GeoCoarsestLevel.load();
-    auto maxLevel = internalQueryS2GeoFinestLevel.load();
+namespace {
+
+/**
+ * Identifies a covering by the coverer settings in effect and a 128-bit hash of the geometry
+ * specification, so that changing the S2 knobs never serves a stale covering. Only the hash is
+ * kept, since large polygons would otherwise make the cache keys as big as the polygons.
+ */
+struct CoveringCacheKey {
+    int minLevel;
+    int maxLevel;
+    int maxCells;
+    uint64_t specHash[2];
 
+    bool operator==(const CoveringCacheKey& other) const {
+        return minLevel == other.minLevel && maxLevel == other.maxLevel &&
+            maxCells == other.maxCells && specHash[0] == other.specHash[0] &&
+            specHash[1] == other.specHash[1];
+    }
+};
+
+struct CoveringCacheKeyHasher {
+    std::size_t operator()(const CoveringCacheKey& key) const {
+        return static_cast<std::size_t>(key.specHash[0]);
+    }
+};
+
+using CoveringCache = LRUCache<CoveringCacheKey, std::vector<S2CellId>, CoveringCacheKeyHasher>;
+
+stdx::mutex coveringCacheMutex;
+
+CoveringCache& getCoveringCache() {
+    static CoveringCache cache(
+        static_cast<std::size_t>(std::max(0, internalQueryS2GeoCoveringCacheSize)));
+    return cache;
+}
+
+void checkCoveringLevels(int minLevel, int maxLevel) {
     uassert(28739, "Geo coarsest level must be in range [0,30]", 0 <= minLevel && minLevel <= 30);
     uassert(28740, "Geo finest level must be in range [0,30]", 0 <= maxLevel && maxLevel <= 30);
     uassert(28741, "Geo coarsest level must be less than or equal to finest", minLevel <= maxLevel);
+}
 
+std::vector<S2CellId> computeCovering(const S2Region& region,
+                                      int minLevel,
+                                      int maxLevel,
+                                      int maxCells) {
     S2RegionCoverer coverer;
     coverer.set_min_level(minLevel);
     coverer.set_max_level(maxLevel);
-    coverer.set_max_cells(internalQueryS2GeoMaxCells.load());
+    coverer.set_max_cells(maxCells);
 
     std::vector<S2CellId> cover;
     coverer.GetCovering(region, &cover);
     return cover;
 }
 
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+    auto minLevel = internalQueryS2GeoCoarsestLevel.load();
+    auto maxLevel = internalQueryS2GeoFinestLevel.load();
+    checkCoveringLevels(minLevel, maxLevel);
+
+    return computeCovering(region, minLevel, maxLevel, internalQueryS2GeoMaxCells.load());
+}
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region,
+                                                             const BSONObj& geometrySpec) {
+    if (geometrySpec.isEmpty() || internalQueryS2GeoCoveringCacheSize <= 0) {
+        return get2dsphereCovering(region);
+    }
+
+    CoveringCacheKey key;
+    key.minLevel = internalQueryS2GeoCoarsestLevel.load();
+    key.maxLevel = internalQueryS2GeoFinestLevel.load();
+    key.maxCells = internalQueryS2GeoMaxCells.load();
+    checkCoveringLevels(key.minLevel, key.maxLevel);
+    MurmurHash3_x64_128(geometrySpec.objdata(), geometrySpec.objsize(), 0, key.specHash);
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(coveringCacheMutex);
+        auto& cache = getCoveringCache();
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+    }
+
+    // Compute the covering outside the lock; two threads racing on the same geometry simply
+    // produce the same covering twice.
+    auto cover = computeCovering(region, key.minLevel, key.maxLevel, key.maxCells);
+
+    stdx::lock_guard<stdx::mutex> lk(coveringCacheMutex);
+    getCoveringCache().add(key, cover);
+    return cover;
+}
+
 void ExpressionMapping::cover2dsphere(const S2Region& region,
                                       const S2IndexingParams& indexingParams,
-                                      OrderedIntervalList* oilOut) {
-    std::vector<S2CellId> cover = get2dsphereCovering(region);
+                                      OrderedIntervalList* oilOut,
+                                      const BSONObj& geometrySpec) {
+    std::vector<S2CellId> cover = get2dsphereCovering(region, geometrySpec);
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
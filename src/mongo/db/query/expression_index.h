@@ -50,20 +50,39 @@ class ExpressionMapping {
 public:
     static BSONObj hash(const BSONElement& value);
 
+    // Hashes 'value' with the hash function of the given hashed index 'hashVersion'.
+    static BSONObj hash(const BSONElement& value, int hashVersion);
+
     static std::vector<GeoHash> get2dCovering(const R2Region& region,
                                               const BSONObj& indexInfoObj,
                                               int maxCoveringCells);
 
+    /**
+     * Converts a 2d covering to index bounds. Cells whose hash ranges touch are scanned as a
+     * single interval. Beyond that, the smallest gaps between cells are also folded into the
+     * intervals as long as their total length stays within 'maxGapFraction' of the length of the
+     * covered cells; the extra keys scanned this way are removed by the fetch filter.
+     */
     static void GeoHashsToIntervalsWithParents(const std::vector<GeoHash>& unorderedCovering,
-                                               OrderedIntervalList* oilOut);
+                                               OrderedIntervalList* oilOut,
+                                               double maxGapFraction = 0.0);
 
     static void cover2d(const R2Region& region,
                         const BSONObj& indexInfoObj,
                         int maxCoveringCells,
-                        OrderedIntervalList* oilOut);
+                        OrderedIntervalList* oilOut,
+                        double maxGapFraction = 0.0);
 
     static std::vector<S2CellId> get2dsphereCovering(const S2Region& region);
 
+    /**
+     * Like above, but first consults a process-wide cache of coverings keyed by a hash of
+     * 'geometrySpec', which must uniquely describe 'region' (e.g. the raw BSON of the geo
+     * predicate). Repeated queries against the same polygon then skip the S2RegionCoverer.
+     */
+    static std::vector<S2CellId> get2dsphereCovering(const S2Region& region,
+                                                     const BSONObj& geometrySpec);
+
     static void S2CellIdsToIntervals(const std::vector<S2CellId>& intervalSet,
                                      const S2IndexVersion indexVersion,
                                      OrderedIntervalList* oilOut);
@@ -74,9 +93,15 @@ public:
                                                 const S2IndexingParams& indexParams,
                                                 OrderedIntervalList* out);
 
+    /**
+     * Computes the covering of 'region' and converts it to index bounds. If 'geometrySpec' is
+     * non-empty, the covering is looked up in and added to the covering cache; see
+     * get2dsphereCovering().
+     */
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
-                              OrderedIntervalList* oilOut);
+                              OrderedIntervalList* oilOut,
+                              const BSONObj& geometrySpec = BSONObj());
 };
 
 }  // namespace mongo
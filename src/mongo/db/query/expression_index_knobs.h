@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/platform/atomic_word.h"
 
 namespace mongo {
@@ -46,6 +47,12 @@ extern AtomicInt32 internalGeoPredicateQuery2DMaxCoveringCells;
  */
 extern AtomicInt32 internalGeoNearQuery2DMaxCoveringCells;
 
+/**
+ * When converting a 2D predicate query covering to index bounds, neighbouring cells are scanned as
+ * one range if the gaps this adds to the scan total at most this fraction of the covered cells.
+ */
+extern AtomicDouble internalGeoPredicateQuery2DCoveringMaxGapFraction;
+
 //
 // Geo query.
 //
@@ -59,4 +66,7 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// How many 2dsphere query coverings to cache, keyed by geometry. Zero disables the cache.
+extern int internalQueryS2GeoCoveringCacheSize;
+
 }  // namespace mongo
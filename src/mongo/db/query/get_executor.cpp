@@ -32,7 +32,9 @@
 
 #include "mongo/db/query/get_executor.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
+#include <cctype>
 #include <limits>
 #include <memory>
 
@@ -40,25 +42,37 @@
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/eof.h"
+#include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/group.h"
 #include "mongo/db/exec/idhack.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/limit.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/oplogstart.h"
+#include "mongo/db/exec/or.h"
+#include "mongo/db/exec/point_lookup.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/subplan.h"
 #include "mongo/db/exec/update.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/index_prefix_counts.h"
 #include "mongo/db/index_names.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
@@ -72,6 +86,8 @@
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
+#include "mongo/db/range_arithmetic.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -120,6 +136,31 @@ namespace {
 // The body is below in the "count hack" section but getExecutor calls it.
 bool turnIxscanIntoCount(QuerySolution* soln);
 
+/**
+ * Returns true if the solution rooted at 'node' is a chain of single-child stages over an index
+ * scan whose bounds are a single point on every field of a unique index.
+ */
+bool isUniqueIndexPointLookup(const QuerySolutionNode* node) {
+    while (node->children.size() == 1U) {
+        node = node->children[0];
+    }
+    if (!node->children.empty() || STAGE_IXSCAN != node->getType()) {
+        return false;
+    }
+
+    const auto* ixscan = static_cast<const IndexScanNode*>(node);
+    if (!ixscan->index.unique || ixscan->bounds.isSimpleRange ||
+        ixscan->bounds.fields.size() != static_cast<size_t>(ixscan->index.keyPattern.nFields())) {
+        return false;
+    }
+
+    return std::all_of(ixscan->bounds.fields.begin(),
+                       ixscan->bounds.fields.end(),
+                       [](const OrderedIntervalList& oil) {
+                           return oil.intervals.size() == 1U && oil.intervals[0].isPoint();
+                       });
+}
+
 }  // namespace
 
 
@@ -194,6 +235,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerGenerateSkipScans.load()) {
+        plannerParams->options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     // Doc-level locking storage engines cannot answer predicates implicitly via exact index
@@ -213,6 +258,20 @@ void fillOutPlannerParams(OperationContext* opCtx,
     if (isMMAPV1()) {
         plannerParams->options |= QueryPlannerParams::SNAPSHOT_USE_ID;
     }
+
+    // The column projection cache reflects the latest committed writes, so it cannot serve reads
+    // that must see an older, majority-committed view of the data.
+    auto columnCache = collection->infoCache()->getColumnProjectionCache();
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    if (columnCache && columnCache->isValid() &&
+        (readConcernLevel == repl::ReadConcernLevel::kLocalReadConcern ||
+         readConcernLevel == repl::ReadConcernLevel::kAvailableReadConcern)) {
+        plannerParams->columnCacheAvailable = true;
+        plannerParams->columnCacheFields.insert("_id");
+        for (auto&& field : columnCache->getFields()) {
+            plannerParams->columnCacheFields.insert(field);
+        }
+    }
 }
 
 namespace {
@@ -230,6 +289,56 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+/**
+ * Adds the shard filter and the projection of 'canonicalQuery' on top of 'root', a plan built
+ * without the query planner whose leaf fetches the full documents.
+ */
+unique_ptr<PlanStage> addFilterAndProjectionStages(OperationContext* opCtx,
+                                                   const CanonicalQuery& canonicalQuery,
+                                                   const QueryPlannerParams& plannerParams,
+                                                   WorkingSet* ws,
+                                                   unique_ptr<PlanStage> root) {
+    // Might have to filter out orphaned docs.
+    if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
+        root = make_unique<ShardFilterStage>(
+            opCtx,
+            CollectionShardingState::get(opCtx, canonicalQuery.nss())->getMetadata(),
+            ws,
+            root.release());
+    }
+
+    // There might be a projection. The leaf stage will always fetch the full document, so we
+    // don't support covered projections. However, we might use the simple inclusion fast path.
+    if (NULL != canonicalQuery.getProj()) {
+        ProjectionStageParams params;
+        params.projObj = canonicalQuery.getProj()->getProjObj();
+        params.collator = canonicalQuery.getCollator();
+
+        // Add a SortKeyGeneratorStage if there is a $meta sortKey projection.
+        if (canonicalQuery.getProj()->wantSortKey()) {
+            root = make_unique<SortKeyGeneratorStage>(opCtx,
+                                                      root.release(),
+                                                      ws,
+                                                      canonicalQuery.getQueryRequest().getSort(),
+                                                      canonicalQuery.getCollator());
+        }
+
+        // Stuff the right data into the params depending on what proj impl we use.
+        if (canonicalQuery.getProj()->requiresDocument() ||
+            canonicalQuery.getProj()->wantIndexKey() || canonicalQuery.getProj()->wantSortKey() ||
+            canonicalQuery.getProj()->hasDottedFieldPath()) {
+            params.fullExpression = canonicalQuery.root();
+            params.projImpl = ProjectionStageParams::NO_FAST_PATH;
+        } else {
+            params.projImpl = ProjectionStageParams::SIMPLE_DOC;
+        }
+
+        root = make_unique<ProjectionStage>(opCtx, params, ws, root.release());
+    }
+
+    return root;
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -281,48 +390,38 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
 
         root = make_unique<IDHackStage>(opCtx, collection, canonicalQuery.get(), ws, descriptor);
+        root = addFilterAndProjectionStages(
+            opCtx, *canonicalQuery, plannerParams, ws, std::move(root));
+        return PrepareExecutionResult(
+            std::move(canonicalQuery), std::move(querySolution), std::move(root));
+    }
 
-        // Might have to filter out orphaned docs.
-        if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
-            root = make_unique<ShardFilterStage>(
-                opCtx,
-                CollectionShardingState::get(opCtx, canonicalQuery->nss())->getMetadata(),
-                ws,
-                root.release());
-        }
-
-        // There might be a projection. The idhack stage will always fetch the full
-        // document, so we don't support covered projections. However, we might use the
-        // simple inclusion fast path.
-        if (NULL != canonicalQuery->getProj()) {
-            ProjectionStageParams params;
-            params.projObj = canonicalQuery->getProj()->getProjObj();
-            params.collator = canonicalQuery->getCollator();
-
-            // Add a SortKeyGeneratorStage if there is a $meta sortKey projection.
-            if (canonicalQuery->getProj()->wantSortKey()) {
-                root =
-                    make_unique<SortKeyGeneratorStage>(opCtx,
-                                                       root.release(),
-                                                       ws,
-                                                       canonicalQuery->getQueryRequest().getSort(),
-                                                       canonicalQuery->getCollator());
-            }
-
-            // Stuff the right data into the params depending on what proj impl we use.
-            if (canonicalQuery->getProj()->requiresDocument() ||
-                canonicalQuery->getProj()->wantIndexKey() ||
-                canonicalQuery->getProj()->wantSortKey() ||
-                canonicalQuery->getProj()->hasDottedFieldPath()) {
-                params.fullExpression = canonicalQuery->root();
-                params.projImpl = ProjectionStageParams::NO_FAST_PATH;
-            } else {
-                params.projImpl = ProjectionStageParams::SIMPLE_DOC;
-            }
-
-            root = make_unique<ProjectionStage>(opCtx, params, ws, root.release());
+    // Equalities on all the fields of a unique index are answered by seeking it for each key
+    // matched, unless index filters restrict the indexes the query may use.
+    vector<BSONObj> lookupKeys;
+    const IndexDescriptor* lookupDescriptor = plannerParams.indexFiltersApplied
+        ? nullptr
+        : PointLookupStage::getLookupIndex(opCtx, collection, *canonicalQuery, &lookupKeys);
+    if (lookupDescriptor) {
+        LOG(2) << "Using point lookups on index " << lookupDescriptor->indexName() << ": "
+               << redact(canonicalQuery->toStringShort());
+
+        root = make_unique<PointLookupStage>(opCtx,
+                                             collection,
+                                             ws,
+                                             lookupDescriptor,
+                                             std::move(lookupKeys),
+                                             canonicalQuery->root());
+
+        const QueryRequest& qr = canonicalQuery->getQueryRequest();
+        if (qr.getLimit()) {
+            root = make_unique<LimitStage>(opCtx, *qr.getLimit(), ws, root.release());
+        } else if (qr.getNToReturn() && !qr.wantMore()) {
+            root = make_unique<LimitStage>(opCtx, *qr.getNToReturn(), ws, root.release());
         }
 
+        root = addFilterAndProjectionStages(
+            opCtx, *canonicalQuery, plannerParams, ws, std::move(root));
         return PrepareExecutionResult(
             std::move(canonicalQuery), std::move(querySolution), std::move(root));
     }
@@ -363,6 +462,7 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
                                                 canonicalQuery.get(),
                                                 plannerParams,
                                                 cs->decisionWorks,
+                                                cs->wantsFeedback,
                                                 rawRoot);
             querySolution.reset(qs);
             return PrepareExecutionResult(
@@ -423,6 +523,34 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // A plan which looks up a single key of a unique index examines at most one document, so no
+    // other candidate can do meaningfully better. Run it without a trial period.
+    if (solutions.size() > 1 && internalQueryPlannerSkipTrialForUniquePointLookups.load()) {
+        for (size_t i = 0; i < solutions.size(); ++i) {
+            if (isUniqueIndexPointLookup(solutions[i]->root.get())) {
+                // Clean up the other QuerySolution(s).
+                for (size_t j = 0; j < solutions.size(); ++j) {
+                    if (j != i) {
+                        delete solutions[j];
+                    }
+                }
+
+                PlanStage* rawRoot;
+                verify(StageBuilder::build(
+                    opCtx, collection, *canonicalQuery, *solutions[i], ws, &rawRoot));
+                root.reset(rawRoot);
+
+                LOG(2) << "Using unique index point lookup without plan ranking: "
+                       << redact(canonicalQuery->toStringShort())
+                       << ", planSummary: " << redact(Explain::getPlanSummary(root.get()));
+
+                querySolution.reset(solutions[i]);
+                return PrepareExecutionResult(
+                    std::move(canonicalQuery), std::move(querySolution), std::move(root));
+            }
+        }
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
@@ -689,6 +817,46 @@ StatusWith<unique_ptr<PlanStage>> applyProjection(OperationContext* opCtx,
     return {make_unique<ProjectionStage>(opCtx, params, ws, root.release())};
 }
 
+/**
+ * Fills out 'params' for a ProjectionStage which applies 'proj' to the document returned by an
+ * update or delete of the document whose _id is 'idElt', without a CanonicalQuery. Returns false
+ * if the projection depends on the query, in which case the request must be canonicalized.
+ */
+StatusWith<bool> makeIdHackProjectionParams(const BSONElement& idElt,
+                                            const BSONObj& proj,
+                                            const CollatorInterface* collator,
+                                            ProjectionStageParams* params) {
+    invariant(!proj.isEmpty());
+
+    // A simple _id query matches exactly what this expression does.
+    EqualityMatchExpression idQuery;
+    Status status = idQuery.init("_id", idElt);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    ParsedProjection* rawParsedProj;
+    Status ppStatus = ParsedProjection::make(proj.getOwned(), &idQuery, &rawParsedProj);
+    if (!ppStatus.isOK()) {
+        return ppStatus;
+    }
+    unique_ptr<ParsedProjection> pp(rawParsedProj);
+
+    // The canonicalized request reports the errors for positional and $meta sortKey projections.
+    if (pp->requiresMatchDetails() || pp->wantSortKey()) {
+        return false;
+    }
+
+    params->projObj = proj.getOwned();
+    params->collator = collator;
+    if (pp->requiresDocument() || pp->wantIndexKey() || pp->hasDottedFieldPath()) {
+        params->projImpl = ProjectionStageParams::NO_FAST_PATH;
+    } else {
+        params->projImpl = ProjectionStageParams::SIMPLE_DOC;
+    }
+    return true;
+}
+
 }  // namespace
 
 //
@@ -767,14 +935,37 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
             CollatorInterface::collatorsMatch(collator.get(), collection->getDefaultCollator());
 
         if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
-            LOG(2) << "Using idhack: " << redact(unparsedQuery);
+            hasCollectionDefaultCollation) {
+            // A findAndModify which returns the deleted document may project it without the
+            // query, so it can use the idhack fast path as well.
+            ProjectionStageParams projParams;
+            bool canUseIdHack = true;
+            if (!request->getProj().isEmpty()) {
+                auto swCanProject = makeIdHackProjectionParams(
+                    unparsedQuery["_id"],
+                    request->getProj(),
+                    collator ? collator.get() : collection->getDefaultCollator(),
+                    &projParams);
+                if (!swCanProject.isOK()) {
+                    return swCanProject.getStatus();
+                }
+                canUseIdHack = swCanProject.getValue();
+            }
 
-            PlanStage* idHackStage = new IDHackStage(
-                opCtx, collection, unparsedQuery["_id"].wrap(), ws.get(), descriptor);
-            unique_ptr<DeleteStage> root = make_unique<DeleteStage>(
-                opCtx, deleteStageParams, ws.get(), collection, idHackStage);
-            return PlanExecutor::make(opCtx, std::move(ws), std::move(root), collection, policy);
+            if (canUseIdHack) {
+                LOG(2) << "Using idhack: " << redact(unparsedQuery);
+
+                PlanStage* idHackStage = new IDHackStage(
+                    opCtx, collection, unparsedQuery["_id"].wrap(), ws.get(), descriptor);
+                unique_ptr<PlanStage> root = make_unique<DeleteStage>(
+                    opCtx, deleteStageParams, ws.get(), collection, idHackStage);
+                if (!request->getProj().isEmpty()) {
+                    root = make_unique<ProjectionStage>(
+                        opCtx, projParams, ws.get(), root.release());
+                }
+                return PlanExecutor::make(
+                    opCtx, std::move(ws), std::move(root), collection, policy);
+            }
         }
 
         // If we're here then we don't have a parsed query, but we're also not eligible for
@@ -918,6 +1109,32 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
                                                      policy);
         }
 
+        // A findAndModify which returns the old or new document usually projects it. Unless the
+        // projection depends on the query, it can still use the idhack fast path. The returned
+        // document is the one produced by the update, so it is not fetched again.
+        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
+            hasCollectionDefaultCollation) {
+            ProjectionStageParams projParams;
+            auto swCanProject = makeIdHackProjectionParams(
+                unparsedQuery["_id"], request->getProj(), parsedUpdate->getCollator(), &projParams);
+            if (!swCanProject.isOK()) {
+                return swCanProject.getStatus();
+            }
+
+            if (swCanProject.getValue()) {
+                LOG(2) << "Using idhack with projection: " << redact(unparsedQuery);
+
+                PlanStage* idHackStage = new IDHackStage(
+                    opCtx, collection, unparsedQuery["_id"].wrap(), ws.get(), descriptor);
+                auto root = make_unique<UpdateStage>(
+                    opCtx, updateStageParams, ws.get(), collection, idHackStage);
+                auto projection =
+                    make_unique<ProjectionStage>(opCtx, projParams, ws.get(), root.release());
+                return PlanExecutor::make(
+                    opCtx, std::move(ws), std::move(projection), collection, policy);
+            }
+        }
+
         // If we're here then we don't have a parsed query, but we're also not eligible for
         // the idhack fast path. We need to force canonicalization now.
         Status cqStatus = parsedUpdate->parseQueryToCQ();
@@ -1088,17 +1305,21 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
     BSONObj endKey;
     bool endKeyInclusive;
 
-    if (!IndexBoundsBuilder::isSingleInterval(
+    // Make the count node that we replace the fetch + ixscan with.
+    CountScanNode* csn = new CountScanNode(isn->index);
+    if (IndexBoundsBuilder::isSingleInterval(
             isn->bounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive)) {
+        csn->startKey = startKey;
+        csn->startKeyInclusive = startKeyInclusive;
+        csn->endKey = endKey;
+        csn->endKeyInclusive = endKeyInclusive;
+    } else if (1 == isn->direction) {
+        // Multiple intervals, such as those of an $in, are counted by seeking between them.
+        csn->bounds = isn->bounds;
+    } else {
+        delete csn;
         return false;
     }
-
-    // Make the count node that we replace the fetch + ixscan with.
-    CountScanNode* csn = new CountScanNode(isn->index);
-    csn->startKey = startKey;
-    csn->startKeyInclusive = startKeyInclusive;
-    csn->endKey = endKey;
-    csn->endKeyInclusive = endKeyInclusive;
     // Takes ownership of 'cn' and deletes the old root.
     soln->root.reset(csn);
     return true;
@@ -1225,6 +1446,196 @@ BSONObj getDistinctProjection(const std::string& field) {
     return bob.obj();
 }
 
+/**
+ * Returns true if every document of 'collection' has a key in the index named by the count's
+ * 'hint', so that an unfiltered count with this hint can still be taken from the record store.
+ * Hints which don't name an index are left to the planner to reject.
+ */
+bool hintCoversAllDocuments(OperationContext* opCtx, Collection* collection, const BSONObj& hint) {
+    if (hint.isEmpty()) {
+        return true;
+    }
+
+    BSONElement firstHintElt = hint.firstElement();
+    if (firstHintElt.fieldNameStringData() == "$natural") {
+        return true;
+    }
+
+    std::vector<IndexDescriptor*> indexes;
+    if (firstHintElt.fieldNameStringData() == "$hint" && firstHintElt.type() == String) {
+        if (auto desc = collection->getIndexCatalog()->findIndexByName(opCtx, firstHintElt.str())) {
+            indexes.push_back(desc);
+        }
+    } else {
+        collection->getIndexCatalog()->findIndexesByKeyPattern(opCtx, hint, false, &indexes);
+    }
+
+    return !indexes.empty() &&
+        std::all_of(indexes.begin(), indexes.end(), [](const IndexDescriptor* desc) {
+               const std::string& type = desc->getAccessMethodName();
+               return (type == IndexNames::BTREE || type == IndexNames::HASHED) &&
+                   !desc->isSparse() && !desc->isPartial();
+           });
+}
+
+/**
+ * If the count of 'query' can be taken from the prefix counts of an index, returns that index and
+ * fills out 'keysOut' with the values of its leading field to add up the counts of. This is the
+ * case for an equality or an $in of values on that field, such as {tenant: "x"}, when the index
+ * compares strings the way the query does and, for an $in, is not multikey. Otherwise returns
+ * nullptr.
+ */
+const IndexDescriptor* getPrefixCountIndex(OperationContext* opCtx,
+                                           Collection* collection,
+                                           const CanonicalQuery& query,
+                                           std::vector<BSONObj>* keysOut) {
+    const MatchExpression* root = query.root();
+    std::vector<BSONElement> values;
+    if (root->matchType() == MatchExpression::EQ) {
+        values.push_back(static_cast<const EqualityMatchExpression*>(root)->getData());
+    } else if (root->matchType() == MatchExpression::MATCH_IN) {
+        const auto in = static_cast<const InMatchExpression*>(root);
+        if (!in->getRegexes().empty()) {
+            return nullptr;
+        }
+        values.insert(values.end(), in->getEqualities().begin(), in->getEqualities().end());
+    } else {
+        return nullptr;
+    }
+
+    // Null also matches missing fields and arrays match both themselves and their elements, so
+    // the keys of such values don't tell which documents match. A numeric path component could be
+    // an array position, for which the keys generated differ from the values the query matches.
+    for (auto&& value : values) {
+        switch (value.type()) {
+            case Array:
+            case jstNULL:
+            case Undefined:
+            case MinKey:
+            case MaxKey:
+                return nullptr;
+            default:
+                break;
+        }
+    }
+    FieldRef path(root->path());
+    for (size_t i = 0; i < path.numParts(); ++i) {
+        StringData part = path.getPart(i);
+        if (std::all_of(part.begin(), part.end(), [](char c) { return std::isdigit(c); })) {
+            return nullptr;
+        }
+    }
+
+    const BSONObj& hint = query.getQueryRequest().getHint();
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii.more()) {
+        const IndexDescriptor* desc = ii.next();
+        IndexCatalogEntry* ice = ii.catalogEntry(desc);
+        if (!ice->prefixCounts() || !ice->prefixCounts()->isBuilt() ||
+            desc->keyPattern().firstElementFieldName() != root->path() ||
+            !CollatorInterface::collatorsMatch(ice->getCollator(), query.getCollator())) {
+            continue;
+        }
+
+        // A hint must name this index.
+        if (!hint.isEmpty()) {
+            BSONElement firstHintElt = hint.firstElement();
+            const bool hintsIndex =
+                (firstHintElt.fieldNameStringData() == "$hint" && firstHintElt.type() == String)
+                ? firstHintElt.str() == desc->indexName()
+                : SimpleBSONObjComparator::kInstance.evaluate(hint == desc->keyPattern());
+            if (!hintsIndex) {
+                continue;
+            }
+        }
+
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        for (auto&& value : values) {
+            BSONObjBuilder key;
+            CollationIndexKey::collationAwareIndexKeyAppend(value, ice->getCollator(), &key);
+            keys.insert(key.obj());
+        }
+
+        // A document with an array of values is counted once for each of them, so the counts of
+        // several values can only be added up if no document has more than one.
+        if (keys.size() > 1 && ice->isMultikey()) {
+            continue;
+        }
+        keysOut->assign(keys.begin(), keys.end());
+        return desc;
+    }
+    return nullptr;
+}
+
+/**
+ * Makes the plan which returns the orphaned documents of 'collection' that match 'filter', or all
+ * of them if 'filter' is null, when the count is taken from statistics which include them: this is
+ * the case for a sharded collection counted through a router, which expects only the documents in
+ * the chunks this shard owns. The orphans are found through the shard key index, in the ranges
+ * which are not owned, including the ones still being migrated in.
+ *
+ * Leaves 'orphansOut' null if there are no orphans to subtract. Returns false if they can't be
+ * counted, in which case the statistics must not be used.
+ */
+bool makeOrphansStage(OperationContext* opCtx,
+                      Collection* collection,
+                      const MatchExpression* filter,
+                      WorkingSet* ws,
+                      unique_ptr<PlanStage>* orphansOut) {
+    if (!ShardingState::get(opCtx)->needCollectionMetadata(opCtx, collection->ns().ns())) {
+        return true;
+    }
+    auto metadata = CollectionShardingState::get(opCtx, collection->ns())->getMetadata();
+    if (!metadata) {
+        return true;
+    }
+
+    const IndexDescriptor* shardKeyIndex = collection->getIndexCatalog()->findShardKeyPrefixedIndex(
+        opCtx, metadata->getKeyPattern(), false);
+    if (!shardKeyIndex) {
+        return false;
+    }
+    KeyPattern indexKeyPattern(shardKeyIndex->keyPattern().getOwned());
+    auto extend = [&](const BSONObj& key) {
+        return Helpers::toKeyFormat(indexKeyPattern.extendRangeBound(key, false));
+    };
+
+    std::vector<unique_ptr<PlanStage>> rangeScans;
+    const RangeMap noReceivingChunks = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<
+        CachedChunkInfo>();
+    BSONObj lookupKey = metadata->getMinKey();
+    while (auto range = metadata->getNextOrphanRange(noReceivingChunks, lookupKey)) {
+        IndexScanParams params;
+        params.descriptor = shardKeyIndex;
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = extend(range->minKey);
+        params.bounds.endKey = extend(range->maxKey);
+        params.bounds.boundInclusion = BoundInclusion::kIncludeStartKeyOnly;
+        rangeScans.push_back(make_unique<IndexScan>(opCtx, params, ws, nullptr));
+        lookupKey = range->maxKey;
+    }
+    if (rangeScans.empty()) {
+        return true;
+    }
+
+    // The ranges don't overlap, so there is nothing to deduplicate.
+    unique_ptr<PlanStage> root;
+    if (rangeScans.size() == 1) {
+        root = std::move(rangeScans.front());
+    } else {
+        auto orStage = make_unique<OrStage>(opCtx, ws, false, nullptr);
+        for (auto&& rangeScan : rangeScans) {
+            orStage->addChild(rangeScan.release());
+        }
+        root = std::move(orStage);
+    }
+    if (filter) {
+        root = make_unique<FetchStage>(opCtx, ws, root.release(), filter, collection);
+    }
+    *orphansOut = std::move(root);
+    return true;
+}
+
 }  // namespace
 
 StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorCount(
@@ -1272,18 +1683,41 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorCount(
     // for its number of records. This is implemented by the CountStage, and we don't need
     // to create a child for the count stage in this case.
     //
-    // If there is a hint, then we can't use a trival count plan as described above.
+    // If there is a hint, then we can only use a trival count plan as described above if every
+    // document is in the hinted index.
+    //
+    // A count of documents by the values of the leading field of an index which keeps prefix
+    // counts is answered by these counts in the same way.
     const bool isEmptyQueryPredicate =
         cq->root()->matchType() == MatchExpression::AND && cq->root()->numChildren() == 0;
-    const bool useRecordStoreCount = isEmptyQueryPredicate && request.getHint().isEmpty();
+    const bool useRecordStoreCount =
+        isEmptyQueryPredicate && hintCoversAllDocuments(opCtx, collection, request.getHint());
     CountStageParams params(request, useRecordStoreCount);
-
-    if (useRecordStoreCount) {
-        unique_ptr<PlanStage> root =
-            make_unique<CountStage>(opCtx, collection, std::move(params), ws.get(), nullptr);
+    if (!useRecordStoreCount && !isEmptyQueryPredicate) {
+        params.prefixCountIndex =
+            getPrefixCountIndex(opCtx, collection, *cq, &params.prefixCountKeys);
+    }
+
+    unique_ptr<PlanStage> orphans;
+    if ((params.useRecordStoreCount || params.prefixCountIndex) &&
+        makeOrphansStage(opCtx,
+                         collection,
+                         isEmptyQueryPredicate ? nullptr : cq->root(),
+                         ws.get(),
+                         &orphans)) {
+        if (params.prefixCountIndex) {
+            LOG(2) << "Using prefix counts of index " << params.prefixCountIndex->indexName()
+                   << ": " << redact(cq->toStringShort());
+        }
+        params.subtractOrphans = static_cast<bool>(orphans);
+        unique_ptr<PlanStage> root = make_unique<CountStage>(
+            opCtx, collection, std::move(params), ws.get(), orphans.release());
         return PlanExecutor::make(
-            opCtx, std::move(ws), std::move(root), request.getNs(), yieldPolicy);
+            opCtx, std::move(ws), std::move(root), std::move(cq), collection, yieldPolicy);
     }
+    params.useRecordStoreCount = false;
+    params.prefixCountIndex = nullptr;
+    params.prefixCountKeys.clear();
 
     const size_t plannerOptions = QueryPlannerParams::IS_COUNT;
     StatusWith<PrepareExecutionResult> executionResult =
@@ -1616,4 +2050,158 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
     return getExecutor(opCtx, collection, parsedDistinct->releaseQuery(), yieldPolicy);
 }
 
+namespace {
+
+/**
+ * Turns a solution shaped [PROJECTION =>] [FETCH =>] IXSCAN, whose index scan is on 'field' and is
+ * only restricted by its bounds, into the same solution with a DISTINCT_SCAN on 'field' in place
+ * of the index scan. Returns false and leaves 'soln' unchanged otherwise.
+ */
+bool turnIxscanIntoDistinctScanOnField(QuerySolution* soln, const string& field) {
+    QuerySolutionNode* parent = nullptr;
+    QuerySolutionNode* node = soln->root.get();
+    if (STAGE_PROJECTION == node->getType()) {
+        parent = node;
+        node = node->children[0];
+    }
+    if (STAGE_FETCH == node->getType()) {
+        // A filter on the fetched document may reject the entry returned for a value while
+        // accepting one of those skipped.
+        if (node->filter) {
+            return false;
+        }
+        parent = node;
+        node = node->children[0];
+    }
+    if (STAGE_IXSCAN != node->getType()) {
+        return false;
+    }
+
+    auto indexScanNode = static_cast<IndexScanNode*>(node);
+    if (indexScanNode->filter || indexScanNode->bounds.isSimpleRange ||
+        indexScanNode->index.multikey) {
+        return false;
+    }
+
+    int fieldNo = 0;
+    BSONObjIterator it(indexScanNode->index.keyPattern);
+    while (it.more() && field != it.next().fieldNameStringData()) {
+        ++fieldNo;
+    }
+    if (fieldNo == indexScanNode->index.keyPattern.nFields()) {
+        return false;
+    }
+
+    auto distinctNode = stdx::make_unique<DistinctNode>(indexScanNode->index);
+    distinctNode->direction = indexScanNode->direction;
+    distinctNode->bounds = indexScanNode->bounds;
+    distinctNode->fieldNo = fieldNo;
+
+    if (parent) {
+        // Take ownership of the index scan node, detaching it from the solution tree.
+        std::unique_ptr<QuerySolutionNode> ownedIsn(parent->children[0]);
+        parent->children[0] = distinctNode.release();
+    } else {
+        soln->root = std::move(distinctNode);
+    }
+    return true;
+}
+
+}  // namespace
+
+StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinctScan(
+    OperationContext* opCtx,
+    Collection* collection,
+    unique_ptr<CanonicalQuery> cq,
+    const std::string& field,
+    PlanExecutor::YieldPolicy yieldPolicy) {
+    // Filtering out orphans after the DISTINCT_SCAN could drop the only entry returned for a value.
+    if (!collection || ShardingState::get(opCtx)->needCollectionMetadata(opCtx, cq->ns())) {
+        return Status(ErrorCodes::BadValue, "Cannot use a DISTINCT_SCAN");
+    }
+
+    // If the canonical query does not have a user-specified collation, set it from the collection
+    // default.
+    if (cq->getQueryRequest().getCollation().isEmpty() && collection->getDefaultCollator()) {
+        cq->setCollator(collection->getDefaultCollator()->clone());
+    }
+
+    QueryPlannerParams plannerParams;
+    plannerParams.options =
+        QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::NO_BLOCKING_SORT;
+    fillOutPlannerParams(opCtx, collection, cq.get(), &plannerParams);
+
+    // The distinct values must be those the query compares by, and each document must have a
+    // single index entry.
+    auto& indices = plannerParams.indices;
+    indices.erase(std::remove_if(indices.begin(),
+                                 indices.end(),
+                                 [&](const IndexEntry& index) {
+                                     return index.type != INDEX_BTREE || index.multikey ||
+                                         !index.keyPattern.hasField(field) ||
+                                         !CollatorInterface::collatorsMatch(index.collator,
+                                                                            cq->getCollator());
+                                 }),
+                  indices.end());
+    if (indices.empty()) {
+        return Status(ErrorCodes::BadValue, "No index can provide a DISTINCT_SCAN");
+    }
+
+    unique_ptr<QuerySolution> distinctSolution;
+    size_t distinctNodeIndex = 0;
+    if (cq->getQueryRequest().getFilter().isEmpty() && cq->getQueryRequest().getSort().isEmpty() &&
+        getDistinctNodeIndex(indices, field, cq->getCollator(), &distinctNodeIndex)) {
+        // The planner uses no index without a predicate or a sort, so distinct-scan one of the
+        // indices led by 'field'.
+        auto dn = stdx::make_unique<DistinctNode>(indices[distinctNodeIndex]);
+        dn->direction = 1;
+        IndexBoundsBuilder::allValuesBounds(dn->index.keyPattern, &dn->bounds);
+        dn->fieldNo = 0;
+
+        // An index with a non-simple collation requires a FETCH stage.
+        std::unique_ptr<QuerySolutionNode> solnRoot = std::move(dn);
+        if (indices[distinctNodeIndex].collator) {
+            auto fetch = stdx::make_unique<FetchNode>();
+            fetch->children.push_back(solnRoot.release());
+            solnRoot = std::move(fetch);
+        }
+
+        QueryPlannerParams params;
+        distinctSolution.reset(
+            QueryPlannerAnalysis::analyzeDataAccess(*cq, params, std::move(solnRoot)));
+    } else {
+        vector<QuerySolution*> solutions;
+        Status status = QueryPlanner::plan(*cq, plannerParams, &solutions);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        for (size_t i = 0; i < solutions.size(); ++i) {
+            unique_ptr<QuerySolution> solution(solutions[i]);
+            if (!distinctSolution && turnIxscanIntoDistinctScanOnField(solution.get(), field)) {
+                distinctSolution = std::move(solution);
+            }
+        }
+    }
+    if (!distinctSolution) {
+        return Status(ErrorCodes::BadValue, "No plan can use a DISTINCT_SCAN");
+    }
+
+    unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
+    PlanStage* rawRoot;
+    verify(StageBuilder::build(opCtx, collection, *cq, *distinctSolution, ws.get(), &rawRoot));
+    unique_ptr<PlanStage> root(rawRoot);
+
+    LOG(2) << "Using DISTINCT_SCAN: " << redact(cq->toStringShort())
+           << ", planSummary: " << redact(Explain::getPlanSummary(root.get()));
+
+    return PlanExecutor::make(opCtx,
+                              std::move(ws),
+                              std::move(root),
+                              std::move(distinctSolution),
+                              std::move(cq),
+                              collection,
+                              yieldPolicy);
+}
+
 }  // namespace mongo
@@ -117,6 +117,21 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDist
     ParsedDistinct* parsedDistinct,
     PlanExecutor::YieldPolicy yieldPolicy);
 
+/**
+ * Get an executor which answers 'cq' with a DISTINCT_SCAN on 'field', so that it returns only the
+ * first index entry, in the order of the scan, of each distinct value of 'field' (along with the
+ * index fields before it). Any sort requested by 'cq' must be provided by the index. Only indexes
+ * which are not multikey are used, so no document is returned more than once.
+ *
+ * Returns a non-OK status if no such plan can answer 'cq' exactly.
+ */
+StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinctScan(
+    OperationContext* opCtx,
+    Collection* collection,
+    std::unique_ptr<CanonicalQuery> cq,
+    const std::string& field,
+    PlanExecutor::YieldPolicy yieldPolicy);
+
 /*
  * Get a PlanExecutor for a query executing as part of a count command.
  *
@@ -30,6 +30,7 @@
 
 #include "mongo/db/query/index_bounds_builder.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -562,14 +563,32 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
 
         // Create our various intervals.
 
+        // Scalar equalities become point intervals. Rather than building a separate BSONObj for
+        // each of them, their keys are appended to a single buffer which the intervals share.
+        BSONObjBuilder pointsBob;
         IndexBoundsBuilder::BoundsTightness tightness;
         for (auto&& equality : ime->getEqualities()) {
+            if (!isHashed && Array != equality.type()) {
+                CollationIndexKey::collationAwareIndexKeyAppend(
+                    equality, index.collator, &pointsBob);
+                continue;
+            }
+
             translateEquality(equality, index, isHashed, oilOut, &tightness);
             if (tightness != IndexBoundsBuilder::EXACT) {
                 *tightnessOut = tightness;
             }
         }
 
+        const BSONObj points = pointsBob.obj();
+        for (auto&& point : points) {
+            Interval ival;
+            ival._intervalData = points;
+            ival.start = ival.end = point;
+            ival.startInclusive = ival.endInclusive = true;
+            oilOut->intervals.push_back(std::move(ival));
+        }
+
         for (auto&& regex : ime->getRegexes()) {
             translateRegex(regex.get(), index, oilOut, &tightness);
             if (tightness != IndexBoundsBuilder::EXACT) {
@@ -580,7 +599,6 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
         if (ime->hasNull()) {
             // A null index key does not always match a null query value so we must fetch the
             // doc and run a full comparison.  See SERVER-4529.
-            // TODO: Do we already set the tightnessOut by calling translateEquality?
             *tightnessOut = INEXACT_FETCH;
         }
 
@@ -601,14 +619,18 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            ExpressionMapping::cover2dsphere(region, indexParams, oilOut, gme->getRawObj());
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
             const R2Region& region = gme->getGeoExpression().getGeometry().getR2Region();
 
             ExpressionMapping::cover2d(
-                region, index.infoObj, internalGeoPredicateQuery2DMaxCoveringCells.load(), oilOut);
+                region,
+                index.infoObj,
+                internalGeoPredicateQuery2DMaxCoveringCells.load(),
+                oilOut,
+                internalGeoPredicateQuery2DCoveringMaxGapFraction.load());
 
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else {
@@ -695,46 +717,51 @@ void IndexBoundsBuilder::unionize(OrderedIntervalList* oilOut) {
         return;
     }
 
-    // Step 1: sort.
-    std::sort(iv.begin(), iv.end(), IntervalComparison);
+    // Step 1: sort. Intervals built from an $in list are frequently in order already, and
+    // checking for that is much cheaper than sorting them again.
+    if (!std::is_sorted(iv.begin(), iv.end(), IntervalComparison)) {
+        std::sort(iv.begin(), iv.end(), IntervalComparison);
+    }
 
-    // Step 2: Walk through and merge.
-    size_t i = 0;
-    while (i < iv.size() - 1) {
-        // Compare i with i + 1.
-        Interval::IntervalComparison cmp = iv[i].compare(iv[i + 1]);
+    // Step 2: Walk through and merge. The merged intervals are compacted to the front of the
+    // vector, so each interval is moved at most once instead of erasing from the middle.
+    size_t last = 0;
+    for (size_t i = 1; i < iv.size(); ++i) {
+        // Compare the last merged interval with i.
+        Interval::IntervalComparison cmp = iv[last].compare(iv[i]);
 
         // This means our sort didn't work.
         verify(Interval::INTERVAL_SUCCEEDS != cmp);
 
         // Intervals are correctly ordered.
         if (Interval::INTERVAL_PRECEDES == cmp) {
-            // We can move to the next pair.
-            ++i;
+            // Keep interval i after 'last'.
+            ++last;
+            if (last != i) {
+                iv[last] = std::move(iv[i]);
+            }
         } else if (Interval::INTERVAL_EQUALS == cmp || Interval::INTERVAL_WITHIN == cmp) {
-            // Interval 'i' is equal to i+1, or is contained within i+1.
-            // Remove interval i and don't move to the next value of 'i'.
-            iv.erase(iv.begin() + i);
+            // Interval 'last' is equal to i, or is contained within i. Replace it with i.
+            iv[last] = std::move(iv[i]);
         } else if (Interval::INTERVAL_CONTAINS == cmp) {
-            // Interval 'i' contains i+1, remove i+1 and don't move to the next value of 'i'.
-            iv.erase(iv.begin() + i + 1);
+            // Interval 'last' contains i, so i is dropped.
         } else if (Interval::INTERVAL_OVERLAPS_BEFORE == cmp ||
                    Interval::INTERVAL_PRECEDES_COULD_UNION == cmp) {
-            // We want to merge intervals i and i+1.
-            // Interval 'i' starts before interval 'i+1'.
+            // We want to merge intervals 'last' and i.
+            // Interval 'last' starts before interval i.
             BSONObjBuilder bob;
-            bob.appendAs(iv[i].start, "");
-            bob.appendAs(iv[i + 1].end, "");
+            bob.appendAs(iv[last].start, "");
+            bob.appendAs(iv[i].end, "");
             BSONObj data = bob.obj();
-            bool startInclusive = iv[i].startInclusive;
-            bool endInclusive = iv[i + 1].endInclusive;
-            iv.erase(iv.begin() + i);
-            // iv[i] is now the former iv[i + 1]
-            iv[i] = makeRangeInterval(
+            bool startInclusive = iv[last].startInclusive;
+            bool endInclusive = iv[i].endInclusive;
+            iv[last] = makeRangeInterval(
                 data, IndexBounds::makeBoundInclusionFromBoundBools(startInclusive, endInclusive));
-            // Don't increment 'i'.
+        } else {
+            MONGO_UNREACHABLE;
         }
     }
+    iv.resize(last + 1);
 }
 
 // static
@@ -830,7 +857,8 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     if (Array != data.type()) {
         BSONObj dataObj = objFromElement(data, index.collator);
         if (isHashed) {
-            dataObj = ExpressionMapping::hash(dataObj.firstElement());
+            dataObj = ExpressionMapping::hash(dataObj.firstElement(),
+                                              index.infoObj["hashVersion"].numberInt());
         }
 
         verify(dataObj.isOwned());
@@ -34,10 +34,14 @@
 #include <memory>
 
 #include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+#include "third_party/s2/s2cellid.h"
 
 using namespace mongo;
 
@@ -536,6 +540,27 @@ TEST(IndexBoundsBuilderTest, TranslateIn) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
 }
 
+TEST(IndexBoundsBuilderTest, TranslateLargeIn) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONArrayBuilder inList;
+    for (int i = 999; i >= 0; --i) {
+        inList.append(i);
+    }
+    BSONObj obj = BSON("a" << BSON("$in" << inList.arr()));
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 1000U);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                      oil.intervals[i].compare(Interval(BSON("" << i << "" << i), true, true)));
+    }
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+}
+
 TEST(IndexBoundsBuilderTest, TranslateInArray) {
     IndexEntry testIndex = IndexEntry(BSONObj());
     BSONObj obj = fromjson("{a: {$in: [[1], 2]}}");
@@ -759,6 +784,31 @@ TEST(IndexBoundsBuilderTest, UnionDupEq) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
 }
 
+TEST(IndexBoundsBuilderTest, UnionMergesContainedAndDuplicateIntervals) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    vector<BSONObj> toUnion;
+    toUnion.push_back(fromjson("{a: {$lt: 0}}"));
+    toUnion.push_back(fromjson("{a: 5}"));
+    toUnion.push_back(fromjson("{a: 9}"));
+    toUnion.push_back(fromjson("{a: 5}"));
+    toUnion.push_back(fromjson("{a: {$lt: -5}}"));
+    toUnion.push_back(fromjson("{a: {$gt: 8}}"));
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    testTranslateAndUnion(toUnion, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 3U);
+    ASSERT_EQUALS(
+        Interval::INTERVAL_EQUALS,
+        oil.intervals[0].compare(Interval(fromjson("{'': -Infinity, '': 0}"), true, false)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[1].compare(Interval(fromjson("{'': 5, '': 5}"), true, true)));
+    ASSERT_EQUALS(
+        Interval::INTERVAL_EQUALS,
+        oil.intervals[2].compare(Interval(fromjson("{'': 8, '': Infinity}"), false, true)));
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+}
+
 TEST(IndexBoundsBuilderTest, UnionGtLt) {
     IndexEntry testIndex = IndexEntry(BSONObj());
     vector<BSONObj> toUnion;
@@ -2208,4 +2258,69 @@ TEST(IndexBoundsBuilderTest, RedundantTypeNumberHasCorrectBounds) {
     ASSERT(tightness == IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+//
+// 2dsphere coverings
+//
+
+TEST(IndexBoundsBuilderTest, CachedS2CoveringMatchesFreshCovering) {
+    BSONObj obj = fromjson(
+        "{a: {$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 10], [10, 10], [10, 0], [0, 0]]]}}}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    ASSERT_EQUALS(MatchExpression::GEO, expr->matchType());
+    const GeoMatchExpression* gme = static_cast<const GeoMatchExpression*>(expr.get());
+    const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
+
+    auto fresh = ExpressionMapping::get2dsphereCovering(region);
+    ASSERT_FALSE(fresh.empty());
+    ASSERT_TRUE(fresh == ExpressionMapping::get2dsphereCovering(region, gme->getRawObj()));
+    ASSERT_TRUE(fresh == ExpressionMapping::get2dsphereCovering(region, gme->getRawObj()));
+
+    // Changing the coverer settings must not return the covering cached under the old ones.
+    const int oldFinestLevel = internalQueryS2GeoFinestLevel.load();
+    ON_BLOCK_EXIT([&] { internalQueryS2GeoFinestLevel.store(oldFinestLevel); });
+    internalQueryS2GeoFinestLevel.store(2);
+    auto coarse = ExpressionMapping::get2dsphereCovering(region);
+    ASSERT_TRUE(coarse == ExpressionMapping::get2dsphereCovering(region, gme->getRawObj()));
+    ASSERT_FALSE(coarse == fresh);
+}
+
+//
+// 2d coverings
+//
+
+TEST(IndexBoundsBuilderTest, AdjacentGeoHashCellsShareOneInterval) {
+    std::vector<GeoHash> covering = {GeoHash("01"), GeoHash("00")};
+    OrderedIntervalList oil;
+    ExpressionMapping::GeoHashsToIntervalsWithParents(covering, &oil);
+    ASSERT_EQUALS(oil.intervals.size(), 1U);
+
+    BSONObjBuilder expected;
+    GeoHash("00").appendHashMin(&expected, "");
+    GeoHash("01").appendHashMax(&expected, "");
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(IndexBoundsBuilder::makeRangeInterval(
+                      expected.obj(), BoundInclusion::kIncludeBothStartAndEndKeys)));
+}
+
+TEST(IndexBoundsBuilderTest, GeoHashCellGapsMergedWithinBudget) {
+    // The gap between the cells is as long as the two cells together.
+    std::vector<GeoHash> covering = {GeoHash("0000"), GeoHash("0011")};
+
+    OrderedIntervalList separate;
+    ExpressionMapping::GeoHashsToIntervalsWithParents(covering, &separate, 0.5);
+    ASSERT_EQUALS(separate.intervals.size(), 2U);
+
+    OrderedIntervalList merged;
+    ExpressionMapping::GeoHashsToIntervalsWithParents(covering, &merged, 1.0);
+    ASSERT_EQUALS(merged.intervals.size(), 1U);
+
+    BSONObjBuilder expected;
+    GeoHash("0000").appendHashMin(&expected, "");
+    GeoHash("0011").appendHashMax(&expected, "");
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  merged.intervals[0].compare(IndexBoundsBuilder::makeRangeInterval(
+                      expected.obj(), BoundInclusion::kIncludeBothStartAndEndKeys)));
+}
+
 }  // namespace
@@ -55,7 +55,7 @@ void Interval::init(BSONObj base, bool si, bool ei) {
 }
 
 bool Interval::isEmpty() const {
-    return _intervalData.nFields() == 0;
+    return _intervalData.isEmpty();
 }
 
 bool Interval::isPoint() const {
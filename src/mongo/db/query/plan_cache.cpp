@@ -45,6 +45,7 @@
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -305,6 +306,26 @@ void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, StringBuil
     }
 }
 
+long long estimateIndexTreeSize(const PlanCacheIndexTree& tree) {
+    long long size =
+        sizeof(tree) + tree.orPushdowns.size() * sizeof(PlanCacheIndexTree::OrPushdown);
+    if (tree.entry) {
+        size += sizeof(IndexEntry) + tree.entry->name.size();
+    }
+    for (const auto child : tree.children) {
+        size += estimateIndexTreeSize(*child);
+    }
+    return size;
+}
+
+long long estimateStatsSize(const PlanStageStats& stats) {
+    long long size = sizeof(stats);
+    for (const auto& child : stats.children) {
+        size += estimateStatsSize(*child);
+    }
+    return size;
+}
+
 }  // namespace
 
 //
@@ -444,6 +465,25 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     return entry;
 }
 
+long long PlanCacheEntry::estimateObjectSizeInBytes() const {
+    long long size = sizeof(*this) + query.objsize() + sort.objsize() + projection.objsize() +
+        collation.objsize();
+    for (const auto data : plannerData) {
+        size += sizeof(*data);
+        if (data->tree) {
+            size += estimateIndexTreeSize(*data->tree);
+        }
+    }
+    size += sizeof(*decision);
+    for (const auto& stats : decision->stats) {
+        size += estimateStatsSize(*stats);
+    }
+    for (const auto fb : feedback) {
+        size += sizeof(*fb) + estimateStatsSize(*fb->stats);
+    }
+    return size;
+}
+
 std::string PlanCacheEntry::toString() const {
     return str::stream() << "(query: " << query.toString() << ";sort: " << sort.toString()
                          << ";projection: " << projection.toString()
@@ -542,6 +582,10 @@ std::string SolutionCacheData::toString() const {
                                  << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case USE_INDEX_TAGS_SOLN:
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
@@ -554,12 +598,32 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : _cache(internalQueryCacheSize.load()) {}
+const size_t PlanCache::kNumPartitions;
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache() {
+    _initPartitions();
+    _bumpIndexabilityStateVersion();
+}
+
+PlanCache::PlanCache(const std::string& ns) : _ns(ns) {
+    _initPartitions();
+    _bumpIndexabilityStateVersion();
+}
 
 PlanCache::~PlanCache() {}
 
+void PlanCache::_initPartitions() {
+    const size_t maxSize = std::max(internalQueryCacheSize.load(), 0);
+    const size_t partitionSize = std::max<size_t>(1, maxSize / kNumPartitions);
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>(partitionSize));
+    }
+}
+
+PlanCache::Partition& PlanCache::_getPartition(const PlanCacheKey& key) const {
+    return *_partitions[std::hash<PlanCacheKey>()(key) % kNumPartitions];
+}
+
 /**
  * Traverses expression tree pre-order.
  * Appends an encoding of each node's match type and path name
@@ -733,8 +797,11 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+    const PlanCacheKey key = computeKey(query);
+    Partition& partition = _getPartition(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(partition.mutex);
+    entry->memoryCharge.set(entry->estimateObjectSizeInBytes() + key.size());
+    std::unique_ptr<PlanCacheEntry> evictedEntry = partition.cache.add(key, entry);
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
@@ -748,15 +815,18 @@ Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const
     PlanCacheKey key = computeKey(query);
     verify(crOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = _getPartition(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
     invariant(entry);
 
     *crOut = new CachedSolution(key, *entry);
+    (*crOut)->wantsFeedback =
+        entry->feedback.size() < static_cast<size_t>(internalQueryCacheFeedbacksStored.load());
 
     return Status::OK();
 }
@@ -768,9 +838,10 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     std::unique_ptr<PlanCacheEntryFeedback> autoFeedback(feedback);
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = _getPartition(ck);
+    stdx::lock_guard<stdx::mutex> cacheLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = partition.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -779,36 +850,49 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     // We store up to a constant number of feedback entries.
     if (entry->feedback.size() < static_cast<size_t>(internalQueryCacheFeedbacksStored.load())) {
         entry->feedback.push_back(autoFeedback.release());
+        entry->memoryCharge.set(entry->estimateObjectSizeInBytes() + ck.size());
     }
 
     return Status::OK();
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const PlanCacheKey key = computeKey(canonicalQuery);
+    Partition& partition = _getPartition(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(partition.mutex);
+    return partition.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> cacheLock(partition->mutex);
+        partition->cache.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
+    if (cq._planCacheKeyVersion == _indexabilityStateVersion) {
+        return cq._planCacheKey;
+    }
+
     StringBuilder keyBuilder;
     encodeKeyForMatch(cq.root(), &keyBuilder);
     encodeKeyForSort(cq.getQueryRequest().getSort(), &keyBuilder);
     encodeKeyForProj(cq.getQueryRequest().getProj(), &keyBuilder);
-    return keyBuilder.str();
+
+    cq._planCacheKey = keyBuilder.str();
+    cq._planCacheKeyVersion = _indexabilityStateVersion;
+    return cq._planCacheKey;
 }
 
 Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOut) const {
     PlanCacheKey key = computeKey(query);
     verify(entryOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = _getPartition(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -820,29 +904,43 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
 }
 
 std::vector<PlanCacheEntry*> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<PlanCacheEntry*> entries;
     typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
-    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
-        PlanCacheEntry* entry = i->second;
-        entries.push_back(entry->clone());
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> cacheLock(partition->mutex);
+        for (ConstIterator i = partition->cache.begin(); i != partition->cache.end(); i++) {
+            PlanCacheEntry* entry = i->second;
+            entries.push_back(entry->clone());
+        }
     }
 
     return entries;
 }
 
 bool PlanCache::contains(const CanonicalQuery& cq) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.hasKey(computeKey(cq));
+    const PlanCacheKey key = computeKey(cq);
+    Partition& partition = _getPartition(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(partition.mutex);
+    return partition.cache.hasKey(key);
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> cacheLock(partition->mutex);
+        size += partition->cache.size();
+    }
+    return size;
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
     _indexabilityState.updateDiscriminators(indexEntries);
+    _bumpIndexabilityStateVersion();
+}
+
+void PlanCache::_bumpIndexabilityStateVersion() {
+    static AtomicUInt64 nextVersion(1);
+    _indexabilityStateVersion = nextVersion.fetchAndAdd(1);
 }
 
 }  // namespace mongo
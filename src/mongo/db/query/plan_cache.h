@@ -29,7 +29,10 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <functional>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
@@ -39,6 +42,7 @@
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/memory_accounting.h"
 
 namespace mongo {
 
@@ -174,6 +178,9 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The cached plan is a skip scan over the index in 'tree'.
+        SKIP_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -221,6 +228,10 @@ public:
     // The number of work cycles taken to decide on a winning plan when the plan was first
     // cached.
     size_t decisionWorks;
+
+    // Whether the entry still had room for feedback when this solution was retrieved. There is
+    // no point in gathering feedback about a run of the solution otherwise.
+    bool wantsFeedback = false;
 };
 
 /**
@@ -246,6 +257,11 @@ public:
      */
     PlanCacheEntry* clone() const;
 
+    /**
+     * Returns an approximation of the memory held by this entry.
+     */
+    long long estimateObjectSizeInBytes() const;
+
     // For debugging.
     std::string toString() const;
 
@@ -279,6 +295,9 @@ public:
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
     // runs when they complete.
     std::vector<PlanCacheEntryFeedback*> feedback;
+
+    // Charges the size of the entry to the plan cache memory account while it is cached.
+    MemoryAccount::Charge memoryCharge{&memory_accounts::planCache};
 };
 
 /**
@@ -411,14 +430,37 @@ public:
     void notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries);
 
 private:
+    /**
+     * Assigns '_indexabilityStateVersion' a value which no plan cache has used before.
+     */
+    void _bumpIndexabilityStateVersion();
+
     void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+    // The cache is split by key into partitions which are each locked separately, so that
+    // concurrent queries only contend with queries whose keys fall into the same partition. Each
+    // partition evicts its own least recently used entries.
+    static const size_t kNumPartitions = 16;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    struct Partition {
+        explicit Partition(size_t maxSize) : cache(maxSize) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry> cache;
+
+        // Protects 'cache'.
+        stdx::mutex mutex;
+    };
+
+    /**
+     * Returns the partition which holds the entry for 'key', if there is one.
+     */
+    Partition& _getPartition(const PlanCacheKey& key) const;
+
+    void _initPartitions();
+
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Full namespace of collection.
     std::string _ns;
@@ -429,6 +471,11 @@ private:
     // Concurrent access is synchronized by the collection lock.  Multiple concurrent readers
     // are allowed.
     PlanCacheIndexabilityState _indexabilityState;
+
+    // Identifies the contents of '_indexabilityState' across all plan caches in the process, so
+    // that a key memoized in a CanonicalQuery is only reused by the cache and index set which
+    // computed it. Synchronized like '_indexabilityState'.
+    unsigned long long _indexabilityStateVersion = 0;
 };
 
 }  // namespace mongo
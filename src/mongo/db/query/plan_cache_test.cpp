@@ -47,6 +47,7 @@
 #include "mongo/db/query/query_planner_test_lib.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/scopeguard.h"
@@ -449,6 +450,58 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+TEST(PlanCacheTest, SizeAndClearCoverAllEntries) {
+    PlanCache planCache;
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    // Distinct shapes hash to different partitions, but all of them must be reported.
+    const std::vector<std::string> queries = {
+        "{a: 1}", "{b: 1}", "{c: 1}", "{d: 1}", "{a: 1, b: 1}", "{a: {$gt: 1}}", "{b: {$lt: 1}}"};
+    for (auto&& query : queries) {
+        unique_ptr<CanonicalQuery> cq(canonicalize(query.c_str()));
+        ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+    }
+    ASSERT_EQUALS(planCache.size(), queries.size());
+    ASSERT_EQUALS(planCache.getAllEntries().size(), queries.size());
+
+    planCache.clear();
+    ASSERT_EQUALS(planCache.size(), 0U);
+}
+
+TEST(PlanCacheTest, CachedSolutionStopsWantingFeedbackOnceEntryIsFull) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+    ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+
+    const int feedbacksStored = internalQueryCacheFeedbacksStored.load();
+    for (int i = 0; i < feedbacksStored; ++i) {
+        CachedSolution* rawCs;
+        ASSERT_OK(planCache.get(*cq, &rawCs));
+        unique_ptr<CachedSolution> cs(rawCs);
+        ASSERT_TRUE(cs->wantsFeedback);
+
+        auto feedback = stdx::make_unique<PlanCacheEntryFeedback>();
+        feedback->stats =
+            stdx::make_unique<PlanStageStats>(CommonStats("COLLSCAN"), STAGE_COLLSCAN);
+        feedback->score = 1.0;
+        ASSERT_OK(planCache.feedback(*cq, feedback.release()));
+    }
+
+    CachedSolution* rawCs;
+    ASSERT_OK(planCache.get(*cq, &rawCs));
+    unique_ptr<CachedSolution> cs(rawCs);
+    ASSERT_FALSE(cs->wantsFeedback);
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -1426,6 +1479,20 @@ TEST(PlanCacheTest, ComputeKey) {
     testComputeKey("{$or: [{a: 1}]}", "{}", "{'a.$': 1}", "eqa|ia.$");
 }
 
+// Cache keys encode only the shape of the query, so queries differing in their constants or in
+// the length of an $in list share a cache entry.
+TEST(PlanCacheTest, ComputeKeyIgnoresConstantsAndInListSize) {
+    testComputeKey("{a: 1, b: 'x'}", "{}", "{}", "an[eqa,eqb]");
+    testComputeKey("{a: 2, b: 'y'}", "{}", "{}", "an[eqa,eqb]");
+    testComputeKey("{a: {$in: [1, 2]}}", "{}", "{}", "ina");
+    testComputeKey("{a: {$in: [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]}}", "{}", "{}", "ina");
+    testComputeKey("{a: {$in: [1, 2]}, b: {$gt: 5}}", "{}", "{}", "an[gtb,ina]");
+    testComputeKey("{a: {$in: [3, 4, 5, 6]}, b: {$gt: 10}}", "{}", "{}", "an[gtb,ina]");
+
+    // An $in list with a single element is normalized to an equality.
+    testComputeKey("{a: {$in: [1]}}", "{}", "{}", "eqa");
+}
+
 // Delimiters found in user field names or non-standard projection field values
 // must be escaped.
 TEST(PlanCacheTest, ComputeKeyEscaped) {
@@ -1496,6 +1563,27 @@ TEST(PlanCacheTest, ComputeKeySparseIndex) {
     ASSERT_NOT_EQUALS(planCache.computeKey(*cqEqNull), planCache.computeKey(*cqEqNumber));
 }
 
+// A key memoized in a query must not be reused once the set of indexes changes, nor by another
+// plan cache.
+TEST(PlanCacheTest, ComputeKeyRecomputedWhenIndexesChange) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cqEqNull(canonicalize("{a: null}}"));
+    ASSERT_EQ(planCache.computeKey(*cqEqNull), "eqa");
+    ASSERT_EQ(planCache.computeKey(*cqEqNull), "eqa");
+
+    planCache.notifyOfIndexEntries({IndexEntry(BSON("a" << 1),
+                                               false,    // multikey
+                                               true,     // sparse
+                                               false,    // unique
+                                               "",       // name
+                                               nullptr,  // filterExpr
+                                               BSONObj())});
+    ASSERT_EQ(planCache.computeKey(*cqEqNull), "eqa<0>");
+
+    PlanCache otherPlanCache;
+    ASSERT_EQ(otherPlanCache.computeKey(*cqEqNull), "eqa");
+}
+
 // When a partial index is present, computeKey() should generate different keys depending on
 // whether or not the predicates in the given query "match" the predicates in the partial index
 // filter.
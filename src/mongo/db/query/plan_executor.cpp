@@ -47,6 +47,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
@@ -54,6 +55,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/stacktrace.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -76,6 +78,27 @@ namespace {
 
 MONGO_FP_DECLARE(planExecutorAlwaysFails);
 
+/**
+ * Adds the time between its construction and destruction to the plan selection time of the
+ * current operation.
+ */
+class ScopedPlanningTimer {
+    MONGO_DISALLOW_COPYING(ScopedPlanningTimer);
+
+public:
+    explicit ScopedPlanningTimer(OperationContext* opCtx) : _opCtx(opCtx) {}
+
+    ~ScopedPlanningTimer() {
+        if (_opCtx) {
+            CurOp::get(_opCtx)->debug().planningTimeMicros += _timer.micros();
+        }
+    }
+
+private:
+    OperationContext* const _opCtx;
+    Timer _timer;
+};
+
 /**
  * Constructs a PlanYieldPolicy based on 'policy'.
  */
@@ -249,6 +272,7 @@ Status PlanExecutor::pickBestPlan(const Collection* collection) {
     PlanStage* foundStage = getStageByType(_root.get(), STAGE_SUBPLAN);
     if (foundStage) {
         SubplanStage* subplan = static_cast<SubplanStage*>(foundStage);
+        ScopedPlanningTimer planningTimer(_opCtx);
         return subplan->pickBestPlan(_yieldPolicy.get());
     }
 
@@ -257,6 +281,7 @@ Status PlanExecutor::pickBestPlan(const Collection* collection) {
     foundStage = getStageByType(_root.get(), STAGE_MULTI_PLAN);
     if (foundStage) {
         MultiPlanStage* mps = static_cast<MultiPlanStage*>(foundStage);
+        ScopedPlanningTimer planningTimer(_opCtx);
         return mps->pickBestPlan(_yieldPolicy.get());
     }
 
@@ -265,6 +290,7 @@ Status PlanExecutor::pickBestPlan(const Collection* collection) {
     foundStage = getStageByType(_root.get(), STAGE_CACHED_PLAN);
     if (foundStage) {
         CachedPlanStage* cachedPlan = static_cast<CachedPlanStage*>(foundStage);
+        ScopedPlanningTimer planningTimer(_opCtx);
         return cachedPlan->pickBestPlan(_yieldPolicy.get());
     }
 
@@ -399,6 +425,19 @@ void PlanExecutor::invalidate(OperationContext* opCtx, const RecordId& dl, Inval
     if (!isMarkedAsKilled()) {
         _root->invalidate(opCtx, dl, type);
     }
+
+    // Batched results already hold their documents, so a deleted RecordId only has to be
+    // dropped once the document no longer depends on the record.
+    if (INVALIDATION_DELETION == type) {
+        for (size_t i = _nextBatchedResult; i < _batchedResults.size(); ++i) {
+            WorkingSetMember* member = _workingSet->get(_batchedResults[i]);
+            if (member->hasObj() && member->hasRecordId() && member->recordId == dl) {
+                member->obj.setValue(member->obj.value().getOwned());
+                member->recordId = RecordId();
+                member->transitionToOwnedObj();
+            }
+        }
+    }
 }
 
 PlanExecutor::ExecState PlanExecutor::getNext(BSONObj* objOut, RecordId* dlOut) {
@@ -543,7 +582,12 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         fetcher.reset();
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = PlanStage::ADVANCED;
+        if (_nextBatchedResult < _batchedResults.size()) {
+            id = _batchedResults[_nextBatchedResult++];
+        } else {
+            code = workRoot(&id);
+        }
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -630,9 +674,41 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     }
 }
 
+PlanStage::StageState PlanExecutor::workRoot(WorkingSetID* out) {
+    const int batchSize = internalQueryExecBatchedWorkSize.load();
+    if (batchSize <= 0) {
+        return _root->work(out);
+    }
+
+    _batchedResults.clear();
+    _nextBatchedResult = 0;
+    PlanStage::StageState code = _root->workBatch(batchSize, &_batchedResults, out);
+    if (_batchedResults.empty()) {
+        return code;
+    }
+
+    if (PlanStage::DEAD == code || PlanStage::FAILURE == code) {
+        // The query has failed, so the results produced before the failure are discarded.
+        for (auto&& id : _batchedResults) {
+            _workingSet->free(id);
+        }
+        _batchedResults.clear();
+        return code;
+    }
+
+    // Any other state is reproduced by working the plan again once the batch is consumed. The
+    // results we hold past this call may outlive a yield, so they must own their documents.
+    for (size_t i = 1; i < _batchedResults.size(); ++i) {
+        _workingSet->get(_batchedResults[i])->makeObjOwnedIfNeeded();
+    }
+    *out = _batchedResults[_nextBatchedResult++];
+    return PlanStage::ADVANCED;
+}
+
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() ||
+        (_stash.empty() && _nextBatchedResult >= _batchedResults.size() && _root->isEOF());
 }
 
 void PlanExecutor::markAsKilled(string reason) {
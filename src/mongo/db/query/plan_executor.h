@@ -33,6 +33,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/util/partitioned.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
@@ -423,6 +424,13 @@ public:
      */
     void enqueue(const BSONObj& obj);
 
+    /**
+     * Returns how many documents queued by enqueue() have yet to be returned by getNext().
+     */
+    size_t numStashedResults() const {
+        return _stash.size();
+    }
+
     /**
      * Helper method which returns a set of BSONObj, where each represents a sort order of our
      * output.
@@ -492,6 +500,13 @@ private:
 
     ExecState getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
+    /**
+     * Works the plan once, in batches of up to 'internalQueryExecBatchedWorkSize' units of work
+     * if batched execution is enabled. Returns ADVANCED with the first result of a batch in
+     * '*out' and keeps the rest of the batch in '_batchedResults'.
+     */
+    PlanStage::StageState workRoot(WorkingSetID* out);
+
     /**
      * New PlanExecutor instances are created with the static make() methods above.
      */
@@ -574,6 +589,12 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Results produced by the last call to PlanStage::workBatch() on '_root' which have not been
+    // returned yet, starting at index '_nextBatchedResult'. These are returned after the stash and
+    // before the plan is worked again.
+    std::vector<WorkingSetID> _batchedResults;
+    size_t _nextBatchedResult = 0;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     // Set if this PlanExecutor is registered with the CursorManager.
@@ -155,11 +155,13 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         params.options & QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
 
     // If the hint is {$natural: +-1} this changes the direction of the collection scan.
+    bool naturalOrder = false;
     if (!query.getQueryRequest().getHint().isEmpty()) {
         BSONElement natural =
             dps::extractElementAtPath(query.getQueryRequest().getHint(), "$natural");
         if (!natural.eoo()) {
             csn->direction = natural.numberInt() >= 0 ? 1 : -1;
+            naturalOrder = true;
         }
     }
 
@@ -170,9 +172,25 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         BSONElement natural = dps::extractElementAtPath(sortObj, "$natural");
         if (!natural.eoo()) {
             csn->direction = natural.numberInt() >= 0 ? 1 : -1;
+            naturalOrder = true;
         }
     }
 
+    // A scan may only start partway through the collection if nothing asked for natural order and
+    // which documents it returns does not depend on where it stops.
+    csn->shared = internalQueryExecCollectionScanShared.load() && !naturalOrder && !tailable &&
+        !csn->shouldTrackLatestOplogTimestamp && csn->maxScan == 0;
+
+    return std::move(csn);
+}
+
+// static
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeColumnScan(
+    const CanonicalQuery& query, const QueryPlannerParams& params) {
+    auto csn = stdx::make_unique<ColumnScanNode>();
+    csn->name = query.ns();
+    csn->filter = query.root()->shallowClone();
+    csn->cachedFields = params.columnCacheFields;
     return std::move(csn);
 }
 
@@ -1283,6 +1301,106 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     return solnRoot;
 }
 
+namespace {
+
+/**
+ * Returns true if 'expr' is a predicate whose index bounds a skip scan can use on a non-leading
+ * field of a compound index.
+ */
+bool isSkipScanPredicate(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+// static
+QuerySolutionNode* QueryPlannerAccess::makeSkipScan(const IndexEntry& index,
+                                                    const CanonicalQuery& query,
+                                                    const QueryPlannerParams& params) {
+    // Bounds on a multikey index can only be intersected for predicates of the same $elemMatch,
+    // and sparse and partial indexes may not contain every document with no leading field
+    // value, so only plain non-multikey btree indexes are skip scanned.
+    if (index.type != INDEX_BTREE || index.multikey || index.sparse || index.filterExpr ||
+        index.keyPattern.nFields() < 2 ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return NULL;
+    }
+
+    std::vector<const MatchExpression*> predicates;
+    const MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    unique_ptr<IndexScanNode> isn = make_unique<IndexScanNode>(index);
+    isn->maxScan = query.getQueryRequest().getMaxScan();
+    isn->addKeyMetadata = query.getQueryRequest().returnKey();
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    bool laterFieldConstrained = false;
+    size_t fieldNo = 0;
+    for (auto&& kpElt : index.keyPattern) {
+        OrderedIntervalList* oil = &isn->bounds.fields[fieldNo];
+        oil->name = kpElt.fieldName();
+
+        bool fieldConstrained = false;
+        for (auto&& predicate : predicates) {
+            if (predicate->path() != kpElt.fieldNameStringData()) {
+                continue;
+            }
+            // Queries on the leading field are served by the regular index scans.
+            if (0 == fieldNo) {
+                return NULL;
+            }
+            if (!isSkipScanPredicate(predicate)) {
+                continue;
+            }
+
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (fieldConstrained) {
+                IndexBoundsBuilder::translateAndIntersect(predicate, kpElt, index, oil, &tightness);
+            } else {
+                IndexBoundsBuilder::translate(predicate, kpElt, index, oil, &tightness);
+                fieldConstrained = true;
+            }
+        }
+
+        if (!fieldConstrained) {
+            IndexBoundsBuilder::allValuesForField(kpElt, oil);
+        }
+        laterFieldConstrained = laterFieldConstrained || fieldConstrained;
+        ++fieldNo;
+    }
+
+    if (!laterFieldConstrained) {
+        return NULL;
+    }
+
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds are not used to answer any predicate exactly, so the whole filter is applied to
+    // the fetched documents.
+    unique_ptr<FetchNode> fetch = make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return fetch.release();
+}
+
 // static
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
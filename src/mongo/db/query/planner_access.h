@@ -189,6 +189,13 @@ public:
                                                                  bool tailable,
                                                                  const QueryPlannerParams& params);
 
+    /**
+     * Return a ColumnScanNode that scans the collection's column projection cache and applies
+     * the query's filter to each document.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeColumnScan(const CanonicalQuery& query,
+                                                             const QueryPlannerParams& params);
+
     /**
      * Return a plan that uses the provided index as a proxy for a collection scan.
      */
@@ -197,6 +204,17 @@ public:
                                              const QueryPlannerParams& params,
                                              int direction = 1);
 
+    /**
+     * Return a plan that skip scans the provided compound index: the leading field, which the
+     * query must not constrain, is scanned over all of its values, and the later fields are
+     * bounded by the query's top-level comparison predicates on them. The index scan seeks from
+     * one leading value's matching range to the next rather than examining every key. Returns
+     * NULL if the index or the query is not suitable.
+     */
+    static QuerySolutionNode* makeSkipScan(const IndexEntry& index,
+                                           const CanonicalQuery& query,
+                                           const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -41,6 +41,7 @@
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -290,6 +291,18 @@ void geoSkipValidationOn(const std::set<StringData>& twoDSphereFields,
     }
 }
 
+/**
+ * Returns the number of results a SORT must produce so that a SKIP of 'skip' above it can still
+ * return 'limit' results. Returns 0, meaning no limit, if the sum does not fit in 64 bits.
+ */
+size_t sortLimitWithSkip(long long limit, long long skip) {
+    long long sum;
+    if (mongoSignedAddOverflow64(limit, skip, &sum)) {
+        return 0;
+    }
+    return static_cast<size_t>(sum);
+}
+
 }  // namespace
 
 // static
@@ -538,17 +551,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
     // N + M items so that the skip stage can discard the first M results.
     if (qr.getLimit()) {
         // We have a true limit. The limit can be combined with the SORT stage.
-        sort->limit =
-            static_cast<size_t>(*qr.getLimit()) + static_cast<size_t>(qr.getSkip().value_or(0));
+        sort->limit = sortLimitWithSkip(*qr.getLimit(), qr.getSkip().value_or(0));
     } else if (qr.getNToReturn()) {
         // We have an ntoreturn specified by an OP_QUERY style find. This is used
         // by clients to mean both batchSize and limit.
         //
-        // Overflow here would be bad and could cause a nonsense limit. Cast
-        // skip and limit values to unsigned ints to make sure that the
-        // sum is never stored as signed. (See SERVER-13537).
-        sort->limit =
-            static_cast<size_t>(*qr.getNToReturn()) + static_cast<size_t>(qr.getSkip().value_or(0));
+        // Overflow here would be bad and could cause a nonsense limit, so a sum which does
+        // not fit is treated as no limit at all. (See SERVER-13537).
+        sort->limit = sortLimitWithSkip(*qr.getNToReturn(), qr.getSkip().value_or(0));
 
         // This is a SORT with a limit. The wire protocol has a single quantity
         // called "numToReturn" which could mean either limit or batchSize.
@@ -598,6 +608,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A limited sort on text score alone keeps only the best scoring documents from a TEXT stage
+    // directly beneath it, so the TEXT stage does not need to fetch the others.
+    if (sort->limit && sortObj.nFields() == 1 &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement()) &&
+        STAGE_TEXT == keyGenNode->children[0]->getType()) {
+        static_cast<TextNode*>(keyGenNode->children[0])->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
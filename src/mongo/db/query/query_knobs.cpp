@@ -38,12 +38,16 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerSkipTrialForUniquePointLookups, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictDuringExecution, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -62,21 +66,75 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecBlockingSortAllowDiskUse, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecProfileSampleInterval, int, 8);
+
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecBatchedWorkSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollectionScanParallelism, int, 1);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollectionScanParallelBatchSize, int, 1024);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollectionScanShared, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCompileMatchExpressions, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetMaxWorkerThreads, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryColumnProjectionCacheMaxBytes, int, 100 * 1024 * 1024);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations.load() / 2);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalInsertGroupCommitWindowMicros, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalUpdateMultiMaxBatchSize, int, 64);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupSpillPartitions, int, 16);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryRandomCursorMaxSampleRatio, double, 0.05);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryViewResultCacheMaxStalenessMS, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryViewResultCacheMaxBytes, int, 64 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalChangeStreamEventCacheMaxBytes, int, 16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryGetMorePrefetchMaxBytes, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalPipelineUseDocumentArena, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalPipelineUseDocumentShapes, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCompileAggExpressions, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryUseKeyStringSortKeys, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPointLookupMaxKeys, int, 200);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnableDistinctScanForGroup, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateSkipScans, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
 }  // namespace mongo
@@ -48,6 +48,10 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// Do we run a plan which looks up a single key of a unique index without racing it against the
+// other candidates?
+extern AtomicBool internalQueryPlannerSkipTrialForUniquePointLookups;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -72,6 +76,10 @@ extern AtomicInt32 internalQueryCacheFeedbacksStored;
 // and replanning?
 extern AtomicDouble internalQueryCacheEvictionRatio;
 
+// Do we evict a cached plan which, after its trial period, performs more than
+// 'internalQueryCacheEvictionRatio' times its decision works without producing a result?
+extern AtomicBool internalQueryCacheEvictDuringExecution;
+
 //
 // Planning and enumeration.
 //
@@ -95,6 +103,10 @@ extern AtomicInt32 internalQueryMaxScansToExplode;
 // Allow the planner to generate covered whole index scans, rather than falling back to a COLLSCAN.
 extern AtomicBool internalQueryPlannerGenerateCoveredWholeIndexScans;
 
+// Allow the planner to generate skip scans over compound indexes whose leading field is not
+// constrained by the query.
+extern AtomicBool internalQueryPlannerGenerateSkipScans;
+
 // Ignore unknown JSON Schema keywords.
 extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
@@ -104,22 +116,128 @@ extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
 extern AtomicInt32 internalQueryExecMaxBlockingSortBytes;
 
+// If true, a blocking SORT stage which exceeds internalQueryExecMaxBlockingSortBytes spills to disk
+// instead of failing the query.
+extern AtomicBool internalQueryExecBlockingSortAllowDiskUse;
+
+// When explaining at "executionProfile" verbosity, time one in this many calls to work() of each
+// stage.
+extern AtomicInt32 internalQueryExecProfileSampleInterval;
+
 // Yield after this many "should yield?" checks.
 extern AtomicInt32 internalQueryExecYieldIterations;
 
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// If positive, the PlanExecutor asks its plan for results in batches of up to this many units of
+// work rather than one unit of work at a time. Zero disables batched execution.
+extern AtomicInt32 internalQueryExecBatchedWorkSize;
+
+// If greater than one, the number of threads a collection scan with a filter may use to evaluate
+// the filter. One disables parallel collection scans.
+extern AtomicInt32 internalQueryExecCollectionScanParallelism;
+
+// The number of records a parallel collection scan reads ahead and splits among its threads.
+extern AtomicInt32 internalQueryExecCollectionScanParallelBatchSize;
+
+// Whether a collection scan whose results need not be in natural order starts at the position of a
+// scan of the same collection which is already running, and wraps around to read the records it
+// skipped, so that concurrent scans read the same records while they are in the cache.
+extern AtomicBool internalQueryExecCollectionScanShared;
+
+// If true, collection scans evaluate supported filters with a CompiledMatchExpression.
+extern AtomicBool internalQueryCompileMatchExpressions;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
 // The number of bytes to buffer at once during a $facet stage.
 extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
+// The most threads a $facet stage may use to run its sub-pipelines concurrently. A value of one
+// runs them one after another on the thread executing the aggregation.
+extern AtomicInt32 internalQueryFacetMaxWorkerThreads;
+
+// The most memory a collection's column projection cache may use. A cache which grows past this
+// is dropped.
+extern AtomicInt32 internalQueryColumnProjectionCacheMaxBytes;
+
 extern AtomicInt32 internalInsertMaxBatchSize;
 
+// How long, in microseconds, the first of several concurrent single-document inserts into the same
+// collection waits for others to arrive, so that they are all committed in one storage transaction.
+// Zero disables combining inserts.
+extern AtomicInt32 internalInsertGroupCommitWindowMicros;
+
+// The most documents a multi-update which returns no documents modifies in one storage transaction
+// on engines with document-level locking. A value of 1 or less updates them one at a time.
+extern AtomicInt32 internalUpdateMultiMaxBatchSize;
+
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// The most memory a $lookup may use to hold the foreign collection in a hash table. A $lookup on
+// localField/foreignField whose foreign collection is no larger than this joins by hashing rather
+// than by querying once per input document. 0 disables hash joins.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMaxMemoryBytes;
+
+// The most memory a $graphLookup may use for the documents it has discovered for one input and for
+// the values it will search for next. With allowDiskUse, it spills the discovered documents to disk
+// rather than failing when it exceeds this.
+extern AtomicInt32 internalDocumentSourceGraphLookupMaxMemoryBytes;
+
+// The number of hash partitions a $group spills its groups into when it runs out of memory. Each
+// partition is later re-aggregated on its own, and re-partitioned again if it still does not fit.
+// 0 spills by sorting the groups instead, which preserves the sorted output order of a spilled
+// $group.
+extern AtomicInt32 internalDocumentSourceGroupSpillPartitions;
+
+// The largest fraction of a collection a $sample may ask for and still be answered by a storage
+// engine random cursor. Larger samples scan the collection and keep the documents with the highest
+// random values. Random cursors may return duplicates, which become more likely as this grows.
+extern AtomicDouble internalQueryRandomCursorMaxSampleRatio;
+
+// How old the cached results of a view's pipeline may be and still be served to a read of the view.
+// Only views made of $match, $project, $addFields, $group, $sort, $limit, $skip, $unwind and
+// $replaceRoot stages are cached. 0 disables the cache, so that every read re-runs the pipeline.
+extern AtomicInt32 internalQueryViewResultCacheMaxStalenessMS;
+
+// The most memory the process-wide cache of view results may use. The results of a view which are
+// larger than this are not cached.
+extern AtomicInt32 internalQueryViewResultCacheMaxBytes;
+
+// The most memory the process-wide cache of change events, shared by all $changeStream stages, may
+// use. 0 disables the cache, so that each change stream transforms every oplog entry itself.
+extern AtomicInt32 internalChangeStreamEventCacheMaxBytes;
+
+// The most memory of documents a cursor may prefetch in the background once a getMore has returned
+// its batch, so that the next getMore finds its batch ready. 0 disables prefetching.
+extern AtomicInt32 internalQueryGetMorePrefetchMaxBytes;
+
+// Whether an aggregation makes the Documents and strings it produces in an arena, released after
+// each batch, rather than allocating each one from the heap.
+extern AtomicBool internalPipelineUseDocumentArena;
+
+// Whether an aggregation interns the field names of the Documents it produces as shared shapes, so
+// that field path lookups in documents of a familiar shape need no hashing.
+extern AtomicBool internalPipelineUseDocumentShapes;
+
+// Whether $project and $addFields compile their computed fields to bytecode when the pipeline is
+// optimized, rather than always walking the expression tree.
+extern AtomicBool internalQueryCompileAggExpressions;
+
+// Whether $sort encodes each sort key as a KeyString once per document, so that the sorter compares
+// keys with memcmp rather than by comparing Values.
+extern AtomicBool internalQueryUseKeyStringSortKeys;
+
+// The largest number of keys for which a query of equalities on all the fields of a unique index
+// is answered by seeking the index for each key, without planning. 0 disables the fast path.
+extern AtomicInt32 internalQueryPointLookupMaxKeys;
+
+// Whether an aggregation whose $group needs only one document of each group, such as the first one
+// of each value of the group key, is fed by a DISTINCT_SCAN which skips the other documents.
+extern AtomicBool internalQueryEnableDistinctScanForGroup;
+
 }  // namespace mongo
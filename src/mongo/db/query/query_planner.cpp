@@ -285,6 +285,129 @@ QuerySolution* buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+QuerySolution* buildSkipScanSoln(const IndexEntry& index,
+                                 const CanonicalQuery& query,
+                                 const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::makeSkipScan(index, query, params));
+    if (!solnRoot) {
+        return NULL;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
+/**
+ * Returns true if 'path' is, or is nested inside of, a top-level field in 'cachedFields'.
+ */
+bool isColumnCachedPath(StringData path, const std::set<std::string>& cachedFields) {
+    if (path.empty()) {
+        return false;
+    }
+    return cachedFields.count(path.substr(0, path.find('.')).toString()) > 0;
+}
+
+/**
+ * Returns true if 'expr' only refers to paths inside of 'cachedFields', and only uses operators
+ * which give the same result over a document holding just those fields as over the whole
+ * document.
+ */
+bool isColumnCacheCovered(const MatchExpression* expr, const std::set<std::string>& cachedFields) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!isColumnCacheCovered(expr->getChild(i), cachedFields)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE:
+            return true;
+        case MatchExpression::ELEM_MATCH_OBJECT:
+        case MatchExpression::ELEM_MATCH_VALUE:
+            // The children are relative to the array elements, which are cached whole.
+        case MatchExpression::SIZE:
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::MATCH_IN:
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR:
+        case MatchExpression::TYPE_OPERATOR:
+        case MatchExpression::GEO:
+            return isColumnCachedPath(expr->path(), cachedFields);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns true if 'query' can be answered by scanning the collection's column projection cache
+ * rather than the collection itself.
+ */
+bool canUseColumnScan(const CanonicalQuery& query, const QueryPlannerParams& params) {
+    if (!params.columnCacheAvailable) {
+        return false;
+    }
+
+    const QueryRequest& qr = query.getQueryRequest();
+    if (qr.isTailable() || qr.isSnapshot() || qr.getMaxScan() || qr.returnKey() ||
+        qr.showRecordId() || !qr.getHint().isEmpty() || !qr.getMin().isEmpty() ||
+        !qr.getMax().isEmpty()) {
+        return false;
+    }
+
+    const auto& cachedFields = params.columnCacheFields;
+
+    // Without a projection, only a count can do without the rest of the document.
+    const ParsedProjection* projection = query.getProj();
+    if (projection) {
+        if (projection->requiresDocument() || projection->wantIndexKey()) {
+            return false;
+        }
+        for (auto&& field : projection->getRequiredFields()) {
+            if (!isColumnCachedPath(field, cachedFields)) {
+                return false;
+            }
+        }
+    } else if (!(params.options & QueryPlannerParams::IS_COUNT)) {
+        return false;
+    }
+
+    for (auto&& sortElt : qr.getSort()) {
+        if (!isColumnCachedPath(sortElt.fieldNameStringData(), cachedFields)) {
+            return false;
+        }
+    }
+
+    if (params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
+        for (auto&& shardKeyElt : params.shardKey) {
+            if (!isColumnCachedPath(shardKeyElt.fieldNameStringData(), cachedFields)) {
+                return false;
+            }
+        }
+    }
+
+    return isColumnCacheCovered(query.root(), cachedFields);
+}
+
+QuerySolution* buildColumnScanSoln(const CanonicalQuery& query,
+                                   const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::makeColumnScan(query, params));
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
@@ -465,6 +588,14 @@ Status QueryPlanner::planFromCache(const CanonicalQuery& query,
             *out = soln;
             return Status::OK();
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        QuerySolution* soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (soln == NULL) {
+            return Status(ErrorCodes::BadValue, "plan cache error: skip scan soln");
+        } else {
+            *out = soln;
+            return Status::OK();
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -1079,6 +1210,43 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     bool collscanNeeded = (0 == out->size() && canTableScan);
 
+    // Compound indexes whose leading field is unconstrained can still be skip scanned. These plans
+    // are only candidates to race against the others, so they are added after deciding whether a
+    // collscan is needed.
+    if ((params.options & QueryPlannerParams::GENERATE_SKIP_SCANS) && hintIndex.isEmpty() &&
+        !query.getQueryRequest().isSnapshot() &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        for (auto&& index : params.indices) {
+            QuerySolution* soln = buildSkipScanSoln(index, query, params);
+            if (NULL == soln) {
+                continue;
+            }
+            LOG(5) << "Planner: outputting a skip scan:" << endl << redact(soln->toString());
+
+            PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+            indexTree->setIndexEntry(index);
+            SolutionCacheData* scd = new SolutionCacheData();
+            scd->tree.reset(indexTree);
+            scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+            soln->cacheData.reset(scd);
+            out->push_back(soln);
+        }
+    }
+
+    if (possibleToCollscan && (collscanRequested || collscanNeeded) &&
+        canUseColumnScan(query, params)) {
+        // The column scan reads the same documents as a collscan would, but only their cached
+        // fields. It is not cached since the column cache may be dropped at any time.
+        QuerySolution* columnScan = buildColumnScanSoln(query, params);
+        if (NULL != columnScan) {
+            out->push_back(columnScan);
+            LOG(5) << "Planner: outputting a column scan:" << endl
+                   << redact(columnScan->toString());
+            return Status::OK();
+        }
+    }
+
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         QuerySolution* collscan = buildCollscanSoln(query, isTailable, params);
         if (NULL != collscan) {
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/db/jsobj.h"
@@ -101,6 +103,10 @@ struct QueryPlannerParams {
 
         // Set this to track the most recent timestamp seen by this cursor while scanning the oplog.
         TRACK_LATEST_OPLOG_TS = 1 << 12,
+
+        // Set this to generate IXSCAN plans over compound indexes whose leading field the query
+        // does not constrain, with bounds on the later fields that the scan seeks between.
+        GENERATE_SKIP_SCANS = 1 << 13,
     };
 
     // See Options enum above.
@@ -121,6 +127,12 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // Does the collection have a column projection cache that this query may read from? If so,
+    // a collection scan may be replaced by a scan of the cache when the query only needs the
+    // cached top-level fields, which are listed in 'columnCacheFields' along with _id.
+    bool columnCacheAvailable = false;
+    std::set<std::string> columnCacheFields;
 };
 
 }  // namespace mongo
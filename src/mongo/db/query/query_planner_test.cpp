@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -1543,6 +1544,19 @@ TEST_F(QueryPlannerTest, SortSkipSoftLimit) {
         "{node: {cscan: {dir: 1}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, SortSkipLimitOverflowIsUnlimited) {
+    const long long kMax = std::numeric_limits<long long>::max();
+    runQuerySortProjSkipNToReturn(BSONObj(), fromjson("{a: 1}"), BSONObj(), kMax, -kMax);
+    assertNumSolutions(1U);
+
+    // The sum of the skip and limit does not fit in 64 bits, so the sort must not be limited.
+    QuerySolutionNode* root = solns[0]->root.get();
+    ASSERT_EQ(STAGE_SKIP, root->getType());
+    ASSERT_EQ(1U, root->children.size());
+    ASSERT_EQ(STAGE_SORT, root->children[0]->getType());
+    ASSERT_EQ(0U, static_cast<SortNode*>(root->children[0])->limit);
+}
+
 //
 // Sort elimination
 //
@@ -5445,4 +5459,139 @@ TEST_F(QueryPlannerTest, EmptyQueryWithProjectionUsesCollscanIfIndexCollationDif
         "{proj: {spec: {_id: 0, a: 1}, node: "
         "{cscan: {dir: 1}}}}");
 }
+
+//
+// Column projection cache
+//
+
+TEST_F(QueryPlannerTest, CoveredProjectionUsesColumnScan) {
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a", "b"};
+    runQueryAsCommand(fromjson("{find: 'testns', filter: {a: 1}, projection: {_id: 0, b: 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, b: 1}, node: "
+        "{colscan: {filter: {a: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanCoversDottedPathsAndSorts) {
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a", "b"};
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {'a.x': {$gt: 1}}, sort: {b: 1}, projection: {'a.y': 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{proj: {spec: {'a.y': 1}, node: {sort: {pattern: {b: 1}, limit: 0, node: "
+        "{sortKeyGen: {node: {colscan: {filter: {'a.x': {$gt: 1}}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CountUsesColumnScanWithoutProjection) {
+    params.options = QueryPlannerParams::IS_COUNT;
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a"};
+    runQuery(fromjson("{a: {$in: [1, 2]}}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{colscan: {filter: {a: {$in: [1, 2]}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanNotUsedWhenFilterNeedsUncachedField) {
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a"};
+    runQueryAsCommand(fromjson("{find: 'testns', filter: {c: 1}, projection: {_id: 0, a: 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: "
+        "{cscan: {dir: 1, filter: {c: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanNotUsedWhenProjectionNeedsUncachedField) {
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a"};
+    runQueryAsCommand(fromjson("{find: 'testns', filter: {a: 1}, projection: {a: 1, c: 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{proj: {spec: {a: 1, c: 1}, node: "
+        "{cscan: {dir: 1, filter: {a: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanNotUsedWithoutProjection) {
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a"};
+    runQuery(fromjson("{a: 1}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1, filter: {a: 1}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanNotUsedForWhere) {
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a"};
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$where: 'this.a == 1'}, projection: {_id: 0, a: 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanReplacesCollscanAlongsideIndexedPlans) {
+    params.columnCacheAvailable = true;
+    params.columnCacheFields = {"_id", "a"};
+    addIndex(BSON("a" << 1));
+    runQueryAsCommand(fromjson("{find: 'testns', filter: {a: 1}, projection: {_id: 0, a: 1}}"));
+    assertNumSolutions(2);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: "
+        "{colscan: {filter: {a: 1}}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: "
+        "{ixscan: {filter: null, pattern: {a: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanUsedForUnconstrainedLeadingFieldIfEnabled) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{b: 5, c: {$gt: 1}}"));
+    assertNumSolutions(2);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5, c: {$gt: 1}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: 5, c: {$gt: 1}}, node: {ixscan: {pattern: {a: 1, b: 1, c: 1}, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]], b: [[5, 5, true, true]], "
+        "c: [[1, Infinity, false, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanBoundsAlignedToDescendingIndexFields) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << -1));
+    runQuery(fromjson("{b: {$in: [1, 4]}}"));
+    assertNumSolutions(2);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: {$in: [1, 4]}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$in: [1, 4]}}, node: {ixscan: {pattern: {a: 1, b: -1}, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]], "
+        "b: [[4, 4, true, true], [1, 1, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedIfDisabled) {
+    params.options &= ~QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedIfLeadingFieldConstrained) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{a: {$gt: 3}, b: 5}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [[3, Infinity, false, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedForMultikeyIndex) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
 }  // namespace
@@ -264,6 +264,23 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
         }
 
         return filterMatches(filter.Obj(), collation, trueSoln);
+    } else if (STAGE_COLUMN_SCAN == trueSoln->getType()) {
+        BSONElement el = testSoln["colscan"];
+        if (el.eoo() || !el.isABSONObj()) {
+            return false;
+        }
+        BSONObj colscanObj = el.Obj();
+
+        BSONElement filter = colscanObj["filter"];
+        if (filter.eoo()) {
+            return true;
+        } else if (filter.isNull()) {
+            return NULL == trueSoln->filter;
+        } else if (!filter.isABSONObj()) {
+            return false;
+        }
+
+        return filterMatches(filter.Obj(), BSONObj(), trueSoln);
     } else if (STAGE_IXSCAN == trueSoln->getType()) {
         const IndexScanNode* ixn = static_cast<const IndexScanNode*>(trueSoln);
         BSONElement el = testSoln["ixscan"];
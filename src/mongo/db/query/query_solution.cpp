@@ -198,6 +198,10 @@ void TextNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "diacriticSensitive= " << ftsQuery->getDiacriticSensitive() << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    if (topK) {
+        addIndent(ss, indent + 1);
+        *ss << "topK = " << topK << '\n';
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->toString();
@@ -212,6 +216,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->_sort = this->_sort;
     copy->ftsQuery = this->ftsQuery->clone();
     copy->indexPrefix = this->indexPrefix;
+    copy->topK = this->topK;
 
     return copy;
 }
@@ -231,6 +236,10 @@ void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent)
     *ss << "COLLSCAN\n";
     addIndent(ss, indent + 1);
     *ss << "ns = " << name << '\n';
+    if (shared) {
+        addIndent(ss, indent + 1);
+        *ss << "shared = true\n";
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << "filter = " << filter->toString();
@@ -248,6 +257,47 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
+    copy->shared = this->shared;
+
+    return copy;
+}
+
+//
+// ColumnScanNode
+//
+
+ColumnScanNode::ColumnScanNode() : _sort(SimpleBSONObjComparator::kInstance.makeBSONObjSet()) {}
+
+void ColumnScanNode::appendToString(mongoutils::str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "COLUMN_SCAN\n";
+    addIndent(ss, indent + 1);
+    *ss << "ns = " << name << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "cachedFields = [";
+    for (auto&& field : cachedFields) {
+        *ss << " " << field;
+    }
+    *ss << " ]\n";
+    if (NULL != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->toString();
+    }
+    addCommon(ss, indent);
+}
+
+bool ColumnScanNode::hasField(const std::string& field) const {
+    // A cached field holds the whole value of a top-level field, including any subfields.
+    return cachedFields.count(field.substr(0, field.find('.'))) > 0;
+}
+
+QuerySolutionNode* ColumnScanNode::clone() const {
+    ColumnScanNode* copy = new ColumnScanNode();
+    cloneBaseData(copy);
+
+    copy->_sort = this->_sort;
+    copy->name = this->name;
+    copy->cachedFields = this->cachedFields;
 
     return copy;
 }
@@ -1139,6 +1189,10 @@ void CountScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
     *ss << "startKey = " << startKey << '\n';
     addIndent(ss, indent + 1);
     *ss << "endKey = " << endKey << '\n';
+    if (!bounds.fields.empty()) {
+        addIndent(ss, indent + 1);
+        *ss << "bounds = " << bounds.toString() << '\n';
+    }
 }
 
 QuerySolutionNode* CountScanNode::clone() const {
@@ -1150,6 +1204,7 @@ QuerySolutionNode* CountScanNode::clone() const {
     copy->startKeyInclusive = this->startKeyInclusive;
     copy->endKey = this->endKey;
     copy->endKeyInclusive = this->endKeyInclusive;
+    copy->bounds = this->bounds;
 
     return copy;
 }
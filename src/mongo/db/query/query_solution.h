@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <set>
 
 #include "mongo/bson/bsonobj_comparator_interface.h"
 #include "mongo/db/fts/fts_query.h"
@@ -254,6 +255,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, only the 'topK' highest scoring documents are needed by a sort on text score
+    // above this node.
+    size_t topK = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -298,6 +303,46 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // maxScan option to .find() limits how many docs we look at.
     int maxScan;
+
+    // Nothing depends on the scan returning documents in natural order, so it may join a scan of
+    // the collection which is already running.
+    bool shared = false;
+};
+
+/**
+ * Reads the cached fields of every document from the collection's column projection cache. The
+ * documents it produces hold only the cached top-level fields.
+ */
+struct ColumnScanNode : public QuerySolutionNode {
+    ColumnScanNode();
+    virtual ~ColumnScanNode() {}
+
+    virtual StageType getType() const {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    virtual void appendToString(mongoutils::str::stream* ss, int indent) const;
+
+    bool fetched() const {
+        return true;
+    }
+    bool hasField(const std::string& field) const;
+    bool sortedByDiskLoc() const {
+        return false;
+    }
+    const BSONObjSet& getSort() const {
+        return _sort;
+    }
+
+    QuerySolutionNode* clone() const;
+
+    BSONObjSet _sort;
+
+    // Name of the namespace.
+    std::string name;
+
+    // The top-level fields held by the cache, including _id.
+    std::set<std::string> cachedFields;
 };
 
 struct AndHashNode : public QuerySolutionNode {
@@ -939,6 +984,10 @@ struct CountScanNode : public QuerySolutionNode {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // If non-empty, the keys within these bounds are counted rather than those between
+    // 'startKey' and 'endKey'.
+    IndexBounds bounds;
 };
 
 /**
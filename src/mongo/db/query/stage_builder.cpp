@@ -39,6 +39,7 @@
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/column_scan.h"
 #include "mongo/db/exec/count_scan.h"
 #include "mongo/db/exec/distinct_scan.h"
 #include "mongo/db/exec/ensure_sorted.h"
@@ -57,6 +58,7 @@
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -82,8 +84,25 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.direction = (csn->direction == 1) ? CollectionScanParams::FORWARD
                                                      : CollectionScanParams::BACKWARD;
             params.maxScan = csn->maxScan;
+            params.shared = csn->shared;
             return new CollectionScan(opCtx, params, ws, csn->filter.get());
         }
+        case STAGE_COLUMN_SCAN: {
+            const ColumnScanNode* csn = static_cast<const ColumnScanNode*>(root);
+
+            if (nullptr == collection) {
+                warning() << "Can't column scan null namespace";
+                return nullptr;
+            }
+
+            auto cache = collection->infoCache()->getColumnProjectionCache();
+            if (!cache) {
+                warning() << "Can't column scan " << csn->name
+                          << " without a column projection cache";
+                return nullptr;
+            }
+            return new ColumnScanStage(opCtx, std::move(cache), ws, csn->filter.get());
+        }
         case STAGE_IXSCAN: {
             const IndexScanNode* ixn = static_cast<const IndexScanNode*>(root);
 
@@ -122,6 +141,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.collection = collection;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = internalQueryExecBlockingSortAllowDiskUse.load();
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -285,6 +305,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             // planning a query that contains "no-op" expressions. TODO: make StageBuilder::build()
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
+            params.topK = node->topK;
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
@@ -342,6 +363,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.startKeyInclusive = csn->startKeyInclusive;
             params.endKey = csn->endKey;
             params.endKeyInclusive = csn->endKeyInclusive;
+            params.bounds = csn->bounds;
 
             return new CountScan(opCtx, params, ws);
         }
@@ -365,6 +387,7 @@ PlanStage* buildStages(OperationContext* opCtx,
         case STAGE_MULTI_PLAN:
         case STAGE_OPLOG_START:
         case STAGE_PIPELINE_PROXY:
+        case STAGE_POINT_LOOKUP:
         case STAGE_QUEUED_DATA:
         case STAGE_SUBPLAN:
         case STAGE_TEXT_OR:
@@ -39,6 +39,9 @@ enum StageType {
     STAGE_CACHED_PLAN,
     STAGE_COLLSCAN,
 
+    // Scans a collection's column projection cache rather than the collection itself.
+    STAGE_COLUMN_SCAN,
+
     // This stage sits at the root of the query tree and counts up the number of results
     // returned by its child.
     STAGE_COUNT,
@@ -92,6 +95,9 @@ enum StageType {
     // Stage for running aggregation pipelines.
     STAGE_PIPELINE_PROXY,
 
+    // Seeks a unique index for each key of a query of equalities on all of the index fields.
+    STAGE_POINT_LOOKUP,
+
     STAGE_QUEUED_DATA,
     STAGE_SHARDING_FILTER,
     STAGE_SKIP,
@@ -316,9 +316,14 @@ void AbstractOplogFetcher::_finishCallback(Status status) {
     std::swap(_onShutdownCallbackFn, onShutdownCallbackFn);
 }
 
+BSONObj AbstractOplogFetcher::_makeStreamingGetMoreCommandObject(
+    const Fetcher::QueryResponse& queryResponse) const {
+    return BSONObj();
+}
+
 std::unique_ptr<Fetcher> AbstractOplogFetcher::_makeFetcher(const BSONObj& findCommandObj,
                                                             const BSONObj& metadataObj) {
-    return stdx::make_unique<Fetcher>(
+    auto fetcher = stdx::make_unique<Fetcher>(
         _getExecutor(),
         _source,
         _nss.db().toString(),
@@ -328,6 +333,9 @@ std::unique_ptr<Fetcher> AbstractOplogFetcher::_makeFetcher(const BSONObj& findC
         metadataObj,
         _getFindMaxTime() + kNetworkTimeoutBufferMS,
         _getGetMoreMaxTime() + kNetworkTimeoutBufferMS);
+    fetcher->setStreamingGetMoreFn(stdx::bind(
+        &AbstractOplogFetcher::_makeStreamingGetMoreCommandObject, this, stdx::placeholders::_1));
+    return fetcher;
 }
 
 }  // namespace repl
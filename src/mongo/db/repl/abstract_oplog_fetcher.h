@@ -173,6 +173,15 @@ private:
      */
     virtual StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) = 0;
 
+    /**
+     * Function called by the Fetcher when it receives a batch, before the batch is passed to
+     * _onSuccessfulBatch. Subclasses may return the `getMore` command for the next batch to have
+     * it sent right away (see Fetcher::setStreamingGetMoreFn()), or an empty object to issue
+     * the `getMore` only after the batch has been processed. Defaults to the latter.
+     */
+    virtual BSONObj _makeStreamingGetMoreCommandObject(
+        const Fetcher::QueryResponse& queryResponse) const;
+
     /**
      * This function creates a Fetcher with the given `find` command and metadata.
      */
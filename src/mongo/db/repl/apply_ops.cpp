@@ -32,10 +32,13 @@
 
 #include "mongo/db/repl/apply_ops.h"
 
+#include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -48,19 +51,71 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/string_map.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
 namespace {
 
 const auto kPreconditionFieldName = "preCondition"_sd;
+const auto kParallelFieldName = "parallel"_sd;
 
 // If enabled, causes loop in _applyOps() to hang after applying current operation.
 MONGO_FP_DECLARE(applyOpsPauseBetweenOperations);
 
+/**
+ * The number of threads applying the ops of an applyOps command with {parallel: true}, such as the
+ * batches sent by an oplog replay during a restore. Configurable with the
+ * "applyOpsParallelWriterThreads" server parameter.
+ */
+int applyOpsParallelWriterThreads = 16;
+
+class ExportedApplyOpsParallelWriterThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedApplyOpsParallelWriterThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "applyOpsParallelWriterThreads",
+              &applyOpsParallelWriterThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 256) {
+            return Status(ErrorCodes::BadValue,
+                          "applyOpsParallelWriterThreads must be between 1 and 256");
+        }
+
+        return Status::OK();
+    }
+
+} exportedApplyOpsParallelWriterThreadsParam;
+
+/**
+ * Returns the pool shared by all parallel applyOps commands. The pool is never shut down, so that
+ * it remains usable until the process exits.
+ */
+ThreadPool* getWriterPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "ApplyOpsWriter";
+        options.minThreads = 0;
+        options.maxThreads = applyOpsParallelWriterThreads;
+        options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
 /**
  * Return true iff the applyOpsCmd can be executed in a single WriteUnitOfWork.
  */
@@ -97,6 +152,66 @@ bool _areOpsCrudOnly(const BSONObj& applyOpCmd) {
     return true;
 }
 
+/**
+ * Applies a single op of a non-atomic applyOps, retrying on write conflicts. Commands require the
+ * global write lock to be held. Returns the status of applying a CRUD op, and throws if the op
+ * cannot be applied at all, which stops the applyOps.
+ */
+Status _applyOpNonAtomic(OperationContext* opCtx,
+                         const NamespaceString& nss,
+                         const BSONObj& opObj,
+                         const char* opType,
+                         bool alwaysUpsert) {
+    return writeConflictRetry(opCtx, "applyOps", nss.ns(), [&] {
+        if (*opType == 'c') {
+            invariant(opCtx->lockState()->isW());
+            return repl::applyCommand_inlock(opCtx, opObj, true);
+        }
+
+        AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+        if (!autoColl.getCollection() && !nss.isSystemDotIndexes()) {
+            // For idempotency reasons, return success on delete operations.
+            if (*opType == 'd') {
+                return Status::OK();
+            }
+            throw DBException(ErrorCodes::NamespaceNotFound,
+                              str::stream() << "cannot apply insert or update operation on a "
+                                               "non-existent namespace "
+                                            << nss.ns()
+                                            << ": "
+                                            << mongo::redact(opObj));
+        }
+
+        OldClientContext ctx(opCtx, nss.ns());
+
+        if (!nss.isSystemDotIndexes()) {
+            return repl::applyOperation_inlock(opCtx, ctx.db(), opObj, alwaysUpsert);
+        }
+
+        auto fieldO = opObj["o"];
+        BSONObj indexSpec;
+        NamespaceString indexNss;
+        std::tie(indexSpec, indexNss) = repl::prepForApplyOpsIndexInsert(fieldO, opObj, nss);
+        BSONObjBuilder command;
+        command.append("createIndexes", indexNss.coll());
+        {
+            BSONArrayBuilder indexes(command.subarrayStart("indexes"));
+            indexes.append(indexSpec);
+            indexes.doneFast();
+        }
+        const BSONObj commandObj = command.done();
+
+        DBDirectClient client(opCtx);
+        BSONObj infoObj;
+        client.runCommand(nss.db().toString(), commandObj, infoObj);
+
+        // Uassert to stop applyOps only when building indexes, but not for CRUD ops.
+        uassertStatusOK(getStatusFromCommandResult(infoObj));
+
+        return Status::OK();
+    });
+}
+
 Status _applyOps(OperationContext* opCtx,
                  const std::string& dbName,
                  const BSONObj& applyOpCmd,
@@ -175,59 +290,7 @@ Status _applyOps(OperationContext* opCtx,
                 return status;
         } else {
             try {
-                status = writeConflictRetry(
-                    opCtx, "applyOps", nss.ns(), [opCtx, nss, opObj, opType, alwaysUpsert] {
-                        if (*opType == 'c') {
-                            invariant(opCtx->lockState()->isW());
-                            return repl::applyCommand_inlock(opCtx, opObj, true);
-                        }
-
-                        AutoGetCollection autoColl(opCtx, nss, MODE_IX);
-                        if (!autoColl.getCollection() && !nss.isSystemDotIndexes()) {
-                            // For idempotency reasons, return success on delete operations.
-                            if (*opType == 'd') {
-                                return Status::OK();
-                            }
-                            throw DBException(ErrorCodes::NamespaceNotFound,
-                                              str::stream()
-                                                  << "cannot apply insert or update operation on a "
-                                                     "non-existent namespace "
-                                                  << nss.ns()
-                                                  << ": "
-                                                  << mongo::redact(opObj));
-                        }
-
-                        OldClientContext ctx(opCtx, nss.ns());
-
-                        if (!nss.isSystemDotIndexes()) {
-                            return repl::applyOperation_inlock(
-                                opCtx, ctx.db(), opObj, alwaysUpsert);
-                        }
-
-                        auto fieldO = opObj["o"];
-                        BSONObj indexSpec;
-                        NamespaceString indexNss;
-                        std::tie(indexSpec, indexNss) =
-                            repl::prepForApplyOpsIndexInsert(fieldO, opObj, nss);
-                        BSONObjBuilder command;
-                        command.append("createIndexes", indexNss.coll());
-                        {
-                            BSONArrayBuilder indexes(command.subarrayStart("indexes"));
-                            indexes.append(indexSpec);
-                            indexes.doneFast();
-                        }
-                        const BSONObj commandObj = command.done();
-
-                        DBDirectClient client(opCtx);
-                        BSONObj infoObj;
-                        client.runCommand(nss.db().toString(), commandObj, infoObj);
-
-                        // Uassert to stop applyOps only when building indexes, but not for CRUD
-                        // ops.
-                        uassertStatusOK(getStatusFromCommandResult(infoObj));
-
-                        return Status::OK();
-                    });
+                status = _applyOpNonAtomic(opCtx, nss, opObj, opType, alwaysUpsert);
             } catch (const DBException& ex) {
                 ab.append(false);
                 result->append("applied", ++(*numApplied));
@@ -271,6 +334,203 @@ Status _applyOps(OperationContext* opCtx,
     return Status::OK();
 }
 
+/**
+ * Returns whether the CRUD ops of 'applyOpCmd' may be given to the writer pool. Ops on
+ * system.indexes build indexes, which must stay in order with the ops around them.
+ */
+bool _canApplyInParallel(const BSONObj& applyOpCmd) {
+    for (const auto& elem : applyOpCmd.firstElement().Obj()) {
+        if (nsToCollectionSubstring(elem.Obj()["ns"].valueStringData()) == "system.indexes")
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Applies the CRUD ops of 'applyOpCmd' on the writer pool, without holding any locks on this
+ * thread. As on a secondary, ops which must be applied in order are given to the same writer: all
+ * ops on a namespace, or all ops on a document when the _id alone decides which ops conflict.
+ * That is not the case for capped collections, which must preserve insertion order, for
+ * collections with a non-simple default collation, and for collections with unique secondary
+ * indexes, whose constraints are enforced here.
+ *
+ * Every op is attempted, and "results" reports them in their original order. If an op could not be
+ * applied at all, the error of the first such op is reported the way the serial path reports the
+ * error which stopped it.
+ */
+Status _applyOpsParallel(OperationContext* opCtx,
+                         const BSONObj& applyOpCmd,
+                         BSONObjBuilder* result,
+                         int* numApplied) {
+    invariant(!opCtx->lockState()->isLocked());
+
+    const bool alwaysUpsert =
+        applyOpCmd.hasField("alwaysUpsert") ? applyOpCmd["alwaysUpsert"].trueValue() : true;
+
+    struct ParallelOp {
+        BSONObj opObj;
+        NamespaceString nss;
+        const char* opType;
+        Status status = Status::OK();
+        bool threw = false;
+    };
+
+    std::vector<ParallelOp> ops;
+    for (const auto& elem : applyOpCmd.firstElement().Obj()) {
+        const BSONObj opObj = elem.Obj();
+        const char* opType = opObj["op"].valuestrsafe();
+        if (*opType == 'n')
+            continue;
+
+        NamespaceString nss(opObj["ns"].String());
+        if (!nss.isValid())
+            return {ErrorCodes::InvalidNamespace, "invalid ns: " + nss.ns()};
+
+        ParallelOp op;
+        op.opObj = opObj;
+        op.nss = std::move(nss);
+        op.opType = opType;
+        ops.push_back(std::move(op));
+    }
+
+    // Whether each namespace may be partitioned by _id, looked up the first time it is seen.
+    StringMap<bool> partitionByIdCache;
+    auto canPartitionById = [&](const NamespaceString& nss) {
+        auto it = partitionByIdCache.find(nss.ns());
+        if (it != partitionByIdCache.end())
+            return it->second;
+
+        bool canPartition = false;
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        if (auto collection = autoColl.getCollection()) {
+            canPartition = !collection->isCapped() && !collection->getDefaultCollator();
+            auto indexIt = collection->getIndexCatalog()->getIndexIterator(opCtx, true);
+            while (canPartition && indexIt.more()) {
+                auto descriptor = indexIt.next();
+                if (descriptor->unique() && !descriptor->isIdIndex())
+                    canPartition = false;
+            }
+        }
+        partitionByIdCache[nss.ns()] = canPartition;
+        return canPartition;
+    };
+
+    const size_t numWriters = static_cast<size_t>(applyOpsParallelWriterThreads);
+    std::vector<std::vector<ParallelOp*>> writerVectors(numWriters);
+    const BSONElementComparator idHasher(BSONElementComparator::FieldNamesMode::kIgnore, nullptr);
+    for (auto&& op : ops) {
+        uint32_t hash = StringMapTraits::hash(op.nss.ns());
+        if (canPartitionById(op.nss)) {
+            // Updates identify their document by the _id in their query.
+            BSONElement doc = op.opObj[*op.opType == 'u' ? "o2" : "o"];
+            BSONElement id = doc.type() == Object ? doc.Obj()["_id"] : BSONElement();
+            if (!id.eoo()) {
+                const size_t idHash = idHasher.hash(id);
+                MurmurHash3_x86_32(&idHash, sizeof(idHash), hash, &hash);
+            }
+        }
+        writerVectors[hash % numWriters].push_back(&op);
+    }
+
+    // Writers check the kill status of this operation, since they do not run under it.
+    auto applyWriterOps = [&](OperationContext* writerOpCtx,
+                              const std::vector<ParallelOp*>& writerOps) {
+        for (auto op : writerOps) {
+            const auto killStatus = opCtx->getKillStatus();
+            if (killStatus != ErrorCodes::OK) {
+                op->status = Status(killStatus, "operation was interrupted");
+                op->threw = true;
+                continue;
+            }
+            try {
+                op->status =
+                    _applyOpNonAtomic(writerOpCtx, op->nss, op->opObj, op->opType, alwaysUpsert);
+            } catch (const DBException& ex) {
+                op->status = ex.toStatus();
+                op->threw = true;
+            }
+        }
+    };
+
+    // Each writer applies its ops under an operation of its own, with the document validation and
+    // replication settings of this one.
+    const bool validationDisabled = documentValidationDisabled(opCtx);
+    const bool writesAreReplicated = opCtx->writesAreReplicated();
+    stdx::mutex mutex;
+    stdx::condition_variable finished;
+    size_t running = 0;
+    for (const auto& writerOps : writerVectors) {
+        if (writerOps.empty())
+            continue;
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++running;
+        }
+        auto scheduleStatus = getWriterPool()->schedule([&] {
+            {
+                auto uniqueWriterOpCtx = cc().makeOperationContext();
+                auto writerOpCtx = uniqueWriterOpCtx.get();
+                documentValidationDisabled(writerOpCtx) = validationDisabled;
+                boost::optional<repl::UnreplicatedWritesBlock> uwb;
+                if (!writesAreReplicated)
+                    uwb.emplace(writerOpCtx);
+                applyWriterOps(writerOpCtx, writerOps);
+            }
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (--running == 0)
+                finished.notify_all();
+        });
+        if (!scheduleStatus.isOK()) {
+            // Apply the ops of this writer under this operation instead, which holds no locks.
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                --running;
+            }
+            applyWriterOps(opCtx, writerOps);
+        }
+    }
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        finished.wait(lk, [&] { return running == 0; });
+    }
+
+    BSONArrayBuilder ab;
+    const ParallelOp* firstThrown = nullptr;
+    int errors = 0;
+    for (const auto& op : ops) {
+        ab.append(op.status.isOK());
+        if (op.status.isOK())
+            continue;
+
+        if (op.threw) {
+            if (!firstThrown)
+                firstThrown = &op;
+        } else {
+            log() << "applyOps error applying: " << op.status;
+        }
+        errors++;
+    }
+
+    *numApplied = ops.size();
+    result->append("applied", *numApplied);
+    if (firstThrown) {
+        result->append("code", firstThrown->status.code());
+        result->append("codeName", ErrorCodes::errorString(firstThrown->status.code()));
+        result->append("errmsg", firstThrown->status.reason());
+    }
+    result->append("results", ab.arr());
+
+    if (firstThrown) {
+        return Status(ErrorCodes::UnknownError, firstThrown->status.reason());
+    }
+    if (errors != 0) {
+        return Status(ErrorCodes::UnknownError, "applyOps had one or more errors applying ops");
+    }
+
+    return Status::OK();
+}
+
 bool _hasPrecondition(const BSONObj& applyOpCmd) {
     return applyOpCmd[kPreconditionFieldName].type() == Array;
 }
@@ -341,6 +601,28 @@ Status applyOps(OperationContext* opCtx,
                 areOpsCrudOnly);
     }
 
+    // {parallel: true} is a hint. Batches which cannot be applied by several threads, including
+    // ops nested in an applyOps being applied under the global lock, are applied serially.
+    bool parallel = false;
+    uassertStatusOK(
+        bsonExtractBooleanFieldWithDefault(applyOpCmd, kParallelFieldName, false, &parallel));
+    if (parallel && !allowAtomic && areOpsCrudOnly && !opCtx->lockState()->isLocked() &&
+        _canApplyInParallel(applyOpCmd)) {
+        {
+            // The writers take their own locks, so this lock must not be held while they run.
+            Lock::DBLock dbLock(opCtx, dbName, MODE_IX);
+            if (opCtx->writesAreReplicated() &&
+                !repl::getGlobalReplicationCoordinator()->canAcceptWritesForDatabase(opCtx,
+                                                                                     dbName)) {
+                return Status(ErrorCodes::NotMaster,
+                              str::stream() << "Not primary while applying ops to database "
+                                            << dbName);
+            }
+        }
+        int numApplied = 0;
+        return _applyOpsParallel(opCtx, applyOpCmd, result, &numApplied);
+    }
+
     boost::optional<Lock::GlobalWrite> globalWriteLock;
     boost::optional<Lock::DBLock> dbWriteLock;
 
@@ -36,6 +36,10 @@ class OperationContext;
 /**
  * Applies ops contained in "applyOpCmd" and populates fields in "result" to be returned to the
  * user.
+ *
+ * With {parallel: true} and {allowAtomic: false}, a batch of CRUD ops is applied by a pool of
+ * writer threads, keeping the ops on a document in order. Batches containing commands or index
+ * builds are applied serially.
  */
 Status applyOps(OperationContext* opCtx,
                 const std::string& dbName,
@@ -105,6 +105,10 @@ MONGO_INITIALIZER(rollbackMethod)(InitializerContext*) {
 // The batchSize to use for the find/getMore queries called by the OplogFetcher
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(bgSyncOplogFetcherBatchSize, int, defaultBatchSize);
 
+// The OplogFetcher streams getMore requests (asks for the next batch before buffering the current
+// one) while the oplog buffer is less than this percent full. Zero disables streaming.
+MONGO_EXPORT_SERVER_PARAMETER(bgSyncOplogFetcherStreamingBufferFillPercent, int, 50);
+
 /**
  * Extends DataReplicatorExternalStateImpl to be member state aware.
  */
@@ -118,6 +122,8 @@ public:
                             const rpc::ReplSetMetadata& replMetadata,
                             boost::optional<rpc::OplogQueryMetadata> oqMetadata) override;
 
+    bool canStreamOplogBatches() const override;
+
 private:
     BackgroundSync* _bgsync;
 };
@@ -140,6 +146,10 @@ bool DataReplicatorExternalStateBackgroundSync::shouldStopFetching(
     return DataReplicatorExternalStateImpl::shouldStopFetching(source, replMetadata, oqMetadata);
 }
 
+bool DataReplicatorExternalStateBackgroundSync::canStreamOplogBatches() const {
+    return _bgsync->canStreamOplogBatches();
+}
+
 size_t getSize(const BSONObj& o) {
     // SERVER-9808 Avoid Fortify complaint about implicit signed->unsigned conversion
     return static_cast<size_t>(o.objsize());
@@ -885,6 +895,20 @@ bool BackgroundSync::shouldStopFetching() const {
     return false;
 }
 
+bool BackgroundSync::canStreamOplogBatches() const {
+    const auto fillPercent = bgSyncOplogFetcherStreamingBufferFillPercent.load();
+    if (fillPercent <= 0) {
+        return false;
+    }
+
+    // Buffers without a size limit never apply backpressure.
+    const auto maxSize = _oplogBuffer->getMaxSize();
+    if (maxSize == 0) {
+        return true;
+    }
+    return _oplogBuffer->getSize() * 100 < maxSize * static_cast<std::size_t>(fillPercent);
+}
+
 void BackgroundSync::pushTestOpToBuffer(OperationContext* opCtx, const BSONObj& op) {
     _oplogBuffer->push(opCtx, op);
     bufferCountGauge.increment();
@@ -135,6 +135,12 @@ public:
      */
     bool shouldStopFetching() const;
 
+    /**
+     * Returns true if the oplog buffer is empty enough for the oplog fetcher to request the next
+     * batch from the sync source before the current one has been buffered.
+     */
+    bool canStreamOplogBatches() const;
+
     ProducerState getState() const;
     // Starts the producer if it's stopped. Otherwise, let it keep running.
     void startProducerIfStopped();
@@ -782,7 +782,14 @@ void CollectionCloner::_insertDocumentsCallback(
     ++_stats.fetchBatches;
     _progressMeter.hit(int(docs.size()));
     invariant(_collLoader);
-    const auto status = _collLoader->insertDocuments(docs.cbegin(), docs.cend());
+    auto collLoader = _collLoader.get();
+
+    // Release the lock while inserting, so the next batch can be buffered from the remote cursors
+    // in the meantime. Inserts are run one at a time by '_dbWorkTaskRunner', and '_collLoader' is
+    // not released before 'onCompletionGuard', which we hold, is.
+    lk.unlock();
+    const auto status = collLoader->insertDocuments(docs.cbegin(), docs.cend());
+    lk.lock();
     if (!status.isOK()) {
         onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, status);
         return;
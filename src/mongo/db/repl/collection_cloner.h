@@ -274,7 +274,9 @@ private:
     NamespaceString _sourceNss;                         // (R)
     NamespaceString _destNss;                           // (R)
     CollectionOptions _options;                         // (R)
-    std::unique_ptr<CollectionBulkLoader> _collLoader;  // (M)
+    // (M) Except that '_insertDocumentsCallback' uses it without the lock while it holds the
+    // completion guard.
+    std::unique_ptr<CollectionBulkLoader> _collLoader;
     CallbackFn _onCompletion;             // (M) Invoked once when cloning completes or fails.
     StorageInterface* _storageInterface;  // (R) Not owned by us.
     RemoteCommandRetryScheduler _countScheduler;  // (S)
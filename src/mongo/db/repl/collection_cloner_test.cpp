@@ -1014,6 +1014,48 @@ TEST_F(CollectionClonerTest, InsertDocumentsSingleBatch) {
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+TEST_F(CollectionClonerTest, InsertDocumentsDoesNotHoldClonerLock) {
+    ASSERT_OK(collectionCloner->startup());
+    ASSERT_TRUE(collectionCloner->isActive());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(0));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->waitForDbWorker();
+    ASSERT_TRUE(collectionStats.initCalled);
+
+    // The cloner's lock must be free while documents are being inserted, so that the next batch
+    // can be received at the same time.
+    ASSERT(_loader != nullptr);
+    bool activeDuringInsert = false;
+    _loader->insertDocsFn = [this, &activeDuringInsert](
+        const std::vector<BSONObj>::const_iterator begin,
+        const std::vector<BSONObj>::const_iterator end) {
+        activeDuringInsert = collectionCloner->isActive();
+        return Status::OK();
+    };
+
+    BSONArray emptyArray;
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCursorResponse(1, emptyArray));
+    }
+    collectionCloner->waitForDbWorker();
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createFinalCursorResponse(BSON_ARRAY(BSON("_id" << 1))));
+    }
+
+    collectionCloner->join();
+    ASSERT_TRUE(activeDuringInsert);
+    ASSERT_EQUALS(1, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+    ASSERT_OK(getStatus());
+}
+
 TEST_F(CollectionClonerTest, InsertDocumentsMultipleBatches) {
     ASSERT_OK(collectionCloner->startup());
     ASSERT_TRUE(collectionCloner->isActive());
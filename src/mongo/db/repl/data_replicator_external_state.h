@@ -106,6 +106,14 @@ public:
                                     const rpc::ReplSetMetadata& replMetadata,
                                     boost::optional<rpc::OplogQueryMetadata> oqMetadata) = 0;
 
+    /**
+     * Returns true if the oplog fetcher may request the next batch from its sync source before
+     * the current batch has been added to the oplog buffer. This is how the oplog buffer applies
+     * backpressure to a streaming oplog fetcher: once the buffer is too full to absorb another
+     * batch, the fetcher falls back to requesting batches one at a time.
+     */
+    virtual bool canStreamOplogBatches() const = 0;
+
     /**
      * This function creates an oplog buffer of the type specified at server startup.
      */
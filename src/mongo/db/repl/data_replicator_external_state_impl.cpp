@@ -105,6 +105,10 @@ bool DataReplicatorExternalStateImpl::shouldStopFetching(
     return false;
 }
 
+bool DataReplicatorExternalStateImpl::canStreamOplogBatches() const {
+    return false;
+}
+
 std::unique_ptr<OplogBuffer> DataReplicatorExternalStateImpl::makeInitialSyncOplogBuffer(
     OperationContext* opCtx) const {
     return _replicationCoordinatorExternalState->makeInitialSyncOplogBuffer(opCtx);
@@ -80,6 +80,10 @@ bool DataReplicatorExternalStateMock::shouldStopFetching(
     return shouldStopFetchingResult;
 }
 
+bool DataReplicatorExternalStateMock::canStreamOplogBatches() const {
+    return canStreamOplogBatchesResult;
+}
+
 std::unique_ptr<OplogBuffer> DataReplicatorExternalStateMock::makeInitialSyncOplogBuffer(
     OperationContext* opCtx) const {
     return stdx::make_unique<OplogBufferBlockingQueue>();
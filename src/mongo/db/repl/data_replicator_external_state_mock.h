@@ -56,6 +56,8 @@ public:
                             const rpc::ReplSetMetadata& replMetadata,
                             boost::optional<rpc::OplogQueryMetadata> oqMetadata) override;
 
+    bool canStreamOplogBatches() const override;
+
     std::unique_ptr<OplogBuffer> makeInitialSyncOplogBuffer(OperationContext* opCtx) const override;
 
     std::unique_ptr<OplogBuffer> makeSteadyStateOplogBuffer(OperationContext* opCtx) const override;
@@ -85,6 +87,9 @@ public:
     // Returned by shouldStopFetching.
     bool shouldStopFetchingResult = false;
 
+    // Returned by canStreamOplogBatches.
+    bool canStreamOplogBatchesResult = false;
+
     // Override to change multiApply behavior.
     MultiApplier::MultiApplyFn multiApplyFn;
 
@@ -59,13 +59,14 @@ struct OplogSlot {
 struct InsertStatement {
 public:
     InsertStatement() = default;
-    explicit InsertStatement(BSONObj toInsert) : doc(toInsert) {}
+    explicit InsertStatement(BSONObj toInsert) : doc(std::move(toInsert)) {}
 
-    InsertStatement(StmtId statementId, BSONObj toInsert) : stmtId(statementId), doc(toInsert) {}
+    InsertStatement(StmtId statementId, BSONObj toInsert)
+        : stmtId(statementId), doc(std::move(toInsert)) {}
     InsertStatement(StmtId statementId, BSONObj toInsert, OplogSlot os)
-        : stmtId(statementId), oplogSlot(os), doc(toInsert) {}
+        : stmtId(statementId), oplogSlot(os), doc(std::move(toInsert)) {}
     InsertStatement(BSONObj toInsert, SnapshotName ts, long long term)
-        : oplogSlot(repl::OpTime(Timestamp(ts.asU64()), term), 0), doc(toInsert) {}
+        : oplogSlot(repl::OpTime(Timestamp(ts.asU64()), term), 0), doc(std::move(toInsert)) {}
 
     StmtId stmtId = kUninitializedStmtId;
     OplogSlot oplogSlot;
@@ -0,0 +1,477 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_file.h"
+
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <snappy.h>
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/encryption_hooks.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/crc32c.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+AtomicUInt32 fileNumber;
+
+OplogBufferFile::Options normalizeOptions(OplogBufferFile::Options options) {
+    if (options.tempDir.empty()) {
+        options.tempDir = storageGlobalParams.dbpath + "/_tmp";
+    }
+    options.prefetchBlocks = std::max(options.prefetchBlocks, std::size_t(1));
+    return options;
+}
+
+EncryptionHooks* getEncryptionHooks() {
+    if (!hasGlobalServiceContext()) {
+        return nullptr;
+    }
+    auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
+    return encryptionHooks->enabled() ? encryptionHooks : nullptr;
+}
+
+}  // namespace
+
+OplogBufferFile::OplogBufferFile(Options options) : _options(normalizeOptions(options)) {
+    StringBuilder sb;
+    sb << _options.tempDir << "/initialSyncOplogBuffer." << fileNumber.fetchAndAdd(1);
+    _fileName = sb.str();
+}
+
+OplogBufferFile::~OplogBufferFile() {
+    DESTRUCTOR_GUARD(shutdown(nullptr););
+}
+
+OplogBufferFile::Options OplogBufferFile::getOptions() const {
+    return _options;
+}
+
+void OplogBufferFile::startup(OperationContext*) {
+    boost::filesystem::create_directories(_options.tempDir);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(!_prefetcher.joinable());
+    _writeFile.open(_fileName.c_str(), std::ios::binary | std::ios::out | std::ios::trunc);
+    _readFile.open(_fileName.c_str(), std::ios::binary | std::ios::in);
+    uassert(40648,
+            str::stream() << "error opening initial sync oplog buffer file \"" << _fileName
+                          << "\": "
+                          << errnoWithDescription(),
+            _writeFile.good() && _readFile.good());
+    _prefetcher = stdx::thread([this] { _prefetch(); });
+}
+
+void OplogBufferFile::shutdown(OperationContext*) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_prefetcher.joinable()) {
+            return;
+        }
+        _inShutdown = true;
+    }
+    _prefetchCV.notify_all();
+    _prefetcher.join();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fillingBlock.clear();
+    _fillingBlockSize = 0;
+    _blocksInFile = 0;
+    _readyBlocks.clear();
+    _count = 0;
+    _size = 0;
+    _lastPushed = boost::none;
+    _writeFile.close();
+    _readFile.close();
+
+    boost::system::error_code ec;
+    boost::filesystem::remove(_fileName, ec);
+}
+
+void OplogBufferFile::pushEvenIfFull(OperationContext*, const Value& value) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _push_inlock(value);
+    }
+    _notEmptyCV.notify_one();
+}
+
+void OplogBufferFile::push(OperationContext* opCtx, const Value& value) {
+    pushEvenIfFull(opCtx, value);
+}
+
+void OplogBufferFile::pushAllNonBlocking(OperationContext*,
+                                         Batch::const_iterator begin,
+                                         Batch::const_iterator end) {
+    if (begin == end) {
+        return;
+    }
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto it = begin; it != end; ++it) {
+            _push_inlock(*it);
+        }
+    }
+    _notEmptyCV.notify_one();
+}
+
+void OplogBufferFile::waitForSpace(OperationContext*, std::size_t) {}
+
+bool OplogBufferFile::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count == 0;
+}
+
+std::size_t OplogBufferFile::getMaxSize() const {
+    return 0;
+}
+
+std::size_t OplogBufferFile::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _size;
+}
+
+std::size_t OplogBufferFile::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count;
+}
+
+void OplogBufferFile::clear(OperationContext*) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    // A block being read still belongs to the file, so let the prefetcher hand it over first.
+    _blockReadyCV.wait(lk, [this] { return _blocksInFlight == 0; });
+    _fillingBlock.clear();
+    _fillingBlockSize = 0;
+    _blocksInFile = 0;
+    _readyBlocks.clear();
+    _count = 0;
+    _size = 0;
+    _lastPushed = boost::none;
+    _resetFile_inlock();
+}
+
+bool OplogBufferFile::tryPop(OperationContext*, Value* value) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (!_ensureFront_inlock(lk)) {
+        return false;
+    }
+
+    auto& block = _readyBlocks.front();
+    *value = std::move(block.front());
+    block.pop_front();
+    if (block.empty()) {
+        _readyBlocks.pop_front();
+        _prefetchCV.notify_one();
+    }
+
+    --_count;
+    _size -= std::size_t(value->objsize());
+    if (_count == 0) {
+        _lastPushed = boost::none;
+        _resetFile_inlock();
+    }
+    return true;
+}
+
+bool OplogBufferFile::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _notEmptyCV.wait_for(
+        lk, waitDuration.toSystemDuration(), [this] { return _count > 0 || _inShutdown; }) &&
+        _count > 0;
+}
+
+bool OplogBufferFile::peek(OperationContext*, Value* value) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (!_ensureFront_inlock(lk)) {
+        return false;
+    }
+    *value = _readyBlocks.front().front();
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferFile::lastObjectPushed(OperationContext*) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _lastPushed;
+}
+
+std::string OplogBufferFile::getFileName_forTest() const {
+    return _fileName;
+}
+
+std::size_t OplogBufferFile::getNumBlocksWritten_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numBlocksWritten;
+}
+
+void OplogBufferFile::_push_inlock(const Value& value) {
+    invariant(_prefetcher.joinable());
+    auto owned = value.getOwned();
+    const auto size = std::size_t(owned.objsize());
+    _fillingBlock.push_back(owned);
+    _fillingBlockSize += size;
+    ++_count;
+    _size += size;
+    _lastPushed = std::move(owned);
+
+    if (_fillingBlockSize >= _options.blockSize) {
+        _completeBlock_inlock();
+    }
+}
+
+void OplogBufferFile::_completeBlock_inlock() {
+    if (_fillingBlock.empty()) {
+        return;
+    }
+
+    // Entries may skip the file only if nothing older than them is still in it.
+    if (_blocksInFile == 0 && _blocksInFlight == 0 &&
+        _readyBlocks.size() < _options.prefetchBlocks) {
+        _readyBlocks.emplace_back(std::make_move_iterator(_fillingBlock.begin()),
+                                  std::make_move_iterator(_fillingBlock.end()));
+    } else {
+        _writeBlock_inlock();
+        ++_blocksInFile;
+        _prefetchCV.notify_one();
+    }
+    _fillingBlock.clear();
+    _fillingBlockSize = 0;
+}
+
+void OplogBufferFile::_writeBlock_inlock() {
+    BufBuilder buffer(static_cast<int>(_fillingBlockSize));
+    for (auto&& value : _fillingBlock) {
+        value.appendSelfToBufBuilder(buffer);
+    }
+
+    // The block format matches the sorter's spill files: the block size, negated if the block is
+    // compressed, followed by the block and a checksum of its bytes as written.
+    int32_t size = buffer.len();
+    const char* outBuffer = buffer.buf();
+
+    std::string compressed;
+    snappy::Compress(outBuffer, size, &compressed);
+    verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
+
+    const bool shouldCompress = compressed.size() < size_t(buffer.len() / 10 * 9);
+    if (shouldCompress) {
+        size = compressed.size();
+        outBuffer = compressed.data();
+    }
+
+    std::unique_ptr<char[]> out;
+    if (auto encryptionHooks = getEncryptionHooks()) {
+        size_t protectedSizeMax = size + encryptionHooks->additionalBytesForProtectedBuffer();
+        out.reset(new char[protectedSizeMax]);
+        size_t resultLen;
+        Status status = encryptionHooks->protectTmpData(reinterpret_cast<const uint8_t*>(outBuffer),
+                                                        size,
+                                                        reinterpret_cast<uint8_t*>(out.get()),
+                                                        protectedSizeMax,
+                                                        &resultLen);
+        uassert(40649,
+                str::stream() << "Failed to protect initial sync oplog buffer data: "
+                              << status.toString(),
+                status.isOK());
+        outBuffer = out.get();
+        size = resultLen;
+    }
+
+    const uint32_t checksum = crc32c(outBuffer, size);
+    const int32_t rawSize = shouldCompress ? -size : size;
+    _writeFile.write(reinterpret_cast<const char*>(&rawSize), sizeof(rawSize));
+    _writeFile.write(outBuffer, size);
+    _writeFile.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+    // The prefetcher reads through a separate stream, so the block must reach the file before the
+    // prefetcher is told about it.
+    _writeFile.flush();
+    uassert(40650,
+            str::stream() << "error writing to initial sync oplog buffer file \"" << _fileName
+                          << "\": "
+                          << errnoWithDescription(),
+            _writeFile.good());
+
+    _fileSize += sizeof(rawSize) + size + sizeof(checksum);
+    ++_numBlocksWritten;
+}
+
+bool OplogBufferFile::_ensureFront_inlock(stdx::unique_lock<stdx::mutex>& lk) {
+    while (_readyBlocks.empty()) {
+        if (_blocksInFile == 0 && _blocksInFlight == 0) {
+            if (_fillingBlock.empty()) {
+                invariant(_count == 0);
+                return false;
+            }
+            // The popper has caught up with the file, so take the block being filled directly.
+            _completeBlock_inlock();
+            continue;
+        }
+        uassertStatusOK(_prefetchStatus);
+        _blockReadyCV.wait(lk);
+    }
+    return true;
+}
+
+void OplogBufferFile::_resetFile_inlock() {
+    invariant(_blocksInFile == 0 && _blocksInFlight == 0);
+    if (_fileSize == 0 || !_writeFile.is_open()) {
+        return;
+    }
+    _writeFile.close();
+    _readFile.close();
+    _writeFile.open(_fileName.c_str(), std::ios::binary | std::ios::out | std::ios::trunc);
+    _readFile.open(_fileName.c_str(), std::ios::binary | std::ios::in);
+    uassert(40651,
+            str::stream() << "error truncating initial sync oplog buffer file \"" << _fileName
+                          << "\": "
+                          << errnoWithDescription(),
+            _writeFile.good() && _readFile.good());
+    _fileSize = 0;
+}
+
+void OplogBufferFile::_prefetch() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        _prefetchCV.wait(lk, [this] {
+            return _inShutdown ||
+                (_blocksInFile > 0 && _readyBlocks.size() < _options.prefetchBlocks);
+        });
+        if (_inShutdown) {
+            return;
+        }
+
+        --_blocksInFile;
+        ++_blocksInFlight;
+        lk.unlock();
+
+        Block block;
+        Status status = Status::OK();
+        try {
+            block = _readBlock();
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        lk.lock();
+        --_blocksInFlight;
+        if (!status.isOK()) {
+            _prefetchStatus = status;
+            _blockReadyCV.notify_all();
+            return;
+        }
+        _readyBlocks.push_back(std::move(block));
+        _blockReadyCV.notify_all();
+    }
+}
+
+OplogBufferFile::Block OplogBufferFile::_readBlock() {
+    auto read = [this](void* out, std::size_t size) {
+        _readFile.read(reinterpret_cast<char*>(out), size);
+        uassert(40652,
+                str::stream() << "error reading initial sync oplog buffer file \"" << _fileName
+                              << "\": "
+                              << errnoWithDescription(),
+                _readFile.good() && _readFile.gcount() == std::streamsize(size));
+    };
+
+    int32_t rawSize;
+    read(&rawSize, sizeof(rawSize));
+
+    // negative size means compressed
+    const bool compressed = rawSize < 0;
+    std::size_t blockSize = std::abs(rawSize);
+
+    std::unique_ptr<char[]> buffer(new char[blockSize]);
+    read(buffer.get(), blockSize);
+
+    uint32_t checksum;
+    read(&checksum, sizeof(checksum));
+    uassert(40653,
+            str::stream() << "checksum mismatch in block of initial sync oplog buffer file \""
+                          << _fileName
+                          << "\"",
+            checksum == crc32c(buffer.get(), blockSize));
+
+    if (auto encryptionHooks = getEncryptionHooks()) {
+        std::unique_ptr<char[]> out(new char[blockSize]);
+        size_t outLen;
+        Status status = encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(buffer.get()),
+                                                          blockSize,
+                                                          reinterpret_cast<uint8_t*>(out.get()),
+                                                          blockSize,
+                                                          &outLen);
+        uassert(40654,
+                str::stream() << "Failed to unprotect initial sync oplog buffer data: "
+                              << status.toString(),
+                status.isOK());
+        blockSize = outLen;
+        buffer.swap(out);
+    }
+
+    if (compressed) {
+        size_t uncompressedSize;
+        uassert(40655,
+                "couldn't get uncompressed length of initial sync oplog buffer block",
+                snappy::GetUncompressedLength(buffer.get(), blockSize, &uncompressedSize));
+        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+        uassert(40656,
+                "decompression of initial sync oplog buffer block failed",
+                snappy::RawUncompress(buffer.get(), blockSize, decompressionBuffer.get()));
+        buffer.swap(decompressionBuffer);
+        blockSize = uncompressedSize;
+    }
+
+    Block block;
+    const char* data = buffer.get();
+    const char* const end = data + blockSize;
+    while (data < end) {
+        BSONObj obj(data);
+        block.push_back(obj.getOwned());
+        data += obj.objsize();
+    }
+    return block;
+}
+
+}  // namespace repl
+}  // namespace mongo
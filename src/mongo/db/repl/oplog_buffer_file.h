@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer backed by an append-only temporary file. Entries are accumulated in memory into
+ * blocks; a full block is handed straight to the popper when it has caught up, and otherwise is
+ * compressed and appended to the file. A background thread reads the file sequentially ahead of
+ * the popper so that popping rarely waits on disk. The file is created in startup() and removed in
+ * shutdown(), and is truncated whenever the buffer drains.
+ *
+ * Unlike OplogBufferCollection, nothing is written through the storage engine, so buffering the
+ * oplog during initial sync does not compete with the data clone for storage engine cache.
+ */
+class OplogBufferFile final : public OplogBuffer {
+public:
+    /**
+     * Structure used to configure an instance of OplogBufferFile.
+     */
+    struct Options {
+        // Directory holding the buffer file. If empty, the "_tmp" directory under the dbpath is
+        // used.
+        std::string tempDir;
+
+        // Entries are grouped into blocks of at least this many bytes, as measured by
+        // BSONObj::objsize(), before being compressed and written out.
+        std::size_t blockSize = 1024 * 1024;
+
+        // Maximum number of blocks held in memory ready to be popped. If equal to 0, this will be
+        // set to 1.
+        std::size_t prefetchBlocks = 2;
+
+        Options() {}
+    };
+
+    explicit OplogBufferFile(Options options = Options());
+    ~OplogBufferFile();
+
+    /**
+     * Returns the options for this oplog buffer.
+     */
+    Options getOptions() const;
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+    // ---- Testing API ----
+    std::string getFileName_forTest() const;
+    std::size_t getNumBlocksWritten_forTest() const;
+
+private:
+    using Block = std::deque<Value>;
+
+    /**
+     * Adds a single entry to the block being filled, completing the block if it is full.
+     */
+    void _push_inlock(const Value& value);
+
+    /**
+     * Hands the block being filled to the popper, or appends it to the file if the popper has
+     * not caught up with the entries already written out.
+     */
+    void _completeBlock_inlock();
+
+    /**
+     * Compresses the block being filled and appends it to the file.
+     */
+    void _writeBlock_inlock();
+
+    /**
+     * Makes sure the next entry to pop is in memory, waiting for the prefetcher if necessary.
+     * Returns false if the buffer is empty.
+     */
+    bool _ensureFront_inlock(stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Truncates the file and resets the read and write positions. The prefetcher must not be
+     * reading.
+     */
+    void _resetFile_inlock();
+
+    /**
+     * Body of the prefetcher thread.
+     */
+    void _prefetch();
+
+    /**
+     * Reads and decompresses the next block of the file. Only called by the prefetcher, without
+     * holding the mutex.
+     */
+    Block _readBlock();
+
+    const Options _options;
+    std::string _fileName;
+
+    // Guards all members below, except for '_readFile' which is only accessed by the prefetcher
+    // while it has a block in flight, and by _resetFile_inlock() while it does not.
+    mutable stdx::mutex _mutex;
+
+    // Signalled when the prefetcher may have more work to do.
+    stdx::condition_variable _prefetchCV;
+
+    // Signalled when the prefetcher delivers a block or fails.
+    stdx::condition_variable _blockReadyCV;
+
+    // Signalled when an entry is pushed.
+    stdx::condition_variable _notEmptyCV;
+
+    std::ofstream _writeFile;
+    std::ifstream _readFile;
+    stdx::thread _prefetcher;
+    bool _inShutdown = false;
+
+    // Entries pushed since the last block was completed.
+    std::vector<Value> _fillingBlock;
+    std::size_t _fillingBlockSize = 0;
+
+    // Blocks written to the file which the prefetcher has not started reading yet.
+    std::size_t _blocksInFile = 0;
+
+    // Blocks the prefetcher is reading. This is at most 1.
+    std::size_t _blocksInFlight = 0;
+
+    // Blocks ready to be popped, oldest first.
+    std::deque<Block> _readyBlocks;
+
+    // Set if the prefetcher failed to read a block. Reported to the popper.
+    Status _prefetchStatus = Status::OK();
+
+    std::size_t _count = 0;
+    std::size_t _size = 0;
+    std::size_t _fileSize = 0;
+    std::size_t _numBlocksWritten = 0;
+    boost::optional<Value> _lastPushed;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,279 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_file.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+class OplogBufferFileTest : public unittest::Test {
+protected:
+    /**
+     * Returns options that write a block to the file for every few entries.
+     */
+    OplogBufferFile::Options makeOptions(std::size_t prefetchBlocks = 1);
+
+    unittest::TempDir _tempDir{"oplogBufferFileTest"};
+};
+
+OplogBufferFile::Options OplogBufferFileTest::makeOptions(std::size_t prefetchBlocks) {
+    OplogBufferFile::Options options;
+    options.tempDir = _tempDir.path();
+    options.blockSize = 500;
+    options.prefetchBlocks = prefetchBlocks;
+    return options;
+}
+
+/**
+ * Generates oplog entries with the given number used for the timestamp.
+ */
+BSONObj makeOplogEntry(int t) {
+    return BSON("ts" << Timestamp(t, t) << "h" << t << "ns"
+                     << "a.a"
+                     << "v"
+                     << 2
+                     << "op"
+                     << "i"
+                     << "o"
+                     << BSON("_id" << t << "a" << t));
+}
+
+TEST_F(OplogBufferFileTest, EmptyTempDirDefaultsToDbpath) {
+    OplogBufferFile oplogBuffer;
+    ASSERT_FALSE(oplogBuffer.getOptions().tempDir.empty());
+    ASSERT_EQUALS(1U, OplogBufferFile([] {
+                          OplogBufferFile::Options options;
+                          options.prefetchBlocks = 0;
+                          return options;
+                      }())
+                          .getOptions()
+                          .prefetchBlocks);
+}
+
+TEST_F(OplogBufferFileTest, StartupCreatesFileAndShutdownRemovesIt) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    ASSERT_FALSE(boost::filesystem::exists(oplogBuffer.getFileName_forTest()));
+    oplogBuffer.startup(nullptr);
+    ASSERT_TRUE(boost::filesystem::exists(oplogBuffer.getFileName_forTest()));
+    oplogBuffer.shutdown(nullptr);
+    ASSERT_FALSE(boost::filesystem::exists(oplogBuffer.getFileName_forTest()));
+}
+
+TEST_F(OplogBufferFileTest, PopAndPeekWithNoDocumentsReturnFalse) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    oplogBuffer.startup(nullptr);
+
+    BSONObj doc;
+    ASSERT_FALSE(oplogBuffer.peek(nullptr, &doc));
+    ASSERT_FALSE(oplogBuffer.tryPop(nullptr, &doc));
+    ASSERT_TRUE(doc.isEmpty());
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_FALSE(oplogBuffer.lastObjectPushed(nullptr));
+    ASSERT_EQUALS(0U, oplogBuffer.getMaxSize());
+}
+
+TEST_F(OplogBufferFileTest, PushOneDocumentAddsDocument) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    oplogBuffer.startup(nullptr);
+
+    const auto oplog = makeOplogEntry(1);
+    oplogBuffer.push(nullptr, oplog);
+    ASSERT_FALSE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(1U, oplogBuffer.getCount());
+    ASSERT_EQUALS(std::size_t(oplog.objsize()), oplogBuffer.getSize());
+    ASSERT_BSONOBJ_EQ(oplog, *oplogBuffer.lastObjectPushed(nullptr));
+
+    BSONObj doc;
+    ASSERT_TRUE(oplogBuffer.peek(nullptr, &doc));
+    ASSERT_BSONOBJ_EQ(oplog, doc);
+    ASSERT_EQUALS(1U, oplogBuffer.getCount());
+
+    ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+    ASSERT_BSONOBJ_EQ(oplog, doc);
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0U, oplogBuffer.getSize());
+    ASSERT_FALSE(oplogBuffer.lastObjectPushed(nullptr));
+}
+
+TEST_F(OplogBufferFileTest, PopReturnsDocumentsInOrderAcrossBlocksWrittenToFile) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    oplogBuffer.startup(nullptr);
+
+    const int numEntries = 200;
+    OplogBuffer::Batch oplog;
+    for (int i = 0; i < numEntries; ++i) {
+        oplog.push_back(makeOplogEntry(i));
+    }
+    std::size_t totalSize = 0;
+    for (auto&& entry : oplog) {
+        totalSize += std::size_t(entry.objsize());
+    }
+
+    // Only a single block may stay in memory ahead of the popper, so most of these must go
+    // through the file.
+    oplogBuffer.pushAllNonBlocking(nullptr, oplog.begin(), oplog.end());
+    ASSERT_EQUALS(std::size_t(numEntries), oplogBuffer.getCount());
+    ASSERT_EQUALS(totalSize, oplogBuffer.getSize());
+    ASSERT_GREATER_THAN(oplogBuffer.getNumBlocksWritten_forTest(), 1U);
+    ASSERT_GREATER_THAN(boost::filesystem::file_size(oplogBuffer.getFileName_forTest()), 0U);
+
+    for (int i = 0; i < numEntries; ++i) {
+        BSONObj doc;
+        ASSERT_TRUE(oplogBuffer.peek(nullptr, &doc));
+        ASSERT_BSONOBJ_EQ(oplog[i], doc);
+        ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+        ASSERT_BSONOBJ_EQ(oplog[i], doc);
+    }
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+
+    // The file is truncated once the buffer drains.
+    ASSERT_EQUALS(0U, boost::filesystem::file_size(oplogBuffer.getFileName_forTest()));
+}
+
+TEST_F(OplogBufferFileTest, InterleavedPushAndPopReturnDocumentsInOrder) {
+    OplogBufferFile oplogBuffer(makeOptions(2));
+    oplogBuffer.startup(nullptr);
+
+    int pushed = 0;
+    int popped = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 15; ++i) {
+            oplogBuffer.push(nullptr, makeOplogEntry(pushed++));
+        }
+        for (int i = 0; i < 10; ++i) {
+            BSONObj doc;
+            ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+            ASSERT_BSONOBJ_EQ(makeOplogEntry(popped++), doc);
+        }
+    }
+    BSONObj doc;
+    while (oplogBuffer.tryPop(nullptr, &doc)) {
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(popped++), doc);
+    }
+    ASSERT_EQUALS(pushed, popped);
+}
+
+TEST_F(OplogBufferFileTest, SentinelsAreReturnedInOrder) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    oplogBuffer.startup(nullptr);
+
+    OplogBuffer::Batch oplog;
+    for (int i = 0; i < 50; ++i) {
+        oplog.push_back(i % 7 == 0 ? BSONObj() : makeOplogEntry(i));
+    }
+    oplogBuffer.pushAllNonBlocking(nullptr, oplog.begin(), oplog.end());
+
+    for (auto&& expected : oplog) {
+        BSONObj doc;
+        ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+        ASSERT_BSONOBJ_EQ(expected, doc);
+    }
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+}
+
+TEST_F(OplogBufferFileTest, ClearClearsBufferAndFile) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    oplogBuffer.startup(nullptr);
+
+    for (int i = 0; i < 100; ++i) {
+        oplogBuffer.push(nullptr, makeOplogEntry(i));
+    }
+    oplogBuffer.clear(nullptr);
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0U, oplogBuffer.getSize());
+    ASSERT_FALSE(oplogBuffer.lastObjectPushed(nullptr));
+    ASSERT_EQUALS(0U, boost::filesystem::file_size(oplogBuffer.getFileName_forTest()));
+
+    BSONObj doc;
+    ASSERT_FALSE(oplogBuffer.tryPop(nullptr, &doc));
+
+    const auto oplog = makeOplogEntry(1000);
+    oplogBuffer.push(nullptr, oplog);
+    ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+    ASSERT_BSONOBJ_EQ(oplog, doc);
+}
+
+TEST_F(OplogBufferFileTest, WaitForDataBlocksAndFindsDocument) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    oplogBuffer.startup(nullptr);
+
+    const auto oplog = makeOplogEntry(1);
+    bool success = false;
+    stdx::thread peekingThread([&] { success = oplogBuffer.waitForData(Seconds(30)); });
+
+    oplogBuffer.push(nullptr, oplog);
+    peekingThread.join();
+    ASSERT_TRUE(success);
+
+    BSONObj doc;
+    ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+    ASSERT_BSONOBJ_EQ(oplog, doc);
+}
+
+TEST_F(OplogBufferFileTest, WaitForDataTimesOutWhenItDoesNotFindDocument) {
+    OplogBufferFile oplogBuffer(makeOptions());
+    oplogBuffer.startup(nullptr);
+    ASSERT_FALSE(oplogBuffer.waitForData(Seconds(1)));
+}
+
+TEST_F(OplogBufferFileTest, ConcurrentPushAndPopReturnDocumentsInOrder) {
+    OplogBufferFile oplogBuffer(makeOptions(2));
+    oplogBuffer.startup(nullptr);
+
+    const int numEntries = 5000;
+    stdx::thread pushingThread([&] {
+        for (int i = 0; i < numEntries; ++i) {
+            oplogBuffer.push(nullptr, makeOplogEntry(i));
+        }
+    });
+
+    int popped = 0;
+    while (popped < numEntries) {
+        BSONObj doc;
+        if (!oplogBuffer.waitForData(Seconds(30))) {
+            break;
+        }
+        while (oplogBuffer.tryPop(nullptr, &doc)) {
+            ASSERT_BSONOBJ_EQ(makeOplogEntry(popped++), doc);
+        }
+    }
+    pushingThread.join();
+    ASSERT_EQUALS(numEntries, popped);
+}
+
+}  // namespace
@@ -392,6 +392,23 @@ Milliseconds OplogFetcher::_getGetMoreMaxTime() const {
     return _awaitDataTimeout;
 }
 
+BSONObj OplogFetcher::_makeStreamingGetMoreCommandObject(
+    const Fetcher::QueryResponse& queryResponse) const {
+    if (!_dataReplicatorExternalState->canStreamOplogBatches()) {
+        return BSONObj();
+    }
+
+    // The term and commit point sent with a streamed getMore lag behind by the batch that has
+    // not been processed yet. Both are advisory, so this only delays their propagation.
+    auto lastCommittedWithCurrentTerm =
+        _dataReplicatorExternalState->getCurrentTermAndLastCommittedOpTime();
+    return makeGetMoreCommandObject(queryResponse.nss,
+                                    queryResponse.cursorId,
+                                    lastCommittedWithCurrentTerm,
+                                    _getGetMoreMaxTime(),
+                                    _batchSize);
+}
+
 StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) {
 
     // Stop fetching and return on fail point.
@@ -480,7 +497,8 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
 
-    // TODO: back pressure handling will be added in SERVER-23499.
+    // Backpressure from the oplog buffer is applied by _makeStreamingGetMoreCommandObject and by
+    // the enqueue function blocking until the buffer has space.
     auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
     if (!status.isOK()) {
         return status;
@@ -157,6 +157,14 @@ private:
      */
     StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) override;
 
+    /**
+     * Streams the `getMore` for the next batch while the oplog buffer has room for it, so that
+     * the sync source runs the next awaitData `getMore` while this batch is being validated and
+     * buffered. Once the buffer fills up, batches are requested one at a time again.
+     */
+    BSONObj _makeStreamingGetMoreCommandObject(
+        const Fetcher::QueryResponse& queryResponse) const override;
+
     // The metadata object sent with the Fetcher queries.
     const BSONObj _metadataObject;
 
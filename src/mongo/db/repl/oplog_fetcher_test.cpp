@@ -806,6 +806,15 @@ TEST_F(
                       request.cmdObj["lastKnownCommittedOpTime"].Obj())));
 }
 
+TEST_F(OplogFetcherTest, StreamedGetMoreRequestMatchesGetMoreSentAfterProcessingBatch) {
+    dataReplicatorExternalState->canStreamOplogBatchesResult = true;
+    auto request = testTwoBatchHandling(true);
+    ASSERT_EQUALS(dataReplicatorExternalState->currentTerm, request.cmdObj["term"].numberLong());
+    ASSERT_EQUALS(dataReplicatorExternalState->lastCommittedOpTime,
+                  unittest::assertGet(OpTime::parseFromOplogEntry(
+                      request.cmdObj["lastKnownCommittedOpTime"].Obj())));
+}
+
 TEST_F(OplogFetcherTest,
        GetMoreRequestUnderProtocolVersionZeroDoesNotIncludeTermOrLastKnownCommittedOpTime) {
     auto request = testTwoBatchHandling(false);
@@ -39,6 +39,7 @@ namespace repl {
 
 extern int maxSyncSourceLagSecs;
 extern double replElectionTimeoutOffsetLimitFraction;
+extern int syncSourceFanoutPenaltyMillis;
 
 class ReplSettings {
 public:
@@ -37,6 +37,7 @@ namespace repl {
 
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(maxSyncSourceLagSecs, int, 30);
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replElectionTimeoutOffsetLimitFraction, double, 0.15);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(syncSourceFanoutPenaltyMillis, int, 0);
 
 MONGO_INITIALIZER(replSettingsCheck)(InitializerContext*) {
     if (maxSyncSourceLagSecs < 1) {
@@ -45,6 +46,9 @@ MONGO_INITIALIZER(replSettingsCheck)(InitializerContext*) {
     if (replElectionTimeoutOffsetLimitFraction <= 0.01) {
         return Status(ErrorCodes::BadValue, "electionTimeoutOffsetLimitFraction must be > 0.01");
     }
+    if (syncSourceFanoutPenaltyMillis < 0) {
+        return Status(ErrorCodes::BadValue, "syncSourceFanoutPenaltyMillis must be >= 0");
+    }
     return Status::OK();
 }
 }
@@ -62,6 +62,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_buffer_collection.h"
+#include "mongo/db/repl/oplog_buffer_file.h"
 #include "mongo/db/repl/oplog_buffer_proxy.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
@@ -121,14 +122,15 @@ const char tsFieldName[] = "ts";
 
 const char kCollectionOplogBufferName[] = "collection";
 const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kFileOplogBufferName[] = "file";
 
 // Set this to true to force background creation of snapshots even if --enableMajorityReadConcern
 // isn't specified. This can be used for A-B benchmarking to find how much overhead
 // repl::SnapshotThread introduces.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(enableReplSnapshotThread, bool, false);
 
-// Set this to specify whether to use a collection to buffer the oplog on the destination server
-// during initial sync to prevent rolling over the oplog.
+// Set this to specify whether to use a collection or a compressed temporary file to buffer the
+// oplog on the destination server during initial sync to prevent rolling over the oplog.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBuffer,
                                       std::string,
                                       kCollectionOplogBufferName);
@@ -136,6 +138,9 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBuffer,
 // Set this to specify size of read ahead buffer in the OplogBufferCollection.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBufferPeekCacheSize, int, 10000);
 
+// Set this to specify the number of blocks the OplogBufferFile reads ahead of the applier.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBufferPrefetchBlocks, int, 2);
+
 // Set this to specify maximum number of times the oplog fetcher will consecutively restart the
 // oplog tailing query on non-cancellation errors.
 server_parameter_storage_type<int, ServerParameterType::kStartupAndRuntime>::value_type
@@ -165,7 +170,8 @@ Status ExportedOplogFetcherMaxFetcherRestartsServerParameter::validate(
 
 MONGO_INITIALIZER(initialSyncOplogBuffer)(InitializerContext*) {
     if ((initialSyncOplogBuffer != kCollectionOplogBufferName) &&
-        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName)) {
+        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (initialSyncOplogBuffer != kFileOplogBufferName)) {
         return Status(ErrorCodes::BadValue,
                       "unsupported initial sync oplog buffer option: " + initialSyncOplogBuffer);
     }
@@ -651,6 +657,7 @@ void ReplicationCoordinatorExternalStateImpl::shardingOnStepDownHook() {
     } else if (ShardingState::get(_service)->enabled()) {
         invariant(serverGlobalParams.clusterRole == ClusterRole::ShardServer);
         ShardingState::get(_service)->interruptChunkSplitter();
+        ShardingState::get(_service)->interruptCollectionMetadataWarmUp();
         CatalogCacheLoader::get(_service).onStepDown();
         PeriodicBalancerSettingsRefresher::get(_service)->stop();
     }
@@ -750,6 +757,13 @@ void ReplicationCoordinatorExternalStateImpl::_shardingOnTransitionToPrimaryHook
     // There is a slight chance that some stale metadata might have been loaded before the latest
     // optime has been recovered, so throw out everything that we have up to now
     ShardingState::get(opCtx)->markCollectionsNotShardedAtStepdown();
+
+    // Reload it in the background from the persisted routing metadata, rather than on the first
+    // versioned request for each collection
+    if (serverGlobalParams.clusterRole == ClusterRole::ShardServer &&
+        ShardingState::get(opCtx)->enabled()) {
+        ShardingState::get(opCtx)->initiateCollectionMetadataWarmUp();
+    }
 }
 
 void ReplicationCoordinatorExternalStateImpl::signalApplierToChooseNewSyncSource() {
@@ -885,6 +899,11 @@ std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeInitia
         options.peekCacheSize = std::size_t(initialSyncOplogBufferPeekCacheSize);
         return stdx::make_unique<OplogBufferProxy>(
             stdx::make_unique<OplogBufferCollection>(StorageInterface::get(opCtx), options));
+    } else if (initialSyncOplogBuffer == kFileOplogBufferName) {
+        invariant(initialSyncOplogBufferPrefetchBlocks >= 0);
+        OplogBufferFile::Options options;
+        options.prefetchBlocks = std::size_t(initialSyncOplogBufferPrefetchBlocks);
+        return stdx::make_unique<OplogBufferFile>(options);
     } else {
         return stdx::make_unique<OplogBufferBlockingQueue>();
     }
@@ -242,51 +242,77 @@ private:
     Waiter* _waiter;
 };
 
+ReplicationCoordinatorImpl::WaiterList::WaiterGroupKey
+ReplicationCoordinatorImpl::WaiterList::_groupKeyOf(WaiterType waiter) {
+    if (!waiter->writeConcern) {
+        return WaiterGroupKey();
+    }
+    return WaiterGroupKey(static_cast<int>(waiter->writeConcern->syncMode),
+                          waiter->writeConcern->wNumNodes,
+                          waiter->writeConcern->wMode);
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    _groups[_groupKeyOf(waiter)].emplace(waiter->opTime, waiter);
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveIf_inlock(
     stdx::function<bool(WaiterType)> func) {
-    // Only advance iterator when the element doesn't match.
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
+    std::vector<WaiterType> ready;
+    for (auto groupIt = _groups.begin(); groupIt != _groups.end();) {
+        auto& group = groupIt->second;
+
+        // The condition is monotonic in opTime, so the waiters to signal are a prefix of the group.
+        auto it = group.begin();
+        while (it != group.end() && func(it->second)) {
+            ready.push_back(it->second);
             ++it;
-            continue;
         }
+        group.erase(group.begin(), it);
 
-        WaiterType waiter = std::move(*it);
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
+        if (group.empty()) {
+            groupIt = _groups.erase(groupIt);
         } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+            ++groupIt;
         }
+    }
 
-        // It's important to call notify() after the waiter has been removed from the list
-        // since notify() might remove the waiter itself.
+    // It's important to call notify() after the waiters have been removed from the list since
+    // notify() might remove the waiter itself.
+    for (auto& waiter : ready) {
         waiter->notify_inlock();
     }
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveAll_inlock() {
-    std::vector<WaiterType> list = std::move(_list);
+    auto groups = std::move(_groups);
+    _groups.clear();
     // Call notify() after removing the waiters from the list.
-    for (auto& waiter : list) {
-        waiter->notify_inlock();
+    for (auto& group : groups) {
+        for (auto& entry : group.second) {
+            entry.second->notify_inlock();
+        }
     }
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+    auto groupIt = _groups.find(_groupKeyOf(waiter));
+    if (groupIt == _groups.end()) {
+        return false;
+    }
+
+    auto& group = groupIt->second;
+    auto range = group.equal_range(waiter->opTime);
+    auto it = std::find_if(
+        range.first, range.second, [waiter](const auto& entry) { return entry.second == waiter; });
+    if (it == range.second) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
+
+    group.erase(it);
+    if (group.empty()) {
+        _groups.erase(groupIt);
+    }
     return true;
 }
 
@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -509,6 +512,9 @@ private:
 
     class WaiterGuard;
 
+    // Waiters are grouped by write concern, and ordered by opTime within a group, so that waking
+    // the waiters whose opTime has been reached only looks at the waiters which get woken up and
+    // at one more waiter per group.
     class WaiterList {
     public:
         using WaiterType = Waiter*;
@@ -517,13 +523,21 @@ private:
         void add_inlock(WaiterType waiter);
         // Returns whether waiter is found and removed.
         bool remove_inlock(WaiterType waiter);
-        // Signals and removes all waiters that satisfy the condition.
+        // Signals and removes all waiters that satisfy the condition. The condition must be
+        // monotonic in the waiter's opTime for a given write concern: if it holds for a waiter, it
+        // must hold for all waiters with the same write concern and an earlier opTime.
         void signalAndRemoveIf_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals and removes all waiters from the list.
         void signalAndRemoveAll_inlock();
 
     private:
-        std::vector<WaiterType> _list;
+        // The parts of a write concern which decide whether a waiter is done waiting.
+        using WaiterGroupKey = std::tuple<int, int, std::string>;
+        using WaiterGroup = std::multimap<OpTime, WaiterType>;
+
+        static WaiterGroupKey _groupKeyOf(WaiterType waiter);
+
+        std::map<WaiterGroupKey, WaiterGroup> _groups;
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
@@ -1062,6 +1076,13 @@ private:
      */
     void _cancelAndRescheduleElectionTimeout_inlock();
 
+    /**
+     * Moves the pending election timeout earlier, to primaryUnreachableElectionTimeoutMillis from
+     * "now", after heartbeats have shown the current primary to be unreachable. Does nothing when
+     * that parameter is unset, no election timeout is scheduled, or it is already due sooner.
+     */
+    void _expediteElectionTimeout_inlock(Date_t now);
+
     /**
      * Callback which starts an election if this node is electable and using protocolVersion 1.
      */
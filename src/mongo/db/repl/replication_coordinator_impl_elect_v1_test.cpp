@@ -40,10 +40,12 @@
 #include "mongo/db/repl/replication_coordinator_impl.h"
 #include "mongo/db/repl/replication_coordinator_test_fixture.h"
 #include "mongo/db/repl/topology_coordinator_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -54,6 +56,12 @@ using executor::RemoteCommandRequest;
 using executor::RemoteCommandResponse;
 using ApplierState = ReplicationCoordinator::ApplierState;
 
+void setParameter(StringData name, StringData value) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find(name.toString());
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString(value.toString()));
+}
+
 TEST_F(ReplCoordTest, RandomizedElectionOffsetWithinProperBounds) {
     BSONObj configObj = BSON("_id"
                              << "mySet"
@@ -1023,6 +1031,69 @@ TEST_F(TakeoverTest, SchedulesCatchupTakeoverIfNodeIsFresherThanCurrentPrimary)
     ASSERT_EQUALS(config.getCatchUpTakeoverDelay(), catchupTakeoverDelay);
 }
 
+TEST_F(TakeoverTest, UnreachablePrimaryMovesElectionTimeoutEarlier) {
+    setParameter("primaryUnreachableElectionTimeoutMillis", "500");
+    ON_BLOCK_EXIT([] { setParameter("primaryUnreachableElectionTimeoutMillis", "0"); });
+
+    BSONObj configObj = BSON("_id"
+                             << "mySet"
+                             << "version"
+                             << 1
+                             << "members"
+                             << BSON_ARRAY(BSON("_id" << 1 << "host"
+                                                      << "node1:12345")
+                                           << BSON("_id" << 2 << "host"
+                                                         << "node2:12345")
+                                           << BSON("_id" << 3 << "host"
+                                                         << "node3:12345"))
+                             << "protocolVersion"
+                             << 1);
+    assertStartSuccess(configObj, HostAndPort("node1", 12345));
+    ReplSetConfig config = assertMakeRSConfig(configObj);
+
+    auto replCoord = getReplCoord();
+    auto now = getNet()->now();
+
+    OpTime currentOptime(Timestamp(200, 1), 0);
+    replCoord->setMyLastAppliedOpTime(currentOptime);
+    replCoord->setMyLastDurableOpTime(currentOptime);
+    ASSERT_OK(replCoord->setFollowerMode(MemberState::RS_SECONDARY));
+
+    // Hearing from the primary pushes the election timeout a full period out.
+    now = respondToHeartbeatsUntil(config, now, HostAndPort("node2", 12345), currentOptime);
+    ASSERT_GREATER_THAN_OR_EQUALS(replCoord->getElectionTimeout_forTest(),
+                                  now + config.getElectionTimeoutPeriod());
+
+    // The next heartbeat to the primary and both of its retries are refused.
+    auto net = getNet();
+    net->enterNetwork();
+    const auto heartbeatTime = now + config.getHeartbeatInterval();
+    net->runUntil(heartbeatTime);
+    int failures = 0;
+    while (net->hasReadyRequests()) {
+        auto noi = net->getNextReadyRequest();
+        if (noi->getRequest().target == HostAndPort("node2", 12345)) {
+            ++failures;
+            net->scheduleResponse(
+                noi, net->now(), Status(ErrorCodes::HostUnreachable, "Connection refused"));
+        } else {
+            net->blackHole(noi);
+        }
+        net->runReadyNetworkOperations();
+    }
+    net->exitNetwork();
+    ASSERT_EQUALS(3, failures);
+
+    // The shortened timeout carries a random offset scaled down to the 500ms delay.
+    auto electionTimeoutWhen = replCoord->getElectionTimeout_forTest();
+    ASSERT_GREATER_THAN_OR_EQUALS(electionTimeoutWhen, heartbeatTime + Milliseconds(500));
+    ASSERT_LESS_THAN_OR_EQUALS(
+        electionTimeoutWhen,
+        heartbeatTime + Milliseconds(500) +
+            Milliseconds(static_cast<long long>(
+                500 * getExternalState()->getElectionTimeoutOffsetLimitFraction())));
+}
+
 TEST_F(TakeoverTest, SchedulesCatchupTakeoverIfBothTakeoversAnOption) {
     BSONObj configObj = BSON("_id"
                              << "mySet"
@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator_impl.h"
 #include "mongo/db/repl/topology_coordinator.h"
 #include "mongo/db/repl/vote_requester.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
@@ -66,6 +67,11 @@ namespace {
 MONGO_FP_DECLARE(blockHeartbeatStepdown);
 MONGO_FP_DECLARE(blockHeartbeatReconfigFinish);
 
+// When positive, a secondary whose heartbeats to the current primary fail with HostUnreachable
+// through all of their retries runs for election after this many milliseconds (plus a
+// proportional random offset) instead of waiting out the rest of the full election timeout.
+MONGO_EXPORT_SERVER_PARAMETER(primaryUnreachableElectionTimeoutMillis, int, 0);
+
 }  // namespace
 
 using executor::RemoteCommandRequest;
@@ -194,6 +200,9 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     const Date_t now = _replExecutor->now();
     Milliseconds networkTime(0);
     StatusWith<ReplSetHeartbeatResponse> hbStatusResponse(hbResponse);
+    const int primaryIndex = _topCoord->getCurrentPrimaryIndex();
+    const bool targetIsPrimary =
+        primaryIndex >= 0 && _rsConfig.getMemberAt(primaryIndex).getHostAndPort() == target;
 
     if (responseStatus.isOK()) {
         networkTime = cbData.response.elapsedMillis.value_or(Milliseconds{0});
@@ -216,6 +225,14 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     HeartbeatResponseAction action =
         _topCoord->processHeartbeatResponse(now, networkTime, target, hbStatusResponse);
 
+    // A primary that refuses connections through every retry is almost certainly gone, so there
+    // is no point waiting out the rest of the election timeout. Timeouts are ambiguous and are
+    // left to the election timeout.
+    if (targetIsPrimary && responseStatus == ErrorCodes::HostUnreachable &&
+        action.getNextHeartbeatStartDate() > now) {
+        _expediteElectionTimeout_inlock(now);
+    }
+
     if (action.getAction() == HeartbeatResponseAction::NoAction && hbStatusResponse.isOK() &&
         hbStatusResponse.getValue().hasState() &&
         hbStatusResponse.getValue().getState() != MemberState::RS_PRIMARY &&
@@ -777,6 +794,36 @@ void ReplicationCoordinatorImpl::_cancelAndRescheduleElectionTimeout_inlock() {
                                    TopologyCoordinator::StartElectionReason::kElectionTimeout));
 }
 
+void ReplicationCoordinatorImpl::_expediteElectionTimeout_inlock(Date_t now) {
+    const Milliseconds delay(primaryUnreachableElectionTimeoutMillis.load());
+    if (delay <= Milliseconds(0) || !_handleElectionTimeoutCbh.isValid()) {
+        return;
+    }
+
+    // Scale the random offset down with the delay so that candidates stay staggered without the
+    // offset dominating the shortened timeout.
+    const Milliseconds electionTimeout = _rsConfig.getElectionTimeoutPeriod();
+    Milliseconds randomOffset = _getRandomizedElectionOffset_inlock();
+    if (delay < electionTimeout) {
+        randomOffset = randomOffset * durationCount<Milliseconds>(delay) /
+            durationCount<Milliseconds>(electionTimeout);
+    }
+    const auto when = now + delay + randomOffset;
+    if (when >= _handleElectionTimeoutWhen) {
+        return;
+    }
+
+    log() << "Current primary is unreachable; moving election timeout from "
+          << _handleElectionTimeoutWhen << " to " << when;
+    _replExecutor->cancel(_handleElectionTimeoutCbh);
+    _handleElectionTimeoutWhen = when;
+    _handleElectionTimeoutCbh =
+        _scheduleWorkAt(when,
+                        stdx::bind(&ReplicationCoordinatorImpl::_startElectSelfIfEligibleV1,
+                                   this,
+                                   TopologyCoordinator::StartElectionReason::kElectionTimeout));
+}
+
 void ReplicationCoordinatorImpl::_startElectSelfIfEligibleV1(
     TopologyCoordinator::StartElectionReason reason) {
     if (!isV1ElectionProtocol()) {
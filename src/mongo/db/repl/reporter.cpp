@@ -94,11 +94,13 @@ bool _isTargetConfigNewerThanRequest(
 Reporter::Reporter(executor::TaskExecutor* executor,
                    PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
                    const HostAndPort& target,
-                   Milliseconds keepAliveInterval)
+                   Milliseconds keepAliveInterval,
+                   Milliseconds minIntervalBetweenCommands)
     : _executor(executor),
       _prepareReplSetUpdatePositionCommandFn(prepareReplSetUpdatePositionCommandFn),
       _target(target),
-      _keepAliveInterval(keepAliveInterval) {
+      _keepAliveInterval(keepAliveInterval),
+      _minIntervalBetweenCommands(minIntervalBetweenCommands) {
     uassert(ErrorCodes::BadValue, "null task executor", executor);
     uassert(ErrorCodes::BadValue,
             "null function to create replSetUpdatePosition command object",
@@ -242,6 +244,33 @@ void Reporter::_sendCommand_inlock(BSONObj commandRequest) {
     }
 
     _remoteCommandCallbackHandle = scheduleResult.getValue();
+    _lastCommandSentAt = _executor->now();
+}
+
+bool Reporter::_delayCommandIfNeeded_inlock() {
+    if (_minIntervalBetweenCommands <= Milliseconds(0) || _lastCommandSentAt == Date_t()) {
+        return false;
+    }
+
+    auto when = _lastCommandSentAt + _minIntervalBetweenCommands;
+    if (_executor->now() >= when) {
+        return false;
+    }
+
+    bool fromTrigger = true;
+    auto scheduleResult = _executor->scheduleWorkAt(
+        when,
+        stdx::bind(
+            &Reporter::_prepareAndSendCommandCallback, this, stdx::placeholders::_1, fromTrigger));
+
+    _status = scheduleResult.getStatus();
+    if (!_status.isOK()) {
+        return true;
+    }
+
+    _prepareAndSendCommandCallbackHandle = scheduleResult.getValue();
+    _keepAliveTimeoutWhen = Date_t();
+    return true;
 }
 
 void Reporter::_processResponseCallback(
@@ -313,6 +342,19 @@ void Reporter::_processResponseCallback(
             _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
             return;
         }
+
+        // The command prepared below describes all progress made so far, so a trigger() arriving
+        // from now on needs another command.
+        _isWaitingToSendReporter = false;
+
+        if (_delayCommandIfNeeded_inlock()) {
+            if (!_status.isOK()) {
+                _onShutdown_inlock();
+                return;
+            }
+            _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
+            return;
+        }
     }
 
     // Must call without holding the lock.
@@ -331,7 +373,6 @@ void Reporter::_processResponseCallback(
     }
 
     invariant(_remoteCommandCallbackHandle.isValid());
-    _isWaitingToSendReporter = false;
 }
 
 void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::CallbackArgs& args,
@@ -355,6 +396,13 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
             _onShutdown_inlock();
             return;
         }
+
+        if (_delayCommandIfNeeded_inlock()) {
+            if (!_status.isOK()) {
+                _onShutdown_inlock();
+            }
+            return;
+        }
     }
 
     // Must call without holding the lock.
@@ -60,6 +60,11 @@ namespace repl {
  *
  * Calling trigger() while it is in state 3 sends a command upstream and cancels the current
  * keep alive timeout, resetting the keep alive schedule.
+ *
+ * If "minIntervalBetweenCommands" is positive, a command is never sent sooner than that after the
+ * previous one. Progress made in the meantime is batched into the delayed command, which bounds
+ * the rate of commands the sync source has to process without delaying the first command after a
+ * quiet period.
  */
 class Reporter {
     MONGO_DISALLOW_COPYING(Reporter);
@@ -77,7 +82,8 @@ public:
     Reporter(executor::TaskExecutor* executor,
              PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
              const HostAndPort& target,
-             Milliseconds keepAliveInterval);
+             Milliseconds keepAliveInterval,
+             Milliseconds minIntervalBetweenCommands = Milliseconds(0));
 
     virtual ~Reporter();
 
@@ -156,6 +162,13 @@ private:
      */
     void _processResponseCallback(const executor::TaskExecutor::RemoteCommandCallbackArgs& rcbd);
 
+    /**
+     * If less than "_minIntervalBetweenCommands" passed since the last command was sent, schedules
+     * the next command to be prepared and sent once it has and returns true. The caller must check
+     * "_status" when this returns true.
+     */
+    bool _delayCommandIfNeeded_inlock();
+
     /**
      * Callback for preparing and sending remote command.
      */
@@ -180,6 +193,9 @@ private:
     // encounters an error.
     const Milliseconds _keepAliveInterval;
 
+    // Minimum time between two commands sent to "_target".
+    const Milliseconds _minIntervalBetweenCommands;
+
     // Protects member data of this Reporter declared below.
     mutable stdx::mutex _mutex;
 
@@ -206,6 +222,9 @@ private:
     // If this date is Date_t(), the callback is either unscheduled or canceled.
     // Used for testing only.
     Date_t _keepAliveTimeoutWhen;
+
+    // When the last command was sent to "_target".
+    Date_t _lastCommandSentAt;
 };
 
 }  // namespace repl
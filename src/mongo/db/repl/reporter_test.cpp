@@ -753,4 +753,42 @@ TEST_F(ReporterTest, ShutdownImmediatelyAfterTriggerWhileKeepAliveTimeoutIsSched
     assertReporterDone();
 }
 
+TEST_F(ReporterTestNoTriggerAtSetUp,
+       TriggersWithinMinIntervalBetweenCommandsAreBatchedIntoOneDelayedCommand) {
+    Milliseconds minIntervalBetweenCommands(100);
+    reporter = stdx::make_unique<Reporter>(
+        _executorProxy.get(),
+        [this](ReplicationCoordinator::ReplSetUpdatePositionCommandStyle commandStyle) {
+            return prepareReplSetUpdatePositionCommandFn(commandStyle);
+        },
+        HostAndPort("h1"),
+        Milliseconds(1000),
+        minIntervalBetweenCommands);
+
+    // The first command is sent right away.
+    ASSERT_OK(reporter->trigger());
+    auto firstCommandSentAt = getExecutor().now();
+
+    // Triggers while the first command is in progress are batched, and the resulting command is not
+    // sent before the minimum interval has passed.
+    ASSERT_OK(reporter->trigger());
+    ASSERT_OK(reporter->trigger());
+    ASSERT_TRUE(reporter->isWaitingToSendReport());
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_TRUE(reporter->isActive());
+    ASSERT_FALSE(reporter->isWaitingToSendReport());
+
+    runUntil(firstCommandSentAt + minIntervalBetweenCommands, true);
+    processNetworkResponse(BSON("ok" << 1));
+
+    // Only once no more progress is to be reported does the reporter fall back to keep alives.
+    ASSERT_EQUALS(getExecutor().now() + reporter->getKeepAliveInterval(),
+                  reporter->getKeepAliveTimeoutWhen_forTest());
+    ASSERT_TRUE(reporter->isActive());
+
+    reporter->shutdown();
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, reporter->join());
+    assertReporterDone();
+}
+
 }  // namespace
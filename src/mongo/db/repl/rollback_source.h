@@ -28,15 +28,18 @@
 
 #pragma once
 
+#include <tuple>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
 
-class NamespaceString;
 class OperationContext;
 
 namespace repl {
@@ -88,6 +91,28 @@ public:
                                                               UUID uuid,
                                                               const BSONObj& filter) const = 0;
 
+    /**
+     * Fetches the documents with the given _id values from the collection with the given UUID on
+     * the sync source. The returned vector is parallel to 'ids': entry i is the document whose _id
+     * is ids[i], or an empty object if the sync source has no such document. Returns the namespace
+     * matching the UUID on the sync source as well.
+     *
+     * The default implementation issues one findOneByUUID() per _id; implementations backed by a
+     * connection should override it with a single query.
+     */
+    virtual std::pair<std::vector<BSONObj>, NamespaceString> findByIdsByUUID(
+        const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+        std::vector<BSONObj> docs;
+        NamespaceString nss;
+        docs.reserve(ids.size());
+        for (auto&& id : ids) {
+            BSONObj doc;
+            std::tie(doc, nss) = findOneByUUID(db, uuid, id.wrap());
+            docs.push_back(doc);
+        }
+        return {std::move(docs), nss};
+    }
+
     /**
      * Clones a single collection from the sync source.
      */
@@ -30,11 +30,13 @@
 
 #include "mongo/db/repl/rollback_source_impl.h"
 
+#include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/cloner.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/oplogreader.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -79,6 +81,67 @@ std::pair<BSONObj, NamespaceString> RollbackSourceImpl::findOneByUUID(const std:
     return _getConnection()->findOneByUUID(db, uuid, filter);
 }
 
+std::pair<std::vector<BSONObj>, NamespaceString> RollbackSourceImpl::findByIdsByUUID(
+    const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+    // Matches returned documents back to their position in 'ids' with the same comparison rules
+    // rollback uses to order the documents it refetches.
+    const StringData::ComparatorInterface* stringComparator = nullptr;
+    BSONElementComparator eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, stringComparator);
+    auto positions = eltCmp.makeBSONEltIndexedMap<size_t>();
+
+    BSONArrayBuilder idsBuilder;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        positions.emplace(ids[i], i);
+        idsBuilder.append(ids[i]);
+    }
+
+    BSONObjBuilder cmdBuilder;
+    uuid.appendToBuilder(&cmdBuilder, "find");
+    cmdBuilder.append("filter", BSON("_id" << BSON("$in" << idsBuilder.arr())));
+    const BSONObj cmd = cmdBuilder.obj();
+
+    std::vector<BSONObj> docs(ids.size());
+    auto addBatch = [&](const BSONObj& batch) {
+        for (auto&& elem : batch) {
+            BSONObj doc = elem.Obj();
+            auto it = positions.find(doc["_id"]);
+            if (it != positions.end()) {
+                docs[it->second] = doc.getOwned();
+            }
+        }
+    };
+
+    DBClientBase* conn = _getConnection();
+    BSONObj res;
+    if (!conn->runCommand(db, cmd, res, QueryOption_SlaveOk)) {
+        uasserted(getStatusFromCommandResult(res).code(),
+                  str::stream() << "find command using UUID failed. Command: " << cmd
+                                << " Result: "
+                                << res);
+    }
+    BSONObj cursorObj = res.getObjectField("cursor");
+    const NamespaceString resNss(cursorObj["ns"].valueStringData());
+    addBatch(cursorObj.getObjectField("firstBatch"));
+    long long cursorId = cursorObj["id"].numberLong();
+
+    // Large documents may not fit in the first batch, so drain the cursor.
+    while (cursorId != 0) {
+        const BSONObj getMoreCmd = BSON("getMore" << cursorId << "collection" << resNss.coll());
+        BSONObj getMoreRes;
+        if (!conn->runCommand(db, getMoreCmd, getMoreRes, QueryOption_SlaveOk)) {
+            uasserted(getStatusFromCommandResult(getMoreRes).code(),
+                      str::stream() << "getMore on refetch cursor failed. Command: " << getMoreCmd
+                                    << " Result: "
+                                    << getMoreRes);
+        }
+        cursorObj = getMoreRes.getObjectField("cursor");
+        addBatch(cursorObj.getObjectField("nextBatch"));
+        cursorId = cursorObj["id"].numberLong();
+    }
+
+    return {std::move(docs), resNss};
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -903,6 +903,15 @@ Status _syncRollback(OperationContext* opCtx,
 
 }  // namespace
 
+namespace {
+
+// Bounds on a single refetch query, by number of documents and by the total size of their _id
+// values, so that the {_id: {$in: [...]}} filter stays well below the maximum command size.
+const size_t kRefetchBatchSize = 1000;
+const size_t kRefetchBatchMaxIdBytes = 1024 * 1024;
+
+}  // namespace
+
 void rollback_internal::syncFixUp(OperationContext* opCtx,
                                   const FixUpInfo& fixUpInfo,
                                   const RollbackSource& rollbackSource,
@@ -919,22 +928,35 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
 
     log() << "Starting refetching documents";
 
-    for (auto&& doc : fixUpInfo.docsToRefetch) {
-        invariant(!doc._id.eoo());  // This is checked when we insert to the set.
-
-        UUID uuid = doc.uuid;
+    // Refetches the documents one batch at a time with a single {_id: {$in: [...]}} query per
+    // batch, rather than a round trip per document. Since docsToRefetch is ordered by UUID first,
+    // the documents of each collection are contiguous.
+    auto docIt = fixUpInfo.docsToRefetch.begin();
+    while (docIt != fixUpInfo.docsToRefetch.end()) {
+        UUID uuid = docIt->uuid;
         NamespaceString nss = catalog.lookupNSSByUUID(uuid);
 
+        std::vector<const DocID*> batch;
+        std::vector<BSONElement> ids;
+        size_t idBytes = 0;
+        while (docIt != fixUpInfo.docsToRefetch.end() && docIt->uuid == uuid &&
+               batch.size() < kRefetchBatchSize && idBytes < kRefetchBatchMaxIdBytes) {
+            invariant(!docIt->_id.eoo());  // This is checked when we insert to the set.
+            batch.push_back(&*docIt);
+            ids.push_back(docIt->_id);
+            idBytes += docIt->_id.size();
+            ++docIt;
+        }
+
         try {
-            LOG(2) << "Refetching document, namespace: " << nss.toString()
-                   << ", _id: " << redact(doc._id);
-            // TODO : Slow. Lots of round trips.
-            numFetched++;
+            LOG(2) << "Refetching " << ids.size() << " documents, namespace: " << nss.toString();
+            numFetched += batch.size();
 
-            BSONObj good;
+            std::vector<BSONObj> goodDocs;
             NamespaceString resNss;
-            std::tie(good, resNss) =
-                rollbackSource.findOneByUUID(nss.db().toString(), uuid, doc._id.wrap());
+            std::tie(goodDocs, resNss) =
+                rollbackSource.findByIdsByUUID(nss.db().toString(), uuid, ids);
+            invariant(goodDocs.size() == batch.size());
 
             // To prevent inconsistencies in the transactions collection, rollback fails if the UUID
             // of the collection is different on the sync source than on the node rolling back,
@@ -951,17 +973,21 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
                        "resync is required.");
             }
 
-            totalSize += good.objsize();
+            auto& goodVersionsByDocID = goodVersions[uuid];
+            for (size_t i = 0; i < batch.size(); ++i) {
+                const BSONObj& good = goodDocs[i];
+                totalSize += good.objsize();
 
-            // Checks that the total amount of data that needs to be refetched is at most
-            // 300 MB. We do not roll back more than 300 MB of documents in order to
-            // prevent out of memory errors from too much data being stored. See SERVER-23392.
-            if (totalSize >= 300 * 1024 * 1024) {
-                throw RSFatalException("replSet too much data to roll back.");
-            }
+                // Checks that the total amount of data that needs to be refetched is at most
+                // 300 MB. We do not roll back more than 300 MB of documents in order to
+                // prevent out of memory errors from too much data being stored. See SERVER-23392.
+                if (totalSize >= 300 * 1024 * 1024) {
+                    throw RSFatalException("replSet too much data to roll back.");
+                }
 
-            // Note good might be empty, indicating we should delete it.
-            goodVersions[uuid].insert(std::pair<DocID, BSONObj>(doc, good));
+                // Note good might be empty, indicating we should delete it.
+                goodVersionsByDocID.insert(std::pair<DocID, BSONObj>(*batch[i], good));
+            }
 
         } catch (const DBException& ex) {
             // If the collection turned into a view, we might get an error trying to
@@ -970,9 +996,9 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
             if (ex.code() == ErrorCodes::CommandNotSupportedOnView)
                 continue;
 
-            log() << "Rollback couldn't re-fetch from uuid: " << uuid << " _id: " << redact(doc._id)
-                  << ' ' << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": "
-                  << redact(ex);
+            log() << "Rollback couldn't re-fetch " << batch.size() << " documents from uuid: "
+                  << uuid << " starting at _id: " << redact(batch.front()->_id) << ' '
+                  << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": " << redact(ex);
             throw;
         }
     }
@@ -475,6 +475,71 @@ TEST_F(RSRollbackTest, RollbackDeleteRestoreDocument) {
             _opCtx.get(), _coordinator, _replicationProcess.get(), coll->uuid().get(), doc));
 }
 
+TEST_F(RSRollbackTest, RollbackRefetchesDocumentsOfACollectionInOneBatch) {
+    createOplog(_opCtx.get());
+    CollectionOptions options;
+    options.uuid = UUID::gen();
+    auto coll = _createCollection(_opCtx.get(), "test.t", options);
+    auto uuid = coll->uuid().get();
+    auto commonOperation =
+        std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+    auto makeDeleteOperation = [&](int id) {
+        return std::make_pair(BSON("ts" << Timestamp(Seconds(id + 2), 0) << "h" << 1LL << "op"
+                                        << "d"
+                                        << "ui"
+                                        << uuid
+                                        << "ns"
+                                        << "test.t"
+                                        << "o"
+                                        << BSON("_id" << id)),
+                              RecordId(id + 2));
+    };
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+        std::pair<std::vector<BSONObj>, NamespaceString> findByIdsByUUID(
+            const std::string& db,
+            UUID uuid,
+            const std::vector<BSONElement>& ids) const override {
+            ++calls;
+            numIds += ids.size();
+            std::vector<BSONObj> docs;
+            for (auto&& id : ids) {
+                BSONObjBuilder bob;
+                bob.appendAs(id, "_id");
+                bob.append("a", 1);
+                docs.push_back(bob.obj());
+            }
+            return {docs, NamespaceString("test.t")};
+        }
+        mutable int calls = 0;
+        mutable size_t numIds = 0;
+    };
+    RollbackSourceLocal rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({
+        commonOperation,
+    })));
+    ASSERT_OK(syncRollback(_opCtx.get(),
+                           OplogInterfaceMock({makeDeleteOperation(2),
+                                               makeDeleteOperation(1),
+                                               makeDeleteOperation(0),
+                                               commonOperation}),
+                           rollbackSource,
+                           {},
+                           _coordinator,
+                           _replicationProcess.get()));
+    ASSERT_EQUALS(1, rollbackSource.calls);
+    ASSERT_EQUALS(3U, rollbackSource.numIds);
+
+    Lock::DBLock dbLock(_opCtx.get(), "test", MODE_S);
+    Lock::CollectionLock collLock(_opCtx->lockState(), "test.t", MODE_S);
+    auto db = dbHolder().get(_opCtx.get(), "test");
+    ASSERT_TRUE(db);
+    auto collection = db->getCollection(_opCtx.get(), "test.t");
+    ASSERT_TRUE(collection);
+    ASSERT_EQUALS(3, collection->getRecordStore()->numRecords(_opCtx.get()));
+}
+
 TEST_F(RSRollbackTest, RollbackInsertDocumentWithNoId) {
     createOplog(_opCtx.get());
     auto commonOperation =
@@ -37,6 +37,7 @@
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/reporter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
@@ -49,6 +50,11 @@ namespace repl {
 
 namespace {
 
+// Minimum time between two replSetUpdatePosition commands sent to the sync source. Progress made
+// within that time is reported together in the next command, which spares the sync source from
+// processing a command for every batch applied. Zero sends a command as soon as progress is made.
+MONGO_EXPORT_SERVER_PARAMETER(replSetUpdatePositionMinIntervalMillis, int, 0);
+
 /**
  * Calculates the keep alive interval based on the current configuration in the replication
  * coordinator.
@@ -217,7 +223,8 @@ void SyncSourceFeedback::run(executor::TaskExecutor* executor, BackgroundSync* b
             executor,
             makePrepareReplSetUpdatePositionCommandFn(opCtx.get(), syncTarget, bgsync),
             syncTarget,
-            keepAliveInterval);
+            keepAliveInterval,
+            Milliseconds(replSetUpdatePositionMinIntervalMillis.load()));
         {
             stdx::lock_guard<stdx::mutex> lock(_mtx);
             if (_shutdownSignaled) {
@@ -34,7 +34,10 @@
 #include "mongo/db/repl/sync_tail.h"
 
 #include "third_party/murmurhash3/MurmurHash3.h"
+#include <algorithm>
+#include <array>
 #include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
 #include <memory>
 
 #include "mongo/base/counter.h"
@@ -72,6 +75,7 @@
 #include "mongo/db/session_txn_record.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -118,6 +122,75 @@ public:
 
 } exportedWriterThreadCountParam;
 
+// If true, the writer threads run on a WorkStealingThreadPool, which does not serialize the
+// scheduling and running of tasks on one mutex.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replWriterThreadPoolWorkStealing, bool, false);
+
+// If true, steady state replication writes the next batch to the oplog while the writer threads
+// are still applying the current batch, when the next batch is already available.
+MONGO_EXPORT_SERVER_PARAMETER(replPipelineOplogWrites, bool, true);
+
+// The most consecutive ops on one collection that a writer thread applies together, either as one
+// grouped insert or as updates and deletes in one storage transaction.
+MONGO_EXPORT_SERVER_PARAMETER(replMaxOpsPerApplyGroup, int, 64);
+
+/**
+ * Returns true if 'entry' is an applyOps command whose operations can be applied as independent
+ * CRUD ops by the writer threads: it has no preCondition and every operation it contains is an
+ * insert, update or delete on a regular collection.
+ */
+bool isApplyOpsOfCrudOps(const OplogEntry& entry) {
+    if (!entry.isCommand() || entry.getCommandType() != OplogEntry::CommandType::kApplyOps) {
+        return false;
+    }
+
+    const BSONObj cmd = entry.getObject();
+    if (cmd.hasField("preCondition") || cmd.firstElement().type() != Array) {
+        return false;
+    }
+
+    for (const auto& elem : cmd.firstElement().Obj()) {
+        if (elem.type() != Object) {
+            return false;
+        }
+        const BSONObj op = elem.Obj();
+        const StringData opType = op.getStringField("op");
+        if (opType != "i" && opType != "u" && opType != "d") {
+            return false;
+        }
+        const NamespaceString nss(op.getStringField("ns"));
+        if (!nss.isValid() || nss.isSystemDotIndexes() || !op["o"].isABSONObj()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the operations of an applyOps entry accepted by isApplyOpsOfCrudOps() as oplog entries
+ * of their own, each carrying the optime and hash of the applyOps entry.
+ */
+MultiApplier::Operations extractApplyOpsOperations(const OplogEntry& applyOps) {
+    MultiApplier::Operations operations;
+    for (const auto& elem : applyOps.getObject().firstElement().Obj()) {
+        BSONObjBuilder builder;
+        for (const auto& field : elem.Obj()) {
+            const auto name = field.fieldNameStringData();
+            if (name != "ts" && name != "t" && name != "h" && name != "v") {
+                builder.append(field);
+            }
+        }
+        for (const auto& field : applyOps.raw) {
+            const auto name = field.fieldNameStringData();
+            if (name == "ts" || name == "t" || name == "h" || name == "v") {
+                builder.append(field);
+            }
+        }
+        operations.emplace_back(builder.obj());
+    }
+    return operations;
+}
+
 class ExportedBatchLimitOperationsParameter
     : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
 public:
@@ -290,6 +363,10 @@ SyncTail::SyncTail(BackgroundSync* q,
 SyncTail::~SyncTail() {}
 
 std::unique_ptr<OldThreadPool> SyncTail::makeWriterPool() {
+    if (replWriterThreadPoolWorkStealing) {
+        return stdx::make_unique<OldThreadPool>(
+            OldThreadPool::WorkStealingTag(), replWriterThreadCount, "repl writer worker ");
+    }
     return stdx::make_unique<OldThreadPool>(replWriterThreadCount, "repl writer worker ");
 }
 
@@ -307,9 +384,16 @@ Status SyncTail::syncApply(OperationContext* opCtx,
     // Count each log op application as a separate operation, for reporting purposes
     CurOp individualOp(opCtx);
 
-    const NamespaceString nss(op.getStringField("ns"));
+    std::array<StringData, 3> names = {"ns", "op", "ui"};
+    std::array<BSONElement, 3> fields;
+    op.getFields(names, &fields);
+    const BSONElement& fieldNs = fields[0];
+    const BSONElement& fieldOp = fields[1];
+    const BSONElement& fieldUI = fields[2];
 
-    const char* opType = op["op"].valuestrsafe();
+    const NamespaceString nss(fieldNs.type() == String ? fieldNs.valueStringData() : "");
+
+    const char* opType = fieldOp.valuestrsafe();
 
     auto applyOp = [&](Database* db) {
         // For non-initial-sync, we convert updates to upserts
@@ -341,10 +425,9 @@ Status SyncTail::syncApply(OperationContext* opCtx,
         return writeConflictRetry(opCtx, "syncApply_CRUD", nss.ns(), [&] {
             // DB lock always acquires the global lock
             Lock::DBLock dbLock(opCtx, nss.db(), MODE_IX);
-            auto ui = op["ui"];
             NamespaceString actualNss = nss;
-            if (ui) {
-                auto statusWithUUID = UUID::parse(ui);
+            if (fieldUI) {
+                auto statusWithUUID = UUID::parse(fieldUI);
                 if (!statusWithUUID.isOK())
                     return statusWithUUID.getStatus();
                 // We may be replaying operations on a collection that was renamed since. If so,
@@ -501,32 +584,35 @@ void scheduleWritesToOplog(OperationContext* opCtx,
         };
     };
 
-    // We want to be able to take advantage of bulk inserts so we don't use multiple threads if it
-    // would result too little work per thread. This also ensures that we can amortize the
+    // We want to be able to take advantage of bulk inserts so we don't use more threads than would
+    // leave enough work for each of them. This also ensures that we can amortize the
     // setup/teardown overhead across many writes.
     const size_t kMinOplogEntriesPerThread = 16;
-    const bool enoughToMultiThread =
-        ops.size() >= kMinOplogEntriesPerThread * threadPool->getNumThreads();
+    const size_t numOplogThreads =
+        std::min(threadPool->getNumThreads(), ops.size() / kMinOplogEntriesPerThread);
 
     // Only doc-locking engines support parallel writes to the oplog because they are required to
     // ensure that oplog entries are ordered correctly, even if inserted out-of-order. Additionally,
     // there would be no way to take advantage of multiple threads if a storage engine doesn't
     // support document locking.
-    if (!enoughToMultiThread ||
+    if (numOplogThreads <= 1 ||
         !opCtx->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking()) {
 
         threadPool->schedule(makeOplogWriterForRange(0, ops.size()));
         return;
     }
 
-
-    const size_t numOplogThreads = threadPool->getNumThreads();
+    // Each thread inserts a contiguous timestamp range. The ranges differ in size by at most one
+    // entry, so that no thread is left with the whole remainder.
     const size_t numOpsPerThread = ops.size() / numOplogThreads;
+    const size_t numThreadsWithExtraOp = ops.size() % numOplogThreads;
+    size_t begin = 0;
     for (size_t thread = 0; thread < numOplogThreads; thread++) {
-        size_t begin = thread * numOpsPerThread;
-        size_t end = (thread == numOplogThreads - 1) ? ops.size() : begin + numOpsPerThread;
+        size_t end = begin + numOpsPerThread + (thread < numThreadsWithExtraOp ? 1 : 0);
         threadPool->schedule(makeOplogWriterForRange(begin, end));
+        begin = end;
     }
+    invariant(begin == ops.size());
 }
 
 using SessionRecordMap =
@@ -625,23 +711,55 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+// Ops which must be applied in order share a conflict key: the namespace, and for doc locking
+// engines the _id of the document as well, unless the collection is capped. All ops with the same
+// key are given to the same writer, in order. The first time a key is seen in a batch it is given
+// to the writer with the fewest ops so far, rather than to the writer its hash falls on, so a batch
+// made up of a few ops on each of many documents is spread evenly across the writers.
+//
+// Secondaries relax unique index constraints while applying ops, so ops on different documents
+// never need to be ordered because of a unique index.
+//
+// The operations of applyOps entries accepted by isApplyOpsOfCrudOps() are given to the writers as
+// separate ops, which are kept alive in 'derivedOps'. The applyOps entry itself is not applied.
+//
 // This only modifies the isForCappedCollection field on each op. It does not alter the ops vector
 // in any other way.
 void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
-                       std::vector<MultiApplier::OperationPtrs>* writerVectors) {
+                       std::vector<MultiApplier::OperationPtrs>* writerVectors,
+                       std::vector<MultiApplier::Operations>* derivedOps) {
     const bool supportsDocLocking =
         getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
     const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
 
-    for (auto&& op : *ops) {
-        StringMapTraits::HashedKey hashedNs(op.getNamespace().ns());
-        uint32_t hash = hashedNs.hash();
+    // Maps the hash of each conflict key seen in this batch to the writer applying its ops. Keys
+    // whose hashes collide are applied by the same writer, which is safe.
+    stdx::unordered_map<uint32_t, uint32_t> writerForKey;
+
+    // Runs of ops on the same namespace are the common case, so the hash of the namespace and the
+    // properties of its collection are only looked up when the namespace changes.
+    boost::optional<StringData> previousNs;
+    uint32_t previousNsHash = 0;
+    boost::optional<CachedCollectionProperties::CollectionProperties> previousCollProperties;
+
+    auto addToWriterVectors = [&](OplogEntry& op) {
+        const StringData ns = op.getNamespace().ns();
+        if (!previousNs || ns != *previousNs) {
+            previousNs = ns;
+            previousNsHash = StringMapTraits::hash(ns);
+            previousCollProperties = boost::none;
+        }
+        uint32_t hash = previousNsHash;
 
         if (op.isCrudOpType()) {
-            auto collProperties = collPropertiesCache.getCollectionProperties(opCtx, hashedNs);
+            if (!previousCollProperties) {
+                previousCollProperties = collPropertiesCache.getCollectionProperties(
+                    opCtx, StringMapTraits::HashedKey(ns, previousNsHash));
+            }
+            const auto& collProperties = *previousCollProperties;
 
             // For doc locking engines, include the _id of the document in the hash so we get
             // parallelism even if all writes are to a single collection.
@@ -663,10 +781,38 @@ void fillWriterVectors(OperationContext* opCtx,
             }
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
+        auto it = writerForKey.find(hash);
+        if (it == writerForKey.end()) {
+            // Start from the writer the hash falls on so that ties are broken the same way the
+            // hash would have placed the key.
+            const uint32_t hashedWriter = hash % numWriters;
+            uint32_t leastLoaded = hashedWriter;
+            for (uint32_t i = 1; i < numWriters; ++i) {
+                const uint32_t candidate = (hashedWriter + i) % numWriters;
+                if ((*writerVectors)[candidate].size() < (*writerVectors)[leastLoaded].size()) {
+                    leastLoaded = candidate;
+                }
+            }
+            it = writerForKey.emplace(hash, leastLoaded).first;
+        }
+
+        auto& writer = (*writerVectors)[it->second];
         if (writer.empty())
             writer.reserve(8);  // skip a few growth rounds.
         writer.push_back(&op);
+    };
+
+    for (auto&& op : *ops) {
+        if (isApplyOpsOfCrudOps(op)) {
+            // Moving the vector into 'derivedOps' keeps its elements where they are, so the
+            // pointers given to the writers stay valid.
+            derivedOps->emplace_back(extractApplyOpsOperations(op));
+            for (auto&& derivedOp : derivedOps->back()) {
+                addToWriterVectors(derivedOp);
+            }
+            continue;
+        }
+        addToWriterVectors(op);
     }
 }
 
@@ -674,18 +820,45 @@ void fillWriterVectors(OperationContext* opCtx,
 
 // Applies a batch of oplog entries, by writing the oplog entries to the local oplog
 // and then using a set of threads to apply the operations.
-OpTime SyncTail::multiApply(OperationContext* opCtx, MultiApplier::Operations ops) {
+OpTime SyncTail::multiApply(OperationContext* opCtx,
+                            MultiApplier::Operations ops,
+                            bool opsInOplog,
+                            const MultiApplier::Operations* nextOps) {
     auto applyOperation = [this](MultiApplier::OperationPtrs* ops) -> Status {
         _applyFunc(ops, this);
         // This function is used by 3.2 initial sync and steady state data replication.
         // _applyFunc() will throw or abort on error, so we return OK here.
         return Status::OK();
     };
-    return fassertStatusOK(
-        34437, repl::multiApply(opCtx, _writerPool.get(), std::move(ops), applyOperation));
+    return fassertStatusOK(34437,
+                           repl::multiApply(opCtx,
+                                            _writerPool.get(),
+                                            std::move(ops),
+                                            applyOperation,
+                                            opsInOplog,
+                                            nextOps));
 }
 
 namespace {
+/**
+ * Returns true if the oplog writes of the batch following 'ops' may overlap with the application
+ * of 'ops'.
+ */
+bool canPipelineOplogWritesAfter(OperationContext* opCtx, const MultiApplier::Operations& ops) {
+    if (!replPipelineOplogWrites.load() || MONGO_FAIL_POINT(rsSyncApplyStop)) {
+        return false;
+    }
+
+    // Oplog writes only run in parallel with other writes on doc-locking engines.
+    if (!opCtx->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking()) {
+        return false;
+    }
+
+    // Commands are applied alone and may take strong locks, so there is nothing to overlap with.
+    return !std::any_of(
+        ops.begin(), ops.end(), [](const OplogEntry& entry) { return entry.isCommand(); });
+}
+
 void tryToGoLiveAsASecondary(OperationContext* opCtx, ReplicationCoordinator* replCoord) {
     if (replCoord->isInPrimaryOrSecondaryState()) {
         return;
@@ -814,14 +987,20 @@ void SyncTail::oplogApplication(ReplicationCoordinator* replCoord) {
             ? new ApplyBatchFinalizerForJournal(replCoord)
             : new ApplyBatchFinalizer(replCoord)};
 
+    // A batch that was written to the oplog while the previous batch was being applied. It must be
+    // applied before anything else, in particular before draining can complete.
+    MultiApplier::Operations pipelinedBatch;
+    bool batcherShutDown = false;
+
     while (true) {  // Exits on message from OpQueueBatcher.
         // Use a new operation context each iteration, as otherwise we may appear to use a single
         // collection name to refer to collections with different UUIDs.
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
-        // For pausing replication in tests.
-        if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
+        // For pausing replication in tests. A pipelined batch is already in the oplog, so it is
+        // applied before pausing.
+        if (MONGO_FAIL_POINT(rsSyncApplyStop) && pipelinedBatch.empty()) {
             log() << "sync tail - rsSyncApplyStop fail point enabled. Blocking until fail point is "
                      "disabled.";
             while (MONGO_FAIL_POINT(rsSyncApplyStop)) {
@@ -837,27 +1016,35 @@ void SyncTail::oplogApplication(ReplicationCoordinator* replCoord) {
 
         tryToGoLiveAsASecondary(&opCtx, replCoord);
 
-        long long termWhenBufferIsEmpty = replCoord->getTerm();
-        // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
-        // ready in time, we'll loop again so we can do the above checks periodically.
-        OpQueue ops = batcher.getNextBatch(Seconds(1));
-        if (ops.empty()) {
-            if (ops.mustShutdown()) {
-                return;
-            }
-            if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
-                continue;
+        MultiApplier::Operations batch;
+        const bool batchInOplog = !pipelinedBatch.empty();
+        if (batchInOplog) {
+            batch = std::move(pipelinedBatch);
+            pipelinedBatch.clear();
+        } else {
+            long long termWhenBufferIsEmpty = replCoord->getTerm();
+            // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
+            // ready in time, we'll loop again so we can do the above checks periodically.
+            OpQueue ops = batcher.getNextBatch(Seconds(1));
+            if (ops.empty()) {
+                if (ops.mustShutdown()) {
+                    return;
+                }
+                if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
+                    continue;
+                }
+                // Signal drain complete if we're in Draining state and the buffer is empty.
+                replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
+                continue;  // Try again.
             }
-            // Signal drain complete if we're in Draining state and the buffer is empty.
-            replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
-            continue;  // Try again.
+            batch = ops.releaseBatch();
         }
 
         // Extract some info from ops that we'll need after releasing the batch below.
         const auto firstOpTimeInBatch =
-            fassertStatusOK(40299, OpTime::parseFromOplogEntry(ops.front().raw));
+            fassertStatusOK(40299, OpTime::parseFromOplogEntry(batch.front().raw));
         const auto lastOpTimeInBatch =
-            fassertStatusOK(28773, OpTime::parseFromOplogEntry(ops.back().raw));
+            fassertStatusOK(28773, OpTime::parseFromOplogEntry(batch.back().raw));
 
         // Make sure the oplog doesn't go back in time or repeat an entry.
         if (firstOpTimeInBatch <= replCoord->getMyLastAppliedOpTime()) {
@@ -870,19 +1057,41 @@ void SyncTail::oplogApplication(ReplicationCoordinator* replCoord) {
                                          << ")."));
         }
 
-        // Don't allow the fsync+lock thread to see intermediate states of batch application.
-        stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
+        // Take the next batch if the batcher already has one, so that its oplog writes keep the
+        // writer threads busy while this batch's writes finish.
+        if (canPipelineOplogWritesAfter(&opCtx, batch)) {
+            OpQueue nextOps = batcher.getNextBatch(Seconds(0));
+            if (nextOps.mustShutdown()) {
+                batcherShutDown = true;
+            } else if (!nextOps.empty()) {
+                pipelinedBatch = nextOps.releaseBatch();
+            }
+        }
 
-        // Do the work.
-        multiApply(&opCtx, ops.releaseBatch());
+        {
+            // Don't allow the fsync+lock thread to see intermediate states of batch application.
+            stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
+
+            // Do the work.
+            multiApply(&opCtx,
+                       std::move(batch),
+                       batchInOplog,
+                       pipelinedBatch.empty() ? nullptr : &pipelinedBatch);
+
+            // Update various things that care about our last applied optime. Tests rely on 2
+            // happening before 3 even though it isn't strictly necessary. The order of 1 doesn't
+            // matter.
+            setNewTimestamp(opCtx.getServiceContext(), lastOpTimeInBatch.getTimestamp());  // 1
+            ReplicationProcess::get(&opCtx)->getConsistencyMarkers()->setAppliedThrough(
+                &opCtx,
+                lastOpTimeInBatch);                // 2
+            finalizer->record(lastOpTimeInBatch);  // 3
+        }
 
-        // Update various things that care about our last applied optime. Tests rely on 2 happening
-        // before 3 even though it isn't strictly necessary. The order of 1 doesn't matter.
-        setNewTimestamp(opCtx.getServiceContext(), lastOpTimeInBatch.getTimestamp());  // 1
-        ReplicationProcess::get(&opCtx)->getConsistencyMarkers()->setAppliedThrough(
-            &opCtx,
-            lastOpTimeInBatch);                // 2
-        finalizer->record(lastOpTimeInBatch);  // 3
+        if (batcherShutDown) {
+            invariant(pipelinedBatch.empty());
+            return;
+        }
     }
 }
 
@@ -953,8 +1162,9 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
         return true;
     }
 
-    // Check for ops that must be processed one at a time.
-    if (entry.isCommand() ||  // commands.
+    // Check for ops that must be processed one at a time. The writer threads apply the operations
+    // of an applyOps of CRUD ops like any other CRUD ops, so it can share a batch.
+    if ((entry.isCommand() && !isApplyOpsOfCrudOps(entry)) ||  // commands.
         // Index builds are achieved through the use of an insert op, not a command op.
         // The following line is the same as what the insert code uses to detect an index build.
         (!entry.getNamespace().isEmpty() && entry.getNamespace().coll() == "system.indexes")) {
@@ -1124,6 +1334,15 @@ bool SyncTail::fetchAndInsertMissingDocument(OperationContext* opCtx, const BSON
     });
 }
 
+namespace {
+
+bool isUpdateOrDelete(const OplogEntry& entry) {
+    const auto opType = entry.getOpType();
+    return opType == OpTypeEnum::kUpdate || opType == OpTypeEnum::kDelete;
+}
+
+}  // namespace
+
 // This free function is used by the writer threads to apply each op
 void multiSyncApply(MultiApplier::OperationPtrs* ops, SyncTail*) {
     initializeWriterThread();
@@ -1174,7 +1393,7 @@ Status multiSyncApply_noAbort(OperationContext* opCtx,
             std::vector<BSONObj> toInsert;
 
             auto maxBatchSize = insertVectorMaxBytes;
-            auto maxBatchCount = 64;
+            auto maxBatchCount = replMaxOpsPerApplyGroup.load();
 
             // Make sure to include the first op in the batch size.
             int batchSize = (*oplogEntriesIterator)->getObject().objsize();
@@ -1286,6 +1505,47 @@ Status multiSyncApply_noAbort(OperationContext* opCtx,
             }
         }
 
+        // Attempt to apply consecutive updates and deletes on the same collection in one storage
+        // transaction, so that they share its locks and its commit.
+        if (isUpdateOrDelete(*entry) && oplogEntriesIterator > doNotGroupBeforePoint) {
+            const auto maxGroupCount = replMaxOpsPerApplyGroup.load();
+            int groupCount = 1;
+            auto endOfGroupIterator =
+                std::find_if(oplogEntriesIterator + 1,
+                             oplogEntryPointers->end(),
+                             [&](const OplogEntry* nextEntry) -> bool {
+                                 groupCount += 1;
+                                 return !isUpdateOrDelete(*nextEntry) ||
+                                     nextEntry->getNamespace() != entry->getNamespace() ||
+                                     nextEntry->getUuid() != entry->getUuid() ||
+                                     groupCount > maxGroupCount;
+                             });
+
+            if (endOfGroupIterator > oplogEntriesIterator + 1) {
+                try {
+                    writeConflictRetry(
+                        opCtx, "multiSyncApply_group", entry->getNamespace().ns(), [&] {
+                            WriteUnitOfWork wuow(opCtx);
+                            for (auto groupingIterator = oplogEntriesIterator;
+                                 groupingIterator != endOfGroupIterator;
+                                 ++groupingIterator) {
+                                uassertStatusOK(syncApply(
+                                    opCtx, (*groupingIterator)->raw, inSteadyStateReplication));
+                            }
+                            wuow.commit();
+                        });
+                    oplogEntriesIterator = endOfGroupIterator - 1;
+                    continue;
+                } catch (const DBException& e) {
+                    // Nothing of the group was committed. Apply its ops individually, so that the
+                    // op which failed reports its own error.
+                    LOG(1) << "Error applying updates and deletes as a group "
+                           << causedBy(redact(e)) << " applying them individually";
+                    doNotGroupBeforePoint = endOfGroupIterator - 1;
+                }
+            }
+        }
+
         // If we didn't create a group, try to apply the op individually.
         try {
             const Status status = syncApply(opCtx, entry->raw, inSteadyStateReplication);
@@ -1373,6 +1633,16 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
                               OldThreadPool* workerPool,
                               MultiApplier::Operations ops,
                               MultiApplier::ApplyOperationFn applyOperation) {
+    return multiApply(opCtx, workerPool, std::move(ops), applyOperation, false, nullptr);
+}
+
+StatusWith<OpTime> multiApply(OperationContext* opCtx,
+                              OldThreadPool* workerPool,
+                              MultiApplier::Operations ops,
+                              MultiApplier::ApplyOperationFn applyOperation,
+                              bool opsInOplog,
+                              const MultiApplier::Operations* nextOps) {
+    invariant(!nextOps || !nextOps->empty());
     if (!opCtx) {
         return {ErrorCodes::BadValue, "invalid operation context"};
     }
@@ -1414,23 +1684,40 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
         // We must wait for the all work we've dispatched to complete before leaving this block
         // because the spawned threads refer to objects on our stack, including writerVectors.
         std::vector<MultiApplier::OperationPtrs> writerVectors(workerPool->getNumThreads());
+        std::vector<MultiApplier::Operations> derivedOps;
         ON_BLOCK_EXIT([&] { workerPool->join(); });
 
-        // Write batch of ops into oplog.
-        consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
-        scheduleWritesToOplog(opCtx, workerPool, ops);
-        fillWriterVectors(opCtx, &ops, &writerVectors);
+        if (opsInOplog) {
+            fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        } else {
+            // Write batch of ops into oplog.
+            consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
+            scheduleWritesToOplog(opCtx, workerPool, ops);
+            fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
 
-        // Wait for writes to finish before applying ops.
-        workerPool->join();
+            // Wait for writes to finish before applying ops.
+            workerPool->join();
+        }
 
-        // Reset consistency markers in case the node fails while applying ops.
-        consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
+        // Reset consistency markers in case the node fails while applying ops. If the next batch
+        // is written to the oplog concurrently, a failure must also remove its entries, which may
+        // be incomplete. Recovery then reapplies this batch from the oplog, since appliedThrough
+        // still precedes it.
+        consistencyMarkers->setOplogTruncateAfterPoint(
+            opCtx, nextOps ? nextOps->front().getTimestamp() : Timestamp());
         consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
 
         applyOps(writerVectors, workerPool, applyOperation, &statusVector);
+        if (nextOps) {
+            scheduleWritesToOplog(opCtx, workerPool, *nextOps);
+        }
         workerPool->join();
 
+        if (nextOps) {
+            // The next batch is now entirely in the oplog.
+            consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
+        }
+
         // Update the transaction table to point to the latest oplog entries for each session id.
         scheduleTxnTableUpdates(opCtx, workerPool, latestTxnRecords);
 
@@ -227,7 +227,11 @@ protected:
 
     // Apply a batch of operations, using multiple threads.
     // Returns the last OpTime applied during the apply batch, ops.end["ts"] basically.
-    OpTime multiApply(OperationContext* opCtx, MultiApplier::Operations ops);
+    // See repl::multiApply() below for 'opsInOplog' and 'nextOps'.
+    OpTime multiApply(OperationContext* opCtx,
+                      MultiApplier::Operations ops,
+                      bool opsInOplog = false,
+                      const MultiApplier::Operations* nextOps = nullptr);
 
 private:
     class OpQueueBatcher;
@@ -257,6 +261,26 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
                               MultiApplier::Operations ops,
                               MultiApplier::ApplyOperationFn applyOperation);
 
+/**
+ * Like multiApply() above, but may overlap the oplog writes of consecutive batches with their
+ * application.
+ *
+ * If 'opsInOplog' is true, the entries in "ops" were already written to the oplog, by passing them
+ * as 'nextOps' to the previous call, and are only applied. If 'nextOps' is not null, its entries
+ * are written to the oplog while "ops" are applied; the caller must keep 'nextOps' alive until this
+ * returns and pass it as "ops", with 'opsInOplog' set, to the next call before anything else.
+ *
+ * The oplog truncate-after point covers the entries of 'nextOps' until they are all written, and
+ * minValid and appliedThrough keep tracking "ops", so that recovery after a crash in the middle of
+ * the call still reapplies "ops" from the oplog.
+ */
+StatusWith<OpTime> multiApply(OperationContext* opCtx,
+                              OldThreadPool* workerPool,
+                              MultiApplier::Operations ops,
+                              MultiApplier::ApplyOperationFn applyOperation,
+                              bool opsInOplog,
+                              const MultiApplier::Operations* nextOps);
+
 // These free functions are used by the thread pool workers to write ops to the db.
 // They consume the passed in OperationPtrs and callers should not make any assumptions about the
 // state of the container after calling. However, these functions cannot modify the pointed-to
@@ -510,6 +510,183 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_BSONOBJ_EQ(op2.raw, operationsWrittenToOplog[1].doc);
 }
 
+TEST_F(SyncTailTest, MultiApplySpreadsNamespacesEvenlyAcrossWriterThreads) {
+    // Unlike assigning by hash alone, every writer thread gets one namespace here regardless of
+    // how the namespace names hash.
+    const std::size_t numWriters = 4;
+    OldThreadPool writerPool(numWriters);
+
+    MultiApplier::Operations ops;
+    for (std::size_t i = 0; i < numWriters; ++i) {
+        NamespaceString nss("test.t" + std::to_string(i));
+        for (int j = 0; j < 3; ++j) {
+            const int seconds = static_cast<int>(i) * 3 + j + 1;
+            ops.push_back(makeInsertDocumentOplogEntry(
+                {Timestamp(Seconds(seconds), 0), 1LL}, nss, BSON("_id" << j)));
+        }
+    }
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterThreadToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+    _storageInterface->insertDocumentsFn =
+        [](OperationContext*, const NamespaceString&, const std::vector<InsertStatement>&) {
+            return Status::OK();
+        };
+
+    auto lastOpTime =
+        unittest::assertGet(multiApply(_opCtx.get(), &writerPool, ops, applyOperationFn));
+    ASSERT_EQUALS(ops.back().getOpTime(), lastOpTime);
+
+    // Each writer thread applies all of the ops on one namespace, in order.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(numWriters, operationsApplied.size());
+    for (auto&& operationsAppliedByThread : operationsApplied) {
+        ASSERT_EQUALS(3U, operationsAppliedByThread.size());
+        const auto& nss = operationsAppliedByThread.front().getNamespace();
+        for (std::size_t j = 0; j < operationsAppliedByThread.size(); ++j) {
+            ASSERT_EQUALS(nss, operationsAppliedByThread[j].getNamespace());
+            if (j > 0) {
+                ASSERT_LT(operationsAppliedByThread[j - 1].getOpTime(),
+                          operationsAppliedByThread[j].getOpTime());
+            }
+        }
+    }
+}
+
+TEST_F(SyncTailTest, MultiApplyAppliesOperationsOfApplyOpsAsSeparateOperations) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    OldThreadPool writerPool(2);
+
+    auto applyOpsOp = makeCommandOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL},
+        nss,
+        BSON("applyOps" << BSON_ARRAY(BSON("op"
+                                           << "i"
+                                           << "ns"
+                                           << nss.ns()
+                                           << "o"
+                                           << BSON("_id" << 1))
+                                      << BSON("op"
+                                              << "u"
+                                              << "ns"
+                                              << nss.ns()
+                                              << "o2"
+                                              << BSON("_id" << 2)
+                                              << "o"
+                                              << BSON("$set" << BSON("x" << 2))))));
+    auto insertOp =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 3));
+
+    stdx::mutex mutex;
+    MultiApplier::Operations operationsApplied;
+    auto applyOperationFn =
+        [&mutex, &operationsApplied](MultiApplier::OperationPtrs* operationsToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        for (auto&& opPtr : *operationsToApply) {
+            operationsApplied.push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+    std::vector<InsertStatement> operationsWrittenToOplog;
+    _storageInterface->insertDocumentsFn = [&mutex, &operationsWrittenToOplog](
+        OperationContext*, const NamespaceString&, const std::vector<InsertStatement>& docs) {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsWrittenToOplog.insert(operationsWrittenToOplog.end(), docs.begin(), docs.end());
+        return Status::OK();
+    };
+
+    auto lastOpTime = unittest::assertGet(
+        multiApply(_opCtx.get(), &writerPool, {applyOpsOp, insertOp}, applyOperationFn));
+    ASSERT_EQUALS(insertOp.getOpTime(), lastOpTime);
+
+    // The writers apply the operations of the applyOps entry, at its optime, instead of the entry.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(3U, operationsApplied.size());
+    std::sort(operationsApplied.begin(),
+              operationsApplied.end(),
+              [](const OplogEntry& l, const OplogEntry& r) {
+                  return l.getIdElement().numberInt() < r.getIdElement().numberInt();
+              });
+    ASSERT_TRUE(OpTypeEnum::kInsert == operationsApplied[0].getOpType());
+    ASSERT_EQUALS(applyOpsOp.getOpTime(), operationsApplied[0].getOpTime());
+    ASSERT_EQUALS(nss, operationsApplied[0].getNamespace());
+    ASSERT_TRUE(OpTypeEnum::kUpdate == operationsApplied[1].getOpType());
+    ASSERT_EQUALS(applyOpsOp.getOpTime(), operationsApplied[1].getOpTime());
+    ASSERT_EQUALS(insertOp, operationsApplied[2]);
+
+    // The oplog gets the applyOps entry itself.
+    ASSERT_EQUALS(2U, operationsWrittenToOplog.size());
+    ASSERT_BSONOBJ_EQ(applyOpsOp.raw, operationsWrittenToOplog[0].doc);
+    ASSERT_BSONOBJ_EQ(insertOp.raw, operationsWrittenToOplog[1].doc);
+}
+
+TEST_F(SyncTailTest, MultiApplyWritesNextBatchToOplogWithoutApplyingIt) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto op1 = makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("x" << 1));
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("x" << 2));
+    auto op3 = makeInsertDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss, BSON("x" << 3));
+
+    stdx::mutex mutex;
+    std::vector<Timestamp> oplogTimestamps;
+    _storageInterface->insertDocumentsFn = [&](OperationContext*,
+                                               const NamespaceString& insertNss,
+                                               const std::vector<InsertStatement>& docs) {
+        ASSERT_EQUALS(NamespaceString::kRsOplogNamespace, insertNss);
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        for (auto&& doc : docs) {
+            oplogTimestamps.push_back(doc.doc["ts"].timestamp());
+        }
+        return Status::OK();
+    };
+
+    std::vector<OpTime> appliedOpTimes;
+    auto applyOperationFn = [&](MultiApplier::OperationPtrs* operationsToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        for (auto&& opPtr : *operationsToApply) {
+            appliedOpTimes.push_back(opPtr->getOpTime());
+        }
+        return Status::OK();
+    };
+
+    auto writerPool = SyncTail::makeWriterPool();
+    auto consistencyMarkers = _replicationProcess->getConsistencyMarkers();
+
+    // The first batch is written to the oplog and applied, and the second one is only written.
+    MultiApplier::Operations nextOps = {op2, op3};
+    ASSERT_EQUALS(op1.getOpTime(),
+                  unittest::assertGet(multiApply(
+                      _opCtx.get(), writerPool.get(), {op1}, applyOperationFn, false, &nextOps)));
+    std::sort(oplogTimestamps.begin(), oplogTimestamps.end());
+    ASSERT_EQUALS(3U, oplogTimestamps.size());
+    ASSERT_EQUALS(op1.getTimestamp(), oplogTimestamps[0]);
+    ASSERT_EQUALS(op3.getTimestamp(), oplogTimestamps[2]);
+    ASSERT_EQUALS(1U, appliedOpTimes.size());
+    ASSERT_EQUALS(op1.getOpTime(), appliedOpTimes[0]);
+    ASSERT_EQUALS(Timestamp(), consistencyMarkers->getOplogTruncateAfterPoint(_opCtx.get()));
+    ASSERT_EQUALS(op1.getOpTime(), consistencyMarkers->getMinValid(_opCtx.get()));
+
+    // The second batch is then applied without being written to the oplog again.
+    ASSERT_EQUALS(op3.getOpTime(),
+                  unittest::assertGet(multiApply(_opCtx.get(),
+                                                 writerPool.get(),
+                                                 std::move(nextOps),
+                                                 applyOperationFn,
+                                                 true,
+                                                 nullptr)));
+    ASSERT_EQUALS(3U, oplogTimestamps.size());
+    ASSERT_EQUALS(3U, appliedOpTimes.size());
+    ASSERT_EQUALS(op3.getOpTime(), consistencyMarkers->getMinValid(_opCtx.get()));
+}
+
 TEST_F(SyncTailTest, MultiApplyUpdatesTheTransactionTable) {
     // Set up the transactions collection, which can only be done by the primary.
     ASSERT_OK(ReplicationCoordinator::get(_opCtx.get())->setFollowerMode(MemberState::RS_PRIMARY));
@@ -954,6 +1131,66 @@ TEST_F(SyncTailTest, MultiSyncApplyFallsBackOnApplyingInsertsIndividuallyWhenGro
     ASSERT_EQUALS(1U, numFailedGroupedInserts);
 }
 
+TEST_F(SyncTailTest, MultiSyncApplyAppliesUpdatesAndDeletesOnACollectionInOneUnitOfWork) {
+    NamespaceString nss1("test." + _agent.getSuiteName() + "_" + _agent.getTestName() + "_1");
+    NamespaceString nss2("test." + _agent.getSuiteName() + "_" + _agent.getTestName() + "_2");
+    auto updateOp1 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss1, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+    OplogEntry deleteOp1(
+        OpTime(Timestamp(2, 0), 1), 1LL, OpTypeEnum::kDelete, nss1, BSON("_id" << 2));
+    auto updateOp2 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(3), 0), 1LL}, nss2, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+
+    std::vector<std::pair<BSONObj, bool>> operationsApplied;
+    auto syncApply = [&operationsApplied](OperationContext* opCtx, const BSONObj& op, bool) {
+        operationsApplied.emplace_back(op.copy(), opCtx->lockState()->inAWriteUnitOfWork());
+        return Status::OK();
+    };
+
+    MultiApplier::OperationPtrs ops = {&updateOp1, &deleteOp1, &updateOp2};
+    ASSERT_OK(multiSyncApply_noAbort(_opCtx.get(), &ops, syncApply));
+
+    ASSERT_EQUALS(3U, operationsApplied.size());
+    ASSERT_BSONOBJ_EQ(updateOp1.raw, operationsApplied[0].first);
+    ASSERT_TRUE(operationsApplied[0].second);
+    ASSERT_BSONOBJ_EQ(deleteOp1.raw, operationsApplied[1].first);
+    ASSERT_TRUE(operationsApplied[1].second);
+
+    // A lone op is not worth a group.
+    ASSERT_BSONOBJ_EQ(updateOp2.raw, operationsApplied[2].first);
+    ASSERT_FALSE(operationsApplied[2].second);
+}
+
+TEST_F(SyncTailTest, MultiSyncApplyFallsBackOnApplyingUpdatesIndividuallyWhenGroupFails) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto updateOp1 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+    auto updateOp2 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2), BSON("_id" << 2 << "x" << 1));
+
+    std::size_t numFailedGroups = 0;
+    MultiApplier::Operations operationsApplied;
+    auto syncApply = [&](OperationContext* opCtx, const BSONObj& op, bool) -> Status {
+        // Reject the second update when it is applied as part of a group.
+        if (opCtx->lockState()->inAWriteUnitOfWork() && OplogEntry(op) == updateOp2) {
+            numFailedGroups++;
+            return {ErrorCodes::OperationFailed, "group failed"};
+        }
+        if (!opCtx->lockState()->inAWriteUnitOfWork()) {
+            operationsApplied.push_back(OplogEntry(op));
+        }
+        return Status::OK();
+    };
+
+    MultiApplier::OperationPtrs ops = {&updateOp1, &updateOp2};
+    ASSERT_OK(multiSyncApply_noAbort(_opCtx.get(), &ops, syncApply));
+
+    ASSERT_EQUALS(1U, numFailedGroups);
+    ASSERT_EQUALS(2U, operationsApplied.size());
+    ASSERT_EQUALS(updateOp1, operationsApplied[0]);
+    ASSERT_EQUALS(updateOp2, operationsApplied[1]);
+}
+
 TEST_F(SyncTailTest, MultiInitialSyncApplyDisablesDocumentValidationWhileApplyingOperations) {
     SyncTailWithOperationContextChecker syncTail;
     NamespaceString nss("test.t");
@@ -319,12 +319,14 @@ HostAndPort TopologyCoordinatorImpl::chooseNewSyncSource(Date_t now,
                        << it->getHeartbeatAppliedOpTime().toBSON();
                 continue;
             }
-            // Candidate cannot be more latent than anything we've already considered.
+            // Candidate cannot be more latent than anything we've already considered, counting
+            // the load of members already syncing from each of them.
             if ((closestIndex != -1) &&
-                (_getPing(itMemberConfig.getHostAndPort()) >
-                 _getPing(_rsConfig.getMemberAt(closestIndex).getHostAndPort()))) {
+                (_getSyncSourceCost(itMemberConfig.getHostAndPort()) >
+                 _getSyncSourceCost(_rsConfig.getMemberAt(closestIndex).getHostAndPort()))) {
                 LOG(2) << "Cannot select sync source with higher latency than the best candidate: "
-                       << itMemberConfig.getHostAndPort();
+                       << itMemberConfig.getHostAndPort()
+                       << ", fanout: " << _getSyncSourceFanout(itMemberConfig.getHostAndPort());
 
                 continue;
             }
@@ -2516,6 +2518,28 @@ Milliseconds TopologyCoordinatorImpl::_getPing(const HostAndPort& host) {
     return _pings[host].getMillis();
 }
 
+int TopologyCoordinatorImpl::_getSyncSourceFanout(const HostAndPort& host) const {
+    int fanout = 0;
+    for (std::vector<MemberData>::const_iterator it = _memberData.begin(); it != _memberData.end();
+         ++it) {
+        if (indexOfIterator(_memberData, it) == _selfIndex || !it->up()) {
+            continue;
+        }
+        if (it->getSyncSource() == host) {
+            ++fanout;
+        }
+    }
+    return fanout;
+}
+
+Milliseconds TopologyCoordinatorImpl::_getSyncSourceCost(const HostAndPort& host) {
+    Milliseconds cost = _getPing(host);
+    if (_options.syncSourceFanoutPenalty > Milliseconds(0)) {
+        cost += _options.syncSourceFanoutPenalty * _getSyncSourceFanout(host);
+    }
+    return cost;
+}
+
 void TopologyCoordinatorImpl::_setElectionTime(const Timestamp& newElectionTime) {
     _electionTime = newElectionTime;
 }
@@ -127,6 +127,11 @@ public:
         // A sync source is re-evaluated after it lags behind further than this amount.
         Seconds maxSyncSourceLagSecs{0};
 
+        // Latency added to a sync source candidate's ping time for each other member already
+        // syncing from it, so that chained replication spreads across nodes with similar
+        // latency instead of piling onto one. Zero disables the penalty.
+        Milliseconds syncSourceFanoutPenalty{0};
+
         // Whether or not this node is running as a config server.
         ClusterRole clusterRole{ClusterRole::None};
     };
@@ -315,6 +320,14 @@ private:
     // Returns the current "ping" value for the given member by their address
     Milliseconds _getPing(const HostAndPort& host);
 
+    // Returns the number of up members, other than ourselves, whose latest heartbeat reports
+    // syncing from "host".
+    int _getSyncSourceFanout(const HostAndPort& host) const;
+
+    // Returns the ping time to "host" plus _options.syncSourceFanoutPenalty for each member
+    // already syncing from it. Used to rank sync source candidates.
+    Milliseconds _getSyncSourceCost(const HostAndPort& host);
+
     // Determines if we will veto the member specified by "args.id".
     // If we veto, the errmsg will be filled in with a reason
     bool _shouldVetoMember(const ReplicationCoordinator::ReplSetFreshArgs& args,
@@ -212,14 +212,16 @@ protected:
                                                 const std::string& setName,
                                                 MemberState memberState,
                                                 const OpTime& lastOpTimeSender,
-                                                Milliseconds roundTripTime = Milliseconds(1)) {
+                                                Milliseconds roundTripTime = Milliseconds(1),
+                                                const HostAndPort& syncingTo = HostAndPort()) {
         return _receiveHeartbeatHelper(Status::OK(),
                                        member,
                                        setName,
                                        memberState,
                                        Timestamp(),
                                        lastOpTimeSender,
-                                       roundTripTime);
+                                       roundTripTime,
+                                       syncingTo);
     }
 
 private:
@@ -229,9 +231,11 @@ private:
                                                     MemberState memberState,
                                                     Timestamp electionTime,
                                                     const OpTime& lastOpTimeSender,
-                                                    Milliseconds roundTripTime) {
+                                                    Milliseconds roundTripTime,
+                                                    const HostAndPort& syncingTo = HostAndPort()) {
         ReplSetHeartbeatResponse hb;
         hb.setConfigVersion(1);
+        hb.setSyncingTo(syncingTo);
         hb.setState(memberState);
         hb.setDurableOpTime(lastOpTimeSender);
         hb.setAppliedOpTime(lastOpTimeSender);
@@ -508,6 +512,75 @@ TEST_F(TopoCoordTest, NodeReturnsClosestValidSyncSourceAsSyncSource) {
     ASSERT(getTopoCoord().getSyncSourceAddress().empty());
 }
 
+TEST_F(TopoCoordTest, NodePrefersLessLoadedSyncSourceWhenFanoutPenaltyIsSet) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxSyncSourceLagSecs = Seconds{100};
+    options.syncSourceFanoutPenalty = Milliseconds(50);
+    setOptions(options);
+
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version"
+                      << 1
+                      << "members"
+                      << BSON_ARRAY(BSON("_id" << 1 << "host"
+                                               << "hself")
+                                    << BSON("_id" << 10 << "host"
+                                                  << "h1")
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2")
+                                    << BSON("_id" << 30 << "host"
+                                                  << "h3")
+                                    << BSON("_id" << 40 << "host"
+                                                  << "hprimary"))),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+    OpTime lastOpTimeWeApplied = OpTime(Timestamp(100, 0), 0);
+
+    // The primary is closest, but h2 and h3 already sync from it, so with a 50ms penalty per
+    // downstream member it costs 110ms against h1's 60ms.
+    for (int i = 0; i < 2; ++i) {
+        heartbeatFromMember(HostAndPort("h1"),
+                            "rs0",
+                            MemberState::RS_SECONDARY,
+                            OpTime(Timestamp(501, 0), 0),
+                            Milliseconds(60));
+        heartbeatFromMember(HostAndPort("h2"),
+                            "rs0",
+                            MemberState::RS_SECONDARY,
+                            OpTime(Timestamp(501, 0), 0),
+                            Milliseconds(300),
+                            HostAndPort("hprimary"));
+        heartbeatFromMember(HostAndPort("h3"),
+                            "rs0",
+                            MemberState::RS_SECONDARY,
+                            OpTime(Timestamp(501, 0), 0),
+                            Milliseconds(300),
+                            HostAndPort("hprimary"));
+        heartbeatFromMember(HostAndPort("hprimary"),
+                            "rs0",
+                            MemberState::RS_PRIMARY,
+                            OpTime(Timestamp(600, 0), 0),
+                            Milliseconds(10));
+    }
+
+    getTopoCoord().chooseNewSyncSource(
+        now()++, lastOpTimeWeApplied, TopologyCoordinator::ChainingPreference::kUseConfiguration);
+    ASSERT_EQUALS(HostAndPort("h1"), getTopoCoord().getSyncSourceAddress());
+
+    // Once h3 moves to sync from h1, h1 costs 110ms against the primary's 60ms.
+    heartbeatFromMember(HostAndPort("h3"),
+                        "rs0",
+                        MemberState::RS_SECONDARY,
+                        OpTime(Timestamp(501, 0), 0),
+                        Milliseconds(300),
+                        HostAndPort("h1"));
+    getTopoCoord().chooseNewSyncSource(
+        now()++, lastOpTimeWeApplied, TopologyCoordinator::ChainingPreference::kUseConfiguration);
+    ASSERT_EQUALS(HostAndPort("hprimary"), getTopoCoord().getSyncSourceAddress());
+}
+
 TEST_F(TopoCoordTest, NodeWontChooseSyncSourceFromOlderTerm) {
     updateConfig(BSON("_id"
                       << "rs0"
@@ -30,64 +30,107 @@
 
 #include "mongo/db/s/active_migrations_registry.h"
 
+#include <algorithm>
+
 #include "mongo/base/status_with.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/db/s/migration_source_manager.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(maxConcurrentChunkMigrationsPerShard, int, 1);
+
+namespace {
+
+/**
+ * Returns the currently configured limit of concurrent migrations per shard. Values lower than one
+ * are treated as one so that migrations can always make progress.
+ */
+size_t getMaxConcurrentMigrations() {
+    return static_cast<size_t>(std::max(1, maxConcurrentChunkMigrationsPerShard.load()));
+}
+
+}  // namespace
+
 ActiveMigrationsRegistry::ActiveMigrationsRegistry() = default;
 
 ActiveMigrationsRegistry::~ActiveMigrationsRegistry() {
-    invariant(!_activeMoveChunkState);
+    invariant(_activeMoveChunkStates.empty());
 }
 
 StatusWith<ScopedRegisterDonateChunk> ActiveMigrationsRegistry::registerDonateChunk(
     const MoveChunkRequest& args) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_activeReceiveChunkState) {
-        return _activeReceiveChunkState->constructErrorStatus();
+    if (!_activeReceiveChunkStates.empty()) {
+        return _activeReceiveChunkStates.front().constructErrorStatus();
     }
 
-    if (_activeMoveChunkState) {
-        if (_activeMoveChunkState->args == args) {
-            return {ScopedRegisterDonateChunk(nullptr, false, _activeMoveChunkState->notification)};
+    for (const auto& activeMoveChunkState : _activeMoveChunkStates) {
+        if (activeMoveChunkState.args == args) {
+            return {ScopedRegisterDonateChunk(nullptr, false, activeMoveChunkState.notification)};
         }
+    }
 
-        return _activeMoveChunkState->constructErrorStatus();
+    // Only one migration per collection can be running, because the migration source manager is
+    // installed on the collection's sharding state
+    for (const auto& activeMoveChunkState : _activeMoveChunkStates) {
+        if (activeMoveChunkState.args.getNss() == args.getNss()) {
+            return activeMoveChunkState.constructErrorStatus();
+        }
+    }
+
+    if (_activeMoveChunkStates.size() >= getMaxConcurrentMigrations()) {
+        return _activeMoveChunkStates.front().constructErrorStatus();
     }
 
-    _activeMoveChunkState.emplace(args);
+    _activeMoveChunkStates.emplace_back(args);
 
-    return {ScopedRegisterDonateChunk(this, true, _activeMoveChunkState->notification)};
+    return {ScopedRegisterDonateChunk(this, true, _activeMoveChunkStates.back().notification)};
 }
 
 StatusWith<ScopedRegisterReceiveChunk> ActiveMigrationsRegistry::registerReceiveChunk(
     const NamespaceString& nss, const ChunkRange& chunkRange, const ShardId& fromShardId) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_activeReceiveChunkState) {
-        return _activeReceiveChunkState->constructErrorStatus();
+    if (!_activeMoveChunkStates.empty()) {
+        return _activeMoveChunkStates.front().constructErrorStatus();
+    }
+
+    const size_t maxConcurrentMigrations = getMaxConcurrentMigrations();
+    if (_activeReceiveChunkStates.size() >= maxConcurrentMigrations) {
+        return _activeReceiveChunkStates.front().constructErrorStatus();
     }
 
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->constructErrorStatus();
+    // Hand out the lowest slot, which is not taken by any of the active receives. There is always
+    // one below the limit, because the number of active receives is below it.
+    std::vector<bool> slotsInUse(maxConcurrentMigrations, false);
+    for (const auto& activeReceiveChunkState : _activeReceiveChunkStates) {
+        if (activeReceiveChunkState.slot < maxConcurrentMigrations) {
+            slotsInUse[activeReceiveChunkState.slot] = true;
+        }
     }
 
-    _activeReceiveChunkState.emplace(nss, chunkRange, fromShardId);
+    const size_t slot =
+        std::find(slotsInUse.begin(), slotsInUse.end(), false) - slotsInUse.begin();
+    invariant(slot < maxConcurrentMigrations);
 
-    return {ScopedRegisterReceiveChunk(this)};
+    _activeReceiveChunkStates.emplace_back(nss, chunkRange, fromShardId, slot);
+
+    return {ScopedRegisterReceiveChunk(this, slot)};
 }
 
-boost::optional<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNss() {
+std::vector<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNamespaces() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->args.getNss();
+
+    std::vector<NamespaceString> namespaces;
+    for (const auto& activeMoveChunkState : _activeMoveChunkStates) {
+        namespaces.push_back(activeMoveChunkState.args.getNss());
     }
 
-    return boost::none;
+    return namespaces;
 }
 
 BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContext* opCtx) {
@@ -95,8 +138,8 @@ BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContex
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-        if (_activeMoveChunkState) {
-            nss = _activeMoveChunkState->args.getNss();
+        if (!_activeMoveChunkStates.empty()) {
+            nss = _activeMoveChunkStates.front().args.getNss();
         }
     }
 
@@ -117,16 +160,27 @@ BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContex
     return BSONObj();
 }
 
-void ActiveMigrationsRegistry::_clearDonateChunk() {
+void ActiveMigrationsRegistry::_clearDonateChunk(
+    const std::shared_ptr<Notification<Status>>& completionNotification) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    invariant(_activeMoveChunkState);
-    _activeMoveChunkState.reset();
+    auto it = std::find_if(_activeMoveChunkStates.begin(),
+                           _activeMoveChunkStates.end(),
+                           [&](const ActiveMoveChunkState& activeMoveChunkState) {
+                               return activeMoveChunkState.notification == completionNotification;
+                           });
+    invariant(it != _activeMoveChunkStates.end());
+    _activeMoveChunkStates.erase(it);
 }
 
-void ActiveMigrationsRegistry::_clearReceiveChunk() {
+void ActiveMigrationsRegistry::_clearReceiveChunk(size_t slot) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    invariant(_activeReceiveChunkState);
-    _activeReceiveChunkState.reset();
+    auto it = std::find_if(_activeReceiveChunkStates.begin(),
+                           _activeReceiveChunkStates.end(),
+                           [&](const ActiveReceiveChunkState& activeReceiveChunkState) {
+                               return activeReceiveChunkState.slot == slot;
+                           });
+    invariant(it != _activeReceiveChunkStates.end());
+    _activeReceiveChunkStates.erase(it);
 }
 
 Status ActiveMigrationsRegistry::ActiveMoveChunkState::constructErrorStatus() const {
@@ -163,7 +217,7 @@ ScopedRegisterDonateChunk::~ScopedRegisterDonateChunk() {
     if (_registry && _forUnregister) {
         // If this is a newly started migration the caller must always signal on completion
         invariant(*_completionNotification);
-        _registry->_clearDonateChunk();
+        _registry->_clearDonateChunk(_completionNotification);
     }
 }
 
@@ -192,12 +246,13 @@ Status ScopedRegisterDonateChunk::waitForCompletion(OperationContext* opCtx) {
     return _completionNotification->get(opCtx);
 }
 
-ScopedRegisterReceiveChunk::ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry)
-    : _registry(registry) {}
+ScopedRegisterReceiveChunk::ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry,
+                                                       size_t slot)
+    : _registry(registry), _slot(slot) {}
 
 ScopedRegisterReceiveChunk::~ScopedRegisterReceiveChunk() {
     if (_registry) {
-        _registry->_clearReceiveChunk();
+        _registry->_clearReceiveChunk(_slot);
     }
 }
 
@@ -210,6 +265,7 @@ ScopedRegisterReceiveChunk& ScopedRegisterReceiveChunk::operator=(
     if (&other != this) {
         _registry = other._registry;
         other._registry = nullptr;
+        _slot = other._slot;
     }
 
     return *this;
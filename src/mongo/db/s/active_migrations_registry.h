@@ -29,8 +29,11 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <list>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/s/move_chunk_request.h"
 #include "mongo/stdx/memory.h"
@@ -45,9 +48,16 @@ class ScopedRegisterReceiveChunk;
 template <typename T>
 class StatusWith;
 
+/**
+ * Maximum number of chunks, which a shard is allowed to donate or receive at the same time. Can be
+ * changed at runtime and takes effect for migrations which are registered afterwards.
+ */
+extern AtomicInt32 maxConcurrentChunkMigrationsPerShard;
+
 /**
  * Thread-safe object, which keeps track of the active migrations running on a node and limits them
- * to only one per-shard. There is only one instance of this object per shard.
+ * to maxConcurrentChunkMigrationsPerShard per-shard. A shard can either be donating or receiving
+ * chunks at any given time, but not both. There is only one instance of this object per shard.
  */
 class ActiveMigrationsRegistry {
     MONGO_DISALLOW_COPYING(ActiveMigrationsRegistry);
@@ -57,9 +67,10 @@ public:
     ~ActiveMigrationsRegistry();
 
     /**
-     * If there are no migrations running on this shard, registers an active migration with the
-     * specified arguments and returns a ScopedRegisterDonateChunk, which must be signaled by the
-     * caller before it goes out of scope.
+     * If this shard is not receiving any chunks, is not already donating a chunk of the same
+     * collection and is below the concurrent migrations limit, registers an active migration with
+     * the specified arguments and returns a ScopedRegisterDonateChunk, which must be signaled by
+     * the caller before it goes out of scope.
      *
      * If there is an active migration already running on this shard and it has the exact same
      * arguments, returns a ScopedRegisterDonateChunk, which can be used to join the already running
@@ -70,9 +81,11 @@ public:
     StatusWith<ScopedRegisterDonateChunk> registerDonateChunk(const MoveChunkRequest& args);
 
     /**
-     * If there are no migrations running on this shard, registers an active receive operation with
-     * the specified session id and returns a ScopedRegisterReceiveChunk, which will unregister it
-     * when it goes out of scope.
+     * If this shard is not donating any chunks and is below the concurrent migrations limit,
+     * registers an active receive operation for the specified chunk and returns a
+     * ScopedRegisterReceiveChunk, which will unregister it when it goes out of scope. The returned
+     * object carries a slot number, which is unique among the currently active receives and is
+     * always lower than the concurrent migrations limit at the time of registration.
      *
      * Otherwise returns a ConflictingOperationInProgress error.
      */
@@ -81,14 +94,14 @@ public:
                                                                 const ShardId& fromShardId);
 
     /**
-     * If a migration has been previously registered through a call to registerDonateChunk returns
-     * that namespace. Otherwise returns boost::none.
+     * Returns the namespaces of all the migrations, which have been previously registered through a
+     * call to registerDonateChunk and are still active, in order of registration.
      */
-    boost::optional<NamespaceString> getActiveDonateChunkNss();
+    std::vector<NamespaceString> getActiveDonateChunkNamespaces();
 
     /**
-     * Returns a report on the active migration if there currently is one. Otherwise, returns an
-     * empty BSONObj.
+     * Returns a report on the oldest active donate migration if there currently is one. Otherwise,
+     * returns an empty BSONObj.
      *
      * Takes an IS lock on the namespace of the active migration, if one is active.
      */
@@ -117,8 +130,14 @@ private:
 
     // Describes the state of a currently active receive chunk operation
     struct ActiveReceiveChunkState {
-        ActiveReceiveChunkState(NamespaceString inNss, ChunkRange inRange, ShardId inFromShardId)
-            : nss(std::move(inNss)), range(std::move(inRange)), fromShardId(inFromShardId) {}
+        ActiveReceiveChunkState(NamespaceString inNss,
+                                ChunkRange inRange,
+                                ShardId inFromShardId,
+                                size_t inSlot)
+            : nss(std::move(inNss)),
+              range(std::move(inRange)),
+              fromShardId(inFromShardId),
+              slot(inSlot) {}
 
         /**
          * Constructs an error status to return in the case of conflicting operations.
@@ -133,30 +152,33 @@ private:
 
         // Id of the shard from which the chunk is being received
         ShardId fromShardId;
+
+        // Slot number handed out to the receive operation
+        size_t slot;
     };
 
     /**
-     * Unregisters a previously registered namespace with ongoing migration. Must only be called if
-     * a previous call to registerDonateChunk has succeeded.
+     * Unregisters a previously registered namespace with ongoing migration, identified by its
+     * completion notification. Must only be called if a previous call to registerDonateChunk has
+     * succeeded.
      */
-    void _clearDonateChunk();
+    void _clearDonateChunk(const std::shared_ptr<Notification<Status>>& completionNotification);
 
     /**
-     * Unregisters a previously registered incoming migration. Must only be called if a previous
-     * call to registerReceiveChunk has succeeded.
+     * Unregisters a previously registered incoming migration, which was given the specified slot.
+     * Must only be called if a previous call to registerReceiveChunk has succeeded.
      */
-    void _clearReceiveChunk();
+    void _clearReceiveChunk(size_t slot);
 
     // Protects the state below
     stdx::mutex _mutex;
 
-    // If there is an active moveChunk operation going on, this field contains the request, which
-    // initiated it
-    boost::optional<ActiveMoveChunkState> _activeMoveChunkState;
+    // Contains the requests of the active moveChunk operations, in order of registration. Each of
+    // them is for a different collection.
+    std::list<ActiveMoveChunkState> _activeMoveChunkStates;
 
-    // If there is an active receive of a chunk going on, this field contains the session id, which
-    // initiated it
-    boost::optional<ActiveReceiveChunkState> _activeReceiveChunkState;
+    // Contains the active receives of chunks, in order of registration
+    std::list<ActiveReceiveChunkState> _activeReceiveChunkStates;
 };
 
 /**
@@ -216,15 +238,26 @@ class ScopedRegisterReceiveChunk {
     MONGO_DISALLOW_COPYING(ScopedRegisterReceiveChunk);
 
 public:
-    ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry);
+    ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry, size_t slot);
     ~ScopedRegisterReceiveChunk();
 
     ScopedRegisterReceiveChunk(ScopedRegisterReceiveChunk&&);
     ScopedRegisterReceiveChunk& operator=(ScopedRegisterReceiveChunk&&);
 
+    /**
+     * Returns the slot number, which was assigned to the receive operation at registration time.
+     * It stays reserved for as long as this object is registered.
+     */
+    size_t getSlot() const {
+        return _slot;
+    }
+
 private:
     // Registry from which to unregister the migration. Not owned.
     ActiveMigrationsRegistry* _registry;
+
+    // Slot assigned to this receive operation
+    size_t _slot;
 };
 
 }  // namespace mongo
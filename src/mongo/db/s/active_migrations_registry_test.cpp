@@ -49,6 +49,8 @@ protected:
     }
 
     void tearDown() override {
+        maxConcurrentChunkMigrationsPerShard.store(1);
+
         _opCtx.reset();
         _client.reset();
     }
@@ -99,14 +101,16 @@ TEST_F(MoveChunkRegistration, ScopedRegisterDonateChunkMoveConstructorAndAssignm
 }
 
 TEST_F(MoveChunkRegistration, GetActiveMigrationNamespace) {
-    ASSERT(!_registry.getActiveDonateChunkNss());
+    ASSERT(_registry.getActiveDonateChunkNamespaces().empty());
 
     const NamespaceString nss("TestDB", "TestColl");
 
     auto originalScopedRegisterDonateChunk =
         assertGet(_registry.registerDonateChunk(createMoveChunkRequest(nss)));
 
-    ASSERT_EQ(nss.ns(), _registry.getActiveDonateChunkNss()->ns());
+    const auto namespaces = _registry.getActiveDonateChunkNamespaces();
+    ASSERT_EQ(1U, namespaces.size());
+    ASSERT_EQ(nss.ns(), namespaces.front().ns());
 
     // Need to signal the registered migration so the destructor doesn't invariant
     originalScopedRegisterDonateChunk.complete(Status::OK());
@@ -138,5 +142,110 @@ TEST_F(MoveChunkRegistration, SecondMigrationWithSameArgumentsJoinsFirst) {
               secondScopedRegisterDonateChunk.waitForCompletion(getTxn()));
 }
 
+TEST_F(MoveChunkRegistration, ConcurrentDonationsOfDifferentCollections) {
+    maxConcurrentChunkMigrationsPerShard.store(2);
+
+    auto firstScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl1"))));
+    auto secondScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl2"))));
+    ASSERT(firstScopedRegisterDonateChunk.mustExecute());
+    ASSERT(secondScopedRegisterDonateChunk.mustExecute());
+    ASSERT_EQ(2U, _registry.getActiveDonateChunkNamespaces().size());
+
+    // Above the limit
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry
+                  .registerDonateChunk(
+                      createMoveChunkRequest(NamespaceString("TestDB", "TestColl3")))
+                  .getStatus());
+
+    // Receiving is not allowed while donating
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry
+                  .registerReceiveChunk(NamespaceString("TestDB", "TestColl3"),
+                                        ChunkRange(BSON("Key" << 0), BSON("Key" << 10)),
+                                        ShardId("shard0001"))
+                  .getStatus());
+
+    // Completing the first donation makes room for another one
+    firstScopedRegisterDonateChunk.complete(Status::OK());
+    {
+        ScopedRegisterDonateChunk completed(std::move(firstScopedRegisterDonateChunk));
+    }
+
+    const auto namespaces = _registry.getActiveDonateChunkNamespaces();
+    ASSERT_EQ(1U, namespaces.size());
+    ASSERT_EQ("TestDB.TestColl2", namespaces.front().ns());
+
+    auto thirdScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl3"))));
+
+    secondScopedRegisterDonateChunk.complete(Status::OK());
+    thirdScopedRegisterDonateChunk.complete(Status::OK());
+}
+
+TEST_F(MoveChunkRegistration, ConcurrentDonationsOfSameCollectionConflict) {
+    maxConcurrentChunkMigrationsPerShard.store(2);
+
+    auto originalScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl"))));
+
+    BSONObjBuilder builder;
+    MoveChunkRequest::appendAsCommand(
+        &builder,
+        NamespaceString("TestDB", "TestColl"),
+        ChunkVersion(1, 2, OID::gen()),
+        assertGet(ConnectionString::parse("TestConfigRS/CS1:12345,CS2:12345,CS3:12345")),
+        ShardId("shard0001"),
+        ShardId("shard0003"),
+        ChunkRange(BSON("Key" << 100), BSON("Key" << 200)),
+        1024,
+        MigrationSecondaryThrottleOptions::create(MigrationSecondaryThrottleOptions::kOff),
+        true);
+    const auto otherChunkRequest = assertGet(
+        MoveChunkRequest::createFromCommand(NamespaceString("TestDB", "TestColl"), builder.obj()));
+
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry.registerDonateChunk(otherChunkRequest).getStatus());
+
+    originalScopedRegisterDonateChunk.complete(Status::OK());
+}
+
+TEST_F(MoveChunkRegistration, ConcurrentReceivesGetDistinctSlots) {
+    maxConcurrentChunkMigrationsPerShard.store(2);
+
+    const NamespaceString nss("TestDB", "TestColl");
+
+    auto firstScopedRegisterReceiveChunk = assertGet(_registry.registerReceiveChunk(
+        nss, ChunkRange(BSON("Key" << 0), BSON("Key" << 10)), ShardId("shard0001")));
+    auto secondScopedRegisterReceiveChunk = assertGet(_registry.registerReceiveChunk(
+        nss, ChunkRange(BSON("Key" << 10), BSON("Key" << 20)), ShardId("shard0002")));
+    ASSERT_EQ(0U, firstScopedRegisterReceiveChunk.getSlot());
+    ASSERT_EQ(1U, secondScopedRegisterReceiveChunk.getSlot());
+
+    // Above the limit
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry
+                  .registerReceiveChunk(nss,
+                                        ChunkRange(BSON("Key" << 20), BSON("Key" << 30)),
+                                        ShardId("shard0003"))
+                  .getStatus());
+
+    // Donating is not allowed while receiving
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry.registerDonateChunk(createMoveChunkRequest(NamespaceString("TestDB", "X")))
+                  .getStatus());
+
+    // The slot of a completed receive gets reused
+    {
+        ScopedRegisterReceiveChunk completed(std::move(firstScopedRegisterReceiveChunk));
+    }
+
+    auto thirdScopedRegisterReceiveChunk = assertGet(_registry.registerReceiveChunk(
+        nss, ChunkRange(BSON("Key" << 20), BSON("Key" << 30)), ShardId("shard0003")));
+    ASSERT_EQ(0U, thirdScopedRegisterReceiveChunk.getSlot());
+}
+
 }  // namespace
 }  // namespace mongo
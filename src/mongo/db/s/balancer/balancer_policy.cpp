@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include <algorithm>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
@@ -218,6 +220,57 @@ string DistributionStatus::toString() const {
     return builder.obj().toString();
 }
 
+ShardMigrationSlots::ShardMigrationSlots(size_t maxMigrationsPerShard)
+    : _maxMigrationsPerShard(std::max<size_t>(1, maxMigrationsPerShard)) {}
+
+bool ShardMigrationSlots::canDonate(const ShardId& shardId, const NamespaceString& nss) const {
+    auto it = _usage.find(shardId);
+    if (it == _usage.end()) {
+        return true;
+    }
+
+    const auto& usage = it->second;
+    return !usage.numReceiving && usage.donating.size() < _maxMigrationsPerShard &&
+        !usage.donating.count(nss.ns());
+}
+
+bool ShardMigrationSlots::canReceive(const ShardId& shardId) const {
+    auto it = _usage.find(shardId);
+    if (it == _usage.end()) {
+        return true;
+    }
+
+    const auto& usage = it->second;
+    return usage.donating.empty() && usage.numReceiving < _maxMigrationsPerShard;
+}
+
+size_t ShardMigrationSlots::numReceiving(const ShardId& shardId) const {
+    auto it = _usage.find(shardId);
+    return (it == _usage.end()) ? 0 : it->second.numReceiving;
+}
+
+size_t ShardMigrationSlots::numReceiving(const ShardId& shardId, const NamespaceString& nss) const {
+    auto it = _usage.find(shardId);
+    if (it == _usage.end()) {
+        return 0;
+    }
+
+    auto itColl = it->second.receiving.find(nss.ns());
+    return (itColl == it->second.receiving.end()) ? 0 : itColl->second;
+}
+
+void ShardMigrationSlots::add(const MigrateInfo& migration) {
+    const NamespaceString nss(migration.ns);
+    invariant(canDonate(migration.from, nss));
+    invariant(canReceive(migration.to));
+
+    invariant(_usage[migration.from].donating.insert(migration.ns).second);
+
+    auto& recipientUsage = _usage[migration.to];
+    recipientUsage.receiving[migration.ns]++;
+    recipientUsage.numReceiving++;
+}
+
 Status BalancerPolicy::isShardSuitableReceiver(const ClusterStatistics::ShardStatistics& stat,
                                                const string& chunkTag) {
     if (stat.isSizeMaxed()) {
@@ -241,12 +294,13 @@ Status BalancerPolicy::isShardSuitableReceiver(const ClusterStatistics::ShardSta
 ShardId BalancerPolicy::_getLeastLoadedReceiverShard(const ShardStatisticsVector& shardStats,
                                                      const DistributionStatus& distribution,
                                                      const string& tag,
-                                                     const set<ShardId>& excludedShards) {
+                                                     const ShardMigrationSlots& usedShards) {
     ShardId best;
-    unsigned minChunks = numeric_limits<unsigned>::max();
+    size_t minChunks = numeric_limits<size_t>::max();
+    size_t minReceiving = numeric_limits<size_t>::max();
 
     for (const auto& stat : shardStats) {
-        if (excludedShards.count(stat.shardId))
+        if (!usedShards.canReceive(stat.shardId))
             continue;
 
         auto status = isShardSuitableReceiver(stat, tag);
@@ -254,13 +308,17 @@ ShardId BalancerPolicy::_getLeastLoadedReceiverShard(const ShardStatisticsVector
             continue;
         }
 
-        unsigned myChunks = distribution.numberOfChunksInShard(stat.shardId);
-        if (myChunks >= minChunks) {
+        // Chunks, which are already on their way to the shard, count as if they were there
+        const size_t myChunks = distribution.numberOfChunksInShard(stat.shardId) +
+            usedShards.numReceiving(stat.shardId, distribution.nss());
+        const size_t myReceiving = usedShards.numReceiving(stat.shardId);
+        if (myChunks > minChunks || (myChunks == minChunks && myReceiving >= minReceiving)) {
             continue;
         }
 
         best = stat.shardId;
         minChunks = myChunks;
+        minReceiving = myReceiving;
     }
 
     return best;
@@ -269,12 +327,12 @@ ShardId BalancerPolicy::_getLeastLoadedReceiverShard(const ShardStatisticsVector
 ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& shardStats,
                                                 const DistributionStatus& distribution,
                                                 const string& chunkTag,
-                                                const set<ShardId>& excludedShards) {
+                                                const ShardMigrationSlots& usedShards) {
     ShardId worst;
     unsigned maxChunks = 0;
 
     for (const auto& stat : shardStats) {
-        if (excludedShards.count(stat.shardId))
+        if (!usedShards.canDonate(stat.shardId, distribution.nss()))
             continue;
 
         const unsigned shardChunkCount =
@@ -292,11 +350,15 @@ ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& sha
 vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
                                             bool shouldAggressivelyBalance) {
-    vector<MigrateInfo> migrations;
+    ShardMigrationSlots usedShards(1);
+    return balance(shardStats, distribution, shouldAggressivelyBalance, &usedShards);
+}
 
-    // Set of shards, which have already been used for migrations. Used so we don't return multiple
-    // migrations for the same shard.
-    set<ShardId> usedShards;
+vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            bool shouldAggressivelyBalance,
+                                            ShardMigrationSlots* usedShards) {
+    vector<MigrateInfo> migrations;
 
     // 1) Check for shards, which are in draining mode
     {
@@ -304,7 +366,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             if (!stat.isDraining)
                 continue;
 
-            if (usedShards.count(stat.shardId))
+            if (!usedShards->canDonate(stat.shardId, distribution.nss()))
                 continue;
 
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
@@ -326,7 +388,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                 const string tag = distribution.getTagForChunk(chunk);
 
                 const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, usedShards);
+                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString())
@@ -337,8 +399,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 invariant(to != stat.shardId);
                 migrations.emplace_back(to, chunk);
-                invariant(usedShards.insert(stat.shardId).second);
-                invariant(usedShards.insert(to).second);
+                usedShards->add(migrations.back());
                 break;
             }
 
@@ -352,7 +413,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
     // 2) Check for chunks, which are on the wrong shard and must be moved off of it
     if (!distribution.tags().empty()) {
         for (const auto& stat : shardStats) {
-            if (usedShards.count(stat.shardId))
+            if (!usedShards->canDonate(stat.shardId, distribution.nss()))
                 continue;
 
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
@@ -373,7 +434,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                 }
 
                 const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, usedShards);
+                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString()) << " violates zone "
@@ -384,8 +445,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 invariant(to != stat.shardId);
                 migrations.emplace_back(to, chunk);
-                invariant(usedShards.insert(stat.shardId).second);
-                invariant(usedShards.insert(to).second);
+                usedShards->add(migrations.back());
                 break;
             }
         }
@@ -434,7 +494,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                   idealNumberOfChunksPerShardForTag,
                                   imbalanceThreshold,
                                   &migrations,
-                                  &usedShards))
+                                  usedShards))
             ;
     }
 
@@ -447,8 +507,8 @@ boost::optional<MigrateInfo> BalancerPolicy::balanceSingleChunk(
     const DistributionStatus& distribution) {
     const string tag = distribution.getTagForChunk(chunk);
 
-    ShardId newShardId =
-        _getLeastLoadedReceiverShard(shardStats, distribution, tag, set<ShardId>());
+    ShardId newShardId = _getLeastLoadedReceiverShard(
+        shardStats, distribution, tag, ShardMigrationSlots(1));
     if (!newShardId.isValid() || newShardId == chunk.getShard()) {
         return boost::optional<MigrateInfo>();
     }
@@ -462,7 +522,7 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
                                         size_t idealNumberOfChunksPerShardForTag,
                                         size_t imbalanceThreshold,
                                         vector<MigrateInfo>* migrations,
-                                        set<ShardId>* usedShards) {
+                                        ShardMigrationSlots* usedShards) {
     const ShardId from = _getMostOverloadedShard(shardStats, distribution, tag, *usedShards);
     if (!from.isValid())
         return false;
@@ -481,7 +541,8 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
         return false;
     }
 
-    const size_t min = distribution.numberOfChunksInShardWithTag(to, tag);
+    const size_t min = distribution.numberOfChunksInShardWithTag(to, tag) +
+        usedShards->numReceiving(to, distribution.nss());
 
     // Do not use a shard if it already has more entries than the optimal per-shard chunk count
     if (min >= idealNumberOfChunksPerShardForTag)
@@ -514,8 +575,7 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
         }
 
         migrations->emplace_back(to, chunk);
-        invariant(usedShards->insert(chunk.getShard()).second);
-        invariant(usedShards->insert(to).second);
+        usedShards->add(migrations->back());
         return true;
     }
 
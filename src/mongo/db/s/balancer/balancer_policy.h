@@ -156,6 +156,59 @@ private:
     std::set<std::string> _allTags;
 };
 
+/**
+ * Keeps track of the migrations, which have already been selected during a balancer round, so
+ * that the ones selected afterwards respect the concurrency limits, which the shards enforce. A
+ * shard can either be donating or receiving chunks, but not both, and it can be part of at most
+ * 'maxMigrationsPerShard' migrations. It can donate only one chunk of any particular collection at
+ * a time, but it can receive several chunks of the same collection from different donors.
+ */
+class ShardMigrationSlots {
+public:
+    explicit ShardMigrationSlots(size_t maxMigrationsPerShard);
+
+    /**
+     * Returns whether the specified shard can be selected to donate a chunk of the specified
+     * collection.
+     */
+    bool canDonate(const ShardId& shardId, const NamespaceString& nss) const;
+
+    /**
+     * Returns whether the specified shard can be selected to receive a chunk.
+     */
+    bool canReceive(const ShardId& shardId) const;
+
+    /**
+     * Returns the number of chunks, which the specified shard has been selected to receive in total
+     * or only for the specified collection.
+     */
+    size_t numReceiving(const ShardId& shardId) const;
+    size_t numReceiving(const ShardId& shardId, const NamespaceString& nss) const;
+
+    /**
+     * Records that the specified migration has been selected. Its donor and recipient must have
+     * been checked with canDonate and canReceive respectively.
+     */
+    void add(const MigrateInfo& migration);
+
+private:
+    // Migrations involving a single shard
+    struct ShardUsage {
+        // Namespaces of the collections, whose chunks the shard is donating
+        std::set<std::string> donating;
+
+        // Number of chunks being received for each collection and in total
+        std::map<std::string, size_t> receiving;
+        size_t numReceiving{0};
+    };
+
+    // Maximum number of migrations in which a shard can be taking part
+    const size_t _maxMigrationsPerShard;
+
+    // Shards, which take part in at least one migration
+    std::map<ShardId, ShardUsage> _usage;
+};
+
 class BalancerPolicy {
 public:
     /**
@@ -179,6 +232,19 @@ public:
      *
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
+     *
+     * The 'usedShards' parameter contains the migrations already selected for other collections
+     * during the same round and is updated with the newly suggested ones. Recipients, which already
+     * receive fewer chunks, are preferred among equally loaded shards so that the concurrent
+     * migrations are spread out.
+     */
+    static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            bool shouldAggressivelyBalance,
+                                            ShardMigrationSlots* usedShards);
+
+    /**
+     * Same as above, but only suggests one migration per shard.
      */
     static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
@@ -194,22 +260,24 @@ public:
 
 private:
     /**
-     * Return the shard with the specified tag, which has the least number of chunks. If the tag is
-     * empty, considers all shards.
+     * Return the shard with the specified tag, which has the least number of chunks, counting the
+     * ones it has already been selected to receive. If the tag is empty, considers all shards. Only
+     * shards, which can still receive chunks according to 'usedShards', are considered.
      */
     static ShardId _getLeastLoadedReceiverShard(const ShardStatisticsVector& shardStats,
                                                 const DistributionStatus& distribution,
                                                 const std::string& tag,
-                                                const std::set<ShardId>& excludedShards);
+                                                const ShardMigrationSlots& usedShards);
 
     /**
      * Return the shard which has the least number of chunks with the specified tag. If the tag is
-     * empty, considers all chunks.
+     * empty, considers all chunks. Only shards, which can still donate chunks of the collection
+     * according to 'usedShards', are considered.
      */
     static ShardId _getMostOverloadedShard(const ShardStatisticsVector& shardStats,
                                            const DistributionStatus& distribution,
                                            const std::string& chunkTag,
-                                           const std::set<ShardId>& excludedShards);
+                                           const ShardMigrationSlots& usedShards);
 
     /**
      * Selects one chunk for the specified zone (if appropriate) to be moved in order to bring the
@@ -229,7 +297,7 @@ private:
                                    size_t idealNumberOfChunksPerShardForTag,
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
-                                   std::set<ShardId>* usedShards);
+                                   ShardMigrationSlots* usedShards);
 };
 
 }  // namespace mongo
@@ -190,6 +190,92 @@ TEST(BalancerPolicy, ParallelBalancing) {
     ASSERT_BSONOBJ_EQ(cluster.second[kShardId1][0].getMax(), migrations[1].maxKey);
 }
 
+TEST(BalancerPolicy, ConcurrentMigrationsToEmptyShard) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId1, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId2, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId3, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    ShardMigrationSlots usedShards(3);
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false, &usedShards));
+    ASSERT_EQ(3U, migrations.size());
+
+    std::set<ShardId> donors;
+    for (const auto& migration : migrations) {
+        ASSERT_EQ(kShardId3, migration.to);
+        donors.insert(migration.from);
+    }
+    ASSERT_EQ(3U, donors.size());
+    ASSERT_EQ(3U, usedShards.numReceiving(kShardId3));
+    ASSERT(!usedShards.canReceive(kShardId3));
+}
+
+TEST(BalancerPolicy, ConcurrentMigrationsSpreadAcrossRecipients) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId1, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0},
+         {ShardStatistics(kShardId3, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    ShardMigrationSlots usedShards(2);
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false, &usedShards));
+    ASSERT_EQ(2U, migrations.size());
+    ASSERT_EQ(kShardId2, migrations[0].to);
+    ASSERT_EQ(kShardId3, migrations[1].to);
+}
+
+TEST(BalancerPolicy, ConcurrentMigrationsLimitIsSharedAcrossCollections) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    // Produces a copy of the chunk distribution for a different collection
+    auto chunksForCollection = [&](const NamespaceString& nss) {
+        ShardToChunksMap shardToChunksMap(cluster.second);
+        for (auto& entry : shardToChunksMap) {
+            for (auto& chunk : entry.second) {
+                chunk.setNS(nss.ns());
+            }
+        }
+        return shardToChunksMap;
+    };
+
+    const NamespaceString nss2("TestDB", "TestColl2");
+    const NamespaceString nss3("TestDB", "TestColl3");
+
+    ShardMigrationSlots usedShards(2);
+    ASSERT_EQ(1U,
+              BalancerPolicy::balance(cluster.first,
+                                      DistributionStatus(kNamespace, cluster.second),
+                                      false,
+                                      &usedShards)
+                  .size());
+
+    // The same collection cannot be donated twice at the same time
+    ASSERT(BalancerPolicy::balance(cluster.first,
+                                   DistributionStatus(kNamespace, cluster.second),
+                                   false,
+                                   &usedShards)
+               .empty());
+
+    ASSERT_EQ(1U,
+              BalancerPolicy::balance(cluster.first,
+                                      DistributionStatus(nss2, chunksForCollection(nss2)),
+                                      false,
+                                      &usedShards)
+                  .size());
+
+    // Both shards have used up their slots
+    ASSERT(BalancerPolicy::balance(cluster.first,
+                                   DistributionStatus(nss3, chunksForCollection(nss3)),
+                                   false,
+                                   &usedShards)
+               .empty());
+}
+
 TEST(BalancerPolicy, ParallelBalancingDoesNotPutChunksOnShardsAboveTheOptimal) {
     auto cluster = generateCluster(
         {{ShardStatistics(kShardId0, kNoMaxSize, 100, false, emptyTagSet, emptyShardVersion), 100},
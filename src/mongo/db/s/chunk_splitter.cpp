@@ -41,6 +41,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/split_chunk.h"
 #include "mongo/db/s/split_vector.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -55,6 +56,10 @@
 namespace mongo {
 namespace {
 
+// Number of shard key samples used to estimate the split points of a chunk when auto-splitting. A
+// value of 0 always scans the full range of the shard key index.
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitVectorSampleSize, int, 1000);
+
 /**
  * Constructs the default options for the thread pool used to schedule splits.
  */
@@ -313,16 +318,15 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
                << " dataWritten since last check: " << dataWritten
                << " maxChunkSizeBytes: " << maxChunkSizeBytes;
 
-        auto splitPoints = uassertStatusOK(splitVector(opCtx.get(),
-                                                       nss,
-                                                       cm->getShardKeyPattern().toBSON(),
-                                                       chunk->getMin(),
-                                                       chunk->getMax(),
-                                                       false,
-                                                       boost::none,
-                                                       boost::none,
-                                                       boost::none,
-                                                       maxChunkSizeBytes));
+        auto splitPoints = uassertStatusOK(
+            splitVectorSampled(opCtx.get(),
+                               nss,
+                               cm->getShardKeyPattern().toBSON(),
+                               chunk->getMin(),
+                               chunk->getMax(),
+                               boost::none,
+                               maxChunkSizeBytes,
+                               std::max(0, autoSplitVectorSampleSize.load())));
 
         if (splitPoints.size() <= 1) {
             // No split points means there isn't enough data to split on; 1 split point means we
@@ -0,0 +1,246 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/collection_metadata_warmer.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/shard_metadata_util.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/catalog/type_shard_collection.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+// Number of collections whose metadata is refreshed concurrently when a shard primary steps up.
+// A value of 0 turns off the warm-up, leaving each collection to be refreshed by the first
+// versioned request for it.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(shardMetadataWarmUpThreads, int, 8);
+
+/**
+ * Constructs the options for the thread pool on which the collections are refreshed.
+ */
+ThreadPool::Options makeDefaultThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "CollectionMetadataWarmer";
+    options.minThreads = 0;
+    options.maxThreads = std::max(1, shardMetadataWarmUpThreads);
+
+    // Ensure all threads have a client
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    return options;
+}
+
+}  // namespace
+
+CollectionMetadataWarmer::CollectionMetadataWarmer()
+    : _threadPool(makeDefaultThreadPoolOptions()) {
+    _threadPool.startup();
+}
+
+CollectionMetadataWarmer::~CollectionMetadataWarmer() {
+    interruptWarmUp();
+    _threadPool.shutdown();
+    _threadPool.join();
+    invariant(_contexts.isEmpty());
+}
+
+void CollectionMetadataWarmer::initiateWarmUp() {
+    if (shardMetadataWarmUpThreads <= 0) {
+        return;
+    }
+
+    long long term;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        term = ++_term;
+        _contexts.resetInterrupt();
+
+        _inProgress = true;
+        _startTime = Date_t::now();
+        _duration = Milliseconds(0);
+        _numCollections = 0;
+        _numPending = 0;
+        _numRefreshed = 0;
+        _numFailed = 0;
+    }
+
+    Status status = _threadPool.schedule([this, term]() noexcept { _scheduleRefreshes(term); });
+    if (!status.isOK()) {
+        warning() << "Failed to schedule the warm-up of the collection metadata"
+                  << causedBy(status);
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inProgress = false;
+    }
+}
+
+void CollectionMetadataWarmer::interruptWarmUp() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_term;
+    _contexts.interrupt(ErrorCodes::PrimarySteppedDown);
+
+    if (_inProgress) {
+        _inProgress = false;
+        _duration = Date_t::now() - _startTime;
+        log() << "Interrupted the warm-up of the collection metadata after refreshing "
+              << _numRefreshed << " of " << _numCollections << " collections";
+    }
+}
+
+void CollectionMetadataWarmer::report(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("inProgress", _inProgress);
+    builder->append("collections", _numCollections);
+    builder->append("refreshed", _numRefreshed);
+    builder->append("failed", _numFailed);
+    builder->append("pending", _numPending);
+    builder->append("durationMillis",
+                    durationCount<Milliseconds>(_inProgress ? Date_t::now() - _startTime
+                                                            : _duration));
+}
+
+void CollectionMetadataWarmer::_scheduleRefreshes(long long term) {
+    auto context = _contexts.makeOperationContext(*Client::getCurrent());
+    auto opCtx = context.opCtx();
+
+    auto swCollections = [&]() -> StatusWith<std::vector<ShardCollectionType>> {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (term != _term) {
+                return {ErrorCodes::PrimarySteppedDown, "warm-up interrupted"};
+            }
+        }
+        return shardmetadatautil::readAllShardCollectionsEntries(opCtx);
+    }();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (term != _term) {
+        return;
+    }
+
+    if (!swCollections.isOK()) {
+        warning() << "Failed to read the collections with persisted chunk metadata to warm up"
+                  << causedBy(swCollections.getStatus());
+        _inProgress = false;
+        _duration = Date_t::now() - _startTime;
+        return;
+    }
+
+    const auto& collections = swCollections.getValue();
+    _numCollections = collections.size();
+    log() << "Warming up the metadata of " << _numCollections << " sharded collections";
+
+    for (const auto& coll : collections) {
+        const NamespaceString nss = coll.getNss();
+        Status status =
+            _threadPool.schedule([this, term, nss]() noexcept { _refreshCollection(term, nss); });
+        if (!status.isOK()) {
+            warning() << "Failed to schedule the warm-up of the metadata for " << nss
+                      << causedBy(status);
+            ++_numFailed;
+            continue;
+        }
+        ++_numPending;
+    }
+
+    _finishIfDone(lk);
+}
+
+void CollectionMetadataWarmer::_refreshCollection(long long term, const NamespaceString& nss) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (term != _term) {
+            return;
+        }
+    }
+
+    auto context = _contexts.makeOperationContext(*Client::getCurrent());
+    auto opCtx = context.opCtx();
+
+    bool refreshed = false;
+    try {
+        // A versioned request may have loaded the metadata already.
+        const bool loaded = [&] {
+            AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+            return bool(CollectionShardingState::get(opCtx, nss)->getMetadata());
+        }();
+
+        if (!loaded) {
+            ChunkVersion shardVersion;
+            uassertStatusOK(
+                ShardingState::get(opCtx)->refreshMetadataNow(opCtx, nss, &shardVersion));
+            LOG(1) << "Warmed up the metadata for " << nss << " at shard version "
+                   << shardVersion;
+        }
+        refreshed = true;
+    } catch (const DBException& ex) {
+        log() << "Failed to warm up the metadata for " << nss << causedBy(redact(ex));
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (term != _term) {
+        return;
+    }
+
+    --_numPending;
+    if (refreshed) {
+        ++_numRefreshed;
+    } else {
+        ++_numFailed;
+    }
+    _finishIfDone(lk);
+}
+
+void CollectionMetadataWarmer::_finishIfDone(WithLock) {
+    if (_numPending > 0) {
+        return;
+    }
+
+    _inProgress = false;
+    _duration = Date_t::now() - _startTime;
+    log() << "Warmed up the metadata of " << _numRefreshed << " of " << _numCollections
+          << " sharded collections in " << _duration;
+}
+
+}  // namespace mongo
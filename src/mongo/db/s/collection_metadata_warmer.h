@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/operation_context_group.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class NamespaceString;
+
+/**
+ * Loads the routing metadata of every collection this shard has persisted chunk metadata for into
+ * the CollectionShardingState as soon as the shard primary steps up, rather than on the first
+ * versioned request for each collection.
+ *
+ * The collections are refreshed in parallel in the background. Each refresh goes through the
+ * shard's CatalogCacheLoader, so it is served from the persisted metadata plus whatever changed on
+ * the config server since the persisted version.
+ */
+class CollectionMetadataWarmer {
+    MONGO_DISALLOW_COPYING(CollectionMetadataWarmer);
+
+public:
+    CollectionMetadataWarmer();
+    ~CollectionMetadataWarmer();
+
+    /**
+     * Invoked when the shard server primary enters the 'PRIMARY' state, after the collection
+     * metadata has been cleared. Schedules the refresh of the metadata of every collection which
+     * has persisted chunk metadata. Interrupts a warm-up which is already in progress.
+     */
+    void initiateWarmUp();
+
+    /**
+     * Invoked when this node steps down. Interrupts the refreshes in progress and skips those
+     * which have not started yet.
+     *
+     * This method might be called multiple times in succession, which is what happens as a result
+     * of incomplete transition to primary so it is resilient to that.
+     */
+    void interruptWarmUp();
+
+    /**
+     * Appends the progress of the latest warm-up to 'builder'.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    /**
+     * Reads the namespaces of the collections with persisted chunk metadata and schedules the
+     * refresh of each of them, unless the warm-up started in 'term' has been interrupted.
+     */
+    void _scheduleRefreshes(long long term);
+
+    /**
+     * Refreshes the metadata of 'nss', unless the warm-up started in 'term' has been interrupted
+     * or the metadata has already been loaded by a versioned request.
+     */
+    void _refreshCollection(long long term, const NamespaceString& nss);
+
+    /**
+     * Marks the warm-up as finished and logs its outcome if no collection refresh is pending.
+     */
+    void _finishIfDone(WithLock);
+
+    // Thread pool on which the collections are refreshed.
+    ThreadPool _threadPool;
+
+    // The operation contexts of the refreshes in progress, interrupted at step down.
+    OperationContextGroup _contexts;
+
+    // Protects the state below.
+    mutable stdx::mutex _mutex;
+
+    // Incremented on every step up and step down, so that the tasks scheduled by an interrupted
+    // warm-up can tell they must not run.
+    long long _term{0};
+
+    // Statistics about the latest warm-up, reported in serverStatus.
+    bool _inProgress{false};
+    Date_t _startTime;
+    Milliseconds _duration{0};
+    long long _numCollections{0};
+    long long _numPending{0};
+    long long _numRefreshed{0};
+    long long _numFailed{0};
+};
+
+}  // namespace mongo
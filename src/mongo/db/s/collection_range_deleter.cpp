@@ -53,6 +53,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
@@ -69,6 +70,9 @@ using logger::LogComponent;
 
 namespace {
 
+// Maximum number of documents, which the range deleter removes in a single storage transaction
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxDeletesPerWriteUnit, int, 32);
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
@@ -279,40 +283,87 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
+    auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
+    auto manual = PlanExecutor::YIELD_MANUAL;
+    auto forward = InternalPlanner::FORWARD;
+
+    // A single index scan is used for the whole pass. The record ids are collected in groups and
+    // each group is deleted in one storage transaction, rather than restarting the scan from 'min'
+    // and committing after every document, which had to skip over the keys of the documents just
+    // deleted and paid the commit cost per document.
+    auto exec = InternalPlanner::indexScan(
+        opCtx, collection, descriptor, min, max, halfOpen, manual, forward);
+
+    const int maxDeletesPerWriteUnit = std::max(1, rangeDeleterMaxDeletesPerWriteUnit.load());
+
     int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
-
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
-
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
+    std::vector<RecordId> toDelete;
+
+    while (numDeleted < maxToDelete) {
+        toDelete.clear();
+
+        const int groupSize = std::min(maxDeletesPerWriteUnit, maxToDelete - numDeleted);
+        while (int(toDelete.size()) < groupSize) {
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+            if (state == PlanExecutor::IS_EOF) {
+                break;
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning(LogComponent::kSharding)
+                    << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
+                    << min << " to " << max << " in " << nss << ": "
+                    << WorkingSetCommon::toStatusString(obj)
+                    << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                break;
+            }
+            invariant(PlanExecutor::ADVANCED == state);
+
+            toDelete.push_back(rloc);
         }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning(LogComponent::kSharding)
-                << PlanExecutor::statestr(state) << " - cursor error while trying to delete " << min
-                << " to " << max << " in " << nss << ": " << WorkingSetCommon::toStatusString(obj)
-                << ", stats: " << Explain::getWinningPlanStats(exec.get());
+
+        if (toDelete.empty()) {
             break;
         }
-        invariant(PlanExecutor::ADVANCED == state);
 
+        exec->saveState();
+
+        int numDeletedInGroup = 0;
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
+            numDeletedInGroup = 0;
+
             WriteUnitOfWork wuow(opCtx);
-            if (saver) {
-                saver->goingToDelete(obj).transitional_ignore();
+            for (const auto& rloc : toDelete) {
+                // Orphaned documents might still be removed by writes, which do not filter by
+                // shard version, so skip the ones which no longer exist
+                Snapshotted<BSONObj> doc;
+                if (!collection->findDoc(opCtx, rloc, &doc)) {
+                    continue;
+                }
+
+                if (saver) {
+                    saver->goingToDelete(doc.value()).transitional_ignore();
+                }
+                collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
+                ++numDeletedInGroup;
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
             wuow.commit();
         });
-    } while (++numDeleted < maxToDelete);
+
+        numDeleted += numDeletedInGroup;
+
+        auto restoreStatus = exec->restoreState();
+        if (!restoreStatus.isOK()) {
+            warning(LogComponent::kSharding) << "unable to resume deleting " << min << " to " << max
+                                             << " in " << nss << ": " << redact(restoreStatus);
+            break;
+        }
+
+        if (int(toDelete.size()) < groupSize) {
+            break;
+        }
+    }
 
     return numDeleted;
 }
@@ -363,6 +363,15 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
                                   << idx["seed"].numberInt(),
                     !shardKeyPattern.isHashedPattern() || idx["seed"].eoo() ||
                         idx["seed"].numberInt() == BSONElementHasher::DEFAULT_HASH_SEED);
+            // Routers target hashed shard keys with the MD5-based hash only.
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "can't shard collection " << nss.ns()
+                                  << " with hashed shard key "
+                                  << proposedKey
+                                  << " because the hashed index uses hashVersion "
+                                  << idx["hashVersion"].numberInt(),
+                    !shardKeyPattern.isHashedPattern() ||
+                        idx["hashVersion"].numberInt() == BSONElementHasher::kMD5HashVersion);
             hasUsefulIndexForKey = true;
         }
     }
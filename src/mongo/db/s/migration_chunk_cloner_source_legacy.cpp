@@ -411,6 +411,10 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
+    // The locs are visited in increasing order, so a single cursor is positioned from one document
+    // to the next instead of opening a new one for every document
+    auto cursor = collection->getCursor(opCtx);
+
     std::set<RecordId>::iterator it;
 
     for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
@@ -420,16 +424,18 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, *it, &doc)) {
+        auto record = cursor->seekExact(*it);
+        if (record) {
+            const BSONObj doc = record->data.releaseToBson();
+
             // Use the builder size instead of accumulating the document sizes directly so that we
             // take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                (arrBuilder->len() + doc.objsize() + 1024) > BSONObjMaxUserSize) {
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            arrBuilder->append(doc);
         }
     }
 
@@ -50,8 +50,9 @@ namespace {
 
 /**
  * Shortcut class to perform the appropriate checks and acquire the cloner associated with the
- * currently active migration. Uses the currently registered migration for this shard and ensures
- * the session ids match.
+ * currently active migration. Since a shard may be donating chunks of several collections at once,
+ * looks through the currently registered migrations for this shard for the one whose session id
+ * matches.
  */
 class AutoGetActiveCloner {
     MONGO_DISALLOW_COPYING(AutoGetActiveCloner);
@@ -60,32 +61,22 @@ public:
     AutoGetActiveCloner(OperationContext* opCtx, const MigrationSessionId& migrationSessionId) {
         ShardingState* const gss = ShardingState::get(opCtx);
 
-        const auto nss = gss->getActiveDonateChunkNss();
-        uassert(ErrorCodes::NotYetInitialized, "No active migrations were found", nss);
+        const auto namespaces = gss->getActiveDonateChunkNamespaces();
+        uassert(
+            ErrorCodes::NotYetInitialized, "No active migrations were found", !namespaces.empty());
 
-        // Once the collection is locked, the migration status cannot change
-        _autoColl.emplace(opCtx, *nss, MODE_IS);
-
-        uassert(ErrorCodes::NamespaceNotFound,
-                str::stream() << "Collection " << nss->ns() << " does not exist",
-                _autoColl->getCollection());
-
-        auto css = CollectionShardingState::get(opCtx, *nss);
-        uassert(ErrorCodes::IllegalOperation,
-                str::stream() << "No active migrations were found for collection " << nss->ns(),
-                css && css->getMigrationSourceManager());
+        Status status = Status::OK();
+        for (const auto& nss : namespaces) {
+            status = _acquire(opCtx, nss, migrationSessionId);
+            if (status.isOK()) {
+                return;
+            }
 
-        // It is now safe to access the cloner
-        _chunkCloner = dynamic_cast<MigrationChunkClonerSourceLegacy*>(
-            css->getMigrationSourceManager()->getCloner());
-        invariant(_chunkCloner);
+            _chunkCloner = nullptr;
+            _autoColl.reset();
+        }
 
-        // Ensure the session ids are correct
-        uassert(ErrorCodes::IllegalOperation,
-                str::stream() << "Requested migration session id " << migrationSessionId.toString()
-                              << " does not match active session id "
-                              << _chunkCloner->getSessionId().toString(),
-                migrationSessionId.matches(_chunkCloner->getSessionId()));
+        uassertStatusOK(status);
     }
 
     Database* getDb() const {
@@ -104,11 +95,50 @@ public:
     }
 
 private:
+    /**
+     * Locks the specified collection and, if it has a migration with the specified session id
+     * running, retains its cloner. Otherwise returns an error describing why it could not be used.
+     */
+    Status _acquire(OperationContext* opCtx,
+                    const NamespaceString& nss,
+                    const MigrationSessionId& migrationSessionId) {
+        // Once the collection is locked, the migration status cannot change
+        _autoColl.emplace(opCtx, nss, MODE_IS);
+
+        if (!_autoColl->getCollection()) {
+            return {ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Collection " << nss.ns() << " does not exist"};
+        }
+
+        auto css = CollectionShardingState::get(opCtx, nss);
+        if (!css || !css->getMigrationSourceManager()) {
+            return {ErrorCodes::IllegalOperation,
+                    str::stream() << "No active migrations were found for collection "
+                                  << nss.ns()};
+        }
+
+        // It is now safe to access the cloner
+        _chunkCloner = dynamic_cast<MigrationChunkClonerSourceLegacy*>(
+            css->getMigrationSourceManager()->getCloner());
+        invariant(_chunkCloner);
+
+        // Ensure the session ids are correct
+        if (!migrationSessionId.matches(_chunkCloner->getSessionId())) {
+            return {ErrorCodes::IllegalOperation,
+                    str::stream() << "Requested migration session id "
+                                  << migrationSessionId.toString()
+                                  << " does not match active session id "
+                                  << _chunkCloner->getSessionId().toString()};
+        }
+
+        return Status::OK();
+    }
+
     // Scoped database + collection lock
     boost::optional<AutoGetCollection> _autoColl;
 
     // Contains the active cloner for the namespace
-    MigrationChunkClonerSourceLegacy* _chunkCloner;
+    MigrationChunkClonerSourceLegacy* _chunkCloner{nullptr};
 };
 
 class InitialCloneCommand : public BasicCommand {
@@ -42,11 +42,14 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/delete.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
@@ -59,6 +62,8 @@
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -197,6 +202,104 @@ BSONObj createTransferModsRequest(const NamespaceString& nss, const MigrationSes
     return builder.obj();
 }
 
+/**
+ * Issues the _migrateClone requests of the initial clone phase on a separate thread, staying one
+ * batch ahead of the caller, so that the round trip to the donor for the next batch overlaps with
+ * the insertion of the current one. Stops fetching after the first empty batch or failure. The
+ * connection must not be used by anybody else for as long as this object exists.
+ */
+class CloneBatchPrefetcher {
+    MONGO_DISALLOW_COPYING(CloneBatchPrefetcher);
+
+public:
+    CloneBatchPrefetcher(DBClientBase* conn, BSONObj migrateCloneRequest)
+        : _conn(conn), _migrateCloneRequest(std::move(migrateCloneRequest)) {
+        _thread = stdx::thread([this] { _fetchLoop(); });
+    }
+
+    ~CloneBatchPrefetcher() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _shutdown = true;
+            _cv.notify_all();
+        }
+
+        // Waits for at most one outstanding request to the donor
+        _thread.join();
+    }
+
+    /**
+     * Blocks until the response to the next _migrateClone request is available and returns it,
+     * setting 'ok' to whether the command succeeded. Rethrows any exception thrown while talking
+     * to the donor.
+     */
+    BSONObj next(bool* ok) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [this] { return _fetched.is_initialized(); });
+
+        Fetched fetched = std::move(*_fetched);
+        _fetched.reset();
+        _cv.notify_all();
+
+        uassertStatusOK(fetched.status);
+        *ok = fetched.ok;
+        return fetched.response;
+    }
+
+private:
+    // Outcome of a single _migrateClone request
+    struct Fetched {
+        Status status{Status::OK()};
+        bool ok{false};
+        BSONObj response;
+    };
+
+    void _fetchLoop() {
+        while (true) {
+            Fetched fetched;
+            try {
+                fetched.ok = _conn->runCommand("admin", _migrateCloneRequest, fetched.response);
+            } catch (const DBException& ex) {
+                fetched.status = ex.toStatus();
+            }
+
+            const bool isLast = !fetched.status.isOK() || !fetched.ok ||
+                fetched.response["objects"].Obj().isEmpty();
+
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _cv.wait(lk, [this] { return _shutdown || !_fetched; });
+            if (_shutdown) {
+                return;
+            }
+
+            _fetched = std::move(fetched);
+            _cv.notify_all();
+
+            if (isLast) {
+                return;
+            }
+        }
+    }
+
+    // Connection to the donor and the request to send on it
+    DBClientBase* const _conn;
+    const BSONObj _migrateCloneRequest;
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    // Signalled when a response becomes available, is consumed or when shutting down
+    stdx::condition_variable _cv;
+
+    // Response, which was fetched, but not yet returned by next()
+    boost::optional<Fetched> _fetched;
+
+    // Set by the destructor to stop the fetching thread
+    bool _shutdown{false};
+
+    stdx::thread _thread;
+};
+
 // Enabling / disabling these fail points pauses / resumes MigrateStatus::_go(), the thread which
 // receives a chunk migration from the donor.
 MONGO_FP_DECLARE(migrateThreadHangAtStep1);
@@ -247,6 +350,11 @@ bool MigrationDestinationManager::isActive() const {
     return _isActive(lk);
 }
 
+bool MigrationDestinationManager::matchesSession(const MigrationSessionId& sessionId) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _lastSessionId && _lastSessionId->matches(sessionId);
+}
+
 bool MigrationDestinationManager::_isActive(WithLock) const {
     return _sessionId.is_initialized();
 }
@@ -325,6 +433,7 @@ Status MigrationDestinationManager::start(const NamespaceString& nss,
     _numSteady = 0;
 
     _sessionId = sessionId;
+    _lastSessionId = sessionId;
     _scopedRegisterReceiveChunk = std::move(scopedRegisterReceiveChunk);
 
     // TODO: If we are here, the migrate thread must have completed, otherwise _active above
@@ -676,45 +785,59 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
 
         _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
+        // Gets arrays of objects to copy, in disk order
+        CloneBatchPrefetcher prefetcher(conn.get(), migrateCloneRequest);
+
         while (true) {
-            BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
+            bool ok;
+            BSONObj res = prefetcher.next(&ok);
+            if (!ok) {
                 setStateFail(str::stream() << "_migrateClone failed: " << redact(res.toString()));
                 conn.done();
                 return;
             }
 
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            std::vector<InsertStatement> docsToClone;
+            for (const auto& elem : res["objects"].Obj()) {
+                docsToClone.emplace_back(elem.Obj());
+            }
 
-            BSONObjIterator i(arr);
-            while (i.more()) {
-                opCtx->checkForInterrupt();
+            if (docsToClone.empty())
+                break;
 
-                if (getState() == ABORT) {
-                    log() << "Migration aborted while copying documents";
-                    return;
-                }
+            opCtx->checkForInterrupt();
 
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(opCtx, _nss.ns());
+            if (getState() == ABORT) {
+                log() << "Migration aborted while copying documents";
+                return;
+            }
+
+            long long batchClonedBytes = 0;
+
+            {
+                AutoGetCollection autoColl(opCtx, _nss, MODE_IX);
 
+                Collection* const collection = autoColl.getCollection();
+                uassert(ErrorCodes::NamespaceNotFound,
+                        str::stream() << "Collection " << _nss.ns()
+                                      << " was dropped while its chunk was being received",
+                        collection);
+
+                for (const auto& docToClone : docsToClone) {
                     BSONObj localDoc;
                     if (willOverrideLocalId(opCtx,
                                             _nss,
                                             min,
                                             max,
                                             shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
+                                            autoColl.getDb(),
+                                            docToClone.doc,
                                             &localDoc)) {
                         string errMsg = str::stream() << "cannot migrate chunk, local document "
                                                       << redact(localDoc)
                                                       << " has same _id as cloned "
-                                                      << "remote document " << redact(docToClone);
+                                                      << "remote document "
+                                                      << redact(docToClone.doc);
 
                         warning() << errMsg;
 
@@ -722,33 +845,47 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                         uasserted(16976, errMsg);
                     }
 
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
+                    batchClonedBytes += docToClone.doc.objsize();
                 }
-                thisTime++;
 
-                {
-                    stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
-                }
+                // The range was verified to be clean before the clone started, so the documents
+                // can be inserted directly, in groups to bound the size of each storage transaction
+                const size_t maxInsertBatchSize = std::max(1, internalInsertMaxBatchSize.load());
 
-                if (writeConcern.shouldWaitForOtherNodes()) {
-                    repl::ReplicationCoordinator::StatusAndDuration replStatus =
-                        repl::getGlobalReplicationCoordinator()->awaitReplication(
-                            opCtx,
-                            repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
-                            writeConcern);
-                    if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
-                        warning() << "secondaryThrottle on, but doc insert timed out; "
-                                     "continuing";
-                    } else {
-                        massertStatusOK(replStatus.status);
-                    }
+                for (auto it = docsToClone.cbegin(); it != docsToClone.cend();) {
+                    const auto batchEnd =
+                        it + std::min<size_t>(maxInsertBatchSize, docsToClone.cend() - it);
+
+                    writeConflictRetry(opCtx, "migrateCloneInsert", _nss.ns(), [&] {
+                        WriteUnitOfWork wuow(opCtx);
+                        uassertStatusOK(collection->insertDocuments(
+                            opCtx, it, batchEnd, nullptr, false, true /* fromMigrate */));
+                        wuow.commit();
+                    });
+
+                    it = batchEnd;
                 }
             }
 
-            if (thisTime == 0)
-                break;
+            {
+                stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+                _numCloned += docsToClone.size();
+                _clonedBytes += batchClonedBytes;
+            }
+
+            if (writeConcern.shouldWaitForOtherNodes()) {
+                repl::ReplicationCoordinator::StatusAndDuration replStatus =
+                    repl::getGlobalReplicationCoordinator()->awaitReplication(
+                        opCtx,
+                        repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
+                        writeConcern);
+                if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
+                    warning() << "secondaryThrottle on, but batch insert timed out; "
+                                 "continuing";
+                } else {
+                    massertStatusOK(replStatus.status);
+                }
+            }
         }
 
         timing.done(3);
@@ -57,7 +57,8 @@ class OpTime;
 }
 
 /**
- * Drives the receiving side of the MongoD migration process. One instance exists per shard.
+ * Drives the receiving side of the MongoD migration process. One instance exists per chunk, which a
+ * shard is able to receive concurrently (see maxConcurrentChunkMigrationsPerShard).
  */
 class MigrationDestinationManager {
     MONGO_DISALLOW_COPYING(MigrationDestinationManager);
@@ -83,6 +84,12 @@ public:
      */
     bool isActive() const;
 
+    /**
+     * Checks whether the currently active migration or, if there is none, the most recently
+     * started one has the specified session id.
+     */
+    bool matchesSession(const MigrationSessionId& sessionId) const;
+
     /**
      * Reports the state of the migration manager as a BSON document.
      */
@@ -186,6 +193,10 @@ private:
     boost::optional<MigrationSessionId> _sessionId;
     boost::optional<ScopedRegisterReceiveChunk> _scopedRegisterReceiveChunk;
 
+    // Session ID of the most recently started migration. Unlike '_sessionId' it is retained after
+    // the migration completes, so that the donor can still retrieve the migration's final state.
+    boost::optional<MigrationSessionId> _lastSessionId;
+
     // A condition variable on which to wait for the prepare method to be called.
     stdx::condition_variable _isActiveCV;
 
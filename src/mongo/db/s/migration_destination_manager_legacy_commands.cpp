@@ -133,11 +133,17 @@ public:
         const MigrationSessionId migrationSessionId(
             uassertStatusOK(MigrationSessionId::extractFromBSON(cmdObj)));
 
-        // Ensure this shard is not currently receiving or donating any chunks.
+        // Ensure this shard is not currently donating any chunks and is not already receiving as
+        // many as it is allowed to concurrently.
         auto scopedRegisterReceiveChunk(
             uassertStatusOK(shardingState->registerReceiveChunk(nss, chunkRange, fromShard)));
 
-        uassertStatusOK(shardingState->migrationDestinationManager()->start(
+        // The slot is reserved until the receive unregisters, which only happens after the
+        // destination manager for that slot has finished the migration, so it is always inactive
+        auto const mdm =
+            shardingState->migrationDestinationManager(scopedRegisterReceiveChunk.getSlot());
+
+        uassertStatusOK(mdm->start(
             nss,
             std::move(scopedRegisterReceiveChunk),
             migrationSessionId,
@@ -188,7 +194,16 @@ public:
              const string&,
              const BSONObj& cmdObj,
              BSONObjBuilder& result) {
-        ShardingState::get(opCtx)->migrationDestinationManager()->report(result);
+        auto const shardingState = ShardingState::get(opCtx);
+
+        // Older donors do not include the session id, in which case there can only be a single
+        // incoming migration
+        auto migrationSessionIdStatus(MigrationSessionId::extractFromBSON(cmdObj));
+        auto const mdm = migrationSessionIdStatus.isOK()
+            ? shardingState->migrationDestinationManager(migrationSessionIdStatus.getValue())
+            : shardingState->migrationDestinationManager();
+
+        mdm->report(result);
         return true;
     }
 
@@ -228,7 +243,7 @@ public:
              const BSONObj& cmdObj,
              BSONObjBuilder& result) {
         auto const sessionId = uassertStatusOK(MigrationSessionId::extractFromBSON(cmdObj));
-        auto mdm = ShardingState::get(opCtx)->migrationDestinationManager();
+        auto mdm = ShardingState::get(opCtx)->migrationDestinationManager(sessionId);
         Status const status = mdm->startCommit(sessionId);
         mdm->report(result);
         if (!status.isOK()) {
@@ -273,11 +288,13 @@ public:
              const string&,
              const BSONObj& cmdObj,
              BSONObjBuilder& result) {
-        auto const mdm = ShardingState::get(opCtx)->migrationDestinationManager();
+        auto const shardingState = ShardingState::get(opCtx);
 
         auto migrationSessionIdStatus(MigrationSessionId::extractFromBSON(cmdObj));
 
         if (migrationSessionIdStatus.isOK()) {
+            auto const mdm =
+                shardingState->migrationDestinationManager(migrationSessionIdStatus.getValue());
             Status const status = mdm->abort(migrationSessionIdStatus.getValue());
             mdm->report(result);
             if (!status.isOK()) {
@@ -285,6 +302,7 @@ public:
                 return appendCommandStatus(result, status);
             }
         } else if (migrationSessionIdStatus == ErrorCodes::NoSuchKey) {
+            auto const mdm = shardingState->migrationDestinationManager();
             mdm->abortWithoutSessionIdCheck();
             mdm->report(result);
         }
@@ -176,6 +176,39 @@ StatusWith<ShardCollectionType> readShardCollectionsEntry(OperationContext* opCt
     }
 }
 
+StatusWith<std::vector<ShardCollectionType>> readAllShardCollectionsEntries(
+    OperationContext* opCtx) {
+    try {
+        DBDirectClient client(opCtx);
+        std::unique_ptr<DBClientCursor> cursor =
+            client.query(ShardCollectionType::ConfigNS.c_str(), Query());
+        if (!cursor) {
+            return Status(ErrorCodes::OperationFailed,
+                          str::stream() << "Failed to establish a cursor for reading "
+                                        << ShardCollectionType::ConfigNS
+                                        << " from local storage");
+        }
+
+        std::vector<ShardCollectionType> collections;
+        while (cursor->more()) {
+            BSONObj document = cursor->nextSafe();
+            auto statusWithCollectionEntry = ShardCollectionType::fromBSON(document);
+            if (!statusWithCollectionEntry.isOK()) {
+                return statusWithCollectionEntry.getStatus();
+            }
+
+            collections.push_back(std::move(statusWithCollectionEntry.getValue()));
+        }
+
+        return collections;
+    } catch (const DBException& ex) {
+        return {ex.toStatus().code(),
+                str::stream() << "Failed to read the entries locally from "
+                              << ShardCollectionType::ConfigNS
+                              << causedBy(ex.toStatus())};
+    }
+}
+
 Status updateShardCollectionsEntry(OperationContext* opCtx,
                                    const BSONObj& query,
                                    const BSONObj& update,
@@ -138,6 +138,13 @@ StatusWith<RefreshState> getPersistedRefreshFlags(OperationContext* opCtx,
 StatusWith<ShardCollectionType> readShardCollectionsEntry(OperationContext* opCtx,
                                                           const NamespaceString& nss);
 
+/**
+ * Reads all of the shard server's collections collection entries, i.e. those of every collection
+ * this shard has persisted routing metadata for.
+ */
+StatusWith<std::vector<ShardCollectionType>> readAllShardCollectionsEntries(
+    OperationContext* opCtx);
+
 /**
  * Updates the collections collection entry matching 'query' with 'update' using local write
  * concern.
@@ -202,6 +202,19 @@ TEST_F(ShardMetadataUtilTest, UpdateAndReadCollectionsEntry) {
     ASSERT(!readShardCollectionType.hasLastRefreshedCollectionVersion());
 }
 
+TEST_F(ShardMetadataUtilTest, ReadAllCollectionsEntries) {
+    ASSERT(assertGet(readAllShardCollectionsEntries(operationContext())).empty());
+
+    ShardCollectionType shardCollectionType = setUpCollection();
+    auto collections = assertGet(readAllShardCollectionsEntries(operationContext()));
+    ASSERT_EQUALS(1U, collections.size());
+    ASSERT_EQUALS(kNss, collections.front().getNss());
+    ASSERT_EQUALS(shardCollectionType.getEpoch(), collections.front().getEpoch());
+
+    ASSERT_OK(dropChunksAndDeleteCollectionsEntry(operationContext(), kNss));
+    ASSERT(assertGet(readAllShardCollectionsEntries(operationContext())).empty());
+}
+
 TEST_F(ShardMetadataUtilTest, PersistedRefreshSignalStartAndFinish) {
     setUpCollection();
 
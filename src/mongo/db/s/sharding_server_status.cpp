@@ -70,6 +70,12 @@ public:
             if (!migrationStatus.isEmpty()) {
                 result.append("migrations", migrationStatus);
             }
+
+            if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
+                BSONObjBuilder warmUpBuilder(result.subobjStart("metadataWarmUp"));
+                shardingState->getCollectionMetadataWarmer()->report(&warmUpBuilder);
+                warmUpBuilder.doneFast();
+            }
         }
 
         return result.obj();
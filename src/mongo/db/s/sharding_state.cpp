@@ -114,6 +114,7 @@ void updateShardIdentityConfigStringCB(const string& setName, const string& newC
 
 ShardingState::ShardingState()
     : _chunkSplitter(stdx::make_unique<ChunkSplitter>()),
+      _metadataWarmer(stdx::make_unique<CollectionMetadataWarmer>()),
       _initializationState(static_cast<uint32_t>(InitializationState::kNew)),
       _initializationStatus(Status(ErrorCodes::InternalError, "Uninitialized value")),
       _globalInit(&initializeGlobalShardingStateForMongod) {}
@@ -217,6 +218,18 @@ void ShardingState::interruptChunkSplitter() {
     _chunkSplitter->interruptChunkSplitter();
 }
 
+CollectionMetadataWarmer* ShardingState::getCollectionMetadataWarmer() {
+    return _metadataWarmer.get();
+}
+
+void ShardingState::initiateCollectionMetadataWarmUp() {
+    _metadataWarmer->initiateWarmUp();
+}
+
+void ShardingState::interruptCollectionMetadataWarmUp() {
+    _metadataWarmer->interruptWarmUp();
+}
+
 void ShardingState::markCollectionsNotShardedAtStepdown() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     for (auto& coll : _collections) {
@@ -526,6 +539,29 @@ ChunkVersion ShardingState::_refreshMetadata(OperationContext* opCtx, const Name
     return css->getMetadata()->getShardVersion();
 }
 
+MigrationDestinationManager* ShardingState::migrationDestinationManager(size_t slot) {
+    stdx::lock_guard<stdx::mutex> lk(_migrationDestManagersMutex);
+    while (_migrationDestManagers.size() <= slot) {
+        _migrationDestManagers.push_back(stdx::make_unique<MigrationDestinationManager>());
+    }
+
+    return _migrationDestManagers[slot].get();
+}
+
+MigrationDestinationManager* ShardingState::migrationDestinationManager(
+    const MigrationSessionId& sessionId) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_migrationDestManagersMutex);
+        for (const auto& mdm : _migrationDestManagers) {
+            if (mdm->matchesSession(sessionId)) {
+                return mdm.get();
+            }
+        }
+    }
+
+    return migrationDestinationManager(0);
+}
+
 StatusWith<ScopedRegisterDonateChunk> ShardingState::registerDonateChunk(
     const MoveChunkRequest& args) {
     return _activeMigrationsRegistry.registerDonateChunk(args);
@@ -536,8 +572,8 @@ StatusWith<ScopedRegisterReceiveChunk> ShardingState::registerReceiveChunk(
     return _activeMigrationsRegistry.registerReceiveChunk(nss, chunkRange, fromShardId);
 }
 
-boost::optional<NamespaceString> ShardingState::getActiveDonateChunkNss() {
-    return _activeMigrationsRegistry.getActiveDonateChunkNss();
+std::vector<NamespaceString> ShardingState::getActiveDonateChunkNamespaces() {
+    return _activeMigrationsRegistry.getActiveDonateChunkNamespaces();
 }
 
 BSONObj ShardingState::getActiveMigrationStatusReport(OperationContext* opCtx) {
@@ -36,6 +36,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/active_migrations_registry.h"
 #include "mongo/db/s/chunk_splitter.h"
+#include "mongo/db/s/collection_metadata_warmer.h"
 #include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/executor/task_executor.h"
@@ -116,8 +117,26 @@ public:
 
     std::string getShardName();
 
+    /**
+     * Returns the migration destination manager, which drives the receive of a chunk holding the
+     * specified slot (see ScopedRegisterReceiveChunk::getSlot). Managers are created on demand and
+     * live for as long as the sharding state, so the returned pointer is always valid.
+     */
+    MigrationDestinationManager* migrationDestinationManager(size_t slot);
+
+    /**
+     * Returns the migration destination manager, which is running or has most recently run the
+     * migration with the specified session id. If there is no such manager, returns the first one,
+     * which is also the only one unless concurrent migrations were enabled.
+     */
+    MigrationDestinationManager* migrationDestinationManager(const MigrationSessionId& sessionId);
+
+    /**
+     * Returns the first migration destination manager. Only used when the caller does not know the
+     * session id of the migration, for backwards compatibility.
+     */
     MigrationDestinationManager* migrationDestinationManager() {
-        return &_migrationDestManager;
+        return migrationDestinationManager(0);
     }
 
     /**
@@ -157,6 +176,21 @@ public:
      */
     void interruptChunkSplitter();
 
+    CollectionMetadataWarmer* getCollectionMetadataWarmer();
+
+    /**
+     * Should be invoked when the shard server primary enters the 'PRIMARY' state, after its
+     * collections have been marked as not sharded. Starts loading the metadata of the sharded
+     * collections in the background.
+     */
+    void initiateCollectionMetadataWarmUp();
+
+    /**
+     * Should be invoked when this node which is currently serving as a 'PRIMARY' steps down.
+     * Stops the loading of the collections metadata started at step up.
+     */
+    void interruptCollectionMetadataWarmUp();
+
     /**
      * Iterates through all known sharded collections and marks them (in memory only) as not sharded
      * so that no filtering will be happening for slaveOk queries.
@@ -234,13 +268,13 @@ public:
                                                                 const ShardId& fromShardId);
 
     /**
-     * If a migration has been previously registered through a call to registerDonateChunk returns
-     * that namespace. Otherwise returns boost::none.
+     * Returns the namespaces of the migrations, which have been previously registered through a
+     * call to registerDonateChunk and are still active.
      *
-     * This method can be called without any locks, but once the namespace is fetched it needs to be
+     * This method can be called without any locks, but once a namespace is fetched it needs to be
      * re-checked after acquiring some intent lock on that namespace.
      */
-    boost::optional<NamespaceString> getActiveDonateChunkNss();
+    std::vector<NamespaceString> getActiveDonateChunkNamespaces();
 
     /**
      * Get a migration status report from the migration registry. If no migration is active, this
@@ -320,8 +354,12 @@ private:
      */
     ChunkVersion _refreshMetadata(OperationContext* opCtx, const NamespaceString& nss);
 
-    // Manages the state of the migration recipient shard
-    MigrationDestinationManager _migrationDestManager;
+    // Protects the migration destination managers below
+    stdx::mutex _migrationDestManagersMutex;
+
+    // Manage the state of the migration recipient shard, one per concurrently received chunk. They
+    // are indexed by slot, created on demand and never destroyed before the sharding state.
+    std::vector<std::unique_ptr<MigrationDestinationManager>> _migrationDestManagers;
 
     // Tracks the active move chunk operations running on this shard
     ActiveMigrationsRegistry _activeMigrationsRegistry;
@@ -329,6 +367,9 @@ private:
     // Handles asynchronous auto-splitting of chunks
     std::unique_ptr<ChunkSplitter> _chunkSplitter;
 
+    // Loads the metadata of the sharded collections in the background at step up
+    std::unique_ptr<CollectionMetadataWarmer> _metadataWarmer;
+
     // Protects state below
     stdx::mutex _mutex;
 
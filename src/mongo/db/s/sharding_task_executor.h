@@ -72,6 +72,8 @@ public:
 
     void appendConnectionStats(ConnectionPoolStats* stats) const override;
 
+    void warmUpConnections(const HostAndPort& hostAndPort) override;
+
 private:
     std::unique_ptr<ThreadPoolTaskExecutor> _executor;
 };
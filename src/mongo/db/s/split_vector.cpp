@@ -38,11 +38,13 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -54,18 +56,130 @@ BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
-}  // namespace
+// Random draws are considerably more expensive than advancing an index cursor, so sampling is
+// only worthwhile while it costs no more than this fraction of scanning one split interval.
+const long long kRandomDrawCostFactor{16};
 
-StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
-                                             const NamespaceString& nss,
-                                             const BSONObj& keyPattern,
-                                             const BSONObj& min,
-                                             const BSONObj& max,
-                                             bool force,
-                                             boost::optional<long long> maxSplitPoints,
-                                             boost::optional<long long> maxChunkObjects,
-                                             boost::optional<long long> maxChunkSize,
-                                             boost::optional<long long> maxChunkSizeBytes) {
+// Below this many in-range samples per split interval the estimate is too noisy to be useful and
+// the full index scan is used instead.
+const long long kMinSamplesPerSplitPoint{4};
+
+/**
+ * Estimates the split points of the range [minKey, maxKey) from up to 'numSamples' in-range keys
+ * drawn from a random cursor over the shard key index (or over the record store, extracting the
+ * index keys from the sampled documents), splitting every 'keyCount' documents. Returns
+ * boost::none if the storage engine does not support random cursors or if too few of the draws
+ * fall within the range, in which case the caller must scan the index.
+ */
+boost::optional<std::vector<BSONObj>> sampleSplitKeys(OperationContext* opCtx,
+                                                      Collection* collection,
+                                                      IndexDescriptor* idx,
+                                                      const BSONObj& keyPattern,
+                                                      const BSONObj& minKey,
+                                                      const BSONObj& maxKey,
+                                                      long long recCount,
+                                                      long long keyCount,
+                                                      boost::optional<long long> maxSplitPoints,
+                                                      long long numSamples) {
+    const IndexAccessMethod* iam = collection->getIndexCatalog()->getIndex(idx);
+
+    auto idxCursor = iam->newRandomCursor(opCtx);
+    auto recCursor = idxCursor ? nullptr : collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!idxCursor && !recCursor) {
+        return boost::none;
+    }
+
+    const Ordering ordering = Ordering::make(idx->keyPattern());
+    const long long maxDraws = std::min(recCount, keyCount / kRandomDrawCostFactor);
+
+    std::vector<BSONObj> samples;
+    long long numDraws = 0;
+    while (numDraws < maxDraws && static_cast<long long>(samples.size()) < numSamples) {
+        BSONObj key;
+        if (idxCursor) {
+            auto entry = idxCursor->next();
+            if (!entry) {
+                break;
+            }
+            key = entry->key.getOwned();
+        } else {
+            auto record = recCursor->next();
+            if (!record) {
+                break;
+            }
+            // The shard key prefix of the index can never be multikey, so any of the generated
+            // keys carries the shard key values of the document.
+            BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            iam->getKeys(record->data.releaseToBson(),
+                         IndexAccessMethod::GetKeysMode::kRelaxConstraints,
+                         &keys,
+                         nullptr);
+            if (keys.empty()) {
+                continue;
+            }
+            key = keys.begin()->getOwned();
+        }
+        numDraws++;
+
+        if (key.woCompare(minKey, ordering, false) >= 0 &&
+            key.woCompare(maxKey, ordering, false) < 0) {
+            samples.push_back(std::move(key));
+        }
+    }
+
+    // Each draw stands for 'recCount / numDraws' documents of the collection, so a split interval
+    // of 'keyCount' documents spans this many of the in-range samples.
+    const double samplesPerSplitPoint =
+        numDraws ? static_cast<double>(keyCount) * numDraws / recCount : 0;
+    if (samplesPerSplitPoint < kMinSamplesPerSplitPoint) {
+        return boost::none;
+    }
+
+    std::sort(samples.begin(), samples.end(), [&ordering](const BSONObj& a, const BSONObj& b) {
+        return a.woCompare(b, ordering, false) < 0;
+    });
+
+    // As with the index scan, the first key of the range is a sentinel which is never returned and
+    // repeated keys are only used once, so that all instances of a key value live in one chunk.
+    std::vector<BSONObj> splitKeys;
+    BSONObj lastKey = samples.empty()
+        ? BSONObj()
+        : dotted_path_support::extractElementsBasedOnTemplate(
+              prettyKey(idx->keyPattern(), samples.front()), keyPattern);
+    for (double pos = samplesPerSplitPoint; pos < samples.size(); pos += samplesPerSplitPoint) {
+        if (maxSplitPoints && maxSplitPoints.get() &&
+            static_cast<long long>(splitKeys.size()) >= maxSplitPoints.get()) {
+            break;
+        }
+
+        BSONObj splitKey = dotted_path_support::extractElementsBasedOnTemplate(
+            prettyKey(idx->keyPattern(), samples[static_cast<size_t>(pos)]), keyPattern);
+        if (splitKey.woCompare(lastKey) == 0) {
+            continue;
+        }
+
+        LOG(4) << "picked a sampled split key: " << redact(splitKey);
+        splitKeys.push_back(splitKey.getOwned());
+        lastKey = splitKeys.back();
+    }
+
+    LOG(1) << "estimated " << splitKeys.size() << " split points for " << collection->ns()
+           << " from " << samples.size() << " samples out of " << numDraws << " random draws";
+
+    return splitKeys;
+}
+
+StatusWith<std::vector<BSONObj>> splitVectorImpl(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 const BSONObj& keyPattern,
+                                                 const BSONObj& min,
+                                                 const BSONObj& max,
+                                                 bool force,
+                                                 boost::optional<long long> maxSplitPoints,
+                                                 boost::optional<long long> maxChunkObjects,
+                                                 boost::optional<long long> maxChunkSize,
+                                                 boost::optional<long long> maxChunkSizeBytes,
+                                                 long long numSamples) {
     std::vector<BSONObj> splitKeys;
 
     // Always have a default value for maxChunkObjects
@@ -151,6 +265,29 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        if (!force && numSamples > 0) {
+            auto sampledSplitKeys = sampleSplitKeys(opCtx,
+                                                    collection,
+                                                    idx,
+                                                    keyPattern,
+                                                    minKey,
+                                                    maxKey,
+                                                    recCount,
+                                                    keyCount,
+                                                    maxSplitPoints,
+                                                    numSamples);
+            if (sampledSplitKeys) {
+                splitKeys = std::move(*sampledSplitKeys);
+                std::sort(splitKeys.begin(),
+                          splitKeys.end(),
+                          SimpleBSONObjComparator::kInstance.makeLessThan());
+                return splitKeys;
+            }
+
+            LOG(1) << "falling back to scanning the index to find split points for chunk "
+                   << nss.toString() << " " << redact(minKey) << " -->> " << redact(maxKey);
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
@@ -277,4 +414,50 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
     return splitKeys;
 }
 
+}  // namespace
+
+StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
+                                             const NamespaceString& nss,
+                                             const BSONObj& keyPattern,
+                                             const BSONObj& min,
+                                             const BSONObj& max,
+                                             bool force,
+                                             boost::optional<long long> maxSplitPoints,
+                                             boost::optional<long long> maxChunkObjects,
+                                             boost::optional<long long> maxChunkSize,
+                                             boost::optional<long long> maxChunkSizeBytes) {
+    return splitVectorImpl(opCtx,
+                           nss,
+                           keyPattern,
+                           min,
+                           max,
+                           force,
+                           maxSplitPoints,
+                           maxChunkObjects,
+                           maxChunkSize,
+                           maxChunkSizeBytes,
+                           0);
+}
+
+StatusWith<std::vector<BSONObj>> splitVectorSampled(OperationContext* opCtx,
+                                                    const NamespaceString& nss,
+                                                    const BSONObj& keyPattern,
+                                                    const BSONObj& min,
+                                                    const BSONObj& max,
+                                                    boost::optional<long long> maxSplitPoints,
+                                                    long long maxChunkSizeBytes,
+                                                    long long numSamples) {
+    return splitVectorImpl(opCtx,
+                           nss,
+                           keyPattern,
+                           min,
+                           max,
+                           false,
+                           maxSplitPoints,
+                           boost::none,
+                           boost::none,
+                           maxChunkSizeBytes,
+                           numSamples);
+}
+
 }  // namespace mongo
@@ -66,4 +66,20 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              boost::optional<long long> maxChunkSize,
                                              boost::optional<long long> maxChunkSizeBytes);
 
+/**
+ * Same as splitVector without 'force' or 'maxChunkObjects', but rather than walking the entire
+ * range of the shard key index, estimates the split points from up to 'numSamples' keys within the
+ * chunk drawn from a random cursor. The estimate is only used if enough of the random draws fall
+ * within the chunk for it to be reliable and if the storage engine supports random cursors,
+ * otherwise this falls back to the full index scan.
+ */
+StatusWith<std::vector<BSONObj>> splitVectorSampled(OperationContext* opCtx,
+                                                    const NamespaceString& nss,
+                                                    const BSONObj& keyPattern,
+                                                    const BSONObj& min,
+                                                    const BSONObj& max,
+                                                    boost::optional<long long> maxSplitPoints,
+                                                    long long maxChunkSizeBytes,
+                                                    long long numSamples);
+
 }  // namespace mongo
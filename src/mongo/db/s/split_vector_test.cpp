@@ -91,6 +91,28 @@ TEST_F(SplitVectorTest, SplitVectorInHalf) {
     }
 }
 
+TEST_F(SplitVectorTest, SampledSplitVectorFallsBackToIndexScan) {
+    // The chunk is too small for enough random draws to land in each split interval, so the split
+    // points must come from the index scan.
+    std::vector<BSONObj> splitKeys =
+        unittest::assertGet(splitVectorSampled(operationContext(),
+                                               kNss,
+                                               BSON(kPattern << 1),
+                                               BSON(kPattern << 0),
+                                               BSON(kPattern << 100),
+                                               boost::none,
+                                               getDocSizeBytes() * 100LL,
+                                               1000));
+    std::vector<BSONObj> expected = {BSON(kPattern << 50)};
+    ASSERT_EQ(splitKeys.size(), expected.size());
+
+    for (auto splitKeysIt = splitKeys.begin(), expectedIt = expected.begin();
+         splitKeysIt != splitKeys.end() && expectedIt != expected.end();
+         ++splitKeysIt, ++expectedIt) {
+        ASSERT_BSONOBJ_EQ(*splitKeysIt, *expectedIt);
+    }
+}
+
 TEST_F(SplitVectorTest, ForceSplit) {
     std::vector<BSONObj> splitKeys = unittest::assertGet(splitVector(operationContext(),
                                                                      kNss,
@@ -272,7 +272,17 @@ void ServiceContext::OperationContextDeleter::operator()(OperationContext* opCtx
     } catch (...) {
         std::terminate();
     }
+
+    // Nothing torn down along with the OperationContext uses its Locker, so the Locker can be
+    // detached first and kept on the Client for its next operation.
+    std::unique_ptr<Locker> locker;
+    if (opCtx->lockState()) {
+        locker = opCtx->releaseLockState();
+    }
     delete opCtx;
+    if (locker && locker->resetForReuse()) {
+        client->setCachedLocker(std::move(locker));
+    }
 }
 
 void ServiceContext::registerClientObserver(std::unique_ptr<ClientObserver> observer) {
@@ -91,6 +91,7 @@ void ServiceContextMongoD::createLockFile() {
                 false);
     }
     bool wasUnclean = _lockFile->createdByUncleanShutdown();
+    _wasUncleanShutdown = wasUnclean;
     auto openStatus = _lockFile->open();
     if (storageGlobalParams.readOnly && openStatus == ErrorCodes::IllegalOperation) {
         _lockFile.reset();
@@ -266,7 +267,9 @@ std::unique_ptr<OperationContext> ServiceContextMongoD::_newOpCtx(Client* client
     invariant(&cc() == client);
     auto opCtx = stdx::make_unique<OperationContext>(client, opId);
 
-    if (isMMAPV1()) {
+    if (auto locker = client->releaseCachedLocker()) {
+        opCtx->setLockState(std::move(locker));
+    } else if (isMMAPV1()) {
         opCtx->setLockState(stdx::make_unique<MMAPV1LockerImpl>());
     } else {
         opCtx->setLockState(stdx::make_unique<DefaultLockerImpl>());
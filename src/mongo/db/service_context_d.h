@@ -49,6 +49,14 @@ public:
 
     void createLockFile();
 
+    /**
+     * Returns true if the lock file showed that the server did not shut down cleanly the last time
+     * it used the data directory. Only meaningful after createLockFile().
+     */
+    bool wasUncleanShutdown() const {
+        return _wasUncleanShutdown;
+    }
+
     void initializeGlobalStorageEngine() override;
 
     void shutdownGlobalStorageEngineCleanly() override;
@@ -64,6 +72,7 @@ private:
     std::unique_ptr<OperationContext> _newOpCtx(Client* client, unsigned opId) override;
 
     std::unique_ptr<StorageEngineLockFile> _lockFile;
+    bool _wasUncleanShutdown = false;
 
     // logically owned here, but never deleted by anyone.
     StorageEngine* _storageEngine = nullptr;
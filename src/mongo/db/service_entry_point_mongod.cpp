@@ -52,6 +52,7 @@
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/logical_time_validator.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/query/find.h"
@@ -398,7 +399,7 @@ bool runCommandImpl(OperationContext* opCtx,
                     const OpMsgRequest& request,
                     rpc::ReplyBuilderInterface* replyBuilder,
                     LogicalTime startOperationTime) {
-    auto bytesToReserve = command->reserveBytesForReply();
+    auto bytesToReserve = command->replyBufferSizeHint();
 
 // SERVER-22100: In Windows DEBUG builds, the CRT heap debugging overhead, in conjunction with the
 // additional memory pressure introduced by reply buffer pre-allocation, causes the concurrency
@@ -503,6 +504,7 @@ bool runCommandImpl(OperationContext* opCtx,
     }
 
     inPlaceReplyBob.doneFast();
+    command->noteReplySize(inPlaceReplyBob.bb().len());
 
     BSONObjBuilder metadataBob;
     appendReplyMetadata(opCtx, request, &metadataBob);
@@ -560,6 +562,12 @@ void execCommandDatabase(OperationContext* opCtx,
         BSONElement shardVersionFieldIdx;
         BSONElement queryOptionMaxTimeMSField;
 
+        // Commands almost always carry a handful of top level fields, so duplicates are detected
+        // with a linear scan over a fixed-size array and only fall back to a hash map (which copies
+        // every key) once the command grows past it.
+        constexpr size_t kInlineFieldCount = 16;
+        std::array<StringData, kInlineFieldCount> inlineFields;
+        size_t numFields = 0;
         StringMap<int> topLevelFields;
         for (auto&& element : request.body) {
             StringData fieldName = element.fieldNameStringData();
@@ -573,10 +581,25 @@ void execCommandDatabase(OperationContext* opCtx,
                 queryOptionMaxTimeMSField = element;
             }
 
+            bool isDuplicate;
+            if (numFields < kInlineFieldCount) {
+                isDuplicate = std::find(inlineFields.begin(),
+                                        inlineFields.begin() + numFields,
+                                        fieldName) != inlineFields.begin() + numFields;
+                inlineFields[numFields++] = fieldName;
+            } else {
+                if (numFields++ == kInlineFieldCount) {
+                    for (auto&& name : inlineFields) {
+                        topLevelFields[name]++;
+                    }
+                }
+                isDuplicate = topLevelFields[fieldName]++ != 0;
+            }
+
             uassert(ErrorCodes::FailedToParse,
                     str::stream() << "Parsed command object contains duplicate top level key: "
                                   << fieldName,
-                    topLevelFields[fieldName]++ == 0);
+                    !isDuplicate);
         }
 
         if (Command::isHelpRequest(helpField)) {
@@ -667,7 +690,7 @@ void execCommandDatabase(OperationContext* opCtx,
 
         repl::ReadConcernArgs::get(opCtx) = uassertStatusOK(_extractReadConcern(
             request.body,
-            command->supportsNonLocalReadConcern(request.getDatabase().toString(), request.body)));
+            command->supportsNonLocalReadConcern(dbname, request.body)));
 
         // Don't handle the shard version that may have been sent along with the command iff
         //   fcv==3.4: This is a secondary.
@@ -1138,25 +1161,46 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
     }
     currentOp.ensureStarted();
     currentOp.done();
-    debug.executionTimeMicros = durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses());
+    const auto latencyMicros = durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses());
+    debug.executionTimeMicros = latencyMicros;
 
     Top::get(opCtx->getServiceContext())
-        .incrementGlobalLatencyStats(
-            opCtx,
-            durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
-            currentOp.getReadWriteType());
+        .incrementGlobalLatencyStats(opCtx, latencyMicros, currentOp.getReadWriteType());
+
+    // Like the global latency statistics, the per command ones only cover user operations.
+    if (auto command = currentOp.getCommand()) {
+        if (c.isFromUserConnection() && !c.isInDirectClient()) {
+            command->recordLatency(latencyMicros);
+        }
+    }
+
+    if (c.isFromUserConnection() && !c.isInDirectClient() &&
+        OperationTraceBuffer::shouldTrace(&c)) {
+        OperationTraceBuffer::get(opCtx->getServiceContext())
+            .add(OperationTraceBuffer::buildTrace(opCtx, &currentOp));
+    }
 
     const bool shouldSample = serverGlobalParams.sampleRate == 1.0
         ? true
         : c.getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
 
-    if (shouldLogOpDebug || (shouldSample && debug.executionTimeMicros > logThresholdMs * 1000LL)) {
+    const bool shouldLogOp =
+        shouldLogOpDebug || (shouldSample && debug.executionTimeMicros > logThresholdMs * 1000LL);
+    const bool shouldProfileOp = currentOp.shouldDBProfile(shouldSample);
+
+    if (shouldLogOp || shouldProfileOp) {
+        BSONObjBuilder storageStatsBuilder;
+        opCtx->recoveryUnit()->appendOperationStatistics(&storageStatsBuilder);
+        debug.storageStats = storageStatsBuilder.obj();
+    }
+
+    if (shouldLogOp) {
         Locker::LockerInfo lockerInfo;
         opCtx->lockState()->getLockerInfo(&lockerInfo);
         log() << debug.report(&c, currentOp, lockerInfo.stats);
     }
 
-    if (currentOp.shouldDBProfile(shouldSample)) {
+    if (shouldProfileOp) {
         // Performance profiling is on
         if (opCtx->lockState()->isReadLocked()) {
             LOG(1) << "note: not profiling because recursive read lock";
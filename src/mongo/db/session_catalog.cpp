@@ -65,6 +65,8 @@ const auto operationSessionDecoration =
 
 }  // namespace
 
+constexpr size_t SessionCatalog::kNumPartitions;
+
 SessionCatalog::SessionCatalog(ServiceContext* serviceContext) : _serviceContext(serviceContext) {}
 
 SessionCatalog::~SessionCatalog() = default;
@@ -141,9 +143,10 @@ ScopedCheckedOutSession SessionCatalog::checkOutSession(OperationContext* opCtx)
 
     const auto lsid = *opCtx->getLogicalSessionId();
 
-    stdx::unique_lock<stdx::mutex> ul(_mutex);
+    auto& partition = _partitionFor(lsid);
+    stdx::unique_lock<stdx::mutex> ul(partition.mutex);
 
-    auto sri = _getOrCreateSessionRuntimeInfo(opCtx, lsid, ul);
+    auto sri = _getOrCreateSessionRuntimeInfo(opCtx, lsid, partition, ul);
 
     // Wait until the session is no longer in use
     opCtx->waitForConditionOrInterrupt(
@@ -162,8 +165,9 @@ ScopedSession SessionCatalog::getOrCreateSession(OperationContext* opCtx,
     invariant(!opCtx->getTxnNumber());
 
     auto ss = [&] {
-        stdx::unique_lock<stdx::mutex> ul(_mutex);
-        return ScopedSession(_getOrCreateSessionRuntimeInfo(opCtx, lsid, ul));
+        auto& partition = _partitionFor(lsid);
+        stdx::unique_lock<stdx::mutex> ul(partition.mutex);
+        return ScopedSession(_getOrCreateSessionRuntimeInfo(opCtx, lsid, partition, ul));
     }();
 
     // Perform the refresh outside of the mutex
@@ -180,47 +184,61 @@ void SessionCatalog::invalidateSessions(OperationContext* opCtx,
                           << " cannot be performed using a transaction or on a session.",
             !opCtx->getLogicalSessionId());
 
-    const auto invalidateSessionFn = [&](WithLock, SessionRuntimeInfoMap::iterator it) {
-        auto& sri = it->second;
-        sri->txnState.invalidate();
-        _txnTable.erase(it);
-    };
-
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    const auto invalidateSessionFn =
+        [&](WithLock, Partition& partition, SessionRuntimeInfoMap::iterator it) {
+            auto& sri = it->second;
+            sri->txnState.invalidate();
+            partition.txnTable.erase(it);
+        };
 
     if (singleSessionDoc) {
         const auto lsid = LogicalSessionId::parse(IDLParserErrorContext("lsid"),
                                                   singleSessionDoc->getField("_id").Obj());
 
-        auto it = _txnTable.find(lsid);
-        if (it != _txnTable.end()) {
-            invalidateSessionFn(lg, it);
+        auto& partition = _partitionFor(lsid);
+        stdx::lock_guard<stdx::mutex> lg(partition.mutex);
+
+        auto it = partition.txnTable.find(lsid);
+        if (it != partition.txnTable.end()) {
+            invalidateSessionFn(lg, partition, it);
         }
     } else {
-        auto it = _txnTable.begin();
-        while (it != _txnTable.end()) {
-            invalidateSessionFn(lg, it++);
+        for (auto& partition : _partitions) {
+            stdx::lock_guard<stdx::mutex> lg(partition.mutex);
+
+            auto it = partition.txnTable.begin();
+            while (it != partition.txnTable.end()) {
+                invalidateSessionFn(lg, partition, it++);
+            }
         }
     }
 }
 
+SessionCatalog::Partition& SessionCatalog::_partitionFor(const LogicalSessionId& lsid) {
+    return _partitions[LogicalSessionIdHash()(lsid) % kNumPartitions];
+}
+
 std::shared_ptr<SessionCatalog::SessionRuntimeInfo> SessionCatalog::_getOrCreateSessionRuntimeInfo(
-    OperationContext* opCtx, const LogicalSessionId& lsid, stdx::unique_lock<stdx::mutex>& ul) {
+    OperationContext* opCtx,
+    const LogicalSessionId& lsid,
+    Partition& partition,
+    stdx::unique_lock<stdx::mutex>& ul) {
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
 
-    auto it = _txnTable.find(lsid);
-    if (it == _txnTable.end()) {
-        it = _txnTable.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
+    auto it = partition.txnTable.find(lsid);
+    if (it == partition.txnTable.end()) {
+        it = partition.txnTable.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
     }
 
     return it->second;
 }
 
 void SessionCatalog::_releaseSession(const LogicalSessionId& lsid) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    auto& partition = _partitionFor(lsid);
+    stdx::lock_guard<stdx::mutex> lg(partition.mutex);
 
-    auto it = _txnTable.find(lsid);
-    invariant(it != _txnTable.end());
+    auto it = partition.txnTable.find(lsid);
+    invariant(it != partition.txnTable.end());
 
     auto& sri = it->second;
     invariant(sri->state == SessionRuntimeInfo::kInUse);
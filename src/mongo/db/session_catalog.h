@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/session.h"
@@ -144,8 +146,8 @@ private:
         // Current state of the runtime info for a session
         State state{kAvailable};
 
-        // Signaled when the state becomes available. Uses the transaction table's mutex to protect
-        // the state transitions.
+        // Signaled when the state becomes available. Uses the mutex of the session's partition of
+        // the transaction table to protect the state transitions.
         stdx::condition_variable availableCondVar;
 
         // Must only be accessed when the state is kInUse and only by the operation context, which
@@ -158,12 +160,29 @@ private:
                                                       LogicalSessionIdHash>;
 
     /**
-     * Must be called with _mutex locked and returns it locked. May release and re-acquire it zero
-     * or more times before returning. The returned 'SessionRuntimeInfo' is guaranteed to be linked
-     * on the catalog's _txnTable as long as the lock is held.
+     * The transaction table is split by session id into partitions with their own mutex, so that
+     * operations on different sessions rarely contend.
+     */
+    static constexpr size_t kNumPartitions = 16;
+
+    struct Partition {
+        stdx::mutex mutex;
+        SessionRuntimeInfoMap txnTable;
+    };
+
+    Partition& _partitionFor(const LogicalSessionId& lsid);
+
+    /**
+     * Must be called with the mutex of the partition for 'lsid' locked and returns it locked. May
+     * release and re-acquire it zero or more times before returning. The returned
+     * 'SessionRuntimeInfo' is guaranteed to be linked on the partition's txnTable as long as the
+     * lock is held.
      */
     std::shared_ptr<SessionRuntimeInfo> _getOrCreateSessionRuntimeInfo(
-        OperationContext* opCtx, const LogicalSessionId& lsid, stdx::unique_lock<stdx::mutex>& ul);
+        OperationContext* opCtx,
+        const LogicalSessionId& lsid,
+        Partition& partition,
+        stdx::unique_lock<stdx::mutex>& ul);
 
     /**
      * Makes a session, previously checked out through 'checkoutSession', available again.
@@ -172,8 +191,7 @@ private:
 
     ServiceContext* const _serviceContext;
 
-    stdx::mutex _mutex;
-    SessionRuntimeInfoMap _txnTable;
+    std::array<Partition, kNumPartitions> _partitions;
 };
 
 /**
@@ -59,9 +59,15 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
+#include "mongo/util/crc32c.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/memory_accounting.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/unowned_ptr.h"
 
@@ -208,6 +214,14 @@ private:
         read(_buffer.get(), blockSize);
         massert(16816, "file too short?", !_done);
 
+        uint32_t checksum;
+        read(&checksum, sizeof(checksum));
+        massert(40641, "file too short?", !_done);
+        massert(40642,
+                str::stream() << "checksum mismatch in block of sorted data file \"" << _fileName
+                              << "\"",
+                checksum == crc32c(_buffer.get(), blockSize));
+
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
@@ -272,6 +286,115 @@ private:
     std::ifstream _file;
 };
 
+/**
+ * Drains another iterator on a background thread and hands its results over in batches, so that
+ * the work of producing them (reading, decompressing and merging files) overlaps with the
+ * consumer's.
+ */
+template <typename Key, typename Value>
+class AsyncIterator : public SortIteratorInterface<Key, Value> {
+public:
+    typedef SortIteratorInterface<Key, Value> Input;
+    typedef std::pair<Key, Value> Data;
+
+    explicit AsyncIterator(std::shared_ptr<Input> source)
+        : _thread([this, source] { produce(source); }) {}
+
+    ~AsyncIterator() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _stopRequested = true;
+        }
+        _cond.notify_all();
+        _thread.join();
+    }
+
+    bool more() {
+        if (_pos < _batch.size())
+            return true;
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cond.wait(lk, [&] { return !_batches.empty() || _producerDone; });
+        if (_batches.empty()) {
+            uassertStatusOK(_status);
+            return false;
+        }
+
+        _batch = std::move(_batches.front());
+        _batches.pop_front();
+        _pos = 0;
+        lk.unlock();
+        _cond.notify_all();
+        return true;
+    }
+
+    Data next() {
+        verify(more());
+        return std::move(_batch[_pos++]);
+    }
+
+private:
+    static const size_t kBatchSize = 1024;
+    static const size_t kMaxQueuedBatches = 4;
+
+    void produce(std::shared_ptr<Input> source) {
+        Status status = Status::OK();
+        try {
+            std::vector<Data> batch;
+            while (source->more()) {
+                // Results may point into the source's buffers, which the next call invalidates.
+                Data data = source->next();
+                batch.emplace_back(data.first.getOwned(), data.second.getOwned());
+                if (batch.size() == kBatchSize && !push(&batch)) {
+                    return;
+                }
+            }
+            if (!batch.empty()) {
+                push(&batch);
+            }
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _status = status;
+        _producerDone = true;
+        _cond.notify_all();
+    }
+
+    /**
+     * Queues 'batch' once there is room, leaving it empty. Returns false without queuing it if
+     * the consumer has gone away.
+     */
+    bool push(std::vector<Data>* batch) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cond.wait(lk, [&] { return _batches.size() < kMaxQueuedBatches || _stopRequested; });
+        if (_stopRequested) {
+            return false;
+        }
+        _batches.push_back(std::move(*batch));
+        batch->clear();
+        lk.unlock();
+        _cond.notify_all();
+        return true;
+    }
+
+    // Only touched by the consumer.
+    std::vector<Data> _batch;
+    size_t _pos = 0;
+
+    // Protects the members below, which are shared with the producer.
+    stdx::mutex _mutex;
+    stdx::condition_variable _cond;
+    std::deque<std::vector<Data>> _batches;
+    bool _producerDone = false;
+    bool _stopRequested = false;
+    Status _status = Status::OK();
+
+    // Declared last so that the members above exist before the producer starts.
+    stdx::thread _thread;
+};
+
 /** Merge-sorts results from 0 or more FileIterators */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
@@ -412,23 +535,39 @@ public:
         verify(_opts.limit == 0);
     }
 
+    ~NoLimitSorter() {
+        // Background spills refer to this sorter, so they must finish before it goes away.
+        for (auto&& spill : _pendingSpills) {
+            spill->thread.join();
+        }
+    }
+
     void add(const Key& key, const Value& val) {
         _data.push_back(std::make_pair(key, val));
 
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
-
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        _memoryCharge.set(_memUsed);
+
+        // Runs being spilled in the background still hold their data, so each run gets an equal
+        // share of the memory limit.
+        const size_t runMemoryBytes = _opts.extSortAllowed
+            ? _opts.maxMemoryUsageBytes / numThreads()
+            : _opts.maxMemoryUsageBytes;
+        if (_memUsed > runMemoryBytes)
             spill();
     }
 
     Iterator* done() {
         if (_iters.empty()) {
-            sort();
+            sort(&_data);
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
+        while (!_pendingSpills.empty()) {
+            finishOldestSpill();
+        }
         return Iterator::merge(_iters, _opts, _comp);
     }
 
@@ -453,9 +592,24 @@ private:
         const Comparator& _comp;
     };
 
-    void sort() {
+    /**
+     * A run being sorted and written to a file on a background thread.
+     */
+    struct PendingSpill {
+        size_t iterIndex;  // The slot in '_iters' reserved for the run.
+        std::deque<Data> data;
+        std::shared_ptr<Iterator> iter;
+        Status status = Status::OK();
+        stdx::thread thread;
+    };
+
+    size_t numThreads() const {
+        return std::max(_opts.numThreads, size_t(1));
+    }
+
+    void sort(std::deque<Data>* data) const {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        std::stable_sort(data->begin(), data->end(), less);
 
         // Does 2x more compares than stable_sort
         // TODO test on windows
@@ -479,24 +633,64 @@ private:
                           << " Pass allowDiskUse:true to opt in.");
         }
 
-        sort();
+        _memUsed = 0;
+        _memoryCharge.set(0);
 
-        SortedFileWriter<Key, Value> writer(_opts, _settings);
-        for (; !_data.empty(); _data.pop_front()) {
-            writer.addAlreadySorted(_data.front().first, _data.front().second);
+        if (numThreads() == 1) {
+            _iters.push_back(writeRun(&_data));
+            return;
         }
 
-        _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        // Keep at most numThreads() - 1 runs in flight, leaving a thread to keep adding data.
+        while (_pendingSpills.size() >= numThreads() - 1) {
+            finishOldestSpill();
+        }
 
-        _memUsed = 0;
+        auto pending = stdx::make_unique<PendingSpill>();
+        PendingSpill* spill = pending.get();
+        spill->iterIndex = _iters.size();
+        spill->data.swap(_data);
+        _iters.emplace_back();
+        _pendingSpills.push_back(std::move(pending));
+
+        spill->thread = stdx::thread([this, spill] {
+            try {
+                spill->iter = writeRun(&spill->data);
+            } catch (const DBException& ex) {
+                spill->status = ex.toStatus();
+            }
+        });
+    }
+
+    /**
+     * Sorts 'data' and writes it to a new file, leaving it empty.
+     */
+    std::shared_ptr<Iterator> writeRun(std::deque<Data>* data) const {
+        sort(data);
+
+        SortedFileWriter<Key, Value> writer(_opts, _settings);
+        for (; !data->empty(); data->pop_front()) {
+            writer.addAlreadySorted(data->front().first, data->front().second);
+        }
+        return std::shared_ptr<Iterator>(writer.done());
+    }
+
+    void finishOldestSpill() {
+        std::unique_ptr<PendingSpill> spill = std::move(_pendingSpills.front());
+        _pendingSpills.pop_front();
+        spill->thread.join();
+        uassertStatusOK(spill->status);
+        _iters[spill->iterIndex] = std::move(spill->iter);
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
+    MemoryAccount::Charge _memoryCharge{&memory_accounts::sorters};
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    std::deque<std::unique_ptr<PendingSpill>> _pendingSpills;  // oldest first
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -594,6 +788,7 @@ public:
             if (_data.size() == _opts.limit)
                 std::make_heap(_data.begin(), _data.end(), less);
 
+            _memoryCharge.set(_memUsed);
             if (_memUsed > _opts.maxMemoryUsageBytes)
                 spill();
 
@@ -617,6 +812,7 @@ public:
         _data.back() = contender;
         std::push_heap(_data.begin(), _data.end(), less);
 
+        _memoryCharge.set(_memUsed);
         if (_memUsed > _opts.maxMemoryUsageBytes)
             spill();
     }
@@ -774,12 +970,14 @@ private:
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
 
         _memUsed = 0;
+        _memoryCharge.set(0);
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
+    MemoryAccount::Charge _memoryCharge{&memory_accounts::sorters};
     std::vector<Data> _data;  // the "current" data. Organized as max-heap if size == limit.
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
 
@@ -884,11 +1082,15 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
+    // Each block is followed by a checksum of its bytes as written, which FileIterator verifies.
+    const uint32_t checksum = crc32c(outBuffer, size);
+
     // negative size means compressed
     size = shouldCompress ? -size : size;
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
         _file.write(outBuffer, std::abs(size));
+        _file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
 
     } catch (const std::exception&) {
         msgasserted(16821,
@@ -916,7 +1118,25 @@ SortIteratorInterface<Key, Value>* SortIteratorInterface<Key, Value>::merge(
     const std::vector<std::shared_ptr<SortIteratorInterface>>& iters,
     const SortOptions& opts,
     const Comparator& comp) {
-    return new sorter::MergeIterator<Key, Value, Comparator>(iters, opts, comp);
+    typedef sorter::MergeIterator<Key, Value, Comparator> MergeIterator;
+
+    const size_t numGroups = std::min(opts.numThreads, iters.size() / 2);
+    if (numGroups <= 1) {
+        return new MergeIterator(iters, opts, comp);
+    }
+
+    // Merge contiguous groups of inputs on background threads, then merge the groups' outputs.
+    // Ties are broken by input order at both levels, so the result is still stable.
+    std::vector<std::shared_ptr<SortIteratorInterface>> groups;
+    for (size_t group = 0; group < numGroups; ++group) {
+        const size_t begin = iters.size() * group / numGroups;
+        const size_t end = iters.size() * (group + 1) / numGroups;
+        const std::vector<std::shared_ptr<SortIteratorInterface>> groupIters(
+            iters.begin() + begin, iters.begin() + end);
+        groups.push_back(std::make_shared<sorter::AsyncIterator<Key, Value>>(
+            std::make_shared<MergeIterator>(groupIters, opts, comp)));
+    }
+    return new MergeIterator(groups, opts, comp);
 }
 
 template <typename Key, typename Value>
@@ -98,8 +98,11 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
+    size_t numThreads;           /// Threads used to spill and merge runs. 1 does all work on
+                                 /// the caller's thread. Memory stays within maxMemoryUsageBytes.
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    SortOptions()
+        : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false), numThreads(1) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -122,6 +125,11 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& NumThreads(size_t newNumThreads) {
+        numThreads = newNumThreads;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -222,6 +230,7 @@ private:
     template class ::mongo::sorter::TopKSorter<Key, Value, Comparator>;                  \
     template class ::mongo::sorter::MergeIterator<Key, Value, Comparator>;               \
     template class ::mongo::sorter::InMemIterator<Key, Value>;                           \
+    template class ::mongo::sorter::AsyncIterator<Key, Value>;                           \
     template class ::mongo::sorter::FileIterator<Key, Value>;                            \
     /* factory functions */                                                              \
     template ::mongo::SortIteratorInterface<Key, Value>* ::mongo::                       \
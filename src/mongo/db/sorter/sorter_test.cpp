@@ -330,6 +330,27 @@ public:
                 mergeIterators(iterators, ASC, SortOptions().Limit(10)),
                 make_shared<LimitIterator>(10, make_shared<IntIterator>(0, 20, 1)));
         }
+        {  // test merging groups of inputs on several threads
+            std::vector<std::shared_ptr<IWIterator>> iterators;
+            for (int i = 0; i < 10; i++) {
+                iterators.push_back(make_shared<IntIterator>(i, 10000, 10));
+            }
+            iterators.push_back(make_shared<EmptyIterator>());
+
+            std::shared_ptr<IWIterator> mergeIter(
+                IWIterator::merge(iterators, SortOptions().NumThreads(4), IWComparator()));
+            ASSERT_ITERATORS_EQUIVALENT(mergeIter, make_shared<IntIterator>(0, 10000, 1));
+        }
+        {  // test stopping a threaded merge early
+            std::vector<std::shared_ptr<IWIterator>> iterators;
+            for (int i = 0; i < 10; i++) {
+                iterators.push_back(make_shared<IntIterator>(i, 100000, 10));
+            }
+
+            std::shared_ptr<IWIterator> mergeIter(IWIterator::merge(
+                iterators, SortOptions().NumThreads(4).Limit(10), IWComparator()));
+            ASSERT_ITERATORS_EQUIVALENT(mergeIter, make_shared<IntIterator>(0, 10, 1));
+        }
     }
 };
 
@@ -518,6 +539,14 @@ public:
 };
 
 
+template <bool Random = true>
+class LotsOfDataParallel : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return Parent::adjustSortOptions(opts).NumThreads(4);
+    }
+};
+
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     typedef LotsOfDataLittleMemory<Random> Parent;
@@ -556,6 +585,8 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataParallel</*random=*/false>>();
+        add<SorterTests::LotsOfDataParallel</*random=*/true>>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
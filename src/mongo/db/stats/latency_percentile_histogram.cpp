@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/latency_percentile_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+int LatencyPercentileHistogram::getBucket(uint64_t micros) {
+    if (micros < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(micros);
+    }
+
+    const int exponent = 63 - countLeadingZeros64(micros);
+    if (exponent > kMaxExponent) {
+        return kNumBuckets - 1;
+    }
+
+    // The bits following the most significant one select the sub-bucket.
+    const int shift = exponent - kSubBucketBits;
+    const int subBucket = static_cast<int>((micros >> shift) & (kSubBuckets - 1));
+    return (shift + 1) * kSubBuckets + subBucket;
+}
+
+uint64_t LatencyPercentileHistogram::getBucketLowerBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+
+    const int shift = bucket / kSubBuckets - 1;
+    const uint64_t subBucket = bucket % kSubBuckets;
+    return (kSubBuckets + subBucket) << shift;
+}
+
+void LatencyPercentileHistogram::increment(uint64_t micros) {
+    _buckets[getBucket(micros)].fetchAndAdd(1);
+    _count.fetchAndAdd(1);
+    _sum.fetchAndAdd(micros);
+
+    auto max = _max.loadRelaxed();
+    while (micros > max) {
+        const auto previous = _max.compareAndSwap(max, micros);
+        if (previous == max) {
+            break;
+        }
+        max = previous;
+    }
+}
+
+uint64_t LatencyPercentileHistogram::getPercentile(double quantile) const {
+    const uint64_t count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, std::ceil(quantile * count));
+    const uint64_t max = _max.loadRelaxed();
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+        seen += _buckets[bucket].loadRelaxed();
+        if (seen >= rank) {
+            // Report the highest latency the bucket stands for, as no recorded latency is larger.
+            if (bucket == kNumBuckets - 1) {
+                return max;
+            }
+            return std::min(getBucketLowerBound(bucket + 1) - 1, max);
+        }
+    }
+
+    // Increments which raced with this read may have been counted, but not yet bucketed.
+    return max;
+}
+
+void LatencyPercentileHistogram::append(bool includeHistogram, BSONObjBuilder* builder) const {
+    builder->append("ops", static_cast<long long>(getCount()));
+    builder->append("latency", static_cast<long long>(_sum.loadRelaxed()));
+    builder->append("max", static_cast<long long>(_max.loadRelaxed()));
+    builder->append("p50", static_cast<long long>(getPercentile(0.5)));
+    builder->append("p95", static_cast<long long>(getPercentile(0.95)));
+    builder->append("p99", static_cast<long long>(getPercentile(0.99)));
+    builder->append("p999", static_cast<long long>(getPercentile(0.999)));
+
+    if (includeHistogram) {
+        BSONArrayBuilder arrayBuilder(builder->subarrayStart("histogram"));
+        for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+            const auto bucketCount = _buckets[bucket].loadRelaxed();
+            if (bucketCount == 0) {
+                continue;
+            }
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append("micros", static_cast<long long>(getBucketLowerBound(bucket)));
+            entryBuilder.append("count", static_cast<long long>(bucketCount));
+            entryBuilder.doneFast();
+        }
+        arrayBuilder.doneFast();
+    }
+}
+
+}  // namespace mongo
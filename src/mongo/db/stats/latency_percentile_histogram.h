@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A latency histogram with bounded relative error, from which percentiles can be computed.
+ *
+ * Latencies under 2^kSubBucketBits microseconds get a bucket each. Above that, every power of two
+ * range is split into 2^kSubBucketBits equal buckets, so a bucket's width is at most 1/32 of its
+ * lower bound, and a percentile is reported within about 3% of the latency actually recorded.
+ * Latencies of 2^kMaxExponent microseconds (about 19 hours) and more share the last bucket.
+ *
+ * All counters are atomic, so the histogram can be updated concurrently without a lock. A reader
+ * running concurrently with increments may see a slightly inconsistent snapshot.
+ */
+class LatencyPercentileHistogram {
+public:
+    static const int kSubBucketBits = 5;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    static const int kMaxExponent = 36;
+    static const int kNumBuckets = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    /**
+     * Records one operation which took 'micros' microseconds.
+     */
+    void increment(uint64_t micros);
+
+    /**
+     * Returns the number of operations recorded.
+     */
+    uint64_t getCount() const {
+        return _count.loadRelaxed();
+    }
+
+    /**
+     * Returns the latency, in microseconds, under which the fraction 'quantile' of the recorded
+     * operations fall. 'quantile' must be in [0, 1]. Returns 0 if nothing was recorded.
+     */
+    uint64_t getPercentile(double quantile) const;
+
+    /**
+     * Appends the number of operations, their total and maximum latency, the 50th, 95th, 99th and
+     * 99.9th percentiles and, if 'includeHistogram' is true, the non-empty buckets.
+     */
+    void append(bool includeHistogram, BSONObjBuilder* builder) const;
+
+    /**
+     * Returns the bucket recording latencies of 'micros' microseconds.
+     */
+    static int getBucket(uint64_t micros);
+
+    /**
+     * Returns the smallest latency recorded in 'bucket'.
+     */
+    static uint64_t getBucketLowerBound(int bucket);
+
+private:
+    std::array<AtomicUInt64, kNumBuckets> _buckets;
+    AtomicUInt64 _count;
+    AtomicUInt64 _sum;
+    AtomicUInt64 _max;
+};
+
+}  // namespace mongo
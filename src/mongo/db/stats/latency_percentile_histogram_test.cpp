@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/latency_percentile_histogram.h"
+
+#include <memory>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Histogram = LatencyPercentileHistogram;
+
+TEST(LatencyPercentileHistogram, BucketsAreContiguousAndOrdered) {
+    ASSERT_EQUALS(0U, Histogram::getBucketLowerBound(0));
+    for (int bucket = 1; bucket < Histogram::kNumBuckets; bucket++) {
+        auto lowerBound = Histogram::getBucketLowerBound(bucket);
+        ASSERT_GREATER_THAN(lowerBound, Histogram::getBucketLowerBound(bucket - 1));
+        ASSERT_EQUALS(bucket, Histogram::getBucket(lowerBound));
+        ASSERT_EQUALS(bucket - 1, Histogram::getBucket(lowerBound - 1));
+    }
+    ASSERT_EQUALS(Histogram::kNumBuckets - 1, Histogram::getBucket(~0ULL));
+}
+
+TEST(LatencyPercentileHistogram, BucketWidthIsBoundedRelativeToLatency) {
+    for (int bucket = Histogram::kSubBuckets; bucket < Histogram::kNumBuckets - 1; bucket++) {
+        auto lowerBound = Histogram::getBucketLowerBound(bucket);
+        auto width = Histogram::getBucketLowerBound(bucket + 1) - lowerBound;
+        ASSERT_LESS_THAN_OR_EQUALS(width * Histogram::kSubBuckets, lowerBound);
+    }
+}
+
+TEST(LatencyPercentileHistogram, EmptyHistogramReportsZero) {
+    auto hist = stdx::make_unique<Histogram>();
+    ASSERT_EQUALS(0U, hist->getCount());
+    ASSERT_EQUALS(0U, hist->getPercentile(0.99));
+}
+
+TEST(LatencyPercentileHistogram, PercentilesAreWithinTheRelativeError) {
+    auto hist = stdx::make_unique<Histogram>();
+    for (uint64_t micros = 1; micros <= 100000; micros++) {
+        hist->increment(micros);
+    }
+    ASSERT_EQUALS(100000U, hist->getCount());
+
+    for (double quantile : {0.5, 0.9, 0.99, 0.999}) {
+        const double expected = quantile * 100000;
+        const double reported = hist->getPercentile(quantile);
+        ASSERT_GREATER_THAN_OR_EQUALS(reported, expected);
+        ASSERT_LESS_THAN_OR_EQUALS(reported, expected * (1 + 1.0 / Histogram::kSubBuckets));
+    }
+    ASSERT_EQUALS(100000U, hist->getPercentile(1.0));
+}
+
+TEST(LatencyPercentileHistogram, AppendReportsTotalsAndNonEmptyBuckets) {
+    auto hist = stdx::make_unique<Histogram>();
+    hist->increment(3);
+    hist->increment(3);
+    hist->increment(5000);
+
+    BSONObjBuilder builder;
+    hist->append(true, &builder);
+    BSONObj out = builder.obj();
+    ASSERT_EQUALS(3, out["ops"].Long());
+    ASSERT_EQUALS(5006, out["latency"].Long());
+    ASSERT_EQUALS(5000, out["max"].Long());
+    ASSERT_EQUALS(3, out["p50"].Long());
+    ASSERT_EQUALS(5000, out["p999"].Long());
+
+    auto histogram = out["histogram"].Array();
+    ASSERT_EQUALS(2U, histogram.size());
+    ASSERT_EQUALS(3, histogram[0]["micros"].Long());
+    ASSERT_EQUALS(2, histogram[0]["count"].Long());
+    ASSERT_EQUALS(1, histogram[1]["count"].Long());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/stats/latency_percentile_histogram.h"
 #include "mongo/db/stats/top.h"
 
 namespace mongo {
@@ -57,5 +58,35 @@ public:
         return latencyBuilder.obj();
     }
 } globalHistogramServerStatusSection;
+
+/**
+ * Appends the latency percentiles of every command which was run, keyed by command name.
+ */
+class CommandLatencyServerStatusSection final : public ServerStatusSection {
+public:
+    CommandLatencyServerStatusSection() : ServerStatusSection("commandLatencies") {}
+
+    bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const {
+        bool includeHistograms = false;
+        if (configElem.type() == BSONType::Object) {
+            includeHistograms = configElem.Obj()["histograms"].trueValue();
+        }
+
+        BSONObjBuilder latencyBuilder;
+        for (const auto& entry : Command::allCommandsByBestName()) {
+            auto histogram = entry.second->getLatencyHistogram();
+            if (!histogram) {
+                continue;
+            }
+            BSONObjBuilder commandBuilder(latencyBuilder.subobjStart(entry.first));
+            histogram->append(includeHistograms, &commandBuilder);
+        }
+        return latencyBuilder.obj();
+    }
+} commandLatencyServerStatusSection;
 }  // namespace
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/concurrency/lock_contention_profiler.h"
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -124,5 +125,31 @@ public:
 
 } lockStatsServerStatusSection;
 
+
+/**
+ * Reports the number and total duration of the long lock waits by resource type while lock
+ * contention is profiled.
+ */
+class LockContentionServerStatusSection : public ServerStatusSection {
+public:
+    LockContentionServerStatusSection() : ServerStatusSection("lockContention") {}
+
+    virtual bool includeByDefault() const {
+        return true;
+    }
+
+    virtual BSONObj generateSection(OperationContext* opCtx,
+                                    const BSONElement& configElement) const {
+        if (!LockContentionProfiler::getThreshold()) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder ret;
+        LockContentionProfiler::get().appendSummary(&ret);
+        return ret.obj();
+    }
+
+} lockContentionServerStatusSection;
+
 }  // namespace
 }  // namespace mongo
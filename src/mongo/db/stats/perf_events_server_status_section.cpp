@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kFTDC
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/perf_event_counters.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Opens hardware performance counters for the process and reports them in the "perfEvents"
+ * serverStatus section, which diagnostic data capture then records with the rest of serverStatus.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(perfEventCountersEnabled, bool, false);
+
+class PerfEventsServerStatusSection final : public ServerStatusSection {
+public:
+    PerfEventsServerStatusSection() : ServerStatusSection("perfEvents") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        if (!perfEventCountersEnabled) {
+            return BSONObj();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_counters && _status.isOK()) {
+            auto swCounters = PerfEventCounters::create();
+            if (swCounters.isOK()) {
+                _counters = std::move(swCounters.getValue());
+            } else {
+                _status = swCounters.getStatus();
+                warning() << "Unable to open hardware performance counters: " << _status;
+            }
+        }
+
+        if (!_counters) {
+            return BSON("error" << _status.reason());
+        }
+
+        BSONObjBuilder builder;
+        _counters->append(&builder);
+        return builder.obj();
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+
+    // Opened the first time the section is generated. If that fails, '_status' holds the reason
+    // and the counters are not retried.
+    mutable std::unique_ptr<PerfEventCounters> _counters;
+    mutable Status _status = Status::OK();
+} perfEventsServerStatusSection;
+
+}  // namespace
+}  // namespace mongo
@@ -1689,7 +1689,10 @@ Decimal128 adjustDecimalExponent(TypeBits::Reader* typeBits, Decimal128 num) {
 }  // namespace
 
 BSONObj KeyString::toBson(const char* buffer, size_t len, Ordering ord, const TypeBits& typeBits) {
-    BSONObjBuilder builder;
+    // Size the builder from the encoded key rather than using the default of 512 bytes, since the
+    // returned object keeps the whole buffer alive. This is only a hint, the builder grows when a
+    // key with many small values decodes to more than that.
+    BSONObjBuilder builder(static_cast<int>(2 * len) + 16);
     BufReader reader(buffer, len);
     TypeBits::Reader typeBitsReader(typeBits);
     for (int i = 0; reader.remaining(); i++) {
@@ -1748,12 +1751,14 @@ std::string KeyString::toString() const {
 }
 
 int KeyString::compare(const KeyString& other) const {
-    int a = getSize();
-    int b = other.getSize();
-
-    int min = std::min(a, b);
+    return compare(getBuffer(), getSize(), other.getBuffer(), other.getSize());
+}
 
-    int cmp = memcmp(getBuffer(), other.getBuffer(), min);
+int KeyString::compare(const char* leftBuf,
+                       size_t leftSize,
+                       const char* rightBuf,
+                       size_t rightSize) {
+    int cmp = memcmp(leftBuf, rightBuf, std::min(leftSize, rightSize));
 
     if (cmp) {
         if (cmp < 0)
@@ -1763,10 +1768,10 @@ int KeyString::compare(const KeyString& other) const {
 
     // keys match
 
-    if (a == b)
+    if (leftSize == rightSize)
         return 0;
 
-    return a < b ? -1 : 1;
+    return leftSize < rightSize ? -1 : 1;
 }
 
 void KeyString::TypeBits::resetFromBuffer(BufReader* reader) {
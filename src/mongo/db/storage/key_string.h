@@ -345,6 +345,15 @@ public:
 
     int compare(const KeyString& other) const;
 
+    /**
+     * Compares two encoded KeyStrings given as raw buffers, for callers which hold the bytes of a
+     * key without a KeyString wrapping them. Returns -1, 0 or 1.
+     */
+    static int compare(const char* leftBuf,
+                       size_t leftSize,
+                       const char* rightBuf,
+                       size_t rightSize);
+
     /**
      * @return a hex encoding of this key
      */
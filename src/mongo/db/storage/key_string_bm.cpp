@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+BSONObj makeKey(int64_t numFields) {
+    BSONObjBuilder bob;
+    for (int64_t i = 0; i < numFields; ++i) {
+        switch (i % 3) {
+            case 0:
+                bob.append("", static_cast<int>(i * 1000));
+                break;
+            case 1:
+                bob.append("", "key string benchmark value");
+                break;
+            default:
+                bob.append("", i * 0.5);
+                break;
+        }
+    }
+    return bob.obj();
+}
+
+void BM_KeyStringEncode(benchmark::State& state) {
+    const BSONObj key = makeKey(state.range());
+    const RecordId rid(1234);
+    while (state.keepRunning()) {
+        KeyString ks(KeyString::Version::V1, key, kAllAscending, rid);
+        benchmark::doNotOptimize(ks.getSize());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+MONGO_BENCHMARK(BM_KeyStringEncode)->arg(1)->arg(3)->arg(12);
+
+void BM_KeyStringDecode(benchmark::State& state) {
+    const BSONObj key = makeKey(state.range());
+    const KeyString ks(KeyString::Version::V1, key, kAllAscending);
+    while (state.keepRunning()) {
+        BSONObj decoded =
+            KeyString::toBson(ks.getBuffer(), ks.getSize(), kAllAscending, ks.getTypeBits());
+        benchmark::doNotOptimize(decoded.objsize());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+MONGO_BENCHMARK(BM_KeyStringDecode)->arg(1)->arg(3)->arg(12);
+
+}  // namespace
+}  // namespace mongo
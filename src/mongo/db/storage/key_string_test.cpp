@@ -135,6 +135,24 @@ TEST_F(KeyStringTest, Simple1) {
         }                                                                  \
     } while (0)
 
+TEST_F(KeyStringTest, CompareRawBuffers) {
+    const KeyString a(version, BSON("" << 1 << "" << 2), ALL_ASCENDING);
+    const KeyString b(version, BSON("" << 1 << "" << 3), ALL_ASCENDING);
+    const KeyString prefix(version, BSON("" << 1), ALL_ASCENDING);
+
+    auto compareRaw = [](const KeyString& left, const KeyString& right) {
+        return KeyString::compare(
+            left.getBuffer(), left.getSize(), right.getBuffer(), right.getSize());
+    };
+
+    ASSERT_EQ(compareRaw(a, a), 0);
+    ASSERT_EQ(compareRaw(a, b), -1);
+    ASSERT_EQ(compareRaw(b, a), 1);
+    ASSERT_EQ(compareRaw(a, b), a.compare(b));
+    ASSERT_EQ(compareRaw(prefix, a), prefix.compare(a));
+    ASSERT_EQ(compareRaw(a, prefix), a.compare(prefix));
+}
+
 TEST_F(KeyStringTest, ActualBytesDouble) {
     // just one test like this for utter sanity
 
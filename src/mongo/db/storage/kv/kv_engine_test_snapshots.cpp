@@ -105,17 +105,20 @@ public:
         return createSnapshot();
     }
 
-    RecordId insertRecord(OperationContext* opCtx, std::string contents = "abcd") {
+    RecordId insertRecord(OperationContext* opCtx,
+                          std::string contents = "abcd",
+                          Timestamp timestamp = Timestamp()) {
         auto id =
-            rs->insertRecord(opCtx, contents.c_str(), contents.length() + 1, Timestamp(), false);
+            rs->insertRecord(opCtx, contents.c_str(), contents.length() + 1, timestamp, false);
         ASSERT_OK(id);
         return id.getValue();
     }
 
-    RecordId insertRecordAndCommit(std::string contents = "abcd") {
+    RecordId insertRecordAndCommit(std::string contents = "abcd",
+                                   Timestamp timestamp = Timestamp()) {
         auto op = makeOperation();
         WriteUnitOfWork wuow(op);
-        auto id = insertRecord(op, contents);
+        auto id = insertRecord(op, contents, timestamp);
         wuow.commit();
         return id;
     }
@@ -222,7 +225,7 @@ TEST_F(SnapshotManagerTests, FailsWithNoCommittedSnapshot) {
               ErrorCodes::ReadConcernMajorityNotAvailableYet);
 
     // Now there is a committed snapshot.
-    snapshotManager->setCommittedSnapshot(name, Timestamp(name.asU64()));
+    snapshotManager->setCommittedSnapshot(name, Timestamp());
     ASSERT_OK(ru->setReadFromMajorityCommittedSnapshot());
 
     // Not anymore!
@@ -239,7 +242,7 @@ TEST_F(SnapshotManagerTests, FailsAfterDropAllSnapshotsWhileYielded) {
 
     // Start an operation using a committed snapshot.
     auto name = prepareAndCreateSnapshot();
-    snapshotManager->setCommittedSnapshot(name, Timestamp(name.asU64()));
+    snapshotManager->setCommittedSnapshot(name, Timestamp());
     ASSERT_OK(op->recoveryUnit()->setReadFromMajorityCommittedSnapshot());
     ASSERT_EQ(itCountOn(op), 0);  // acquires a snapshot.
 
@@ -290,17 +293,17 @@ TEST_F(SnapshotManagerTests, BasicFunctionality) {
     auto snap4 = prepareAndCreateSnapshot();
 
     // If these fail, everything is busted.
-    snapshotManager->setCommittedSnapshot(snap0, Timestamp(snap0.asU64()));
+    snapshotManager->setCommittedSnapshot(snap0, Timestamp());
     ASSERT_EQ(itCountCommitted(), 0);
-    snapshotManager->setCommittedSnapshot(snap1, Timestamp(snap1.asU64()));
+    snapshotManager->setCommittedSnapshot(snap1, Timestamp());
     ASSERT_EQ(itCountCommitted(), 1);
 
     // If this fails, the snapshot is from the 'create' time rather than the 'prepare' time.
-    snapshotManager->setCommittedSnapshot(snap2, Timestamp(snap2.asU64()));
+    snapshotManager->setCommittedSnapshot(snap2, Timestamp());
     ASSERT_EQ(itCountCommitted(), 2);
 
     // If this fails, the snapshot contains writes that weren't yet committed.
-    snapshotManager->setCommittedSnapshot(snap3, Timestamp(snap3.asU64()));
+    snapshotManager->setCommittedSnapshot(snap3, Timestamp());
     ASSERT_EQ(itCountCommitted(), 3);
 
     // This op should keep its original snapshot until abandoned.
@@ -309,7 +312,7 @@ TEST_F(SnapshotManagerTests, BasicFunctionality) {
     ASSERT_EQ(itCountOn(longOp), 3);
 
     // If this fails, the snapshot contains writes that were rolled back.
-    snapshotManager->setCommittedSnapshot(snap4, Timestamp(snap4.asU64()));
+    snapshotManager->setCommittedSnapshot(snap4, Timestamp());
     ASSERT_EQ(itCountCommitted(), 4);
 
     // If this fails, longOp changed snapshots at an illegal time.
@@ -340,21 +343,53 @@ TEST_F(SnapshotManagerTests, UpdateAndDelete) {
     deleteRecordAndCommit(id);
     auto snapAfterDelete = prepareAndCreateSnapshot();
 
-    snapshotManager->setCommittedSnapshot(snapBeforeInsert, Timestamp(snapBeforeInsert.asU64()));
+    snapshotManager->setCommittedSnapshot(snapBeforeInsert, Timestamp());
     ASSERT_EQ(itCountCommitted(), 0);
     ASSERT(!readRecordCommitted(id));
 
-    snapshotManager->setCommittedSnapshot(snapDog, Timestamp(snapDog.asU64()));
+    snapshotManager->setCommittedSnapshot(snapDog, Timestamp());
     ASSERT_EQ(itCountCommitted(), 1);
     ASSERT_EQ(readStringCommitted(id), "Dog");
 
-    snapshotManager->setCommittedSnapshot(snapCat, Timestamp(snapCat.asU64()));
+    snapshotManager->setCommittedSnapshot(snapCat, Timestamp());
     ASSERT_EQ(itCountCommitted(), 1);
     ASSERT_EQ(readStringCommitted(id), "Cat");
 
-    snapshotManager->setCommittedSnapshot(snapAfterDelete, Timestamp(snapAfterDelete.asU64()));
+    snapshotManager->setCommittedSnapshot(snapAfterDelete, Timestamp());
     ASSERT_EQ(itCountCommitted(), 0);
     ASSERT(!readRecordCommitted(id));
 }
 
+TEST_F(SnapshotManagerTests, ReadsAtCommittedTimestamp) {
+    if (!snapshotManager)
+        return;  // This test is only for engines that DO support SnapshotMangers.
+
+    // No named snapshots are created: a committed snapshot with a timestamp is read at that
+    // timestamp.
+    insertRecordAndCommit("a", Timestamp(1, 1));
+    insertRecordAndCommit("b", Timestamp(1, 2));
+
+    snapshotManager->setCommittedSnapshot(SnapshotName(1), Timestamp(1, 1));
+    ASSERT_EQ(itCountCommitted(), 1);
+
+    // This op should keep its original snapshot until abandoned.
+    auto longOp = makeOperation();
+    ASSERT_OK(longOp->recoveryUnit()->setReadFromMajorityCommittedSnapshot());
+    ASSERT_EQ(itCountOn(longOp), 1);
+    ASSERT_EQ(*longOp->recoveryUnit()->getMajorityCommittedSnapshot(), SnapshotName(1));
+
+    snapshotManager->setCommittedSnapshot(SnapshotName(2), Timestamp(1, 2));
+    ASSERT_EQ(itCountCommitted(), 2);
+    ASSERT_EQ(itCountOn(longOp), 1);
+
+    longOp->recoveryUnit()->abandonSnapshot();
+    ASSERT_EQ(itCountOn(longOp), 2);
+    ASSERT_EQ(*longOp->recoveryUnit()->getMajorityCommittedSnapshot(), SnapshotName(2));
+
+    snapshotManager->dropAllSnapshots();
+    auto op = makeOperation();
+    ASSERT_EQ(op->recoveryUnit()->setReadFromMajorityCommittedSnapshot(),
+              ErrorCodes::ReadConcernMajorityNotAvailableYet);
+}
+
 }  // namespace mongo
@@ -58,6 +58,14 @@ public:
      */
     virtual void reportState(BSONObjBuilder* b) const {}
 
+    /**
+     * A storage engine may append statistics about the work it did on behalf of the operation
+     * using this recovery unit, such as the time spent waiting for its cache. Nothing should be
+     * appended for statistics which are zero, so that operations which did not wait are not
+     * reported as having done so.
+     */
+    virtual void appendOperationStatistics(BSONObjBuilder* b) const {}
+
     /**
      * These should be called through WriteUnitOfWork rather than directly.
      *
@@ -76,6 +76,10 @@ public:
      * Implementations are allowed to assume that all older snapshots have names that compare
      * less than the passed in name, and newer ones compare greater.
      *
+     * 'ts' is the timestamp of the snapshot's point-in-time, or null if it has none. Engines that
+     * support reading at a timestamp may serve committed reads at 'ts' instead of from the named
+     * snapshot.
+     *
      * This is called while holding a very hot mutex. Therefore it should avoid doing any work that
      * can be done later. In particular, cleaning up of old snapshots should be deferred until
      * cleanupUnneededSnapshots is called.
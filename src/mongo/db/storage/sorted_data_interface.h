@@ -42,6 +42,7 @@ namespace mongo {
 class BSONObjBuilder;
 class BucketDeletionNotification;
 class SortedDataBuilderInterface;
+struct CompactOptions;
 struct ValidateResults;
 
 /**
@@ -129,7 +130,7 @@ public:
      * Attempt to reduce the storage space used by this index via compaction. Only called if the
      * indexed record store supports compaction-in-place.
      */
-    virtual Status compact(OperationContext* opCtx) {
+    virtual Status compact(OperationContext* opCtx, const CompactOptions* options) {
         return Status::OK();
     }
 
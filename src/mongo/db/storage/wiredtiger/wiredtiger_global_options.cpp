@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/status.h"
+#include "mongo/config.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/util/log.h"
@@ -38,6 +39,18 @@
 
 namespace mongo {
 
+namespace {
+#ifdef MONGO_CONFIG_HAVE_ZSTD
+const char kBlockCompressorHelp[] = "[none|snappy|zlib|zstd]";
+const char kBlockCompressorFormat[] = "(:?none)|(:?snappy)|(:?zlib)|(:?zstd)";
+const char kBlockCompressorFormatName[] = "(none/snappy/zlib/zstd)";
+#else
+const char kBlockCompressorHelp[] = "[none|snappy|zlib]";
+const char kBlockCompressorFormat[] = "(:?none)|(:?snappy)|(:?zlib)";
+const char kBlockCompressorFormatName[] = "(none/snappy/zlib)";
+#endif
+}  // namespace
+
 WiredTigerGlobalOptions wiredTigerGlobalOptions;
 
 Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
@@ -83,9 +96,9 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
         .addOptionChaining("storage.wiredTiger.collectionConfig.blockCompressor",
                            "wiredTigerCollectionBlockCompressor",
                            moe::String,
-                           "block compression algorithm for collection data "
-                           "[none|snappy|zlib]")
-        .format("(:?none)|(:?snappy)|(:?zlib)", "(none/snappy/zlib)")
+                           std::string("block compression algorithm for collection data ") +
+                               kBlockCompressorHelp)
+        .format(kBlockCompressorFormat, kBlockCompressorFormatName)
         .setDefault(moe::Value(std::string("snappy")));
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.collectionConfig.configString",
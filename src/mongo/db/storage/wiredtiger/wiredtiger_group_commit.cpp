@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerGroupCommit, bool, true);
+
+namespace {
+
+// How long the flusher keeps a batch open after its first waiter arrives. With the default of 0
+// the flusher starts a flush as soon as there is a waiter, so batching only happens among the
+// writes that arrive while the previous flush is in progress.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerGroupCommitWindowMicros, int, 0);
+
+// A batch is closed early once this many waiters have joined it. Values below 1 mean no limit.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerGroupCommitMaxBatchWaiters, int, 1000);
+
+bool batchIsFull(std::uint64_t waiters) {
+    const auto maxWaiters = wiredTigerGroupCommitMaxBatchWaiters.load();
+    return maxWaiters > 0 && waiters >= static_cast<std::uint64_t>(maxWaiters);
+}
+
+std::uint64_t elapsedMicros(stdx::chrono::steady_clock::time_point start,
+                            stdx::chrono::steady_clock::time_point end) {
+    return stdx::chrono::duration_cast<stdx::chrono::microseconds>(end - start).count();
+}
+
+}  // namespace
+
+WiredTigerGroupCommitter::WiredTigerGroupCommitter(FlushFn flushFn) : _flushFn(std::move(flushFn)) {
+    invariant(_flushFn);
+}
+
+WiredTigerGroupCommitter::~WiredTigerGroupCommitter() {
+    shutdown();
+}
+
+void WiredTigerGroupCommitter::startup() {
+    invariant(!_flusherThread.joinable());
+    _flusherThread = stdx::thread([this] { _flusherThreadMain(); });
+}
+
+void WiredTigerGroupCommitter::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shuttingDown = true;
+        _flusherCV.notify_one();
+    }
+    if (_flusherThread.joinable()) {
+        _flusherThread.join();
+    }
+}
+
+void WiredTigerGroupCommitter::waitForFlush() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    uassert(ErrorCodes::ShutdownInProgress,
+            "Cannot wait for durability because a shutdown is in progress",
+            !_shuttingDown);
+
+    const auto batch = _openBatch;
+    ++_openBatchWaiters;
+    if (_openBatchWaiters == 1) {
+        _openBatchStart = stdx::chrono::steady_clock::now();
+        _flusherCV.notify_one();
+    } else if (batchIsFull(_openBatchWaiters)) {
+        _flusherCV.notify_one();
+    }
+
+    _waitersCV.wait(lk, [&] { return _flushedBatch >= batch; });
+
+    if (_firstFailedBatch && batch >= _firstFailedBatch) {
+        uassertStatusOK(_flushStatus);
+    }
+}
+
+void WiredTigerGroupCommitter::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("windowMicros", wiredTigerGroupCommitWindowMicros.load());
+    builder->append("maxBatchWaitersAllowed", wiredTigerGroupCommitMaxBatchWaiters.load());
+    builder->append("batches", static_cast<long long>(_numBatches));
+    builder->append("waitersFlushed", static_cast<long long>(_numWaitersFlushed));
+    builder->append("maxBatchWaiters", static_cast<long long>(_maxBatchWaiters));
+    builder->append("totalWindowMicros", static_cast<long long>(_totalWindowMicros));
+    builder->append("totalFlushMicros", static_cast<long long>(_totalFlushMicros));
+}
+
+void WiredTigerGroupCommitter::_flusherThreadMain() {
+    setThreadName("WTGroupCommit");
+    LOG(1) << "starting WTGroupCommit thread";
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        {
+            MONGO_IDLE_THREAD_BLOCK;
+            _flusherCV.wait(lk, [&] { return _openBatchWaiters > 0 || _shuttingDown; });
+        }
+
+        // Waiters that joined before shutdown still get their flush.
+        if (_openBatchWaiters == 0) {
+            break;
+        }
+
+        // Keep the batch open to let more waiters join it.
+        const auto windowMicros = wiredTigerGroupCommitWindowMicros.load();
+        if (windowMicros > 0) {
+            const auto deadline = _openBatchStart + stdx::chrono::microseconds(windowMicros);
+            _flusherCV.wait_until(
+                lk, deadline, [&] { return _shuttingDown || batchIsFull(_openBatchWaiters); });
+        }
+
+        const auto batch = _openBatch++;
+        const auto waiters = _openBatchWaiters;
+        const auto batchStart = _openBatchStart;
+        _openBatchWaiters = 0;
+        lk.unlock();
+
+        const auto flushStart = stdx::chrono::steady_clock::now();
+        Status status = Status::OK();
+        try {
+            _flushFn();
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+        const auto flushEnd = stdx::chrono::steady_clock::now();
+
+        lk.lock();
+        if (!status.isOK() && !_firstFailedBatch) {
+            _firstFailedBatch = batch;
+            _flushStatus = status;
+        }
+        _flushedBatch = batch;
+        _numBatches++;
+        _numWaitersFlushed += waiters;
+        _maxBatchWaiters = std::max(_maxBatchWaiters, waiters);
+        _totalWindowMicros += elapsedMicros(batchStart, flushStart);
+        _totalFlushMicros += elapsedMicros(flushStart, flushEnd);
+        _waitersCV.notify_all();
+    }
+
+    LOG(1) << "stopping WTGroupCommit thread";
+}
+
+}  // namespace mongo
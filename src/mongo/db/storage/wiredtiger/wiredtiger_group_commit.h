@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+// Startup parameter. When true, waitUntilDurable() calls that only need the journal flushed go
+// through a WiredTigerGroupCommitter.
+extern bool wiredTigerGroupCommit;
+
+/**
+ * Coalesces journal flushes requested by j:true writes into group commits.
+ *
+ * Threads calling waitForFlush() join the currently open batch and block. A dedicated flusher
+ * thread closes the batch once it has been open for wiredTigerGroupCommitWindowMicros, or as soon
+ * as wiredTigerGroupCommitMaxBatchWaiters threads have joined it, runs the flush function once
+ * and wakes up every thread in the batch. Threads arriving while a flush is in progress form the
+ * next batch.
+ */
+class WiredTigerGroupCommitter {
+    MONGO_DISALLOW_COPYING(WiredTigerGroupCommitter);
+
+public:
+    /**
+     * Makes all writes committed before the call durable. Throws on failure.
+     */
+    using FlushFn = stdx::function<void()>;
+
+    explicit WiredTigerGroupCommitter(FlushFn flushFn);
+    ~WiredTigerGroupCommitter();
+
+    /**
+     * Starts the flusher thread.
+     */
+    void startup();
+
+    /**
+     * Flushes batches that already have waiters and stops the flusher thread. Subsequent calls to
+     * waitForFlush() throw ShutdownInProgress.
+     */
+    void shutdown();
+
+    /**
+     * Blocks until a flush that started after this call has completed. Rethrows the error raised
+     * by the flush function, or throws ShutdownInProgress if the committer has been shut down.
+     */
+    void waitForFlush();
+
+    /**
+     * Appends batching statistics for serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    void _flusherThreadMain();
+
+    const FlushFn _flushFn;
+
+    stdx::thread _flusherThread;
+
+    // Protects the member variables below.
+    mutable stdx::mutex _mutex;
+
+    // Signaled when the open batch gets its first waiter, when it reaches the maximum number of
+    // waiters, and on shutdown.
+    stdx::condition_variable _flusherCV;
+
+    // Signaled when a batch has been flushed.
+    stdx::condition_variable _waitersCV;
+
+    bool _shuttingDown = false;
+
+    // Batches are numbered from 1. '_openBatch' is the batch new waiters join; every batch up to
+    // and including '_flushedBatch' has been flushed.
+    std::uint64_t _openBatch = 1;
+    std::uint64_t _flushedBatch = 0;
+    std::uint64_t _openBatchWaiters = 0;
+    stdx::chrono::steady_clock::time_point _openBatchStart;
+
+    // Status of the first failed flush and the batch it failed for. Waiters in that batch and in
+    // later ones get the error.
+    std::uint64_t _firstFailedBatch = 0;
+    Status _flushStatus = Status::OK();
+
+    // Statistics.
+    std::uint64_t _numBatches = 0;
+    std::uint64_t _numWaitersFlushed = 0;
+    std::uint64_t _maxBatchWaiters = 0;
+    std::uint64_t _totalWindowMicros = 0;
+    std::uint64_t _totalFlushMicros = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+void setParameter(StringData name, StringData value) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find(name.toString());
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString(value.toString()));
+}
+
+TEST(WiredTigerGroupCommitterTest, SingleWaiterTriggersFlush) {
+    AtomicInt32 flushes(0);
+    WiredTigerGroupCommitter committer([&] { flushes.fetchAndAdd(1); });
+    committer.startup();
+
+    committer.waitForFlush();
+    ASSERT_EQUALS(1, flushes.load());
+
+    committer.waitForFlush();
+    ASSERT_EQUALS(2, flushes.load());
+}
+
+TEST(WiredTigerGroupCommitterTest, ConcurrentWaitersShareOneFlush) {
+    // Hold the batch open until all waiters have joined it.
+    setParameter("wiredTigerGroupCommitWindowMicros", "60000000");
+    setParameter("wiredTigerGroupCommitMaxBatchWaiters", "4");
+    ON_BLOCK_EXIT([] {
+        setParameter("wiredTigerGroupCommitWindowMicros", "0");
+        setParameter("wiredTigerGroupCommitMaxBatchWaiters", "1000");
+    });
+
+    AtomicInt32 flushes(0);
+    WiredTigerGroupCommitter committer([&] { flushes.fetchAndAdd(1); });
+    committer.startup();
+
+    std::vector<stdx::thread> waiters;
+    for (int i = 0; i < 4; ++i) {
+        waiters.emplace_back([&] { committer.waitForFlush(); });
+    }
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+    ASSERT_EQUALS(1, flushes.load());
+
+    BSONObjBuilder bob;
+    committer.appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQUALS(1LL, stats["batches"].numberLong());
+    ASSERT_EQUALS(4LL, stats["waitersFlushed"].numberLong());
+    ASSERT_EQUALS(4LL, stats["maxBatchWaiters"].numberLong());
+}
+
+TEST(WiredTigerGroupCommitterTest, FlushErrorIsReturnedToWaiters) {
+    WiredTigerGroupCommitter committer(
+        [] { uasserted(ErrorCodes::ShutdownInProgress, "flush failed"); });
+    committer.startup();
+
+    ASSERT_THROWS_CODE(
+        committer.waitForFlush(), AssertionException, ErrorCodes::ShutdownInProgress);
+}
+
+TEST(WiredTigerGroupCommitterTest, WaitAfterShutdownThrows) {
+    WiredTigerGroupCommitter committer([] {});
+    committer.startup();
+    committer.shutdown();
+
+    ASSERT_THROWS_CODE(
+        committer.waitForFlush(), AssertionException, ErrorCodes::ShutdownInProgress);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -37,6 +37,7 @@
 #include <set>
 
 #include "mongo/base/checked_cast.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -504,13 +505,10 @@ Status WiredTigerIndex::initAsEmpty(OperationContext* opCtx) {
     return Status::OK();
 }
 
-Status WiredTigerIndex::compact(OperationContext* opCtx) {
+Status WiredTigerIndex::compact(OperationContext* opCtx, const CompactOptions* options) {
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx)->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, uri().c_str(), "timeout=0");
-        invariantWTOK(ret);
+        return WiredTigerUtil::compact(opCtx, uri(), options->timeLimit);
     }
     return Status::OK();
 }
@@ -841,6 +839,11 @@ protected:
     // Called after _key has been filled in. Must not throw WriteConflictException.
     virtual void updateIdAndTypeBits() = 0;
 
+    // Called by curr() before decoding _key for cursors which defer reading the TypeBits until
+    // the key is requested. The WT cursor is still positioned on the entry last read by
+    // updatePosition(). Must not throw WriteConflictException.
+    virtual void ensureTypeBits() {}
+
     void setKey(WT_CURSOR* cursor, const WT_ITEM* item) {
         if (_prefix == KVPrefix::kNotPrefixed) {
             cursor->set_key(cursor, item);
@@ -870,7 +873,7 @@ protected:
         return _prefix.repr() != prefix;
     }
 
-    boost::optional<IndexKeyEntry> curr(RequestedInfo parts) const {
+    boost::optional<IndexKeyEntry> curr(RequestedInfo parts) {
         if (_eof)
             return {};
 
@@ -879,6 +882,7 @@ protected:
 
         BSONObj bson;
         if (TRACING_ENABLED || (parts & kWantKey)) {
+            ensureTypeBits();
             bson = KeyString::toBson(_key.getBuffer(), _key.getSize(), _idx.ordering(), _typeBits);
 
             TRACE_CURSOR << " returning " << bson << ' ' << _id;
@@ -975,9 +979,10 @@ protected:
         if (isForwardNextCall) {
             // Due to a bug in wired tiger (SERVER-21867) sometimes calling next
             // returns something prev.
-            const int cmp =
-                std::memcmp(_key.getBuffer(), item.data, std::min(_key.getSize(), item.size));
-            bool nextNotIncreasing = cmp > 0 || (cmp == 0 && _key.getSize() > item.size);
+            bool nextNotIncreasing = KeyString::compare(_key.getBuffer(),
+                                                        _key.getSize(),
+                                                        static_cast<const char*>(item.data),
+                                                        item.size) > 0;
 
             if (MONGO_FAIL_POINT(WTEmulateOutOfOrderNextIndexKey)) {
                 log() << "WTIndex::updatePosition simulating next key not increasing.";
@@ -1044,12 +1049,25 @@ public:
     void updateIdAndTypeBits() override {
         _id = KeyString::decodeRecordIdAtEnd(_key.getBuffer(), _key.getSize());
 
+        // The TypeBits are stored in the value and are only needed to turn the key back into
+        // BSON, so callers that only want the RecordId, such as count scans, never read it.
+        _typeBitsUpToDate = false;
+    }
+
+    void ensureTypeBits() override {
+        if (_typeBitsUpToDate)
+            return;
+
         WT_CURSOR* c = _cursor->get();
         WT_ITEM item;
         invariantWTOK(c->get_value(c, &item));
         BufReader br(item.data, item.size);
         _typeBits.resetFromBuffer(&br);
+        _typeBitsUpToDate = true;
     }
+
+private:
+    bool _typeBitsUpToDate = false;
 };
 
 class WiredTigerIndexUniqueCursor final : public WiredTigerIndexCursorBase {
@@ -93,6 +93,21 @@ using std::string;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+// When set, dropping an ident only queues its table for removal instead of dropping it in the
+// dropping operation. The queue is drained in the background by threads releasing sessions, so
+// dropping a database with many collections no longer waits on the file system while holding its
+// lock. Tables still queued at shutdown are dropped on the next startup as unknown idents.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerDeferIdentDrops, bool, false);
+
+// The most tables a single background pass drops from the queue, which limits how much the
+// reaping competes with user operations. Values of 0 or less leave the pass size to its default
+// of the larger of 10 tables or a tenth of the queue.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMaxQueuedIdentDropsPerPass, int, 0);
+
+}  // namespace
+
 class WiredTigerKVEngine::WiredTigerJournalFlusher : public BackgroundJob {
 public:
     explicit WiredTigerJournalFlusher(WiredTigerSessionCache* sessionCache)
@@ -261,15 +276,21 @@ private:
 
 namespace {
 
+// The ticket holders are created along with the first WiredTigerKVEngine, once the ticket queueing
+// policy is known. Until then, only the number of tickets is recorded.
 class TicketServerParameter : public ServerParameter {
     MONGO_DISALLOW_COPYING(TicketServerParameter);
 
 public:
-    TicketServerParameter(TicketHolder* holder, const std::string& name)
+    TicketServerParameter(std::unique_ptr<TicketHolder>* holder, const std::string& name)
         : ServerParameter(ServerParameterSet::getGlobal(), name, true, true), _holder(holder) {}
 
     virtual void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) {
-        b.append(name, _holder->outof());
+        b.append(name, *_holder ? (*_holder)->outof() : _initialSize);
+    }
+
+    int getInitialSize() const {
+        return _initialSize;
     }
 
     virtual Status set(const BSONElement& newValueElement) {
@@ -291,21 +312,55 @@ public:
             return Status(ErrorCodes::BadValue, str::stream() << name() << " has to be > 0");
         }
 
-        return _holder->resize(newNum);
+        if (!*_holder) {
+            _initialSize = newNum;
+            return Status::OK();
+        }
+        return (*_holder)->resize(newNum);
     }
 
 private:
-    TicketHolder* _holder;
+    std::unique_ptr<TicketHolder>* _holder;
+    int _initialSize = 128;
 };
 
-TicketHolder openWriteTransaction(128);
+std::unique_ptr<TicketHolder> openWriteTransaction;
 TicketServerParameter openWriteTransactionParam(&openWriteTransaction,
                                                 "wiredTigerConcurrentWriteTransactions");
 
-TicketHolder openReadTransaction(128);
+std::unique_ptr<TicketHolder> openReadTransaction;
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// How threads waiting for a read or write ticket are woken: "semaphore" wakes them in no
+// particular order, "fifo" wakes them in the order they started waiting.
+std::string wiredTigerTicketQueueingPolicy = "semaphore";
+
+class ExportedTicketQueueingPolicyParameter
+    : public ExportedServerParameter<std::string, ServerParameterType::kStartupOnly> {
+public:
+    ExportedTicketQueueingPolicyParameter()
+        : ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "wiredTigerTicketQueueingPolicy",
+              &wiredTigerTicketQueueingPolicy) {}
+
+    Status validate(const std::string& potentialNewValue) override {
+        if (potentialNewValue != "semaphore" && potentialNewValue != "fifo") {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerTicketQueueingPolicy must be 'semaphore' or 'fifo'");
+        }
+        return Status::OK();
+    }
+} exportedTicketQueueingPolicyParam;
+
+std::unique_ptr<TicketHolder> makeTicketHolder(int numTickets) {
+    if (wiredTigerTicketQueueingPolicy == "fifo") {
+        return stdx::make_unique<FifoTicketHolder>(numTickets);
+    }
+    return stdx::make_unique<SemaphoreTicketHolder>(numTickets);
+}
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
@@ -412,6 +467,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionCache.reset(new WiredTigerSessionCache(this));
 
     if (_durable && !_ephemeral) {
+        if (wiredTigerGroupCommit) {
+            _sessionCache->startGroupCommit();
+        }
         _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
         _journalFlusher->go();
     }
@@ -433,7 +491,13 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         new WiredTigerSizeStorer(_conn, _sizeStorerUri, sizeStorerLoggingEnabled, _readOnly));
     _sizeStorer->fillCache();
 
-    Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+    // The ticket holders outlive any engine, since lockers may still hold tickets when an engine
+    // is destroyed.
+    if (!openReadTransaction) {
+        openReadTransaction = makeTicketHolder(openReadTransactionParam.getInitialSize());
+        openWriteTransaction = makeTicketHolder(openWriteTransactionParam.getInitialSize());
+    }
+    Locker::setGlobalThrottling(openReadTransaction.get(), openWriteTransaction.get());
 }
 
 
@@ -449,16 +513,12 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
-        bbb.append("out", openWriteTransaction.used());
-        bbb.append("available", openWriteTransaction.available());
-        bbb.append("totalTickets", openWriteTransaction.outof());
+        openWriteTransaction->appendStats(&bbb);
         bbb.done();
     }
     {
         BSONObjBuilder bbb(bb.subobjStart("read"));
-        bbb.append("out", openReadTransaction.used());
-        bbb.append("available", openReadTransaction.available());
-        bbb.append("totalTickets", openReadTransaction.outof());
+        openReadTransaction->appendStats(&bbb);
         bbb.done();
     }
     bb.done();
@@ -786,6 +846,16 @@ Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, StringData ident)
     ru->getSessionNoTxn(opCtx)->closeAllCursors(uri);
     _sessionCache->closeAllCursors(uri);
 
+    if (wiredTigerDeferIdentDrops.load()) {
+        LOG(1) << "WT queueing drop of " << uri;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_identToDropMutex);
+            _identToDrop.push_back(uri);
+        }
+        _sessionCache->closeCursorsForQueuedDrops();
+        return Status::OK();
+    }
+
     WiredTigerSession session(_conn);
 
     int ret = session.getSession()->drop(
@@ -868,6 +938,10 @@ void WiredTigerKVEngine::dropSomeQueuedIdents() {
     if (tenPercentQueue > 10)
         numToDelete = tenPercentQueue;
 
+    const int maxPerPass = wiredTigerMaxQueuedIdentDropsPerPass.load();
+    if (maxPerPass > 0 && numToDelete > maxPerPass)
+        numToDelete = maxPerPass;
+
     LOG(1) << "WT Queue is: " << numInQueue << " attempting to drop: " << numToDelete << " tables";
     for (int i = 0; i < numToDelete; i++) {
         string uri;
@@ -125,9 +125,15 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
 }
 
 void WiredTigerOplogManager::triggerJournalFlush() {
+    // The journal thread clears the flag before it fetches the all_committed timestamp, so if a
+    // refresh is still pending it is guaranteed to observe the write that was just committed.
+    if (_opsWaitingForJournal.load()) {
+        return;
+    }
+
     stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
-    if (!_opsWaitingForJournal) {
-        _opsWaitingForJournal = true;
+    if (!_opsWaitingForJournal.load()) {
+        _opsWaitingForJournal.store(true);
         _opsWaitingForJournalCV.notify_one();
     }
 }
@@ -143,8 +149,8 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
         stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
         {
             MONGO_IDLE_THREAD_BLOCK;
-            _opsWaitingForJournalCV.wait(lk,
-                                         [&] { return _shuttingDown || _opsWaitingForJournal; });
+            _opsWaitingForJournalCV.wait(
+                lk, [&] { return _shuttingDown || _opsWaitingForJournal.load(); });
         }
 
         while (!_shuttingDown && MONGO_FAIL_POINT(WTPausePrimaryOplogDurabilityLoop)) {
@@ -157,7 +163,7 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
             log() << "oplog journal thread loop shutting down";
             return;
         }
-        _opsWaitingForJournal = false;
+        _opsWaitingForJournal.store(false);
         lk.unlock();
 
         char allCommittedTimestampBuf[TIMESTAMP_BUF_SIZE];
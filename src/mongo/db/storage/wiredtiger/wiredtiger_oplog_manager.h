@@ -90,7 +90,11 @@ private:
     // This is the RecordId of the newest oplog document in the oplog on startup.  It is used as a
     // floor in waitForAllEarlierOplogWritesToBeVisible().
     RecordId _oplogMaxAtStartup = RecordId(0);  // Guarded by oplogVisibilityStateMutex.
-    bool _opsWaitingForJournal = false;         // Guarded by oplogVisibilityStateMutex.
+
+    // Set when a commit has asked for the oplog read timestamp to be refreshed. Only written while
+    // holding oplogVisibilityStateMutex, but read without it so that concurrent oplog commits do
+    // not all serialize on the mutex while a refresh is already pending.
+    AtomicBool _opsWaitingForJournal{false};
 
     AtomicUInt64 _oplogReadTimestamp;
 };
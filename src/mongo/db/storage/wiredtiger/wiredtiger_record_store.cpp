@@ -38,12 +38,14 @@
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -82,6 +84,116 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// The oplog truncation thread waits before removing the next stone while dirty data makes up more
+// than this percentage of the WiredTiger cache, so that it does not add to the eviction work that
+// foreground writes are already throttled on. Values of 0 or less disable the pacing.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogTruncationMaxDirtyCachePercent, int, 15);
+
+// Longest time the truncation thread waits for cache pressure to subside before removing a stone
+// anyway, which bounds how far the oplog can grow past its configured size.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogTruncationMaxPauseMillis, int, 1000);
+
+const Milliseconds kOplogTruncationPauseInterval{50};
+
+bool isCacheOverDirtyLimit(WT_SESSION* session, int maxDirtyPercent) {
+    const auto dirtyBytes = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+        session, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    const auto maxBytes = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+        session, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_MAX);
+    if (!dirtyBytes.isOK() || !maxBytes.isOK() || maxBytes.getValue() <= 0) {
+        return false;
+    }
+
+    return dirtyBytes.getValue() * 100 > maxBytes.getValue() * maxDirtyPercent;
+}
+
+void pauseOplogTruncationForCachePressure(OperationContext* opCtx) {
+    const int maxDirtyPercent = wiredTigerOplogTruncationMaxDirtyCachePercent.load();
+    if (maxDirtyPercent <= 0) {
+        return;
+    }
+
+    const Milliseconds maxPause{std::max(0, wiredTigerOplogTruncationMaxPauseMillis.load())};
+    WiredTigerRecoveryUnit* ru = WiredTigerRecoveryUnit::get(opCtx);
+
+    Milliseconds paused{0};
+    while (paused < maxPause &&
+           isCacheOverDirtyLimit(ru->getSession(opCtx)->getSession(), maxDirtyPercent)) {
+        // Do not pin a snapshot while waiting for eviction to catch up.
+        ru->abandonSnapshot();
+        sleepmillis(durationCount<Milliseconds>(kOplogTruncationPauseInterval));
+        paused += kOplogTruncationPauseInterval;
+    }
+
+    if (paused > Milliseconds(0)) {
+        LOG(1) << "Paused oplog truncation for " << paused
+               << " because of WiredTiger cache pressure";
+    }
+}
+
+// updateRecord() writes records at least this large as a delta against their old value when few
+// of their bytes change, so that WiredTiger keeps a small modify entry in its update chain rather
+// than a full copy of the record.
+const size_t kMinLengthForModify = 1024;
+
+// A delta may replace at most this fraction of the new value.
+const size_t kMaxModifyFraction = 10;
+
+// Records are usually BSON, whose first bytes hold the size of the document. They are compared
+// separately so that a change in size alone does not end the common prefix.
+const size_t kLengthPrefixBytes = 4;
+
+/**
+ * Fills 'entries' with up to two WT_MODIFY entries which turn 'oldValue' into the 'len' bytes at
+ * 'data': one for the length prefix if it differs, and one replacing whatever lies between the
+ * remaining common prefix and the common suffix. Returns the number of entries, or 0 if the values
+ * are too small, identical, or differ in too many bytes for a delta to be worthwhile.
+ */
+int calculateModify(const WT_ITEM& oldValue, const char* data, size_t len, WT_MODIFY entries[2]) {
+    const char* oldData = static_cast<const char*>(oldValue.data);
+    const size_t oldLen = oldValue.size;
+    if (len < kMinLengthForModify || oldLen < kMinLengthForModify) {
+        return 0;
+    }
+
+    int nentries = 0;
+    if (memcmp(oldData, data, kLengthPrefixBytes) != 0) {
+        entries[nentries].data.data = data;
+        entries[nentries].data.size = kLengthPrefixBytes;
+        entries[nentries].offset = 0;
+        entries[nentries].size = kLengthPrefixBytes;
+        ++nentries;
+    }
+
+    const size_t maxCommon = std::min(oldLen, len);
+    size_t prefix = kLengthPrefixBytes;
+    while (prefix < maxCommon && oldData[prefix] == data[prefix]) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < maxCommon - prefix && oldData[oldLen - 1 - suffix] == data[len - 1 - suffix]) {
+        ++suffix;
+    }
+
+    const size_t oldBytes = oldLen - prefix - suffix;
+    const size_t newBytes = len - prefix - suffix;
+    if (oldBytes == 0 && newBytes == 0 && nentries == 0) {
+        return 0;
+    }
+    if (nentries * kLengthPrefixBytes + std::max(oldBytes, newBytes) > len / kMaxModifyFraction) {
+        return 0;
+    }
+
+    if (oldBytes != 0 || newBytes != 0) {
+        entries[nentries].data.data = data + prefix;
+        entries[nentries].data.size = newBytes;
+        entries[nentries].offset = prefix;
+        entries[nentries].size = oldBytes;
+        ++nentries;
+    }
+    return nentries;
+}
 }  // namespace
 
 MONGO_FP_DECLARE(WTWriteConflictException);
@@ -694,12 +806,24 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
 }
 
 void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
+    if (!_isCapped && _sizeStorer) {
+        // The size and count come from the size storer, and the largest RecordId in use is only
+        // needed for inserts. Opening the table can wait until then, which keeps startup cheap for
+        // instances with many collections.
+        long long numRecords;
+        long long dataSize;
+        _sizeStorer->loadFromCache(_uri, &numRecords, &dataSize);
+        _numRecords.store(numRecords);
+        _dataSize.store(dataSize);
+        _sizeStorer->onCreate(this, numRecords, dataSize);
+        return;
+    }
+
+    _initNextIdNum(opCtx);
+
     // Find the largest RecordId currently in use and estimate the number of records.
     std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
     if (auto record = cursor->next()) {
-        int64_t max = record->id.repr();
-        _nextIdNum.store(1 + max);
-
         if (_sizeStorer) {
             long long numRecords;
             long long dataSize;
@@ -721,8 +845,6 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
     } else {
         _dataSize.store(0);
         _numRecords.store(0);
-        // Need to start at 1 so we are always higher than RecordId::min()
-        _nextIdNum.store(1);
         if (_sizeStorer)
             _sizeStorer->onCreate(this, 0, 0);
     }
@@ -1066,6 +1188,8 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isNormal());
 
+        pauseOplogTruncationForCachePressure(opCtx);
+
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
                << stone->lastRecord << " to remove approximately " << stone->records
                << " records totaling to " << stone->bytes << " bytes";
@@ -1147,9 +1271,9 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
                 return status.getStatus();
             record.id = status.getValue();
         } else if (_isCapped) {
-            record.id = _nextId();
+            record.id = _nextId(opCtx);
         } else {
-            record.id = _nextId();
+            record.id = _nextId(opCtx);
         }
         dassert(record.id > highestId);
         highestId = record.id;
@@ -1279,9 +1403,15 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
         return {ErrorCodes::IllegalOperation, "Cannot change the size of a document in the oplog"};
     }
 
-    WiredTigerItem value(data, len);
-    c->set_value(c, value.Get());
-    ret = WT_OP_CHECK(c->insert(c));
+    WT_MODIFY entries[2];
+    const int nentries = calculateModify(old_value, data, len, entries);
+    if (nentries > 0) {
+        ret = WT_OP_CHECK(c->modify(c, entries, nentries));
+    } else {
+        WiredTigerItem value(data, len);
+        c->set_value(c, value.Get());
+        ret = WT_OP_CHECK(c->insert(c));
+    }
     invariantWTOK(ret);
 
     _increaseDataSize(opCtx, len - old_length);
@@ -1345,6 +1475,50 @@ std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors
     return cursors;
 }
 
+std::vector<std::unique_ptr<RecordCursor>> StandardWiredTigerRecordStore::getManyCursors(
+    OperationContext* opCtx) const {
+    const long long numRanges = std::min(static_cast<long long>(kMaxParallelScanRanges),
+                                         numRecords(opCtx) / kMinRecordsPerParallelScanRange);
+    if (_isCapped || numRanges <= 1) {
+        return WiredTigerRecordStore::getManyCursors(opCtx);
+    }
+
+    // Find the smallest and largest RecordIds in the snapshot all of the cursors start out in.
+    int64_t first;
+    int64_t last;
+    {
+        WiredTigerCursor cursorWrap(_uri, _tableId, true, opCtx);
+        WT_CURSOR* c = cursorWrap.get();
+        int ret = WT_READ_CHECK(c->next(c));
+        if (ret == WT_NOTFOUND) {
+            return WiredTigerRecordStore::getManyCursors(opCtx);
+        }
+        invariantWTOK(ret);
+        invariantWTOK(c->get_key(c, &first));
+
+        invariantWTOK(c->reset(c));
+        invariantWTOK(WT_READ_CHECK(c->prev(c)));
+        invariantWTOK(c->get_key(c, &last));
+    }
+
+    // The last range is unbounded, so that it also covers records inserted after this point.
+    std::vector<std::unique_ptr<RecordCursor>> cursors;
+    const int64_t span = last - first + 1;
+    RecordId start = RecordId::min();
+    for (long long i = 1; i <= numRanges; ++i) {
+        const RecordId end = i == numRanges
+            ? RecordId::max()
+            : RecordId(first + static_cast<int64_t>(static_cast<double>(span) * i / numRanges));
+        if (end <= start) {
+            continue;
+        }
+        cursors.push_back(
+            stdx::make_unique<WiredTigerRecordStoreRangeCursor>(opCtx, *this, start, end));
+        start = end;
+    }
+    return cursors;
+}
+
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* start = startWrap.get();
@@ -1373,10 +1547,7 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx,
                                       CompactStats* stats) {
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx)->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
-        invariantWTOK(ret);
+        return WiredTigerUtil::compact(opCtx, getURI(), options->timeLimit);
     }
     return Status::OK();
 }
@@ -1544,8 +1715,29 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
     }
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+void WiredTigerRecordStore::_initNextIdNum(OperationContext* opCtx) {
+    stdx::lock_guard<stdx::mutex> lk(_nextIdNumMutex);
+    if (_nextIdNumInitialized.load()) {
+        return;
+    }
+
+    // Find the largest RecordId currently in use. Every record inserted since startup got its
+    // RecordId after this ran, so only records that were committed before startup can be found.
+    std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
+    if (auto record = cursor->next()) {
+        _nextIdNum.store(1 + record->id.repr());
+    } else {
+        // Need to start at 1 so we are always higher than RecordId::min()
+        _nextIdNum.store(1);
+    }
+    _nextIdNumInitialized.store(true);
+}
+
+RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
     invariant(!_isOplog);
+    if (!_nextIdNumInitialized.load()) {
+        _initNextIdNum(opCtx);
+    }
     RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
     invariant(out.isNormal());
     return out;
@@ -1847,6 +2039,11 @@ void WiredTigerRecordStoreCursorBase::reattachToOperationContext(OperationContex
 // Standard Implementations:
 
 
+// static
+const size_t StandardWiredTigerRecordStore::kMaxParallelScanRanges;
+// static
+const long long StandardWiredTigerRecordStore::kMinRecordsPerParallelScanRange;
+
 StandardWiredTigerRecordStore::StandardWiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
                                                              OperationContext* opCtx,
                                                              Params params)
@@ -1909,6 +2106,52 @@ bool WiredTigerRecordStoreStandardCursor::hasWrongPrefix(WT_CURSOR* cursor,
     return false;
 }
 
+WiredTigerRecordStoreRangeCursor::WiredTigerRecordStoreRangeCursor(OperationContext* opCtx,
+                                                                   const WiredTigerRecordStore& rs,
+                                                                   RecordId start,
+                                                                   RecordId end)
+    : WiredTigerRecordStoreStandardCursor(opCtx, rs, /*forward=*/true), _start(start), _end(end) {}
+
+boost::optional<Record> WiredTigerRecordStoreRangeCursor::next() {
+    if (_eof)
+        return {};
+
+    if (!_positioned) {
+        // Position the cursor on the first record at or after '_start', or at the record just
+        // before it, from which the base class advances.
+        WT_CURSOR* c = _cursor->get();
+        setKey(c, _start);
+        int cmp;
+        int ret = WT_READ_CHECK(c->search_near(c, &cmp));
+        if (ret == WT_NOTFOUND) {
+            _eof = true;
+            return {};
+        }
+        invariantWTOK(ret);
+        _skipNextAdvance = cmp >= 0;
+        _positioned = true;
+    }
+
+    auto record = WiredTigerRecordStoreStandardCursor::next();
+    if (record && record->id >= _end) {
+        _eof = true;
+        return {};
+    }
+    return record;
+}
+
+boost::optional<Record> WiredTigerRecordStoreRangeCursor::seekExact(const RecordId& id) {
+    _positioned = true;
+    return WiredTigerRecordStoreStandardCursor::seekExact(id);
+}
+
+void WiredTigerRecordStoreRangeCursor::save() {
+    // Without a record to restore to, the cursor has to find the start of its range again.
+    if (_lastReturnedId.isNull())
+        _positioned = false;
+    WiredTigerRecordStoreStandardCursor::save();
+}
+
 
 // Prefixed Implementations:
 
@@ -176,7 +176,8 @@ public:
     virtual std::unique_ptr<RecordCursor> getRandomCursorWithOptions(
         OperationContext* opCtx, StringData extraConfig) const = 0;
 
-    std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* opCtx) const final;
+    std::vector<std::unique_ptr<RecordCursor>> getManyCursors(
+        OperationContext* opCtx) const override;
 
     virtual Status truncate(OperationContext* opCtx);
 
@@ -297,7 +298,14 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId();
+    /**
+     * Sets '_nextIdNum' from the largest RecordId in the table, unless that was already done.
+     * Record stores backed by the size storer defer this, and so the first open of the table,
+     * until the first insert.
+     */
+    void _initNextIdNum(OperationContext* opCtx);
+
+    RecordId _nextId(OperationContext* opCtx);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
@@ -331,6 +339,8 @@ private:
     mutable stdx::timed_mutex _cappedDeleterMutex;
 
     AtomicInt64 _nextIdNum;
+    AtomicWord<bool> _nextIdNumInitialized{false};
+    stdx::mutex _nextIdNumMutex;  // serializes _initNextIdNum()
     AtomicInt64 _dataSize;
     AtomicInt64 _numRecords;
 
@@ -356,6 +366,18 @@ public:
     virtual std::unique_ptr<RecordCursor> getRandomCursorWithOptions(
         OperationContext* opCtx, StringData extraConfig) const override;
 
+    /**
+     * Splits all but capped collections into up to kMaxParallelScanRanges cursors over disjoint
+     * ranges of RecordIds, with at least kMinRecordsPerParallelScanRange records per range. The
+     * range boundaries are evenly spaced between the smallest and largest RecordId, which are
+     * handed out in increasing order.
+     */
+    std::vector<std::unique_ptr<RecordCursor>> getManyCursors(
+        OperationContext* opCtx) const final;
+
+    static const size_t kMaxParallelScanRanges = 64;
+    static const long long kMinRecordsPerParallelScanRange = 1000;
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const;
 
@@ -457,7 +479,7 @@ private:
     bool isVisible(const RecordId& id);
 };
 
-class WiredTigerRecordStoreStandardCursor final : public WiredTigerRecordStoreCursorBase {
+class WiredTigerRecordStoreStandardCursor : public WiredTigerRecordStoreCursorBase {
 public:
     WiredTigerRecordStoreStandardCursor(OperationContext* opCtx,
                                         const WiredTigerRecordStore& rs,
@@ -480,6 +502,31 @@ protected:
     virtual void initCursorToBeginning(){};
 };
 
+/**
+ * A forward cursor over the records of a standard record store whose RecordIds lie in
+ * ['start', 'end').
+ */
+class WiredTigerRecordStoreRangeCursor final : public WiredTigerRecordStoreStandardCursor {
+public:
+    WiredTigerRecordStoreRangeCursor(OperationContext* opCtx,
+                                     const WiredTigerRecordStore& rs,
+                                     RecordId start,
+                                     RecordId end);
+
+    boost::optional<Record> next() override;
+
+    boost::optional<Record> seekExact(const RecordId& id) override;
+
+    void save() override;
+
+private:
+    const RecordId _start;
+    const RecordId _end;
+
+    // Whether the WT cursor has been positioned at or before '_start', or a record returned.
+    bool _positioned = false;
+};
+
 class WiredTigerRecordStorePrefixedCursor final : public WiredTigerRecordStoreCursorBase {
 public:
     WiredTigerRecordStorePrefixedCursor(OperationContext* opCtx,
@@ -222,6 +222,66 @@ StatusWith<RecordId> insertBSON(ServiceContext::UniqueOperationContext& opCtx,
     return res;
 }
 
+// Large records whose updates change only a few bytes are written as deltas. Each update must
+// still leave exactly the new value in the record, whether it changes the size of the record or
+// rewrites most of it.
+TEST(WiredTigerRecordStoreTest, UpdateRecordAsModify) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    std::string value(8 * 1024, 'a');
+    RecordId id;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), value.data(), value.size(), Timestamp(), false);
+        ASSERT_OK(res.getStatus());
+        id = res.getValue();
+        uow.commit();
+    }
+
+    auto updateAndCheck = [&](const std::string& newValue) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->updateRecord(
+                opCtx.get(), id, newValue.data(), newValue.size(), false, nullptr));
+            uow.commit();
+        }
+        RecordData data = rs->dataFor(opCtx.get(), id);
+        ASSERT_EQ(newValue, std::string(data.data(), data.size()));
+        ASSERT_EQ(static_cast<long long>(newValue.size()), rs->dataSize(opCtx.get()));
+    };
+
+    // Same size, one byte changed in the middle.
+    value[4000] = 'b';
+    updateAndCheck(value);
+
+    // Only the first bytes change.
+    value[0] = 'c';
+    value[5] = 'c';
+    updateAndCheck(value);
+
+    // Grow and shrink in the middle of the record.
+    value.insert(2000, "inserted");
+    updateAndCheck(value);
+    value.erase(6000, 100);
+    updateAndCheck(value);
+
+    // Changes at the very end, and an identical value.
+    value.back() = 'd';
+    updateAndCheck(value);
+    updateAndCheck(value);
+
+    // A value mostly unlike the old one is written in full.
+    updateAndCheck(std::string(7 * 1024, 'e'));
+
+    // Small records are always written in full.
+    updateAndCheck("small");
+    updateAndCheck("smalL");
+}
+
 TEST(WiredTigerRecordStoreTest, CappedCursorRollover) {
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, 5));
@@ -34,8 +34,13 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -49,6 +54,27 @@ namespace {
 AtomicUInt64 nextSnapshotId{1};
 
 logger::LogSeverity kSlowTransactionSeverity = logger::LogSeverity::Debug(1);
+
+// Beginning a transaction takes a few microseconds unless the thread has to wait for the cache.
+const uint64_t kCacheWaitThresholdMicros = 100;
+
+// Counts the bytes read from disk by the threads running transactions, which costs two system
+// calls per transaction.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOperationDiskReadStatistics, bool, false);
+
+/**
+ * Returns the number of 512 byte blocks the calling thread has read from disk, or -1 if the
+ * platform does not count them.
+ */
+long long getThreadBlocksRead() {
+#if defined(__linux__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        return usage.ru_inblock;
+    }
+#endif
+    return -1;
+}
 }  // namespace
 
 WiredTigerRecoveryUnit::WiredTigerRecoveryUnit(WiredTigerSessionCache* sc)
@@ -196,11 +222,34 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
         invariantWTOK(s->rollback_transaction(s, NULL));
         LOG(3) << "WT rollback_transaction for snapshot id " << _mySnapshotId;
     }
+
+    if (_blocksReadAtTxnOpen >= 0) {
+        // The difference is meaningless, and may be negative, if the transaction began on
+        // another thread.
+        const long long blocksRead = getThreadBlocksRead() - _blocksReadAtTxnOpen;
+        if (blocksRead > 0) {
+            _bytesReadFromDisk += blocksRead * 512;
+        }
+        _blocksReadAtTxnOpen = -1;
+    }
+
     _active = false;
     _mySnapshotId = nextSnapshotId.fetchAndAdd(1);
     _isOplogReader = false;
 }
 
+void WiredTigerRecoveryUnit::appendOperationStatistics(BSONObjBuilder* b) const {
+    if (_bytesReadFromDisk > 0) {
+        BSONObjBuilder dataBuilder(b->subobjStart("data"));
+        dataBuilder.append("bytesRead", _bytesReadFromDisk);
+    }
+
+    if (_timeWaitingForCacheMicros > 0) {
+        BSONObjBuilder waitingBuilder(b->subobjStart("timeWaitingMicros"));
+        waitingBuilder.append("cache", _timeWaitingForCacheMicros);
+    }
+}
+
 SnapshotId WiredTigerRecoveryUnit::getSnapshotId() const {
     // TODO: use actual wiredtiger txn id
     return SnapshotId(_mySnapshotId);
@@ -234,6 +283,11 @@ void WiredTigerRecoveryUnit::_txnOpen() {
     }
     WT_SESSION* session = _session->getSession();
 
+    if (wiredTigerOperationDiskReadStatistics.load()) {
+        _blocksReadAtTxnOpen = getThreadBlocksRead();
+    }
+
+    const uint64_t startOfBeginMicros = curTimeMicros64();
     if (_readAtTimestamp != SnapshotName::min()) {
         _sessionCache->snapshotManager().beginTransactionAtTimestamp(_readAtTimestamp, session);
     } else if (_readFromMajorityCommittedSnapshot) {
@@ -245,6 +299,10 @@ void WiredTigerRecoveryUnit::_txnOpen() {
     } else {
         invariantWTOK(session->begin_transaction(session, NULL));
     }
+    const uint64_t beginMicros = curTimeMicros64() - startOfBeginMicros;
+    if (beginMicros >= kCacheWaitThresholdMicros) {
+        _timeWaitingForCacheMicros += beginMicros;
+    }
 
     LOG(3) << "WT begin_transaction for snapshot id " << _mySnapshotId;
     _active = true;
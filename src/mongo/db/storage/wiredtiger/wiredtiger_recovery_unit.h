@@ -79,6 +79,8 @@ public:
 
     void setRollbackWritesDisabled() override {}
 
+    void appendOperationStatistics(BSONObjBuilder* b) const override;
+
     // ---- WT STUFF
 
     WiredTigerSession* getSession(OperationContext* opCtx);
@@ -134,6 +136,18 @@ private:
     SnapshotName _readAtTimestamp = SnapshotName::min();
     std::unique_ptr<Timer> _timer;
     bool _isOplogReader = false;
+
+    // Work WiredTiger did on behalf of the operation, for appendOperationStatistics(). WiredTiger
+    // makes the application threads evict pages when its cache is full, which they do when
+    // beginning a transaction, so the slow transaction beginnings are time spent waiting for the
+    // cache.
+    long long _timeWaitingForCacheMicros = 0;
+    long long _bytesReadFromDisk = 0;
+
+    // The number of blocks read from disk by the thread when the current transaction began, or -1
+    // if not counted.
+    long long _blocksReadAtTxnOpen = -1;
+
     typedef std::vector<std::unique_ptr<Change>> Changes;
     Changes _changes;
 };
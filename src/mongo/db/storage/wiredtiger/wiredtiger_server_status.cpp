@@ -62,7 +62,8 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
     // The session does not open a transaction here as one is not needed and opening one would
     // mean that execution could become blocked when a new transaction cannot be allocated
     // immediately.
-    WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn(opCtx);
+    WiredTigerRecoveryUnit* recoveryUnit = WiredTigerRecoveryUnit::get(opCtx);
+    WiredTigerSession* session = recoveryUnit->getSessionNoTxn(opCtx);
     invariant(session);
 
     WT_SESSION* s = session->getSession();
@@ -79,6 +80,11 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder groupCommitBob(bob.subobjStart("groupCommit"));
+        recoveryUnit->getSessionCache()->appendGroupCommitStats(&groupCommitBob);
+    }
+
     return bob.obj();
 }
 
@@ -80,14 +80,16 @@ WiredTigerSession::~WiredTigerSession() {
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool forRecordStore) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            _cursorsCached--;
-            return c;
-        }
+    auto indexIt = _cursorsById.find(id);
+    if (indexIt != _cursorsById.end() && !indexIt->second.empty()) {
+        CursorCache::iterator i = indexIt->second.back();
+        indexIt->second.pop_back();
+
+        WT_CURSOR* c = i->_cursor;
+        _cursors.erase(i);
+        _cursorsOut++;
+        _cursorsCached--;
+        return c;
     }
 
     WT_CURSOR* c = NULL;
@@ -109,6 +111,7 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursorsById[id].push_back(_cursors.begin());
     _cursorsCached++;
 
     // "Old" is defined as not used in the last N**2 operations, if we have N cursors cached.
@@ -118,6 +121,12 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
     // in between use.
     while (_cursorGen - _cursors.back()._gen > 10000) {
         cursor = _cursors.back()._cursor;
+
+        // The oldest cursor in the cache is also the oldest one cached for its ID
+        auto& cachedForId = _cursorsById[_cursors.back()._id];
+        invariant(!cachedForId.empty() && cachedForId.front() == std::prev(_cursors.end()));
+        cachedForId.erase(cachedForId.begin());
+
         _cursors.pop_back();
         _cursorsCached--;
         invariantWTOK(cursor->close(cursor));
@@ -135,6 +144,8 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
         } else
             ++i;
     }
+
+    _rebuildCursorCacheIndex();
 }
 
 void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
@@ -142,6 +153,9 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
     _cursorEpoch = _cache->getCursorEpoch();
     auto toDrop = engine->filterCursorsWithQueuedDrops(&_cursors);
+    if (!toDrop.empty()) {
+        _rebuildCursorCacheIndex();
+    }
 
     for (auto i = toDrop.begin(); i != toDrop.end(); i++) {
         WT_CURSOR* cursor = i->_cursor;
@@ -151,6 +165,16 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
     }
 }
 
+void WiredTigerSession::_rebuildCursorCacheIndex() {
+    _cursorsById.clear();
+
+    // Walk from the back so that each ID's cursors are indexed oldest first
+    for (auto i = _cursors.end(); i != _cursors.begin();) {
+        --i;
+        _cursorsById[i->_id].push_back(i);
+    }
+}
+
 namespace {
 AtomicUInt64 nextTableId(1);
 }
@@ -162,10 +186,18 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _cacheLock("WiredTigerSessionCache::_cacheLock") {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(NULL),
+      _conn(conn),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _cacheLock("WiredTigerSessionCache::_cacheLock") {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -183,6 +215,12 @@ void WiredTigerSessionCache::shuttingDown() {
             return;
     } while (actual != expected);
 
+    // Release the threads waiting for a group commit. Flushes attempted from now on fail with
+    // ShutdownInProgress.
+    if (_groupCommitter) {
+        _groupCommitter->shutdown();
+    }
+
     // Spin as long as there are threads in releaseSession
     while (_shuttingDown.load() != kShuttingDownMask) {
         sleepmillis(1);
@@ -192,7 +230,30 @@ void WiredTigerSessionCache::shuttingDown() {
     _snapshotManager.shutdown();
 }
 
+void WiredTigerSessionCache::startGroupCommit() {
+    invariant(!_groupCommitter);
+    invariant(_engine && _engine->isDurable() && !isEphemeral());
+    _groupCommitter = stdx::make_unique<WiredTigerGroupCommitter>(
+        [this] { _waitUntilDurable(false /* forceCheckpoint */, false /* stableCheckpoint */); });
+    _groupCommitter->startup();
+}
+
+void WiredTigerSessionCache::appendGroupCommitStats(BSONObjBuilder* builder) const {
+    if (_groupCommitter) {
+        _groupCommitter->appendStats(builder);
+    }
+}
+
 void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint) {
+    // A plain journal flush is shared with the other threads waiting for one.
+    if (!forceCheckpoint && _groupCommitter) {
+        _groupCommitter->waitForFlush();
+        return;
+    }
+    _waitUntilDurable(forceCheckpoint, stableCheckpoint);
+}
+
+void WiredTigerSessionCache::_waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint) {
     // For inMemory storage engines, the data is "as durable as it's going to get".
     // That is, a restart is equivalent to a complete node failure.
     if (isEphemeral()) {
@@ -269,7 +330,7 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
 }
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    stdx::lock_guard<AdaptiveMutex> lock(_cacheLock);
     for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
         (*i)->closeAllCursors(uri);
     }
@@ -279,7 +340,7 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    stdx::lock_guard<AdaptiveMutex> lock(_cacheLock);
     for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
         (*i)->closeCursorsForQueuedDrops(_engine);
     }
@@ -290,7 +351,7 @@ void WiredTigerSessionCache::closeAll() {
     SessionCache swap;
 
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        stdx::lock_guard<AdaptiveMutex> lock(_cacheLock);
         _epoch.fetchAndAdd(1);
         _sessions.swap(swap);
     }
@@ -310,7 +371,7 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        stdx::lock_guard<AdaptiveMutex> lock(_cacheLock);
         if (!_sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
@@ -364,7 +425,7 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        stdx::lock_guard<AdaptiveMutex> lock(_cacheLock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
             _sessions.push_back(session);
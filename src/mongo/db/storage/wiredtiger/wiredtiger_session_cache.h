@@ -32,14 +32,19 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/adaptive_mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
@@ -117,6 +122,13 @@ private:
     // The cursor cache is a list of pairs that contain an ID and cursor
     typedef std::list<WiredTigerCachedCursor> CursorCache;
 
+    // Index over the cursor cache by source ID, so that lookups do not have to search the list.
+    // The cached cursors for an ID are ordered from least to most recently released.
+    typedef stdx::unordered_map<uint64_t, std::vector<CursorCache::iterator>> CursorCacheIndex;
+
+    // Rebuilds _cursorsById after cursors were removed from arbitrary positions of _cursors
+    void _rebuildCursorCacheIndex();
+
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
@@ -132,6 +144,7 @@ private:
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    CursorCacheIndex _cursorsById;
     uint64_t _cursorGen;
     int _cursorsCached, _cursorsOut;
 };
@@ -193,6 +206,18 @@ public:
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
+    /**
+     * Starts routing journal flushes requested through waitUntilDurable() to a group committer,
+     * so that concurrent j:true writes share a single log flush. Must be called at most once,
+     * before the cache is used, and only when the journal is enabled.
+     */
+    void startGroupCommit();
+
+    /**
+     * Appends group commit statistics. Appends nothing if group commit is not running.
+     */
+    void appendGroupCommitStats(BSONObjBuilder* builder) const;
+
     WT_CONNECTION* conn() const {
         return _conn;
     }
@@ -225,7 +250,7 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
+    AdaptiveMutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
     SessionCache _sessions;
 
@@ -244,6 +269,14 @@ private:
     // Notified when we commit to the journal.
     JournalListener* _journalListener = &NoOpJournalListener::instance;
 
+    // Coalesces journal flushes. Null unless startGroupCommit() has been called.
+    std::unique_ptr<WiredTigerGroupCommitter> _groupCommitter;
+
+    /**
+     * Implements waitUntilDurable() without going through the group committer.
+     */
+    void _waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
+
     /**
      * Returns a session to the cache for later reuse. If closeAll was called between getting this
      * session and releasing it, the session is directly released. This method is thread safe.
@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+#include <wiredtiger.h>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerConnection {
+public:
+    explicit WiredTigerConnection(StringData dbpath) {
+        int ret = wiredtiger_open(dbpath.toString().c_str(), NULL, "create,cache_size=64M", &_conn);
+        invariantOK(wtRCToStatus(ret));
+    }
+
+    ~WiredTigerConnection() {
+        _conn->close(_conn, NULL);
+    }
+
+    WT_CONNECTION* getConnection() const {
+        return _conn;
+    }
+
+private:
+    WT_CONNECTION* _conn = nullptr;
+};
+
+void BM_WiredTigerSessionCacheGetRelease(benchmark::State& state) {
+    unittest::TempDir dbpath("wt_session_cache_bm");
+    WiredTigerConnection connection(dbpath.path());
+    WiredTigerSessionCache sessionCache(connection.getConnection());
+
+    // Warm the cache so the loop measures reuse of a cached session, not session creation.
+    { auto session = sessionCache.getSession(); }
+
+    while (state.keepRunning()) {
+        auto session = sessionCache.getSession();
+        benchmark::doNotOptimize(session->getSession());
+    }
+}
+MONGO_BENCHMARK(BM_WiredTigerSessionCacheGetRelease);
+
+void BM_WiredTigerSessionCacheGetReleaseMany(benchmark::State& state) {
+    unittest::TempDir dbpath("wt_session_cache_bm");
+    WiredTigerConnection connection(dbpath.path());
+    WiredTigerSessionCache sessionCache(connection.getConnection());
+
+    // Holding several sessions at once exercises the cache's list of idle sessions rather than
+    // just the most recently released one.
+    const auto numSessions = state.range();
+    std::vector<UniqueWiredTigerSession> sessions;
+    while (state.keepRunning()) {
+        for (int64_t i = 0; i < numSessions; ++i) {
+            sessions.push_back(sessionCache.getSession());
+        }
+        sessions.clear();
+    }
+    state.setItemsProcessed(state.iterations() * numSessions);
+}
+MONGO_BENCHMARK(BM_WiredTigerSessionCacheGetReleaseMany)->arg(8)->arg(64);
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
@@ -53,6 +55,9 @@ using std::string;
 
 namespace {
 int MAGIC = 123123;
+
+// Maximum number of entries written to the size storer table in a single transaction.
+const size_t kSyncBatchSize = 1000;
 }
 
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn,
@@ -183,11 +188,10 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     _checkMagic();
 
-    Map myMap;
+    std::vector<std::pair<std::string, Entry>> dirtyEntries;
     {
         stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
         for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            std::string uriKey = it->first;
             Entry& entry = it->second;
             if (entry.rs) {
                 if (entry.dataSize != entry.rs->dataSize(NULL)) {
@@ -202,47 +206,62 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
 
             if (!entry.dirty)
                 continue;
-            myMap[uriKey] = entry;
+            dirtyEntries.emplace_back(it->first, entry);
         }
     }
 
-    if (myMap.empty())
+    if (dirtyEntries.empty())
         return;  // Nothing to do.
 
+    // Write the entries in bounded batches so that a sync with many dirty collections does not
+    // build up one large transaction in the cache. Only the last batch needs to be synced to disk,
+    // since syncing its commit also makes every earlier commit durable.
     WT_SESSION* session = _session.getSession();
-    invariantWTOK(session->begin_transaction(session, syncToDisk ? "sync=true" : ""));
-    ScopeGuard rollbacker = MakeGuard(session->rollback_transaction, session, "");
-
-    for (Map::iterator it = myMap.begin(); it != myMap.end(); ++it) {
-        string uriKey = it->first;
-        Entry& entry = it->second;
-
-        BSONObj data;
-        {
-            BSONObjBuilder b;
-            b.append("numRecords", entry.numRecords);
-            b.append("dataSize", entry.dataSize);
-            data = b.obj();
-        }
+    for (size_t batchStart = 0; batchStart < dirtyEntries.size(); batchStart += kSyncBatchSize) {
+        const size_t batchEnd = std::min(dirtyEntries.size(), batchStart + kSyncBatchSize);
+        const bool syncBatch = syncToDisk && batchEnd == dirtyEntries.size();
+
+        invariantWTOK(session->begin_transaction(session, syncBatch ? "sync=true" : ""));
+        ScopeGuard rollbacker = MakeGuard(session->rollback_transaction, session, "");
+
+        for (size_t i = batchStart; i < batchEnd; ++i) {
+            const std::string& uriKey = dirtyEntries[i].first;
+            const Entry& entry = dirtyEntries[i].second;
+
+            BSONObj data;
+            {
+                BSONObjBuilder b;
+                b.append("numRecords", entry.numRecords);
+                b.append("dataSize", entry.dataSize);
+                data = b.obj();
+            }
 
-        LOG(2) << "WiredTigerSizeStorer::storeInto " << uriKey << " -> " << redact(data);
+            LOG(2) << "WiredTigerSizeStorer::storeInto " << uriKey << " -> " << redact(data);
 
-        WiredTigerItem key(uriKey.c_str(), uriKey.size());
-        WiredTigerItem value(data.objdata(), data.objsize());
-        _cursor->set_key(_cursor, key.Get());
-        _cursor->set_value(_cursor, value.Get());
-        invariantWTOK(_cursor->insert(_cursor));
-    }
+            WiredTigerItem key(uriKey.c_str(), uriKey.size());
+            WiredTigerItem value(data.objdata(), data.objsize());
+            _cursor->set_key(_cursor, key.Get());
+            _cursor->set_value(_cursor, value.Get());
+            invariantWTOK(_cursor->insert(_cursor));
+        }
 
-    invariantWTOK(_cursor->reset(_cursor));
+        invariantWTOK(_cursor->reset(_cursor));
 
-    rollbacker.Dismiss();
-    invariantWTOK(session->commit_transaction(session, NULL));
+        rollbacker.Dismiss();
+        invariantWTOK(session->commit_transaction(session, NULL));
 
-    {
+        // Only clear the dirty flag of entries that still hold the values just written; anything
+        // updated concurrently with this batch is left dirty for the next sync.
         stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            it->second.dirty = false;
+        for (size_t i = batchStart; i < batchEnd; ++i) {
+            Map::iterator it = _entries.find(dirtyEntries[i].first);
+            if (it == _entries.end())
+                continue;
+            Entry& entry = it->second;
+            const Entry& written = dirtyEntries[i].second;
+            if (entry.numRecords == written.numRecords && entry.dataSize == written.dataSize) {
+                entry.dirty = false;
+            }
         }
     }
 }
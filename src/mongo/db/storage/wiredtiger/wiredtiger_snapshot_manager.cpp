@@ -59,24 +59,26 @@ Status WiredTigerSnapshotManager::createSnapshot(OperationContext* opCtx,
 void WiredTigerSnapshotManager::setCommittedSnapshot(const SnapshotName& name, Timestamp ts) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-    invariant(!_committedSnapshot || *_committedSnapshot <= name);
-    _committedSnapshot = name;
+    invariant(_committedSnapshotName.load() <= name.asU64());
+    _committedSnapshotTimestamp.store(ts.asULL());
+    _committedSnapshotName.store(name.asU64());
 }
 
 void WiredTigerSnapshotManager::cleanupUnneededSnapshots() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-    if (!_committedSnapshot)
+    const auto committedSnapshot = _committedSnapshotName.load();
+    if (committedSnapshot == 0)
         return;
 
-    const std::string config = str::stream() << "drop=(before=" << _committedSnapshot->asU64()
-                                             << ')';
+    const std::string config = str::stream() << "drop=(before=" << committedSnapshot << ')';
     invariantWTOK(_session->snapshot(_session, config.c_str()));
 }
 
 void WiredTigerSnapshotManager::dropAllSnapshots() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
-    _committedSnapshot = boost::none;
+    _committedSnapshotName.store(0);
+    _committedSnapshotTimestamp.store(0);
 
     invariantWTOK(_session->snapshot(_session, "drop=(all)"));
 }
@@ -91,8 +93,10 @@ void WiredTigerSnapshotManager::shutdown() {
 
 boost::optional<SnapshotName> WiredTigerSnapshotManager::getMinSnapshotForNextCommittedRead()
     const {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    return _committedSnapshot;
+    const auto committedSnapshot = _committedSnapshotName.load();
+    if (committedSnapshot == 0)
+        return boost::none;
+    return SnapshotName(committedSnapshot);
 }
 
 void WiredTigerSnapshotManager::beginTransactionAtTimestamp(SnapshotName pointInTime,
@@ -109,17 +113,50 @@ void WiredTigerSnapshotManager::beginTransactionAtTimestamp(SnapshotName pointIn
 
 SnapshotName WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     WT_SESSION* session) const {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    size_t retries = 1000;
+    int status;
+    SnapshotName name;
+    do {
+        name = SnapshotName(_committedSnapshotName.load());
+        auto readTimestamp = _committedSnapshotTimestamp.load();
+        uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
+                "Committed view disappeared while running operation",
+                name.asU64() != 0);
+
+        if (readTimestamp == 0) {
+            // A committed snapshot without a timestamp can only be read from its named snapshot,
+            // which cleanupUnneededSnapshots() must not drop until our transaction has begun.
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            name = SnapshotName(_committedSnapshotName.load());
+            readTimestamp = _committedSnapshotTimestamp.load();
+            uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
+                    "Committed view disappeared while running operation",
+                    name.asU64() != 0);
+
+            if (readTimestamp == 0) {
+                StringBuilder config;
+                config << "snapshot=" << name.asU64();
+                invariantWTOK(session->begin_transaction(session, config.str().c_str()));
+                return name;
+            }
+        }
 
-    uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
-            "Committed view disappeared while running operation",
-            _committedSnapshot);
+        char readTSConfigString[15 /* read_timestamp= */ + (8 * 2) /* 16 hexadecimal digits */ +
+                                1 /* trailing null */];
+        auto size = std::snprintf(readTSConfigString,
+                                  sizeof(readTSConfigString),
+                                  "read_timestamp=%llx",
+                                  static_cast<unsigned long long>(readTimestamp));
+        invariant(static_cast<std::size_t>(size) < sizeof(readTSConfigString));
 
-    StringBuilder config;
-    config << "snapshot=" << _committedSnapshot->asU64();
-    invariantWTOK(session->begin_transaction(session, config.str().c_str()));
+        status = session->begin_transaction(session, readTSConfigString);
+
+        // The oldest_timestamp trails the commit point, but it may pass the timestamp we loaded
+        // if the commit point advanced in the meantime. Retry with the newer commit point.
+    } while (status == EINVAL && --retries > 0);
+    invariantWTOK(status);
 
-    return *_committedSnapshot;
+    return name;
 }
 
 void WiredTigerSnapshotManager::beginTransactionOnOplog(WiredTigerOplogManager* oplogManager,
@@ -127,7 +164,6 @@ void WiredTigerSnapshotManager::beginTransactionOnOplog(WiredTigerOplogManager*
     size_t retries = 1000;
     int status;
     do {
-        stdx::lock_guard<stdx::mutex> lock(_mutex);
         auto allCommittedTimestamp = oplogManager->getOplogReadTimestamp();
         char readTSConfigString[15 /* read_timestamp= */ + (8 * 2) /* 16 hexadecimal digits */ +
                                 1 /* trailing null */];
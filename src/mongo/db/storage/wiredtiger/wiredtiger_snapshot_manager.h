@@ -35,6 +35,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/snapshot_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -72,7 +73,10 @@ public:
     void beginTransactionAtTimestamp(SnapshotName pointInTime, WT_SESSION* session) const;
 
     /**
-     * Starts a transaction and returns the SnapshotName used.
+     * Starts a transaction on the committed snapshot and returns the SnapshotName used.
+     *
+     * If the committed snapshot has a timestamp, the transaction reads at that timestamp without
+     * taking any mutex. Otherwise it reads from the named snapshot.
      *
      * Throws if there is currently no committed snapshot.
      */
@@ -94,8 +98,16 @@ public:
     boost::optional<SnapshotName> getMinSnapshotForNextCommittedRead() const;
 
 private:
-    mutable stdx::mutex _mutex;  // Guards all members.
-    boost::optional<SnapshotName> _committedSnapshot;
+    // Guards _session and serializes changes to the committed snapshot. Reading the committed
+    // snapshot only needs it when falling back to a named snapshot.
+    mutable stdx::mutex _mutex;
+
+    // The name and timestamp of the committed snapshot, 0 meaning none. Writers store the
+    // timestamp before the name and lock-free readers load the name before the timestamp, so a
+    // reader never reads at a timestamp older than the one that came with the name it reports.
+    AtomicUInt64 _committedSnapshotName;
+    AtomicUInt64 _committedSnapshotTimestamp;
+
     WT_SESSION* _session;
     WT_CONNECTION* _conn;
 };
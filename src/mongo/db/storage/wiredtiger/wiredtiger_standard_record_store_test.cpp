@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <time.h>
@@ -296,6 +297,115 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+// A record store backed by the size storer only looks for its largest RecordId on the first insert
+// after it is opened.
+TEST(WiredTigerRecordStoreTest, ReopenedRecordStoreContinuesRecordIds) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    string indexUri = "table:myindex";
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(harnessHelper->conn(), indexUri, enableWtLogging);
+    checked_cast<WiredTigerRecordStore*>(rs.get())->setSizeStorer(&ss);
+
+    RecordId lastId;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 5; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            lastId = res.getValue();
+        }
+        uow.commit();
+    }
+
+    rs.reset(NULL);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WiredTigerRecordStore::Params params;
+        params.ns = "a.b"_sd;
+        params.uri = uri;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = false;
+        params.isEphemeral = false;
+        params.cappedMaxSize = -1;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = &ss;
+
+        auto ret = new StandardWiredTigerRecordStore(nullptr, opCtx.get(), params);
+        ret->postConstructorInit(opCtx.get());
+        rs.reset(ret);
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(5, rs->numRecords(opCtx.get()));
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_GT(res.getValue(), lastId);
+        uow.commit();
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(6, rs->numRecords(opCtx.get()));
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
+// A large collection is split into cursors over disjoint RecordId ranges which together return
+// every record exactly once, also when saved and restored before returning anything.
+TEST(WiredTigerRecordStoreTest, GetManyCursorsSplitsIntoDisjointRanges) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 5 * StandardWiredTigerRecordStore::kMinRecordsPerParallelScanRange;
+    std::set<RecordId> remain;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < nToInsert; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            remain.insert(res.getValue());
+        }
+        uow.commit();
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursors = rs->getManyCursors(opCtx.get());
+    ASSERT_EQ(5U, cursors.size());
+
+    RecordId previousRangeLast;
+    for (auto&& cursor : cursors) {
+        cursor->save();
+        ASSERT(cursor->restore());
+
+        RecordId last;
+        while (auto record = cursor->next()) {
+            ASSERT_GT(record->id, previousRangeLast);
+            ASSERT_GT(record->id, last);
+            ASSERT_EQ(1U, remain.erase(record->id));
+            last = record->id;
+
+            cursor->save();
+            ASSERT(cursor->restore());
+        }
+        ASSERT(!cursor->next());
+        ASSERT(last.isNormal());
+        previousRangeLast = last;
+    }
+    ASSERT(remain.empty());
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
@@ -439,6 +439,21 @@ int WiredTigerUtil::verifyTable(OperationContext* opCtx,
     return (session->verify)(session, uri.c_str(), NULL);
 }
 
+Status WiredTigerUtil::compact(OperationContext* opCtx, const std::string& uri, Seconds timeLimit) {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx)->getSession();
+    opCtx->recoveryUnit()->abandonSnapshot();
+    const std::string config = str::stream() << "timeout=" << durationCount<Seconds>(timeLimit);
+    int ret = s->compact(s, uri.c_str(), config.c_str());
+    if (timeLimit > Seconds(0) && (ret == ETIMEDOUT || ret == EBUSY)) {
+        return Status(ErrorCodes::ExceededTimeLimit,
+                      str::stream() << "compaction of " << uri << " stopped after " << timeLimit
+                                    << ": "
+                                    << wiredtiger_strerror(ret));
+    }
+    invariantWTOK(ret);
+    return Status::OK();
+}
+
 bool WiredTigerUtil::useTableLogging(NamespaceString ns, bool replEnabled) {
     if (!replEnabled) {
         // All tables on standalones are logged.
@@ -39,6 +39,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -219,6 +220,13 @@ public:
                            const std::string& uri,
                            std::vector<std::string>* errors = NULL);
 
+    /**
+     * Compacts the table or file at 'uri'. A non-zero 'timeLimit' bounds the pass, which returns
+     * ExceededTimeLimit if it ran out of time or the file was busy. The blocks moved by the pass
+     * stay moved, so another pass picks up where it stopped.
+     */
+    static Status compact(OperationContext* opCtx, const std::string& uri, Seconds timeLimit);
+
     static bool useTableLogging(NamespaceString ns, bool replEnabled);
 
     static Status setTableLogging(OperationContext* opCtx, const std::string& uri, bool on);
@@ -56,20 +56,25 @@ TimeProofService::Key TimeProofService::generateRandomKey() {
 }
 
 TimeProofService::TimeProof TimeProofService::getProof(LogicalTime time, const Key& key) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    if (_cache && _cache->hasProof(time, key)) {
-        return _cache->_proof;
+    // All the times in a range share the proof of the greatest time in it.
+    auto timeCeil = LogicalTime(Timestamp(time.asTimestamp().asULL() | kRangeMask));
+    {
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        if (_cache && _cache->hasProof(timeCeil, key)) {
+            return _cache->_proof;
+        }
     }
 
-    auto timeCeil = LogicalTime(Timestamp(time.asTimestamp().asULL() | kRangeMask));
+    // Compute the HMAC outside of the mutex, so that threads needing proofs for different ranges
+    // or keys do not wait for each other.
     auto unsignedTimeArray = timeCeil.toUnsignedArray();
+    auto proof = SHA1Block::computeHmac(
+        key.data(), key.size(), unsignedTimeArray.data(), unsignedTimeArray.size());
+
     // update cache
-    _cache =
-        CacheEntry(SHA1Block::computeHmac(
-                       key.data(), key.size(), unsignedTimeArray.data(), unsignedTimeArray.size()),
-                   timeCeil,
-                   key);
-    return _cache->_proof;
+    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+    _cache = CacheEntry(proof, timeCeil, key);
+    return proof;
 }
 
 Status TimeProofService::checkProof(LogicalTime time, const TimeProof& proof, const Key& key) {
@@ -72,10 +72,10 @@ private:
             : _proof(std::move(proof)), _time(time), _key(key) {}
 
         /**
-         * Returns true if it has proof for time greater or equal than the argument.
+         * Returns true if it has the proof for the range ending at timeCeil, with the given key.
          */
-        bool hasProof(LogicalTime time, const Key& key) const {
-            return key == _key && time == _time;
+        bool hasProof(LogicalTime timeCeil, const Key& key) const {
+            return key == _key && timeCeil == _time;
         }
 
         TimeProof _proof;
@@ -0,0 +1,102 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace timeseries {
+
+struct BucketCatalog::Bucket {
+    OID id;
+    int numRows = 0;
+    int numBytes = 0;
+    int numWriters = 0;
+    bool full = false;
+};
+
+BucketCatalog& BucketCatalog::get() {
+    static BucketCatalog catalog;
+    return catalog;
+}
+
+BucketCatalog::Reservation BucketCatalog::reserve(StringData ns,
+                                                  const TimeseriesOptions& options,
+                                                  const BSONObj& measurement) {
+    BSONObjBuilder meta;
+    if (!options.metaField.empty()) {
+        if (auto metaElem = measurement[options.metaField]) {
+            meta.appendAs(metaElem, "");
+        }
+    }
+    const BSONObj metaObj = meta.done();
+    SeriesKey key{ns.toString(), std::string(metaObj.objdata(), metaObj.objsize())};
+
+    // The columns and the bounds of the bucket each hold the values of the measurement.
+    const int numBytes = measurement.objsize() * 3;
+
+    Reservation reservation;
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto& bucket = _openBuckets[key];
+    if (bucket && bucket->numRows > 0 && bucket->numBytes + numBytes > kBucketMaxSizeBytes) {
+        bucket->full = true;
+        if (bucket->numWriters == 0) {
+            reservation.bucketToCompress = bucket->id;
+        }
+        bucket.reset();
+    }
+    if (!bucket) {
+        bucket = std::make_shared<Bucket>();
+        bucket->id = OID::gen();
+    }
+
+    reservation.bucketId = bucket->id;
+    reservation.row = bucket->numRows++;
+    reservation.bucket = bucket;
+    bucket->numBytes += numBytes;
+    ++bucket->numWriters;
+    if (bucket->numRows == options.bucketMaxCount) {
+        bucket->full = true;
+        _openBuckets.erase(key);
+    }
+    return reservation;
+}
+
+bool BucketCatalog::release(const Reservation& reservation) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto& bucket = *reservation.bucket;
+    invariant(bucket.numWriters > 0);
+    return --bucket.numWriters == 0 && bucket.full;
+}
+
+}  // namespace timeseries
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace timeseries {
+
+/**
+ * Keeps track of the open bucket of each series of the time-series collections, and assigns the
+ * measurements inserted into them their rows.
+ *
+ * A bucket is full once it has bucketMaxCount measurements or would grow beyond
+ * kBucketMaxSizeBytes, and new measurements of its series then go to a new bucket. The last
+ * writer to finish with a full bucket is told to compress it. The catalog is not durable: after a
+ * restart, new buckets are opened, and the buckets which were open stay uncompressed.
+ */
+class BucketCatalog {
+    MONGO_DISALLOW_COPYING(BucketCatalog);
+
+public:
+    static const int kBucketMaxSizeBytes = 1024 * 1024;
+
+    struct Bucket;
+
+    /**
+     * A row reserved in a bucket for a measurement.
+     */
+    struct Reservation {
+        OID bucketId;
+        int row;
+
+        // Set if the full bucket which the measurement would have gone to has no more writers
+        // and must be compressed by the caller.
+        boost::optional<OID> bucketToCompress;
+
+        std::shared_ptr<Bucket> bucket;
+    };
+
+    BucketCatalog() = default;
+
+    static BucketCatalog& get();
+
+    /**
+     * Reserves a row for 'measurement' in the open bucket of its series in 'ns'.
+     */
+    Reservation reserve(StringData ns,
+                        const TimeseriesOptions& options,
+                        const BSONObj& measurement);
+
+    /**
+     * Called once the write of a reserved measurement committed or failed. Returns true if the
+     * caller must compress the bucket.
+     */
+    bool release(const Reservation& reservation);
+
+private:
+    // The namespace, and the binary form of the document holding the meta value of the series.
+    using SeriesKey = std::pair<std::string, std::string>;
+
+    stdx::mutex _mutex;
+    std::map<SeriesKey, std::shared_ptr<Bucket>> _openBuckets;
+};
+
+}  // namespace timeseries
+}  // namespace mongo
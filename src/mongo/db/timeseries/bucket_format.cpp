@@ -0,0 +1,370 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_format.h"
+
+#include <algorithm>
+#include <map>
+#include <snappy.h>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace timeseries {
+
+namespace {
+
+uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+void appendVarint(uint64_t value, std::string* out) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+}
+
+/**
+ * Returns the values of the column 'name' by row, ascending, given the document mapping its rows
+ * to its values.
+ */
+std::vector<std::pair<int, BSONElement>> readColumn(StringData name, const BSONObj& column) {
+    std::vector<std::pair<int, BSONElement>> values;
+    for (auto&& value : column) {
+        int row;
+        uassert(40661,
+                str::stream() << "Invalid row in time-series bucket column '" << name << "': "
+                              << value.fieldNameStringData(),
+                parseNumberFromStringWithBase(value.fieldNameStringData(), 10, &row).isOK() &&
+                    row >= 0);
+        values.emplace_back(row, value);
+    }
+    std::sort(values.begin(),
+              values.end(),
+              [](const std::pair<int, BSONElement>& lhs, const std::pair<int, BSONElement>& rhs) {
+                  return lhs.first < rhs.first;
+              });
+    return values;
+}
+
+std::vector<std::pair<int, BSONElement>> readOpenColumn(const BSONElement& column) {
+    uassert(40660,
+            str::stream() << "Invalid time-series bucket column: " << column,
+            column.type() == Object);
+    return readColumn(column.fieldNameStringData(), column.embeddedObject());
+}
+
+BSONObj decompressColumn(const BSONElement& column) {
+    int length;
+    const char* data = column.binData(length);
+    std::string uncompressed;
+    uassert(40662,
+            str::stream() << "Invalid compressed time-series bucket column '"
+                          << column.fieldNameStringData()
+                          << "'",
+            snappy::Uncompress(data, length, &uncompressed));
+    uassertStatusOK(
+        validateBSON(uncompressed.data(), uncompressed.size(), BSONVersion::kLatest));
+
+    SharedBuffer buffer = SharedBuffer::allocate(uncompressed.size());
+    memcpy(buffer.get(), uncompressed.data(), uncompressed.size());
+    return BSONObj(std::move(buffer));
+}
+
+}  // namespace
+
+Status validateMeasurement(const TimeseriesOptions& options, const BSONObj& measurement) {
+    for (auto&& elem : measurement) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName.empty() || fieldName.startsWith("$") ||
+            fieldName.find('.') != std::string::npos) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "The field '" << fieldName
+                                  << "' cannot be stored in a time-series collection"};
+        }
+    }
+
+    const auto time = measurement[options.timeField];
+    if (time.type() != Date) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "The '" << options.timeField
+                              << "' field of a time-series measurement must be a date, but is: "
+                              << time};
+    }
+    return Status::OK();
+}
+
+BSONObj makeMeasurementUpdate(const TimeseriesOptions& options,
+                              const BSONObj& measurement,
+                              int row) {
+    const std::string rowSuffix = str::stream() << "." << row;
+    const std::string dataPrefix = str::stream() << kBucketDataFieldName << ".";
+    const std::string minPrefix = str::stream() << kBucketControlFieldName << "."
+                                                << kBucketControlMinFieldName << ".";
+    const std::string maxPrefix = str::stream() << kBucketControlFieldName << "."
+                                                << kBucketControlMaxFieldName << ".";
+
+    BSONObjBuilder set;
+    BSONObjBuilder min;
+    BSONObjBuilder max;
+    BSONObjBuilder setOnInsert;
+    setOnInsert.append(str::stream() << kBucketControlFieldName << "."
+                                     << kBucketControlVersionFieldName,
+                       kOpenBucketVersion);
+    for (auto&& elem : measurement) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == options.metaField) {
+            setOnInsert.appendAs(elem, kBucketMetaFieldName);
+            continue;
+        }
+        set.appendAs(elem, dataPrefix + fieldName + rowSuffix);
+        min.appendAs(elem, minPrefix + fieldName);
+        max.appendAs(elem, maxPrefix + fieldName);
+    }
+
+    BSONObjBuilder update;
+    update.append("$set", set.obj());
+    update.append("$min", min.obj());
+    update.append("$max", max.obj());
+    const std::string countPath = str::stream() << kBucketControlFieldName << "."
+                                                << kBucketControlCountFieldName;
+    update.append("$inc", BSON(countPath << 1));
+    update.append("$setOnInsert", setOnInsert.obj());
+    return update.obj();
+}
+
+std::string encodeTimes(const std::vector<long long>& millis) {
+    std::string out;
+    uint64_t previous = 0;
+    uint64_t previousDelta = 0;
+    for (size_t i = 0; i < millis.size(); ++i) {
+        // Unsigned arithmetic wraps around, which decoding undoes.
+        const uint64_t value = static_cast<uint64_t>(millis[i]);
+        const uint64_t delta = value - previous;
+        appendVarint(zigzagEncode(static_cast<int64_t>(i < 2 ? delta : delta - previousDelta)),
+                     &out);
+        previous = value;
+        previousDelta = delta;
+    }
+    return out;
+}
+
+StatusWith<std::vector<long long>> decodeTimes(StringData encoded) {
+    std::vector<long long> millis;
+    uint64_t previous = 0;
+    uint64_t previousDelta = 0;
+    size_t pos = 0;
+    while (pos < encoded.size()) {
+        uint64_t varint = 0;
+        for (int shift = 0;; shift += 7) {
+            if (pos == encoded.size() || shift > 63) {
+                return {ErrorCodes::BadValue, "Invalid encoded time-series bucket times"};
+            }
+            const auto byte = static_cast<unsigned char>(encoded[pos++]);
+            varint |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+
+        const uint64_t decoded = static_cast<uint64_t>(zigzagDecode(varint));
+        const uint64_t delta = millis.size() < 2 ? decoded : decoded + previousDelta;
+        previous += delta;
+        previousDelta = delta;
+        millis.push_back(static_cast<long long>(previous));
+    }
+    return millis;
+}
+
+StatusWith<BSONObj> compressBucket(const TimeseriesOptions& options, const BSONObj& bucket) {
+    try {
+        const auto control = bucket[kBucketControlFieldName];
+        if (control.type() != Object ||
+            control[kBucketControlVersionFieldName].numberInt() != kOpenBucketVersion) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Only open time-series buckets can be compressed: "
+                                  << bucket["_id"]};
+        }
+
+        const auto data = bucket[kBucketDataFieldName];
+        if (data.type() != Object) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Invalid time-series bucket: " << bucket["_id"]};
+        }
+
+        // Number the rows which have a time densely, in order.
+        const auto times = readOpenColumn(data[options.timeField]);
+        std::map<int, int> denseRows;
+        std::vector<long long> millis;
+        for (auto&& time : times) {
+            if (time.second.type() != Date) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "Invalid time in time-series bucket: " << bucket["_id"]};
+            }
+            denseRows.emplace(time.first, denseRows.size());
+            millis.push_back(time.second.date().toMillisSinceEpoch());
+        }
+
+        BSONObjBuilder compressedData;
+        for (auto&& column : data.embeddedObject()) {
+            const auto name = column.fieldNameStringData();
+            if (name == options.timeField) {
+                const auto encoded = encodeTimes(millis);
+                compressedData.appendBinData(
+                    name, encoded.size(), BinDataGeneral, encoded.data());
+                continue;
+            }
+
+            BSONObjBuilder values;
+            for (auto&& value : readOpenColumn(column)) {
+                auto it = denseRows.find(value.first);
+                if (it != denseRows.end()) {
+                    values.appendAs(value.second, str::stream() << it->second);
+                }
+            }
+            const BSONObj valuesObj = values.obj();
+            std::string compressed;
+            snappy::Compress(valuesObj.objdata(), valuesObj.objsize(), &compressed);
+            compressedData.appendBinData(
+                name, compressed.size(), BinDataGeneral, compressed.data());
+        }
+
+        BSONObjBuilder compressedControl;
+        compressedControl.append(kBucketControlVersionFieldName, kCompressedBucketVersion);
+        compressedControl.append(kBucketControlCountFieldName,
+                                 static_cast<int>(denseRows.size()));
+        compressedControl.append(control[kBucketControlMinFieldName]);
+        compressedControl.append(control[kBucketControlMaxFieldName]);
+
+        BSONObjBuilder compressedBucket;
+        compressedBucket.append(bucket["_id"]);
+        compressedBucket.append(kBucketControlFieldName, compressedControl.obj());
+        if (auto meta = bucket[kBucketMetaFieldName]) {
+            compressedBucket.append(meta);
+        }
+        compressedBucket.append(kBucketDataFieldName, compressedData.obj());
+        return compressedBucket.obj();
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+BucketUnpacker::BucketUnpacker(std::string timeField, std::string metaField)
+    : _timeField(std::move(timeField)), _metaField(std::move(metaField)) {}
+
+void BucketUnpacker::reset(const BSONObj& bucket) {
+    _bucket = bucket.getOwned();
+    _decompressed.clear();
+    _columns.clear();
+    _rows.clear();
+    _nextRow = 0;
+
+    const auto control = _bucket[kBucketControlFieldName];
+    const auto data = _bucket[kBucketDataFieldName];
+    uassert(40664,
+            str::stream() << "Invalid time-series bucket: " << _bucket["_id"],
+            control.type() == Object && data.type() == Object);
+    const int version = control[kBucketControlVersionFieldName].numberInt();
+    uassert(40665,
+            str::stream() << "Invalid time-series bucket version: " << control,
+            version == kOpenBucketVersion || version == kCompressedBucketVersion);
+
+    _meta = _metaField.empty() ? BSONElement() : _bucket[kBucketMetaFieldName];
+
+    for (auto&& column : data.embeddedObject()) {
+        Column unpacked;
+        unpacked.name = column.fieldName();
+        if (version == kOpenBucketVersion) {
+            unpacked.values = readOpenColumn(column);
+        } else if (unpacked.name == _timeField) {
+            uassert(40666,
+                    str::stream() << "Invalid compressed time-series bucket column '"
+                                  << unpacked.name
+                                  << "'",
+                    column.type() == BinData);
+            int length;
+            const char* encoded = column.binData(length);
+            const auto millis = uassertStatusOK(decodeTimes(StringData(encoded, length)));
+            BSONObjBuilder times;
+            for (size_t i = 0; i < millis.size(); ++i) {
+                times.appendDate(str::stream() << i, Date_t::fromMillisSinceEpoch(millis[i]));
+            }
+            _decompressed.push_back(times.obj());
+            unpacked.values = readColumn(unpacked.name, _decompressed.back());
+        } else {
+            uassert(40667,
+                    str::stream() << "Invalid compressed time-series bucket column '"
+                                  << unpacked.name
+                                  << "'",
+                    column.type() == BinData);
+            _decompressed.push_back(decompressColumn(column));
+            unpacked.values = readColumn(unpacked.name, _decompressed.back());
+        }
+
+        if (unpacked.name == _timeField) {
+            for (auto&& value : unpacked.values) {
+                _rows.push_back(value.first);
+            }
+        }
+        _columns.push_back(std::move(unpacked));
+    }
+}
+
+BSONObj BucketUnpacker::getNext() {
+    invariant(hasNext());
+    const int row = _rows[_nextRow++];
+
+    BSONObjBuilder measurement;
+    for (auto&& column : _columns) {
+        while (column.next < column.values.size() && column.values[column.next].first < row) {
+            ++column.next;
+        }
+        if (column.next < column.values.size() && column.values[column.next].first == row) {
+            measurement.appendAs(column.values[column.next].second, column.name);
+        }
+    }
+    if (_meta) {
+        measurement.appendAs(_meta, _metaField);
+    }
+    return measurement.obj();
+}
+
+}  // namespace timeseries
+}  // namespace mongo
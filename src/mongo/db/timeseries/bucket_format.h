@@ -0,0 +1,147 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/catalog/collection_options.h"
+
+namespace mongo {
+namespace timeseries {
+
+/**
+ * A time-series collection stores the measurements of each series in bucket documents, which hold
+ * the fields of up to 'bucketMaxCount' measurements as columns:
+ *
+ * {
+ *     _id: <ObjectId>,
+ *     control: {
+ *         version: <1 while the bucket is open, 2 once it is compressed>,
+ *         count: <number of measurements>,
+ *         min: {<field>: <least value>, ...},
+ *         max: {<field>: <greatest value>, ...}
+ *     },
+ *     meta: <value of the metaField shared by the measurements, if any>,
+ *     data: {
+ *         <field>: <column>,
+ *         ...
+ *     }
+ * }
+ *
+ * In an open bucket each column is a document mapping the row of each measurement which has the
+ * field to its value, {"0": <value>, "1": <value>, ...}, so that a measurement is added by a
+ * single update. Once the bucket is full it is compressed, renumbering its rows densely in order:
+ * the column of the timeField becomes BinData of the delta-of-delta encoded times, and the other
+ * columns become BinData of their snappy-compressed documents.
+ */
+constexpr StringData kBucketControlFieldName = "control"_sd;
+constexpr StringData kBucketMetaFieldName = "meta"_sd;
+constexpr StringData kBucketDataFieldName = "data"_sd;
+constexpr StringData kBucketControlVersionFieldName = "version"_sd;
+constexpr StringData kBucketControlCountFieldName = "count"_sd;
+constexpr StringData kBucketControlMinFieldName = "min"_sd;
+constexpr StringData kBucketControlMaxFieldName = "max"_sd;
+
+const int kOpenBucketVersion = 1;
+const int kCompressedBucketVersion = 2;
+
+/**
+ * Checks that 'measurement' can be stored in a bucket: it must have a date in its timeField, and
+ * the names of its fields must be usable in update paths.
+ */
+Status validateMeasurement(const TimeseriesOptions& options, const BSONObj& measurement);
+
+/**
+ * Returns the update which adds 'measurement' as 'row' of an open bucket, to be applied as an
+ * upsert to the bucket's _id.
+ */
+BSONObj makeMeasurementUpdate(const TimeseriesOptions& options,
+                              const BSONObj& measurement,
+                              int row);
+
+/**
+ * Returns the compressed form of the open 'bucket'.
+ */
+StatusWith<BSONObj> compressBucket(const TimeseriesOptions& options, const BSONObj& bucket);
+
+/**
+ * Encodes 'millis' as a varint of the first value, then of the first delta, then of the deltas
+ * between consecutive deltas, all zigzag encoded. Regular intervals encode to a byte per value.
+ */
+std::string encodeTimes(const std::vector<long long>& millis);
+
+StatusWith<std::vector<long long>> decodeTimes(StringData encoded);
+
+/**
+ * Turns open or compressed buckets back into their measurements, one at a time. The fields of each
+ * measurement are in the order of the bucket's columns, followed by the metaField.
+ */
+class BucketUnpacker {
+public:
+    BucketUnpacker(std::string timeField, std::string metaField);
+
+    /**
+     * Starts unpacking 'bucket'. Throws if it is not a valid bucket.
+     */
+    void reset(const BSONObj& bucket);
+
+    bool hasNext() const {
+        return _nextRow < _rows.size();
+    }
+
+    BSONObj getNext();
+
+private:
+    struct Column {
+        std::string name;
+        // The values of the column by row, ascending.
+        std::vector<std::pair<int, BSONElement>> values;
+        size_t next = 0;
+    };
+
+    const std::string _timeField;
+    const std::string _metaField;
+
+    BSONObj _bucket;
+    BSONElement _meta;
+
+    // Owns the decompressed columns of a compressed bucket.
+    std::vector<BSONObj> _decompressed;
+
+    std::vector<Column> _columns;
+    std::vector<int> _rows;
+    size_t _nextRow = 0;
+};
+
+}  // namespace timeseries
+}  // namespace mongo
@@ -0,0 +1,185 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_format.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace timeseries {
+namespace {
+
+TimeseriesOptions makeOptions() {
+    TimeseriesOptions options;
+    options.timeField = "t";
+    options.metaField = "m";
+    return options;
+}
+
+Date_t date(long long millis) {
+    return Date_t::fromMillisSinceEpoch(millis);
+}
+
+std::vector<BSONObj> unpack(const BSONObj& bucket) {
+    BucketUnpacker unpacker("t", "m");
+    unpacker.reset(bucket);
+    std::vector<BSONObj> measurements;
+    while (unpacker.hasNext()) {
+        measurements.push_back(unpacker.getNext());
+    }
+    return measurements;
+}
+
+void assertTimesRoundTrip(const std::vector<long long>& millis) {
+    auto decoded = decodeTimes(encodeTimes(millis));
+    ASSERT_OK(decoded.getStatus());
+    ASSERT(millis == decoded.getValue());
+}
+
+TEST(BucketFormatTest, TimesRoundTrip) {
+    assertTimesRoundTrip({});
+    assertTimesRoundTrip({1500000000000LL});
+    assertTimesRoundTrip({1500000000000LL, 1500000001000LL, 1500000002000LL, 1500000002500LL});
+    assertTimesRoundTrip({-5, 7, -9, 0, 0, 100});
+    assertTimesRoundTrip({std::numeric_limits<long long>::min(),
+                          std::numeric_limits<long long>::max(),
+                          std::numeric_limits<long long>::min(),
+                          0});
+}
+
+TEST(BucketFormatTest, RegularTimesEncodeToAByteEach) {
+    std::vector<long long> millis;
+    for (int i = 0; i < 1000; ++i) {
+        millis.push_back(1500000000000LL + i * 1000);
+    }
+    // The first time and first delta take several bytes, then every delta of delta is 0.
+    ASSERT_LT(encodeTimes(millis).size(), 1000U + 10U);
+}
+
+TEST(BucketFormatTest, TruncatedTimesAreRejected) {
+    const auto encoded = encodeTimes({1500000000000LL});
+    ASSERT_NOT_OK(decodeTimes(StringData(encoded).substr(0, encoded.size() - 1)).getStatus());
+}
+
+TEST(BucketFormatTest, ValidateMeasurement) {
+    const auto options = makeOptions();
+    ASSERT_OK(validateMeasurement(options, BSON("t" << date(1) << "m" << 1 << "v" << 2)));
+    ASSERT_NOT_OK(validateMeasurement(options, BSON("m" << 1 << "v" << 2)));
+    ASSERT_NOT_OK(validateMeasurement(options, BSON("t" << 1 << "v" << 2)));
+    ASSERT_NOT_OK(validateMeasurement(options, BSON("t" << date(1) << "a.b" << 2)));
+    ASSERT_NOT_OK(validateMeasurement(options, BSON("t" << date(1) << "$v" << 2)));
+}
+
+TEST(BucketFormatTest, MeasurementUpdate) {
+    const auto options = makeOptions();
+    ASSERT_BSONOBJ_EQ(
+        BSON("$set" << BSON("data.t.3" << date(10) << "data.v.3" << 2) << "$min"
+                    << BSON("control.min.t" << date(10) << "control.min.v" << 2)
+                    << "$max"
+                    << BSON("control.max.t" << date(10) << "control.max.v" << 2)
+                    << "$inc"
+                    << BSON("control.count" << 1)
+                    << "$setOnInsert"
+                    << BSON("control.version" << kOpenBucketVersion << "meta"
+                                              << "sensor")),
+        makeMeasurementUpdate(options, BSON("t" << date(10) << "m" << "sensor" << "v" << 2), 3));
+}
+
+BSONObj makeOpenBucket() {
+    // Rows 1 and 0 were written out of order, and row 2 was rolled back.
+    return BSON("_id" << OID::gen() << "control"
+                      << BSON("version" << kOpenBucketVersion << "count" << 3 << "min"
+                                        << BSON("t" << date(10) << "v" << 1)
+                                        << "max"
+                                        << BSON("t" << date(30) << "v" << 3))
+                      << "meta"
+                      << "sensor"
+                      << "data"
+                      << BSON("t" << BSON("1" << date(20) << "0" << date(10) << "3" << date(30))
+                                  << "v"
+                                  << BSON("1" << 2 << "0" << 1)
+                                  << "w"
+                                  << BSON("3" << BSON("x" << 1))));
+}
+
+TEST(BucketFormatTest, UnpackOpenBucket) {
+    auto measurements = unpack(makeOpenBucket());
+    ASSERT_EQ(3U, measurements.size());
+    ASSERT_BSONOBJ_EQ(BSON("t" << date(10) << "v" << 1 << "m"
+                               << "sensor"),
+                      measurements[0]);
+    ASSERT_BSONOBJ_EQ(BSON("t" << date(20) << "v" << 2 << "m"
+                               << "sensor"),
+                      measurements[1]);
+    ASSERT_BSONOBJ_EQ(BSON("t" << date(30) << "w" << BSON("x" << 1) << "m"
+                               << "sensor"),
+                      measurements[2]);
+}
+
+TEST(BucketFormatTest, CompressedBucketUnpacksToTheSameMeasurements) {
+    const auto bucket = makeOpenBucket();
+    auto compressed = compressBucket(makeOptions(), bucket);
+    ASSERT_OK(compressed.getStatus());
+
+    const auto control = compressed.getValue()["control"].Obj();
+    ASSERT_EQ(kCompressedBucketVersion, control["version"].numberInt());
+    ASSERT_EQ(3, control["count"].numberInt());
+    ASSERT_BSONOBJ_EQ(bucket["control"]["min"].Obj(), control["min"].Obj());
+    ASSERT_BSONOBJ_EQ(bucket["control"]["max"].Obj(), control["max"].Obj());
+    ASSERT_EQ(BinData, compressed.getValue()["data"]["t"].type());
+    ASSERT_EQ(BinData, compressed.getValue()["data"]["v"].type());
+
+    auto expected = unpack(bucket);
+    auto actual = unpack(compressed.getValue());
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(expected[i], actual[i]);
+    }
+
+    // Compressed buckets cannot be compressed again.
+    ASSERT_NOT_OK(compressBucket(makeOptions(), compressed.getValue()).getStatus());
+}
+
+TEST(BucketFormatTest, InvalidBucketsAreRejected) {
+    BucketUnpacker unpacker("t", "m");
+    ASSERT_THROWS(unpacker.reset(BSON("_id" << 1)), AssertionException);
+    ASSERT_THROWS(unpacker.reset(fromjson("{control: {version: 3}, data: {}}")),
+                  AssertionException);
+    ASSERT_THROWS(unpacker.reset(fromjson("{control: {version: 1}, data: {t: {a: 1}}}")),
+                  AssertionException);
+    ASSERT_THROWS(unpacker.reset(fromjson("{control: {version: 2}, data: {t: 1}}")),
+                  AssertionException);
+}
+
+}  // namespace
+}  // namespace timeseries
+}  // namespace mongo
@@ -0,0 +1,299 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_recorder.h"
+
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/traffic_recording.h"
+#include "mongo/rpc/factory.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+const auto getTrafficRecorder = ServiceContext::declareDecoration<TrafficRecorder>();
+
+// Recordings can only be written into this directory, so that the recording commands cannot be
+// used to overwrite arbitrary files. Recording is disabled if it is not set.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(trafficRecordingDirectory, std::string, "");
+
+MONGO_EXPORT_SERVER_PARAMETER(trafficRecordingBufferSizeBytes, int, 64 * 1024 * 1024);
+
+/**
+ * Returns true if 'request' is a step of an authentication handshake.
+ */
+bool isAuthenticationRequest(const Message& request) {
+    if (request.operation() != dbMsg && request.operation() != dbQuery) {
+        return false;
+    }
+
+    try {
+        const auto commandName = rpc::opMsgRequestFromAnyProtocol(request).getCommandName();
+        return commandName == "saslStart" || commandName == "saslContinue" ||
+            commandName == "authenticate" || commandName == "getnonce" ||
+            commandName == "copydbsaslstart" || commandName == "copydbgetnonce";
+    } catch (const DBException&) {
+        // Not a command, such as a legacy query.
+        return false;
+    }
+}
+
+}  // namespace
+
+TrafficRecorder::~TrafficRecorder() {
+    if (_thread.joinable()) {
+        stop().ignore();
+    }
+}
+
+TrafficRecorder& TrafficRecorder::get(ServiceContext* service) {
+    return getTrafficRecorder(service);
+}
+
+Status TrafficRecorder::start(const std::string& filename, std::int64_t maxFileSizeBytes) {
+    if (trafficRecordingDirectory.empty()) {
+        return {ErrorCodes::IllegalOperation,
+                "Traffic recording is disabled, as trafficRecordingDirectory is not set"};
+    }
+    if (filename.empty() || filename.find_first_of("/\\") != std::string::npos ||
+        filename == "." || filename == "..") {
+        return {ErrorCodes::BadValue,
+                str::stream() << "The recording file name must not be a path, but is: "
+                              << filename};
+    }
+    if (maxFileSizeBytes <= 0) {
+        return {ErrorCodes::BadValue, "The maximum recording file size must be positive"};
+    }
+
+    const auto path = (boost::filesystem::path(trafficRecordingDirectory) / filename).string();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_thread.joinable()) {
+        return {ErrorCodes::FileAlreadyOpen,
+                str::stream() << "Traffic is already being recorded into " << _path
+                              << ", which must be stopped first"};
+    }
+
+    boost::system::error_code ec;
+    if (boost::filesystem::exists(path, ec)) {
+        return {ErrorCodes::FileAlreadyOpen,
+                str::stream() << "The recording file " << path << " already exists"};
+    }
+
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.write(kTrafficRecordingMagic, sizeof(kTrafficRecordingMagic))) {
+        return {ErrorCodes::FileOpenFailed,
+                str::stream() << "Unable to create the recording file " << path};
+    }
+
+    _path = path;
+    _maxFileSizeBytes = maxFileSizeBytes;
+    _startOfRecordingMicros = curTimeMicros64();
+    _buffer.clear();
+    _bufferedBytes = 0;
+    _stopRequested = false;
+    _recordsWritten = 0;
+    _recordsDropped = 0;
+    _bytesWritten = sizeof(kTrafficRecordingMagic);
+    _stopReason = Status::OK();
+
+    _thread = stdx::thread([ this, out = std::move(out) ]() mutable { _run(std::move(out)); });
+    _recording.store(true);
+
+    log() << "Started recording traffic into " << _path;
+    return Status::OK();
+}
+
+Status TrafficRecorder::stop() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_thread.joinable()) {
+            return {ErrorCodes::FileNotOpen, "Traffic is not being recorded"};
+        }
+
+        _recording.store(false);
+        _stopRequested = true;
+        _condvar.notify_one();
+    }
+
+    // Only the recording commands start and stop the thread, and they do so one at a time.
+    _thread.join();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _thread = stdx::thread();
+    log() << "Stopped recording traffic into " << _path << " after writing " << _recordsWritten
+          << " records";
+    return Status::OK();
+}
+
+void TrafficRecorder::appendStatus(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("recording", _recording.load());
+    if (_path.empty()) {
+        return;
+    }
+
+    builder->append("path", _path);
+    builder->append("maxFileSize", static_cast<long long>(_maxFileSizeBytes));
+    builder->append("recordsWritten", _recordsWritten);
+    builder->append("recordsDropped", _recordsDropped);
+    builder->append("bytesWritten", _bytesWritten);
+    if (!_stopReason.isOK()) {
+        builder->append("stopReason", _stopReason.reason());
+    }
+}
+
+void TrafficRecorder::observeRequest(const transport::SessionHandle& session,
+                                     const Message& request) {
+    if (!_recording.load() || isAuthenticationRequest(request)) {
+        return;
+    }
+
+    TrafficRecord record;
+    record.type = TrafficRecord::Type::kRequest;
+    record.sessionId = session->id();
+    record.offset =
+        Microseconds(static_cast<long long>(curTimeMicros64() - _startOfRecordingMicros));
+    record.request = request;
+
+    BufBuilder builder;
+    appendTrafficRecord(record, &builder);
+    _append(std::string(builder.buf(), builder.len()));
+}
+
+void TrafficRecorder::observeResponse(const transport::SessionHandle& session,
+                                      const Message& request,
+                                      const Message& response) {
+    if (!_recording.load()) {
+        return;
+    }
+
+    const long long cursorId = getCursorIdFromReply(response);
+    if (cursorId == 0) {
+        return;
+    }
+
+    TrafficRecord record;
+    record.type = TrafficRecord::Type::kCursorReply;
+    record.sessionId = session->id();
+    record.offset =
+        Microseconds(static_cast<long long>(curTimeMicros64() - _startOfRecordingMicros));
+    record.responseTo = request.header().getId();
+    record.cursorId = cursorId;
+
+    BufBuilder builder;
+    appendTrafficRecord(record, &builder);
+    _append(std::string(builder.buf(), builder.len()));
+}
+
+void TrafficRecorder::_append(std::string record) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_recording.load()) {
+        return;
+    }
+
+    const auto bufferSizeBytes = static_cast<std::size_t>(trafficRecordingBufferSizeBytes.load());
+    if (_bufferedBytes + record.size() > bufferSizeBytes) {
+        _recordsDropped++;
+        return;
+    }
+
+    _bufferedBytes += record.size();
+    _buffer.push_back(std::move(record));
+    _condvar.notify_one();
+}
+
+void TrafficRecorder::_run(std::ofstream out) {
+    setThreadName("trafficRecorder");
+
+    while (true) {
+        std::vector<std::string> batch;
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _condvar.wait(lk, [this] { return !_buffer.empty() || _stopRequested; });
+            if (_buffer.empty()) {
+                break;
+            }
+
+            batch.swap(_buffer);
+            _bufferedBytes = 0;
+        }
+
+        long long recordsWritten = 0;
+        long long bytesWritten = 0;
+        Status stopReason = Status::OK();
+        for (const auto& record : batch) {
+            if (_bytesWritten + bytesWritten + static_cast<long long>(record.size()) >
+                _maxFileSizeBytes) {
+                stopReason = {ErrorCodes::OperationFailed,
+                              "The recording reached its maximum file size"};
+                break;
+            }
+            if (!out.write(record.data(), record.size())) {
+                stopReason = {ErrorCodes::FileStreamFailed,
+                              str::stream() << "Failed to write to " << _path};
+                break;
+            }
+
+            recordsWritten++;
+            bytesWritten += record.size();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _recordsWritten += recordsWritten;
+        _recordsDropped += batch.size() - recordsWritten;
+        _bytesWritten += bytesWritten;
+        if (!stopReason.isOK()) {
+            warning() << "Stopped recording traffic into " << _path << ": " << stopReason;
+            _stopReason = stopReason;
+            _recording.store(false);
+            _recordsDropped += _buffer.size();
+            _buffer.clear();
+            _bufferedBytes = 0;
+            break;
+        }
+    }
+
+    out.flush();
+}
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/session.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class Message;
+class ServiceContext;
+
+/**
+ * Records the requests a server receives, as they come in from the network, into a file in the
+ * format described in traffic_recording.h, so that production load can be replayed against a test
+ * deployment with mongotrafficreplay.
+ *
+ * Requests are seen after TLS and wire protocol compression have been undone. The authentication
+ * handshakes are not recorded, as they contain credentials and cannot be replayed. For the replies
+ * which return a cursor, the cursor id is recorded, so that the replay can substitute the ids of
+ * the cursors it opens for the recorded ones.
+ *
+ * Records are handed to a background thread which writes them out. If the thread falls behind by
+ * more than trafficRecordingBufferSizeBytes, records are dropped and counted rather than slowing
+ * the server down.
+ */
+class TrafficRecorder {
+    MONGO_DISALLOW_COPYING(TrafficRecorder);
+
+public:
+    TrafficRecorder() = default;
+    ~TrafficRecorder();
+
+    static TrafficRecorder& get(ServiceContext* service);
+
+    /**
+     * Starts recording into 'filename' within trafficRecordingDirectory. The recording stops on its
+     * own once the file reaches 'maxFileSizeBytes'.
+     */
+    Status start(const std::string& filename, std::int64_t maxFileSizeBytes);
+
+    /**
+     * Stops the recording, waiting for the records buffered so far to be written.
+     */
+    Status stop();
+
+    /**
+     * Appends the state of the current or last recording.
+     */
+    void appendStatus(BSONObjBuilder* builder) const;
+
+    /**
+     * Records a request received on 'session', unless no recording is in progress.
+     */
+    void observeRequest(const transport::SessionHandle& session, const Message& request);
+
+    /**
+     * Records the cursor id returned by 'response', if any, unless no recording is in progress.
+     */
+    void observeResponse(const transport::SessionHandle& session,
+                         const Message& request,
+                         const Message& response);
+
+private:
+    void _append(std::string record);
+
+    void _run(std::ofstream out);
+
+    // Lets the request paths skip the mutex when there is no recording.
+    AtomicWord<bool> _recording{false};
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+
+    std::string _path;
+    std::int64_t _maxFileSizeBytes = 0;
+    std::uint64_t _startOfRecordingMicros = 0;
+
+    // Records waiting to be written, and the sum of their sizes.
+    std::vector<std::string> _buffer;
+    std::size_t _bufferedBytes = 0;
+
+    bool _stopRequested = false;
+    stdx::thread _thread;
+
+    long long _recordsWritten = 0;
+    long long _recordsDropped = 0;
+    long long _bytesWritten = 0;
+
+    // Why the recording stopped on its own, if it did.
+    Status _stopReason = Status::OK();
+};
+
+}  // namespace mongo
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_recording.h"
+
+#include <cstring>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/rpc/factory.h"
+#include "mongo/rpc/reply_interface.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+const char kTrafficRecordingMagic[8] = {'M', 'D', 'B', 'T', 'R', 'A', 'F', '1'};
+
+namespace {
+
+// Total size, type, session id and offset.
+constexpr std::size_t kRecordHeaderSize = 4 + 1 + 8 + 8;
+
+// Request id and cursor id.
+constexpr std::size_t kCursorReplySize = 4 + 8;
+
+// Larger than any message the server accepts.
+constexpr std::size_t kMaxRecordSize = 64 * 1024 * 1024;
+
+}  // namespace
+
+void appendTrafficRecord(const TrafficRecord& record, BufBuilder* builder) {
+    const int start = builder->len();
+
+    // The size is known once the whole record has been appended.
+    builder->appendNum(static_cast<int>(0));
+    builder->appendUChar(static_cast<unsigned char>(record.type));
+    builder->appendNum(static_cast<unsigned long long>(record.sessionId));
+    builder->appendNum(static_cast<long long>(durationCount<Microseconds>(record.offset)));
+
+    switch (record.type) {
+        case TrafficRecord::Type::kRequest:
+            builder->appendBuf(record.request.buf(), record.request.size());
+            break;
+        case TrafficRecord::Type::kCursorReply:
+            builder->appendNum(static_cast<int>(record.responseTo));
+            builder->appendNum(static_cast<long long>(record.cursorId));
+            break;
+    }
+
+    DataView(builder->buf() + start)
+        .write(tagLittleEndian(static_cast<std::int32_t>(builder->len() - start)));
+}
+
+long long getCursorIdFromReply(const Message& response) {
+    if (response.operation() == opReply) {
+        const long long cursorId = QueryResult::ConstView(response.buf()).getCursorId();
+        if (cursorId != 0) {
+            return cursorId;
+        }
+    }
+
+    try {
+        const auto reply = rpc::makeReply(&response);
+        const BSONObj commandReply = reply->getCommandReply();
+        const BSONElement cursor = commandReply["cursor"];
+        if (cursor.type() == Object) {
+            return cursor.Obj()["id"].safeNumberLong();
+        }
+    } catch (const DBException&) {
+        // Not a command reply, such as the reply to a legacy query without a cursor.
+    }
+
+    return 0;
+}
+
+StatusWith<std::unique_ptr<TrafficRecordingReader>> TrafficRecordingReader::open(
+    const std::string& path) {
+    std::unique_ptr<TrafficRecordingReader> reader(new TrafficRecordingReader());
+    reader->_path = path;
+    reader->_in.open(path, std::ios::in | std::ios::binary);
+    if (!reader->_in.is_open()) {
+        return {ErrorCodes::FileOpenFailed,
+                str::stream() << "Unable to open traffic recording " << path};
+    }
+
+    char magic[sizeof(kTrafficRecordingMagic)];
+    if (!reader->_in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, kTrafficRecordingMagic, sizeof(magic)) != 0) {
+        return {ErrorCodes::FailedToParse,
+                str::stream() << path << " is not a traffic recording"};
+    }
+
+    return {std::move(reader)};
+}
+
+StatusWith<boost::optional<TrafficRecord>> TrafficRecordingReader::next() {
+    char header[kRecordHeaderSize];
+    if (!_in.read(header, sizeof(header))) {
+        return {boost::none};
+    }
+
+    ConstDataView headerView(header);
+    const std::size_t size = headerView.read<LittleEndian<std::uint32_t>>();
+    if (size < kRecordHeaderSize || size > kMaxRecordSize) {
+        return {ErrorCodes::FailedToParse,
+                str::stream() << "Invalid record size " << size << " in traffic recording "
+                              << _path};
+    }
+
+    const auto type = static_cast<TrafficRecord::Type>(headerView.read<std::uint8_t>(4U));
+
+    TrafficRecord record;
+    record.type = type;
+    record.sessionId = headerView.read<LittleEndian<std::uint64_t>>(5U);
+    const std::int64_t offsetMicros = headerView.read<LittleEndian<std::int64_t>>(13U);
+    record.offset = Microseconds(offsetMicros);
+
+    const std::size_t payloadSize = size - kRecordHeaderSize;
+
+    switch (type) {
+        case TrafficRecord::Type::kRequest: {
+            auto buffer = SharedBuffer::allocate(payloadSize);
+            if (!_in.read(buffer.get(), payloadSize)) {
+                return {boost::none};
+            }
+
+            record.request = Message(std::move(buffer));
+            if (payloadSize < sizeof(MSGHEADER::Value) ||
+                static_cast<std::size_t>(record.request.size()) != payloadSize) {
+                return {ErrorCodes::FailedToParse,
+                        str::stream() << "Invalid request message in traffic recording "
+                                      << _path};
+            }
+            break;
+        }
+        case TrafficRecord::Type::kCursorReply: {
+            char payload[kCursorReplySize];
+            if (payloadSize != kCursorReplySize) {
+                return {ErrorCodes::FailedToParse,
+                        str::stream() << "Invalid cursor reply record in traffic recording "
+                                      << _path};
+            }
+            if (!_in.read(payload, sizeof(payload))) {
+                return {boost::none};
+            }
+
+            ConstDataView payloadView(payload);
+            record.responseTo = payloadView.read<LittleEndian<std::int32_t>>();
+            record.cursorId = payloadView.read<LittleEndian<std::int64_t>>(4U);
+            break;
+        }
+        default:
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Unknown record type " << static_cast<int>(type)
+                                  << " in traffic recording " << _path};
+    }
+
+    return {std::move(record)};
+}
+
+}  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * The file format of the traffic recordings written by the TrafficRecorder.
+ *
+ * A recording starts with the 8 bytes of kTrafficRecordingMagic, followed by the records. Every
+ * record starts with a header made of its total size as a 32 bit integer, its type as a byte, the
+ * id of the session it belongs to as a 64 bit integer, and the number of microseconds since the
+ * recording started as a 64 bit integer, all little endian. The header is followed by:
+ *  - for a kRequest record, the request message as it was received, decompressed;
+ *  - for a kCursorReply record, the id of the request as a 32 bit integer and the id of the cursor
+ *    its reply returned as a 64 bit integer, so that a replay can substitute the ids of the
+ *    cursors it opens for the recorded ones.
+ */
+extern const char kTrafficRecordingMagic[8];
+
+struct TrafficRecord {
+    enum class Type : std::uint8_t {
+        kRequest = 1,
+        kCursorReply = 2,
+    };
+
+    Type type = Type::kRequest;
+    std::uint64_t sessionId = 0;
+    Microseconds offset{0};
+
+    // Set for kRequest records.
+    Message request;
+
+    // Set for kCursorReply records.
+    std::int32_t responseTo = 0;
+    std::int64_t cursorId = 0;
+};
+
+/**
+ * Appends 'record' to 'builder' in the format of the recordings.
+ */
+void appendTrafficRecord(const TrafficRecord& record, BufBuilder* builder);
+
+/**
+ * Returns the id of the cursor 'response' returns, or 0 if it does not return one.
+ */
+long long getCursorIdFromReply(const Message& response);
+
+/**
+ * Reads the records of a recording in order.
+ */
+class TrafficRecordingReader {
+    MONGO_DISALLOW_COPYING(TrafficRecordingReader);
+
+public:
+    /**
+     * Opens the recording at 'path' and checks that it starts like one.
+     */
+    static StatusWith<std::unique_ptr<TrafficRecordingReader>> open(const std::string& path);
+
+    /**
+     * Returns the next record, boost::none once all of them have been read, or an error if the
+     * recording is corrupt. A record cut short by the end of the file counts as the end, since
+     * the server may have been stopped while writing it.
+     */
+    StatusWith<boost::optional<TrafficRecord>> next();
+
+private:
+    TrafficRecordingReader() = default;
+
+    std::ifstream _in;
+    std::string _path;
+};
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/traffic_recording.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+Message makeRequest(int id, const char* text) {
+    Message message;
+    message.setData(dbMsg, text);
+    message.header().setId(id);
+    return message;
+}
+
+void writeRecording(const std::string& path, const std::vector<TrafficRecord>& records) {
+    BufBuilder builder;
+    builder.appendBuf(kTrafficRecordingMagic, sizeof(kTrafficRecordingMagic));
+    for (const auto& record : records) {
+        appendTrafficRecord(record, &builder);
+    }
+
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    out.write(builder.buf(), builder.len());
+}
+
+TEST(TrafficRecordingTest, RecordsRoundTrip) {
+    unittest::TempDir tempdir("traffic_recording_test");
+    const auto path = (boost::filesystem::path(tempdir.path()) / "recording").string();
+
+    TrafficRecord request;
+    request.type = TrafficRecord::Type::kRequest;
+    request.sessionId = 12;
+    request.offset = Microseconds(345);
+    request.request = makeRequest(7, "request body");
+
+    TrafficRecord cursorReply;
+    cursorReply.type = TrafficRecord::Type::kCursorReply;
+    cursorReply.sessionId = 12;
+    cursorReply.offset = Microseconds(678);
+    cursorReply.responseTo = 7;
+    cursorReply.cursorId = 123456789012345LL;
+
+    writeRecording(path, {request, cursorReply});
+
+    auto swReader = TrafficRecordingReader::open(path);
+    ASSERT_OK(swReader.getStatus());
+    auto& reader = swReader.getValue();
+
+    auto swRecord = reader->next();
+    ASSERT_OK(swRecord.getStatus());
+    ASSERT_TRUE(swRecord.getValue());
+    const auto& readRequest = *swRecord.getValue();
+    ASSERT(readRequest.type == TrafficRecord::Type::kRequest);
+    ASSERT_EQ(12U, readRequest.sessionId);
+    ASSERT_EQ(Microseconds(345), readRequest.offset);
+    ASSERT_EQ(7, readRequest.request.header().getId());
+    ASSERT_EQ(dbMsg, readRequest.request.operation());
+    ASSERT_EQ(request.request.size(), readRequest.request.size());
+    ASSERT_EQ(0,
+              std::memcmp(
+                  request.request.buf(), readRequest.request.buf(), request.request.size()));
+
+    swRecord = reader->next();
+    ASSERT_OK(swRecord.getStatus());
+    ASSERT_TRUE(swRecord.getValue());
+    const auto& readCursorReply = *swRecord.getValue();
+    ASSERT(readCursorReply.type == TrafficRecord::Type::kCursorReply);
+    ASSERT_EQ(Microseconds(678), readCursorReply.offset);
+    ASSERT_EQ(7, readCursorReply.responseTo);
+    ASSERT_EQ(123456789012345LL, readCursorReply.cursorId);
+
+    swRecord = reader->next();
+    ASSERT_OK(swRecord.getStatus());
+    ASSERT_FALSE(swRecord.getValue());
+}
+
+TEST(TrafficRecordingTest, TruncatedRecordEndsRecording) {
+    unittest::TempDir tempdir("traffic_recording_test");
+    const auto path = (boost::filesystem::path(tempdir.path()) / "recording").string();
+
+    TrafficRecord request;
+    request.request = makeRequest(1, "request body");
+    writeRecording(path, {request});
+    boost::filesystem::resize_file(path, boost::filesystem::file_size(path) - 3);
+
+    auto swReader = TrafficRecordingReader::open(path);
+    ASSERT_OK(swReader.getStatus());
+
+    auto swRecord = swReader.getValue()->next();
+    ASSERT_OK(swRecord.getStatus());
+    ASSERT_FALSE(swRecord.getValue());
+}
+
+TEST(TrafficRecordingTest, RejectsOtherFiles) {
+    unittest::TempDir tempdir("traffic_recording_test");
+    const auto path = (boost::filesystem::path(tempdir.path()) / "not_a_recording").string();
+
+    std::ofstream(path, std::ios::out | std::ios::binary) << "some other file";
+
+    ASSERT_EQ(ErrorCodes::FailedToParse, TrafficRecordingReader::open(path).getStatus());
+    ASSERT_EQ(ErrorCodes::FileOpenFailed,
+              TrafficRecordingReader::open(path + ".missing").getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
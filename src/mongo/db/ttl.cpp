@@ -72,6 +72,13 @@ ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocume
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// Maximum number of documents a single pass deletes through one TTL index. When a pass stops at
+// this limit, the monitor starts the next pass after ttlMonitorBatchPauseMillis rather than after
+// ttlMonitorSleepSecs, so large expirations are spread out in paced batches instead of arriving as
+// a single burst of deletes. Zero means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, long long, 0);
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchPauseMillis, int, 100);
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -87,11 +94,17 @@ public:
         Client::initThread(name().c_str());
         AuthorizationSession::get(cc())->grantInternalAuthorization();
 
+        bool moreExpired = false;
         while (!globalInShutdownDeprecated()) {
             {
                 MONGO_IDLE_THREAD_BLOCK;
-                sleepsecs(ttlMonitorSleepSecs.load());
+                if (moreExpired) {
+                    sleepmillis(ttlMonitorBatchPauseMillis.load());
+                } else {
+                    sleepsecs(ttlMonitorSleepSecs.load());
+                }
             }
+            moreExpired = false;
 
             LOG(3) << "thread awake";
 
@@ -108,7 +121,7 @@ public:
             }
 
             try {
-                doTTLPass();
+                moreExpired = doTTLPass();
             } catch (const WriteConflictException& e) {
                 LOG(1) << "got WriteConflictException";
             }
@@ -116,7 +129,10 @@ public:
     }
 
 private:
-    void doTTLPass() {
+    /**
+     * Returns true if any TTL index stopped at the batch size with expired documents remaining.
+     */
+    bool doTTLPass() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -124,7 +140,7 @@ private:
         if (repl::getGlobalReplicationCoordinator()->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::getGlobalReplicationCoordinator()->getMemberState().readable())
-            return;
+            return false;
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
@@ -153,37 +169,41 @@ private:
             }
         }
 
+        bool moreExpired = false;
         for (const BSONObj& idx : ttlIndexes) {
             try {
-                doTTLForIndex(&opCtx, idx);
+                moreExpired |= doTTLForIndex(&opCtx, idx);
             } catch (const DBException& dbex) {
                 error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
                 // Continue on to the next index.
                 continue;
             }
         }
+
+        return moreExpired;
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
-     * of time has passed according to its expiry specification.
+     * of time has passed according to its expiry specification. Returns true if the deletion
+     * stopped at ttlMonitorBatchSize documents, in which case more may have expired.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    bool doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (collectionNSS.isDropPendingNamespace()) {
-            return;
+            return false;
         }
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             error() << "namespace '" << collectionNSS
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         const BSONObj key = idx["key"].Obj();
         const StringData name = idx["name"].valueStringData();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
@@ -192,18 +212,18 @@ private:
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return false;
         }
 
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return false;
         }
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return;
+            return false;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
@@ -212,7 +232,7 @@ private:
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -220,7 +240,7 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         const Date_t kDawnOfTime =
@@ -245,8 +265,11 @@ private:
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
         invariantOK(canonicalQuery.getStatus());
 
+        const long long batchSize = ttlMonitorBatchSize.load();
+
         DeleteStageParams params;
         params.isMulti = true;
+        params.limit = std::max(0LL, batchSize);
         params.canonicalQuery = canonicalQuery.getValue().get();
 
         auto exec =
@@ -264,12 +287,14 @@ private:
         if (!result.isOK()) {
             error() << "ttl query execution for index " << idx
                     << " failed with status: " << redact(result);
-            return;
+            return false;
         }
 
         const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
         LOG(1) << "deleted: " << numDeleted;
+
+        return batchSize > 0 && numDeleted >= batchSize;
     }
 };
 
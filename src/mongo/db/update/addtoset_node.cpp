@@ -31,7 +31,10 @@
 #include "mongo/db/update/addtoset_node.h"
 
 #include "mongo/bson/bsonelement_comparator.h"
+#include "mongo/bson/mutable/algorithm.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/update/log_builder.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -131,12 +134,39 @@ ModifierNode::ModifyResult AddToSetNode::updateExistingElement(
         return ModifyResult::kNoOp;
     }
 
+    const bool wasEmpty = !element->leftChild().ok();
     for (auto&& elem : elementsToAdd) {
         auto toAdd = element->getDocument().makeElement(elem);
         invariantOK(element->pushBack(toAdd));
     }
 
-    return ModifyResult::kNormalUpdate;
+    return wasEmpty ? ModifyResult::kNormalUpdate : ModifyResult::kArrayAppendUpdate;
+}
+
+void AddToSetNode::logUpdate(LogBuilder* logBuilder,
+                             StringData pathTaken,
+                             mutablebson::Element element,
+                             ModifyResult modifyResult) const {
+    invariant(logBuilder);
+
+    if (modifyResult != ModifyResult::kArrayAppendUpdate) {
+        ModifierNode::logUpdate(logBuilder, pathTaken, element, modifyResult);
+        return;
+    }
+
+    // Like $push, an $addToSet which only appended to a non-empty array is logged as a $set of
+    // each appended element rather than of the whole array. At most '_elements.size()' elements
+    // were appended, and the array had at least one element before, so logging that many trailing
+    // positions with their current values covers every appended element. Any of them which was
+    // already in the array keeps its value.
+    const auto arraySize = countChildren(element);
+    const auto numToLog = std::min(_elements.size(), arraySize - 1);
+    auto position = arraySize - numToLog;
+    for (auto child = getNthChild(element, position); child.ok(); child = child.rightSibling()) {
+        std::string pathToArrayElement(str::stream() << pathTaken << "." << position);
+        uassertStatusOK(logBuilder->addToSetsWithNewFieldName(pathToArrayElement, child));
+        ++position;
+    }
 }
 
 void AddToSetNode::setValueForNewElement(mutablebson::Element* element) const {
@@ -50,6 +50,10 @@ protected:
     ModifyResult updateExistingElement(mutablebson::Element* element,
                                        std::shared_ptr<FieldRef> elementPath) const final;
     void setValueForNewElement(mutablebson::Element* element) const final;
+    void logUpdate(LogBuilder* logBuilder,
+                   StringData pathTaken,
+                   mutablebson::Element element,
+                   ModifyResult modifyResult) const final;
 
     bool allowCreation() const final {
         return true;
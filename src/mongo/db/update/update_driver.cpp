@@ -34,6 +34,7 @@
 #include "mongo/bson/mutable/algorithm.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/feature_compatibility_version_command_parser.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/matcher/expression_leaf.h"
@@ -44,6 +45,8 @@
 #include "mongo/db/update/object_replace_node.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/db/update/update_leaf_node.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -144,6 +147,135 @@ bool parseUpdateExpression(
     return positional;
 }
 
+// The number of update shapes remembered per client. Clients tend to send the same few shapes of
+// update over and over again, so a small cache is enough.
+const size_t kMaxCachedUpdateShapesPerClient = 32;
+
+// An UpdateNode tree parsed from an update expression, kept so that later update expressions with
+// the same operators and field paths can reuse it instead of being parsed again. Its leaves still
+// point into 'updateExpr' and must be rebound to the values of the new expression before use.
+struct CachedUpdateShape {
+    BSONObj updateExpr;
+    std::unique_ptr<UpdateNode> root;
+    bool positional = false;
+
+    // The path parts leading to the leaf of each field, in the order of the update expression.
+    std::vector<std::vector<std::string>> leafPaths;
+};
+
+using UpdateShapeCache = stdx::unordered_map<std::string, CachedUpdateShape>;
+
+const auto getUpdateShapeCache = Client::declareDecoration<UpdateShapeCache>();
+
+// Builds the cache key for the shape of 'updateExpr': its operators and the field paths of each
+// operator, but not their values. Returns false if the update cannot be served from the cache,
+// which is the case for operators whose leaves keep more than the value of the modifier and for
+// array filter identifiers, whose parsing depends on the array filters.
+bool makeUpdateShapeKey(const BSONObj& updateExpr, std::string* key) {
+    for (auto&& mod : updateExpr) {
+        auto modName = mod.fieldNameStringData();
+        key->append(modName.rawData(), modName.size());
+        key->push_back('\0');
+        if (modName == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+
+        switch (modifiertable::getType(mod.fieldName())) {
+            case modifiertable::MOD_SET:
+            case modifiertable::MOD_INC:
+            case modifiertable::MOD_MUL:
+            case modifiertable::MOD_UNSET:
+            case modifiertable::MOD_MIN:
+            case modifiertable::MOD_MAX:
+                break;
+            default:
+                return false;
+        }
+        if (mod.type() != BSONType::Object) {
+            return false;
+        }
+
+        BSONObj fields = mod.embeddedObject();
+        const int32_t numFields = fields.nFields();
+        key->append(reinterpret_cast<const char*>(&numFields), sizeof(numFields));
+        for (auto&& field : fields) {
+            auto fieldName = field.fieldNameStringData();
+            if (fieldName.find("$[") != std::string::npos) {
+                return false;
+            }
+            key->append(fieldName.rawData(), fieldName.size());
+            key->push_back('\0');
+        }
+    }
+    return true;
+}
+
+// Clones the cached tree and binds its leaves to the values in 'updateExpr', which has the same
+// shape as the cached expression. Fails if a value is not valid for its operator.
+StatusWith<std::unique_ptr<UpdateNode>> bindCachedUpdateShape(const CachedUpdateShape& cached,
+                                                              const BSONObj& updateExpr) {
+    auto root = cached.root->clone();
+    auto leafPath = cached.leafPaths.begin();
+    for (auto&& mod : updateExpr) {
+        if (mod.fieldNameStringData() == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+
+        for (auto&& field : mod.embeddedObject()) {
+            invariant(leafPath != cached.leafPaths.end());
+            UpdateNode* node = root.get();
+            for (auto&& part : *leafPath) {
+                node = static_cast<UpdateInternalNode*>(node)->getChild(part);
+                invariant(node);
+            }
+            ++leafPath;
+
+            auto status = static_cast<UpdateLeafNode*>(node)->init(field, nullptr);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+    invariant(leafPath == cached.leafPaths.end());
+    return {std::move(root)};
+}
+
+// Remembers the tree parsed from 'updateExpr' under 'key'. The cached tree is bound to an owned
+// copy of the expression so that it stays valid after the caller's expression goes away.
+void cacheUpdateShape(UpdateShapeCache* cache,
+                      std::string key,
+                      const BSONObj& updateExpr,
+                      const UpdateNode& root,
+                      bool positional) {
+    CachedUpdateShape cached;
+    cached.updateExpr = updateExpr.getOwned();
+    cached.positional = positional;
+    for (auto&& mod : updateExpr) {
+        if (mod.fieldNameStringData() == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+        for (auto&& field : mod.embeddedObject()) {
+            FieldRef fieldRef(field.fieldNameStringData());
+            std::vector<std::string> parts;
+            for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+                parts.push_back(fieldRef.getPart(i).toString());
+            }
+            cached.leafPaths.push_back(std::move(parts));
+        }
+    }
+
+    // Point the leaves of the cached tree at the owned copy of the expression.
+    cached.root = root.clone();
+    auto status = bindCachedUpdateShape(cached, cached.updateExpr);
+    invariantOK(status.getStatus());
+    cached.root = std::move(status.getValue());
+
+    if (cache->size() >= kMaxCachedUpdateShapesPerClient) {
+        cache->erase(cache->begin());
+    }
+    cache->emplace(std::move(key), std::move(cached));
+}
+
 }  // namespace
 
 UpdateDriver::UpdateDriver(const Options& opts)
@@ -237,9 +369,27 @@ Status UpdateDriver::parse(
             break;
         }
         case UpdateSemantics::kUpdateNode: {
+            // Updates without array filters or a collation can reuse the tree of an earlier update
+            // of the same shape issued by this client.
+            UpdateShapeCache* shapeCache = nullptr;
+            std::string shapeKey;
+            if (haveClient() && arrayFilters.empty() && !_modOptions.collator &&
+                makeUpdateShapeKey(updateExpr, &shapeKey)) {
+                shapeCache = &getUpdateShapeCache(cc());
+                auto it = shapeCache->find(shapeKey);
+                if (it != shapeCache->end()) {
+                    _root = uassertStatusOK(bindCachedUpdateShape(it->second, updateExpr));
+                    _positional = it->second.positional;
+                    break;
+                }
+            }
+
             auto root = stdx::make_unique<UpdateObjectNode>();
             _positional =
                 parseUpdateExpression(updateExpr, root.get(), _modOptions.collator, arrayFilters);
+            if (shapeCache) {
+                cacheUpdateShape(shapeCache, std::move(shapeKey), updateExpr, *root, _positional);
+            }
             _root = std::move(root);
             break;
         }
@@ -41,8 +41,10 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/update_index_data.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -139,6 +141,39 @@ TEST(Parse, SetOnInsert) {
     ASSERT_FALSE(driver.isDocReplacement());
 }
 
+TEST(Parse, RepeatedUpdateShapeIsBoundToNewValues) {
+    const auto oldVersion = serverGlobalParams.featureCompatibility.version.load();
+    serverGlobalParams.featureCompatibility.version.store(
+        ServerGlobalParams::FeatureCompatibility::Version::k36);
+    ON_BLOCK_EXIT(
+        [oldVersion] { serverGlobalParams.featureCompatibility.version.store(oldVersion); });
+
+    // Parsed update shapes are cached on the current client.
+    QueryTestServiceContext serviceContext;
+    Client::setCurrent(serviceContext.getServiceContext()->makeClient("UpdateDriverTest"));
+    ON_BLOCK_EXIT([] { Client::releaseCurrent(); });
+
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    FieldRefSet immutablePaths;
+    for (int i = 0; i < 3; ++i) {
+        UpdateDriver driver(UpdateDriver::Options{});
+        BSONObj updateExpr = BSON("$set" << BSON("a.b" << i) << "$inc" << BSON("c" << i));
+        ASSERT_OK(driver.parse(updateExpr, arrayFilters));
+        ASSERT_FALSE(driver.needMatchDetails());
+
+        mutablebson::Document doc(fromjson("{a: {b: -1}, c: 10}"));
+        ASSERT_OK(driver.update(StringData(), doc.getObject(), &doc, false, immutablePaths));
+        ASSERT_BSONOBJ_EQ(BSON("a" << BSON("b" << i) << "c" << 10 + i), doc.getObject());
+    }
+
+    // The values of an update with a cached shape are still validated.
+    UpdateDriver driver(UpdateDriver::Options{});
+    ASSERT_THROWS_CODE(
+        driver.parse(BSON("$set" << BSON("a.b" << 1) << "$inc" << BSON("c" << "x")), arrayFilters),
+        AssertionException,
+        ErrorCodes::TypeMismatch);
+}
+
 TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     BSONObj updateDocument = fromjson("{$max: {a: 'abd'}}");
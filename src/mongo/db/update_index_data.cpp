@@ -36,15 +36,51 @@ namespace mongo {
 
 using std::string;
 
-UpdateIndexData::UpdateIndexData() : _allPathsIndexed(false) {}
+namespace {
+
+/**
+ * Calls 'callback' with each component of the dotted 'path', in order, until it returns false.
+ * Unlike FieldRef, empty components are reported, so that the components of two paths compare
+ * equal exactly when the paths do.
+ */
+template <typename Callback>
+void forEachPathComponent(StringData path, Callback callback) {
+    size_t start = 0;
+    while (true) {
+        const size_t dot = path.find('.', start);
+        if (dot == string::npos) {
+            callback(path.substr(start));
+            return;
+        }
+        if (!callback(path.substr(start, dot - start)))
+            return;
+        start = dot + 1;
+    }
+}
+
+}  // namespace
+
+UpdateIndexData::UpdateIndexData() : _pathTrie(1), _allPathsIndexed(false) {}
 
 void UpdateIndexData::addPath(StringData path) {
     string s;
-    if (getCanonicalIndexField(path, &s)) {
-        _canonicalPaths.insert(s);
-    } else {
-        _canonicalPaths.insert(path.toString());
-    }
+    StringData canonicalPath = getCanonicalIndexField(path, &s) ? StringData(s) : path;
+
+    size_t node = 0;
+    forEachPathComponent(canonicalPath, [&](StringData component) {
+        auto child = _pathTrie[node].children.find(component);
+        if (child != _pathTrie[node].children.end()) {
+            node = child->second;
+        } else {
+            // Growing '_pathTrie' may move its nodes, so only hold on to indexes into it.
+            const size_t newNode = _pathTrie.size();
+            _pathTrie.emplace_back();
+            _pathTrie[node].children[component] = newNode;
+            node = newNode;
+        }
+        return true;
+    });
+    _pathTrie[node].isIndexedPath = true;
 }
 
 void UpdateIndexData::addPathComponent(StringData pathComponent) {
@@ -56,7 +92,7 @@ void UpdateIndexData::allPathsIndexed() {
 }
 
 void UpdateIndexData::clear() {
-    _canonicalPaths.clear();
+    _pathTrie.assign(1, PathNode());
     _pathComponents.clear();
     _allPathsIndexed = false;
 }
@@ -71,16 +107,26 @@ bool UpdateIndexData::mightBeIndexed(StringData path) const {
     if (getCanonicalIndexField(path, &x))
         use = StringData(x);
 
-    for (std::set<string>::const_iterator i = _canonicalPaths.begin(); i != _canonicalPaths.end();
-         ++i) {
-        StringData idx(*i);
-
-        if (_startsWith(use, idx))
-            return true;
+    // Walk the trie along 'use'. Either a registered path is a prefix of 'use', or 'use' ends
+    // within the trie and so is a prefix of a registered path.
+    size_t node = 0;
+    bool indexed = true;
+    forEachPathComponent(use, [&](StringData component) {
+        if (_pathTrie[node].isIndexedPath)
+            return false;
+        auto child = _pathTrie[node].children.find(component);
+        if (child == _pathTrie[node].children.end()) {
+            indexed = false;
+            return false;
+        }
+        node = child->second;
+        return true;
+    });
+    if (indexed)
+        return true;
 
-        if (_startsWith(idx, use))
-            return true;
-    }
+    if (_pathComponents.empty())
+        return false;
 
     FieldRef pathFieldRef(path);
     for (std::set<string>::const_iterator i = _pathComponents.begin(); i != _pathComponents.end();
@@ -96,18 +142,6 @@ bool UpdateIndexData::mightBeIndexed(StringData path) const {
     return false;
 }
 
-bool UpdateIndexData::_startsWith(StringData a, StringData b) const {
-    if (!a.startsWith(b))
-        return false;
-
-    // make sure there is a dot or EOL right after
-
-    if (a.size() == b.size())
-        return true;
-
-    return a[b.size()] == '.';
-}
-
 bool getCanonicalIndexField(StringData fullName, string* out) {
     // check if fieldName contains ".$" or ".###" substrings (#=digit) and skip them
     // however do not skip the first field even if it meets these criteria
@@ -31,8 +31,10 @@
 #pragma once
 
 #include <set>
+#include <vector>
 
 #include "mongo/base/string_data.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -71,12 +73,25 @@ public:
 
     void clear();
 
+    /**
+     * Returns whether an update of 'path' may change the index keys of a document. Takes time
+     * proportional to the length of 'path', regardless of how many paths are registered.
+     */
     bool mightBeIndexed(StringData path) const;
 
 private:
-    bool _startsWith(StringData a, StringData b) const;
+    /**
+     * A node of the trie of registered canonical paths, keyed by dotted path component. Every node
+     * lies on the way to at least one registered path.
+     */
+    struct PathNode {
+        StringMap<size_t> children;  // Indexes into '_pathTrie'.
+        bool isIndexedPath = false;
+    };
+
+    // The registered canonical paths. Element 0 is the root, which stands for the empty prefix.
+    std::vector<PathNode> _pathTrie;
 
-    std::set<std::string> _canonicalPaths;
     std::set<std::string> _pathComponents;
 
     bool _allPathsIndexed;
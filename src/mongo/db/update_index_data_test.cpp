@@ -58,6 +58,26 @@ TEST(UpdateIndexDataTest, Simple2) {
     ASSERT_FALSE(a.mightBeIndexed("ab"));
 }
 
+TEST(UpdateIndexDataTest, ManyPathsSharingPrefixes) {
+    UpdateIndexData a;
+    a.addPath("a.b.c");
+    a.addPath("a.b.d");
+    a.addPath("a.$.e");
+    a.addPath("x");
+    ASSERT_TRUE(a.mightBeIndexed("a"));
+    ASSERT_TRUE(a.mightBeIndexed("a.b"));
+    ASSERT_TRUE(a.mightBeIndexed("a.b.d.f"));
+    ASSERT_TRUE(a.mightBeIndexed("a.e"));
+    ASSERT_TRUE(a.mightBeIndexed("a.3.e"));
+    ASSERT_TRUE(a.mightBeIndexed("x.y"));
+
+    ASSERT_FALSE(a.mightBeIndexed("a.b.x"));
+    ASSERT_FALSE(a.mightBeIndexed("a.f"));
+    ASSERT_FALSE(a.mightBeIndexed("b"));
+    ASSERT_FALSE(a.mightBeIndexed("xy"));
+    ASSERT_FALSE(a.mightBeIndexed("a.bc"));
+}
+
 TEST(UpdateIndexDataTest, Component1) {
     UpdateIndexData a;
     a.addPathComponent("a");
@@ -79,6 +79,7 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
 
     // Need to reload, first clear our cache.
     _viewMap.clear();
+    _resolvedViews.clear();
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -154,8 +155,10 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
+        this->_resolvedViews.clear();
         this->_viewGraphNeedsRefresh = true;
     });
 
@@ -307,6 +310,7 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
     ViewDefinition savedDefinition = *viewPtr;
     opCtx->recoveryUnit()->onRollback([this, opCtx, viewName, savedDefinition]() {
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
     });
 
     return _createOrUpdateView_inlock(
@@ -334,9 +338,11 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, opCtx, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -376,6 +382,24 @@ std::shared_ptr<ViewDefinition> ViewCatalog::lookup(OperationContext* opCtx, Str
 StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                                                   const NamespaceString& nss) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // An invalid catalog is reloaded by the first lookup below, which also empties the cache.
+    if (MONGO_likely(_valid.load())) {
+        auto it = _resolvedViews.find(nss.ns());
+        if (it != _resolvedViews.end()) {
+            return *it->second;
+        }
+    }
+
+    auto resolved = _resolveView_inlock(opCtx, nss);
+    if (resolved.isOK() && _valid.load() && _viewMap.find(nss.ns()) != _viewMap.end()) {
+        _resolvedViews[nss.ns()] = std::make_shared<const ResolvedView>(resolved.getValue());
+    }
+    return resolved;
+}
+
+StatusWith<ResolvedView> ViewCatalog::_resolveView_inlock(OperationContext* opCtx,
+                                                          const NamespaceString& nss) {
     const NamespaceString* resolvedNss = &nss;
     std::vector<BSONObj> resolvedPipeline;
     BSONObj collation;
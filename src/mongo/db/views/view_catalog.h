@@ -114,6 +114,8 @@ public:
      * Resolve the views on 'nss', transforming the pipeline appropriately. This function returns a
      * fully-resolved view definition containing the backing namespace, the resolved pipeline and
      * the collation to use for the operation.
+     *
+     * Resolutions are cached per view until the next change to any view in the catalog.
      */
     StatusWith<ResolvedView> resolveView(OperationContext* opCtx, const NamespaceString& nss);
 
@@ -156,6 +158,8 @@ private:
                                      const std::vector<NamespaceString>& refs);
 
     std::shared_ptr<ViewDefinition> _lookup_inlock(OperationContext* opCtx, StringData ns);
+    StatusWith<ResolvedView> _resolveView_inlock(OperationContext* opCtx,
+                                                 const NamespaceString& nss);
     Status _reloadIfNeeded_inlock(OperationContext* opCtx);
 
     void _requireValidCatalog_inlock(OperationContext* opCtx) {
@@ -165,6 +169,11 @@ private:
 
     stdx::mutex _mutex;  // Protects all members, except for _valid.
     ViewMap _viewMap;
+
+    // Fully resolved definitions of the views in '_viewMap', filled in on demand by resolveView.
+    // Resolving a view depends on every view along its chain, so any change to '_viewMap' clears
+    // the whole cache. Entries are only used while '_valid' is true.
+    StringMap<std::shared_ptr<const ResolvedView>> _resolvedViews;
     DurableViewCatalog* _durable;
     AtomicBool _valid;
     ViewGraph _viewGraph;
@@ -442,6 +442,48 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectlyExtractsDefaultCollation) {
                       expectedCollation.getValue()->getSpec().toBSON());
 }
 
+TEST_F(ViewCatalogFixture, ResolveViewReflectsModificationOfUnderlyingView) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString viewOn("db.coll");
+    const NamespaceString otherViewOn("db.otherColl");
+    BSONArrayBuilder pipeline1;
+    BSONArrayBuilder pipeline2;
+    BSONArrayBuilder modifiedPipeline1;
+
+    pipeline1 << BSON("$match" << BSON("foo" << 1));
+    pipeline2 << BSON("$match" << BSON("foo" << 2));
+    modifiedPipeline1 << BSON("$match" << BSON("foo" << 3));
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view1, viewOn, pipeline1.arr(), emptyCollation));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view2, view1, pipeline2.arr(), emptyCollation));
+
+    // Resolve twice so that the second resolution may be served from the cache.
+    for (int i = 0; i < 2; i++) {
+        auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+        ASSERT_OK(resolvedView.getStatus());
+        ASSERT_EQ(resolvedView.getValue().getNamespace(), viewOn);
+        ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+        ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 1)),
+                          resolvedView.getValue().getPipeline()[0]);
+    }
+
+    ASSERT_OK(viewCatalog.modifyView(opCtx.get(), view1, otherViewOn, modifiedPipeline1.arr()));
+
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(resolvedView.getValue().getNamespace(), otherViewOn);
+    ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 3)), resolvedView.getValue().getPipeline()[0]);
+
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), view1));
+
+    resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(resolvedView.getValue().getNamespace(), view1);
+    ASSERT_EQ(1U, resolvedView.getValue().getPipeline().size());
+}
+
 TEST_F(ViewCatalogFixture, InvalidateThenReload) {
     const NamespaceString viewName("db.view");
     const NamespaceString viewOn("db.coll");
@@ -0,0 +1,148 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/views/view_result_cache.h"
+
+#include <algorithm>
+#include <set>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/views/resolved_view.h"
+
+namespace mongo {
+
+namespace {
+const auto getViewResultCache = ServiceContext::declareDecoration<ViewResultCache>();
+
+// Stages whose output is a function of their input alone.
+const std::set<StringData> kCacheableStages = {"$match",
+                                                "$project",
+                                                "$addFields",
+                                                "$group",
+                                                "$sort",
+                                                "$limit",
+                                                "$skip",
+                                                "$unwind",
+                                                "$replaceRoot"};
+}  // namespace
+
+ViewResultCache* ViewResultCache::get(ServiceContext* serviceContext) {
+    return &getViewResultCache(serviceContext);
+}
+
+bool ViewResultCache::isCacheable(const ResolvedView& view) {
+    // A view with no stages would just be a copy of its collection.
+    return !view.getPipeline().empty() && std::all_of(
+        view.getPipeline().begin(), view.getPipeline().end(), [](const BSONObj& stage) {
+            return stage.nFields() == 1 &&
+                kCacheableStages.count(stage.firstElement().fieldNameStringData()) > 0;
+        });
+}
+
+std::string ViewResultCache::makeKey(const ResolvedView& view) {
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("viewOn", view.getNamespace().ns());
+    keyBuilder.append("pipeline", view.getPipeline());
+    keyBuilder.append("collation", view.getDefaultCollation());
+    BSONObj key = keyBuilder.obj();
+    return std::string(key.objdata(), key.objsize());
+}
+
+size_t ViewResultCache::getApproximateSize(const std::vector<BSONObj>& results) {
+    size_t sizeBytes = sizeof(results) + results.capacity() * sizeof(BSONObj);
+    for (auto&& result : results) {
+        sizeBytes += result.objsize();
+    }
+    return sizeBytes;
+}
+
+ViewResultCache::Results ViewResultCache::find(const ResolvedView& view,
+                                               Date_t now,
+                                               Milliseconds maxStaleness) const {
+    const auto key = makeKey(view);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _results.find(key);
+    if (it == _results.end() || now - it->second.computedAt > maxStaleness) {
+        return nullptr;
+    }
+    return it->second.results;
+}
+
+void ViewResultCache::insert(const ResolvedView& view,
+                             Results results,
+                             Date_t computedAt,
+                             size_t maxSizeBytes) {
+    const size_t resultsSizeBytes = getApproximateSize(*results);
+    if (resultsSizeBytes > maxSizeBytes) {
+        return;
+    }
+
+    const auto key = makeKey(view);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _results.find(key);
+    if (it != _results.end()) {
+        if (it->second.computedAt >= computedAt) {
+            // Another reader got here first with results which are at least as fresh.
+            return;
+        }
+        _sizeBytes -= it->second.sizeBytes;
+        _results.erase(it);
+    }
+    _results.emplace(key, CachedResults{std::move(results), computedAt, resultsSizeBytes});
+    _sizeBytes += resultsSizeBytes;
+
+    while (_sizeBytes > maxSizeBytes) {
+        auto oldest = std::min_element(
+            _results.begin(), _results.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.second.computedAt < rhs.second.computedAt;
+            });
+        _sizeBytes -= oldest->second.sizeBytes;
+        _results.erase(oldest);
+    }
+}
+
+void ViewResultCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _results.clear();
+    _sizeBytes = 0;
+}
+
+size_t ViewResultCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _results.size();
+}
+
+size_t ViewResultCache::sizeBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+}  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ResolvedView;
+class ServiceContext;
+
+/**
+ * A process-wide cache of the results of view pipelines, so that a view which is read much more
+ * often than its underlying collection changes need not re-run its pipeline on every read. Cached
+ * results are never updated: they are only served while they are younger than the staleness
+ * bound the reader asks for, and are recomputed from scratch once they are too old.
+ *
+ * Results are identified by the fully resolved view definition, so redefining a view never serves
+ * results computed for its old definition. The cache is bounded by the total size of the results
+ * it holds; once full, the oldest results are evicted first. This class is thread-safe.
+ */
+class ViewResultCache {
+    MONGO_DISALLOW_COPYING(ViewResultCache);
+
+public:
+    using Results = std::shared_ptr<const std::vector<BSONObj>>;
+
+    ViewResultCache() = default;
+
+    static ViewResultCache* get(ServiceContext* serviceContext);
+
+    /**
+     * Returns whether the results of 'view' may be cached. Only pipelines made of stages whose
+     * output depends on nothing but the contents of the underlying collection are cacheable.
+     */
+    static bool isCacheable(const ResolvedView& view);
+
+    /**
+     * Returns the results cached for 'view' if they were computed no more than 'maxStaleness'
+     * before 'now', or nullptr otherwise.
+     */
+    Results find(const ResolvedView& view, Date_t now, Milliseconds maxStaleness) const;
+
+    /**
+     * Caches 'results' as the results of 'view' as of 'computedAt', replacing any older results,
+     * and evicts the oldest results until the cache holds no more than 'maxSizeBytes'.
+     */
+    void insert(const ResolvedView& view,
+                Results results,
+                Date_t computedAt,
+                size_t maxSizeBytes);
+
+    /**
+     * Removes all results from the cache.
+     */
+    void clear();
+
+    size_t size() const;
+
+    size_t sizeBytes() const;
+
+    /**
+     * Returns the number of bytes 'results' takes up for the purposes of the cache's size bound.
+     */
+    static size_t getApproximateSize(const std::vector<BSONObj>& results);
+
+private:
+    struct CachedResults {
+        Results results;
+        Date_t computedAt;
+        size_t sizeBytes;
+    };
+
+    static std::string makeKey(const ResolvedView& view);
+
+    mutable stdx::mutex _mutex;
+    std::map<std::string, CachedResults> _results;
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,160 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/views/view_result_cache.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/views/resolved_view.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString backingNss("testdb.testcoll");
+const BSONObj kSimpleCollation;
+
+ResolvedView makeView(std::vector<BSONObj> pipeline, BSONObj collation = kSimpleCollation) {
+    return ResolvedView{backingNss, std::move(pipeline), std::move(collation)};
+}
+
+ViewResultCache::Results makeResults(std::vector<BSONObj> docs) {
+    return std::make_shared<const std::vector<BSONObj>>(std::move(docs));
+}
+
+const size_t kUnlimited = 1024 * 1024;
+
+TEST(ViewResultCacheTest, ViewsOfDeterministicStagesAreCacheable) {
+    ASSERT_TRUE(ViewResultCache::isCacheable(makeView({BSON("$match" << BSON("a" << 1)),
+                                                       BSON("$group" << BSON("_id"
+                                                                             << "$b")),
+                                                       BSON("$limit" << 3)})));
+}
+
+TEST(ViewResultCacheTest, ViewsWithOtherStagesAreNotCacheable) {
+    ASSERT_FALSE(ViewResultCache::isCacheable(makeView({})));
+    ASSERT_FALSE(ViewResultCache::isCacheable(
+        makeView({BSON("$match" << BSON("a" << 1)), BSON("$sample" << BSON("size" << 3))})));
+    ASSERT_FALSE(ViewResultCache::isCacheable(makeView(
+        {BSON("$lookup" << BSON("from" << "other" << "localField" << "a" << "foreignField" << "b"
+                                       << "as" << "c"))})));
+}
+
+TEST(ViewResultCacheTest, FindReturnsResultsWithinStalenessBound) {
+    ViewResultCache cache;
+    auto view = makeView({BSON("$match" << BSON("a" << 1))});
+    auto results = makeResults({BSON("_id" << 1 << "a" << 1)});
+    const Date_t computedAt = Date_t::fromMillisSinceEpoch(1000);
+
+    cache.insert(view, results, computedAt, kUnlimited);
+    ASSERT_EQ(1U, cache.size());
+    ASSERT_EQ(results, cache.find(view, computedAt + Milliseconds(50), Milliseconds(100)));
+    ASSERT_EQ(results, cache.find(view, computedAt + Milliseconds(100), Milliseconds(100)));
+    ASSERT_FALSE(cache.find(view, computedAt + Milliseconds(101), Milliseconds(100)));
+}
+
+TEST(ViewResultCacheTest, ResultsAreKeyedByTheWholeViewDefinition) {
+    ViewResultCache cache;
+    auto view = makeView({BSON("$match" << BSON("a" << 1))});
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+    cache.insert(view, makeResults({BSON("_id" << 1)}), now, kUnlimited);
+
+    ASSERT_FALSE(cache.find(makeView({BSON("$match" << BSON("a" << 2))}), now, Milliseconds(100)));
+    ASSERT_FALSE(cache.find(makeView({BSON("$match" << BSON("a" << 1))}, BSON("locale" << "fr")),
+                            now,
+                            Milliseconds(100)));
+    ASSERT_TRUE(cache.find(makeView({BSON("$match" << BSON("a" << 1))}), now, Milliseconds(100)));
+}
+
+TEST(ViewResultCacheTest, InsertKeepsFresherResults) {
+    ViewResultCache cache;
+    auto view = makeView({BSON("$match" << BSON("a" << 1))});
+    auto older = makeResults({BSON("_id" << 1)});
+    auto newer = makeResults({BSON("_id" << 2)});
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+    cache.insert(view, newer, now, kUnlimited);
+    cache.insert(view, older, now - Milliseconds(10), kUnlimited);
+    ASSERT_EQ(newer, cache.find(view, now, Milliseconds(100)));
+
+    auto newest = makeResults({BSON("_id" << 3)});
+    cache.insert(view, newest, now + Milliseconds(10), kUnlimited);
+    ASSERT_EQ(newest, cache.find(view, now + Milliseconds(10), Milliseconds(100)));
+    ASSERT_EQ(1U, cache.size());
+    ASSERT_EQ(ViewResultCache::getApproximateSize(*newest), cache.sizeBytes());
+}
+
+TEST(ViewResultCacheTest, InsertEvictsOldestResultsWhenFull) {
+    ViewResultCache cache;
+    auto first = makeView({BSON("$skip" << 1)});
+    auto second = makeView({BSON("$skip" << 2)});
+    auto third = makeView({BSON("$skip" << 3)});
+    auto results = makeResults({BSON("_id" << 1)});
+    const size_t maxSizeBytes = 2 * ViewResultCache::getApproximateSize(*results);
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+    cache.insert(second, results, now + Milliseconds(1), maxSizeBytes);
+    cache.insert(first, results, now, maxSizeBytes);
+    cache.insert(third, results, now + Milliseconds(2), maxSizeBytes);
+
+    ASSERT_EQ(2U, cache.size());
+    ASSERT_LTE(cache.sizeBytes(), maxSizeBytes);
+    ASSERT_FALSE(cache.find(first, now + Milliseconds(2), Milliseconds(100)));
+    ASSERT_TRUE(cache.find(second, now + Milliseconds(2), Milliseconds(100)));
+    ASSERT_TRUE(cache.find(third, now + Milliseconds(2), Milliseconds(100)));
+}
+
+TEST(ViewResultCacheTest, ResultsLargerThanTheCacheAreNotCached) {
+    ViewResultCache cache;
+    auto view = makeView({BSON("$skip" << 1)});
+    auto results = makeResults({BSON("_id" << 1)});
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+    cache.insert(view, results, now, ViewResultCache::getApproximateSize(*results) - 1);
+    ASSERT_EQ(0U, cache.size());
+    ASSERT_EQ(0U, cache.sizeBytes());
+}
+
+TEST(ViewResultCacheTest, ClearRemovesAllResults) {
+    ViewResultCache cache;
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+    cache.insert(makeView({BSON("$skip" << 1)}), makeResults({BSON("_id" << 1)}), now, kUnlimited);
+    cache.insert(makeView({BSON("$skip" << 2)}), makeResults({BSON("_id" << 1)}), now, kUnlimited);
+
+    cache.clear();
+    ASSERT_EQ(0U, cache.size());
+    ASSERT_EQ(0U, cache.sizeBytes());
+}
+
+}  // namespace
+}  // namespace mongo
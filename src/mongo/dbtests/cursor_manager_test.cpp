@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include <algorithm>
+#include <set>
 
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
@@ -298,6 +299,29 @@ TEST_F(CursorManagerTest, InactiveCursorShouldTimeout) {
     ASSERT_EQ(0UL, cursorManager->numCursors());
 }
 
+/**
+ * Test that cursors registered across all partitions get distinct ids and are all timed out.
+ */
+TEST_F(CursorManagerTest, InactiveCursorsInAllPartitionsShouldTimeout) {
+    CursorManager* cursorManager = useCursorManager();
+    auto clock = useClock();
+
+    const size_t numCursors = 200;
+    std::set<CursorId> cursorIds;
+    for (size_t i = 0; i < numCursors; ++i) {
+        auto pin = cursorManager->registerCursor(
+            _opCtx.get(),
+            {makeFakePlanExecutor(), NamespaceString{"test.collection"}, {}, false, BSONObj()});
+        cursorIds.insert(pin.getCursor()->cursorid());
+    }
+    ASSERT_EQ(numCursors, cursorIds.size());
+    ASSERT_EQ(numCursors, cursorManager->numCursors());
+
+    clock->advance(getDefaultCursorTimeoutMillis());
+    ASSERT_EQ(numCursors, cursorManager->timeoutCursors(_opCtx.get(), clock->now()));
+    ASSERT_EQ(0UL, cursorManager->numCursors());
+}
+
 /**
  * Test that pinned cursors do not get timed out.
  */
@@ -185,6 +185,24 @@ TEST_F(DocumentSourceCursorTest, IterateDispose) {
     ASSERT(source()->getNext().isEOF());
 }
 
+/** Iterate a DocumentSourceCursor which only needs to produce some of the fields. */
+TEST_F(DocumentSourceCursorTest, IterateWithDependencies) {
+    client.insert(nss.ns(), BSON("_id" << 1 << "a" << 1 << "b" << 1));
+    client.insert(nss.ns(), BSON("_id" << 2 << "a" << 2 << "b" << 2));
+    createSource();
+    DepsTracker deps;
+    deps.fields.insert("a");
+    source()->setProjection(BSONObj(), deps.toParsedDeps());
+    // Only the needed fields are materialized in the results.
+    for (int i = 1; i <= 2; ++i) {
+        auto next = source()->getNext();
+        ASSERT(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.getDocument(), (Document{{"a", i}}));
+    }
+    // There are no more results.
+    ASSERT(source()->getNext().isEOF());
+}
+
 /** Set a value or await an expected value. */
 class PendingValue {
 public:
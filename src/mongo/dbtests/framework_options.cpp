@@ -101,6 +101,11 @@ Status addTestFrameworkOptions(moe::OptionSection* options) {
     options->addOptionChaining(
         "perfHist", "perfHist", moe::Unsigned, "number of back runs of perf stats to display");
 
+    options->addOptionChaining("benchmark",
+                               "benchmark",
+                               moe::Switch,
+                               "run benchmark suites at full size instead of as quick checks");
+
     options
         ->addOptionChaining(
             "storage.engine", "storageEngine", moe::String, "what storage engine to use")
@@ -162,6 +167,10 @@ Status storeTestFrameworkOptions(const moe::Environment& params,
         frameworkGlobalParams.perfHist = params["perfHist"].as<unsigned>();
     }
 
+    if (params.count("benchmark")) {
+        frameworkGlobalParams.runBenchmarks = true;
+    }
+
     bool nodur = false;
     if (params.count("nodur")) {
         nodur = true;
@@ -49,6 +49,7 @@ struct FrameworkGlobalParams {
     std::string dbpathSpec;
     std::vector<std::string> suites;
     std::string filter;
+    bool runBenchmarks = false;
 };
 
 extern FrameworkGlobalParams frameworkGlobalParams;
@@ -0,0 +1,342 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Benchmarks of query stage trees run against real collections. Every workload runs over a matrix
+ * of collection sizes, selectivities and document widths and logs the nanoseconds and the heap
+ * allocations per collection document it took. Without --benchmark each workload only runs once
+ * over a small collection, as a check that it still works.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/and_hash.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/sort.h"
+#include "mongo/db/exec/sort_key_generator.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/dbtests/framework_options.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/allocation_counter.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
+
+namespace QueryStageBenchmarks {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+const NamespaceString nss("unittests.QueryStageBenchmarks");
+
+// Each workload runs this many times per set of parameters, and the fastest run is reported.
+const int kBenchmarkRuns = 3;
+
+struct WorkloadParams {
+    int numDocs;
+
+    // The fraction of the documents the predicates of the workload select.
+    double selectivity;
+
+    // The size of the unindexed string padding every document.
+    int paddingBytes;
+};
+
+std::vector<WorkloadParams> workloadParams() {
+    if (!frameworkGlobalParams.runBenchmarks) {
+        return {{100, 0.1, 16}};
+    }
+
+    std::vector<WorkloadParams> params;
+    for (int numDocs : {10 * 1000, 100 * 1000}) {
+        for (double selectivity : {0.01, 0.1, 1.0}) {
+            for (int paddingBytes : {16, 1024}) {
+                params.push_back({numDocs, selectivity, paddingBytes});
+            }
+        }
+    }
+    return params;
+}
+
+/**
+ * The collection holds documents {_id: i, a: i, b: <a permutation of i>, pad: <string>} for i in
+ * [0, numDocs), indexed on 'a' and on 'b'. Workloads select documents with {a: {$lt: limit}} and
+ * {b: {$lt: limit}}, where limit is numDocs * selectivity.
+ */
+class QueryStageBenchmarkBase {
+public:
+    QueryStageBenchmarkBase() : _client(&_opCtx) {}
+
+    virtual ~QueryStageBenchmarkBase() {
+        _client.dropCollection(nss.ns());
+    }
+
+    void run() {
+        for (auto&& params : workloadParams()) {
+            load(params);
+            measure(params);
+        }
+    }
+
+protected:
+    virtual std::string name() const = 0;
+
+    /**
+     * Returns the root of the stage tree of the workload, which uses 'ws'.
+     */
+    virtual unique_ptr<PlanStage> makeStages(const WorkloadParams& params,
+                                             Collection* coll,
+                                             WorkingSet* ws) = 0;
+
+    /**
+     * Returns the number of results the workload should return.
+     */
+    virtual long long expectedResults(const WorkloadParams& params) const {
+        return limit(params);
+    }
+
+    static long long limit(const WorkloadParams& params) {
+        return static_cast<long long>(params.numDocs * params.selectivity);
+    }
+
+    static long long permuted(long long i, const WorkloadParams& params) {
+        // 7919 is a prime that divides none of the collection sizes, so this is a permutation.
+        return (i * 7919) % params.numDocs;
+    }
+
+    IndexDescriptor* getIndex(const BSONObj& keyPattern, Collection* coll) {
+        std::vector<IndexDescriptor*> indexes;
+        coll->getIndexCatalog()->findIndexesByKeyPattern(&_opCtx, keyPattern, false, &indexes);
+        ASSERT_FALSE(indexes.empty());
+        return indexes[0];
+    }
+
+    /**
+     * Returns a scan of the index on 'field' for the documents the workload selects.
+     */
+    unique_ptr<PlanStage> makeIndexScan(StringData field,
+                                        const WorkloadParams& params,
+                                        Collection* coll,
+                                        WorkingSet* ws) {
+        IndexScanParams scanParams;
+        scanParams.descriptor = getIndex(BSON(field << 1), coll);
+        scanParams.bounds.isSimpleRange = true;
+        scanParams.bounds.startKey = BSON("" << 0);
+        scanParams.bounds.endKey = BSON("" << limit(params));
+        scanParams.bounds.boundInclusion = BoundInclusion::kIncludeStartKeyOnly;
+        return make_unique<IndexScan>(&_opCtx, scanParams, ws, nullptr);
+    }
+
+    /**
+     * Returns a match expression for the documents the workload selects on 'field', which lives
+     * as long as the fixture.
+     */
+    const MatchExpression* makeFilter(StringData field, const WorkloadParams& params) {
+        _filterObj = BSON(field << BSON("$lt" << limit(params)));
+        auto swMatcher = MatchExpressionParser::parse(_filterObj, nullptr);
+        ASSERT_OK(swMatcher.getStatus());
+        _filter = std::move(swMatcher.getValue());
+        return _filter.get();
+    }
+
+    const ServiceContext::UniqueOperationContext _txnPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_txnPtr;
+
+private:
+    void load(const WorkloadParams& params) {
+        _client.dropCollection(nss.ns());
+
+        const std::string padding(params.paddingBytes, 'x');
+        std::vector<BSONObj> batch;
+        for (int i = 0; i < params.numDocs; ++i) {
+            batch.push_back(BSON("_id" << i << "a" << i << "b" << permuted(i, params) << "pad"
+                                       << padding));
+            if (batch.size() == 1000 || i == params.numDocs - 1) {
+                _client.insert(nss.ns(), batch);
+                batch.clear();
+            }
+        }
+
+        ASSERT_OK(dbtests::createIndex(&_opCtx, nss.ns(), BSON("a" << 1)));
+        ASSERT_OK(dbtests::createIndex(&_opCtx, nss.ns(), BSON("b" << 1)));
+    }
+
+    void measure(const WorkloadParams& params) {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        Collection* coll = ctx.getCollection();
+        ASSERT(coll);
+
+        const int runs = frameworkGlobalParams.runBenchmarks ? kBenchmarkRuns : 1;
+        long long bestMicros = std::numeric_limits<long long>::max();
+        long long allocations = 0;
+        for (int run = 0; run < runs; ++run) {
+            auto ws = make_unique<WorkingSet>();
+            auto root = makeStages(params, coll, ws.get());
+            auto exec = uassertStatusOK(PlanExecutor::make(
+                &_opCtx, std::move(ws), std::move(root), coll, PlanExecutor::NO_YIELD));
+
+            const long long allocationsBefore = allocation_counter::getThreadAllocationCount();
+            Timer timer;
+            long long results = 0;
+            PlanExecutor::ExecState state;
+            for (BSONObj obj; PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr));) {
+                ++results;
+            }
+            const long long micros = timer.micros();
+            const long long runAllocations =
+                allocation_counter::getThreadAllocationCount() - allocationsBefore;
+
+            ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+            ASSERT_EQUALS(expectedResults(params), results);
+
+            if (micros < bestMicros) {
+                bestMicros = micros;
+                allocations = runAllocations;
+            }
+        }
+
+        BSONObjBuilder report;
+        report.append("workload", name());
+        report.append("numDocs", params.numDocs);
+        report.append("selectivity", params.selectivity);
+        report.append("paddingBytes", params.paddingBytes);
+        report.append("nanosPerDoc", bestMicros * 1000.0 / params.numDocs);
+        if (allocation_counter::isSupported()) {
+            report.append("allocationsPerDoc",
+                          static_cast<double>(allocations) / params.numDocs);
+        }
+        unittest::log() << "query stage benchmark: " << report.obj();
+    }
+
+    DBDirectClient _client;
+    BSONObj _filterObj;
+    unique_ptr<MatchExpression> _filter;
+};
+
+class CollectionScanWithFilter : public QueryStageBenchmarkBase {
+    std::string name() const final {
+        return "collscanFilter";
+    }
+
+    unique_ptr<PlanStage> makeStages(const WorkloadParams& params,
+                                     Collection* coll,
+                                     WorkingSet* ws) final {
+        CollectionScanParams scanParams;
+        scanParams.collection = coll;
+        return make_unique<CollectionScan>(&_opCtx, scanParams, ws, makeFilter("a", params));
+    }
+};
+
+class IndexScanAndFetch : public QueryStageBenchmarkBase {
+    std::string name() const final {
+        return "ixscanFetch";
+    }
+
+    unique_ptr<PlanStage> makeStages(const WorkloadParams& params,
+                                     Collection* coll,
+                                     WorkingSet* ws) final {
+        auto ixscan = makeIndexScan("a", params, coll, ws);
+        return make_unique<FetchStage>(&_opCtx, ws, ixscan.release(), nullptr, coll);
+    }
+};
+
+class BlockingSort : public QueryStageBenchmarkBase {
+    std::string name() const final {
+        return "collscanSort";
+    }
+
+    unique_ptr<PlanStage> makeStages(const WorkloadParams& params,
+                                     Collection* coll,
+                                     WorkingSet* ws) final {
+        CollectionScanParams scanParams;
+        scanParams.collection = coll;
+        auto collscan =
+            make_unique<CollectionScan>(&_opCtx, scanParams, ws, makeFilter("a", params));
+
+        SortStageParams sortParams;
+        sortParams.collection = coll;
+        sortParams.pattern = BSON("b" << 1);
+        sortParams.allowDiskUse = true;
+        auto keyGen = make_unique<SortKeyGeneratorStage>(
+            &_opCtx, collscan.release(), ws, sortParams.pattern, nullptr);
+        return make_unique<SortStage>(&_opCtx, sortParams, ws, keyGen.release());
+    }
+};
+
+class IndexIntersection : public QueryStageBenchmarkBase {
+    std::string name() const final {
+        return "andHash";
+    }
+
+    unique_ptr<PlanStage> makeStages(const WorkloadParams& params,
+                                     Collection* coll,
+                                     WorkingSet* ws) final {
+        auto andHash = make_unique<AndHashStage>(&_opCtx, ws, coll);
+        andHash->addChild(makeIndexScan("a", params, coll, ws).release());
+        andHash->addChild(makeIndexScan("b", params, coll, ws).release());
+        return make_unique<FetchStage>(&_opCtx, ws, andHash.release(), nullptr, coll);
+    }
+
+    long long expectedResults(const WorkloadParams& params) const final {
+        long long expected = 0;
+        for (long long i = 0; i < limit(params); ++i) {
+            if (permuted(i, params) < limit(params)) {
+                ++expected;
+            }
+        }
+        return expected;
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("query_stage_benchmarks") {}
+
+    void setupTests() {
+        add<CollectionScanWithFilter>();
+        add<IndexScanAndFetch>();
+        add<BlockingSort>();
+        add<IndexIntersection>();
+    }
+};
+
+SuiteInstance<All> queryStageBenchmarks;
+
+}  // namespace QueryStageBenchmarks
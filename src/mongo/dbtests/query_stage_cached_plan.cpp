@@ -142,8 +142,14 @@ public:
 
         // High enough so that we shouldn't trigger a replan based on works.
         const size_t decisionWorks = 50;
-        CachedPlanStage cachedPlanStage(
-            &_opCtx, collection, &_ws, cq.get(), plannerParams, decisionWorks, mockChild.release());
+        CachedPlanStage cachedPlanStage(&_opCtx,
+                                        collection,
+                                        &_ws,
+                                        cq.get(),
+                                        plannerParams,
+                                        decisionWorks,
+                                        true,
+                                        mockChild.release());
 
         // This should succeed after triggering a replan.
         PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD,
@@ -213,8 +219,14 @@ public:
             mockChild->pushBack(PlanStage::NEED_TIME);
         }
 
-        CachedPlanStage cachedPlanStage(
-            &_opCtx, collection, &_ws, cq.get(), plannerParams, decisionWorks, mockChild.release());
+        CachedPlanStage cachedPlanStage(&_opCtx,
+                                        collection,
+                                        &_ws,
+                                        cq.get(),
+                                        plannerParams,
+                                        decisionWorks,
+                                        true,
+                                        mockChild.release());
 
         // This should succeed after triggering a replan.
         PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD,
@@ -247,6 +259,96 @@ public:
     }
 };
 
+/**
+ * Test that a cached plan which stops producing results after its trial period has its cache
+ * entry evicted, and that it still runs to completion.
+ */
+class QueryStageCachedPlanEvictDuringExecution : public QueryStageCachedPlanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        ASSERT(collection);
+
+        auto makeQuery = [&] {
+            // Query can be answered by either index on "a" or index on "b". The limit ends the
+            // cached plan's trial period after a single result.
+            auto qr = stdx::make_unique<QueryRequest>(nss);
+            qr->setFilter(fromjson("{a: {$gte: 8}, b: 1}"));
+            qr->setLimit(1);
+            auto statusWithCQ = CanonicalQuery::canonicalize(opCtx(), std::move(qr));
+            ASSERT_OK(statusWithCQ.getStatus());
+            return std::move(statusWithCQ.getValue());
+        };
+        const std::unique_ptr<CanonicalQuery> cq = makeQuery();
+
+        // Running the query through the multi-planner creates a plan cache entry.
+        PlanCache* cache = collection->infoCache()->getPlanCache();
+        ASSERT(cache);
+        auto exec = uassertStatusOK(
+            getExecutor(&_opCtx, collection, makeQuery(), PlanExecutor::NO_YIELD));
+        ASSERT_OK(exec->executePlan());
+        ASSERT(cache->contains(*cq));
+
+        // Get planner params.
+        QueryPlannerParams plannerParams;
+        fillOutPlannerParams(&_opCtx, collection, cq.get(), &plannerParams);
+
+        // The mock plan produces a result during the trial period, then stalls for more work
+        // cycles than the eviction threshold allows before producing another.
+        const size_t decisionWorks = 10;
+        const size_t stallWorks =
+            1U + static_cast<size_t>(internalQueryCacheEvictionRatio * decisionWorks);
+        auto mockChild = stdx::make_unique<QueuedDataStage>(&_opCtx, &_ws);
+        for (int i = 0; i < 2; ++i) {
+            WorkingSetID id = _ws.allocate();
+            WorkingSetMember* member = _ws.get(id);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << 9 << "b" << 1));
+            member->transitionToOwnedObj();
+            mockChild->pushBack(id);
+
+            for (size_t j = 0; i == 0 && j < stallWorks; ++j) {
+                mockChild->pushBack(PlanStage::NEED_TIME);
+            }
+        }
+
+        CachedPlanStage cachedPlanStage(&_opCtx,
+                                        collection,
+                                        &_ws,
+                                        cq.get(),
+                                        plannerParams,
+                                        decisionWorks,
+                                        true,
+                                        mockChild.release());
+
+        PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD,
+                                    _opCtx.getServiceContext()->getFastClockSource());
+        ASSERT_OK(cachedPlanStage.pickBestPlan(&yieldPolicy));
+        ASSERT(cache->contains(*cq));
+
+        // The cached plan is not replanned, and returns both of its results.
+        size_t numResults = 0;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (state != PlanStage::IS_EOF) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            state = cachedPlanStage.work(&id);
+
+            ASSERT_NE(state, PlanStage::FAILURE);
+            ASSERT_NE(state, PlanStage::DEAD);
+
+            if (state == PlanStage::ADVANCED) {
+                numResults++;
+            }
+        }
+        ASSERT_EQ(numResults, 2U);
+
+        auto stats = static_cast<const CachedPlanStats*>(cachedPlanStage.getSpecificStats());
+        ASSERT_FALSE(stats->replanned);
+        ASSERT_TRUE(stats->evictedDuringExecution);
+        ASSERT_FALSE(cache->contains(*cq));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_cached_plan") {}
@@ -254,6 +356,7 @@ public:
     void setupTests() {
         add<QueryStageCachedPlanFailure>();
         add<QueryStageCachedPlanHitMaxWorks>();
+        add<QueryStageCachedPlanEvictDuringExecution>();
     }
 };
 
@@ -44,10 +44,12 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageCollectionScan {
 
@@ -398,6 +400,127 @@ public:
     }
 };
 
+//
+// Scan in batches with a filter and make sure every matching object comes back exactly once, in
+// order.
+//
+
+class QueryStageCollscanWorkBatchWithMatch : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+
+        BSONObj filterObj = BSON("foo" << BSON("$gte" << 10));
+        const CollatorInterface* collator = nullptr;
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(filterObj, collator);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CollectionScan scan(&_opCtx, params, &ws, filterExpr.get());
+
+        int count = 0;
+        std::vector<WorkingSetID> results;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (PlanStage::IS_EOF != state) {
+            results.clear();
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            state = scan.workBatch(7, &results, &id);
+            ASSERT_LTE(results.size(), 7U);
+            for (auto&& result : results) {
+                WorkingSetMember* member = ws.get(result);
+                ASSERT_TRUE(member->hasObj());
+                ASSERT_EQUALS(10 + count, member->obj.value()["foo"].numberInt());
+                ++count;
+                ws.free(result);
+            }
+        }
+
+        ASSERT_EQUALS(numObj() - 10, count);
+        ASSERT_EQUALS(static_cast<size_t>(numObj() - 10), scan.getCommonStats()->advanced);
+    }
+};
+
+//
+// Make sure the PlanExecutor returns the same results when batched execution is enabled.
+//
+
+class QueryStageCollscanBatchedExecution : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        const int oldBatchSize = internalQueryExecBatchedWorkSize.load();
+        internalQueryExecBatchedWorkSize.store(16);
+        ON_BLOCK_EXIT([oldBatchSize] { internalQueryExecBatchedWorkSize.store(oldBatchSize); });
+
+        ASSERT_EQUALS(numObj(), countResults(CollectionScanParams::FORWARD, BSONObj()));
+        BSONObj obj = BSON("foo" << BSON("$lt" << 25));
+        ASSERT_EQUALS(25, countResults(CollectionScanParams::BACKWARD, obj));
+    }
+};
+
+//
+// Make sure a scan which evaluates its filter on several threads returns every matching object
+// exactly once, in order.
+//
+
+class QueryStageCollscanParallelFilter : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        const int oldParallelism = internalQueryExecCollectionScanParallelism.load();
+        const int oldBatchSize = internalQueryExecCollectionScanParallelBatchSize.load();
+        internalQueryExecCollectionScanParallelism.store(4);
+        internalQueryExecCollectionScanParallelBatchSize.store(16);
+        ON_BLOCK_EXIT([oldParallelism, oldBatchSize] {
+            internalQueryExecCollectionScanParallelism.store(oldParallelism);
+            internalQueryExecCollectionScanParallelBatchSize.store(oldBatchSize);
+        });
+
+        BSONObj obj = BSON("foo" << BSON("$mod" << BSON_ARRAY(3 << 0)));
+        ASSERT_EQUALS(17, countResults(CollectionScanParams::FORWARD, obj));
+        ASSERT_EQUALS(17, countResults(CollectionScanParams::BACKWARD, obj));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = CollectionScanParams::BACKWARD;
+        params.tailable = false;
+
+        BSONObj filterObj = BSON("foo" << BSON("$lt" << 40));
+        const CollatorInterface* collator = nullptr;
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(filterObj, collator);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CollectionScan scan(&_opCtx, params, &ws, filterExpr.get());
+
+        int expected = 39;
+        while (!scan.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = scan.work(&id);
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_TRUE(member->hasRecordId());
+                ASSERT_EQUALS(expected, member->obj.value()["foo"].numberInt());
+                --expected;
+                ws.free(id);
+            }
+        }
+
+        ASSERT_EQUALS(-1, expected);
+        auto stats = static_cast<const CollectionScanStats*>(scan.getSpecificStats());
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), stats->docsTested);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -412,6 +535,9 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanInvalidateUpcomingObject>();
         add<QueryStageCollscanInvalidateUpcomingObjectBackward>();
+        add<QueryStageCollscanWorkBatchWithMatch>();
+        add<QueryStageCollscanBatchedExecution>();
+        add<QueryStageCollscanParallelFilter>();
     }
 };
 
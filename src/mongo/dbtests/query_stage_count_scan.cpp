@@ -641,6 +641,44 @@ public:
     }
 };
 
+//
+// Check that a count over several disjoint intervals skips the keys between them
+//
+class QueryStageCountScanMultipleIntervals : public CountBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+
+        // Insert some docs
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("a" << i));
+        }
+
+        // Add an index
+        addIndex(BSON("a" << 1));
+
+        // Count {a: {$in: [1, 3]}} and {a: {$gte: 6, $lt: 8}} in a single scan
+        OrderedIntervalList oil("a");
+        oil.intervals.push_back(Interval(BSON("" << 1 << "" << 1), true, true));
+        oil.intervals.push_back(Interval(BSON("" << 3 << "" << 3), true, true));
+        oil.intervals.push_back(Interval(BSON("" << 6 << "" << 8), true, false));
+
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1));
+        params.bounds.fields.push_back(oil);
+
+        WorkingSet ws;
+        CountScan count(&_opCtx, params, &ws);
+
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(4, numCounted);
+
+        // The scan seeks past keys 0 and 5 and stops after examining 8, so 9 is never read.
+        const CountScanStats* stats = static_cast<const CountScanStats*>(count.getSpecificStats());
+        ASSERT_LT(stats->keysExamined, 10U);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_count_scan") {}
@@ -657,6 +695,7 @@ public:
         add<QueryStageCountScanInsertNewDocsDuringYield>();
         add<QueryStageCountScanBecomesMultiKeyDuringYield>();
         add<QueryStageCountScanUnusedKeys>();
+        add<QueryStageCountScanMultipleIntervals>();
     }
 };
 
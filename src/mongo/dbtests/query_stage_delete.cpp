@@ -188,6 +188,44 @@ public:
     }
 };
 
+/**
+ * Test that a multi delete with a limit stops after deleting that many documents.
+ */
+class QueryStageDeleteLimit : public QueryStageDeleteBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        Collection* coll = ctx.getCollection();
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        const long long limit = 7;
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.limit = limit;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_opCtx,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_opCtx, collScanParams, &ws, NULL));
+
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+        ASSERT_EQUALS(static_cast<size_t>(limit), stats->docsDeleted);
+        ASSERT_EQUALS(numObj() - limit, static_cast<size_t>(coll->numRecords(&_opCtx)));
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -312,6 +350,7 @@ public:
     void setupTests() {
         // Stage-specific tests below.
         add<QueryStageDeleteInvalidateUpcomingObject>();
+        add<QueryStageDeleteLimit>();
         add<QueryStageDeleteReturnOldDoc>();
         add<QueryStageDeleteSkipOwnedObjects>();
     }
@@ -110,12 +110,39 @@ protected:
     OperationContext* const _opCtx = _uniqOpCtx.get();
 };
 
+//
+// Check that a profiled tree times the sampled calls into every stage.
+//
+class QueryStageLimitSkipProfiling {
+public:
+    void run() {
+        WorkingSet ws;
+        auto child = getMS(_opCtx, &ws);
+        unique_ptr<PlanStage> skip = make_unique<SkipStage>(_opCtx, 10, &ws, child);
+
+        // Sample every other call to work().
+        skip->enableProfiling(2);
+        ASSERT_EQUALS(N - 10, countResults(skip.get()));
+
+        for (const CommonStats* stats : {skip->getCommonStats(), child->getCommonStats()}) {
+            ASSERT_GT(stats->works, 0U);
+            ASSERT_EQUALS(stats->works / 2, stats->profiledWorks);
+            ASSERT_GTE(stats->profiledTimeNanos, 0);
+        }
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _uniqOpCtx = cc().makeOperationContext();
+    OperationContext* const _opCtx = _uniqOpCtx.get();
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_limit_skip") {}
 
     void setupTests() {
         add<QueryStageLimitSkipBasicTest>();
+        add<QueryStageLimitSkipProfiling>();
     }
 };
 
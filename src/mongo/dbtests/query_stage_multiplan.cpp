@@ -54,6 +54,7 @@
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -417,6 +418,40 @@ TEST_F(QueryStageMultiPlanTest, MPSSummaryStats) {
     ASSERT_LTE(stats.totalKeysExamined, static_cast<size_t>(N));
 }
 
+// Test that a point lookup on a unique index is run without racing it against other plans.
+TEST_F(QueryStageMultiPlanTest, UniqueIndexPointLookupSkipsPlanRanking) {
+    for (int i = 0; i < 100; ++i) {
+        insert(BSON("foo" << i << "bar" << (i % 10)));
+    }
+
+    ASSERT_OK(dbtests::createIndex(opCtx(), nss.ns(), BSON("foo" << 1), true));
+    addIndex(BSON("bar" << 1));
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* coll = ctx.getCollection();
+
+    auto makeQuery = [&] {
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(BSON("foo" << 7 << "bar" << 7));
+        return uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    };
+
+    auto exec = uassertStatusOK(getExecutor(opCtx(), coll, makeQuery(), PlanExecutor::NO_YIELD));
+    ASSERT_NE(exec->getRootStage()->stageType(), STAGE_MULTI_PLAN);
+    ASSERT_EQ(Explain::getPlanSummary(exec.get()), "IXSCAN { foo: 1 }");
+
+    BSONObj obj;
+    ASSERT_EQ(PlanExecutor::ADVANCED, exec->getNext(&obj, nullptr));
+    ASSERT_EQ(obj["foo"].numberInt(), 7);
+    ASSERT_EQ(PlanExecutor::IS_EOF, exec->getNext(&obj, nullptr));
+
+    // With the optimization disabled, the candidate plans are ranked as usual.
+    internalQueryPlannerSkipTrialForUniquePointLookups.store(false);
+    ON_BLOCK_EXIT([] { internalQueryPlannerSkipTrialForUniquePointLookups.store(true); });
+    exec = uassertStatusOK(getExecutor(opCtx(), coll, makeQuery(), PlanExecutor::NO_YIELD));
+    ASSERT_EQ(exec->getRootStage()->stageType(), STAGE_MULTI_PLAN);
+}
+
 TEST_F(QueryStageMultiPlanTest, ShouldReportErrorIfExceedsTimeLimitDuringPlanning) {
     const int N = 5000;
     for (int i = 0; i < N; ++i) {
@@ -49,10 +49,12 @@
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/update/update_driver.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageUpdate {
 
@@ -247,6 +249,11 @@ public:
 class QueryStageUpdateSkipInvalidatedDoc : public QueryStageUpdateBase {
 public:
     void run() {
+        // The invalidation happens between two documents, so update them one at a time.
+        const int oldBatchSize = internalUpdateMultiMaxBatchSize.load();
+        internalUpdateMultiMaxBatchSize.store(1);
+        ON_BLOCK_EXIT([oldBatchSize] { internalUpdateMultiMaxBatchSize.store(oldBatchSize); });
+
         // Run the update.
         {
             OldClientWriteContext ctx(&_opCtx, nss.ns());
@@ -358,6 +365,76 @@ public:
     }
 };
 
+/**
+ * Test that a multi-update updates several documents per call to work() on storage engines with
+ * document-level locking, and that every matching document is updated exactly once.
+ */
+class QueryStageUpdateMultiBatches : public QueryStageUpdateBase {
+public:
+    void run() {
+        const int batchSize = 16;
+        const int oldBatchSize = internalUpdateMultiMaxBatchSize.load();
+        internalUpdateMultiMaxBatchSize.store(batchSize);
+        ON_BLOCK_EXIT([oldBatchSize] { internalUpdateMultiMaxBatchSize.store(oldBatchSize); });
+
+        {
+            OldClientWriteContext ctx(&_opCtx, nss.ns());
+
+            for (int i = 0; i < 100; ++i) {
+                insert(BSON("_id" << i << "foo" << i));
+            }
+
+            CurOp& curOp = *CurOp::get(_opCtx);
+            OpDebug* opDebug = &curOp.debug();
+            UpdateDriver driver((UpdateDriver::Options()));
+            Collection* coll = ctx.db()->getCollection(&_opCtx, nss);
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            // Half of the documents match, so gathering a batch also skips documents.
+            BSONObj query = fromjson("{foo: {$lt: 50}}");
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(fromjson("{$inc: {foo: 1000}}"));
+
+            const std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+            ASSERT_OK(driver.parse(request.getUpdates(), arrayFilters, request.isMulti()));
+
+            CollectionScanParams collScanParams;
+            collScanParams.collection = coll;
+            collScanParams.direction = CollectionScanParams::FORWARD;
+            collScanParams.tailable = false;
+
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+
+            auto ws = make_unique<WorkingSet>();
+            auto cs = make_unique<CollectionScan>(&_opCtx, collScanParams, ws.get(), cq->root());
+            auto updateStage =
+                make_unique<UpdateStage>(&_opCtx, updateParams, ws.get(), coll, cs.release());
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, updateStage->work(&id));
+            const bool supportsDocLocking =
+                getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+            ASSERT_EQUALS(supportsDocLocking ? size_t(batchSize) : 1U, stats->nModified);
+            ASSERT_EQUALS(stats->nModified, stats->nMatched);
+
+            runUpdate(updateStage.get());
+            ASSERT_EQUALS(50U, stats->nMatched);
+            ASSERT_EQUALS(50U, stats->nModified);
+        }
+
+        ASSERT_EQUALS(50U, count(fromjson("{foo: {$gte: 1000}}")));
+        ASSERT_EQUALS(50U, count(fromjson("{foo: {$gte: 50, $lt: 100}}")));
+    }
+};
+
 /**
  * Test that the update stage returns an owned copy of the original document if
  * ReturnDocOption::RETURN_OLD is specified.
@@ -609,6 +686,7 @@ public:
         // Stage-specific tests below.
         add<QueryStageUpdateUpsertEmptyColl>();
         add<QueryStageUpdateSkipInvalidatedDoc>();
+        add<QueryStageUpdateMultiBatches>();
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
         add<QueryStageUpdateSkipOwnedObjects>();
@@ -80,6 +80,13 @@ public:
      */
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
+    /**
+     * Spawns connections up to minConnections without waiting for a request, so that the first
+     * requests to a host do not all pay for connection establishment. Sinks a unique_lock from
+     * the parent to preserve the lock on _mutex
+     */
+    void warmUp(stdx::unique_lock<stdx::mutex> lk);
+
     /**
      * Returns a connection to a specific pool. Sinks a unique_lock from the
      * parent to preserve the lock on _mutex
@@ -215,6 +222,17 @@ void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
         Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"), std::move(lk));
 }
 
+void ConnectionPool::warmUp(const HostAndPort& hostAndPort) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    auto& pool = _pools[hostAndPort];
+    if (!pool) {
+        pool = stdx::make_unique<SpecificPool>(this, hostAndPort);
+    }
+
+    pool->warmUp(std::move(lk));
+}
+
 void ConnectionPool::get(const HostAndPort& hostAndPort,
                          Milliseconds timeout,
                          GetConnectionCallback cb) {
@@ -327,6 +345,18 @@ void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
     fulfillRequests(lk);
 }
 
+void ConnectionPool::SpecificPool::warmUp(stdx::unique_lock<stdx::mutex> lk) {
+    // A pool which was about to be reaped for lack of activity starts its host timeout over, the
+    // same as if a request had come in.
+    if (_state == State::kInShutdown) {
+        _state = State::kRunning;
+    }
+
+    updateStateInLock();
+
+    spawnConnections(lk);
+}
+
 void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr,
                                                     stdx::unique_lock<stdx::mutex> lk) {
     auto needsRefreshTP = connPtr->getLastUsed() + _parent->_options.refreshRequirement;
@@ -127,6 +127,12 @@ public:
 
     void dropConnections(const HostAndPort& hostAndPort);
 
+    /**
+     * Starts establishing minConnections connections to the given host ahead of any request for
+     * one, bounded by maxConnecting. Has no effect if the pool for the host is already warm.
+     */
+    void warmUp(const HostAndPort& hostAndPort);
+
     void get(const HostAndPort& hostAndPort, Milliseconds timeout, GetConnectionCallback cb);
 
     void appendConnectionStats(ConnectionPoolStats* stats) const;
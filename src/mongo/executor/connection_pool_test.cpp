@@ -916,6 +916,48 @@ TEST_F(ConnectionPoolTest, minPoolRespected) {
 }
 
 
+/**
+ * Verify that warming up a host spawns minConnections without any request, honoring maxConnecting
+ */
+TEST_F(ConnectionPoolTest, warmUpSpawnsMinConnections) {
+    ConnectionPool::Options options;
+    options.minConnections = 3;
+    options.maxConnecting = 2;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    pool.warmUp(HostAndPort());
+
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 2u);
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 2u);
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 1u);
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 0u);
+
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), 3u);
+
+    // Warming up an already warm host does not spawn anything
+    pool.warmUp(HostAndPort());
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 0u);
+
+    // A request is served by a warm connection without waiting for a setup
+    ConnectionPool::ConnectionHandle conn;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn = std::move(swConn.getValue());
+             });
+
+    ASSERT(conn);
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 0u);
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), 3u);
+
+    doneWith(conn);
+}
+
 /**
  * Verify that the hostTimeout is respected. This implies that an idle
  * hostAndPort drops it's connections.
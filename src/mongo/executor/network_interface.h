@@ -166,6 +166,12 @@ public:
      */
     virtual void dropConnections(const HostAndPort& hostAndPort) = 0;
 
+    /**
+     * Starts establishing the minimum number of pooled connections to the given host ahead of any
+     * request to it.
+     */
+    virtual void warmUpConnections(const HostAndPort& hostAndPort) = 0;
+
 protected:
     NetworkInterface();
 };
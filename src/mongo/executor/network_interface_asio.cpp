@@ -523,5 +523,13 @@ void NetworkInterfaceASIO::dropConnections(const HostAndPort& hostAndPort) {
     _connectionPool.dropConnections(hostAndPort);
 }
 
+void NetworkInterfaceASIO::warmUpConnections(const HostAndPort& hostAndPort) {
+    if (inShutdown()) {
+        return;
+    }
+
+    _connectionPool.warmUp(hostAndPort);
+}
+
 }  // namespace executor
 }  // namespace mongo
@@ -137,6 +137,7 @@ public:
     bool onNetworkThread() override;
 
     void dropConnections(const HostAndPort& hostAndPort) override;
+    void warmUpConnections(const HostAndPort& hostAndPort) override;
 
 private:
     using ResponseStatus = TaskExecutor::ResponseStatus;
@@ -259,6 +259,13 @@ public:
      */
     virtual void appendConnectionStats(ConnectionPoolStats* stats) const = 0;
 
+    /**
+     * Starts establishing the minimum number of pooled connections to the given host on the
+     * underlying network interface, so that the first requests to it do not have to wait for
+     * connection setup.
+     */
+    virtual void warmUpConnections(const HostAndPort& hostAndPort) = 0;
+
 protected:
     // Retrieves the Callback from a given CallbackHandle
     static CallbackState* getCallbackFromHandle(const CallbackHandle& cbHandle);
@@ -84,6 +84,8 @@ public:
 
     void appendConnectionStats(ConnectionPoolStats* stats) const override;
 
+    void warmUpConnections(const HostAndPort& hostAndPort) override;
+
     /**
      * Drops all connections to the given host on the network interface.
      */
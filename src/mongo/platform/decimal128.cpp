@@ -557,6 +557,43 @@ bool Decimal128::isNegative() const {
     return bid128_isSigned(decimal128ToLibraryType(_value));
 }
 
+bool Decimal128::_compareFast(const Decimal128& other, int* result) const {
+    if (!_isCanonicalFinite() || !other._isCanonicalFinite())
+        return false;
+
+    const uint64_t high = getCoefficientHigh();
+    const uint64_t low = _value.low64;
+    const uint64_t otherHigh = other.getCoefficientHigh();
+    const uint64_t otherLow = other._value.low64;
+    const bool thisIsZero = (high | low) == 0;
+    const bool otherIsZero = (otherHigh | otherLow) == 0;
+    if (thisIsZero && otherIsZero) {
+        *result = 0;  // Zeros compare equal regardless of sign and exponent.
+        return true;
+    }
+
+    const bool negative = _value.high64 >> kSignFieldPos;
+    const bool otherNegative = other._value.high64 >> kSignFieldPos;
+    if (negative != otherNegative) {
+        // At least one side is nonzero, so the side with the sign bit set is the smaller one.
+        *result = negative ? -1 : 1;
+        return true;
+    }
+
+    // Same sign. Compare magnitudes, then flip the result for negative numbers.
+    int magnitude;
+    if (thisIsZero || otherIsZero) {
+        magnitude = thisIsZero ? -1 : 1;
+    } else if (getBiasedExponent() == other.getBiasedExponent()) {
+        magnitude = high != otherHigh ? (high < otherHigh ? -1 : 1)
+                                      : (low != otherLow ? (low < otherLow ? -1 : 1) : 0);
+    } else {
+        return false;
+    }
+    *result = negative ? -magnitude : magnitude;
+    return true;
+}
+
 Decimal128 Decimal128::add(const Decimal128& other, RoundingMode roundMode) const {
     std::uint32_t throwAwayFlag = 0;
     return add(other, &throwAwayFlag, roundMode);
@@ -726,6 +763,9 @@ Decimal128 Decimal128::squareRoot(std::uint32_t* signalingFlags, RoundingMode ro
 }
 
 bool Decimal128::isEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareFast(other, &cmp))
+        return cmp == 0;
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -733,6 +773,9 @@ bool Decimal128::isEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isNotEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareFast(other, &cmp))
+        return cmp != 0;
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -740,6 +783,9 @@ bool Decimal128::isNotEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isGreater(const Decimal128& other) const {
+    int cmp;
+    if (_compareFast(other, &cmp))
+        return cmp > 0;
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -747,6 +793,9 @@ bool Decimal128::isGreater(const Decimal128& other) const {
 }
 
 bool Decimal128::isGreaterEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareFast(other, &cmp))
+        return cmp >= 0;
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -754,6 +803,9 @@ bool Decimal128::isGreaterEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isLess(const Decimal128& other) const {
+    int cmp;
+    if (_compareFast(other, &cmp))
+        return cmp < 0;
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -761,6 +813,9 @@ bool Decimal128::isLess(const Decimal128& other) const {
 }
 
 bool Decimal128::isLessEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareFast(other, &cmp))
+        return cmp <= 0;
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
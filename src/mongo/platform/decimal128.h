@@ -418,6 +418,9 @@ private:
     static const uint64_t kCombinationInfinity = 0x1e << 12;
     static const uint64_t kCombinationNaN = 0x1f << 12;
     static const uint64_t kCanonicalCoefficientHighFieldMask = (1ull << 49) - 1;
+    // The high and low 64 bits of the largest canonical coefficient, 10^34 - 1.
+    static const uint64_t kLargestCoefficientHigh = 0x1ed09bead87c0;
+    static const uint64_t kLargestCoefficientLow = 0x378d8e63ffffffff;
 
     std::string _convertToScientificNotation(StringData coefficient, int adjustedExponent) const;
     std::string _convertToStandardDecimalNotation(StringData coefficient, int exponent) const;
@@ -426,6 +429,25 @@ private:
         return (_value.high64 >> kCombinationFieldPos) & kCombinationFieldMask;
     }
 
+    /**
+     * Returns true if this is a finite value in canonical encoding, so that its sign, exponent
+     * and coefficient can be read directly without going through the decimal library.
+     */
+    bool _isCanonicalFinite() const {
+        const uint64_t coefficientHigh = getCoefficientHigh();
+        return _getCombinationField() < kCombinationNonCanonical &&
+            (coefficientHigh < kLargestCoefficientHigh ||
+             (coefficientHigh == kLargestCoefficientHigh &&
+              _value.low64 <= kLargestCoefficientLow));
+    }
+
+    /**
+     * Compares 'this' to 'other' using only their bit patterns, storing a negative, zero or
+     * positive value in 'result'. Returns false if the comparison needs the decimal library, for
+     * example for NaN or for nonzero values of equal sign with different exponents.
+     */
+    bool _compareFast(const Decimal128& other, int* result) const;
+
     Value _value;
 };
 }  // namespace mongo
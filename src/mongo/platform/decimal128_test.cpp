@@ -1217,6 +1217,57 @@ TEST(Decimal128Test, TestDecimal128LessEqualCase3) {
     ASSERT_TRUE(result);
 }
 
+TEST(Decimal128Test, TestDecimal128CompareZerosOfDifferentSignAndExponent) {
+    Decimal128 d1("-0E-20");
+    Decimal128 d2("0E30");
+    ASSERT_TRUE(d1.isEqual(d2));
+    ASSERT_FALSE(d1.isNotEqual(d2));
+    ASSERT_FALSE(d1.isLess(d2));
+    ASSERT_TRUE(d1.isLessEqual(d2));
+    ASSERT_TRUE(d1.isGreaterEqual(d2));
+}
+
+TEST(Decimal128Test, TestDecimal128CompareZeroWithNonzero) {
+    Decimal128 zero("-0E10");
+    Decimal128 small("1E-6000");
+    Decimal128 negativeSmall("-1E-6000");
+    ASSERT_TRUE(zero.isLess(small));
+    ASSERT_TRUE(zero.isGreater(negativeSmall));
+    ASSERT_TRUE(negativeSmall.isLess(zero));
+    ASSERT_FALSE(small.isLessEqual(zero));
+}
+
+TEST(Decimal128Test, TestDecimal128CompareNegativeSameExponent) {
+    Decimal128 d1("-12.34");
+    Decimal128 d2("-12.35");
+    ASSERT_TRUE(d1.isGreater(d2));
+    ASSERT_TRUE(d2.isLess(d1));
+    ASSERT_FALSE(d1.isEqual(d2));
+}
+
+TEST(Decimal128Test, TestDecimal128CompareDifferentExponent) {
+    Decimal128 d1("123.4");
+    Decimal128 d2("12.35");
+    ASSERT_TRUE(d1.isGreater(d2));
+    ASSERT_TRUE(Decimal128("-123.4").isLess(Decimal128("-12.35")));
+}
+
+TEST(Decimal128Test, TestDecimal128CompareNonCanonicalCoefficientAsZero) {
+    // A coefficient above 10^34 - 1 is non-canonical and must be treated as zero.
+    Decimal128 nonCanonical(Decimal128::Value{~0ull, (6176ull << 49) | ((1ull << 49) - 1)});
+    ASSERT_TRUE(nonCanonical.isEqual(Decimal128(0)));
+    ASSERT_TRUE(nonCanonical.isLess(Decimal128(1)));
+}
+
+TEST(Decimal128Test, TestDecimal128CompareNaN) {
+    Decimal128 nan = Decimal128::kPositiveNaN;
+    Decimal128 one(1);
+    ASSERT_FALSE(nan.isEqual(nan));
+    ASSERT_TRUE(nan.isNotEqual(one));
+    ASSERT_FALSE(nan.isLess(one));
+    ASSERT_FALSE(nan.isGreaterEqual(one));
+}
+
 TEST(Decimal128Test, TestDecimal128GetLargestPositive) {
     Decimal128 d = Decimal128::kLargestPositive;
     uint64_t largestPositiveDecimalHigh64 = 6917508178773903296ull;
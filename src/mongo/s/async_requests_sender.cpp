@@ -33,6 +33,7 @@
 #include "mongo/s/async_requests_sender.h"
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -48,6 +49,19 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// If a request that is allowed to run on a secondary has not been answered after this many
+// milliseconds, a duplicate request is sent to another eligible member of the same shard and
+// whichever answers first is used. Zero disables hedging.
+MONGO_EXPORT_SERVER_PARAMETER(readHedgingDelayMillis, int, 0);
+
+// Number of times the targeter is asked for an eligible host when looking for one other than the
+// host the original request was sent to.
+const int kMaxHedgeHostSelectionAttempts = 4;
+
+// Commands which are safe to send twice: they only read, and leave no server-side state, such as a
+// cursor, behind on the host whose reply is discarded.
+const StringData kHedgeableCommands[] = {"count"_sd, "distinct"_sd};
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -68,6 +82,10 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
     // Initialize command metadata to handle the read preference.
     _metadataObj = readPreference.toContainingBSON();
 
+    if (_shouldHedge()) {
+        _hedgeDelay = Milliseconds(readHedgingDelayMillis.load());
+    }
+
     // Schedule the requests immediately.
 
     // We must create the notification before scheduling any requests, because the notification is
@@ -86,6 +104,10 @@ AsyncRequestsSender::~AsyncRequestsSender() {
     while (!done()) {
         next();
     }
+
+    // Wait for canceled hedged requests and hedge timers, which no remote is waiting on any more.
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _noOutstandingCallbacksCV.wait(lk, [&] { return _outstandingCallbacks == 0; });
 }
 
 AsyncRequestsSender::Response AsyncRequestsSender::next() {
@@ -133,6 +155,12 @@ void AsyncRequestsSender::_cancelPendingRequests() {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeTimerHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerHandle);
+        }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
     }
 }
 
@@ -211,7 +239,7 @@ void AsyncRequestsSender::_scheduleRequests(WithLock lk) {
         }
 
         // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
+        if (!remote.swResponse && !remote.cbHandle.isValid() && !remote.hedgeCbHandle.isValid()) {
             auto scheduleStatus = _scheduleRequest(lk, i);
             if (!scheduleStatus.isOK()) {
                 remote.swResponse = std::move(scheduleStatus);
@@ -226,7 +254,7 @@ void AsyncRequestsSender::_scheduleRequests(WithLock lk) {
     }
 }
 
-Status AsyncRequestsSender::_scheduleRequest(WithLock, size_t remoteIndex) {
+Status AsyncRequestsSender::_scheduleRequest(WithLock lk, size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
 
     invariant(!remote.cbHandle.isValid());
@@ -242,26 +270,161 @@ Status AsyncRequestsSender::_scheduleRequest(WithLock, size_t remoteIndex) {
 
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request,
-        stdx::bind(
-            &AsyncRequestsSender::_handleResponse, this, stdx::placeholders::_1, remoteIndex));
+        stdx::bind(&AsyncRequestsSender::_handleResponse,
+                   this,
+                   stdx::placeholders::_1,
+                   remoteIndex,
+                   false));
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    ++_outstandingCallbacks;
+
+    if (_hedgeDelay > Milliseconds(0)) {
+        _scheduleHedgeTimer(lk, remoteIndex);
+    }
+
     return Status::OK();
 }
 
+bool AsyncRequestsSender::_shouldHedge() const {
+    if (readHedgingDelayMillis.load() <= 0 || !_readPreference.canRunOnSecondary()) {
+        return false;
+    }
+
+    return std::all_of(_remotes.begin(), _remotes.end(), [](const RemoteData& remote) {
+        const StringData commandName = remote.cmdObj.firstElementFieldName();
+        return std::find(std::begin(kHedgeableCommands),
+                         std::end(kHedgeableCommands),
+                         commandName) != std::end(kHedgeableCommands);
+    });
+}
+
+void AsyncRequestsSender::_scheduleHedgeTimer(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    invariant(remote.shardHostAndPort);
+    invariant(!remote.hedgeTimerHandle.isValid());
+    invariant(!remote.hedgeCbHandle.isValid());
+
+    remote.hedgeHostAndPort = boost::none;
+    const auto shard = remote.getShard();
+    if (!shard) {
+        return;
+    }
+
+    // The targeter picks randomly among the eligible hosts within the latency window, so ask it a
+    // few times for one other than the host the original request went to. A wait of zero only
+    // consults the replica set monitor's current view of the shard.
+    for (int attempt = 0; attempt < kMaxHedgeHostSelectionAttempts; ++attempt) {
+        auto swHost = shard->getTargeter()->findHostWithMaxWait(_readPreference, Milliseconds(0));
+        if (swHost.isOK() && swHost.getValue() != *remote.shardHostAndPort) {
+            remote.hedgeHostAndPort = std::move(swHost.getValue());
+            break;
+        }
+    }
+
+    if (!remote.hedgeHostAndPort) {
+        return;
+    }
+
+    auto swTimerHandle = _executor->scheduleWorkAt(
+        _executor->now() + _hedgeDelay,
+        stdx::bind(
+            &AsyncRequestsSender::_sendHedgedRequest, this, stdx::placeholders::_1, remoteIndex));
+    if (!swTimerHandle.isOK()) {
+        // Hedging is best-effort, and the original request is still outstanding.
+        return;
+    }
+
+    remote.hedgeTimerHandle = swTimerHandle.getValue();
+    ++_outstandingCallbacks;
+}
+
+void AsyncRequestsSender::_sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbArgs,
+                                             size_t remoteIndex) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ON_BLOCK_EXIT([&] { _onCallbackFinished(lk); });
+
+    auto& remote = _remotes[remoteIndex];
+
+    // The timer may have been canceled, and its handle cleared, after it had already fired.
+    if (!(remote.hedgeTimerHandle == cbArgs.myHandle)) {
+        return;
+    }
+    remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+
+    if (!cbArgs.status.isOK() || _stopRetrying || remote.swResponse ||
+        !remote.cbHandle.isValid()) {
+        return;
+    }
+
+    invariant(remote.hedgeHostAndPort);
+    LOG(1) << "Command to remote " << remote.shardId << " at host " << *remote.shardHostAndPort
+           << " has not replied within " << _hedgeDelay << ", sending a hedged request to "
+           << *remote.hedgeHostAndPort;
+
+    executor::RemoteCommandRequest request(
+        *remote.hedgeHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
+
+    auto callbackStatus = _executor->scheduleRemoteCommand(
+        request,
+        stdx::bind(&AsyncRequestsSender::_handleResponse,
+                   this,
+                   stdx::placeholders::_1,
+                   remoteIndex,
+                   true));
+    if (!callbackStatus.isOK()) {
+        return;
+    }
+
+    remote.hedgeCbHandle = callbackStatus.getValue();
+    ++_outstandingCallbacks;
+}
+
 void AsyncRequestsSender::_handleResponse(
-    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, size_t remoteIndex) {
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
+    size_t remoteIndex,
+    bool isHedge) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ON_BLOCK_EXIT([&] { _onCallbackFinished(lk); });
 
     auto& remote = _remotes[remoteIndex];
+
+    // A request which lost the race of a hedged pair has already had its handle cleared when it
+    // was canceled, and its response is discarded.
+    auto& ownHandle = isHedge ? remote.hedgeCbHandle : remote.cbHandle;
+    auto& otherHandle = isHedge ? remote.cbHandle : remote.hedgeCbHandle;
+    if (!(ownHandle == cbData.myHandle)) {
+        return;
+    }
     invariant(!remote.swResponse);
 
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    // this host.
+    ownHandle = executor::TaskExecutor::CallbackHandle();
+
+    // While the other request of a hedged pair is outstanding, wait for it rather than report an
+    // error from this one.
+    if (!cbData.response.isOK() && otherHandle.isValid()) {
+        return;
+    }
+
+    // Cancel the request or timer which lost the race. Their callbacks still run, but find their
+    // handles cleared and return without touching the remote.
+    if (otherHandle.isValid()) {
+        _executor->cancel(otherHandle);
+        otherHandle = executor::TaskExecutor::CallbackHandle();
+    }
+    if (remote.hedgeTimerHandle.isValid()) {
+        _executor->cancel(remote.hedgeTimerHandle);
+        remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    if (isHedge) {
+        remote.shardHostAndPort = remote.hedgeHostAndPort;
+    }
 
     // Store the response or error.
     if (cbData.response.status.isOK()) {
@@ -276,6 +439,13 @@ void AsyncRequestsSender::_handleResponse(
     }
 }
 
+void AsyncRequestsSender::_onCallbackFinished(WithLock) {
+    invariant(_outstandingCallbacks > 0);
+    if (--_outstandingCallbacks == 0) {
+        _noOutstandingCallbacksCV.notify_all();
+    }
+}
+
 AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
     : shardId(shardId), cmdObj(cmdObj) {}
 
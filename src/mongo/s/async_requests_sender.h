@@ -39,6 +39,7 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_id.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/concurrency/with_lock.h"
@@ -200,6 +201,15 @@ private:
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // Another eligible host of the same shard, chosen when the request is scheduled, to which a
+        // duplicate (hedged) request is sent if shardHostAndPort has not replied in time.
+        boost::optional<HostAndPort> hedgeHostAndPort;
+
+        // The callback handles to the timer that sends the hedged request, and to the hedged
+        // request itself.
+        executor::TaskExecutor::CallbackHandle hedgeTimerHandle;
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+
         // Whether this remote's result has been returned.
         bool done = false;
     };
@@ -246,10 +256,39 @@ private:
      * 'remoteIndex' is the position of the relevant remote node in '_remotes', and therefore
      * indicates which node the response came from and where the response should be buffered.
      *
+     * 'isHedge' tells whether the response is for the hedged request rather than the original
+     * one. The first successful response of a hedged pair wins and the other request is canceled;
+     * an error is only recorded once neither request of the pair is outstanding any more.
+     *
      * Stores the response or error in the remote and signals the notification.
      */
     void _handleResponse(const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
-                         size_t remoteIndex);
+                         size_t remoteIndex,
+                         bool isHedge);
+
+    /**
+     * Returns whether requests sent by this ARS may be hedged: hedging must be enabled, the read
+     * preference must allow secondaries, and every command must be safe to send twice.
+     */
+    bool _shouldHedge() const;
+
+    /**
+     * Chooses a host for the remote other than the one its request was sent to and, if there is
+     * one, schedules the timer that sends the hedged request to it.
+     */
+    void _scheduleHedgeTimer(WithLock, size_t remoteIndex);
+
+    /**
+     * The callback for the hedge timer. Sends the request to the remote's hedge host if the
+     * original request is still waiting for its reply.
+     */
+    void _sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbArgs,
+                            size_t remoteIndex);
+
+    /**
+     * Must be called when any callback scheduled by this ARS finishes.
+     */
+    void _onCallbackFinished(WithLock);
 
     OperationContext* _opCtx;
 
@@ -268,6 +307,11 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
+    // How long to wait for a reply before hedging a request, or zero if requests are not hedged.
+    // Computed once on construction, since it depends on every remote's command and would
+    // otherwise be re-evaluated for each scheduled request.
+    Milliseconds _hedgeDelay{0};
+
     // Is set to a non-OK status if the client operation is interrupted.
     // When waiting for a remote to be ready, we only check for interrupt if the _interruptStatus
     // has not already been set to an error (so we can wait for callbacks for (canceled) outstanding
@@ -289,6 +333,13 @@ private:
     // Used to determine if the ARS should attempt to retry any requests. Is set to true when
     // stopRetrying() or cancelPendingRequests() is called.
     bool _stopRetrying = false;
+
+    // The number of scheduled requests and hedge timers whose callbacks have not run yet. A
+    // canceled hedged request can still be outstanding after every remote has returned its
+    // response, so the destructor waits for this to drop to zero, signaled through the condition
+    // variable.
+    int _outstandingCallbacks = 0;
+    stdx::condition_variable _noOutstandingCallbacksCV;
 };
 
 }  // namespace mongo
@@ -438,5 +438,61 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunkMixedTypes) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss,
+                                         shardKeyPattern,
+                                         nullptr,
+                                         false,
+                                         {BSON("a" << -1.5),
+                                          BSON("a" << 0),
+                                          BSON("a" << 10LL),
+                                          BSON("a"
+                                               << "abc"),
+                                          BSON("a"
+                                               << "abd"),
+                                          BSON("a" << BSON("x" << 1))});
+
+    const std::vector<BSONObj> keys{BSON("a" << MINKEY),
+                                    BSON("a" << -2),
+                                    BSON("a" << -1.5),
+                                    BSON("a" << -1),
+                                    BSON("a" << 0.0),
+                                    BSON("a" << 9.99),
+                                    BSON("a" << 10),
+                                    BSON("a" << Decimal128("10.5")),
+                                    BSON("a"
+                                         << ""),
+                                    BSON("a"
+                                         << "abc"),
+                                    BSON("a"
+                                         << "abcd"),
+                                    BSON("a"
+                                         << "abd"),
+                                    BSON("a" << BSONObj()),
+                                    BSON("a" << BSON("x" << 1)),
+                                    BSON("a" << BSON("x" << 2)),
+                                    BSON("a" << true)};
+
+    for (const auto& key : keys) {
+        // Find the owning chunk the slow way and make sure the lookup agrees with it
+        boost::optional<ShardId> expectedShardId;
+        for (const auto& chunk : chunkManager->chunks()) {
+            if (chunk->containsKey(key)) {
+                expectedShardId = chunk->getShardId();
+            }
+        }
+        ASSERT(expectedShardId);
+
+        auto chunk = chunkManager->findIntersectingChunkWithSimpleCollation(key);
+        ASSERT_EQ(*expectedShardId, chunk->getShardId());
+
+        std::set<ShardId> shardIds;
+        chunkManager->getShardIdsForRange(key, key, &shardIds);
+        ASSERT_EQ(1U, shardIds.size());
+        ASSERT_EQ(*expectedShardId, *shardIds.begin());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,528 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_map.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "mongo/base/error_codes.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
+    for (const auto&& element : o) {
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Not all elements of " << o << " are of type " << typeName(type),
+                element.type() == type);
+    }
+}
+
+void checkContiguous(const Chunk& prev, const Chunk& next) {
+    uassert(ErrorCodes::ConflictingOperationInProgress,
+            str::stream() << "Gap or an overlap between chunks " << prev.toString() << " and "
+                          << next.toString(),
+            SimpleBSONObjComparator::kInstance.evaluate(prev.getMax() == next.getMin()));
+}
+
+}  // namespace
+
+const size_t ChunkMap::kMaxBlockSize = 256;
+
+const KeyString::Version PackedKeyIndex::kKeyStringVersion = KeyString::Version::V1;
+const Ordering PackedKeyIndex::kOrdering = Ordering::make(BSONObj());
+
+void PackedKeyIndex::append(const BSONObj& key) {
+    const KeyString ks(kKeyStringVersion, key, kOrdering);
+    _append(ks.getBuffer(), ks.getSize());
+}
+
+void PackedKeyIndex::appendFrom(const PackedKeyIndex& other, size_t pos) {
+    const auto offset = other._offsets[pos];
+    _append(other._keys.data() + offset, other._offsets[pos + 1] - offset);
+}
+
+void PackedKeyIndex::_append(const char* data, size_t size) {
+    _keys.append(data, size);
+    _offsets.push_back(static_cast<uint32_t>(_keys.size()));
+}
+
+size_t PackedKeyIndex::upperBound(const KeyString& key) const {
+    const size_t numKeys = size();
+    if (numKeys == 0) {
+        return 0;
+    }
+
+    // Invariant: the result is within [base, base + len]. Each step halves 'len' and only ever
+    // conditionally advances 'base', which the compiler can do without a branch.
+    size_t base = 0;
+    size_t len = numKeys;
+    while (len > 1) {
+        const size_t half = len / 2;
+        base += (_compareAt(base + half - 1, key) <= 0) ? half : 0;
+        len -= half;
+    }
+
+    return base + ((_compareAt(base, key) <= 0) ? 1 : 0);
+}
+
+int PackedKeyIndex::_compareAt(size_t pos, const KeyString& key) const {
+    const char* const data = _keys.data() + _offsets[pos];
+    const size_t size = _offsets[pos + 1] - _offsets[pos];
+    const size_t minSize = std::min(size, key.getSize());
+
+    const int cmp = minSize ? std::memcmp(data, key.getBuffer(), minSize) : 0;
+    if (cmp != 0) {
+        return cmp;
+    }
+
+    return size < key.getSize() ? -1 : (size > key.getSize() ? 1 : 0);
+}
+
+ChunkMap::ConstIterator& ChunkMap::ConstIterator::operator++() {
+    if (++_pos == (*_blocks)[_block]->chunks.size()) {
+        ++_block;
+        _pos = 0;
+    }
+
+    return *this;
+}
+
+const std::shared_ptr<Chunk>& ChunkMap::ConstIterator::operator*() const {
+    return (*_blocks)[_block]->chunks[_pos];
+}
+
+/**
+ * Accumulates the changes to a map. Blocks of the base map are copied only once a change touches
+ * them and all the blocks are rebuilt into a new map in done().
+ */
+class ChunkMap::Updater {
+public:
+    explicit Updater(const ChunkMap& base) : _base(base) {
+        _slots.reserve(base._blocks.size());
+        for (const auto& block : base._blocks) {
+            Slot slot;
+            slot.shared = block;
+            _slots.push_back(std::move(slot));
+        }
+    }
+
+    /**
+     * Replaces the entire content with 'chunks', which must be sorted by max key.
+     */
+    void reset(std::vector<std::shared_ptr<Chunk>> chunks) {
+        _slots.clear();
+
+        if (!chunks.empty()) {
+            Slot slot;
+            slot.touched = true;
+            slot.chunks = std::move(chunks);
+            _slots.push_back(std::move(slot));
+        }
+    }
+
+    /**
+     * Removes all the chunks, which overlap 'chunk' and inserts it in their place.
+     */
+    void apply(std::shared_ptr<Chunk> chunk) {
+        // The first chunk with a max key that is > min - implies that the chunk overlaps min
+        auto low = _upperBound(chunk->getMin());
+
+        // The first chunk with a max key that is > max - implies that the next chunk cannot not
+        // overlap max
+        const auto high = _upperBound(chunk->getMax());
+
+        if (low.first == _slots.size()) {
+            // The chunk goes after all existing ones, so add it to the last slot
+            if (_slots.empty()) {
+                Slot slot;
+                slot.touched = true;
+                _slots.push_back(std::move(slot));
+            }
+
+            const size_t lastSlot = _slots.size() - 1;
+            auto& chunks = _slots[lastSlot].mutableChunks();
+            chunks.push_back(std::move(chunk));
+            return;
+        }
+
+        if (low.first == high.first) {
+            auto& chunks = _slots[low.first].mutableChunks();
+            chunks.erase(chunks.begin() + low.second, chunks.begin() + high.second);
+            chunks.insert(chunks.begin() + low.second, std::move(chunk));
+            return;
+        }
+
+        auto& lowChunks = _slots[low.first].mutableChunks();
+        lowChunks.erase(lowChunks.begin() + low.second, lowChunks.end());
+        lowChunks.push_back(std::move(chunk));
+
+        // The slot of 'high' keeps at least the chunk at 'high', because its max is > max. There
+        // is no need to copy it if no chunk before that is removed.
+        if (high.first < _slots.size() && high.second > 0) {
+            auto& highChunks = _slots[high.first].mutableChunks();
+            highChunks.erase(highChunks.begin(), highChunks.begin() + high.second);
+        }
+
+        _slots.erase(_slots.begin() + low.first + 1, _slots.begin() + high.first);
+    }
+
+    /**
+     * Validates the accumulated changes and builds the new map from them.
+     */
+    ChunkMap done() {
+        _validate();
+
+        ChunkMap result;
+        result._shardIds = _base._shardIds;
+
+        for (auto& slot : _slots) {
+            if (!slot.touched) {
+                result._blocks.push_back(std::move(slot.shared));
+                continue;
+            }
+
+            // Split the slot into pieces of approximately equal size not exceeding the max block
+            // size
+            const auto& chunks = slot.chunks;
+            const size_t numBlocks = (chunks.size() + kMaxBlockSize - 1) / kMaxBlockSize;
+            const size_t blockSize = (chunks.size() + numBlocks - 1) / numBlocks;
+
+            for (size_t begin = 0; begin < chunks.size(); begin += blockSize) {
+                const size_t end = std::min(begin + blockSize, chunks.size());
+                result._blocks.push_back(
+                    _makeBlock(chunks.begin() + begin, chunks.begin() + end, &result));
+            }
+        }
+
+        std::vector<bool> ownsChunks(result._shardIds->size(), false);
+
+        for (const auto& block : result._blocks) {
+            result._blockMaxKeys.appendFrom(block->maxKeys, block->maxKeys.size() - 1);
+            result._size += block->chunks.size();
+
+            for (const auto& shardVersion : block->shardVersions) {
+                if (!ownsChunks[shardVersion.first]) {
+                    ownsChunks[shardVersion.first] = true;
+                    result._numShards++;
+                }
+            }
+        }
+
+        return result;
+    }
+
+private:
+    struct Slot {
+        const std::vector<std::shared_ptr<Chunk>>& get() const {
+            return touched ? chunks : shared->chunks;
+        }
+
+        std::vector<std::shared_ptr<Chunk>>& mutableChunks() {
+            if (!touched) {
+                chunks = shared->chunks;
+                shared.reset();
+                touched = true;
+            }
+
+            return chunks;
+        }
+
+        // The block of the base map, as long as the slot has not been touched
+        std::shared_ptr<const Block> shared;
+
+        // Copy of the block's chunks, once the slot has been touched
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        bool touched{false};
+    };
+
+    using ChunkIterator = std::vector<std::shared_ptr<Chunk>>::const_iterator;
+
+    /**
+     * Returns the slot and position within it of the first chunk with a max key > 'key'. No slot
+     * is empty, so the max key of a slot is that of its last chunk.
+     */
+    std::pair<size_t, size_t> _upperBound(const BSONObj& key) const {
+        const auto& comparator = SimpleBSONObjComparator::kInstance;
+
+        const auto slotIt =
+            std::partition_point(_slots.begin(), _slots.end(), [&](const Slot& slot) {
+                return comparator.evaluate(slot.get().back()->getMax() <= key);
+            });
+        if (slotIt == _slots.end()) {
+            return {_slots.size(), 0};
+        }
+
+        const auto& chunks = slotIt->get();
+        const auto chunkIt = std::upper_bound(
+            chunks.begin(),
+            chunks.end(),
+            key,
+            [&](const BSONObj& k, const std::shared_ptr<Chunk>& chunk) {
+                return comparator.evaluate(k < chunk->getMax());
+            });
+
+        return {static_cast<size_t>(slotIt - _slots.begin()),
+                static_cast<size_t>(chunkIt - chunks.begin())};
+    }
+
+    /**
+     * The chunks of the base map are already known to be valid, so only the touched slots and
+     * their boundaries with the neighbouring ones need to be checked.
+     */
+    void _validate() const {
+        for (size_t i = 0; i < _slots.size(); ++i) {
+            const auto& slot = _slots[i];
+            if (!slot.touched)
+                continue;
+
+            const auto& chunks = slot.chunks;
+            for (size_t pos = 1; pos < chunks.size(); ++pos) {
+                checkContiguous(*chunks[pos - 1], *chunks[pos]);
+            }
+
+            if (i > 0) {
+                checkContiguous(*_slots[i - 1].get().back(), *chunks.front());
+            }
+
+            if (i + 1 < _slots.size() && !_slots[i + 1].touched) {
+                checkContiguous(*chunks.back(), *_slots[i + 1].get().front());
+            }
+        }
+
+        if (!_slots.empty()) {
+            checkAllElementsAreOfType(MinKey, _slots.front().get().front()->getMin());
+            checkAllElementsAreOfType(MaxKey, _slots.back().get().back()->getMax());
+        }
+    }
+
+    /**
+     * Builds a block from the chunks in [begin, end), adding the shards which they reference to
+     * the shard id table of 'map' as necessary.
+     */
+    std::shared_ptr<const Block> _makeBlock(ChunkIterator begin, ChunkIterator end, ChunkMap* map) {
+        auto block = std::make_shared<Block>();
+        block->chunks.assign(begin, end);
+        block->shardIndexes.reserve(block->chunks.size());
+
+        for (const auto& chunk : block->chunks) {
+            block->maxKeys.append(chunk->getMax());
+
+            const auto shardIndex = _internShardId(chunk->getShardId(), map);
+            block->shardIndexes.push_back(shardIndex);
+
+            auto it = std::find_if(block->shardVersions.begin(),
+                                   block->shardVersions.end(),
+                                   [&](const std::pair<uint16_t, ChunkVersion>& shardVersion) {
+                                       return shardVersion.first == shardIndex;
+                                   });
+            if (it == block->shardVersions.end()) {
+                block->shardVersions.emplace_back(shardIndex, chunk->getLastmod());
+            } else if (chunk->getLastmod() > it->second) {
+                it->second = chunk->getLastmod();
+            }
+        }
+
+        return block;
+    }
+
+    uint16_t _internShardId(const ShardId& shardId, ChunkMap* map) {
+        if (_shardIndexes.empty()) {
+            const auto& shardIds = *map->_shardIds;
+            for (size_t i = 0; i < shardIds.size(); ++i) {
+                _shardIndexes.emplace(shardIds[i], static_cast<uint16_t>(i));
+            }
+        }
+
+        auto it = _shardIndexes.find(shardId);
+        if (it != _shardIndexes.end()) {
+            return it->second;
+        }
+
+        // The table is shared with the previous versions of the map, so it must be copied before
+        // it can be appended to
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Metadata contains chunks on more than "
+                              << std::numeric_limits<uint16_t>::max()
+                              << " shards",
+                map->_shardIds->size() < std::numeric_limits<uint16_t>::max());
+
+        auto shardIds = std::make_shared<ShardIdTable>(*map->_shardIds);
+        shardIds->push_back(shardId);
+        map->_shardIds = std::move(shardIds);
+
+        const auto shardIndex = static_cast<uint16_t>(map->_shardIds->size() - 1);
+        _shardIndexes.emplace(shardId, shardIndex);
+        return shardIndex;
+    }
+
+    const ChunkMap& _base;
+
+    // Blocks of the new map, in order, while it is being built
+    std::vector<Slot> _slots;
+
+    // Reverse of the shard id table, populated on first use
+    std::map<ShardId, uint16_t> _shardIndexes;
+};
+
+ChunkMap::ChunkMap() : _shardIds(std::make_shared<ShardIdTable>()) {}
+
+ChunkMap ChunkMap::makeUpdated(const std::vector<std::shared_ptr<Chunk>>& changedChunks) const {
+    Updater updater(*this);
+
+    if (empty()) {
+        // Building a map from scratch, which is done with all the chunks of the collection. These
+        // come sorted by version rather than by key, so they are collected in an ordered map
+        // first instead of being inserted into the middle of a block one by one.
+        auto chunkMap =
+            SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>();
+
+        for (const auto& chunk : changedChunks) {
+            const auto low = chunkMap.upper_bound(chunk->getMin());
+            const auto high = chunkMap.upper_bound(chunk->getMax());
+            chunkMap.erase(low, high);
+            chunkMap.insert(std::make_pair(chunk->getMax(), chunk));
+        }
+
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        chunks.reserve(chunkMap.size());
+        for (auto& entry : chunkMap) {
+            chunks.push_back(std::move(entry.second));
+        }
+
+        updater.reset(std::move(chunks));
+    } else {
+        for (const auto& chunk : changedChunks) {
+            updater.apply(chunk);
+        }
+    }
+
+    return updater.done();
+}
+
+std::pair<size_t, size_t> ChunkMap::_upperBound(const KeyString& key) const {
+    const size_t block = _blockMaxKeys.upperBound(key);
+    if (block == _blocks.size()) {
+        return {block, 0};
+    }
+
+    return {block, _blocks[block]->maxKeys.upperBound(key)};
+}
+
+std::shared_ptr<Chunk> ChunkMap::findIntersectingChunk(const BSONObj& key) const {
+    const auto pos = _upperBound(
+        KeyString(PackedKeyIndex::kKeyStringVersion, key, PackedKeyIndex::kOrdering));
+    if (pos.first == _blocks.size()) {
+        return nullptr;
+    }
+
+    const auto& chunk = _blocks[pos.first]->chunks[pos.second];
+    if (!chunk->containsKey(key)) {
+        return nullptr;
+    }
+
+    return chunk;
+}
+
+void ChunkMap::getShardIdsForRange(const BSONObj& min,
+                                   const BSONObj& max,
+                                   std::set<ShardId>* shardIds) const {
+    const auto begin = _upperBound(
+        KeyString(PackedKeyIndex::kKeyStringVersion, min, PackedKeyIndex::kOrdering));
+
+    // The chunks must always cover the entire key space
+    invariant(begin.first < _blocks.size());
+
+    // We need to include the last chunk
+    auto last = _upperBound(
+        KeyString(PackedKeyIndex::kKeyStringVersion, max, PackedKeyIndex::kOrdering));
+    if (last.first == _blocks.size()) {
+        last = {_blocks.size() - 1, _blocks.back()->chunks.size() - 1};
+    }
+
+    // Collect the interned indexes first, so each shard id is inserted into the result only once
+    const auto& allShardIds = *_shardIds;
+    std::vector<bool> seen(allShardIds.size(), false);
+    size_t numSeen = 0;
+
+    const auto markSeen = [&](uint16_t shardIndex) {
+        if (!seen[shardIndex]) {
+            seen[shardIndex] = true;
+            numSeen++;
+        }
+    };
+
+    // No need to iterate through the rest of the chunks once we know we need to use all shards
+    for (size_t b = begin.first; b <= last.first && numSeen < _numShards; ++b) {
+        const auto& block = *_blocks[b];
+        const size_t from = (b == begin.first) ? begin.second : 0;
+        const size_t to = (b == last.first) ? last.second + 1 : block.chunks.size();
+
+        if (from == 0 && to == block.chunks.size()) {
+            for (const auto& shardVersion : block.shardVersions) {
+                markSeen(shardVersion.first);
+            }
+        } else {
+            for (size_t pos = from; pos < to; ++pos) {
+                markSeen(block.shardIndexes[pos]);
+            }
+        }
+    }
+
+    for (size_t shardIndex = 0; shardIndex < allShardIds.size(); ++shardIndex) {
+        if (seen[shardIndex]) {
+            shardIds->insert(allShardIds[shardIndex]);
+        }
+    }
+}
+
+ShardVersionMap ChunkMap::getShardVersions(const OID& epoch) const {
+    ShardVersionMap shardVersions;
+
+    for (const auto& block : _blocks) {
+        for (const auto& shardVersion : block->shardVersions) {
+            auto it = shardVersions
+                          .emplace((*_shardIds)[shardVersion.first], ChunkVersion(0, 0, epoch))
+                          .first;
+            if (shardVersion.second > it->second) {
+                it->second = shardVersion.second;
+            }
+        }
+    }
+
+    return shardVersions;
+}
+
+}  // namespace mongo
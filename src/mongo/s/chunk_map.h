@@ -0,0 +1,235 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/s/chunk.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/s/shard_id.h"
+
+namespace mongo {
+
+// Map from a shard is to the max chunk version on that shard
+using ShardVersionMap = std::map<ShardId, ChunkVersion>;
+
+/**
+ * Immutable, sorted sequence of keys encoded as KeyString and packed back to back into a single
+ * buffer. Looking up a key is a binary search over contiguous memory which compares bytes, rather
+ * than a walk of a BSONObjIndexedMap doing a BSON comparison at every node.
+ *
+ * KeyString does not encode field names, so this is only usable for keys which have the same
+ * fields as the shard key pattern, in the same order.
+ */
+class PackedKeyIndex {
+public:
+    // Keys passed to upperBound() must be encoded with this version and ordering
+    static const KeyString::Version kKeyStringVersion;
+    static const Ordering kOrdering;
+
+    /**
+     * Appends 'key', which must compare greater than all the keys appended before it.
+     */
+    void append(const BSONObj& key);
+
+    /**
+     * Appends the key at position 'pos' of 'other' without decoding it.
+     */
+    void appendFrom(const PackedKeyIndex& other, size_t pos);
+
+    /**
+     * Returns the position of the first key, which is greater than 'key' or size() if there is no
+     * such key. Equivalent to std::upper_bound.
+     */
+    size_t upperBound(const KeyString& key) const;
+
+    size_t size() const {
+        return _offsets.size() - 1;
+    }
+
+private:
+    void _append(const char* data, size_t size);
+
+    // Returns < 0, 0 or > 0 depending on whether the key at 'pos' compares less than, equal to or
+    // greater than 'key'
+    int _compareAt(size_t pos, const KeyString& key) const;
+
+    // Concatenation of the KeyString encodings of all keys
+    std::string _keys;
+
+    // The key at position i occupies [_offsets[i], _offsets[i + 1]) of '_keys'
+    std::vector<uint32_t> _offsets{0};
+};
+
+/**
+ * Immutable set of the chunks of a sharded collection, ordered by the max key of each chunk.
+ *
+ * The chunks are stored in blocks of bounded size and every block is immutable once built, so
+ * successive versions of the map share all the blocks which a change did not touch. Deriving a new
+ * version through makeUpdated() therefore allocates in proportion to the number of changed chunks
+ * (plus one pointer per block), instead of copying the entire map, and previous versions stay
+ * valid for as long as someone references them.
+ */
+class ChunkMap {
+    struct Block;
+    using BlockVector = std::vector<std::shared_ptr<const Block>>;
+
+public:
+    // Blocks larger than this are split when a new version of the map is built
+    static const size_t kMaxBlockSize;
+
+    class ConstIterator {
+    public:
+        ConstIterator() = default;
+
+        ConstIterator& operator++();
+        ConstIterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return _block == other._block && _pos == other._pos;
+        }
+        bool operator!=(const ConstIterator& other) const {
+            return !(*this == other);
+        }
+
+        const std::shared_ptr<Chunk>& operator*() const;
+
+    private:
+        friend class ChunkMap;
+
+        ConstIterator(const BlockVector* blocks, size_t block, size_t pos)
+            : _blocks(blocks), _block(block), _pos(pos) {}
+
+        const BlockVector* _blocks{nullptr};
+        size_t _block{0};
+        size_t _pos{0};
+    };
+
+    /**
+     * Constructs an empty map.
+     */
+    ChunkMap();
+
+    /**
+     * Returns a new map, which contains the chunks of this map with each of 'changedChunks'
+     * applied in order. Applying a chunk removes all the chunks it overlaps and inserts it in
+     * their place. This map is not modified.
+     *
+     * Throws ConflictingOperationInProgress if the resulting chunks do not cover the complete
+     * space from [MinKey, MaxKey) without gaps or overlaps.
+     */
+    ChunkMap makeUpdated(const std::vector<std::shared_ptr<Chunk>>& changedChunks) const;
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    ConstIterator begin() const {
+        return {&_blocks, 0, 0};
+    }
+
+    ConstIterator end() const {
+        return {&_blocks, _blocks.size(), 0};
+    }
+
+    /**
+     * Returns the chunk which contains 'key' or nullptr if there is no such chunk.
+     */
+    std::shared_ptr<Chunk> findIntersectingChunk(const BSONObj& key) const;
+
+    /**
+     * Adds to 'shardIds' the ids of all shards which own chunks overlapping the range [min, max].
+     * Must not be called on an empty map.
+     */
+    void getShardIdsForRange(const BSONObj& min,
+                             const BSONObj& max,
+                             std::set<ShardId>* shardIds) const;
+
+    /**
+     * Returns the maximum chunk version for each shard, which owns chunks.
+     */
+    ShardVersionMap getShardVersions(const OID& epoch) const;
+
+private:
+    using ShardIdTable = std::vector<ShardId>;
+
+    /**
+     * Contiguous run of chunks along with the derived data used for lookups within it.
+     */
+    struct Block {
+        std::vector<std::shared_ptr<Chunk>> chunks;
+
+        // Max keys of 'chunks'
+        PackedKeyIndex maxKeys;
+
+        // The shard of each chunk in 'chunks', as an index into the map's shard id table
+        std::vector<uint16_t> shardIndexes;
+
+        // The distinct values of 'shardIndexes' and the max chunk version for each of them
+        std::vector<std::pair<uint16_t, ChunkVersion>> shardVersions;
+    };
+
+    class Updater;
+
+    // Returns the position of the first chunk whose max key is greater than 'key' as a pair of
+    // block index and position within the block. Equivalent to std::upper_bound.
+    std::pair<size_t, size_t> _upperBound(const KeyString& key) const;
+
+    BlockVector _blocks;
+
+    // Max key of the last chunk of each block
+    PackedKeyIndex _blockMaxKeys;
+
+    // Append-only table of the ids of the shards referenced by the blocks. It is shared with
+    // previous versions of the map, whose blocks index into a prefix of it.
+    std::shared_ptr<const ShardIdTable> _shardIds;
+
+    // Number of distinct shards that own chunks
+    size_t _numShards{0};
+
+    // Total number of chunks across all blocks
+    size_t _size{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,225 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <random>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/s/chunk_map.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+
+/**
+ * Returns the split point with the given number, where 0 is the global min and 'numChunks' the
+ * global max of the shard key {a: 1}.
+ */
+BSONObj key(int i, int numChunks) {
+    if (i == 0)
+        return BSON("a" << MINKEY);
+    if (i == numChunks)
+        return BSON("a" << MAXKEY);
+    return BSON("a" << i * 10);
+}
+
+std::shared_ptr<Chunk> makeChunk(const BSONObj& min,
+                                 const BSONObj& max,
+                                 const ChunkVersion& version,
+                                 const ShardId& shardId) {
+    return std::make_shared<Chunk>(ChunkType(kNss, {min, max}, version, shardId));
+}
+
+class ChunkMapTest : public unittest::Test {
+protected:
+    /**
+     * Builds a map of 'numChunks' chunks, with chunk i on shard i % 'numShards' at major version
+     * i + 1. Applies them out of key order, like a refresh from scratch does.
+     */
+    ChunkMap makeMap(int numChunks, int numShards) {
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        for (int i = 0; i < numChunks; ++i) {
+            chunks.push_back(makeChunk(key(i, numChunks),
+                                       key(i + 1, numChunks),
+                                       ChunkVersion(i + 1, 0, _epoch),
+                                       ShardId(str::stream() << (i % numShards))));
+        }
+
+        std::shuffle(chunks.begin(), chunks.end(), std::mt19937(1));
+        return ChunkMap().makeUpdated(chunks);
+    }
+
+    void assertContiguous(const ChunkMap& map, size_t expectedSize) {
+        ASSERT_EQ(expectedSize, map.size());
+
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            chunks.push_back(*it);
+        }
+        ASSERT_EQ(expectedSize, chunks.size());
+        ASSERT_BSONOBJ_EQ(BSON("a" << MINKEY), chunks.front()->getMin());
+        ASSERT_BSONOBJ_EQ(BSON("a" << MAXKEY), chunks.back()->getMax());
+
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(chunks[i - 1]->getMax(), chunks[i]->getMin());
+        }
+
+        // Every chunk must be found through its min key
+        for (const auto& chunk : chunks) {
+            ASSERT_EQ(chunk, map.findIntersectingChunk(chunk->getMin()));
+        }
+    }
+
+    const OID _epoch{OID::gen()};
+};
+
+TEST_F(ChunkMapTest, Empty) {
+    ChunkMap map;
+    ASSERT(map.empty());
+    ASSERT_EQ(0U, map.size());
+    ASSERT(map.begin() == map.end());
+    ASSERT(!map.findIntersectingChunk(BSON("a" << 1)));
+    ASSERT(map.getShardVersions(_epoch).empty());
+}
+
+TEST_F(ChunkMapTest, BuildSpanningMultipleBlocks) {
+    const int numChunks = 3 * ChunkMap::kMaxBlockSize + 7;
+    const auto map = makeMap(numChunks, 4);
+    assertContiguous(map, numChunks);
+
+    auto chunk = map.findIntersectingChunk(BSON("a" << 1005));
+    ASSERT(chunk);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1000), chunk->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1010), chunk->getMax());
+    ASSERT_EQ(ShardId("0"), chunk->getShardId());
+
+    const auto shardVersions = map.getShardVersions(_epoch);
+    ASSERT_EQ(4U, shardVersions.size());
+    for (int shard = 0; shard < 4; ++shard) {
+        // The last chunk on each shard has the highest version
+        const int lastChunk = numChunks - 1 - ((numChunks - 1 - shard) % 4);
+        ASSERT_EQ(ChunkVersion(lastChunk + 1, 0, _epoch).toString(),
+                  shardVersions.at(ShardId(str::stream() << shard)).toString());
+    }
+}
+
+TEST_F(ChunkMapTest, SplitLeavesPreviousVersionIntact) {
+    const int numChunks = 2 * ChunkMap::kMaxBlockSize;
+    const auto map = makeMap(numChunks, 2);
+
+    // Split the chunk [100, 110) in two
+    ChunkVersion version(numChunks + 1, 0, _epoch);
+    const auto left = makeChunk(key(10, numChunks), BSON("a" << 105), version, ShardId("0"));
+    version.incMinor();
+    const auto right = makeChunk(BSON("a" << 105), key(11, numChunks), version, ShardId("0"));
+
+    const auto updated = map.makeUpdated({left, right});
+    assertContiguous(updated, numChunks + 1);
+    ASSERT_EQ(left, updated.findIntersectingChunk(BSON("a" << 100)));
+    ASSERT_EQ(right, updated.findIntersectingChunk(BSON("a" << 105)));
+    ASSERT_EQ(version.toString(), updated.getShardVersions(_epoch).at(ShardId("0")).toString());
+
+    // The chunks which the split did not touch are the same objects
+    ASSERT_EQ(map.findIntersectingChunk(BSON("a" << 5000)),
+              updated.findIntersectingChunk(BSON("a" << 5000)));
+
+    assertContiguous(map, numChunks);
+    auto original = map.findIntersectingChunk(BSON("a" << 105));
+    ASSERT_BSONOBJ_EQ(key(10, numChunks), original->getMin());
+    ASSERT_BSONOBJ_EQ(key(11, numChunks), original->getMax());
+}
+
+TEST_F(ChunkMapTest, MergeAcrossBlocks) {
+    const int numChunks = 4 * ChunkMap::kMaxBlockSize;
+    const auto map = makeMap(numChunks, 3);
+
+    // Replace the chunks in the middle two blocks with a single one, owned by a new shard
+    const int first = ChunkMap::kMaxBlockSize - 3;
+    const int last = 3 * ChunkMap::kMaxBlockSize + 3;
+    const auto merged = makeChunk(key(first, numChunks),
+                                  key(last, numChunks),
+                                  ChunkVersion(numChunks + 1, 0, _epoch),
+                                  ShardId("new"));
+
+    const auto updated = map.makeUpdated({merged});
+    assertContiguous(updated, numChunks - (last - first) + 1);
+    ASSERT_EQ(merged, updated.findIntersectingChunk(BSON("a" << (first + 1) * 10)));
+    ASSERT_EQ(4U, updated.getShardVersions(_epoch).size());
+
+    std::set<ShardId> shardIds;
+    updated.getShardIdsForRange(BSON("a" << first * 10), BSON("a" << (last - 1) * 10), &shardIds);
+    ASSERT_EQ(1U, shardIds.size());
+    ASSERT_EQ(ShardId("new"), *shardIds.begin());
+
+    assertContiguous(map, numChunks);
+}
+
+TEST_F(ChunkMapTest, ShardIdsForRange) {
+    const int numChunks = 3 * ChunkMap::kMaxBlockSize;
+    const auto map = makeMap(numChunks, 5);
+
+    std::set<ShardId> shardIds;
+    map.getShardIdsForRange(BSON("a" << 10), BSON("a" << 10), &shardIds);
+    ASSERT_EQ(1U, shardIds.size());
+    ASSERT_EQ(ShardId("1"), *shardIds.begin());
+
+    // Both bounds are inclusive
+    shardIds.clear();
+    map.getShardIdsForRange(BSON("a" << 10), BSON("a" << 30), &shardIds);
+    ASSERT_EQ(3U, shardIds.size());
+
+    shardIds.clear();
+    map.getShardIdsForRange(BSON("a" << MINKEY), BSON("a" << MAXKEY), &shardIds);
+    ASSERT_EQ(5U, shardIds.size());
+}
+
+TEST_F(ChunkMapTest, GapIsRejected) {
+    const int numChunks = 2 * ChunkMap::kMaxBlockSize;
+    const auto map = makeMap(numChunks, 2);
+
+    // Overlaps only part of chunk [100, 110), leaving a gap after it
+    const auto chunk = makeChunk(
+        key(10, numChunks), BSON("a" << 105), ChunkVersion(numChunks + 1, 0, _epoch), ShardId("0"));
+    ASSERT_THROWS_CODE(
+        map.makeUpdated({chunk}), AssertionException, ErrorCodes::ConflictingOperationInProgress);
+}
+
+TEST_F(ChunkMapTest, MissingGlobalMinIsRejected) {
+    const auto chunk =
+        makeChunk(BSON("a" << 0), BSON("a" << MAXKEY), ChunkVersion(1, 0, _epoch), ShardId("0"));
+    ASSERT_THROWS_CODE(ChunkMap().makeUpdated({chunk}),
+                       AssertionException,
+                       ErrorCodes::ConflictingOperationInProgress);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -326,6 +326,18 @@ void ShardRegistry::replicaSetChangeShardRegistryUpdateHook(
     grid.shardRegistry()->updateReplSetHosts(connString);
 }
 
+void ShardRegistry::replicaSetChangePrimaryWarmUpHook(const std::string& setName,
+                                                      const HostAndPort& newPrimary) {
+    // The executor pool is not available until sharding has been initialized.
+    auto executorPool = grid.getExecutorPool();
+    if (!executorPool) {
+        return;
+    }
+
+    LOG(1) << "warming up connections to new primary " << newPrimary << " of " << setName;
+    executorPool->warmUpConnections(newPrimary);
+}
+
 void ShardRegistry::replicaSetChangeConfigServerUpdateHook(const std::string& setName,
                                                            const std::string& newConnectionString) {
     // This is run in it's own thread. Exceptions escaping would result in a call to terminate.
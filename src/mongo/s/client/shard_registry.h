@@ -252,6 +252,15 @@ public:
     static void replicaSetChangeShardRegistryUpdateHook(const std::string& setName,
                                                         const std::string& newConnectionString);
 
+    /**
+     * For use in mongos to start establishing connections to a newly seen replica set primary
+     * before requests are routed to it.
+     *
+     * This is expected to be run in an existing thread.
+     */
+    static void replicaSetChangePrimaryWarmUpHook(const std::string& setName,
+                                                  const HostAndPort& newPrimary);
+
     /**
      * For use in mongos which needs notifications about changes to shard replset membership to
      * update the config.shards collection.
@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/client/shard_registry.h"
@@ -49,15 +50,20 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Maximum number of fields of a sort, whose sort keys can be encoded as KeyString. This is the
+// number of fields an Ordering can describe.
+const int kMaxKeyStringSortFields = 32;
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
                                        executor::TaskExecutor* executor,
                                        ClusterClientCursorParams* params)
-    : _opCtx(opCtx),
-      _executor(executor),
-      _params(params),
-      _mergeQueue(MergingComparator(_remotes, _params->sort)) {
+    : _opCtx(opCtx), _executor(executor), _params(params) {
+    if (!_params->sort.isEmpty() && _params->sort.nFields() <= kMaxKeyStringSortFields) {
+        _sortKeyOrdering = Ordering::make(_params->sort);
+    }
+
     size_t remoteIndex = 0;
     for (const auto& remote : _params->remotes) {
         _remotes.emplace_back(remote.hostAndPort,
@@ -66,10 +72,15 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
 
         // We don't check the return value of _addBatchToBuffer here; if there was an error,
         // it will be stored in the remote and the first call to ready() will return true.
-        _addBatchToBuffer(WithLock::withoutLock(), remoteIndex, remote.cursorResponse.getBatch());
+        const auto& batch = remote.cursorResponse.getBatch();
+        _addBatchToBuffer(WithLock::withoutLock(), remoteIndex, batch, _computeSortKeys(batch));
         ++remoteIndex;
     }
 
+    if (!_params->sort.isEmpty() && !_remotes.empty()) {
+        _mergeTree.emplace(_remotes.size());
+    }
+
     // Initialize command metadata to handle the read preference. We do this in case the readPref
     // is primaryOnly, in which case if the remote host for one of the cursors changes roles, the
     // remote will return an error.
@@ -204,25 +215,37 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     // Tailable cursors cannot have a sort.
     invariant(_params->tailableMode == TailableMode::kNormal);
 
-    if (_mergeQueue.empty()) {
+    if (!_mergeTree) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
+    const auto sortsBefore = [this](size_t lhs, size_t rhs) { return _sortsBefore(lhs, rhs); };
+
+    if (_mergeTreeNeedsRebuild) {
+        _mergeTree->rebuild(sortsBefore);
+        _mergeTreeNeedsRebuild = false;
+    }
 
-    invariant(!_remotes[smallestRemote].docBuffer.empty());
-    invariant(_remotes[smallestRemote].status.isOK());
+    // Remotes without buffered results lose against all others, so if the winner has none, then
+    // no remote has any.
+    const size_t smallestRemote = _mergeTree->winner();
+    auto& remote = _remotes[smallestRemote];
+    if (!remote.hasNext()) {
+        return {};
+    }
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    invariant(remote.status.isOK());
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+    ClusterQueryResult front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+    if (!remote.sortKeyBuffer.empty()) {
+        remote.sortKeyBuffer.pop();
     }
 
+    // Advancing the winner is the only change to the buffered results that a replay can account
+    // for.
+    _mergeTree->replayWinner(sortsBefore);
+
     return front;
 }
 
@@ -284,8 +307,13 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
 
     auto callbackStatus =
         _executor->scheduleRemoteCommand(request, [this, remoteIndex](auto const& cbData) {
+            // Parse the response and encode its sort keys before acquiring the mutex, so responses
+            // from different remotes are processed in parallel on the threads that receive them,
+            // rather than one at a time while blocking the thread consuming the merged results.
+            auto parsedBatch = this->_parseBatch(cbData.response);
+
             stdx::lock_guard<stdx::mutex> lk(this->_mutex);
-            this->_handleBatchResponse(lk, cbData, remoteIndex);
+            this->_handleBatchResponse(lk, std::move(parsedBatch), remoteIndex);
         });
 
     if (!callbackStatus.isOK()) {
@@ -353,16 +381,24 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
     return eventToReturn;
 }
 
-StatusWith<CursorResponse> AsyncResultsMerger::_parseCursorResponse(
-    const BSONObj& responseObj, const RemoteCursorData& remote) {
+void AsyncResultsMerger::prefetchNextBatches() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    auto getMoreParseStatus = CursorResponse::parseFromBSON(responseObj);
-    if (!getMoreParseStatus.isOK()) {
-        return getMoreParseStatus.getStatus();
+    if (_lifecycleState != kAlive || _params->tailableMode != TailableMode::kNormal) {
+        return;
     }
 
-    auto cursorResponse = std::move(getMoreParseStatus.getValue());
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        auto& remote = _remotes[i];
+        if (remote.status.isOK() && !remote.hasNext() && !remote.exhausted() &&
+            !remote.cbHandle.isValid()) {
+            remote.status = _askForNextBatch(lk, i);
+        }
+    }
+}
 
+Status AsyncResultsMerger::_checkCursorId(const CursorResponse& cursorResponse,
+                                          const RemoteCursorData& remote) {
     // If we get a non-zero cursor id that is not equal to the established cursor id, we will fail
     // the operation.
     if (cursorResponse.getCursorId() != 0 && remote.cursorId != cursorResponse.getCursorId()) {
@@ -371,11 +407,66 @@ StatusWith<CursorResponse> AsyncResultsMerger::_parseCursorResponse(
                                     << cursorResponse.getCursorId());
     }
 
-    return std::move(cursorResponse);
+    return Status::OK();
+}
+
+AsyncResultsMerger::ParsedBatch AsyncResultsMerger::_parseBatch(CbResponse const& response) const {
+    ParsedBatch parsedBatch;
+
+    if (!response.isOK()) {
+        parsedBatch.cursorResponse = response.status;
+        return parsedBatch;
+    }
+
+    try {
+        parsedBatch.cursorResponse = CursorResponse::parseFromBSON(response.data);
+        if (parsedBatch.cursorResponse.isOK()) {
+            parsedBatch.sortKeys =
+                _computeSortKeys(parsedBatch.cursorResponse.getValue().getBatch());
+        }
+    } catch (const DBException& e) {
+        parsedBatch.cursorResponse = e.toStatus();
+    }
+
+    return parsedBatch;
+}
+
+StatusWith<std::vector<std::string>> AsyncResultsMerger::_computeSortKeys(
+    std::vector<BSONObj> const& batch) const {
+    std::vector<std::string> sortKeys;
+    if (_params->sort.isEmpty()) {
+        return std::move(sortKeys);
+    }
+
+    if (_sortKeyOrdering) {
+        sortKeys.reserve(batch.size());
+    }
+
+    for (const auto& obj : batch) {
+        // If there's a sort, we're expecting the remote node to have given us back a sort key.
+        const auto sortKeyElt = obj[ClusterClientCursorParams::kSortKeyField];
+        if (sortKeyElt.type() != BSONType::Object) {
+            return Status(ErrorCodes::InternalError,
+                          str::stream() << "Missing field '"
+                                        << ClusterClientCursorParams::kSortKeyField
+                                        << "' in document: "
+                                        << obj);
+        }
+
+        // This does not need to sort with a collator, since mongod has already mapped strings to
+        // their ICU comparison keys as part of the $sortKey meta projection. KeyString ignores
+        // field names, just like the comparison of the sort keys as BSON does.
+        if (_sortKeyOrdering) {
+            const KeyString ks(KeyString::Version::V1, sortKeyElt.Obj(), *_sortKeyOrdering);
+            sortKeys.emplace_back(ks.getBuffer(), ks.getSize());
+        }
+    }
+
+    return std::move(sortKeys);
 }
 
 void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
-                                              CbData const& cbData,
+                                              ParsedBatch parsedBatch,
                                               size_t remoteIndex) {
     // Got a response from remote, so indicate we are no longer waiting for one.
     _remotes[remoteIndex].cbHandle = executor::TaskExecutor::CallbackHandle();
@@ -387,7 +478,7 @@ void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
         return;
     }
     try {
-        _processBatchResults(lk, cbData.response, remoteIndex);
+        _processBatchResults(lk, std::move(parsedBatch), remoteIndex);
     } catch (DBException const& e) {
         _remotes[remoteIndex].status = e.toStatus();
     }
@@ -424,31 +515,37 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
         remote.cursorId = 0;
+
+        _mergeTreeNeedsRebuild = true;
     }
 }
 
 void AsyncResultsMerger::_processBatchResults(WithLock lk,
-                                              CbResponse const& response,
+                                              ParsedBatch parsedBatch,
                                               size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
-    if (!response.isOK()) {
-        _cleanUpFailedBatch(lk, response.status, remoteIndex);
+    if (!parsedBatch.cursorResponse.isOK()) {
+        _cleanUpFailedBatch(lk, parsedBatch.cursorResponse.getStatus(), remoteIndex);
         return;
     }
-    auto cursorResponseStatus = _parseCursorResponse(response.data, remote);
-    if (!cursorResponseStatus.isOK()) {
-        _cleanUpFailedBatch(lk, cursorResponseStatus.getStatus(), remoteIndex);
+
+    const CursorResponse& cursorResponse = parsedBatch.cursorResponse.getValue();
+
+    auto cursorIdStatus = _checkCursorId(cursorResponse, remote);
+    if (!cursorIdStatus.isOK()) {
+        _cleanUpFailedBatch(lk, std::move(cursorIdStatus), remoteIndex);
         return;
     }
 
-    CursorResponse cursorResponse = std::move(cursorResponseStatus.getValue());
-
     // Update the cursorId; it is sent as '0' when the cursor has been exhausted on the shard.
     remote.cursorId = cursorResponse.getCursorId();
 
     // Save the batch in the remote's buffer.
-    if (!_addBatchToBuffer(lk, remoteIndex, cursorResponse.getBatch())) {
+    if (!_addBatchToBuffer(
+            lk, remoteIndex, cursorResponse.getBatch(), std::move(parsedBatch.sortKeys))) {
         return;
     }
 
@@ -474,29 +571,28 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
 
 bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            size_t remoteIndex,
-                                           std::vector<BSONObj> const& batch) {
+                                           std::vector<BSONObj> const& batch,
+                                           StatusWith<std::vector<std::string>> sortKeys) {
     auto& remote = _remotes[remoteIndex];
-    for (const auto& obj : batch) {
-        // If there's a sort, we're expecting the remote node to have given us back a sort key.
-        if (!_params->sort.isEmpty() &&
-            obj[ClusterClientCursorParams::kSortKeyField].type() != BSONType::Object) {
-            remote.status = Status(ErrorCodes::InternalError,
-                                   str::stream() << "Missing field '"
-                                                 << ClusterClientCursorParams::kSortKeyField
-                                                 << "' in document: "
-                                                 << obj);
-            return false;
-        }
+    if (!sortKeys.isOK()) {
+        remote.status = sortKeys.getStatus();
+        return false;
+    }
 
+    for (const auto& obj : batch) {
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
     }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the
-    // merge queue.
+    for (auto& sortKey : sortKeys.getValue()) {
+        remote.sortKeyBuffer.push(std::move(sortKey));
+    }
+
+    // If we're doing a sorted merge, then the remote which got the results was not the winner of
+    // the merge tree, so the tree has to be rebuilt.
     if (!_params->sort.isEmpty() && !batch.empty()) {
-        _mergeQueue.push(remoteIndex);
+        _mergeTreeNeedsRebuild = true;
     }
     return true;
 }
@@ -608,19 +704,32 @@ std::shared_ptr<Shard> AsyncResultsMerger::RemoteCursorData::getShard() {
 }
 
 //
-// AsyncResultsMerger::MergingComparator
+// Sorted merge
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
+bool AsyncResultsMerger::_sortsBefore(size_t lhs, size_t rhs) const {
+    const auto& left = _remotes[lhs];
+    const auto& right = _remotes[rhs];
+
+    if (!left.hasNext()) {
+        return false;
+    }
+    if (!right.hasNext()) {
+        return true;
+    }
+
+    if (_sortKeyOrdering) {
+        return left.sortKeyBuffer.front() < right.sortKeyBuffer.front();
+    }
 
-    BSONObj leftDocKey = (*leftDoc.getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
-    BSONObj rightDocKey = (*rightDoc.getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
+    BSONObj leftDocKey =
+        (*left.docBuffer.front().getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
+    BSONObj rightDocKey =
+        (*right.docBuffer.front().getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
 
     // This does not need to sort with a collator, since mongod has already mapped strings to their
     // ICU comparison keys as part of the $sortKey meta projection.
-    return leftDocKey.woCompare(rightDocKey, _sort, false /*considerFieldName*/) > 0;
+    return leftDocKey.woCompare(rightDocKey, _params->sort, false /*considerFieldName*/) < 0;
 }
 
 }  // namespace mongo
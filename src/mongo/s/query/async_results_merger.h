@@ -30,15 +30,19 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/query/cursor_response.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
 #include "mongo/s/query/cluster_query_result.h"
+#include "mongo/s/query/loser_tree.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
@@ -80,8 +84,8 @@ public:
      * the hosts on which they exist in _remotes.
      *
      * Additionally copies each remote's first batch of results, if one exists, into that remote's
-     * docBuffer. If a sort is specified in the ClusterClientCursorParams, places the remotes with
-     * buffered results onto _mergeQueue.
+     * docBuffer. If a sort is specified in the ClusterClientCursorParams, the sort keys of the
+     * results are encoded as KeyString while they are buffered and merged through _mergeTree.
      *
      * The TaskExecutor* must remain valid for the lifetime of the ARM.
      *
@@ -178,6 +182,17 @@ public:
      */
     StatusWith<executor::TaskExecutor::EventHandle> nextEvent();
 
+    /**
+     * Asks each remote which has no buffered results, is not exhausted and has no outstanding
+     * request for its next batch, without creating an event to wait for them. Used once the
+     * caller has returned a batch of results to its client, so that the next batch is being
+     * retrieved while the client processes this one. Does nothing if the cursor is tailable, as
+     * the batches of remote tailable cursors are passed through to the client as they arrive.
+     *
+     * An error scheduling the work is reported by the next call to nextReady().
+     */
+    void prefetchNextBatches();
+
     /**
      * Starts shutting down this ARM by canceling all pending requests. Returns a handle to an event
      * that is signaled when this ARM is safe to destroy.
@@ -243,6 +258,10 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // If there is a sort, which can be encoded as KeyString, contains the encoded sort key of
+        // each result in 'docBuffer', in the same order.
+        std::queue<std::string> sortKeyBuffer;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -255,28 +274,48 @@ private:
         long long fetchedCount = 0;
     };
 
-    class MergingComparator {
-    public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes, const BSONObj& sort)
-            : _remotes(remotes), _sort(sort) {}
-
-        bool operator()(const size_t& lhs, const size_t& rhs);
+    using CbResponse = executor::TaskExecutor::ResponseStatus;
 
-    private:
-        const std::vector<RemoteCursorData>& _remotes;
+    /**
+     * The results of a batch received from a remote, parsed outside of '_mutex' on the thread
+     * which received the response.
+     */
+    struct ParsedBatch {
+        // The parsed response or the error from receiving or parsing it.
+        StatusWith<CursorResponse> cursorResponse{ErrorCodes::InternalError, "uninitialized"};
 
-        const BSONObj& _sort;
+        // The encoded sort key of each result in the batch, as computed by _computeSortKeys.
+        StatusWith<std::vector<std::string>> sortKeys{std::vector<std::string>()};
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
 
     /**
-     * Parses the find or getMore command response object to a CursorResponse.
-     *
-     * Returns a non-OK response if the response fails to parse or if there is a cursor id mismatch.
+     * Returns a non-OK status if the cursor id in a find or getMore command response does not
+     * match the one established for the remote.
      */
-    static StatusWith<CursorResponse> _parseCursorResponse(const BSONObj& responseObj,
-                                                           const RemoteCursorData& remote);
+    static Status _checkCursorId(const CursorResponse& cursorResponse,
+                                 const RemoteCursorData& remote);
+
+    /**
+     * Parses a response received from a remote and precomputes the sort keys of its results. Only
+     * reads '_params', so it does not need to be called under '_mutex'.
+     */
+    ParsedBatch _parseBatch(CbResponse const& response) const;
+
+    /**
+     * If there is a sort, verifies that every document in 'batch' has a sort key and, if the sort
+     * can be encoded as KeyString, returns the encoded sort keys so that merging only needs to
+     * compare bytes. Returns no keys if there is no sort or it cannot be encoded.
+     */
+    StatusWith<std::vector<std::string>> _computeSortKeys(std::vector<BSONObj> const& batch) const;
+
+    /**
+     * Returns true if the next buffered result of the remote at 'lhs' must be returned before
+     * that of the remote at 'rhs' according to the sort. Remotes without buffered results sort
+     * after all others.
+     */
+    bool _sortsBefore(size_t lhs, size_t rhs) const;
 
     /**
      * Helper to schedule a command asking the remote node for another batch of results.
@@ -308,9 +347,6 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
-    using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
-    using CbResponse = executor::TaskExecutor::ResponseStatus;
-
     /**
      * When nextEvent() schedules remote work, the callback uses this function to process results.
      *
@@ -318,7 +354,7 @@ private:
      * indicates which node the response came from and where the new result documents should be
      * buffered.
      */
-    void _handleBatchResponse(WithLock, CbData const&, size_t remoteIndex);
+    void _handleBatchResponse(WithLock, ParsedBatch parsedBatch, size_t remoteIndex);
 
     /**
      * Cleans up if the remote cursor was killed while waiting for a response.
@@ -333,13 +369,16 @@ private:
     /**
      * Processes results from a remote query.
      */
-    void _processBatchResults(WithLock, CbResponse const&, size_t remoteIndex);
+    void _processBatchResults(WithLock, ParsedBatch parsedBatch, size_t remoteIndex);
 
     /**
-     * Adds the batch of results to the RemoteCursorData. Returns false if there was an error
-     * parsing the batch.
+     * Adds the batch of results along with their sort keys, as returned by _computeSortKeys, to
+     * the RemoteCursorData. Returns false if there was an error computing the sort keys.
      */
-    bool _addBatchToBuffer(WithLock, size_t remoteIndex, std::vector<BSONObj> const& batch);
+    bool _addBatchToBuffer(WithLock,
+                           size_t remoteIndex,
+                           std::vector<BSONObj> const& batch,
+                           StatusWith<std::vector<std::string>> sortKeys);
 
     /**
      * If there is a valid unsignaled event that has been requested via nextReady() and there are
@@ -374,9 +413,17 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // Ordering for the KeyString encoding of the sort keys. Not set if there is no sort or if the
+    // sort has more fields than KeyString supports, in which case sort keys are compared as BSON.
+    boost::optional<Ordering> _sortKeyOrdering;
+
+    // The winner of this tree is the index into '_remotes' for the remote host that has the next
+    // document to return, according to the sort order. Used only if there is a sort.
+    boost::optional<LoserTree> _mergeTree;
+
+    // Set when the buffered results of a remote other than the winner of '_mergeTree' changed, so
+    // the tree must be rebuilt before it is used again.
+    bool _mergeTreeNeedsRebuild = true;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
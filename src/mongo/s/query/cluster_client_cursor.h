@@ -127,6 +127,12 @@ public:
      */
     virtual Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) = 0;
 
+    /**
+     * Starts retrieving the next batches of the remote cursors whose results have all been
+     * returned, without waiting for them. Must be called while attached to an operation context.
+     */
+    virtual void prefetchNextBatches() = 0;
+
     /**
      * Returns the logical session id for this cursor.
      */
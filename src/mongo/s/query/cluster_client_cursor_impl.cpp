@@ -137,6 +137,10 @@ Status ClusterClientCursorImpl::setAwaitDataTimeout(Milliseconds awaitDataTimeou
     return _root->setAwaitDataTimeout(awaitDataTimeout);
 }
 
+void ClusterClientCursorImpl::prefetchNextBatches() {
+    _root->prefetchNextBatches();
+}
+
 boost::optional<LogicalSessionId> ClusterClientCursorImpl::getLsid() const {
     return _lsid;
 }
@@ -65,6 +65,8 @@ public:
 
     Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) final;
 
+    void prefetchNextBatches() final;
+
     boost::optional<LogicalSessionId> getLsid() const final;
 
     /**
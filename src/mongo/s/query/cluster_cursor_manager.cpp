@@ -34,6 +34,7 @@
 #include "mongo/s/query/cluster_cursor_manager.h"
 
 #include <set>
+#include <utility>
 
 #include "mongo/db/kill_sessions_common.h"
 #include "mongo/db/logical_session_cache.h"
@@ -170,6 +171,11 @@ Status ClusterCursorManager::PinnedCursor::setAwaitDataTimeout(Milliseconds awai
     return _cursor->setAwaitDataTimeout(awaitDataTimeout);
 }
 
+void ClusterCursorManager::PinnedCursor::prefetchNextBatches() {
+    invariant(_cursor);
+    _cursor->prefetchNextBatches();
+}
+
 void ClusterCursorManager::PinnedCursor::returnAndKillCursor() {
     invariant(_cursor);
 
@@ -184,22 +190,26 @@ void ClusterCursorManager::PinnedCursor::returnAndKillCursor() {
     returnCursor(CursorState::NotExhausted);
 }
 
-ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource)
-    : _clockSource(clockSource),
-      _pseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {
+ClusterCursorManager::Partition::Partition()
+    : pseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {}
+
+ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource) : _clockSource(clockSource) {
     invariant(_clockSource);
 }
 
 ClusterCursorManager::~ClusterCursorManager() {
-    invariant(_cursorIdPrefixToNamespaceMap.empty());
-    invariant(_namespaceToContainerMap.empty());
+    for (const auto& partition : _partitions) {
+        invariant(partition.cursorIdPrefixToNamespaceMap.empty());
+        invariant(partition.namespaceToContainerMap.empty());
+        invariant(partition.idleMortalCursors.empty());
+        invariant(partition.killPendingCursors.empty());
+    }
 }
 
 void ClusterCursorManager::shutdown(OperationContext* opCtx) {
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _inShutdown = true;
-    }
+    // Cursors registered concurrently either see the flag, or are registered before
+    // killAllCursors() acquires the mutex of their partition.
+    _inShutdown.store(true);
     killAllCursors();
     reapZombieCursors(opCtx);
 }
@@ -213,9 +223,11 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const uint32_t partitionIndex = _nextPartition.fetchAndAdd(1) % kNumPartitions;
+    Partition& partition = _partitions[partitionIndex];
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex);
 
-    if (_inShutdown) {
+    if (_inShutdown.load()) {
         lk.unlock();
         cursor->kill(opCtx);
         return Status(ErrorCodes::ShutdownInProgress,
@@ -225,21 +237,24 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     invariant(cursor);
 
     // Find the CursorEntryContainer for this namespace.  If none exists, create one.
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto& namespaceToContainerMap = partition.namespaceToContainerMap;
+    auto& cursorIdPrefixToNamespaceMap = partition.cursorIdPrefixToNamespaceMap;
+    auto nsToContainerIt = namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == namespaceToContainerMap.end()) {
         uint32_t containerPrefix = 0;
         do {
             // The server has always generated positive values for CursorId (which is a signed
             // type), so we use std::abs() here on the prefix for consistency with this historical
-            // behavior.
-            containerPrefix = static_cast<uint32_t>(std::abs(_pseudoRandom.nextInt32()));
-        } while (_cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
-        _cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
+            // behavior. The prefix is then rounded down to one which maps to this partition.
+            containerPrefix = static_cast<uint32_t>(std::abs(partition.pseudoRandom.nextInt32()));
+            containerPrefix = containerPrefix - containerPrefix % kNumPartitions + partitionIndex;
+        } while (cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
+        cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
 
         auto emplaceResult =
-            _namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
+            namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
         invariant(emplaceResult.second);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        invariant(namespaceToContainerMap.size() == cursorIdPrefixToNamespaceMap.size());
 
         nsToContainerIt = emplaceResult.first;
     } else {
@@ -251,7 +266,7 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     CursorEntryMap& entryMap = container.entryMap;
     CursorId cursorId = 0;
     do {
-        const uint32_t cursorSuffix = static_cast<uint32_t>(_pseudoRandom.nextInt32());
+        const uint32_t cursorSuffix = static_cast<uint32_t>(partition.pseudoRandom.nextInt32());
         cursorId = createCursorId(container.containerPrefix, cursorSuffix);
     } while (cursorId == 0 || entryMap.count(cursorId) > 0);
 
@@ -260,19 +275,24 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
         entryMap.emplace(cursorId, CursorEntry(std::move(cursor), cursorType, cursorLifetime, now));
     invariant(emplaceResult.second);
 
+    if (cursorLifetime == CursorLifetime::Mortal) {
+        partition.idleMortalCursors.emplace(now, cursorId);
+    }
+
     return cursorId;
 }
 
 StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCursor(
     const NamespaceString& nss, CursorId cursorId, OperationContext* opCtx) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition& partition = _getPartition(cursorId);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-    if (_inShutdown) {
+    if (_inShutdown.load()) {
         return Status(ErrorCodes::ShutdownInProgress,
                       "Cannot check out cursor as we are in the process of shutting down");
     }
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -293,6 +313,11 @@ StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCur
     // return before the end of this function.  Be careful to avoid any early returns/throws after
     // this point.
 
+    // A pinned cursor can't time out.
+    if (entry->getLifetimeType() == CursorLifetime::Mortal) {
+        partition.idleMortalCursors.erase(std::make_pair(entry->getLastActive(), cursorId));
+    }
+
     // We use pinning of a cursor as a proxy for active, user-initiated use of a cursor.  Therefore,
     // we pass down to the logical session cache and vivify the record (updating last use).
     if (cursor->getLsid()) {
@@ -311,32 +336,40 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    Partition& partition = _getPartition(cursorId);
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex);
 
     invariant(cursor);
 
     const bool remotesExhausted = cursor->remotesExhausted();
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, partition, nss, cursorId);
     invariant(entry);
 
     entry->setLastActive(now);
     entry->returnCursor(std::move(cursor));
 
-    if (cursorState == CursorState::NotExhausted || entry->getKillPending()) {
+    if (entry->getKillPending()) {
+        return;
+    }
+
+    if (cursorState == CursorState::NotExhausted) {
+        if (entry->getLifetimeType() == CursorLifetime::Mortal) {
+            partition.idleMortalCursors.emplace(now, cursorId);
+        }
         return;
     }
 
     if (!remotesExhausted) {
         // The cursor still has open remote cursors that need to be cleaned up. Schedule for
         // deletion by the reaper thread by setting the kill pending flag.
-        entry->setKillPending();
+        _setKillPending(lk, partition, cursorId, entry);
         return;
     }
 
     // The cursor is exhausted, is not already scheduled for deletion, and does not have any
     // remote cursor state left to clean up. We can delete the cursor right away.
-    auto detachedCursor = _detachCursor(lk, nss, cursorId);
+    auto detachedCursor = _detachCursor(lk, partition, nss, cursorId);
     invariantOK(detachedCursor.getStatus());
 
     // Deletion of the cursor can happen out of the lock.
@@ -345,41 +378,48 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 }
 
 Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cursorId) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition& partition = _getPartition(cursorId);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
 
-    entry->setKillPending();
+    _setKillPending(lk, partition, cursorId, entry);
 
     return Status::OK();
 }
 
 void ClusterCursorManager::killMortalCursorsInactiveSince(Date_t cutoff) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorEntry& entry = cursorIdEntryPair.second;
-            if (entry.getLifetimeType() == CursorLifetime::Mortal && entry.isCursorOwned() &&
-                entry.getLastActive() <= cutoff) {
-                entry.setInactive();
-                log() << "Marking cursor id " << cursorIdEntryPair.first
-                      << " for deletion, idle since " << entry.getLastActive().toString();
-                entry.setKillPending();
-            }
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+        while (!partition.idleMortalCursors.empty() &&
+               partition.idleMortalCursors.begin()->first <= cutoff) {
+            const CursorId cursorId = partition.idleMortalCursors.begin()->second;
+            const auto nss = partition.cursorIdPrefixToNamespaceMap.find(
+                extractPrefixFromCursorId(cursorId));
+            invariant(nss != partition.cursorIdPrefixToNamespaceMap.end());
+            CursorEntry* entry = _getEntry(lk, partition, nss->second, cursorId);
+            invariant(entry && entry->isCursorOwned());
+
+            entry->setInactive();
+            log() << "Marking cursor id " << cursorId << " for deletion, idle since "
+                  << entry->getLastActive().toString();
+            _setKillPending(lk, partition, cursorId, entry);
         }
     }
 }
 
 void ClusterCursorManager::killAllCursors() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            cursorIdEntryPair.second.setKillPending();
+        for (auto& nsContainerPair : partition.namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                _setKillPending(lk, partition, cursorIdEntryPair.first, &cursorIdEntryPair.second);
+            }
         }
     }
 }
@@ -394,74 +434,75 @@ std::size_t ClusterCursorManager::reapZombieCursors(OperationContext* opCtx) {
         bool isInactive;
     };
 
-    // List all zombie cursors under the manager lock, and kill them one-by-one while not holding
-    // the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a lock while
-    // issuing the kill).
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    std::vector<CursorDescriptor> zombieCursorDescriptors;
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        const NamespaceString& nss = nsContainerPair.first;
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorId cursorId = cursorIdEntryPair.first;
-            const CursorEntry& entry = cursorIdEntryPair.second;
-            if (!entry.getKillPending()) {
-                continue;
-            }
-            zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
-        }
-    }
-
     std::size_t cursorsTimedOut = 0;
 
-    for (auto& cursorDescriptor : zombieCursorDescriptors) {
-        StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
-            _detachCursor(lk, cursorDescriptor.ns, cursorDescriptor.cursorId);
-        if (!zombieCursor.isOK()) {
-            // Cursor in use, or has already been deleted.
-            continue;
+    for (auto& partition : _partitions) {
+        // List all zombie cursors of the partition under its lock, and kill them one-by-one while
+        // not holding the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a
+        // lock while issuing the kill).
+        stdx::unique_lock<stdx::mutex> lk(partition.mutex);
+        std::vector<CursorDescriptor> zombieCursorDescriptors;
+        for (CursorId cursorId : partition.killPendingCursors) {
+            const auto nss = partition.cursorIdPrefixToNamespaceMap.find(
+                extractPrefixFromCursorId(cursorId));
+            invariant(nss != partition.cursorIdPrefixToNamespaceMap.end());
+            const CursorEntry* entry = _getEntry(lk, partition, nss->second, cursorId);
+            invariant(entry && entry->getKillPending());
+            zombieCursorDescriptors.emplace_back(nss->second, cursorId, entry->isInactive());
         }
 
-        lk.unlock();
-        // Pass opCtx to kill(), since a cursor which wraps an underlying aggregation pipeline is
-        // obliged to call Pipeline::dispose with a valid OperationContext prior to deletion.
-        zombieCursor.getValue()->kill(opCtx);
-        zombieCursor.getValue().reset();
-        lk.lock();
-
-        if (cursorDescriptor.isInactive) {
-            ++cursorsTimedOut;
+        for (auto& cursorDescriptor : zombieCursorDescriptors) {
+            StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
+                _detachCursor(lk, partition, cursorDescriptor.ns, cursorDescriptor.cursorId);
+            if (!zombieCursor.isOK()) {
+                // Cursor in use, or has already been deleted.
+                continue;
+            }
+
+            lk.unlock();
+            // Pass opCtx to kill(), since a cursor which wraps an underlying aggregation pipeline
+            // is obliged to call Pipeline::dispose with a valid OperationContext prior to
+            // deletion.
+            zombieCursor.getValue()->kill(opCtx);
+            zombieCursor.getValue().reset();
+            lk.lock();
+
+            if (cursorDescriptor.isInactive) {
+                ++cursorsTimedOut;
+            }
         }
     }
     return cursorsTimedOut;
 }
 
 ClusterCursorManager::Stats ClusterCursorManager::stats() const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
     Stats stats;
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Killed cursors do not count towards the number of pinned cursors or the number of
-                // open cursors.
-                continue;
-            }
-
-            if (!entry.isCursorOwned()) {
-                ++stats.cursorsPinned;
-            }
-
-            switch (entry.getCursorType()) {
-                case CursorType::SingleTarget:
-                    ++stats.cursorsSingleTarget;
-                    break;
-                case CursorType::MultiTarget:
-                    ++stats.cursorsMultiTarget;
-                    break;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+        for (auto& nsContainerPair : partition.namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Killed cursors do not count towards the number of pinned cursors or the
+                    // number of open cursors.
+                    continue;
+                }
+
+                if (!entry.isCursorOwned()) {
+                    ++stats.cursorsPinned;
+                }
+
+                switch (entry.getCursorType()) {
+                    case CursorType::SingleTarget:
+                        ++stats.cursorsSingleTarget;
+                        break;
+                    case CursorType::MultiTarget:
+                        ++stats.cursorsMultiTarget;
+                        break;
+                }
             }
         }
     }
@@ -470,20 +511,22 @@ ClusterCursorManager::Stats ClusterCursorManager::stats() const {
 }
 
 void ClusterCursorManager::appendActiveSessions(LogicalSessionIdSet* lsids) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (const auto& nsContainerPair : _namespaceToContainerMap) {
-        for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Don't include sessions for killed cursors.
-                continue;
-            }
-
-            auto lsid = entry.getLsid();
-            if (lsid) {
-                lsids->insert(*lsid);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+        for (const auto& nsContainerPair : partition.namespaceToContainerMap) {
+            for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Don't include sessions for killed cursors.
+                    continue;
+                }
+
+                auto lsid = entry.getLsid();
+                if (lsid) {
+                    lsids->insert(*lsid);
+                }
             }
         }
     }
@@ -502,22 +545,24 @@ Status ClusterCursorManager::killCursorsWithMatchingSessions(
 
 stdx::unordered_set<CursorId> ClusterCursorManager::getCursorsForSession(
     LogicalSessionId lsid) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
     stdx::unordered_set<CursorId> cursorIds;
 
-    for (auto&& nsContainerPair : _namespaceToContainerMap) {
-        for (auto&& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-            if (entry.getKillPending()) {
-                // Don't include sessions for killed cursors.
-                continue;
-            }
+        for (auto&& nsContainerPair : partition.namespaceToContainerMap) {
+            for (auto&& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Don't include sessions for killed cursors.
+                    continue;
+                }
 
-            auto cursorLsid = entry.getLsid();
-            if (lsid == cursorLsid) {
-                cursorIds.insert(cursorIdEntryPair.first);
+                auto cursorLsid = entry.getLsid();
+                if (lsid == cursorLsid) {
+                    cursorIds.insert(cursorIdEntryPair.first);
+                }
             }
         }
     }
@@ -527,20 +572,32 @@ stdx::unordered_set<CursorId> ClusterCursorManager::getCursorsForSession(
 
 boost::optional<NamespaceString> ClusterCursorManager::getNamespaceForCursorId(
     CursorId cursorId) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const Partition& partition = _getPartition(cursorId);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-    const auto it = _cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
-    if (it == _cursorIdPrefixToNamespaceMap.end()) {
+    const auto it =
+        partition.cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
+    if (it == partition.cursorIdPrefixToNamespaceMap.end()) {
         return boost::none;
     }
     return it->second;
 }
 
-auto ClusterCursorManager::_getEntry(WithLock, NamespaceString const& nss, CursorId cursorId)
-    -> CursorEntry* {
+auto ClusterCursorManager::_getPartition(CursorId cursorId) -> Partition& {
+    return _partitions[extractPrefixFromCursorId(cursorId) % kNumPartitions];
+}
+
+auto ClusterCursorManager::_getPartition(CursorId cursorId) const -> const Partition& {
+    return _partitions[extractPrefixFromCursorId(cursorId) % kNumPartitions];
+}
+
+auto ClusterCursorManager::_getEntry(WithLock,
+                                     Partition& partition,
+                                     NamespaceString const& nss,
+                                     CursorId cursorId) -> CursorEntry* {
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto nsToContainerIt = partition.namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == partition.namespaceToContainerMap.end()) {
         return nullptr;
     }
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
@@ -552,10 +609,25 @@ auto ClusterCursorManager::_getEntry(WithLock, NamespaceString const& nss, Curso
     return &entryMapIt->second;
 }
 
+void ClusterCursorManager::_setKillPending(WithLock,
+                                           Partition& partition,
+                                           CursorId cursorId,
+                                           CursorEntry* entry) {
+    if (entry->getKillPending()) {
+        return;
+    }
+
+    if (entry->getLifetimeType() == CursorLifetime::Mortal && entry->isCursorOwned()) {
+        partition.idleMortalCursors.erase(std::make_pair(entry->getLastActive(), cursorId));
+    }
+    entry->setKillPending();
+    partition.killPendingCursors.insert(cursorId);
+}
+
 StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::_detachCursor(
-    WithLock lk, NamespaceString const& nss, CursorId cursorId) {
+    WithLock lk, Partition& partition, NamespaceString const& nss, CursorId cursorId) {
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -565,8 +637,14 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::_detachCu
         return cursorInUseStatus(nss, cursorId);
     }
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    invariant(nsToContainerIt != _namespaceToContainerMap.end());
+    if (entry->getKillPending()) {
+        partition.killPendingCursors.erase(cursorId);
+    } else if (entry->getLifetimeType() == CursorLifetime::Mortal) {
+        partition.idleMortalCursors.erase(std::make_pair(entry->getLastActive(), cursorId));
+    }
+
+    auto nsToContainerIt = partition.namespaceToContainerMap.find(nss);
+    invariant(nsToContainerIt != partition.namespaceToContainerMap.end());
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
     size_t eraseResult = entryMap.erase(cursorId);
     invariant(1 == eraseResult);
@@ -574,10 +652,11 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::_detachCu
         // This was the last cursor remaining in the given namespace.  Erase all state associated
         // with this namespace.
         size_t numDeleted =
-            _cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
+            partition.cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
         invariant(numDeleted == 1);
-        _namespaceToContainerMap.erase(nsToContainerIt);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        partition.namespaceToContainerMap.erase(nsToContainerIt);
+        invariant(partition.namespaceToContainerMap.size() ==
+                  partition.cursorIdPrefixToNamespaceMap.size());
     }
 
     return std::move(cursor);
@@ -28,17 +28,22 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/kill_sessions.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/query/cluster_client_cursor.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/time_support.h"
 
@@ -64,6 +69,12 @@ class StatusWith;
  * with the kill*() suite of methods.  These simply mark the affected cursors as 'kill pending',
  * which can be cleaned up by later calls to the reapZombieCursors() method.
  *
+ * Cursors are spread over a fixed number of partitions, each with its own mutex, so that clients
+ * using different cursors rarely contend with each other. The partition of a cursor is encoded in
+ * the prefix of its id. Each partition indexes its idle mortal cursors by the time they were last
+ * active, and its 'kill pending' cursors, so that the periodic cleanup only visits the cursors it
+ * kills or reaps.
+ *
  * No public methods throw exceptions, and all public methods are thread-safe.
  *
  * TODO: Add maxTimeMS support.  SERVER-19410.
@@ -222,6 +233,13 @@ public:
          */
         Status setAwaitDataTimeout(Milliseconds awaitDataTimeout);
 
+        /**
+         * Starts retrieving the next batches of the remote cursors whose results have all been
+         * returned, without waiting for them. A cursor must be owned and attached to an operation
+         * context.
+         */
+        void prefetchNextBatches();
+
     private:
         // ClusterCursorManager is a friend so that its methods can call the PinnedCursor
         // constructor declared below, which is private to prevent clients from calling it directly.
@@ -378,15 +396,16 @@ public:
     boost::optional<NamespaceString> getNamespaceForCursorId(CursorId cursorId) const;
 
     void incrementCursorsTimedOut(size_t inc) {
-        _cursorsTimedOut += inc;
+        _cursorsTimedOut.fetchAndAdd(inc);
     }
 
     size_t cursorsTimedOut() const {
-        return _cursorsTimedOut;
+        return _cursorsTimedOut.load();
     }
 
 private:
     class CursorEntry;
+    struct Partition;
     using CursorEntryMap = stdx::unordered_map<CursorId, CursorEntry>;
 
     /**
@@ -409,12 +428,32 @@ private:
                        CursorState cursorState);
 
     /**
-     * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
-     * registered, returns null.
+     * Returns the partition which holds the cursor with the given id, whether or not it exists.
+     */
+    Partition& _getPartition(CursorId cursorId);
+    const Partition& _getPartition(CursorId cursorId) const;
+
+    /**
+     * Returns a pointer to the CursorEntry for the given cursor in 'partition', which must be the
+     * partition of 'cursorId'.  If the given cursor is not registered, returns null.
+     *
+     * Not thread-safe.
+     */
+    static CursorEntry* _getEntry(WithLock,
+                                  Partition& partition,
+                                  NamespaceString const& nss,
+                                  CursorId cursorId);
+
+    /**
+     * Marks the given cursor of 'partition' as 'kill pending', so that it is reaped by the next
+     * call to reapZombieCursors().
      *
      * Not thread-safe.
      */
-    CursorEntry* _getEntry(WithLock, NamespaceString const& nss, CursorId cursorId);
+    static void _setKillPending(WithLock,
+                                Partition& partition,
+                                CursorId cursorId,
+                                CursorEntry* entry);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -425,9 +464,8 @@ private:
      *
      * Not thread-safe.
      */
-    StatusWith<std::unique_ptr<ClusterClientCursor>> _detachCursor(WithLock,
-                                                                   NamespaceString const& nss,
-                                                                   CursorId cursorId);
+    static StatusWith<std::unique_ptr<ClusterClientCursor>> _detachCursor(
+        WithLock, Partition& partition, NamespaceString const& nss, CursorId cursorId);
 
     /**
      * CursorEntry is a moveable, non-copyable container for a single cursor.
@@ -539,38 +577,63 @@ private:
         CursorEntryMap entryMap;
     };
 
+    /**
+     * Partition is a non-copyable container for the cursors whose id prefix maps to it.
+     */
+    struct Partition {
+        MONGO_DISALLOW_COPYING(Partition);
+
+        Partition();
+
+        // Synchronizes access to all members below.
+        mutable stdx::mutex mutex;
+
+        // Randomness source.  Used for cursor id generation.
+        PseudoRandom pseudoRandom;
+
+        // Map from cursor id prefix to associated namespace.  Exists only to provide namespace
+        // lookup for (deprecated) getNamespaceForCursorId() method.
+        //
+        // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the
+        // first cursor on a given namespace is registered in a partition, it is given a CursorId
+        // with a prefix that is unique to that namespace and maps to the partition, and an
+        // arbitrary suffix.  Cursors subsequently registered on that namespace in the partition
+        // will all share the same prefix.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        stdx::unordered_map<uint32_t, NamespaceString> cursorIdPrefixToNamespaceMap;
+
+        // Map from namespace to the CursorEntryContainer for that namespace.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
+            namespaceToContainerMap;
+
+        // The mortal cursors which are neither pinned nor 'kill pending', ordered by the time they
+        // were last active, so that the ones to time out are found without visiting the others.
+        std::set<std::pair<Date_t, CursorId>> idleMortalCursors;
+
+        // The cursors which are 'kill pending', to be deleted by reapZombieCursors().
+        stdx::unordered_set<CursorId> killPendingCursors;
+    };
+
+    // Number of partitions over which cursors are spread.
+    static constexpr uint32_t kNumPartitions = 16;
+
     // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.  May be
     // concurrently accessed by multiple threads.
     ClockSource* _clockSource;
 
-    // Synchronizes access to all private state variables below.
-    mutable stdx::mutex _mutex;
+    AtomicBool _inShutdown{false};
 
-    bool _inShutdown{false};
+    // Used to spread newly registered cursors over the partitions in turn.
+    AtomicUInt32 _nextPartition;
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
-
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
-    //
-    // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
-    // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
-    // unique to that namespace, and an arbitrary suffix.  Cursors subsequently registered on that
-    // namespace will all share the same prefix.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
-
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
-        _namespaceToContainerMap;
+    std::array<Partition, kNumPartitions> _partitions;
 
-    size_t _cursorsTimedOut = 0;
+    AtomicUInt64 _cursorsTimedOut;
 };
 
 }  // namespace
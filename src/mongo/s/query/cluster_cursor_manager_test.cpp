@@ -479,6 +479,44 @@ TEST_F(ClusterCursorManagerTest, KillMortalCursorsInactiveSinceMultipleCursors)
     }
 }
 
+// Test that a cursor checked in after the cutoff is not killed, while one which stayed idle since
+// before the cutoff is, and that reaping counts the latter as timed out.
+TEST_F(ClusterCursorManagerTest, KillMortalCursorsInactiveSinceAfterCheckIn) {
+    auto activeCursorId =
+        assertGet(getManager()->registerCursor(nullptr,
+                                               allocateMockCursor(),
+                                               nss,
+                                               ClusterCursorManager::CursorType::SingleTarget,
+                                               ClusterCursorManager::CursorLifetime::Mortal));
+    ASSERT_OK(getManager()->registerCursor(nullptr,
+                                           allocateMockCursor(),
+                                           nss,
+                                           ClusterCursorManager::CursorType::SingleTarget,
+                                           ClusterCursorManager::CursorLifetime::Mortal));
+    Date_t cutoff = getClockSource()->now();
+    getClockSource()->advance(Milliseconds(1));
+    auto pin = assertGet(getManager()->checkOutCursor(nss, activeCursorId, _opCtx.get()));
+    pin.returnCursor(ClusterCursorManager::CursorState::NotExhausted);
+    getManager()->killMortalCursorsInactiveSince(cutoff);
+    ASSERT_EQ(1U, getManager()->reapZombieCursors(nullptr));
+    ASSERT(!isMockCursorKilled(0));
+    ASSERT(isMockCursorKilled(1));
+}
+
+// Test that a cursor which was killed before it expired is not counted as timed out.
+TEST_F(ClusterCursorManagerTest, KilledCursorIsNotTimedOut) {
+    auto cursorId =
+        assertGet(getManager()->registerCursor(nullptr,
+                                               allocateMockCursor(),
+                                               nss,
+                                               ClusterCursorManager::CursorType::SingleTarget,
+                                               ClusterCursorManager::CursorLifetime::Mortal));
+    ASSERT_OK(getManager()->killCursor(nss, cursorId));
+    getManager()->killMortalCursorsInactiveSince(getClockSource()->now());
+    ASSERT_EQ(0U, getManager()->reapZombieCursors(nullptr));
+    ASSERT(isMockCursorKilled(0));
+}
+
 // Test that killing all cursors successfully kills all cursors.
 TEST_F(ClusterCursorManagerTest, KillAllCursors) {
     const size_t numCursors = 10;
@@ -770,6 +808,31 @@ TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdMultipleCursorsDifferent
     }
 }
 
+// Test that many cursors on the same namespace, which are spread over the partitions of the
+// manager, can each be checked out, and that the namespace is forgotten once they are all deleted.
+TEST_F(ClusterCursorManagerTest, CheckOutManyCursorsSameNamespace) {
+    const size_t numCursors = 100;
+    std::vector<CursorId> cursorIds(numCursors);
+    for (size_t i = 0; i < numCursors; ++i) {
+        cursorIds[i] =
+            assertGet(getManager()->registerCursor(nullptr,
+                                                   allocateMockCursor(),
+                                                   nss,
+                                                   ClusterCursorManager::CursorType::SingleTarget,
+                                                   ClusterCursorManager::CursorLifetime::Mortal));
+    }
+    for (size_t i = 0; i < numCursors; ++i) {
+        auto pin = assertGet(getManager()->checkOutCursor(nss, cursorIds[i], _opCtx.get()));
+        ASSERT_EQ(cursorIds[i], pin.getCursorId());
+        ASSERT_EQ(nss.ns(), getManager()->getNamespaceForCursorId(cursorIds[i])->ns());
+        pin.returnCursor(ClusterCursorManager::CursorState::Exhausted);
+    }
+    for (size_t i = 0; i < numCursors; ++i) {
+        ASSERT_FALSE(getManager()->getNamespaceForCursorId(cursorIds[i]));
+    }
+    ASSERT_EQ(0U, getManager()->stats().cursorsSingleTarget);
+}
+
 // Test that getting the namespace for an unknown cursor returns boost::none.
 TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdUnknown) {
     boost::optional<NamespaceString> cursorNamespace = getManager()->getNamespaceForCursorId(5);
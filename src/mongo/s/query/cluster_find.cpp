@@ -51,6 +51,7 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_knobs.h"
 #include "mongo/s/query/establish_cursors.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
@@ -306,12 +307,18 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* opCtx,
         results->push_back(std::move(nextObj));
     }
 
-    ccc->detachFromOperationContext();
-
     if (!query.getQueryRequest().wantMore() && !ccc->isTailable()) {
         cursorState = ClusterCursorManager::CursorState::Exhausted;
     }
 
+    // The client is expected to ask for the rest of the results.
+    if (cursorState == ClusterCursorManager::CursorState::NotExhausted &&
+        internalQueryPrefetchShardBatches.load()) {
+        ccc->prefetchNextBatches();
+    }
+
+    ccc->detachFromOperationContext();
+
     // If the cursor is exhausted, then there are no more results to return and we don't need to
     // allocate a cursor id.
     if (cursorState == ClusterCursorManager::CursorState::Exhausted) {
@@ -467,6 +474,11 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
         batch.push_back(std::move(*next.getValue().getResult()));
     }
 
+    if (cursorState == ClusterCursorManager::CursorState::NotExhausted &&
+        internalQueryPrefetchShardBatches.load()) {
+        pinnedCursor.getValue().prefetchNextBatches();
+    }
+
     pinnedCursor.getValue().detachFromOperationContext();
 
     // Transfer ownership of the cursor back to the cursor manager.
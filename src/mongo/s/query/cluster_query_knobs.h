@@ -45,4 +45,9 @@ extern AtomicBool internalQueryAlwaysMergeOnPrimaryShard;
 // of merging on mongoS will always do so.
 extern AtomicBool internalQueryProhibitMergingOnMongoS;
 
+// If set to true on mongos, a find or getMore which leaves a non-tailable cursor open asks the
+// shards whose results have all been returned for their next batch before replying, so that the
+// next getMore can be answered without waiting for them. True by default.
+extern AtomicBool internalQueryPrefetchShardBatches;
+
 }  // namespace mongo
@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * Tournament tree for merging a fixed number of sorted input streams, identified by their index.
+ * The root holds the stream with the smallest current element and every internal node holds the
+ * loser of the match played there. Advancing the winning stream only replays the matches on the
+ * path from its leaf to the root, so producing each merged element costs about log2(size())
+ * comparisons - about half of what a binary heap needs.
+ *
+ * The tree does not look at the elements itself. The 'less' function passed to the methods below
+ * compares the current elements of two streams; streams which have no current element must
+ * compare greater than all others. Once the current element of any stream other than the winner
+ * changes, the tree must be rebuilt.
+ */
+class LoserTree {
+public:
+    explicit LoserTree(size_t numStreams) : _nodes(numStreams) {
+        invariant(numStreams > 0);
+    }
+
+    size_t size() const {
+        return _nodes.size();
+    }
+
+    /**
+     * Plays all the matches from scratch.
+     */
+    template <typename Less>
+    void rebuild(const Less& less) {
+        const size_t n = size();
+
+        // Leaves occupy positions [n, 2n) of an implicit complete binary tree, whose internal
+        // nodes are [1, n). Winners are only needed while building.
+        std::vector<size_t> winners(2 * n);
+        for (size_t i = 0; i < n; ++i) {
+            winners[n + i] = i;
+        }
+
+        for (size_t node = n - 1; node >= 1; --node) {
+            const size_t left = winners[2 * node];
+            const size_t right = winners[2 * node + 1];
+
+            if (less(right, left)) {
+                winners[node] = right;
+                _nodes[node] = left;
+            } else {
+                winners[node] = left;
+                _nodes[node] = right;
+            }
+        }
+
+        _nodes[0] = (n == 1) ? 0 : winners[1];
+    }
+
+    /**
+     * Returns the stream with the smallest current element.
+     */
+    size_t winner() const {
+        return _nodes[0];
+    }
+
+    /**
+     * Must be called after the current element of the winning stream has changed, in order to
+     * find the new winner.
+     */
+    template <typename Less>
+    void replayWinner(const Less& less) {
+        size_t winner = _nodes[0];
+
+        for (size_t node = (winner + size()) / 2; node >= 1; node /= 2) {
+            if (less(_nodes[node], winner)) {
+                std::swap(_nodes[node], winner);
+            }
+        }
+
+        _nodes[0] = winner;
+    }
+
+private:
+    // Position 0 is the overall winner, positions [1, size()) the internal nodes
+    std::vector<size_t> _nodes;
+};
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "mongo/s/query/loser_tree.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Merges 'streams', each of which must be sorted, through a LoserTree.
+ */
+std::vector<int> merge(std::vector<std::deque<int>> streams) {
+    const auto less = [&](size_t lhs, size_t rhs) {
+        if (streams[lhs].empty())
+            return false;
+        if (streams[rhs].empty())
+            return true;
+        return streams[lhs].front() < streams[rhs].front();
+    };
+
+    LoserTree tree(streams.size());
+    tree.rebuild(less);
+
+    std::vector<int> merged;
+    while (!streams[tree.winner()].empty()) {
+        merged.push_back(streams[tree.winner()].front());
+        streams[tree.winner()].pop_front();
+        tree.replayWinner(less);
+    }
+
+    return merged;
+}
+
+TEST(LoserTreeTest, SingleStream) {
+    ASSERT(std::vector<int>({1, 2, 3}) == merge({{1, 2, 3}}));
+    ASSERT(merge({{}}).empty());
+}
+
+TEST(LoserTreeTest, EmptyStreams) {
+    ASSERT(std::vector<int>({1, 2, 3}) == merge({{}, {1, 3}, {}, {2}, {}}));
+    ASSERT(merge({{}, {}, {}}).empty());
+}
+
+TEST(LoserTreeTest, DuplicateElements) {
+    ASSERT(std::vector<int>({1, 1, 1, 2, 2}) == merge({{1, 2}, {1}, {1, 2}}));
+}
+
+TEST(LoserTreeTest, RandomStreams) {
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> valueDist(0, 100);
+
+    for (size_t numStreams = 1; numStreams <= 70; ++numStreams) {
+        std::vector<std::deque<int>> streams(numStreams);
+        std::vector<int> expected;
+
+        for (auto& stream : streams) {
+            const size_t length = gen() % 20;
+            for (size_t i = 0; i < length; ++i) {
+                stream.push_back(valueDist(gen));
+            }
+
+            std::sort(stream.begin(), stream.end());
+            expected.insert(expected.end(), stream.begin(), stream.end());
+        }
+
+        std::sort(expected.begin(), expected.end());
+        ASSERT(expected == merge(std::move(streams)));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
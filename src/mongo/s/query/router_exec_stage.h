@@ -107,6 +107,17 @@ public:
         return doSetAwaitDataTimeout(awaitDataTimeout);
     }
 
+    /**
+     * Starts retrieving the next results from the remotes which have none buffered, without
+     * waiting for them. Must be called while the stage is attached to an operation context.
+     */
+    void prefetchNextBatches() {
+        if (_child) {
+            _child->prefetchNextBatches();
+        }
+        doPrefetchNextBatches();
+    }
+
     /**
      * Sets the current operation context to be used by the router stage.
      */
@@ -155,6 +166,11 @@ protected:
         return Status::OK();
     }
 
+    /**
+     * Performs any stage-specific prefetching of remote results.
+     */
+    virtual void doPrefetchNextBatches() {}
+
     /**
      * Returns an unowned pointer to the child stage, or nullptr if there is no child.
      */
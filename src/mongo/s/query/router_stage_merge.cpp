@@ -73,4 +73,8 @@ Status RouterStageMerge::doSetAwaitDataTimeout(Milliseconds awaitDataTimeout) {
     return _arm.setAwaitDataTimeout(awaitDataTimeout);
 }
 
+void RouterStageMerge::doPrefetchNextBatches() {
+    _arm.prefetchNextBatches();
+}
+
 }  // namespace mongo
@@ -56,6 +56,8 @@ public:
 protected:
     Status doSetAwaitDataTimeout(Milliseconds awaitDataTimeout) final;
 
+    void doPrefetchNextBatches() final;
+
 protected:
     void doReattachToOperationContext() override {
         _arm.reattachToOperationContext(getOpCtx());
@@ -375,6 +375,8 @@ static ExitCode runMongosServer() {
         &ShardRegistry::replicaSetChangeConfigServerUpdateHook);
     ReplicaSetMonitor::setSynchronousConfigChangeHook(
         &ShardRegistry::replicaSetChangeShardRegistryUpdateHook);
+    ReplicaSetMonitor::setSynchronousPrimaryChangeHook(
+        &ShardRegistry::replicaSetChangePrimaryWarmUpHook);
 
     // Mongos connection pools already takes care of authenticating new connections so the
     // replica set connection shouldn't need to.
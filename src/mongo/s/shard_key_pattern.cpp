@@ -131,7 +131,8 @@ Status ShardKeyPattern::checkShardKeySize(const BSONObj& shardKey) {
 ShardKeyPattern::ShardKeyPattern(const BSONObj& keyPattern)
     : _keyPatternPaths(parseShardKeyPattern(keyPattern)),
       _keyPattern(_keyPatternPaths.empty() ? BSONObj() : keyPattern),
-      _hasId(keyPattern.hasField("_id"_sd)) {}
+      _hasId(keyPattern.hasField("_id"_sd)),
+      _isHashed(isHashedPatternEl(_keyPattern.toBSON().firstElement())) {}
 
 ShardKeyPattern::ShardKeyPattern(const KeyPattern& keyPattern)
     : ShardKeyPattern(keyPattern.toBSON()) {}
@@ -141,7 +142,7 @@ bool ShardKeyPattern::isValid() const {
 }
 
 bool ShardKeyPattern::isHashedPattern() const {
-    return isHashedPatternEl(_keyPattern.toBSON().firstElement());
+    return _isHashed;
 }
 
 const KeyPattern& ShardKeyPattern::getKeyPattern() const {
@@ -255,8 +256,59 @@ BSONObj ShardKeyPattern::extractShardKeyFromMatchable(const MatchableDocument& m
 }
 
 BSONObj ShardKeyPattern::extractShardKeyFromDoc(const BSONObj& doc) const {
-    BSONMatchableDocument matchable(doc);
-    return extractShardKeyFromMatchable(matchable);
+    if (!isValid())
+        return BSONObj();
+
+    // Resolve the leading part of all the pre-parsed key pattern paths in a single pass over the
+    // top-level fields of the document, keeping the first occurrence of a field as getField()
+    // would, rather than walking a new ElementPath through the document for every path.
+    std::vector<BSONElement> keyEls(_keyPatternPaths.size());
+    size_t numUnresolved = keyEls.size();
+
+    BSONObjIterator docIt(doc);
+    while (docIt.more() && numUnresolved > 0) {
+        const BSONElement docEl = docIt.next();
+        const StringData fieldName = docEl.fieldNameStringData();
+
+        for (size_t i = 0; i < keyEls.size(); ++i) {
+            if (keyEls[i].eoo() && _keyPatternPaths[i]->getPart(0) == fieldName) {
+                keyEls[i] = docEl;
+                --numUnresolved;
+            }
+        }
+    }
+
+    BSONObjBuilder keyBuilder;
+    for (size_t i = 0; i < keyEls.size(); ++i) {
+        const FieldRef& patternPath = *_keyPatternPaths[i];
+        BSONElement keyEl = keyEls[i];
+
+        for (size_t part = 1; part < patternPath.numParts() && !keyEl.eoo(); ++part) {
+            if (keyEl.type() == Array) {
+                // Arrays along the path are subject to the ElementPath traversal rules, so leave
+                // those documents to the generic extraction.
+                BSONMatchableDocument matchable(doc);
+                return extractShardKeyFromMatchable(matchable);
+            }
+
+            keyEl = (keyEl.type() == Object) ? keyEl.embeddedObject()[patternPath.getPart(part)]
+                                             : BSONElement();
+        }
+
+        if (!isShardKeyElement(keyEl, true))
+            return BSONObj();
+
+        if (_isHashed) {
+            keyBuilder.append(
+                patternPath.dottedField(),
+                BSONElementHasher::hash64(keyEl, BSONElementHasher::DEFAULT_HASH_SEED));
+        } else {
+            keyBuilder.appendAs(keyEl, patternPath.dottedField());
+        }
+    }
+
+    dassert(isShardKey(keyBuilder.asTempObj()));
+    return keyBuilder.obj();
 }
 
 static BSONElement findEqualityElement(const EqualityMatches& equalities, const FieldRef& path) {
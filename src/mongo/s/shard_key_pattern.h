@@ -239,6 +239,9 @@ private:
     KeyPattern _keyPattern;
 
     bool _hasId;
+
+    // Whether the key pattern is a single hashed field, computed once at construction
+    bool _isHashed;
 };
 
 }  // namespace mongo
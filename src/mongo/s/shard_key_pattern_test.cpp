@@ -236,6 +236,36 @@ TEST(ShardKeyPattern, ExtractDocShardKeyDeepNested) {
                       BSONObj());
 }
 
+TEST(ShardKeyPattern, ExtractDocShardKeySharedPrefix) {
+    //
+    // Nested ShardKeyPatterns whose paths share a parent field
+    //
+
+    ShardKeyPattern pattern(BSON("a.b" << 1 << "a.c" << 1 << "d" << 1));
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{d:30, a:{c:20, b:10}}")),
+                      fromjson("{'a.b':10, 'a.c':20, d:30}"));
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{a:{b:10}, d:30}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{a:{b:10, c:20}}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{a:[{b:10, c:20}], d:30}")), BSONObj());
+}
+
+TEST(ShardKeyPattern, ExtractDocShardKeyMatchesMatchableExtraction) {
+    //
+    // Extracting from a document gives the same key as going through a MatchableDocument
+    //
+
+    ShardKeyPattern pattern(BSON("a.0" << 1 << "b.c" << 1));
+    for (auto&& doc : {fromjson("{a:{'0':10}, b:{c:20}}"),
+                       fromjson("{a:[10], b:{c:20}}"),
+                       fromjson("{a:[{'0':10}], b:{c:20}}"),
+                       fromjson("{a:{'0':10}, b:[{c:20}]}"),
+                       fromjson("{a:{'0':10}, b:{c:[20]}}"),
+                       fromjson("{a:10, b:{c:20}}")}) {
+        BSONMatchableDocument matchable(doc);
+        ASSERT_BSONOBJ_EQ(docKey(pattern, doc), pattern.extractShardKeyFromMatchable(matchable));
+    }
+}
+
 TEST(ShardKeyPattern, ExtractDocShardKeyHashed) {
     //
     // Hashed ShardKeyPattern
@@ -270,6 +270,11 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     int numTargetErrors = 0;
 
+    // Used to bound the extra targeting work done for unordered batches when some of the targeted
+    // batches have filled up, but others still have room
+    size_t numTargetedOps = 0;
+    size_t numSkippedOps = 0;
+
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
     for (size_t i = 0; i < numWriteOps; ++i) {
@@ -338,6 +343,15 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchSizes)) {
             invariant(!batchMap.empty());
             writeOp.cancelWrites(NULL);
+
+            // A full batch for one shard should not hold back the writes for the other shards in
+            // an unordered batch, otherwise every round is limited by the busiest shard. The
+            // skipped write stays ready and gets targeted again in the next round. Targeting is
+            // abandoned once it has skipped more writes than it has placed, so a round never costs
+            // much more than the writes it actually sends.
+            if (!ordered && ++numSkippedOps <= numTargetedOps)
+                continue;
+
             break;
         }
 
@@ -369,6 +383,8 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         // Relinquish ownership of TargetedWrites, now the TargetedBatches own them
         writesOwned.mutableVector().clear();
 
+        ++numTargetedOps;
+
         //
         // Break if we're ordered and we have more than one endpoint - later writes cannot be
         // enforced as ordered across multiple shard endpoints.
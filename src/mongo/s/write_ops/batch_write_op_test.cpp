@@ -1553,5 +1553,61 @@ TEST_F(BatchWriteOpLimitTests, OneBigOneSmall) {
     ASSERT(batchOp.isFinished());
 }
 
+// Unordered batch where the batch for one shard fills up - the writes for the other shard, which
+// come after the one that did not fit, should still be sent in the same round
+TEST_F(BatchWriteOpLimitTests, FullBatchDoesNotHoldBackOtherShardUnordered) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    // Two of these do not fit in a single batch
+    const std::string halfBigString(BSONObjMaxUserSize / 2, 'x');
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        insertOp.setDocuments({BSON("x" << -1 << "data" << halfBigString),
+                               BSON("x" << -2 << "data" << halfBigString),
+                               BSON("x" << 1)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 2u);
+    verifyTargetedBatches({{endpointA.shardName, 1u}, {endpointB.shardName, 1u}}, targeted);
+
+    BatchedCommandResponse response;
+    buildResponse(1, &response);
+
+    for (auto it = targeted.begin(); it != targeted.end(); ++it) {
+        batchOp.noteBatchResponse(*it->second, response, NULL);
+    }
+    ASSERT(!batchOp.isFinished());
+
+    // The write which did not fit goes out in the next round
+    targetedOwned.clear();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    verifyTargetedBatches({{endpointA.shardName, 1u}}, targeted);
+
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 3);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -394,19 +394,78 @@ private:
 };
 
 ScopeCache scopeCache;
+
+// Bumped by dropScopeCache() so that each thread drops its idle scope the next time it looks.
+AtomicInt64 threadScopeCacheGeneration(0);
+
+/**
+ * Keeps the last scope released on a thread, for scopes which run on the thread that created them.
+ * Reusing it saves creating a new JS runtime and compiling the same functions again for each
+ * operation.
+ */
+class ThreadScopeCache {
+public:
+    void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
+        _scope.reset();
+
+        if (scope->hasOutOfMemoryException() || scope->isKillPending() ||
+            !scope->getError().empty())
+            return;  // not saving scopes which may be in a bad state
+
+        if (scope->getTimesUsed() > kMaxScopeReuse)
+            return;  // used too many times to save
+
+        scope->reset();
+        _scope = scope;
+        _poolName = poolName;
+        _generation = threadScopeCacheGeneration.load();
+    }
+
+    std::shared_ptr<Scope> tryAcquire(OperationContext* opCtx, const string& poolName) {
+        if (!_scope || _generation != threadScopeCacheGeneration.load()) {
+            _scope.reset();
+            return std::shared_ptr<Scope>();
+        }
+
+        if (_poolName != poolName)
+            return std::shared_ptr<Scope>();
+
+        std::shared_ptr<Scope> scope = std::move(_scope);
+        scope->incTimesUsed();
+        scope->reset();
+        scope->registerOperation(opCtx);
+        return scope;
+    }
+
+private:
+    // Each thread keeps at most one scope, so it may be reused more often than the scopes
+    // shared by all threads.
+    static const int kMaxScopeReuse = 100;
+
+    std::shared_ptr<Scope> _scope;
+    string _poolName;
+    long long _generation = 0;
+};
+
+thread_local ThreadScopeCache threadScopeCache;
 }  // anonymous namespace
 
 void ScriptEngine::dropScopeCache() {
     scopeCache.clear();
+    threadScopeCacheGeneration.fetchAndAdd(1);
 }
 
 class PooledScope : public Scope {
 public:
-    PooledScope(const std::string& pool, const std::shared_ptr<Scope>& real)
-        : _pool(pool), _real(real) {}
+    PooledScope(const std::string& pool, const std::shared_ptr<Scope>& real, bool forCurrentThread)
+        : _pool(pool), _real(real), _forCurrentThread(forCurrentThread) {}
 
     virtual ~PooledScope() {
-        scopeCache.release(_pool, _real);
+        if (_forCurrentThread) {
+            threadScopeCache.release(_pool, _real);
+        } else {
+            scopeCache.release(_pool, _real);
+        }
     }
 
     // wrappers for the derived (_real) scope
@@ -539,6 +598,7 @@ protected:
 private:
     string _pool;
     std::shared_ptr<Scope> _real;
+    const bool _forCurrentThread;
 };
 
 /** Get a scope from the pool of scopes matching the supplied pool name */
@@ -553,7 +613,24 @@ unique_ptr<Scope> ScriptEngine::getPooledScope(OperationContext* opCtx,
     }
 
     unique_ptr<Scope> p;
-    p.reset(new PooledScope(fullPoolName, s));
+    p.reset(new PooledScope(fullPoolName, s, false));
+    p->setLocalDB(db);
+    p->loadStored(opCtx, true);
+    return p;
+}
+
+unique_ptr<Scope> ScriptEngine::getPooledScopeForCurrentThread(OperationContext* opCtx,
+                                                               const string& db,
+                                                               const string& scopeType) {
+    const string fullPoolName = db + scopeType;
+    std::shared_ptr<Scope> s = threadScopeCache.tryAcquire(opCtx, fullPoolName);
+    if (!s) {
+        s.reset(newScopeForCurrentThread());
+        s->registerOperation(opCtx);
+    }
+
+    unique_ptr<Scope> p;
+    p.reset(new PooledScope(fullPoolName, s, true));
     p->setLocalDB(db);
     p->loadStored(opCtx, true);
     return p;
@@ -262,6 +262,18 @@ public:
                                           const std::string& db,
                                           const std::string& scopeType);
 
+    /** gets the scope last released on this thread for the same db and scope type, or a new
+     * scope for the current thread if there is none. The scope runs on the calling thread, so
+     * unlike the scopes of getPooledScope() it must not be used from any other thread.
+     * @param db The db name
+     * @param scopeType A unique id to limit scope sharing.
+     *                  This must include authenticated users.
+     * @return the scope
+     */
+    std::unique_ptr<Scope> getPooledScopeForCurrentThread(OperationContext* opCtx,
+                                                          const std::string& db,
+                                                          const std::string& scopeType);
+
     void setScopeInitCallback(void (*func)(Scope&)) {
         _scopeInitCallback = func;
     }
@@ -100,9 +100,10 @@ DBQuery.prototype._canUseFindCommand = function() {
     // to make sure that we don't try to run a find command against the $cmd collection.
     //
     // We also forbid queries with the exhaust option from running as find commands, because the
-    // find command does not support exhaust.
+    // find command does not support exhaust. Pipelined getMores are only issued by the native
+    // cursor, which the find command path does not use.
     return (this._collection.getName().indexOf("$cmd") !== 0) &&
-        (this._options & DBQuery.Option.exhaust) === 0;
+        (this._options & (DBQuery.Option.exhaust | DBQuery.Option.pipelineGetMores)) === 0;
 };
 
 DBQuery.prototype._exec = function() {
@@ -694,7 +695,10 @@ DBQuery.Option = {
     noTimeout: 0x10,
     awaitData: 0x20,
     exhaust: 0x40,
-    partial: 0x80
+    partial: 0x80,
+    // Not a wire protocol flag: makes the shell's cursor request the next batch while the current
+    // one is being iterated. The connection must not be used for anything else meanwhile.
+    pipelineGetMores: 0x20000000
 };
 
 function DBCommandCursor(mongo, cmdResult, batchSize) {
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/tools/mongotrafficreplay_options.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "mongo/base/status.h"
+#include "mongo/util/log.h"
+#include "mongo/util/options_parser/startup_options.h"
+
+namespace mongo {
+
+MongoTrafficReplayGlobalParams mongoTrafficReplayGlobalParams;
+
+Status addMongoTrafficReplayOptions(moe::OptionSection* options) {
+    options->addOptionChaining("help", "help", moe::Switch, "show this usage information");
+
+    options->addOptionChaining("host", "host", moe::String, "MongoDB process to replay against")
+        .setDefault(moe::Value(std::string("localhost:27017")));
+
+    options->addOptionChaining(
+        "recording", "recording", moe::String, "recording written by startRecordingTraffic");
+
+    options->addOptionChaining(
+                "speed", "speed", moe::Double, "speed of the replay relative to the recording")
+        .setDefault(moe::Value(1.0));
+
+    options->addOptionChaining("verbose", "verbose", moe::String, "log more verbose output")
+        .setImplicit(moe::Value(std::string("v")));
+
+    return Status::OK();
+}
+
+void printMongoTrafficReplayHelp(std::ostream* out) {
+    *out << "Usage: mongotrafficreplay --recording <file> [ --host <host> ] [ --speed <speed> ]"
+            " [ --verbose <vvv> ] [ --help ]"
+         << std::endl;
+    *out << moe::startupOptions.helpString();
+    *out << std::flush;
+}
+
+bool handlePreValidationMongoTrafficReplayOptions(const moe::Environment& params) {
+    if (params.count("help")) {
+        printMongoTrafficReplayHelp(&std::cout);
+        return false;
+    }
+    return true;
+}
+
+Status storeMongoTrafficReplayOptions(const moe::Environment& params,
+                                      const std::vector<std::string>& args) {
+    if (!params.count("recording")) {
+        return {ErrorCodes::BadValue, "Missing required option: --recording"};
+    }
+
+    mongoTrafficReplayGlobalParams.host = params["host"].as<std::string>();
+    mongoTrafficReplayGlobalParams.recording = params["recording"].as<std::string>();
+    mongoTrafficReplayGlobalParams.speed = params["speed"].as<double>();
+
+    if (!(mongoTrafficReplayGlobalParams.speed > 0)) {
+        return {ErrorCodes::BadValue, "The --speed option must be greater than 0"};
+    }
+
+    if (params.count("verbose")) {
+        std::string verbosity = params["verbose"].as<std::string>();
+        if (std::any_of(verbosity.cbegin(), verbosity.cend(), [](char ch) { return ch != 'v'; })) {
+            return {ErrorCodes::BadValue,
+                    "The string for the --verbose option cannot contain characters other than 'v'"};
+        }
+        logger::globalLogDomain()->setMinimumLoggedSeverity(
+            logger::LogSeverity::Debug(verbosity.length()));
+    }
+
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,483 @@
+/**
+ *    Copyright (C) 2017 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * mongotrafficreplay replays a recording written by the startRecordingTraffic command against
+ * another server, keeping the timing and the concurrency of the recorded sessions. Every recorded
+ * session is replayed on a connection and a thread of its own, and the ids of the cursors the
+ * recorded requests opened are replaced by those of the cursors the replay opens.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+
+#include "mongo/base/data_view.h"
+#include "mongo/base/init.h"
+#include "mongo/base/initializer.h"
+#include "mongo/client/connection_string.h"
+#include "mongo/client/dbclientinterface.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/db/traffic_recording.h"
+#include "mongo/rpc/factory.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/reply_interface.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/tools/mongotrafficreplay_options.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/exit_code.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/op_msg.h"
+#include "mongo/util/quick_exit.h"
+#include "mongo/util/signal_handlers.h"
+#include "mongo/util/text.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Maps the ids of the cursors of the recording to those of the cursors opened by the replay.
+ * Shared by all sessions, since a cursor can be used by a session other than the one opening it.
+ */
+class CursorIdMap {
+public:
+    void add(long long recordedId, long long liveId) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _liveIds[recordedId] = liveId;
+    }
+
+    /**
+     * Returns the id of the cursor the replay opened in place of 'recordedId', or 'recordedId'
+     * itself if the replay did not open one, such as for a cursor opened before the recording
+     * started.
+     */
+    long long get(long long recordedId) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _liveIds.find(recordedId);
+        return it == _liveIds.end() ? recordedId : it->second;
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    stdx::unordered_map<long long, long long> _liveIds;
+};
+
+CursorIdMap cursorIdMap;
+
+struct ReplayStats {
+    void add(const ReplayStats& other) {
+        sent += other.sent;
+        errors += other.errors;
+        skipped += other.skipped;
+        replies += other.replies;
+        totalLatencyMicros += other.totalLatencyMicros;
+        maxLatencyMicros = std::max(maxLatencyMicros, other.maxLatencyMicros);
+        totalLatenessMicros += other.totalLatenessMicros;
+        maxLatenessMicros = std::max(maxLatenessMicros, other.maxLatenessMicros);
+    }
+
+    long long sent = 0;
+    long long errors = 0;
+    long long skipped = 0;
+
+    // Only requests the server replies to have a latency.
+    long long replies = 0;
+    long long totalLatencyMicros = 0;
+    long long maxLatencyMicros = 0;
+
+    // How far behind the timing of the recording the requests were sent.
+    long long totalLatenessMicros = 0;
+    long long maxLatenessMicros = 0;
+};
+
+/**
+ * Returns true if the server does not reply to 'request'.
+ */
+bool isFireAndForget(const Message& request) {
+    switch (request.operation()) {
+        case dbInsert:
+        case dbUpdate:
+        case dbDelete:
+        case dbKillCursors:
+            return true;
+        case dbMsg:
+            return OpMsg::isFlagSet(request, OpMsg::kMoreToCome);
+        default:
+            return false;
+    }
+}
+
+bool isExhaustQuery(const Message& request) {
+    if (request.operation() != dbQuery) {
+        return false;
+    }
+    DbMessage dbMessage(request);
+    QueryMessage query(dbMessage);
+    return query.queryOptions & QueryOption_Exhaust;
+}
+
+/**
+ * Replaces the recorded cursor ids in a legacy OP_GET_MORE or OP_KILL_CURSORS request.
+ */
+void rewriteLegacyCursorIds(Message* request) {
+    char* const data = request->singleData().view2ptr();
+    if (request->operation() == dbGetMore) {
+        // The cursor id follows a reserved int32, the namespace and the number to return.
+        DataView cursorId(data + sizeof(std::int32_t) + strlen(data + sizeof(std::int32_t)) + 1 +
+                          sizeof(std::int32_t));
+        cursorId.write(tagLittleEndian(static_cast<std::int64_t>(
+            cursorIdMap.get(cursorId.read<LittleEndian<std::int64_t>>()))));
+    } else if (request->operation() == dbKillCursors) {
+        // The cursor ids follow a reserved int32 and their number.
+        const std::int32_t count =
+            ConstDataView(data).read<LittleEndian<std::int32_t>>(sizeof(std::int32_t));
+        for (std::int32_t i = 0; i < count; ++i) {
+            DataView cursorId(data + 2 * sizeof(std::int32_t) + i * sizeof(std::int64_t));
+            cursorId.write(tagLittleEndian(static_cast<std::int64_t>(
+                cursorIdMap.get(cursorId.read<LittleEndian<std::int64_t>>()))));
+        }
+    }
+}
+
+/**
+ * Replaces the recorded cursor ids in a getMore or killCursors command. Commands sent as OP_QUERY
+ * are rewritten as OP_MSG.
+ */
+void rewriteCommandCursorIds(const OpMsgRequest& command, Message* request) {
+    const auto commandName = command.getCommandName();
+    if (commandName != "getMore" && commandName != "killCursors") {
+        return;
+    }
+
+    BSONObjBuilder body;
+    for (auto&& elem : command.body) {
+        if (commandName == "getMore" && elem.fieldNameStringData() == "getMore") {
+            body.append("getMore", cursorIdMap.get(elem.safeNumberLong()));
+        } else if (commandName == "killCursors" && elem.fieldNameStringData() == "cursors" &&
+                   elem.type() == Array) {
+            BSONArrayBuilder cursors(body.subarrayStart("cursors"));
+            for (auto&& cursorId : elem.Obj()) {
+                cursors.append(cursorIdMap.get(cursorId.safeNumberLong()));
+            }
+        } else {
+            body.append(elem);
+        }
+    }
+
+    OpMsgRequest rewritten(command);
+    rewritten.body = body.obj();
+    *request = rewritten.serialize();
+}
+
+/**
+ * Replays the requests of one recorded session in order on a connection of its own.
+ */
+class SessionReplayer {
+    MONGO_DISALLOW_COPYING(SessionReplayer);
+
+public:
+    SessionReplayer(std::uint64_t sessionId, const Timer* replayTimer)
+        : _sessionId(sessionId),
+          _replayTimer(replayTimer),
+          _thread(stdx::thread([this] { _run(); })) {}
+
+    /**
+     * Queues 'record' for replay once the replay has run for 'dueMicros'.
+     */
+    void enqueue(TrafficRecord record, long long dueMicros) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _queue.push_back({std::move(record), dueMicros});
+        _queueChanged.notify_one();
+    }
+
+    /**
+     * Waits for the queued records to be replayed and returns the statistics of the session.
+     */
+    ReplayStats finish() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _finished = true;
+            _queueChanged.notify_one();
+        }
+        _thread.join();
+        return _stats;
+    }
+
+private:
+    struct QueuedRecord {
+        TrafficRecord record;
+        long long dueMicros;
+    };
+
+    void _run() {
+        setThreadName(str::stream() << "replay" << _sessionId);
+
+        while (true) {
+            QueuedRecord queued;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _queueChanged.wait(lk, [&] { return _finished || !_queue.empty(); });
+                if (_queue.empty()) {
+                    return;
+                }
+                queued = std::move(_queue.front());
+                _queue.pop_front();
+            }
+
+            if (queued.record.type == TrafficRecord::Type::kCursorReply) {
+                // The request opening the cursor was replayed, since it precedes this record.
+                auto it = _liveCursorIds.find(queued.record.responseTo);
+                if (it != _liveCursorIds.end()) {
+                    cursorIdMap.add(queued.record.cursorId, it->second);
+                    _liveCursorIds.erase(it);
+                }
+                continue;
+            }
+
+            _replay(&queued.record.request, queued.dueMicros);
+        }
+    }
+
+    void _replay(Message* request, long long dueMicros) {
+        const std::int32_t recordedRequestId = request->header().getId();
+
+        if (isExhaustQuery(*request)) {
+            // Replaying an exhaust cursor would need to receive the replies it streams.
+            LOG(1) << "Skipping exhaust query of session " << _sessionId;
+            ++_stats.skipped;
+            return;
+        }
+
+        if (!_connection && !_connect()) {
+            ++_stats.skipped;
+            return;
+        }
+
+        bool isCommand = false;
+        try {
+            if (request->operation() == dbMsg || request->operation() == dbQuery) {
+                const auto command = rpc::opMsgRequestFromAnyProtocol(*request);
+                isCommand = true;
+                rewriteCommandCursorIds(command, request);
+            } else {
+                rewriteLegacyCursorIds(request);
+            }
+        } catch (const DBException&) {
+            // Not a command, such as a legacy query.
+        }
+
+        const long long lateness = std::max(0LL, _replayTimer->micros() - dueMicros);
+        _stats.totalLatenessMicros += lateness;
+        _stats.maxLatenessMicros = std::max(_stats.maxLatenessMicros, lateness);
+
+        try {
+            ++_stats.sent;
+            if (isFireAndForget(*request)) {
+                _connection->say(*request);
+                return;
+            }
+
+            Timer latencyTimer;
+            Message response;
+            if (!_connection->call(*request, response, false)) {
+                ++_stats.errors;
+                _connection.reset();
+                return;
+            }
+
+            const long long latency = latencyTimer.micros();
+            ++_stats.replies;
+            _stats.totalLatencyMicros += latency;
+            _stats.maxLatencyMicros = std::max(_stats.maxLatencyMicros, latency);
+
+            if (const long long cursorId = getCursorIdFromReply(response)) {
+                _liveCursorIds[recordedRequestId] = cursorId;
+            }
+
+            if (isCommand) {
+                const auto reply = rpc::makeReply(&response);
+                const Status status = getStatusFromCommandResult(reply->getCommandReply());
+                if (!status.isOK()) {
+                    LOG(2) << "Command of session " << _sessionId << " failed: " << status;
+                    ++_stats.errors;
+                }
+            }
+        } catch (const DBException& ex) {
+            LOG(1) << "Failed to replay request of session " << _sessionId << ": " << ex.what();
+            ++_stats.errors;
+            _connection.reset();
+        }
+    }
+
+    bool _connect() {
+        auto connectionString =
+            uassertStatusOK(ConnectionString::parse(mongoTrafficReplayGlobalParams.host));
+
+        std::string errmsg;
+        _connection.reset(connectionString.connect("mongotrafficreplay", errmsg));
+        if (!_connection) {
+            warning() << "Failed to connect to " << mongoTrafficReplayGlobalParams.host
+                      << " for session " << _sessionId << ": " << errmsg;
+            return false;
+        }
+        return true;
+    }
+
+    const std::uint64_t _sessionId;
+    const Timer* const _replayTimer;
+
+    std::unique_ptr<DBClientBase> _connection;
+
+    // Ids of the cursors opened by the replayed requests of this session, by the ids of the
+    // recorded requests, until the kCursorReply record of the request maps them.
+    stdx::unordered_map<std::int32_t, long long> _liveCursorIds;
+
+    ReplayStats _stats;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _queueChanged;
+    std::deque<QueuedRecord> _queue;
+    bool _finished = false;
+
+    stdx::thread _thread;
+};
+
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
+    return Status::OK();
+}
+
+}  // namespace
+
+int trafficReplayMain(int argc, char** argv, char** envp) {
+    setupSignalHandlers();
+    runGlobalInitializersOrDie(argc, argv, envp);
+
+    auto swReader = TrafficRecordingReader::open(mongoTrafficReplayGlobalParams.recording);
+    if (!swReader.isOK()) {
+        severe() << swReader.getStatus();
+        return EXIT_BADOPTIONS;
+    }
+    auto reader = std::move(swReader.getValue());
+
+    log() << "Replaying " << mongoTrafficReplayGlobalParams.recording << " against "
+          << mongoTrafficReplayGlobalParams.host << " at " << mongoTrafficReplayGlobalParams.speed
+          << "x speed";
+
+    const Timer replayTimer;
+    std::map<std::uint64_t, std::unique_ptr<SessionReplayer>> sessions;
+    Status readStatus = Status::OK();
+
+    while (true) {
+        auto swRecord = reader->next();
+        if (!swRecord.isOK()) {
+            readStatus = swRecord.getStatus();
+            break;
+        }
+        if (!swRecord.getValue()) {
+            break;
+        }
+        TrafficRecord& record = *swRecord.getValue();
+
+        auto& session = sessions[record.sessionId];
+        if (!session) {
+            session = stdx::make_unique<SessionReplayer>(record.sessionId, &replayTimer);
+        }
+
+        // Requests are handed to their session when they are due, so that a session waiting for
+        // a slow reply falls behind the recording instead of running its requests back to back.
+        const long long dueMicros = static_cast<long long>(
+            record.offset.count() / mongoTrafficReplayGlobalParams.speed);
+        if (record.type == TrafficRecord::Type::kRequest) {
+            const long long waitMicros = dueMicros - replayTimer.micros();
+            if (waitMicros > 0) {
+                sleepmicros(waitMicros);
+            }
+        }
+        session->enqueue(std::move(record), dueMicros);
+    }
+
+    ReplayStats stats;
+    for (auto&& session : sessions) {
+        stats.add(session.second->finish());
+    }
+
+    log() << "Replayed " << sessions.size() << " sessions in " << replayTimer.millis() << "ms: "
+          << stats.sent << " requests sent, " << stats.errors << " errors, " << stats.skipped
+          << " skipped";
+    if (stats.replies) {
+        log() << "Latency: average " << stats.totalLatencyMicros / stats.replies
+              << " micros, maximum " << stats.maxLatencyMicros << " micros";
+    }
+    if (stats.sent) {
+        log() << "Behind the recording by: average " << stats.totalLatenessMicros / stats.sent
+              << " micros, maximum " << stats.maxLatenessMicros << " micros";
+    }
+
+    if (!readStatus.isOK()) {
+        severe() << "Stopped reading the recording: " << readStatus;
+        return EXIT_FAILURE;
+    }
+    return EXIT_CLEAN;
+}
+
+}  // namespace mongo
+
+#if defined(_WIN32)
+// In Windows, wmain() is an alternate entry point for main(), and receives the same parameters
+// as main() but encoded in Windows Unicode (UTF-16); "wide" 16-bit wchar_t characters.  The
+// WindowsCommandLine object converts these wide character strings to a UTF-8 coded equivalent
+// and makes them available through the argv() and envp() members.  This enables
+// trafficReplayMain() to process UTF-8 encoded arguments and environment variables without regard
+// to platform.
+int wmain(int argc, wchar_t* argvW[], wchar_t* envpW[]) {
+    mongo::WindowsCommandLine wcl(argc, argvW, envpW);
+    int exitCode = mongo::trafficReplayMain(argc, wcl.argv(), wcl.envp());
+    mongo::quickExit(exitCode);
+}
+#else
+int main(int argc, char* argv[], char** envp) {
+    int exitCode = mongo::trafficReplayMain(argc, argv, envp);
+    mongo::quickExit(exitCode);
+}
+#endif
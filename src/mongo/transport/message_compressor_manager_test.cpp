@@ -29,12 +29,16 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_snappy.h"
 #include "mongo/transport/message_compressor_zlib.h"
+#ifdef MONGO_CONFIG_HAVE_ZSTD
+#include "mongo/transport/message_compressor_zstd.h"
+#endif
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/message.h"
 
@@ -195,6 +199,22 @@ TEST(ZlibMessageCompressor, Fidelity) {
     checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>());
 }
 
+#ifdef MONGO_CONFIG_HAVE_ZSTD
+TEST(ZstdMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, RejectsCorruptInput) {
+    ZstdMessageCompressor compressor;
+    const char garbage[] = "this is not a zstd frame";
+    char output[64];
+    auto swLength = compressor.decompressData(ConstDataRange(garbage, sizeof(garbage)),
+                                              DataRange(output, sizeof(output)));
+    ASSERT_EQ(ErrorCodes::BadValue, swLength.getStatus());
+}
+#endif
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
@@ -224,7 +224,7 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task, Sch
         _ioContext->post(std::move(wrappedTask));
     }
 
-    _lastScheduleTimer.reset();
+    _lastScheduleTimer.resetCoarse();
     _totalQueued.addAndFetch(1);
 
     // Deferred tasks never count against the thread starvation avoidance. For other tasks, we
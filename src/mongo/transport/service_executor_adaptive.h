@@ -37,6 +37,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/transport/service_executor.h"
 #include "mongo/util/tick_source.h"
+#include "mongo/util/with_alignment.h"
 
 #include <asio.hpp>
 
@@ -125,6 +126,18 @@ private:
             _start.store(_tickSource->getTicks());
         }
 
+        /**
+         * Like reset(), but leaves the start time alone if it is less than a millisecond old.
+         * Readers only look at the timer with millisecond granularity, and skipping the store keeps
+         * frequent callers on different cores from bouncing its cache line between them.
+         */
+        void resetCoarse() {
+            const auto now = _tickSource->getTicks();
+            if (now - _start.load() >= _ticksPerMillisecond) {
+                _start.store(now);
+            }
+        }
+
     private:
         TickSource* const _tickSource;
         const TickSource::Tick _ticksPerMillisecond;
@@ -196,21 +209,23 @@ private:
     TickSource* const _tickSource;
     AtomicWord<bool> _isRunning{false};
 
-    // These counters are used to detect stuck threads and high task queuing.
+    // These counters are used to detect stuck threads and high task queuing. The ones updated for
+    // every scheduled or executed task are kept on separate cache lines so that worker threads
+    // updating one of them do not also invalidate the others.
     AtomicWord<int> _threadsRunning{0};
     AtomicWord<int> _threadsPending{0};
-    AtomicWord<int> _tasksExecuting{0};
-    AtomicWord<int> _tasksQueued{0};
-    AtomicWord<int> _deferredTasksQueued{0};
-    TickTimer _lastScheduleTimer;
+    CacheAligned<AtomicWord<int>> _tasksExecuting{0};
+    CacheAligned<AtomicWord<int>> _tasksQueued{0};
+    CacheAligned<AtomicWord<int>> _deferredTasksQueued{0};
+    CacheAligned<TickTimer> _lastScheduleTimer;
     AtomicWord<TickSource::Tick> _pastThreadsSpentExecuting{0};
     AtomicWord<TickSource::Tick> _pastThreadsSpentRunning{0};
     static thread_local ThreadState* _localThreadState;
 
     // These counters are only used for reporting in serverStatus.
-    AtomicWord<int64_t> _totalQueued{0};
-    AtomicWord<int64_t> _totalExecuted{0};
-    AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+    CacheAligned<AtomicWord<int64_t>> _totalQueued{0};
+    CacheAligned<AtomicWord<int64_t>> _totalExecuted{0};
+    CacheAligned<AtomicWord<TickSource::Tick>> _totalSpentQueued{0};
 
     // Threads signal this condition variable when they exit so we can gracefully shutdown
     // the executor.
@@ -35,6 +35,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/traffic_recorder.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
@@ -258,6 +259,7 @@ void ServiceStateMachine::_sinkCallback(Status status) {
     }
 
     invariant(state() == State::SinkWait);
+    _messageCharge.set(_inMessage.size());
 
     // If there was an error sinking the message to the client, then we should print an error and
     // end the session. No need to unwind the stack, so this will runNextInGuard() and return.
@@ -298,6 +300,14 @@ void ServiceStateMachine::_processMessage(ThreadGuard& guard) {
     }
 
     networkCounter.hitLogicalIn(_inMessage.size());
+    _messageCharge.set(_inMessage.size());
+
+    // The getMores of an exhaust cursor are made up by the server rather than received, so they
+    // are left out of traffic recordings.
+    auto& trafficRecorder = TrafficRecorder::get(_serviceContext);
+    if (!_inExhaust) {
+        trafficRecorder.observeRequest(_session(), _inMessage);
+    }
 
     // Pass sourced Message to handler to generate response.
     auto opCtx = Client::getCurrent()->makeOperationContext();
@@ -317,6 +327,10 @@ void ServiceStateMachine::_processMessage(ThreadGuard& guard) {
         toSink.header().setId(nextMessageId());
         toSink.header().setResponseToMsgId(_inMessage.header().getId());
 
+        if (!_inExhaust) {
+            trafficRecorder.observeResponse(_session(), _inMessage, toSink);
+        }
+
         // If this is an exhaust cursor, don't source more Messages
         if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
             _inExhaust = true;
@@ -333,6 +347,8 @@ void ServiceStateMachine::_processMessage(ThreadGuard& guard) {
             toSink = swm.getValue();
         }
 
+        _messageCharge.set(_inMessage.size() + toSink.size());
+
         // Sink our response to the client
         auto ticket = _session()->sinkMessage(toSink);
 
@@ -348,7 +364,13 @@ void ServiceStateMachine::_processMessage(ThreadGuard& guard) {
     } else {
         _state.store(State::Source);
         _inMessage.reset();
-        return scheduleNext(ServiceExecutor::kDeferredTask);
+        _messageCharge.set(0);
+
+        // A request without a reply (an OP_MSG with moreToCome or a legacy unacknowledged write)
+        // is usually pipelined by the client ahead of further requests, so the next message is
+        // likely already readable. Let it be sourced on this thread instead of sending it back
+        // through the executor's queue.
+        return scheduleNext(ServiceExecutor::kDeferredTask | ServiceExecutor::kMayRecurse);
     }
 }
 
@@ -461,6 +483,7 @@ void ServiceStateMachine::_cleanupSession(ThreadGuard& guard) {
     _state.store(State::Ended);
 
     _inMessage.reset();
+    _messageCharge.set(0);
 
     // By ignoring the return value of Client::releaseCurrent() we destroy the session.
     // _dbClient is now nullptr and _dbClientPtr is invalid and should never be accessed.
@@ -42,6 +42,7 @@
 #include "mongo/transport/service_executor.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_mode.h"
+#include "mongo/util/memory_accounting.h"
 
 namespace mongo {
 
@@ -209,6 +210,10 @@ private:
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
+    // Charges the request being processed and the response being sent to the network buffers
+    // memory account.
+    MemoryAccount::Charge _messageCharge{&memory_accounts::networkBuffers};
+
     AtomicWord<stdx::thread::id> _currentOwningThread;
     std::atomic_flag _isOwned = ATOMIC_FLAG_INIT;  // NOLINT
 };
@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
 #include <utility>
 
 #include "mongo/base/system_error.h"
@@ -150,7 +154,11 @@ public:
         } else {
 
 #endif
-            opportunisticRead(sync, _socket, buffers, std::forward<CompleteHandler>(handler));
+            readWithReadAhead(sync,
+                              asio::buffer_cast<char*>(buffers),
+                              asio::buffer_size(buffers),
+                              0,
+                              std::forward<CompleteHandler>(handler));
 #ifdef MONGO_CONFIG_SSL
         }
 #endif
@@ -212,6 +220,73 @@ private:
         }
     }
 
+    // Reads into [data, data + size), of which the first 'filled' bytes have already been read.
+    // Bytes left over from an earlier socket read are consumed first. Each receive from the socket
+    // also asks for up to kReadAheadBytes past the end of the requested range, so that a small
+    // message body is usually already buffered by the time its header has been read, saving a
+    // receive call per message. Only used on plain sockets; TLS streams do their own buffering.
+    template <typename CompleteHandler>
+    void readWithReadAhead(
+        bool sync, char* data, size_t size, size_t filled, CompleteHandler&& handler) {
+        filled += drainReadAhead(data + filled, size - filled);
+
+        std::error_code ec;
+        while (filled < size && !ec) {
+            filled += readSomeWithReadAhead(data + filled, size - filled, ec);
+        }
+
+        if ((ec == asio::error::would_block || ec == asio::error::try_again) && !sync) {
+            _socket.async_wait(
+                GenericSocket::wait_read,
+                [ this, data, size, filled, handler = std::forward<CompleteHandler>(handler) ](
+                    const std::error_code& ec) mutable {
+                    if (ec) {
+                        handler(ec, filled);
+                        return;
+                    }
+                    readWithReadAhead(false, data, size, filled, std::move(handler));
+                });
+            return;
+        }
+
+        handler(filled == size ? std::error_code() : ec, filled);
+    }
+
+    size_t drainReadAhead(char* data, size_t size) {
+        const size_t copied = std::min(size, _readAheadEnd - _readAheadBegin);
+        if (copied == 0) {
+            return 0;
+        }
+
+        std::memcpy(data, _readAheadBuffer.get() + _readAheadBegin, copied);
+        _readAheadBegin += copied;
+        if (_readAheadBegin == _readAheadEnd) {
+            // Most sessions are idle most of the time, so don't hold on to the buffer.
+            _readAheadBuffer.reset();
+            _readAheadBegin = _readAheadEnd = 0;
+        }
+        return copied;
+    }
+
+    size_t readSomeWithReadAhead(char* data, size_t size, std::error_code& ec) {
+        invariant(_readAheadBegin == _readAheadEnd);
+        if (!_readAheadBuffer) {
+            _readAheadBuffer.reset(new char[kReadAheadBytes]);
+        }
+
+        const std::array<asio::mutable_buffer, 2> buffers = {
+            {asio::buffer(data, size), asio::buffer(_readAheadBuffer.get(), kReadAheadBytes)}};
+        const size_t received = _socket.read_some(buffers, ec);
+        const size_t intoData = std::min(received, size);
+
+        _readAheadBegin = 0;
+        _readAheadEnd = received - intoData;
+        if (_readAheadEnd == 0) {
+            _readAheadBuffer.reset();
+        }
+        return intoData;
+    }
+
 #ifdef MONGO_CONFIG_SSL
     template <typename MutableBufferSequence, typename HandshakeCb>
     void maybeHandshakeSSL(bool sync, const MutableBufferSequence& buffer, HandshakeCb onComplete) {
@@ -291,10 +366,18 @@ private:
     }
 #endif
 
+    static constexpr size_t kReadAheadBytes = 4096;
+
     HostAndPort _remote;
     HostAndPort _local;
 
     GenericSocket _socket;
+
+    // Bytes received from _socket beyond the end of the last read, in
+    // [_readAheadBegin, _readAheadEnd).
+    std::unique_ptr<char[]> _readAheadBuffer;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
     bool _ranHandshake = false;
@@ -30,6 +30,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cstring>
+
 #include "mongo/base/system_error.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/transport/asio_utils.h"
@@ -93,7 +95,7 @@ void TransportLayerASIO::ASIOSourceTicket::_headerCallback(const std::error_code
     if (!session)
         return;
 
-    MSGHEADER::View headerView(_buffer.get());
+    MSGHEADER::ConstView headerView(_headerBuffer);
     auto msgLen = static_cast<size_t>(headerView.getMessageLength());
     if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
         StringBuilder sb;
@@ -105,12 +107,16 @@ void TransportLayerASIO::ASIOSourceTicket::_headerCallback(const std::error_code
         return;
     }
 
+    _buffer = SharedBuffer::allocate(msgLen);
+    std::memcpy(_buffer.get(), _headerBuffer, kHeaderSize);
+
     if (msgLen == size) {
+        _target->setData(std::move(_buffer));
+        networkCounter.hitPhysicalIn(_target->size());
         finishFill(Status::OK());
         return;
     }
 
-    _buffer.realloc(msgLen);
     MsgData::View msgView(_buffer.get());
 
     session->read(isSync(),
@@ -123,11 +129,8 @@ void TransportLayerASIO::ASIOSourceTicket::fillImpl() {
     if (!session)
         return;
 
-    const auto initBufSize = kHeaderSize;
-    _buffer = SharedBuffer::allocate(initBufSize);
-
     session->read(isSync(),
-                  asio::buffer(_buffer.get(), initBufSize),
+                  asio::buffer(_headerBuffer, kHeaderSize),
                   [this](const std::error_code& ec, size_t size) { _headerCallback(ec, size); });
 }
 
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/net/message.h"
 
 #include "asio.hpp"
 
@@ -83,6 +84,9 @@ private:
     void _headerCallback(const std::error_code& ec, size_t size);
     void _bodyCallback(const std::error_code& ec, size_t size);
 
+    // The header is read into _headerBuffer so that _buffer can be allocated once, at the full
+    // message length, instead of being allocated for the header and then grown for the body.
+    char _headerBuffer[sizeof(MSGHEADER::Value)];
     SharedBuffer _buffer;
     Message* _target;
 };
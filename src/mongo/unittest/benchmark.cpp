@@ -0,0 +1,231 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "mongo/config.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace benchmark {
+namespace {
+
+// Never grow the iteration count by more than this factor between two trial runs, so that one
+// unusually fast run does not make the next one take far longer than minTime.
+const double kMaxGrowthFactor = 10.0;
+
+// Aim somewhat above minTime so that the final run usually lands past it on the first try.
+const double kTargetOvershoot = 1.4;
+
+std::vector<Benchmark*>& registry() {
+    static std::vector<Benchmark*>* benchmarks = new std::vector<Benchmark*>();
+    return *benchmarks;
+}
+
+std::string runName(const Benchmark& benchmark, bool hasArg, std::int64_t arg) {
+    if (!hasArg) {
+        return benchmark.getName();
+    }
+    return str::stream() << benchmark.getName() << "/" << arg;
+}
+
+BenchmarkResult runScaled(const std::string& name,
+                          BenchmarkFunction fn,
+                          bool hasArg,
+                          std::int64_t arg,
+                          const RunOptions& options) {
+    const Nanoseconds minTime = duration_cast<Nanoseconds>(options.minTime);
+    std::uint64_t iterations = 1;
+    while (true) {
+        auto result = runOnce(name, fn, hasArg, arg, iterations);
+        if (result.elapsed >= minTime || iterations >= options.maxIterations) {
+            return result;
+        }
+
+        const double elapsedNanos = std::max<double>(result.elapsed.count(), 1);
+        const double multiplier =
+            std::min(kMaxGrowthFactor, kTargetOvershoot * minTime.count() / elapsedNanos);
+        const auto next = static_cast<std::uint64_t>(iterations * multiplier);
+        iterations = std::min(std::max(next, iterations + 1), options.maxIterations);
+    }
+}
+
+}  // namespace
+
+State::State(std::uint64_t maxIterations, bool hasArg, std::int64_t arg)
+    : _maxIterations(maxIterations), _hasArg(hasArg), _arg(arg) {}
+
+void State::pauseTiming() {
+    if (!_running) {
+        return;
+    }
+    _elapsed += duration_cast<Nanoseconds>(stdx::chrono::steady_clock::now() - _start);
+    _running = false;
+}
+
+void State::resumeTiming() {
+    if (_running) {
+        return;
+    }
+    _running = true;
+    _start = stdx::chrono::steady_clock::now();
+}
+
+std::int64_t State::range() const {
+    invariant(_hasArg);
+    return _arg;
+}
+
+Benchmark::Benchmark(std::string name, BenchmarkFunction fn)
+    : _name(std::move(name)), _fn(fn) {}
+
+Benchmark* Benchmark::arg(std::int64_t value) {
+    _args.push_back(value);
+    return this;
+}
+
+Benchmark* registerBenchmark(std::string name, BenchmarkFunction fn) {
+    registry().push_back(new Benchmark(std::move(name), fn));
+    return registry().back();
+}
+
+const std::vector<Benchmark*>& getRegisteredBenchmarks() {
+    return registry();
+}
+
+BenchmarkResult runOnce(const std::string& name,
+                        BenchmarkFunction fn,
+                        bool hasArg,
+                        std::int64_t arg,
+                        std::uint64_t iterations) {
+    State state(iterations, hasArg, arg);
+    fn(state);
+    // A benchmark that returns without running its loop to completion would report a
+    // meaningless time.
+    invariant(state.iterations() == iterations);
+    state.pauseTiming();
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.elapsed = state.elapsed();
+    result.nanosPerIteration = static_cast<double>(result.elapsed.count()) / iterations;
+
+    const double seconds = std::max<double>(result.elapsed.count(), 1) / 1e9;
+    result.itemsPerSecond = state.itemsProcessed() / seconds;
+    result.bytesPerSecond = state.bytesProcessed() / seconds;
+    return result;
+}
+
+std::vector<BenchmarkResult> runBenchmarks(const RunOptions& options) {
+    std::vector<BenchmarkResult> results;
+    auto runOne = [&](const Benchmark& benchmark, bool hasArg, std::int64_t arg) {
+        const auto name = runName(benchmark, hasArg, arg);
+        if (name.find(options.filter) == std::string::npos) {
+            return;
+        }
+        for (int i = 0; i < options.repetitions; ++i) {
+            results.push_back(runScaled(name, benchmark.getFunction(), hasArg, arg, options));
+        }
+    };
+
+    for (const auto* benchmark : getRegisteredBenchmarks()) {
+        if (benchmark->getArgs().empty()) {
+            runOne(*benchmark, false, 0);
+            continue;
+        }
+        for (auto arg : benchmark->getArgs()) {
+            runOne(*benchmark, true, arg);
+        }
+    }
+    return results;
+}
+
+void printConsoleReport(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    size_t nameWidth = std::string("Benchmark").size();
+    for (const auto& result : results) {
+        nameWidth = std::max(nameWidth, result.name.size());
+    }
+
+    os << std::left << std::setw(nameWidth) << "Benchmark" << std::right << std::setw(16)
+       << "Time (ns)" << std::setw(14) << "Iterations" << std::setw(16) << "Items/s" << '\n';
+    os << std::string(nameWidth + 46, '-') << '\n';
+    for (const auto& result : results) {
+        os << std::left << std::setw(nameWidth) << result.name << std::right << std::setw(16)
+           << std::fixed << std::setprecision(1) << result.nanosPerIteration << std::setw(14)
+           << result.iterations;
+        if (result.itemsPerSecond > 0) {
+            os << std::setw(16) << std::setprecision(0) << result.itemsPerSecond;
+        }
+        os << '\n';
+    }
+}
+
+void printJsonReport(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    BSONObjBuilder bob;
+    {
+        BSONObjBuilder context(bob.subobjStart("context"));
+        context.append("date", dateToISOStringLocal(Date_t::now()));
+        context.append("num_cpus", static_cast<int>(stdx::thread::hardware_concurrency()));
+#if defined(MONGO_CONFIG_DEBUG_BUILD)
+        context.append("library_build_type", "debug");
+#else
+        context.append("library_build_type", "release");
+#endif
+    }
+    {
+        BSONArrayBuilder benchmarks(bob.subarrayStart("benchmarks"));
+        for (const auto& result : results) {
+            BSONObjBuilder entry(benchmarks.subobjStart());
+            entry.append("name", result.name);
+            entry.append("iterations", static_cast<long long>(result.iterations));
+            entry.append("real_time", result.nanosPerIteration);
+            entry.append("time_unit", "ns");
+            if (result.itemsPerSecond > 0) {
+                entry.append("items_per_second", result.itemsPerSecond);
+            }
+            if (result.bytesPerSecond > 0) {
+                entry.append("bytes_per_second", result.bytesPerSecond);
+            }
+        }
+    }
+    os << bob.obj().jsonString(Strict, 1) << std::endl;
+}
+
+}  // namespace benchmark
+}  // namespace mongo
@@ -0,0 +1,277 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * A small microbenchmark framework, modeled on the Google Benchmark API.
+ *
+ * A benchmark is a function taking a State& that runs the code under measurement once per
+ * iteration of a keepRunning() loop. Any setup done before the first call to keepRunning() is
+ * excluded from the measurement:
+ *
+ *     void BM_AppendInt(benchmark::State& state) {
+ *         BSONObjBuilder bob;
+ *         while (state.keepRunning()) {
+ *             bob.append("a", 1);
+ *         }
+ *     }
+ *     MONGO_BENCHMARK(BM_AppendInt);
+ *
+ * A benchmark may be registered with one or more arguments, in which case it is run once per
+ * argument and can read the argument with state.range():
+ *
+ *     MONGO_BENCHMARK(BM_BuildDocument)->arg(1)->arg(64);
+ *
+ * The runner scales the iteration count until a run takes at least the requested minimum time,
+ * and reports the time per iteration. Benchmark binaries are built with env.CppBenchmark and
+ * linked against benchmark_main, which can report results as JSON for later comparison.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/util/duration.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mongo {
+namespace benchmark {
+
+/**
+ * Prevents the compiler from optimizing away the computation of 'value'.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    const volatile char* sink = &reinterpret_cast<const volatile char&>(value);
+    (void)*sink;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * Tracks the iterations and timing of a single run of a benchmark function.
+ */
+class State {
+    MONGO_DISALLOW_COPYING(State);
+
+public:
+    State(std::uint64_t maxIterations, bool hasArg, std::int64_t arg);
+
+    /**
+     * Returns true while the benchmark should run another iteration. The timer starts on the
+     * first call and stops on the call that returns false.
+     */
+    bool keepRunning() {
+        if (_iterations < _maxIterations) {
+            if (_iterations++ == 0) {
+                resumeTiming();
+            }
+            return true;
+        }
+        pauseTiming();
+        return false;
+    }
+
+    /**
+     * Excludes the time between pauseTiming() and resumeTiming() from the measurement. Useful for
+     * per-iteration setup that should not be counted.
+     */
+    void pauseTiming();
+    void resumeTiming();
+
+    /**
+     * Returns the argument this run was registered with. Only valid for benchmarks registered
+     * through arg().
+     */
+    std::int64_t range() const;
+
+    /**
+     * Records how many logical items or bytes the whole run processed, so that the runner can
+     * also report a throughput.
+     */
+    void setItemsProcessed(std::int64_t items) {
+        _itemsProcessed = items;
+    }
+    void setBytesProcessed(std::int64_t bytes) {
+        _bytesProcessed = bytes;
+    }
+
+    std::uint64_t maxIterations() const {
+        return _maxIterations;
+    }
+
+    std::uint64_t iterations() const {
+        return _iterations;
+    }
+
+    Nanoseconds elapsed() const {
+        return _elapsed;
+    }
+
+    std::int64_t itemsProcessed() const {
+        return _itemsProcessed;
+    }
+
+    std::int64_t bytesProcessed() const {
+        return _bytesProcessed;
+    }
+
+private:
+    const std::uint64_t _maxIterations;
+    const bool _hasArg;
+    const std::int64_t _arg;
+
+    std::uint64_t _iterations = 0;
+    bool _running = false;
+    stdx::chrono::steady_clock::time_point _start;
+    Nanoseconds _elapsed{0};
+
+    std::int64_t _itemsProcessed = 0;
+    std::int64_t _bytesProcessed = 0;
+};
+
+using BenchmarkFunction = void (*)(State&);
+
+/**
+ * A registered benchmark function, along with the arguments to run it with.
+ */
+class Benchmark {
+    MONGO_DISALLOW_COPYING(Benchmark);
+
+public:
+    Benchmark(std::string name, BenchmarkFunction fn);
+
+    /**
+     * Adds an argument to run this benchmark with. Returns this, so that calls can be chained.
+     */
+    Benchmark* arg(std::int64_t value);
+
+    const std::string& getName() const {
+        return _name;
+    }
+
+    BenchmarkFunction getFunction() const {
+        return _fn;
+    }
+
+    const std::vector<std::int64_t>& getArgs() const {
+        return _args;
+    }
+
+private:
+    const std::string _name;
+    const BenchmarkFunction _fn;
+    std::vector<std::int64_t> _args;
+};
+
+/**
+ * Registers a benchmark function. Normally called through MONGO_BENCHMARK rather than directly.
+ * The returned object lives for the rest of the process.
+ */
+Benchmark* registerBenchmark(std::string name, BenchmarkFunction fn);
+
+/**
+ * Returns all registered benchmarks, in registration order.
+ */
+const std::vector<Benchmark*>& getRegisteredBenchmarks();
+
+struct RunOptions {
+    // Only benchmarks whose full name, including any "/<arg>" suffix, contains this substring
+    // are run. An empty filter runs everything.
+    std::string filter;
+
+    // Each reported run is scaled up until it takes at least this long.
+    Milliseconds minTime{500};
+
+    // Upper bound on the number of iterations of a single run.
+    std::uint64_t maxIterations = 1000000000;
+
+    // Number of times each benchmark is measured. Each repetition is reported separately.
+    int repetitions = 1;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    Nanoseconds elapsed{0};
+    double nanosPerIteration = 0;
+
+    // Both are zero unless the benchmark reported items or bytes processed.
+    double itemsPerSecond = 0;
+    double bytesPerSecond = 0;
+};
+
+/**
+ * Runs a single benchmark function for exactly 'iterations' iterations and returns the result.
+ */
+BenchmarkResult runOnce(const std::string& name,
+                        BenchmarkFunction fn,
+                        bool hasArg,
+                        std::int64_t arg,
+                        std::uint64_t iterations);
+
+/**
+ * Runs every registered benchmark matching options.filter, scaling each up to options.minTime.
+ */
+std::vector<BenchmarkResult> runBenchmarks(const RunOptions& options);
+
+/**
+ * Writes results as an aligned human readable table.
+ */
+void printConsoleReport(std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+/**
+ * Writes results as a JSON document shaped like the Google Benchmark JSON output:
+ *     {context: {...}, benchmarks: [{name, iterations, real_time, time_unit, ...}, ...]}
+ */
+void printJsonReport(std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+}  // namespace benchmark
+}  // namespace mongo
+
+#define MONGO_BENCHMARK_CONCAT_IMPL(A, B) A##B
+#define MONGO_BENCHMARK_CONCAT(A, B) MONGO_BENCHMARK_CONCAT_IMPL(A, B)
+
+/**
+ * Registers FN as a benchmark. May be followed by ->arg(...) calls.
+ */
+#define MONGO_BENCHMARK(FN)                                                              \
+    MONGO_COMPILER_VARIABLE_UNUSED static ::mongo::benchmark::Benchmark* const           \
+        MONGO_BENCHMARK_CONCAT(_mongoBenchmark_, __LINE__) =                             \
+            ::mongo::benchmark::registerBenchmark(#FN, FN)
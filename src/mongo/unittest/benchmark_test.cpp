@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <sstream>
+
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+int noopRuns = 0;
+
+void BM_BenchmarkTestNoop(benchmark::State& state) {
+    ++noopRuns;
+    while (state.keepRunning()) {
+    }
+}
+MONGO_BENCHMARK(BM_BenchmarkTestNoop);
+
+std::vector<std::int64_t> seenArgs;
+
+void BM_BenchmarkTestWithArgs(benchmark::State& state) {
+    seenArgs.push_back(state.range());
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(state.range());
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+MONGO_BENCHMARK(BM_BenchmarkTestWithArgs)->arg(4)->arg(16);
+
+std::uint64_t countedIterations = 0;
+
+TEST(BenchmarkTest, RunOnceRunsTheRequestedNumberOfIterations) {
+    countedIterations = 0;
+    auto result = benchmark::runOnce("count",
+                                     [](benchmark::State& state) {
+                                         while (state.keepRunning()) {
+                                             ++countedIterations;
+                                         }
+                                     },
+                                     false,
+                                     0,
+                                     1000);
+    ASSERT_EQ(1000U, countedIterations);
+    ASSERT_EQ(1000U, result.iterations);
+    ASSERT_EQ("count", result.name);
+}
+
+TEST(BenchmarkTest, PausedTimeIsNotMeasured) {
+    auto result = benchmark::runOnce("paused",
+                                     [](benchmark::State& state) {
+                                         while (state.keepRunning()) {
+                                             state.pauseTiming();
+                                             sleepmillis(10);
+                                             state.resumeTiming();
+                                         }
+                                     },
+                                     false,
+                                     0,
+                                     5);
+    ASSERT_LT(result.elapsed, Milliseconds(50));
+}
+
+TEST(BenchmarkTest, RunBenchmarksAppliesFilterAndArgs) {
+    benchmark::RunOptions options;
+    options.filter = "BM_BenchmarkTestWithArgs";
+    options.minTime = Milliseconds(0);
+    seenArgs.clear();
+    noopRuns = 0;
+
+    auto results = benchmark::runBenchmarks(options);
+    ASSERT_EQ(2U, results.size());
+    ASSERT_EQ("BM_BenchmarkTestWithArgs/4", results[0].name);
+    ASSERT_EQ("BM_BenchmarkTestWithArgs/16", results[1].name);
+    ASSERT_EQ(0, noopRuns);
+    ASSERT_EQ(2U, seenArgs.size());
+    ASSERT_GT(results[0].itemsPerSecond, 0);
+}
+
+TEST(BenchmarkTest, RunBenchmarksScalesIterationsUpToMinTime) {
+    benchmark::RunOptions options;
+    options.filter = "BM_BenchmarkTestNoop";
+    options.minTime = Milliseconds(20);
+
+    auto results = benchmark::runBenchmarks(options);
+    ASSERT_EQ(1U, results.size());
+    ASSERT_GTE(results[0].elapsed, Milliseconds(20));
+    ASSERT_GT(results[0].iterations, 1U);
+}
+
+TEST(BenchmarkTest, JsonReportListsEveryResult) {
+    benchmark::BenchmarkResult result;
+    result.name = "BM_Something/8";
+    result.iterations = 100;
+    result.nanosPerIteration = 12.5;
+
+    std::ostringstream os;
+    benchmark::printJsonReport(os, {result});
+    auto report = fromjson(os.str());
+    ASSERT_EQ(1U, report["benchmarks"].Array().size());
+    auto entry = report["benchmarks"].Array()[0].Obj();
+    ASSERT_EQ("BM_Something/8", entry["name"].String());
+    ASSERT_EQ(100, entry["iterations"].numberLong());
+    ASSERT_EQ(12.5, entry["real_time"].Double());
+    ASSERT_EQ("ns", entry["time_unit"].String());
+}
+
+}  // namespace
+}  // namespace mongo
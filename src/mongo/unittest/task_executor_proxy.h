@@ -68,6 +68,7 @@ public:
     virtual void cancel(const CallbackHandle& cbHandle) override;
     virtual void wait(const CallbackHandle& cbHandle) override;
     virtual void appendConnectionStats(executor::ConnectionPoolStats* stats) const override;
+    virtual void warmUpConnections(const HostAndPort& hostAndPort) override;
 
 private:
     // Not owned by us.
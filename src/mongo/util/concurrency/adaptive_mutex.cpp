@@ -0,0 +1,244 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_mutex.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/pause.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+// Bounds of the number of pause instructions a thread executes while spinning before it goes to
+// sleep, and of the pause instructions between two looks at the mutex.
+const int kMinSpins = 16;
+const int kMaxSpins = 1024;
+const int kMaxBackoff = 64;
+
+// Number of distinct holder call sites recorded for one mutex name.
+const size_t kMaxHolderSites = 16;
+
+}  // namespace
+
+struct AdaptiveMutex::ContentionStats {
+    struct HolderSite {
+        std::atomic<const void*> site{nullptr};  // NOLINT
+        AtomicUInt64 waits;
+        AtomicUInt64 waitMicros;
+    };
+
+    /**
+     * Attributes a wait of "micros" to the call site "site" which held the mutex.
+     */
+    void recordHolder(const void* site, unsigned long long micros) {
+        for (auto& holder : holders) {
+            if (!site) {
+                // The holder took the mutex before profiling was enabled.
+                break;
+            }
+            const void* current = holder.site.load(std::memory_order_acquire);
+            if (!current &&
+                holder.site.compare_exchange_strong(current, site, std::memory_order_acq_rel)) {
+                current = site;
+            }
+            if (current == site) {
+                holder.waits.fetchAndAdd(1);
+                holder.waitMicros.fetchAndAdd(micros);
+                return;
+            }
+        }
+        otherHolderWaits.fetchAndAdd(1);
+    }
+
+    // Acquisitions which found the mutex locked.
+    AtomicUInt64 contended;
+
+    // Number of times a thread waiting for the mutex went to sleep.
+    AtomicUInt64 slept;
+
+    // Time spent waiting for the mutex while contention profiling was enabled.
+    AtomicUInt64 waitMicros;
+
+    // Call sites holding the mutex when a thread had to wait for it, while profiling was enabled.
+    HolderSite holders[kMaxHolderSites];
+    AtomicUInt64 otherHolderWaits;
+};
+
+namespace {
+
+using ContentionStatsMap = std::map<std::string, AdaptiveMutex::ContentionStats*>;
+
+// The registry and its statistics are never destroyed, as adaptive mutexes might still be used
+// during shutdown.
+stdx::mutex& registryMutex() {
+    static auto mutex = new stdx::mutex();
+    return *mutex;
+}
+
+ContentionStatsMap& registry() {
+    static auto map = new ContentionStatsMap();
+    return *map;
+}
+
+AdaptiveMutex::ContentionStats* contentionStatsFor(const char* name) {
+    stdx::lock_guard<stdx::mutex> lk(registryMutex());
+    auto& stats = registry()[name];
+    if (!stats) {
+        stats = new AdaptiveMutex::ContentionStats();
+    }
+    return stats;
+}
+
+}  // namespace
+
+std::atomic<bool> AdaptiveMutex::contentionProfilingEnabled{false};  // NOLINT
+
+AdaptiveMutex::AdaptiveMutex(const char* name) : _stats(contentionStatsFor(name)) {}
+
+void AdaptiveMutex::_lockSlowPath() {
+#if defined(_MSC_VER)
+    const void* const callSite = _ReturnAddress();
+#else
+    const void* const callSite = __builtin_return_address(0);
+#endif
+    const bool profiling = contentionProfilingEnabled.load(std::memory_order_relaxed);
+
+    // While profiling, uncontended acquisitions come here too, to record their call site.
+    if (!try_lock()) {
+        _stats->contended.fetchAndAdd(1);
+        const void* const holderSite =
+            profiling ? _holderSite.load(std::memory_order_relaxed) : nullptr;
+        const auto start = profiling ? curTimeMicros64() : 0;
+
+        if (!_spinLock()) {
+            _stats->slept.fetchAndAdd(_sleepLock());
+        }
+
+        if (profiling) {
+            const auto micros = curTimeMicros64() - start;
+            _stats->waitMicros.fetchAndAdd(micros);
+            _stats->recordHolder(holderSite, micros);
+        }
+    }
+
+    if (profiling) {
+        _holderSite.store(callSite, std::memory_order_relaxed);
+    }
+}
+
+bool AdaptiveMutex::_spinLock() {
+    const int averageSpins = _averageSpins.load(std::memory_order_relaxed);
+    const int budget = std::min(kMaxSpins, std::max(kMinSpins, 2 * averageSpins));
+
+    int spins = 0;
+    for (int backoff = 1; spins < budget; backoff = std::min(2 * backoff, kMaxBackoff)) {
+        for (int i = 0; i < backoff; ++i) {
+            MONGO_YIELD_CORE_FOR_SMT();
+        }
+        spins += backoff;
+
+        // Only attempt to take the mutex once it looks free, so that spinning threads do not keep
+        // taking its cache line away from the holder.
+        if (_state.load(std::memory_order_relaxed) == kUnlocked && try_lock()) {
+            _averageSpins.store(averageSpins + (spins - averageSpins) / 8,
+                                std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Spinning did not pay off, so spin less next time.
+    _averageSpins.store(averageSpins - averageSpins / 8, std::memory_order_relaxed);
+    return false;
+}
+
+int AdaptiveMutex::_sleepLock() {
+    int sleeps = 0;
+    stdx::unique_lock<stdx::mutex> lk(_sleepMutex);
+
+    // The state is set to kLockedWithSleepers before this thread checks whether the mutex was
+    // free, and with _sleepMutex held, so that the unlock() which frees it next cannot miss this
+    // thread. Having the state still say so after this thread took the mutex is harmless: at
+    // worst, its own unlock() wakes a thread needlessly.
+    while (_state.exchange(kLockedWithSleepers, std::memory_order_acquire) != kUnlocked) {
+        ++sleeps;
+        _sleepers.wait(lk);
+    }
+    return sleeps;
+}
+
+void AdaptiveMutex::_wakeSleeper() {
+    stdx::lock_guard<stdx::mutex> lk(_sleepMutex);
+    _sleepers.notify_one();
+}
+
+void AdaptiveMutex::setContentionProfilingEnabled(bool enabled) {
+    contentionProfilingEnabled.store(enabled);
+}
+
+void AdaptiveMutex::appendContentionStats(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lk(registryMutex());
+    for (const auto& entry : registry()) {
+        const ContentionStats& stats = *entry.second;
+        BSONObjBuilder section(builder->subobjStart(entry.first));
+        section.append("contended", static_cast<long long>(stats.contended.load()));
+        section.append("slept", static_cast<long long>(stats.slept.load()));
+        section.append("waitMicros", static_cast<long long>(stats.waitMicros.load()));
+
+        BSONArrayBuilder holders(section.subarrayStart("holders"));
+        for (const auto& holder : stats.holders) {
+            const void* site = holder.site.load();
+            if (!site) {
+                break;
+            }
+            BSONObjBuilder holderBuilder(holders.subobjStart());
+            holderBuilder.append(
+                "site",
+                integerToHex(static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(site))));
+            holderBuilder.append("waits", static_cast<long long>(holder.waits.load()));
+            holderBuilder.append("waitMicros", static_cast<long long>(holder.waitMicros.load()));
+        }
+        holders.done();
+        section.append("otherHolderWaits", static_cast<long long>(stats.otherHolderWaits.load()));
+    }
+}
+
+}  // namespace mongo
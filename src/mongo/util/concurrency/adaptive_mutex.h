@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/inline_decls.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A mutex for critical sections which are very short but heavily contended.
+ *
+ * A thread which finds the mutex locked first spins, with exponential backoff, and only goes to
+ * sleep if the mutex is still locked after that, which avoids the wake up latency of a sleeping
+ * thread when the holder releases the mutex quickly. How long a thread spins adapts to how long
+ * spinning took to acquire this mutex in the past.
+ *
+ * Satisfies the Lockable requirements, so it can be used with stdx::lock_guard and
+ * stdx::unique_lock, but not with stdx::condition_variable.
+ *
+ * Every AdaptiveMutex has a name, which should be a string literal, and the mutexes sharing a name
+ * share their contention statistics. appendContentionStats() reports, for each name, how often a
+ * thread had to wait and to sleep. While contention profiling is enabled, it additionally reports
+ * how long threads waited and the call sites which held the mutex while they did.
+ */
+class AdaptiveMutex {
+    MONGO_DISALLOW_COPYING(AdaptiveMutex);
+
+public:
+    struct ContentionStats;
+
+    explicit AdaptiveMutex(const char* name);
+
+    void lock() {
+        if (MONGO_likely(!contentionProfilingEnabled.load(std::memory_order_relaxed) &&
+                         try_lock())) {
+            return;
+        }
+        _lockSlowPath();
+    }
+
+    bool try_lock() {
+        uint32_t expected = kUnlocked;
+        return _state.compare_exchange_strong(expected, kLocked, std::memory_order_acquire);
+    }
+
+    void unlock() {
+        if (_state.exchange(kUnlocked, std::memory_order_release) == kLockedWithSleepers) {
+            _wakeSleeper();
+        }
+    }
+
+    /**
+     * Appends the contention statistics of every AdaptiveMutex name, as a subobject per name.
+     */
+    static void appendContentionStats(BSONObjBuilder* builder);
+
+    /**
+     * Turns recording of wait times and holder call sites on or off for all adaptive mutexes.
+     * Recording these sends every acquisition through the slow path, so it has a cost even
+     * without contention.
+     */
+    static void setContentionProfilingEnabled(bool enabled);
+
+private:
+    enum : uint32_t { kUnlocked = 0, kLocked = 1, kLockedWithSleepers = 2 };
+
+    static std::atomic<bool> contentionProfilingEnabled;  // NOLINT
+
+    NOINLINE_DECL void _lockSlowPath();
+
+    /**
+     * Spins until the mutex is acquired or the spin budget is used up. Returns whether the mutex
+     * was acquired.
+     */
+    bool _spinLock();
+
+    /**
+     * Sleeps until the mutex is acquired. Returns the number of times this thread went to sleep.
+     */
+    int _sleepLock();
+
+    void _wakeSleeper();
+
+    std::atomic<uint32_t> _state{kUnlocked};  // NOLINT
+
+    // Running average of the number of spins it took to acquire the mutex, which decays whenever
+    // spinning failed to acquire it.
+    std::atomic<int> _averageSpins{0};  // NOLINT
+
+    // Call site which last locked the mutex, only maintained while profiling is enabled.
+    std::atomic<const void*> _holderSite{nullptr};  // NOLINT
+
+    ContentionStats* const _stats;
+
+    // Used by threads which gave up on spinning to sleep until the mutex is released.
+    stdx::mutex _sleepMutex;
+    stdx::condition_variable _sleepers;
+};
+
+}  // namespace mongo
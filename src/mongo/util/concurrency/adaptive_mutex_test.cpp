@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/adaptive_mutex.h"
+
+namespace mongo {
+namespace {
+
+BSONObj statsFor(StringData name) {
+    BSONObjBuilder builder;
+    AdaptiveMutex::appendContentionStats(&builder);
+    return builder.obj().getObjectField(name).getOwned();
+}
+
+void runConcurrentIncrements(AdaptiveMutex* mutex, int* counter, int threads, int increments) {
+    std::vector<stdx::thread> testers;
+    for (int i = 0; i < threads; i++) {
+        testers.emplace_back([=] {
+            for (int j = 0; j < increments; j++) {
+                stdx::lock_guard<AdaptiveMutex> lk(*mutex);
+                ++(*counter);
+            }
+        });
+    }
+    for (auto& tester : testers) {
+        tester.join();
+    }
+}
+
+TEST(AdaptiveMutex, TryLock) {
+    AdaptiveMutex mutex("AdaptiveMutexTest::TryLock");
+    ASSERT_TRUE(mutex.try_lock());
+    ASSERT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    ASSERT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(AdaptiveMutex, ConcurrentIncrements) {
+    AdaptiveMutex mutex("AdaptiveMutexTest::ConcurrentIncrements");
+    int counter = 0;
+    runConcurrentIncrements(&mutex, &counter, 32, 20000);
+    ASSERT_EQUALS(counter, 32 * 20000);
+
+    auto stats = statsFor("AdaptiveMutexTest::ConcurrentIncrements");
+    ASSERT_TRUE(stats.hasField("contended"));
+    ASSERT_TRUE(stats.hasField("slept"));
+}
+
+TEST(AdaptiveMutex, ConcurrentIncrementsWithProfiling) {
+    AdaptiveMutex mutex("AdaptiveMutexTest::ConcurrentIncrementsWithProfiling");
+    int counter = 0;
+    AdaptiveMutex::setContentionProfilingEnabled(true);
+    runConcurrentIncrements(&mutex, &counter, 16, 20000);
+    AdaptiveMutex::setContentionProfilingEnabled(false);
+    ASSERT_EQUALS(counter, 16 * 20000);
+
+    auto stats = statsFor("AdaptiveMutexTest::ConcurrentIncrementsWithProfiling");
+    ASSERT_EQUALS(stats["holders"].type(), Array);
+    if (stats["contended"].numberLong() > 0) {
+        ASSERT_GT(stats["holders"].Array().size() + stats["otherHolderWaits"].numberLong(), 0U);
+    }
+}
+
+TEST(AdaptiveMutex, MutexesWithTheSameNameShareStats) {
+    AdaptiveMutex first("AdaptiveMutexTest::SharedName");
+    AdaptiveMutex second("AdaptiveMutexTest::SharedName");
+
+    BSONObjBuilder builder;
+    AdaptiveMutex::appendContentionStats(&builder);
+    auto all = builder.obj();
+    int matches = 0;
+    for (auto&& element : all) {
+        if (element.fieldNameStringData() == "AdaptiveMutexTest::SharedName") {
+            ++matches;
+        }
+    }
+    ASSERT_EQUALS(matches, 1);
+}
+
+}  // namespace
+}  // namespace mongo
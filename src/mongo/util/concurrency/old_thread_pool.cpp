@@ -31,6 +31,7 @@
 
 #include "mongo/util/concurrency/old_thread_pool.h"
 
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -48,6 +49,16 @@ ThreadPool::Options makeOptions(int nThreads, const std::string& threadNamePrefi
     return options;
 }
 
+WorkStealingThreadPool::Options makeWorkStealingOptions(int nThreads,
+                                                       const std::string& threadNamePrefix) {
+    const auto options = makeOptions(nThreads, threadNamePrefix);
+    WorkStealingThreadPool::Options workStealingOptions;
+    workStealingOptions.poolName = options.poolName;
+    workStealingOptions.threadNamePrefix = options.threadNamePrefix;
+    workStealingOptions.numThreads = options.maxThreads;
+    return workStealingOptions;
+}
+
 }  // namespace
 
 OldThreadPool::OldThreadPool(int nThreads, const std::string& threadNamePrefix)
@@ -58,26 +69,56 @@ OldThreadPool::OldThreadPool(int nThreads, const std::string& threadNamePrefix)
 OldThreadPool::OldThreadPool(const DoNotStartThreadsTag&,
                              int nThreads,
                              const std::string& threadNamePrefix)
-    : _pool(makeOptions(nThreads, threadNamePrefix)) {}
+    : _pool(stdx::make_unique<ThreadPool>(makeOptions(nThreads, threadNamePrefix))) {}
+
+OldThreadPool::OldThreadPool(const WorkStealingTag&,
+                             int nThreads,
+                             const std::string& threadNamePrefix)
+    : _workStealingPool(stdx::make_unique<WorkStealingThreadPool>(
+          makeWorkStealingOptions(nThreads, threadNamePrefix))) {
+    startThreads();
+}
 
 std::size_t OldThreadPool::getNumThreads() const {
-    return _pool.getStats().numThreads;
+    return getStats().numThreads;
 }
 
 ThreadPool::Stats OldThreadPool::getStats() const {
-    return _pool.getStats();
+    if (_pool) {
+        return _pool->getStats();
+    }
+
+    const auto workStealingStats = _workStealingPool->getStats();
+    ThreadPool::Stats stats;
+    stats.options.poolName = workStealingStats.options.poolName;
+    stats.options.threadNamePrefix = workStealingStats.options.threadNamePrefix;
+    stats.options.minThreads = stats.options.maxThreads = workStealingStats.options.numThreads;
+    stats.numThreads = workStealingStats.numThreads;
+    stats.numIdleThreads = workStealingStats.numIdleThreads;
+    stats.numPendingTasks = workStealingStats.numPendingTasks;
+    return stats;
 }
 
 void OldThreadPool::startThreads() {
-    _pool.startup();
+    if (_pool) {
+        _pool->startup();
+    } else {
+        _workStealingPool->startup();
+    }
 }
 
 void OldThreadPool::join() {
-    _pool.waitForIdle();
+    if (_pool) {
+        _pool->waitForIdle();
+    } else {
+        _workStealingPool->waitForIdle();
+    }
 }
 
 void OldThreadPool::schedule(Task task) {
-    fassert(28705, _pool.schedule(std::move(task)));
+    fassert(28705,
+            _pool ? _pool->schedule(std::move(task))
+                  : _workStealingPool->schedule(std::move(task)));
 }
 
 }  // namespace mongo
@@ -28,11 +28,13 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <string>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
 
 namespace mongo {
 
@@ -48,8 +50,12 @@ class OldThreadPool {
 public:
     typedef stdx::function<void(void)> Task;  // nullary function or functor
     struct DoNotStartThreadsTag {};
+    struct WorkStealingTag {};
 
     explicit OldThreadPool(int nThreads = 8, const std::string& threadNamePrefix = "");
+
+    // Runs the tasks on a WorkStealingThreadPool instead of a ThreadPool, and starts the threads.
+    OldThreadPool(const WorkStealingTag&, int nThreads, const std::string& threadNamePrefix = "");
     explicit OldThreadPool(const DoNotStartThreadsTag&,
                            int nThreads = 8,
                            const std::string& threadNamePrefix = "");
@@ -93,7 +99,9 @@ public:
     }
 
 private:
-    ThreadPool _pool;
+    // Exactly one of these is set.
+    std::unique_ptr<ThreadPool> _pool;
+    std::unique_ptr<WorkStealingThreadPool> _workStealingPool;
 };
 
 }  // namespace mongo
@@ -32,12 +32,21 @@
 #include "mongo/util/concurrency/ticketholder.h"
 
 #include <iostream>
+#include <iterator>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
+void TicketHolder::appendStats(BSONObjBuilder* builder) const {
+    builder->append("out", used());
+    builder->append("available", available());
+    builder->append("totalTickets", outof());
+}
+
 #if defined(__linux__)
 namespace {
 void _check(int ret) {
@@ -49,15 +58,15 @@ void _check(int ret) {
 }
 }
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
+SemaphoreTicketHolder::SemaphoreTicketHolder(int num) : _outof(num) {
     _check(sem_init(&_sem, 0, num));
 }
 
-TicketHolder::~TicketHolder() {
+SemaphoreTicketHolder::~SemaphoreTicketHolder() {
     _check(sem_destroy(&_sem));
 }
 
-bool TicketHolder::tryAcquire() {
+bool SemaphoreTicketHolder::tryAcquire() {
     while (0 != sem_trywait(&_sem)) {
         if (errno == EAGAIN)
             return false;
@@ -67,14 +76,14 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket() {
+void SemaphoreTicketHolder::waitForTicket() {
     while (0 != sem_wait(&_sem)) {
         if (errno != EINTR)
             _check(-1);
     }
 }
 
-bool TicketHolder::waitForTicketUntil(Date_t until) {
+bool SemaphoreTicketHolder::waitForTicketUntil(Date_t until) {
     const long long millisSinceEpoch = until.toMillisSinceEpoch();
     struct timespec ts;
 
@@ -90,11 +99,11 @@ bool TicketHolder::waitForTicketUntil(Date_t until) {
     return true;
 }
 
-void TicketHolder::release() {
+void SemaphoreTicketHolder::release() {
     _check(sem_post(&_sem));
 }
 
-Status TicketHolder::resize(int newSize) {
+Status SemaphoreTicketHolder::resize(int newSize) {
     stdx::lock_guard<stdx::mutex> lk(_resizeMutex);
 
     if (newSize < 5)
@@ -121,32 +130,32 @@ Status TicketHolder::resize(int newSize) {
     return Status::OK();
 }
 
-int TicketHolder::available() const {
+int SemaphoreTicketHolder::available() const {
     int val = 0;
     _check(sem_getvalue(&_sem, &val));
     return val;
 }
 
-int TicketHolder::used() const {
+int SemaphoreTicketHolder::used() const {
     return outof() - available();
 }
 
-int TicketHolder::outof() const {
+int SemaphoreTicketHolder::outof() const {
     return _outof.load();
 }
 
 #else
 
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
+SemaphoreTicketHolder::SemaphoreTicketHolder(int num) : _outof(num), _num(num) {}
 
-TicketHolder::~TicketHolder() = default;
+SemaphoreTicketHolder::~SemaphoreTicketHolder() = default;
 
-bool TicketHolder::tryAcquire() {
+bool SemaphoreTicketHolder::tryAcquire() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket() {
+void SemaphoreTicketHolder::waitForTicket() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     while (!_tryAcquire()) {
@@ -154,13 +163,13 @@ void TicketHolder::waitForTicket() {
     }
 }
 
-bool TicketHolder::waitForTicketUntil(Date_t until) {
+bool SemaphoreTicketHolder::waitForTicketUntil(Date_t until) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     return _newTicket.wait_until(lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
 }
 
-void TicketHolder::release() {
+void SemaphoreTicketHolder::release() {
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         _num++;
@@ -168,7 +177,7 @@ void TicketHolder::release() {
     _newTicket.notify_one();
 }
 
-Status TicketHolder::resize(int newSize) {
+Status SemaphoreTicketHolder::resize(int newSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     int used = _outof.load() - _num;
@@ -190,19 +199,19 @@ Status TicketHolder::resize(int newSize) {
     return Status::OK();
 }
 
-int TicketHolder::available() const {
+int SemaphoreTicketHolder::available() const {
     return _num;
 }
 
-int TicketHolder::used() const {
+int SemaphoreTicketHolder::used() const {
     return outof() - _num;
 }
 
-int TicketHolder::outof() const {
+int SemaphoreTicketHolder::outof() const {
     return _outof.load();
 }
 
-bool TicketHolder::_tryAcquire() {
+bool SemaphoreTicketHolder::_tryAcquire() {
     if (_num <= 0) {
         if (_num < 0) {
             std::cerr << "DISASTER! in TicketHolder" << std::endl;
@@ -213,4 +222,142 @@ bool TicketHolder::_tryAcquire() {
     return true;
 }
 #endif
+
+FifoTicketHolder::FifoTicketHolder(int num) : _available(num), _outof(num) {}
+
+FifoTicketHolder::~FifoTicketHolder() {
+    invariant(_queue.empty());
+}
+
+bool FifoTicketHolder::_tryTakeAvailable() {
+    int available = _available.load();
+    while (available > 0) {
+        const int previous = _available.compareAndSwap(available, available - 1);
+        if (previous == available) {
+            return true;
+        }
+        available = previous;
+    }
+    return false;
+}
+
+bool FifoTicketHolder::tryAcquire() {
+    // Don't take a ticket ahead of threads which are already waiting for one.
+    if (_numWaiters.load() > 0) {
+        return false;
+    }
+    return _tryTakeAvailable();
+}
+
+void FifoTicketHolder::waitForTicket() {
+    invariant(waitForTicketUntil(Date_t::max()));
+}
+
+bool FifoTicketHolder::waitForTicketUntil(Date_t until) {
+    if (tryAcquire()) {
+        return true;
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    // Count ourselves as waiting before checking for a ticket again, so that a thread releasing a
+    // ticket from now on hands it to the queue rather than leaving it available.
+    _numWaiters.fetchAndAdd(1);
+    if (_queue.empty() && _tryTakeAvailable()) {
+        _numWaiters.subtractAndFetch(1);
+        return true;
+    }
+
+    Waiter waiter;
+    _queue.push_back(&waiter);
+    const auto position = std::prev(_queue.end());
+    _totalQueued.fetchAndAdd(1);
+    const unsigned long long start = curTimeMicros64();
+    ON_BLOCK_EXIT([&] { _totalTimeQueuedMicros.fetchAndAdd(curTimeMicros64() - start); });
+
+    const auto hasTicket = [&waiter] { return waiter.hasTicket; };
+    if (until == Date_t::max()) {
+        waiter.granted.wait(lk, hasTicket);
+        return true;
+    }
+
+    if (!waiter.granted.wait_until(lk, until.toSystemTimePoint(), hasTicket)) {
+        _queue.erase(position);
+        _numWaiters.subtractAndFetch(1);
+        return false;
+    }
+    return true;
+}
+
+void FifoTicketHolder::release() {
+    if (_numWaiters.load() == 0) {
+        _available.fetchAndAdd(1);
+        if (_numWaiters.load() == 0) {
+            return;
+        }
+
+        // A thread started waiting while we released the ticket; make sure it doesn't miss it.
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_queue.empty() && _tryTakeAvailable()) {
+            _grantOrMakeAvailable_inlock();
+        }
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _grantOrMakeAvailable_inlock();
+}
+
+void FifoTicketHolder::_grantOrMakeAvailable_inlock() {
+    if (_queue.empty()) {
+        _available.fetchAndAdd(1);
+        return;
+    }
+
+    Waiter* waiter = _queue.front();
+    _queue.pop_front();
+    _numWaiters.subtractAndFetch(1);
+    waiter->hasTicket = true;
+    waiter->granted.notify_one();
+}
+
+Status FifoTicketHolder::resize(int newSize) {
+    stdx::lock_guard<stdx::mutex> lk(_resizeMutex);
+
+    if (newSize < 1)
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Minimum number of tickets is 1; given " << newSize);
+
+    while (_outof.load() < newSize) {
+        release();
+        _outof.fetchAndAdd(1);
+    }
+
+    while (_outof.load() > newSize) {
+        waitForTicket();
+        _outof.subtractAndFetch(1);
+    }
+
+    invariant(_outof.load() == newSize);
+    return Status::OK();
+}
+
+int FifoTicketHolder::available() const {
+    return _available.load();
+}
+
+int FifoTicketHolder::used() const {
+    return outof() - available();
+}
+
+int FifoTicketHolder::outof() const {
+    return _outof.load();
+}
+
+void FifoTicketHolder::appendStats(BSONObjBuilder* builder) const {
+    TicketHolder::appendStats(builder);
+    builder->append("queueLength", _numWaiters.load());
+    builder->append("totalQueued", _totalQueued.load());
+    builder->append("totalTimeQueuedMicros", _totalTimeQueuedMicros.load());
 }
+}  // namespace mongo
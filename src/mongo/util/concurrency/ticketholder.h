@@ -30,7 +30,11 @@
 #include <semaphore.h>
 #endif
 
+#include <list>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -38,28 +42,67 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * Hands out a bounded number of tickets. A thread which wants a ticket when none are available
+ * waits until another thread releases one.
+ */
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
 public:
-    explicit TicketHolder(int num);
-    ~TicketHolder();
+    virtual ~TicketHolder() = default;
+
+    virtual bool tryAcquire() = 0;
+
+    virtual void waitForTicket() = 0;
+
+    virtual bool waitForTicketUntil(Date_t until) = 0;
+
+    virtual void release() = 0;
+
+    virtual Status resize(int newSize) = 0;
+
+    virtual int available() const = 0;
+
+    virtual int used() const = 0;
+
+    virtual int outof() const = 0;
+
+    /**
+     * Appends the number of tickets in use, available and in total, along with any statistics
+     * about threads waiting for tickets that the implementation keeps.
+     */
+    virtual void appendStats(BSONObjBuilder* builder) const;
+
+protected:
+    TicketHolder() = default;
+};
+
+/**
+ * A TicketHolder built on a counting semaphore. Waiting threads are woken in no particular order.
+ */
+class SemaphoreTicketHolder final : public TicketHolder {
+public:
+    explicit SemaphoreTicketHolder(int num);
+    ~SemaphoreTicketHolder() override;
 
-    bool tryAcquire();
+    bool tryAcquire() override;
 
-    void waitForTicket();
+    void waitForTicket() override;
 
-    bool waitForTicketUntil(Date_t until);
+    bool waitForTicketUntil(Date_t until) override;
 
-    void release();
+    void release() override;
 
-    Status resize(int newSize);
+    Status resize(int newSize) override;
 
-    int available() const;
+    int available() const override;
 
-    int used() const;
+    int used() const override;
 
-    int outof() const;
+    int outof() const override;
 
 private:
 #if defined(__linux__)
@@ -78,6 +121,76 @@ private:
 #endif
 };
 
+/**
+ * A TicketHolder which grants tickets to waiting threads in the order they started waiting. A
+ * released ticket is handed straight to the thread at the front of the queue, so a thread which
+ * has just arrived can't take it first and only one waiter is woken per ticket.
+ *
+ * While no thread is waiting, acquiring and releasing a ticket is a single atomic operation.
+ */
+class FifoTicketHolder final : public TicketHolder {
+public:
+    explicit FifoTicketHolder(int num);
+    ~FifoTicketHolder() override;
+
+    bool tryAcquire() override;
+
+    void waitForTicket() override;
+
+    bool waitForTicketUntil(Date_t until) override;
+
+    void release() override;
+
+    Status resize(int newSize) override;
+
+    int available() const override;
+
+    int used() const override;
+
+    int outof() const override;
+
+    /**
+     * Also appends the number of threads waiting, and how many have waited and for how long in
+     * total.
+     */
+    void appendStats(BSONObjBuilder* builder) const override;
+
+private:
+    struct Waiter {
+        stdx::condition_variable granted;
+        bool hasTicket = false;
+    };
+
+    /**
+     * Takes an available ticket, if there is one, without regard for any waiting threads.
+     */
+    bool _tryTakeAvailable();
+
+    /**
+     * Gives a ticket to the thread at the front of the queue, or makes it available if nobody is
+     * waiting.
+     */
+    void _grantOrMakeAvailable_inlock();
+
+    // Tickets which are neither held nor promised to a waiter.
+    AtomicInt32 _available;
+
+    // You can read _outof without a lock, but have to hold _resizeMutex to change.
+    AtomicInt32 _outof;
+    stdx::mutex _resizeMutex;
+
+    // The number of threads queued or about to queue. Releasing threads only take '_mutex' when
+    // this is non-zero.
+    AtomicInt32 _numWaiters;
+
+    // Protects '_queue'.
+    mutable stdx::mutex _mutex;
+    std::list<Waiter*> _queue;
+
+    AtomicInt64 _totalQueued;
+    AtomicInt64 _totalTimeQueuedMicros;
+};
+
 class ScopedTicket {
 public:
     ScopedTicket(TicketHolder* holder) : _holder(holder) {
@@ -31,14 +31,21 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
 
-TEST(TicketholderTest, BasicTimeout) {
-    TicketHolder holder(1);
+template <typename Holder>
+void checkBasicTimeout() {
+    Holder holder(1);
     ASSERT_EQ(holder.used(), 0);
     ASSERT_EQ(holder.available(), 1);
     ASSERT_EQ(holder.outof(), 1);
@@ -71,4 +78,74 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+TEST(TicketholderTest, BasicTimeout) {
+    checkBasicTimeout<SemaphoreTicketHolder>();
+}
+
+TEST(TicketholderTest, FifoBasicTimeout) {
+    checkBasicTimeout<FifoTicketHolder>();
+}
+
+TEST(TicketholderTest, FifoGrantsTicketsInWaitingOrder) {
+    FifoTicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    const int kNumWaiters = 4;
+    stdx::mutex mutex;
+    std::vector<int> order;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumWaiters; ++i) {
+        threads.emplace_back([&, i] {
+            holder.waitForTicket();
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                order.push_back(i);
+            }
+            holder.release();
+        });
+
+        // Wait for this thread to queue before starting the next one.
+        while (true) {
+            BSONObjBuilder builder;
+            holder.appendStats(&builder);
+            if (builder.obj()["queueLength"].numberInt() == i + 1) {
+                break;
+            }
+            sleepmillis(1);
+        }
+    }
+
+    // A newcomer must not take the ticket ahead of the queue.
+    holder.release();
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(static_cast<size_t>(kNumWaiters), order.size());
+    for (int i = 0; i < kNumWaiters; ++i) {
+        ASSERT_EQ(i, order[i]);
+    }
+
+    BSONObjBuilder builder;
+    holder.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(0, stats["out"].numberInt());
+    ASSERT_EQ(1, stats["available"].numberInt());
+    ASSERT_EQ(0, stats["queueLength"].numberInt());
+    ASSERT_EQ(kNumWaiters, stats["totalQueued"].numberLong());
+}
+
+TEST(TicketholderTest, FifoResize) {
+    FifoTicketHolder holder(2);
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(5, holder.available());
+    ASSERT(holder.tryAcquire());
+    ASSERT_OK(holder.resize(1));
+    ASSERT_EQ(1, holder.outof());
+    ASSERT_EQ(0, holder.available());
+    ASSERT_FALSE(holder.tryAcquire());
+    holder.release();
+    ASSERT_EQ(1, holder.available());
+    ASSERT_NOT_OK(holder.resize(0));
+}
 }  // namespace
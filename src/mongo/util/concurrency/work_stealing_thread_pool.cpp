@@ -0,0 +1,392 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mongo/base/status.h"
+#include "mongo/platform/pause.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicInt32 nextUnnamedThreadPoolId{1};
+
+// The pool whose worker thread is the current thread, if any, and the index of its queue.
+thread_local const WorkStealingThreadPool* currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+
+/**
+ * Sets defaults and checks bounds limits on "options", and returns it.
+ *
+ * This method is just a helper for the WorkStealingThreadPool constructor.
+ */
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with "
+                 << options.numThreads << " threads but it must have at least 1";
+        fassertFailed(40644);
+    }
+    return options;
+}
+
+/**
+ * Binds the current thread to the CPU at "index" among those the process may run on, modulo their
+ * number.
+ */
+void bindCurrentThreadToCpu(size_t index, const std::string& threadName) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+        warning() << "Could not bind " << threadName << " to a CPU: " << errnoWithDescription();
+        return;
+    }
+
+    size_t target = index % CPU_COUNT(&allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || target-- > 0) {
+            continue;
+        }
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (error != 0) {
+            warning() << "Could not bind " << threadName << " to CPU " << cpu << ": "
+                      << errnoWithDescription(error);
+        } else {
+            LOG(1) << "Bound " << threadName << " to CPU " << cpu;
+        }
+        return;
+    }
+#endif
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))), _queues(_options.numThreads) {}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+    if (shutdownComplete != _state.load()) {
+        _join_inlock(&lk);
+    }
+
+    if (shutdownComplete != _state.load()) {
+        severe() << "Failed to shutdown pool during destruction";
+        fassertFailed(40645);
+    }
+    invariant(_threads.empty());
+    for (auto& queue : _queues) {
+        invariant(queue.tasks.empty());
+    }
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state.load() != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(40646);
+    }
+    _setState_inlock(running);
+    invariant(_threads.empty());
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        try {
+            _threads.emplace_back(
+                stdx::bind(&WorkStealingThreadPool::_workerThreadBody, this, i, threadName));
+        } catch (const std::exception& ex) {
+            error() << "Failed to start " << threadName << "; " << _threads.size()
+                    << " other thread(s) still running in pool " << _options.poolName
+                    << "; caught exception: " << redact(ex.what());
+        }
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void WorkStealingThreadPool::_shutdown_inlock() {
+    switch (_state.load()) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            _workAvailable.notify_all();
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    try {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _join_inlock(&lk);
+    } catch (...) {
+        severe() << "Exception escaped join in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
+    _stateChange.wait(*lk, [this] {
+        switch (_state.load()) {
+            case preStart:
+                return false;
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(40647);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    ThreadList threadsToJoin;
+    swap(threadsToJoin, _threads);
+    lk->unlock();
+    if (threadsToJoin.empty()) {
+        _drainPendingTasks();
+    }
+    for (auto& t : threadsToJoin) {
+        t.join();
+    }
+    lk->lock();
+    invariant(_state.load() == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+void WorkStealingThreadPool::_drainPendingTasks() {
+    // Tasks cannot be run inline because they can create OperationContexts and the join() caller
+    // may already have one associated with the thread.
+    const std::string threadName = str::stream() << _options.threadNamePrefix
+                                                 << _options.numThreads;
+    stdx::thread cleanThread(
+        stdx::bind(&WorkStealingThreadPool::_workerThreadBody, this, 0, threadName));
+    cleanThread.join();
+}
+
+Status WorkStealingThreadPool::schedule(Task task) {
+    // The task is counted before the state is checked, so that a concurrent join() waits for it to
+    // be queued and run, unless it is rejected here.
+    _numUnfinishedTasks.fetchAndAdd(1);
+    if (_isShuttingDown()) {
+        _onTaskFinished();
+        return Status(ErrorCodes::ShutdownInProgress,
+                      str::stream() << "Shutdown of thread pool " << _options.poolName
+                                    << " in progress");
+    }
+
+    const size_t queueIndex = currentPool == this
+        ? currentQueue
+        : static_cast<size_t>(_nextQueue.fetchAndAdd(1) % _queues.size());
+    {
+        auto& queue = _queues[queueIndex];
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+    _numPendingTasks.fetchAndAdd(1);
+
+    // A thread going to sleep first counts itself and then checks for pending tasks, so either it
+    // sees this task or it is seen here.
+    if (_numSleepingThreads.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+    return Status::OK();
+}
+
+void WorkStealingThreadPool::waitForIdle() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _poolIsIdle.wait(lk, [this] { return _numUnfinishedTasks.load() == 0; });
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Stats result;
+    result.options = _options;
+    result.numThreads = _threads.size();
+    result.numIdleThreads = static_cast<size_t>(_numSleepingThreads.load());
+    result.numPendingTasks = static_cast<size_t>(std::max(0LL, _numPendingTasks.load()));
+    return result;
+}
+
+void WorkStealingThreadPool::_workerThreadBody(WorkStealingThreadPool* pool,
+                                               size_t workerIndex,
+                                               const std::string& threadName) {
+    setThreadName(threadName);
+    pool->_options.onCreateThread(threadName);
+    if (pool->_options.bindThreadsToCpus) {
+        bindCurrentThreadToCpu(workerIndex, threadName);
+    }
+    LOG(1) << "starting thread in pool " << pool->_options.poolName;
+    try {
+        pool->_consumeTasks(workerIndex);
+    } catch (...) {
+        severe() << "Exception reached top of stack in thread pool " << pool->_options.poolName
+                 << ": " << exceptionToStatus();
+        std::terminate();
+    }
+    LOG(1) << "shutting down thread in pool " << pool->_options.poolName;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    currentPool = this;
+    currentQueue = workerIndex;
+    ON_BLOCK_EXIT([] { currentPool = nullptr; });
+
+    Task task;
+    while (true) {
+        if (_takeTask(workerIndex, &task)) {
+            _runTask(&task);
+            continue;
+        }
+
+        bool foundWork = false;
+        for (int i = 0; i < _options.spinIterations && !foundWork; ++i) {
+            MONGO_YIELD_CORE_FOR_SMT();
+            foundWork = _numPendingTasks.load() > 0;
+        }
+        if (foundWork) {
+            continue;
+        }
+
+        const auto isDone = [this] { return _isShuttingDown() && _numUnfinishedTasks.load() == 0; };
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _numSleepingThreads.fetchAndAdd(1);
+        while (_numPendingTasks.load() <= 0 && !isDone()) {
+            MONGO_IDLE_THREAD_BLOCK;
+            _workAvailable.wait(lk);
+        }
+        _numSleepingThreads.fetchAndSubtract(1);
+        if (isDone()) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingThreadPool::_takeTask(size_t workerIndex, Task* task) {
+    {
+        auto& queue = _queues[workerIndex];
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        if (!queue.tasks.empty()) {
+            *task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            _numPendingTasks.fetchAndSubtract(1);
+            return true;
+        }
+    }
+
+    // Steal from the other queues, skipping those that are busy: if their tasks are not taken by
+    // their owner, they will be found on the next attempt.
+    for (size_t i = 1; i < _queues.size(); ++i) {
+        auto& queue = _queues[(workerIndex + i) % _queues.size()];
+        stdx::unique_lock<stdx::mutex> lk(queue.mutex, stdx::try_to_lock);
+        if (lk.owns_lock() && !queue.tasks.empty()) {
+            *task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            _numPendingTasks.fetchAndSubtract(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::_runTask(Task* task) {
+    try {
+        LOG(3) << "Executing a task on behalf of pool " << _options.poolName;
+        (*task)();
+        *task = Task();
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+    _onTaskFinished();
+}
+
+void WorkStealingThreadPool::_onTaskFinished() {
+    if (_numUnfinishedTasks.subtractAndFetch(1) == 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _poolIsIdle.notify_all();
+        if (_isShuttingDown()) {
+            _workAvailable.notify_all();
+        }
+    }
+}
+
+bool WorkStealingThreadPool::_isShuttingDown() const {
+    const auto state = _state.load();
+    return state != preStart && state != running;
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state.load()) {
+        return;
+    }
+    _state.store(newState);
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
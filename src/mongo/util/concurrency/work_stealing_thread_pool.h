@@ -0,0 +1,253 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/align/aligned_allocator.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A thread pool with a fixed number of threads, each of which owns a queue of tasks.
+ *
+ * Tasks scheduled by a thread of the pool go to that thread's queue, and tasks scheduled by other
+ * threads are spread over the queues in turn. A thread whose queue is empty steals the newest task
+ * of another queue, and spins for a while before going to sleep when there is no work at all.
+ * Unlike ThreadPool, scheduling and running a task never takes a lock shared by the whole pool,
+ * which matters when many threads run short tasks. In exchange, the pool does not grow or shrink.
+ *
+ * The lifecycle and the behavior at shutdown are the same as for ThreadPool.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a
+        // name unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of threads in the pool, all of which are started by startup().
+        size_t numThreads = 8;
+
+        // Number of times a thread which found no work checks again before going to sleep.
+        int spinIterations = 1000;
+
+        // If true, the i-th thread of the pool is bound to the i-th CPU, modulo the number of CPUs
+        // the process may run on. Only supported on Linux; elsewhere this has no effect.
+        bool bindThreadsToCpus = false;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The options for the instance of the pool returning these stats.
+        Options options;
+
+        // The number of threads currently in the pool.
+        size_t numThreads;
+
+        // The number of threads currently asleep waiting for work.
+        size_t numIdleThreads;
+
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks;
+    };
+
+    /**
+     * Constructs a thread pool, configured with the given "options".
+     */
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+    /**
+     * Blocks the caller until there are no pending or running tasks on this pool.
+     *
+     * The same caveats as for ThreadPool::waitForIdle apply. May not be called by a task in the
+     * thread pool.
+     */
+    void waitForIdle();
+
+    /**
+     * Returns statistics about the thread pool's utilization.
+     */
+    Stats getStats() const;
+
+private:
+    using ThreadList = std::vector<stdx::thread>;
+
+    /**
+     * A task queue owned by one thread of the pool. The owner takes the oldest task, and other
+     * threads steal the newest one.
+     */
+    struct WorkerQueue {
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    using AlignedWorkerQueue = CacheAligned<WorkerQueue>;
+    using WorkerQueueList =
+        std::vector<AlignedWorkerQueue, boost::alignment::aligned_allocator<AlignedWorkerQueue>>;
+
+    /**
+     * Representation of the stage of life of a thread pool, with the same transitions as
+     * ThreadPool::LifecycleState.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * This is the thread body for worker threads. The pool joins all of its threads before being
+     * destroyed, so unlike with ThreadPool it is safe to keep using "pool" until this returns.
+     */
+    static void _workerThreadBody(WorkStealingThreadPool* pool,
+                                  size_t workerIndex,
+                                  const std::string& threadName);
+
+    /**
+     * This is the run loop of the thread owning the queue at "workerIndex". Returns once the pool
+     * is shutting down and all scheduled tasks have finished.
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Takes a task from the queue at "workerIndex" or, failing that, steals one from another queue.
+     * Returns false if no task was found.
+     */
+    bool _takeTask(size_t workerIndex, Task* task);
+
+    /**
+     * Runs "task", which must have been taken from a queue, and then records its completion.
+     */
+    void _runTask(Task* task);
+
+    /**
+     * Records that a task scheduled on the pool has finished or was rejected, waking up the
+     * threads which wait for the pool to become idle if it was the last one.
+     */
+    void _onTaskFinished();
+
+    /**
+     * Returns true once shutdown has been requested.
+     */
+    bool _isShuttingDown() const;
+
+    /**
+     * Implementation of shutdown once _mutex is locked.
+     */
+    void _shutdown_inlock();
+
+    /**
+     * Implementation of join once _mutex is owned by "lk".
+     */
+    void _join_inlock(stdx::unique_lock<stdx::mutex>* lk);
+
+    /**
+     * Runs the remaining tasks on a new thread as part of the join process of a pool which never
+     * started its threads, blocking until complete. Caller must not hold the mutex!
+     */
+    void _drainPendingTasks();
+
+    /**
+     * Changes the lifecycle state (_state) of the pool and wakes up any threads waiting for a state
+     * change. Has no effect if _state == newState.
+     */
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // One queue for each thread of the pool, created at construction time.
+    WorkerQueueList _queues;
+
+    // Number of tasks sitting in the queues. May briefly lag behind the queues themselves.
+    CacheAligned<AtomicInt64> _numPendingTasks{0};
+
+    // Number of tasks which have been scheduled but have not finished running yet.
+    CacheAligned<AtomicInt64> _numUnfinishedTasks{0};
+
+    // Queue that the next task scheduled from outside the pool will go to, modulo the number of
+    // queues.
+    CacheAligned<AtomicUInt64> _nextQueue{0};
+
+    // Number of threads waiting on _workAvailable. Incremented with _mutex held.
+    AtomicInt64 _numSleepingThreads{0};
+
+    // Mutex guarding _threads, the lifecycle state transitions and the condition variables below.
+    mutable stdx::mutex _mutex;
+
+    // This variable represents the lifecycle state of the pool. It is only changed with _mutex
+    // held, but may be read without it.
+    AtomicWord<LifecycleState> _state{preStart};
+
+    // Condition signaled to indicate that there is work in the queues, that the last task has
+    // finished, or that the system is shutting down.
+    stdx::condition_variable _workAvailable;
+
+    // Condition signaled to indicate that there are no pending or running tasks.
+    stdx::condition_variable _poolIsIdle;
+
+    // Condition variable signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+
+    // List of threads serving as the worker pool.
+    ThreadList _threads;
+};
+
+}  // namespace mongo
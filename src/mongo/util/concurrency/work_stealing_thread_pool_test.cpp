@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+TEST(WorkStealingThreadPoolTest, StartsAllThreads) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    ASSERT_EQ(0U, pool.getStats().numThreads);
+    pool.startup();
+    ASSERT_EQ(4U, pool.getStats().numThreads);
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(0U, pool.getStats().numThreads);
+}
+
+TEST(WorkStealingThreadPoolTest, RunsTasksScheduledFromManyThreads) {
+    const int numSchedulers = 8;
+    const int tasksPerScheduler = 1000;
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    AtomicInt32 count{0};
+    std::vector<stdx::thread> schedulers;
+    for (int i = 0; i < numSchedulers; ++i) {
+        schedulers.emplace_back([&] {
+            for (int j = 0; j < tasksPerScheduler; ++j) {
+                ASSERT_OK(pool.schedule([&count] { count.fetchAndAdd(1); }));
+            }
+        });
+    }
+    for (auto& scheduler : schedulers) {
+        scheduler.join();
+    }
+
+    pool.waitForIdle();
+    ASSERT_EQ(numSchedulers * tasksPerScheduler, count.load());
+    ASSERT_EQ(0U, pool.getStats().numPendingTasks);
+}
+
+TEST(WorkStealingThreadPoolTest, TasksScheduledByATaskAreStolenByIdleThreads) {
+    const int numTasks = 64;
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    options.spinIterations = 0;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    // Every task lands on the queue of the thread running the first one, which then blocks until
+    // the others have run, so they can only have been run by stealing threads.
+    AtomicInt32 count{0};
+    ASSERT_OK(pool.schedule([&] {
+        for (int i = 0; i < numTasks; ++i) {
+            ASSERT_OK(pool.schedule([&count] { count.fetchAndAdd(1); }));
+        }
+        while (count.load() < numTasks) {
+            stdx::this_thread::yield();
+        }
+    }));
+
+    pool.waitForIdle();
+    ASSERT_EQ(numTasks, count.load());
+}
+
+TEST(WorkStealingThreadPoolTest, ThreadsBoundToCpusRunTasks) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 2;
+    options.bindThreadsToCpus = true;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    AtomicInt32 count{0};
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_OK(pool.schedule([&count] { count.fetchAndAdd(1); }));
+    }
+    pool.waitForIdle();
+    ASSERT_EQ(10, count.load());
+}
+
+DEATH_TEST(WorkStealingThreadPoolTest, NoThreadsDies, "but it must have at least 1") {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 0;
+    WorkStealingThreadPool pool(options);
+}
+
+}  // namespace
@@ -0,0 +1,166 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/crc32c.h"
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+
+#if defined(_M_AMD64) || defined(__amd64__)
+#define MONGO_CRC32C_HAVE_SSE42
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MONGO_CRC32C_SSE42_TARGET
+#else
+#define MONGO_CRC32C_SSE42_TARGET __attribute__((target("sse4.2")))
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define MONGO_CRC32C_HAVE_ARMV8
+#include <arm_acle.h>
+#endif
+
+namespace mongo {
+namespace {
+
+// The reflected Castagnoli polynomial.
+const uint32_t kPolynomial = 0x82F63B78;
+
+/**
+ * Tables for the slicing-by-8 software implementation: table[0] is the classic byte-at-a-time
+ * table, and table[k][b] is the CRC of byte b followed by k zero bytes.
+ */
+struct Crc32cTables {
+    Crc32cTables() {
+        for (uint32_t b = 0; b < 256; ++b) {
+            uint32_t crc = b;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (kPolynomial & (0 - (crc & 1)));
+            }
+            table[0][b] = crc;
+        }
+        for (uint32_t b = 0; b < 256; ++b) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+            }
+        }
+    }
+
+    uint32_t table[8][256];
+};
+
+const Crc32cTables& getTables() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+uint32_t crc32cSoftware(uint32_t crc, const char* p, size_t len) {
+    const auto& t = getTables().table;
+
+    for (; len >= 8; p += 8, len -= 8) {
+        const uint64_t word = ConstDataView(p).read<LittleEndian<uint64_t>>() ^ crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF] ^
+            t[4][(word >> 24) & 0xFF] ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+            t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+    }
+    for (; len > 0; ++p, --len) {
+        crc = (crc >> 8) ^ t[0][(crc ^ static_cast<uint8_t>(*p)) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(MONGO_CRC32C_HAVE_SSE42)
+
+bool detectSSE42() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return info[2] & (1 << 20);
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+// Zero during static initialization of other translation units, which only means that they get
+// the (equivalent) software implementation.
+const bool kHaveHardwareCrc32c = detectSSE42();
+
+MONGO_CRC32C_SSE42_TARGET uint32_t crc32cHardware(uint32_t crc, const char* p, size_t len) {
+    uint64_t crc64 = crc;
+    for (; len >= 8; p += 8, len -= 8) {
+        crc64 = _mm_crc32_u64(crc64, ConstDataView(p).read<LittleEndian<uint64_t>>());
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; len > 0; ++p, --len) {
+        crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*p));
+    }
+    return crc;
+}
+
+#elif defined(MONGO_CRC32C_HAVE_ARMV8)
+
+// The compiler only defines __ARM_FEATURE_CRC32 when every targeted CPU has the instructions.
+const bool kHaveHardwareCrc32c = true;
+
+uint32_t crc32cHardware(uint32_t crc, const char* p, size_t len) {
+    for (; len >= 8; p += 8, len -= 8) {
+        crc = __crc32cd(crc, ConstDataView(p).read<LittleEndian<uint64_t>>());
+    }
+    for (; len > 0; ++p, --len) {
+        crc = __crc32cb(crc, static_cast<uint8_t>(*p));
+    }
+    return crc;
+}
+
+#else
+
+const bool kHaveHardwareCrc32c = false;
+
+uint32_t crc32cHardware(uint32_t crc, const char* p, size_t len) {
+    return crc32cSoftware(crc, p, len);
+}
+
+#endif
+
+}  // namespace
+
+uint32_t crc32cExtend(uint32_t crc, const void* buf, size_t len) {
+    const char* p = static_cast<const char*>(buf);
+    crc = ~crc;
+    crc = kHaveHardwareCrc32c ? crc32cHardware(crc, p, len) : crc32cSoftware(crc, p, len);
+    return ~crc;
+}
+
+bool crc32cIsHardwareAccelerated() {
+    return kHaveHardwareCrc32c;
+}
+
+}  // namespace mongo
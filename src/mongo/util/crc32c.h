@@ -0,0 +1,55 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mongo {
+
+/**
+ * Computes the CRC-32C (Castagnoli) checksum of 'len' bytes at 'buf', continuing from 'crc',
+ * which is the value returned by a previous call over the preceding bytes, or 0 for the first
+ * call. The result is the same as that of a single call over the concatenated buffers.
+ *
+ * Uses the SSE4.2 crc32 instruction on x86-64 CPUs that support it and the ARMv8 CRC extension
+ * when the compiler targets it, and a table-driven implementation otherwise.
+ */
+uint32_t crc32cExtend(uint32_t crc, const void* buf, size_t len);
+
+inline uint32_t crc32c(const void* buf, size_t len) {
+    return crc32cExtend(0, buf, len);
+}
+
+/**
+ * Returns true if crc32cExtend() uses a hardware instruction on this machine.
+ */
+bool crc32cIsHardwareAccelerated();
+
+}  // namespace mongo
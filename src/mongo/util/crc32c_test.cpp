@@ -0,0 +1,88 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/crc32c.h"
+
+#include <cstring>
+#include <string>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(Crc32c, KnownVectors) {
+    ASSERT_EQ(0u, crc32c("", 0));
+    ASSERT_EQ(0xE3069283u, crc32c("123456789", 9));
+
+    const char zeros[32] = {};
+    ASSERT_EQ(0x8A9136AAu, crc32c(zeros, sizeof(zeros)));
+
+    char ones[32];
+    memset(ones, 0xFF, sizeof(ones));
+    ASSERT_EQ(0x62A8AB43u, crc32c(ones, sizeof(ones)));
+}
+
+TEST(Crc32c, ExtendMatchesSingleCall) {
+    PseudoRandom rng(1);
+    std::string data(10000, '\0');
+    for (auto& c : data) {
+        c = static_cast<char>(rng.nextInt32());
+    }
+    const uint32_t expected = crc32c(data.data(), data.size());
+
+    for (size_t split = 0; split < 40; ++split) {
+        uint32_t crc = crc32cExtend(0, data.data(), split);
+        crc = crc32cExtend(crc, data.data() + split, data.size() - split);
+        ASSERT_EQ(expected, crc);
+    }
+
+    uint32_t crc = 0;
+    for (size_t pos = 0; pos < data.size();) {
+        const size_t n = std::min<size_t>(rng.nextInt32(17), data.size() - pos);
+        crc = crc32cExtend(crc, data.data() + pos, n);
+        pos += n;
+    }
+    ASSERT_EQ(expected, crc);
+}
+
+TEST(Crc32c, DetectsSingleBitFlips) {
+    std::string data(256, 'x');
+    const uint32_t original = crc32c(data.data(), data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] ^= 0x10;
+        ASSERT_NE(original, crc32c(data.data(), data.size()));
+        data[i] ^= 0x10;
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -46,10 +46,15 @@ intrusive_ptr<const RCString> RCString::create(StringData s) {
     const size_t sizeWithNUL = s.size() + 1;
     const size_t bytesNeeded = sizeof(RCString) + sizeWithNUL;
 
+    intrusive_ptr<RCString> ptr;
+    if (auto arena = RefCountedArena::current()) {
+        ptr = arena->makeSized<RCString>(bytesNeeded);
+    } else {
 #pragma warning(push)
 #pragma warning(disable : 4291)
-    intrusive_ptr<RCString> ptr = new (bytesNeeded) RCString();  // uses custom operator new
+        ptr = new (bytesNeeded) RCString();  // uses custom operator new
 #pragma warning(pop)
+    }
 
     ptr->_size = s.size();
     char* stringStart = reinterpret_cast<char*>(ptr.get()) + sizeof(RCString);
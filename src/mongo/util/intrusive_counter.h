@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
+#include "mongo/util/ref_counted_arena.h"
 
 namespace mongo {
 
@@ -98,21 +99,48 @@ public:
     }
 
     friend void intrusive_ptr_add_ref(const RefCountable* ptr) {
+        if (ptr->_arenaAllocated) {
+            // Arena objects are confined to a single thread, so the count need not be atomic.
+            ++reinterpret_cast<unsigned&>(ptr->_count);
+            return;
+        }
         ptr->_count.addAndFetch(1);
     };
 
     friend void intrusive_ptr_release(const RefCountable* ptr) {
+        if (ptr->_arenaAllocated) {
+            if (--reinterpret_cast<unsigned&>(ptr->_count) == 0) {
+                ptr->destroyInArena();
+            }
+            return;
+        }
         if (ptr->_count.subtractAndFetch(1) == 0) {
             delete ptr;  // uses subclass destructor and operator delete
         }
     };
 
+    /// True if this object was made by RefCountedArena::make().
+    bool isArenaAllocated() const {
+        return _arenaAllocated;
+    }
+
 protected:
     RefCountable() {}
     virtual ~RefCountable() {}
 
 private:
+    friend class RefCountedArena;
+
+    void destroyInArena() const {
+        // The arena allocation starts at the most derived object, which may not be where this
+        // base class subobject is.
+        void* allocation = const_cast<void*>(dynamic_cast<const void*>(this));
+        this->~RefCountable();
+        RefCountedArena::deallocate(allocation);
+    }
+
     mutable AtomicUInt32 _count;  // default initialized to 0
+    bool _arenaAllocated = false;
 };
 
 /// This is an immutable reference-counted string
@@ -128,6 +156,9 @@ public:
         return StringData(c_str(), _size);
     }
 
+    /**
+     * Copies 's' into a new RCString, made in the current RefCountedArena if there is one.
+     */
     static boost::intrusive_ptr<const RCString> create(StringData s);
 
 // MSVC: C4291: 'declaration' : no matching operator delete found; memory will not be freed if
@@ -142,6 +173,8 @@ public:
 #pragma warning(pop)
 
 private:
+    friend class RefCountedArena;
+
     // these can only be created by calling create()
     RCString(){};
     void* operator new(size_t objSize, size_t realSize) {
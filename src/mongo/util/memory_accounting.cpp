@@ -0,0 +1,87 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/memory_accounting.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+namespace {
+
+// Accounts are only created during static initialization, so the registry needs no locking.
+std::vector<MemoryAccount*>& registeredAccounts() {
+    static std::vector<MemoryAccount*> accounts;
+    return accounts;
+}
+
+}  // namespace
+
+namespace memory_accounts {
+
+MemoryAccount planCache("planCache");
+MemoryAccount cursors("cursors");
+MemoryAccount sorters("sorters");
+MemoryAccount aggregation("aggregation");
+MemoryAccount networkBuffers("networkBuffers");
+
+}  // namespace memory_accounts
+
+constexpr long long MemoryAccount::Charge::kUpdateGranularityBytes;
+
+MemoryAccount::MemoryAccount(StringData name) : _name(name.toString()) {
+    registeredAccounts().push_back(this);
+}
+
+void MemoryAccount::appendAll(BSONObjBuilder* builder) {
+    long long total = 0;
+    for (const auto account : registeredAccounts()) {
+        const long long bytes = account->getBytes();
+        builder->append(account->getName(), bytes);
+        total += bytes;
+    }
+    builder->append("total", total);
+}
+
+void MemoryAccount::Charge::set(long long bytes) {
+    _bytes = bytes;
+    const long long difference = bytes - _charged;
+    if (difference == 0 ||
+        (bytes != 0 && _charged != 0 && std::abs(difference) < kUpdateGranularityBytes)) {
+        return;
+    }
+
+    _account->_bytes.addAndFetch(difference);
+    _charged = bytes;
+}
+
+}  // namespace mongo
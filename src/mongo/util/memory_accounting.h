@@ -0,0 +1,118 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Approximate accounting of the memory held by a subsystem of the server, so that the memory the
+ * allocator reports can be attributed to the plan cache, cursors, sorts and so on. Accounts are
+ * only defined at namespace scope, below, and are charged through Charge objects that live as
+ * long as the memory they account for.
+ */
+class MemoryAccount {
+    MONGO_DISALLOW_COPYING(MemoryAccount);
+
+public:
+    class Charge;
+
+    explicit MemoryAccount(StringData name);
+
+    /**
+     * Appends the number of bytes charged to every account, and their total, to 'builder'.
+     */
+    static void appendAll(BSONObjBuilder* builder);
+
+    StringData getName() const {
+        return _name;
+    }
+
+    long long getBytes() const {
+        return _bytes.load();
+    }
+
+private:
+    const std::string _name;
+    AtomicInt64 _bytes{0};
+};
+
+/**
+ * A number of bytes charged to a MemoryAccount until the charge is set to 0 or destroyed.
+ *
+ * Changes to a charge are only applied to its account once they add up to kUpdateGranularityBytes,
+ * so that charges can be updated as often as every document of a sort without every update
+ * contending on the account. Setting a charge for the first time, or to 0, is applied at once.
+ */
+class MemoryAccount::Charge {
+    MONGO_DISALLOW_COPYING(Charge);
+
+public:
+    static constexpr long long kUpdateGranularityBytes = 4 * 1024;
+
+    explicit Charge(MemoryAccount* account) : _account(account) {}
+
+    ~Charge() {
+        set(0);
+    }
+
+    /**
+     * Sets the number of bytes this charge accounts for.
+     */
+    void set(long long bytes);
+
+    long long get() const {
+        return _bytes;
+    }
+
+private:
+    MemoryAccount* const _account;
+
+    // The bytes last set, and the bytes applied to the account.
+    long long _bytes = 0;
+    long long _charged = 0;
+};
+
+namespace memory_accounts {
+
+extern MemoryAccount planCache;
+extern MemoryAccount cursors;
+extern MemoryAccount sorters;
+extern MemoryAccount aggregation;
+extern MemoryAccount networkBuffers;
+
+}  // namespace memory_accounts
+}  // namespace mongo
@@ -0,0 +1,91 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/memory_accounting.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+MemoryAccount testAccount("memoryAccountingTest");
+
+using Charge = MemoryAccount::Charge;
+
+TEST(MemoryAccountingTest, ChargesAreAppliedAndReleased) {
+    const long long start = testAccount.getBytes();
+    {
+        Charge charge(&testAccount);
+        charge.set(100);
+        ASSERT_EQ(start + 100, testAccount.getBytes());
+    }
+    ASSERT_EQ(start, testAccount.getBytes());
+}
+
+TEST(MemoryAccountingTest, SmallChangesAreDeferred) {
+    const long long start = testAccount.getBytes();
+    Charge charge(&testAccount);
+    charge.set(100);
+
+    charge.set(100 + Charge::kUpdateGranularityBytes - 1);
+    ASSERT_EQ(100 + Charge::kUpdateGranularityBytes - 1, charge.get());
+    ASSERT_EQ(start + 100, testAccount.getBytes());
+
+    charge.set(100 + Charge::kUpdateGranularityBytes);
+    ASSERT_EQ(start + 100 + Charge::kUpdateGranularityBytes, testAccount.getBytes());
+
+    charge.set(0);
+    ASSERT_EQ(start, testAccount.getBytes());
+}
+
+TEST(MemoryAccountingTest, AppendAllReportsEveryAccountAndTheTotal) {
+    Charge charge(&testAccount);
+    charge.set(1000);
+
+    BSONObjBuilder builder;
+    MemoryAccount::appendAll(&builder);
+    const BSONObj obj = builder.obj();
+
+    ASSERT_EQ(testAccount.getBytes(), obj["memoryAccountingTest"].numberLong());
+    ASSERT(obj.hasField("planCache"));
+    ASSERT(obj.hasField("networkBuffers"));
+
+    long long total = 0;
+    for (auto&& elem : obj) {
+        if (elem.fieldNameStringData() != "total") {
+            total += elem.numberLong();
+        }
+    }
+    ASSERT_EQ(total, obj["total"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
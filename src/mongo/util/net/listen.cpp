@@ -652,7 +652,7 @@ void Listener::shutdown() {
     _finished.store(true);
 }
 
-TicketHolder Listener::globalTicketHolder(DEFAULT_MAX_CONN);
+SemaphoreTicketHolder Listener::globalTicketHolder(DEFAULT_MAX_CONN);
 AtomicInt64 Listener::globalConnectionNumber;
 
 void ListeningSockets::closeAll() {
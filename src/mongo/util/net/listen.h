@@ -116,7 +116,7 @@ public:
     static AtomicInt64 globalConnectionNumber;
 
     /** keeps track of how many allowed connections there are and how many are being used*/
-    static TicketHolder globalTicketHolder;
+    static SemaphoreTicketHolder globalTicketHolder;
 
     /** makes sure user input is sane */
     static void checkTicketNumbers();
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/net/op_msg.h"
+
+namespace mongo {
+namespace {
+
+Message makeInsertMessage(int64_t numDocuments) {
+    OpMsgBuilder builder;
+    builder.setBody(BSON("insert"
+                         << "coll"
+                         << "ordered"
+                         << true
+                         << "$db"
+                         << "benchmarkdb"));
+    {
+        auto docs = builder.beginDocSequence("documents");
+        for (int64_t i = 0; i < numDocuments; ++i) {
+            docs.append(BSON("_id" << static_cast<int>(i) << "payload"
+                                   << "some document payload"));
+        }
+    }
+    return builder.finish();
+}
+
+void BM_OpMsgParse(benchmark::State& state) {
+    const Message message = makeInsertMessage(state.range());
+    while (state.keepRunning()) {
+        auto request = OpMsgRequest::parse(message);
+        benchmark::doNotOptimize(request.sequences.size());
+    }
+    state.setBytesProcessed(state.iterations() * message.size());
+}
+MONGO_BENCHMARK(BM_OpMsgParse)->arg(0)->arg(16)->arg(1000);
+
+void BM_OpMsgBuild(benchmark::State& state) {
+    const auto numDocuments = state.range();
+    const BSONObj doc = BSON("_id" << 1 << "payload"
+                                   << "some document payload");
+    while (state.keepRunning()) {
+        OpMsgBuilder builder;
+        builder.setBody(BSON("insert"
+                             << "coll"
+                             << "$db"
+                             << "benchmarkdb"));
+        {
+            auto docs = builder.beginDocSequence("documents");
+            for (int64_t i = 0; i < numDocuments; ++i) {
+                docs.append(doc);
+            }
+        }
+        benchmark::doNotOptimize(builder.finish().size());
+    }
+    state.setItemsProcessed(state.iterations() * numDocuments);
+}
+MONGO_BENCHMARK(BM_OpMsgBuild)->arg(16)->arg(1000);
+
+}  // namespace
+}  // namespace mongo
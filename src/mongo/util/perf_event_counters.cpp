@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/perf_event_counters.h"
+
+#if defined(__linux__)
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+#if defined(__linux__)
+
+namespace {
+
+struct EventDefinition {
+    const char* name;
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+const EventDefinition kEventDefinitions[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"llcMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branchMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"contextSwitches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+// Layout of a read(2) of a counter opened with kReadFormat.
+struct CounterValue {
+    std::uint64_t value;
+    std::uint64_t timeEnabled;
+    std::uint64_t timeRunning;
+};
+
+const std::uint64_t kReadFormat = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+int perfEventOpen(perf_event_attr* attr, pid_t tid) {
+    return syscall(__NR_perf_event_open, attr, tid, -1 /* any cpu */, -1 /* no group */, 0);
+}
+
+/**
+ * Opens a counter of the event on the thread, returning -1 and setting errno on failure.
+ */
+int openCounter(const EventDefinition& definition, pid_t tid) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = definition.type;
+    attr.config = definition.config;
+    attr.read_format = kReadFormat;
+    attr.inherit = 1;
+
+    int fd = perfEventOpen(&attr, tid);
+    if (fd < 0 && errno == EACCES) {
+        // Unprivileged processes may only count user space events.
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = perfEventOpen(&attr, tid);
+    }
+
+    if (fd >= 0) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return fd;
+}
+
+std::vector<pid_t> listThreads() {
+    std::vector<pid_t> tids;
+
+    boost::system::error_code ec;
+    boost::filesystem::directory_iterator it("/proc/self/task", ec);
+    for (; !ec && it != boost::filesystem::directory_iterator(); it.increment(ec)) {
+        int tid;
+        if (parseNumberFromString(it->path().filename().string(), &tid).isOK()) {
+            tids.push_back(tid);
+        }
+    }
+
+    return tids;
+}
+
+}  // namespace
+
+StatusWith<std::unique_ptr<PerfEventCounters>> PerfEventCounters::create() {
+    std::unique_ptr<PerfEventCounters> counters(new PerfEventCounters());
+
+    const auto tids = listThreads();
+    if (tids.empty()) {
+        return Status(ErrorCodes::InternalError, "Failed to list the threads in /proc/self/task");
+    }
+
+    int lastErrno = 0;
+    for (const auto& definition : kEventDefinitions) {
+        Event event{definition.name, {}};
+        bool supported = true;
+        for (auto tid : tids) {
+            const int fd = openCounter(definition, tid);
+            if (fd < 0) {
+                // The thread may have exited since the threads were listed. Any other error means
+                // the event cannot be counted, and counting it on some of the threads only would
+                // make the counts misleading.
+                if (errno == ESRCH) {
+                    continue;
+                }
+                lastErrno = errno;
+                supported = false;
+                break;
+            }
+            event.fds.push_back(fd);
+        }
+
+        if (!supported || event.fds.empty()) {
+            for (auto fd : event.fds) {
+                close(fd);
+            }
+            continue;
+        }
+
+        counters->_events.push_back(std::move(event));
+    }
+
+    if (counters->_events.empty()) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Failed to open any performance counter: "
+                                    << strerror(lastErrno));
+    }
+
+    return {std::move(counters)};
+}
+
+PerfEventCounters::~PerfEventCounters() {
+    for (const auto& event : _events) {
+        for (auto fd : event.fds) {
+            close(fd);
+        }
+    }
+}
+
+void PerfEventCounters::append(BSONObjBuilder* builder) const {
+    for (const auto& event : _events) {
+        double count = 0;
+        for (auto fd : event.fds) {
+            CounterValue counter;
+            if (read(fd, &counter, sizeof(counter)) != static_cast<ssize_t>(sizeof(counter))) {
+                continue;
+            }
+
+            if (counter.timeRunning == 0) {
+                continue;
+            }
+
+            // Scale up the count if the counter was multiplexed with others.
+            count += static_cast<double>(counter.value) * counter.timeEnabled / counter.timeRunning;
+        }
+
+        builder->append(event.name, static_cast<long long>(count));
+    }
+}
+
+#else
+
+StatusWith<std::unique_ptr<PerfEventCounters>> PerfEventCounters::create() {
+    return Status(ErrorCodes::InternalError,
+                  "Performance counters are only supported on Linux");
+}
+
+PerfEventCounters::~PerfEventCounters() = default;
+
+void PerfEventCounters::append(BSONObjBuilder* builder) const {}
+
+#endif
+
+}  // namespace mongo
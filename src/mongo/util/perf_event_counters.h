@@ -0,0 +1,84 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Counts hardware and software events of the whole process with the Linux perf_event_open(2)
+ * interface: cycles, instructions, last level cache misses, branch misses and context switches.
+ *
+ * A counter for each event is opened on every thread which exists when the counters are created.
+ * The counters are inherited by the threads those threads create afterwards, and reading a counter
+ * includes the counts of the threads which inherited it, so the sum covers the whole process.
+ *
+ * Events the hardware or the kernel do not support are skipped. When the kernel multiplexes the
+ * hardware counters, the counts are scaled by the fraction of time the counter was running.
+ *
+ * Thread-safe once created.
+ */
+class PerfEventCounters {
+    MONGO_DISALLOW_COPYING(PerfEventCounters);
+
+public:
+    ~PerfEventCounters();
+
+    /**
+     * Opens the counters. Fails if no event could be counted, e.g. due to
+     * /proc/sys/kernel/perf_event_paranoid, or if the platform is not Linux.
+     */
+    static StatusWith<std::unique_ptr<PerfEventCounters>> create();
+
+    /**
+     * Appends the current count of each event.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    struct Event {
+        const char* name;
+
+        // One file descriptor per thread the event was opened on.
+        std::vector<int> fds;
+    };
+
+    PerfEventCounters() = default;
+
+    std::vector<Event> _events;
+};
+
+}  // namespace mongo
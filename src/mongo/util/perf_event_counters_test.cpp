@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/perf_event_counters.h"
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj readCounters(const PerfEventCounters& counters) {
+    BSONObjBuilder builder;
+    counters.append(&builder);
+    return builder.obj();
+}
+
+// Counts never go backwards, and include the threads created after the counters were opened.
+TEST(PerfEventCountersTest, CountsIncludeThreadsCreatedLater) {
+    auto swCounters = PerfEventCounters::create();
+    if (!swCounters.isOK()) {
+        // Not Linux, or the kernel does not let this process count its events.
+        unittest::log() << "Skipping test: " << swCounters.getStatus();
+        return;
+    }
+
+    const auto& counters = *swCounters.getValue();
+    const BSONObj before = readCounters(counters);
+    ASSERT_FALSE(before.isEmpty());
+
+    stdx::thread worker([] {
+        volatile long long sum = 0;
+        for (long long i = 0; i < 10 * 1000 * 1000; i++) {
+            sum += i;
+        }
+    });
+    worker.join();
+
+    const BSONObj after = readCounters(counters);
+    ASSERT_EQ(before.nFields(), after.nFields());
+    for (const auto& element : before) {
+        ASSERT_GTE(element.numberLong(), 0) << element;
+        ASSERT_GTE(after[element.fieldNameStringData()].numberLong(), element.numberLong())
+            << element;
+    }
+
+    if (after.hasField("instructions")) {
+        ASSERT_GT(after["instructions"].numberLong(), before["instructions"].numberLong());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/ref_counted_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * The header at the start of every chunk. Each allocation is preceded by a pointer back to the
+ * header of the chunk it was made in.
+ */
+struct RefCountedArena::Chunk {
+    size_t liveAllocations = 0;
+    bool retired = false;
+};
+
+namespace {
+
+const size_t kAlignment = 8;
+const size_t kAllocationHeaderBytes = sizeof(void*);
+
+thread_local RefCountedArena* currentArena = nullptr;
+
+size_t alignUp(size_t bytes) {
+    return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}  // namespace
+
+RefCountedArena::RefCountedArena(size_t chunkBytes) : _chunkBytes(chunkBytes) {}
+
+RefCountedArena::~RefCountedArena() {
+    retireChunk();
+}
+
+RefCountedArena* RefCountedArena::current() {
+    return currentArena;
+}
+
+RefCountedArena::Scope::Scope(RefCountedArena* arena) : _previous(currentArena) {
+    currentArena = arena;
+}
+
+RefCountedArena::Scope::~Scope() {
+    currentArena = _previous;
+}
+
+void* RefCountedArena::allocate(size_t bytes) {
+    const size_t chunkHeaderBytes = alignUp(sizeof(Chunk));
+    const size_t needed = kAllocationHeaderBytes + alignUp(bytes);
+
+    Chunk* chunk;
+    char* start;
+    if (needed > _chunkBytes / 4) {
+        // Large allocations get a chunk of their own, which is retired from the start, rather than
+        // wasting most of the current one.
+        start = static_cast<char*>(mongoMalloc(chunkHeaderBytes + needed));
+        chunk = new (start) Chunk();
+        chunk->retired = true;
+        start += chunkHeaderBytes;
+    } else {
+        if (!_chunk || static_cast<size_t>(_end - _next) < needed) {
+            retireChunk();
+            const size_t chunkBytes = std::max(_chunkBytes, chunkHeaderBytes + needed);
+            char* memory = static_cast<char*>(mongoMalloc(chunkBytes));
+            _chunk = new (memory) Chunk();
+            _next = memory + chunkHeaderBytes;
+            _end = memory + chunkBytes;
+        }
+        chunk = _chunk;
+        start = _next;
+        _next += needed;
+    }
+
+    ++chunk->liveAllocations;
+    *reinterpret_cast<Chunk**>(start) = chunk;
+    return start + kAllocationHeaderBytes;
+}
+
+void RefCountedArena::deallocate(void* ptr) {
+    Chunk* chunk = *reinterpret_cast<Chunk**>(static_cast<char*>(ptr) - kAllocationHeaderBytes);
+    dassert(chunk->liveAllocations > 0);
+    if (--chunk->liveAllocations == 0 && chunk->retired) {
+        std::free(chunk);
+    }
+}
+
+void RefCountedArena::retireChunk() {
+    if (!_chunk) {
+        return;
+    }
+
+    _chunk->retired = true;
+    if (_chunk->liveAllocations == 0) {
+        std::free(_chunk);
+    }
+    _chunk = nullptr;
+    _next = _end = nullptr;
+}
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+/**
+ * A bump allocator for short-lived reference counted objects, such as the Documents and strings
+ * an aggregation pipeline builds while producing a batch of results.
+ *
+ * Memory is carved out of large chunks, and a chunk goes back to the heap as a whole once the arena
+ * has retired it and everything allocated from it has been deallocated. An object which outlives
+ * the batch it was made in, for example one held by a $group, stays valid and only keeps its own
+ * chunk alive.
+ *
+ * RefCountable objects made with make() are reference counted non-atomically, so they, and
+ * everything else allocated from the arena, must only be used by one thread at a time.
+ */
+class RefCountedArena {
+    MONGO_DISALLOW_COPYING(RefCountedArena);
+
+public:
+    static const size_t kDefaultChunkBytes = 64 * 1024;
+
+    explicit RefCountedArena(size_t chunkBytes = kDefaultChunkBytes);
+    ~RefCountedArena();
+
+    /**
+     * Returns the arena set by the innermost Scope on this thread, or nullptr if there is none.
+     */
+    static RefCountedArena* current();
+
+    /**
+     * Makes 'arena' the current arena on this thread until the Scope is destroyed. A null 'arena'
+     * means that nothing should be allocated in an arena.
+     */
+    class Scope {
+        MONGO_DISALLOW_COPYING(Scope);
+
+    public:
+        explicit Scope(RefCountedArena* arena);
+        ~Scope();
+
+    private:
+        RefCountedArena* const _previous;
+    };
+
+    /**
+     * Returns 'bytes' of memory aligned for any pointer or 8-byte scalar. The memory must be
+     * passed to deallocate(), but may outlive the arena.
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * Releases memory returned by allocate() on any arena.
+     */
+    static void deallocate(void* ptr);
+
+    /**
+     * Constructs a T which derives from RefCountable in 'bytes' of arena memory, which must be at
+     * least sizeof(T). The object is destroyed and its memory deallocated when its last reference
+     * is released.
+     */
+    template <typename T, typename... Args>
+    T* makeSized(size_t bytes, Args&&... args) {
+        void* ptr = allocate(bytes);
+        T* obj;
+        try {
+            obj = ::new (ptr) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(ptr);
+            throw;
+        }
+        obj->_arenaAllocated = true;
+        return obj;
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        return makeSized<T>(sizeof(T), std::forward<Args>(args)...);
+    }
+
+    /**
+     * Stops allocating from the current chunk so that it is released as soon as everything made
+     * from it has been deallocated. Called once each batch of results has been handed off.
+     */
+    void retireChunk();
+
+private:
+    struct Chunk;
+
+    const size_t _chunkBytes;
+
+    Chunk* _chunk = nullptr;
+    char* _next = nullptr;
+    char* _end = nullptr;
+};
+
+}  // namespace mongo
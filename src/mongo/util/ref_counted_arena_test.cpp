@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/ref_counted_arena.h"
+
+#include <cstring>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/intrusive_counter.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+class Tracked : public RefCountable {
+public:
+    explicit Tracked(int* liveCount) : _liveCount(liveCount) {
+        ++*_liveCount;
+    }
+
+    ~Tracked() {
+        --*_liveCount;
+    }
+
+private:
+    int* const _liveCount;
+};
+
+TEST(RefCountedArenaTest, AllocationsAreAlignedAndDoNotOverlap) {
+    RefCountedArena arena(1024);
+    std::vector<char*> allocations;
+    for (size_t i = 0; i < 100; i++) {
+        char* ptr = static_cast<char*>(arena.allocate(i + 1));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % 8, 0U);
+        memset(ptr, static_cast<int>(i), i + 1);
+        allocations.push_back(ptr);
+    }
+
+    for (size_t i = 0; i < allocations.size(); i++) {
+        for (size_t j = 0; j <= i; j++) {
+            ASSERT_EQ(allocations[i][j], static_cast<char>(i));
+        }
+        RefCountedArena::deallocate(allocations[i]);
+    }
+}
+
+TEST(RefCountedArenaTest, LargeAllocationsSucceed) {
+    RefCountedArena arena(1024);
+    char* ptr = static_cast<char*>(arena.allocate(64 * 1024));
+    memset(ptr, 'x', 64 * 1024);
+    RefCountedArena::deallocate(ptr);
+}
+
+TEST(RefCountedArenaTest, ObjectIsDestroyedWhenLastReferenceIsReleased) {
+    int liveCount = 0;
+    RefCountedArena arena;
+    {
+        intrusive_ptr<Tracked> first(arena.make<Tracked>(&liveCount));
+        ASSERT_TRUE(first->isArenaAllocated());
+        ASSERT_FALSE(first->isShared());
+        ASSERT_EQ(liveCount, 1);
+
+        intrusive_ptr<Tracked> second = first;
+        ASSERT_TRUE(first->isShared());
+
+        first.reset();
+        ASSERT_EQ(liveCount, 1);
+        ASSERT_FALSE(second->isShared());
+    }
+    ASSERT_EQ(liveCount, 0);
+}
+
+TEST(RefCountedArenaTest, ObjectMayOutliveArena) {
+    int liveCount = 0;
+    intrusive_ptr<Tracked> survivor;
+    {
+        RefCountedArena arena;
+        survivor = arena.make<Tracked>(&liveCount);
+        intrusive_ptr<Tracked> transient(arena.make<Tracked>(&liveCount));
+        ASSERT_EQ(liveCount, 2);
+    }
+    ASSERT_EQ(liveCount, 1);
+    survivor.reset();
+    ASSERT_EQ(liveCount, 0);
+}
+
+TEST(RefCountedArenaTest, RetiringChunkKeepsExistingObjectsValid) {
+    RefCountedArena arena;
+    RefCountedArena::Scope scope(&arena);
+
+    auto before = RCString::create("a string made before the chunk was retired");
+    ASSERT_TRUE(before->isArenaAllocated());
+    arena.retireChunk();
+    auto after = RCString::create("a string made after the chunk was retired");
+
+    ASSERT_EQ(before->stringData(), "a string made before the chunk was retired");
+    ASSERT_EQ(after->stringData(), "a string made after the chunk was retired");
+}
+
+TEST(RefCountedArenaTest, ScopeSetsAndRestoresCurrentArena) {
+    ASSERT_FALSE(RefCountedArena::current());
+
+    RefCountedArena outer;
+    RefCountedArena::Scope outerScope(&outer);
+    ASSERT_EQ(RefCountedArena::current(), &outer);
+    {
+        RefCountedArena::Scope noArena(nullptr);
+        ASSERT_FALSE(RefCountedArena::current());
+        ASSERT_FALSE(RCString::create("made on the heap")->isArenaAllocated());
+    }
+    ASSERT_EQ(RefCountedArena::current(), &outer);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/platform/unordered_map.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+std::vector<std::string> makeKeys(int64_t numKeys) {
+    std::vector<std::string> keys;
+    for (int64_t i = 0; i < numKeys; ++i) {
+        keys.push_back("someFieldName" + std::to_string(i));
+    }
+    return keys;
+}
+
+template <typename Map>
+void insertAll(benchmark::State& state) {
+    const auto keys = makeKeys(state.range());
+    while (state.keepRunning()) {
+        Map map;
+        for (auto&& key : keys) {
+            map[key] = 1;
+        }
+        benchmark::doNotOptimize(map.size());
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+
+template <typename Map>
+void findAll(benchmark::State& state) {
+    const auto keys = makeKeys(state.range());
+    Map map;
+    for (auto&& key : keys) {
+        map[key] = 1;
+    }
+
+    while (state.keepRunning()) {
+        size_t found = 0;
+        for (auto&& key : keys) {
+            found += map.find(key) != map.end();
+        }
+        benchmark::doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+
+template <typename Map>
+void findMissing(benchmark::State& state) {
+    const auto keys = makeKeys(state.range());
+    const auto missingKeys = makeKeys(2 * state.range());
+    Map map;
+    for (auto&& key : keys) {
+        map[key] = 1;
+    }
+
+    while (state.keepRunning()) {
+        size_t found = 0;
+        for (size_t i = keys.size(); i < missingKeys.size(); ++i) {
+            found += map.find(missingKeys[i]) != map.end();
+        }
+        benchmark::doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+
+void BM_StringMapInsert(benchmark::State& state) {
+    insertAll<StringMap<int>>(state);
+}
+MONGO_BENCHMARK(BM_StringMapInsert)->arg(16)->arg(1024)->arg(65536);
+
+void BM_StdUnorderedMapInsert(benchmark::State& state) {
+    insertAll<stdx::unordered_map<std::string, int>>(state);
+}
+MONGO_BENCHMARK(BM_StdUnorderedMapInsert)->arg(16)->arg(1024)->arg(65536);
+
+void BM_StringMapFind(benchmark::State& state) {
+    findAll<StringMap<int>>(state);
+}
+MONGO_BENCHMARK(BM_StringMapFind)->arg(16)->arg(1024)->arg(65536);
+
+void BM_StdUnorderedMapFind(benchmark::State& state) {
+    findAll<stdx::unordered_map<std::string, int>>(state);
+}
+MONGO_BENCHMARK(BM_StdUnorderedMapFind)->arg(16)->arg(1024)->arg(65536);
+
+void BM_StringMapFindMissing(benchmark::State& state) {
+    findMissing<StringMap<int>>(state);
+}
+MONGO_BENCHMARK(BM_StringMapFindMissing)->arg(16)->arg(1024)->arg(65536);
+
+void BM_StdUnorderedMapFindMissing(benchmark::State& state) {
+    findMissing<stdx::unordered_map<std::string, int>>(state);
+}
+MONGO_BENCHMARK(BM_StdUnorderedMapFindMissing)->arg(16)->arg(1024)->arg(65536);
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/platform/random.h"
 #include "mongo/platform/unordered_map.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/string_map.h"
 #include "mongo/util/timer.h"
 
@@ -215,4 +216,84 @@ TEST(StringMapTest, InitWithInitializerList) {
     ASSERT_EQ(2, smap["coollog"]);
     ASSERT_EQ(3, smap["mango"]);
 }
+
+TEST(StringMapTest, RepeatedEraseAndInsertDoesNotGrowUnboundedly) {
+    StringMap<int> m;
+    char buf[64];
+
+    // Churn through many more distinct keys than the map ever holds at once, so that it fills up
+    // with tombstones which must be reclaimed.
+    for (int i = 0; i < 100000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+        if (i >= 10) {
+            sprintf(buf, "foo%d", i - 10);
+            ASSERT_EQUALS(1U, m.erase(buf));
+        }
+    }
+
+    ASSERT_EQUALS(10U, m.size());
+    ASSERT_LTE(m.capacity(), 64U);
+    for (int i = 100000 - 10; i < 100000; i++) {
+        sprintf(buf, "foo%d", i);
+        ASSERT_TRUE(m.find(buf) != m.end());
+        ASSERT_EQUALS(i, m[buf]);
+    }
+}
+
+TEST(StringMapTest, CopyPreservesEntriesAfterErase) {
+    StringMap<int> m;
+    char buf[64];
+    for (int i = 0; i < 1000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        sprintf(buf, "foo%d", i);
+        m.erase(buf);
+    }
+
+    StringMap<int> y = m;
+    ASSERT_EQUALS(500U, y.size());
+    size_t numIterated = 0;
+    for (auto&& entry : y) {
+        ASSERT_EQUALS(1, entry.second % 2);
+        ASSERT_EQUALS(entry.second, m[entry.first]);
+        numIterated++;
+    }
+    ASSERT_EQUALS(500U, numIterated);
+}
+
+TEST(StringMapTest, MatchesStdUnorderedMapUnderRandomOperations) {
+    PseudoRandom rng(12345);
+    StringMap<int> m;
+    stdx::unordered_map<std::string, int> expected;
+
+    for (int i = 0; i < 100000; i++) {
+        const std::string key = str::stream() << "key" << rng.nextInt32(2000);
+        switch (rng.nextInt32(3)) {
+            case 0:
+                m[key] = i;
+                expected[key] = i;
+                break;
+            case 1:
+                ASSERT_EQUALS(expected.erase(key), m.erase(key));
+                break;
+            case 2: {
+                auto it = m.find(key);
+                auto expectedIt = expected.find(key);
+                ASSERT_EQUALS(expectedIt == expected.end(), it == m.end());
+                if (it != m.end()) {
+                    ASSERT_EQUALS(expectedIt->second, it->second);
+                }
+                break;
+            }
+        }
+        ASSERT_EQUALS(expected.size(), m.size());
+    }
+
+    for (auto&& entry : expected) {
+        ASSERT_EQUALS(entry.second, m[entry.first]);
+    }
+}
 }
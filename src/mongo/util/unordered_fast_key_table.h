@@ -29,15 +29,107 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 
+// TODO replace this with #if BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSE2_VERSION in boost 1.60
+#if defined(_M_AMD64) || defined(__amd64__)
+#define MONGO_UNORDERED_FAST_KEY_TABLE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+namespace unordered_fast_key_table_detail {
+
+/**
+ * Every slot of the table has a control byte which says whether it is empty, deleted (a
+ * tombstone), or full. A full slot's control byte holds the top 7 bits of its entry's hash, so
+ * that most mismatches are rejected without looking at the entry itself.
+ */
+using Ctrl = int8_t;
+const Ctrl kEmpty = -128;
+const Ctrl kDeleted = -2;
+
+inline bool isFull(Ctrl ctrl) {
+    return ctrl >= 0;
+}
+
+inline Ctrl hashToCtrl(uint32_t hash) {
+    return static_cast<Ctrl>(hash >> 25);
+}
+
+/**
+ * The slots are probed a group of kGroupWidth control bytes at a time. Each match* function
+ * returns a bitmask with bit i set if the i'th slot in the group matches.
+ */
+const unsigned kGroupWidth = 16;
+
+class Group {
+public:
+#ifdef MONGO_UNORDERED_FAST_KEY_TABLE_USE_SSE2
+    explicit Group(const Ctrl* pos)
+        : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    uint32_t match(Ctrl ctrl) const {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl), _ctrl));
+    }
+
+    uint32_t matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+        // Empty and deleted are the only control bytes less than -1.
+        return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl));
+    }
+
+private:
+    __m128i _ctrl;
+#else
+    explicit Group(const Ctrl* pos) : _pos(pos) {}
+
+    uint32_t match(Ctrl ctrl) const {
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < kGroupWidth; ++i) {
+            mask |= uint32_t(_pos[i] == ctrl) << i;
+        }
+        return mask;
+    }
+
+    uint32_t matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < kGroupWidth; ++i) {
+            mask |= uint32_t(_pos[i] < -1) << i;
+        }
+        return mask;
+    }
+
+private:
+    const Ctrl* _pos;
+#endif
+};
+
+/**
+ * Returns the index of the lowest set bit of a non-zero mask returned by Group.
+ */
+inline unsigned lowestBit(uint32_t mask) {
+    dassert(mask);
+    return countTrailingZeros64(mask);
+}
+
+}  // namespace unordered_fast_key_table_detail
+
 /**
  * A hash map that allows a different type to be used stored (K_S) than is used for lookups (K_L).
  *
@@ -55,6 +147,11 @@ namespace mongo {
  *     const K_L& key() const;
  *     uint32_t hash() const; // Should be free to call repeatedly.
  * };
+ *
+ * The table uses open addressing with the control bytes of its slots kept apart from the entries,
+ * so a lookup scans the control bytes of 16 slots at a time (with SSE2 where available) and only
+ * touches entries whose stored hash agrees with the key's in 7 bits. The table grows once it is
+ * 7/8 full, counting tombstones.
  */
 template <typename K_L,  // key lookup
           typename K_S,  // key storage
@@ -70,86 +167,49 @@ public:
     using HashedKey = typename Traits::HashedKey;
 
 private:
+    using Ctrl = unordered_fast_key_table_detail::Ctrl;
+
+    /**
+     * The storage for one slot. Whether it holds a value is recorded by the slot's control byte in
+     * the owning Area, which is responsible for constructing and destroying the value.
+     */
     class Entry {
     public:
-        Entry() = default;
-
-        Entry(const Entry& other)
-            : _used(other._used), _everUsed(other.everUsed), _curHash(other._curHash) {
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-        }
-
-        Entry& operator=(const Entry& other) {
-            if (this == &other) {
-                return *this;
-            }
-
-            if (isUsed()) {
-                unUse();
-            }
-
-            _used = other._used;
-            _everUsed = other._everUsed;
-            _curHash = other._curHash;
-
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-
-            return *this;
-        }
-
-        ~Entry() {
-            if (isUsed()) {
-                unUse();
-            }
-        }
-
         template <typename... Args>
         void emplaceData(const HashedKey& key, Args&&... args) {
-            dassert(!isUsed());
-            _used = true;
-            _everUsed = true;
-            _curHash = key.hash();
             new (&_data) value_type(std::piecewise_construct,
                                     std::forward_as_tuple(Traits::toStorage(key.key())),
                                     std::forward_as_tuple(std::forward<Args>(args)...));
+            _curHash = key.hash();
         }
 
-        bool isUsed() const {
-            return _used;
+        void copyData(const Entry& other) {
+            new (&_data) value_type(other.getData());
+            _curHash = other._curHash;
         }
 
-        bool wasEverUsed() const {
-            return _everUsed;
+        void moveData(Entry* other) {
+            new (&_data) value_type(std::move(other->getData()));
+            _curHash = other->_curHash;
         }
 
-        uint32_t getCurHash() const {
-            dassert(isUsed());
-            return _curHash;
+        void destroyData() {
+            getData().~value_type();
         }
 
-        void unUse() {
-            dassert(isUsed());
-            _used = false;
-            reinterpret_cast<value_type*>(&_data)->~value_type();
+        uint32_t getCurHash() const {
+            return _curHash;
         }
 
         value_type& getData() {
-            dassert(isUsed());
             return *reinterpret_cast<value_type*>(&_data);
         }
 
         const value_type& getData() const {
-            dassert(isUsed());
             return *reinterpret_cast<const value_type*>(&_data);
         }
 
     private:
-        bool _used = false;
-        bool _everUsed = false;
         uint32_t _curHash;
         typename std::aligned_storage<sizeof(value_type),
                                       std::alignment_of<value_type>::value>::type _data;
@@ -158,16 +218,12 @@ private:
     struct Area {
         Area() = default;  // TODO constexpr
 
-        Area(unsigned capacity, unsigned maxProbe)
-            : _hashMask(capacity - 1),
-              _maxProbe(maxProbe),
-              _entries(capacity ? new Entry[capacity] : nullptr) {
-            // Capacity must be a power of two or zero. See the comment on _hashMask for why.
-            dassert((capacity & (capacity - 1)) == 0);
-        }
+        explicit Area(unsigned capacity);
+
+        Area(const Area& other);
 
-        Area(const Area& other) : Area(other.capacity(), other._maxProbe) {
-            std::copy(other.begin(), other.end(), begin());
+        Area(Area&& other) {
+            swap(&other);
         }
 
         Area& operator=(const Area& other) {
@@ -175,14 +231,38 @@ private:
             return *this;
         }
 
-        int find(const HashedKey& key, int* firstEmpty) const;
+        Area& operator=(Area&& other) {
+            Area(std::move(other)).swap(this);
+            return *this;
+        }
+
+        ~Area();
+
+        /**
+         * Returns the slot holding 'key', or -1 if there is none.
+         */
+        int find(const HashedKey& key) const;
+
+        /**
+         * Returns the first empty or deleted slot on the probe sequence of 'hash'.
+         */
+        unsigned findSlotForInsert(uint32_t hash) const;
+
+        /**
+         * Moves every entry into 'newArea', which must have room for them all.
+         */
+        void transfer(Area* newArea);
+
+        template <typename... Args>
+        void emplaceAt(unsigned pos, const HashedKey& key, Args&&... args);
 
-        bool transfer(Area* newArea) const;
+        void eraseAt(unsigned pos);
 
         void swap(Area* other) {
             using std::swap;
             swap(_hashMask, other->_hashMask);
-            swap(_maxProbe, other->_maxProbe);
+            swap(_growthLeft, other->_growthLeft);
+            swap(_ctrl, other->_ctrl);
             swap(_entries, other->_entries);
         }
 
@@ -190,6 +270,10 @@ private:
             return _hashMask + 1;
         }
 
+        bool isFull(unsigned pos) const {
+            return unordered_fast_key_table_detail::isFull(_ctrl[pos]);
+        }
+
         Entry* begin() {
             return _entries.get();
         }
@@ -204,12 +288,17 @@ private:
             return _entries.get() + capacity();
         }
 
-        // Capacity is always a power of two. This means that the operation (hash % capacity) can be
-        // preformed by (hash & (capacity - 1)). Since we need the mask more than the capacity we
-        // store it directly and derive the capacity from it. The default capacity is 0 so the
-        // default hashMask is -1.
+        // Capacity is always a power of two, and a multiple of the group width once allocated.
+        // This means that the operation (hash % capacity) can be preformed by
+        // (hash & (capacity - 1)). Since we need the mask more than the capacity we store it
+        // directly and derive the capacity from it. The default capacity is 0 so the default
+        // hashMask is -1.
         unsigned _hashMask = -1;
-        unsigned _maxProbe = 0;
+
+        // How many more empty slots may be filled before the table must grow.
+        unsigned _growthLeft = 0;
+
+        std::unique_ptr<Ctrl[]> _ctrl = {};
         std::unique_ptr<Entry[]> _entries = {};
     };
 
@@ -326,7 +415,7 @@ public:
                     _position = -1;
                     break;
                 }
-                if (_area->_entries[_position].isUsed())
+                if (_area->isFull(_position))
                     break;
                 ++_position;
             }
@@ -354,7 +443,7 @@ public:
     const_iterator find(const HashedKey& key) const {
         if (empty())
             return end();
-        return const_iterator(&_area, _area.find(key, nullptr));
+        return const_iterator(&_area, _area.find(key));
     }
 
     iterator find(const K_L& key) {
@@ -366,7 +455,7 @@ public:
     iterator find(const HashedKey& key) {
         if (empty())
             return end();
-        return iterator(&_area, _area.find(key, nullptr));
+        return iterator(&_area, _area.find(key));
     }
 
     const_iterator begin() const {
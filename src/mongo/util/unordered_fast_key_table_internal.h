@@ -30,65 +30,183 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "mongo/util/unordered_fast_key_table.h"
 
 namespace mongo {
 
+namespace unordered_fast_key_table_detail {
+
+/**
+ * Walks the groups of a table with 'numGroups' groups, a power of two, in the order the slots for
+ * 'hash' are probed. The stride grows by one group each step, which visits every group once.
+ */
+class ProbeSequence {
+public:
+    ProbeSequence(uint32_t hash, unsigned numGroups)
+        : _groupMask(numGroups - 1), _group(hash & _groupMask) {}
+
+    unsigned groupOffset() const {
+        return _group * kGroupWidth;
+    }
+
+    void next() {
+        ++_index;
+        dassert(_index <= _groupMask);
+        _group = (_group + _index) & _groupMask;
+    }
+
+private:
+    const unsigned _groupMask;
+    unsigned _group;
+    unsigned _index = 0;
+};
+
+/**
+ * The most entries, counting tombstones, a table of 'capacity' slots may hold before growing.
+ */
+inline unsigned maxLoad(unsigned capacity) {
+    return capacity - capacity / 8;
+}
+
+}  // namespace unordered_fast_key_table_detail
+
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key,
-                                                                  int* firstEmpty) const {
-    dassert(capacity());                        // Caller must special-case empty tables.
-    dassert(!firstEmpty || *firstEmpty == -1);  // Caller must initialize *firstEmpty.
-
-    unsigned probe = 0;
-    do {
-        unsigned pos = (key.hash() + probe) & _hashMask;
-
-        if (!_entries[pos].isUsed()) {
-            // space is empty
-            if (firstEmpty && *firstEmpty == -1)
-                *firstEmpty = pos;
-            if (!_entries[pos].wasEverUsed())
-                return -1;
-            continue;
+inline UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::Area(unsigned capacity)
+    : _hashMask(capacity - 1),
+      _growthLeft(unordered_fast_key_table_detail::maxLoad(capacity)),
+      _ctrl(new Ctrl[capacity]),
+      _entries(new Entry[capacity]) {
+    // Capacity must be a power of two and a whole number of groups. See the comment on _hashMask.
+    dassert((capacity & (capacity - 1)) == 0);
+    dassert(capacity >= unordered_fast_key_table_detail::kGroupWidth);
+    std::fill(_ctrl.get(), _ctrl.get() + capacity, unordered_fast_key_table_detail::kEmpty);
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::Area(const Area& other) {
+    if (!other._entries) {
+        return;
+    }
+
+    // Each slot is only marked full once its value has been copied, so that if a copy throws,
+    // 'copy' destroys exactly the values copied so far.
+    Area copy(other.capacity());
+    for (unsigned pos = 0; pos < other.capacity(); ++pos) {
+        if (other.isFull(pos)) {
+            copy._entries[pos].copyData(other._entries[pos]);
         }
+        copy._ctrl[pos] = other._ctrl[pos];
+    }
+    copy._growthLeft = other._growthLeft;
+    swap(&copy);
+}
 
-        if (_entries[pos].getCurHash() != key.hash()) {
-            // space has something else
-            continue;
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::~Area() {
+    if (!_entries) {
+        return;
+    }
+
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (isFull(pos)) {
+            _entries[pos].destroyData();
         }
+    }
+}
 
-        if (!Traits::equals(key.key(), Traits::toLookup(_entries[pos].getData().first))) {
-            // hashes match
-            // strings are not equals
-            continue;
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key) const {
+    using namespace unordered_fast_key_table_detail;
+    dassert(capacity());  // Caller must special-case empty tables.
+
+    const Ctrl ctrl = hashToCtrl(key.hash());
+    for (ProbeSequence seq(key.hash(), capacity() / kGroupWidth);; seq.next()) {
+        const Group group(_ctrl.get() + seq.groupOffset());
+        for (uint32_t mask = group.match(ctrl); mask; mask &= mask - 1) {
+            const unsigned pos = seq.groupOffset() + lowestBit(mask);
+            const Entry& entry = _entries[pos];
+            if (entry.getCurHash() == key.hash() &&
+                Traits::equals(key.key(), Traits::toLookup(entry.getData().first))) {
+                return pos;
+            }
         }
 
-        // hashes and strings are equal
-        // yay!
-        return pos;
-    } while (++probe < _maxProbe);
-    return -1;
+        // An insert only moves on from a group which has no empty slot, so the key can't be in
+        // any later group.
+        if (group.matchEmpty()) {
+            return -1;
+        }
+    }
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline bool UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
-    for (auto&& entry : *this) {
-        if (!entry.isUsed())
-            continue;
+inline unsigned UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::findSlotForInsert(
+    uint32_t hash) const {
+    using namespace unordered_fast_key_table_detail;
+    dassert(capacity());
+
+    // There is always an empty slot somewhere, since the table grows before it is full.
+    for (ProbeSequence seq(hash, capacity() / kGroupWidth);; seq.next()) {
+        if (uint32_t mask = Group(_ctrl.get() + seq.groupOffset()).matchEmptyOrDeleted()) {
+            return seq.groupOffset() + lowestBit(mask);
+        }
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+template <typename... Args>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::emplaceAt(unsigned pos,
+                                                                         const HashedKey& key,
+                                                                         Args&&... args) {
+    using namespace unordered_fast_key_table_detail;
+    dassert(!isFull(pos));
+    const bool wasEmpty = _ctrl[pos] == kEmpty;
+    dassert(!wasEmpty || _growthLeft > 0);
+
+    // Only mark the slot as full once the value has been constructed, in case that throws.
+    _entries[pos].emplaceData(key, std::forward<Args>(args)...);
+    _ctrl[pos] = hashToCtrl(key.hash());
+    if (wasEmpty) {
+        --_growthLeft;
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::eraseAt(unsigned pos) {
+    using namespace unordered_fast_key_table_detail;
+    dassert(isFull(pos));
+    _entries[pos].destroyData();
 
-        int firstEmpty = -1;
-        int loc = newArea->find(
-            HashedKey(Traits::toLookup(entry.getData().first), entry.getCurHash()), &firstEmpty);
+    // If the slot's group already has an empty slot, no probe sequence continues past this group,
+    // so the slot can become empty again rather than a tombstone.
+    const unsigned groupOffset = pos & ~(kGroupWidth - 1);
+    if (Group(_ctrl.get() + groupOffset).matchEmpty()) {
+        _ctrl[pos] = kEmpty;
+        ++_growthLeft;
+    } else {
+        _ctrl[pos] = kDeleted;
+    }
+}
 
-        verify(loc == -1);
-        if (firstEmpty < 0) {
-            return false;
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) {
+    using namespace unordered_fast_key_table_detail;
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (!isFull(pos)) {
+            continue;
         }
 
-        newArea->_entries[firstEmpty] = entry;
+        // The keys are already known to be distinct, so there is no need to compare them.
+        Entry& entry = _entries[pos];
+        const unsigned newPos = newArea->findSlotForInsert(entry.getCurHash());
+        dassert(newArea->_ctrl[newPos] == kEmpty);
+        invariant(newArea->_growthLeft > 0);
+        newArea->_entries[newPos].moveData(&entry);
+        newArea->_ctrl[newPos] = _ctrl[pos];
+        --newArea->_growthLeft;
     }
-    return true;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -115,13 +233,13 @@ inline size_t UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const HashedKey&
     if (_size == 0)
         return 0;  // Nothing to delete.
 
-    int pos = _area.find(key, nullptr);
+    int pos = _area.find(key);
 
     if (pos < 0)
         return 0;
 
     --_size;
-    _area._entries[pos].unUse();
+    _area.eraseAt(pos);
     return 1;
 }
 
@@ -131,7 +249,7 @@ void UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const_iterator it) {
     dassert(it._area == &_area);
 
     --_size;
-    _area._entries[it._position].unUse();
+    _area.eraseAt(it._position);
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -143,54 +261,41 @@ inline auto UnorderedFastKeyTable<K_L, K_S, V, Traits>::try_emplace(const Hashed
         // This is the first insert ever. Need to allocate initial space.
         dassert(_area.capacity() == 0);
         _grow();
-    }
-
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        int firstEmpty = -1;
-        int pos = _area.find(key, &firstEmpty);
+    } else {
+        int pos = _area.find(key);
         if (pos >= 0) {
-            // This is only possible the first pass through the loop, since you're allocating space
-            // for a new element after that.
-            dassert(numGrowTries == 0);
             return {iterator(&_area, pos), false};
         }
+    }
 
-        // key not in map
-        // need to add
-        if (firstEmpty >= 0) {
-            _size++;
-            _area._entries[firstEmpty].emplaceData(key, std::forward<Args>(args)...);
-            return {iterator(&_area, firstEmpty), true};
-        }
-
-        // no space left in map
+    // key not in map
+    // need to add
+    unsigned pos = _area.findSlotForInsert(key.hash());
+    if (_area._growthLeft == 0 && _area._ctrl[pos] == unordered_fast_key_table_detail::kEmpty) {
+        // Filling another empty slot would leave too few for probing to stay short.
         _grow();
+        pos = _area.findSlotForInsert(key.hash());
     }
-    msgasserted(16471, "UnorderedFastKeyTable couldn't add entry after growing many times");
+
+    _area.emplaceAt(pos, key, std::forward<Args>(args)...);
+    _size++;
+    return {iterator(&_area, pos), true};
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
 inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::_grow() {
+    using namespace unordered_fast_key_table_detail;
     unsigned capacity = _area.capacity();
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        if (capacity == 0) {
-            const unsigned kDefaultStartingCapacity = 16;
-            capacity = kDefaultStartingCapacity;
-        } else {
-            capacity *= 2;
-        }
-
-        const double kMaxProbeRatio = 0.05;
-        unsigned maxProbes = (capacity * kMaxProbeRatio) + 1;  // Round up
-
-        Area newArea(capacity, maxProbes);
-        bool success = _area.transfer(&newArea);
-        if (!success) {
-            continue;
-        }
-        _area.swap(&newArea);
-        return;
+    if (capacity == 0) {
+        const unsigned kDefaultStartingCapacity = 16;
+        capacity = kDefaultStartingCapacity;
+    } else if (_size >= maxLoad(capacity) / 2) {
+        capacity *= 2;
     }
-    msgasserted(16845, "UnorderedFastKeyTable::_grow couldn't add entry after growing many times");
+    // Otherwise the table is mostly tombstones, and rehashing at the same capacity clears them.
+
+    Area newArea(capacity);
+    _area.transfer(&newArea);
+    _area.swap(&newArea);
 }
 }
@@ -0,0 +1,177 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/xxhash.h"
+
+#include <cstring>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+
+namespace mongo {
+namespace {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const unsigned char* p) {
+    return ConstDataView(reinterpret_cast<const char*>(p)).read<LittleEndian<uint64_t>>();
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    return ConstDataView(reinterpret_cast<const char*>(p)).read<LittleEndian<uint32_t>>();
+}
+
+inline uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t h, uint64_t acc) {
+    h ^= round(0, acc);
+    return h * kPrime1 + kPrime4;
+}
+
+void initAccumulators(uint64_t seed, uint64_t acc[4]) {
+    acc[0] = seed + kPrime1 + kPrime2;
+    acc[1] = seed + kPrime2;
+    acc[2] = seed;
+    acc[3] = seed - kPrime1;
+}
+
+/**
+ * Consumes as many whole 32-byte stripes as 'len' allows and returns the number of bytes used.
+ */
+size_t consumeStripes(uint64_t acc[4], const unsigned char* p, size_t len) {
+    const unsigned char* const start = p;
+    for (; len >= 32; p += 32, len -= 32) {
+        acc[0] = round(acc[0], read64(p));
+        acc[1] = round(acc[1], read64(p + 8));
+        acc[2] = round(acc[2], read64(p + 16));
+        acc[3] = round(acc[3], read64(p + 24));
+    }
+    return p - start;
+}
+
+/**
+ * Combines the accumulators (if any stripe was consumed) with the trailing 'len' < 32 bytes.
+ */
+uint64_t finish(uint64_t seed,
+                const uint64_t acc[4],
+                uint64_t totalLen,
+                const unsigned char* p,
+                size_t len) {
+    uint64_t h;
+    if (totalLen >= 32) {
+        h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+        h = mergeRound(h, acc[0]);
+        h = mergeRound(h, acc[1]);
+        h = mergeRound(h, acc[2]);
+        h = mergeRound(h, acc[3]);
+    } else {
+        h = seed + kPrime5;
+    }
+
+    h += totalLen;
+
+    for (; len >= 8; p += 8, len -= 8) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (len >= 4) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+        len -= 4;
+    }
+    for (; len > 0; ++p, --len) {
+        h ^= *p * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+}  // namespace
+
+uint64_t xxhash64(const void* buf, size_t len, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(buf);
+    uint64_t acc[4];
+    initAccumulators(seed, acc);
+    const size_t used = consumeStripes(acc, p, len);
+    return finish(seed, acc, len, p + used, len - used);
+}
+
+XXHash64::XXHash64(uint64_t seed) : _seed(seed) {
+    initAccumulators(_seed, _acc);
+}
+
+void XXHash64::update(const void* buf, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(buf);
+    _totalLen += len;
+
+    if (_pendingLen + len < sizeof(_pending)) {
+        memcpy(_pending + _pendingLen, p, len);
+        _pendingLen += len;
+        return;
+    }
+
+    if (_pendingLen > 0) {
+        const size_t fill = sizeof(_pending) - _pendingLen;
+        memcpy(_pending + _pendingLen, p, fill);
+        consumeStripes(_acc, _pending, sizeof(_pending));
+        p += fill;
+        len -= fill;
+        _pendingLen = 0;
+    }
+
+    const size_t used = consumeStripes(_acc, p, len);
+    memcpy(_pending, p + used, len - used);
+    _pendingLen = len - used;
+}
+
+uint64_t XXHash64::digest() const {
+    return finish(_seed, _acc, _totalLen, _pending, _pendingLen);
+}
+
+}  // namespace mongo
@@ -0,0 +1,69 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mongo {
+
+/**
+ * Computes the 64-bit xxHash (XXH64) of 'len' bytes at 'buf'. This is a fast non-cryptographic
+ * hash with good distribution; it is meant for checksums and consistency checks, not for
+ * anything that must resist a deliberate collision.
+ */
+uint64_t xxhash64(const void* buf, size_t len, uint64_t seed = 0);
+
+/**
+ * Incremental XXH64: feeding a buffer through any sequence of update() calls produces the same
+ * digest() as a single xxhash64() call over the whole buffer.
+ */
+class XXHash64 {
+public:
+    explicit XXHash64(uint64_t seed = 0);
+
+    void update(const void* buf, size_t len);
+
+    /**
+     * Returns the hash of everything passed to update() so far. Does not modify the state, so
+     * more data may still be added afterwards.
+     */
+    uint64_t digest() const;
+
+private:
+    uint64_t _seed;
+    uint64_t _acc[4];
+    uint64_t _totalLen = 0;
+
+    // Input that does not yet fill a whole 32-byte stripe.
+    unsigned char _pending[32];
+    size_t _pendingLen = 0;
+};
+
+}  // namespace mongo
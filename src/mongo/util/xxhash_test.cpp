@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/xxhash.h"
+
+#include <string>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(XXHash64, KnownVectors) {
+    ASSERT_EQ(0xEF46DB3751D8E999ULL, xxhash64("", 0));
+    ASSERT_EQ(0xD24EC4F1A98C6E5BULL, xxhash64("a", 1));
+    ASSERT_EQ(0x44BC2CF5AD770999ULL, xxhash64("abc", 3));
+
+    const std::string longer = "Nobody inspects the spammish repetition";
+    ASSERT_EQ(0xFBCEA83C8A378BF1ULL, xxhash64(longer.data(), longer.size()));
+}
+
+TEST(XXHash64, SeedChangesHash) {
+    ASSERT_NE(xxhash64("abc", 3, 0), xxhash64("abc", 3, 1));
+}
+
+TEST(XXHash64, StreamingMatchesOneShot) {
+    PseudoRandom rng(2);
+    std::string data(5000, '\0');
+    for (auto& c : data) {
+        c = static_cast<char>(rng.nextInt32());
+    }
+
+    for (size_t len : {0, 1, 31, 32, 33, 63, 64, 100, 5000}) {
+        const uint64_t expected = xxhash64(data.data(), len, 42);
+
+        for (int chunk : {1, 3, 7, 31, 32, 33, 1000}) {
+            XXHash64 hasher(42);
+            for (size_t pos = 0; pos < len; pos += chunk) {
+                hasher.update(data.data() + pos, std::min<size_t>(chunk, len - pos));
+            }
+            ASSERT_EQ(expected, hasher.digest()) << "length " << len << " chunk " << chunk;
+        }
+    }
+}
+
+TEST(XXHash64, DigestDoesNotConsumeState) {
+    XXHash64 hasher;
+    hasher.update("ab", 2);
+    ASSERT_EQ(xxhash64("ab", 2), hasher.digest());
+    hasher.update("c", 1);
+    ASSERT_EQ(xxhash64("abc", 3), hasher.digest());
+}
+
+}  // namespace
+}  // namespace mongo